@@ -0,0 +1,122 @@
+#!/usr/bin/env python
+
+"""
+Collects the results of the perf_regression resmoke suite and compares them against a baseline.
+
+Example usage:
+    resmoke.py --suites=perf_regression | tee perf.log
+    perf_results.py collect perf.log --out perf.json
+    perf_results.py compare perf.json --baseline baseline_perf.json
+
+"collect" writes the PERF_RESULT lines printed by jstests/libs/perf_harness.js to a JSON file in
+the format mongo-perf produces. "compare" exits with status code 1 if any benchmark's mean
+throughput dropped by more than --threshold (5% by default) and by more than --noiseMultiple
+times the combined standard error of the two runs, and 0 otherwise.
+"""
+
+from __future__ import absolute_import
+from __future__ import print_function
+
+import argparse
+import json
+import math
+import sys
+
+PERF_RESULT_MARKER = "PERF_RESULT: "
+
+
+def collect(log_files):
+    """
+    Returns the results printed to the given logs, merging the thread levels of each benchmark.
+    """
+    results = {}
+    for log_file in log_files:
+        with open(log_file) as log:
+            for line in log:
+                index = line.find(PERF_RESULT_MARKER)
+                if index < 0:
+                    continue
+                result = json.loads(line[index + len(PERF_RESULT_MARKER):])
+                merged = results.setdefault(result["name"], {"name": result["name"],
+                                                             "results": {}})
+                merged["results"].update(result["results"])
+    return {"results": sorted(results.values(), key=lambda r: r["name"])}
+
+
+def load(path):
+    with open(path) as result_file:
+        return dict((r["name"], r) for r in json.load(result_file)["results"])
+
+
+def standard_error(level):
+    """
+    Returns the standard error of the mean throughput of one thread level.
+    """
+    values = level.get("ops_per_sec_values", [])
+    if len(values) < 2:
+        return 0.0
+    return level.get("stddev", 0.0) / math.sqrt(len(values))
+
+
+def compare(current, baseline, threshold, noise_multiple):
+    """
+    Compares every thread level that both runs measured and returns whether any regressed.
+    """
+    failed = False
+    for name in sorted(current):
+        if name not in baseline:
+            print("%s: no baseline, skipping" % name)
+            continue
+        for threads, level in sorted(current[name]["results"].items()):
+            reference = baseline[name]["results"].get(threads)
+            if not reference:
+                continue
+            ref = reference["ops_per_sec"]
+            cur = level["ops_per_sec"]
+            if ref <= 0:
+                continue
+            noise = noise_multiple * math.sqrt(standard_error(level) ** 2 +
+                                               standard_error(reference) ** 2)
+            drop = ref - cur
+            if drop > threshold * ref and drop > noise:
+                print("%s (%s threads): regression from %.2f to %.2f ops/sec (%.2f%%), noise"
+                      " level %.2f" % (name, threads, ref, cur, 100 * drop / ref, noise))
+                failed = True
+            else:
+                print("%s (%s threads): %.2f ops/sec against %.2f (%+.2f%%)" %
+                      (name, threads, cur, ref, 100 * (cur - ref) / ref))
+    return failed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    subparsers = parser.add_subparsers(dest="command")
+
+    collect_parser = subparsers.add_parser("collect", help="collect results from resmoke logs")
+    collect_parser.add_argument("logs", nargs="+", help="logs of perf_regression suite runs")
+    collect_parser.add_argument("--out", required=True, help="JSON file to write results to")
+
+    compare_parser = subparsers.add_parser("compare", help="compare results against a baseline")
+    compare_parser.add_argument("results", help="JSON file written by collect")
+    compare_parser.add_argument("--baseline", required=True,
+                                help="JSON file written by collect for the reference build")
+    compare_parser.add_argument("--threshold", default=0.05, type=float,
+                                help="Don't flag a regression if throughput is less than"
+                                " 'threshold'x100 percent lower")
+    compare_parser.add_argument("--noiseMultiple", default=2, type=float,
+                                help="Don't flag a regression if throughput is less than"
+                                " 'noiseMultiple' standard errors lower")
+
+    args = parser.parse_args()
+    if args.command == "collect":
+        with open(args.out, "w") as out:
+            json.dump(collect(args.logs), out, indent=4, sort_keys=True)
+        return 0
+
+    failed = compare(load(args.results), load(args.baseline), args.threshold, args.noiseMultiple)
+    return 1 if failed else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,36 @@
+// Checks that $approxDistinct estimates the number of distinct values in each group, both as a
+// $group accumulator and as an expression over an array.
+(function() {
+    "use strict";
+
+    var coll = db.approx_distinct;
+    coll.drop();
+
+    var N = 20000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, g: i % 2, a: i % 5000, b: [i % 3, i % 3, 7]});
+    }
+    bulk.insert({_id: N, g: 2});
+    assert.writeOK(bulk.execute());
+
+    var results = coll.aggregate([
+                          {$group: {_id: '$g', a: {$approxDistinct: '$a'}, n: {$sum: 1}}},
+                          {$sort: {_id: 1}}
+                      ]).toArray();
+    assert.eq(3, results.length, tojson(results));
+    [0, 1].forEach(function(g) {
+        // Each parity sees half of the values of 'a'.
+        assert.lt(Math.abs(results[g].a - 2500), 125, tojson(results));
+        assert.eq(N / 2, results[g].n, tojson(results));
+    });
+    // Missing values are not counted.
+    assert.eq({_id: 2, a: 0, n: 1}, results[2]);
+
+    results = coll.aggregate([
+                          {$match: {_id: {$lt: 3}}},
+                          {$project: {d: {$approxDistinct: '$b'}}},
+                          {$sort: {_id: 1}}
+                      ]).toArray();
+    assert.eq([{_id: 0, d: 2}, {_id: 1, d: 2}, {_id: 2, d: 2}], results);
+})();
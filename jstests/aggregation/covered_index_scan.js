@@ -0,0 +1,48 @@
+// Checks that a pipeline whose fields are all in an index reads them from a covered scan of that
+// index, even when its query does not constrain the index.
+load("jstests/libs/analyze_plan.js");
+
+(function() {
+    "use strict";
+
+    var coll = db.covered_index_scan;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: i, a: i, b: i % 10, c: i % 7});
+    }
+    assert.writeOK(bulk.execute());
+
+    function getWinningPlan(pipeline) {
+        var explain = coll.aggregate(pipeline, {explain: true});
+        assert.commandWorked(explain);
+        return explain.stages[0].$cursor.queryPlanner.winningPlan;
+    }
+
+    function results(pipeline) {
+        return coll.aggregate(pipeline).toArray().map(tojson).sort();
+    }
+
+    var pipelines = [
+        [{$group: {_id: "$c", total: {$sum: "$b"}}}],
+        [{$match: {c: {$gte: 3}}}, {$group: {_id: "$c", total: {$sum: "$b"}}}],
+        [{$project: {_id: 0, b: 1, c: 1}}, {$match: {b: 4}}],
+    ];
+
+    var expected = pipelines.map(function(pipeline) {
+        assert(isCollscan(getWinningPlan(pipeline)), tojson(pipeline));
+        return results(pipeline);
+    });
+
+    assert.commandWorked(coll.ensureIndex({b: 1, c: 1}));
+    pipelines.forEach(function(pipeline, i) {
+        var plan = getWinningPlan(pipeline);
+        assert(isIxscan(plan) && isIndexOnly(plan), tojson(plan));
+        assert.eq(expected[i], results(pipeline), tojson(pipeline));
+    });
+
+    // Fields outside the index still need the documents.
+    var pipeline = [{$group: {_id: "$c", total: {$sum: "$a"}}}];
+    assert(isCollscan(getWinningPlan(pipeline)), tojson(pipeline));
+})();
@@ -0,0 +1,83 @@
+// Checks that a $group whose input is sorted on its key, either by a preceding $sort or by an index
+// scan providing the group key's order, returns the same groups as one which hashes its input.
+(function() {
+    "use strict";
+
+    var coll = db.group_streaming;
+    coll.drop();
+
+    var N = 1000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, a: i % 37, b: i % 5, c: i});
+    }
+    // Keys that are missing, null, or arrays.
+    bulk.insert({_id: N, b: 1});
+    bulk.insert({_id: N + 1, a: null, b: 2});
+    bulk.insert({_id: N + 2, a: [3, 40], b: 3});
+    bulk.insert({_id: N + 3, a: [40, 3], b: 4});
+    assert.writeOK(bulk.execute());
+
+    function byId(l, r) {
+        var lId = tojson(l._id);
+        var rId = tojson(r._id);
+        return lId < rId ? -1 : (lId > rId ? 1 : 0);
+    }
+
+    function groups(pipeline) {
+        return coll.aggregate(pipeline).toArray().sort(byId);
+    }
+
+    function getGroupStage(pipeline) {
+        var explain = coll.aggregate(pipeline, {explain: true});
+        assert.commandWorked(explain);
+        for (var i = 0; i < explain.stages.length; i++) {
+            if (explain.stages[i].hasOwnProperty('$group')) {
+                return explain.stages[i].$group;
+            }
+        }
+        assert(false, tojson(explain));
+    }
+
+    var group = {$group: {_id: '$a', n: {$sum: 1}, b: {$sum: '$b'}, c: {$max: '$c'}}};
+    var compoundGroup = {$group: {_id: {b: '$b', a: '$a'}, n: {$sum: 1}, c: {$min: '$c'}}};
+
+    [[{$sort: {a: 1}}, group],
+     [{$sort: {a: -1, c: 1}}, group],
+     [{$sort: {b: 1, a: -1}}, compoundGroup],
+     [{$match: {b: {$gte: 2}}}, {$sort: {a: 1, b: 1}}, compoundGroup]]
+        .forEach(function(pipeline) {
+            var hashed = pipeline.slice(0, -1).concat([{$project: {a: 1, b: 1, c: 1}}],
+                                                      pipeline.slice(-1));
+            assert(!getGroupStage(hashed).$streaming, tojson(hashed));
+            assert(getGroupStage(pipeline).$streaming, tojson(pipeline));
+
+            // Arrays in 'a' make some of the pipelines fall back to hashing part of their input.
+            var expected = groups(hashed);
+            assert.eq(expected, groups(pipeline), tojson(pipeline));
+
+            assert.commandWorked(coll.ensureIndex({a: 1}));
+            assert.eq(expected, groups(pipeline), tojson(pipeline));
+            assert.commandWorked(coll.dropIndex({a: 1}));
+        });
+
+    // Without a $sort, a $group streams over an index scan which provides the order of its key and
+    // covers the fields it needs.
+    assert.writeOK(coll.remove({_id: {$in: [N + 2, N + 3]}}));
+    var pipeline = [{$group: {_id: '$a', n: {$sum: 1}, b: {$sum: '$b'}}}];
+    var expected = groups(pipeline);
+    assert(!getGroupStage(pipeline).$streaming);
+
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+    assert(!getGroupStage(pipeline).$streaming);
+
+    assert.commandWorked(coll.ensureIndex({a: 1, b: 1}));
+    assert(getGroupStage(pipeline).$streaming);
+    assert.eq(expected, groups(pipeline));
+
+    pipeline = [{$match: {a: {$gte: 10}}}].concat(pipeline);
+    assert(getGroupStage(pipeline).$streaming);
+    assert.eq(expected.filter(function(doc) {
+        return doc._id >= 10;
+    }), groups(pipeline));
+})();
@@ -0,0 +1,92 @@
+// Checks that $lookUp joins each document with the matching documents of another collection, and
+// returns the same results whether the foreign field is indexed, the unindexed foreign collection
+// fits in memory, or it has to be scanned once per batch of input documents.
+(function() {
+    "use strict";
+
+    var local = db.lookup_local;
+    var foreign = db.lookup_foreign;
+    local.drop();
+    foreign.drop();
+
+    assert.writeOK(local.insert({_id: 0, a: 1}));
+    assert.writeOK(local.insert({_id: 1, a: 2}));
+    assert.writeOK(local.insert({_id: 2, a: [1, 3]}));
+    assert.writeOK(local.insert({_id: 3, a: null}));
+    assert.writeOK(local.insert({_id: 4}));
+    assert.writeOK(local.insert({_id: 5, a: 4}));
+    assert.writeOK(local.insert({_id: 6, a: 1.0}));
+
+    assert.writeOK(foreign.insert({_id: 0, b: 1, x: 'one'}));
+    assert.writeOK(foreign.insert({_id: 1, b: 1, x: 'uno'}));
+    assert.writeOK(foreign.insert({_id: 2, b: 2, x: 'two'}));
+    assert.writeOK(foreign.insert({_id: 3, b: [3, 1], x: 'three'}));
+    assert.writeOK(foreign.insert({_id: 4, b: null, x: 'null'}));
+    assert.writeOK(foreign.insert({_id: 5, x: 'missing'}));
+
+    function byId(l, r) {
+        return l._id - r._id;
+    }
+
+    function run(pipeline) {
+        var results = local.aggregate(pipeline).toArray();
+        results.forEach(function(doc) {
+            if (Array.isArray(doc.same)) {
+                doc.same.sort(byId);
+            }
+        });
+        return results.sort(function(l, r) {
+            return byId(l, r) || (l.same && r.same ? byId(l.same, r.same) : 0);
+        });
+    }
+
+    var lookUp =
+        {$lookUp: {from: foreign.getName(), localField: 'a', foreignField: 'b', as: 'same'}};
+    var pipelines = [
+        [{$sort: {_id: 1}}, lookUp],
+        [lookUp, {$unwind: '$same'}],
+        [lookUp, {$unwind: '$same'}, {$match: {'same.x': {$ne: 'uno'}}}],
+        [lookUp, {$unwind: '$same'}, {$match: {'same.x': /^t/, _id: {$gt: 0}}}]
+    ];
+
+    function runAll() {
+        return pipelines.map(run);
+    }
+
+    var expected = runAll();
+
+    // Spot check the joins in the first pipeline.
+    var ids = expected[0].map(function(doc) {
+        return doc.same.map(function(match) {
+            return match._id;
+        });
+    });
+    assert.eq([[0, 1, 3], [2], [0, 1, 3], [4, 5], [4, 5], [], [0, 1, 3]], ids, tojson(expected));
+    assert.eq(11, expected[2].length, tojson(expected));
+
+    var admin = db.getSiblingDB('admin');
+    var res = admin.runCommand({setParameter: 1, internalDocumentSourceLookUpBatchSize: 2});
+    assert.commandWorked(res);
+    var wasBatchSize = res.was;
+    res = admin.runCommand({setParameter: 1, internalDocumentSourceLookUpMaxHashTableBytes: 1});
+    assert.commandWorked(res);
+    var wasMaxBytes = res.was;
+
+    try {
+        // Scan the foreign collection once per batch of two input documents.
+        assert.eq(expected, runAll());
+
+        // Probe an index on the foreign field.
+        assert.commandWorked(foreign.ensureIndex({b: 1}));
+        assert.eq(expected, runAll());
+    } finally {
+        assert.commandWorked(admin.runCommand(
+            {setParameter: 1, internalDocumentSourceLookUpBatchSize: wasBatchSize}));
+        assert.commandWorked(admin.runCommand(
+            {setParameter: 1, internalDocumentSourceLookUpMaxHashTableBytes: wasMaxBytes}));
+    }
+
+    assert.throws(function() {
+        local.aggregate([{$lookUp: {from: foreign.getName(), localField: 'a', as: 'same'}}]);
+    });
+})();
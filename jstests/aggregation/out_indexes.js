@@ -0,0 +1,38 @@
+// Tests that $out keeps the target collection's indexes, which it builds on its temporary
+// collection after inserting the documents.
+(function() {
+    "use strict";
+
+    var source = db.out_indexes_source;
+    var target = db.out_indexes_target;
+    source.drop();
+    target.drop();
+
+    var bulk = source.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i % 100, b: i});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.writeOK(target.insert({_id: "old"}));
+    assert.commandWorked(target.ensureIndex({a: 1}));
+    assert.commandWorked(target.ensureIndex({b: 1}, {unique: true}));
+
+    source.aggregate([{$out: target.getName()}]);
+    assert.eq(1000, target.count());
+    assert.eq(0, target.count({_id: "old"}));
+
+    var indexNames = target.getIndexes().map(function(index) {
+        return index.name;
+    }).sort();
+    assert.eq(["_id_", "a_1", "b_1"], indexNames);
+    assert.eq(10, target.find({a: 5}).hint({a: 1}).itcount());
+
+    // A unique index which the new documents violate fails the $out and leaves the target as
+    // it was.
+    assert.throws(function() {
+        source.aggregate([{$project: {b: {$literal: 1}}}, {$out: target.getName()}]);
+    });
+    assert.eq(1000, target.count());
+    assert.eq(3, target.getIndexes().length);
+})();
@@ -0,0 +1,68 @@
+// Checks that $_internalPackBuckets stores the measurements of each series in buckets of bounded
+// size and time span, and that $_internalUnpackBucket returns the original measurements.
+(function() {
+    "use strict";
+
+    var raw = db.timeseries_buckets_raw;
+    var buckets = db.timeseries_buckets;
+    raw.drop();
+    buckets.drop();
+
+    var start = ISODate("2015-10-01T00:00:00Z").getTime();
+    var bulk = raw.initializeUnorderedBulkOp();
+    for (var sensor = 0; sensor < 3; sensor++) {
+        for (var i = 0; i < 2500; i++) {
+            bulk.insert({
+                sensor: {id: sensor},
+                ts: new Date(start + i * 1000),
+                value: 20 + Math.round(10 * Math.sin(i / 100)) / 10,
+                count: i
+            });
+        }
+    }
+    assert.writeOK(bulk.execute());
+
+    var spec = {timeField: "ts", metaField: "sensor"};
+    raw.aggregate([
+        {$sort: {sensor: 1, ts: 1}},
+        {$_internalPackBuckets: Object.extend({maxCount: 1000, maxSpanSeconds: 600}, spec)},
+        {$out: buckets.getName()}
+    ]);
+
+    // A measurement a second fills a bucket every ten minutes, before it has 1000 of them.
+    assert.eq(3 * 5, buckets.count());
+    buckets.find().forEach(function(bucket) {
+        assert.lte(bucket.control.count, 1000, tojson(bucket.control));
+        assert.lt(bucket.control.max.ts - bucket.control.min.ts, 600 * 1000);
+    });
+
+    function measurements(coll, pipeline) {
+        return coll.aggregate(pipeline.concat([{$sort: {"sensor.id": 1, ts: 1}}])).toArray();
+    }
+    var expected = measurements(raw, [{$project: {_id: 0, ts: 1, sensor: 1, value: 1, count: 1}}]);
+    var unpacked = measurements(buckets, [{$_internalUnpackBucket: spec}]);
+    assert.eq(expected.length, unpacked.length);
+    for (var i = 0; i < expected.length; i++) {
+        assert.docEq(expected[i], unpacked[i]);
+    }
+
+    // Time range queries can skip buckets on their control fields before unpacking.
+    var from = new Date(start + 1200 * 1000);
+    var to = new Date(start + 1300 * 1000);
+    var inRange = measurements(buckets, [
+        {$match: {"control.max.ts": {$gte: from}, "control.min.ts": {$lt: to}}},
+        {$_internalUnpackBucket: spec},
+        {$match: {ts: {$gte: from, $lt: to}}}
+    ]);
+    assert.eq(300, inRange.length);
+
+    assert.throws(function() {
+        raw.aggregate([{$_internalPackBuckets: {metaField: "sensor"}}]);
+    });
+    assert.throws(function() {
+        raw.aggregate([{$_internalPackBuckets: {timeField: "value"}}]);
+    });
+    assert.throws(function() {
+        raw.aggregate([{$_internalUnpackBucket: spec}]);
+    });
+})();
@@ -0,0 +1,63 @@
+// Single-document updates and deletes in a write batch share the batch's collection locks, while
+// multi-document and $isolated writes and upserts into a missing collection take their own.
+(function() {
+    "use strict";
+
+    var coll = db.batch_write_shared_locks;
+    coll.drop();
+
+    // Upserts into a collection that doesn't exist yet have to create it.
+    var res = db.runCommand({
+        update: coll.getName(),
+        updates: [
+            {q: {_id: 0}, u: {$set: {a: 0}}, upsert: true},
+            {q: {_id: 1}, u: {$set: {a: 1}}, upsert: true},
+        ],
+        ordered: false
+    });
+    assert.commandWorked(res);
+    assert.eq(2, res.n, tojson(res));
+    assert.eq(2, res.upserted.length, tojson(res));
+
+    for (var i = 2; i < 200; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: i % 2}));
+    }
+
+    var updates = [];
+    for (var i = 0; i < 200; i++) {
+        updates.push({q: {_id: i}, u: {$inc: {a: 1}}});
+    }
+    updates.push({q: {b: 1}, u: {$set: {odd: true}}, multi: true});
+    updates.push({q: {_id: 2, $isolated: 1}, u: {$set: {isolated: true}}});
+    updates.push({q: {_id: 1000}, u: {$set: {a: 1000}}, upsert: true});
+    res = db.runCommand({update: coll.getName(), updates: updates, ordered: false});
+    assert.commandWorked(res);
+    assert.eq(301, res.n, tojson(res));
+    assert.eq(300, res.nModified, tojson(res));
+    assert.eq(1000, res.upserted[0]._id, tojson(res));
+
+    assert.eq(5, coll.findOne({_id: 4}).a);
+    assert.eq(99, coll.count({odd: true}));
+    assert(coll.findOne({_id: 2}).isolated);
+
+    // A failing operation in the middle of an unordered batch doesn't stop the others.
+    res = db.runCommand({
+        update: coll.getName(),
+        updates: [{q: {_id: 3}, u: {$set: {a: 0}}}, {q: {_id: 4}, u: {$inc: {a: "x"}}},
+                  {q: {_id: 5}, u: {$set: {a: 0}}}],
+        ordered: false
+    });
+    assert.eq(2, res.nModified, tojson(res));
+    assert.eq(1, res.writeErrors.length, tojson(res));
+    assert.eq(1, res.writeErrors[0].index, tojson(res));
+
+    var deletes = [];
+    for (var i = 0; i < 100; i++) {
+        deletes.push({q: {_id: i}, limit: 1});
+    }
+    deletes.push({q: {odd: true}, limit: 0});
+    res = db.runCommand({delete: coll.getName(), deletes: deletes, ordered: false});
+    assert.commandWorked(res);
+    assert.eq(150, res.n, tojson(res));
+    assert.eq(51, coll.count());
+})();
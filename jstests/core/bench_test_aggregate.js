@@ -0,0 +1,58 @@
+// Checks the aggregate and findAndModify benchRun ops, the latency percentiles reported for each
+// kind of op, and that targetOpsPerSecond paces the run.
+(function() {
+    "use strict";
+
+    var t = db.bench_test_aggregate;
+    t.drop();
+    for (var i = 0; i < 20; i++) {
+        assert.writeOK(t.insert({_id: i, x: 0}));
+    }
+
+    var benchArgs = {
+        ops: [
+            {
+              op: "aggregate",
+              ns: t.getFullName(),
+              pipeline: [{$match: {_id: {$gte: 0}}}],
+              batchSize: 5,
+              expected: 20
+            },
+            {
+              op: "findAndModify",
+              ns: t.getFullName(),
+              query: {_id: 1},
+              update: {$inc: {x: 1}}
+            }
+        ],
+        parallel: 2,
+        seconds: 2,
+        host: db.getMongo().host
+    };
+
+    if (jsTest.options().auth) {
+        benchArgs['db'] = 'admin';
+        benchArgs['username'] = jsTest.options().adminUser;
+        benchArgs['password'] = jsTest.options().adminPassword;
+    }
+
+    var res = benchRun(benchArgs);
+    assert.eq(0, res.errCount, tojson(res));
+    assert.gt(res.aggregate, 0, tojson(res));
+    assert.gt(res.getMore, 0, tojson(res));
+    assert.lte(res.findAndModify * benchArgs.seconds, t.findOne({_id: 1}).x * 1.5, tojson(res));
+
+    ["aggregateLatencyMicros", "findAndModifyLatencyMicros", "getMoreLatencyMicros"].forEach(
+        function(field) {
+            var percentiles = res[field];
+            assert(percentiles, field + " missing from " + tojson(res));
+            assert.lte(percentiles.p50, percentiles.p99, tojson(res));
+            assert.lte(percentiles.p99, percentiles.max, tojson(res));
+        });
+
+    // At 20 ops per second in total, a two second run starts about 40 ops.
+    benchArgs.targetOpsPerSecond = 20;
+    res = benchRun(benchArgs);
+    assert.eq(0, res.errCount, tojson(res));
+    assert.lte(res.totalOps, 60, tojson(res));
+})();
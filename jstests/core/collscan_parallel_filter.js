@@ -0,0 +1,55 @@
+// Checks that collection scans which evaluate their filter over batches of documents on several
+// threads return the same results, in the same order, as scans which filter one document at a time.
+(function() {
+    "use strict";
+
+    var coll = db.collscan_parallel_filter;
+    coll.drop();
+
+    var N = 10000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, a: i % 7, s: 'str' + i, arr: [i % 3, i % 5]});
+    }
+    assert.writeOK(bulk.execute());
+
+    var queries = [
+        {a: 3},
+        {s: /9$/},
+        {arr: {$elemMatch: {$gt: 1, $lt: 4}}},
+        {$or: [{a: {$lt: 2}}, {s: /^str1/}]},
+        {a: {$ne: 0}, arr: 4},
+        {$where: 'this.a == 5'}
+    ];
+
+    function runAll() {
+        return queries.map(function(query) {
+            return [coll.find(query).toArray(),
+                    coll.find(query).sort({$natural: -1}).toArray(),
+                    coll.find(query).limit(5).toArray(),
+                    coll.find(query).batchSize(2).limit(300).toArray(),
+                    coll.find(query)._addSpecial('$maxScan', 1000).toArray(),
+                    coll.count(query),
+                    // An aggregation $match is pushed down into the collection scan, but may not
+                    // use $where.
+                    query.$where ? [] : coll.aggregate([{$match: query}]).toArray()];
+        });
+    }
+
+    var admin = db.getSiblingDB('admin');
+    var res = admin.runCommand({setParameter: 1, internalQueryExecCollScanFilterThreads: 0});
+    assert.commandWorked(res);
+    var was = res.was;
+
+    var serial = runAll();
+    try {
+        [1, 4].forEach(function(threads) {
+            assert.commandWorked(admin.runCommand(
+                {setParameter: 1, internalQueryExecCollScanFilterThreads: threads}));
+            assert.eq(serial, runAll(), 'threads: ' + threads);
+        });
+    } finally {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryExecCollScanFilterThreads: was}));
+    }
+})();
@@ -0,0 +1,33 @@
+// Checks that a count which allows an approximate answer is close to the exact count. Collections
+// whose storage engine cannot sample them are counted exactly.
+(function() {
+    "use strict";
+
+    var coll = db.count_approximate;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 5000; i++) {
+        bulk.insert({a: i % 4});
+    }
+    assert.writeOK(bulk.execute());
+
+    var exact = coll.count({a: {$lte: 1}});
+    assert.eq(2500, exact);
+
+    var res = db.runCommand({count: coll.getName(), query: {a: {$lte: 1}}, approximate: true});
+    assert.commandWorked(res);
+    if (res.approximate) {
+        assert.gt(res.n, exact * 0.6, tojson(res));
+        assert.lt(res.n, exact * 1.4, tojson(res));
+    } else {
+        assert.eq(exact, res.n, tojson(res));
+    }
+
+    // The limit applies to the estimate.
+    res = db.runCommand({count: coll.getName(), query: {a: 0}, approximate: true, limit: 10});
+    assert.commandWorked(res);
+    assert.eq(10, res.n, tojson(res));
+
+    assert.commandFailed(db.runCommand({count: coll.getName(), query: {}, approximate: 1}));
+})();
@@ -0,0 +1,41 @@
+// Checks that a query on a multikey compound index is covered when it only needs components of the
+// index which have no arrays, and that it stops being covered once one of them gets an array.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var coll = db.covered_index_multikey_component;
+    coll.drop();
+
+    for (var i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({a: i, b: [i, i + 1], c: i % 3}));
+    }
+    assert.commandWorked(coll.ensureIndex({a: 1, b: 1}));
+
+    function explain(query, projection) {
+        return coll.find(query, projection).hint({a: 1, b: 1}).explain("executionStats");
+    }
+
+    var plan = explain({a: {$gte: 5}}, {_id: 0, a: 1});
+    assert(isIndexOnly(plan.queryPlanner.winningPlan), tojson(plan.queryPlanner));
+    assert.eq(0, plan.executionStats.totalDocsExamined);
+    // Each document has two keys, but is returned once.
+    assert.eq(15, plan.executionStats.nReturned);
+    var covered = coll.find({a: {$gte: 5}}, {_id: 0, a: 1}).hint({a: 1, b: 1}).toArray();
+    assert.eq(15, covered.length);
+    covered.forEach(function(doc, i) {
+        assert.eq({a: i + 5}, doc);
+    });
+
+    // 'b' comes from arrays, so it can't be covered.
+    plan = explain({a: {$gte: 5}}, {_id: 0, b: 1});
+    assert(!isIndexOnly(plan.queryPlanner.winningPlan), tojson(plan.queryPlanner));
+    assert.eq([{b: [5, 6]}], coll.find({a: 5}, {_id: 0, b: 1}).hint({a: 1, b: 1}).toArray());
+
+    // Now 'a' has arrays too.
+    assert.writeOK(coll.insert({a: [100, 101], b: 1}));
+    plan = explain({a: {$gte: 5}}, {_id: 0, a: 1});
+    assert(!isIndexOnly(plan.queryPlanner.winningPlan), tojson(plan.queryPlanner));
+    assert.eq([{a: [100, 101]}], coll.find({a: 100}, {_id: 0, a: 1}).hint({a: 1, b: 1}).toArray());
+})();
@@ -0,0 +1,42 @@
+// Tests hashing collections by _id range with the rangeSize and ranges options of dbHash.
+(function() {
+    "use strict";
+
+    var mydb = db.getSisterDB("dbhash_ranges");
+    mydb.dropDatabase();
+
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(mydb.a.insert({_id: i, x: i}));
+        assert.writeOK(mydb.b.insert({_id: i, y: i}));
+    }
+
+    var res = mydb.runCommand({dbHash: 1, rangeSize: 4});
+    assert.commandWorked(res);
+    assert.eq(3, res.ranges.a.length, tojson(res));
+    assert.eq([0, 4, 8], res.ranges.a.map(function(r) { return r.min; }), tojson(res));
+    assert.eq([4, 4, 2], res.ranges.a.map(function(r) { return r.n; }), tojson(res));
+    assert.eq(4, res.ranges.a[0].max, tojson(res));
+    assert(res.hasOwnProperty("token"), tojson(res));
+
+    // Changing one document only changes the hash of its range.
+    assert.writeOK(mydb.a.update({_id: 5}, {$set: {x: -5}}));
+    var res2 = mydb.runCommand({dbHash: 1, rangeSize: 4});
+    assert.commandWorked(res2);
+    assert.eq(res.ranges.a[0].md5, res2.ranges.a[0].md5);
+    assert.neq(res.ranges.a[1].md5, res2.ranges.a[1].md5);
+    assert.eq(res.ranges.a[2].md5, res2.ranges.a[2].md5);
+    assert.eq(res.collections.b, res2.collections.b);
+    assert.neq(res.md5, res2.md5);
+
+    // Rehashing just the changed range gives the same range hash.
+    var res3 = mydb.runCommand({dbHash: 1, ranges: {a: [4, 8]}});
+    assert.commandWorked(res3);
+    assert.eq(["a"], Object.keys(res3.collections), tojson(res3));
+    assert.eq(1, res3.ranges.a.length, tojson(res3));
+    assert.eq(res2.ranges.a[1].md5, res3.ranges.a[0].md5, tojson(res3));
+
+    assert.commandFailed(mydb.runCommand({dbHash: 1, rangeSize: 0}));
+    assert.commandFailed(mydb.runCommand({dbHash: 1, ranges: {a: [8, 4]}}));
+    assert.commandFailed(mydb.runCommand({dbHash: 1, ranges: {a: [4]}}));
+    assert.commandFailed(mydb.runCommand({dbHash: 1, ranges: {a: 4}}));
+})();
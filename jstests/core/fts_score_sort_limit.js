@@ -0,0 +1,62 @@
+// Checks that a text search sorted on the text score with a limit returns the best scoring
+// documents, with the same scores as a search which scores every match, and that it can stop
+// reading the index early.
+(function() {
+    "use strict";
+
+    var t = db.fts_score_sort_limit;
+    t.drop();
+
+    var bulk = t.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        var words = [];
+        for (var j = 0; j < i % 17 + 1; j++) {
+            words.push("alpha");
+        }
+        if (i % 3 == 0) {
+            words.push("beta");
+        }
+        for (var j = 0; j < i % 5; j++) {
+            words.push("filler" + j);
+        }
+        bulk.insert({_id: i, text: words.join(" "), n: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(t.ensureIndex({text: "text"}));
+
+    var proj = {score: {$meta: "textScore"}};
+    var sort = {score: {$meta: "textScore"}};
+
+    function scores(cursor) {
+        return cursor.toArray().map(function(doc) {
+            return doc.score;
+        });
+    }
+
+    [{$text: {$search: "alpha"}},
+     {$text: {$search: "alpha beta"}},
+     {$text: {$search: "beta filler3"}},
+     {$text: {$search: "alpha beta"}, n: 1}]
+        .forEach(function(query) {
+            var all = scores(t.find(query, proj).sort(sort));
+            [1, 7, 50, 2000].forEach(function(limit) {
+                assert.eq(all.slice(0, limit),
+                          scores(t.find(query, proj).sort(sort).limit(limit)),
+                          tojson(query) + " limit " + limit);
+            });
+        });
+
+    // With a single popular term the index scan can stop once it has read the best documents.
+    var query = {$text: {$search: "alpha"}};
+    var full = t.find(query, proj).sort(sort).explain("executionStats").executionStats;
+    var limited = t.find(query, proj).sort(sort).limit(5).explain("executionStats").executionStats;
+    assert.eq(1000, full.totalKeysExamined, tojson(full));
+    assert.lt(limited.totalKeysExamined, 100, tojson(limited));
+
+    // Negations and phrases are checked against the fetched documents, so every match is scored.
+    query = {$text: {$search: "alpha -beta"}};
+    var all = scores(t.find(query, proj).sort(sort));
+    assert.eq(all.slice(0, 5), scores(t.find(query, proj).sort(sort).limit(5)));
+    limited = t.find(query, proj).sort(sort).limit(5).explain("executionStats").executionStats;
+    assert.eq(1000, limited.totalKeysExamined, tojson(limited));
+})();
@@ -0,0 +1,50 @@
+// Checks that a $near search over points whose density varies with the distance from the search
+// center returns every point in order, and that repeated $geoWithin queries, whose index bounds
+// are cached, return the same points as the first one.
+(function() {
+    "use strict";
+
+    var coll = db.geo_s2near_density;
+    coll.drop();
+    assert.commandWorked(coll.ensureIndex({loc: "2dsphere"}));
+
+    // A dense cluster around the origin, and sparse points farther out.
+    var bulk = coll.initializeUnorderedBulkOp();
+    var n = 0;
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: n++, loc: {type: "Point", coordinates: [(i % 40) / 1000, i / 40000]}});
+    }
+    for (var i = 0; i < 100; i++) {
+        bulk.insert({_id: n++, loc: {type: "Point", coordinates: [1 + i / 10, 1 + i / 20]}});
+    }
+    assert.writeOK(bulk.execute());
+
+    var origin = {type: "Point", coordinates: [0, 0]};
+    var results = coll.aggregate([{
+                          $geoNear: {
+                              near: origin,
+                              distanceField: "dist",
+                              spherical: true,
+                              limit: n
+                          }
+                      }]).toArray();
+    assert.eq(n, results.length);
+    for (var i = 1; i < results.length; i++) {
+        assert.lte(results[i - 1].dist, results[i].dist, tojson(results[i]));
+    }
+    assert.eq(n, coll.find({loc: {$near: {$geometry: origin}}}).itcount());
+
+    var box = {
+        type: "Polygon",
+        coordinates:
+            [[[-0.001, -0.001], [0.02, -0.001], [0.02, 0.02], [-0.001, 0.02], [-0.001, -0.001]]]
+    };
+    function within() {
+        return coll.find({loc: {$geoWithin: {$geometry: box}}}).sort({_id: 1}).toArray();
+    }
+    var expected = within();
+    assert.gt(expected.length, 0);
+    for (var i = 0; i < 3; i++) {
+        assert.eq(expected, within());
+    }
+})();
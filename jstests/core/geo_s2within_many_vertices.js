@@ -0,0 +1,63 @@
+// Checks that $geoWithin and $geoIntersects with a polygon of many vertices, whose interior and
+// exterior are covered once per query to classify most points cheaply, match the same points with
+// and without a 2dsphere index, and exactly the points inside the polygon.
+(function() {
+    "use strict";
+
+    var coll = db.geo_s2within_many_vertices;
+    coll.drop();
+
+    // A polygon approximating a circle of radius 1 degree around the origin, with a notch cut out
+    // of it on the positive x axis.
+    var numVertices = 2000;
+    var ring = [];
+    for (var i = 0; i < numVertices; i++) {
+        var angle = 2 * Math.PI * i / numVertices;
+        var radius = (i < numVertices / 100 || i > numVertices * 99 / 100) ? 0.5 : 1;
+        ring.push([radius * Math.cos(angle), radius * Math.sin(angle)]);
+    }
+    ring.push(ring[0]);
+    var polygon = {type: "Polygon", coordinates: [ring]};
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    var n = 0;
+    for (var x = -1.2; x <= 1.2; x += 0.05) {
+        for (var y = -1.2; y <= 1.2; y += 0.05) {
+            bulk.insert({_id: n++, loc: [x, y], x: x, y: y});
+        }
+    }
+    assert.writeOK(bulk.execute());
+
+    // Points well inside or well outside of the polygon, away from its edges.
+    function inside(doc) {
+        var r = Math.sqrt(doc.x * doc.x + doc.y * doc.y);
+        var inNotch = doc.x > 0 && Math.abs(doc.y) < 0.25 * doc.x;
+        return r < 0.99 && !(inNotch && r > 0.51);
+    }
+    function outside(doc) {
+        var r = Math.sqrt(doc.x * doc.x + doc.y * doc.y);
+        var inNotch = doc.x > 0 && Math.abs(doc.y) < 0.02 * doc.x;
+        return r > 1.01 || (inNotch && r > 0.52);
+    }
+
+    function ids(query) {
+        return coll.find(query).sort({_id: 1}).toArray();
+    }
+
+    var within = {loc: {$geoWithin: {$geometry: polygon}}};
+    var intersects = {loc: {$geoIntersects: {$geometry: polygon}}};
+    var unindexed = ids(within);
+    assert.eq(unindexed, ids(intersects));
+    unindexed.forEach(function(doc) {
+        assert(!outside(doc), tojson(doc));
+    });
+    coll.find().forEach(function(doc) {
+        if (inside(doc)) {
+            assert.eq(1, coll.find({_id: doc._id, loc: within.loc}).itcount(), tojson(doc));
+        }
+    });
+
+    assert.commandWorked(coll.ensureIndex({loc: "2dsphere"}));
+    assert.eq(unindexed, ids(within));
+    assert.eq(unindexed, ids(intersects));
+})();
@@ -0,0 +1,53 @@
+// Queries of the form {_id: {$in: [...]}} are answered by the MULTI_IDHACK stage.
+(function() {
+    "use strict";
+
+    load("jstests/libs/analyze_plan.js");
+
+    var t = db.idhack_in;
+    t.drop();
+
+    for (var i = 0; i < 20; i++) {
+        assert.writeOK(t.insert({_id: i, a: i}));
+    }
+    assert.writeOK(t.insert({_id: {x: 1}, a: "obj"}));
+
+    function ids(cursor) {
+        return cursor.toArray().map(function(doc) {
+            return tojson(doc._id);
+        }).sort();
+    }
+
+    // Duplicates, values the index considers equal and missing ids are all handled.
+    var query = {_id: {$in: [3, 7, 3.0, NumberLong(7), 100, {x: 1}, 15]}};
+    assert.eq(ids(t.find(query)), [tojson(15), tojson(3), tojson(7), tojson({x: 1})].sort());
+
+    var explain = t.find(query).explain(true);
+    assert(planHasStage(explain.queryPlanner.winningPlan, "MULTI_IDHACK"), tojson(explain));
+    assert.eq(4, explain.executionStats.nReturned, tojson(explain));
+    assert.eq(5, explain.executionStats.totalKeysExamined, tojson(explain));
+
+    // Projections and returnKey() work on top of the stage.
+    var projected = t.find({_id: {$in: [7, 3]}}, {_id: 0, a: 1}).toArray();
+    assert.eq([3, 7], projected.map(function(doc) {
+        assert.eq(["a"], Object.keys(doc), tojson(doc));
+        return doc.a;
+    }).sort());
+    assert.eq(2, t.find({_id: {$in: [7, 3]}}).returnKey().itcount());
+    assert.eq(0, t.find({_id: {$in: []}}).itcount());
+
+    // Anything beyond a plain $in goes through the query planner.
+    [t.find(query).sort({_id: 1}),
+     t.find(query).limit(2),
+     t.find(query).skip(1),
+     t.find(query).hint({_id: 1}),
+     t.find({_id: {$in: [1, /2/]}}),
+     t.find({_id: {$in: [1, 2]}, a: 1})].forEach(function(cursor) {
+        var plan = cursor.explain().queryPlanner.winningPlan;
+        assert(!planHasStage(plan, "MULTI_IDHACK"), tojson(plan));
+    });
+
+    assert.eq([3, 7, 15], t.find(query).sort({_id: 1}).limit(3).toArray().map(function(doc) {
+        return doc._id;
+    }));
+})();
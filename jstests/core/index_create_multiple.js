@@ -0,0 +1,41 @@
+// Builds several indexes in the foreground with one createIndexes command and checks that each of
+// them indexed every document, including the per-index partial filter and multikey handling.
+
+var coll = db.index_create_multiple;
+coll.drop();
+
+var N = 1000;
+var bulk = coll.initializeUnorderedBulkOp();
+for (var i = 0; i < N; i++) {
+    bulk.insert({a: i, b: i % 10, c: [i, i + 1], d: 'str' + i});
+}
+assert.writeOK(bulk.execute());
+
+var specs = [
+    {key: {a: 1}, name: 'a_1', unique: true},
+    {key: {b: 1}, name: 'b_1'},
+    {key: {c: 1}, name: 'c_1'},
+    {key: {d: 1}, name: 'd_1'},
+    {key: {b: 1, a: -1}, name: 'b_partial', partialFilterExpression: {b: {$gte: 5}}}
+];
+var res = coll.runCommand('createIndexes', {indexes: specs});
+assert.commandWorked(res, tojson(res));
+assert.eq(specs.length + 1, coll.getIndexes().length);
+
+assert.eq(N, coll.find().hint('a_1').itcount());
+assert.eq(N, coll.find().hint('b_1').itcount());
+assert.eq(N, coll.find().hint('d_1').itcount());
+assert.eq(N, coll.find({c: {$gte: 0}}).hint('c_1').itcount());
+assert.eq(N / 2, coll.find({b: {$gte: 5}}).hint('b_partial').itcount());
+assert(coll.validate(true).valid);
+
+// A document which cannot be indexed fails the whole build.
+coll.drop();
+assert.writeOK(coll.insert({x: [1, 2], y: [3, 4]}));
+for (var i = 0; i < 100; i++) {
+    assert.writeOK(coll.insert({x: i, y: i}));
+}
+res = coll.runCommand('createIndexes',
+                      {indexes: [{key: {x: 1, y: 1}, name: 'xy'}, {key: {x: 1}, name: 'x'}]});
+assert.commandFailed(res, tojson(res));
+assert.eq(1, coll.getIndexes().length);
@@ -0,0 +1,58 @@
+// Checks that a compound index can answer predicates over its trailing fields by skipping over the
+// distinct values of its unconstrained leading field, and that such scans return the same results
+// as a collection scan.
+load("jstests/libs/analyze_plan.js");
+
+(function() {
+    "use strict";
+
+    var coll = db.index_skip_scan;
+    coll.drop();
+
+    var N = 10000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({a: i % 4, b: i % 1000, c: i});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.ensureIndex({a: 1, b: 1}));
+
+    var queries = [
+        {b: 7},
+        {b: {$gte: 990}},
+        {b: {$in: [1, 500]}, c: {$lt: 5000}},
+        {$or: [{b: 3}, {b: 4}]}
+    ];
+
+    function runAll() {
+        return queries.map(function(query) {
+            return coll.find(query, {_id: 0}).sort({c: 1}).toArray();
+        });
+    }
+
+    var admin = db.getSiblingDB('admin');
+    var res = admin.runCommand({setParameter: 1, internalQueryPlannerEnableSkipScan: false});
+    assert.commandWorked(res);
+    var was = res.was;
+
+    var expected = runAll();
+    try {
+        // Without skip scans the index cannot be used.
+        var explain = coll.find({b: 7}).explain();
+        assert(isCollscan(explain.queryPlanner.winningPlan), tojson(explain));
+
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryPlannerEnableSkipScan: true}));
+        assert.eq(expected, runAll());
+
+        // With only a few distinct values of 'a' the skip scan beats the collection scan, and
+        // seeks past most of the index.
+        explain = coll.find({b: 7}).explain('executionStats');
+        assert(isIxscan(explain.queryPlanner.winningPlan), tojson(explain));
+        assert.eq(N / 1000, explain.executionStats.nReturned, tojson(explain));
+        assert.lt(explain.executionStats.totalKeysExamined, 100, tojson(explain));
+    } finally {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryPlannerEnableSkipScan: was}));
+    }
+})();
@@ -0,0 +1,70 @@
+// Checks that mapReduce returns the same results when it maps and reduces common function shapes
+// natively as when it runs them in JS, including for documents the native functions leave to JS.
+(function() {
+    "use strict";
+
+    var coll = db.mr_native;
+    coll.drop();
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: {b: i % 7}, c: i % 13, s: 'k' + (i % 3)});
+    }
+    bulk.insert({_id: 1000, a: {b: NumberLong(3)}, c: 1});
+    bulk.insert({_id: 1001, a: {b: 'x'}, c: NumberLong(5)});
+    bulk.insert({_id: 1002, a: {b: null}, c: 'not a number'});
+    assert.writeOK(bulk.execute());
+
+    var maps = [
+        function() {
+            emit(this.a.b, 1);
+        },
+        function() {
+            emit(this.s, this.c);
+        },
+        function() {
+            emit(this.a.b, this.c);
+        }
+    ];
+    var reduces = [
+        function(key, values) {
+            return Array.sum(values);
+        },
+        function(key, values) {
+            return Math.max.apply(Math, values);
+        },
+        function(key, values) {
+            return Math.min.apply(Math, values);
+        }
+    ];
+
+    function runAll() {
+        var results = [];
+        maps.forEach(function(map) {
+            reduces.forEach(function(reduce) {
+                var res = coll.mapReduce(map, reduce, {out: {inline: 1}});
+                assert.commandWorked(res);
+                results.push(res.results.sort(function(l, r) {
+                    return tojson(l._id) < tojson(r._id) ? -1 : 1;
+                }));
+            });
+        });
+        return results;
+    }
+
+    var admin = db.getSiblingDB('admin');
+    var res =
+        admin.runCommand({setParameter: 1, internalQueryMapReduceUseNativeFunctions: false});
+    assert.commandWorked(res);
+    var was = res.was;
+
+    try {
+        var expected = runAll();
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryMapReduceUseNativeFunctions: true}));
+        assert.eq(expected, runAll());
+    } finally {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryMapReduceUseNativeFunctions: was}));
+    }
+})();
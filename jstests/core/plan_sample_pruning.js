@@ -0,0 +1,61 @@
+// Checks that candidate plans which a sample of the collection estimates to examine far more index
+// keys than the best candidate are dropped before the plans are raced.
+load("jstests/libs/analyze_plan.js");
+
+(function() {
+    "use strict";
+
+    var coll = db.plan_sample_pruning;
+    coll.drop();
+
+    var N = 5000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({a: i % 1000, b: i % 2});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+    assert.commandWorked(coll.ensureIndex({b: 1}));
+
+    var query = {a: 7, b: 1};
+
+    function explainQuery() {
+        var explain = coll.find(query).explain();
+        assert.commandWorked(explain);
+        return explain.queryPlanner;
+    }
+
+    var admin = db.getSiblingDB('admin');
+    var res = admin.runCommand({setParameter: 1, internalQueryPlanSamplePruningRatio: 0});
+    assert.commandWorked(res);
+    var was = res.was;
+
+    try {
+        // Without estimates every candidate is raced.
+        var planner = explainQuery();
+        var numRejected = planner.rejectedPlans.length;
+        assert.gte(numRejected, 1, tojson(planner));
+        assert(!getPlanStage(planner.winningPlan, 'IXSCAN').hasOwnProperty('estimatedKeysExamined'),
+               tojson(planner));
+
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryPlanSamplePruningRatio: 10}));
+        planner = explainQuery();
+        var ixscan = getPlanStage(planner.winningPlan, 'IXSCAN');
+        assert.eq({a: 1}, ixscan.keyPattern, tojson(planner));
+
+        // Only storage engines which can return records in random order are sampled.
+        if (ixscan.hasOwnProperty('estimatedKeysExamined')) {
+            // The plan which scans {b: 1} alone is dropped. An index intersection plan, if there
+            // is one, cannot be estimated and is still raced.
+            assert.eq(numRejected - 1, planner.rejectedPlans.length, tojson(planner));
+            assert.lt(ixscan.estimatedKeysExamined, N / 10, tojson(planner));
+        }
+
+        // The pruned query returns the same results.
+        assert.eq(N / 1000, coll.find(query).itcount());
+    } finally {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryPlanSamplePruningRatio: was}));
+    }
+})();
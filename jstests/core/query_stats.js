@@ -0,0 +1,41 @@
+// Checks that $queryStats reports the finds run against a collection, aggregated by query shape.
+(function() {
+    "use strict";
+
+    var coll = db.jstests_query_stats;
+    coll.drop();
+
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i, a: i, b: i % 2}));
+    }
+
+    function getShapeStats(filter) {
+        return coll.aggregate([{$queryStats: {}}]).toArray().filter(function(doc) {
+            return doc.query && friendlyEqual(doc.query.filter, filter);
+        });
+    }
+
+    // Queries which differ only by their values have the same shape.
+    assert.eq(1, coll.find({a: 1}).itcount());
+    assert.eq(1, coll.find({a: 2}).itcount());
+    assert.eq(5, coll.find({b: 1}).itcount());
+
+    var stats = getShapeStats({a: 1});
+    assert.eq(1, stats.length, tojson(stats));
+    var aStats = stats[0];
+    assert.eq(coll.getFullName(), aStats.ns, tojson(aStats));
+    assert.eq(2, aStats.execCount, tojson(aStats));
+    assert.eq(2, aStats.nreturned, tojson(aStats));
+    assert.eq(20, aStats.docsExamined, tojson(aStats));
+    assert.eq("COLLSCAN", aStats.planSummary, tojson(aStats));
+    assert.lte(aStats.latencyMicros.p50, aStats.latencyMicros.p99, tojson(aStats));
+    assert(aStats.hasOwnProperty("processName"), tojson(aStats));
+
+    stats = getShapeStats({b: 1});
+    assert.eq(1, stats.length, tojson(stats));
+    assert.eq(1, stats[0].execCount, tojson(stats));
+
+    assert.throws(function() {
+        coll.aggregate([{$queryStats: {a: 1}}]);
+    });
+})();
@@ -0,0 +1,54 @@
+// Checks that a blocking sort with a limit drops the documents which can no longer make its results
+// below the sort, and that doing so returns the same results as sorting every document.
+(function() {
+    "use strict";
+
+    var coll = db.sort_limit_threshold;
+    coll.drop();
+
+    var N = 1000;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < N; i++) {
+        bulk.insert({_id: i, a: i % 10, b: i, c: i % 7});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.ensureIndex({a: 1, b: 1}));
+
+    var queries = [
+        {filter: {a: {$gte: 0}}, sort: {b: 1}, limit: 5},
+        {filter: {a: {$gte: 0}}, sort: {b: -1}, limit: 5},
+        {filter: {a: {$gte: 3}, c: 2}, sort: {b: 1}, limit: 10},
+        {filter: {a: {$gte: 0}}, sort: {c: 1, b: -1}, limit: 20},
+        {filter: {a: {$gte: 0}}, sort: {b: 1}, limit: 1}
+    ];
+
+    function runAll() {
+        return queries.map(function(query) {
+            return coll.find(query.filter).sort(query.sort).limit(query.limit).toArray();
+        });
+    }
+
+    var admin = db.getSiblingDB('admin');
+    var res = admin.runCommand({setParameter: 1, internalQueryExecEnableSortKeyThreshold: false});
+    assert.commandWorked(res);
+    var was = res.was;
+
+    var expected = runAll();
+    try {
+        var explain = coll.find({a: {$gte: 0}}).sort({b: 1}).limit(5).explain('executionStats');
+        assert.eq(N, explain.executionStats.totalDocsExamined, tojson(explain));
+
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryExecEnableSortKeyThreshold: true}));
+        assert.eq(expected, runAll());
+
+        // Once the sort holds five documents, the index scan only passes on the keys of each
+        // value of 'a' with a smaller 'b' than the fifth one, so few documents are fetched.
+        explain = coll.find({a: {$gte: 0}}).sort({b: 1}).limit(5).explain('executionStats');
+        assert.eq(N, explain.executionStats.totalKeysExamined, tojson(explain));
+        assert.lt(explain.executionStats.totalDocsExamined, N / 10, tojson(explain));
+    } finally {
+        assert.commandWorked(
+            admin.runCommand({setParameter: 1, internalQueryExecEnableSortKeyThreshold: was}));
+    }
+})();
@@ -0,0 +1,50 @@
+// Checks that an update keeps every index consistent when it only modifies the paths of some of
+// the collection's indexes, including positional updates, partial index filters and
+// replacements.
+(function() {
+    "use strict";
+
+    var coll = db.update_affected_indexes;
+    coll.drop();
+
+    assert.commandWorked(coll.ensureIndex({a: 1}));
+    assert.commandWorked(coll.ensureIndex({"b.x": 1}));
+    assert.commandWorked(coll.ensureIndex({d: 1}, {partialFilterExpression: {c: {$gt: 0}}}));
+
+    assert.writeOK(coll.insert({_id: 0, a: [1, 2], b: [{x: 1}, {x: 2}], c: 0, d: 1, e: 0}));
+
+    function countWithHint(query, hint) {
+        return coll.find(query).hint(hint).itcount();
+    }
+
+    // Only the {a: 1} index is affected.
+    assert.writeOK(coll.update({_id: 0}, {$push: {a: 3}}));
+    assert.eq(1, countWithHint({a: 3}, {a: 1}));
+    assert.eq(1, countWithHint({"b.x": 2}, {"b.x": 1}));
+
+    // Positional update of an indexed array of subdocuments.
+    assert.writeOK(coll.update({"b.x": 2}, {$set: {"b.$.x": 5}}));
+    assert.eq(0, countWithHint({"b.x": 2}, {"b.x": 1}));
+    assert.eq(1, countWithHint({"b.x": 5}, {"b.x": 1}));
+    assert.eq(1, countWithHint({a: 3}, {a: 1}));
+
+    // A path which only appears in a partial index's filter brings the document into the index.
+    assert.writeOK(coll.update({_id: 0}, {$set: {c: 1}}));
+    assert.eq(1, countWithHint({d: 1, c: {$gt: 0}}, {d: 1}));
+
+    // A path which no index covers.
+    assert.writeOK(coll.update({_id: 0}, {$inc: {e: 1}}));
+    assert.eq(1, countWithHint({a: 1}, {a: 1}));
+    assert.eq(1, countWithHint({d: 1, c: {$gt: 0}}, {d: 1}));
+
+    // A replacement can change every index.
+    assert.writeOK(coll.update({_id: 0}, {a: 7, b: {x: 8}, c: 1, d: 9}));
+    assert.eq(0, countWithHint({a: 3}, {a: 1}));
+    assert.eq(1, countWithHint({a: 7}, {a: 1}));
+    assert.eq(1, countWithHint({"b.x": 8}, {"b.x": 1}));
+    assert.eq(1, countWithHint({d: 9, c: {$gt: 0}}, {d: 1}));
+
+    var res = coll.validate(true);
+    assert.commandWorked(res);
+    assert(res.valid, tojson(res));
+})();
@@ -0,0 +1,24 @@
+// Tests the background mode of the validate command.
+(function() {
+    "use strict";
+
+    var t = db.validate_background;
+    t.drop();
+
+    for (var i = 0; i < 100; i++) {
+        assert.writeOK(t.insert({_id: i, a: i % 10, b: -i}));
+    }
+    assert.commandWorked(t.ensureIndex({a: 1}));
+    assert.commandWorked(t.ensureIndex({b: -1, a: 1}));
+
+    var res = t.validate({background: true});
+    assert.commandWorked(res);
+    assert(res.valid, tojson(res));
+    assert(res.background, tojson(res));
+    assert.eq(100, res.nrecords, tojson(res));
+    assert.eq(3, res.nIndexes, tojson(res));
+    assert.eq(100, res.keysPerIndex[t.getFullName() + ".$a_1"], tojson(res));
+    assert.eq(100, res.keysPerIndex[t.getFullName() + ".$b_-1_a_1"], tojson(res));
+
+    assert.commandFailed(db.runCommand({validate: t.getName(), background: true, full: true}));
+})();
@@ -0,0 +1,102 @@
+// Helpers for the perf_regression suite. Each benchmark runs a warmup trial followed by a fixed
+// number of measured trials, and reports the throughput of every trial together with its mean,
+// standard deviation and coefficient of variation, so that buildscripts/perf_results.py can tell
+// a regression from noise.
+//
+// Results are printed one per line, prefixed with PERF_RESULT_MARKER, in the format mongo-perf
+// produces:
+//   {name: <string>, results: {<threads>: {ops_per_sec: <mean>, ops_per_sec_values: [...],
+//                                          stddev: <number>, cv: <number>}}}
+
+var PERF_RESULT_MARKER = "PERF_RESULT: ";
+
+var PerfHarness = (function() {
+    "use strict";
+
+    var kDefaultTrials = 5;
+    var kDefaultSeconds = 5;
+
+    /**
+     * Returns the mean, standard deviation and coefficient of variation of 'values'.
+     */
+    function summarize(values) {
+        var sum = values.reduce(function(total, value) {
+            return total + value;
+        }, 0);
+        var mean = sum / values.length;
+        var squares = values.reduce(function(total, value) {
+            return total + (value - mean) * (value - mean);
+        }, 0);
+        var stddev = values.length > 1 ? Math.sqrt(squares / (values.length - 1)) : 0;
+        return {mean: mean, stddev: stddev, cv: mean > 0 ? stddev / mean : 0};
+    }
+
+    function report(name, threads, values) {
+        var stats = summarize(values);
+        var results = {};
+        results[threads] = {
+            ops_per_sec: stats.mean,
+            ops_per_sec_values: values,
+            stddev: stats.stddev,
+            cv: stats.cv
+        };
+        var result = {name: name, results: results};
+        print(PERF_RESULT_MARKER + JSON.stringify(result));
+        return result;
+    }
+
+    /**
+     * Runs 'ops' with benchRun against 'conn' once for warmup and then 'options.trials' times,
+     * calling 'options.setup' (if any) before each trial. Reports operations per second.
+     */
+    function runBenchRun(conn, name, ops, options) {
+        options = options || {};
+        var trials = options.trials || kDefaultTrials;
+        var threads = options.threads || 1;
+        var values = [];
+
+        for (var trial = -1; trial < trials; trial++) {
+            if (options.setup) {
+                options.setup();
+            }
+            var res = benchRun({
+                ops: ops,
+                parallel: threads,
+                seconds: options.seconds || kDefaultSeconds,
+                host: conn.host
+            });
+            assert.eq(0, res.errCount, name + " had errors: " + tojson(res));
+            // The first trial only warms the caches.
+            if (trial >= 0) {
+                values.push(res["totalOps/s"]);
+            }
+        }
+        return report(name, threads, values);
+    }
+
+    /**
+     * Times 'op' once for warmup and then 'options.trials' times, calling 'options.setup' (if
+     * any) untimed before each run. 'op' returns the number of operations it performed, and the
+     * reported throughput is operations per second.
+     */
+    function runTimed(name, op, options) {
+        options = options || {};
+        var trials = options.trials || kDefaultTrials;
+        var values = [];
+
+        for (var trial = -1; trial < trials; trial++) {
+            if (options.setup) {
+                options.setup();
+            }
+            var start = Date.now();
+            var count = op();
+            var millis = Math.max(1, Date.now() - start);
+            if (trial >= 0) {
+                values.push(count * 1000 / millis);
+            }
+        }
+        return report(name, 1, values);
+    }
+
+    return {runBenchRun: runBenchRun, runTimed: runTimed, summarize: summarize};
+})();
@@ -0,0 +1,58 @@
+// Checks that awaitData getMores waiting on a capped collection return documents inserted while
+// they wait, both when inserts wake them immediately and when wakeups are coalesced.
+(function() {
+    'use strict';
+
+    var mongo = MongoRunner.runMongod({});
+    var db = mongo.getDB("test");
+    var collName = 'awaitdata_coalesced_wakeups';
+    var coll = db[collName];
+
+    assert.commandWorked(db.createCollection(collName, {capped: true, size: 1024 * 1024}));
+    assert.writeOK(coll.insert({a: 0}));
+
+    [0, 200 * 1000].forEach(function(coalesceMicros) {
+        assert.commandWorked(db.adminCommand(
+            {setParameter: 1, internalCappedInsertNotifyCoalesceMicros: coalesceMicros}));
+
+        // Several cursors wait at the end of the collection together.
+        var numWaiters = 5;
+        var shells = [];
+        for (var i = 0; i < numWaiters; i++) {
+            shells.push(startParallelShell(function() {
+                var cmdRes = db.runCommand({
+                    find: 'awaitdata_coalesced_wakeups',
+                    batchSize: 100,
+                    awaitData: true,
+                    tailable: true,
+                    maxTimeMS: 30 * 1000
+                });
+                assert.commandWorked(cmdRes);
+                var start = new Date();
+                cmdRes = db.runCommand({
+                    getMore: cmdRes.cursor.id,
+                    collection: 'awaitdata_coalesced_wakeups'
+                });
+                assert.commandWorked(cmdRes);
+                assert.gt(cmdRes.cursor.nextBatch.length, 0, tojson(cmdRes));
+                // Woken by the inserts, well before maxTimeMS.
+                assert.lt(new Date() - start, 20 * 1000, tojson(cmdRes));
+                assert.writeOK(db.awaitdata_coalesced_wakeups_done.insert({}));
+            }, mongo.port));
+        }
+
+        // Keep inserting, slower than the waiters take to come back for more, until every waiter
+        // has been woken.
+        assert.soon(function() {
+            assert.writeOK(coll.insert({a: 1}));
+            sleep(100);
+            return db.awaitdata_coalesced_wakeups_done.count() == numWaiters;
+        });
+        assert.writeOK(db.awaitdata_coalesced_wakeups_done.remove({}));
+        shells.forEach(function(join) {
+            join();
+        });
+    });
+
+    MongoRunner.stopMongod(mongo);
+})();
@@ -0,0 +1,55 @@
+// Tests the beginBackup and endBackup commands, including incremental backups.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    assert.neq(null, conn, "mongod failed to start");
+    var admin = conn.getDB("admin");
+    var testDB = conn.getDB("test");
+
+    if (testDB.serverStatus().storageEngine.name !== "wiredTiger") {
+        assert.commandFailedWithCode(admin.runCommand({beginBackup: 1}),
+                                     ErrorCodes.CommandNotSupported);
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    assert.writeOK(testDB.a.insert({x: 1}));
+    assert.writeOK(testDB.b.insert({x: 1}));
+
+    function identFile(coll) {
+        return coll.stats().wiredTiger.uri.split("table:")[1] + ".wt";
+    }
+
+    function beginBackup(cmd) {
+        var res = admin.runCommand(cmd);
+        assert.commandWorked(res);
+        assert.eq(0, res.cursor.id, tojson(res));
+        var files = {};
+        res.cursor.firstBatch.forEach(function(file) {
+            files[file.filename] = file;
+        });
+        return {backupTime: res.backupTime, files: files};
+    }
+
+    var full = beginBackup({beginBackup: 1});
+    assert(full.files.hasOwnProperty(identFile(testDB.a)), tojson(full));
+    assert(full.files[identFile(testDB.a)].changed, tojson(full));
+
+    // Only one backup can be pinned at a time, and writes are not blocked by it.
+    assert.commandFailed(admin.runCommand({beginBackup: 1}));
+    assert.writeOK(testDB.a.insert({x: 2}));
+    assert.commandWorked(admin.runCommand({endBackup: 1}));
+
+    // File modification times have a resolution of seconds.
+    sleep(2000);
+    assert.writeOK(testDB.a.insert({x: 3}));
+
+    var incremental = beginBackup({beginBackup: 1, incrementalSince: full.backupTime});
+    assert(incremental.files[identFile(testDB.a)].changed, tojson(incremental));
+    assert.commandWorked(admin.runCommand({endBackup: 1}));
+
+    assert.commandFailed(admin.runCommand({beginBackup: 1, incrementalSince: 5}));
+
+    MongoRunner.stopMongod(conn);
+})();
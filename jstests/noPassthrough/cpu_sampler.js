@@ -0,0 +1,49 @@
+// Checks that the built-in CPU sampler tags its samples with the operations being run.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    var admin = conn.getDB("admin");
+    var coll = conn.getDB("test").cpu_sampler;
+
+    if (admin.hostInfo().os.type != "Linux") {
+        jsTestLog("Skipping test because the CPU sampler is only supported on Linux");
+        MongoRunner.stopMongod(conn);
+        return;
+    }
+
+    assert.commandFailedWithCode(admin.runCommand({_cpuSamplerStop: 1}),
+                                 ErrorCodes.IllegalOperation);
+    assert.commandFailedWithCode(admin.runCommand({_cpuSamplerStart: 1, periodMicros: 1}),
+                                 ErrorCodes.BadValue);
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, a: i % 10});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(admin.runCommand({_cpuSamplerStart: 1, periodMicros: 1000}));
+    assert.commandFailedWithCode(admin.runCommand({_cpuSamplerStart: 1}),
+                                 ErrorCodes.ConflictingOperationInProgress);
+
+    // Run unindexed queries until some of them have been sampled.
+    var res;
+    assert.soon(function() {
+        for (var i = 0; i < 20; i++) {
+            assert.eq(100, coll.find({a: i % 10}).itcount());
+        }
+        res = assert.commandWorked(admin.runCommand({_cpuSamplerStop: 1}));
+        var found = res.stacks.some(function(entry) {
+            return entry.stack.indexOf("find test.cpu_sampler;") == 0;
+        });
+        if (!found) {
+            assert.commandWorked(admin.runCommand({_cpuSamplerStart: 1, periodMicros: 1000}));
+        }
+        return found;
+    });
+
+    assert.gt(res.samples, 0, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+})();
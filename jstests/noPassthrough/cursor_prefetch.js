@@ -0,0 +1,59 @@
+// Tests that cursors read ahead with cursorPrefetchBytes return the same results as without it.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: "cursorPrefetchBytes=4096"});
+    assert.neq(null, conn, "mongod failed to start");
+    var testDB = conn.getDB("test");
+    var coll = testDB.cursor_prefetch;
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, pad: new Array(101).join("x")});
+    }
+    assert.writeOK(bulk.execute());
+
+    function readAll(cmd) {
+        var res = assert.commandWorked(testDB.runCommand(cmd));
+        var ids = res.cursor.firstBatch.map(function(doc) {
+            return doc._id;
+        });
+        while (res.cursor.id != 0) {
+            res = assert.commandWorked(testDB.runCommand(
+                {getMore: res.cursor.id, collection: coll.getName(), batchSize: 7}));
+            res.cursor.nextBatch.forEach(function(doc) {
+                ids.push(doc._id);
+            });
+        }
+        return ids;
+    }
+
+    // Batches are served in order, across several read-aheads.
+    var ids = readAll({find: coll.getName(), sort: {_id: 1}, batchSize: 5});
+    assert.eq(1000, ids.length);
+    for (var i = 0; i < ids.length; i++) {
+        assert.eq(i, ids[i]);
+    }
+
+    // The same holds for a plan which has to fetch documents through an index.
+    assert.commandWorked(coll.createIndex({pad: 1, _id: 1}));
+    ids = readAll({find: coll.getName(), filter: {pad: {$ne: null}}, hint: {pad: 1, _id: 1}});
+    assert.eq(1000, ids.length);
+
+    // Killing a cursor with a finished read-ahead frees it.
+    var res = assert.commandWorked(testDB.runCommand({find: coll.getName(), batchSize: 2}));
+    assert.soon(function() {
+        var killed = testDB.runCommand({killCursors: coll.getName(), cursors: [res.cursor.id]});
+        return killed.ok && killed.cursorsKilled.length == 1;
+    });
+    assert.commandFailedWithCode(
+        testDB.runCommand({getMore: res.cursor.id, collection: coll.getName()}),
+        ErrorCodes.CursorNotFound);
+
+    // Dropping the collection kills its prefetched cursors.
+    res = assert.commandWorked(testDB.runCommand({find: coll.getName(), batchSize: 2}));
+    coll.drop();
+    assert.commandFailed(testDB.runCommand({getMore: res.cursor.id, collection: coll.getName()}));
+
+    MongoRunner.stopMongod(conn);
+}());
@@ -0,0 +1,35 @@
+// Checks that the inMemoryExperiment storage engine delays commits by the configured simulated
+// latency, and that the delay can be changed at runtime.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod(
+        {storageEngine: "inMemoryExperiment", setParameter: "inMemorySimulatedCommitMicros=20000"});
+    assert.neq(null, conn, "mongod failed to start with the inMemoryExperiment storage engine");
+    var coll = conn.getDB("test").in_memory_simulated_latency;
+
+    function timeInserts(n) {
+        var start = new Date();
+        for (var i = 0; i < n; i++) {
+            assert.writeOK(coll.insert({i: i}));
+        }
+        return new Date() - start;
+    }
+
+    // Each insert commits at least once.
+    assert.gte(timeInserts(10), 200);
+
+    var res = conn.adminCommand({setParameter: 1, inMemorySimulatedCommitMicros: 0});
+    assert.commandWorked(res);
+    assert.eq(20000, res.was);
+    timeInserts(10);
+
+    assert.commandWorked(conn.adminCommand({
+        setParameter: 1,
+        inMemorySimulatedReadMicros: 1000,
+        inMemorySimulatedLatencyExponential: true
+    }));
+    assert.eq(20, coll.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,51 @@
+// Basic operation of mongod with the ASIO-multiplexed ingress mode, where connections do not
+// each get a dedicated thread.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: "inboundNetworkImpl=ASIO"});
+    assert.neq(null, conn, "mongod failed to start with inboundNetworkImpl=ASIO");
+
+    var res = conn.getDB("admin").runCommand({getParameter: 1, inboundNetworkImpl: 1});
+    assert.commandWorked(res);
+    assert.eq("ASIO", res.inboundNetworkImpl);
+
+    // Open many more connections than there are worker threads at startup and interleave
+    // operations on them, so that each connection's messages are handled by several threads.
+    var conns = [];
+    for (var i = 0; i < 50; i++) {
+        conns.push(new Mongo(conn.host));
+    }
+    for (var round = 0; round < 5; round++) {
+        conns.forEach(function(c, i) {
+            var coll = c.getDB("test").asio;
+            assert.writeOK(coll.insert({conn: i, round: round}));
+            assert.eq(round + 1, coll.find({conn: i}).itcount());
+        });
+    }
+
+    // Per-connection state, such as the last error, must follow the connection across threads.
+    conns.forEach(function(c, i) {
+        c.forceWriteMode("legacy");
+        var db = c.getDB("test");
+        db.asio.insert({_id: "dup" + i});
+        db.asio.insert({_id: "dup" + i});
+        assert.eq(11000, db.getLastErrorObj().code);
+    });
+
+    // A result set spanning several getMores.
+    var coll = conn.getDB("test").asio;
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({big: new Array(1024).join("x")});
+    }
+    assert.writeOK(bulk.execute());
+    assert.eq(1000, coll.find({big: {$exists: true}}).batchSize(10).itcount());
+
+    // Messages larger than the socket buffers must be reassembled before being processed.
+    var huge = new Array(4 * 1024 * 1024).join("y");
+    assert.writeOK(coll.insert({_id: "huge", s: huge}));
+    assert.eq(huge.length, coll.findOne({_id: "huge"}).s.length);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,24 @@
+// Checks that a server accepting connections on several threads serves them all, and reports its
+// listener counters in serverStatus.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: "listenerThreads=4"});
+    var admin = conn.getDB("admin");
+
+    var before = assert.commandWorked(admin.serverStatus()).network.listener;
+    var kConnections = 20;
+    var conns = [];
+    for (var i = 0; i < kConnections; i++) {
+        conns.push(new Mongo(conn.host));
+        assert.commandWorked(conns[i].getDB("admin").runCommand({ping: 1}));
+    }
+
+    var after = assert.commandWorked(admin.serverStatus()).network.listener;
+    assert.eq(4, after.acceptThreads, tojson(after));
+    assert.gte(after.accepted - before.accepted, kConnections, tojson(after));
+    assert.gte(after.firstMessages - before.firstMessages, kConnections, tojson(after));
+    assert.gte(after.acceptWakeups, 1, tojson(after));
+
+    MongoRunner.stopMongod(conn);
+})();
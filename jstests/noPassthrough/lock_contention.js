@@ -0,0 +1,43 @@
+// Checks that the lockContention command reports the waits of lock requests while
+// lockContentionProfiling is on, along with the operations which held the lock.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({setParameter: "lockContentionProfiling=true"});
+    assert.neq(null, conn, "mongod failed to start");
+    var db = conn.getDB("test");
+    var admin = conn.getDB("admin");
+
+    assert.writeOK(db.lock_contention.insert({_id: 0}));
+    assert.commandWorked(admin.runCommand({lockContention: 1, reset: true}));
+
+    // An insert waits for the global lock while fsyncLock holds it.
+    assert.commandWorked(admin.runCommand({fsync: 1, lock: 1}));
+    var insert = startParallelShell(function() {
+        assert.writeOK(db.getSiblingDB("test").lock_contention.insert({_id: 1}));
+    }, conn.port);
+
+    assert.soon(function() {
+        return admin.currentOp({waitingForLock: true, ns: "test.lock_contention"}).inprog.length >
+            0;
+    });
+    sleep(100);
+    assert.commandWorked(admin.fsyncUnlock());
+    insert();
+
+    var res = admin.runCommand({lockContention: 1});
+    assert.commandWorked(res);
+    assert(res.profiling, tojson(res));
+    var global = res.resources.filter(function(resource) {
+        return resource.type === "Global";
+    });
+    assert.eq(1, global.length, tojson(res));
+    assert.gte(global[0].numWaits, 1, tojson(res));
+    assert.gte(global[0].totalWaitMicros, 100 * 1000, tojson(res));
+    assert.gt(global[0].recentWaits.length, 0, tojson(res));
+    assert.gt(global[0].recentWaits[0].holderOpids.length, 0, tojson(res));
+
+    assert.commandFailed(admin.runCommand({lockContention: 1, top: 0}));
+
+    MongoRunner.stopMongod(conn);
+})();
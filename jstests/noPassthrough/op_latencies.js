@@ -0,0 +1,43 @@
+// Checks that serverStatus reports the latencies of reads, writes and commands, and reports their
+// histograms only when asked to.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    var testDB = conn.getDB("test");
+    var coll = testDB.op_latencies;
+
+    function getLatencies(options) {
+        var res = testDB.serverStatus({opLatencies: options});
+        assert.commandWorked(res);
+        return res.opLatencies;
+    }
+
+    var before = getLatencies({});
+    assert.writeOK(coll.insert({_id: 0}));
+    assert.eq(1, coll.find().itcount());
+    assert.commandWorked(testDB.runCommand({count: coll.getName()}));
+
+    // The find and count commands count as commands, not reads.
+    var after = getLatencies({});
+    ["writes", "commands"].forEach(function(opType) {
+        assert.gt(after[opType].ops, before[opType].ops, tojson(after));
+        assert.gte(after[opType].latency, before[opType].latency, tojson(after));
+    });
+    ["reads", "writes", "commands"].forEach(function(opType) {
+        assert(!after[opType].hasOwnProperty("histogram"), tojson(after));
+    });
+
+    var withHistograms = getLatencies({histograms: true});
+    var totalCount = 0;
+    withHistograms.commands.histogram.forEach(function(bucket) {
+        totalCount += bucket.count;
+    });
+    assert.eq(withHistograms.commands.ops, totalCount, tojson(withHistograms));
+
+    var top = conn.getDB("admin").runCommand({top: 1});
+    assert.commandWorked(top);
+    assert.gte(top.totals[coll.getFullName()].latencyStats.writes.ops, 1, tojson(top));
+
+    MongoRunner.stopMongod(conn);
+})();
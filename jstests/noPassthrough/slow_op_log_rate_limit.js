@@ -0,0 +1,33 @@
+// Checks that slowOpLogRateLimit bounds the number of slow operations logged per second, counts
+// the ones it does not log, and that the server runs with its log file written asynchronously.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({
+        slowms: 0,
+        setParameter: {slowOpLogRateLimit: 1, logFileQueueSize: 100},
+        logpath: MongoRunner.dataPath + "slow_op_log_rate_limit.log"
+    });
+    assert.neq(null, conn, "mongod failed to start");
+    var coll = conn.getDB("test").slow_op_log_rate_limit;
+
+    function notLogged() {
+        return conn.adminCommand({serverStatus: 1}).metrics.log.slowOpsNotLogged;
+    }
+
+    var before = notLogged();
+    for (var i = 0; i < 20; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    assert.gt(notLogged(), before);
+
+    assert.commandWorked(conn.adminCommand({setParameter: 1, slowOpLogRateLimit: 0}));
+    before = notLogged();
+    for (var i = 20; i < 40; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+    }
+    assert.eq(before, notLogged());
+    assert.eq(40, coll.find().itcount());
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,43 @@
+// Checks that startRecordingTraffic writes the server's traffic to a file in the configured
+// directory, and that the file name may not escape it.
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    var admin = conn.getDB("admin");
+    assert.commandFailedWithCode(admin.runCommand({startRecordingTraffic: 1, filename: "t"}),
+                                 ErrorCodes.IllegalOperation);
+    MongoRunner.stopMongod(conn);
+
+    var dir = MongoRunner.dataPath;
+    conn = MongoRunner.runMongod({setParameter: "trafficRecordingDirectory=" + dir});
+    admin = conn.getDB("admin");
+    var coll = conn.getDB("test").traffic_recording;
+
+    assert.commandFailedWithCode(admin.runCommand({stopRecordingTraffic: 1}),
+                                 ErrorCodes.IllegalOperation);
+    assert.commandFailedWithCode(
+        admin.runCommand({startRecordingTraffic: 1, filename: "../traffic"}), ErrorCodes.BadValue);
+
+    assert.commandWorked(admin.runCommand({startRecordingTraffic: 1, filename: "traffic.bin"}));
+    assert.commandFailedWithCode(
+        admin.runCommand({startRecordingTraffic: 1, filename: "other.bin"}),
+        ErrorCodes.ConflictingOperationInProgress);
+
+    for (var i = 0; i < 10; i++) {
+        assert.writeOK(coll.insert({_id: i}));
+        assert.eq(1, coll.find({_id: i}).itcount());
+    }
+
+    var res = assert.commandWorked(admin.runCommand({stopRecordingTraffic: 1}));
+    assert.eq(false, res.recording);
+    assert.gt(res.records, 40, tojson(res));
+
+    var file = listFiles(dir).filter(function(f) {
+        return f.baseName == "traffic.bin";
+    })[0];
+    assert(file, "recording not found in " + dir);
+    assert.eq(res.bytesWritten + 8, file.size, tojson(res));
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,47 @@
+// Checks that the TTL monitor deletes the expired documents of several TTL indexes in small,
+// throttled batches, and reports how far behind each index is.
+(function() {
+    "use strict";
+
+    var runner = MongoRunner.runMongod({
+        setParameter: {
+            ttlMonitorSleepSecs: 1,
+            ttlMonitorBatchSize: 10,
+            ttlMonitorMaxDeletesPerSecond: 1000
+        }
+    });
+    var db = runner.getDB("test");
+
+    var past = new Date(new Date().getTime() - 3600 * 1000);
+    var colls = [db.ttl_batched_a, db.ttl_batched_b];
+    colls.forEach(function(coll) {
+        coll.drop();
+        assert.commandWorked(coll.ensureIndex({x: 1}, {expireAfterSeconds: 0}));
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < 500; i++) {
+            bulk.insert({x: past});
+        }
+        // Neither documents which have not expired yet nor ones without a date are deleted.
+        bulk.insert({x: new Date(new Date().getTime() + 3600 * 1000)});
+        bulk.insert({x: 1});
+        assert.writeOK(bulk.execute());
+    });
+
+    assert.soon(function() {
+        return colls.every(function(coll) {
+            return coll.count() == 2;
+        });
+    }, "TTL monitor didn't delete the expired documents", 60 * 1000);
+
+    // Once a pass finds nothing more to delete, neither index is behind.
+    var ttlPass = db.serverStatus().metrics.ttl.passes;
+    assert.soon(function() {
+        return db.serverStatus().metrics.ttl.passes >= ttlPass + 2;
+    });
+    var backlog = db.serverStatus().metrics.ttl.backlogSecs;
+    colls.forEach(function(coll) {
+        assert.eq(0, backlog[coll.getFullName() + ".$x_1"], tojson(backlog));
+    });
+
+    MongoRunner.stopMongod(runner);
+})();
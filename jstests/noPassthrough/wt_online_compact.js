@@ -0,0 +1,52 @@
+/**
+ * This test is only for WiredTiger storageEngine
+ * Test that compact holds only intent locks, so that the collection can be written while it runs,
+ * and that it reclaims the space freed by removing most of the collection.
+ */
+(function() {
+    "use strict";
+
+    // This test can only be run if the storageEngine is wiredTiger
+    if (jsTest.options().storageEngine && jsTest.options().storageEngine !== "wiredTiger") {
+        jsTestLog("Skipping test because storageEngine is not wiredTiger");
+        return;
+    }
+
+    var conn = MongoRunner.runMongod({storageEngine: "wiredTiger"});
+    var db = conn.getDB("test");
+    var coll = db.wt_online_compact;
+
+    var padding = new Array(1024).join("x");
+    for (var i = 0; i < 20; i++) {
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var j = 0; j < 1000; j++) {
+            bulk.insert({_id: i * 1000 + j, padding: padding});
+        }
+        assert.writeOK(bulk.execute());
+    }
+    assert.writeOK(coll.remove({_id: {$gte: 1000}}));
+    assert.commandWorked(db.adminCommand({fsync: 1}));
+    var sizeBefore = coll.stats().storageSize;
+
+    // Writes to the collection, and to another one in the same database, go on while compact
+    // runs.
+    var writer = startParallelShell(function() {
+        var ops = 0;
+        while (!db.wt_online_compact_done.findOne()) {
+            assert.writeOK(db.wt_online_compact.insert({x: ops}));
+            assert.writeOK(db.wt_online_compact_other.insert({x: ops}));
+            ops++;
+        }
+        assert.writeOK(db.wt_online_compact_done.insert({ops: ops}));
+    }, conn.port);
+
+    assert.commandWorked(coll.runCommand("compact"));
+    assert.writeOK(db.wt_online_compact_done.insert({}));
+    writer();
+
+    assert.eq(1000, coll.find({_id: {$lt: 1000}}).itcount());
+    assert.eq(1, db.wt_online_compact_done.find({ops: {$exists: true}}).itcount());
+    assert.lt(coll.stats().storageSize, sizeBefore);
+
+    MongoRunner.stopMongod(conn);
+})();
@@ -0,0 +1,33 @@
+// Throughput of common aggregation stages over an in-memory collection.
+load("jstests/libs/perf_harness.js");
+
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    var coll = conn.getDB("perf").aggregation;
+    var ns = coll.getFullName();
+
+    coll.drop();
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, group: i % 100, value: i % 997, tags: ["a", "b", "c"]});
+    }
+    assert.writeOK(bulk.execute());
+    assert.commandWorked(coll.createIndex({group: 1}));
+
+    var pipelines = {
+        "aggregation.matchIndexed": [{$match: {group: {"#RAND_INT": [0, 100]}}}],
+        "aggregation.group": [{$group: {_id: "$group", total: {$sum: "$value"}}}],
+        "aggregation.sortLimit": [{$sort: {value: -1}}, {$limit: 10}],
+        "aggregation.project": [{$project: {doubled: {$multiply: ["$value", 2]}}}, {$limit: 1000}],
+        "aggregation.unwindGroup": [{$unwind: "$tags"}, {$group: {_id: "$tags", n: {$sum: 1}}}],
+    };
+
+    Object.keys(pipelines).forEach(function(name) {
+        PerfHarness.runBenchRun(
+            conn, name, [{op: "aggregate", ns: ns, pipeline: pipelines[name]}], {threads: 2});
+    });
+
+    MongoRunner.stopMongod(conn);
+})();
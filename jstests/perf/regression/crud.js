@@ -0,0 +1,59 @@
+// Throughput of single-document inserts, point reads, updates and removes.
+load("jstests/libs/perf_harness.js");
+
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    var coll = conn.getDB("perf").crud;
+    var ns = coll.getFullName();
+    var kDocs = 10000;
+
+    function populate() {
+        coll.drop();
+        var bulk = coll.initializeUnorderedBulkOp();
+        for (var i = 0; i < kDocs; i++) {
+            bulk.insert({_id: i, x: i, s: "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx"});
+        }
+        assert.writeOK(bulk.execute());
+        assert.commandWorked(coll.createIndex({x: 1}));
+    }
+
+    var randomId = {"#RAND_INT": [0, kDocs]};
+
+    [1, 4].forEach(function(threads) {
+        PerfHarness.runBenchRun(
+            conn,
+            "crud.insert",
+            [{op: "insert", ns: ns, doc: {x: randomId, s: "xxxxxxxx"}, writeCmd: true}],
+            {threads: threads, setup: function() { coll.drop(); }});
+
+        PerfHarness.runBenchRun(conn,
+                                "crud.findOneById",
+                                [{op: "findOne", ns: ns, query: {_id: randomId}}],
+                                {threads: threads, setup: populate});
+
+        PerfHarness.runBenchRun(
+            conn,
+            "crud.updateById",
+            [{
+              op: "update",
+              ns: ns,
+              query: {_id: randomId},
+              update: {$inc: {x: 1}},
+              writeCmd: true
+            }],
+            {threads: threads, setup: populate});
+
+        PerfHarness.runBenchRun(
+            conn,
+            "crud.insertAndRemove",
+            [
+              {op: "insert", ns: ns, doc: {x: randomId}, writeCmd: true},
+              {op: "remove", ns: ns, query: {x: randomId}, writeCmd: true}
+            ],
+            {threads: threads, setup: populate});
+    });
+
+    MongoRunner.stopMongod(conn);
+})();
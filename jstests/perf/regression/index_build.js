@@ -0,0 +1,33 @@
+// Rate at which a foreground index build indexes an existing collection.
+load("jstests/libs/perf_harness.js");
+
+(function() {
+    "use strict";
+
+    var conn = MongoRunner.runMongod({});
+    var coll = conn.getDB("perf").index_build;
+    var kDocs = 100000;
+
+    coll.drop();
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < kDocs; i++) {
+        bulk.insert({_id: i, a: Random.randInt(kDocs), b: "k" + (i % 1000)});
+    }
+    assert.writeOK(bulk.execute());
+
+    var dropIndexes = function() {
+        assert.commandWorked(coll.dropIndexes());
+    };
+
+    PerfHarness.runTimed("index_build.int", function() {
+        assert.commandWorked(coll.createIndex({a: 1}));
+        return kDocs;
+    }, {setup: dropIndexes});
+
+    PerfHarness.runTimed("index_build.compound", function() {
+        assert.commandWorked(coll.createIndex({b: 1, a: -1}));
+        return kDocs;
+    }, {setup: dropIndexes});
+
+    MongoRunner.stopMongod(conn);
+})();
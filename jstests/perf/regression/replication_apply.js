@@ -0,0 +1,42 @@
+// Rate at which a secondary applies a burst of inserts written on the primary.
+load("jstests/libs/perf_harness.js");
+
+(function() {
+    "use strict";
+
+    var rst = new ReplSetTest({nodes: 2});
+    rst.startSet();
+    rst.initiate();
+
+    var primary = rst.getPrimary();
+    var secondary = rst.getSecondary();
+    var coll = primary.getDB("perf").replication_apply;
+    var kDocs = 20000;
+
+    // Applying is timed from when the writes are stopped on the secondary until it has caught
+    // up, so that the primary's write rate does not bound the measurement.
+    function stopApplying() {
+        assert.commandWorked(secondary.adminCommand(
+            {configureFailPoint: "rsSyncApplyStop", mode: "alwaysOn"}));
+    }
+
+    PerfHarness.runTimed("replication_apply.insert", function() {
+        assert.commandWorked(secondary.adminCommand(
+            {configureFailPoint: "rsSyncApplyStop", mode: "off"}));
+        rst.awaitReplication();
+        return kDocs;
+    }, {
+        setup: function() {
+            coll.drop();
+            rst.awaitReplication();
+            stopApplying();
+            var bulk = coll.initializeUnorderedBulkOp();
+            for (var i = 0; i < kDocs; i++) {
+                bulk.insert({_id: i, x: i});
+            }
+            assert.writeOK(bulk.execute());
+        }
+    });
+
+    rst.stopSet();
+})();
@@ -0,0 +1,44 @@
+// Throughput of queries that mongos has to send to every shard.
+load("jstests/libs/perf_harness.js");
+
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2, mongos: 1});
+    var mongos = st.s0;
+    var db = mongos.getDB("perf");
+    var coll = db.scatter_gather;
+    var ns = coll.getFullName();
+
+    assert.commandWorked(mongos.adminCommand({enableSharding: db.getName()}));
+    st.ensurePrimaryShard(db.getName(), "shard0000");
+    assert.commandWorked(mongos.adminCommand({shardCollection: ns, key: {_id: 1}}));
+    assert.commandWorked(mongos.adminCommand({split: ns, middle: {_id: 5000}}));
+    assert.commandWorked(
+        mongos.adminCommand({moveChunk: ns, find: {_id: 5000}, to: "shard0001"}));
+
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 10000; i++) {
+        bulk.insert({_id: i, x: i % 100});
+    }
+    assert.writeOK(bulk.execute());
+
+    PerfHarness.runBenchRun(
+        mongos,
+        "sharded.scatterGatherFind",
+        [{op: "find", ns: ns, query: {x: {"#RAND_INT": [0, 100]}}}],
+        {threads: 2});
+
+    PerfHarness.runBenchRun(
+        mongos,
+        "sharded.scatterGatherCount",
+        [{op: "command", ns: db.getName(), command: {count: coll.getName(), query: {x: 1}}}],
+        {threads: 2});
+
+    PerfHarness.runBenchRun(mongos,
+                            "sharded.targetedFindOne",
+                            [{op: "findOne", ns: ns, query: {_id: {"#RAND_INT": [0, 10000]}}}],
+                            {threads: 2});
+
+    st.stop();
+})();
@@ -0,0 +1,46 @@
+// Checks that DBCollection.watch() returns the oplog entries of one collection, filtered by
+// operation type on the server, and can resume from the last entry it returned.
+(function() {
+    "use strict";
+
+    var rst = new ReplSetTest({nodes: 1});
+    rst.startSet();
+    rst.initiate();
+
+    var db = rst.getPrimary().getDB("test");
+    var coll = db.collection_watch;
+    var other = db.collection_watch_other;
+    assert.writeOK(coll.insert({_id: 0}));
+
+    var cursor = coll.watch({operationTypes: ['i', 'd'], projection: {ts: 1, op: 1, o: 1}});
+    assert.writeOK(other.insert({_id: 1}));
+    assert.writeOK(coll.insert({_id: 1}));
+    assert.writeOK(coll.update({_id: 1}, {$set: {a: 1}}));
+    assert.writeOK(coll.remove({_id: 0}));
+
+    var entries = [];
+    assert.soon(function() {
+        while (cursor.hasNext()) {
+            entries.push(cursor.next());
+        }
+        return entries.length >= 2;
+    });
+    assert.eq(2, entries.length, tojson(entries));
+    assert.eq({op: 'i', o: {_id: 1}}, {op: entries[0].op, o: entries[0].o}, tojson(entries));
+    assert.eq({op: 'd', o: {_id: 0}}, {op: entries[1].op, o: entries[1].o}, tojson(entries));
+    assert(!entries[0].hasOwnProperty('ns'), tojson(entries));
+
+    // A new cursor picks up after the last entry seen.
+    assert.writeOK(coll.insert({_id: 2}));
+    var resumed = coll.watch({resumeAfter: entries[0].ts, operationTypes: ['i', 'd']});
+    var ids = [];
+    assert.soon(function() {
+        while (resumed.hasNext()) {
+            ids.push(resumed.next().o._id);
+        }
+        return ids.length >= 2;
+    });
+    assert.eq([0, 2], ids);
+
+    rst.stopSet();
+})();
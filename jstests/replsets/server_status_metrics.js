@@ -26,6 +26,27 @@ function testSecondaryMetrics(secondary, opCount, offset) {
     assert(ss.metrics.repl.apply.batches.num > 0, "no batches")
     assert(ss.metrics.repl.apply.batches.totalMillis > 0, "no batch time")
     assert.eq(ss.metrics.repl.apply.ops, opCount + offset, "wrong number of applied ops")
+
+    // the stages of each batch, between fetching and journaling
+    assert(ss.metrics.repl.buffer.pushes.num > 0, "no buffer pushes")
+    assert(ss.metrics.repl.apply.batchCollection.num > 0, "no batches collected")
+    assert(ss.metrics.repl.apply.oplogWrites.num > 0, "no oplog writes")
+    assert(ss.metrics.repl.apply.journalWaits.num >= 0, "journalWaits missing")
+    assert(ss.metrics.repl.apply.prefetch.num >= 0, "prefetch missing")
+
+    var batches = 0;
+    for (var bucket in ss.metrics.repl.apply.batchSizes) {
+        batches += ss.metrics.repl.apply.batchSizes[bucket];
+    }
+    assert.gte(batches, ss.metrics.repl.apply.batches.num, "batchSizes do not add up")
+
+    var writers = ss.metrics.repl.apply.writers;
+    assert(writers.tasks > 0, "no writer tasks")
+    assert(writers.threads.length > 0, "no writer threads")
+    writers.threads.forEach(function(thread) {
+        assert.gte(thread.busyMicros, 0, "busyMicros missing")
+        assert.gte(thread.idleMicros, 0, "idleMicros missing")
+    });
 }
 
 var rt = new ReplSetTest( { name : "server_status_metrics" , nodes: 2, oplogSize: 100 } );
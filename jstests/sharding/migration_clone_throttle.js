@@ -0,0 +1,41 @@
+//
+// Tests that a chunk migration clones every document of the chunk, across several clone batches,
+// and that the recipient holds the cloning rate under migrateCloneMaxBytesPerSecond.
+//
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2, mongos: 1});
+    st.stopBalancer();
+
+    var mongos = st.s0;
+    var admin = mongos.getDB("admin");
+    var shards = mongos.getDB("config").shards.find().toArray();
+    var coll = mongos.getCollection("foo.bar");
+
+    assert.commandWorked(admin.runCommand({enableSharding: coll.getDB() + ""}));
+    st.ensurePrimaryShard(coll.getDB() + "", shards[0]._id);
+    assert.commandWorked(admin.runCommand({shardCollection: coll + "", key: {_id: 1}}));
+
+    // About 4MB of documents, which the donor sends in several batches.
+    var padding = new Array(4 * 1024).join("x");
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 1000; i++) {
+        bulk.insert({_id: i, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+
+    assert.commandWorked(st.shard1.getDB("admin").runCommand(
+        {setParameter: 1, migrateCloneMaxBytesPerSecond: 1024 * 1024}));
+
+    var start = new Date();
+    assert.commandWorked(
+        admin.runCommand({moveChunk: coll + "", find: {_id: 0}, to: shards[1]._id}));
+    var elapsedMillis = new Date() - start;
+
+    assert.eq(1000, st.shard1.getCollection(coll + "").count());
+    assert.eq(1000, coll.find().itcount());
+    assert.gte(elapsedMillis, 3000, "migration was not throttled");
+
+    st.stop();
+})();
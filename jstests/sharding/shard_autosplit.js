@@ -0,0 +1,36 @@
+//
+// Tests that a shard primary splits its chunks as data is inserted into them when shardAutoSplit
+// is set, even though the routers don't autosplit.
+//
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 1, mongos: 1, other: {mongosOptions: {noAutoSplit: ""}}});
+
+    var mongos = st.s0;
+    var admin = mongos.getDB("admin");
+    var config = mongos.getDB("config");
+    var coll = mongos.getCollection("foo.bar");
+
+    assert.commandWorked(admin.runCommand({enableSharding: coll.getDB() + ""}));
+    assert.commandWorked(admin.runCommand({shardCollection: coll + "", key: {_id: 1}}));
+
+    assert.commandWorked(st.shard0.getDB("admin").runCommand(
+        {setParameter: 1, shardAutoSplit: true, shardAutoSplitChunkSizeMB: 1}));
+
+    var padding = new Array(1024).join("x");
+    var bulk = coll.initializeUnorderedBulkOp();
+    for (var i = 0; i < 4 * 1024; i++) {
+        bulk.insert({_id: i, padding: padding});
+    }
+    assert.writeOK(bulk.execute());
+
+    // The splits run in the background on the shard.
+    assert.soon(function() {
+        return config.chunks.find({ns: coll + ""}).count() > 1;
+    }, "shard did not split the chunk");
+
+    assert.eq(4 * 1024, coll.find().itcount());
+
+    st.stop();
+})();
@@ -0,0 +1,53 @@
+// Checks that unordered inserts which mongos merges with other clients' inserts report their own
+// results, and that the documents all get written.
+(function() {
+    "use strict";
+
+    var st = new ShardingTest({shards: 2, mongos: 1});
+    var mongos = st.s0;
+    var admin = mongos.getDB("admin");
+    var coll = mongos.getCollection("test.write_coalescing");
+
+    assert.commandWorked(admin.runCommand({enableSharding: "test"}));
+    st.ensurePrimaryShard("test", "shard0000");
+    assert.commandWorked(admin.runCommand({shardCollection: coll.getFullName(), key: {_id: 1}}));
+    assert.commandWorked(admin.runCommand({split: coll.getFullName(), middle: {_id: 0}}));
+    assert.commandWorked(
+        admin.runCommand({moveChunk: coll.getFullName(), find: {_id: 0}, to: "shard0001"}));
+
+    assert.commandWorked(
+        admin.runCommand({setParameter: 1, clusterWriteCoalescingWindowMicros: 5000}));
+
+    // Each writer inserts its own documents one batch at a time, and in every batch re-inserts
+    // one of its documents from the batch before.
+    function writeDocs(writer) {
+        var coll = db.getSiblingDB("test").write_coalescing;
+        for (var i = 0; i < 50; i++) {
+            var docs = [{_id: writer * 1000 + i}, {_id: -(writer * 1000 + i)}];
+            if (i > 0) {
+                docs.push({_id: writer * 1000 + i - 1});
+            }
+            var res = coll.runCommand("insert", {documents: docs, ordered: false});
+            assert.commandWorked(res);
+            assert.eq(2, res.n, tojson(res));
+            if (i > 0) {
+                assert.eq(1, res.writeErrors.length, tojson(res));
+                assert.eq(2, res.writeErrors[0].index, tojson(res));
+                assert.eq(ErrorCodes.DuplicateKey, res.writeErrors[0].code, tojson(res));
+            }
+        }
+    }
+
+    var writers = [];
+    for (var w = 1; w <= 4; w++) {
+        writers.push(startParallelShell("(" + writeDocs.toString() + ")(" + w + ");", mongos.port));
+    }
+    writers.forEach(function(join) {
+        join();
+    });
+
+    assert.eq(4 * 50 * 2, coll.find().itcount());
+    assert.eq(4 * 50, coll.find({_id: {$gt: 0}}).itcount());
+
+    st.stop();
+})();
@@ -0,0 +1,111 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bson_field_index.h"
+
+#include <cstring>
+
+namespace mongo {
+
+BSONFieldIndex::BSONFieldIndex(const BSONObj& obj) : _obj(obj) {
+    if (static_cast<size_t>(_obj.nFields()) < kMinFieldsToHash) {
+        return;
+    }
+
+    BSONObjIterator it(_obj);
+    while (it.more()) {
+        _elements.push_back(it.next());
+    }
+
+    // Keep the table at most half full so that probe sequences stay short.
+    size_t numSlots = 1;
+    while (numSlots < _elements.size() * 2) {
+        numSlots <<= 1;
+    }
+    _slots.resize(numSlots, 0);
+
+    const StringData::Hasher hasher;
+    for (size_t i = 0; i < _elements.size(); ++i) {
+        const StringData name = _elements[i].fieldNameStringData();
+        size_t slot = hasher(name) & (numSlots - 1);
+        while (_slots[slot] != 0) {
+            if (_elements[_slots[slot] - 1].fieldNameStringData() == name) {
+                // Keep the first occurrence of a duplicated field name.
+                break;
+            }
+            slot = (slot + 1) & (numSlots - 1);
+        }
+        if (_slots[slot] == 0) {
+            _slots[slot] = i + 1;
+        }
+    }
+}
+
+BSONElement BSONFieldIndex::getField(StringData name) const {
+    if (_slots.empty()) {
+        return _obj.getField(name);
+    }
+
+    const size_t mask = _slots.size() - 1;
+    size_t slot = StringData::Hasher()(name) & mask;
+    while (_slots[slot] != 0) {
+        const BSONElement& elt = _elements[_slots[slot] - 1];
+        if (elt.fieldNameStringData() == name) {
+            return elt;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return BSONElement();
+}
+
+BSONElement BSONFieldIndex::getFieldDottedOrArray(const char*& name) const {
+    const char* p = strchr(name, '.');
+
+    BSONElement sub;
+    if (p) {
+        sub = getField(StringData(name, p - name));
+        name = p + 1;
+    } else {
+        const size_t len = strlen(name);
+        sub = getField(StringData(name, len));
+        name = name + len;
+    }
+
+    if (sub.eoo())
+        return BSONElement();
+    else if (sub.type() == Array || name[0] == '\0')
+        return sub;
+    else if (sub.type() == Object)
+        return sub.embeddedObject().getFieldDottedOrArray(name);
+    else
+        return BSONElement();
+}
+
+}  // namespace mongo
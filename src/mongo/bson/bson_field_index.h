@@ -0,0 +1,89 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+/**
+ * A transient index from top-level field name to element for a single BSONObj.
+ *
+ * BSONObj::getField() is a linear scan, so looking up k fields of an object with n fields costs
+ * O(k * n). A BSONFieldIndex walks the object once and then answers each lookup from a hash
+ * table, which pays off when several fields are looked up in a wide document. Objects with
+ * fewer than kMinFieldsToHash fields are not indexed, and lookups in them fall back to
+ * BSONObj::getField(), so building an index for a narrow object costs one pass and no
+ * allocation.
+ *
+ * The index points into the object's buffer, so the object must outlive it. Like getField(),
+ * lookups return the first element with the given name.
+ */
+class BSONFieldIndex {
+    MONGO_DISALLOW_COPYING(BSONFieldIndex);
+
+public:
+    static const size_t kMinFieldsToHash = 32;
+
+    explicit BSONFieldIndex(const BSONObj& obj);
+
+    /**
+     * Returns the first top-level element named 'name', or EOO if there is none.
+     */
+    BSONElement getField(StringData name) const;
+
+    /**
+     * Equivalent to BSONObj::getFieldDottedOrArray(), using the index for the first component
+     * of the path.
+     */
+    BSONElement getFieldDottedOrArray(const char*& name) const;
+
+    /**
+     * Returns true if lookups are answered from the hash table rather than by scanning.
+     */
+    bool isHashed() const {
+        return !_slots.empty();
+    }
+
+private:
+    const BSONObj _obj;
+
+    // The top-level elements of '_obj' and an open-addressed table of indices into them, plus
+    // one, so that 0 marks an empty slot. Both are empty unless '_obj' has at least
+    // kMinFieldsToHash fields.
+    std::vector<BSONElement> _elements;
+    std::vector<unsigned> _slots;
+};
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/bson/bson_field_index.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace {
+
+using namespace mongo;
+
+BSONObj makeWideObject(size_t nFields) {
+    BSONObjBuilder bob;
+    for (size_t i = 0; i < nFields; ++i) {
+        bob.append(std::string(str::stream() << "f" << i), static_cast<int>(i));
+    }
+    return bob.obj();
+}
+
+TEST(BSONFieldIndex, NarrowObjectIsNotHashed) {
+    BSONObj obj = makeWideObject(BSONFieldIndex::kMinFieldsToHash - 1);
+    BSONFieldIndex index(obj);
+    ASSERT_FALSE(index.isHashed());
+    ASSERT_EQUALS(3, index.getField("f3").numberInt());
+    ASSERT(index.getField("missing").eoo());
+}
+
+TEST(BSONFieldIndex, WideObjectLookups) {
+    const size_t nFields = 250;
+    BSONObj obj = makeWideObject(nFields);
+    BSONFieldIndex index(obj);
+    ASSERT_TRUE(index.isHashed());
+    for (size_t i = 0; i < nFields; ++i) {
+        std::string name = str::stream() << "f" << i;
+        ASSERT_EQUALS(obj.getField(name).rawdata(), index.getField(name).rawdata());
+    }
+    ASSERT(index.getField("f250").eoo());
+    ASSERT(index.getField("").eoo());
+}
+
+TEST(BSONFieldIndex, DuplicateFieldReturnsFirst) {
+    BSONObjBuilder bob;
+    bob.appendElements(makeWideObject(BSONFieldIndex::kMinFieldsToHash));
+    bob.append("f0", "second");
+    BSONObj obj = bob.obj();
+    BSONFieldIndex index(obj);
+    ASSERT_TRUE(index.isHashed());
+    ASSERT_EQUALS(NumberInt, index.getField("f0").type());
+}
+
+TEST(BSONFieldIndex, GetFieldDottedOrArray) {
+    BSONObjBuilder bob;
+    bob.appendElements(makeWideObject(BSONFieldIndex::kMinFieldsToHash));
+    bob.append("a", BSON("b" << BSON("c" << 1)));
+    bob.append("arr", BSON_ARRAY(BSON("b" << 2)));
+    BSONObj obj = bob.obj();
+    BSONFieldIndex index(obj);
+
+    for (const char* path : {"a.b.c", "a.b", "arr.b", "f1.x", "a.missing", "missing.b", "f2"}) {
+        const char* expectedRest = path;
+        const char* rest = path;
+        BSONElement expected = obj.getFieldDottedOrArray(expectedRest);
+        BSONElement actual = index.getFieldDottedOrArray(rest);
+        ASSERT_EQUALS(expected.eoo(), actual.eoo());
+        if (!expected.eoo()) {
+            ASSERT_EQUALS(expected.rawdata(), actual.rawdata());
+        }
+        ASSERT_EQUALS(std::string(expectedRest), std::string(rest));
+    }
+}
+
+}  // namespace
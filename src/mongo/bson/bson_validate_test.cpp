@@ -236,6 +236,27 @@ TEST(BSONValidateFast, NestedObject) {
     ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2));
 }
 
+TEST(BSONValidateFast, DeeplyNestedObject) {
+    BSONObj x = BSON("a" << 1);
+    for (int i = 0; i < 100; i++) {
+        x = BSON("a" << x << "b" << BSON_ARRAY(i));
+    }
+    ASSERT_OK(validateBSON(x.objdata(), x.objsize()));
+    ASSERT_NOT_OK(validateBSON(x.objdata(), x.objsize() / 2));
+
+    // Corrupt an object's length many levels down.
+    std::string corrupt(x.objdata(), x.objsize());
+    const size_t innerLength = corrupt.size() / 2 - 1;
+    auto deepest = BSONObj(corrupt.data());
+    for (int i = 0; i < 60; i++) {
+        deepest = deepest["a"].Obj();
+    }
+    const size_t offset = deepest.objdata() - corrupt.data();
+    ASSERT_LESS_THAN(offset, innerLength);
+    corrupt[offset] = static_cast<char>(corrupt[offset] + 1);
+    ASSERT_NOT_OK(validateBSON(corrupt.data(), corrupt.size()));
+}
+
 TEST(BSONValidateFast, ErrorWithId) {
     BufBuilder bb;
     BSONObjBuilder ob(bb);
@@ -58,7 +58,7 @@ string BSONElement::jsonString(JsonStringFormat format, bool includeFieldNames,
     switch (type()) {
         case mongo::String:
         case Symbol:
-            s << '"' << escape(string(valuestr(), valuestrsize() - 1)) << '"';
+            s << '"' << escape(StringData(valuestr(), valuestrsize() - 1)) << '"';
             break;
         case NumberLong:
             if (format == TenGen) {
@@ -805,45 +805,52 @@ bool BSONObj::coerceVector(std::vector<T>* out) const {
 }
 
 // used by jsonString()
-std::string escape(const std::string& s, bool escape_slash) {
-    StringBuilder ret;
-    for (std::string::const_iterator i = s.begin(); i != s.end(); ++i) {
-        switch (*i) {
+std::string escape(StringData s, bool escape_slash) {
+    std::string ret;
+    ret.reserve(s.size());
+    // Runs of characters which need no escaping are copied with a single append.
+    const char* run = s.rawData();
+    const char* const end = run + s.size();
+    for (const char* i = run; i != end; ++i) {
+        const unsigned char c = *i;
+        if (c >= 0x20 && c != '"' && c != '\\' && (c != '/' || !escape_slash)) {
+            continue;
+        }
+        ret.append(run, i);
+        run = i + 1;
+        switch (c) {
             case '"':
-                ret << "\\\"";
+                ret += "\\\"";
                 break;
             case '\\':
-                ret << "\\\\";
+                ret += "\\\\";
                 break;
             case '/':
-                ret << (escape_slash ? "\\/" : "/");
+                ret += "\\/";
                 break;
             case '\b':
-                ret << "\\b";
+                ret += "\\b";
                 break;
             case '\f':
-                ret << "\\f";
+                ret += "\\f";
                 break;
             case '\n':
-                ret << "\\n";
+                ret += "\\n";
                 break;
             case '\r':
-                ret << "\\r";
+                ret += "\\r";
                 break;
             case '\t':
-                ret << "\\t";
+                ret += "\\t";
                 break;
             default:
-                if (*i >= 0 && *i <= 0x1f) {
-                    // TODO: these should be utf16 code-units not bytes
-                    char c = *i;
-                    ret << "\\u00" << toHexLower(&c, 1);
-                } else {
-                    ret << *i;
-                }
+                // TODO: these should be utf16 code-units not bytes
+                ret += "\\u00";
+                ret += toHexLower(i, 1);
         }
     }
-    return ret.str();
+    ret.append(run, end);
+    return ret;
 }
 
 /**
@@ -800,6 +800,6 @@ inline BSONElement::BSONElement() {
     totalSize = 1;
 }
 
-// TODO(SERVER-14596): move to a better place; take a StringData.
-std::string escape(const std::string& s, bool escape_slash = false);
+// TODO(SERVER-14596): move to a better place.
+std::string escape(StringData s, bool escape_slash = false);
 }
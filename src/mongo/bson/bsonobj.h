@@ -181,6 +181,18 @@ public:
     */
     BSONObj getOwned() const;
 
+    /** Makes this unowned view into 'other' share ownership of other's buffer, so that it stays
+        valid for as long as it is in use without copying the data out of 'other'. 'other' must be
+        owned and this object's data must lie within it.
+    */
+    BSONObj& shareOwnershipWith(const BSONObj& other) {
+        invariant(other.isOwned());
+        invariant(_objdata >= other.objdata() &&
+                  _objdata + objsize() <= other.objdata() + other.objsize());
+        _ownedBuffer = other._ownedBuffer;
+        return *this;
+    }
+
     /** @return a new full (and owned) copy of the object. */
     BSONObj copy() const;
 
@@ -1176,7 +1176,16 @@ Status JParse::chars(std::string* result, const char* terminalSet, const char* a
             }
             ++q;
         } else {
-            result->push_back(*q++);
+            // Append the run of characters up to the next one which needs a closer look at once
+            // rather than one character at a time.
+            const char* runEnd = q + 1;
+            while (runEnd < _input_end && *runEnd != '\\' &&
+                   !(0x00 <= *runEnd && *runEnd <= 0x1F) && !match(*runEnd, terminalSet) &&
+                   (allowedSet == NULL || match(*runEnd, allowedSet))) {
+                ++runEnd;
+            }
+            result->append(q, runEnd);
+            q = runEnd;
         }
     }
     if (q < _input_end) {
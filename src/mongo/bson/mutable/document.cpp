@@ -29,6 +29,7 @@
 
 #include "mongo/bson/mutable/document.h"
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 #include <limits>
@@ -2117,17 +2118,14 @@ void Document::Impl::writeElement(Element::RepIdx repIdx,
 
 template <typename Builder>
 void Document::Impl::writeChildren(Element::RepIdx repIdx, Builder* builder) const {
-    // TODO: In theory, I think we can walk rightwards building a write region from all
-    // serialized embedded children that share an obj id and form a contiguous memory
-    // region. For arrays we would need to know something about how many elements we wrote
-    // that way so that the indexes would come out right.
-    //
-    // However, that involves walking the memory twice: once to build the copy region, and
-    // another time to actually copy it. It is unclear if this is better than just walking
-    // it once with the recursive solution.
-
     const ElementRep& rep = getElementRep(repIdx);
 
+    // Serialized children of an object which still sit next to each other in the object they
+    // were read from are written with a single copy. Arrays are written element by element, as
+    // their field names must be renumbered if elements were added or removed.
+    const bool canCopyRuns = (getType(rep) == mongo::Object) && (rep.objIdx != kInvalidObjIdx);
+    const ElementRep::ObjIdx parentObjIdx = rep.objIdx;
+
     // OK, need to resolve left if we haven't done that yet.
     Element::RepIdx current = rep.child.left;
     if (current == Element::kOpaqueRepIdx)
@@ -2135,7 +2133,32 @@ void Document::Impl::writeChildren(Element::RepIdx repIdx, Builder* builder) con
 
     // We need to write the element, and then walk rightwards.
     while (current != Element::kInvalidRepIdx) {
-        writeElement(current, builder);
+        const ElementRep* runRep = &getElementRep(current);
+        if (canCopyRuns && hasValue(*runRep) && (runRep->objIdx == parentObjIdx)) {
+            const BSONElement runStart = getSerializedElement(*runRep);
+            const char* const runBegin = runStart.rawdata();
+            const char* runEnd = runBegin + runStart.size();
+
+            // Extend the run over the already resolved right siblings which follow it
+            // unmodified in the same buffer. An opaque sibling ends the run, and is handled
+            // below.
+            while ((runRep->sibling.right != Element::kInvalidRepIdx) &&
+                   (runRep->sibling.right != Element::kOpaqueRepIdx)) {
+                const ElementRep& rightRep = getElementRep(runRep->sibling.right);
+                if (!hasValue(rightRep) || (rightRep.objIdx != parentObjIdx))
+                    break;
+                const BSONElement rightElt = getSerializedElement(rightRep);
+                if (rightElt.rawdata() != runEnd)
+                    break;
+                runEnd += rightElt.size();
+                current = runRep->sibling.right;
+                runRep = &rightRep;
+            }
+
+            builder->bb().appendBuf(runBegin, runEnd - runBegin);
+        } else {
+            writeElement(current, builder);
+        }
 
         // If we have an opaque region to the right, and we are not in an array, then we
         // can bulk copy from the end of the element we just wrote to the end of our
@@ -2208,6 +2231,22 @@ void Document::reset(const BSONObj& value, InPlaceMode inPlaceMode) {
 
 Document::~Document() {}
 
+BSONObj Document::getObject() const {
+    // Start with room for the object this Document was built from, plus some headroom, so
+    // that serializing a large, slightly modified document does not keep regrowing the buffer.
+    const Impl& impl = getImpl();
+    const ElementRep& rootRep = impl.getElementRep(kRootRepIdx);
+    int initialSize = 512;
+    if ((rootRep.objIdx != kInvalidObjIdx) && (rootRep.objIdx != kLeafObjIdx)) {
+        const int originalSize = impl.getObject(rootRep.objIdx).objsize();
+        initialSize = std::max(initialSize, originalSize + originalSize / 8);
+    }
+
+    BSONObjBuilder builder(initialSize);
+    writeTo(&builder);
+    return builder.obj();
+}
+
 void Document::reserveDamageEvents(size_t expectedEvents) {
     return getImpl().reserveDamageEvents(expectedEvents);
 }
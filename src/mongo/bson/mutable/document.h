@@ -295,7 +295,7 @@ public:
     /** Serialize the Elements reachable from the root Element of this Document and return
      *  the result as a BSONObj.
      */
-    inline BSONObj getObject() const;
+    BSONObj getObject() const;
 
 
     //
@@ -1175,6 +1175,29 @@ TEST(Document, RenameDeserialization) {
     ASSERT_EQUALS(mongo::fromjson(outJson), outObj);
 }
 
+TEST(Document, SerializeResolvedSiblingsAroundModifications) {
+    // Serialization copies runs of unmodified serialized siblings in one go; make sure runs
+    // stop at removed, renamed, and added elements, and that array elements are renumbered.
+    static const char inJson[] =
+        "{ a : 1, b : 2, c : { x : 1, y : 2 }, d : 4, e : [ 0, 1, 2 ], f : 6, g : 7 }";
+    mongo::BSONObj inObj = mongo::fromjson(inJson);
+
+    mmb::Document doc(inObj);
+    for (mmb::Element elt = doc.root().leftChild(); elt.ok(); elt = elt.rightSibling()) {
+    }
+    ASSERT_EQUALS(inObj, doc.getObject());
+
+    ASSERT_OK(doc.root()["b"].remove());
+    ASSERT_OK(doc.root()["d"].rename("D"));
+    ASSERT_OK(doc.root()["c"].appendInt("z", 3));
+    ASSERT_OK(doc.root()["e"].leftChild().remove());
+    ASSERT_OK(doc.root()["f"].addSiblingRight(doc.makeElementInt("h", 8)));
+
+    static const char outJson[] =
+        "{ a : 1, c : { x : 1, y : 2, z : 3 }, D : 4, e : [ 1, 2 ], f : 6, h : 8, g : 7 }";
+    ASSERT_EQUALS(mongo::fromjson(outJson), doc.getObject());
+}
+
 TEST(Document, CantRenameRootElement) {
     mmb::Document doc;
     ASSERT_NOT_OK(doc.root().rename("foo"));
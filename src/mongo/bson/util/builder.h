@@ -43,6 +43,7 @@
 #include "mongo/platform/decimal128.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/bump_arena.h"
 
 namespace mongo {
 /* Accessing unaligned doubles on ARM generates an alignment trap and aborts with SIGBUS on Linux.
@@ -116,6 +117,28 @@ private:
     char buf[SZ];
 };
 
+/**
+ * Draws buffers from a BumpArena instead of the heap. Nothing allocated this way may be
+ * decoupled and handed to code that will free() it.
+ */
+class ArenaAllocator {
+public:
+    explicit ArenaAllocator(BumpArena* arena) : _arena(arena) {}
+
+    void* Malloc(size_t sz) {
+        return _arena->allocate(sz);
+    }
+    void* Realloc(void* p, size_t sz) {
+        return _arena->reallocate(p, sz);
+    }
+    void Free(void* p) {
+        _arena->deallocate(p);
+    }
+
+private:
+    BumpArena* _arena;
+};
+
 template <class Allocator>
 class _BufBuilder {
     // non-copyable, non-assignable
@@ -125,6 +148,18 @@ class _BufBuilder {
 
 public:
     _BufBuilder(int initsize = 512) : size(initsize) {
+        _init();
+    }
+
+    /**
+     * Use for allocator policies which are not default constructible, such as ArenaAllocator.
+     */
+    _BufBuilder(const Allocator& allocator, int initsize) : al(allocator), size(initsize) {
+        _init();
+    }
+
+private:
+    void _init() {
         if (size > 0) {
             data = (char*)al.Malloc(size);
             if (data == 0)
@@ -135,6 +170,8 @@ public:
         l = 0;
         reservedBytes = 0;
     }
+
+public:
     ~_BufBuilder() {
         kill();
     }
@@ -333,6 +370,17 @@ public:
     void decouple();  // not allowed. not implemented.
 };
 
+/** The ArenaBufBuilder takes its memory from a BumpArena, typically the one belonging to the
+      current operation (see OperationArena). Like StackBufBuilder it can not be decoupled, and
+      it must not be used after the arena is reset.
+*/
+class ArenaBufBuilder : public _BufBuilder<ArenaAllocator> {
+public:
+    explicit ArenaBufBuilder(BumpArena* arena, int initsize = 512)
+        : _BufBuilder<ArenaAllocator>(ArenaAllocator(arena), initsize) {}
+    void decouple();  // not allowed. not implemented.
+};
+
 #if defined(_WIN32) && _MSC_VER < 1900
 #pragma push_macro("snprintf")
 #define snprintf _snprintf
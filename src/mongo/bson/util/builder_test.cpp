@@ -44,6 +44,25 @@ TEST(Builder, String1) {
     ASSERT_EQUALS(0, strcmp("eliot", bb.buf()));
 }
 
+TEST(Builder, ArenaBufBuilder) {
+    BumpArena arena(1024);
+    {
+        ArenaBufBuilder bb(&arena, 16);
+        for (int i = 0; i < 1000; i++) {
+            bb.appendNum(i);
+        }
+        ASSERT_EQUALS(4000, bb.len());
+        for (int i = 0; i < 1000; i++) {
+            ASSERT_EQUALS(i, ConstDataView(bb.buf()).read<LittleEndian<int>>(i * sizeof(int)));
+        }
+    }
+
+    // Growing past the block size moved the buffer into its own block, which reset() releases.
+    ASSERT_GREATER_THAN(arena.bytesReserved(), 1024U);
+    arena.reset();
+    ASSERT_EQUALS(1024U, arena.bytesReserved());
+}
+
 TEST(Builder, StringBuilderAddress) {
     const void* longPtr = reinterpret_cast<const void*>(-1);
     const void* shortPtr = reinterpret_cast<const void*>(0xDEADBEEF);
@@ -0,0 +1,200 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/async_cursor.h"
+
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/query/getmore_request.h"
+#include "mongo/db/query/killcursors_request.h"
+
+namespace mongo {
+
+using executor::Deferred;
+using executor::RemoteCommandRequest;
+using executor::TaskExecutor;
+
+AsyncCursor::State::State(TaskExecutor* theExecutor,
+                          const HostAndPort& theTarget,
+                          const std::string& theDbname,
+                          Milliseconds theTimeout)
+    : executor(theExecutor), target(theTarget), dbname(theDbname), timeout(theTimeout) {}
+
+AsyncCursor::AsyncCursor(TaskExecutor* executor,
+                         const HostAndPort& target,
+                         const std::string& dbname,
+                         const BSONObj& cmdObj,
+                         Milliseconds timeout)
+    : _cmdObj(cmdObj.getOwned()),
+      _state(std::make_shared<State>(executor, target, dbname, timeout)) {}
+
+AsyncCursor::~AsyncCursor() {
+    kill();
+}
+
+Deferred<AsyncCursor::Batch> AsyncCursor::nextBatch() {
+    Deferred<Batch> current;
+    bool first = false;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        if (!_state->started) {
+            _state->started = true;
+            first = true;
+        } else if (!_state->prefetched) {
+            return Deferred<Batch>::makeReady(Batch());
+        } else {
+            current = *_state->prefetched;
+            _state->prefetched = boost::none;
+        }
+    }
+
+    if (first) {
+        current = _fetch(_state, _cmdObj);
+    }
+
+    // Send the getMore for the following batch as soon as this one arrives, before the caller's
+    // continuations run.
+    auto state = _state;
+    return current.then(_state->executor,
+                        [state](const Batch& batch) {
+                            _prefetchNext(state);
+                            return StatusWith<Batch>(batch);
+                        });
+}
+
+bool AsyncCursor::isExhausted() const {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    return _state->started && !_state->prefetched;
+}
+
+void AsyncCursor::kill() {
+    NamespaceString nss;
+    CursorId cursorId;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        if (_state->killed) {
+            return;
+        }
+        _state->killed = true;
+        _state->prefetched = boost::none;
+
+        // A cursor in use by a getMore cannot be killed. The response handler kills it instead.
+        if (_state->inFlight || _state->cursorId == 0) {
+            return;
+        }
+        nss = _state->nss;
+        cursorId = _state->cursorId;
+        _state->cursorId = 0;
+    }
+    _sendKillCursors(_state, nss, cursorId);
+}
+
+Deferred<AsyncCursor::Batch> AsyncCursor::_fetch(const std::shared_ptr<State>& state,
+                                                 const BSONObj& cmdObj) {
+    Deferred<Batch> deferred;
+    {
+        stdx::lock_guard<stdx::mutex> lk(state->mutex);
+        state->inFlight = true;
+    }
+
+    auto cbh = state->executor->scheduleRemoteCommand(
+        RemoteCommandRequest(state->target, state->dbname, cmdObj, state->timeout),
+        [state, deferred](const TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+            StatusWith<Batch> result(ErrorCodes::InternalError, "uninitialized");
+            NamespaceString nssToKill;
+            CursorId cursorToKill = 0;
+            {
+                stdx::lock_guard<stdx::mutex> lk(state->mutex);
+                state->inFlight = false;
+
+                auto response = cbData.response.isOK()
+                    ? CursorResponse::parseFromBSON(cbData.response.getValue().data)
+                    : StatusWith<CursorResponse>(cbData.response.getStatus());
+                if (!response.isOK()) {
+                    // The server times out a cursor we can no longer reach.
+                    state->cursorId = 0;
+                    result = response.getStatus();
+                } else {
+                    state->nss = response.getValue().nss;
+                    state->cursorId = response.getValue().cursorId;
+                    result = Batch(response.getValue().batch);
+                }
+
+                if (state->killed && state->cursorId != 0) {
+                    nssToKill = state->nss;
+                    cursorToKill = state->cursorId;
+                    state->cursorId = 0;
+                }
+            }
+
+            if (cursorToKill != 0) {
+                _sendKillCursors(state, nssToKill, cursorToKill);
+            }
+            deferred.emplace(std::move(result));
+        });
+
+    if (!cbh.isOK()) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(state->mutex);
+            state->inFlight = false;
+        }
+        deferred.emplace(cbh.getStatus());
+    }
+    return deferred;
+}
+
+void AsyncCursor::_prefetchNext(const std::shared_ptr<State>& state) {
+    BSONObj getMore;
+    {
+        stdx::lock_guard<stdx::mutex> lk(state->mutex);
+        if (state->killed || state->cursorId == 0) {
+            return;
+        }
+        getMore = GetMoreRequest(state->nss, state->cursorId, boost::none, boost::none).toBSON();
+    }
+
+    auto next = _fetch(state, getMore);
+
+    stdx::lock_guard<stdx::mutex> lk(state->mutex);
+    if (!state->killed) {
+        state->prefetched = next;
+    }
+}
+
+void AsyncCursor::_sendKillCursors(const std::shared_ptr<State>& state,
+                                   const NamespaceString& nss,
+                                   CursorId cursorId) {
+    KillCursorsRequest request(nss, {cursorId});
+    // Best effort: a cursor left behind is reaped by the server's cursor timeout.
+    state->executor->scheduleRemoteCommand(
+        RemoteCommandRequest(state->target, state->dbname, request.toBSON(), state->timeout),
+        [](const TaskExecutor::RemoteCommandCallbackArgs&) {});
+}
+
+}  // namespace mongo
@@ -0,0 +1,151 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/executor/deferred.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/net/hostandport.h"
+
+namespace mongo {
+
+/**
+ * Iterates the results of a cursor-returning command, such as find or aggregate, on a remote
+ * host without blocking a thread while a batch is on the network.
+ *
+ * Each batch is returned as a Deferred. As soon as the caller's batch arrives, the getMore for
+ * the batch after it is sent, so the next batch is fetched while the current one is processed.
+ * At most one request per cursor is in flight. Many cursors can share one TaskExecutor, whose
+ * network interface multiplexes their requests over its connection pool.
+ *
+ * Callers must wait for the Deferred returned by nextBatch() to be ready before calling
+ * nextBatch() again. An error ends the cursor.
+ */
+class AsyncCursor {
+    MONGO_DISALLOW_COPYING(AsyncCursor);
+
+public:
+    using Batch = std::vector<BSONObj>;
+
+    /**
+     * Creates a cursor for 'cmdObj' run against 'dbname' on 'target'. Nothing is sent until the
+     * first call to nextBatch().
+     */
+    AsyncCursor(executor::TaskExecutor* executor,
+                const HostAndPort& target,
+                const std::string& dbname,
+                const BSONObj& cmdObj,
+                Milliseconds timeout = executor::RemoteCommandRequest::kNoTimeout);
+
+    /**
+     * Kills the remote cursor if it is still open.
+     */
+    ~AsyncCursor();
+
+    /**
+     * Returns the next batch of results. The first call sends the command; later calls return
+     * the batch prefetched by the previous one. Once the cursor is exhausted, returns a ready,
+     * empty batch.
+     */
+    executor::Deferred<Batch> nextBatch();
+
+    /**
+     * Returns true if there are no more batches to fetch. Only meaningful when no batch is
+     * outstanding.
+     */
+    bool isExhausted() const;
+
+    /**
+     * Stops prefetching and schedules a killCursors for the remote cursor, without waiting for
+     * it to complete. Batches already requested are still delivered.
+     */
+    void kill();
+
+private:
+    /**
+     * State shared with the continuations, which may run after this cursor is destroyed.
+     */
+    struct State {
+        State(executor::TaskExecutor* executor,
+              const HostAndPort& target,
+              const std::string& dbname,
+              Milliseconds timeout);
+
+        executor::TaskExecutor* const executor;
+        const HostAndPort target;
+        const std::string dbname;
+        const Milliseconds timeout;
+
+        // Protects the members below.
+        mutable stdx::mutex mutex;
+
+        NamespaceString nss;
+        CursorId cursorId = 0;
+        bool started = false;
+        bool inFlight = false;
+        bool killed = false;
+
+        // The getMore sent ahead of the next call to nextBatch(), if any.
+        boost::optional<executor::Deferred<Batch>> prefetched;
+    };
+
+    /**
+     * Sends 'cmdObj' and returns a Deferred for the batch in its cursor response. Records the
+     * cursor id and namespace of the response. An error abandons the remote cursor.
+     */
+    static executor::Deferred<Batch> _fetch(const std::shared_ptr<State>& state,
+                                            const BSONObj& cmdObj);
+
+    /**
+     * Sends the getMore for the next batch, unless the cursor is exhausted or killed.
+     */
+    static void _prefetchNext(const std::shared_ptr<State>& state);
+
+    /**
+     * Schedules a killCursors for 'cursorId' and ignores its response.
+     */
+    static void _sendKillCursors(const std::shared_ptr<State>& state,
+                                 const NamespaceString& nss,
+                                 CursorId cursorId);
+
+    const BSONObj _cmdObj;
+    const std::shared_ptr<State> _state;
+};
+
+}  // namespace mongo
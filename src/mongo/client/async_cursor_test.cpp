@@ -0,0 +1,141 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/client/async_cursor.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/executor/thread_pool_task_executor_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using executor::NetworkInterfaceMock;
+using executor::RemoteCommandResponse;
+
+using AsyncCursorTest = executor::ThreadPoolExecutorTest;
+
+const HostAndPort kTarget("localhost", 27017);
+const NamespaceString kNss("db.coll");
+
+/**
+ * Answers the next request on the mock network with a cursor response and returns the command
+ * it was sent.
+ */
+BSONObj respond(NetworkInterfaceMock* net,
+                CursorId cursorId,
+                std::vector<BSONObj> batch,
+                CursorResponse::ResponseType type) {
+    net->enterNetwork();
+    auto noi = net->getNextReadyRequest();
+    BSONObj cmdObj = noi->getRequest().cmdObj.getOwned();
+    BSONObjBuilder bob;
+    CursorResponse(kNss, cursorId, std::move(batch)).addToBSON(type, &bob);
+    bob.append("ok", 1);
+    net->scheduleResponse(
+        noi, net->now(), RemoteCommandResponse(bob.obj(), BSONObj(), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+    return cmdObj;
+}
+
+TEST_F(AsyncCursorTest, PrefetchesTheNextBatch) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    AsyncCursor cursor(&executor, kTarget, "db", BSON("find" << kNss.coll()));
+    auto first = cursor.nextBatch();
+    BSONObj find =
+        respond(net, 5, {BSON("_id" << 1)}, CursorResponse::ResponseType::InitialResponse);
+    ASSERT_EQUALS(BSON("find" << kNss.coll()), find);
+    auto batch = unittest::assertGet(first.get());
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(BSON("_id" << 1), batch[0]);
+    ASSERT_FALSE(cursor.isExhausted());
+
+    // The getMore is already on the network before the caller asks for the next batch.
+    BSONObj getMore =
+        respond(net, 0, {BSON("_id" << 2)}, CursorResponse::ResponseType::SubsequentResponse);
+    ASSERT_EQUALS(5, getMore["getMore"].numberLong());
+    ASSERT_EQUALS(kNss.coll(), getMore["collection"].str());
+
+    batch = unittest::assertGet(cursor.nextBatch().get());
+    ASSERT_EQUALS(1U, batch.size());
+    ASSERT_EQUALS(BSON("_id" << 2), batch[0]);
+    ASSERT_TRUE(cursor.isExhausted());
+    ASSERT_TRUE(unittest::assertGet(cursor.nextBatch().get()).empty());
+}
+
+TEST_F(AsyncCursorTest, ErrorEndsTheCursor) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    AsyncCursor cursor(&executor, kTarget, "db", BSON("find" << kNss.coll()));
+    auto first = cursor.nextBatch();
+    net->enterNetwork();
+    net->scheduleResponse(net->getNextReadyRequest(),
+                          net->now(),
+                          Status(ErrorCodes::HostUnreachable, "host unreachable"));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ASSERT_EQUALS(ErrorCodes::HostUnreachable, first.get().getStatus());
+    ASSERT_TRUE(cursor.isExhausted());
+}
+
+TEST_F(AsyncCursorTest, KillStopsPrefetchingAndKillsTheRemoteCursor) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    AsyncCursor cursor(&executor, kTarget, "db", BSON("find" << kNss.coll()));
+    auto first = cursor.nextBatch();
+    respond(net, 5, {BSON("_id" << 1)}, CursorResponse::ResponseType::InitialResponse);
+    ASSERT_OK(first.get().getStatus());
+
+    // The prefetch is in flight, so the cursor is killed once its response arrives.
+    cursor.kill();
+    respond(net, 5, {BSON("_id" << 2)}, CursorResponse::ResponseType::SubsequentResponse);
+
+    net->enterNetwork();
+    auto noi = net->getNextReadyRequest();
+    BSONObj killCursors = noi->getRequest().cmdObj;
+    ASSERT_EQUALS(kNss.coll(), killCursors["killCursors"].str());
+    ASSERT_EQUALS(5, killCursors["cursors"].Array()[0].numberLong());
+    net->exitNetwork();
+
+    ASSERT_TRUE(cursor.isExhausted());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -189,7 +189,7 @@ bool DBClientCursor::initCommand() {
     return ok;
 }
 
-void DBClientCursor::requestMore() {
+void DBClientCursor::_assembleGetMore(Message& toSend) {
     verify(cursorId && batch.pos == batch.nReturned);
 
     if (haveLimit) {
@@ -202,8 +202,12 @@ void DBClientCursor::requestMore() {
     b.appendNum(nextBatchSize());
     b.appendNum(cursorId);
 
-    Message toSend;
     toSend.setData(dbGetMore, b.buf(), b.len());
+}
+
+void DBClientCursor::requestMore() {
+    Message toSend;
+    _assembleGetMore(toSend);
     unique_ptr<Message> response(new Message());
 
     if (_client) {
@@ -222,6 +226,25 @@ void DBClientCursor::requestMore() {
     }
 }
 
+void DBClientCursor::requestMoreLazy() {
+    massert(28815,
+            "DBClientCursor::requestMoreLazy called on a client that doesn't support lazy",
+            _client && _client->lazySupported());
+    Message toSend;
+    _assembleGetMore(toSend);
+    _client->say(toSend);
+}
+
+void DBClientCursor::requestMoreLazyFinish() {
+    unique_ptr<Message> response(new Message());
+    verify(_client);
+    if (!_client->recv(*response)) {
+        uasserted(28816, "recv failed while waiting for getMore reply");
+    }
+    batch.m = std::move(response);
+    dataReceived();
+}
+
 /** with QueryOption_Exhaust, the server just blasts data at us (marked at end with cursorid==0). */
 void DBClientCursor::exhaustReceiveMore() {
     verify(cursorId && batch.pos == batch.nReturned);
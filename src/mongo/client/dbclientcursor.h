@@ -212,6 +212,15 @@ public:
     void initLazy(bool isRetry = false);
     bool initLazyFinish(bool& retry);
 
+    /**
+     * Sends a getMore for the next batch without waiting for the reply, which must be received by
+     * requestMoreLazyFinish() before the cursor or its connection are used again. Like initLazy(),
+     * this lets requests on several connections be in flight at once. The current batch must be
+     * exhausted and the cursor must not be dead.
+     */
+    void requestMoreLazy();
+    void requestMoreLazyFinish();
+
     class Batch {
         MONGO_DISALLOW_COPYING(Batch);
         friend class DBClientCursor;
@@ -290,6 +299,9 @@ private:
 
     void requestMore();
 
+    // Builds the getMore message for the next batch.
+    void _assembleGetMore(Message& toSend);
+
     // Don't call from a virtual function
     void _assertIfNull() const {
         uassert(13348, "connection died", this);
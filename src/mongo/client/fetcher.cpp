@@ -130,7 +130,14 @@ Status parseCursorResponse(const BSONObj& obj,
                                         << "'" << kCursorFieldName << "." << batchFieldName
                                         << "' field: " << obj);
         }
-        batchData->documents.push_back(itemElement.Obj().getOwned());
+        // Share the reply buffer rather than copying each document out of it.
+        BSONObj document = itemElement.Obj();
+        if (obj.isOwned()) {
+            document.shareOwnershipWith(obj);
+        } else {
+            document = document.getOwned();
+        }
+        batchData->documents.push_back(std::move(document));
     }
 
     return Status::OK();
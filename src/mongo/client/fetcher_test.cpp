@@ -422,6 +422,7 @@ TEST_F(FetcherTest, FetchOneDocument) {
     ASSERT_EQUALS("db.coll", nss.ns());
     ASSERT_EQUALS(1U, documents.size());
     ASSERT_EQUALS(doc, documents.front());
+    ASSERT_TRUE(documents.front().isOwned());
 }
 
 TEST_F(FetcherTest, SetNextActionToContinueWhenNextBatchIsNotAvailable) {
@@ -307,6 +307,13 @@ void ReplicaSetMonitor::failedHost(const HostAndPort& host) {
     DEV _state->checkInvariants();
 }
 
+void ReplicaSetMonitor::updateHostLatency(const HostAndPort& host, int64_t latencyMicros) {
+    stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+    Node* node = _state->findNode(host);
+    if (node && node->isUp)
+        node->updateLatency(latencyMicros);
+}
+
 bool ReplicaSetMonitor::isPrimary(const HostAndPort& host) const {
     stdx::lock_guard<stdx::mutex> lk(_state->mutex);
     Node* node = _state->findNode(host);
@@ -829,13 +836,19 @@ void Node::update(const IsMasterReply& reply) {
     if (!tags.binaryEqual(reply.tags))
         tags = reply.tags.getOwned();
 
-    if (reply.latencyMicros >= 0) {  // TODO upper bound?
-        if (latencyMicros == unknownLatency) {
-            latencyMicros = reply.latencyMicros;
-        } else {
-            // update latency with smoothed moving average (1/4th the delta)
-            latencyMicros += (reply.latencyMicros - latencyMicros) / 4;
-        }
+    updateLatency(reply.latencyMicros);
+}
+
+void Node::updateLatency(int64_t sampleMicros) {
+    if (sampleMicros < 0) {  // TODO upper bound?
+        return;
+    }
+
+    if (latencyMicros == unknownLatency) {
+        latencyMicros = sampleMicros;
+    } else {
+        // update latency with smoothed moving average (1/4th the delta)
+        latencyMicros += (sampleMicros - latencyMicros) / 4;
     }
 }
 
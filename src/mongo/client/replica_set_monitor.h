@@ -95,6 +95,13 @@ public:
      */
     void failedHost(const HostAndPort& host);
 
+    /**
+     * Folds the time an operation took to complete on host into the latency used to pick hosts
+     * within the local threshold, so that a node which stalls stops being chosen without waiting
+     * for the next isMaster round. Ignored if host is not known to this set or is down.
+     */
+    void updateHostLatency(const HostAndPort& host, int64_t latencyMicros);
+
     /**
      * Returns true if this node is the master based ONLY on local data. Be careful, return may
      * be stale.
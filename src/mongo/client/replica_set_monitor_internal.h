@@ -114,6 +114,11 @@ public:
          */
         void update(const IsMasterReply& reply);
 
+        /**
+         * Folds a new round-trip sample into latencyMicros. Negative samples are ignored.
+         */
+        void updateLatency(int64_t sampleMicros);
+
         // Intentionally chosen to compare worse than all known latencies.
         static const int64_t unknownLatency;  // = numeric_limits<int64_t>::max()
 
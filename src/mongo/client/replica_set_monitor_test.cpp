@@ -768,6 +768,45 @@ TEST(ReplicaSetMonitor, OutOfBandFailedHost) {
     }
 }
 
+TEST(ReplicaSetMonitor, OperationLatencyDemotesSlowHost) {
+    SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
+    ReplicaSetMonitorPtr rsm = std::make_shared<ReplicaSetMonitor>(state);
+    Refresher refresher = rsm->startOrContinueRefresh();
+
+    for (size_t i = 0; i != basicSeeds.size(); ++i) {
+        NextStep ns = refresher.getNextStep();
+    }
+
+    for (size_t i = 0; i != basicSeeds.size(); ++i) {
+        bool primary = (i == 0);
+        refresher.receivedIsMaster(basicSeeds[i],
+                                   1000,
+                                   BSON("setName"
+                                        << "name"
+                                        << "ismaster" << primary << "secondary" << !primary
+                                        << "hosts" << BSON_ARRAY("a"
+                                                                 << "b"
+                                                                 << "c") << "ok" << true));
+    }
+
+    // A secondary which stalls is pulled past the local threshold by its slow operations alone.
+    const ReadPreferenceSetting secondary(ReadPreference::SecondaryOnly, TagSet());
+    for (int i = 0; i < 10; i++) {
+        rsm->updateHostLatency(HostAndPort("b"), 500 * 1000);
+    }
+    ASSERT_GREATER_THAN(state->findNode(HostAndPort("b"))->latencyMicros, 400 * 1000);
+    for (int i = 0; i < 20; i++) {
+        ASSERT_EQUALS(HostAndPort("c"), state->getMatchingHost(secondary));
+    }
+
+    // Hosts which are unknown or down are left alone.
+    rsm->updateHostLatency(HostAndPort("d"), 500 * 1000);
+    ASSERT(!state->findNode(HostAndPort("d")));
+    rsm->failedHost(HostAndPort("c"));
+    rsm->updateHostLatency(HostAndPort("c"), 500 * 1000);
+    ASSERT_EQUALS(1000, state->findNode(HostAndPort("c"))->latencyMicros);
+}
+
 // Newly elected primary with electionId >= maximum electionId seen by the Refresher
 TEST(ReplicaSetMonitorTests, NewPrimaryWithMaxElectionId) {
     SetStatePtr state = std::make_shared<SetState>("name", basicSeedsSet);
@@ -30,11 +30,17 @@
 
 #include "mongo/crypto/mechanism_scram.h"
 
+#include <memory>
+#include <string>
 #include <vector>
 
 #include "mongo/crypto/crypto.h"
 #include "mongo/platform/random.h"
+#include "mongo/platform/unordered_map.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/base64.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 namespace scram {
@@ -79,12 +85,11 @@ static void HMACIteration(const unsigned char input[],
     }
 }
 
-// Iterate the hash function to generate SaltedPassword
-void generateSaltedPassword(StringData hashedPassword,
-                            const unsigned char* salt,
-                            const int saltLen,
-                            const int iterationCount,
-                            unsigned char saltedPassword[hashSize]) {
+static void computeSaltedPassword(StringData hashedPassword,
+                                  const unsigned char* salt,
+                                  const int saltLen,
+                                  const int iterationCount,
+                                  unsigned char saltedPassword[hashSize]) {
     // saltedPassword = Hi(hashedPassword, salt)
     HMACIteration(reinterpret_cast<const unsigned char*>(hashedPassword.rawData()),
                   hashedPassword.size(),
@@ -94,18 +99,97 @@ void generateSaltedPassword(StringData hashedPassword,
                   saltedPassword);
 }
 
-void generateSecrets(const std::string& hashedPassword,
-                     const unsigned char salt[],
-                     size_t saltLen,
-                     size_t iterationCount,
-                     unsigned char storedKey[hashSize],
-                     unsigned char serverKey[hashSize]) {
-    unsigned char saltedPassword[hashSize];
+namespace {
+
+/**
+ * Remembers the SaltedPassword computed for each (password, salt, iteration count), so that a
+ * burst of authentications with the same credentials, such as a connection pool reconnecting
+ * with the cluster key file, pays for Hi() once.  Threads wanting a SaltedPassword which is
+ * being computed wait for it rather than computing it again.
+ */
+class SaltedPasswordCache {
+public:
+    void get(StringData hashedPassword,
+             const unsigned char* salt,
+             const int saltLen,
+             const int iterationCount,
+             unsigned char saltedPassword[hashSize]) {
+        std::string key = hashedPassword.toString();
+        key.push_back('\0');
+        key.append(reinterpret_cast<const char*>(salt), saltLen);
+        key.append(reinterpret_cast<const char*>(&iterationCount), sizeof(iterationCount));
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        auto it = _entries.find(key);
+        if (it != _entries.end()) {
+            auto entry = it->second;
+            _computed.wait(lk, [&entry] { return entry->state != Entry::kComputing; });
+            if (entry->state == Entry::kReady) {
+                memcpy(saltedPassword, entry->saltedPassword, hashSize);
+                return;
+            }
+        }
+
+        if (_entries.size() >= kMaxEntries) {
+            // Entries being computed are still referenced by the threads computing them.
+            _entries.clear();
+        }
+        auto entry = std::make_shared<Entry>();
+        _entries[key] = entry;
+        lk.unlock();
+
+        bool computed = false;
+        ON_BLOCK_EXIT([&] {
+            stdx::lock_guard<stdx::mutex> guard(_mutex);
+            entry->state = computed ? Entry::kReady : Entry::kFailed;
+            if (!computed) {
+                auto it = _entries.find(key);
+                if (it != _entries.end() && it->second == entry) {
+                    _entries.erase(it);
+                }
+            }
+            _computed.notify_all();
+        });
+        computeSaltedPassword(hashedPassword, salt, saltLen, iterationCount, saltedPassword);
+        memcpy(entry->saltedPassword, saltedPassword, hashSize);
+        computed = true;
+    }
+
+private:
+    // SaltedPasswords are kept for at most this many distinct credentials before starting over.
+    static const size_t kMaxEntries = 128;
+
+    struct Entry {
+        enum State { kComputing, kReady, kFailed };
+        State state = kComputing;
+        unsigned char saltedPassword[hashSize];
+    };
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _computed;
+    unordered_map<std::string, std::shared_ptr<Entry>> _entries;
+};
+
+SaltedPasswordCache saltedPasswordCache;
+
+}  // namespace
+
+// Iterate the hash function to generate SaltedPassword
+void generateSaltedPassword(StringData hashedPassword,
+                            const unsigned char* salt,
+                            const int saltLen,
+                            const int iterationCount,
+                            unsigned char saltedPassword[hashSize]) {
+    saltedPasswordCache.get(hashedPassword, salt, saltLen, iterationCount, saltedPassword);
+}
+
+// Computes storedKey and serverKey from SaltedPassword
+static void generateSecretsFromSaltedPassword(const unsigned char saltedPassword[hashSize],
+                                              unsigned char storedKey[hashSize],
+                                              unsigned char serverKey[hashSize]) {
     unsigned char clientKey[hashSize];
     unsigned int hashLen = 0;
 
-    generateSaltedPassword(hashedPassword, salt, saltLen, iterationCount, saltedPassword);
-
     // clientKey = HMAC(saltedPassword, "Client Key")
     fassert(17498,
             crypto::hmacSha1(saltedPassword,
@@ -128,6 +212,17 @@ void generateSecrets(const std::string& hashedPassword,
                              &hashLen));
 }
 
+void generateSecrets(const std::string& hashedPassword,
+                     const unsigned char salt[],
+                     size_t saltLen,
+                     size_t iterationCount,
+                     unsigned char storedKey[hashSize],
+                     unsigned char serverKey[hashSize]) {
+    unsigned char saltedPassword[hashSize];
+    generateSaltedPassword(hashedPassword, salt, saltLen, iterationCount, saltedPassword);
+    generateSecretsFromSaltedPassword(saltedPassword, storedKey, serverKey);
+}
+
 BSONObj generateCredentials(const std::string& hashedPassword, int iterationCount) {
     const int saltLenQWords = 2;
 
@@ -145,12 +240,14 @@ BSONObj generateCredentials(const std::string& hashedPassword, int iterationCoun
     unsigned char storedKey[hashSize];
     unsigned char serverKey[hashSize];
 
-    generateSecrets(hashedPassword,
-                    reinterpret_cast<unsigned char*>(userSalt),
-                    saltLenQWords * sizeof(uint64_t),
-                    iterationCount,
-                    storedKey,
-                    serverKey);
+    // The salt is new, so there is no point looking for or remembering its SaltedPassword.
+    unsigned char saltedPassword[hashSize];
+    computeSaltedPassword(hashedPassword,
+                          reinterpret_cast<unsigned char*>(userSalt),
+                          saltLenQWords * sizeof(uint64_t),
+                          iterationCount,
+                          saltedPassword);
+    generateSecretsFromSaltedPassword(saltedPassword, storedKey, serverKey);
 
     std::string encodedStoredKey = base64::encode(reinterpret_cast<char*>(storedKey), hashSize);
     std::string encodedServerKey = base64::encode(reinterpret_cast<char*>(serverKey), hashSize);
@@ -46,7 +46,9 @@ const std::string storedKeyFieldName = "storedKey";
 const std::string serverKeyFieldName = "serverKey";
 
 /*
- * Computes the SaltedPassword from password, salt and iterationCount.
+ * Computes the SaltedPassword from password, salt and iterationCount.  Results are remembered
+ * per (password, salt, iterationCount), so repeated authentications with the same credentials
+ * only compute Hi() once.
  */
 void generateSaltedPassword(StringData hashedPassword,
                             const unsigned char* salt,
@@ -32,6 +32,7 @@
 
 #include "mongo/db/auth/authorization_manager.h"
 
+#include <boost/optional.hpp>
 #include <memory>
 #include <string>
 #include <vector>
@@ -132,9 +133,15 @@ const int AuthorizationManager::schemaVersion28SCRAM;
  * mutex.  At that point, the thread can make its modifications to the cache and let the guard
  * go out of scope.
  *
- * All updates by guards using a fetch-phase are totally ordered with respect to one another,
- * and all guards using no fetch phase are totally ordered with respect to one another, but
- * there is not a total ordering among all guard objects.
+ * A guard fetching a single user instead waits until otherFetchOfUserInProgress() is false for
+ * that user and calls beginUserFetchPhase().  Such fetches exclude only other fetches of the
+ * same user, so that many distinct users can be acquired at once, for example when a burst of
+ * connections authenticates after a failover.
+ *
+ * All updates by guards using beginFetchPhase() are totally ordered with respect to one
+ * another, as are those fetching the same user, and all guards using no fetch phase are totally
+ * ordered with respect to one another, but there is not a total ordering among all guard
+ * objects.
  *
  * The cached data has an associated counter, called the cache generation.  If the cache
  * generation changes while a guard is in fetch phase, the fetched data should not be stored
@@ -171,7 +178,10 @@ public:
         if (!_lock.owns_lock()) {
             _lock.lock();
         }
-        if (_isThisGuardInFetchPhase) {
+        if (_fetchingUser) {
+            _authzManager->_usersBeingFetched.erase(*_fetchingUser);
+            _authzManager->_fetchPhaseIsReady.notify_all();
+        } else if (_isThisGuardInFetchPhase) {
             fassert(17190, _authzManager->_isFetchPhaseBusy);
             _authzManager->_isFetchPhaseBusy = false;
             _authzManager->_fetchPhaseIsReady.notify_all();
@@ -185,6 +195,13 @@ public:
         return _authzManager->_isFetchPhaseBusy;
     }
 
+    /**
+     * Returns true if another guard is fetching the user named "userName".
+     */
+    bool otherFetchOfUserInProgress(const UserName& userName) {
+        return _authzManager->_usersBeingFetched.count(userName);
+    }
+
     /**
      * Waits on the _authzManager->_fetchPhaseIsReady condition.
      */
@@ -205,6 +222,19 @@ public:
         _lock.unlock();
     }
 
+    /**
+     * Like beginFetchPhase(), but only excludes other fetches of the user named "userName", so
+     * that fetches of distinct users run concurrently.
+     */
+    void beginUserFetchPhase(const UserName& userName) {
+        fassert(28818, !otherFetchOfUserInProgress(userName));
+        _isThisGuardInFetchPhase = true;
+        _fetchingUser = userName;
+        _authzManager->_usersBeingFetched.insert(userName);
+        _startGeneration = _authzManager->_cacheGeneration;
+        _lock.unlock();
+    }
+
     /**
      * Exits the fetch phase, reacquiring the _authzManager->_cacheMutex.
      */
@@ -242,6 +272,7 @@ private:
 
     OID _startGeneration;
     bool _isThisGuardInFetchPhase;
+    boost::optional<UserName> _fetchingUser;
     AuthorizationManager* _authzManager;
     stdx::unique_lock<stdx::mutex> _lock;
 };
@@ -441,7 +472,7 @@ Status AuthorizationManager::acquireUser(OperationContext* txn,
 
     CacheGuard guard(this, CacheGuard::fetchSynchronizationManual);
     while ((_userCache.end() == (it = _userCache.find(userName))) &&
-           guard.otherUpdateInFetchPhase()) {
+           guard.otherFetchOfUserInProgress(userName)) {
         guard.wait();
     }
 
@@ -457,7 +488,7 @@ Status AuthorizationManager::acquireUser(OperationContext* txn,
     std::unique_ptr<User> user;
 
     int authzVersion = _version;
-    guard.beginFetchPhase();
+    guard.beginUserFetchPhase(userName);
 
     // Number of times to retry a user document that fetches due to transient
     // AuthSchemaIncompatible errors.  These errors should only ever occur during and shortly
@@ -44,6 +44,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/platform/unordered_map.h"
+#include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -401,14 +402,23 @@ private:
     bool _isFetchPhaseBusy;
 
     /**
-     * Protects _userCache, _cacheGeneration, _version and _isFetchPhaseBusy.  Manipulated
-     * via CacheGuard.
+     * Names of the users whose documents acquireUser() is currently fetching.  Fetches of
+     * distinct users run concurrently; an acquireUser() for a user in this set waits for that
+     * fetch instead of starting another.
+     *
+     * Manipulated via CacheGuard.
+     */
+    unordered_set<UserName> _usersBeingFetched;
+
+    /**
+     * Protects _userCache, _cacheGeneration, _version, _isFetchPhaseBusy and
+     * _usersBeingFetched.  Manipulated via CacheGuard.
      */
     stdx::mutex _cacheMutex;
 
     /**
-     * Condition used to signal that it is OK for another CacheGuard to enter a fetch phase.
-     * Manipulated via CacheGuard.
+     * Condition used to signal that it is OK for another CacheGuard to enter a fetch phase, or
+     * that a fetch of a user has finished.  Manipulated via CacheGuard.
      */
     stdx::condition_variable _fetchPhaseIsReady;
 };
@@ -410,6 +410,9 @@ bool AuthorizationSession::isAuthorizedForActionsOnNamespace(const NamespaceStri
     return isAuthorizedForPrivilege(Privilege(ResourcePattern::forExactNamespace(ns), actions));
 }
 
+// Sessions which touch many namespaces start over rather than remember every one of them.
+static const size_t grantedActionsCacheCapacity = 256;
+
 static const int resourceSearchListCapacity = 5;
 /**
  * Builds from "target" an exhaustive list of all ResourcePatterns that match "target".
@@ -494,6 +497,7 @@ bool AuthorizationSession::isAuthenticatedAsUserWithRole(const RoleName& roleNam
 
 void AuthorizationSession::_refreshUserInfoAsNeeded(OperationContext* txn) {
     AuthorizationManager& authMan = getAuthorizationManager();
+    bool usersChanged = false;
     UserSet::iterator it = _authenticatedUsers.begin();
     while (it != _authenticatedUsers.end()) {
         User* user = *it;
@@ -510,6 +514,7 @@ void AuthorizationSession::_refreshUserInfoAsNeeded(OperationContext* txn) {
                     // Success! Replace the old User object with the updated one.
                     fassert(17067, _authenticatedUsers.replaceAt(it, updatedUser) == user);
                     authMan.releaseUser(user);
+                    usersChanged = true;
                     LOG(1) << "Updated session cache of user information for " << name;
                     break;
                 }
@@ -517,6 +522,7 @@ void AuthorizationSession::_refreshUserInfoAsNeeded(OperationContext* txn) {
                     // User does not exist anymore; remove it from _authenticatedUsers.
                     fassert(17068, _authenticatedUsers.removeAt(it) == user);
                     authMan.releaseUser(user);
+                    usersChanged = true;
                     log() << "Removed deleted user " << name
                           << " from session cache of user information.";
                     continue;  // No need to advance "it" in this case.
@@ -531,10 +537,13 @@ void AuthorizationSession::_refreshUserInfoAsNeeded(OperationContext* txn) {
         }
         ++it;
     }
-    _buildAuthenticatedRolesVector();
+    if (usersChanged) {
+        _buildAuthenticatedRolesVector();
+    }
 }
 
 void AuthorizationSession::_buildAuthenticatedRolesVector() {
+    _grantedActionsCache.clear();
     _authenticatedRoleNames.clear();
     for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
          ++it) {
@@ -569,19 +578,25 @@ bool AuthorizationSession::_isAuthorizedForPrivilege(const Privilege& privilege)
         }
     }
 
-    for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
-         ++it) {
-        User* user = *it;
-        for (int i = 0; i < resourceSearchListLength; ++i) {
-            ActionSet userActions = user->getActionsForResource(resourceSearchList[i]);
-            unmetRequirements.removeAllActionsFromSet(userActions);
-
-            if (unmetRequirements.empty())
-                return true;
+    auto cached = _grantedActionsCache.find(target);
+    if (cached == _grantedActionsCache.end()) {
+        ActionSet grantedActions;
+        for (UserSet::iterator it = _authenticatedUsers.begin(); it != _authenticatedUsers.end();
+             ++it) {
+            User* user = *it;
+            for (int i = 0; i < resourceSearchListLength; ++i) {
+                grantedActions.addAllActionsFromSet(
+                    user->getActionsForResource(resourceSearchList[i]));
+            }
+        }
+        if (_grantedActionsCache.size() >= grantedActionsCacheCapacity) {
+            _grantedActionsCache.clear();
         }
+        cached = _grantedActionsCache.insert(std::make_pair(target, grantedActions)).first;
     }
 
-    return false;
+    unmetRequirements.removeAllActionsFromSet(cached->second);
+    return unmetRequirements.empty();
 }
 
 void AuthorizationSession::setImpersonatedUserData(std::vector<UserName> usernames,
@@ -42,6 +42,7 @@
 #include "mongo/db/auth/user_name.h"
 #include "mongo/db/auth/user_set.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/unordered_map.h"
 
 namespace mongo {
 class ClientBasic;
@@ -252,6 +253,7 @@ private:
     // Builds a vector of all roles held by users who are authenticated on this connection. The
     // vector is stored in _authenticatedRoleNames. This function is called when users are
     // logged in or logged out, as well as when the user cache is determined to be out of date.
+    // It also forgets the actions remembered in _grantedActionsCache.
     void _buildAuthenticatedRolesVector();
 
     // Checks if this connection is authorized for the given Privilege, ignoring whether or not
@@ -266,6 +268,9 @@ private:
     // The roles of the authenticated users. This vector is generated when the authenticated
     // users set is changed.
     std::vector<RoleName> _authenticatedRoleNames;
+    // The actions the authenticated users hold on each resource checked since the set of users
+    // last changed, so that repeated checks against the same resource skip the privilege walk.
+    unordered_map<ResourcePattern, ActionSet> _grantedActionsCache;
 
     // A vector of impersonated UserNames and a vector of those users' RoleNames.
     // These are used in the auditing system. They are not used for authz checks.
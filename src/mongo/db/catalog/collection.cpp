@@ -44,6 +44,7 @@
 #include "mongo/db/clientcursor.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/field_ref_set.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/matcher/expression_parser.h"
@@ -52,6 +53,7 @@
 #include "mongo/db/ops/update_driver.h"
 #include "mongo/db/ops/update_request.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/mmap_v1/mmap_v1_options.h"
 #include "mongo/db/storage/record_fetcher.h"
@@ -91,6 +93,11 @@ using std::vector;
 
 using logger::LogComponent;
 
+// Inserts into a capped collection wake the awaitData cursors waiting on it at most once per this
+// many microseconds, and the cursors recheck for new data as often. Zero wakes them on every
+// insert.
+MONGO_EXPORT_SERVER_PARAMETER(internalCappedInsertNotifyCoalesceMicros, int, 1000);
+
 std::string CompactOptions::toString() const {
     std::stringstream ss;
     ss << "paddingMode: ";
@@ -114,39 +121,72 @@ std::string CompactOptions::toString() const {
 // CappedInsertNotifier
 //
 
-CappedInsertNotifier::CappedInsertNotifier() : _cappedInsertCount(0), _dead(false) {}
+CappedInsertNotifier::CappedInsertNotifier()
+    : _cappedInsertCount(0), _numWaiters(0), _lastNotifyMicros(0), _dead(false) {}
 
 void CappedInsertNotifier::notifyOfInsert() {
-    stdx::lock_guard<stdx::mutex> lk(_cappedNewDataMutex);
-    if (!_dead) {
-        _cappedInsertCount++;
+    if (_dead.load()) {
+        return;
+    }
+
+    // The count is bumped before '_numWaiters' is read, and waiters register before reading the
+    // count, so either this insert sees the waiter or the waiter sees this insert.
+    _cappedInsertCount.fetchAndAdd(1);
+    if (0 == _numWaiters.load()) {
+        return;
     }
+
+    const long long coalesceMicros = internalCappedInsertNotifyCoalesceMicros;
+    const unsigned long long now = curTimeMicros64();
+    if (coalesceMicros > 0 && now < _lastNotifyMicros.load() + coalesceMicros) {
+        // Waiters recheck the count within the window, so they find this insert without a
+        // wakeup of their own.
+        return;
+    }
+    _lastNotifyMicros.store(now);
+
+    stdx::lock_guard<stdx::mutex> lk(_cappedNewDataMutex);
     _cappedNewDataNotifier.notify_all();
 }
 
 uint64_t CappedInsertNotifier::getCount() const {
-    stdx::lock_guard<stdx::mutex> lk(_cappedNewDataMutex);
-    return _cappedInsertCount;
+    return _cappedInsertCount.load();
 }
 
 void CappedInsertNotifier::waitForInsert(uint64_t referenceCount, Microseconds timeout) const {
-    stdx::unique_lock<stdx::mutex> lk(_cappedNewDataMutex);
-    while (!_dead && referenceCount == _cappedInsertCount) {
-        if (stdx::cv_status::timeout == _cappedNewDataNotifier.wait_for(lk, timeout)) {
-            return;
+    if (_dead.load() || referenceCount != _cappedInsertCount.load()) {
+        return;
+    }
+
+    _numWaiters.fetchAndAdd(1);
+    const Date_t deadline = Date_t::now() + timeout;
+    {
+        stdx::unique_lock<stdx::mutex> lk(_cappedNewDataMutex);
+        while (!_dead.load() && referenceCount == _cappedInsertCount.load()) {
+            const Date_t now = Date_t::now();
+            if (now >= deadline) {
+                break;
+            }
+
+            Microseconds wait = duration_cast<Microseconds>(deadline - now);
+            const long long coalesceMicros = internalCappedInsertNotifyCoalesceMicros;
+            if (coalesceMicros > 0) {
+                wait = std::min(wait, Microseconds(coalesceMicros));
+            }
+            _cappedNewDataNotifier.wait_for(lk, wait);
         }
     }
+    _numWaiters.subtractAndFetch(1);
 }
 
 void CappedInsertNotifier::kill() {
+    _dead.store(true);
     stdx::lock_guard<stdx::mutex> lk(_cappedNewDataMutex);
-    _dead = true;
     _cappedNewDataNotifier.notify_all();
 }
 
 bool CappedInsertNotifier::isDead() {
-    stdx::lock_guard<stdx::mutex> lk(_cappedNewDataMutex);
-    return _dead;
+    return _dead.load();
 }
 
 // ----
@@ -359,6 +399,46 @@ Status Collection::insertDocument(OperationContext* txn,
     return status;
 }
 
+Status Collection::insertDocuments(OperationContext* txn,
+                                   std::vector<BSONObj>::const_iterator begin,
+                                   std::vector<BSONObj>::const_iterator end,
+                                   bool enforceQuota,
+                                   bool fromMigrate) {
+    const bool hasIdIndex = _indexCatalog.findIdIndex(txn);
+    for (auto it = begin; it != end; it++) {
+        auto status = checkValidation(txn, *it);
+        if (!status.isOK())
+            return status;
+
+        if (hasIdIndex && (*it)["_id"].eoo()) {
+            return Status(ErrorCodes::InternalError,
+                          str::stream() << "Collection::insertDocuments got "
+                                           "document without _id for ns:" << _ns.ns());
+        }
+    }
+
+    const SnapshotId sid = txn->recoveryUnit()->getSnapshotId();
+
+    if (_mustTakeCappedLockOnInsert)
+        synchronizeOnCappedInFlightResource(txn->lockState(), _ns);
+
+    Status status = _insertDocuments(txn, begin, end, enforceQuota);
+    if (!status.isOK())
+        return status;
+    invariant(sid == txn->recoveryUnit()->getSnapshotId());
+
+    getGlobalServiceContext()->getOpObserver()->onInserts(txn, ns(), begin, end, fromMigrate);
+
+    // If there is a notifier object and another thread is waiting on it, then we notify waiters
+    // of this batch. Waiters keep a shared_ptr to '_cappedNotifier', so there are waiters if this
+    // Collection's shared_ptr is not unique.
+    if (_cappedNotifier && !_cappedNotifier.unique()) {
+        _cappedNotifier->notifyOfInsert();
+    }
+
+    return Status::OK();
+}
+
 Status Collection::insertDocument(OperationContext* txn,
                                   const BSONObj& doc,
                                   MultiIndexBlock* indexBlock,
@@ -420,6 +500,38 @@ Status Collection::_insertDocument(OperationContext* txn,
     return Status::OK();
 }
 
+Status Collection::_insertDocuments(OperationContext* txn,
+                                    std::vector<BSONObj>::const_iterator begin,
+                                    std::vector<BSONObj>::const_iterator end,
+                                    bool enforceQuota) {
+    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX));
+
+    std::vector<Record> records;
+    records.reserve(std::distance(begin, end));
+    for (auto it = begin; it != end; it++) {
+        Record record = {RecordId(), RecordData(it->objdata(), it->objsize())};
+        records.push_back(record);
+    }
+
+    Status status = _recordStore->insertRecords(txn, &records, _enforceQuota(enforceQuota));
+    if (!status.isOK())
+        return status;
+
+    std::vector<BsonRecord> bsonRecords;
+    bsonRecords.reserve(records.size());
+    int recordIndex = 0;
+    for (auto it = begin; it != end; it++) {
+        RecordId loc = records[recordIndex++].id;
+        invariant(RecordId::min() < loc);
+        invariant(loc < RecordId::max());
+
+        BsonRecord bsonRecord = {loc, &(*it)};
+        bsonRecords.push_back(bsonRecord);
+    }
+
+    return _indexCatalog.indexRecords(txn, bsonRecords);
+}
+
 Status Collection::aboutToDeleteCapped(OperationContext* txn,
                                        const RecordId& loc,
                                        RecordData data) {
@@ -463,6 +575,29 @@ void Collection::deleteDocument(
     }
 }
 
+namespace {
+
+/**
+ * Returns true if modifying any of the paths in 'updatedFields' could change the keys of an
+ * index whose indexed paths are 'indexedPaths'. A NULL 'indexedPaths' is treated as indexing
+ * every path.
+ */
+bool updatedFieldsMightBeIndexed(const UpdateIndexData* indexedPaths,
+                                 const FieldRefSet& updatedFields) {
+    if (!indexedPaths) {
+        return true;
+    }
+    for (FieldRefSet::const_iterator it = updatedFields.begin(); it != updatedFields.end();
+         ++it) {
+        if (indexedPaths->mightBeIndexed((*it)->dottedField())) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
 Counter64 moveCounter;
 ServerStatusMetricField<Counter64> moveCounterDisplay("record.moves", &moveCounter);
 
@@ -473,7 +608,8 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
                                                 bool enforceQuota,
                                                 bool indexesAffected,
                                                 OpDebug* debug,
-                                                oplogUpdateEntryArgs& args) {
+                                                oplogUpdateEntryArgs& args,
+                                                const FieldRefSet* updatedFields) {
     {
         auto status = checkValidation(txn, newDoc);
         if (!status.isOK()) {
@@ -511,6 +647,13 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
             IndexCatalogEntry* entry = ii.catalogEntry(descriptor);
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            if (updatedFields && !updatedFieldsMightBeIndexed(
+                                     _infoCache.getIndexKeys(txn, descriptor->indexName()),
+                                     *updatedFields)) {
+                // None of the modified paths can change this index's keys, so leave it alone.
+                continue;
+            }
+
             InsertDeleteOptions options;
             options.logIfError = false;
             options.dupsAllowed =
@@ -571,8 +714,13 @@ StatusWith<RecordId> Collection::updateDocument(OperationContext* txn,
             IndexDescriptor* descriptor = ii.next();
             IndexAccessMethod* iam = ii.accessMethod(descriptor);
 
+            auto ticket = updateTickets.mutableMap().find(descriptor);
+            if (ticket == updateTickets.mutableMap().end()) {
+                continue;
+            }
+
             int64_t updatedKeys;
-            Status ret = iam->update(txn, *updateTickets.mutableMap()[descriptor], &updatedKeys);
+            Status ret = iam->update(txn, *ticket->second, &updatedKeys);
             if (!ret.isOK())
                 return StatusWith<RecordId>(ret);
             if (debug)
@@ -33,6 +33,7 @@
 #include <cstdint>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/status_with.h"
@@ -48,6 +49,7 @@
 #include "mongo/db/storage/capped_callback.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/snapshot.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 
@@ -56,6 +58,7 @@ namespace mongo {
 class CollectionCatalogEntry;
 class DatabaseCatalogEntry;
 class ExtentManager;
+class FieldRefSet;
 class IndexCatalog;
 class MatchExpression;
 class MultiIndexBlock;
@@ -103,6 +106,12 @@ struct CompactStats {
 /**
  * Queries with the awaitData option use this notifier object to wait for more data to be
  * inserted into the capped collection.
+ *
+ * Every insert bumps a version which waiters read without taking a lock, so a waiter which has
+ * missed an insert returns immediately and inserts with no one waiting never take the mutex. To
+ * keep thousands of waiters from being woken on every one of a stream of inserts, at most one
+ * wakeup is sent per internalCappedInsertNotifyCoalesceMicros; waiters also recheck the version
+ * that often, so they see the inserts whose wakeup was coalesced within that window.
  */
 class CappedInsertNotifier {
 public:
@@ -139,17 +148,24 @@ private:
     // Signalled when a successful insert is made into a capped collection.
     mutable stdx::condition_variable _cappedNewDataNotifier;
 
-    // Mutex used with '_cappedNewDataNotifier'. Protects access to '_cappedInsertCount'.
+    // Mutex used with '_cappedNewDataNotifier'. Held while notifying, and by waiters between
+    // checking '_cappedInsertCount' and waiting, so that no notification is lost.
     mutable stdx::mutex _cappedNewDataMutex;
 
     // A counter, incremented on insertion of new data into the capped collection.
     //
     // The condition which '_cappedNewDataNotifier' is being notified of is an increment of this
-    // counter. Access to this counter is synchronized with '_cappedNewDataMutex'.
-    uint64_t _cappedInsertCount;
+    // counter.
+    AtomicUInt64 _cappedInsertCount;
+
+    // The number of threads in waitForInsert(). Inserts only notify if it is non-zero.
+    mutable AtomicUInt32 _numWaiters;
+
+    // When the last notification was sent, in microseconds since the epoch.
+    AtomicUInt64 _lastNotifyMicros;
 
     // True once the notifier is dead.
-    bool _dead;
+    AtomicWord<bool> _dead;
 };
 
 /**
@@ -242,6 +258,19 @@ public:
                           bool enforceQuota,
                           bool fromMigrate = false);
 
+    /**
+     * Inserts the documents in [begin, end) with the same semantics as calling insertDocument()
+     * on each of them, but writes the records and index keys as one batch.
+     *
+     * On failure some of the documents may have been written, so the caller must abandon the
+     * enclosing WriteUnitOfWork.
+     */
+    Status insertDocuments(OperationContext* txn,
+                           std::vector<BSONObj>::const_iterator begin,
+                           std::vector<BSONObj>::const_iterator end,
+                           bool enforceQuota,
+                           bool fromMigrate = false);
+
     /**
      * Callers must ensure no document validation is performed for this collection when calling
      * this method.
@@ -258,6 +287,9 @@ public:
      * if the document fits in the old space, it is put there
      * if not, it is moved
      * @return the post update location of the doc (may or may not be the same as oldLocation)
+     *
+     * If 'updatedFields' is non-NULL, it holds every path the update modified, and the keys of
+     * an index are only recomputed if one of those paths might be indexed by it.
      */
     StatusWith<RecordId> updateDocument(OperationContext* txn,
                                         const RecordId& oldLocation,
@@ -266,7 +298,8 @@ public:
                                         bool enforceQuota,
                                         bool indexesAffected,
                                         OpDebug* debug,
-                                        oplogUpdateEntryArgs& args);
+                                        oplogUpdateEntryArgs& args,
+                                        const FieldRefSet* updatedFields = NULL);
 
     bool updateWithDamagesSupported() const;
 
@@ -405,6 +438,11 @@ private:
      */
     Status _insertDocument(OperationContext* txn, const BSONObj& doc, bool enforceQuota);
 
+    Status _insertDocuments(OperationContext* txn,
+                            std::vector<BSONObj>::const_iterator begin,
+                            std::vector<BSONObj>::const_iterator end,
+                            bool enforceQuota);
+
     bool _enforceQuota(bool userEnforeQuota) const;
 
     int _magic;
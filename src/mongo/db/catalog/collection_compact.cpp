@@ -100,7 +100,10 @@ private:
 
 StatusWith<CompactStats> Collection::compact(OperationContext* txn,
                                              const CompactOptions* compactOptions) {
-    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X));
+    dassert(txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_X) ||
+            (_recordStore->compactSupported() && _recordStore->compactsInPlace() &&
+             _recordStore->compactsOnline() &&
+             txn->lockState()->isCollectionLockedForMode(ns().toString(), MODE_IX)));
 
     DisableDocumentValidation validationDisabler(txn);
 
@@ -39,8 +39,10 @@
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/index_legacy.h"
+#include "mongo/db/query/collection_sample.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/planner_ixselect.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/debug_util.h"
@@ -48,6 +50,58 @@
 
 namespace mongo {
 
+namespace {
+
+/**
+ * Adds the paths whose modification could change the keys, or the filter expression, of the
+ * index described by 'descriptor' to 'indexedPaths'.
+ */
+void addIndexedPaths(const IndexDescriptor* descriptor,
+                     const IndexCatalogEntry* entry,
+                     UpdateIndexData* indexedPaths) {
+    if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
+        BSONObj key = descriptor->keyPattern();
+        BSONObjIterator j(key);
+        while (j.more()) {
+            BSONElement e = j.next();
+            indexedPaths->addPath(e.fieldName());
+        }
+    } else {
+        fts::FTSSpec ftsSpec(descriptor->infoObj());
+
+        if (ftsSpec.wildcard()) {
+            indexedPaths->allPathsIndexed();
+        } else {
+            for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraBefore(i));
+            }
+            for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
+                 it != ftsSpec.weights().end();
+                 ++it) {
+                indexedPaths->addPath(it->first);
+            }
+            for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
+                indexedPaths->addPath(ftsSpec.extraAfter(i));
+            }
+            // Any update to a path containing "language" as a component could change the
+            // language of a subdocument.  Add the override field as a path component.
+            indexedPaths->addPathComponent(ftsSpec.languageOverrideField());
+        }
+    }
+
+    // handle partial indexes
+    const MatchExpression* filter = entry->getFilterExpression();
+    if (filter) {
+        unordered_set<std::string> paths;
+        QueryPlannerIXSelect::getFields(filter, "", &paths);
+        for (auto it = paths.begin(); it != paths.end(); ++it) {
+            indexedPaths->addPath(*it);
+        }
+    }
+}
+
+}  // namespace
+
 CollectionInfoCache::CollectionInfoCache(Collection* collection)
     : _collection(collection),
       _keysComputed(false),
@@ -63,53 +117,25 @@ const UpdateIndexData& CollectionInfoCache::getIndexKeys(OperationContext* txn)
     return _indexedPaths;
 }
 
+const UpdateIndexData* CollectionInfoCache::getIndexKeys(OperationContext* txn,
+                                                         StringData indexName) const {
+    dassert(txn->lockState()->isCollectionLockedForMode(_collection->ns().ns(), MODE_IS));
+    invariant(_keysComputed);
+    auto it = _indexedPathsByIndex.find(indexName);
+    return it == _indexedPathsByIndex.end() ? NULL : &it->second;
+}
+
 void CollectionInfoCache::computeIndexKeys(OperationContext* txn) {
     _indexedPaths.clear();
+    _indexedPathsByIndex = StringMap<UpdateIndexData>();
 
     IndexCatalog::IndexIterator i = _collection->getIndexCatalog()->getIndexIterator(txn, true);
     while (i.more()) {
         IndexDescriptor* descriptor = i.next();
-
-        if (descriptor->getAccessMethodName() != IndexNames::TEXT) {
-            BSONObj key = descriptor->keyPattern();
-            BSONObjIterator j(key);
-            while (j.more()) {
-                BSONElement e = j.next();
-                _indexedPaths.addPath(e.fieldName());
-            }
-        } else {
-            fts::FTSSpec ftsSpec(descriptor->infoObj());
-
-            if (ftsSpec.wildcard()) {
-                _indexedPaths.allPathsIndexed();
-            } else {
-                for (size_t i = 0; i < ftsSpec.numExtraBefore(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraBefore(i));
-                }
-                for (fts::Weights::const_iterator it = ftsSpec.weights().begin();
-                     it != ftsSpec.weights().end();
-                     ++it) {
-                    _indexedPaths.addPath(it->first);
-                }
-                for (size_t i = 0; i < ftsSpec.numExtraAfter(); ++i) {
-                    _indexedPaths.addPath(ftsSpec.extraAfter(i));
-                }
-                // Any update to a path containing "language" as a component could change the
-                // language of a subdocument.  Add the override field as a path component.
-                _indexedPaths.addPathComponent(ftsSpec.languageOverrideField());
-            }
-        }
-
-        // handle partial indexes
         const IndexCatalogEntry* entry = i.catalogEntry(descriptor);
-        const MatchExpression* filter = entry->getFilterExpression();
-        if (filter) {
-            unordered_set<std::string> paths;
-            QueryPlannerIXSelect::getFields(filter, "", &paths);
-            for (auto it = paths.begin(); it != paths.end(); ++it) {
-                _indexedPaths.addPath(*it);
-            }
-        }
+
+        addIndexedPaths(descriptor, entry, &_indexedPaths);
+        addIndexedPaths(descriptor, entry, &_indexedPathsByIndex[descriptor->indexName()]);
     }
 
     _keysComputed = true;
@@ -208,4 +234,13 @@ void CollectionInfoCache::rebuildIndexData(OperationContext* txn) {
 CollectionIndexUsageMap CollectionInfoCache::getIndexUsageStats() const {
     return _indexUsageTracker.getUsageStats();
 }
+
+std::shared_ptr<const CollectionSample> CollectionInfoCache::getSample(OperationContext* txn) {
+    const long long numRecords = _collection->numRecords(txn);
+    stdx::lock_guard<stdx::mutex> lk(_sampleMutex);
+    if (!_sample || _sample->isStale(numRecords, Date_t::now())) {
+        _sample = CollectionSample::make(txn, _collection, internalQueryPlanSampleSize);
+    }
+    return _sample;
+}
 }
@@ -30,14 +30,19 @@
 
 #pragma once
 
+#include <memory>
+
 #include "mongo/db/collection_index_usage_tracker.h"
 #include "mongo/db/query/plan_cache.h"
 #include "mongo/db/query/query_settings.h"
 #include "mongo/db/update_index_data.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
 class Collection;
+class CollectionSample;
 class OperationContext;
 
 /**
@@ -63,6 +68,12 @@ public:
     */
     const UpdateIndexData& getIndexKeys(OperationContext* txn) const;
 
+    /**
+     * Returns the paths indexed by the single index named 'indexName', in the same form as
+     * getIndexKeys(), or NULL if there is no such index.
+     */
+    const UpdateIndexData* getIndexKeys(OperationContext* txn, StringData indexName) const;
+
     /**
      * Returns cached index usage statistics for this collection.  The map returned will contain
      * entry for each index in the collection along with both a usage counter and a timestamp
@@ -72,6 +83,13 @@ public:
      */
     CollectionIndexUsageMap getIndexUsageStats() const;
 
+    /**
+     * Returns a random sample of this collection's documents for estimating plan costs, taking
+     * a new sample if there is none yet or the current one is stale. Returns null if no sample
+     * can be taken.
+     */
+    std::shared_ptr<const CollectionSample> getSample(OperationContext* txn);
+
     /**
      * Builds internal cache state based on the current state of the Collection's IndexCatalog
      */
@@ -110,6 +128,7 @@ private:
     // ---  index keys cache
     bool _keysComputed;
     UpdateIndexData _indexedPaths;
+    StringMap<UpdateIndexData> _indexedPathsByIndex;
 
     // A cache for query plans.
     std::unique_ptr<PlanCache> _planCache;
@@ -121,6 +140,10 @@ private:
     // Tracks index usage statistics for this collection.
     CollectionIndexUsageTracker _indexUsageTracker;
 
+    // Guards '_sample', which may be replaced by any reader of the collection.
+    stdx::mutex _sampleMutex;
+    std::shared_ptr<const CollectionSample> _sample;
+
     void computeIndexKeys(OperationContext* txn);
     void updatePlanCacheIndexEntries(OperationContext* txn);
 
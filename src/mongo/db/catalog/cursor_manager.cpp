@@ -323,66 +323,73 @@ CursorManager::~CursorManager() {
 }
 
 void CursorManager::invalidateAll(bool collectionGoingAway, const std::string& reason) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        // we kill the executor, but it deletes itself
-        PlanExecutor* exec = *it;
-        exec->kill(reason);
-        invariant(exec->collection() == NULL);
-    }
-    _nonCachedExecutors.clear();
-
-    if (collectionGoingAway) {
-        // we're going to wipe out the world
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-            ClientCursor* cc = i->second;
+    for (Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            // we kill the executor, but it deletes itself
+            PlanExecutor* exec = *it;
+            exec->kill(reason);
+            invariant(exec->collection() == NULL);
+        }
+        partition.nonCachedExecutors.clear();
 
-            cc->kill();
+        if (collectionGoingAway) {
+            // we're going to wipe out the world
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
+                ClientCursor* cc = i->second;
 
-            invariant(cc->getExecutor() == NULL || cc->getExecutor()->collection() == NULL);
+                cc->kill();
 
-            // If the CC is pinned, somebody is actively using it and we do not delete it.
-            // Instead we notify the holder that we killed it.  The holder will then delete the
-            // CC.
-            //
-            // If the CC is not pinned, there is nobody actively holding it.  We can safely
-            // delete it.
-            if (!cc->isPinned()) {
-                delete cc;
+                invariant(cc->getExecutor() == NULL || cc->getExecutor()->collection() == NULL);
+
+                // If the CC is pinned, somebody is actively using it and we do not delete it.
+                // Instead we notify the holder that we killed it.  The holder will then delete
+                // the CC.
+                //
+                // If the CC is not pinned, there is nobody actively holding it.  We can safely
+                // delete it.
+                if (!cc->isPinned()) {
+                    delete cc;
+                }
             }
-        }
-    } else {
-        CursorMap newMap;
-
-        // collection will still be around, just all PlanExecutors are invalid
-        for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-            ClientCursor* cc = i->second;
-
-            // Note that a valid ClientCursor state is "no cursor no executor."  This is because
-            // the set of active cursor IDs in ClientCursor is used as representation of query
-            // state.  See sharding_block.h.  TODO(greg,hk): Move this out.
-            if (NULL == cc->getExecutor()) {
-                newMap.insert(*i);
-                continue;
+        } else {
+            CursorMap newMap;
+
+            // collection will still be around, just all PlanExecutors are invalid
+            for (CursorMap::const_iterator i = partition.cursors.begin();
+                 i != partition.cursors.end();
+                 ++i) {
+                ClientCursor* cc = i->second;
+
+                // Note that a valid ClientCursor state is "no cursor no executor."  This is
+                // because the set of active cursor IDs in ClientCursor is used as representation
+                // of query state.  See sharding_block.h.  TODO(greg,hk): Move this out.
+                if (NULL == cc->getExecutor()) {
+                    newMap.insert(*i);
+                    continue;
+                }
+
+                if (cc->isPinned() || cc->isAggCursor()) {
+                    // Pinned cursors need to stay alive, so we leave them around.  Aggregation
+                    // cursors also can stay alive (since they don't have their lifetime bound to
+                    // the underlying collection).  However, if they have an associated executor,
+                    // we need to kill it, because it's now invalid.
+                    if (cc->getExecutor())
+                        cc->getExecutor()->kill(reason);
+                    newMap.insert(*i);
+                } else {
+                    cc->kill();
+                    delete cc;
+                }
             }
 
-            if (cc->isPinned() || cc->isAggCursor()) {
-                // Pinned cursors need to stay alive, so we leave them around.  Aggregation
-                // cursors also can stay alive (since they don't have their lifetime bound to
-                // the underlying collection).  However, if they have an associated executor, we
-                // need to kill it, because it's now invalid.
-                if (cc->getExecutor())
-                    cc->getExecutor()->kill(reason);
-                newMap.insert(*i);
-            } else {
-                cc->kill();
-                delete cc;
-            }
+            partition.cursors = newMap;
         }
-
-        _cursors = newMap;
     }
 }
 
@@ -395,58 +402,72 @@ void CursorManager::invalidateDocument(OperationContext* txn,
         return;
     }
 
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (ExecSet::iterator it = _nonCachedExecutors.begin(); it != _nonCachedExecutors.end();
-         ++it) {
-        PlanExecutor* exec = *it;
-        exec->invalidate(txn, dl, type);
-    }
-
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        PlanExecutor* exec = i->second->getExecutor();
-        if (exec) {
+        for (ExecSet::iterator it = partition.nonCachedExecutors.begin();
+             it != partition.nonCachedExecutors.end();
+             ++it) {
+            PlanExecutor* exec = *it;
             exec->invalidate(txn, dl, type);
         }
+
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            PlanExecutor* exec = i->second->getExecutor();
+            if (exec) {
+                exec->invalidate(txn, dl, type);
+            }
+        }
     }
 }
 
 std::size_t CursorManager::timeoutCursors(int millisSinceLastCall) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    std::size_t numTimedOut = 0;
+    for (Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    vector<ClientCursor*> toDelete;
+        vector<ClientCursor*> toDelete;
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        if (cc->shouldTimeout(millisSinceLastCall))
-            toDelete.push_back(cc);
-    }
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            if (cc->shouldTimeout(millisSinceLastCall))
+                toDelete.push_back(cc);
+        }
 
-    for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end(); ++i) {
-        ClientCursor* cc = *i;
-        _deregisterCursor_inlock(cc);
-        cc->kill();
-        delete cc;
+        for (vector<ClientCursor*>::const_iterator i = toDelete.begin(); i != toDelete.end();
+             ++i) {
+            ClientCursor* cc = *i;
+            partition.cursors.erase(cc->cursorid());
+            cc->kill();
+            delete cc;
+        }
+
+        numTimedOut += toDelete.size();
     }
 
-    return toDelete.size();
+    return numTimedOut;
 }
 
 void CursorManager::registerExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    const std::pair<ExecSet::iterator, bool> result = _nonCachedExecutors.insert(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    const std::pair<ExecSet::iterator, bool> result = partition.nonCachedExecutors.insert(exec);
     invariant(result.second);  // make sure this was inserted
 }
 
 void CursorManager::deregisterExecutor(PlanExecutor* exec) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _nonCachedExecutors.erase(exec);
+    Partition& partition = _partitionForExecutor(exec);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    partition.nonCachedExecutors.erase(exec);
 }
 
 ClientCursor* CursorManager::find(CursorId id, bool pin) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorMap::const_iterator it = _cursors.find(id);
-    if (it == _cursors.end())
+    Partition& partition = _partitionForCursor(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    CursorMap::const_iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end())
         return NULL;
 
     ClientCursor* cursor = it->second;
@@ -459,7 +480,8 @@ ClientCursor* CursorManager::find(CursorId id, bool pin) {
 }
 
 void CursorManager::unpin(ClientCursor* cursor) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _partitionForCursor(cursor->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
     invariant(cursor->isPinned());
     cursor->unsetPinned();
@@ -470,47 +492,60 @@ bool CursorManager::ownsCursorId(CursorId cursorId) const {
 }
 
 void CursorManager::getCursorIds(std::set<CursorId>* openCursors) const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    for (const Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    for (CursorMap::const_iterator i = _cursors.begin(); i != _cursors.end(); ++i) {
-        ClientCursor* cc = i->second;
-        openCursors->insert(cc->cursorid());
+        for (CursorMap::const_iterator i = partition.cursors.begin(); i != partition.cursors.end();
+             ++i) {
+            ClientCursor* cc = i->second;
+            openCursors->insert(cc->cursorid());
+        }
     }
 }
 
 size_t CursorManager::numCursors() const {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    return _cursors.size();
+    size_t numCursors = 0;
+    for (const Partition& partition : _partitions) {
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        numCursors += partition.cursors.size();
+    }
+    return numCursors;
 }
 
-CursorId CursorManager::_allocateCursorId_inlock() {
+CursorId CursorManager::registerCursor(ClientCursor* cc) {
+    invariant(cc);
     for (int i = 0; i < 10000; i++) {
-        unsigned mypart = static_cast<unsigned>(_random->nextInt32());
+        unsigned mypart;
+        {
+            stdx::lock_guard<SimpleMutex> lk(_randomMutex);
+            mypart = static_cast<unsigned>(_random->nextInt32());
+        }
         CursorId id = cursorIdFromParts(_collectionCacheRuntimeId, mypart);
-        if (_cursors.count(id) == 0)
+
+        // Checking for a collision and inserting under the same partition mutex keeps ids unique.
+        Partition& partition = _partitionForCursor(id);
+        stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+        if (partition.cursors.count(id) == 0) {
+            partition.cursors[id] = cc;
             return id;
+        }
     }
     fassertFailed(17360);
 }
 
-CursorId CursorManager::registerCursor(ClientCursor* cc) {
-    invariant(cc);
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    CursorId id = _allocateCursorId_inlock();
-    _cursors[id] = cc;
-    return id;
-}
-
 void CursorManager::deregisterCursor(ClientCursor* cc) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
-    _deregisterCursor_inlock(cc);
+    invariant(cc);
+    Partition& partition = _partitionForCursor(cc->cursorid());
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
+    partition.cursors.erase(cc->cursorid());
 }
 
 Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shouldAudit) {
-    stdx::lock_guard<SimpleMutex> lk(_mutex);
+    Partition& partition = _partitionForCursor(id);
+    stdx::lock_guard<SimpleMutex> lk(partition.mutex);
 
-    CursorMap::iterator it = _cursors.find(id);
-    if (it == _cursors.end()) {
+    CursorMap::iterator it = partition.cursors.find(id);
+    if (it == partition.cursors.end()) {
         if (shouldAudit) {
             audit::logKillCursorsAuthzCheck(txn->getClient(), _nss, id, ErrorCodes::CursorNotFound);
         }
@@ -532,14 +567,18 @@ Status CursorManager::eraseCursor(OperationContext* txn, CursorId id, bool shoul
     }
 
     cursor->kill();
-    _deregisterCursor_inlock(cursor);
+    partition.cursors.erase(it);
     delete cursor;
     return Status::OK();
 }
 
-void CursorManager::_deregisterCursor_inlock(ClientCursor* cc) {
-    invariant(cc);
-    CursorId id = cc->cursorid();
-    _cursors.erase(id);
+CursorManager::Partition& CursorManager::_partitionForCursor(CursorId id) {
+    // The low half of a cursor id is random.
+    return _partitions[static_cast<uint32_t>(id) % kNumPartitions];
+}
+
+CursorManager::Partition& CursorManager::_partitionForExecutor(PlanExecutor* exec) {
+    // Skip the low bits, which are the same for every executor due to allocation alignment.
+    return _partitions[(reinterpret_cast<uintptr_t>(exec) >> 4) % kNumPartitions];
 }
 }
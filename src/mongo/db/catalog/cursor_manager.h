@@ -143,19 +143,33 @@ public:
     static std::size_t timeoutCursorsGlobal(OperationContext* txn, int millisSinceLastCall);
 
 private:
-    CursorId _allocateCursorId_inlock();
-    void _deregisterCursor_inlock(ClientCursor* cc);
+    typedef unordered_set<PlanExecutor*> ExecSet;
+    typedef std::map<CursorId, ClientCursor*> CursorMap;
+
+    /**
+     * The registered executors and cursors are split into partitions, each with its own mutex,
+     * so that concurrent operations on one collection rarely wait on each other. Cursors are
+     * placed by the random half of their id and executors by their address. Operations which
+     * visit every cursor take the partition mutexes one at a time.
+     */
+    struct Partition {
+        mutable SimpleMutex mutex;
+        ExecSet nonCachedExecutors;
+        CursorMap cursors;
+    };
+
+    static const size_t kNumPartitions = 16;
+
+    Partition& _partitionForCursor(CursorId id);
+    Partition& _partitionForExecutor(PlanExecutor* exec);
 
     NamespaceString _nss;
     unsigned _collectionCacheRuntimeId;
-    std::unique_ptr<PseudoRandom> _random;
-
-    mutable SimpleMutex _mutex;
 
-    typedef unordered_set<PlanExecutor*> ExecSet;
-    ExecSet _nonCachedExecutors;
+    // Only used to generate cursor ids.
+    SimpleMutex _randomMutex;
+    std::unique_ptr<PseudoRandom> _random;
 
-    typedef std::map<CursorId, ClientCursor*> CursorMap;
-    CursorMap _cursors;
+    Partition _partitions[kNumPartitions];
 };
 }
@@ -78,6 +78,29 @@ const int DefaultIndexVersionNumber = 1;
 
 const BSONObj IndexCatalog::_idObj = BSON("_id" << 1);
 
+namespace {
+/**
+ * Returns whether "entry" is one an IndexIterator over the catalog would return.
+ */
+bool isEntryVisible(OperationContext* txn,
+                    IndexCatalogEntry* entry,
+                    bool includeUnfinishedIndexes) {
+    if (includeUnfinishedIndexes)
+        return true;
+
+    if (auto minSnapshot = entry->getMinimumVisibleSnapshot()) {
+        if (auto mySnapshot = txn->recoveryUnit()->getMajorityCommittedSnapshot()) {
+            if (mySnapshot < minSnapshot) {
+                // This index isn't finished in my snapshot.
+                return false;
+            }
+        }
+    }
+
+    return entry->isReady(txn);
+}
+}  // namespace
+
 // -------------
 
 IndexCatalog::IndexCatalog(Collection* collection)
@@ -980,19 +1003,8 @@ void IndexCatalog::IndexIterator::_advance() {
         IndexCatalogEntry* entry = *_iterator;
         ++_iterator;
 
-        if (!_includeUnfinishedIndexes) {
-            if (auto minSnapshot = entry->getMinimumVisibleSnapshot()) {
-                if (auto mySnapshot = _txn->recoveryUnit()->getMajorityCommittedSnapshot()) {
-                    if (mySnapshot < minSnapshot) {
-                        // This index isn't finished in my snapshot.
-                        continue;
-                    }
-                }
-            }
-
-            if (!entry->isReady(_txn))
-                continue;
-        }
+        if (!isEntryVisible(_txn, entry, _includeUnfinishedIndexes))
+            continue;
 
         _next = entry;
         return;
@@ -1013,11 +1025,10 @@ IndexDescriptor* IndexCatalog::findIdIndex(OperationContext* txn) const {
 IndexDescriptor* IndexCatalog::findIndexByName(OperationContext* txn,
                                                StringData name,
                                                bool includeUnfinishedIndexes) const {
-    IndexIterator ii = getIndexIterator(txn, includeUnfinishedIndexes);
-    while (ii.more()) {
-        IndexDescriptor* desc = ii.next();
-        if (desc->indexName() == name)
-            return desc;
+    auto range = _entries.findByName(name);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (isEntryVisible(txn, i->second, includeUnfinishedIndexes))
+            return i->second->descriptor();
     }
     return NULL;
 }
@@ -1025,11 +1036,10 @@ IndexDescriptor* IndexCatalog::findIndexByName(OperationContext* txn,
 IndexDescriptor* IndexCatalog::findIndexByKeyPattern(OperationContext* txn,
                                                      const BSONObj& key,
                                                      bool includeUnfinishedIndexes) const {
-    IndexIterator ii = getIndexIterator(txn, includeUnfinishedIndexes);
-    while (ii.more()) {
-        IndexDescriptor* desc = ii.next();
-        if (desc->keyPattern() == key)
-            return desc;
+    auto range = _entries.findByKeyPattern(key);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (isEntryVisible(txn, i->second, includeUnfinishedIndexes))
+            return i->second->descriptor();
     }
     return NULL;
 }
@@ -1151,6 +1161,28 @@ Status IndexCatalog::_indexRecord(OperationContext* txn,
     return index->accessMethod()->insert(txn, obj, loc, options, &inserted);
 }
 
+Status IndexCatalog::_indexRecords(OperationContext* txn,
+                                   IndexCatalogEntry* index,
+                                   const std::vector<BsonRecord>& records) {
+    const MatchExpression* filter = index->getFilterExpression();
+    std::vector<BsonRecord> filtered;
+    if (filter) {
+        for (const auto& record : records) {
+            if (filter->matchesBSON(*record.docPtr)) {
+                filtered.push_back(record);
+            }
+        }
+    }
+
+    InsertDeleteOptions options;
+    options.logIfError = false;
+    options.dupsAllowed = isDupsAllowed(index->descriptor());
+
+    int64_t inserted;
+    return index->accessMethod()->insertBatch(
+        txn, filter ? filtered : records, options, &inserted);
+}
+
 Status IndexCatalog::_unindexRecord(OperationContext* txn,
                                     IndexCatalogEntry* index,
                                     const BSONObj& obj,
@@ -1188,6 +1220,17 @@ Status IndexCatalog::indexRecord(OperationContext* txn, const BSONObj& obj, cons
     return Status::OK();
 }
 
+Status IndexCatalog::indexRecords(OperationContext* txn, const std::vector<BsonRecord>& records) {
+    for (IndexCatalogEntryContainer::const_iterator i = _entries.begin(); i != _entries.end();
+         ++i) {
+        Status s = _indexRecords(txn, *i, records);
+        if (!s.isOK())
+            return s;
+    }
+
+    return Status::OK();
+}
+
 void IndexCatalog::unindexRecord(OperationContext* txn,
                                  const BSONObj& obj,
                                  const RecordId& loc,
@@ -36,6 +36,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/platform/unordered_map.h"
 
 namespace mongo {
@@ -265,6 +266,12 @@ public:
     // this throws for now
     Status indexRecord(OperationContext* txn, const BSONObj& obj, const RecordId& loc);
 
+    /**
+     * Indexes a batch of newly inserted documents into every index. On failure the caller must
+     * abandon the enclosing WriteUnitOfWork, as some keys may already have been added.
+     */
+    Status indexRecords(OperationContext* txn, const std::vector<BsonRecord>& records);
+
     void unindexRecord(OperationContext* txn, const BSONObj& obj, const RecordId& loc, bool noWarn);
 
     // ------- temp internal -------
@@ -299,6 +306,10 @@ private:
                         const BSONObj& obj,
                         const RecordId& loc);
 
+    Status _indexRecords(OperationContext* txn,
+                         IndexCatalogEntry* index,
+                         const std::vector<BsonRecord>& records);
+
     Status _unindexRecord(OperationContext* txn,
                           IndexCatalogEntry* index,
                           const BSONObj& obj,
@@ -98,6 +98,9 @@ void IndexCatalogEntry::init(OperationContext* txn, IndexAccessMethod* accessMet
     _isReady = _catalogIsReady(txn);
     _head = _catalogHead(txn);
     _isMultikey = _catalogIsMultikey(txn);
+    // Which components are arrays is not persisted, an index which is multikey when loaded may
+    // have arrays along any of its paths.
+    _multikeyComponents.store(_isMultikey ? kAllMultikeyComponents : 0);
 
     BSONElement filterElement = _descriptor->getInfoElement("partialFilterExpression");
     if (filterElement.type()) {
@@ -184,7 +187,26 @@ private:
     const std::unique_ptr<RecoveryUnit> _newRecoveryUnit;
 };
 
-void IndexCatalogEntry::setMultikey(OperationContext* txn) {
+void IndexCatalogEntry::setMultikey(OperationContext* txn,
+                                    unsigned long long multikeyComponents) {
+    // Record the components before the index is marked multikey, so that the planner never sees
+    // a multikey index without the components which made it so.
+    unsigned long long known = _multikeyComponents.load();
+    while ((known & multikeyComponents) != multikeyComponents) {
+        const unsigned long long previous =
+            _multikeyComponents.compareAndSwap(known, known | multikeyComponents);
+        if (previous == known) {
+            // Plans covering the fields which are now known to be arrays are no longer correct.
+            if (isMultikey() && _infoCache) {
+                LOG(1) << _ns << ": clearing plan cache - index " << _descriptor->keyPattern()
+                       << " has new multi key components.";
+                _infoCache->clearQueryCache();
+            }
+            break;
+        }
+        known = previous;
+    }
+
     if (isMultikey()) {
         return;
     }
@@ -263,12 +285,29 @@ IndexCatalogEntry* IndexCatalogEntryContainer::find(const IndexDescriptor* desc)
 }
 
 IndexCatalogEntry* IndexCatalogEntryContainer::find(const string& name) {
-    for (iterator i = begin(); i != end(); ++i) {
-        IndexCatalogEntry* e = *i;
-        if (e->descriptor()->indexName() == name)
-            return e;
+    auto range = findByName(name);
+    return range.first == range.second ? NULL : range.first->second;
+}
+
+namespace {
+template <typename Map, typename Key>
+void eraseEntry(Map* map, const Key& key, const IndexCatalogEntry* entry) {
+    auto range = map->equal_range(key);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second == entry) {
+            map->erase(i);
+            return;
+        }
     }
-    return NULL;
+    invariant(false);
+}
+}  // namespace
+
+void IndexCatalogEntryContainer::add(IndexCatalogEntry* entry) {
+    _entries.mutableVector().push_back(entry);
+    const IndexDescriptor* desc = entry->descriptor();
+    _byName.emplace(desc->indexName(), entry);
+    _byKeyPattern.emplace(desc->keyPattern(), entry);
 }
 
 IndexCatalogEntry* IndexCatalogEntryContainer::release(const IndexDescriptor* desc) {
@@ -279,6 +318,8 @@ IndexCatalogEntry* IndexCatalogEntryContainer::release(const IndexDescriptor* de
         if (e->descriptor() != desc)
             continue;
         _entries.mutableVector().erase(i);
+        eraseEntry(&_byName, StringData(desc->indexName()), e);
+        eraseEntry(&_byKeyPattern, desc->keyPattern(), e);
         return e;
     }
     return NULL;
@@ -31,11 +31,15 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/bson/ordering.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/storage/snapshot_name.h"
+#include "mongo/platform/atomic_word.h"
 
 namespace mongo {
 
@@ -102,7 +106,23 @@ public:
 
     bool isMultikey() const;
 
-    void setMultikey(OperationContext* txn);
+    /**
+     * Returns a mask of the components of the key pattern, bit i for the i-th field, which had an
+     * array along their path in a document indexed by this process. All the bits are set for an
+     * index which was already multikey when it was loaded, and so may have arrays anywhere.
+     * Only meaningful if isMultikey().
+     */
+    unsigned long long getMultikeyComponents() const {
+        return _multikeyComponents.load();
+    }
+
+    /**
+     * Marks the index multikey, because of arrays along the paths of 'multikeyComponents'.
+     */
+    void setMultikey(OperationContext* txn,
+                     unsigned long long multikeyComponents = kAllMultikeyComponents);
+
+    static const unsigned long long kAllMultikeyComponents = ~0ULL;
 
     // if this ready is ready for queries
     bool isReady(OperationContext* txn) const;
@@ -149,6 +169,7 @@ private:
     bool _isReady;       // cache of NamespaceDetails info
     RecordId _head;      // cache of IndexDetails
     bool _isMultikey;    // cache of NamespaceDetails info
+    AtomicWord<unsigned long long> _multikeyComponents;
 
     // The earliest snapshot that is allowed to read this index.
     boost::optional<SnapshotName> _minVisibleSnapshot;
@@ -159,6 +180,10 @@ public:
     typedef std::vector<IndexCatalogEntry*>::const_iterator const_iterator;
     typedef std::vector<IndexCatalogEntry*>::const_iterator iterator;
 
+    // Hashed lookups of the entries, keyed by views into their descriptors.
+    typedef std::unordered_multimap<StringData, IndexCatalogEntry*, StringData::Hasher> ByName;
+    typedef std::unordered_multimap<BSONObj, IndexCatalogEntry*, BSONObj::Hasher> ByKeyPattern;
+
     const_iterator begin() const {
         return _entries.vector().begin();
     }
@@ -180,6 +205,17 @@ public:
 
     IndexCatalogEntry* find(const std::string& name);
 
+    /**
+     * Returns the range of entries whose index is named "name", or whose key pattern equals
+     * "keyPattern". The entries in a range are in no particular order.
+     */
+    std::pair<ByName::const_iterator, ByName::const_iterator> findByName(StringData name) const {
+        return _byName.equal_range(name);
+    }
+    std::pair<ByKeyPattern::const_iterator, ByKeyPattern::const_iterator> findByKeyPattern(
+        const BSONObj& keyPattern) const {
+        return _byKeyPattern.equal_range(keyPattern);
+    }
 
     unsigned size() const {
         return _entries.size();
@@ -198,11 +234,13 @@ public:
     }
 
     // pass ownership to EntryContainer
-    void add(IndexCatalogEntry* entry) {
-        _entries.mutableVector().push_back(entry);
-    }
+    void add(IndexCatalogEntry* entry);
 
 private:
     OwnedPointerVector<IndexCatalogEntry> _entries;
+
+    // With many indexes on a collection, walking _entries is a noticeable part of planning.
+    ByName _byName;
+    ByKeyPattern _byKeyPattern;
 };
 }
@@ -34,6 +34,8 @@
 
 #include "mongo/db/catalog/index_create.h"
 
+#include <algorithm>
+#include <deque>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/client/dbclientinterface.h"
@@ -47,7 +49,10 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/progress_meter.h"
@@ -58,6 +63,18 @@ using std::unique_ptr;
 using std::string;
 using std::endl;
 
+// Foreground builds of more than one index generate keys on up to this many threads, one index
+// or more per thread. A value of 1 generates all keys on the thread scanning the collection.
+MONGO_EXPORT_SERVER_PARAMETER(maxIndexBuildKeyGenerationThreads, int, 16);
+
+namespace {
+// Number of documents handed to the key generation threads at a time.
+const size_t kParallelBulkBatchSize = 128;
+
+// Batches queued for a key generation thread before the collection scan waits for it.
+const size_t kParallelBulkMaxQueuedBatches = 8;
+}  // namespace
+
 /**
  * On rollback sets MultiIndexBlock::_needToCleanup to true.
  */
@@ -215,6 +232,180 @@ Status MultiIndexBlock::init(const std::vector<BSONObj>& indexSpecs) {
     return Status::OK();
 }
 
+/**
+ * Feeds the BulkBuilders of a foreground index build from worker threads, so that building
+ * several indexes at once generates and sorts their keys on several cores. The thread scanning
+ * the collection hands documents over in batches, which every worker then runs through the
+ * indexes assigned to it. BulkBuilders do not touch storage, so no OperationContext is shared.
+ */
+class MultiIndexBlock::ParallelBulkInserter {
+    MONGO_DISALLOW_COPYING(ParallelBulkInserter);
+
+public:
+    ParallelBulkInserter(std::vector<IndexToBuild>* indexes, size_t numThreads) {
+        _workers.resize(numThreads);
+        for (size_t i = 0; i < numThreads; i++) {
+            _workers[i].reset(new Worker());
+        }
+        for (size_t i = 0; i < indexes->size(); i++) {
+            invariant((*indexes)[i].bulk);
+            _workers[i % numThreads]->indexes.push_back(&(*indexes)[i]);
+        }
+        for (auto& worker : _workers) {
+            Worker* const w = worker.get();
+            worker->thread = stdx::thread([this, w] { _run(w); });
+        }
+    }
+
+    ~ParallelBulkInserter() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            for (auto& worker : _workers) {
+                worker->queue.clear();
+            }
+        }
+        _join();
+    }
+
+    /**
+     * Queues 'doc', which must be owned, for insertion into every index. Returns the first error
+     * hit by any worker so far.
+     */
+    Status insert(const BSONObj& doc, const RecordId& loc) {
+        invariant(doc.isOwned());
+        if (!_pending) {
+            _pending = std::make_shared<Batch>();
+            _pending->reserve(kParallelBulkBatchSize);
+        }
+        _pending->push_back(std::make_pair(doc, loc));
+        if (_pending->size() >= kParallelBulkBatchSize) {
+            _flush();
+        }
+
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _status;
+    }
+
+    /**
+     * Waits for the workers to process every queued document. Returns the first error hit.
+     */
+    Status finish() {
+        _flush();
+        _join();
+        return _status;
+    }
+
+private:
+    using Batch = std::vector<std::pair<BSONObj, RecordId>>;
+
+    struct Worker {
+        std::vector<IndexToBuild*> indexes;
+        std::deque<std::shared_ptr<const Batch>> queue;
+        stdx::thread thread;
+    };
+
+    void _flush() {
+        if (!_pending || _pending->empty())
+            return;
+
+        std::shared_ptr<const Batch> batch(std::move(_pending));
+        _pending.reset();
+
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _workConsumed.wait(lk,
+                           [this] {
+                               if (!_status.isOK())
+                                   return true;
+                               for (const auto& worker : _workers) {
+                                   if (worker->queue.size() >= kParallelBulkMaxQueuedBatches)
+                                       return false;
+                               }
+                               return true;
+                           });
+        if (!_status.isOK())
+            return;
+
+        for (auto& worker : _workers) {
+            worker->queue.push_back(batch);
+        }
+        _workAvailable.notify_all();
+    }
+
+    void _join() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_shutdown)
+                return;
+            _shutdown = true;
+        }
+        _workAvailable.notify_all();
+        for (auto& worker : _workers) {
+            worker->thread.join();
+        }
+    }
+
+    void _run(Worker* worker) {
+        while (true) {
+            std::shared_ptr<const Batch> batch;
+            {
+                stdx::unique_lock<stdx::mutex> lk(_mutex);
+                _workAvailable.wait(lk, [&] { return _shutdown || !worker->queue.empty(); });
+                if (worker->queue.empty())
+                    return;
+                batch = std::move(worker->queue.front());
+                worker->queue.pop_front();
+                _workConsumed.notify_all();
+                if (!_status.isOK())
+                    continue;
+            }
+
+            Status status = _insertBatch(worker, *batch);
+            if (!status.isOK()) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                if (_status.isOK())
+                    _status = status;
+                _workConsumed.notify_all();
+            }
+        }
+    }
+
+    Status _insertBatch(Worker* worker, const Batch& batch) {
+        try {
+            for (const auto& item : batch) {
+                for (IndexToBuild* index : worker->indexes) {
+                    if (index->filterExpression &&
+                        !index->filterExpression->matchesBSON(item.first)) {
+                        continue;
+                    }
+
+                    Status status =
+                        index->bulk->insert(NULL, item.first, item.second, index->options, NULL);
+                    if (!status.isOK())
+                        return status;
+                }
+            }
+        } catch (...) {
+            return exceptionToStatus();
+        }
+        return Status::OK();
+    }
+
+    stdx::mutex _mutex;
+
+    // Signaled when a batch is queued for the workers, or when they should exit.
+    stdx::condition_variable _workAvailable;
+
+    // Signaled when a worker takes a batch off its queue, or hits an error.
+    stdx::condition_variable _workConsumed;
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    bool _shutdown = false;
+    Status _status = Status::OK();
+
+    // Only used by the thread scanning the collection.
+    std::shared_ptr<Batch> _pending;
+};
+
 Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsOut) {
     const char* curopMessage = _buildInBackground ? "Index Build (background)" : "Index Build";
     const auto numRecords = _collection->numRecords(_txn);
@@ -235,6 +426,13 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
         exec->setYieldPolicy(PlanExecutor::WRITE_CONFLICT_RETRY_ONLY);
     }
 
+    std::unique_ptr<ParallelBulkInserter> parallelInserter;
+    const size_t numThreads = std::min(
+        _indexes.size(), static_cast<size_t>(std::max(maxIndexBuildKeyGenerationThreads, 1)));
+    if (!_buildInBackground && numThreads > 1) {
+        parallelInserter.reset(new ParallelBulkInserter(&_indexes, numThreads));
+    }
+
     Snapshotted<BSONObj> objToIndex;
     RecordId loc;
     PlanExecutor::ExecState state;
@@ -257,7 +455,9 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
             progress->setTotalWhileRunning(_collection->numRecords(_txn));
 
             WriteUnitOfWork wunit(_txn);
-            Status ret = insert(objToIndex.value(), loc);
+            Status ret = parallelInserter
+                ? parallelInserter->insert(objToIndex.value().getOwned(), loc)
+                : insert(objToIndex.value(), loc);
             if (ret.isOK()) {
                 wunit.commit();
             } else if (dupsOut && ret.code() == ErrorCodes::DuplicateKey) {
@@ -296,6 +496,12 @@ Status MultiIndexBlock::insertAllDocumentsInCollection(std::set<RecordId>* dupsO
         uasserted(28550, "Unable to complete index build as the collection is no longer readable");
     }
 
+    if (parallelInserter) {
+        Status ret = parallelInserter->finish();
+        if (!ret.isOK())
+            return ret;
+    }
+
     progress->finished();
 
     Status ret = doneInserting(dupsOut);
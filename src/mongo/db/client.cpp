@@ -89,6 +89,18 @@ void Client::initThread(const char* desc, ServiceContext* service, AbstractMessa
     *currentClient.get() = service->makeClient(fullDesc, mp);
 }
 
+ServiceContext::UniqueClient Client::releaseCurrent() {
+    invariant(haveClient());
+    return std::move(*currentClient.get());
+}
+
+void Client::setCurrent(ServiceContext::UniqueClient client) {
+    invariant(!haveClient());
+    invariant(client);
+    setThreadName(client->desc());
+    *currentClient.getMake() = std::move(client);
+}
+
 namespace {
 int64_t generateSeed(const std::string& desc) {
     size_t seed = 0;
@@ -75,6 +75,19 @@ public:
      */
     static void initThreadIfNotAlready();
 
+    /**
+     * Detaches the Client bound to the current thread and returns it, leaving the thread without
+     * a Client. Used by servers that do not dedicate a thread to each connection, so that the
+     * next message on the connection can be handled on a different thread.
+     */
+    static ServiceContext::UniqueClient releaseCurrent();
+
+    /**
+     * Binds "client" to the current thread and names the thread after it. The current thread
+     * must not already have a Client.
+     */
+    static void setCurrent(ServiceContext::UniqueClient client);
+
     std::string clientAddress(bool includePort = false) const;
     const std::string& desc() const {
         return _desc;
@@ -116,6 +116,7 @@ void ClientCursor::init() {
 
     _idleAgeMillis = 0;
     _leftoverMaxTimeMicros = 0;
+    _lastBatchBytes = 0;
     _pos = 0;
 
     if (_queryOptions & QueryOption_NoCursorTimeout) {
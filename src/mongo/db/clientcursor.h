@@ -142,6 +142,15 @@ public:
         _leftoverMaxTimeMicros = leftoverMaxTimeMicros;
     }
 
+    // The size in bytes of the last batch returned from this cursor, used to presize the buffer
+    // for the next one. Zero before the first batch.
+    int getLastBatchBytes() const {
+        return _lastBatchBytes;
+    }
+    void setLastBatchBytes(int lastBatchBytes) {
+        _lastBatchBytes = lastBatchBytes;
+    }
+
     //
     // Replication-related stuff.  TODO: Document and clean.
     //
@@ -251,6 +260,8 @@ private:
     // TODO: Document.
     uint64_t _leftoverMaxTimeMicros;
 
+    int _lastBatchBytes;
+
     //
     // The underlying execution machinery.
     //
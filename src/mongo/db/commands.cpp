@@ -53,6 +53,7 @@
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/executor/connection_pool.h"
 #include "mongo/rpc/get_status_from_command_result.h"
 #include "mongo/rpc/metadata.h"
 #include "mongo/s/client/shard_connection.h"
@@ -558,6 +559,11 @@ public:
         globalConnPool.appendInfo(result);
         result.append("numDBClientConnection", DBClientConnection::getNumConnections());
         result.append("numAScopedConnection", AScopedConnection::getNumConnections());
+
+        // The pools of the task executors' network interfaces
+        BSONObjBuilder executorPoolsBob(result.subobjStart("executorPools"));
+        executor::ConnectionPool::appendAllStats(&executorPoolsBob);
+        executorPoolsBob.done();
         return true;
     }
     virtual bool slaveOk() const {
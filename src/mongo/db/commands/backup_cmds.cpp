@@ -0,0 +1,199 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/query/cursor_response.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/db/storage_options.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+using std::string;
+using std::stringstream;
+using std::vector;
+
+namespace {
+
+/**
+ * Pins a consistent image of the data files with StorageEngine::beginNonBlockingBackup() and
+ * returns a cursor with one {filename, fileSize, changed} document per file to copy. Writes are
+ * not blocked while the files are copied.
+ *
+ * With incrementalSince set to the backupTime of an earlier backup, 'changed' is false for files
+ * which have not been written since that backup began, so only the changed files need copying.
+ * Files missing from the cursor were dropped and should be removed from the backup.
+ */
+class BeginBackupCmd : public Command {
+public:
+    BeginBackupCmd() : Command("beginBackup") {}
+
+    bool isWriteCommandForConfigServer() const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void help(stringstream& h) const override {
+        h << "Pins a consistent image of the data files for copying without blocking writes.\n"
+             "{ beginBackup: 1, incrementalSince: <backupTime of an earlier backup> }\n"
+             "Call endBackup once the files are copied.";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::fsync);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* txn,
+             const string& dbname,
+             BSONObj& cmdObj,
+             int,
+             string& errmsg,
+             BSONObjBuilder& result) override {
+        const BSONElement sinceElt = cmdObj["incrementalSince"];
+        const bool incremental = !sinceElt.eoo();
+        if (incremental && sinceElt.type() != Date) {
+            errmsg = "incrementalSince has to be a date";
+            return false;
+        }
+
+        // Taken before the checkpoint is written, so that a file written by it, or at any later
+        // point, counts as changed for the next incremental backup.
+        const Date_t backupTime = Date_t::now();
+
+        StorageEngine* engine = getGlobalServiceContext()->getGlobalStorageEngine();
+        StatusWith<vector<string>> swFilenames = engine->beginNonBlockingBackup(txn);
+        if (!swFilenames.isOK()) {
+            return appendCommandStatus(result, swFilenames.getStatus());
+        }
+
+        BSONArrayBuilder firstBatch;
+        for (const string& filename : swFilenames.getValue()) {
+            const boost::filesystem::path path =
+                boost::filesystem::path(storageGlobalParams.dbpath) / filename;
+
+            boost::system::error_code ec;
+            const uintmax_t fileSize = boost::filesystem::file_size(path, ec);
+            const std::time_t modified = ec ? 0 : boost::filesystem::last_write_time(path, ec);
+            if (ec) {
+                engine->endNonBlockingBackup(txn);
+                return appendCommandStatus(result,
+                                           Status(ErrorCodes::FileNotOpen,
+                                                  str::stream() << "could not stat " << filename
+                                                                << ": " << ec.message()));
+            }
+
+            // Modification times only have a resolution of seconds, so a file written in the
+            // same second as the earlier backup began is counted as changed.
+            const bool changed = !incremental ||
+                Date_t::fromMillisSinceEpoch((modified + 1) * 1000) > sinceElt.date();
+
+            firstBatch.append(BSON("filename" << filename << "fileSize"
+                                              << static_cast<long long>(fileSize) << "changed"
+                                              << changed));
+        }
+
+        log() << "beginBackup: pinned " << swFilenames.getValue().size() << " files"
+              << (incremental ? " for an incremental backup" : "");
+
+        result.append("backupTime", backupTime);
+        // Every file is returned in the first batch, so the cursor is always exhausted.
+        appendCursorResponseObject(0LL, dbname + ".$cmd." + name, firstBatch.arr(), &result);
+        return true;
+    }
+
+} beginBackupCmd;
+
+/**
+ * Releases the image of the data files pinned by beginBackup.
+ */
+class EndBackupCmd : public Command {
+public:
+    EndBackupCmd() : Command("endBackup") {}
+
+    bool isWriteCommandForConfigServer() const override {
+        return false;
+    }
+
+    bool slaveOk() const override {
+        return true;
+    }
+
+    bool adminOnly() const override {
+        return true;
+    }
+
+    void help(stringstream& h) const override {
+        h << "Releases the data files pinned by beginBackup.";
+    }
+
+    void addRequiredPrivileges(const std::string& dbname,
+                               const BSONObj& cmdObj,
+                               std::vector<Privilege>* out) override {
+        ActionSet actions;
+        actions.addAction(ActionType::fsync);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+
+    bool run(OperationContext* txn,
+             const string& dbname,
+             BSONObj& cmdObj,
+             int,
+             string& errmsg,
+             BSONObjBuilder& result) override {
+        getGlobalServiceContext()->getGlobalStorageEngine()->endNonBlockingBackup(txn);
+        log() << "endBackup: released pinned files";
+        return true;
+    }
+
+} endBackupCmd;
+
+}  // namespace
+}  // namespace mongo
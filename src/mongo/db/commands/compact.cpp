@@ -30,6 +30,7 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
 
+#include <boost/optional.hpp>
 #include <string>
 #include <vector>
 
@@ -77,8 +78,8 @@ public:
     }
     virtual void help(stringstream& help) const {
         help << "compact collection\n"
-                "warning: this operation locks the database and is slow. you can cancel with "
-                "killOp()\n"
+                "warning: this operation is slow, and locks the database unless the storage "
+                "engine compacts online. you can cancel with killOp()\n"
                 "{ compact : <collection_name>, [force:<bool>], [validate:<bool>],\n"
                 "  [paddingFactor:<num>], [paddingBytes:<num>] }\n"
                 "  force - allows to run on a replica set primary\n"
@@ -87,6 +88,23 @@ public:
     }
     CompactCmd() : Command("compact") {}
 
+private:
+    static bool compactsOnline(const Collection* collection) {
+        const RecordStore* rs = collection->getRecordStore();
+        return rs->compactSupported() && rs->compactsInPlace() && rs->compactsOnline();
+    }
+
+    static bool compactsOnline(OperationContext* txn, const NamespaceString& nss) {
+        ScopedTransaction transaction(txn, MODE_IS);
+        AutoGetDb autoDb(txn, nss.db(), MODE_IS);
+        Lock::CollectionLock collLock(txn->lockState(), nss.ns(), MODE_IS);
+        Database* const collDB = autoDb.getDb();
+        Collection* const collection = collDB ? collDB->getCollection(nss) : NULL;
+        return collection && compactsOnline(collection);
+    }
+
+public:
+
     virtual bool run(OperationContext* txn,
                      const string& db,
                      BSONObj& cmdObj,
@@ -95,20 +113,24 @@ public:
                      BSONObjBuilder& result) {
         const std::string nsToCompact = parseNsCollectionRequired(db, cmdObj);
 
+        NamespaceString nss(nsToCompact);
+        if (!nss.isNormal()) {
+            errmsg = "bad namespace name";
+            return false;
+        }
+
+        // Record stores which compact in place alongside reads and writes only need intent locks,
+        // so compacting them neither takes the database offline nor blocks a primary.
+        const bool online = compactsOnline(txn, nss);
+
         repl::ReplicationCoordinator* replCoord = repl::getGlobalReplicationCoordinator();
-        if (replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
+        if (!online && replCoord->getMemberState().primary() && !cmdObj["force"].trueValue()) {
             errmsg =
                 "will not run compact on an active replica set primary as this is a slow blocking "
                 "operation. use force:true to force";
             return false;
         }
 
-        NamespaceString nss(nsToCompact);
-        if (!nss.isNormal()) {
-            errmsg = "bad namespace name";
-            return false;
-        }
-
         if (nss.isSystem()) {
             // items in system.* cannot be moved as there might be pointers to them
             // i.e. system.indexes entries are pointed to from NamespaceDetails
@@ -148,7 +170,11 @@ public:
 
 
         ScopedTransaction transaction(txn, MODE_IX);
-        AutoGetDb autoDb(txn, db, MODE_X);
+        AutoGetDb autoDb(txn, db, online ? MODE_IX : MODE_X);
+        boost::optional<Lock::CollectionLock> collLock;
+        if (online) {
+            collLock.emplace(txn->lockState(), nss.ns(), MODE_IX);
+        }
         Database* const collDB = autoDb.getDb();
         Collection* collection = collDB ? collDB->getCollection(nss) : NULL;
 
@@ -166,6 +192,12 @@ public:
             return false;
         }
 
+        if (online && !compactsOnline(collection)) {
+            // The collection was recreated since it was checked.
+            errmsg = "collection changed while compact was starting, retry";
+            return false;
+        }
+
         log() << "compact " << nss.ns() << " begin, options: " << compactOptions.toString();
 
         StatusWith<CompactStats> status = collection->compact(txn, &compactOptions);
@@ -170,6 +170,9 @@ public:
             static_cast<const CountStats*>(countStage->getSpecificStats());
 
         result.appendNumber("n", countStats->nCounted);
+        if (countStats->approximate) {
+            result.appendBool("approximate", true);
+        }
         return true;
     }
 
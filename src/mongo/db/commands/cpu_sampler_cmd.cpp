@@ -0,0 +1,148 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Commands for the built-in sampling CPU profiler, CpuSampler.
+ *
+ * The following command starts sampling the CPU every 'periodMicros' microseconds of CPU time,
+ * keeping at most 'maxSamples' samples:
+ *     { _cpuSamplerStart: 1, periodMicros: 10000, maxSamples: 32768 }
+ *
+ * The following command stops sampling, and returns the samples folded by stack:
+ *     { _cpuSamplerStop: 1 }
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/bson/util/bson_extract.h"
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/stats/cpu_sampler.h"
+
+namespace mongo {
+namespace {
+
+const long long kDefaultPeriodMicros = 10 * 1000;
+const long long kDefaultMaxSamples = 32 * 1024;
+const long long kMaxMaxSamples = 1024 * 1024;
+
+/**
+ * Common code for the implementation of the CPU sampler commands.
+ */
+class CpuSamplerCommand : public Command {
+public:
+    CpuSamplerCommand(char const* name) : Command(name) {}
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool isWriteCommandForConfigServer() const {
+        return false;
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::cpuProfiler);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+};
+
+class CpuSamplerStartCommand : public CpuSamplerCommand {
+public:
+    CpuSamplerStartCommand() : CpuSamplerCommand("_cpuSamplerStart") {}
+
+    virtual void help(std::stringstream& help) const {
+        help << "starts the sampling CPU profiler\n"
+                "{ _cpuSamplerStart: 1, periodMicros: <int>, maxSamples: <int> }";
+    }
+
+    virtual bool run(OperationContext* txn,
+                     const std::string& db,
+                     BSONObj& cmdObj,
+                     int options,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) {
+        long long periodMicros;
+        Status status = bsonExtractIntegerFieldWithDefault(
+            cmdObj, "periodMicros", kDefaultPeriodMicros, &periodMicros);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+        if (periodMicros < 1000 || periodMicros > 1000 * 1000) {
+            return appendCommandStatus(
+                result,
+                Status(ErrorCodes::BadValue, "periodMicros must be between 1000 and 1000000"));
+        }
+
+        long long maxSamples;
+        status = bsonExtractIntegerFieldWithDefault(
+            cmdObj, "maxSamples", kDefaultMaxSamples, &maxSamples);
+        if (!status.isOK()) {
+            return appendCommandStatus(result, status);
+        }
+        if (maxSamples < 1 || maxSamples > kMaxMaxSamples) {
+            return appendCommandStatus(result,
+                                       Status(ErrorCodes::BadValue,
+                                              str::stream() << "maxSamples must be between 1 and "
+                                                            << kMaxMaxSamples));
+        }
+
+        return appendCommandStatus(
+            result, CpuSampler::start(static_cast<int>(periodMicros), maxSamples));
+    }
+} cpuSamplerStartCommand;
+
+class CpuSamplerStopCommand : public CpuSamplerCommand {
+public:
+    CpuSamplerStopCommand() : CpuSamplerCommand("_cpuSamplerStop") {}
+
+    virtual void help(std::stringstream& help) const {
+        help << "stops the sampling CPU profiler, and returns its samples folded by stack";
+    }
+
+    virtual bool run(OperationContext* txn,
+                     const std::string& db,
+                     BSONObj& cmdObj,
+                     int options,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) {
+        return appendCommandStatus(result, CpuSampler::stop(&result));
+    }
+} cpuSamplerStopCommand;
+
+}  // namespace
+}  // namespace mongo
@@ -107,38 +107,38 @@ public:
              Client* client = cursor.next();) {
             invariant(client);
 
-            stdx::lock_guard<Client> lk(*client);
-            const OperationContext* opCtx = client->getOperationContext();
-
-            if (!includeAll) {
-                // Skip over inactive connections.
-                if (!opCtx)
-                    continue;
-            }
-
             BSONObjBuilder infoBuilder;
+            {
+                stdx::lock_guard<Client> lk(*client);
+                const OperationContext* opCtx = client->getOperationContext();
+
+                if (!includeAll) {
+                    // Skip over inactive connections.
+                    if (!opCtx)
+                        continue;
+                }
 
-            // The client information
-            client->reportState(infoBuilder);
+                // The client information
+                client->reportState(infoBuilder);
 
-            // Operation context specific information
-            infoBuilder.appendBool("active", static_cast<bool>(opCtx));
-            if (opCtx) {
-                infoBuilder.append("opid", opCtx->getOpID());
-                if (opCtx->isKillPending()) {
-                    infoBuilder.append("killPending", true);
-                }
+                // Operation context specific information
+                infoBuilder.appendBool("active", static_cast<bool>(opCtx));
+                if (opCtx) {
+                    infoBuilder.append("opid", opCtx->getOpID());
+                    if (opCtx->isKillPending()) {
+                        infoBuilder.append("killPending", true);
+                    }
 
-                CurOp::get(opCtx)->reportState(&infoBuilder);
+                    CurOp::get(opCtx)->reportState(&infoBuilder);
 
-                // LockState
-                Locker::LockerInfo lockerInfo;
-                opCtx->lockState()->getLockerInfo(&lockerInfo);
-                fillLockerInfo(lockerInfo, infoBuilder);
+                    // LockState
+                    Locker::LockerInfo lockerInfo;
+                    opCtx->lockState()->getLockerInfo(&lockerInfo);
+                    fillLockerInfo(lockerInfo, infoBuilder);
+                }
             }
 
-            infoBuilder.done();
-
+            // The filter is matched against the copy, after the client is unlocked.
             const BSONObj info = infoBuilder.obj();
 
             if (includeAll || matcher.matches(info)) {
@@ -39,7 +39,11 @@
 #include "mongo/db/client.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/operation_context_impl.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 #include "mongo/util/md5.hpp"
 #include "mongo/util/timer.h"
@@ -48,13 +52,88 @@ namespace mongo {
 
 using std::endl;
 using std::list;
+using std::map;
 using std::set;
 using std::string;
 using std::unique_ptr;
 using std::vector;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalDbHashThreads, int, 4);
+
 DBHashCmd dbhashCmd;
 
+namespace {
+
+/**
+ * Hashes the documents whose _id index key lies in ['min', 'max'), or ['min', 'max'] when 'max'
+ * is MaxKey, holding an S lock on the collection alone. Stops after 'rangeSize' documents when
+ * that is non-zero, setting '*next' to the key of the first document left out; '*next' is empty
+ * once the range is exhausted.
+ */
+Status hashIdRange(OperationContext* txn,
+                   const string& fullCollectionName,
+                   const BSONObj& min,
+                   const BSONObj& max,
+                   long long rangeSize,
+                   long long* n,
+                   string* hash,
+                   BSONObj* next) {
+    ScopedTransaction scopedXact(txn, MODE_IS);
+    AutoGetDb autoDb(txn, fullCollectionName, MODE_IS);
+    Database* db = autoDb.getDb();
+    if (!db) {
+        return Status(ErrorCodes::NamespaceNotFound, "database dropped while hashing");
+    }
+    Lock::CollectionLock collLock(txn->lockState(), fullCollectionName, MODE_S);
+
+    Collection* collection = db->getCollection(fullCollectionName);
+    if (!collection) {
+        return Status(ErrorCodes::NamespaceNotFound, "collection dropped while hashing");
+    }
+    IndexDescriptor* desc = collection->getIndexCatalog()->findIdIndex(txn);
+    if (!desc) {
+        return Status(ErrorCodes::IndexNotFound, "no _id _index");
+    }
+
+    unique_ptr<PlanExecutor> exec =
+        InternalPlanner::indexScan(txn,
+                                   collection,
+                                   desc,
+                                   min,
+                                   max,
+                                   max.firstElement().type() == MaxKey,  // endKeyInclusive
+                                   PlanExecutor::YIELD_MANUAL,
+                                   InternalPlanner::FORWARD,
+                                   InternalPlanner::IXSCAN_FETCH);
+
+    md5_state_t st;
+    md5_init(&st);
+
+    *n = 0;
+    *next = BSONObj();
+    PlanExecutor::ExecState state;
+    BSONObj c;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&c, NULL))) {
+        if (rangeSize > 0 && *n == rangeSize) {
+            BSONObjBuilder key;
+            key.appendAs(c["_id"], "");
+            *next = key.obj();
+            break;
+        }
+        md5_append(&st, (const md5_byte_t*)c.objdata(), c.objsize());
+        (*n)++;
+    }
+    if (PlanExecutor::ADVANCED != state && PlanExecutor::IS_EOF != state) {
+        warning() << "error while hashing, db dropped? ns=" << fullCollectionName << endl;
+    }
+    md5digest d;
+    md5_finish(&st, d);
+    *hash = digestToString(d);
+    return Status::OK();
+}
+
+}  // namespace
+
 
 void logOpForDbHash(OperationContext* txn, const char* ns) {
     dbhashCmd.wipeCacheForCollection(txn, ns);
@@ -138,6 +217,135 @@ std::string DBHashCmd::hashCollection(OperationContext* opCtx,
     return hash;
 }
 
+string DBHashCmd::hashCollectionRanges(OperationContext* txn,
+                                       OperationContext* interruptTxn,
+                                       const string& fullCollectionName,
+                                       const vector<BSONObj>& bounds,
+                                       long long rangeSize,
+                                       BSONArrayBuilder* ranges) {
+    md5_state_t collectionState;
+    md5_init(&collectionState);
+
+    for (size_t i = 0; i + 1 < bounds.size(); ++i) {
+        const BSONObj& max = bounds[i + 1];
+        BSONObj min = bounds[i];
+        while (!min.isEmpty()) {
+            // The collection lock is released between ranges so that writers only ever wait for
+            // one range. Since _id values are immutable, a document which changes meanwhile
+            // only affects the hash of the range it always belonged to.
+            uassertStatusOK(interruptTxn->checkForInterruptNoAssert());
+
+            long long n;
+            string hash;
+            BSONObj next;
+            Status status =
+                hashIdRange(txn, fullCollectionName, min, max, rangeSize, &n, &hash, &next);
+            if (status == ErrorCodes::NamespaceNotFound) {
+                return "";
+            }
+            if (!status.isOK()) {
+                log() << "can't find _id index for: " << fullCollectionName << endl;
+                return status.reason();
+            }
+
+            BSONObjBuilder range(ranges->subobjStart());
+            range.appendAs(min.firstElement(), "min");
+            range.appendAs(next.isEmpty() ? max.firstElement() : next.firstElement(), "max");
+            range.appendNumber("n", n);
+            range.append("md5", hash);
+            range.done();
+
+            md5_append(&collectionState, (const md5_byte_t*)hash.c_str(), hash.size());
+            min = next;
+        }
+    }
+
+    md5digest d;
+    md5_finish(&collectionState, d);
+    return digestToString(d);
+}
+
+void DBHashCmd::hashCollectionsByRange(OperationContext* txn,
+                                       const string& dbname,
+                                       const vector<string>& collections,
+                                       const map<string, vector<BSONObj>>& bounds,
+                                       long long rangeSize,
+                                       BSONObjBuilder* result) {
+    const vector<BSONObj> wholeCollection{BSON("" << MINKEY), BSON("" << MAXKEY)};
+
+    vector<string> hashes(collections.size());
+    vector<BSONArray> ranges(collections.size());
+    vector<Status> statuses(collections.size(), Status::OK());
+
+    ThreadPool::Options options;
+    options.poolName = "dbHashPool";
+    options.threadNamePrefix = "dbHashWorker";
+    options.maxThreads =
+        std::max(1, std::min(static_cast<int>(internalDbHashThreads),
+                             static_cast<int>(collections.size())));
+    ThreadPool pool(options);
+    pool.startup();
+
+    for (size_t i = 0; i < collections.size(); ++i) {
+        const string& fullCollectionName = collections[i];
+        map<string, vector<BSONObj>>::const_iterator it = bounds.find(fullCollectionName);
+        const vector<BSONObj>& collectionBounds =
+            it == bounds.end() ? wholeCollection : it->second;
+
+        Status scheduled = pool.schedule(
+            [this, txn, i, &fullCollectionName, &collectionBounds, rangeSize, &hashes, &ranges,
+             &statuses] {
+                Client::initThreadIfNotAlready("dbHashWorker");
+                OperationContextImpl workerTxn;
+                try {
+                    BSONArrayBuilder rangesBuilder;
+                    hashes[i] = hashCollectionRanges(&workerTxn,
+                                                     txn,
+                                                     fullCollectionName,
+                                                     collectionBounds,
+                                                     rangeSize,
+                                                     &rangesBuilder);
+                    ranges[i] = rangesBuilder.arr();
+                } catch (const DBException& ex) {
+                    statuses[i] = ex.toStatus();
+                }
+            });
+        if (!scheduled.isOK()) {
+            statuses[i] = scheduled;
+        }
+    }
+
+    pool.waitForIdle();
+    pool.shutdown();
+    pool.join();
+
+    for (size_t i = 0; i < statuses.size(); ++i) {
+        uassertStatusOK(statuses[i]);
+    }
+
+    const size_t prefixLength = dbname.size() + 1;
+
+    md5_state_t globalState;
+    md5_init(&globalState);
+
+    BSONObjBuilder collectionsBuilder(result->subobjStart("collections"));
+    for (size_t i = 0; i < collections.size(); ++i) {
+        collectionsBuilder.append(collections[i].substr(prefixLength), hashes[i]);
+        md5_append(&globalState, (const md5_byte_t*)hashes[i].c_str(), hashes[i].size());
+    }
+    collectionsBuilder.done();
+
+    BSONObjBuilder rangesBuilder(result->subobjStart("ranges"));
+    for (size_t i = 0; i < collections.size(); ++i) {
+        rangesBuilder.append(collections[i].substr(prefixLength), ranges[i]);
+    }
+    rangesBuilder.done();
+
+    md5digest d;
+    md5_finish(&globalState, d);
+    result->append("md5", digestToString(d));
+}
+
 bool DBHashCmd::run(OperationContext* txn,
                     const string& dbname,
                     BSONObj& cmdObj,
@@ -159,14 +367,59 @@ bool DBHashCmd::run(OperationContext* txn,
         }
     }
 
-    list<string> colls;
+    long long rangeSize = 0;
+    if (cmdObj.hasField("rangeSize")) {
+        BSONElement e = cmdObj["rangeSize"];
+        if (!e.isNumber() || e.numberLong() <= 0) {
+            errmsg = "rangeSize has to be a positive number";
+            return false;
+        }
+        rangeSize = e.numberLong();
+    }
+
+    map<string, vector<BSONObj>> bounds;
+    if (cmdObj.hasField("ranges")) {
+        if (cmdObj["ranges"].type() != Object) {
+            errmsg = "ranges has to be an object";
+            return false;
+        }
+        BSONObjIterator i(cmdObj["ranges"].Obj());
+        while (i.more()) {
+            BSONElement e = i.next();
+            if (e.type() != Array) {
+                errmsg = "ranges entries have to be arrays of _id values";
+                return false;
+            }
+            vector<BSONObj>& collectionBounds = bounds[dbname + "." + e.fieldName()];
+            BSONObjIterator j(e.Obj());
+            while (j.more()) {
+                BSONObjBuilder key;
+                key.appendAs(j.next(), "");
+                BSONObj k = key.obj();
+                if (!collectionBounds.empty() && collectionBounds.back().woCompare(k) >= 0) {
+                    errmsg = "ranges entries have to be in increasing _id order";
+                    return false;
+                }
+                collectionBounds.push_back(k);
+            }
+            if (collectionBounds.size() < 2) {
+                errmsg = "ranges entries need at least two _id values";
+                return false;
+            }
+            desiredCollections.insert(e.fieldName());
+        }
+    }
+
+    const bool byRange = rangeSize > 0 || !bounds.empty();
     const string ns = parseNs(dbname, cmdObj);
 
-    // We lock the entire database in S-mode in order to ensure that the contents will not
-    // change for the snapshot.
+    // By default we lock the entire database in S-mode in order to ensure that the contents will
+    // not change for the snapshot. Hashing by range only ever locks the collection being hashed,
+    // one range at a time, so there the database lock is just held to list the collections.
     ScopedTransaction scopedXact(txn, MODE_IS);
-    AutoGetDb autoDb(txn, ns, MODE_S);
-    Database* db = autoDb.getDb();
+    unique_ptr<AutoGetDb> autoDb(new AutoGetDb(txn, ns, byRange ? MODE_IS : MODE_S));
+    Database* db = autoDb->getDb();
+    list<string> colls;
     if (db) {
         db->getDatabaseCatalogEntry()->getCollectionNamespaces(&colls);
         colls.sort();
@@ -175,12 +428,7 @@ bool DBHashCmd::run(OperationContext* txn,
     result.appendNumber("numCollections", (long long)colls.size());
     result.append("host", prettyHostName());
 
-    md5_state_t globalState;
-    md5_init(&globalState);
-
-    vector<string> cached;
-
-    BSONObjBuilder bb(result.subobjStart("collections"));
+    vector<string> hashedCollections;
     for (list<string>::iterator i = colls.begin(); i != colls.end(); i++) {
         string fullCollectionName = *i;
         if (fullCollectionName.size() - 1 <= dbname.size()) {
@@ -195,10 +443,35 @@ bool DBHashCmd::run(OperationContext* txn,
         if (desiredCollections.size() > 0 && desiredCollections.count(shortCollectionName) == 0)
             continue;
 
+        hashedCollections.push_back(fullCollectionName);
+    }
+
+    if (byRange) {
+        autoDb.reset();
+
+        // Writes applied from here on are logged after 'token', so the oplog entries which
+        // follow it name the ranges a later dbHash has to hash again.
+        result.append("token",
+                      repl::getGlobalReplicationCoordinator()->getMyLastOptime().getTimestamp());
+        hashCollectionsByRange(txn, dbname, hashedCollections, bounds, rangeSize, &result);
+        result.appendNumber("timeMillis", timer.millis());
+        return true;
+    }
+
+    md5_state_t globalState;
+    md5_init(&globalState);
+
+    vector<string> cached;
+
+    BSONObjBuilder bb(result.subobjStart("collections"));
+    for (vector<string>::iterator i = hashedCollections.begin(); i != hashedCollections.end();
+         i++) {
+        const string& fullCollectionName = *i;
+
         bool fromCache = false;
         string hash = hashCollection(txn, db, fullCollectionName, &fromCache);
 
-        bb.append(shortCollectionName, hash);
+        bb.append(fullCollectionName.substr(dbname.size() + 1), hash);
 
         md5_append(&globalState, (const md5_byte_t*)hash.c_str(), hash.size());
         if (fromCache)
@@ -73,6 +73,31 @@ private:
                                const std::string& fullCollectionName,
                                bool* fromCache);
 
+    /**
+     * Hashes the collections of 'dbname' named in 'collections' concurrently, one range of '_id'
+     * values at a time, and appends the per-collection and per-range hashes to 'result'. A
+     * collection present in 'bounds' is only hashed between the '_id' values listed for it; the
+     * others are hashed whole. Ranges are cut every 'rangeSize' documents (never when 0).
+     */
+    void hashCollectionsByRange(OperationContext* txn,
+                                const std::string& dbname,
+                                const std::vector<std::string>& collections,
+                                const std::map<std::string, std::vector<BSONObj>>& bounds,
+                                long long rangeSize,
+                                BSONObjBuilder* result);
+
+    /**
+     * Hashes the collection 'fullCollectionName' as a sequence of '_id' ranges spanning
+     * consecutive entries of 'bounds', appending a {min, max, n, md5} entry for each range to
+     * 'ranges'. Returns the md5 of the concatenated range hashes.
+     */
+    std::string hashCollectionRanges(OperationContext* txn,
+                                     OperationContext* interruptTxn,
+                                     const std::string& fullCollectionName,
+                                     const std::vector<BSONObj>& bounds,
+                                     long long rangeSize,
+                                     BSONArrayBuilder* ranges);
+
     std::map<std::string, std::string> _cachedHashed;
     stdx::mutex _cachedHashedMutex;
 };
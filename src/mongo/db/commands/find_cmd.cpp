@@ -43,6 +43,7 @@
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/repl/replication_coordinator.h"
+#include "mongo/db/query/cursor_prefetch.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/find.h"
@@ -350,6 +351,7 @@ public:
 
             cursor->setLeftoverMaxTimeMicros(CurOp::get(txn)->getRemainingMaxTimeMicros());
             cursor->setPos(numResults);
+            cursor->setLastBatchBytes(firstBatch.len());
         } else {
             cursorId = 0;
         }
@@ -361,6 +363,10 @@ public:
         appendCursorResponseObject(cursorId, nss.ns(), firstBatch.arr(), &result);
         if (cursorId) {
             cursorFreer.Dismiss();
+            if (isCursorPrefetchEligible(nss, cursor)) {
+                ccPin.release();
+                scheduleCursorPrefetch(nss, cursorId);
+            }
         }
         return true;
     }
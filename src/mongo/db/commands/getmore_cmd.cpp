@@ -44,6 +44,7 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/global_timestamp.h"
+#include "mongo/db/query/cursor_prefetch.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find.h"
 #include "mongo/db/query/find_common.h"
@@ -155,6 +156,9 @@ public:
         // Disable shard version checking - getmore commands are always unversioned
         OperationShardVersion::get(txn).setShardVersion(request.nss, ChunkVersion::IGNORED());
 
+        // A read-ahead of this cursor holds its pin, and must finish before we lock and pin.
+        waitForCursorPrefetch(request.cursorid);
+
         // Depending on the type of cursor being operated on, we hold locks for the whole
         // getMore, or none of the getMore, or part of the getMore.  The three cases in detail:
         //
@@ -281,7 +285,8 @@ public:
         }
 
         CursorId respondWithId = 0;
-        BSONArrayBuilder nextBatch;
+        BSONArrayBuilder nextBatch(
+            FindCommon::getMoreBufSize(cursor->getLastBatchBytes(), 512));
         BSONObj obj;
         PlanExecutor::ExecState state;
         long long numResults = 0;
@@ -337,6 +342,7 @@ public:
             }
 
             cursor->incPos(numResults);
+            cursor->setLastBatchBytes(nextBatch.len());
         } else {
             CurOp::get(txn)->debug().cursorExhausted = true;
         }
@@ -353,6 +359,9 @@ public:
                 unpinDBLock.reset(new Lock::DBLock(txn->lockState(), request.nss.db(), MODE_IS));
                 unpinCollLock.reset(
                     new Lock::CollectionLock(txn->lockState(), request.nss.ns(), MODE_IS));
+            } else if (isCursorPrefetchEligible(request.nss, cursor)) {
+                ccPin.release();
+                scheduleCursorPrefetch(request.nss, request.cursorid);
             }
         }
 
@@ -0,0 +1,212 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <list>
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/catalog/database_catalog_entry.h"
+#include "mongo/db/client.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/concurrency/d_concurrency.h"
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/service_context.h"
+#include "mongo/db/storage/storage_engine.h"
+#include "mongo/platform/unordered_map.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns the names of the databases and collections which 'resources' refer to. Resource ids only
+ * keep a hash of the name, so the names are found by hashing those of the existing databases and
+ * collections.
+ */
+unordered_map<ResourceId, std::string> findResourceNames(
+    OperationContext* txn,
+    const std::vector<LockContentionProfiler::ResourceContention>& resources) {
+    unordered_map<ResourceId, std::string> names;
+
+    bool anyCollection = false;
+    for (const auto& contention : resources) {
+        anyCollection = anyCollection || contention.resId.getType() == RESOURCE_COLLECTION;
+    }
+
+    std::vector<std::string> dbNames;
+    StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+    storageEngine->listDatabases(&dbNames);
+
+    for (const auto& dbName : dbNames) {
+        names[ResourceId(RESOURCE_DATABASE, dbName)] = dbName;
+        if (!anyCollection) {
+            continue;
+        }
+
+        ScopedTransaction transaction(txn, MODE_IS);
+        Lock::DBLock dbLock(txn->lockState(), dbName, MODE_IS);
+
+        DatabaseCatalogEntry* dbEntry = storageEngine->getDatabaseCatalogEntry(txn, dbName);
+        std::list<std::string> collectionNames;
+        dbEntry->getCollectionNamespaces(&collectionNames);
+        for (const auto& ns : collectionNames) {
+            names[ResourceId(RESOURCE_COLLECTION, ns)] = ns;
+        }
+    }
+
+    return names;
+}
+
+void appendContention(const LockContentionProfiler::ResourceContention& contention,
+                      const unordered_map<ResourceId, std::string>& names,
+                      BSONObjBuilder* b) {
+    b->append("resource", contention.resId.toString());
+    b->append("type", resourceTypeName(contention.resId.getType()));
+    const auto name = names.find(contention.resId);
+    if (name != names.end()) {
+        b->append("name", name->second);
+    }
+
+    b->append("numWaits", contention.numWaits);
+    b->append("numWaitsNotGranted", contention.numWaitsNotGranted);
+    b->append("totalWaitMicros", contention.totalWaitMicros);
+    b->append("maxWaitMicros", contention.maxWaitMicros);
+    {
+        BSONObjBuilder byMode(b->subobjStart("waitsByMode"));
+        for (int mode = MODE_IS; mode < LockModesCount; mode++) {
+            if (contention.waitsByMode[mode]) {
+                byMode.append(modeName(static_cast<LockMode>(mode)),
+                              contention.waitsByMode[mode]);
+            }
+        }
+    }
+    {
+        BSONObjBuilder histogram(b->subobjStart("waitHistogram"));
+        for (int bucket = 0; bucket < LockContentionProfiler::kNumWaitBuckets; bucket++) {
+            histogram.append(LockContentionProfiler::waitBucketName(bucket),
+                             contention.waitHistogram[bucket]);
+        }
+    }
+    {
+        BSONArrayBuilder samples(b->subarrayStart("recentWaits"));
+        for (const auto& sample : contention.recentSamples) {
+            BSONObjBuilder sampleBuilder(samples.subobjStart());
+            sampleBuilder.append("when", sample.when);
+            sampleBuilder.append("opid", sample.waiterOpId);
+            sampleBuilder.append("mode", modeName(sample.mode));
+            sampleBuilder.append("granted", sample.granted);
+            sampleBuilder.append("waitMicros", static_cast<long long>(sample.waitMicros));
+            BSONArrayBuilder holders(sampleBuilder.subarrayStart("holderOpids"));
+            for (unsigned opId : sample.holderOpIds) {
+                holders.append(opId);
+            }
+        }
+    }
+}
+
+/**
+ * Reports the resources which lock requests waited for the longest while lockContentionProfiling
+ * was on.
+ *
+ * {lockContention: 1, top: <number of resources, 10 by default>, reset: <bool>}
+ */
+class LockContentionCommand : public Command {
+public:
+    LockContentionCommand() : Command("lockContention") {}
+
+    bool isWriteCommandForConfigServer() const final {
+        return false;
+    }
+
+    bool slaveOk() const final {
+        return true;
+    }
+
+    bool adminOnly() const final {
+        return true;
+    }
+
+    void help(std::stringstream& help) const final {
+        help << "reports the resources lock requests waited for the longest while "
+                "lockContentionProfiling was on\n"
+                "{lockContention: 1, top: <number of resources>, reset: <bool>}";
+    }
+
+    Status checkAuthForCommand(ClientBasic* client,
+                               const std::string& dbname,
+                               const BSONObj& cmdObj) final {
+        bool isAuthorized = AuthorizationSession::get(client)->isAuthorizedForActionsOnResource(
+            ResourcePattern::forClusterResource(), ActionType::inprog);
+        return isAuthorized ? Status::OK() : Status(ErrorCodes::Unauthorized, "Unauthorized");
+    }
+
+    bool run(OperationContext* txn,
+             const std::string& db,
+             BSONObj& cmdObj,
+             int options,
+             std::string& errmsg,
+             BSONObjBuilder& result) final {
+        long long top = 10;
+        BSONElement topElement = cmdObj["top"];
+        if (!topElement.eoo()) {
+            if (!topElement.isNumber() || topElement.numberLong() <= 0) {
+                return appendCommandStatus(
+                    result, Status(ErrorCodes::BadValue, "top must be a positive number"));
+            }
+            top = topElement.numberLong();
+        }
+
+        LockContentionProfiler& profiler = LockContentionProfiler::get();
+        const auto resources = profiler.getTopResources(static_cast<size_t>(top));
+        const auto names = findResourceNames(txn, resources);
+
+        result.append("profiling", lockContentionProfiling);
+        result.append("untrackedWaits", profiler.getUntrackedWaits());
+        BSONArrayBuilder resourcesBuilder(result.subarrayStart("resources"));
+        for (const auto& contention : resources) {
+            BSONObjBuilder b(resourcesBuilder.subobjStart());
+            appendContention(contention, names, &b);
+        }
+        resourcesBuilder.done();
+
+        if (cmdObj["reset"].trueValue()) {
+            profiler.reset();
+        }
+        return true;
+    }
+
+} lockContentionCommand;
+
+}  // namespace
+}  // namespace mongo
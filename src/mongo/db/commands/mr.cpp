@@ -32,6 +32,10 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <cmath>
+#include <cstdlib>
+#include <pcrecpp.h>
+
 #include "mongo/client/connpool.h"
 #include "mongo/client/parallel.h"
 #include "mongo/db/auth/authorization_session.h"
@@ -53,6 +57,7 @@
 #include "mongo/db/op_observer.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/range_preserver.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
@@ -260,6 +265,240 @@ void JSReducer::_reduce(const BSONList& tuples, BSONObj& key, int& endSizeEstima
     _reduce(x, key, endSizeEstimate);
 }
 
+namespace {
+
+// A JS property path such as 'a.b', as written after 'this.'.
+const char kJSPathPattern[] = "([A-Za-z_$][\\w$]*(?:\\.[A-Za-z_$][\\w$]*)*)";
+
+/**
+ * Returns true if 'elem' converts to a JS value and back to BSON unchanged, apart from NumberInt
+ * becoming NumberDouble as it does for the arguments of emit().
+ */
+bool convertsToJSUnchanged(const BSONElement& elem) {
+    switch (elem.type()) {
+        case String:
+            return elem.valueStringData().find('\0') == string::npos;
+        case Date:
+            // Dates outside this range are invalid in JS.
+            return std::abs(elem.date().toMillisSinceEpoch()) <= 8640000000000000LL;
+        case NumberDouble:
+        case NumberInt:
+        case Bool:
+        case jstNULL:
+        case jstOID:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Returns the element at 'path' in 'obj', which JS would reach through embedded objects, or EOO if
+ * JS wouldn't find a value there.
+ */
+BSONElement getJSPath(const BSONObj& obj, StringData path) {
+    BSONObj current = obj;
+    while (true) {
+        const size_t dot = path.find('.');
+        BSONElement elem = current.getField(path.substr(0, dot));
+        if (dot == string::npos || elem.type() != Object) {
+            return dot == string::npos ? elem : BSONElement();
+        }
+        current = elem.embeddedObject();
+        path = path.substr(dot + 1);
+    }
+}
+
+/**
+ * Appends 'elem' to 'b' as 'fieldName' the way it comes back from JS.
+ */
+void appendAsFromJS(BSONObjBuilder* b, StringData fieldName, const BSONElement& elem) {
+    if (elem.type() == NumberInt) {
+        b->append(fieldName, elem.numberDouble());
+    } else {
+        b->appendAs(elem, fieldName);
+    }
+}
+
+}  // namespace
+
+NativeMapper::NativeMapper(const BSONElement& code,
+                           string keyPath,
+                           string valuePath,
+                           double valueConstant)
+    : _jsMapper(code),
+      _keyPath(std::move(keyPath)),
+      _valuePath(std::move(valuePath)),
+      _valueConstant(valueConstant) {}
+
+std::unique_ptr<NativeMapper> NativeMapper::parse(const BSONElement& code) {
+    if (code.type() != Code && code.type() != String) {
+        return nullptr;
+    }
+
+    static const pcrecpp::RE re(str::stream()
+                                << "\\s*function\\s*\\(\\s*\\)\\s*\\{\\s*emit\\s*\\(\\s*this\\."
+                                << kJSPathPattern << "\\s*,\\s*(?:this\\." << kJSPathPattern
+                                << "|(-?\\d+(?:\\.\\d+)?))\\s*\\)\\s*;?\\s*\\}\\s*");
+    string keyPath;
+    string valuePath;
+    string valueConstant;
+    if (!re.FullMatch(code.valuestr(), &keyPath, &valuePath, &valueConstant)) {
+        return nullptr;
+    }
+
+    return std::unique_ptr<NativeMapper>(new NativeMapper(
+        code, keyPath, valuePath, valuePath.empty() ? strtod(valueConstant.c_str(), nullptr) : 0));
+}
+
+void NativeMapper::init(State* state) {
+    _jsMapper.init(state);
+    _state = state;
+}
+
+bool NativeMapper::makeTuple(const BSONObj& o, BSONObj* tuple) const {
+    const BSONElement key = getJSPath(o, _keyPath);
+    if (!convertsToJSUnchanged(key)) {
+        return false;
+    }
+
+    BSONObjBuilder b;
+    appendAsFromJS(&b, "0", key);
+    if (_valuePath.empty()) {
+        b.append("1", _valueConstant);
+    } else {
+        const BSONElement value = getJSPath(o, _valuePath);
+        if (!convertsToJSUnchanged(value)) {
+            return false;
+        }
+        appendAsFromJS(&b, "1", value);
+    }
+
+    if (b.len() >= BSONObjMaxUserSize / 2) {
+        // Let the JS function report the emit as too large.
+        return false;
+    }
+
+    *tuple = b.obj();
+    return true;
+}
+
+void NativeMapper::map(const BSONObj& o) {
+    BSONObj tuple;
+    if (makeTuple(o, &tuple)) {
+        _state->emit(tuple);
+    } else {
+        _jsMapper.map(o);
+    }
+}
+
+std::unique_ptr<NativeReducer> NativeReducer::parse(const BSONElement& code) {
+    if (code.type() != Code && code.type() != String) {
+        return nullptr;
+    }
+
+    static const pcrecpp::RE sumRe(
+        "\\s*function\\s*\\(\\s*[A-Za-z_$][\\w$]*\\s*,\\s*([A-Za-z_$][\\w$]*)\\s*\\)\\s*\\{\\s*"
+        "return\\s+Array\\.sum\\s*\\(\\s*([A-Za-z_$][\\w$]*)\\s*\\)\\s*;?\\s*\\}\\s*");
+    static const pcrecpp::RE minMaxRe(
+        "\\s*function\\s*\\(\\s*[A-Za-z_$][\\w$]*\\s*,\\s*([A-Za-z_$][\\w$]*)\\s*\\)\\s*\\{\\s*"
+        "return\\s+Math\\.(max|min)\\.apply\\s*\\(\\s*Math\\s*,\\s*([A-Za-z_$][\\w$]*)\\s*\\)"
+        "\\s*;?\\s*\\}\\s*");
+
+    string valuesParam;
+    string valuesArg;
+    string minMax;
+    Op op;
+    if (sumRe.FullMatch(code.valuestr(), &valuesParam, &valuesArg)) {
+        op = Op::kSum;
+    } else if (minMaxRe.FullMatch(code.valuestr(), &valuesParam, &minMax, &valuesArg)) {
+        op = minMax == "max" ? Op::kMax : Op::kMin;
+    } else {
+        return nullptr;
+    }
+
+    if (valuesParam != valuesArg) {
+        return nullptr;
+    }
+    return std::unique_ptr<NativeReducer>(new NativeReducer(code, op));
+}
+
+void NativeReducer::init(State* state) {
+    _jsReducer.init(state);
+}
+
+bool NativeReducer::reduceValues(const BSONList& tuples, double* result) const {
+    invariant(!tuples.empty());
+
+    for (size_t i = 0; i < tuples.size(); ++i) {
+        BSONObjIterator it(tuples[i]);
+        it.next();
+        const BSONElement valueElem = it.next();
+        if (valueElem.type() != NumberDouble && valueElem.type() != NumberInt) {
+            return false;
+        }
+
+        const double value = valueElem.numberDouble();
+        if (std::isnan(value)) {
+            return false;
+        }
+
+        if (i == 0) {
+            *result = value;
+        } else if (_op == Op::kSum) {
+            *result += value;
+        } else if (value == *result) {
+            // Math.max and Math.min order +0 after -0.
+            if (std::signbit(value) == (_op == Op::kMin)) {
+                *result = value;
+            }
+        } else if ((value > *result) == (_op == Op::kMax)) {
+            *result = value;
+        }
+    }
+    return true;
+}
+
+BSONObj NativeReducer::reduce(const BSONList& tuples) {
+    if (tuples.size() <= 1)
+        return tuples[0];
+
+    double result;
+    if (!reduceValues(tuples, &result)) {
+        const long long jsReduces = _jsReducer.numReduces;
+        BSONObj res = _jsReducer.reduce(tuples);
+        numReduces += _jsReducer.numReduces - jsReduces;
+        return res;
+    }
+    ++numReduces;
+
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "0");
+    b.append("1", result);
+    return b.obj();
+}
+
+BSONObj NativeReducer::finalReduce(const BSONList& tuples, Finalizer* finalizer) {
+    double result;
+    if (tuples.size() == 1 || !reduceValues(tuples, &result)) {
+        const long long jsReduces = _jsReducer.numReduces;
+        BSONObj res = _jsReducer.finalReduce(tuples, finalizer);
+        numReduces += _jsReducer.numReduces - jsReduces;
+        return res;
+    }
+    ++numReduces;
+
+    BSONObjBuilder b;
+    b.appendAs(tuples[0].firstElement(), "_id");
+    b.append("value", result);
+    BSONObj res = b.obj();
+
+    if (finalizer) {
+        res = finalizer->finalize(res);
+    }
+    return res;
+}
+
 Config::Config(const string& _dbname, const BSONObj& cmdObj) {
     dbname = _dbname;
     ns = dbname + "." + cmdObj.firstElement().valuestrsafe();
@@ -301,8 +540,16 @@ Config::Config(const string& _dbname, const BSONObj& cmdObj) {
         if (cmdObj["scope"].type() == Object)
             scopeSetup = cmdObj["scope"].embeddedObjectUserCheck();
 
-        mapper.reset(new JSMapper(cmdObj["map"]));
-        reducer.reset(new JSReducer(cmdObj["reduce"]));
+        // The native functions are used outside of JS mode, where emitted tuples are kept in C++.
+        if (internalQueryMapReduceUseNativeFunctions && !jsMode && scopeSetup.isEmpty() &&
+            cmdObj["mapparams"].type() != Array) {
+            mapper = NativeMapper::parse(cmdObj["map"]);
+            reducer = NativeReducer::parse(cmdObj["reduce"]);
+        }
+        if (!mapper)
+            mapper.reset(new JSMapper(cmdObj["map"]));
+        if (!reducer)
+            reducer.reset(new JSReducer(cmdObj["reduce"]));
         if (cmdObj["finalize"].type() && cmdObj["finalize"].trueValue())
             finalizer.reset(new JSFinalizer(cmdObj["finalize"]));
 
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -174,6 +175,82 @@ private:
     JSFunction _func;
 };
 
+// ------------  native function implementations -----------
+
+/**
+ * Maps documents like a JS map function of the form
+ *     function() { emit(this.<path>, <this.<path> or a number>); }
+ * without calling into the JS engine. A document whose key or value would not convert to and from
+ * JS unchanged, or whose paths don't lead to a scalar through embedded objects, is mapped by the
+ * JS function instead.
+ */
+class NativeMapper : public Mapper {
+public:
+    /**
+     * Returns a NativeMapper for the JS map function 'code', or nullptr if it is not of the form
+     * above.
+     */
+    static std::unique_ptr<NativeMapper> parse(const BSONElement& code);
+
+    void map(const BSONObj& o) final;
+    void init(State* state) final;
+
+    /**
+     * Sets '*tuple' to the tuple the JS function would emit for 'o' and returns true, or returns
+     * false if 'o' must be mapped by the JS function.
+     */
+    bool makeTuple(const BSONObj& o, BSONObj* tuple) const;
+
+private:
+    NativeMapper(const BSONElement& code,
+                 std::string keyPath,
+                 std::string valuePath,
+                 double valueConstant);
+
+    JSMapper _jsMapper;
+    State* _state = nullptr;
+
+    const std::string _keyPath;
+    const std::string _valuePath;  // Empty if the constant '_valueConstant' is emitted instead.
+    const double _valueConstant;
+};
+
+/**
+ * Reduces tuples like a JS reduce function of one of the forms
+ *     function(key, values) { return Array.sum(values); }
+ *     function(key, values) { return Math.max.apply(Math, values); }
+ *     function(key, values) { return Math.min.apply(Math, values); }
+ * without calling into the JS engine. Tuples whose values are not all numbers, or are NaN, are
+ * reduced by the JS function instead.
+ */
+class NativeReducer : public Reducer {
+public:
+    enum class Op { kSum, kMax, kMin };
+
+    /**
+     * Returns a NativeReducer for the JS reduce function 'code', or nullptr if it is not of one of
+     * the forms above.
+     */
+    static std::unique_ptr<NativeReducer> parse(const BSONElement& code);
+
+    void init(State* state) final;
+
+    BSONObj reduce(const BSONList& tuples) final;
+    BSONObj finalReduce(const BSONList& tuples, Finalizer* finalizer) final;
+
+    /**
+     * Sets '*result' to the value the JS function would return for the values of 'tuples' and
+     * returns true, or returns false if 'tuples' must be reduced by the JS function.
+     */
+    bool reduceValues(const BSONList& tuples, double* result) const;
+
+private:
+    NativeReducer(const BSONElement& code, Op op) : _jsReducer(code), _op(op) {}
+
+    JSReducer _jsReducer;
+    const Op _op;
+};
+
 // -----------------
 
 
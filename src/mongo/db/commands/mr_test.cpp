@@ -32,6 +32,8 @@
 
 #include "mongo/db/commands/mr.h"
 
+#include <cmath>
+#include <limits>
 #include <string>
 
 #include "mongo/db/json.h"
@@ -208,4 +210,97 @@ TEST(ConfigOutputOptionsTest, parseOutputOptions) {
                                   mr::Config::INMEMORY);
 }
 
+/**
+ * Tests for mr::NativeMapper and mr::NativeReducer.
+ */
+
+BSONElement code(const BSONObj& holder) {
+    return holder.firstElement();
+}
+
+TEST(NativeMapperTest, ParsesSimpleEmits) {
+    ASSERT(mr::NativeMapper::parse(code(BSON("" << "function() { emit(this.a, 1); }"))));
+    ASSERT(mr::NativeMapper::parse(code(BSON("" << "function(){emit(this.a.b,this.c)}"))));
+    ASSERT(mr::NativeMapper::parse(
+        code(BSONObjBuilder().appendCode("", "function() { emit(this._id, -2.5); }").obj())));
+
+    ASSERT(!mr::NativeMapper::parse(code(BSON("" << "function() { emit(this.a, this.b + 1); }"))));
+    ASSERT(!mr::NativeMapper::parse(code(BSON("" << "function() { emit(this['a'], 1); }"))));
+    ASSERT(!mr::NativeMapper::parse(
+        code(BSON("" << "function() { emit(this.a, 1); emit(this.b, 1); }"))));
+    ASSERT(!mr::NativeMapper::parse(code(BSON("" << 1))));
+}
+
+TEST(NativeMapperTest, MakesTheTuplesJSWould) {
+    auto mapper =
+        mr::NativeMapper::parse(code(BSON("" << "function() { emit(this.a.b, this.c); }")));
+    ASSERT(mapper);
+
+    BSONObj tuple;
+    ASSERT(mapper->makeTuple(fromjson("{a: {b: 'x'}, c: 3.5}"), &tuple));
+    ASSERT_EQUALS(fromjson("{'0': 'x', '1': 3.5}"), tuple);
+
+    // Integers become doubles in JS.
+    ASSERT(mapper->makeTuple(BSON("a" << BSON("b" << 1) << "c" << 2), &tuple));
+    ASSERT_EQUALS(NumberDouble, tuple["0"].type());
+    ASSERT_EQUALS(NumberDouble, tuple["1"].type());
+
+    // Missing fields, arrays and values which change in JS are left to the JS function.
+    ASSERT(!mapper->makeTuple(fromjson("{a: {b: 'x'}}"), &tuple));
+    ASSERT(!mapper->makeTuple(fromjson("{a: [{b: 'x'}], c: 1}"), &tuple));
+    ASSERT(!mapper->makeTuple(fromjson("{a: {b: {d: 1}}, c: 1}"), &tuple));
+    ASSERT(!mapper->makeTuple(BSON("a" << BSON("b" << 1LL) << "c" << 1), &tuple));
+
+    mapper = mr::NativeMapper::parse(code(BSON("" << "function() { emit(this.a, 1); }")));
+    ASSERT(mapper->makeTuple(fromjson("{a: null}"), &tuple));
+    ASSERT_EQUALS(fromjson("{'0': null, '1': 1.0}"), tuple);
+}
+
+double reduceValues(const mr::NativeReducer& reducer, const std::vector<double>& values) {
+    mr::BSONList tuples;
+    for (double value : values) {
+        tuples.push_back(BSON("0" << "key" << "1" << value));
+    }
+    double result;
+    ASSERT(reducer.reduceValues(tuples, &result));
+    return result;
+}
+
+TEST(NativeReducerTest, ParsesSumMinAndMax) {
+    ASSERT(mr::NativeReducer::parse(
+        code(BSON("" << "function(key, values) { return Array.sum(values); }"))));
+    ASSERT(mr::NativeReducer::parse(
+        code(BSON("" << "function(k,v){return Math.max.apply(Math, v)}"))));
+    ASSERT(mr::NativeReducer::parse(
+        code(BSON("" << "function(k, vals) { return Math.min.apply(Math, vals); }"))));
+
+    ASSERT(!mr::NativeReducer::parse(
+        code(BSON("" << "function(key, values) { return Array.sum(key); }"))));
+    ASSERT(!mr::NativeReducer::parse(
+        code(BSON("" << "function(key, values) { return values.length; }"))));
+}
+
+TEST(NativeReducerTest, ReducesLikeJS) {
+    auto sum = mr::NativeReducer::parse(
+        code(BSON("" << "function(key, values) { return Array.sum(values); }")));
+    ASSERT_EQUALS(6.5, reduceValues(*sum, {1, 2, 3.5}));
+
+    auto max = mr::NativeReducer::parse(
+        code(BSON("" << "function(key, values) { return Math.max.apply(Math, values); }")));
+    ASSERT_EQUALS(3.5, reduceValues(*max, {1, 3.5, 2}));
+    ASSERT(!std::signbit(reduceValues(*max, {-0.0, 0.0})));
+
+    auto min = mr::NativeReducer::parse(
+        code(BSON("" << "function(key, values) { return Math.min.apply(Math, values); }")));
+    ASSERT_EQUALS(-1.0, reduceValues(*min, {1, -1, 2}));
+    ASSERT(std::signbit(reduceValues(*min, {0.0, -0.0})));
+
+    // Values which aren't numbers are left to the JS function.
+    double result;
+    ASSERT(!sum->reduceValues({fromjson("{'0': 1, '1': 'a'}"), fromjson("{'0': 1, '1': 1}")},
+                              &result));
+    ASSERT(!max->reduceValues(
+        {BSON("0" << 1 << "1" << std::numeric_limits<double>::quiet_NaN())}, &result));
+}
+
 }  // namespace
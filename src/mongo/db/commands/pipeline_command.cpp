@@ -50,6 +50,8 @@
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/sorter/sorter.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/stdx/memory.h"
 
@@ -191,6 +193,8 @@ public:
 
         intrusive_ptr<ExpressionContext> pCtx = new ExpressionContext(txn, nss);
         pCtx->tempDir = storageGlobalParams.dbpath + "/_tmp";
+        pCtx->spillTracker = std::make_shared<SpillTracker>(
+            internalDocumentSourceMaxSpillBytes, internalDocumentSourceMaxTotalSpillBytes);
 
         /* try to parse the command; if this fails, then we didn't run */
         intrusive_ptr<Pipeline> pPipeline = Pipeline::parseCommand(errmsg, cmdObj, pCtx);
@@ -317,6 +321,11 @@ public:
         }
         // Any code that needs the cursor pinned must be inside the try block, above.
 
+        // Reports what the pipeline spilled while producing its first batch.
+        if (pCtx->spillTracker->bytesWritten() > 0) {
+            CurOp::get(txn)->debug().spilledBytes = pCtx->spillTracker->bytesWritten();
+        }
+
         return true;
     }
 } cmdPipeline;
@@ -48,6 +48,7 @@
 #include "mongo/util/log.h"
 #include "mongo/util/net/listen.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/ramlog.h"
 #include "mongo/util/version.h"
@@ -275,11 +276,38 @@ public:
     BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
         BSONObjBuilder b;
         networkCounter.append(b);
+
+        const Listener::Stats stats = Listener::getStats();
+        BSONObjBuilder listener(b.subobjStart("listener"));
+        listener.append("acceptThreads", stats.acceptThreads);
+        listener.append("accepted", stats.accepted);
+        listener.append("acceptWakeups", stats.acceptWakeups);
+        listener.append("acceptQueueDepth", stats.acceptQueueDepth);
+        listener.append("maxAcceptQueueDepth", stats.maxAcceptQueueDepth);
+        listener.append("firstMessages", stats.firstMessages);
+        listener.append("timeToFirstMessageMicros", stats.timeToFirstMessageMicros);
+        listener.done();
         return b.obj();
     }
 
 } network;
 
+class Numa : public ServerStatusSection {
+public:
+    Numa() : ServerStatusSection("numa") {}
+    virtual bool includeByDefault() const {
+        return NumaTopology::get().numNodes() > 0;
+    }
+
+    BSONObj generateSection(OperationContext* txn, const BSONElement& configElement) const {
+        BSONObjBuilder b;
+        b.append("pinConnections", numaPinConnections);
+        NumaTopology::get().appendStats(&b);
+        return b.obj();
+    }
+
+} numa;
+
 #ifdef MONGO_CONFIG_SSL
 class Security : public ServerStatusSection {
 public:
@@ -32,18 +32,90 @@
 
 #include "mongo/platform/basic.h"
 
+#include "mongo/bson/bson_validate.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/query/internal_plans.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
+#include "mongo/util/progress_meter.h"
 
 namespace mongo {
 
 using std::endl;
 using std::string;
 using std::stringstream;
+using std::unique_ptr;
+using std::vector;
+
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(internalBackgroundValidateThreads, int, 4);
+
+// How many keys a background index check scans between checks for an interrupted validate.
+const long long kKeysPerInterruptCheck = 1024;
+
+/**
+ * Scans the index 'indexName' of 'ns' under intent locks, yielding regularly, and checks that
+ * its keys come back in index order. 'interruptTxn' is the validate command's operation, which
+ * may be killed while the scan runs on another thread.
+ */
+Status validateIndexInBackground(OperationContext* txn,
+                                 OperationContext* interruptTxn,
+                                 const NamespaceString& ns,
+                                 const string& indexName,
+                                 long long* numKeys,
+                                 vector<string>* errors) {
+    AutoGetCollectionForRead ctx(txn, ns);
+    Collection* collection = ctx.getCollection();
+    if (!collection) {
+        return Status(ErrorCodes::NamespaceNotFound, "collection dropped during validate");
+    }
+    IndexDescriptor* desc = collection->getIndexCatalog()->findIndexByName(txn, indexName);
+    if (!desc) {
+        return Status(ErrorCodes::IndexNotFound,
+                      str::stream() << "index " << indexName << " dropped during validate");
+    }
+
+    const Ordering ordering = Ordering::make(desc->keyPattern());
+    unique_ptr<PlanExecutor> exec(InternalPlanner::indexScan(
+        txn, collection, desc, BSONObj(), BSONObj(), false, PlanExecutor::YIELD_AUTO));
+
+    *numKeys = 0;
+    BSONObj prevKey;
+    BSONObj key;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&key, NULL))) {
+        if (!prevKey.isEmpty() && prevKey.woCompare(key, ordering, false) > 0) {
+            errors->push_back(str::stream() << "index " << indexName << " has key " << key
+                                            << " after key " << prevKey);
+        }
+        prevKey = key.getOwned();
+
+        if (++(*numKeys) % kKeysPerInterruptCheck == 0) {
+            Status interrupted = interruptTxn->checkForInterruptNoAssert();
+            if (!interrupted.isOK()) {
+                return interrupted;
+            }
+        }
+    }
+    if (PlanExecutor::IS_EOF != state) {
+        return Status(ErrorCodes::OperationFailed,
+                      str::stream() << "index " << indexName << " scan died during validate: "
+                                    << WorkingSetCommon::toStatusString(key));
+    }
+    return Status::OK();
+}
+
+}  // namespace
 
 class ValidateCmd : public Command {
 public:
@@ -56,7 +128,8 @@ public:
     virtual void help(stringstream& h) const {
         h << "Validate contents of a namespace by scanning its data structures for correctness.  "
              "Slow.\n"
-             "Add full:true option to do a more thorough check";
+             "Add full:true option to do a more thorough check\n"
+             "Add background:true to check the documents and indexes without blocking writes";
     }
 
     virtual bool isWriteCommandForConfigServer() const {
@@ -69,7 +142,8 @@ public:
         actions.addAction(ActionType::validate);
         out->push_back(Privilege(parseResourcePattern(dbname, cmdObj), actions));
     }
-    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool> } */
+    //{ validate: "collectionnamewithoutthedbpart" [, scandata: <bool>] [, full: <bool>]
+    //  [, background: <bool>] } */
 
     bool run(OperationContext* txn,
              const string& dbname,
@@ -88,8 +162,18 @@ public:
             return false;
         }
 
+        const bool background = cmdObj["background"].trueValue();
+        if (background && full) {
+            errmsg = "full validate can not run in the background";
+            return false;
+        }
+
         if (!serverGlobalParams.quiet) {
-            LOG(0) << "CMD: validate " << ns << endl;
+            LOG(0) << "CMD: validate " << ns << (background ? " (background)" : "") << endl;
+        }
+
+        if (background) {
+            return runInBackground(txn, ns_string, errmsg, result);
         }
 
         AutoGetDb ctx(txn, ns_string.db(), MODE_IX);
@@ -123,5 +207,144 @@ public:
         return true;
     }
 
+private:
+    /**
+     * Validates 'ns' without blocking writers: the documents are scanned under an intent lock
+     * which is yielded regularly, and every index is scanned the same way on a thread of its
+     * own. This checks each document's BSON and each index's key order, but skips the storage
+     * engine's own structural checks, which need the collection to hold still.
+     */
+    bool runInBackground(OperationContext* txn,
+                         const NamespaceString& ns,
+                         string& errmsg,
+                         BSONObjBuilder& result) {
+        vector<string> indexNames;
+        long long numRecordsEstimate = 0;
+        {
+            AutoGetCollectionForRead ctx(txn, ns);
+            Collection* collection = ctx.getCollection();
+            if (!collection) {
+                errmsg = "ns not found";
+                return false;
+            }
+            IndexCatalog::IndexIterator it =
+                collection->getIndexCatalog()->getIndexIterator(txn, false);
+            while (it.more()) {
+                indexNames.push_back(it.next()->indexName());
+            }
+            numRecordsEstimate = collection->numRecords(txn);
+        }
+
+        result.append("ns", ns.ns());
+
+        vector<long long> numKeys(indexNames.size(), 0);
+        vector<vector<string>> indexErrors(indexNames.size());
+        vector<Status> indexStatuses(indexNames.size(), Status::OK());
+
+        ThreadPool::Options options;
+        options.poolName = "backgroundValidatePool";
+        options.threadNamePrefix = "backgroundValidateWorker";
+        options.maxThreads = std::max(1, static_cast<int>(internalBackgroundValidateThreads));
+        ThreadPool pool(options);
+        pool.startup();
+
+        for (size_t i = 0; i < indexNames.size(); ++i) {
+            Status scheduled = pool.schedule(
+                [txn, i, &ns, &indexNames, &numKeys, &indexErrors, &indexStatuses] {
+                    Client::initThreadIfNotAlready("backgroundValidateWorker");
+                    OperationContextImpl workerTxn;
+                    try {
+                        indexStatuses[i] = validateIndexInBackground(
+                            &workerTxn, txn, ns, indexNames[i], &numKeys[i], &indexErrors[i]);
+                    } catch (const DBException& ex) {
+                        indexStatuses[i] = ex.toStatus();
+                    }
+                });
+            if (!scheduled.isOK()) {
+                indexStatuses[i] = scheduled;
+            }
+        }
+
+        ValidateResults results;
+        long long numRecords = 0;
+        long long dataSize = 0;
+        Status recordStatus = Status::OK();
+        try {
+            AutoGetCollectionForRead ctx(txn, ns);
+            Collection* collection = ctx.getCollection();
+            uassert(ErrorCodes::NamespaceNotFound,
+                    "collection dropped during validate",
+                    collection);
+
+            stdx::unique_lock<Client> lk(*txn->getClient());
+            ProgressMeterHolder progress(*txn->setMessage_inlock(
+                "Background Validate", "Background Validate Progress", numRecordsEstimate));
+            lk.unlock();
+
+            unique_ptr<PlanExecutor> exec(InternalPlanner::collectionScan(
+                txn, ns.ns(), collection, PlanExecutor::YIELD_AUTO));
+            BSONObj obj;
+            RecordId loc;
+            PlanExecutor::ExecState state;
+            while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, &loc))) {
+                Status status = validateBSON(obj.objdata(), obj.objsize());
+                if (!status.isOK()) {
+                    results.valid = false;
+                    results.errors.push_back(str::stream() << "invalid object at " << loc
+                                                           << ": " << status.reason());
+                }
+                numRecords++;
+                dataSize += obj.objsize();
+                progress.hit();
+            }
+            uassert(ErrorCodes::OperationFailed,
+                    str::stream() << "collection scan died during validate: "
+                                  << WorkingSetCommon::toStatusString(obj),
+                    PlanExecutor::IS_EOF == state);
+            progress.finished();
+        } catch (const DBException& ex) {
+            recordStatus = ex.toStatus();
+        }
+
+        pool.waitForIdle();
+        pool.shutdown();
+        pool.join();
+
+        if (!recordStatus.isOK()) {
+            return appendCommandStatus(result, recordStatus);
+        }
+
+        BSONObjBuilder keysPerIndex;
+        for (size_t i = 0; i < indexNames.size(); ++i) {
+            if (!indexStatuses[i].isOK()) {
+                return appendCommandStatus(result, indexStatuses[i]);
+            }
+            const string indexNs = ns.ns() + ".$" + indexNames[i];
+            keysPerIndex.appendNumber(indexNs, numKeys[i]);
+            if (!indexErrors[i].empty()) {
+                results.valid = false;
+                results.errors.insert(
+                    results.errors.end(), indexErrors[i].begin(), indexErrors[i].end());
+            }
+        }
+
+        result.appendNumber("nrecords", numRecords);
+        result.appendNumber("datasize", dataSize);
+        result.append("nIndexes", static_cast<int>(indexNames.size()));
+        result.append("keysPerIndex", keysPerIndex.obj());
+        result.appendBool("background", true);
+        result.appendBool("valid", results.valid);
+        result.append("errors", results.errors);
+        result.append("warning",
+                      "Documents and indexes were checked while writes continued, so record and "
+                      "key counts need not agree. Storage engine checks were skipped.");
+
+        if (!results.valid) {
+            result.append("advice", "ns corrupt. See http://dochub.mongodb.org/core/data-recovery");
+        }
+
+        return true;
+    }
+
 } validateCmd;
 }
@@ -57,6 +57,7 @@
 #include "mongo/db/ops/parsed_update.h"
 #include "mongo/db/ops/update_lifecycle_impl.h"
 #include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/lite_parsed_query.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/query_knobs.h"
 #include "mongo/db/repl/oplog.h"
@@ -218,11 +219,86 @@ bool checkShardVersion(OperationContext* txn,
     return true;
 }
 
+/**
+ * Holds the intent locks on the database and collection targeted by an update or delete batch
+ * across several of its operations. While they are held, the locks each operation takes for
+ * itself are recursive acquisitions that don't go through the lock manager.
+ *
+ * Only operations that write at most one document are run this way: the locks held here prevent
+ * the PlanExecutor from yielding, so yields happen at the batch level instead (see
+ * WriteBatchExecutor::bulkExecute()).
+ */
+class BatchLocks {
+    MONGO_DISALLOW_COPYING(BatchLocks);
+
+public:
+    BatchLocks(OperationContext* txn, const NamespaceString& nss) : _txn(txn), _nss(nss) {}
+
+    /**
+     * Takes the locks unless they are already held. Leaves them released if the collection does
+     * not exist, since creating it needs a stronger lock on the database.
+     */
+    void acquire() {
+        if (_collLock) {
+            return;
+        }
+
+        _transaction.emplace(_txn, MODE_IX);
+        _dbLock.emplace(_txn->lockState(), _nss.db(), MODE_IX);
+        Database* const db = dbHolder().get(_txn, _nss.db());
+        if (!db || !db->getCollection(_nss.ns())) {
+            release();
+            return;
+        }
+        _collLock.emplace(_txn->lockState(), _nss.ns(), MODE_IX);
+    }
+
+    void release() {
+        _collLock = boost::none;
+        _dbLock = boost::none;
+        _transaction = boost::none;
+    }
+
+    bool isHeld() const {
+        return static_cast<bool>(_collLock);
+    }
+
+private:
+    OperationContext* const _txn;
+    const NamespaceString _nss;
+
+    boost::optional<ScopedTransaction> _transaction;
+    boost::optional<Lock::DBLock> _dbLock;
+    boost::optional<Lock::CollectionLock> _collLock;
+};
+
+/**
+ * Returns true if 'currWrite' is an update or delete that may run under BatchLocks.
+ */
+bool writesAtMostOneDocument(const BatchItemRef& currWrite) {
+    if (currWrite.getOpType() == BatchedCommandRequest::BatchType_Update) {
+        const BatchedUpdateDocument* update = currWrite.getUpdate();
+        return !update->getMulti() && !LiteParsedQuery::isQueryIsolated(update->getQuery());
+    }
+
+    dassert(currWrite.getOpType() == BatchedCommandRequest::BatchType_Delete);
+    const BatchedDeleteDocument* remove = currWrite.getDelete();
+    return remove->getLimit() == 1 && !LiteParsedQuery::isQueryIsolated(remove->getQuery());
+}
+
 }  // namespace
 
 // TODO: Determine queueing behavior we want here
 MONGO_EXPORT_SERVER_PARAMETER(queueForMigrationCommit, bool, true);
 
+// Maximum number of documents, and their total size in bytes, written by a single batched insert
+// (see WriteBatchExecutor::execInsertBatch). A value of 1 for the count disables batching.
+MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchSize, int, 64);
+MONGO_EXPORT_SERVER_PARAMETER(internalInsertMaxBatchBytes, int, 256 * 1024);
+
+// Whether single-document updates and deletes in a batch share the batch's collection locks.
+MONGO_EXPORT_SERVER_PARAMETER(internalWriteBatchSharedLocks, bool, true);
+
 WriteBatchExecutor::WriteBatchExecutor(OperationContext* txn, OpCounters* opCounters, LastError* le)
     : _txn(txn), _opCounters(opCounters), _le(le), _stats(new WriteBatchStats) {}
 
@@ -566,7 +642,7 @@ static void finishCurrentOp(OperationContext* txn, WriteErrorDetail* opError) {
                                                        logger::LogSeverity::Debug(1));
     bool logSlow = executionTime > (serverGlobalParams.slowMS + currentOp->getExpectedLatencyMs());
 
-    if (logAll || logSlow) {
+    if (logAll || (logSlow && shouldLogSlowOp(logger::LogComponent::kWrite))) {
         Locker::LockerInfo lockerInfo;
         txn->lockState()->getLockerInfo(&lockerInfo);
 
@@ -687,6 +763,29 @@ void WriteBatchExecutor::bulkExecute(const BatchedCommandRequest& request,
         maybeDisableValidation.emplace(_txn);
     }
 
+    // Theory of operation for updates and deletes (inserts are grouped by execInserts()):
+    //
+    // A batch targets a single collection. Operations that write at most one document run while
+    // 'batchLocks' holds the collection locks, taking them only when the previous operation did
+    // not leave them held. Other operations release them first, so that they can take stronger
+    // locks and yield as usual. Since locks held across operations keep the PlanExecutor from
+    // yielding, the batch yields between operations on the same schedule as PlanYieldPolicy.
+    BatchLocks batchLocks(_txn, request.getNS());
+    ElapsedTracker elapsedTracker(internalQueryExecYieldIterations, internalQueryExecYieldPeriodMS);
+    auto prepareForWrite = [&](const BatchItemRef& currWrite) {
+        if (elapsedTracker.intervalHasElapsed()) {
+            batchLocks.release();
+            _txn->checkForInterrupt();
+            elapsedTracker.resetLastTime();
+        }
+
+        if (internalWriteBatchSharedLocks && writesAtMostOneDocument(currWrite)) {
+            batchLocks.acquire();
+        } else {
+            batchLocks.release();
+        }
+    };
+
     if (request.getBatchType() == BatchedCommandRequest::BatchType_Insert) {
         execInserts(request, errors);
     } else if (request.getBatchType() == BatchedCommandRequest::BatchType_Update) {
@@ -695,9 +794,12 @@ void WriteBatchExecutor::bulkExecute(const BatchedCommandRequest& request,
                 setupSynchronousCommit(_txn);
             }
 
+            const BatchItemRef updateItem(&request, i);
+            prepareForWrite(updateItem);
+
             WriteErrorDetail* error = NULL;
             BSONObj upsertedId;
-            execUpdate(BatchItemRef(&request, i), &upsertedId, &error);
+            execUpdate(updateItem, &upsertedId, &error);
 
             if (!upsertedId.isEmpty()) {
                 BatchedUpsertDetail* batchUpsertedId = new BatchedUpsertDetail;
@@ -719,8 +821,11 @@ void WriteBatchExecutor::bulkExecute(const BatchedCommandRequest& request,
                 setupSynchronousCommit(_txn);
             }
 
+            const BatchItemRef removeItem(&request, i);
+            prepareForWrite(removeItem);
+
             WriteErrorDetail* error = NULL;
-            execRemove(BatchItemRef(&request, i), &error);
+            execRemove(removeItem, &error);
 
             if (error) {
                 errors->push_back(error);
@@ -814,6 +919,14 @@ void WriteBatchExecutor::execInserts(const BatchedCommandRequest& request,
             elapsedTracker.resetLastTime();
         }
 
+        if (!request.isInsertIndexRequest()) {
+            const size_t numInserted = execInsertBatch(&state);
+            if (numInserted > 0) {
+                state.currIndex += numInserted - 1;
+                continue;
+            }
+        }
+
         WriteErrorDetail* error = NULL;
         execOneInsert(&state, &error);
         if (error) {
@@ -1055,6 +1168,80 @@ void WriteBatchExecutor::execOneInsert(ExecInsertsState* state, WriteErrorDetail
     }
 }
 
+size_t WriteBatchExecutor::execInsertBatch(ExecInsertsState* state) {
+    invariant(!state->txn->lockState()->inAWriteUnitOfWork());
+
+    // Gather the run of valid inserts starting at the current one. Invalid documents end the run
+    // and are reported by execOneInsert().
+    std::vector<BSONObj> docs;
+    int batchBytes = 0;
+    for (size_t i = state->currIndex; i < state->request->sizeWriteOps(); ++i) {
+        if (docs.size() >= static_cast<size_t>(internalInsertMaxBatchSize) ||
+            batchBytes >= internalInsertMaxBatchBytes) {
+            break;
+        }
+
+        const StatusWith<BSONObj>& normalizedInsert = state->normalizedInserts[i];
+        if (!normalizedInsert.isOK())
+            break;
+
+        docs.push_back(normalizedInsert.getValue().isEmpty()
+                           ? state->request->getInsertRequest()->getDocumentsAt(i)
+                           : normalizedInsert.getValue());
+        batchBytes += docs.back().objsize();
+    }
+
+    if (docs.size() < 2) {
+        return 0;
+    }
+
+    if (state->currIndex + docs.size() == state->request->sizeWriteOps()) {
+        setupSynchronousCommit(_txn);
+    }
+
+    CurOp currentOp(_txn);
+    beginCurrentOp(_txn, BatchItemRef(state->request, state->currIndex));
+
+    // Any failure, including a write conflict, rolls back the whole batch and leaves the
+    // documents to execOneInsert(), which retries and reports errors for each of them.
+    try {
+        WriteOpResult result;
+        if (!state->lockAndCheck(&result)) {
+            return 0;
+        }
+
+        WriteUnitOfWork wunit(_txn);
+        Status status =
+            state->getCollection()->insertDocuments(_txn, docs.begin(), docs.end(), true);
+        if (!status.isOK()) {
+            return 0;
+        }
+        wunit.commit();
+    } catch (const WriteConflictException&) {
+        CurOp::get(_txn)->debug().writeConflicts++;
+        state->unlock();
+        _txn->recoveryUnit()->abandonSnapshot();
+        return 0;
+    } catch (const DBException& ex) {
+        if (ErrorCodes::isInterruption(ex.toStatus().code()))
+            throw;
+        state->unlock();
+        _txn->recoveryUnit()->abandonSnapshot();
+        return 0;
+    }
+
+    WriteOpStats stats;
+    stats.n = 1;
+    for (size_t i = 0; i < docs.size(); ++i) {
+        BatchItemRef insertItem(state->request, state->currIndex + i);
+        incOpStats(insertItem);
+        incWriteStats(insertItem, stats, NULL, &currentOp);
+    }
+    finishCurrentOp(_txn, NULL);
+
+    return docs.size();
+}
+
 /**
  * Perform a single insert into a collection.  Requires the insert be preprocessed and the
  * collection already has been created.
@@ -97,6 +97,13 @@ private:
      */
     void execOneInsert(ExecInsertsState* state, WriteErrorDetail** error);
 
+    /**
+     * Inserts the run of valid documents starting at the current insert of "state" as a single
+     * batch, committed in one WriteUnitOfWork. Returns the number of documents inserted, or zero
+     * if nothing was written and the caller should fall back to execOneInsert().
+     */
+    size_t execInsertBatch(ExecInsertsState* state);
+
     /**
      * Executes an update item (which may update many documents or upsert), and returns the
      * upserted _id on upsert or error on failure.
@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+
+#include <algorithm>
+
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(lockContentionProfiling, bool, false);
+
+namespace {
+
+LockContentionProfiler globalLockContentionProfiler;
+
+const char* const kWaitBucketNames[LockContentionProfiler::kNumWaitBuckets] = {
+    "0-1ms", "1-10ms", "10-100ms", "100ms-1s", "1-10s", "10s+"};
+
+}  // namespace
+
+// static
+LockContentionProfiler& LockContentionProfiler::get() {
+    return globalLockContentionProfiler;
+}
+
+void LockContentionProfiler::recordWait(ResourceId resId,
+                                        LockMode mode,
+                                        uint64_t waitMicros,
+                                        bool granted,
+                                        unsigned waiterOpId,
+                                        std::vector<unsigned> holderOpIds) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _resources.find(resId);
+    if (it == _resources.end()) {
+        if (_resources.size() >= kMaxResources) {
+            _untrackedWaits++;
+            return;
+        }
+        it = _resources.insert(std::make_pair(resId, ResourceContention())).first;
+        it->second.resId = resId;
+    }
+
+    ResourceContention& contention = it->second;
+    const long long micros = static_cast<long long>(waitMicros);
+    contention.numWaits++;
+    if (!granted)
+        contention.numWaitsNotGranted++;
+    contention.totalWaitMicros += micros;
+    contention.maxWaitMicros = std::max(contention.maxWaitMicros, micros);
+    contention.waitsByMode[mode]++;
+    contention.waitHistogram[waitBucket(waitMicros)]++;
+
+    if (contention.recentSamples.size() == kMaxSamplesPerResource)
+        contention.recentSamples.pop_front();
+    contention.recentSamples.emplace_back();
+    Sample& sample = contention.recentSamples.back();
+    sample.when = Date_t::now();
+    sample.waiterOpId = waiterOpId;
+    sample.mode = mode;
+    sample.granted = granted;
+    sample.waitMicros = waitMicros;
+    sample.holderOpIds = std::move(holderOpIds);
+}
+
+std::vector<LockContentionProfiler::ResourceContention> LockContentionProfiler::getTopResources(
+    size_t n) const {
+    std::vector<ResourceContention> top;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        top.reserve(_resources.size());
+        for (const auto& entry : _resources) {
+            top.push_back(entry.second);
+        }
+    }
+
+    const auto longerTotalWait = [](const ResourceContention& lhs, const ResourceContention& rhs) {
+        return lhs.totalWaitMicros > rhs.totalWaitMicros;
+    };
+    if (n < top.size()) {
+        std::partial_sort(top.begin(), top.begin() + n, top.end(), longerTotalWait);
+        top.resize(n);
+    } else {
+        std::sort(top.begin(), top.end(), longerTotalWait);
+    }
+    return top;
+}
+
+long long LockContentionProfiler::getUntrackedWaits() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _untrackedWaits;
+}
+
+void LockContentionProfiler::reset() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _resources.clear();
+    _untrackedWaits = 0;
+}
+
+// static
+int LockContentionProfiler::waitBucket(uint64_t waitMicros) {
+    int bucket = 0;
+    for (uint64_t bound = 1000; bucket < kNumWaitBuckets - 1 && waitMicros >= bound; bound *= 10) {
+        bucket++;
+    }
+    return bucket;
+}
+
+// static
+const char* LockContentionProfiler::waitBucketName(int bucket) {
+    return kWaitBucketNames[bucket];
+}
+
+}  // namespace mongo
@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/concurrency/lock_manager_defs.h"
+#include "mongo/platform/unordered_map.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Whether the lock requests which have to wait are recorded by the lock contention profiler.
+ */
+extern bool lockContentionProfiling;
+
+/**
+ * Keeps, for each resource on which lock requests had to wait while lockContentionProfiling was
+ * on, how many waits there were and how long they took, along with the last few waits and the
+ * operations which held the resource in a conflicting mode when they started.
+ *
+ * Only lock requests which are not granted right away are recorded, so that the profiler costs
+ * nothing to the uncontended path even when it is on. This class is thread-safe.
+ */
+class LockContentionProfiler {
+    MONGO_DISALLOW_COPYING(LockContentionProfiler);
+
+public:
+    // Waits are counted in buckets of [0, 1ms), [1ms, 10ms), ..., [1s, 10s) and [10s, inf).
+    static const int kNumWaitBuckets = 6;
+
+    static const size_t kMaxSamplesPerResource = 5;
+
+    // Lockers report at most this many of the holders of a resource they wait for.
+    static const size_t kMaxHolderOpIds = 8;
+
+    // Waits for resources beyond this many are only counted, so that hashing many different
+    // resources cannot use up memory.
+    static const size_t kMaxResources = 10000;
+
+    struct Sample {
+        Date_t when;
+        unsigned waiterOpId = 0;
+        LockMode mode = MODE_NONE;
+        bool granted = false;
+        uint64_t waitMicros = 0;
+        std::vector<unsigned> holderOpIds;
+    };
+
+    struct ResourceContention {
+        ResourceId resId;
+        long long numWaits = 0;
+        long long numWaitsNotGranted = 0;
+        long long totalWaitMicros = 0;
+        long long maxWaitMicros = 0;
+        long long waitsByMode[LockModesCount] = {};
+        long long waitHistogram[kNumWaitBuckets] = {};
+
+        // The most recent samples are at the back.
+        std::deque<Sample> recentSamples;
+    };
+
+    LockContentionProfiler() = default;
+
+    static LockContentionProfiler& get();
+
+    /**
+     * Records that a request for 'resId' in 'mode' by the operation 'waiterOpId' waited for
+     * 'waitMicros', while the operations 'holderOpIds' held it in a conflicting mode, and whether
+     * it was granted in the end.
+     */
+    void recordWait(ResourceId resId,
+                    LockMode mode,
+                    uint64_t waitMicros,
+                    bool granted,
+                    unsigned waiterOpId,
+                    std::vector<unsigned> holderOpIds);
+
+    /**
+     * Returns the 'n' resources which were waited for the longest in total, longest first.
+     */
+    std::vector<ResourceContention> getTopResources(size_t n) const;
+
+    /**
+     * Returns how many waits were only counted, because kMaxResources were already tracked.
+     */
+    long long getUntrackedWaits() const;
+
+    void reset();
+
+    static int waitBucket(uint64_t waitMicros);
+    static const char* waitBucketName(int bucket);
+
+private:
+    mutable stdx::mutex _mutex;
+    unordered_map<ResourceId, ResourceContention> _resources;
+    long long _untrackedWaits = 0;
+};
+
+}  // namespace mongo
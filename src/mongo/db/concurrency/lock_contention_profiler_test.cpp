@@ -0,0 +1,93 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/lock_contention_profiler.h"
+#include "mongo/db/concurrency/lock_manager_test_help.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+
+TEST(LockContentionProfiler, RecordsWaitsWithTheirHolders) {
+    const bool profilingBefore = lockContentionProfiling;
+    ON_BLOCK_EXIT([&] { lockContentionProfiling = profilingBefore; });
+    lockContentionProfiling = true;
+    LockContentionProfiler::get().reset();
+
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    LockerForTests holder(MODE_IX);
+    holder.setOpId(1);
+    LockerForTests waiter(MODE_IX);
+    waiter.setOpId(2);
+
+    ASSERT_EQUALS(LOCK_OK, holder.lock(resId, MODE_X));
+    ASSERT_EQUALS(LOCK_WAITING, waiter.lockBegin(resId, MODE_IX));
+    ASSERT_EQUALS(LOCK_TIMEOUT, waiter.lockComplete(resId, MODE_IX, 0, false));
+    holder.unlock(resId);
+
+    const auto top = LockContentionProfiler::get().getTopResources(10);
+    ASSERT_EQUALS(1U, top.size());
+    ASSERT_EQUALS(resId, top[0].resId);
+    ASSERT_EQUALS(1, top[0].numWaits);
+    ASSERT_EQUALS(1, top[0].numWaitsNotGranted);
+    ASSERT_EQUALS(1, top[0].waitsByMode[MODE_IX]);
+    ASSERT_EQUALS(1U, top[0].recentSamples.size());
+    ASSERT_EQUALS(2U, top[0].recentSamples[0].waiterOpId);
+    ASSERT_EQUALS(1U, top[0].recentSamples[0].holderOpIds.size());
+    ASSERT_EQUALS(1U, top[0].recentSamples[0].holderOpIds[0]);
+
+    LockContentionProfiler::get().reset();
+}
+
+TEST(LockContentionProfiler, ReportsTheLongestTotalWaitsFirst) {
+    LockContentionProfiler profiler;
+    const ResourceId resIdA(RESOURCE_COLLECTION, std::string("TestDB.a"));
+    const ResourceId resIdB(RESOURCE_COLLECTION, std::string("TestDB.b"));
+
+    profiler.recordWait(resIdA, MODE_IS, 500, true, 1, {});
+    profiler.recordWait(resIdB, MODE_X, 20000, true, 2, {1});
+    profiler.recordWait(resIdA, MODE_IX, 600, true, 3, {});
+
+    const auto top = profiler.getTopResources(1);
+    ASSERT_EQUALS(1U, top.size());
+    ASSERT_EQUALS(resIdB, top[0].resId);
+    ASSERT_EQUALS(1, top[0].waitHistogram[LockContentionProfiler::waitBucket(20000)]);
+    ASSERT_EQUALS(2, LockContentionProfiler::waitBucket(20000));
+
+    const auto all = profiler.getTopResources(10);
+    ASSERT_EQUALS(2U, all.size());
+    ASSERT_EQUALS(resIdA, all[1].resId);
+    ASSERT_EQUALS(2, all[1].numWaits);
+    ASSERT_EQUALS(1100, all[1].totalWaitMicros);
+    ASSERT_EQUALS(600, all[1].maxWaitMicros);
+}
+
+}  // namespace mongo
@@ -30,12 +30,18 @@
 
 #include "mongo/platform/basic.h"
 
+#include <algorithm>
 #include <vector>
 
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
 #include "mongo/db/concurrency/lock_manager.h"
 
 #include "mongo/config.h"
 #include "mongo/db/concurrency/locker.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stringutils.h"
@@ -45,6 +51,8 @@ namespace mongo {
 
 using std::string;
 
+MONGO_EXPORT_SERVER_PARAMETER(internalLockMaxBackgroundRequestOvertakes, int, 100);
+
 namespace {
 
 /**
@@ -201,22 +209,43 @@ struct LockHead {
         // which case access to that field is not protected. The 'partitioned' member instead
         // indicates if a request was initially partitioned.
 
+        request->overtakenCount = 0;
+
         // New lock request. Queue after all granted modes and after any already requested
         // conflicting modes.
         if (conflicts(mode, grantedModes) ||
             (!compatibleFirstCount && conflicts(mode, conflictModes))) {
-            request->status = LockRequest::STATUS_WAITING;
+            // Requests of operations which are not in the background go ahead of the background
+            // requests at the back of the queue, and are granted right away if that puts them at
+            // the front of it without conflicting with the granted modes.
+            LockRequest* overtaken = NULL;
+            if (!request->enqueueAtFront && !request->background) {
+                overtaken = firstOvertakableRequest();
+            }
 
-            // Put it on the conflict queue. Conflicts are granted front to back.
-            if (request->enqueueAtFront) {
-                conflictList.push_front(request);
-            } else {
-                conflictList.push_back(request);
+            if (overtaken != NULL) {
+                for (LockRequest* it = overtaken; it != NULL; it = it->next) {
+                    it->overtakenCount++;
+                }
             }
 
-            incConflictModeCount(mode);
+            if (overtaken == NULL || overtaken != conflictList._front ||
+                conflicts(mode, grantedModes)) {
+                request->status = LockRequest::STATUS_WAITING;
+
+                // Put it on the conflict queue. Conflicts are granted front to back.
+                if (request->enqueueAtFront) {
+                    conflictList.push_front(request);
+                } else if (overtaken != NULL) {
+                    conflictList.insert_before(overtaken, request);
+                } else {
+                    conflictList.push_back(request);
+                }
 
-            return LOCK_WAITING;
+                incConflictModeCount(mode);
+
+                return LOCK_WAITING;
+            }
         }
 
         // No conflict, new request
@@ -232,6 +261,25 @@ struct LockHead {
         return LOCK_OK;
     }
 
+    /**
+     * Returns the first of the requests at the back of the conflict queue which belong to
+     * background operations and may still be overtaken, or NULL if the request at the back does
+     * not.
+     */
+    LockRequest* firstOvertakableRequest() const {
+        const unsigned maxOvertakes =
+            std::max(0, internalLockMaxBackgroundRequestOvertakes);
+
+        LockRequest* first = NULL;
+        for (LockRequest* it = conflictList._back; it != NULL; it = it->prev) {
+            if (!it->background || it->enqueueAtFront || it->overtakenCount >= maxOvertakes) {
+                break;
+            }
+            first = it;
+        }
+        return first;
+    }
+
     /**
      * Lock each partitioned LockHead in turn, and move any (granted) intent mode requests for
      * lock->resourceId to lock, which must itself already be locked.
@@ -416,13 +464,10 @@ void LockHead::migratePartitionedLockHeads() {
 // Have more buckets than CPUs to reduce contention on lock and caches
 const unsigned LockManager::_numLockBuckets(128);
 
-// Balance scalability of intent locks against potential added cost of conflicting locks.
-// The exact value doesn't appear very important, but should be power of two
-const unsigned LockManager::_numPartitions = 32;
+const unsigned LockManager::_numPartitions;
 
 LockManager::LockManager() {
     _lockBuckets = new LockBucket[_numLockBuckets];
-    _partitions = new Partition[_numPartitions];
 }
 
 LockManager::~LockManager() {
@@ -434,7 +479,6 @@ LockManager::~LockManager() {
     }
 
     delete[] _lockBuckets;
-    delete[] _partitions;
 }
 
 LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mode) {
@@ -445,6 +489,7 @@ LockResult LockManager::lock(ResourceId resId, LockRequest* request, LockMode mo
 
     // For intent modes, try the PartitionedLockHead
     if (request->partitioned) {
+        _choosePartition(request);
         Partition* partition = _getPartition(request);
         stdx::lock_guard<SimpleMutex> scopedLock(partition->mutex);
 
@@ -658,6 +703,42 @@ void LockManager::downgrade(LockRequest* request, LockMode newMode) {
     _onLockModeChanged(lock, true);
 }
 
+bool LockManager::hasWaiters(ResourceId resId) {
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    // A conflicting request migrates any PartitionedLockHeads into the LockHead before it
+    // queues, so waiters are always on the LockHead's conflict list.
+    LockBucket::Map::iterator it = bucket->data.find(resId);
+    return it != bucket->data.end() && it->second->conflictList._front != NULL;
+}
+
+std::vector<unsigned> LockManager::getConflictingHolderOpIds(ResourceId resId,
+                                                             LockMode mode,
+                                                             const Locker* waiter,
+                                                             size_t maxOpIds) {
+    std::vector<unsigned> opIds;
+
+    LockBucket* bucket = _getBucket(resId);
+    stdx::lock_guard<SimpleMutex> scopedLock(bucket->mutex);
+
+    LockBucket::Map::iterator it = bucket->data.find(resId);
+    if (it == bucket->data.end()) {
+        return opIds;
+    }
+
+    // Requests which are still partitioned only hold intent modes, which do not conflict with
+    // the modes of requests which wait.
+    for (LockRequest* request = it->second->grantedList._front;
+         request != NULL && opIds.size() < maxOpIds;
+         request = request->next) {
+        if (request->locker != waiter && conflicts(mode, modeMask(request->mode))) {
+            opIds.push_back(request->locker->getOpId());
+        }
+    }
+    return opIds;
+}
+
 void LockManager::cleanupUnusedLocks() {
     size_t deletedLockHeads = 0;
     for (unsigned i = 0; i < _numLockBuckets; i++) {
@@ -789,8 +870,19 @@ LockManager::LockBucket* LockManager::_getBucket(ResourceId resId) const {
     return &_lockBuckets[resId % _numLockBuckets];
 }
 
-LockManager::Partition* LockManager::_getPartition(LockRequest* request) const {
-    return &_partitions[request->locker->getId() % _numPartitions];
+void LockManager::_choosePartition(LockRequest* request) const {
+#if defined(__linux__)
+    const int cpu = sched_getcpu();
+    if (cpu >= 0) {
+        request->partitionIndex = cpu % _numPartitions;
+        return;
+    }
+#endif
+    request->partitionIndex = request->locker->getId() % _numPartitions;
+}
+
+LockManager::Partition* LockManager::_getPartition(LockRequest* request) {
+    return &_partitions[request->partitionIndex];
 }
 
 void LockManager::dump() const {
@@ -1072,6 +1164,7 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
 
     enqueueAtFront = false;
     compatibleFirst = false;
+    background = false;
     recursiveCount = 0;
 
     lock = NULL;
@@ -1079,8 +1172,10 @@ void LockRequest::initNew(Locker* locker, LockGrantNotification* notify) {
     next = NULL;
     status = STATUS_NEW;
     partitioned = false;
+    partitionIndex = 0;
     mode = MODE_NONE;
     convertMode = MODE_NONE;
+    overtakenCount = 0;
 }
 
 
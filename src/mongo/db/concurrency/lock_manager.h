@@ -30,6 +30,7 @@
 
 #include <cstdint>
 #include <deque>
+#include <vector>
 
 #include "mongo/config.h"
 #include "mongo/db/concurrency/lock_manager_defs.h"
@@ -43,6 +44,12 @@
 
 namespace mongo {
 
+/**
+ * Each waiting lock request of a background operation may be overtaken by this many requests of
+ * other operations, after which it keeps its place in the queue.
+ */
+extern int internalLockMaxBackgroundRequestOvertakes;
+
 /**
  * Entry point for the lock manager scheduling functionality. Don't use it directly, but
  * instead go through the Locker interface.
@@ -109,6 +116,20 @@ public:
      */
     void downgrade(LockRequest* request, LockMode newMode);
 
+    /**
+     * Returns whether any request is queued waiting for 'resId'.
+     */
+    bool hasWaiters(ResourceId resId);
+
+    /**
+     * Returns the operations, at most 'maxOpIds' of them, which other than 'waiter' have been
+     * granted 'resId' in modes that conflict with 'mode'.
+     */
+    std::vector<unsigned> getConflictingHolderOpIds(ResourceId resId,
+                                                    LockMode mode,
+                                                    const Locker* waiter,
+                                                    size_t maxOpIds);
+
     /**
      * Iterates through all buckets and deletes all locks, which have no requests on them. This
      * call is kind of expensive and should only be used for reducing the memory footprint of
@@ -137,10 +158,11 @@ private:
         LockHead* findOrInsert(ResourceId resId);
     };
 
-    // Each locker maps to a partition that is used for resources acquired in intent modes
-    // modes and potentially other modes that don't conflict with themselves. This avoids
-    // contention on the regular LockHead in the lock manager.
-    struct Partition {
+    // Resources acquired in intent modes, and potentially other modes that don't conflict with
+    // themselves, are put on the partition for the CPU the locking thread runs on. This avoids
+    // contention on the regular LockHead in the lock manager, and keeps each partition in the
+    // cache of the CPU which uses it. The alignment keeps partitions on separate cache lines.
+    struct MONGO_COMPILER_ALIGN_TYPE(128) Partition {
         PartitionedLockHead* find(ResourceId resId);
         PartitionedLockHead* findOrInsert(ResourceId resId);
         typedef unordered_map<ResourceId, PartitionedLockHead*> Map;
@@ -155,10 +177,16 @@ private:
     LockBucket* _getBucket(ResourceId resId) const;
 
 
+    /**
+     * Chooses the Partition that a new LockRequest for an intent mode should use, which
+     * _getPartition() returns from then on.
+     */
+    void _choosePartition(LockRequest* request) const;
+
     /**
      * Retrieves the Partition that a particular LockRequest should use for intent locking.
      */
-    Partition* _getPartition(LockRequest* request) const;
+    Partition* _getPartition(LockRequest* request);
 
     /**
      * Prints the contents of a bucket to the log.
@@ -181,8 +209,10 @@ private:
     static const unsigned _numLockBuckets;
     LockBucket* _lockBuckets;
 
-    static const unsigned _numPartitions;
-    Partition* _partitions;
+    // Balance scalability of intent locks against potential added cost of conflicting locks.
+    // The exact value doesn't appear very important, but should be power of two
+    static const unsigned _numPartitions = 32;
+    Partition _partitions[_numPartitions];
 };
 
 
@@ -361,6 +361,10 @@ struct LockRequest {
     // granted immediately. This effectively turns off fairness.
     bool compatibleFirst;
 
+    // Whether the request is on behalf of a background operation, which requests of other
+    // operations may overtake on the conflict queue. Default is FALSE.
+    bool background;
+
     // When set, an attempt is made to execute this request using partitioned lockheads.
     // This speeds up the common case where all requested locking modes are compatible with
     // each other, at the cost of extra overhead for conflicting modes.
@@ -381,6 +385,9 @@ struct LockRequest {
     // this pointer hanging around.
     LockHead* lock;
 
+    // Index of the partition which the request uses while it is partitioned.
+    unsigned partitionIndex;
+
     // Pointer to the partitioned lock to which this request belongs, or null if it is not
     // partitioned. Only one of 'lock' and 'partitionedLock' is non-NULL, and a request can
     // only transition from 'partitionedLock' to 'lock', never the other way around.
@@ -403,6 +410,10 @@ struct LockRequest {
     // This value is different from MODE_NONE only if a conversion is requested for a lock and
     // that conversion cannot be immediately granted.
     LockMode convertMode;
+
+    // How many requests, which came after this background request, have gone ahead of it while
+    // it was waiting.
+    unsigned overtakenCount;
 };
 
 /**
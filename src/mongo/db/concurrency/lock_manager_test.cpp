@@ -28,6 +28,7 @@
 
 #include "mongo/db/concurrency/lock_manager_test_help.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -649,6 +650,92 @@ TEST(LockManager, EnqueueAtFront) {
     ASSERT(lockMgr.unlock(&requestLow));
 }
 
+TEST(LockManager, BackgroundRequestsAreOvertaken) {
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl lockerIX;
+    LockRequestCombo requestIX(&lockerIX);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIX, MODE_IX));
+
+    MMAPV1LockerImpl lockerBackground;
+    LockRequestCombo requestBackground(&lockerBackground);
+    requestBackground.background = true;
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestBackground, MODE_X));
+
+    // An IS request goes ahead of the waiting background X request, which would otherwise make
+    // it wait, and is granted because it is compatible with the IX request
+    MMAPV1LockerImpl lockerIS;
+    LockRequestCombo requestIS(&lockerIS);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestIS, MODE_IS));
+
+    // An S request goes ahead of it too, but waits for the IX request to be unlocked
+    MMAPV1LockerImpl lockerS;
+    LockRequestCombo requestS(&lockerS);
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestS, MODE_S));
+
+    ASSERT(lockMgr.unlock(&requestIX));
+    ASSERT(requestS.lastResId == resId);
+    ASSERT(requestS.lastResult == LOCK_OK);
+    ASSERT(requestBackground.numNotifies == 0);
+
+    ASSERT(lockMgr.unlock(&requestIS));
+    ASSERT(lockMgr.unlock(&requestS));
+    ASSERT(requestBackground.lastResId == resId);
+    ASSERT(requestBackground.lastResult == LOCK_OK);
+
+    // This avoids the lock manager asserting on leaked locks
+    ASSERT(lockMgr.unlock(&requestBackground));
+}
+
+TEST(LockManager, BackgroundRequestsAreOvertakenALimitedNumberOfTimes) {
+    const int maxOvertakesBefore = internalLockMaxBackgroundRequestOvertakes;
+    ON_BLOCK_EXIT([&] { internalLockMaxBackgroundRequestOvertakes = maxOvertakesBefore; });
+    internalLockMaxBackgroundRequestOvertakes = 1;
+
+    LockManager lockMgr;
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    MMAPV1LockerImpl lockerX;
+    LockRequestCombo requestX(&lockerX);
+
+    ASSERT(LOCK_OK == lockMgr.lock(resId, &requestX, MODE_X));
+
+    MMAPV1LockerImpl lockerBackground;
+    LockRequestCombo requestBackground(&lockerBackground);
+    requestBackground.background = true;
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestBackground, MODE_X));
+
+    // The first request goes ahead of the background request, the second one does not
+    MMAPV1LockerImpl lockerFirst;
+    LockRequestCombo requestFirst(&lockerFirst);
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestFirst, MODE_X));
+
+    MMAPV1LockerImpl lockerSecond;
+    LockRequestCombo requestSecond(&lockerSecond);
+
+    ASSERT(LOCK_WAITING == lockMgr.lock(resId, &requestSecond, MODE_X));
+
+    ASSERT(lockMgr.unlock(&requestX));
+    ASSERT(requestFirst.lastResult == LOCK_OK);
+
+    ASSERT(lockMgr.unlock(&requestFirst));
+    ASSERT(requestBackground.lastResult == LOCK_OK);
+    ASSERT(requestSecond.numNotifies == 0);
+
+    ASSERT(lockMgr.unlock(&requestBackground));
+    ASSERT(requestSecond.lastResult == LOCK_OK);
+
+    // This avoids the lock manager asserting on leaked locks
+    ASSERT(lockMgr.unlock(&requestSecond));
+}
+
 TEST(LockManager, CompatibleFirstImmediateGrant) {
     LockManager lockMgr;
     const ResourceId resId(RESOURCE_GLOBAL, 0);
@@ -75,6 +75,22 @@ public:
         }
     }
 
+    void insert_before(LockRequest* before, LockRequest* request) {
+        // Sanity check that we do not reuse entries without cleaning them up
+        invariant(request->next == NULL);
+        invariant(request->prev == NULL);
+
+        if (before == _front) {
+            push_front(request);
+        } else {
+            request->prev = before->prev;
+            request->next = before;
+
+            before->prev->next = request;
+            before->prev = request;
+        }
+    }
+
     void remove(LockRequest* request) {
         if (request->prev != NULL) {
             request->prev->next = request->next;
@@ -34,6 +34,7 @@
 
 #include <vector>
 
+#include "mongo/db/concurrency/lock_contention_profiler.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/platform/compiler.h"
@@ -490,6 +491,17 @@ ResourceId LockerImpl<IsForMMAPV1>::getWaitingResource() const {
     return ResourceId();
 }
 
+template <bool IsForMMAPV1>
+bool LockerImpl<IsForMMAPV1>::hasLockWaiters() const {
+    // Only this locker's own thread changes _requests, so reading it here needs no _lock.
+    for (LockRequestsMap::ConstIterator it = _requests.begin(); !it.finished(); it.next()) {
+        if (it->status == LockRequest::STATUS_GRANTED && globalLockManager.hasWaiters(it.key())) {
+            return true;
+        }
+    }
+    return false;
+}
+
 template <bool IsForMMAPV1>
 void LockerImpl<IsForMMAPV1>::getLockerInfo(LockerInfo* lockerInfo) const {
     invariant(lockerInfo);
@@ -640,6 +652,8 @@ LockResult LockerImpl<IsForMMAPV1>::lockBegin(ResourceId resId, LockMode mode) {
         };
     }
 
+    request->background = _backgroundOperation;
+
     // The notification object must be cleared before we invoke the lock manager, because
     // otherwise we might reset state if the lock becomes granted very fast.
     _notify.clear();
@@ -652,6 +666,12 @@ LockResult LockerImpl<IsForMMAPV1>::lockBegin(ResourceId resId, LockMode mode) {
         _requestStartTime = curTimeMicros64();
         globalStats.recordWait(_id, resId, mode);
         _stats.recordWait(resId, mode);
+
+        _profilingWait = lockContentionProfiling;
+        if (_profilingWait) {
+            _waitHolderOpIds = globalLockManager.getConflictingHolderOpIds(
+                resId, mode, this, LockContentionProfiler::kMaxHolderOpIds);
+        }
     }
 
     return result;
@@ -717,6 +737,17 @@ LockResult LockerImpl<IsForMMAPV1>::lockComplete(ResourceId resId,
         }
     }
 
+    if (_profilingWait) {
+        LockContentionProfiler::get().recordWait(resId,
+                                                 mode,
+                                                 curTimeMicros64() - _requestStartTime,
+                                                 result == LOCK_OK,
+                                                 _opId,
+                                                 std::move(_waitHolderOpIds));
+        _profilingWait = false;
+        _waitHolderOpIds.clear();
+    }
+
     // Cleanup the state, since this is an unused lock now
     if (result != LOCK_OK) {
         LockRequestsMap::Iterator it = _requests.find(resId);
@@ -29,6 +29,7 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
 #include "mongo/db/concurrency/fast_map_noalloc.h"
 #include "mongo/db/concurrency/locker.h"
@@ -248,10 +249,33 @@ public:
         return _batchWriter;
     }
 
+    virtual void setIsBackgroundOperation(bool newValue) {
+        _backgroundOperation = newValue;
+    }
+    virtual bool isBackgroundOperation() const {
+        return _backgroundOperation;
+    }
+
+    virtual void setOpId(unsigned opId) {
+        _opId = opId;
+    }
+    virtual unsigned getOpId() const {
+        return _opId;
+    }
+
     virtual bool hasStrongLocks() const;
 
+    virtual bool hasLockWaiters() const;
+
 private:
     bool _batchWriter;
+    bool _backgroundOperation = false;
+    unsigned _opId = 0;
+
+    // The operations which held the resource being waited for in a conflicting mode when the
+    // wait started, if lockContentionProfiling was on then.
+    bool _profilingWait = false;
+    std::vector<unsigned> _waitHolderOpIds;
 };
 
 typedef LockerImpl<false> DefaultLockerImpl;
@@ -99,6 +99,35 @@ TEST(LockerImpl, ConflictWithTimeout) {
     ASSERT(locker2.unlockAll());
 }
 
+TEST(LockerImpl, HasLockWaiters) {
+    const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
+
+    DefaultLockerImpl locker1;
+    ASSERT(LOCK_OK == locker1.lockGlobal(MODE_IX));
+    ASSERT(LOCK_OK == locker1.lock(resId, MODE_IX));
+
+    DefaultLockerImpl locker2;
+    ASSERT(LOCK_OK == locker2.lockGlobal(MODE_IX));
+    ASSERT(LOCK_OK == locker2.lock(resId, MODE_IX));
+    ASSERT_FALSE(locker1.hasLockWaiters());
+
+    DefaultLockerImpl locker3;
+    ASSERT(LOCK_OK == locker3.lockGlobal(MODE_IX));
+    ASSERT(LOCK_WAITING == locker3.lockBegin(resId, MODE_X));
+    ASSERT_TRUE(locker1.hasLockWaiters());
+    ASSERT_TRUE(locker2.hasLockWaiters());
+
+    // The waiter itself only waits; nobody waits for the locks it holds.
+    ASSERT_FALSE(locker3.hasLockWaiters());
+
+    ASSERT(locker3.unlock(resId));
+    ASSERT_FALSE(locker1.hasLockWaiters());
+
+    ASSERT(locker1.unlockAll());
+    ASSERT(locker2.unlockAll());
+    ASSERT(locker3.unlockAll());
+}
+
 TEST(LockerImpl, ConflictUpgradeWithTimeout) {
     const ResourceId resId(RESOURCE_COLLECTION, std::string("TestDB.collection"));
 
@@ -284,12 +284,34 @@ public:
     virtual void setIsBatchWriter(bool newValue) = 0;
     virtual bool isBatchWriter() const = 0;
 
+    /**
+     * Background operations, such as TTL deletes, range deletions and index builds on a thread of
+     * their own, give way to the other operations: their lock requests may be overtaken by the
+     * requests of other operations which come after them, up to
+     * internalLockMaxBackgroundRequestOvertakes times each, and storage engines may admit fewer
+     * of them at a time.
+     */
+    virtual void setIsBackgroundOperation(bool newValue) = 0;
+    virtual bool isBackgroundOperation() const = 0;
+
+    /**
+     * The id of the operation which uses this locker, which reports of lock contention refer to.
+     */
+    virtual void setOpId(unsigned opId) = 0;
+    virtual unsigned getOpId() const = 0;
+
     /**
      * A string lock is MODE_X or MODE_S.
      * These are incompatible with other locks and therefore are strong.
      */
     virtual bool hasStrongLocks() const = 0;
 
+    /**
+     * Returns whether some other locker is queued behind a lock this one has been granted, which
+     * is what releasing the locks at a yield would let it have.
+     */
+    virtual bool hasLockWaiters() const = 0;
+
 protected:
     Locker() {}
 };
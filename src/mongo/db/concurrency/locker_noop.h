@@ -164,9 +164,25 @@ public:
         invariant(false);
     }
 
+    virtual void setIsBackgroundOperation(bool newValue) {}
+
+    virtual void setOpId(unsigned opId) {}
+
+    virtual unsigned getOpId() const {
+        return 0;
+    }
+
+    virtual bool isBackgroundOperation() const {
+        return false;
+    }
+
     virtual bool hasStrongLocks() const {
         return false;
     }
+
+    virtual bool hasLockWaiters() const {
+        return false;
+    }
 };
 
 }  // namespace mongo
@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/concurrency/record_conflict_queue.h"
+
+#include <algorithm>
+#include <functional>
+
+namespace mongo {
+
+RecordConflictQueue::Turn::Turn(RecordConflictQueue* queue,
+                                StringData ns,
+                                const RecordId& loc,
+                                Milliseconds maxWait)
+    : _queue(queue), _key(ns.toString(), loc), _isHead(false) {
+    Partition& partition = _queue->_partitionFor(_key);
+    stdx::unique_lock<stdx::mutex> lk(partition.mutex);
+    auto& waiters = partition.queues[_key];
+    waiters.push_back(this);
+    _isHead = partition.headChanged.wait_for(
+        lk, maxWait, [&] { return waiters.front() == this; });
+}
+
+RecordConflictQueue::Turn::~Turn() {
+    Partition& partition = _queue->_partitionFor(_key);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.queues.find(_key);
+    auto& waiters = it->second;
+    const bool wasFront = waiters.front() == this;
+    waiters.erase(std::find(waiters.begin(), waiters.end(), this));
+    if (waiters.empty()) {
+        partition.queues.erase(it);
+    } else if (wasFront) {
+        partition.headChanged.notify_all();
+    }
+}
+
+RecordConflictQueue* RecordConflictQueue::get() {
+    static RecordConflictQueue* queue = new RecordConflictQueue();
+    return queue;
+}
+
+size_t RecordConflictQueue::numQueued(StringData ns, const RecordId& loc) {
+    const Key key(ns.toString(), loc);
+    Partition& partition = _partitionFor(key);
+    stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+    auto it = partition.queues.find(key);
+    return it == partition.queues.end() ? 0 : it->second.size();
+}
+
+RecordConflictQueue::Partition& RecordConflictQueue::_partitionFor(const Key& key) {
+    const size_t hash = std::hash<std::string>()(key.first) ^ RecordId::Hasher()(key.second);
+    return _partitions[hash % kNumPartitions];
+}
+
+}  // namespace mongo
@@ -0,0 +1,113 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <list>
+#include <map>
+#include <string>
+#include <utility>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/db/record_id.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * Orders the writers which retry after a WriteConflictException on the same record, so that a
+ * hot document is updated by one retrying writer at a time, in the order they conflicted,
+ * rather than by all of them at once conflicting again.
+ *
+ * The wait for a turn is bounded, because a writer holds its locks while queued. A writer
+ * which times out proceeds anyway and relies on the write conflict backoff.
+ */
+class RecordConflictQueue {
+    MONGO_DISALLOW_COPYING(RecordConflictQueue);
+
+public:
+    /**
+     * A writer's place in the queue of one record. Constructing it waits up to 'maxWait' for
+     * the writers queued ahead of it. The writer keeps its place, at the head once it gets
+     * there, until the Turn is destroyed, which should be when its write commits or it stops
+     * retrying.
+     */
+    class Turn {
+        MONGO_DISALLOW_COPYING(Turn);
+
+    public:
+        Turn(RecordConflictQueue* queue, StringData ns, const RecordId& loc, Milliseconds maxWait);
+        ~Turn();
+
+        /**
+         * Returns true if the writers ahead of this one had finished before the wait timed out.
+         */
+        bool isHead() const {
+            return _isHead;
+        }
+
+    private:
+        RecordConflictQueue* const _queue;
+        const std::pair<std::string, RecordId> _key;
+        bool _isHead;
+    };
+
+    RecordConflictQueue() = default;
+
+    /**
+     * Returns the queue shared by all writers of this process.
+     */
+    static RecordConflictQueue* get();
+
+    /**
+     * Returns the number of writers queued on 'loc' in 'ns'.
+     */
+    size_t numQueued(StringData ns, const RecordId& loc);
+
+private:
+    using Key = std::pair<std::string, RecordId>;
+
+    // Writers are spread over partitions by record, so that unrelated records do not share a
+    // mutex.
+    static const size_t kNumPartitions = 16;
+
+    struct Partition {
+        stdx::mutex mutex;
+        stdx::condition_variable headChanged;
+        std::map<Key, std::list<const Turn*>> queues;
+    };
+
+    Partition& _partitionFor(const Key& key);
+
+    Partition _partitions[kNumPartitions];
+};
+
+}  // namespace mongo
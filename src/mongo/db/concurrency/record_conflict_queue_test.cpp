@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <memory>
+
+#include "mongo/db/concurrency/record_conflict_queue.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(RecordConflictQueueTest, FirstWriterIsHead) {
+    RecordConflictQueue queue;
+    RecordConflictQueue::Turn turn(&queue, "test.coll", RecordId(1), Milliseconds(0));
+    ASSERT_TRUE(turn.isHead());
+    ASSERT_EQUALS(1U, queue.numQueued("test.coll", RecordId(1)));
+    ASSERT_EQUALS(0U, queue.numQueued("test.coll", RecordId(2)));
+    ASSERT_EQUALS(0U, queue.numQueued("test.other", RecordId(1)));
+}
+
+TEST(RecordConflictQueueTest, WaitForTheWriterAheadIsBounded) {
+    RecordConflictQueue queue;
+    RecordConflictQueue::Turn first(&queue, "test.coll", RecordId(1), Milliseconds(0));
+    RecordConflictQueue::Turn second(&queue, "test.coll", RecordId(1), Milliseconds(10));
+    ASSERT_FALSE(second.isHead());
+    ASSERT_EQUALS(2U, queue.numQueued("test.coll", RecordId(1)));
+}
+
+TEST(RecordConflictQueueTest, NextWriterBecomesHeadWhenTheHeadFinishes) {
+    RecordConflictQueue queue;
+    std::unique_ptr<RecordConflictQueue::Turn> first(
+        new RecordConflictQueue::Turn(&queue, "test.coll", RecordId(1), Milliseconds(0)));
+
+    bool secondWasHead = false;
+    stdx::thread waiter([&] {
+        RecordConflictQueue::Turn second(&queue, "test.coll", RecordId(1), Milliseconds(60000));
+        secondWasHead = second.isHead();
+    });
+
+    while (queue.numQueued("test.coll", RecordId(1)) < 2) {
+        stdx::this_thread::yield();
+    }
+    first.reset();
+    waiter.join();
+
+    ASSERT_TRUE(secondWasHead);
+    ASSERT_EQUALS(0U, queue.numQueued("test.coll", RecordId(1)));
+}
+
+}  // namespace
+}  // namespace mongo
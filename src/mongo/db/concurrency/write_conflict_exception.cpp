@@ -31,12 +31,32 @@
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kWrite
 
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include <algorithm>
+
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/util/log.h"
 #include "mongo/util/stacktrace.h"
 
 namespace mongo {
 
+namespace {
+
+AtomicUInt64 jitterState;
+
+/**
+ * Returns a pseudo-random number for spreading out retries. Uses splitmix64 over a shared
+ * counter, so that concurrent callers get different values without taking a lock.
+ */
+unsigned long long nextJitter() {
+    unsigned long long z = jitterState.fetchAndAdd(0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+}  // namespace
+
 bool WriteConflictException::trace = false;
 
 WriteConflictException::WriteConflictException()
@@ -50,16 +70,14 @@ void WriteConflictException::logAndBackoff(int attempt, StringData operation, St
     LOG(1) << "Caught WriteConflictException doing " << operation << " on " << ns
            << ", attempt: " << attempt << " retrying";
 
-    // All numbers below chosen by guess and check against a few random benchmarks.
+    // The first few retries are immediate. After that the sleep doubles with each attempt, up
+    // to 10ms, and is drawn at random from the upper half of that bound so that writers which
+    // conflicted together do not all retry together again.
     if (attempt < 4) {
-        // no-op
-    } else if (attempt < 10) {
-        sleepmillis(1);
-    } else if (attempt < 100) {
-        sleepmillis(5);
-    } else {
-        sleepmillis(10);
+        return;
     }
+    const unsigned long long maxMicros = std::min(10000ULL, 250ULL << std::min(attempt - 4, 6));
+    sleepmicros(maxMicros / 2 + nextJitter() % (maxMicros / 2 + 1));
 }
 
 namespace {
@@ -68,8 +68,8 @@ public:
     WriteConflictException();
 
     /**
-     * Will log a message if sensible and will do an exponential backoff to make sure
-     * we don't hammer the same doc over and over.
+     * Will log a message if sensible and will do an exponential backoff, with jitter, to make
+     * sure we don't hammer the same doc over and over.
      * @param attempt - what attempt is this, 1 based
      * @param operation - e.g. "update"
      */
@@ -32,6 +32,12 @@
 
 #include "mongo/db/curop.h"
 
+#if defined(__linux__)
+#include <pthread.h>
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/client.h"
@@ -162,6 +168,9 @@ CurOp::CurOp(OperationContext* opCtx, CurOpStack* stack) : _stack(stack) {
     _isCommand = false;
     _dbprofile = 0;
     _end = 0;
+    _startCpuMicros = -1;
+    _startDiskReadBytes = -1;
+    _startMajorPageFaults = -1;
     _maxTimeMicros = 0;
     _maxTimeTracker.reset();
     _message = "";
@@ -202,10 +211,51 @@ void CurOp::setNS_inlock(StringData ns) {
     _ns = ns.toString();
 }
 
+namespace {
+
+/**
+ * Gets the CPU time consumed by the calling thread, the bytes it read from disk and its major
+ * page faults so far. Sets them to -1 where the platform cannot measure them.
+ */
+void getThreadResourceUsage(long long* cpuMicros,
+                            long long* diskReadBytes,
+                            long long* majorPageFaults) {
+    *cpuMicros = -1;
+    *diskReadBytes = -1;
+    *majorPageFaults = -1;
+#if defined(__linux__)
+    // The thread CPU clock is precise, whereas getrusage only counts CPU time in scheduler ticks.
+    struct timespec cpuTime;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpuTime) == 0) {
+        *cpuMicros = cpuTime.tv_sec * 1000 * 1000LL + cpuTime.tv_nsec / 1000;
+    }
+
+    struct rusage usage;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        // ru_inblock counts 512 byte blocks.
+        *diskReadBytes = usage.ru_inblock * 512LL;
+        *majorPageFaults = usage.ru_majflt;
+    }
+#endif
+}
+
+long long resourceDelta(long long start, long long end) {
+    return start >= 0 && end >= start ? end - start : -1;
+}
+
+}  // namespace
+
 void CurOp::ensureStarted() {
     if (_start == 0) {
         _start = curTimeMicros64();
 
+        getThreadResourceUsage(&_startCpuMicros, &_startDiskReadBytes, &_startMajorPageFaults);
+#if defined(__linux__)
+        if (pthread_getcpuclockid(pthread_self(), &_cpuClock) != 0) {
+            _startCpuMicros = -1;
+        }
+#endif
+
         // If ensureStarted() is invoked after setMaxTimeMicros(), then time limit tracking will
         // start here.  This is because time limit tracking can only commence after the
         // operation is assigned a start time.
@@ -225,10 +275,33 @@ void CurOp::raiseDbProfileLevel(int dbProfileLevel) {
     _dbprofile = std::max(dbProfileLevel, _dbprofile);
 }
 
+void CurOp::done() {
+    _end = curTimeMicros64();
+
+    // The operation ran on this thread since it started, so the growth of the thread's resource
+    // usage is what the operation consumed.
+    long long cpuMicros;
+    long long diskReadBytes;
+    long long majorPageFaults;
+    getThreadResourceUsage(&cpuMicros, &diskReadBytes, &majorPageFaults);
+    _debug.cpuMicros = resourceDelta(_startCpuMicros, cpuMicros);
+    _debug.diskReadBytes = resourceDelta(_startDiskReadBytes, diskReadBytes);
+    _debug.majorPageFaults = resourceDelta(_startMajorPageFaults, majorPageFaults);
+}
+
 void CurOp::reportState(BSONObjBuilder* builder) {
     if (_start) {
         builder->append("secs_running", elapsedSeconds());
         builder->append("microsecs_running", static_cast<long long int>(elapsedMicros()));
+
+#if defined(__linux__)
+        // Another thread reports the operation, so read the clock of the thread running it.
+        struct timespec cpuTime;
+        if (_startCpuMicros >= 0 && clock_gettime(_cpuClock, &cpuTime) == 0) {
+            const long long cpuMicros = cpuTime.tv_sec * 1000 * 1000LL + cpuTime.tv_nsec / 1000;
+            builder->append("cpuMicros_running", resourceDelta(_startCpuMicros, cpuMicros));
+        }
+#endif
     }
 
     const char* opName;
@@ -406,6 +479,10 @@ void OpDebug::reset() {
     cursorExhausted = false;
     keyUpdates = 0;  // unsigned, so -1 not possible
     writeConflicts = 0;
+    spilledBytes = -1;
+    cpuMicros = -1;
+    diskReadBytes = -1;
+    majorPageFaults = -1;
     planSummary = "";
     execStats.reset();
 
@@ -490,6 +567,10 @@ string OpDebug::report(const CurOp& curop, const SingleThreadedLockStats& lockSt
     OPDEBUG_TOSTRING_HELP_BOOL(cursorExhausted);
     OPDEBUG_TOSTRING_HELP(keyUpdates);
     OPDEBUG_TOSTRING_HELP(writeConflicts);
+    OPDEBUG_TOSTRING_HELP(spilledBytes);
+    OPDEBUG_TOSTRING_HELP(cpuMicros);
+    OPDEBUG_TOSTRING_HELP(diskReadBytes);
+    OPDEBUG_TOSTRING_HELP(majorPageFaults);
 
     if (!exceptionInfo.empty()) {
         s << " exception: " << exceptionInfo.msg;
@@ -688,6 +769,10 @@ void OpDebug::append(const CurOp& curop,
     OPDEBUG_APPEND_BOOL(cursorExhausted);
     OPDEBUG_APPEND_NUMBER(keyUpdates);
     OPDEBUG_APPEND_NUMBER(writeConflicts);
+    OPDEBUG_APPEND_NUMBER(spilledBytes);
+    OPDEBUG_APPEND_NUMBER(cpuMicros);
+    OPDEBUG_APPEND_NUMBER(diskReadBytes);
+    OPDEBUG_APPEND_NUMBER(majorPageFaults);
     b.appendNumber("numYield", curop.numYields());
 
     {
@@ -31,6 +31,8 @@
 
 #pragma once
 
+#include <ctime>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/server_options.h"
@@ -176,6 +178,13 @@ public:
     bool cursorExhausted;  // true if the cursor has been closed at end a find/getMore operation
     int keyUpdates;
     long long writeConflicts;
+    long long spilledBytes;  // written to temporary files by external sorts
+
+    // Resources consumed by the thread running the operation, as reported by the OS. -1 where the
+    // platform cannot measure them.
+    long long cpuMicros;        // CPU time, user and system
+    long long diskReadBytes;    // read from disk rather than from the page cache
+    long long majorPageFaults;  // page faults which had to wait for the disk
     ThreadSafeString planSummary;  // a brief std::string describing the query solution
 
     // New Query Framework debugging/profiling info
@@ -371,9 +380,7 @@ public:
         ensureStarted();
         return _start;
     }
-    void done() {
-        _end = curTimeMicros64();
-    }
+    void done();
 
     long long totalTimeMicros() {
         massert(12601, "CurOp not marked done yet", _end);
@@ -477,6 +484,17 @@ private:
     Command* _command;
     long long _start;
     long long _end;
+
+    // Thread resource usage when the operation started, so that done() can compute the
+    // resources consumed by the operation into _debug.
+    long long _startCpuMicros;
+    long long _startDiskReadBytes;
+    long long _startMajorPageFaults;
+#if defined(__linux__)
+    // The CPU time clock of the thread running the operation, which currentOp reads.
+    clockid_t _cpuClock;
+#endif
+
     int _op;
     bool _isCommand;
     int _dbprofile;  // 0=off, 1=slow, 2=all
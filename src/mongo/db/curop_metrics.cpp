@@ -26,10 +26,20 @@
  *    it in the license file.
  */
 
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/curop_metrics.h"
+
 #include "mongo/base/counter.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 namespace {
@@ -52,6 +62,7 @@ Counter64 idhackCounter;
 Counter64 scanAndOrderCounter;
 Counter64 fastmodCounter;
 Counter64 writeConflictsCounter;
+Counter64 spilledBytesCounter;
 
 ServerStatusMetricField<Counter64> displayIdhack("operation.idhack", &idhackCounter);
 ServerStatusMetricField<Counter64> displayScanAndOrder("operation.scanAndOrder",
@@ -59,6 +70,27 @@ ServerStatusMetricField<Counter64> displayScanAndOrder("operation.scanAndOrder",
 ServerStatusMetricField<Counter64> displayFastMod("operation.fastmod", &fastmodCounter);
 ServerStatusMetricField<Counter64> displayWriteConflicts("operation.writeConflicts",
                                                          &writeConflictsCounter);
+ServerStatusMetricField<Counter64> displaySpilledBytes("operation.spilledBytes",
+                                                       &spilledBytesCounter);
+
+// Maximum number of slow operations logged per second for each log component; 0 is unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(slowOpLogRateLimit, int, 0);
+
+Counter64 slowOpsNotLoggedCounter;
+ServerStatusMetricField<Counter64> displaySlowOpsNotLogged("log.slowOpsNotLogged",
+                                                           &slowOpsNotLoggedCounter);
+
+/**
+ * The slow operations of one log component during the current second.  Racing threads may reset
+ * the window more than once when the second changes, which only lets a few more lines through.
+ */
+struct SlowOpLogWindow {
+    AtomicInt64 second;
+    AtomicInt32 logged;
+    AtomicInt64 notLogged;
+};
+
+SlowOpLogWindow slowOpLogWindows[logger::LogComponent::kNumLogComponents];
 
 }  // namespace
 
@@ -85,6 +117,35 @@ void recordCurOpMetrics(OperationContext* opCtx) {
         fastmodCounter.increment();
     if (debug.writeConflicts)
         writeConflictsCounter.increment(debug.writeConflicts);
+    if (debug.spilledBytes > 0)
+        spilledBytesCounter.increment(debug.spilledBytes);
+}
+
+bool shouldLogSlowOp(logger::LogComponent component) {
+    const int limit = slowOpLogRateLimit;
+    if (limit <= 0) {
+        return true;
+    }
+
+    SlowOpLogWindow& window = slowOpLogWindows[component];
+    const long long now = static_cast<long long>(curTimeMillis64() / 1000);
+    const long long second = window.second.load();
+    if (second != now && window.second.compareAndSwap(second, now) == second) {
+        window.logged.store(0);
+    }
+
+    if (window.logged.addAndFetch(1) > limit) {
+        window.notLogged.addAndFetch(1);
+        slowOpsNotLoggedCounter.increment();
+        return false;
+    }
+
+    const long long notLogged = window.notLogged.swap(0);
+    if (notLogged > 0) {
+        MONGO_LOG_COMPONENT(0, component)
+            << notLogged << " slow operations were not logged because of slowOpLogRateLimit";
+    }
+    return true;
 }
 
 }  // namespace mongo
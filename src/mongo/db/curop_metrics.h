@@ -28,10 +28,19 @@
 
 #pragma once
 
+#include "mongo/logger/log_component.h"
+
 namespace mongo {
 
 class OperationContext;
 
 void recordCurOpMetrics(OperationContext* opCtx);
 
+/**
+ * Returns whether a slow operation may be logged under "component" without exceeding the
+ * slowOpLogRateLimit lines per second for that component.  Operations which may not be logged are
+ * counted, and their number is logged ahead of the next slow operation of the component.
+ */
+bool shouldLogSlowOp(logger::LogComponent component);
+
 }  // namespace mongo
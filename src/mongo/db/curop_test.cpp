@@ -98,6 +98,30 @@ TEST(TimeHasExpired, NegSimple) {
     ASSERT_FALSE(curOp.maxTimeHasExpired());
 }
 
+#if defined(__linux__)
+// An operation which burns CPU reports the CPU time it consumed, and not the time it slept.
+TEST(CurOpResourceUsage, CpuMicros) {
+    auto service = stdx::make_unique<ServiceContextNoop>();
+    auto client = service->makeClient("CurOpTest");
+    OperationContextNoop txn(client.get(), 100);
+    CurOp curOp(&txn);
+    curOp.ensureStarted();
+
+    volatile unsigned long long x = 0;
+    const long long start = curTimeMicros64();
+    while (curTimeMicros64() - start < intervalShort) {
+        x = x + 1;
+    }
+    sleepmicros(intervalLong);
+
+    curOp.done();
+    ASSERT_GREATER_THAN_OR_EQUALS(curOp.debug().cpuMicros, intervalShort / 2);
+    ASSERT_LESS_THAN(curOp.debug().cpuMicros, intervalLong);
+    ASSERT_GREATER_THAN_OR_EQUALS(curOp.debug().diskReadBytes, 0);
+    ASSERT_GREATER_THAN_OR_EQUALS(curOp.debug().majorPageFaults, 0);
+}
+#endif
+
 }  // namespace
 
 }  // namespace mongo
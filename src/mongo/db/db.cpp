@@ -93,11 +93,14 @@
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
 #include "mongo/db/storage_options.h"
+#include "mongo/db/traffic_recorder.h"
 #include "mongo/db/ttl.h"
 #include "mongo/executor/network_interface_factory.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/platform/process_id.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/cmdline_utils/censor_cmdline.h"
@@ -149,6 +152,9 @@ ntservice::NtServiceDefaultStrings defaultServiceStrings = {
 
 Timer startupSrandTimer;
 
+// Number of threads which open and check databases at startup.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(startupDatabaseRecoveryThreads, int, 4);
+
 class MyMessageHandler : public MessageHandler {
 public:
     virtual void connected(AbstractMessagingPort* p) {
@@ -162,6 +168,11 @@ public:
                 break;
             }
 
+            TrafficRecorder& trafficRecorder = TrafficRecorder::get();
+            if (trafficRecorder.isRecording()) {
+                trafficRecorder.observeRequest(port->connectionId(), m);
+            }
+
             DbResponse dbresponse;
             {
                 OperationContextImpl txn;
@@ -172,6 +183,9 @@ public:
 
             if (dbresponse.response) {
                 port->reply(m, *dbresponse.response, dbresponse.responseTo);
+                if (trafficRecorder.isRecording()) {
+                    trafficRecorder.observeReply(port->connectionId(), *dbresponse.response);
+                }
                 if (dbresponse.exhaustNS.size() > 0) {
                     MsgData::View header = dbresponse.response->header();
                     QueryResult::View qr = header.view2ptr();
@@ -293,101 +307,168 @@ static unsigned long long checkIfReplMissingFromCommandLine(OperationContext* tx
     return 0;
 }
 
-static void repairDatabasesAndCheckVersion() {
-    LOG(1) << "enter repairDatabases (to check pdfile version #)" << endl;
+/**
+ * Opens the database and checks that its files and indexes can be used by this version. Returns
+ * false if the database needs an upgrade in the middle.
+ */
+static bool recoverDatabase(OperationContext* txn,
+                            const string& dbName,
+                            bool shouldClearNonLocalTmpCollections) {
+    LOG(1) << "    Recovering database: " << dbName << endl;
 
-    OperationContextImpl txn;
-    ScopedTransaction transaction(&txn, MODE_X);
-    Lock::GlobalWrite lk(txn.lockState());
+    const repl::ReplSettings& replSettings = repl::getGlobalReplicationCoordinator()->getSettings();
 
-    vector<string> dbNames;
+    Database* db = dbHolder().openDb(txn, dbName);
+    invariant(db);
+
+    // First thing after opening the database is to check for file compatibility,
+    // otherwise we might crash if this is a deprecated format.
+    if (!db->getDatabaseCatalogEntry()->currentFilesCompatible(txn)) {
+        return false;
+    }
+
+    // Major versions match, check indexes
+    const string systemIndexes = db->name() + ".system.indexes";
+
+    Collection* coll = db->getCollection(systemIndexes);
+    unique_ptr<PlanExecutor> exec(
+        InternalPlanner::collectionScan(txn, systemIndexes, coll, PlanExecutor::YIELD_MANUAL));
+
+    BSONObj index;
+    PlanExecutor::ExecState state;
+    while (PlanExecutor::ADVANCED == (state = exec->getNext(&index, NULL))) {
+        const BSONObj key = index.getObjectField("key");
+        const string plugin = IndexNames::findPluginName(key);
 
-    StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
-    storageEngine->listDatabases(&dbNames);
+        if (db->getDatabaseCatalogEntry()->isOlderThan24(txn)) {
+            if (IndexNames::existedBefore24(plugin)) {
+                continue;
+            }
 
-    // Repair all databases first, so that we do not try to open them if they are in bad shape
-    if (storageGlobalParams.repair) {
-        for (vector<string>::const_iterator i = dbNames.begin(); i != dbNames.end(); ++i) {
-            const string dbName = *i;
-            LOG(1) << "    Repairing database: " << dbName << endl;
+            log() << "Index " << index << " claims to be of type '" << plugin << "', "
+                  << "which is either invalid or did not exist before v2.4. "
+                  << "See the upgrade section: "
+                  << "http://dochub.mongodb.org/core/upgrade-2.4" << startupWarningsLog;
+        }
 
-            fassert(18506, repairDatabase(&txn, storageEngine, dbName));
+        const Status keyStatus = validateKeyPattern(key);
+        if (!keyStatus.isOK()) {
+            log() << "Problem with index " << index << ": " << keyStatus.reason()
+                  << " This index can still be used however it cannot be rebuilt."
+                  << " For more info see"
+                  << " http://dochub.mongodb.org/core/index-validation" << startupWarningsLog;
         }
     }
 
-    const repl::ReplSettings& replSettings = repl::getGlobalReplicationCoordinator()->getSettings();
+    if (PlanExecutor::IS_EOF != state) {
+        warning() << "Internal error while reading collection " << systemIndexes;
+    }
 
-    // On replica set members we only clear temp collections on DBs other than "local" during
-    // promotion to primary. On pure slaves, they are only cleared when the oplog tells them
-    // to. The local DB is special because it is not replicated.  See SERVER-10927 for more
-    // details.
-    const bool shouldClearNonLocalTmpCollections =
-        !(checkIfReplMissingFromCommandLine(&txn) || replSettings.usingReplSets() ||
-          replSettings.slave == repl::SimpleSlave);
-
-    for (vector<string>::const_iterator i = dbNames.begin(); i != dbNames.end(); ++i) {
-        const string dbName = *i;
-        LOG(1) << "    Recovering database: " << dbName << endl;
-
-        Database* db = dbHolder().openDb(&txn, dbName);
-        invariant(db);
-
-        // First thing after opening the database is to check for file compatibility,
-        // otherwise we might crash if this is a deprecated format.
-        if (!db->getDatabaseCatalogEntry()->currentFilesCompatible(&txn)) {
-            log() << "****";
-            log() << "cannot do this upgrade without an upgrade in the middle";
-            log() << "please do a --repair with 2.6 and then start this version";
-            dbexit(EXIT_NEED_UPGRADE);
-            return;
-        }
+    if (replSettings.usingReplSets()) {
+        // We only care about the _id index if we are in a replset
+        checkForIdIndexes(txn, db);
+    }
 
-        // Major versions match, check indexes
-        const string systemIndexes = db->name() + ".system.indexes";
+    if (shouldClearNonLocalTmpCollections || dbName == "local") {
+        db->clearTmpCollections(txn);
+    }
 
-        Collection* coll = db->getCollection(systemIndexes);
-        unique_ptr<PlanExecutor> exec(
-            InternalPlanner::collectionScan(&txn, systemIndexes, coll, PlanExecutor::YIELD_MANUAL));
+    return true;
+}
 
-        BSONObj index;
-        PlanExecutor::ExecState state;
-        while (PlanExecutor::ADVANCED == (state = exec->getNext(&index, NULL))) {
-            const BSONObj key = index.getObjectField("key");
-            const string plugin = IndexNames::findPluginName(key);
+static void repairDatabasesAndCheckVersion() {
+    LOG(1) << "enter repairDatabases (to check pdfile version #)" << endl;
 
-            if (db->getDatabaseCatalogEntry()->isOlderThan24(&txn)) {
-                if (IndexNames::existedBefore24(plugin)) {
-                    continue;
-                }
+    vector<string> dbNames;
+    bool shouldClearNonLocalTmpCollections;
+    {
+        Timer timer;
+        OperationContextImpl txn;
+        ScopedTransaction transaction(&txn, MODE_X);
+        Lock::GlobalWrite lk(txn.lockState());
 
-                log() << "Index " << index << " claims to be of type '" << plugin << "', "
-                      << "which is either invalid or did not exist before v2.4. "
-                      << "See the upgrade section: "
-                      << "http://dochub.mongodb.org/core/upgrade-2.4" << startupWarningsLog;
-            }
+        StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
+        storageEngine->listDatabases(&dbNames);
+
+        // Repair all databases first, so that we do not try to open them if they are in bad shape
+        if (storageGlobalParams.repair) {
+            for (vector<string>::const_iterator i = dbNames.begin(); i != dbNames.end(); ++i) {
+                const string dbName = *i;
+                LOG(1) << "    Repairing database: " << dbName << endl;
 
-            const Status keyStatus = validateKeyPattern(key);
-            if (!keyStatus.isOK()) {
-                log() << "Problem with index " << index << ": " << keyStatus.reason()
-                      << " This index can still be used however it cannot be rebuilt."
-                      << " For more info see"
-                      << " http://dochub.mongodb.org/core/index-validation" << startupWarningsLog;
+                fassert(18506, repairDatabase(&txn, storageEngine, dbName));
             }
+            log() << "repaired " << dbNames.size() << " databases in " << timer.millis() << "ms";
         }
 
-        if (PlanExecutor::IS_EOF != state) {
-            warning() << "Internal error while reading collection " << systemIndexes;
-        }
+        const repl::ReplSettings& replSettings =
+            repl::getGlobalReplicationCoordinator()->getSettings();
 
-        if (replSettings.usingReplSets()) {
-            // We only care about the _id index if we are in a replset
-            checkForIdIndexes(&txn, db);
-        }
+        // On replica set members we only clear temp collections on DBs other than "local" during
+        // promotion to primary. On pure slaves, they are only cleared when the oplog tells them
+        // to. The local DB is special because it is not replicated.  See SERVER-10927 for more
+        // details.
+        shouldClearNonLocalTmpCollections =
+            !(checkIfReplMissingFromCommandLine(&txn) || replSettings.usingReplSets() ||
+              replSettings.slave == repl::SimpleSlave);
+    }
 
-        if (shouldClearNonLocalTmpCollections || dbName == "local") {
-            db->clearTmpCollections(&txn);
+    // Databases are opened and checked concurrently, each under its own exclusive lock, as they
+    // would be when first used.
+    Timer timer;
+    const size_t numThreads = std::min(
+        dbNames.size(), static_cast<size_t>(std::max(1, startupDatabaseRecoveryThreads)));
+    AtomicWord<unsigned long long> nextDb(0);
+    AtomicWord<bool> needsUpgrade(false);
+    stdx::mutex errorMutex;
+    Status error = Status::OK();
+
+    auto recoverDatabases = [&] {
+        try {
+            for (size_t i = nextDb.fetchAndAdd(1); i < dbNames.size(); i = nextDb.fetchAndAdd(1)) {
+                OperationContextImpl txn;
+                ScopedTransaction transaction(&txn, MODE_IX);
+                Lock::DBLock lk(txn.lockState(), dbNames[i], MODE_X);
+                if (!recoverDatabase(&txn, dbNames[i], shouldClearNonLocalTmpCollections)) {
+                    needsUpgrade.store(true);
+                    break;
+                }
+            }
+        } catch (const DBException& ex) {
+            stdx::lock_guard<stdx::mutex> lk(errorMutex);
+            if (error.isOK()) {
+                error = ex.toStatus();
+            }
         }
+    };
+
+    if (numThreads <= 1) {
+        recoverDatabases();
+    } else {
+        vector<stdx::thread> threads;
+        for (size_t i = 0; i < numThreads; i++) {
+            threads.emplace_back([&, i] {
+                const std::string name = str::stream() << "initandlisten-recovery-" << i;
+                Client::initThread(name.c_str());
+                recoverDatabases();
+            });
+        }
+        for (auto&& thread : threads) {
+            thread.join();
+        }
+    }
+
+    if (needsUpgrade.load()) {
+        log() << "****";
+        log() << "cannot do this upgrade without an upgrade in the middle";
+        log() << "please do a --repair with 2.6 and then start this version";
+        dbexit(EXIT_NEED_UPGRADE);
+        return;
     }
+    uassertStatusOK(error);
+
+    log() << "opened " << dbNames.size() << " databases in " << timer.millis() << "ms using "
+          << std::max(numThreads, size_t(1)) << " threads";
 
     LOG(1) << "done repairDatabases" << endl;
 }
@@ -749,6 +830,9 @@ MONGO_INITIALIZER_WITH_PREREQUISITES(CreateReplicationManager,
     repl::TopologyCoordinatorImpl::Options topoCoordOptions;
     topoCoordOptions.maxSyncSourceLagSecs = Seconds(repl::maxSyncSourceLagSecs);
     topoCoordOptions.configServerMode = serverGlobalParams.configsvrMode;
+    topoCoordOptions.maxHeartbeatJitter = Milliseconds(repl::replHeartbeatJitterMillis);
+    topoCoordOptions.nonVoterHeartbeatInterval =
+        Milliseconds(repl::replNonVoterHeartbeatIntervalMillis);
     // TODO(SERVER-19739):  Rather than checking if the storage engine name is "wiredTiger"
     // we should be asking the global storage engine whether it supports readCommitted,
     // however at this point in mongod startup the storage engine has not yet been
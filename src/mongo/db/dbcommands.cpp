@@ -86,6 +86,7 @@
 #include "mongo/db/s/operation_shard_version.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/cpu_sampler.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/rpc/request_interface.h"
 #include "mongo/rpc/reply_builder_interface.h"
@@ -1184,6 +1185,12 @@ void Command::execCommand(OperationContext* txn,
         std::string dbname = request.getDatabase().toString();
         unique_ptr<MaintenanceModeSetter> mmSetter;
 
+        BSONElement cmdTarget = request.getCommandArgs().firstElement();
+        CpuSampler::ScopedTag cpuSamplerTag(
+            command->name,
+            dbname,
+            cmdTarget.type() == String ? cmdTarget.valueStringData() : StringData());
+
         if (isHelpRequest(request)) {
             CurOp::get(txn)->ensureStarted();
             generateHelpResponse(txn, request, replyBuilder, *command);
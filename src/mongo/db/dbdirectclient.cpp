@@ -34,6 +34,7 @@
 #include "mongo/db/commands.h"
 #include "mongo/db/instance.h"
 #include "mongo/db/lasterror.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/util/log.h"
 
@@ -150,6 +151,50 @@ unique_ptr<DBClientCursor> DBDirectClient::query(const string& ns,
         ns, query, nToReturn, nToSkip, fieldsToReturn, queryOptions, batchSize);
 }
 
+BSONObj DBDirectClient::findOne(const string& ns,
+                                const Query& query,
+                                const BSONObj* fieldsToReturn,
+                                int queryOptions) {
+    const NamespaceString nss(ns);
+    if (nss.isCommand() || nss.isSpecialCommand() || query.isExplain()) {
+        return DBClientBase::findOne(ns, query, fieldsToReturn, queryOptions);
+    }
+
+    DirectClientScope directClientScope(_txn);
+    LastError::get(_txn->getClient()).startRequest();
+
+    CurOp curOp(_txn);
+    return directFindOne(
+        _txn, nss, query.obj, fieldsToReturn ? *fieldsToReturn : BSONObj(), queryOptions);
+}
+
+void DBDirectClient::insert(const string& ns, BSONObj obj, int flags) {
+    insert(ns, std::vector<BSONObj>{obj}, flags);
+}
+
+void DBDirectClient::insert(const string& ns, const std::vector<BSONObj>& v, int flags) {
+    const NamespaceString nss(ns);
+    if (nss.isSystemDotIndexes()) {
+        DBClientBase::insert(ns, v, flags);
+        return;
+    }
+
+    DirectClientScope directClientScope(_txn);
+    LastError::get(_txn->getClient()).startRequest();
+
+    CurOp curOp(_txn);
+    std::vector<BSONObj> docs(v);
+    directInsert(_txn, nss, docs, flags & InsertOption_ContinueOnError);
+}
+
+void DBDirectClient::update(const string& ns, Query query, BSONObj obj, int flags) {
+    DirectClientScope directClientScope(_txn);
+    LastError::get(_txn->getClient()).startRequest();
+
+    CurOp curOp(_txn);
+    directUpdate(_txn, NamespaceString(ns), query.obj, obj, flags & ~WriteOption_FromWriteback);
+}
+
 const HostAndPort DBDirectClient::dummyHost("0.0.0.0", 0);
 
 unsigned long long DBDirectClient::count(
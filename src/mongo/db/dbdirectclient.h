@@ -53,7 +53,9 @@ public:
 
     DBDirectClient(OperationContext* txn);
 
+    using DBClientBase::insert;
     using DBClientBase::query;
+    using DBClientBase::update;
 
     // XXX: is this valid or useful?
     void setOpCtx(OperationContext* txn);
@@ -66,6 +68,22 @@ public:
                                                   int queryOptions = 0,
                                                   int batchSize = 0);
 
+    /**
+     * The following run in-process without encoding the operation into a Message or decoding a
+     * reply. Queries on command namespaces, explains and inserts into system.indexes still go
+     * through the wire protocol path.
+     */
+    virtual BSONObj findOne(const std::string& ns,
+                            const Query& query,
+                            const BSONObj* fieldsToReturn = 0,
+                            int queryOptions = 0);
+
+    virtual void insert(const std::string& ns, BSONObj obj, int flags = 0);
+
+    virtual void insert(const std::string& ns, const std::vector<BSONObj>& v, int flags = 0);
+
+    virtual void update(const std::string& ns, Query query, BSONObj obj, int flags);
+
     virtual bool isFailed() const;
 
     virtual bool isStillConnected();
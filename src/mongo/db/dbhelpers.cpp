@@ -56,6 +56,7 @@
 #include "mongo/db/range_arithmetic.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/db/write_concern.h"
 #include "mongo/db/write_concern_options.h"
@@ -77,6 +78,12 @@ using std::stringstream;
 
 using logger::LogComponent;
 
+// Number of documents which Helpers::removeRange deletes in a single unit of work.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchSize, int, 128);
+
+// Milliseconds for which Helpers::removeRange pauses between two batches of deletes.
+MONGO_EXPORT_SERVER_PARAMETER(rangeDeleterBatchDelayMS, int, 0);
+
 void Helpers::ensureIndex(OperationContext* txn,
                           Collection* collection,
                           BSONObj keyPattern,
@@ -337,6 +344,8 @@ long long Helpers::removeRange(OperationContext* txn,
     Milliseconds millisWaitingForReplication{0};
 
     while (1) {
+        bool lastBatch = false;
+
         // Scoping for write lock.
         {
             OldClientWriteContext ctx(txn, ns);
@@ -357,61 +366,37 @@ long long Helpers::removeRange(OperationContext* txn,
                                            PlanExecutor::YIELD_MANUAL,
                                            InternalPlanner::FORWARD,
                                            InternalPlanner::IXSCAN_FETCH));
-            exec->setYieldPolicy(PlanExecutor::YIELD_AUTO);
-
-            RecordId rloc;
-            BSONObj obj;
-            PlanExecutor::ExecState state;
-            // This may yield so we cannot touch nsd after this.
-            state = exec->getNext(&obj, &rloc);
-            if (PlanExecutor::IS_EOF == state) {
-                break;
-            }
-
-            if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
-                const std::unique_ptr<PlanStageStats> stats(exec->getStats());
-                warning(LogComponent::kSharding)
-                    << PlanExecutor::statestr(state) << " - cursor error while trying to delete "
-                    << min << " to " << max << " in " << ns << ": "
-                    << WorkingSetCommon::toStatusString(obj)
-                    << ", stats: " << Explain::statsToBSON(*stats) << endl;
-                break;
-            }
-
-            verify(PlanExecutor::ADVANCED == state);
-
-            WriteUnitOfWork wuow(txn);
 
-            if (onlyRemoveOrphanedDocs) {
-                // Do a final check in the write lock to make absolutely sure that our
-                // collection hasn't been modified in a way that invalidates our migration
-                // cleanup.
-
-                // We should never be able to turn off the sharding state once enabled, but
-                // in the future we might want to.
-                verify(ShardingState::get(getGlobalServiceContext())->enabled());
-
-                bool docIsOrphan;
-
-                // In write lock, so will be the most up-to-date version
-                std::shared_ptr<CollectionMetadata> metadataNow =
-                    ShardingState::get(getGlobalServiceContext())->getCollectionMetadata(ns);
-                if (metadataNow) {
-                    ShardKeyPattern kp(metadataNow->getKeyPattern());
-                    BSONObj key = kp.extractShardKeyFromDoc(obj);
-                    docIsOrphan =
-                        !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
-                } else {
-                    docIsOrphan = false;
+            // Collect the next batch of documents in the range. The executor doesn't yield, so
+            // the documents can't go away before they are deleted below under the same lock.
+            const int batchSize = std::max(1, rangeDeleterBatchSize);
+            std::vector<std::pair<RecordId, BSONObj>> batch;
+            while (static_cast<int>(batch.size()) < batchSize) {
+                RecordId rloc;
+                BSONObj obj;
+                PlanExecutor::ExecState state = exec->getNext(&obj, &rloc);
+                if (PlanExecutor::IS_EOF == state) {
+                    lastBatch = true;
+                    break;
                 }
 
-                if (!docIsOrphan) {
+                if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+                    const std::unique_ptr<PlanStageStats> stats(exec->getStats());
                     warning(LogComponent::kSharding)
-                        << "aborting migration cleanup for chunk " << min << " to " << max
-                        << (metadataNow ? (string) " at document " + obj.toString() : "")
-                        << ", collection " << ns << " has changed " << endl;
+                        << PlanExecutor::statestr(state)
+                        << " - cursor error while trying to delete " << min << " to " << max
+                        << " in " << ns << ": " << WorkingSetCommon::toStatusString(obj)
+                        << ", stats: " << Explain::statsToBSON(*stats) << endl;
+                    lastBatch = true;
                     break;
                 }
+
+                verify(PlanExecutor::ADVANCED == state);
+                batch.emplace_back(rloc, obj.getOwned());
+            }
+
+            if (batch.empty()) {
+                break;
             }
 
             NamespaceString nss(ns);
@@ -422,13 +407,58 @@ long long Helpers::removeRange(OperationContext* txn,
                 return numDeleted;
             }
 
-            if (callback)
-                callback->goingToDelete(obj);
+            // In write lock, so will be the most up-to-date version
+            std::shared_ptr<CollectionMetadata> metadataNow;
+            if (onlyRemoveOrphanedDocs) {
+                // We should never be able to turn off the sharding state once enabled, but
+                // in the future we might want to.
+                verify(ShardingState::get(getGlobalServiceContext())->enabled());
+
+                metadataNow =
+                    ShardingState::get(getGlobalServiceContext())->getCollectionMetadata(ns);
+            }
+
+            // The whole batch is deleted in one unit of work.
+            WriteUnitOfWork wuow(txn);
+            long long numDeletedInBatch = 0;
+
+            for (const auto& doc : batch) {
+                const BSONObj& obj = doc.second;
+
+                if (onlyRemoveOrphanedDocs) {
+                    // Do a final check in the write lock to make absolutely sure that our
+                    // collection hasn't been modified in a way that invalidates our migration
+                    // cleanup.
+                    bool docIsOrphan;
+                    if (metadataNow) {
+                        ShardKeyPattern kp(metadataNow->getKeyPattern());
+                        BSONObj key = kp.extractShardKeyFromDoc(obj);
+                        docIsOrphan =
+                            !metadataNow->keyBelongsToMe(key) && !metadataNow->keyIsPending(key);
+                    } else {
+                        docIsOrphan = false;
+                    }
+
+                    if (!docIsOrphan) {
+                        warning(LogComponent::kSharding)
+                            << "aborting migration cleanup for chunk " << min << " to " << max
+                            << (metadataNow ? (string) " at document " + obj.toString() : "")
+                            << ", collection " << ns << " has changed " << endl;
+                        lastBatch = true;
+                        break;
+                    }
+                }
+
+                if (callback)
+                    callback->goingToDelete(obj);
+
+                BSONObj deletedId;
+                collection->deleteDocument(txn, doc.first, false, false, &deletedId);
+                numDeletedInBatch++;
+            }
 
-            BSONObj deletedId;
-            collection->deleteDocument(txn, rloc, false, false, &deletedId);
             wuow.commit();
-            numDeleted++;
+            numDeleted += numDeletedInBatch;
         }
 
         // TODO remove once the yielding below that references this timer has been removed
@@ -448,6 +478,16 @@ long long Helpers::removeRange(OperationContext* txn,
             }
             millisWaitingForReplication += replStatus.duration;
         }
+
+        if (lastBatch) {
+            break;
+        }
+
+        // Throttle the deletes to leave the shard's I/O and cache to its regular workload.
+        const int batchDelayMillis = rangeDeleterBatchDelayMS;
+        if (batchDelayMillis > 0) {
+            sleepmillis(batchDelayMillis);
+        }
     }
 
     if (writeConcern.shouldWaitForOtherNodes())
@@ -58,6 +58,20 @@ AndHashStage::AndHashStage(OperationContext* opCtx, WorkingSet* ws, const Collec
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
+      _mode(Mode::kMergeMembers),
+      _hashingChildren(true),
+      _currentChild(0),
+      _memUsage(0),
+      _maxMemUsage(kDefaultMaxMemUsageBytes) {}
+
+AndHashStage::AndHashStage(OperationContext* opCtx,
+                           WorkingSet* ws,
+                           const Collection* collection,
+                           Mode mode)
+    : PlanStage(kStageType, opCtx),
+      _collection(collection),
+      _ws(ws),
+      _mode(mode),
       _hashingChildren(true),
       _currentChild(0),
       _memUsage(0),
@@ -70,6 +84,7 @@ AndHashStage::AndHashStage(OperationContext* opCtx,
     : PlanStage(kStageType, opCtx),
       _collection(collection),
       _ws(ws),
+      _mode(Mode::kMergeMembers),
       _hashingChildren(true),
       _currentChild(0),
       _memUsage(0),
@@ -83,6 +98,15 @@ size_t AndHashStage::getMemUsage() const {
     return _memUsage;
 }
 
+bool AndHashStage::intersectionEmpty() const {
+    return Mode::kRecordIdsOnly == _mode ? _recordIds.empty() : _dataMap.empty();
+}
+
+void AndHashStage::clearIntersection() {
+    _dataMap.clear();
+    _recordIds.clear();
+}
+
 bool AndHashStage::isEOF() {
     // This is empty before calling work() and not-empty after.
     if (_lookAheadResults.empty()) {
@@ -97,7 +121,7 @@ bool AndHashStage::isEOF() {
     // Or we're streaming in results from the last child.
 
     // If there's nothing to probe against, we're EOF.
-    if (_dataMap.empty()) {
+    if (intersectionEmpty()) {
         return true;
     }
 
@@ -142,7 +166,7 @@ PlanStage::StageState AndHashStage::work(WorkingSetID* out) {
                 if (PlanStage::IS_EOF == childStatus) {
                     // A child went right to EOF.  Bail out.
                     _hashingChildren = false;
-                    _dataMap.clear();
+                    clearIntersection();
                     return PlanStage::IS_EOF;
                 } else if (PlanStage::ADVANCED == childStatus) {
                     // Ensure that the BSONObj underlying the WorkingSetMember is owned in case we
@@ -165,7 +189,7 @@ PlanStage::StageState AndHashStage::work(WorkingSetID* out) {
                     }
 
                     _hashingChildren = false;
-                    _dataMap.clear();
+                    clearIntersection();
                     return childStatus;
                 }
                 // We ignore NEED_TIME. TODO: what do we want to do if we get NEED_YIELD here?
@@ -208,7 +232,7 @@ PlanStage::StageState AndHashStage::work(WorkingSetID* out) {
     // hash map.
 
     // We should be EOF if we're not hashing results and the dataMap is empty.
-    verify(!_dataMap.empty());
+    verify(!intersectionEmpty());
 
     // We probe _dataMap with the last child.
     verify(_currentChild == _children.size() - 1);
@@ -229,6 +253,21 @@ PlanStage::StageState AndHashStage::work(WorkingSetID* out) {
         return PlanStage::NEED_TIME;
     }
 
+    if (Mode::kRecordIdsOnly == _mode) {
+        // The parent only needs the RecordId, so the child's output is returned as it is.  Each
+        // RecordId is returned at most once, as with _dataMap.
+        if (!_recordIds.contains(member->loc)) {
+            _ws->free(*out);
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
+        _recordIds.remove(member->loc);
+        _memUsage = _recordIds.getMemUsage();
+        ++_commonStats.advanced;
+        return PlanStage::ADVANCED;
+    }
+
     DataMap::iterator it = _dataMap.find(member->loc);
     if (_dataMap.end() == it) {
         // Child's output wasn't in every previous child.  Throw it out.
@@ -276,6 +315,16 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
             return PlanStage::NEED_TIME;
         }
 
+        if (Mode::kRecordIdsOnly == _mode) {
+            // Nothing but the RecordId is kept.  A newer copy of a doc seen in a more recent
+            // snapshot adds nothing.
+            _recordIds.add(member->loc);
+            _ws->free(id);
+            _memUsage = _recordIds.getMemUsage();
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
         if (!_dataMap.insert(std::make_pair(member->loc, id)).second) {
             // Didn't insert because we already had this loc inside the map. This should only
             // happen if we're seeing a newer copy of the same doc in a more recent snapshot.
@@ -298,13 +347,14 @@ PlanStage::StageState AndHashStage::readFirstChild(WorkingSetID* out) {
         _currentChild = 1;
 
         // If our first child was empty, don't scan any others, no possible results.
-        if (_dataMap.empty()) {
+        if (intersectionEmpty()) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
 
         ++_commonStats.needTime;
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+        _specificStats.mapAfterChild.push_back(Mode::kRecordIdsOnly == _mode ? _recordIds.size()
+                                                                              : _dataMap.size());
 
         return PlanStage::NEED_TIME;
     } else if (PlanStage::FAILURE == childStatus || PlanStage::DEAD == childStatus) {
@@ -348,7 +398,12 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         }
 
         verify(member->hasLoc());
-        if (_dataMap.end() == _dataMap.find(member->loc)) {
+        if (Mode::kRecordIdsOnly == _mode) {
+            if (_recordIds.contains(member->loc)) {
+                _seenRecordIds.add(member->loc);
+                _memUsage = _recordIds.getMemUsage() + _seenRecordIds.getMemUsage();
+            }
+        } else if (_dataMap.end() == _dataMap.find(member->loc)) {
             // Ignore.  It's not in any previous child.
         } else {
             // We have a hit.  Copy data into the WSM we already have.
@@ -369,32 +424,40 @@ PlanStage::StageState AndHashStage::hashOtherChildren(WorkingSetID* out) {
         // Finished with a child.
         ++_currentChild;
 
-        // Keep elements of _dataMap that are in _seenMap.
-        DataMap::iterator it = _dataMap.begin();
-        while (it != _dataMap.end()) {
-            if (_seenMap.end() == _seenMap.find(it->first)) {
-                DataMap::iterator toErase = it;
-                ++it;
-
-                // Update memory stats.
-                WorkingSetMember* member = _ws->get(toErase->second);
-                _memUsage -= member->getMemUsage();
-
-                _ws->free(toErase->second);
-                _dataMap.erase(toErase);
-            } else {
-                ++it;
+        if (Mode::kRecordIdsOnly == _mode) {
+            // Everything in _seenRecordIds was also in _recordIds, so it is the intersection.
+            std::swap(_recordIds, _seenRecordIds);
+            _seenRecordIds.clear();
+            _memUsage = _recordIds.getMemUsage();
+            _specificStats.mapAfterChild.push_back(_recordIds.size());
+        } else {
+            // Keep elements of _dataMap that are in _seenMap.
+            DataMap::iterator it = _dataMap.begin();
+            while (it != _dataMap.end()) {
+                if (_seenMap.end() == _seenMap.find(it->first)) {
+                    DataMap::iterator toErase = it;
+                    ++it;
+
+                    // Update memory stats.
+                    WorkingSetMember* member = _ws->get(toErase->second);
+                    _memUsage -= member->getMemUsage();
+
+                    _ws->free(toErase->second);
+                    _dataMap.erase(toErase);
+                } else {
+                    ++it;
+                }
             }
-        }
 
-        _specificStats.mapAfterChild.push_back(_dataMap.size());
+            _specificStats.mapAfterChild.push_back(_dataMap.size());
 
-        _seenMap.clear();
+            _seenMap.clear();
+        }
 
         // _dataMap is now the intersection of the first _currentChild nodes.
 
         // If we have nothing to AND with after finishing any child, stop.
-        if (_dataMap.empty()) {
+        if (intersectionEmpty()) {
             _hashingChildren = false;
             return PlanStage::IS_EOF;
         }
@@ -455,6 +518,26 @@ void AndHashStage::doInvalidate(OperationContext* txn, const RecordId& dl, Inval
     // If it's a mutation the predicates implied by the AND-ing may no longer be true.
     //
     // So, we flag and try to pick it up later.
+    if (Mode::kRecordIdsOnly == _mode) {
+        _seenRecordIds.remove(dl);
+        if (_recordIds.remove(dl)) {
+            if (_hashingChildren) {
+                ++_specificStats.flaggedInProgress;
+            } else {
+                ++_specificStats.flaggedButPassed;
+            }
+            _memUsage = _recordIds.getMemUsage() + _seenRecordIds.getMemUsage();
+
+            // There is no buffered member for the loc, so make one to fetch it into.
+            WorkingSetID id = _ws->allocate();
+            WorkingSetMember* member = _ws->get(id);
+            member->loc = dl;
+            WorkingSetCommon::fetchAndInvalidateLoc(txn, member, _collection);
+            _ws->flagForReview(id);
+        }
+        return;
+    }
+
     DataMap::iterator it = _dataMap.find(dl);
     if (_dataMap.end() != it) {
         WorkingSetID id = it->second;
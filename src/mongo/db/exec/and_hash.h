@@ -32,6 +32,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/exec/record_id_bitmap.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
 #include "mongo/platform/unordered_set.h"
@@ -48,11 +49,28 @@ namespace mongo {
  * is fetched and added to the WorkingSet as "flagged for further review."  Because this stage
  * operates with RecordIds, we are unable to evaluate the AND for the invalidated RecordId, and it
  * must be fully matched later.
+ *
+ * When the parent fetches the intersected documents and needs none of the children's key data,
+ * the stage can be built in RecordIdsOnly mode.  It then keeps only the RecordIds of the
+ * children it has read, in a RecordIdBitmap rather than a hash table of WorkingSetMembers, and
+ * returns the last child's WorkingSetMembers as they are.
  */
 class AndHashStage final : public PlanStage {
 public:
+    enum class Mode {
+        // Buffer and merge the WorkingSetMembers of every child.
+        kMergeMembers,
+        // Buffer only the RecordIds of all but the last child.
+        kRecordIdsOnly,
+    };
+
     AndHashStage(OperationContext* opCtx, WorkingSet* ws, const Collection* collection);
 
+    AndHashStage(OperationContext* opCtx,
+                 WorkingSet* ws,
+                 const Collection* collection,
+                 Mode mode);
+
     /**
      * For testing only. Allows tests to set memory usage threshold.
      */
@@ -91,6 +109,13 @@ private:
     StageState hashOtherChildren(WorkingSetID* out);
     StageState workChild(size_t childNo, WorkingSetID* out);
 
+    /**
+     * Returns true if nothing is left of the intersection of the children read so far.
+     */
+    bool intersectionEmpty() const;
+
+    void clearIntersection();
+
     // Not owned by us.
     const Collection* _collection;
 
@@ -112,6 +137,11 @@ private:
     typedef unordered_set<RecordId, RecordId::Hasher> SeenMap;
     SeenMap _seenMap;
 
+    // Take the place of _dataMap and _seenMap in RecordIdsOnly mode.
+    const Mode _mode;
+    RecordIdBitmap _recordIds;
+    RecordIdBitmap _seenRecordIds;
+
     // True if we're still intersecting _children[0..._children.size()-1].
     bool _hashingChildren;
 
@@ -122,7 +152,8 @@ private:
     AndHashStats _specificStats;
 
     // The usage in bytes of all buffered data that we're holding.
-    // Memory usage is calculated from keys held in _dataMap only.
+    // Memory usage is calculated from keys held in _dataMap, or from the size of _recordIds and
+    // _seenRecordIds, only.
     // For simplicity, results in _lookAheadResults do not count towards the limit.
     size_t _memUsage;
 
@@ -32,16 +32,19 @@
 
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/exec/collection_scan_common.h"
-#include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/storage/record_fetcher.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 #include "mongo/db/client.h"  // XXX-ERH
 
@@ -54,6 +57,27 @@ using stdx::make_unique;
 // static
 const char* CollectionScan::kStageType = "COLLSCAN";
 
+namespace {
+
+// Bounds on how many records are read ahead when the filter is evaluated in parallel.
+const size_t kMinBatchSize = 64;
+const size_t kMaxBatchSize = 4096;
+const size_t kMaxBatchBytes = 16 * 1024 * 1024;
+
+// Batches are only split across threads when each thread gets at least this many records, since
+// starting a thread costs about as much as matching a few hundred small documents.
+const size_t kMinRecordsPerThread = 256;
+
+size_t filterThreadsFor(const CollectionScanParams& params, const MatchExpression* filter) {
+    const int threads = internalQueryExecCollScanFilterThreads;
+    if (threads <= 0 || !filter || params.tailable || !supportsDocLocking()) {
+        return 0;
+    }
+    return static_cast<size_t>(threads);
+}
+
+}  // namespace
+
 CollectionScan::CollectionScan(OperationContext* txn,
                                const CollectionScanParams& params,
                                WorkingSet* workingSet,
@@ -63,9 +87,16 @@ CollectionScan::CollectionScan(OperationContext* txn,
       _filter(filter),
       _params(params),
       _isDead(false),
-      _wsidForFetch(_workingSet->allocate()) {
+      _wsidForFetch(_workingSet->allocate()),
+      _filterThreads(canMatchInParallel(filter) ? filterThreadsFor(params, filter) : 0),
+      _nextBatchSize(kMinBatchSize),
+      _cursorExhausted(false) {
     // Explain reports the direction of the collection scan.
     _specificStats.direction = params.direction;
+
+    if (_filter) {
+        _compiledFilter = make_unique<CompiledMatchExpression>(_filter);
+    }
 }
 
 PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
@@ -84,7 +115,8 @@ PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
         return PlanStage::DEAD;
     }
 
-    if ((0 != _params.maxScan) && (_specificStats.docsTested >= _params.maxScan)) {
+    if ((0 != _params.maxScan) && (_specificStats.docsTested >= _params.maxScan) &&
+        _buffered.empty()) {
         _commonStats.isEOF = true;
     }
 
@@ -92,6 +124,15 @@ PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
         return PlanStage::IS_EOF;
     }
 
+    if (!_buffered.empty()) {
+        return returnBuffered(out);
+    }
+
+    if (_cursorExhausted) {
+        _commonStats.isEOF = true;
+        return PlanStage::IS_EOF;
+    }
+
     boost::optional<Record> record;
     const bool needToMakeCursor = !_cursor;
     try {
@@ -99,6 +140,12 @@ PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
             const bool forward = _params.direction == CollectionScanParams::FORWARD;
             _cursor = _params.collection->getCursor(getOpCtx(), forward);
 
+            // A scan which reads on to the end of the collection is worth reading ahead of.
+            if (forward && !_params.tailable && 0 == _params.maxScan && _params.start.isNull() &&
+                _lastSeenId.isNull()) {
+                _cursor->enableReadAhead(internalQueryExecCollScanReadAheadBytes);
+            }
+
             if (!_lastSeenId.isNull()) {
                 invariant(_params.tailable);
                 // Seek to where we were last time. If it no longer exists, mark us as dead
@@ -124,19 +171,66 @@ PlanStage::StageState CollectionScan::work(WorkingSetID* out) {
 
         if (_lastSeenId.isNull() && !_params.start.isNull()) {
             record = _cursor->seekExact(_params.start);
-        } else {
-            // See if the record we're about to access is in memory. If not, pass a fetch
-            // request up.
-            if (auto fetcher = _cursor->fetcherForNext()) {
-                // Pass the RecordFetcher up.
-                WorkingSetMember* member = _workingSet->get(_wsidForFetch);
-                member->setFetcher(fetcher.release());
-                *out = _wsidForFetch;
-                _commonStats.needYield++;
+        } else if (_filterThreads) {
+            if (fillBuffer()) {
+                // Return what was read before the conflict once we have yielded.
+                *out = WorkingSet::INVALID_ID;
                 return PlanStage::NEED_YIELD;
             }
 
-            record = _cursor->next();
+            if (!_buffered.empty()) {
+                return returnBuffered(out);
+            }
+
+            if (_cursorExhausted) {
+                _commonStats.isEOF = true;
+                return PlanStage::IS_EOF;
+            }
+
+            _commonStats.needTime++;
+            return PlanStage::NEED_TIME;
+        } else {
+            // Records which fail the filter are skipped here rather than by returning NEED_TIME
+            // up through every ancestor stage and the executor for each of them. The last record
+            // read is handled by returnIfMatches() below.
+            const size_t maxRecords = std::max(1, internalQueryExecCollScanMaxRecordsPerWork);
+            for (size_t examined = 1;; ++examined) {
+                // See if the record we're about to access is in memory. If not, pass a fetch
+                // request up.
+                if (auto fetcher = _cursor->fetcherForNext()) {
+                    // Pass the RecordFetcher up.
+                    WorkingSetMember* member = _workingSet->get(_wsidForFetch);
+                    member->setFetcher(fetcher.release());
+                    *out = _wsidForFetch;
+                    _commonStats.needYield++;
+                    return PlanStage::NEED_YIELD;
+                }
+
+                record = _cursor->next();
+                if (!record || !_filter || examined >= maxRecords ||
+                    ((0 != _params.maxScan) &&
+                     (_specificStats.docsTested + 1 >= _params.maxScan))) {
+                    break;
+                }
+
+                _lastSeenId = record->id;
+                ++_specificStats.docsTested;
+                if (_compiledFilter->matchesBSON(record->data.toBson())) {
+                    WorkingSetID id = _workingSet->allocate();
+                    WorkingSetMember* member = _workingSet->get(id);
+                    member->loc = record->id;
+                    member->obj = {getOpCtx()->recoveryUnit()->getSnapshotId(),
+                                   record->data.releaseToBson()};
+                    _workingSet->transitionToLocAndObj(id);
+                    *out = id;
+                    ++_commonStats.advanced;
+                    return PlanStage::ADVANCED;
+                }
+
+                // Account for the skipped record as if it had taken its own call to work().
+                ++_commonStats.works;
+                ++_commonStats.needTime;
+            }
         }
     } catch (const WriteConflictException& wce) {
         // Leave us in a state to try again next time.
@@ -175,7 +269,7 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
                                                       WorkingSetID* out) {
     ++_specificStats.docsTested;
 
-    if (Filter::passes(member, _filter)) {
+    if (!_compiledFilter || _compiledFilter->matchesBSON(member->obj.value())) {
         *out = memberID;
         ++_commonStats.advanced;
         return PlanStage::ADVANCED;
@@ -186,6 +280,124 @@ PlanStage::StageState CollectionScan::returnIfMatches(WorkingSetMember* member,
     }
 }
 
+// static
+bool CollectionScan::canMatchInParallel(const MatchExpression* expr) {
+    if (!expr) {
+        return true;
+    }
+
+    if (MatchExpression::WHERE == expr->matchType()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < expr->numChildren(); ++i) {
+        if (!canMatchInParallel(expr->getChild(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CollectionScan::fillBuffer() {
+    size_t batchSize = _nextBatchSize;
+    if (0 != _params.maxScan) {
+        batchSize = std::min(batchSize, _params.maxScan - _specificStats.docsTested);
+    }
+
+    // The records are copied out of the cursor since its buffers are only valid until the next
+    // call to next().
+    const SnapshotId snapshotId = getOpCtx()->recoveryUnit()->getSnapshotId();
+    vector<BufferedRecord> batch;
+    batch.reserve(batchSize);
+    size_t batchBytes = 0;
+    bool writeConflict = false;
+    try {
+        while (batch.size() < batchSize && batchBytes < kMaxBatchBytes) {
+            boost::optional<Record> record = _cursor->next();
+            if (!record) {
+                _cursorExhausted = true;
+                break;
+            }
+
+            _lastSeenId = record->id;
+            batchBytes += record->data.size();
+            batch.push_back({record->id, {snapshotId, record->data.releaseToBson().getOwned()}});
+        }
+    } catch (const WriteConflictException& wce) {
+        if (batch.empty()) {
+            throw;
+        }
+        writeConflict = true;
+    }
+
+    // Not a vector<bool>, since each thread writes to its own range of elements.
+    vector<char> matches(batch.size());
+    const auto matchRange = [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            matches[i] = _compiledFilter->matchesBSON(batch[i].obj.value());
+        }
+    };
+
+    const size_t numThreads = std::min(_filterThreads, batch.size() / kMinRecordsPerThread);
+    if (numThreads <= 1) {
+        matchRange(0, batch.size());
+    } else {
+        const size_t perThread = (batch.size() + numThreads - 1) / numThreads;
+        vector<Status> statuses(numThreads, Status::OK());
+        vector<stdx::thread> threads;
+        {
+            ON_BLOCK_EXIT([&] {
+                for (auto&& thread : threads) {
+                    thread.join();
+                }
+            });
+
+            for (size_t t = 1; t < numThreads; ++t) {
+                threads.emplace_back([&, t] {
+                    try {
+                        matchRange(t * perThread, std::min(batch.size(), (t + 1) * perThread));
+                    } catch (...) {
+                        statuses[t] = exceptionToStatus();
+                    }
+                });
+            }
+
+            try {
+                matchRange(0, perThread);
+            } catch (...) {
+                statuses[0] = exceptionToStatus();
+            }
+        }
+
+        for (auto&& status : statuses) {
+            uassertStatusOK(status);
+        }
+    }
+
+    _specificStats.docsTested += batch.size();
+    for (size_t i = 0; i < batch.size(); ++i) {
+        if (matches[i]) {
+            _buffered.push_back(std::move(batch[i]));
+        }
+    }
+
+    _nextBatchSize = std::min(_nextBatchSize * 2, kMaxBatchSize);
+    return writeConflict;
+}
+
+PlanStage::StageState CollectionScan::returnBuffered(WorkingSetID* out) {
+    WorkingSetID id = _workingSet->allocate();
+    WorkingSetMember* member = _workingSet->get(id);
+    member->loc = _buffered.front().id;
+    member->obj = std::move(_buffered.front().obj);
+    _workingSet->transitionToLocAndObj(id);
+    _buffered.pop_front();
+
+    *out = id;
+    ++_commonStats.advanced;
+    return PlanStage::ADVANCED;
+}
+
 bool CollectionScan::isEOF() {
     return _commonStats.isEOF || _isDead;
 }
@@ -199,7 +411,8 @@ void CollectionScan::doInvalidate(OperationContext* txn,
         return;
     }
 
-    // If we're here, 'id' is being deleted.
+    // If we're here, 'id' is being deleted. Records in '_buffered' never need invalidating since
+    // they are only kept on storage engines with document-level locking, which don't invalidate.
 
     // Deletions can harm the underlying RecordCursor so we must pass them down.
     if (_cursor) {
@@ -28,12 +28,16 @@
 
 #pragma once
 
+#include <deque>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/exec/collection_scan_common.h"
 #include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
 #include "mongo/db/matcher/expression.h"
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/snapshot.h"
 
 namespace mongo {
 
@@ -80,12 +84,37 @@ private:
      */
     StageState returnIfMatches(WorkingSetMember* member, WorkingSetID memberID, WorkingSetID* out);
 
+    /**
+     * Returns true if 'expr' can be evaluated against several documents on different threads at
+     * once. $where is excluded since it runs in the operation's JavaScript scope.
+     */
+    static bool canMatchInParallel(const MatchExpression* expr);
+
+    /**
+     * Reads the next batch of records from '_cursor', evaluates '_filter' over the batch on up to
+     * '_filterThreads' threads and appends the matching records to '_buffered'. Sets
+     * '_cursorExhausted' once the cursor returns no more records.
+     *
+     * Returns true if a WriteConflictException was thrown part way through the batch, in which
+     * case the records read before the conflict are still evaluated and buffered.
+     */
+    bool fillBuffer();
+
+    /**
+     * Allocates a working set member for the oldest buffered match, sets *out to its id and
+     * returns ADVANCED.
+     */
+    StageState returnBuffered(WorkingSetID* out);
+
     // WorkingSet is not owned by us.
     WorkingSet* _workingSet;
 
     // The filter is not owned by us.
     const MatchExpression* _filter;
 
+    // '_filter' flattened for matching each document. Null if there is no filter.
+    std::unique_ptr<CompiledMatchExpression> _compiledFilter;
+
     std::unique_ptr<SeekableRecordCursor> _cursor;
 
     CollectionScanParams _params;
@@ -99,6 +128,27 @@ private:
     // should remain in the INVALID state.
     const WorkingSetID _wsidForFetch;
 
+    // When non-zero, documents are read ahead in batches and '_filter' is evaluated over each
+    // batch on up to this many threads. Only enabled for non-tailable scans with a filter on
+    // storage engines with document-level locking, so buffered records are never invalidated.
+    const size_t _filterThreads;
+
+    // How many records the next call to fillBuffer() reads. Starts small so that scans which
+    // stop early (e.g. due to a limit) don't read far ahead, and doubles up to a maximum.
+    size_t _nextBatchSize;
+
+    struct BufferedRecord {
+        RecordId id;
+        Snapshotted<BSONObj> obj;
+    };
+
+    // Records which have passed '_filter' but have not been returned yet, in scan order.
+    std::deque<BufferedRecord> _buffered;
+
+    // Set once '_cursor' has returned EOF while filling '_buffered'. The stage is EOF once the
+    // buffer has also been drained.
+    bool _cursorExhausted;
+
     // Stats
     CollectionScanStats _specificStats;
 };
@@ -58,8 +58,20 @@ CountStage::CountStage(OperationContext* txn,
         _children.emplace_back(child);
 }
 
+CountStage::CountStage(OperationContext* txn,
+                       Collection* collection,
+                       const CountRequest& request,
+                       WorkingSet* ws,
+                       long long nEstimated)
+    : PlanStage(kStageType, txn),
+      _collection(collection),
+      _request(request),
+      _nEstimated(nEstimated),
+      _leftToSkip(request.getSkip()),
+      _ws(ws) {}
+
 bool CountStage::isEOF() {
-    if (_specificStats.trivialCount) {
+    if (_specificStats.trivialCount || _specificStats.approximate) {
         return true;
     }
 
@@ -72,7 +84,12 @@ bool CountStage::isEOF() {
 
 void CountStage::trivialCount() {
     invariant(_collection);
-    long long nCounted = _collection->numRecords(getOpCtx());
+    setCountFromMatching(_collection->numRecords(getOpCtx()));
+    _specificStats.trivialCount = true;
+}
+
+void CountStage::setCountFromMatching(long long nMatching) {
+    long long nCounted = nMatching;
 
     if (0 != _request.getSkip()) {
         nCounted -= _request.getSkip();
@@ -92,7 +109,6 @@ void CountStage::trivialCount() {
 
     _specificStats.nCounted = nCounted;
     _specificStats.nSkipped = _request.getSkip();
-    _specificStats.trivialCount = true;
 }
 
 PlanStage::StageState CountStage::work(WorkingSetID* out) {
@@ -104,6 +120,12 @@ PlanStage::StageState CountStage::work(WorkingSetID* out) {
     // This stage never returns a working set member.
     *out = WorkingSet::INVALID_ID;
 
+    if (_nEstimated) {
+        setCountFromMatching(*_nEstimated);
+        _specificStats.approximate = true;
+        return PlanStage::IS_EOF;
+    }
+
     // If we don't have a query and we have a non-NULL collection, then we can execute this
     // as a trivial count (just ask the collection for how many records it has).
     if (_request.getQuery().isEmpty() && NULL != _collection) {
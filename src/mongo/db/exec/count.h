@@ -53,6 +53,17 @@ public:
                WorkingSet* ws,
                PlanStage* child);
 
+    /**
+     * Constructs a stage which reports 'nEstimated' as the number of documents matching the
+     * request's query, without a child. Used when the request allows the count to be
+     * approximated and the collection has a sample to estimate it from.
+     */
+    CountStage(OperationContext* txn,
+               Collection* collection,
+               const CountRequest& request,
+               WorkingSet* ws,
+               long long nEstimated);
+
     bool isEOF() final;
     StageState work(WorkingSetID* out) final;
 
@@ -73,11 +84,20 @@ private:
      */
     void trivialCount();
 
+    /**
+     * Stores 'nMatching', the number of documents matching the query, as the count after
+     * applying the skip and limit.
+     */
+    void setCountFromMatching(long long nMatching);
+
     // The collection over which we are counting.
     Collection* _collection;
 
     CountRequest _request;
 
+    // Set if the count is estimated rather than counted.
+    boost::optional<long long> _nEstimated;
+
     // The number of documents that we still need to skip.
     long long _leftToSkip;
 
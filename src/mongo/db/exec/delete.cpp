@@ -74,6 +74,11 @@ bool DeleteStage::isEOF() {
     if (!_params.isMulti && _specificStats.docsDeleted > 0) {
         return true;
     }
+    if (_params.limit > 0 &&
+        static_cast<long long>(_specificStats.docsDeleted) >= _params.limit &&
+        _idReturning == WorkingSet::INVALID_ID) {
+        return true;
+    }
     return _idRetrying == WorkingSet::INVALID_ID && _idReturning == WorkingSet::INVALID_ID &&
         child()->isEOF();
 }
@@ -44,6 +44,7 @@ struct DeleteStageParams {
           fromMigrate(false),
           isExplain(false),
           returnDeleted(false),
+          limit(0),
           canonicalQuery(NULL) {}
 
     // Should we delete all documents returned from the child (a "multi delete"), or at most one
@@ -60,6 +61,9 @@ struct DeleteStageParams {
     // Should we return the document we just deleted?
     bool returnDeleted;
 
+    // If positive, a multi delete stops once it has deleted this many documents.
+    long long limit;
+
     // The parsed query predicate for this delete. Not owned here.
     CanonicalQuery* canonicalQuery;
 };
@@ -48,6 +48,7 @@
 #include "mongo/util/log.h"
 
 #include <algorithm>
+#include <cmath>
 
 namespace mongo {
 
@@ -184,14 +185,14 @@ static StatusWith<double> computeGeoNearDistance(const GeoNearParams& nearParams
             // Hack for nearSphere
             // TODO: Remove nearSphere?
             invariant(SPHERE == queryCRS);
-            member->addComputed(new GeoDistanceComputedData(minDistance / kRadiusOfEarthInMeters));
+            member->emplaceComputed<GeoDistanceComputedData>(minDistance / kRadiusOfEarthInMeters);
         } else {
-            member->addComputed(new GeoDistanceComputedData(minDistance));
+            member->emplaceComputed<GeoDistanceComputedData>(minDistance);
         }
     }
 
     if (nearParams.addPointMeta) {
-        member->addComputed(new GeoNearPointComputedData(minDistanceObj));
+        member->emplaceComputed<GeoNearPointComputedData>(minDistanceObj);
     }
 
     return StatusWith<double>(minDistance);
@@ -535,6 +536,39 @@ static double min2DBoundsIncrement(const GeoNearExpression& query, IndexDescript
     return minBoundsIncrement * kMetersPerDegreeAtEquator;
 }
 
+// The number of results each interval of a near search aims for: enough that a search takes few
+// intervals, few enough that the first results of a search come back quickly.
+static const double kTargetResultsPerInterval = 450;
+
+/**
+ * Returns the width of the annulus to search after the one described by 'lastIntervalStats',
+ * which was 'lastIncrement' wide. Assuming the documents around the search center are as dense
+ * as they were in the last annulus, the next one is sized to hold about
+ * kTargetResultsPerInterval results, but it is at most four times and at least half as wide as
+ * the last one, so that a sparse or crowded annulus does not throw the search off too far.
+ */
+static double nextBoundsIncrement(const IntervalStats& lastIntervalStats, double lastIncrement) {
+    const double maxIncrement = lastIncrement * 4;
+    const double minIncrement = lastIncrement / 2;
+    if (lastIntervalStats.numResultsReturned == 0) {
+        return maxIncrement;
+    }
+
+    const double inner = max(0.0, lastIntervalStats.minDistanceAllowed);
+    const double outer = lastIntervalStats.maxDistanceAllowed;
+    // The area of the last annulus, up to a factor of pi which cancels out below.
+    const double area = outer * outer - inner * inner;
+    if (area <= 0) {
+        return lastIncrement;
+    }
+
+    // The next annulus holds the target number of results when its area is the target's share
+    // of the last one's.
+    const double nextArea = area * kTargetResultsPerInterval / lastIntervalStats.numResultsReturned;
+    const double nextOuter = sqrt(outer * outer + nextArea);
+    return min(maxIncrement, max(minIncrement, nextOuter - outer));
+}
+
 static R2Annulus projectBoundsToTwoDDegrees(R2Annulus sphereBounds) {
     const double outerDegrees = rad2deg(sphereBounds.getOuter() / kRadiusOfEarthInMeters);
     const double innerDegrees = rad2deg(sphereBounds.getInner() / kRadiusOfEarthInMeters);
@@ -561,11 +595,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     if (!_specificStats.intervalStats.empty()) {
         const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
 
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = nextBoundsIncrement(lastIntervalStats, _boundsIncrement);
     }
 
     _boundsIncrement =
@@ -948,11 +978,7 @@ StatusWith<NearStage::CoveredInterval*>  //
     if (!_specificStats.intervalStats.empty()) {
         const IntervalStats& lastIntervalStats = _specificStats.intervalStats.back();
 
-        // TODO: Generally we want small numbers of results fast, then larger numbers later
-        if (lastIntervalStats.numResultsReturned < 300)
-            _boundsIncrement *= 2;
-        else if (lastIntervalStats.numResultsReturned > 600)
-            _boundsIncrement /= 2;
+        _boundsIncrement = nextBoundsIncrement(lastIntervalStats, _boundsIncrement);
     }
 
     invariant(_boundsIncrement > 0.0);
@@ -35,9 +35,11 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/filter.h"
 #include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/sort_key_threshold.h"
 #include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
@@ -81,6 +83,7 @@ IndexScan::IndexScan(OperationContext* txn,
     _specificStats.isSparse = _params.descriptor->isSparse();
     _specificStats.isPartial = _params.descriptor->isPartial();
     _specificStats.indexVersion = _params.descriptor->version();
+    _specificStats.estimatedKeysExamined = _params.estimatedKeysExamined;
 }
 
 boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
@@ -91,6 +94,11 @@ boost::optional<IndexKeyEntry> IndexScan::initIndexScan() {
         _shouldDedup = _params.descriptor->isMultikey(getOpCtx());
     }
 
+    // The key of a document with an array in an indexed field need not hold its sort key.
+    if (_sortKeyThreshold && _params.descriptor->isMultikey(getOpCtx())) {
+        _sortKeyThreshold = nullptr;
+    }
+
     // Perform the possibly heavy-duty initialization of the underlying index cursor.
     _indexCursor = _iam->newCursor(getOpCtx(), _forward);
 
@@ -190,6 +198,11 @@ PlanStage::StageState IndexScan::work(WorkingSetID* out) {
 
     _scanState = GETTING_NEXT;
 
+    if (_sortKeyThreshold && _sortKeyThreshold->excludes(getSortKey(kv->key))) {
+        ++_commonStats.needTime;
+        return PlanStage::NEED_TIME;
+    }
+
     if (_shouldDedup) {
         ++_specificStats.dupsTested;
         if (!_returned.insert(kv->loc).second) {
@@ -220,7 +233,7 @@ PlanStage::StageState IndexScan::work(WorkingSetID* out) {
     if (_params.addKeyMetadata) {
         BSONObjBuilder bob;
         bob.appendKeys(_keyPattern, kv->key);
-        member->addComputed(new IndexKeyComputedData(bob.obj()));
+        member->emplaceComputed<IndexKeyComputedData>(bob.obj());
     }
 
     *out = id;
@@ -228,6 +241,50 @@ PlanStage::StageState IndexScan::work(WorkingSetID* out) {
     return PlanStage::ADVANCED;
 }
 
+void IndexScan::setSortKeyThreshold(const SortKeyThreshold* threshold) {
+    // Only btree keys hold the values of the indexed fields.
+    if (_params.descriptor->getAccessMethodName() != IndexNames::BTREE) {
+        return;
+    }
+
+    std::vector<size_t> positions;
+    for (auto&& sortElt : threshold->getSortPattern()) {
+        // A $meta sort key is not in the index.
+        if (!sortElt.isNumber()) {
+            return;
+        }
+
+        size_t position = 0;
+        for (auto&& keyPatternElt : _keyPattern) {
+            if (keyPatternElt.fieldNameStringData() == sortElt.fieldNameStringData()) {
+                break;
+            }
+            ++position;
+        }
+        if (position == static_cast<size_t>(_keyPattern.nFields())) {
+            return;
+        }
+        positions.push_back(position);
+    }
+
+    _sortKeyThreshold = threshold;
+    _sortKeyPositions.swap(positions);
+}
+
+BSONObj IndexScan::getSortKey(const BSONObj& key) const {
+    std::vector<BSONElement> keyElts;
+    keyElts.reserve(_keyPattern.nFields());
+    for (auto&& keyElt : key) {
+        keyElts.push_back(keyElt);
+    }
+
+    BSONObjBuilder sortKey;
+    for (size_t position : _sortKeyPositions) {
+        sortKey.appendAs(keyElts[position], "");
+    }
+    return sortKey.obj();
+}
+
 bool IndexScan::isEOF() {
     return _commonStats.isEOF;
 }
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <vector>
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/index/index_access_method.h"
@@ -43,11 +44,17 @@ namespace mongo {
 
 class IndexAccessMethod;
 class IndexDescriptor;
+class SortKeyThreshold;
 class WorkingSet;
 
 struct IndexScanParams {
     IndexScanParams()
-        : descriptor(NULL), direction(1), doNotDedup(false), maxScan(0), addKeyMetadata(false) {}
+        : descriptor(NULL),
+          direction(1),
+          doNotDedup(false),
+          maxScan(0),
+          addKeyMetadata(false),
+          estimatedKeysExamined(-1) {}
 
     const IndexDescriptor* descriptor;
 
@@ -62,6 +69,9 @@ struct IndexScanParams {
 
     // Do we want to add the key as metadata?
     bool addKeyMetadata;
+
+    // The planner's estimate of how many keys the scan will examine, or negative if none.
+    double estimatedKeysExamined;
 };
 
 /**
@@ -111,6 +121,13 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Makes this scan drop the keys whose sort key is excluded by 'threshold' before they are
+     * fetched, if the sort key of a document can be read off its key in this index. 'threshold'
+     * is owned by a SortStage above this scan.
+     */
+    void setSortKeyThreshold(const SortKeyThreshold* threshold);
+
     static const char* kStageType;
 
 private:
@@ -119,6 +136,12 @@ private:
      */
     boost::optional<IndexKeyEntry> initIndexScan();
 
+    /**
+     * Returns the sort key of the document indexed by 'key', ordered by the sort pattern of
+     * _sortKeyThreshold.
+     */
+    BSONObj getSortKey(const BSONObj& key) const;
+
     // The WorkingSet we fill with results.  Not owned by us.
     WorkingSet* const _workingSet;
 
@@ -135,6 +158,12 @@ private:
     // The filter is not owned by us.
     const MatchExpression* const _filter;
 
+    // Not owned by us. May be null.
+    const SortKeyThreshold* _sortKeyThreshold = nullptr;
+
+    // For each field of the sort pattern of _sortKeyThreshold, its position in _keyPattern.
+    std::vector<size_t> _sortKeyPositions;
+
     // Could our index have duplicates?  If so, we use _returned to dedup.
     bool _shouldDedup;
     unordered_set<RecordId, RecordId::Hasher> _returned;
@@ -0,0 +1,275 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/multi_idhack.h"
+
+#include <algorithm>
+
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/working_set_common.h"
+#include "mongo/db/exec/working_set_computed_data.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/storage/record_fetcher.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using std::unique_ptr;
+using stdx::make_unique;
+
+// static
+const char* MultiIDHackStage::kStageType = "MULTI_IDHACK";
+
+MultiIDHackStage::MultiIDHackStage(OperationContext* txn,
+                                   const Collection* collection,
+                                   CanonicalQuery* query,
+                                   WorkingSet* ws,
+                                   const IndexDescriptor* descriptor)
+    : PlanStage(kStageType, txn),
+      _collection(collection),
+      _workingSet(ws),
+      _keyPattern(descriptor->keyPattern()),
+      _keysLookedUp(false),
+      _nextLoc(0),
+      _idBeingPagedIn(WorkingSet::INVALID_ID) {
+    const IndexCatalog* catalog = _collection->getIndexCatalog();
+    _specificStats.indexName = descriptor->indexName();
+    _accessMethod = catalog->getIndex(descriptor);
+
+    if (NULL != query->getProj()) {
+        _addKeyMetadata = query->getProj()->wantIndexKey();
+    } else {
+        _addKeyMetadata = false;
+    }
+
+    // Index keys have empty field names. The set also collapses ids that the index considers
+    // equal, such as 1 and 1.0.
+    BSONObjSet keys;
+    BSONForEach(elt, query->getParsed().getFilter()["_id"].Obj()["$in"].Obj()) {
+        BSONObjBuilder bob;
+        bob.appendAs(elt, "");
+        keys.insert(bob.obj());
+    }
+    _keys.assign(keys.begin(), keys.end());
+}
+
+MultiIDHackStage::~MultiIDHackStage() {}
+
+bool MultiIDHackStage::isEOF() {
+    if (WorkingSet::INVALID_ID != _idBeingPagedIn) {
+        // We asked the parent for a page-in, but still haven't had a chance to return the
+        // paged in document
+        return false;
+    }
+
+    return _keysLookedUp && _nextLoc >= _locs.size();
+}
+
+void MultiIDHackStage::lookupKeys() {
+    _locs.clear();
+    _locs.reserve(_keys.size());
+
+    // The keys are sorted, so each seek lands close to the previous one.
+    unique_ptr<SortedDataInterface::Cursor> cursor = _accessMethod->newCursor(getOpCtx());
+    for (const BSONObj& key : _keys) {
+        ++_specificStats.keysExamined;
+        if (auto kv = cursor->seekExact(key, SortedDataInterface::Cursor::kWantLoc)) {
+            _locs.push_back(kv->loc);
+        }
+    }
+
+    std::sort(_locs.begin(), _locs.end());
+    _keysLookedUp = true;
+}
+
+PlanStage::StageState MultiIDHackStage::work(WorkingSetID* out) {
+    ++_commonStats.works;
+
+    // Adds the amount of time taken by work() to executionTimeMillis.
+    ScopedTimer timer(&_commonStats.executionTimeMillis);
+
+    if (WorkingSet::INVALID_ID != _idBeingPagedIn) {
+        invariant(_recordCursor);
+        WorkingSetID id = _idBeingPagedIn;
+        _idBeingPagedIn = WorkingSet::INVALID_ID;
+
+        invariant(WorkingSetCommon::fetchIfUnfetched(getOpCtx(), _workingSet, id, _recordCursor));
+
+        WorkingSetMember* member = _workingSet->get(id);
+        return advance(id, member, out);
+    }
+
+    if (isEOF()) {
+        return PlanStage::IS_EOF;
+    }
+
+    WorkingSetID id = WorkingSet::INVALID_ID;
+    try {
+        if (!_keysLookedUp) {
+            lookupKeys();
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
+        const RecordId loc = _locs[_nextLoc++];
+        ++_specificStats.docsExamined;
+
+        // Create a new WSM for the result document.
+        id = _workingSet->allocate();
+        WorkingSetMember* member = _workingSet->get(id);
+        member->loc = loc;
+        _workingSet->transitionToLocAndIdx(id);
+
+        if (!_recordCursor)
+            _recordCursor = _collection->getCursor(getOpCtx());
+
+        // We may need to request a yield while we fetch the document.
+        if (auto fetcher = _recordCursor->fetcherForId(loc)) {
+            // There's something to fetch. Hand the fetcher off to the WSM, and pass up a
+            // fetch request.
+            _idBeingPagedIn = id;
+            member->setFetcher(fetcher.release());
+            *out = id;
+            _commonStats.needYield++;
+            return NEED_YIELD;
+        }
+
+        if (!WorkingSetCommon::fetch(getOpCtx(), _workingSet, id, _recordCursor)) {
+            // The document was deleted since we looked up its id.
+            _workingSet->free(id);
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
+        return advance(id, member, out);
+    } catch (const WriteConflictException& wce) {
+        // Retry the lookup or the fetch that was interrupted.
+        if (!_keysLookedUp) {
+            _locs.clear();
+        } else {
+            --_nextLoc;
+        }
+        _recordCursor.reset();
+        if (id != WorkingSet::INVALID_ID)
+            _workingSet->free(id);
+
+        *out = WorkingSet::INVALID_ID;
+        _commonStats.needYield++;
+        return NEED_YIELD;
+    }
+}
+
+PlanStage::StageState MultiIDHackStage::advance(WorkingSetID id,
+                                                WorkingSetMember* member,
+                                                WorkingSetID* out) {
+    invariant(member->hasObj());
+
+    if (_addKeyMetadata) {
+        BSONObjBuilder bob;
+        BSONObj ownedKeyObj = member->obj.value()["_id"].wrap().getOwned();
+        bob.appendKeys(_keyPattern, ownedKeyObj);
+        member->emplaceComputed<IndexKeyComputedData>(bob.obj());
+    }
+
+    ++_commonStats.advanced;
+    *out = id;
+    return PlanStage::ADVANCED;
+}
+
+void MultiIDHackStage::doSaveState() {
+    if (_recordCursor)
+        _recordCursor->saveUnpositioned();
+}
+
+void MultiIDHackStage::doRestoreState() {
+    if (_recordCursor)
+        _recordCursor->restore();
+}
+
+void MultiIDHackStage::doDetachFromOperationContext() {
+    if (_recordCursor)
+        _recordCursor->detachFromOperationContext();
+}
+
+void MultiIDHackStage::doReattachToOperationContext() {
+    if (_recordCursor)
+        _recordCursor->reattachToOperationContext(getOpCtx());
+}
+
+void MultiIDHackStage::doInvalidate(OperationContext* txn,
+                                    const RecordId& dl,
+                                    InvalidationType type) {
+    // Since updates can't mutate the '_id' field, we can ignore mutation invalidations.
+    if (INVALIDATION_MUTATION == type) {
+        return;
+    }
+
+    // It's possible that the loc getting invalidated is the one we're about to
+    // fetch. In this case we do a "forced fetch" and put the WSM in owned object state.
+    if (WorkingSet::INVALID_ID != _idBeingPagedIn) {
+        WorkingSetMember* member = _workingSet->get(_idBeingPagedIn);
+        if (member->hasLoc() && (member->loc == dl)) {
+            // Fetch it now and kill the diskloc.
+            WorkingSetCommon::fetchAndInvalidateLoc(txn, member, _collection);
+        }
+    }
+
+    // A deleted document must not be returned, and its RecordId may be reused by an unrelated
+    // document before we get to it.
+    auto pending = std::lower_bound(_locs.begin() + _nextLoc, _locs.end(), dl);
+    if (pending != _locs.end() && *pending == dl) {
+        _locs.erase(pending);
+    }
+}
+
+// static
+bool MultiIDHackStage::supportsQuery(const CanonicalQuery& query) {
+    const LiteParsedQuery& pq = query.getParsed();
+    return !pq.showRecordId() && pq.getHint().isEmpty() && !pq.getSkip() && !pq.getLimit() &&
+        pq.getSort().isEmpty() && pq.getMin().isEmpty() && pq.getMax().isEmpty() &&
+        !pq.getMaxScan() && !pq.isTailable() && !pq.isOplogReplay() &&
+        CanonicalQuery::isSimpleIdInQuery(pq.getFilter());
+}
+
+unique_ptr<PlanStageStats> MultiIDHackStage::getStats() {
+    _commonStats.isEOF = isEOF();
+    unique_ptr<PlanStageStats> ret =
+        make_unique<PlanStageStats>(_commonStats, STAGE_MULTI_IDHACK);
+    ret->specific = make_unique<IDHackStats>(_specificStats);
+    return ret;
+}
+
+const SpecificStats* MultiIDHackStage::getSpecificStats() const {
+    return &_specificStats;
+}
+
+}  // namespace mongo
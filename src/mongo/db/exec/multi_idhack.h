@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/exec/plan_stage.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+class IndexAccessMethod;
+class RecordCursor;
+
+/**
+ * A standalone stage implementing the fast path for queries of the form
+ * {_id: {$in: [<id>, <id>, ...]}}.
+ *
+ * The first call to work() sorts and de-duplicates the ids and looks each of them up with a
+ * single cursor over the _id index. The matching records are then fetched and returned in
+ * RecordId order, so the stage never goes through query planning or builds index bounds.
+ */
+class MultiIDHackStage final : public PlanStage {
+public:
+    MultiIDHackStage(OperationContext* txn,
+                     const Collection* collection,
+                     CanonicalQuery* query,
+                     WorkingSet* ws,
+                     const IndexDescriptor* descriptor);
+
+    ~MultiIDHackStage();
+
+    bool isEOF() final;
+    StageState work(WorkingSetID* out) final;
+
+    void doSaveState() final;
+    void doRestoreState() final;
+    void doDetachFromOperationContext() final;
+    void doReattachToOperationContext() final;
+    void doInvalidate(OperationContext* txn, const RecordId& dl, InvalidationType type) final;
+
+    /**
+     * Like the ID Hack, only supports unsorted, unlimited queries whose entire filter is an $in
+     * over literal _id values.
+     */
+    static bool supportsQuery(const CanonicalQuery& query);
+
+    StageType stageType() const final {
+        return STAGE_MULTI_IDHACK;
+    }
+
+    std::unique_ptr<PlanStageStats> getStats();
+
+    const SpecificStats* getSpecificStats() const final;
+
+    static const char* kStageType;
+
+private:
+    /**
+     * Resolves every id to the RecordId of its document and leaves them sorted in '_locs'.
+     */
+    void lookupKeys();
+
+    /**
+     * Optionally adds key metadata to 'member' and returns PlanStage::ADVANCED.
+     */
+    StageState advance(WorkingSetID id, WorkingSetMember* member, WorkingSetID* out);
+
+    // Not owned here.
+    const Collection* _collection;
+
+    std::unique_ptr<SeekableRecordCursor> _recordCursor;
+
+    // The WorkingSet we annotate with results.  Not owned by us.
+    WorkingSet* _workingSet;
+
+    // Not owned here.
+    const IndexAccessMethod* _accessMethod;
+
+    BSONObj _keyPattern;
+
+    // The distinct ids to look up, sorted in index order.
+    std::vector<BSONObj> _keys;
+
+    bool _keysLookedUp;
+
+    // The RecordIds of the matching documents in ascending order, and the next one to return.
+    std::vector<RecordId> _locs;
+    size_t _nextLoc;
+
+    // Do we need to add index key metadata for returnKey?
+    bool _addKeyMetadata;
+
+    // The WSM of a document we asked the PlanExecutor to page in, as in the ID Hack.
+    WorkingSetID _idBeingPagedIn;
+
+    IDHackStats _specificStats;
+};
+
+}  // namespace mongo
@@ -51,6 +51,12 @@ struct SpecificStats {
      * Make a deep copy.
      */
     virtual SpecificStats* clone() const = 0;
+
+    /**
+     * Returns an estimate of the memory held by these stats, including any strings and BSON the
+     * stats own.
+     */
+    virtual size_t estimateObjectSizeInBytes() const = 0;
 };
 
 // Every stage has CommonStats.
@@ -127,6 +133,21 @@ struct PlanStageStats {
         return stats;
     }
 
+    /**
+     * Estimates the memory held by this stats tree, including the stats of all children.
+     */
+    size_t estimateObjectSizeInBytes() const {
+        size_t size = sizeof(*this) + common.filter.objsize() +
+            children.capacity() * sizeof(PlanStageStats*);
+        if (specific.get()) {
+            size += specific->estimateObjectSizeInBytes();
+        }
+        for (size_t i = 0; i < children.size(); ++i) {
+            size += children[i]->estimateObjectSizeInBytes();
+        }
+        return size;
+    }
+
     // See query/stage_type.h
     StageType stageType;
 
@@ -151,6 +172,10 @@ struct AndHashStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + mapAfterChild.capacity() * sizeof(size_t);
+    }
+
     // Invalidation counters.
     // How many results had the AND fully evaluated but were invalidated?
     size_t flaggedButPassed;
@@ -181,6 +206,10 @@ struct AndSortedStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + failedAnd.capacity() * sizeof(size_t);
+    }
+
     // How many results from each child did not pass the AND?
     std::vector<size_t> failedAnd;
 
@@ -194,6 +223,10 @@ struct CachedPlanStats : public SpecificStats {
     SpecificStats* clone() const final {
         return new CachedPlanStats(*this);
     }
+
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
 };
 
 struct CollectionScanStats : public SpecificStats {
@@ -204,6 +237,10 @@ struct CollectionScanStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     // How many documents did we check against our filter?
     size_t docsTested;
 
@@ -213,13 +250,17 @@ struct CollectionScanStats : public SpecificStats {
 };
 
 struct CountStats : public SpecificStats {
-    CountStats() : nCounted(0), nSkipped(0), trivialCount(false) {}
+    CountStats() : nCounted(0), nSkipped(0), trivialCount(false), approximate(false) {}
 
     SpecificStats* clone() const final {
         CountStats* specific = new CountStats(*this);
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     // The result of the count.
     long long nCounted;
 
@@ -229,6 +270,10 @@ struct CountStats : public SpecificStats {
     // A "trivial count" is one that we can answer by calling numRecords() on the
     // collection, without actually going through any query logic.
     bool trivialCount;
+
+    // True if the count was estimated from the documents in a sample of the collection which
+    // match the query, rather than counted.
+    bool approximate;
 };
 
 struct CountScanStats : public SpecificStats {
@@ -247,6 +292,10 @@ struct CountScanStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + indexName.capacity() + keyPattern.objsize();
+    }
+
     std::string indexName;
 
     BSONObj keyPattern;
@@ -268,6 +317,10 @@ struct DeleteStats : public SpecificStats {
         return new DeleteStats(*this);
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t docsDeleted;
 
     // Invalidated documents can be force-fetched, causing the now invalid RecordId to
@@ -284,6 +337,10 @@ struct DistinctScanStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + keyPattern.objsize() + indexName.capacity() + indexBounds.objsize();
+    }
+
     // How many keys did we look at while distinct-ing?
     size_t keysExamined = 0;
 
@@ -312,6 +369,10 @@ struct FetchStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     // Have we seen anything that already had an object?
     size_t alreadyHasObj;
 
@@ -330,6 +391,10 @@ struct GroupStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     // The total number of groups.
     size_t nGroups;
 };
@@ -342,6 +407,10 @@ struct IDHackStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + indexName.capacity();
+    }
+
     std::string indexName;
 
     // Number of entries retrieved from the index while executing the idhack.
@@ -362,7 +431,8 @@ struct IndexScanStats : public SpecificStats {
           dupsTested(0),
           dupsDropped(0),
           seenInvalidated(0),
-          keysExamined(0) {}
+          keysExamined(0),
+          estimatedKeysExamined(-1) {}
 
     SpecificStats* clone() const final {
         IndexScanStats* specific = new IndexScanStats(*this);
@@ -372,6 +442,11 @@ struct IndexScanStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + indexType.capacity() + indexName.capacity() + keyPattern.objsize() +
+            indexBounds.objsize();
+    }
+
     // Index type being used.
     std::string indexType;
 
@@ -405,6 +480,9 @@ struct IndexScanStats : public SpecificStats {
 
     // Number of entries retrieved from the index during the scan.
     size_t keysExamined;
+
+    // The planner's estimate of 'keysExamined', or negative if it made no estimate.
+    double estimatedKeysExamined;
 };
 
 struct LimitStats : public SpecificStats {
@@ -415,6 +493,10 @@ struct LimitStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t limit;
 };
 
@@ -424,6 +506,10 @@ struct MockStats : public SpecificStats {
     SpecificStats* clone() const final {
         return new MockStats(*this);
     }
+
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
 };
 
 struct MultiPlanStats : public SpecificStats {
@@ -432,6 +518,10 @@ struct MultiPlanStats : public SpecificStats {
     SpecificStats* clone() const final {
         return new MultiPlanStats(*this);
     }
+
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
 };
 
 struct OrStats : public SpecificStats {
@@ -442,6 +532,10 @@ struct OrStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t dupsTested;
     size_t dupsDropped;
 
@@ -457,6 +551,10 @@ struct ProjectionStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + projObj.objsize();
+    }
+
     // Object specifying the projection transformation to apply.
     BSONObj projObj;
 };
@@ -469,6 +567,10 @@ struct SortStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + sortPattern.objsize();
+    }
+
     // How many records were we forced to fetch as the result of an invalidation?
     size_t forcedFetches;
 
@@ -493,6 +595,10 @@ struct MergeSortStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + sortPattern.objsize();
+    }
+
     size_t dupsTested;
     size_t dupsDropped;
 
@@ -511,6 +617,10 @@ struct ShardingFilterStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t chunkSkips;
 };
 
@@ -522,6 +632,10 @@ struct SkipStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t skip;
 };
 
@@ -547,6 +661,11 @@ public:
         return new NearStats(*this);
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + intervalStats.capacity() * sizeof(IntervalStats) +
+            indexName.capacity() + keyPattern.objsize();
+    }
+
     std::vector<IntervalStats> intervalStats;
     std::string indexName;
     BSONObj keyPattern;
@@ -566,6 +685,10 @@ struct UpdateStats : public SpecificStats {
         return new UpdateStats(*this);
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + objInserted.objsize();
+    }
+
     // The number of documents which match the query part of the update.
     size_t nMatched;
 
@@ -605,6 +728,11 @@ struct TextStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this) + indexName.capacity() + parsedTextQuery.objsize() +
+            indexPrefix.objsize();
+    }
+
     std::string indexName;
 
     // Human-readable form of the FTSQuery associated with the text stage.
@@ -622,6 +750,10 @@ struct TextMatchStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t docsRejected;
 };
 
@@ -633,6 +765,10 @@ struct TextOrStats : public SpecificStats {
         return specific;
     }
 
+    size_t estimateObjectSizeInBytes() const final {
+        return sizeof(*this);
+    }
+
     size_t fetches;
 };
 
@@ -0,0 +1,144 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include <algorithm>
+
+namespace mongo {
+
+const size_t RecordIdBitmap::kMaxArrayCardinality;
+const size_t RecordIdBitmap::kBitmapWords;
+
+bool RecordIdBitmap::Container::add(uint16_t low) {
+    if (isBitmap()) {
+        uint64_t mask = uint64_t(1) << (low % 64);
+        uint64_t& word = bits[low / 64];
+        if (word & mask) {
+            return false;
+        }
+        word |= mask;
+        ++cardinality;
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it != array.end() && *it == low) {
+        return false;
+    }
+    array.insert(it, low);
+    ++cardinality;
+
+    if (cardinality > kMaxArrayCardinality) {
+        // The array is now larger than a bitmap would be.
+        bits.assign(kBitmapWords, 0);
+        for (uint16_t value : array) {
+            bits[value / 64] |= uint64_t(1) << (value % 64);
+        }
+        std::vector<uint16_t>().swap(array);
+    }
+    return true;
+}
+
+bool RecordIdBitmap::Container::remove(uint16_t low) {
+    if (isBitmap()) {
+        uint64_t mask = uint64_t(1) << (low % 64);
+        uint64_t& word = bits[low / 64];
+        if (!(word & mask)) {
+            return false;
+        }
+        word &= ~mask;
+        --cardinality;
+        // Bitmaps are not converted back to arrays: a container shrinks by being dropped once it
+        // is empty, and the stages using this set only ever remove entries.
+        return true;
+    }
+
+    auto it = std::lower_bound(array.begin(), array.end(), low);
+    if (it == array.end() || *it != low) {
+        return false;
+    }
+    array.erase(it);
+    --cardinality;
+    return true;
+}
+
+bool RecordIdBitmap::Container::contains(uint16_t low) const {
+    if (isBitmap()) {
+        return bits[low / 64] & (uint64_t(1) << (low % 64));
+    }
+    return std::binary_search(array.begin(), array.end(), low);
+}
+
+bool RecordIdBitmap::add(const RecordId& id) {
+    Container& container = _containers[highBits(id)];
+    size_t memUsageBefore = container.getMemUsage();
+    if (!container.add(lowBits(id))) {
+        return false;
+    }
+    if (1 == container.cardinality) {
+        memUsageBefore = 0;
+    }
+    _memUsage = _memUsage - memUsageBefore + container.getMemUsage();
+    ++_size;
+    return true;
+}
+
+bool RecordIdBitmap::remove(const RecordId& id) {
+    auto it = _containers.find(highBits(id));
+    if (it == _containers.end()) {
+        return false;
+    }
+    size_t memUsageBefore = it->second.getMemUsage();
+    if (!it->second.remove(lowBits(id))) {
+        return false;
+    }
+    if (0 == it->second.cardinality) {
+        _containers.erase(it);
+        _memUsage -= memUsageBefore;
+    } else {
+        _memUsage = _memUsage - memUsageBefore + it->second.getMemUsage();
+    }
+    --_size;
+    return true;
+}
+
+bool RecordIdBitmap::contains(const RecordId& id) const {
+    auto it = _containers.find(highBits(id));
+    return it != _containers.end() && it->second.contains(lowBits(id));
+}
+
+void RecordIdBitmap::clear() {
+    _containers.clear();
+    _size = 0;
+    _memUsage = 0;
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "mongo/db/record_id.h"
+
+namespace mongo {
+
+/**
+ * A compressed set of RecordIds, used by stages that intersect RecordIds without needing to keep
+ * the WorkingSetMember that produced each one.
+ *
+ * The set is split into containers, one for each value of the high 48 bits of a RecordId's
+ * repr.  A container holds the low 16 bits either as a sorted array, while it has at most
+ * kMaxArrayCardinality entries, or as a 65536-bit bitmap once it grows past that.  Dense runs of
+ * RecordIds, as produced by record stores which allocate them sequentially, therefore cost about
+ * one bit each, and sparse ones two bytes each.
+ */
+class RecordIdBitmap {
+public:
+    /**
+     * Containers holding more than this many entries are converted to bitmaps, which are smaller
+     * from there on.
+     */
+    static const size_t kMaxArrayCardinality = 4096;
+
+    /**
+     * Adds 'id' to the set.  Returns false if it was already present.
+     */
+    bool add(const RecordId& id);
+
+    /**
+     * Removes 'id' from the set.  Returns false if it was not present.
+     */
+    bool remove(const RecordId& id);
+
+    bool contains(const RecordId& id) const;
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return 0 == _size;
+    }
+
+    void clear();
+
+    /**
+     * Returns an estimate of the bytes used by the set's containers.
+     */
+    size_t getMemUsage() const {
+        return _memUsage;
+    }
+
+private:
+    static const size_t kBitmapWords = (1 << 16) / 64;
+
+    struct Container {
+        bool add(uint16_t low);
+        bool remove(uint16_t low);
+        bool contains(uint16_t low) const;
+
+        bool isBitmap() const {
+            return !bits.empty();
+        }
+
+        size_t getMemUsage() const {
+            return sizeof(Container) + array.size() * sizeof(uint16_t) +
+                bits.size() * sizeof(uint64_t);
+        }
+
+        // Sorted low halves while the container is small, empty once it is a bitmap.
+        std::vector<uint16_t> array;
+
+        // kBitmapWords words once the container holds more than kMaxArrayCardinality entries.
+        std::vector<uint64_t> bits;
+
+        size_t cardinality = 0;
+    };
+
+    static int64_t highBits(const RecordId& id) {
+        return id.repr() >> 16;
+    }
+
+    static uint16_t lowBits(const RecordId& id) {
+        return static_cast<uint16_t>(id.repr() & 0xFFFF);
+    }
+
+    std::map<int64_t, Container> _containers;
+    size_t _size = 0;
+    size_t _memUsage = 0;
+};
+
+}  // namespace mongo
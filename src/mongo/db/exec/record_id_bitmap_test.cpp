@@ -0,0 +1,104 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/exec/record_id_bitmap.h"
+
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+TEST(RecordIdBitmapTest, AddContainsRemove) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.empty());
+
+    ASSERT_TRUE(bitmap.add(RecordId(1)));
+    ASSERT_TRUE(bitmap.add(RecordId(70000)));
+    ASSERT_TRUE(bitmap.add(RecordId(1LL << 40)));
+    ASSERT_FALSE(bitmap.add(RecordId(1)));
+    ASSERT_EQUALS(3U, bitmap.size());
+
+    ASSERT_TRUE(bitmap.contains(RecordId(1)));
+    ASSERT_TRUE(bitmap.contains(RecordId(70000)));
+    ASSERT_TRUE(bitmap.contains(RecordId(1LL << 40)));
+    ASSERT_FALSE(bitmap.contains(RecordId(2)));
+    ASSERT_FALSE(bitmap.contains(RecordId(1 + (1 << 16))));
+
+    ASSERT_TRUE(bitmap.remove(RecordId(70000)));
+    ASSERT_FALSE(bitmap.remove(RecordId(70000)));
+    ASSERT_FALSE(bitmap.contains(RecordId(70000)));
+    ASSERT_EQUALS(2U, bitmap.size());
+
+    bitmap.clear();
+    ASSERT_TRUE(bitmap.empty());
+    ASSERT_FALSE(bitmap.contains(RecordId(1)));
+}
+
+TEST(RecordIdBitmapTest, DenseContainerBecomesBitmap) {
+    RecordIdBitmap bitmap;
+    const int64_t n = 3 * RecordIdBitmap::kMaxArrayCardinality;
+
+    for (int64_t i = 0; i < n; i += 3) {
+        ASSERT_TRUE(bitmap.add(RecordId(i)));
+    }
+    size_t arrayUsage = bitmap.getMemUsage();
+
+    // Going over the array limit switches the container over to a fixed size bitmap.
+    ASSERT_TRUE(bitmap.add(RecordId(1)));
+    for (int64_t i = 2; i < n; i += 3) {
+        ASSERT_TRUE(bitmap.add(RecordId(i)));
+    }
+    ASSERT_GREATER_THAN_OR_EQUALS(bitmap.getMemUsage(), (1U << 16) / 8);
+    ASSERT_LESS_THAN(bitmap.getMemUsage(), 2 * arrayUsage);
+
+    for (int64_t i = 0; i < n; ++i) {
+        ASSERT_EQUALS(i % 3 != 1 || i == 1, bitmap.contains(RecordId(i)));
+    }
+    ASSERT_EQUALS(static_cast<size_t>(2 * n / 3 + 1), bitmap.size());
+
+    for (int64_t i = 0; i < n; i += 3) {
+        ASSERT_TRUE(bitmap.remove(RecordId(i)));
+    }
+    ASSERT_FALSE(bitmap.contains(RecordId(0)));
+    ASSERT_TRUE(bitmap.contains(RecordId(2)));
+}
+
+TEST(RecordIdBitmapTest, NegativeRecordIds) {
+    RecordIdBitmap bitmap;
+    ASSERT_TRUE(bitmap.add(RecordId(-1)));
+    ASSERT_TRUE(bitmap.add(RecordId(-70000)));
+    ASSERT_TRUE(bitmap.contains(RecordId(-1)));
+    ASSERT_TRUE(bitmap.contains(RecordId(-70000)));
+    ASSERT_FALSE(bitmap.contains(RecordId(65535)));
+    ASSERT_FALSE(bitmap.contains(RecordId(-65535)));
+}
+
+}  // namespace
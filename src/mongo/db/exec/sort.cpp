@@ -34,6 +34,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/index_names.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/scoped_timer.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
@@ -91,6 +92,43 @@ SortStage::SortStage(OperationContext* opCtx,
         const WorkingSetComparator& cmp = *_sortKeyComparator;
         _dataSet.reset(new SortableDataItemSet(cmp));
     }
+
+    // With a limit, the stages below us can drop documents which order after all that we hold.
+    if (_limit > 0 && internalQueryExecEnableSortKeyThreshold) {
+        _sortKeyThreshold = stdx::make_unique<SortKeyThreshold>(_pattern, sortComparator);
+        pushDownSortKeyThreshold();
+    }
+}
+
+void SortStage::pushDownSortKeyThreshold() {
+    PlanStage* stage = child().get();
+    while (true) {
+        switch (stage->stageType()) {
+            case STAGE_SORT_KEY_GENERATOR:
+                static_cast<SortKeyGeneratorStage*>(stage)
+                    ->setSortKeyThreshold(_sortKeyThreshold.get());
+                break;
+            case STAGE_FETCH:
+            case STAGE_SHARDING_FILTER:
+                break;
+            case STAGE_IXSCAN:
+                static_cast<IndexScan*>(stage)->setSortKeyThreshold(_sortKeyThreshold.get());
+                return;
+            default:
+                return;
+        }
+
+        if (stage->getChildren().size() != 1) {
+            return;
+        }
+        stage = stage->getChildren().front().get();
+    }
+}
+
+void SortStage::updateSortKeyThreshold(const SortableDataItem& item) {
+    if (_sortKeyThreshold) {
+        _sortKeyThreshold->set(item.sortKey);
+    }
 }
 
 SortStage::~SortStage() {}
@@ -282,6 +320,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             member->makeObjOwnedIfNeeded();
             _data.push_back(item);
             _memUsage = member->getMemUsage();
+            updateSortKeyThreshold(item);
             return;
         }
         wsidToFree = item.wsid;
@@ -292,6 +331,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             member->makeObjOwnedIfNeeded();
             _data[0] = item;
             _memUsage = member->getMemUsage();
+            updateSortKeyThreshold(item);
         }
     } else {
         // Update data item set instead of vector
@@ -301,6 +341,9 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             member->makeObjOwnedIfNeeded();
             _dataSet->insert(item);
             _memUsage += member->getMemUsage();
+            if (_dataSet->size() == limit) {
+                updateSortKeyThreshold(*_dataSet->rbegin());
+            }
             return;
         }
         // Limit will be exceeded - compare with item with lowest key
@@ -321,6 +364,7 @@ void SortStage::addToBuffer(const SortableDataItem& item) {
             _dataSet->erase(lastItemIt);
             member->makeObjOwnedIfNeeded();
             _dataSet->insert(item);
+            updateSortKeyThreshold(*_dataSet->rbegin());
         }
     }
 
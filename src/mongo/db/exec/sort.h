@@ -33,6 +33,7 @@
 
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/exec/sort_key_threshold.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/query/index_bounds.h"
@@ -150,10 +151,24 @@ private:
      */
     void sortBuffer();
 
+    /**
+     * Hands _sortKeyThreshold to the stages below us which can drop documents with it: the sort
+     * key generator, and an index scan reached only through fetches and filters.
+     */
+    void pushDownSortKeyThreshold();
+
+    /**
+     * Moves _sortKeyThreshold to the sort key of the 'item' that we now hold as our limit-th.
+     */
+    void updateSortKeyThreshold(const SortableDataItem& item);
+
     // Comparator for data buffer
     // Initialization follows sort key generator
     std::unique_ptr<WorkingSetComparator> _sortKeyComparator;
 
+    // The sort key of the last item we hold once we hold '_limit' items. Null if there is no limit.
+    std::unique_ptr<SortKeyThreshold> _sortKeyThreshold;
+
     // The data we buffer and sort.
     // _data will contain sorted data when all data is gathered
     // and sorted.
@@ -36,6 +36,7 @@
 
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/exec/scoped_timer.h"
+#include "mongo/db/exec/sort_key_threshold.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/working_set_common.h"
 #include "mongo/db/exec/working_set_computed_data.h"
@@ -296,8 +297,15 @@ PlanStage::StageState SortKeyGeneratorStage::work(WorkingSetID* out) {
             return PlanStage::FAILURE;
         }
 
+        // The sort already holds enough documents which order before this one.
+        if (_sortKeyThreshold && _sortKeyThreshold->excludes(sortKey)) {
+            _ws->free(*out);
+            ++_commonStats.needTime;
+            return PlanStage::NEED_TIME;
+        }
+
         // Add the sort key to the WSM as computed data.
-        member->addComputed(new SortKeyComputedData(sortKey));
+        member->emplaceComputed<SortKeyComputedData>(sortKey);
 
         return PlanStage::ADVANCED;
     }
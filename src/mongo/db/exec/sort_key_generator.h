@@ -39,6 +39,7 @@
 namespace mongo {
 
 class Collection;
+class SortKeyThreshold;
 class WorkingSetMember;
 
 /**
@@ -125,6 +126,14 @@ public:
 
     const SpecificStats* getSpecificStats() const final;
 
+    /**
+     * Makes this stage drop the results of its child whose sort key is excluded by 'threshold'
+     * rather than passing them up to the sort. 'threshold' is owned by the parent SortStage.
+     */
+    void setSortKeyThreshold(const SortKeyThreshold* threshold) {
+        _sortKeyThreshold = threshold;
+    }
+
     static const char* kStageType;
 
 private:
@@ -139,6 +148,9 @@ private:
     const BSONObj _query;
 
     std::unique_ptr<SortKeyGenerator> _sortKeyGen;
+
+    // Not owned by us. May be null.
+    const SortKeyThreshold* _sortKeyThreshold = nullptr;
 };
 
 }  // namespace mongo
@@ -0,0 +1,79 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/jsobj.h"
+
+namespace mongo {
+
+/**
+ * The sort key of the last document held by a SortStage with a limit of K, once it holds K
+ * documents. Any document whose sort key orders after the threshold cannot be among the results
+ * of the sort, so the stages below the sort use this to drop such documents before they are
+ * fetched or buffered.
+ *
+ * Documents whose sort key equals the threshold are kept, since the sort breaks ties on RecordId.
+ */
+class SortKeyThreshold {
+public:
+    /**
+     * 'sortPattern' is the raw sort pattern, and 'comparePattern' is the pattern used to compare
+     * sort keys as produced by FindCommon::transformSortSpec().
+     */
+    SortKeyThreshold(BSONObj sortPattern, BSONObj comparePattern)
+        : _sortPattern(std::move(sortPattern)), _comparePattern(std::move(comparePattern)) {}
+
+    const BSONObj& getSortPattern() const {
+        return _sortPattern;
+    }
+
+    /**
+     * Sets the threshold to 'sortKey', which must order no later than any previous threshold.
+     */
+    void set(const BSONObj& sortKey) {
+        _sortKey = sortKey.getOwned();
+        _isSet = true;
+    }
+
+    /**
+     * Returns true if a document with sort key 'sortKey' cannot be among the results of the sort.
+     */
+    bool excludes(const BSONObj& sortKey) const {
+        return _isSet && sortKey.woCompare(_sortKey, _comparePattern, false) > 0;
+    }
+
+private:
+    const BSONObj _sortPattern;
+    const BSONObj _comparePattern;
+
+    bool _isSet = false;
+    BSONObj _sortKey;
+};
+
+}  // namespace mongo
@@ -39,10 +39,16 @@
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/db/query/planner_analysis.h"
 #include "mongo/db/query/planner_access.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/db/query/stage_builder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -69,6 +75,20 @@ SubplanStage::SubplanStage(OperationContext* txn,
 
 namespace {
 
+// Runs the query planner for the children of rooted ORs alongside the operations' own threads.
+ThreadPool* getSubplanningPool() {
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "SubplanningPool";
+        options.threadNamePrefix = "Subplanner";
+        options.maxThreads = std::max(stdx::thread::hardware_concurrency(), 2U);
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
 /**
  * Returns true if 'expr' is an AND that contains a single OR child.
  */
@@ -180,6 +200,9 @@ Status SubplanStage::planSubqueries() {
 
     const WhereCallbackReal whereCallback(getOpCtx(), _collection->ns().db());
 
+    // Branches with no cached plan, which are planned once every branch has been canonicalized.
+    std::vector<size_t> toPlan;
+
     for (size_t i = 0; i < _orExpression->numChildren(); ++i) {
         // We need a place to shove the results from planning this branch.
         _branchResults.push_back(new BranchPlanningResult());
@@ -213,29 +236,92 @@ Status SubplanStage::planSubqueries() {
             branchResult->cachedSolution.reset(rawCS);
         } else {
             // No CachedSolution found. We'll have to plan from scratch.
-            LOG(5) << "Subplanner: planning child " << i << " of " << _orExpression->numChildren();
+            toPlan.push_back(i);
+        }
+    }
 
-            // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
-            // considering any plan that's a collscan.
-            Status status = QueryPlanner::plan(*branchResult->canonicalQuery,
-                                               _plannerParams,
-                                               &branchResult->solutions.mutableVector());
+    return planBranches(toPlan);
+}
 
-            if (!status.isOK()) {
-                mongoutils::str::stream ss;
-                ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
-                   << status.reason();
-                return Status(ErrorCodes::BadValue, ss);
-            }
-            LOG(5) << "Subplanner: got " << branchResult->solutions.size() << " solutions";
+Status SubplanStage::planBranch(size_t i, BranchPlanningResult* branchResult) const {
+    LOG(5) << "Subplanner: planning child " << i << " of " << _orExpression->numChildren();
 
-            if (0 == branchResult->solutions.size()) {
-                // If one child doesn't have an indexed solution, bail out.
-                mongoutils::str::stream ss;
-                ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
-                return Status(ErrorCodes::BadValue, ss);
+    // We don't set NO_TABLE_SCAN because peeking at the cache data will keep us from
+    // considering any plan that's a collscan.
+    Status status = QueryPlanner::plan(
+        *branchResult->canonicalQuery, _plannerParams, &branchResult->solutions.mutableVector());
+
+    if (!status.isOK()) {
+        mongoutils::str::stream ss;
+        ss << "Can't plan for subchild " << branchResult->canonicalQuery->toString() << " "
+           << status.reason();
+        return Status(ErrorCodes::BadValue, ss);
+    }
+    LOG(5) << "Subplanner: got " << branchResult->solutions.size() << " solutions";
+
+    if (0 == branchResult->solutions.size()) {
+        // If one child doesn't have an indexed solution, bail out.
+        mongoutils::str::stream ss;
+        ss << "No solutions for subchild " << branchResult->canonicalQuery->toString();
+        return Status(ErrorCodes::BadValue, ss);
+    }
+
+    return Status::OK();
+}
+
+Status SubplanStage::planBranches(const std::vector<size_t>& branches) {
+    vector<Status> statuses(branches.size(), Status::OK());
+    AtomicWord<unsigned> nextBranch(0);
+
+    // Each thread claims the next unplanned branch until none are left.
+    const auto planClaimedBranches = [&] {
+        for (unsigned ix = nextBranch.fetchAndAdd(1); ix < branches.size();
+             ix = nextBranch.fetchAndAdd(1)) {
+            try {
+                statuses[ix] = planBranch(branches[ix], _branchResults[branches[ix]]);
+            } catch (...) {
+                statuses[ix] = exceptionToStatus();
             }
         }
+    };
+
+    const size_t maxThreads = std::max(internalQueryPlanOrChildrenThreads, 1);
+    const size_t helpers = std::min(maxThreads, branches.size()) - (branches.empty() ? 0 : 1);
+
+    stdx::mutex mutex;
+    stdx::condition_variable helperFinished;
+    size_t helpersRunning = 0;
+    for (size_t h = 0; h < helpers; ++h) {
+        {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            ++helpersRunning;
+        }
+        Status scheduled = getSubplanningPool()->schedule([&] {
+            planClaimedBranches();
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            --helpersRunning;
+            helperFinished.notify_one();
+        });
+        if (!scheduled.isOK()) {
+            stdx::lock_guard<stdx::mutex> lk(mutex);
+            --helpersRunning;
+            break;
+        }
+    }
+
+    planClaimedBranches();
+
+    // The helpers reference this frame, so wait for every one of them, even those which start
+    // after the last branch has been claimed.
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        helperFinished.wait(lk, [&] { return helpersRunning == 0; });
+    }
+
+    for (auto&& status : statuses) {
+        if (!status.isOK()) {
+            return status;
+        }
     }
 
     return Status::OK();
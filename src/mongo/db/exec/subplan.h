@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
@@ -50,7 +51,9 @@ class OperationContext;
  * individually, and then creates an overall query plan based on the winning plan from
  * each clause.
  *
- * Uses the MultiPlanStage in order to rank plans for the individual clauses.
+ * Uses the MultiPlanStage in order to rank plans for the individual clauses. Clauses with no
+ * cached plan have their candidate plans enumerated concurrently; the MultiPlanStage trials read
+ * the collection and so still run one clause at a time on the operation's thread.
  *
  * Notes on caching strategy:
  *
@@ -159,6 +162,21 @@ private:
      */
     Status planSubqueries();
 
+    /**
+     * Generates the candidate solutions for each branch whose index is in 'branches', spreading
+     * the branches over up to internalQueryPlanOrChildrenThreads threads. Only runs the query
+     * planner, which does not touch the collection, so it may run away from the operation's
+     * thread. Returns the error of the first failing branch in 'branches' order.
+     *
+     * Helper for planSubqueries().
+     */
+    Status planBranches(const std::vector<size_t>& branches);
+
+    /**
+     * Generates the candidate solutions for a single branch. Helper for planBranches().
+     */
+    Status planBranch(size_t i, BranchPlanningResult* branchResult) const;
+
     /**
      * Uses the query planning results from planSubqueries() and the multi plan stage
      * to select the best plan for each branch.
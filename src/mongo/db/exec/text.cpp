@@ -117,7 +117,15 @@ const SpecificStats* TextStage::getSpecificStats() const {
 unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* txn,
                                                WorkingSet* ws,
                                                const MatchExpression* filter) const {
-    auto textScorer = make_unique<TextOrStage>(txn, _params.spec, ws, filter, _params.index);
+    // A limit can only be pushed down to the scoring when the TEXT_MATCH stage is not going to
+    // reject any of the documents: there are no negations or phrases, and the positive terms are
+    // not matched with case or diacritic sensitivity.
+    const FTSQuery& query = _params.query;
+    const bool matchesAll = query.getNegatedTerms().empty() && query.getPositivePhr().empty() &&
+        query.getNegatedPhr().empty() && !query.getCaseSensitive() &&
+        !query.getDiacriticSensitive();
+    auto textScorer = make_unique<TextOrStage>(
+        txn, _params.spec, ws, filter, _params.index, matchesAll ? _params.limit : 0);
 
     // Get all the index scans for each term in our query.
     for (const auto& term : _params.query.getTermsForBounds()) {
@@ -132,7 +140,7 @@ unique_ptr<PlanStage> TextStage::buildTextTree(OperationContext* txn,
         ixparams.descriptor = _params.index;
         ixparams.direction = -1;
 
-        textScorer->addChild(make_unique<IndexScan>(txn, ixparams, ws, nullptr));
+        textScorer->addChild(make_unique<IndexScan>(txn, ixparams, ws, nullptr), term);
     }
 
     auto fetcher = make_unique<FetchStage>(
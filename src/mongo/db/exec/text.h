@@ -62,6 +62,9 @@ struct TextStageParams {
 
     // The text query.
     FTSQuery query;
+
+    // If nonzero, the stage may return only the 'limit' documents with the highest scores.
+    size_t limit = 0;
 };
 
 /**
@@ -28,6 +28,8 @@
 
 #include "mongo/db/exec/text_or.h"
 
+#include <algorithm>
+#include <functional>
 #include <map>
 #include <vector>
 
@@ -58,19 +60,23 @@ TextOrStage::TextOrStage(OperationContext* txn,
                          const FTSSpec& ftsSpec,
                          WorkingSet* ws,
                          const MatchExpression* filter,
-                         IndexDescriptor* index)
+                         IndexDescriptor* index,
+                         size_t limit)
     : PlanStage(kStageType, txn),
       _ftsSpec(ftsSpec),
       _ws(ws),
       _scoreIterator(_scores.end()),
+      _limit(limit),
       _filter(filter),
       _idRetrying(WorkingSet::INVALID_ID),
       _index(index) {}
 
 TextOrStage::~TextOrStage() {}
 
-void TextOrStage::addChild(unique_ptr<PlanStage> child) {
+void TextOrStage::addChild(unique_ptr<PlanStage> child, const std::string& term) {
     _children.push_back(std::move(child));
+    _terms.push_back(term);
+    _termScoreBounds.push_back(fts::MAX_WEIGHT);
 }
 
 bool TextOrStage::isEOF() {
@@ -108,6 +114,16 @@ void TextOrStage::doInvalidate(OperationContext* txn, const RecordId& dl, Invali
         }
         _scores.erase(scoreIt);
     }
+
+    auto topKIt = std::find_if(_topK.begin(),
+                               _topK.end(),
+                               [&dl](const std::pair<double, RecordId>& entry) {
+                                   return entry.second == dl;
+                               });
+    if (topKIt != _topK.end()) {
+        _topK.erase(topKIt);
+        std::make_heap(_topK.begin(), _topK.end(), std::greater<std::pair<double, RecordId>>());
+    }
 }
 
 std::unique_ptr<PlanStageStats> TextOrStage::getStats() {
@@ -150,7 +166,7 @@ PlanStage::StageState TextOrStage::work(WorkingSetID* out) {
             stageState = initStage(out);
             break;
         case State::kReadingTerms:
-            stageState = readFromChildren(out);
+            stageState = _limit ? readTopKFromChildren(out) : readFromChildren(out);
             break;
         case State::kReturningResults:
             stageState = returnResults(out);
@@ -247,6 +263,106 @@ PlanStage::StageState TextOrStage::readFromChildren(WorkingSetID* out) {
     }
 }
 
+PlanStage::StageState TextOrStage::readTopKFromChildren(WorkingSetID* out) {
+    if (_children.size() == 0) {
+        _internalState = State::kDone;
+        return PlanStage::IS_EOF;
+    }
+    invariant(_currentChild < _children.size());
+
+    WorkingSetID id;
+    StageState childState;
+    if (_idRetrying == WorkingSet::INVALID_ID) {
+        childState = _children[_currentChild]->work(&id);
+    } else {
+        childState = ADVANCED;
+        id = _idRetrying;
+        _idRetrying = WorkingSet::INVALID_ID;
+    }
+
+    if (PlanStage::ADVANCED == childState || PlanStage::IS_EOF == childState) {
+        if (PlanStage::ADVANCED == childState) {
+            WorkingSetMember* wsm = _ws->get(id);
+            invariant(1 == wsm->keyData.size());
+            _termScoreBounds[_currentChild] = getTermScore(wsm->keyData.back().keyData);
+
+            StageState addState = addTopKDocument(id, out);
+            if (PlanStage::NEED_YIELD == addState) {
+                // The document is retried, with the same child, after the yield.
+                return addState;
+            }
+        } else {
+            _termScoreBounds[_currentChild] = 0;
+        }
+
+        // Move on to the next child which has keys left.
+        size_t next = _currentChild;
+        do {
+            next = (next + 1) % _children.size();
+        } while (next != _currentChild && _children[next]->isEOF());
+        _currentChild = next;
+
+        if (_children[_currentChild]->isEOF() || haveTopK()) {
+            _scoreIterator = _scores.begin();
+            _internalState = State::kReturningResults;
+        }
+        return PlanStage::NEED_TIME;
+    } else if (PlanStage::FAILURE == childState) {
+        if (WorkingSet::INVALID_ID == id) {
+            mongoutils::str::stream ss;
+            ss << "TEXT_OR stage failed to read in results from child";
+            Status status(ErrorCodes::InternalError, ss);
+            *out = WorkingSetCommon::allocateStatusMember(_ws, status);
+        } else {
+            *out = id;
+        }
+        return PlanStage::FAILURE;
+    } else {
+        // Propagate WSID from below.
+        *out = id;
+        return childState;
+    }
+}
+
+bool TextOrStage::haveTopK() const {
+    if (_topK.size() < _limit) {
+        return false;
+    }
+
+    double unseenMaxScore = 0;
+    for (double bound : _termScoreBounds) {
+        unseenMaxScore += bound;
+    }
+    return _topK.front().first >= unseenMaxScore;
+}
+
+double TextOrStage::getTermScore(const BSONObj& keyData) const {
+    // Locate score within possibly compound key: {prefix,term,score,suffix}.
+    BSONObjIterator keyIt(keyData);
+    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
+        keyIt.next();
+    }
+
+    keyIt.next();  // Skip past 'term'.
+
+    BSONElement scoreElement = keyIt.next();
+    return scoreElement.number();
+}
+
+double TextOrStage::scoreDocument(const BSONObj& obj) const {
+    fts::TermFrequencyMap termFrequencies;
+    _ftsSpec.scoreDocument(obj, &termFrequencies);
+
+    double score = 0;
+    for (const auto& term : _terms) {
+        auto it = termFrequencies.find(term);
+        if (it != termFrequencies.end()) {
+            score += it->second;
+        }
+    }
+    return score;
+}
+
 PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     if (_scoreIterator == _scores.end()) {
         _internalState = State::kDone;
@@ -266,7 +382,7 @@ PlanStage::StageState TextOrStage::returnResults(WorkingSetID* out) {
     WorkingSetMember* wsm = _ws->get(textRecordData.wsid);
 
     // Populate the working set member with the text score and return it.
-    wsm->addComputed(new TextScoreComputedData(textRecordData.score));
+    wsm->emplaceComputed<TextScoreComputedData>(textRecordData.score);
     *out = textRecordData.wsid;
     return PlanStage::ADVANCED;
 }
@@ -413,19 +529,70 @@ PlanStage::StageState TextOrStage::addTerm(WorkingSetID wsid, WorkingSetID* out)
         return NEED_TIME;
     }
 
-    // Locate score within possibly compound key: {prefix,term,score,suffix}.
-    BSONObjIterator keyIt(newKeyData.keyData);
-    for (unsigned i = 0; i < _ftsSpec.numExtraBefore(); i++) {
-        keyIt.next();
+    // Aggregate relevance score, term keys.
+    *documentAggregateScore += getTermScore(newKeyData.keyData);
+    return NEED_TIME;
+}
+
+PlanStage::StageState TextOrStage::addTopKDocument(WorkingSetID wsid, WorkingSetID* out) {
+    WorkingSetMember* wsm = _ws->get(wsid);
+    invariant(wsm->getState() == WorkingSetMember::LOC_AND_IDX ||
+              wsm->getState() == WorkingSetMember::LOC_AND_OBJ);
+
+    if (_scores.count(wsm->loc)) {
+        // The document was scored on all of the terms when it was first seen.
+        _ws->free(wsid);
+        return NEED_TIME;
     }
 
-    keyIt.next();  // Skip past 'term'.
+    bool shouldKeep = true;
+    try {
+        if (_filter) {
+            const IndexKeyDatum& keyData = wsm->keyData.back();
+            TextMatchableDocument tdoc(getOpCtx(),
+                                       keyData.indexKeyPattern,
+                                       keyData.keyData,
+                                       _ws,
+                                       wsid,
+                                       _recordCursor);
+            shouldKeep = _filter->matches(&tdoc);
+        }
+        if (shouldKeep && !wsm->hasObj()) {
+            ++_specificStats.fetches;
+            shouldKeep = WorkingSetCommon::fetch(getOpCtx(), _ws, wsid, _recordCursor);
+        }
+    } catch (const WriteConflictException& wce) {
+        wsm->makeObjOwnedIfNeeded();
+        _idRetrying = wsid;
+        *out = WorkingSet::INVALID_ID;
+        return NEED_YIELD;
+    } catch (const TextMatchableDocument::DocumentDeletedException&) {
+        shouldKeep = false;
+    }
 
-    BSONElement scoreElement = keyIt.next();
-    double documentTermScore = scoreElement.number();
+    TextRecordData* textRecordData = &_scores[wsm->loc];
+    if (!shouldKeep) {
+        _ws->free(wsid);
+        textRecordData->score = -1;
+        return NEED_TIME;
+    }
 
-    // Aggregate relevance score, term keys.
-    *documentAggregateScore += documentTermScore;
+    wsm->makeObjOwnedIfNeeded();
+    textRecordData->wsid = wsid;
+    textRecordData->score = scoreDocument(wsm->obj.value());
+
+    const std::greater<std::pair<double, RecordId>> heapOrder;
+    _topK.emplace_back(textRecordData->score, wsm->loc);
+    std::push_heap(_topK.begin(), _topK.end(), heapOrder);
+    if (_topK.size() > _limit) {
+        std::pop_heap(_topK.begin(), _topK.end(), heapOrder);
+        TextRecordData* evicted = &_scores[_topK.back().second];
+        _topK.pop_back();
+
+        _ws->free(evicted->wsid);
+        evicted->wsid = WorkingSet::INVALID_ID;
+        evicted->score = -1;
+    }
     return NEED_TIME;
 }
 
@@ -29,6 +29,8 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/db/catalog/collection.h"
@@ -53,6 +55,13 @@ class OperationContext;
  *
  * The WorkingSetMembers returned are in the LOC_AND_IDX state. If a filter is passed in, some
  * WorkingSetMembers may be returned in the LOC_AND_OBJ state.
+ *
+ * If constructed with a nonzero 'limit', the stage returns only the 'limit' documents with the
+ * highest scores, all in the LOC_AND_OBJ state. Each child must then scan the keys of its term in
+ * descending order of score, so that the score of the last key read from a child bounds what its
+ * term adds to any document not seen yet. The children are read in turn, each new document is
+ * fetched and scored on all of the terms at once, and reading stops as soon as the lowest of the
+ * best 'limit' scores is at least the sum of those bounds: no unseen document can beat it.
  */
 class TextOrStage final : public PlanStage {
 public:
@@ -77,10 +86,14 @@ public:
                 const FTSSpec& ftsSpec,
                 WorkingSet* ws,
                 const MatchExpression* filter,
-                IndexDescriptor* index);
+                IndexDescriptor* index,
+                size_t limit = 0);
     ~TextOrStage();
 
-    void addChild(unique_ptr<PlanStage> child);
+    /**
+     * Adds a child which returns the index keys of 'term'.
+     */
+    void addChild(unique_ptr<PlanStage> child, const std::string& term);
 
     bool isEOF() final;
 
@@ -121,6 +134,34 @@ private:
      */
     StageState addTerm(WorkingSetID wsid, WorkingSetID* out);
 
+    /**
+     * Worker for kReadingTerms when the stage has a limit. Reads a key from the current child and
+     * moves on to the next, until no document which has not been seen can make the top 'limit'.
+     */
+    StageState readTopKFromChildren(WorkingSetID* out);
+
+    /**
+     * Helper called from readTopKFromChildren to score a newfound document on all of the terms,
+     * and keep it if it is among the 'limit' highest scoring documents so far.
+     */
+    StageState addTopKDocument(WorkingSetID wsid, WorkingSetID* out);
+
+    /**
+     * Returns the score of the term in a text index key {prefix,term,score,suffix}.
+     */
+    double getTermScore(const BSONObj& keyData) const;
+
+    /**
+     * Returns the sum of the scores 'obj' gets for each of the terms of the children.
+     */
+    double scoreDocument(const BSONObj& obj) const;
+
+    /**
+     * Returns true once the lowest of the 'limit' best scores so far is at least the most that a
+     * document not seen yet could score.
+     */
+    bool haveTopK() const;
+
     /**
      * Worker for kReturningResults. Returns a wsm with RecordID and Score.
      */
@@ -153,6 +194,20 @@ private:
     ScoreMap _scores;
     ScoreMap::const_iterator _scoreIterator;
 
+    // If nonzero, only the documents with the 'limit' highest scores are returned.
+    const size_t _limit;
+
+    // The term each child returns the keys of.
+    std::vector<std::string> _terms;
+
+    // Used with a limit: the score of the last key read from each child, which no key it has yet
+    // to return exceeds, or 0 once it is EOF.
+    std::vector<double> _termScoreBounds;
+
+    // Used with a limit: a min-heap of the (score, RecordId) of the best documents so far, which
+    // are the only documents in _scores with a nonnegative score.
+    std::vector<std::pair<double, RecordId>> _topK;
+
     TextOrStats _specificStats;
 
     // Members needed only for using the TextMatchableDocument.
@@ -41,6 +41,7 @@
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -56,6 +57,10 @@ namespace mb = mutablebson;
 
 namespace {
 
+// How long a writer retrying after a write conflict waits for the writers which conflicted on
+// the same document before it. Zero disables the queue, leaving only the backoff.
+MONGO_EXPORT_SERVER_PARAMETER(writeConflictQueueMaxWaitMillis, int, 100);
+
 const char idFieldName[] = "_id";
 const FieldRef idFieldRef(idFieldName);
 
@@ -441,56 +446,77 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
     // If asked to return new doc, default to the oldObj, in case nothing changes.
     BSONObj newObj = oldObj.value();
 
-    // Ask the driver to apply the mods. It may be that the driver can apply those "in
-    // place", that is, some values of the old document just get adjusted without any
-    // change to the binary layout on the bson layer. It may be that a whole new document
-    // is needed to accomodate the new bson layout of the resulting document. In any event,
-    // only enable in-place mutations if the underlying storage engine offers support for
-    // writing damage events.
-    _doc.reset(oldObj.value(),
-               (_collection->updateWithDamagesSupported()
-                    ? mutablebson::Document::kInPlaceEnabled
-                    : mutablebson::Document::kInPlaceDisabled));
-
     BSONObj logObj;
 
     FieldRefSet updatedFields;
     bool docWasModified = false;
 
-    Status status = Status::OK();
-    if (!driver->needMatchDetails()) {
-        // If we don't need match details, avoid doing the rematch
-        status = driver->update(StringData(), &_doc, &logObj, &updatedFields, &docWasModified);
+    // An update which only $set's or $inc's top-level fields, keeping the size of their
+    // values, is turned into damages directly, without building a mutable document.
+    BSONObj inPlaceValues;
+    const bool updatedWithoutDocument = driver->mayUpdateInPlace() &&
+        _collection->updateWithDamagesSupported() &&
+        driver->updateInPlace(oldObj.value(),
+                              lifecycle ? lifecycle->getImmutableFields() : NULL,
+                              &inPlaceValues,
+                              &_damages,
+                              &docWasModified);
+
+    const char* source = NULL;
+    bool inPlace = true;
+    if (updatedWithoutDocument) {
+        source = inPlaceValues.objdata();
+        if (driver->logOp()) {
+            logObj = inPlaceValues;
+        }
     } else {
-        // If there was a matched field, obtain it.
-        MatchDetails matchDetails;
-        matchDetails.requestElemMatchKey();
+        // Ask the driver to apply the mods. It may be that the driver can apply those "in
+        // place", that is, some values of the old document just get adjusted without any
+        // change to the binary layout on the bson layer. It may be that a whole new document
+        // is needed to accomodate the new bson layout of the resulting document. In any event,
+        // only enable in-place mutations if the underlying storage engine offers support for
+        // writing damage events.
+        _doc.reset(oldObj.value(),
+                   (_collection->updateWithDamagesSupported()
+                        ? mutablebson::Document::kInPlaceEnabled
+                        : mutablebson::Document::kInPlaceDisabled));
+
+        Status status = Status::OK();
+        if (!driver->needMatchDetails()) {
+            // If we don't need match details, avoid doing the rematch
+            status =
+                driver->update(StringData(), &_doc, &logObj, &updatedFields, &docWasModified);
+        } else {
+            // If there was a matched field, obtain it.
+            MatchDetails matchDetails;
+            matchDetails.requestElemMatchKey();
 
-        dassert(cq);
-        verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
+            dassert(cq);
+            verify(cq->root()->matchesBSON(oldObj.value(), &matchDetails));
 
-        string matchedField;
-        if (matchDetails.hasElemMatchKey())
-            matchedField = matchDetails.elemMatchKey();
+            string matchedField;
+            if (matchDetails.hasElemMatchKey())
+                matchedField = matchDetails.elemMatchKey();
 
-        // TODO: Right now, each mod checks in 'prepare' that if it needs positional
-        // data, that a non-empty StringData() was provided. In principle, we could do
-        // that check here in an else clause to the above conditional and remove the
-        // checks from the mods.
+            // TODO: Right now, each mod checks in 'prepare' that if it needs positional
+            // data, that a non-empty StringData() was provided. In principle, we could do
+            // that check here in an else clause to the above conditional and remove the
+            // checks from the mods.
 
-        status = driver->update(matchedField, &_doc, &logObj, &updatedFields, &docWasModified);
-    }
+            status =
+                driver->update(matchedField, &_doc, &logObj, &updatedFields, &docWasModified);
+        }
 
-    if (!status.isOK()) {
-        uasserted(16837, status.reason());
-    }
+        if (!status.isOK()) {
+            uasserted(16837, status.reason());
+        }
 
-    // Ensure _id exists and is first
-    uassertStatusOK(ensureIdAndFirst(_doc));
+        // Ensure _id exists and is first
+        uassertStatusOK(ensureIdAndFirst(_doc));
 
-    // See if the changes were applied in place
-    const char* source = NULL;
-    const bool inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+        // See if the changes were applied in place
+        inPlace = _doc.getInPlaceUpdates(&_damages, &source);
+    }
 
     if (inPlace && _damages.empty()) {
         // An interesting edge case. A modifier didn't notice that it was really a no-op
@@ -504,8 +530,9 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
 
     if (docWasModified) {
         // Verify that no immutable fields were changed and data is valid for storage.
-
-        if (!(!getOpCtx()->writesAreReplicated() || request->isFromMigration())) {
+        // updateInPlace() has already checked that it modified no immutable field.
+        if (!updatedWithoutDocument &&
+            !(!getOpCtx()->writesAreReplicated() || request->isFromMigration())) {
             const std::vector<FieldRef*>* immutableFields = NULL;
             if (lifecycle)
                 immutableFields = lifecycle->getImmutableFields();
@@ -559,6 +586,10 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                 args.update = logObj;
                 args.criteria = idQuery;
                 args.fromMigrate = request->isFromMigration();
+                // A replacement can change any path, so only the modifiers' paths let the
+                // collection skip the indexes they cannot affect.
+                const FieldRefSet* updatedFieldsForIndexes =
+                    driver->isDocReplacement() ? NULL : &updatedFields;
                 StatusWith<RecordId> res = _collection->updateDocument(getOpCtx(),
                                                                        loc,
                                                                        oldObj,
@@ -566,7 +597,8 @@ BSONObj UpdateStage::transformAndUpdate(const Snapshotted<BSONObj>& oldObj, Reco
                                                                        true,
                                                                        driver->modsAffectIndices(),
                                                                        _params.opDebug,
-                                                                       args);
+                                                                       args,
+                                                                       updatedFieldsForIndexes);
                 uassertStatusOK(res.getStatus());
                 newLoc = res.getValue();
             }
@@ -800,6 +832,17 @@ PlanStage::StageState UpdateStage::work(WorkingSetID* out) {
         status = ADVANCED;
         id = _idRetrying;
         _idRetrying = WorkingSet::INVALID_ID;
+
+        // Retry behind the writers which conflicted on this document before us, rather than
+        // racing them into another conflict.
+        WorkingSetMember* member = _ws->get(id);
+        if (!_conflictTurn && member->hasLoc() && writeConflictQueueMaxWaitMillis > 0) {
+            _conflictTurn = stdx::make_unique<RecordConflictQueue::Turn>(
+                RecordConflictQueue::get(),
+                _collection->ns().ns(),
+                member->loc,
+                Milliseconds(writeConflictQueueMaxWaitMillis));
+        }
     }
 
     if (PlanStage::ADVANCED == status) {
@@ -811,6 +854,9 @@ PlanStage::StageState UpdateStage::work(WorkingSetID* out) {
         // We want to free this member when we return, unless we need to retry it.
         ScopeGuard memberFreer = MakeGuard(&WorkingSet::free, _ws, id);
 
+        // Give up our place in the conflict queue when we return, unless we need to retry.
+        ScopeGuard turnReleaser = MakeGuard([this] { _conflictTurn.reset(); });
+
         if (!member->hasLoc()) {
             // We expect to be here because of an invalidation causing a force-fetch, and
             // doc-locking storage engines do not issue invalidations.
@@ -896,6 +942,7 @@ PlanStage::StageState UpdateStage::work(WorkingSetID* out) {
             member->makeObjOwnedIfNeeded();
             _idRetrying = id;
             memberFreer.Dismiss();  // Keep this member around so we can retry updating it.
+            turnReleaser.Dismiss();  // Keep our place in the queue for the retry.
             *out = WorkingSet::INVALID_ID;
             _commonStats.needYield++;
             return NEED_YIELD;
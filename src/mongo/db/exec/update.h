@@ -30,6 +30,7 @@
 
 
 #include "mongo/db/catalog/collection.h"
+#include "mongo/db/concurrency/record_conflict_queue.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/ops/update_driver.h"
@@ -179,6 +180,10 @@ private:
     // If not WorkingSet::INVALID_ID, we return this member to our caller.
     WorkingSetID _idReturning;
 
+    // Our place among the writers retrying after a write conflict on the document in
+    // _idRetrying. Held from the first retry until the update succeeds or is abandoned.
+    std::unique_ptr<RecordConflictQueue::Turn> _conflictTurn;
+
     // Stats
     UpdateStats _specificStats;
 
@@ -41,11 +41,7 @@ WorkingSet::MemberHolder::~MemberHolder() {}
 
 WorkingSet::WorkingSet() : _freeList(INVALID_ID) {}
 
-WorkingSet::~WorkingSet() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-}
+WorkingSet::~WorkingSet() {}
 
 WorkingSetID WorkingSet::allocate() {
     if (_freeList == INVALID_ID) {
@@ -54,8 +50,9 @@ WorkingSetID WorkingSet::allocate() {
         // remains empty until something is returned by a call to free().
         WorkingSetID id = _data.size();
         _data.resize(_data.size() + 1);
+        _members.emplace_back();
         _data.back().nextFreeOrSelf = id;
-        _data.back().member = new WorkingSetMember();
+        _data.back().member = &_members.back();
         return id;
     }
 
@@ -93,14 +90,14 @@ bool WorkingSet::isFlagged(WorkingSetID id) const {
 }
 
 void WorkingSet::clear() {
-    for (size_t i = 0; i < _data.size(); i++) {
-        delete _data[i].member;
-    }
-    _data.clear();
-
-    // Since working set is now empty, the free list pointer should
-    // point to nothing.
+    // Put every member on the free list, lowest id first, keeping their storage (and the capacity
+    // of their key data) for reuse.
     _freeList = INVALID_ID;
+    for (size_t i = _data.size(); i-- > 0;) {
+        _data[i].member->clear();
+        _data[i].nextFreeOrSelf = _freeList;
+        _freeList = i;
+    }
 
     _flagged.clear();
     _yieldSensitiveIds.clear();
@@ -135,18 +132,40 @@ std::vector<WorkingSetID> WorkingSet::getAndClearYieldSensitiveIds() {
 
 WorkingSetMember::WorkingSetMember() {}
 
-WorkingSetMember::~WorkingSetMember() {}
+WorkingSetMember::~WorkingSetMember() {
+    for (size_t i = 0; i < WSM_COMPUTED_NUM_TYPES; i++) {
+        resetComputed(static_cast<WorkingSetComputedDataType>(i));
+    }
+}
 
 void WorkingSetMember::clear() {
     for (size_t i = 0; i < WSM_COMPUTED_NUM_TYPES; i++) {
-        _computed[i].reset();
+        resetComputed(static_cast<WorkingSetComputedDataType>(i));
     }
 
+    // Members are recycled, so everything must go back to its initial value.
     keyData.clear();
     obj.reset();
+    loc = RecordId();
+    isSuspicious = false;
+    _fetcher.reset();
     _state = WorkingSetMember::INVALID;
 }
 
+void WorkingSetMember::resetComputed(WorkingSetComputedDataType type) {
+    WorkingSetComputedData* data = _computed[type];
+    if (!data) {
+        return;
+    }
+
+    _computed[type] = NULL;
+    if (static_cast<void*>(data) == static_cast<void*>(&_computedSlots[type])) {
+        data->~WorkingSetComputedData();
+    } else {
+        delete data;
+    }
+}
+
 WorkingSetMember::MemberState WorkingSetMember::getState() const {
     return _state;
 }
@@ -176,18 +195,18 @@ void WorkingSetMember::makeObjOwnedIfNeeded() {
 }
 
 bool WorkingSetMember::hasComputed(const WorkingSetComputedDataType type) const {
-    return _computed[type].get();
+    return _computed[type];
 }
 
 const WorkingSetComputedData* WorkingSetMember::getComputed(
     const WorkingSetComputedDataType type) const {
     verify(_computed[type]);
-    return _computed[type].get();
+    return _computed[type];
 }
 
 void WorkingSetMember::addComputed(WorkingSetComputedData* data) {
     verify(!hasComputed(data->type()));
-    _computed[data->type()].reset(data);
+    _computed[data->type()] = data;
 }
 
 void WorkingSetMember::setFetcher(RecordFetcher* fetcher) {
@@ -28,8 +28,12 @@
 
 #pragma once
 
-#include <vector>
+#include <deque>
+#include <new>
+#include <type_traits>
 #include <unordered_set>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/jsobj.h"
@@ -113,7 +117,8 @@ public:
     const unordered_set<WorkingSetID>& getFlagged() const;
 
     /**
-     * Removes and deallocates all members of this working set.
+     * Frees all members of this working set. Their storage is kept and reused by later calls to
+     * allocate().
      */
     void clear();
 
@@ -147,7 +152,7 @@ private:
         // Free list link if freed. Points to self if in use.
         WorkingSetID nextFreeOrSelf;
 
-        // Owning pointer
+        // Points into _members.
         WorkingSetMember* member;
     };
 
@@ -155,6 +160,11 @@ private:
     // Elements are added to _freeList rather than removed when freed.
     std::vector<MemberHolder> _data;
 
+    // The members themselves, _members[i] belonging to _data[i]. A deque allocates them in
+    // contiguous blocks rather than one at a time, and never moves them, so pointers handed out
+    // by get() stay valid as the working set grows.
+    std::deque<WorkingSetMember> _members;
+
     // Index into _data, forming a linked-list using MemberHolder::nextFreeOrSelf as the next
     // link. INVALID_ID is the list terminator since 0 is a valid index.
     // If _freeList == INVALID_ID, the free list is empty and all elements in _data are in use.
@@ -304,8 +314,25 @@ public:
 
     bool hasComputed(const WorkingSetComputedDataType type) const;
     const WorkingSetComputedData* getComputed(const WorkingSetComputedDataType type) const;
+
+    /**
+     * Takes ownership of 'data', which must have been allocated with new.
+     */
     void addComputed(WorkingSetComputedData* data);
 
+    /**
+     * Constructs computed data of type T from 'args' in storage reserved for T::kType inside this
+     * member, so that stages attaching data to every result don't allocate for it.
+     */
+    template <typename T, typename... Args>
+    void emplaceComputed(Args&&... args) {
+        static_assert(sizeof(T) <= sizeof(ComputedDataSlot) &&
+                          std::alignment_of<T>::value <= std::alignment_of<ComputedDataSlot>::value,
+                      "computed data does not fit in a WorkingSetMember slot");
+        verify(!hasComputed(T::kType));
+        _computed[T::kType] = new (&_computedSlots[T::kType]) T(std::forward<Args>(args)...);
+    }
+
     //
     // Fetching
     //
@@ -334,9 +361,21 @@ public:
 private:
     friend class WorkingSet;
 
+    // Large enough for any of the types in working_set_computed_data.h: a vtable pointer, the
+    // type tag and a BSONObj.
+    typedef std::aligned_storage<4 * sizeof(void*)>::type ComputedDataSlot;
+
+    /**
+     * Destroys the computed data of 'type', if any, releasing it the way it was added.
+     */
+    void resetComputed(WorkingSetComputedDataType type);
+
     MemberState _state = WorkingSetMember::INVALID;
 
-    std::unique_ptr<WorkingSetComputedData> _computed[WSM_COMPUTED_NUM_TYPES];
+    // Either null, a heap object passed to addComputed(), or an object built in the matching
+    // entry of _computedSlots by emplaceComputed().
+    WorkingSetComputedData* _computed[WSM_COMPUTED_NUM_TYPES] = {};
+    ComputedDataSlot _computedSlots[WSM_COMPUTED_NUM_TYPES];
 
     std::unique_ptr<RecordFetcher> _fetcher;
 };
@@ -34,8 +34,10 @@ namespace mongo {
 
 class TextScoreComputedData : public WorkingSetComputedData {
 public:
+    static const WorkingSetComputedDataType kType = WSM_COMPUTED_TEXT_SCORE;
+
     TextScoreComputedData(double score)
-        : WorkingSetComputedData(WSM_COMPUTED_TEXT_SCORE), _score(score) {}
+        : WorkingSetComputedData(kType), _score(score) {}
 
     double getScore() const {
         return _score;
@@ -51,8 +53,10 @@ private:
 
 class GeoDistanceComputedData : public WorkingSetComputedData {
 public:
+    static const WorkingSetComputedDataType kType = WSM_COMPUTED_GEO_DISTANCE;
+
     GeoDistanceComputedData(double dist)
-        : WorkingSetComputedData(WSM_COMPUTED_GEO_DISTANCE), _dist(dist) {}
+        : WorkingSetComputedData(kType), _dist(dist) {}
 
     double getDist() const {
         return _dist;
@@ -68,8 +72,10 @@ private:
 
 class IndexKeyComputedData : public WorkingSetComputedData {
 public:
+    static const WorkingSetComputedDataType kType = WSM_INDEX_KEY;
+
     IndexKeyComputedData(BSONObj key)
-        : WorkingSetComputedData(WSM_INDEX_KEY), _key(key.getOwned()) {}
+        : WorkingSetComputedData(kType), _key(key.getOwned()) {}
 
     BSONObj getKey() const {
         return _key;
@@ -85,8 +91,10 @@ private:
 
 class GeoNearPointComputedData : public WorkingSetComputedData {
 public:
+    static const WorkingSetComputedDataType kType = WSM_GEO_NEAR_POINT;
+
     GeoNearPointComputedData(BSONObj point)
-        : WorkingSetComputedData(WSM_GEO_NEAR_POINT), _point(point.getOwned()) {}
+        : WorkingSetComputedData(kType), _point(point.getOwned()) {}
 
     BSONObj getPoint() const {
         return _point;
@@ -102,8 +110,10 @@ private:
 
 class SortKeyComputedData : public WorkingSetComputedData {
 public:
+    static const WorkingSetComputedDataType kType = WSM_SORT_KEY;
+
     SortKeyComputedData(BSONObj sortKey)
-        : WorkingSetComputedData(WSM_SORT_KEY), _sortKey(sortKey.getOwned()) {}
+        : WorkingSetComputedData(kType), _sortKey(sortKey.getOwned()) {}
 
     BSONObj getSortKey() const {
         return _sortKey;
@@ -32,6 +32,7 @@
 
 
 #include "mongo/db/exec/working_set.h"
+#include "mongo/db/exec/working_set_computed_data.h"
 #include "mongo/db/json.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/storage/snapshot.h"
@@ -154,4 +155,42 @@ TEST_F(WorkingSetFixture, getDottedFieldFromIndex) {
     ASSERT_FALSE(member->getFieldDotted("y", &elt));
 }
 
+TEST_F(WorkingSetFixture, computedDataInlineAndOnHeap) {
+    member->emplaceComputed<SortKeyComputedData>(BSON("" << 1));
+    member->addComputed(new TextScoreComputedData(2.5));
+
+    ASSERT_TRUE(member->hasComputed(WSM_SORT_KEY));
+    ASSERT_EQUALS(BSON("" << 1),
+                  static_cast<const SortKeyComputedData*>(member->getComputed(WSM_SORT_KEY))
+                      ->getSortKey());
+    ASSERT_EQUALS(2.5,
+                  static_cast<const TextScoreComputedData*>(
+                      member->getComputed(WSM_COMPUTED_TEXT_SCORE))->getScore());
+
+    ws->free(id);
+    WorkingSetID reused = ws->allocate();
+    ASSERT_EQUALS(id, reused);
+    ASSERT_FALSE(ws->get(reused)->hasComputed(WSM_SORT_KEY));
+    ASSERT_FALSE(ws->get(reused)->hasComputed(WSM_COMPUTED_TEXT_SCORE));
+}
+
+TEST_F(WorkingSetFixture, clearRecyclesMembers) {
+    WorkingSetID second = ws->allocate();
+    WorkingSetMember* secondMember = ws->get(second);
+    secondMember->isSuspicious = true;
+    secondMember->emplaceComputed<IndexKeyComputedData>(BSON("" << 3));
+
+    ws->clear();
+    ASSERT_TRUE(ws->isFree(id));
+    ASSERT_TRUE(ws->isFree(second));
+
+    // Members are handed out again lowest id first, reset to their initial state.
+    ASSERT_EQUALS(id, ws->allocate());
+    ASSERT_EQUALS(second, ws->allocate());
+    ASSERT_EQUALS(secondMember, ws->get(second));
+    ASSERT_EQUALS(WorkingSetMember::INVALID, secondMember->getState());
+    ASSERT_FALSE(secondMember->isSuspicious);
+    ASSERT_FALSE(secondMember->hasComputed(WSM_INDEX_KEY));
+}
+
 }  // namespace
@@ -41,32 +41,57 @@
 
 namespace mongo {
 
-void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector) {
+namespace {
+
+void collectOne(Client* client, FTDCCollectorInterface* collector, BSONObjBuilder& subObjBuilder) {
+    // Add a Date_t before and after each BSON is collected so that we can track timing of the
+    // collector.
+    subObjBuilder.appendDate(kFTDCCollectStartField,
+                             client->getServiceContext()->getClockSource()->now());
+
+    {
+        // Create a operation context per command so that we do not share operation contexts
+        // across multiple command invocations.
+        auto txn = client->makeOperationContext();
+
+        collector->collect(txn.get(), subObjBuilder);
+    }
+
+    subObjBuilder.appendDate(kFTDCCollectEndField,
+                             client->getServiceContext()->getClockSource()->now());
+}
+
+}  // namespace
+
+void FTDCCollectorCollection::add(std::unique_ptr<FTDCCollectorInterface> collector,
+                                  Milliseconds period) {
     // TODO: ensure the collectors all have unique names.
-    _collectors.emplace_back(std::move(collector));
+    invariant(period >= Milliseconds(0));
+    CollectorEntry entry;
+    entry.collector = std::move(collector);
+    entry.period = period;
+    _collectors.emplace_back(std::move(entry));
 }
 
 BSONObj FTDCCollectorCollection::collect(Client* client) {
     BSONObjBuilder builder;
 
-    for (auto& collector : _collectors) {
-        BSONObjBuilder subObjBuilder(builder.subobjStart(collector->name()));
-
-        // Add a Date_t before and after each BSON is collected so that we can track timing of the
-        // collector.
-        subObjBuilder.appendDate(kFTDCCollectStartField,
-                                 client->getServiceContext()->getClockSource()->now());
-
-        {
-            // Create a operation context per command so that we do not share operation contexts
-            // across multiple command invocations.
-            auto txn = client->makeOperationContext();
+    for (auto& entry : _collectors) {
+        if (entry.period == Milliseconds(0)) {
+            BSONObjBuilder subObjBuilder(builder.subobjStart(entry.collector->name()));
+            collectOne(client, entry.collector.get(), subObjBuilder);
+            continue;
+        }
 
-            collector->collect(txn.get(), subObjBuilder);
+        auto now = client->getServiceContext()->getClockSource()->now();
+        if (entry.lastSample.isEmpty() || now >= entry.nextCollection) {
+            BSONObjBuilder subObjBuilder;
+            collectOne(client, entry.collector.get(), subObjBuilder);
+            entry.lastSample = subObjBuilder.obj();
+            entry.nextCollection = FTDCUtil::roundTime(now, entry.period);
         }
 
-        subObjBuilder.appendDate(kFTDCCollectEndField,
-                                 client->getServiceContext()->getClockSource()->now());
+        builder.append(entry.collector->name(), entry.lastSample);
     }
 
     return builder.obj();
@@ -32,6 +32,8 @@
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -84,8 +86,14 @@ public:
     /**
      * Add a metric collector to the collection.
      * Must be called before collect. Cannot be called after collect is called.
+     *
+     * A collector with a non-zero period is only run once that period has elapsed since it last
+     * ran. Samples taken in between repeat its previous data, so the schema of the samples does not
+     * change and the repeated values compress to nothing. This lets expensive collectors run less
+     * often than the FTDC period.
      */
-    void add(std::unique_ptr<FTDCCollectorInterface> collector);
+    void add(std::unique_ptr<FTDCCollectorInterface> collector,
+             Milliseconds period = Milliseconds(0));
 
     /**
      * Collect a sample from all collectors. Called after all adding is complete.
@@ -102,8 +110,20 @@ public:
     BSONObj collect(Client* client);
 
 private:
+    struct CollectorEntry {
+        std::unique_ptr<FTDCCollectorInterface> collector;
+
+        // Minimum time between two runs of the collector, or zero to run it on every sample.
+        Milliseconds period;
+
+        // The next time the collector is due to run, and the data it returned last. Only used if
+        // period is non-zero.
+        Date_t nextCollection;
+        BSONObj lastSample;
+    };
+
     // collection of collectors
-    std::vector<std::unique_ptr<FTDCCollectorInterface>> _collectors;
+    std::vector<CollectorEntry> _collectors;
 };
 
 }  // namespace mongo
@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/client.h"
+#include "mongo/db/ftdc/collector.h"
+#include "mongo/db/ftdc/constants.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+class FTDCCountingCollector final : public FTDCCollectorInterface {
+public:
+    FTDCCountingCollector(std::string name, int* counter)
+        : _name(std::move(name)), _counter(counter) {}
+
+    void collect(OperationContext* txn, BSONObjBuilder& builder) final {
+        builder.append("count", ++*_counter);
+    }
+
+    std::string name() const final {
+        return _name;
+    }
+
+private:
+    std::string _name;
+    int* _counter;
+};
+
+// The clock of the FTDC unit tests always returns 37ms, so a collector with a longer period is
+// only due once.
+TEST(FTDCCollectorTest, CollectorPeriod) {
+    int everySample = 0;
+    int everySecond = 0;
+
+    FTDCCollectorCollection collectors;
+    collectors.add(stdx::make_unique<FTDCCountingCollector>("everySample", &everySample));
+    collectors.add(stdx::make_unique<FTDCCountingCollector>("everySecond", &everySecond),
+                   Milliseconds(1000));
+
+    for (int i = 1; i <= 3; i++) {
+        BSONObj sample = collectors.collect(&cc());
+        ASSERT_EQUALS(i, sample["everySample"]["count"].numberInt());
+        ASSERT_EQUALS(1, sample["everySecond"]["count"].numberInt());
+        ASSERT_TRUE(sample["everySecond"][kFTDCCollectStartField].type() == Date);
+        ASSERT_TRUE(sample["everySecond"][kFTDCCollectEndField].type() == Date);
+    }
+
+    ASSERT_EQUALS(3, everySample);
+    ASSERT_EQUALS(1, everySecond);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -81,12 +81,13 @@ void FTDCController::setMaxSamplesPerInterimMetricChunk(size_t size) {
     _condvar.notify_one();
 }
 
-void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector) {
+void FTDCController::addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector,
+                                          Milliseconds period) {
     {
         stdx::lock_guard<stdx::mutex> lock(_mutex);
         invariant(_state == State::kNotStarted);
 
-        _periodicCollectors.add(std::move(collector));
+        _periodicCollectors.add(std::move(collector), period);
     }
 }
 
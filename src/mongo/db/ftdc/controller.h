@@ -94,8 +94,12 @@ public:
 
     /**
      * Add a metric collector to collect periodically. i.e., serverStatus
+     *
+     * A non-zero period makes the collector run at most once per period instead of on every
+     * sample; see FTDCCollectorCollection::add.
      */
-    void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector);
+    void addPeriodicCollector(std::unique_ptr<FTDCCollectorInterface> collector,
+                              Milliseconds period = Milliseconds(0));
 
     /**
      * Add a collector to collect on server start, and file rotation. i.e. hostInfo
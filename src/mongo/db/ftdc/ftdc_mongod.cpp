@@ -107,6 +107,31 @@ public:
 
 } exportedFTDCPeriodParameter;
 
+// The replication collectors take locks and build large documents, so they can be sampled less
+// often than serverStatus. Zero samples them on every period.
+std::int32_t localReplicationPeriodMillis = 0;
+
+class ExportedFTDCReplicationPeriodParameter : public ExportedServerParameter<std::int32_t> {
+public:
+    ExportedFTDCReplicationPeriodParameter()
+        : ExportedServerParameter<std::int32_t>(ServerParameterSet::getGlobal(),
+                                                "diagnosticDataCollectionReplicationPeriodMillis",
+                                                &localReplicationPeriodMillis,
+                                                true,
+                                                false) {}
+
+    virtual Status validate(const std::int32_t& potentialNewValue) {
+        if (potentialNewValue < 0) {
+            return Status(ErrorCodes::BadValue,
+                          "diagnosticDataCollectionReplicationPeriodMillis must be greater than "
+                          "or equal to 0");
+        }
+
+        return Status::OK();
+    }
+
+} exportedFTDCReplicationPeriodParameter;
+
 // Scale the values down since are defaults are in bytes, but the user interface is MB
 std::int32_t localMaxDirectorySizeMB = FTDCConfig::kMaxDirectorySizeBytesDefault / (1024 * 1024);
 
@@ -312,13 +337,18 @@ void startFTDC() {
     // These metrics are only collected if replication is enabled
     if (repl::getGlobalReplicationCoordinator()->getReplicationMode() !=
         repl::ReplicationCoordinator::modeNone) {
+        const Milliseconds replicationPeriod(localReplicationPeriodMillis);
+
         // CmdReplSetGetStatus
         controller->addPeriodicCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
-            "replSetGetStatus", "replSetGetStatus", "", BSONObj()));
+                                             "replSetGetStatus", "replSetGetStatus", "", BSONObj()),
+                                         replicationPeriod);
 
         // CollectionStats
-        controller->addPeriodicCollector(stdx::make_unique<FTDCSimpleInternalCommandCollector>(
-            "collStats", "local.oplog.rs.stats", "local.oplog.rs", BSONObj()));
+        controller->addPeriodicCollector(
+            stdx::make_unique<FTDCSimpleInternalCommandCollector>(
+                "collStats", "local.oplog.rs.stats", "local.oplog.rs", BSONObj()),
+            replicationPeriod);
     }
 
     // Install file rotation collectors
@@ -30,6 +30,9 @@
 
 #include "mongo/db/fts/fts_unicode_tokenizer.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "mongo/db/fts/fts_query.h"
 #include "mongo/db/fts/fts_spec.h"
 #include "mongo/db/fts/stemmer.h"
@@ -44,6 +47,30 @@ namespace fts {
 
 using std::string;
 
+namespace {
+
+/**
+ * Returns true if no byte of 'str' has its high bit set, testing eight bytes at a time.
+ */
+bool isAscii(StringData str) {
+    const char* data = str.rawData();
+    const size_t size = str.size();
+    size_t i = 0;
+
+    uint64_t highBits = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        highBits |= word;
+    }
+    for (; i < size; ++i) {
+        highBits |= static_cast<unsigned char>(data[i]);
+    }
+    return (highBits & 0x8080808080808080ULL) == 0;
+}
+
+}  // namespace
+
 UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
     : _language(language), _stemmer(language), _stopWords(StopWords::getStopWords(language)) {
     if (_language->str() == "english") {
@@ -62,6 +89,15 @@ UnicodeFTSTokenizer::UnicodeFTSTokenizer(const FTSLanguage* language)
 void UnicodeFTSTokenizer::reset(StringData document, Options options) {
     _options = options;
     _pos = 0;
+
+    // Turkish lower cases 'I' to a dotless i, which is not ASCII.
+    _isAscii = _caseFoldMode == unicode::CaseFoldMode::kNormal && isAscii(document);
+    if (_isAscii) {
+        _asciiDocument.assign(document.rawData(), document.size());
+        _skipAsciiDelimiters();
+        return;
+    }
+
     _document.resetData(document);
 
     // Skip any leading delimiters (and handle the case where the document is entirely delimiters).
@@ -69,6 +105,10 @@ void UnicodeFTSTokenizer::reset(StringData document, Options options) {
 }
 
 bool UnicodeFTSTokenizer::moveNext() {
+    if (_isAscii) {
+        return _moveNextAscii();
+    }
+
     while (true) {
         if (_pos >= _document.size()) {
             _stem = "";
@@ -111,10 +151,70 @@ bool UnicodeFTSTokenizer::moveNext() {
     }
 }
 
+bool UnicodeFTSTokenizer::_moveNextAscii() {
+    while (true) {
+        if (_pos >= _asciiDocument.size()) {
+            _stem = "";
+            return false;
+        }
+
+        // Traverse through non-delimiters and build the next token.
+        size_t start = _pos++;
+        while (_pos < _asciiDocument.size() &&
+               (!unicode::codepointIsDelimiter(_asciiDocument[_pos], _delimListLanguage))) {
+            ++_pos;
+        }
+        const StringData token(_asciiDocument.data() + start, _pos - start);
+
+        // Skip the delimiters before the next token.
+        _skipAsciiDelimiters();
+
+        _asciiWord.resize(token.size());
+        for (size_t i = 0; i < token.size(); ++i) {
+            const char c = token[i];
+            _asciiWord[i] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+        }
+
+        if ((_options & kFilterStopWords) && _stopWords->isStopWord(_asciiWord)) {
+            continue;
+        }
+
+        if (_options & kGenerateCaseSensitiveTokens) {
+            _asciiWord.assign(token.rawData(), token.size());
+        }
+
+        _stem = _stemmer.stem(_asciiWord);
+
+        if (!(_options & kGenerateDiacriticSensitiveTokens)) {
+            if (isAscii(_stem)) {
+                // The only ASCII diacritics are marks of their own, such as '^', which removing
+                // diacritics drops.
+                _stem.erase(std::remove_if(_stem.begin(),
+                                           _stem.end(),
+                                           [](char c) { return unicode::codepointIsDiacritic(c); }),
+                            _stem.end());
+            } else {
+                _tokenBuf.resetData(_stem);
+                _tokenBuf.removeDiacriticsToBuf(_wordBuf);
+                _stem = _wordBuf.toString();
+            }
+        }
+
+        return true;
+    }
+}
+
 StringData UnicodeFTSTokenizer::get() const {
     return _stem;
 }
 
+void UnicodeFTSTokenizer::_skipAsciiDelimiters() {
+    while (_pos < _asciiDocument.size() &&
+           unicode::codepointIsDelimiter(_asciiDocument[_pos], _delimListLanguage)) {
+        ++_pos;
+    }
+}
+
 void UnicodeFTSTokenizer::_skipDelimiters() {
     while (_pos < _document.size() &&
            unicode::codepointIsDelimiter(_document[_pos], _delimListLanguage)) {
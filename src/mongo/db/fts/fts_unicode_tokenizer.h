@@ -35,6 +35,8 @@
 #include "mongo/db/fts/tokenizer.h"
 #include "mongo/db/fts/unicode/string.h"
 
+#include <string>
+
 namespace mongo {
 namespace fts {
 
@@ -73,6 +75,14 @@ private:
      */
     void _skipDelimiters();
 
+    /**
+     * moveNext() for a document made only of ASCII characters, which is tokenized, lower cased and
+     * stripped of diacritics in place rather than after converting it to UTF-32.
+     */
+    bool _moveNextAscii();
+
+    void _skipAsciiDelimiters();
+
     unicode::DelimiterListLanguage _delimListLanguage;
     unicode::CaseFoldMode _caseFoldMode;
 
@@ -83,6 +93,12 @@ private:
     unicode::String _document;
     size_t _pos;
 
+    // Set instead of _document when the document is all ASCII and the language folds case the
+    // usual way.
+    bool _isAscii = false;
+    std::string _asciiDocument;
+    std::string _asciiWord;
+
     unicode::String _tokenBuf;
     unicode::String _wordBuf;
 
@@ -239,5 +239,27 @@ TEST(FtsUnicodeTokenizer, FrenchStopWordsAndDiacriticSensitive) {
     ASSERT_EQUALS("excit", terms[4]);
 }
 
+// Ensure that an ASCII document, which is tokenized without converting it to UTF-32, gives the
+// same terms as it does with a non-ASCII word appended.
+TEST(FtsUnicodeTokenizer, AsciiDocumentMatchesUnicodeDocument) {
+    const char* ascii = "The QUICK brown Foxes, jumping over Mark's dogs^ 42 times";
+    const std::string unicode = std::string(ascii) + " caf\xc3\xa9";
+
+    for (auto options : {FTSTokenizer::kNone,
+                         FTSTokenizer::kFilterStopWords,
+                         FTSTokenizer::kGenerateCaseSensitiveTokens,
+                         FTSTokenizer::kGenerateDiacriticSensitiveTokens}) {
+        for (auto language : {"english", "french", "turkish"}) {
+            std::vector<std::string> asciiTerms = tokenizeString(ascii, language, options);
+            std::vector<std::string> unicodeTerms =
+                tokenizeString(unicode.c_str(), language, options);
+
+            ASSERT_EQUALS(asciiTerms.size() + 1, unicodeTerms.size());
+            unicodeTerms.pop_back();
+            ASSERT_TRUE(asciiTerms == unicodeTerms);
+        }
+    }
+}
+
 }  // namespace fts
 }  // namespace mongo
@@ -28,10 +28,19 @@
 *    it in the license file.
 */
 
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/fts/stemmer.h"
+
 #include <cstdlib>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <vector>
 
-#include "mongo/db/fts/stemmer.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/concurrency/threadlocal.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -40,32 +49,104 @@ namespace fts {
 
 using std::string;
 
-Stemmer::Stemmer(const FTSLanguage* language) {
-    _stemmer = NULL;
-    if (language->str() != "none")
-        _stemmer = sb_stemmer_new(language->str().c_str(), "UTF_8");
-}
+namespace {
+
+// The number of words whose stems each thread caches, per language. A power of two.
+const size_t kStemCacheSize = 4096;
+
+// Longer words are stemmed without going through the cache.
+const size_t kMaxCachedWordSize = 32;
+
+/**
+ * The snowball stemmer of a language for one thread, with a direct-mapped cache of the stems of
+ * the words it has recently stemmed.
+ */
+class ThreadStemmer {
+    MONGO_DISALLOW_COPYING(ThreadStemmer);
+
+public:
+    explicit ThreadStemmer(const FTSLanguage* language)
+        : _stemmer(sb_stemmer_new(language->str().c_str(), "UTF_8")), _cache(kStemCacheSize) {}
 
-Stemmer::~Stemmer() {
-    if (_stemmer) {
-        sb_stemmer_delete(_stemmer);
-        _stemmer = NULL;
+    ~ThreadStemmer() {
+        if (_stemmer) {
+            sb_stemmer_delete(_stemmer);
+        }
     }
-}
 
-string Stemmer::stem(StringData word) const {
-    if (!_stemmer)
-        return word.toString();
+    string stem(StringData word) {
+        if (!_stemmer) {
+            return word.toString();
+        }
+        if (word.size() > kMaxCachedWordSize) {
+            return _stem(word);
+        }
+
+        CacheEntry& entry = _cache[StringData::Hasher()(word) & (kStemCacheSize - 1)];
+        if (!entry.valid || word != entry.word) {
+            entry.word = word.toString();
+            entry.stem = _stem(word);
+            entry.valid = true;
+        }
+        return entry.stem;
+    }
+
+private:
+    struct CacheEntry {
+        bool valid = false;
+        string word;
+        string stem;
+    };
 
-    const sb_symbol* sb_sym =
-        sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
+    string _stem(StringData word) {
+        const sb_symbol* sb_sym =
+            sb_stemmer_stem(_stemmer, (const sb_symbol*)word.rawData(), word.size());
 
-    if (sb_sym == NULL) {
-        // out of memory
-        invariant(false);
+        if (sb_sym == NULL) {
+            // out of memory
+            invariant(false);
+        }
+
+        return string((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    }
+
+    struct sb_stemmer* const _stemmer;
+    std::vector<CacheEntry> _cache;
+};
+
+struct ThreadStemmers {
+    std::unordered_map<const FTSLanguage*, std::unique_ptr<ThreadStemmer>> byLanguage;
+};
+
+}  // namespace
+}  // namespace fts
+
+TSP_DECLARE(fts::ThreadStemmers, threadStemmers);
+TSP_DEFINE(fts::ThreadStemmers, threadStemmers);
+
+namespace fts {
+namespace {
+
+ThreadStemmer* getThreadStemmer(const FTSLanguage* language) {
+    auto& stemmer = threadStemmers.getMake()->byLanguage[language];
+    if (!stemmer) {
+        stemmer = stdx::make_unique<ThreadStemmer>(language);
     }
+    return stemmer.get();
+}
+
+}  // namespace
+
+Stemmer::Stemmer(const FTSLanguage* language)
+    : _language(language->str() != "none" ? language : NULL) {}
+
+Stemmer::~Stemmer() {}
+
+string Stemmer::stem(StringData word) const {
+    if (!_language)
+        return word.toString();
 
-    return string((const char*)(sb_sym), sb_stemmer_length(_stemmer));
+    return getThreadStemmer(_language)->stem(word);
 }
 }
 }
@@ -45,6 +45,10 @@ namespace fts {
  * maintains case
  * but works
  * running/Running -> run/Run
+ *
+ * The snowball stemmers themselves are kept per thread and language, along with a cache of the
+ * stems of the words they stemmed last, so constructing a Stemmer is cheap and the common words
+ * of a text are only stemmed once per thread.
  */
 class Stemmer {
     MONGO_DISALLOW_COPYING(Stemmer);
@@ -56,7 +60,8 @@ public:
     std::string stem(StringData word) const;
 
 private:
-    struct sb_stemmer* _stemmer;
+    // NULL for the language "none", which does not stem.
+    const FTSLanguage* _language;
 };
 }
 }
@@ -48,5 +48,17 @@ TEST(English, Caps) {
     ASSERT_EQUALS("unit", s.stem("united"));
     ASSERT_EQUALS("Unite", s.stem("United"));
 }
+
+TEST(English, CachedStems) {
+    Stemmer english(&languageEnglishV2);
+    Stemmer french(&languageFrenchV2);
+    const std::string longWord(100, 'a');
+    for (int i = 0; i < 3; i++) {
+        ASSERT_EQUALS("run", english.stem("running"));
+        ASSERT_EQUALS("continu", french.stem("continuer"));
+        ASSERT_EQUALS("Run", english.stem("Running"));
+        ASSERT_EQUALS(longWord, english.stem(longWord));
+    }
+}
 }
 }
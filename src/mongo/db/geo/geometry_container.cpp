@@ -31,6 +31,7 @@
 #include "mongo/db/geo/geoconstants.h"
 #include "mongo/db/geo/geoparser.h"
 #include "mongo/util/mongoutils/str.h"
+#include "third_party/s2/s2regioncoverer.h"
 
 namespace mongo {
 
@@ -373,6 +374,12 @@ bool containsPoint(const S2Polygon& poly, const S2Cell& otherCell, const S2Point
 
 bool GeometryContainer::contains(const S2Cell& otherCell, const S2Point& otherPoint) const {
     if (NULL != _polygon && (NULL != _polygon->s2Polygon)) {
+        if (_polygonExterior && !_polygonExterior->Contains(otherPoint)) {
+            return false;
+        }
+        if (_polygonInterior && _polygonInterior->Contains(otherPoint)) {
+            return true;
+        }
         return containsPoint(*_polygon->s2Polygon, otherCell, otherPoint);
     }
 
@@ -616,6 +623,12 @@ bool GeometryContainer::intersects(const S2Cell& otherPoint) const {
     } else if (NULL != _line) {
         return _line->line.MayIntersect(otherPoint);
     } else if (NULL != _polygon && NULL != _polygon->s2Polygon) {
+        if (_polygonExterior && !_polygonExterior->Contains(otherPoint.id())) {
+            return false;
+        }
+        if (_polygonInterior && _polygonInterior->Contains(otherPoint.id())) {
+            return true;
+        }
         return _polygon->s2Polygon->MayIntersect(otherPoint);
     } else if (NULL != _polygon && NULL != _polygon->bigPolygon) {
         return _polygon->bigPolygon->MayIntersect(otherPoint);
@@ -1001,9 +1014,40 @@ Status GeometryContainer::parseFromQuery(const BSONElement& elem) {
         _r2Region.reset(new R2BoxRegion(this));
     }
 
+    preparePolygon();
+
     return status;
 }
 
+namespace {
+// Query polygons with fewer vertices are cheap enough to test points against directly.
+const int kMinVerticesToPrepare = 256;
+// How many cells the interior and exterior coverings of a query polygon have at most.
+const int kMaxPreparedCells = 256;
+}  // namespace
+
+void GeometryContainer::preparePolygon() {
+    if (NULL == _polygon || NULL == _polygon->s2Polygon ||
+        _polygon->s2Polygon->num_vertices() < kMinVerticesToPrepare) {
+        return;
+    }
+
+    // The coverings cost about as much as testing a few hundred points, once per query, and
+    // save testing the edges of the polygon for every point which is not near them.
+    S2RegionCoverer coverer;
+    coverer.set_max_cells(kMaxPreparedCells);
+    vector<S2CellId> cells;
+
+    coverer.GetInteriorCovering(*_polygon->s2Polygon, &cells);
+    _polygonInterior.reset(new S2CellUnion());
+    _polygonInterior->InitSwap(&cells);
+
+    cells.clear();
+    coverer.GetCovering(*_polygon->s2Polygon, &cells);
+    _polygonExterior.reset(new S2CellUnion());
+    _polygonExterior->InitSwap(&cells);
+}
+
 // Examples:
 // { location: <GeoJSON> }
 // { location: [1, 2] }
@@ -32,6 +32,7 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/geo/shapes.h"
+#include "third_party/s2/s2cellunion.h"
 #include "third_party/s2/s2regionunion.h"
 
 namespace mongo {
@@ -128,6 +129,9 @@ private:
 
     Status parseFromGeoJSON(const BSONObj& obj, bool skipValidation = false);
 
+    // Covers the interior and the exterior of a query polygon with many vertices.
+    void preparePolygon();
+
     // Does 'this' intersect with the provided type?
     bool intersects(const S2Cell& otherPoint) const;
     bool intersects(const S2Polyline& otherLine) const;
@@ -160,6 +164,11 @@ private:
     // TODO: _s2Region is currently generated immediately - don't necessarily need to do this
     std::unique_ptr<S2RegionUnion> _s2Region;
     std::unique_ptr<R2Region> _r2Region;
+
+    // For a query polygon with many vertices, cells inside the polygon and cells covering all of
+    // it. They let most points be classified without testing them against the polygon's edges.
+    std::unique_ptr<S2CellUnion> _polygonInterior;
+    std::unique_ptr<S2CellUnion> _polygonExterior;
 };
 
 }  // namespace mongo
@@ -29,13 +29,15 @@
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
 
 #include "mongo/db/global_timestamp.h"
-#include "mongo/stdx/mutex.h"
-#include "mongo/stdx/thread.h"
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
 
 namespace {
-mongo::stdx::mutex globalTimestampMutex;
-mongo::Timestamp globalTimestamp(0, 0);
+// The last Timestamp handed out or set, packed as Timestamp::asULL() so that it can be advanced
+// with a single compare-and-swap instead of under a mutex.
+mongo::AtomicUInt64 globalTimestamp(0);
 
 bool skewed(const mongo::Timestamp& val) {
     if (val.getInc() & 0x80000000) {
@@ -50,30 +52,48 @@ bool skewed(const mongo::Timestamp& val) {
 
 namespace mongo {
 void setGlobalTimestamp(const Timestamp& newTime) {
-    stdx::lock_guard<stdx::mutex> lk(globalTimestampMutex);
-    globalTimestamp = newTime;
+    globalTimestamp.store(newTime.asULL());
 }
 
 Timestamp getLastSetTimestamp() {
-    stdx::lock_guard<stdx::mutex> lk(globalTimestampMutex);
-    return globalTimestamp;
+    return Timestamp(globalTimestamp.load());
 }
 
 Timestamp getNextGlobalTimestamp() {
-    stdx::lock_guard<stdx::mutex> lk(globalTimestampMutex);
+    return getNextGlobalTimestamps(1);
+}
+
+Timestamp getNextGlobalTimestamps(unsigned count) {
+    invariant(count > 0);
 
     const unsigned now = (unsigned)time(0);
-    const unsigned globalSecs = globalTimestamp.getSecs();
-    if (globalSecs == now) {
-        globalTimestamp = Timestamp(globalSecs, globalTimestamp.getInc() + 1);
-    } else if (now < globalSecs) {
-        globalTimestamp = Timestamp(globalSecs, globalTimestamp.getInc() + 1);
-        // separate function to keep out of the hot code path
-        fassert(17449, !skewed(globalTimestamp));
-    } else {
-        globalTimestamp = Timestamp(now, 1);
-    }
+    unsigned long long current = globalTimestamp.load();
+    while (true) {
+        const Timestamp prev(current);
+        const unsigned globalSecs = prev.getSecs();
+        Timestamp first;
+        Timestamp last;
+        if (globalSecs >= now) {
+            first = Timestamp(globalSecs, prev.getInc() + 1);
+            last = Timestamp(globalSecs, prev.getInc() + count);
+        } else {
+            first = Timestamp(now, 1);
+            last = Timestamp(now, count);
+        }
 
-    return globalTimestamp;
+        const unsigned long long seen = globalTimestamp.compareAndSwap(current, last.asULL());
+        if (seen != current) {
+            // Another thread allocated in between, retry on top of what it reserved.
+            current = seen;
+            continue;
+        }
+
+        if (globalSecs > now) {
+            // separate function to keep out of the hot code path
+            fassert(17449, !skewed(last));
+        }
+
+        return first;
+    }
 }
 }
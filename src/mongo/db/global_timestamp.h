@@ -42,4 +42,11 @@ Timestamp getLastSetTimestamp();
  * Generates a new and unique Timestamp.
  */
 Timestamp getNextGlobalTimestamp();
+
+/**
+ * Reserves 'count' (which must be positive) consecutive Timestamps that share the same seconds
+ * value and have increments first.getInc() .. first.getInc() + count - 1, and returns the first.
+ * Safe to call concurrently; no Timestamp is ever handed out twice.
+ */
+Timestamp getNextGlobalTimestamps(unsigned count);
 }
@@ -40,8 +40,6 @@
 
 namespace mongo {
 
-using std::unique_ptr;
-
 Hasher::Hasher(HashSeed seed) : _seed(seed) {
     md5_init(&_md5State);
     md5_append(&_md5State, reinterpret_cast<const md5_byte_t*>(&_seed), sizeof(_seed));
@@ -56,10 +54,12 @@ void Hasher::finish(HashDigest out) {
 }
 
 long long int BSONElementHasher::hash64(const BSONElement& e, HashSeed seed) {
-    unique_ptr<Hasher> h(HasherFactory::createHasher(seed));
-    recursiveHash(h.get(), e, false);
+    // This is called for every hashed index key and every hashed shard key a router extracts, so
+    // the hasher lives on the stack rather than coming from HasherFactory.
+    Hasher h(seed);
+    recursiveHash(&h, e, false);
     HashDigest d;
-    h->finish(d);
+    h.finish(d);
     // HashDigest is actually 16 bytes, but we just read 8 bytes
     ConstDataView digestView(reinterpret_cast<const char*>(d));
     return digestView.read<LittleEndian<long long int>>();
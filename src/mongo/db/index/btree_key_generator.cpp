@@ -26,8 +26,10 @@
 *    it in the license file.
 */
 
-#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/db/index/btree_key_generator.h"
+
+#include "mongo/bson/bson_field_index.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -43,6 +45,29 @@ const BSONElement nullElt = nullObj.firstElement();
 const BSONObj undefinedObj = BSON("" << BSONUndefined);
 const BSONElement undefinedElt = undefinedObj.firstElement();
 
+/**
+ * Builds the key made of the values in 'fixed' in 'scratch', and adds an owned copy of it to
+ * 'keys' unless an equal key is already there. A document with a multikey path commonly yields
+ * the same key more than once, and building in a reused buffer means only the distinct keys
+ * are allocated, and at their exact size.
+ */
+void addKey(const std::vector<BSONElement>& fixed, StackBufBuilder* scratch, BSONObjSet* keys) {
+    scratch->reset();
+    scratch->skip(sizeof(int));
+    for (const auto& elt : fixed) {
+        scratch->appendNum(static_cast<char>(elt.type()));
+        scratch->appendStr("");
+        scratch->appendBuf(elt.value(), elt.valuesize());
+    }
+    scratch->appendNum(static_cast<char>(EOO));
+    DataView(scratch->buf()).write(tagLittleEndian(scratch->len()));
+
+    BSONObj key(scratch->buf());
+    if (keys->find(key) == keys->end()) {
+        keys->insert(key.copy());
+    }
+}
+
 }  // namespace
 
 BtreeKeyGenerator::BtreeKeyGenerator(std::vector<const char*> fieldNames,
@@ -213,11 +238,14 @@ BtreeKeyGeneratorV1::BtreeKeyGeneratorV1(std::vector<const char*> fieldNames,
     : BtreeKeyGenerator(fieldNames, fixed, isSparse), _emptyPositionalInfo(fieldNames.size()) {}
 
 BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
+                                                    const BSONFieldIndex* objIndex,
                                                     const PositionalPathInfo& positionalInfo,
                                                     const char** field,
                                                     bool* arrayNestedArray) const {
-    std::string firstField = mongoutils::str::before(*field, '.');
-    bool haveObjField = !obj.getField(firstField).eoo();
+    const char* dot = strchr(*field, '.');
+    StringData firstField = dot ? StringData(*field, dot - *field) : StringData(*field);
+    BSONElement firstElt = objIndex ? objIndex->getField(firstField) : obj.getField(firstField);
+    bool haveObjField = !firstElt.eoo();
     BSONElement arrField = positionalInfo.positionallyIndexedElt;
 
     // An index component field name cannot exist in both a document
@@ -231,7 +259,19 @@ BSONElement BtreeKeyGeneratorV1::extractNextElement(const BSONObj& obj,
 
     *arrayNestedArray = false;
     if (haveObjField) {
-        return obj.getFieldDottedOrArray(*field);
+        // Continue the traversal from the first path component, as getFieldDottedOrArray()
+        // would, rather than looking it up in 'obj' a second time.
+        if (!dot) {
+            *field += firstField.size();
+            return firstElt;
+        }
+        *field = dot + 1;
+        if (firstElt.type() == Array || **field == '\0') {
+            return firstElt;
+        } else if (firstElt.type() == Object) {
+            return firstElt.embeddedObject().getFieldDottedOrArray(*field);
+        }
+        return BSONElement();
     } else if (positionalInfo.hasPositionallyIndexedElt()) {
         if (arrField.type() == Array) {
             *arrayNestedArray = true;
@@ -251,7 +291,8 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(
     const BSONElement& arrObjElt,
     const std::set<unsigned>& arrIdxs,
     bool mayExpandArrayUnembedded,
-    const std::vector<PositionalPathInfo>& positionalInfo) const {
+    const std::vector<PositionalPathInfo>& positionalInfo,
+    StackBufBuilder* scratch) const {
     // Set up any terminal array values.
     for (std::set<unsigned>::const_iterator j = arrIdxs.begin(); j != arrIdxs.end(); ++j) {
         unsigned idx = *j;
@@ -260,20 +301,46 @@ void BtreeKeyGeneratorV1::_getKeysArrEltFixed(
         }
     }
 
+    // If every field path has been traversed to its end, the recursive call would only build
+    // the key from 'fixed', so build it here without copying 'fieldNames' and 'fixed'.
+    bool allFieldsFixed = true;
+    for (const char* fieldName : *fieldNames) {
+        if (*fieldName != '\0') {
+            allFieldsFixed = false;
+            break;
+        }
+    }
+    if (allFieldsFixed) {
+        if (!_isSparse || numNotFound != fieldNames->size()) {
+            addKey(*fixed, scratch, keys);
+        }
+        return;
+    }
+
     // Recurse.
     getKeysImplWithArray(*fieldNames,
                          *fixed,
                          arrEntry.type() == Object ? arrEntry.embeddedObject() : BSONObj(),
                          keys,
                          numNotFound,
-                         positionalInfo);
+                         positionalInfo,
+                         scratch);
 }
 
 void BtreeKeyGeneratorV1::getKeysImpl(std::vector<const char*> fieldNames,
                                       std::vector<BSONElement> fixed,
                                       const BSONObj& obj,
                                       BSONObjSet* keys) const {
-    getKeysImplWithArray(fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo);
+    StackBufBuilder scratch;
+    if (fieldNames.size() > 1) {
+        // Several fields are looked up in the same document, so index its top-level fields in
+        // case it is wide.
+        BSONFieldIndex objIndex(obj);
+        getKeysImplWithArray(
+            fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo, &scratch, &objIndex);
+        return;
+    }
+    getKeysImplWithArray(fieldNames, fixed, obj, keys, 0, _emptyPositionalInfo, &scratch);
 }
 
 void BtreeKeyGeneratorV1::getKeysImplWithArray(
@@ -282,7 +349,9 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
     const BSONObj& obj,
     BSONObjSet* keys,
     unsigned numNotFound,
-    const std::vector<PositionalPathInfo>& positionalInfo) const {
+    const std::vector<PositionalPathInfo>& positionalInfo,
+    StackBufBuilder* scratch,
+    const BSONFieldIndex* objIndex) const {
     BSONElement arrElt;
     std::set<unsigned> arrIdxs;
     bool mayExpandArrayUnembedded = true;
@@ -293,8 +362,8 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
 
         bool arrayNestedArray;
         // Extract element matching fieldName[ i ] from object xor array.
-        BSONElement e =
-            extractNextElement(obj, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
+        BSONElement e = extractNextElement(
+            obj, objIndex, positionalInfo[i], &fieldNames[i], &arrayNestedArray);
 
         if (e.eoo()) {
             // if field not present, set to null
@@ -325,11 +394,7 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
         if (_isSparse && numNotFound == fieldNames.size()) {
             return;
         }
-        BSONObjBuilder b(_sizeTracker);
-        for (std::vector<BSONElement>::iterator i = fixed.begin(); i != fixed.end(); ++i) {
-            b.appendAs(*i, "");
-        }
-        keys->insert(b.obj());
+        addKey(fixed, scratch, keys);
     } else if (arrElt.embeddedObject().firstElement().eoo()) {
         // Empty array, so set matching fields to undefined.
         _getKeysArrEltFixed(&fieldNames,
@@ -340,7 +405,8 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
                             arrElt,
                             arrIdxs,
                             true,
-                            _emptyPositionalInfo);
+                            _emptyPositionalInfo,
+                            scratch);
     } else {
         BSONObj arrObj = arrElt.embeddedObject();
 
@@ -382,7 +448,8 @@ void BtreeKeyGeneratorV1::getKeysImplWithArray(
                                 arrElt,
                                 arrIdxs,
                                 mayExpandArrayUnembedded,
-                                subPositionalInfo);
+                                subPositionalInfo,
+                                scratch);
         }
     }
 }
@@ -34,6 +34,8 @@
 
 namespace mongo {
 
+class BSONFieldIndex;
+
 /**
  * Internal class used by BtreeAccessMethod to generate keys for indexed documents.
  * This class is meant to be kept under the index access layer.
@@ -162,13 +164,21 @@ private:
 
     /**
      * This recursive method does the heavy-lifting for getKeysImpl().
+     *
+     * Keys are built in 'scratch', which is reused for every key of the document, and only
+     * copied out when they are added to 'keys'.
+     *
+     * If 'objIndex' is non-null, it indexes the top-level fields of 'obj' and is used to look
+     * up the first component of each field path.
      */
     void getKeysImplWithArray(std::vector<const char*> fieldNames,
                               std::vector<BSONElement> fixed,
                               const BSONObj& obj,
                               BSONObjSet* keys,
                               unsigned numNotFound,
-                              const std::vector<PositionalPathInfo>& positionalInfo) const;
+                              const std::vector<PositionalPathInfo>& positionalInfo,
+                              StackBufBuilder* scratch,
+                              const BSONFieldIndex* objIndex = nullptr) const;
     /**
      * A call to getKeysImplWithArray() begins by calling this for each field in the key
      * pattern. It uses getFieldDottedOrArray() to traverse the path '*field' in 'obj'.
@@ -202,6 +212,7 @@ private:
      *   the second array element.
      */
     BSONElement extractNextElement(const BSONObj& obj,
+                                   const BSONFieldIndex* objIndex,
                                    const PositionalPathInfo& positionalInfo,
                                    const char** field,
                                    bool* arrayNestedArray) const;
@@ -209,7 +220,8 @@ private:
     /**
      * Sets extracted elements in 'fixed' for field paths that we have traversed to the end.
      *
-     * Then calls getKeysImplWithArray() recursively.
+     * Then calls getKeysImplWithArray() recursively, or adds the key directly if every field
+     * path has been traversed to its end.
      */
     void _getKeysArrEltFixed(std::vector<const char*>* fieldNames,
                              std::vector<BSONElement>* fixed,
@@ -219,7 +231,8 @@ private:
                              const BSONElement& arrObjElt,
                              const std::set<unsigned>& arrIdxs,
                              bool mayExpandArrayUnembedded,
-                             const std::vector<PositionalPathInfo>& positionalInfo) const;
+                             const std::vector<PositionalPathInfo>& positionalInfo,
+                             StackBufBuilder* scratch) const;
 
     const std::vector<PositionalPathInfo> _emptyPositionalInfo;
 };
@@ -138,6 +138,15 @@ TEST(BtreeKeyGeneratorTest, GetKeysFromArraySimple) {
     ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys));
 }
 
+TEST(BtreeKeyGeneratorTest, GetKeysFromArrayWithDuplicateValues) {
+    BSONObj keyPattern = fromjson("{a: 1, b: 1}");
+    BSONObj genKeysFrom = fromjson("{a: [1, 2, 1, 2, 1], b: 'x'}");
+    BSONObjSet expectedKeys;
+    expectedKeys.insert(fromjson("{'': 1, '': 'x'}"));
+    expectedKeys.insert(fromjson("{'': 2, '': 'x'}"));
+    ASSERT(testKeygen(keyPattern, genKeysFrom, expectedKeys));
+}
+
 TEST(BtreeKeyGeneratorTest, GetKeysFromArrayFirstElement) {
     BSONObj keyPattern = fromjson("{a: 1, b: 1}");
     BSONObj genKeysFrom = fromjson("{a: [1, 2, 3], b: 2}");
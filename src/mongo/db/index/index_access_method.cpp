@@ -32,16 +32,20 @@
 
 #include "mongo/db/index/btree_access_method.h"
 
+#include <algorithm>
 #include <vector>
 
 #include "mongo/base/error_codes.h"
 #include "mongo/base/status.h"
 #include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
 #include "mongo/db/curop.h"
+#include "mongo/db/index_names.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/keypattern.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/util/log.h"
@@ -55,6 +59,9 @@ using std::vector;
 
 MONGO_EXPORT_SERVER_PARAMETER(failIndexKeyTooLong, bool, true);
 
+// commitBulk() adds up to this many keys to the index in each unit of work.
+MONGO_EXPORT_SERVER_PARAMETER(internalIndexBulkBuildKeysPerUnitOfWork, int, 1000);
+
 //
 // Comparison for external sorter interface
 //
@@ -96,6 +103,39 @@ bool IndexAccessMethod::ignoreKeyTooLong(OperationContext* txn) {
     return !txn->isPrimaryFor(_btreeState->ns()) || !failIndexKeyTooLong;
 }
 
+namespace {
+bool pathHasArray(const BSONObj& obj, StringData path) {
+    const size_t dot = path.find('.');
+    const BSONElement elem = obj[path.substr(0, dot)];
+    if (elem.type() == Array) {
+        return true;
+    }
+    if (dot == std::string::npos || elem.type() != Object) {
+        return false;
+    }
+    return pathHasArray(elem.Obj(), path.substr(dot + 1));
+}
+}  // namespace
+
+unsigned long long IndexAccessMethod::getMultikeyComponents(const BSONObj& obj) const {
+    // Other access methods generate several keys for documents without arrays.
+    if (IndexNames::BTREE != IndexNames::findPluginName(_descriptor->keyPattern())) {
+        return IndexCatalogEntry::kAllMultikeyComponents;
+    }
+
+    unsigned long long components = 0;
+    int position = 0;
+    for (auto&& field : _descriptor->keyPattern()) {
+        // Compound indexes have at most 32 fields.
+        invariant(position < 64);
+        if (pathHasArray(obj, field.fieldNameStringData())) {
+            components |= 1ULL << position;
+        }
+        position++;
+    }
+    return components;
+}
+
 // Find the keys for obj, put them in the tree pointing to loc
 Status IndexAccessMethod::insert(OperationContext* txn,
                                  const BSONObj& obj,
@@ -143,12 +183,62 @@ Status IndexAccessMethod::insert(OperationContext* txn,
     }
 
     if (*numInserted > 1) {
-        _btreeState->setMultikey(txn);
+        _btreeState->setMultikey(txn, getMultikeyComponents(obj));
     }
 
     return ret;
 }
 
+Status IndexAccessMethod::insertBatch(OperationContext* txn,
+                                      const std::vector<BsonRecord>& records,
+                                      const InsertDeleteOptions& options,
+                                      int64_t* numInserted) {
+    *numInserted = 0;
+
+    // Background index builds tolerate duplicate keys and failIndexKeyTooLong=false skips keys
+    // which are too long, both key by key, so those cases take the one-at-a-time path.
+    if (!_btreeState->isReady(txn) || ignoreKeyTooLong(txn)) {
+        for (const auto& record : records) {
+            int64_t inserted;
+            Status status = insert(txn, *record.docPtr, record.id, options, &inserted);
+            if (!status.isOK())
+                return status;
+            *numInserted += inserted;
+        }
+        return Status::OK();
+    }
+
+    std::vector<IndexKeyEntry> entries;
+    entries.reserve(records.size());
+    bool isMultikey = false;
+    unsigned long long multikeyComponents = 0;
+    for (const auto& record : records) {
+        BSONObjSet keys;
+        getKeys(*record.docPtr, &keys);
+        if (keys.size() > 1) {
+            isMultikey = true;
+            multikeyComponents |= getMultikeyComponents(*record.docPtr);
+        }
+        for (const auto& key : keys) {
+            entries.emplace_back(key, record.id);
+        }
+    }
+
+    std::sort(entries.begin(),
+              entries.end(),
+              IndexEntryComparison(Ordering::make(_descriptor->keyPattern())));
+
+    Status status = _newInterface->insertKeys(txn, entries, options.dupsAllowed);
+    if (!status.isOK())
+        return status;
+
+    *numInserted = entries.size();
+    if (isMultikey) {
+        _btreeState->setMultikey(txn, multikeyComponents);
+    }
+    return Status::OK();
+}
+
 void IndexAccessMethod::removeOneKey(OperationContext* txn,
                                      const BSONObj& key,
                                      const RecordId& loc,
@@ -274,6 +364,8 @@ Status IndexAccessMethod::validateUpdate(OperationContext* txn,
         getKeys(from, &ticket->oldKeys);
     if (indexFilter == NULL || indexFilter->matchesBSON(to))
         getKeys(to, &ticket->newKeys);
+    if (ticket->newKeys.size() > 1)
+        ticket->multikeyComponents = getMultikeyComponents(to);
     ticket->loc = record;
     ticket->dupsAllowed = options.dupsAllowed;
 
@@ -293,7 +385,7 @@ Status IndexAccessMethod::update(OperationContext* txn,
     }
 
     if (ticket.oldKeys.size() + ticket.added.size() - ticket.removed.size() > 1) {
-        _btreeState->setMultikey(txn);
+        _btreeState->setMultikey(txn, ticket.multikeyComponents);
     }
 
     for (size_t i = 0; i < ticket.removed.size(); ++i) {
@@ -328,7 +420,8 @@ IndexAccessMethod::BulkBuilder::BulkBuilder(const IndexAccessMethod* index,
           SortOptions()
               .TempDir(storageGlobalParams.dbpath + "/_tmp")
               .ExtSortAllowed()
-              .MaxMemoryUsageBytes(100 * 1024 * 1024),
+              .MaxMemoryUsageBytes(100 * 1024 * 1024)
+              .SpillThreads(std::max(internalQueryExecSorterSpillThreads, 0)),
           BtreeExternalSortComparison(descriptor->keyPattern(), descriptor->version()))),
       _real(index) {}
 
@@ -340,7 +433,10 @@ Status IndexAccessMethod::BulkBuilder::insert(OperationContext* txn,
     BSONObjSet keys;
     _real->getKeys(obj, &keys);
 
-    _isMultiKey = _isMultiKey || (keys.size() > 1);
+    if (keys.size() > 1) {
+        _isMultiKey = true;
+        _multikeyComponents |= _real->getMultikeyComponents(obj);
+    }
 
     for (BSONObjSet::iterator it = keys.begin(); it != keys.end(); ++it) {
         _sorter->add(*it, loc);
@@ -377,7 +473,7 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
         WriteUnitOfWork wunit(txn);
 
         if (bulk->_isMultiKey) {
-            _btreeState->setMultikey(txn);
+            _btreeState->setMultikey(txn, bulk->_multikeyComponents);
         }
 
         builder.reset(_newInterface->getBulkBuilder(txn, dupsAllowed));
@@ -385,11 +481,11 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
     }
     MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "setting index multikey flag", "");
 
+    const int keysPerUnitOfWork = std::max(1, internalIndexBulkBuildKeysPerUnitOfWork);
     while (i->more()) {
-        if (mayInterrupt) {
-            txn->checkForInterrupt();
-        }
-
+        // Adding a batch of keys in each unit of work saves committing one for every key. On
+        // mmapv1, that commit declares the modified bucket to the journal each time, although the
+        // bucket is usually the same one as for the previous key.
         WriteUnitOfWork wunit(txn);
         // Improve performance in the btree-building phase by disabling rollback tracking.
         // This avoids copying all the written bytes to a buffer that is only used to roll back.
@@ -397,32 +493,40 @@ Status IndexAccessMethod::commitBulk(OperationContext* txn,
         // up by the index system.
         txn->recoveryUnit()->setRollbackWritesDisabled();
 
-        // Get the next datum and add it to the builder.
-        BulkBuilder::Sorter::Data d = i->next();
-        Status status = builder->addKey(d.first, d.second);
-
-        if (!status.isOK()) {
-            // Overlong key that's OK to skip?
-            if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(txn)) {
-                continue;
+        for (int keysInUnitOfWork = 0; keysInUnitOfWork < keysPerUnitOfWork && i->more();
+             keysInUnitOfWork++) {
+            if (mayInterrupt) {
+                txn->checkForInterrupt();
             }
 
-            // Check if this is a duplicate that's OK to skip
-            if (status.code() == ErrorCodes::DuplicateKey) {
-                invariant(!dupsAllowed);  // shouldn't be getting DupKey errors if dupsAllowed.
+            // Get the next datum and add it to the builder.
+            BulkBuilder::Sorter::Data d = i->next();
+            Status status = builder->addKey(d.first, d.second);
 
-                if (dupsToDrop) {
-                    dupsToDrop->insert(d.second);
+            if (!status.isOK()) {
+                // Overlong key that's OK to skip?
+                if (status.code() == ErrorCodes::KeyTooLong && ignoreKeyTooLong(txn)) {
                     continue;
                 }
+
+                // Check if this is a duplicate that's OK to skip
+                if (status.code() == ErrorCodes::DuplicateKey) {
+                    invariant(!dupsAllowed);  // shouldn't be getting DupKey errors if dupsAllowed.
+
+                    if (dupsToDrop) {
+                        dupsToDrop->insert(d.second);
+                        continue;
+                    }
+                }
+
+                return status;
             }
 
-            return status;
+            // If we're here either it's a dup and we're cool with it or the addKey went just
+            // fine.
+            pm.hit();
         }
 
-        // If we're here either it's a dup and we're cool with it or the addKey went just
-        // fine.
-        pm.hit();
         wunit.commit();
     }
 
@@ -36,6 +36,7 @@
 #include "mongo/db/operation_context.h"
 #include "mongo/db/record_id.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/storage/record_store.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 
 namespace mongo {
@@ -80,6 +81,19 @@ public:
                   const InsertDeleteOptions& options,
                   int64_t* numInserted);
 
+    /**
+     * Same as insert() for every record in 'records', but generates all of their keys first and
+     * hands them to the SortedDataInterface sorted, as a single batch. 'numInserted' is set to
+     * the total number of keys added.
+     *
+     * Unlike insert(), a failure does not remove the keys already added, so the caller must
+     * abandon the enclosing WriteUnitOfWork.
+     */
+    Status insertBatch(OperationContext* txn,
+                       const std::vector<BsonRecord>& records,
+                       const InsertDeleteOptions& options,
+                       int64_t* numInserted);
+
     /**
      * Analogous to above, but remove the records instead of inserting them.  If not NULL,
      * numDeleted will be set to the number of keys removed from the index for the document.
@@ -186,6 +200,9 @@ public:
     public:
         /**
          * Insert into the BulkBuilder as-if inserting into an IndexAccessMethod.
+         *
+         * This only generates keys and adds them to the sorter, without using 'txn', so distinct
+         * BulkBuilders may be fed from different threads.
          */
         Status insert(OperationContext* txn,
                       const BSONObj& obj,
@@ -204,6 +221,7 @@ public:
         const IndexAccessMethod* _real;
         int64_t _keysInserted = 0;
         bool _isMultiKey = false;
+        unsigned long long _multikeyComponents = 0;
     };
 
     /**
@@ -235,6 +253,13 @@ public:
      */
     virtual void getKeys(const BSONObj& obj, BSONObjSet* keys) const = 0;
 
+    /**
+     * Returns the mask of the components of the key pattern which have an array along their path
+     * in 'obj', for an 'obj' which generates several keys (see
+     * IndexCatalogEntry::getMultikeyComponents).
+     */
+    unsigned long long getMultikeyComponents(const BSONObj& obj) const;
+
 protected:
     // Determines whether it's OK to ignore ErrorCodes::KeyTooLong for this OperationContext
     bool ignoreKeyTooLong(OperationContext* txn);
@@ -271,6 +296,9 @@ private:
 
     RecordId loc;
     bool dupsAllowed;
+
+    // The components with arrays in the new document, if it generates several keys.
+    unsigned long long multikeyComponents = 0;
 };
 
 /**
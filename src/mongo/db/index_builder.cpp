@@ -84,6 +84,7 @@ void IndexBuilder::run() {
 
     OperationContextImpl txn;
     txn.lockState()->setIsBatchWriter(true);
+    txn.lockState()->setIsBackgroundOperation(true);
 
     AuthorizationSession::get(txn.getClient())->grantInternalAuthorization();
 
@@ -51,6 +51,8 @@
 #include "mongo/db/auth/internal_user_auth.h"
 #include "mongo/db/auth/security_key.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/logger/async_log_appender.h"
 #include "mongo/logger/logger.h"
 #include "mongo/logger/console_appender.h"
 #include "mongo/logger/message_event.h"
@@ -76,6 +78,10 @@ using std::cerr;
 using std::cout;
 using std::endl;
 
+// Number of log messages which may wait for a background thread to write them to the log file.
+// With 0, each message is written to the file by the thread logging it.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(logFileQueueSize, int, 0);
+
 #ifndef _WIN32
 // support for exit value propagation with fork
 void launchSignal(int sig) {
@@ -274,9 +280,14 @@ MONGO_INITIALIZER_GENERAL(ServerLogRedirection,
 
         LogManager* manager = logger::globalLogManager();
         manager->getGlobalDomain()->clearAppenders();
-        manager->getGlobalDomain()->attachAppender(
-            MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
-                new MessageEventDetailsEncoder, writer.getValue())));
+        MessageLogDomain::AppenderAutoPtr fileAppender(
+            new RotatableFileAppender<MessageEventEphemeral>(new MessageEventDetailsEncoder,
+                                                             writer.getValue()));
+        if (logFileQueueSize > 0) {
+            fileAppender.reset(new logger::AsyncLogAppender(std::move(fileAppender),
+                                                            static_cast<size_t>(logFileQueueSize)));
+        }
+        manager->getGlobalDomain()->attachAppender(std::move(fileAppender));
         manager->getNamedDomain("javascriptOutput")
             ->attachAppender(
                 MessageLogDomain::AppenderAutoPtr(new RotatableFileAppender<MessageEventEphemeral>(
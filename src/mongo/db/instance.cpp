@@ -66,6 +66,7 @@
 #include "mongo/db/mongod_options.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/op_observer.h"
+#include "mongo/db/operation_arena.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/ops/delete_request.h"
 #include "mongo/db/ops/insert.h"
@@ -82,6 +83,7 @@
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/stats/counters.h"
+#include "mongo/db/stats/cpu_sampler.h"
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/db/storage_options.h"
 #include "mongo/platform/atomic_word.h"
@@ -140,6 +142,19 @@ void receivedDelete(OperationContext* txn, const NamespaceString& nsString, Mess
 
 void receivedInsert(OperationContext* txn, const NamespaceString& nsString, Message& m, CurOp& op);
 
+void performUpdate(OperationContext* txn,
+                   const NamespaceString& nsString,
+                   const BSONObj& query,
+                   const BSONObj& toupdate,
+                   int flags,
+                   CurOp& op);
+
+void performInsert(OperationContext* txn,
+                   const NamespaceString& nsString,
+                   vector<BSONObj>& docs,
+                   bool keepGoing,
+                   CurOp& op);
+
 bool receivedGetMore(OperationContext* txn, DbResponse& dbresponse, Message& m, CurOp& curop);
 
 int nloggedsome = 0;
@@ -335,7 +350,7 @@ void receivedPseudoCommand(OperationContext* txn,
 
     // TODO: use OP_COMMAND here instead of constructing
     // a legacy OP_QUERY style command
-    BufBuilder cmdMsgBuf;
+    ArenaBufBuilder cmdMsgBuf(OperationArena::get(txn));
 
     int32_t flags = DataView(message.header().data()).read<LittleEndian<int32_t>>();
     cmdMsgBuf.appendNum(flags);
@@ -398,6 +413,157 @@ void mongoAbort(const char* msg) {
     ::abort();
 }
 
+namespace {
+
+/**
+ * Marks the operation 'op' in the CurOp of 'txn' as done, then logs it if 'shouldLog' is set or
+ * it ran slower than 'logThreshold', and profiles it when profiling is on.
+ */
+void finishReceivedOp(OperationContext* txn,
+                      int op,
+                      LogComponent responseComponent,
+                      bool shouldLog,
+                      long long logThreshold) {
+    CurOp& currentOp = *CurOp::get(txn);
+    OpDebug& debug = currentOp.debug();
+
+    currentOp.ensureStarted();
+    currentOp.done();
+    debug.executionTime = currentOp.totalTimeMillis();
+
+    logThreshold += currentOp.getExpectedLatencyMs();
+
+    if (shouldLog ||
+        (debug.executionTime > logThreshold && shouldLogSlowOp(responseComponent))) {
+        Locker::LockerInfo lockerInfo;
+        txn->lockState()->getLockerInfo(&lockerInfo);
+
+        MONGO_LOG_COMPONENT(0, responseComponent) << debug.report(currentOp, lockerInfo.stats);
+    }
+
+    if (currentOp.shouldDBProfile(debug.executionTime)) {
+        // Performance profiling is on
+        if (txn->lockState()->isReadLocked()) {
+            MONGO_LOG_COMPONENT(1, responseComponent)
+                << "note: not profiling because recursive read lock";
+        } else if (lockedForWriting()) {
+            MONGO_LOG_COMPONENT(1, responseComponent)
+                << "note: not profiling because doing fsync+lock";
+        } else {
+            profile(txn, op);
+        }
+    }
+
+    recordCurOpMetrics(txn);
+    debug.reset();
+}
+
+/**
+ * Runs 'work' as the legacy operation 'op' on 'nss' for DBDirectClient, with the CurOp setup,
+ * op counting, logging and profiling assembleResponse() gives an operation which arrives in a
+ * Message. An exception from a write is recorded in LastError, as it would be for a write sent
+ * with DBClientBase::say(); an exception from a query is rethrown.
+ */
+template <typename Work>
+void runDirectOp(OperationContext* txn, int op, const NamespaceString& nss, Work work) {
+    switch (op) {
+        case dbQuery:
+            globalOpCounters.gotQuery();
+            break;
+        case dbUpdate:
+            globalOpCounters.gotUpdate();
+            break;
+        default:
+            // Inserts are counted per document as they are applied.
+            break;
+    }
+
+    CurOp& currentOp = *CurOp::get(txn);
+    {
+        stdx::lock_guard<Client> lk(*txn->getClient());
+        currentOp.setOp_inlock(op);
+    }
+    currentOp.debug().op = op;
+
+    CpuSampler::ScopedTag cpuSamplerTag(opToString(op), nss.ns());
+
+    const LogComponent responseComponent =
+        op == dbQuery ? LogComponent::kQuery : LogComponent::kWrite;
+    bool shouldLog =
+        logger::globalLogDomain()->shouldLog(responseComponent, logger::LogSeverity::Debug(1));
+
+    try {
+        work(currentOp);
+    } catch (const AssertionException& e) {
+        currentOp.debug().exceptionInfo = e.getInfo();
+        if (op == dbQuery) {
+            finishReceivedOp(txn, op, responseComponent, shouldLog, serverGlobalParams.slowMS);
+            throw;
+        }
+        LastError::get(txn->getClient()).setLastError(e.getCode(), e.getInfo().msg);
+        MONGO_LOG_COMPONENT(3, responseComponent) << " Caught Assertion in " << opToString(op)
+                                                  << ", continuing " << e.toString() << endl;
+        shouldLog = shouldLog || !dynamic_cast<const UserException*>(&e);
+    }
+
+    finishReceivedOp(txn, op, responseComponent, shouldLog, serverGlobalParams.slowMS);
+}
+
+}  // namespace
+
+BSONObj directFindOne(OperationContext* txn,
+                      const NamespaceString& nss,
+                      const BSONObj& query,
+                      const BSONObj& fields,
+                      int queryOptions) {
+    invariant(txn->getClient()->isInDirectClient());
+
+    BSONObj result;
+    runDirectOp(txn, dbQuery, nss, [&](CurOp& op) {
+        Client* client = txn->getClient();
+        Status status = AuthorizationSession::get(client)->checkAuthForFind(nss, false);
+        audit::logQueryAuthzCheck(client, nss, query, status.code());
+        uassertStatusOK(status);
+
+        result = runQueryForOne(txn, nss, query, fields, queryOptions);
+    });
+    return result;
+}
+
+void directInsert(OperationContext* txn,
+                  const NamespaceString& nss,
+                  vector<BSONObj>& docs,
+                  bool keepGoing) {
+    invariant(txn->getClient()->isInDirectClient());
+    invariant(!nss.isSystemDotIndexes());
+
+    runDirectOp(txn, dbInsert, nss, [&](CurOp& op) {
+        {
+            stdx::lock_guard<Client> lk(*txn->getClient());
+            op.setNS_inlock(nss.ns());
+        }
+        uassert(16257, str::stream() << "Invalid ns [" << nss.ns() << "]", nss.isValid());
+        uassertStatusOK(userAllowedWriteNS(nss.ns()));
+        if (!docs.empty()) {
+            performInsert(txn, nss, docs, keepGoing, op);
+        }
+    });
+}
+
+void directUpdate(OperationContext* txn,
+                  const NamespaceString& nss,
+                  const BSONObj& query,
+                  const BSONObj& toupdate,
+                  int flags) {
+    invariant(txn->getClient()->isInDirectClient());
+
+    runDirectOp(txn, dbUpdate, nss, [&](CurOp& op) {
+        uassert(16257, str::stream() << "Invalid ns [" << nss.ns() << "]", nss.isValid());
+        uassertStatusOK(userAllowedWriteNS(nss));
+        performUpdate(txn, nss, query, toupdate, flags, op);
+    });
+}
+
 // Returns false when request includes 'end'
 void assembleResponse(OperationContext* txn,
                       Message& m,
@@ -488,6 +654,9 @@ void assembleResponse(OperationContext* txn,
     OpDebug& debug = currentOp.debug();
     debug.op = op;
 
+    // Commands retag their samples with the command name once it is parsed.
+    CpuSampler::ScopedTag cpuSamplerTag(opToString(op), nsString.ns());
+
     long long logThreshold = serverGlobalParams.slowMS;
     LogComponent responseComponent(LogComponent::kQuery);
     if (op == dbInsert || op == dbDelete || op == dbUpdate) {
@@ -576,34 +745,7 @@ void assembleResponse(OperationContext* txn,
             shouldLog = true;
         }
     }
-    currentOp.ensureStarted();
-    currentOp.done();
-    debug.executionTime = currentOp.totalTimeMillis();
-
-    logThreshold += currentOp.getExpectedLatencyMs();
-
-    if (shouldLog || debug.executionTime > logThreshold) {
-        Locker::LockerInfo lockerInfo;
-        txn->lockState()->getLockerInfo(&lockerInfo);
-
-        MONGO_LOG_COMPONENT(0, responseComponent) << debug.report(currentOp, lockerInfo.stats);
-    }
-
-    if (currentOp.shouldDBProfile(debug.executionTime)) {
-        // Performance profiling is on
-        if (txn->lockState()->isReadLocked()) {
-            MONGO_LOG_COMPONENT(1, responseComponent)
-                << "note: not profiling because recursive read lock";
-        } else if (lockedForWriting()) {
-            MONGO_LOG_COMPONENT(1, responseComponent)
-                << "note: not profiling because doing fsync+lock";
-        } else {
-            profile(txn, op);
-        }
-    }
-
-    recordCurOpMetrics(txn);
-    debug.reset();
+    finishReceivedOp(txn, op, responseComponent, shouldLog, logThreshold);
 }
 
 void receivedKillCursors(OperationContext* txn, Message& m) {
@@ -636,15 +778,26 @@ void receivedUpdate(OperationContext* txn, const NamespaceString& nsString, Mess
     uassertStatusOK(userAllowedWriteNS(nsString));
     int flags = d.pullInt();
     BSONObj query = d.nextJsObj();
-    auto client = txn->getClient();
-    auto lastOpAtOperationStart = repl::ReplClientInfo::forClient(client).getLastOp();
 
     verify(d.moreJSObjs());
     verify(query.objsize() < m.header().dataLen());
     BSONObj toupdate = d.nextJsObj();
-    uassert(10055, "update object too large", toupdate.objsize() <= BSONObjMaxUserSize);
     verify(toupdate.objsize() < m.header().dataLen());
     verify(query.objsize() + toupdate.objsize() < m.header().dataLen());
+
+    performUpdate(txn, nsString, query, toupdate, flags, op);
+}
+
+void performUpdate(OperationContext* txn,
+                   const NamespaceString& nsString,
+                   const BSONObj& query,
+                   const BSONObj& toupdate,
+                   int flags,
+                   CurOp& op) {
+    auto client = txn->getClient();
+    auto lastOpAtOperationStart = repl::ReplClientInfo::forClient(client).getLastOp();
+
+    uassert(10055, "update object too large", toupdate.objsize() <= BSONObjMaxUserSize);
     bool upsert = flags & UpdateOption_Upsert;
     bool multi = flags & UpdateOption_Multi;
     bool broadcast = flags & UpdateOption_Broadcast;
@@ -859,6 +1012,7 @@ bool receivedGetMore(OperationContext* txn, DbResponse& dbresponse, Message& m,
     bool exhaust = false;
     QueryResult::View msgdata = 0;
     bool isCursorAuthorized = false;
+    std::unique_ptr<Message> resp = stdx::make_unique<Message>();
 
     try {
         const NamespaceString nsString(ns);
@@ -873,7 +1027,8 @@ bool receivedGetMore(OperationContext* txn, DbResponse& dbresponse, Message& m,
             sleepmillis(0);
         }
 
-        msgdata = getMore(txn, ns, ntoreturn, cursorid, &exhaust, &isCursorAuthorized);
+        msgdata =
+            getMore(txn, ns, ntoreturn, cursorid, &exhaust, &isCursorAuthorized, resp.get());
     } catch (AssertionException& e) {
         if (isCursorAuthorized) {
             // If a cursor with id 'cursorid' was authorized, it may have been advanced
@@ -896,12 +1051,10 @@ bool receivedGetMore(OperationContext* txn, DbResponse& dbresponse, Message& m,
         return false;
     }
 
-    Message* resp = new Message();
-    resp->setData(msgdata.view2ptr(), true);
     curop.debug().responseLength = resp->header().dataLen();
     curop.debug().nreturned = msgdata.getNReturned();
 
-    dbresponse.response = resp;
+    dbresponse.response = resp.release();
     dbresponse.responseTo = m.header().getId();
 
     if (exhaust) {
@@ -1064,7 +1217,6 @@ bool _receivedInsert(OperationContext* txn,
 
 void receivedInsert(OperationContext* txn, const NamespaceString& nsString, Message& m, CurOp& op) {
     DbMessage d(m);
-    const char* ns = d.getns();
     {
         stdx::lock_guard<Client>(*txn->getClient());
         CurOp::get(txn)->setNS_inlock(nsString.ns());
@@ -1083,9 +1235,19 @@ void receivedInsert(OperationContext* txn, const NamespaceString& nsString, Mess
 
     vector<BSONObj> multi;
     while (d.moreJSObjs()) {
-        BSONObj obj = d.nextJsObj();
-        multi.push_back(obj);
+        multi.push_back(d.nextJsObj());
+    }
 
+    performInsert(txn, nsString, multi, d.reservedField() & InsertOption_ContinueOnError, op);
+}
+
+void performInsert(OperationContext* txn,
+                   const NamespaceString& nsString,
+                   vector<BSONObj>& docs,
+                   bool keepGoing,
+                   CurOp& op) {
+    const char* ns = nsString.ns().c_str();
+    for (const BSONObj& obj : docs) {
         // Check auth for insert (also handles checking if this is an index build and checks
         // for the proper privileges in that case).
         Status status =
@@ -1094,7 +1256,6 @@ void receivedInsert(OperationContext* txn, const NamespaceString& nsString, Mess
         uassertStatusOK(status);
     }
 
-    const bool keepGoing = d.reservedField() & InsertOption_ContinueOnError;
     {
         ScopedTransaction transaction(txn, MODE_IX);
         Lock::DBLock dbLock(txn->lockState(), nsString.db(), MODE_IX);
@@ -1102,7 +1263,7 @@ void receivedInsert(OperationContext* txn, const NamespaceString& nsString, Mess
 
         // OldClientContext may implicitly create a database, so check existence
         if (dbHolder().get(txn, nsString.db()) != NULL) {
-            if (_receivedInsert(txn, nsString, ns, multi, keepGoing, op, true))
+            if (_receivedInsert(txn, nsString, ns, docs, keepGoing, op, true))
                 return;
         }
     }
@@ -1111,7 +1272,7 @@ void receivedInsert(OperationContext* txn, const NamespaceString& nsString, Mess
     ScopedTransaction transaction(txn, MODE_IX);
     Lock::DBLock dbLock(txn->lockState(), nsString.db(), MODE_X);
 
-    _receivedInsert(txn, nsString, ns, multi, keepGoing, op, false);
+    _receivedInsert(txn, nsString, ns, docs, keepGoing, op, false);
 }
 
 static AtomicUInt32 shutdownInProgress(0);
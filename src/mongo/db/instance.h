@@ -34,6 +34,7 @@
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/dbmessage.h"
+#include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
 #include "mongo/db/storage_options.h"
 
@@ -74,6 +75,33 @@ void assembleResponse(OperationContext* txn,
                       DbResponse& dbresponse,
                       const HostAndPort& client);
 
+/**
+ * In-process versions of the legacy find, insert and update operations for DBDirectClient,
+ * which take their arguments as BSON rather than encoded into a Message. They perform the same
+ * authorization checks, op counting, LastError bookkeeping, logging and profiling as the
+ * operations received through assembleResponse().
+ *
+ * directFindOne() returns the first document matching 'query', or an empty object, and throws
+ * on error. The writes record their errors in LastError, like writes sent with say().
+ * Inserts into system.indexes have to go through assembleResponse().
+ */
+BSONObj directFindOne(OperationContext* txn,
+                      const NamespaceString& nss,
+                      const BSONObj& query,
+                      const BSONObj& fields,
+                      int queryOptions);
+
+void directInsert(OperationContext* txn,
+                  const NamespaceString& nss,
+                  std::vector<BSONObj>& docs,
+                  bool keepGoing);
+
+void directUpdate(OperationContext* txn,
+                  const NamespaceString& nss,
+                  const BSONObj& query,
+                  const BSONObj& toupdate,
+                  int flags);
+
 void maybeCreatePidFile();
 
 }  // namespace mongo
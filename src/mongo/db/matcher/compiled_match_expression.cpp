@@ -0,0 +1,147 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/matcher/compiled_match_expression.h"
+
+#include <algorithm>
+
+#include "mongo/db/matcher/expression.h"
+#include "mongo/db/matcher/expression_leaf.h"
+
+namespace mongo {
+
+namespace {
+
+/**
+ * Returns the relative cost of evaluating a compilable predicate against a single element, or -1
+ * if the predicate cannot be compiled.
+ */
+int predicateCost(const MatchExpression* expr) {
+    switch (expr->matchType()) {
+        case MatchExpression::EQ:
+            return 0;
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return 1;
+        case MatchExpression::MATCH_IN:
+            return 2;
+        case MatchExpression::MOD:
+            return 3;
+        case MatchExpression::REGEX:
+            return 4;
+        default:
+            return -1;
+    }
+}
+
+}  // namespace
+
+const size_t CompiledMatchExpression::kMaxFields;
+
+CompiledMatchExpression::CompiledMatchExpression(const MatchExpression* expr) {
+    std::vector<const MatchExpression*> conjuncts;
+    if (MatchExpression::AND == expr->matchType()) {
+        for (size_t i = 0; i < expr->numChildren(); ++i) {
+            conjuncts.push_back(expr->getChild(i));
+        }
+    } else {
+        conjuncts.push_back(expr);
+    }
+
+    for (const MatchExpression* conjunct : conjuncts) {
+        const StringData path = conjunct->path();
+        if (predicateCost(conjunct) < 0 || path.empty() ||
+            path.find('.') != std::string::npos) {
+            _others.push_back(conjunct);
+            continue;
+        }
+
+        size_t slot = std::find(_fields.begin(), _fields.end(), path) - _fields.begin();
+        if (slot == _fields.size()) {
+            if (_fields.size() == kMaxFields) {
+                _others.push_back(conjunct);
+                continue;
+            }
+            _fields.push_back(path);
+        }
+
+        _predicates.push_back({slot, static_cast<const LeafMatchExpression*>(conjunct)});
+    }
+
+    std::stable_sort(_predicates.begin(),
+                     _predicates.end(),
+                     [](const Predicate& lhs, const Predicate& rhs) {
+                         return predicateCost(lhs.expr) < predicateCost(rhs.expr);
+                     });
+}
+
+bool CompiledMatchExpression::matchesBSON(const BSONObj& doc) const {
+    if (!_predicates.empty()) {
+        // Find the first occurrence of each field, as BSONObj::getField() would.
+        BSONElement elements[kMaxFields];
+        size_t remaining = _fields.size();
+        BSONObjIterator it(doc);
+        while (remaining > 0 && it.more()) {
+            const BSONElement e = it.next();
+            const StringData name = e.fieldNameStringData();
+            for (size_t i = 0; i < _fields.size(); ++i) {
+                if (elements[i].eoo() && name == _fields[i]) {
+                    elements[i] = e;
+                    --remaining;
+                    break;
+                }
+            }
+        }
+
+        for (const Predicate& predicate : _predicates) {
+            const BSONElement& e = elements[predicate.slot];
+
+            // Arrays and missing fields have special matching rules, which the expression
+            // applies itself.
+            const bool matched = (e.eoo() || e.type() == Array)
+                ? predicate.expr->matchesBSON(doc)
+                : predicate.expr->matchesSingleElement(e);
+            if (!matched) {
+                return false;
+            }
+        }
+    }
+
+    for (const MatchExpression* other : _others) {
+        if (!other->matchesBSON(doc)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace mongo
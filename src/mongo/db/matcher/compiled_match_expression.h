@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+
+class LeafMatchExpression;
+class MatchExpression;
+
+/**
+ * A flattened form of a MatchExpression for matching many documents against the same filter.
+ *
+ * Conjuncts of the expression which apply a comparison, $in, $mod or regex to a top-level field
+ * are evaluated directly against that field's element. Each distinct field is found in a single
+ * pass over the document, rather than once per predicate through an ElementIterator. Cheaper
+ * predicates are evaluated before more expensive ones. Arrays, missing fields and all other
+ * conjuncts are evaluated through MatchExpression::matches(), so the results are always the same
+ * as matching 'expr' itself.
+ *
+ * The expression must outlive this object and must not be modified after it is compiled.
+ * matchesBSON() may be called from several threads at once.
+ */
+class CompiledMatchExpression {
+    MONGO_DISALLOW_COPYING(CompiledMatchExpression);
+
+public:
+    explicit CompiledMatchExpression(const MatchExpression* expr);
+
+    bool matchesBSON(const BSONObj& doc) const;
+
+    /**
+     * Returns the number of predicates which are evaluated directly against a top-level field.
+     */
+    size_t numCompiledPredicates() const {
+        return _predicates.size();
+    }
+
+private:
+    struct Predicate {
+        // Index into '_fields' of the field this predicate applies to.
+        size_t slot;
+        const LeafMatchExpression* expr;
+    };
+
+    // Past this many distinct fields a single pass over the document is no longer cheaper than
+    // looking each field up separately, so further predicates are not compiled.
+    static const size_t kMaxFields = 32;
+
+    // The distinct top-level fields referenced by '_predicates'.
+    std::vector<StringData> _fields;
+
+    // Evaluated in order, before '_others'.
+    std::vector<Predicate> _predicates;
+
+    // Conjuncts which could not be compiled.
+    std::vector<const MatchExpression*> _others;
+};
+
+}  // namespace mongo
@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/** Unit tests for CompiledMatchExpression. */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/compiled_match_expression.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using std::unique_ptr;
+
+/**
+ * Parses 'json' into *filter and returns an expression which refers into it.
+ */
+unique_ptr<MatchExpression> parse(const char* json, BSONObj* filter) {
+    *filter = fromjson(json);
+    StatusWithMatchExpression swme = MatchExpressionParser::parse(*filter);
+    ASSERT_OK(swme.getStatus());
+    return std::move(swme.getValue());
+}
+
+/**
+ * Checks that the compiled form of 'filter' agrees with the expression itself on every one of a
+ * set of documents covering scalars, arrays, subdocuments, missing fields and duplicate fields.
+ */
+void assertSameResults(const char* filter) {
+    BSONObj filterObj;
+    unique_ptr<MatchExpression> expr = parse(filter, &filterObj);
+    CompiledMatchExpression compiled(expr.get());
+
+    const char* docs[] = {"{}",
+                          "{a: 1}",
+                          "{a: 5, b: 'abc'}",
+                          "{a: null, b: 'xyz'}",
+                          "{a: [1, 5, 9], b: ['abc', 'q']}",
+                          "{a: [], b: []}",
+                          "{a: {x: 1}, b: {y: 'abc'}}",
+                          "{b: 'abd', c: 3, a: 4}",
+                          "{a: 4, a: 100}",
+                          "{a: 2.5, b: 7, c: {d: 4}}",
+                          "{c: [{d: 4}, {d: 5}], a: 'str'}"};
+    for (const char* doc : docs) {
+        BSONObj obj = fromjson(doc);
+        ASSERT_EQUALS(expr->matchesBSON(obj), compiled.matchesBSON(obj))
+            << "filter: " << filter << " doc: " << doc;
+    }
+}
+
+TEST(CompiledMatchExpression, SameResultsAsExpression) {
+    assertSameResults("{}");
+    assertSameResults("{a: 1}");
+    assertSameResults("{a: 4}");
+    assertSameResults("{a: null}");
+    assertSameResults("{a: {$gt: 2}}");
+    assertSameResults("{a: {$gte: 1, $lt: 6}}");
+    assertSameResults("{a: {$lte: 5}, b: 'abc'}");
+    assertSameResults("{a: {$in: [1, 4, null]}}");
+    assertSameResults("{a: {$mod: [2, 0]}}");
+    assertSameResults("{b: /^ab/}");
+    assertSameResults("{b: {$in: [/^x/, 'q']}}");
+    assertSameResults("{a: {$ne: 5}}");
+    assertSameResults("{a: {$exists: true}, b: {$type: 2}}");
+    assertSameResults("{'c.d': 4, a: {$gt: 0}}");
+    assertSameResults("{a: {$elemMatch: {$gt: 4}}}");
+    assertSameResults("{$or: [{a: 1}, {b: 'abc'}]}");
+    assertSameResults("{a: {$gt: 0}, b: {$exists: false}}");
+    assertSameResults("{a: [1, 5, 9]}");
+    assertSameResults("{a: {x: 1}}");
+}
+
+TEST(CompiledMatchExpression, CompilesTopLevelPredicates) {
+    BSONObj filter;
+    unique_ptr<MatchExpression> expr =
+        parse("{a: {$gt: 1, $lt: 5}, b: /x/, 'c.d': 1, e: {$ne: 1}}", &filter);
+    CompiledMatchExpression compiled(expr.get());
+    ASSERT_EQUALS(3U, compiled.numCompiledPredicates());
+    ASSERT(compiled.matchesBSON(BSON("a" << 2 << "b"
+                                         << "xx"
+                                         << "c" << BSON("d" << 1))));
+    ASSERT(!compiled.matchesBSON(BSON("a" << 2 << "b"
+                                          << "xx"
+                                          << "c" << BSON("d" << 1) << "e" << 1)));
+}
+
+TEST(CompiledMatchExpression, SingleLeaf) {
+    BSONObj filter;
+    unique_ptr<MatchExpression> expr = parse("{a: {$gte: 3}}", &filter);
+    CompiledMatchExpression compiled(expr.get());
+    ASSERT_EQUALS(1U, compiled.numCompiledPredicates());
+    ASSERT(compiled.matchesBSON(BSON("a" << 3)));
+    ASSERT(compiled.matchesBSON(BSON("a" << BSON_ARRAY(1 << 4))));
+    ASSERT(!compiled.matchesBSON(BSON("a" << 2)));
+    ASSERT(!compiled.matchesBSON(BSONObj()));
+}
+
+}  // namespace
+}  // namespace mongo
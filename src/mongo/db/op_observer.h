@@ -29,6 +29,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/db/jsobj.h"
@@ -59,6 +60,11 @@ public:
                   const NamespaceString& ns,
                   BSONObj doc,
                   bool fromMigrate = false);
+    void onInserts(OperationContext* txn,
+                   const NamespaceString& ns,
+                   std::vector<BSONObj>::const_iterator begin,
+                   std::vector<BSONObj>::const_iterator end,
+                   bool fromMigrate = false);
     void onUpdate(OperationContext* txn, oplogUpdateEntryArgs args);
     void onDelete(OperationContext* txn,
                   const std::string& ns,
@@ -0,0 +1,63 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/bump_arena.h"
+
+namespace mongo {
+
+class OperationContext;
+
+/**
+ * Scratch memory for buffers whose lifetime is bounded by a single operation, such as
+ * ArenaBufBuilders for intermediate BSON.
+ *
+ * The arena itself belongs to the Client so that its first block is reused by every operation
+ * on a connection, and it is reset when the OperationContext which used it is destroyed. Memory
+ * obtained from it must therefore not be referenced once the operation has finished; in
+ * particular, it must not back a reply Message or an owned BSONObj.
+ */
+class OperationArena {
+    MONGO_DISALLOW_COPYING(OperationArena);
+
+public:
+    OperationArena() = default;
+    ~OperationArena();
+
+    /**
+     * Returns the arena for 'txn', which must have a Client.
+     */
+    static BumpArena* get(OperationContext* txn);
+
+private:
+    BumpArena* _arena = nullptr;
+};
+
+}  // namespace mongo
@@ -79,6 +79,8 @@ OperationContextImpl::OperationContextImpl()
     : OperationContext(
           &cc(), nextOpId.fetchAndAdd(1), clientOperationInfoDecoration(cc()).getLocker()),
       _writesAreReplicated(true) {
+    lockState()->setOpId(getOpID());
+
     StorageEngine* storageEngine = getGlobalServiceContext()->getGlobalStorageEngine();
     _recovery.reset(storageEngine->newRecoveryUnit());
 
@@ -41,6 +41,7 @@
 #include "mongo/db/ops/path_support.h"
 #include "mongo/util/embedded_builder.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/safe_num.h"
 
 namespace mongo {
 
@@ -52,6 +53,41 @@ using std::vector;
 
 using pathsupport::EqualityMatches;
 
+namespace {
+
+/**
+ * Returns true if 'elem', a modifier argument of type 'type', can be applied by
+ * UpdateDriver::updateInPlace(): a $set of a fixed-size value or an $inc by a non-decimal
+ * number, of a top-level field other than _id.
+ */
+bool isTopLevelMod(modifiertable::ModifierType type, const BSONElement& elem) {
+    const StringData fieldName = elem.fieldNameStringData();
+    if (fieldName.find('.') != std::string::npos || fieldName.startsWith("$") ||
+        fieldName == "_id") {
+        return false;
+    }
+
+    switch (type) {
+        case modifiertable::MOD_SET:
+            switch (elem.type()) {
+                case NumberInt:
+                case NumberLong:
+                case NumberDouble:
+                case Bool:
+                case Date:
+                    return true;
+                default:
+                    return false;
+            }
+        case modifiertable::MOD_INC:
+            return elem.isNumber() && elem.type() != NumberDecimal;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
 UpdateDriver::UpdateDriver(const Options& opts)
     : _replacementMode(false),
       _indexedFields(NULL),
@@ -94,6 +130,7 @@ Status UpdateDriver::parse(const BSONObj& updateExpr, const bool multi) {
 
     // The update expression is made of mod operators, that is
     // { <$mod>: {...}, <$mod>: {...}, ...  }
+    bool allTopLevel = true;
     BSONObjIterator outerIter(updateExpr);
     while (outerIter.more()) {
         BSONElement outerModElem = outerIter.next();
@@ -130,9 +167,26 @@ Status UpdateDriver::parse(const BSONObj& updateExpr, const bool multi) {
             if (!status.isOK()) {
                 return status;
             }
+
+            if (allTopLevel) {
+                allTopLevel = isTopLevelMod(modType, innerModElem);
+                // Leave conflicting mods of the same field to update() to report.
+                for (size_t i = 0; allTopLevel && i < _topLevelMods.size(); ++i) {
+                    allTopLevel = _topLevelMods[i].elem.fieldNameStringData() !=
+                        innerModElem.fieldNameStringData();
+                }
+                if (allTopLevel) {
+                    TopLevelMod topLevelMod = {modType, innerModElem};
+                    _topLevelMods.push_back(topLevelMod);
+                }
+            }
         }
     }
 
+    if (!allTopLevel) {
+        _topLevelMods.clear();
+    }
+
     // Register the fact that there will be only $mod's in this driver -- no object
     // replacement.
     _replacementMode = false;
@@ -315,6 +369,89 @@ Status UpdateDriver::update(StringData matchedField,
     return Status::OK();
 }
 
+bool UpdateDriver::updateInPlace(const BSONObj& doc,
+                                 const std::vector<FieldRef*>* immutablePaths,
+                                 BSONObj* newValues,
+                                 mutablebson::DamageVector* damages,
+                                 bool* docWasModified) {
+    if (_topLevelMods.empty()) {
+        return false;
+    }
+
+    // update() moves _id to the front of the document, which cannot be done in place.
+    if (StringData(doc.firstElementFieldName()) != "_id") {
+        return false;
+    }
+
+    // Compute every new value before changing any state, so that we can still give up and
+    // let update() apply the mods, and report any error.
+    BSONObjBuilder logBuilder;
+    BSONObjBuilder setBuilder(logBuilder.subobjStart("$set"));
+    std::vector<BSONElement> targets;
+    for (const auto& mod : _topLevelMods) {
+        const StringData fieldName = mod.elem.fieldNameStringData();
+
+        if (_indexedFields && _indexedFields->mightBeIndexed(fieldName)) {
+            return false;
+        }
+        if (immutablePaths) {
+            for (const auto& immutablePath : *immutablePaths) {
+                if (immutablePath->getPart(0) == fieldName) {
+                    return false;
+                }
+            }
+        }
+
+        BSONElement current = doc[fieldName];
+        if (current.eoo() || (mod.type == modifiertable::MOD_INC && !current.isNumber())) {
+            return false;
+        }
+
+        if (mod.type == modifiertable::MOD_SET) {
+            if (current.type() != mod.elem.type()) {
+                return false;
+            }
+            if (current.woCompare(mod.elem, false) == 0) {
+                continue;
+            }
+            setBuilder.append(mod.elem);
+        } else {
+            const SafeNum currentValue(current);
+            const SafeNum newValue = SafeNum(mod.elem) + currentValue;
+            if (!newValue.isValid() || newValue.type() != current.type()) {
+                return false;
+            }
+            if (newValue.isIdentical(currentValue)) {
+                continue;
+            }
+            newValue.toBSON(fieldName, &setBuilder);
+        }
+        targets.push_back(current);
+    }
+    setBuilder.doneFast();
+
+    _affectIndices = false;
+    damages->clear();
+    *newValues = BSONObj();
+    *docWasModified = !targets.empty();
+    if (targets.empty()) {
+        return true;
+    }
+
+    *newValues = logBuilder.obj();
+    BSONObjIterator newValueIt(newValues->firstElement().embeddedObject());
+    for (const auto& target : targets) {
+        const BSONElement newValue = newValueIt.next();
+        dassert(newValue.valuesize() == target.valuesize());
+        mutablebson::DamageEvent damage;
+        damage.sourceOffset = newValue.value() - newValues->objdata();
+        damage.targetOffset = target.value() - doc.objdata();
+        damage.size = newValue.valuesize();
+        damages->push_back(damage);
+    }
+    return true;
+}
+
 size_t UpdateDriver::numMods() const {
     return _mods.size();
 }
@@ -378,6 +515,7 @@ void UpdateDriver::clear() {
         delete *it;
     }
     _mods.clear();
+    _topLevelMods.clear();
     _indexedFields = NULL;
     _replacementMode = false;
     _positional = false;
@@ -33,6 +33,7 @@
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/base/status.h"
+#include "mongo/bson/mutable/damage_vector.h"
 #include "mongo/bson/mutable/document.h"
 #include "mongo/db/field_ref_set.h"
 #include "mongo/db/jsobj.h"
@@ -100,6 +101,29 @@ public:
                   FieldRefSet* updatedFields = NULL,
                   bool* docWasModified = NULL);
 
+    /**
+     * Returns false if updateInPlace() can never apply this update.
+     */
+    bool mayUpdateInPlace() const {
+        return !_topLevelMods.empty();
+    }
+
+    /**
+     * Applies the update to 'doc' without building a mutablebson::Document, if the update only
+     * $set's or $inc's top-level fields which exist in 'doc', are neither indexed nor a prefix
+     * of any of 'immutablePaths', and keep the type, and so the size, of their values.
+     *
+     * On success, returns true, fills 'damages' with the in-place changes to 'doc', and sets
+     * 'newValues' to the {$set: {...}} oplog entry for the update, whose buffer is the source
+     * of the damages. Both are left empty if the update is a no-op.
+     * Otherwise returns false without modifying anything, and the caller must use update().
+     */
+    bool updateInPlace(const BSONObj& doc,
+                       const std::vector<FieldRef*>* immutablePaths,
+                       BSONObj* newValues,
+                       mutablebson::DamageVector* damages,
+                       bool* docWasModified);
+
     //
     // Accessors
     //
@@ -149,6 +173,17 @@ private:
     // Collection of update mod instances. Owned here.
     std::vector<ModifierInterface*> _mods;
 
+    // A $set or $inc of a top-level field, in a form updateInPlace() can apply directly.
+    // 'elem' points into the update expression, which must outlive the driver, as for the
+    // mods themselves.
+    struct TopLevelMod {
+        modifiertable::ModifierType type;
+        BSONElement elem;
+    };
+
+    // The mods, in order, if all of them are TopLevelMods. Empty otherwise.
+    std::vector<TopLevelMod> _topLevelMods;
+
     // What are the list of fields in the collection over which the update is going to be
     // applied that participate in indices?
     //
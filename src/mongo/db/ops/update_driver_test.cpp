@@ -29,6 +29,7 @@
 #include "mongo/db/ops/update_driver.h"
 
 
+#include <cstring>
 #include <map>
 
 #include "mongo/base/owned_pointer_vector.h"
@@ -125,6 +126,117 @@ TEST(Parse, SetOnInsert) {
     ASSERT_FALSE(driver.isDocReplacement());
 }
 
+//
+// Tests of applying simple updates of top-level fields without a mutable document
+//
+
+// Returns a copy of 'doc' with 'damages' applied from the buffer of 'newValues'.
+BSONObj applyDamages(const BSONObj& doc,
+                     const BSONObj& newValues,
+                     const mongo::mutablebson::DamageVector& damages) {
+    BSONObj result = doc.copy();
+    char* target = const_cast<char*>(result.objdata());
+    for (const auto& damage : damages) {
+        std::memcpy(
+            target + damage.targetOffset, newValues.objdata() + damage.sourceOffset, damage.size);
+    }
+    return result;
+}
+
+TEST(UpdateInPlace, SetAndIncTopLevelFields) {
+    UpdateDriver::Options opts;
+    UpdateDriver driver(opts);
+    // The driver refers to the values in the update expression, which must outlive it.
+    BSONObj update = fromjson("{$inc: {a: 2, d: 1}, $set: {c: false, b: 3.5}}");
+    ASSERT_OK(driver.parse(update));
+    ASSERT_TRUE(driver.mayUpdateInPlace());
+
+    BSONObj doc = fromjson("{_id: 1, a: 1, b: 2.5, c: true, d: NumberLong(5)}");
+    BSONObj newValues;
+    mongo::mutablebson::DamageVector damages;
+    bool docWasModified = false;
+    ASSERT_TRUE(driver.updateInPlace(doc, NULL, &newValues, &damages, &docWasModified));
+    ASSERT_TRUE(docWasModified);
+    ASSERT_EQUALS(fromjson("{$set: {a: 3, d: NumberLong(6), c: false, b: 3.5}}"), newValues);
+    ASSERT_EQUALS(fromjson("{_id: 1, a: 3, b: 3.5, c: false, d: NumberLong(6)}"),
+                  applyDamages(doc, newValues, damages));
+}
+
+TEST(UpdateInPlace, NoOp) {
+    UpdateDriver::Options opts;
+    UpdateDriver driver(opts);
+    BSONObj update = fromjson("{$set: {a: 1}, $inc: {b: 0}}");
+    ASSERT_OK(driver.parse(update));
+
+    BSONObj doc = fromjson("{_id: 1, a: 1, b: 2}");
+    BSONObj newValues;
+    mongo::mutablebson::DamageVector damages;
+    bool docWasModified = true;
+    ASSERT_TRUE(driver.updateInPlace(doc, NULL, &newValues, &damages, &docWasModified));
+    ASSERT_FALSE(docWasModified);
+    ASSERT_TRUE(damages.empty());
+}
+
+TEST(UpdateInPlace, NotApplicableToUpdate) {
+    const char* updates[] = {"{$set: {'a.b': 1}}",
+                             "{$set: {a: 'x'}}",
+                             "{$set: {_id: 1}}",
+                             "{$set: {a: 1}, $unset: {b: 1}}",
+                             "{$set: {a: 1}, $inc: {a: 1}}",
+                             "{$push: {a: 1}}",
+                             "{b: 1}"};
+    for (const char* update : updates) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        ASSERT_OK(driver.parse(fromjson(update)));
+        ASSERT_FALSE(driver.mayUpdateInPlace()) << update;
+    }
+}
+
+TEST(UpdateInPlace, NotApplicableToDocument) {
+    const char* docs[] = {"{_id: 1, a: 2147483647, b: 1, c: 1}",
+                          "{_id: 1, a: 1, b: true, c: 1}",
+                          "{_id: 1, a: 1, c: 1}",
+                          "{_id: 1, a: 1, b: 1.5, c: 1}",
+                          "{a: 1, _id: 1, b: 1, c: 1}",
+                          "{_id: 1, a: 1, b: 1, c: 1.5}"};
+    for (const char* docJson : docs) {
+        UpdateDriver::Options opts;
+        UpdateDriver driver(opts);
+        BSONObj update = fromjson("{$inc: {a: 1}, $set: {b: 2, c: 3}}");
+        ASSERT_OK(driver.parse(update));
+
+        BSONObj doc = fromjson(docJson);
+        BSONObj newValues;
+        mongo::mutablebson::DamageVector damages;
+        bool docWasModified = false;
+        ASSERT_FALSE(driver.updateInPlace(doc, NULL, &newValues, &damages, &docWasModified))
+            << docJson;
+    }
+}
+
+TEST(UpdateInPlace, NotApplicableToIndexedOrImmutableField) {
+    UpdateDriver::Options opts;
+    UpdateDriver driver(opts);
+    BSONObj update = fromjson("{$inc: {a: 1}}");
+    ASSERT_OK(driver.parse(update));
+
+    BSONObj doc = fromjson("{_id: 1, a: 1}");
+    BSONObj newValues;
+    mongo::mutablebson::DamageVector damages;
+    bool docWasModified = false;
+
+    OwnedPointerVector<FieldRef> immutablePaths;
+    immutablePaths.push_back(new FieldRef("a.b"));
+    ASSERT_FALSE(driver.updateInPlace(
+        doc, &immutablePaths.vector(), &newValues, &damages, &docWasModified));
+
+    UpdateIndexData indexedFields;
+    indexedFields.addPath("a");
+    driver.refreshIndexKeys(&indexedFields);
+    ASSERT_FALSE(driver.updateInPlace(doc, NULL, &newValues, &damages, &docWasModified));
+}
+
 //
 // Tests of creating a base for an upsert from a query document
 // $or, $and, $all get special handling, as does the _id field
@@ -36,6 +36,7 @@
 
 #include "mongo/base/init.h"
 #include "mongo/bson/bsontypes.h"
+#include "mongo/db/pipeline/decimal_summation.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/stdx/functional.h"
 
@@ -185,6 +186,12 @@ private:
     BSONType totalType;
     long long longTotal;
     double doubleTotal;
+
+    // Decimals are summed apart from the other numbers, whose total is only converted to a decimal
+    // by getValue().
+    DecimalSummation decimalTotal;
+    BSONType nonDecimalTotalType;
+    bool hasNonDecimal;
 };
 
 
@@ -252,8 +259,18 @@ public:
     static boost::intrusive_ptr<Accumulator> create();
 
 private:
+    /**
+     * Returns the total of both the decimal and the other numbers as a decimal.
+     */
+    Decimal128 getDecimalTotal() const;
+
     double _total;
     long long _count;
+
+    // Decimals are summed apart from the other numbers, as in AccumulatorSum.
+    DecimalSummation _decimalTotal;
+    bool _hasDecimal;
+    bool _hasNonDecimal;
 };
 
 
@@ -284,4 +301,39 @@ public:
     AccumulatorStdDevSamp() : AccumulatorStdDev(true) {}
     static boost::intrusive_ptr<Accumulator> create();
 };
+
+
+/**
+ * Estimates the number of distinct values it is given with a HyperLogLog sketch, in a constant
+ * 4KB per group however many values there are. The estimate has a standard error of about 1.6%,
+ * and is close to exact for small counts. The partial state sent for merging is the sketch
+ * itself, so merging the results of many shards only takes the maximum of each register.
+ *
+ * It does not report itself as associative and commutative: nested $approxDistinct expressions
+ * cannot be flattened, and a shard's $group must not pass documents on with a sketch each.
+ */
+class AccumulatorApproxDistinct final : public Accumulator {
+public:
+    AccumulatorApproxDistinct();
+
+    void processInternal(const Value& input, bool merging) final;
+    Value getValue(bool toBeMerged) const final;
+    const char* getOpName() const final;
+    void reset() final;
+
+    static boost::intrusive_ptr<Accumulator> create();
+
+    // The number of bits of each hash used to pick a register. Shards and mongos must agree on it,
+    // so it is not tunable.
+    static const int kPrecision = 12;
+    static const size_t kNumRegisters = size_t(1) << kPrecision;
+
+private:
+    void addHash(uint64_t hash);
+
+    // Allocated on the first input, so that groups which only ever see missing values stay small.
+    // Each register holds the largest rank ("number of leading zeros plus one") of the hashes it
+    // has been given.
+    std::vector<unsigned char> _registers;
+};
 }
@@ -0,0 +1,158 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <cmath>
+
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/platform/bits.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+REGISTER_ACCUMULATOR(approxDistinct, AccumulatorApproxDistinct::create);
+REGISTER_EXPRESSION(approxDistinct, ExpressionFromAccumulator<AccumulatorApproxDistinct>::parse);
+
+namespace {
+
+/**
+ * Value::hash_combine() is only meant for hash tables, and leaves small integers with small
+ * hashes. The sketch needs every bit of the hash to look random, so mix it with the finalizer of
+ * MurmurHash3.
+ */
+uint64_t mixHash(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+}  // namespace
+
+const char* AccumulatorApproxDistinct::getOpName() const {
+    return "$approxDistinct";
+}
+
+void AccumulatorApproxDistinct::addHash(uint64_t hash) {
+    if (_registers.empty()) {
+        _registers.resize(kNumRegisters);
+        _memUsageBytes = sizeof(*this) + _registers.capacity();
+    }
+
+    // The top bits pick the register, and the rank of the remaining bits is recorded in it. The
+    // low bit set below the remaining bits bounds the rank if they are all zero.
+    const size_t index = hash >> (64 - kPrecision);
+    const uint64_t rest = (hash << kPrecision) | (uint64_t(1) << (kPrecision - 1));
+    const unsigned char rank = countLeadingZeros64(rest) + 1;
+    if (rank > _registers[index]) {
+        _registers[index] = rank;
+    }
+}
+
+void AccumulatorApproxDistinct::processInternal(const Value& input, bool merging) {
+    if (!merging) {
+        if (input.missing()) {
+            return;
+        }
+        size_t seed = 0;
+        input.hash_combine(seed);
+        addHash(mixHash(seed));
+        return;
+    }
+
+    // This is what getValue(true) produced below: either no registers, or all of them.
+    verify(input.getType() == BinData);
+    const BSONBinData binData = input.getBinData();
+    if (binData.length == 0) {
+        return;
+    }
+    verify(binData.length == int(kNumRegisters));
+    const unsigned char* registers = static_cast<const unsigned char*>(binData.data);
+
+    if (_registers.empty()) {
+        _registers.assign(registers, registers + kNumRegisters);
+        _memUsageBytes = sizeof(*this) + _registers.capacity();
+        return;
+    }
+    for (size_t i = 0; i < kNumRegisters; i++) {
+        const unsigned char rank = registers[i];
+        if (rank > _registers[i]) {
+            _registers[i] = rank;
+        }
+    }
+}
+
+Value AccumulatorApproxDistinct::getValue(bool toBeMerged) const {
+    if (toBeMerged) {
+        return Value(BSONBinData(_registers.data(), _registers.size(), BinDataGeneral));
+    }
+
+    if (_registers.empty()) {
+        return Value(0LL);
+    }
+
+    // The raw HyperLogLog estimate is the bias corrected harmonic mean of 2^rank over all of the
+    // registers.
+    const double m = kNumRegisters;
+    double sum = 0;
+    size_t numZeros = 0;
+    for (unsigned char rank : _registers) {
+        sum += std::ldexp(1.0, -int(rank));
+        if (rank == 0) {
+            numZeros++;
+        }
+    }
+    double estimate = (0.7213 / (1 + 1.079 / m)) * m * m / sum;
+
+    // The raw estimate is poor while many registers are still empty. Count the empty registers
+    // instead ("linear counting"), which is far more accurate at small cardinalities.
+    if (estimate <= 2.5 * m && numZeros > 0) {
+        estimate = m * std::log(m / numZeros);
+    }
+    return Value(static_cast<long long>(std::llround(estimate)));
+}
+
+AccumulatorApproxDistinct::AccumulatorApproxDistinct() {
+    _memUsageBytes = sizeof(*this);
+}
+
+void AccumulatorApproxDistinct::reset() {
+    std::vector<unsigned char>().swap(_registers);
+    _memUsageBytes = sizeof(*this);
+}
+
+intrusive_ptr<Accumulator> AccumulatorApproxDistinct::create() {
+    return new AccumulatorApproxDistinct();
+}
+}
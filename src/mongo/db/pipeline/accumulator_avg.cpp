@@ -52,17 +52,32 @@ const char countName[] = "count";
 
 void AccumulatorAvg::processInternal(const Value& input, bool merging) {
     if (!merging) {
+        if (input.getType() == NumberDecimal) {
+            _decimalTotal.add(input.getDecimal());
+            _hasDecimal = true;
+            _count += 1;
+            return;
+        }
+
         // non numeric types have no impact on average
         if (!input.numeric())
             return;
 
         _total += input.getDouble();
+        _hasNonDecimal = true;
         _count += 1;
     } else {
         // We expect an object that contains both a subtotal and a count.
         // This is what getValue(true) produced below.
         verify(input.getType() == Object);
-        _total += input[subTotalName].getDouble();
+        Value subTotal = input[subTotalName];
+        if (subTotal.getType() == NumberDecimal) {
+            _decimalTotal.add(subTotal.getDecimal());
+            _hasDecimal = true;
+        } else {
+            _total += subTotal.getDouble();
+            _hasNonDecimal = true;
+        }
         _count += input[countName].getLong();
     }
 }
@@ -71,18 +86,33 @@ intrusive_ptr<Accumulator> AccumulatorAvg::create() {
     return new AccumulatorAvg();
 }
 
+Decimal128 AccumulatorAvg::getDecimalTotal() const {
+    if (!_hasNonDecimal) {
+        return _decimalTotal.getDecimal();
+    }
+    DecimalSummation total = _decimalTotal;
+    total.add(Decimal128(_total));
+    return total.getDecimal();
+}
+
 Value AccumulatorAvg::getValue(bool toBeMerged) const {
     if (!toBeMerged) {
         if (_count == 0)
             return Value(BSONNULL);
 
+        if (_hasDecimal)
+            return Value(getDecimalTotal().divide(Decimal128(_count)));
+
         return Value(_total / static_cast<double>(_count));
     } else {
+        if (_hasDecimal)
+            return Value(DOC(subTotalName << getDecimalTotal() << countName << _count));
+
         return Value(DOC(subTotalName << _total << countName << _count));
     }
 }
 
-AccumulatorAvg::AccumulatorAvg() : _total(0), _count(0) {
+AccumulatorAvg::AccumulatorAvg() : _total(0), _count(0), _hasDecimal(false), _hasNonDecimal(false) {
     // This is a fixed size Accumulator so we never need to update this
     _memUsageBytes = sizeof(*this);
 }
@@ -90,5 +120,8 @@ AccumulatorAvg::AccumulatorAvg() : _total(0), _count(0) {
 void AccumulatorAvg::reset() {
     _total = 0;
     _count = 0;
+    _decimalTotal = DecimalSummation();
+    _hasDecimal = false;
+    _hasNonDecimal = false;
 }
 }
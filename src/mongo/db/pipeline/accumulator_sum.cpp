@@ -44,18 +44,26 @@ const char* AccumulatorSum::getOpName() const {
 }
 
 void AccumulatorSum::processInternal(const Value& input, bool merging) {
+    if (input.getType() == NumberDecimal) {
+        totalType = NumberDecimal;
+        decimalTotal.add(input.getDecimal());
+        return;
+    }
+
     // do nothing with non numeric types
     if (!input.numeric())
         return;
 
     // upgrade to the widest type required to hold the result
     totalType = Value::getWidestNumeric(totalType, input.getType());
+    nonDecimalTotalType = Value::getWidestNumeric(nonDecimalTotalType, input.getType());
+    hasNonDecimal = true;
 
-    if (totalType == NumberInt || totalType == NumberLong) {
+    if (nonDecimalTotalType == NumberInt || nonDecimalTotalType == NumberLong) {
         long long v = input.coerceToLong();
         longTotal += v;
         doubleTotal += v;
-    } else if (totalType == NumberDouble) {
+    } else if (nonDecimalTotalType == NumberDouble) {
         double v = input.coerceToDouble();
         doubleTotal += v;
     } else {
@@ -75,12 +83,28 @@ Value AccumulatorSum::getValue(bool toBeMerged) const {
         return Value(doubleTotal);
     } else if (totalType == NumberInt) {
         return Value::createIntOrLong(longTotal);
+    } else if (totalType == NumberDecimal) {
+        if (!hasNonDecimal) {
+            return Value(decimalTotal.getDecimal());
+        }
+        DecimalSummation total = decimalTotal;
+        if (nonDecimalTotalType == NumberDouble) {
+            total.add(Decimal128(doubleTotal));
+        } else {
+            total.add(longTotal);
+        }
+        return Value(total.getDecimal());
     } else {
         massert(16000, "$sum resulted in a non-numeric type", false);
     }
 }
 
-AccumulatorSum::AccumulatorSum() : totalType(NumberInt), longTotal(0), doubleTotal(0) {
+AccumulatorSum::AccumulatorSum()
+    : totalType(NumberInt),
+      longTotal(0),
+      doubleTotal(0),
+      nonDecimalTotalType(NumberInt),
+      hasNonDecimal(false) {
     // This is a fixed size Accumulator so we never need to update this
     _memUsageBytes = sizeof(*this);
 }
@@ -89,5 +113,8 @@ void AccumulatorSum::reset() {
     totalType = NumberInt;
     longTotal = 0;
     doubleTotal = 0;
+    decimalTotal = DecimalSummation();
+    nonDecimalTotalType = NumberInt;
+    hasNonDecimal = false;
 }
 }
@@ -93,6 +93,54 @@ static void assertExpectedResults(
     }
 }
 
+TEST(Accumulators, ApproxDistinct) {
+    assertExpectedResults(
+        "$approxDistinct",
+        {// No documents evaluated.
+         {{}, Value(0LL)},
+         // Missing values are ignored.
+         {{Value(), Value()}, Value(0LL)},
+
+         // One value.
+         {{Value(1)}, Value(1LL)},
+         // Duplicates are counted once.
+         {{Value(1), Value(1), Value(1)}, Value(1LL)},
+         // Numbers which compare equal are counted once.
+         {{Value(1), Value(1LL), Value(1.0)}, Value(1LL)},
+         // Null counts as a value.
+         {{Value(BSONNULL), Value(2), Value()}, Value(2LL)},
+         // Values of different types.
+         {{Value(1), Value("1"), Value(DOC("a" << 1)), Value(std::vector<Value>{Value(1)})},
+          Value(4LL)}});
+}
+
+TEST(Accumulators, ApproxDistinctEstimatesLargeCardinality) {
+    auto factory = Accumulator::getFactory("$approxDistinct");
+    const int kNumShards = 4;
+    const long long kNumDistinct = 100000;
+
+    // Each shard sees a quarter of the numbers, and every string is seen by two shards.
+    std::vector<intrusive_ptr<Accumulator>> shards;
+    for (int i = 0; i < kNumShards; i++) {
+        shards.push_back(factory());
+    }
+    for (long long i = 0; i < kNumDistinct; i++) {
+        const int shard = i % kNumShards;
+        shards[shard]->process(Value(i), false);
+        shards[shard]->process(Value(std::to_string(i)), false);
+        shards[(shard + 1) % kNumShards]->process(Value(std::to_string(i)), false);
+    }
+
+    intrusive_ptr<Accumulator> merger = factory();
+    for (auto&& shard : shards) {
+        // The sketch does not grow with its input.
+        ASSERT_LESS_THAN(shard->memUsageForSorter(), 8 * 1024);
+        merger->process(shard->getValue(true), true);
+    }
+    const long long estimate = merger->getValue(false).getLong();
+    ASSERT_LESS_THAN(std::abs(estimate - 2 * kNumDistinct), 2 * kNumDistinct / 20);
+}
+
 TEST(Accumulators, Avg) {
     assertExpectedResults(
         "$avg",
@@ -277,4 +325,64 @@ TEST(Accumulators, Sum) {
          {{Value(9), Value()}, Value(9)}});
 }
 
+TEST(Accumulators, SumDecimal) {
+    if (!Decimal128::enabled) {
+        return;
+    }
+    assertExpectedResults(
+        "$sum",
+        {// One decimal.
+         {{Value(Decimal128("1.25"))}, Value(Decimal128("1.25"))},
+         // Decimals with the same exponent.
+         {{Value(Decimal128("1.25")), Value(Decimal128("-0.50"))}, Value(Decimal128("0.75"))},
+         // Decimals with different exponents.
+         {{Value(Decimal128("1.5")), Value(Decimal128("0.25")), Value(Decimal128("1E+2"))},
+          Value(Decimal128("101.75"))},
+         // A decimal, an int and a long.
+         {{Value(Decimal128("1.25")), Value(3), Value(4LL)}, Value(Decimal128("8.25"))},
+         // A decimal and a double.
+         {{Value(0.5), Value(Decimal128("1.25"))}, Value(Decimal128("1.75"))},
+         // Coefficients which overflow a long long are still summed exactly.
+         {{Value(Decimal128("9223372036854775807")), Value(Decimal128("9223372036854775807"))},
+          Value(Decimal128("18446744073709551614"))},
+         // Exponents too far apart to scale to each other.
+         {{Value(Decimal128("1E+30")), Value(Decimal128("1E-10"))},
+          Value(Decimal128("1E+30").add(Decimal128("1E-10")))},
+         // An infinity.
+         {{Value(Decimal128("1")), Value(Decimal128::kNegativeInfinity)},
+          Value(Decimal128::kNegativeInfinity)},
+         // Non numeric values are ignored.
+         {{Value(Decimal128("2.5")), Value("string"), Value()}, Value(Decimal128("2.5"))}});
+}
+
+TEST(Accumulators, SumDecimalKeepsExponent) {
+    if (!Decimal128::enabled) {
+        return;
+    }
+    intrusive_ptr<Accumulator> sum = Accumulator::getFactory("$sum")();
+    for (int i = 0; i < 100000; i++) {
+        sum->process(Value(Decimal128("0.01")), false);
+    }
+    ASSERT_EQUALS(sum->getValue(false).getDecimal().toString(), "1000.00");
+
+    sum = Accumulator::getFactory("$sum")();
+    sum->process(Value(Decimal128("-0")), false);
+    sum->process(Value(Decimal128("-0.0")), false);
+    ASSERT_EQUALS(sum->getValue(false).getDecimal().toString(), "-0.0");
+}
+
+TEST(Accumulators, AvgDecimal) {
+    if (!Decimal128::enabled) {
+        return;
+    }
+    assertExpectedResults(
+        "$avg",
+        {// Averaging two decimals.
+         {{Value(Decimal128("1.5")), Value(Decimal128("2.5"))}, Value(Decimal128("2"))},
+         // The average of a decimal, an int and a double is a decimal.
+         {{Value(Decimal128("1")), Value(2), Value(3.0)}, Value(Decimal128("2"))},
+         // Non numeric values are ignored.
+         {{Value(Decimal128("1")), Value("string")}, Value(Decimal128("1"))}});
+}
+
 }  // namespace AccumulatorTests
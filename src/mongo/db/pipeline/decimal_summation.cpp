@@ -0,0 +1,183 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/decimal_summation.h"
+
+#include <limits>
+
+namespace mongo {
+
+namespace {
+
+const long long kMaxCoefficient = std::numeric_limits<long long>::max();
+const long long kMinCoefficient = std::numeric_limits<long long>::min();
+
+// The powers of ten which fit in a long long.
+const long long kPowersOfTen[] = {1LL,
+                                  10LL,
+                                  100LL,
+                                  1000LL,
+                                  10000LL,
+                                  100000LL,
+                                  1000000LL,
+                                  10000000LL,
+                                  100000000LL,
+                                  1000000000LL,
+                                  10000000000LL,
+                                  100000000000LL,
+                                  1000000000000LL,
+                                  10000000000000LL,
+                                  100000000000000LL,
+                                  1000000000000000LL,
+                                  10000000000000000LL,
+                                  100000000000000000LL,
+                                  1000000000000000000LL};
+
+/**
+ * Multiplies '*coefficient' by 10^scale. Returns false, leaving '*coefficient' unchanged, if the
+ * result would not fit in a long long.
+ */
+bool scaleCoefficient(long long* coefficient, std::uint32_t scale) {
+    if (*coefficient == 0) {
+        return true;
+    }
+    if (scale >= sizeof(kPowersOfTen) / sizeof(kPowersOfTen[0])) {
+        return false;
+    }
+    const long long limit = kMaxCoefficient / kPowersOfTen[scale];
+    if (*coefficient > limit || *coefficient < -limit) {
+        return false;
+    }
+    *coefficient *= kPowersOfTen[scale];
+    return true;
+}
+
+/**
+ * Adds 'addend' to '*total'. Returns false, leaving '*total' unchanged, if the sum would not fit
+ * in a long long.
+ */
+bool addCoefficients(long long* total, long long addend) {
+    if ((addend > 0 && *total > kMaxCoefficient - addend) ||
+        (addend < 0 && *total < kMinCoefficient - addend)) {
+        return false;
+    }
+    *total += addend;
+    return true;
+}
+
+}  // namespace
+
+void DecimalSummation::add(const Decimal128& value) {
+    if (value.getCoefficientHigh() != 0 ||
+        value.getCoefficientLow() > static_cast<std::uint64_t>(kMaxCoefficient)) {
+        addSlow(value);
+        return;
+    }
+
+    const long long magnitude = static_cast<long long>(value.getCoefficientLow());
+    const bool negative = value.isNegative();
+    if (negative && magnitude == 0) {
+        // The integer accumulator has no negative zero, and the sum of negative zeros is one.
+        addSlow(value);
+        return;
+    }
+
+    if (!addCoefficient(negative ? -magnitude : magnitude, value.getBiasedExponent())) {
+        addSlow(value);
+    }
+}
+
+void DecimalSummation::add(long long value) {
+    if (!addCoefficient(value, Decimal128::kExponentBias)) {
+        addSlow(Decimal128(value));
+    }
+}
+
+Decimal128 DecimalSummation::getDecimal() const {
+    if (!_hasCoefficient) {
+        return _hasDecimalTotal ? _decimalTotal : Decimal128(0, Decimal128::kExponentBias, 0, 0);
+    }
+    const Decimal128 partialSum = coefficientToDecimal();
+    return _hasDecimalTotal ? _decimalTotal.add(partialSum) : partialSum;
+}
+
+bool DecimalSummation::addCoefficient(long long coefficient, std::uint32_t biasedExponent) {
+    if (!_hasCoefficient) {
+        _hasCoefficient = true;
+        _biasedExponent = biasedExponent;
+        _coefficient = coefficient;
+        return true;
+    }
+
+    if (biasedExponent > _biasedExponent) {
+        // Bring the new value down to the accumulator's exponent.
+        if (!scaleCoefficient(&coefficient, biasedExponent - _biasedExponent)) {
+            return false;
+        }
+    } else if (biasedExponent < _biasedExponent) {
+        // Bring the accumulator down to the new value's exponent, or start again from the new
+        // value if it cannot be.
+        if (!scaleCoefficient(&_coefficient, _biasedExponent - biasedExponent)) {
+            flushCoefficient();
+            return addCoefficient(coefficient, biasedExponent);
+        }
+        _biasedExponent = biasedExponent;
+    }
+
+    if (!addCoefficients(&_coefficient, coefficient)) {
+        flushCoefficient();
+        return addCoefficient(coefficient, _biasedExponent);
+    }
+    return true;
+}
+
+void DecimalSummation::flushCoefficient() {
+    if (!_hasCoefficient) {
+        return;
+    }
+    const Decimal128 partialSum = coefficientToDecimal();
+    _hasCoefficient = false;
+    addSlow(partialSum);
+}
+
+void DecimalSummation::addSlow(const Decimal128& value) {
+    _decimalTotal = _hasDecimalTotal ? _decimalTotal.add(value) : value;
+    _hasDecimalTotal = true;
+}
+
+Decimal128 DecimalSummation::coefficientToDecimal() const {
+    // Negate in unsigned arithmetic so that the most negative long long has a magnitude.
+    const std::uint64_t magnitude = _coefficient < 0
+        ? 0 - static_cast<std::uint64_t>(_coefficient)
+        : static_cast<std::uint64_t>(_coefficient);
+    return Decimal128(_coefficient < 0 ? 1 : 0, _biasedExponent, 0, magnitude);
+}
+
+}  // namespace mongo
@@ -0,0 +1,83 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/platform/decimal128.h"
+
+namespace mongo {
+
+/**
+ * Sums Decimal128 values without going through the decimal library for each one. Finite values
+ * whose coefficients fit in a long long are added exactly into an integer coefficient scaled to
+ * the smallest exponent seen so far, and only getDecimal() converts that back into a Decimal128.
+ * Infinities, NaNs, negative zeros, coefficients which would overflow the integer accumulator
+ * and exponents too far apart to be scaled fall back to Decimal128::add().
+ */
+class DecimalSummation {
+public:
+    void add(const Decimal128& value);
+
+    /**
+     * Adds an integer as a decimal with an exponent of zero.
+     */
+    void add(long long value);
+
+    /**
+     * Returns the sum of the values added so far, or a zero if nothing was added.
+     */
+    Decimal128 getDecimal() const;
+
+private:
+    /**
+     * Adds coefficient * 10^(biasedExponent - Decimal128::kExponentBias) to the integer
+     * accumulator. Returns false if the value cannot be scaled to the accumulator's exponent, in
+     * which case the caller must add it with addSlow().
+     */
+    bool addCoefficient(long long coefficient, std::uint32_t biasedExponent);
+
+    /**
+     * Moves the integer accumulator into the decimal total.
+     */
+    void flushCoefficient();
+
+    void addSlow(const Decimal128& value);
+
+    Decimal128 coefficientToDecimal() const;
+
+    bool _hasCoefficient = false;
+    std::uint32_t _biasedExponent = 0;
+    long long _coefficient = 0;
+
+    bool _hasDecimalTotal = false;
+    Decimal128 _decimalTotal;
+};
+
+}  // namespace mongo
@@ -143,10 +143,14 @@ Value arrayHelper(const BSONObj& bson, const Document& neededFields) {
 
 // Handles object-typed values including the top-level for ParsedDeps::extractFields
 Document documentHelper(const BSONObj& bson, const Document& neededFields) {
-    MutableDocument md(neededFields.size());
+    const size_t numNeededFields = neededFields.size();
+    MutableDocument md(numNeededFields);
 
+    // Once every needed field has been extracted, the rest of 'bson' can't add anything that a
+    // lookup would see, so we stop decoding it.
+    size_t numExtractedFields = 0;
     BSONObjIterator it(bson);
-    while (it.more()) {
+    while (it.more() && numExtractedFields < numNeededFields) {
         BSONElement bsonElement(it.next());
         StringData fieldName = bsonElement.fieldNameStringData();
         Value isNeeded = neededFields[fieldName];
@@ -154,22 +158,26 @@ Document documentHelper(const BSONObj& bson, const Document& neededFields) {
         if (isNeeded.missing())
             continue;
 
+        Value extracted;
         if (isNeeded.getType() == Bool) {
-            md.addField(fieldName, Value(bsonElement));
-            continue;
-        }
-
-        dassert(isNeeded.getType() == Object);
-
-        if (bsonElement.type() == Object) {
-            Document sub = documentHelper(bsonElement.embeddedObject(), isNeeded.getDocument());
-            md.addField(fieldName, Value(sub));
+            extracted = Value(bsonElement);
+        } else {
+            dassert(isNeeded.getType() == Object);
+
+            if (bsonElement.type() == Object) {
+                extracted =
+                    Value(documentHelper(bsonElement.embeddedObject(), isNeeded.getDocument()));
+            } else if (bsonElement.type() == Array) {
+                extracted = arrayHelper(bsonElement.embeddedObject(), isNeeded.getDocument());
+            } else {
+                continue;
+            }
         }
 
-        if (bsonElement.type() == Array) {
-            md.addField(fieldName,
-                        arrayHelper(bsonElement.embeddedObject(), isNeeded.getDocument()));
-        }
+        // Only the first of several fields with the same name counts as extracted.
+        if (md.peek()[fieldName].missing())
+            numExtractedFields++;
+        md.addField(fieldName, extracted);
     }
 
     return md.freeze();
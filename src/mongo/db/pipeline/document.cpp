@@ -30,8 +30,6 @@
 
 #include "mongo/db/pipeline/document.h"
 
-#include <boost/functional/hash.hpp>
-
 #include "mongo/db/jsobj.h"
 #include "mongo/db/pipeline/field_path.h"
 #include "mongo/util/mongoutils/str.h"
@@ -363,8 +361,10 @@ size_t Document::getApproximateSize() const {
 
 void Document::hash_combine(size_t& seed) const {
     for (DocumentStorageIterator it = storage().iterator(); !it.atEnd(); it.advance()) {
+        // Hash the whole name at once, as Value::hash_combine() does for strings, rather than
+        // combining it into the seed a byte at a time.
         StringData name = it->nameSD();
-        boost::hash_range(seed, name.rawData(), name.rawData() + name.size());
+        MurmurHash3_x86_32(name.rawData(), name.size(), seed, &seed);
         it->val.hash_combine(seed);
     }
 }
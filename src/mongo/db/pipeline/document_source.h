@@ -50,8 +50,10 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/expression.h"
+#include "mongo/db/pipeline/group_table.h"
 #include "mongo/db/pipeline/value.h"
 #include "mongo/db/sorter/sorter.h"
+#include "mongo/db/timeseries/bucket.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/intrusive_counter.h"
 
@@ -287,13 +289,21 @@ public:
         virtual bool isCapped(const NamespaceString& ns) = 0;
 
         /**
-         * Inserts 'objs' into 'ns' and returns the "detailed" last error object.
+         * Inserts 'objs' into the existing collection 'ns' as one batch, in a single storage
+         * transaction, bypassing the write operation path.
          */
-        virtual BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) = 0;
+        virtual Status insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) = 0;
 
         virtual CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
                                                       const NamespaceString& ns) = 0;
 
+        /**
+         * Returns the statistics of the query shapes run against 'ns', as described by
+         * QueryStatsEntry::appendTo().
+         */
+        virtual std::vector<BSONObj> getQueryStats(OperationContext* opCtx,
+                                                   const NamespaceString& ns) = 0;
+
         // Add new methods as needed.
     };
 
@@ -437,6 +447,28 @@ public:
         _doingMerge = doingMerge;
     }
 
+    /**
+     * Returns true if documents with equal group keys are adjacent in input sorted by
+     * 'sortPattern', which holds when the group key is made up of field paths forming a prefix of
+     * 'sortPattern' in any order.
+     */
+    bool canStreamInputSortedBy(const BSONObj& sortPattern) const;
+
+    /**
+     * Returns a sort pattern on the field paths making up the group key, or an empty object if the
+     * group key is not made up of field paths.
+     */
+    BSONObj getStreamingSortPattern() const;
+
+    /**
+     * Tell this source that its input is sorted so that canStreamInputSortedBy() holds. Each group
+     * is then returned as soon as the group key changes, rather than after all input is consumed.
+     * Defaults to false.
+     */
+    void setStreaming(bool streaming) {
+        _streaming = streaming;
+    }
+
     /**
       Create a grouping DocumentSource from BSON.
 
@@ -470,9 +502,29 @@ private:
       on the first call to any method on this source.  The populated
       boolean indicates that this has been done.
      */
-    void populate();
+    void populate(boost::optional<Document> firstInput = boost::none);
     bool populated;
 
+    /**
+     * Returns the next group when '_streaming', or boost::none once the input is exhausted. If a
+     * group key is found whose sort order may not keep its documents adjacent, the remaining input
+     * is grouped by populate() instead and this also returns boost::none.
+     */
+    boost::optional<Document> getNextStreaming();
+
+    /**
+     * Returns true if this is the shards' part of a split $group whose accumulators give the same
+     * result however their input is partitioned and ordered, so that it may stop grouping and send
+     * partial groups with repeated keys to the merger.
+     */
+    bool canStopPreAggregating() const;
+
+    /**
+     * Returns the next input document as a partial group of its own when '_passingThrough', or
+     * boost::none once the input is exhausted.
+     */
+    boost::optional<Document> getNextPassThrough();
+
     /**
      * Parses the raw id expression into _idExpressions and possibly _idFieldNames.
      */
@@ -490,9 +542,8 @@ private:
     Value expandId(const Value& val);
 
 
-    typedef std::vector<boost::intrusive_ptr<Accumulator>> Accumulators;
-    typedef std::unordered_map<Value, Accumulators, Value::Hash> GroupsMap;
-    GroupsMap groups;
+    typedef GroupTable::Accumulators Accumulators;
+    GroupTable groups;
 
     /*
       The field names for the result documents and the accumulator
@@ -515,6 +566,7 @@ private:
 
     bool _doingMerge;
     bool _spilled;
+    bool _streaming;
     const bool _extSortAllowed;
     const int _maxMemoryUsageBytes;
     std::unique_ptr<Variables> _variables;
@@ -522,13 +574,22 @@ private:
     std::vector<boost::intrusive_ptr<Expression>> _idExpressions;
 
     // only used when !_spilled
-    GroupsMap::iterator groupsIterator;
+    GroupTable::const_iterator groupsIterator;
 
     // only used when _spilled
     std::unique_ptr<Sorter<Value, Value>::Iterator> _sorterIterator;
     std::pair<Value, Value> _firstPartOfNextGroup;
+
+    // used when _spilled or _streaming
     Value _currentId;
     Accumulators _currentAccumulators;
+
+    // only used when _streaming
+    bool _haveCurrentGroup;
+
+    // Set by populate() when it stops grouping because its groups hardly reduce the input. The
+    // remaining input is passed through by getNextPassThrough() once the groups are returned.
+    bool _passingThrough;
 };
 
 /**
@@ -557,6 +618,147 @@ private:
     std::string _processName;
 };
 
+/**
+ * Provides a document source interface to retrieve the statistics of the query shapes run against
+ * a given namespace. Each document returned represents a single query shape and mongod instance.
+ */
+class DocumentSourceQueryStats final : public DocumentSource, public DocumentSourceNeedsMongod {
+public:
+    // virtuals from DocumentSource
+    boost::optional<Document> getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(bool explain = false) const final;
+
+    virtual bool isValidInitialSource() const final {
+        return true;
+    }
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    DocumentSourceQueryStats(const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    bool _populated = false;
+    std::vector<BSONObj> _queryStats;
+    std::vector<BSONObj>::const_iterator _queryStatsIter;
+    std::string _processName;
+};
+
+/**
+ * Joins each input document with the documents of the unsharded collection 'from' in the same
+ * database whose 'foreignField' equals the input's 'localField', storing the matches in an array
+ * at 'as'.
+ *
+ * When 'foreignField' is the leading field of a btree index, the join looks up the foreign
+ * documents for a batch of input documents with a single $in query so that the index scan seeks
+ * once per distinct value. Otherwise the foreign collection is scanned once into an in-memory
+ * hash table, falling back to one scan per batch of input documents if the table grows too large.
+ *
+ * A directly following $unwind of 'as' is absorbed into this stage, as is any $match after it
+ * that only refers to fields under 'as', which is then evaluated by the foreign query.
+ */
+class DocumentSourceLookUp final : public DocumentSource,
+                                   public SplittableDocumentSource,
+                                   public DocumentSourceNeedsMongod {
+public:
+    // virtuals from DocumentSource
+    boost::optional<Document> getNext() final;
+    const char* getSourceName() const final;
+    void serializeToArray(std::vector<Value>& array, bool explain = false) const final;
+    bool coalesce(const boost::intrusive_ptr<DocumentSource>& pNextSource) final;
+    void dispose() final;
+    GetDepsReturn getDependencies(DepsTracker* deps) const final;
+
+    bool needsPrimaryShard() const final {
+        return true;
+    }
+
+    void addInvolvedCollections(std::vector<NamespaceString>* collections) const final {
+        collections->push_back(_fromNs);
+    }
+
+    // Virtuals for SplittableDocumentSource
+    boost::intrusive_ptr<DocumentSource> getShardSource() final {
+        return NULL;
+    }
+    boost::intrusive_ptr<DocumentSource> getMergeSource() final {
+        return this;
+    }
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    enum class JoinStrategy {
+        // Not yet chosen; decided on the first call to getNext().
+        kUndecided,
+        // One $in query per batch of input documents, answered by an index on 'foreignField'.
+        kIndexedProbe,
+        // The whole foreign collection is held in '_foreignDocs'.
+        kHash,
+        // One scan of the foreign collection per batch of input documents.
+        kBlockNestedLoop,
+    };
+
+    DocumentSourceLookUp(NamespaceString fromNs,
+                         std::string as,
+                         std::string localField,
+                         std::string foreignField,
+                         const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+    Value serialize(bool explain = false) const final {
+        verify(false);  // should call serializeToArray instead
+    }
+
+    void chooseStrategy();
+
+    /**
+     * Returns true if 'foreignField' is the leading field of a non-sparse btree index on '_fromNs'.
+     */
+    bool foreignFieldIsIndexed();
+
+    /**
+     * Replaces the contents of '_foreignDocs' with the foreign documents matching 'query'. Returns
+     * false, leaving '_foreignDocs' empty, if they would use more than 'maxMemoryUsageBytes'.
+     */
+    bool loadForeignDocs(const BSONObj& query, long long maxMemoryUsageBytes);
+
+    /**
+     * Returns the query for the foreign documents which may join with any of 'localKeys'.
+     */
+    BSONObj buildForeignQuery(const ValueSet& localKeys) const;
+
+    void addLocalKeys(const Document& input, ValueSet* localKeys) const;
+
+    /**
+     * Appends the result of joining 'input' with '_foreignDocs' to '_output'.
+     */
+    void join(const Document& input);
+
+    const NamespaceString _fromNs;
+    const FieldPath _as;
+    const FieldPath _localField;
+    const std::string _foreignField;
+
+    // Set when a following $unwind of '_as' has been absorbed.
+    bool _handlingUnwind;
+
+    // The $match specs absorbed after the $unwind, and their conjunction rewritten in terms of
+    // the foreign documents' fields.
+    std::vector<BSONObj> _absorbedMatches;
+    BSONObj _foreignFilter;
+
+    JoinStrategy _strategy;
+
+    std::vector<Document> _foreignDocs;
+
+    // Maps each value of 'foreignField' to the positions in '_foreignDocs' holding it.
+    std::unordered_map<Value, std::vector<size_t>, Value::Hash> _foreignIndex;
+
+    std::deque<Document> _output;
+};
+
 
 class DocumentSourceMatch final : public DocumentSource {
 public:
@@ -642,6 +844,9 @@ private:
         CursorAndConnection(ConnectionString host, NamespaceString ns, CursorId id);
         ScopedDbConnection connection;
         DBClientCursor cursor;
+
+        // Whether a getMore has been sent on 'connection' whose reply has not been received yet.
+        bool pendingGetMore = false;
     };
 
     // using list to enable removing arbitrary elements
@@ -742,8 +947,13 @@ private:
 
     void spill(const std::vector<BSONObj>& toInsert);
 
+    // Builds the indexes of _outputNs, saved by prepTempCollection(), on the filled _tempNs.
+    void copyIndexes();
+
     bool _done;
 
+    std::list<BSONObj> _indexesToCopy;
+
     NamespaceString _tempNs;          // output goes here as it is being processed.
     const NamespaceString _outputNs;  // output will go here after all data is processed.
 };
@@ -1179,6 +1389,60 @@ private:
     std::unique_ptr<Unwinder> _unwinder;
 };
 
+/**
+ * Groups measurements of a time series into buckets, each holding one series' measurements over
+ * a window of time in compressed columns (see BucketBuilder). The input should be sorted by the
+ * meta field and then the time field, or every change of series starts a new bucket.
+ */
+class DocumentSourcePackBuckets final : public DocumentSource {
+public:
+    boost::optional<Document> getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(bool explain = false) const final;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    DocumentSourcePackBuckets(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+                              std::string timeField,
+                              std::string metaField,
+                              int maxCount,
+                              Milliseconds maxSpan);
+
+    const std::string _timeField;
+    const std::string _metaField;
+    const int _maxCount;
+    const Milliseconds _maxSpan;
+
+    BucketBuilder _builder;
+    // A measurement which did not fit in the last bucket, to start the next one with.
+    boost::optional<BSONObj> _pending;
+};
+
+/**
+ * Returns the measurements stored in buckets made by $_internalPackBuckets.
+ */
+class DocumentSourceUnpackBucket final : public DocumentSource {
+public:
+    boost::optional<Document> getNext() final;
+    const char* getSourceName() const final;
+    Value serialize(bool explain = false) const final;
+
+    static boost::intrusive_ptr<DocumentSource> createFromBson(
+        BSONElement elem, const boost::intrusive_ptr<ExpressionContext>& pExpCtx);
+
+private:
+    DocumentSourceUnpackBucket(const boost::intrusive_ptr<ExpressionContext>& pExpCtx,
+                               std::string timeField,
+                               std::string metaField);
+
+    const std::string _timeField;
+    const std::string _metaField;
+
+    BucketUnpacker _unpacker;
+};
+
 class DocumentSourceGeoNear : public DocumentSource,
                               public SplittableDocumentSource,
                               public DocumentSourceNeedsMongod {
@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -53,6 +54,11 @@ const char* DocumentSourceGroup::getSourceName() const {
 boost::optional<Document> DocumentSourceGroup::getNext() {
     pExpCtx->checkForInterrupt();
 
+    if (_streaming && !populated) {
+        if (boost::optional<Document> out = getNextStreaming())
+            return out;
+    }
+
     if (!populated)
         populate();
 
@@ -101,23 +107,158 @@ boost::optional<Document> DocumentSourceGroup::getNext() {
         return makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
 
     } else {
-        if (groups.empty())
+        if (groups.empty()) {
+            if (_passingThrough)
+                return getNextPassThrough();
             return boost::none;
+        }
 
         Document out =
             makeDocument(groupsIterator->first, groupsIterator->second, pExpCtx->inShard);
 
-        if (++groupsIterator == groups.end())
-            dispose();
+        if (++groupsIterator == groups.end()) {
+            if (_passingThrough) {
+                groups.clear();
+            } else {
+                dispose();
+            }
+        }
 
         return out;
     }
 }
 
+bool DocumentSourceGroup::canStopPreAggregating() const {
+    if (!pExpCtx->inShard || _doingMerge || internalDocumentSourceGroupMinPreAggregationRatio <= 0)
+        return false;
+
+    for (auto&& factory : vpAccumulatorFactory) {
+        if (!factory()->isAssociativeAndCommutative())
+            return false;
+    }
+    return true;
+}
+
+boost::optional<Document> DocumentSourceGroup::getNextPassThrough() {
+    boost::optional<Document> input = pSource->getNext();
+    if (!input) {
+        dispose();
+        return boost::none;
+    }
+
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+    if (_currentAccumulators.empty()) {
+        _currentAccumulators.reserve(numAccumulators);
+        for (size_t i = 0; i < numAccumulators; i++) {
+            _currentAccumulators.push_back(vpAccumulatorFactory[i]());
+        }
+    }
+
+    _variables->setRoot(*input);
+
+    Value id = computeId(_variables.get());
+    if (id.missing())
+        id = Value(BSONNULL);
+
+    for (size_t i = 0; i < numAccumulators; i++) {
+        _currentAccumulators[i]->reset();
+        _currentAccumulators[i]->process(vpExpression[i]->evaluate(_variables.get()), _doingMerge);
+    }
+
+    _variables->clearRoot();
+    return makeDocument(id, _currentAccumulators, pExpCtx->inShard);
+}
+
+namespace {
+/**
+ * Returns false if documents with this group key may not be adjacent in input sorted on the group
+ * key's fields. An index scan orders arrays by their first element in the sort direction, and a
+ * $sort treats undefined like missing, which groups as null.
+ */
+bool isStreamableGroupKey(const Value& component) {
+    return component.getType() != Array && component.getType() != Undefined;
+}
+}  // namespace
+
+boost::optional<Document> DocumentSourceGroup::getNextStreaming() {
+    const size_t numAccumulators = vpAccumulatorFactory.size();
+
+    while (boost::optional<Document> input = pSource->getNext()) {
+        _variables->setRoot(*input);
+
+        Value id = computeId(_variables.get());
+        if (id.missing())
+            id = Value(BSONNULL);
+
+        bool streamable = true;
+        if (_idExpressions.size() == 1) {
+            streamable = isStreamableGroupKey(id);
+        } else {
+            for (auto&& component : id.getArray()) {
+                streamable = streamable && isStreamableGroupKey(component);
+            }
+        }
+
+        if (!streamable) {
+            // The groups returned so far have keys which sort before this one and cannot recur,
+            // so group everything else in the hash table, starting with the current group.
+            _variables->clearRoot();
+            if (_haveCurrentGroup) {
+                bool inserted;
+                groups.findOrInsert(_currentId, &inserted) = std::move(_currentAccumulators);
+                _currentAccumulators.clear();
+                _haveCurrentGroup = false;
+            }
+            _streaming = false;
+            populate(std::move(input));
+            return boost::none;
+        }
+
+        boost::optional<Document> out;
+        if (_haveCurrentGroup && id != _currentId) {
+            out = makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                _currentAccumulators[i]->reset();  // prep accumulators for a new group
+            }
+        } else if (!_haveCurrentGroup && _currentAccumulators.empty()) {
+            _currentAccumulators.reserve(numAccumulators);
+            for (size_t i = 0; i < numAccumulators; i++) {
+                _currentAccumulators.push_back(vpAccumulatorFactory[i]());
+            }
+        }
+        _currentId = id;
+        _haveCurrentGroup = true;
+
+        for (size_t i = 0; i < numAccumulators; i++) {
+            _currentAccumulators[i]->process(vpExpression[i]->evaluate(_variables.get()),
+                                             _doingMerge);
+        }
+
+        // We are done with the ROOT document so release it.
+        _variables->clearRoot();
+
+        if (out)
+            return out;
+    }
+
+    // The input is exhausted, so the current group is the last one.
+    populated = true;
+    if (!_haveCurrentGroup)
+        return boost::none;
+
+    _haveCurrentGroup = false;
+    Document out = makeDocument(_currentId, _currentAccumulators, pExpCtx->inShard);
+    dispose();
+    return out;
+}
+
 void DocumentSourceGroup::dispose() {
     // free our resources
-    GroupsMap().swap(groups);
+    groups.clear();
     _sorterIterator.reset();
+    _currentAccumulators.clear();
+    _haveCurrentGroup = false;
+    _passingThrough = false;
 
     // make us look done
     groupsIterator = groups.end();
@@ -166,6 +307,10 @@ Value DocumentSourceGroup::serialize(bool explain) const {
             Value(DOC(accum->getOpName() << vpExpression[i]->serialize(explain)));
     }
 
+    if (explain && _streaming) {
+        insides["$streaming"] = Value(true);
+    }
+
     if (_doingMerge) {
         // This makes the output unparsable (with error) on pre 2.6 shards, but it will never
         // be sent to old shards when this flag is true since they can't do a merge anyway.
@@ -176,6 +321,52 @@ Value DocumentSourceGroup::serialize(bool explain) const {
     return Value(DOC(getSourceName() << insides.freeze()));
 }
 
+BSONObj DocumentSourceGroup::getStreamingSortPattern() const {
+    BSONObjBuilder sortPattern;
+    std::set<std::string> fields;
+    for (auto&& idExpression : _idExpressions) {
+        // Only field paths on the input document, such as "$a.b" or "$$ROOT.a.b", are ordered by
+        // a sort on that field.
+        auto fieldPathExpression = dynamic_cast<ExpressionFieldPath*>(idExpression.get());
+        if (!fieldPathExpression)
+            return BSONObj();
+
+        const FieldPath& fieldPath = fieldPathExpression->getFieldPath();
+        if (fieldPath.getPathLength() < 2 ||
+            (fieldPath.getFieldName(0) != "CURRENT" && fieldPath.getFieldName(0) != "ROOT")) {
+            return BSONObj();
+        }
+
+        const std::string field = fieldPath.tail().getPath(false);
+        if (fields.insert(field).second)
+            sortPattern.append(field, 1);
+    }
+    return sortPattern.obj();
+}
+
+bool DocumentSourceGroup::canStreamInputSortedBy(const BSONObj& sortPattern) const {
+    const BSONObj groupPattern = getStreamingSortPattern();
+    if (groupPattern.isEmpty())
+        return false;
+
+    std::set<std::string> fields;
+    for (auto&& elem : groupPattern) {
+        fields.insert(elem.fieldName());
+    }
+
+    // The first fields of the sort, in either direction, must be exactly the group key's fields.
+    BSONObjIterator sortIt(sortPattern);
+    for (size_t i = 0; i < fields.size(); i++) {
+        if (!sortIt.more())
+            return false;
+
+        BSONElement sortElem = sortIt.next();
+        if (!sortElem.isNumber() || !fields.count(sortElem.fieldName()))
+            return false;
+    }
+    return true;
+}
+
 DocumentSource::GetDepsReturn DocumentSourceGroup::getDependencies(DepsTracker* deps) const {
     // add the _id
     for (size_t i = 0; i < _idExpressions.size(); i++) {
@@ -202,8 +393,11 @@ DocumentSourceGroup::DocumentSourceGroup(const intrusive_ptr<ExpressionContext>&
       populated(false),
       _doingMerge(false),
       _spilled(false),
+      _streaming(false),
       _extSortAllowed(pExpCtx->extSortAllowed && !pExpCtx->inRouter),
-      _maxMemoryUsageBytes(100 * 1024 * 1024) {}
+      _maxMemoryUsageBytes(100 * 1024 * 1024),
+      _haveCurrentGroup(false),
+      _passingThrough(false) {}
 
 void DocumentSourceGroup::addAccumulator(const std::string& fieldName,
                                          Accumulator::Factory accumulatorFactory,
@@ -305,17 +499,25 @@ public:
 };
 }
 
-void DocumentSourceGroup::populate() {
+void DocumentSourceGroup::populate(boost::optional<Document> firstInput) {
     const size_t numAccumulators = vpAccumulatorFactory.size();
     dassert(numAccumulators == vpExpression.size());
 
     // pushed to on spill()
     vector<shared_ptr<Sorter<Value, Value>::Iterator>> sortedFiles;
-    int memoryUsageBytes = 0;
+    // The memory owned by group keys and accumulators, which together with the memory used by the
+    // groups table itself is the memory used by all groups.
+    size_t memoryUsageBytes = 0;
+
+    // The shards' part of a split $group checks whether it reduces its input enough to be worth
+    // grouping once it has seen a sample of it.
+    bool checkPreAggregation = canStopPreAggregating();
+    long long numInputs = 0;
 
     // This loop consumes all input from pSource and buckets it based on pIdExpression.
-    while (boost::optional<Document> input = pSource->getNext()) {
-        if (memoryUsageBytes > _maxMemoryUsageBytes) {
+    boost::optional<Document> input = firstInput ? std::move(firstInput) : pSource->getNext();
+    for (; input; input = pSource->getNext()) {
+        if (memoryUsageBytes + groups.memoryUsageBytes() > size_t(_maxMemoryUsageBytes)) {
             uassert(16945,
                     "Exceeded memory limit for $group, but didn't allow external sort."
                     " Pass allowDiskUse:true to opt in.",
@@ -337,12 +539,13 @@ void DocumentSourceGroup::populate() {
           Look for the _id value in the map; if it's not there, add a
           new entry with a blank accumulator.
         */
-        const size_t oldSize = groups.size();
-        vector<intrusive_ptr<Accumulator>>& group = groups[id];
-        const bool inserted = groups.size() != oldSize;
+        bool inserted;
+        Accumulators& group = groups.findOrInsert(id, &inserted);
 
         if (inserted) {
-            memoryUsageBytes += id.getApproximateSize();
+            // The Value itself is stored in the groups table.
+            memoryUsageBytes += id.getApproximateSize() - sizeof(Value) +
+                numAccumulators * sizeof(intrusive_ptr<Accumulator>);
 
             // Add the accumulators
             group.reserve(numAccumulators);
@@ -363,8 +566,22 @@ void DocumentSourceGroup::populate() {
             memoryUsageBytes += group[i]->memUsageForSorter();
         }
 
-        // We are done with the ROOT document so release it.
+        // We are done with the ROOT document so release it. Also drop our own reference before
+        // pulling the next input, so that a $unwind feeding us can overwrite the unwound field
+        // in place instead of copying the whole document for every array element.
         _variables->clearRoot();
+        input = boost::none;
+
+        if (checkPreAggregation &&
+            ++numInputs >= internalDocumentSourceGroupPreAggregationSampleSize) {
+            checkPreAggregation = false;
+            if (sortedFiles.empty() &&
+                numInputs < groups.size() * internalDocumentSourceGroupMinPreAggregationRatio) {
+                // Leave the rest of the input to be passed through after the groups so far.
+                _passingThrough = true;
+                break;
+            }
+        }
 
         DEV {
             // In debug mode, spill every time we have a duplicate id to stress merge logic.
@@ -389,7 +606,7 @@ void DocumentSourceGroup::populate() {
         }
 
         // We won't be using groups again so free its memory.
-        GroupsMap().swap(groups);
+        groups.clear();
 
         _sorterIterator.reset(
             Sorter<Value, Value>::Iterator::merge(sortedFiles, SortOptions(), SorterComparator()));
@@ -412,21 +629,22 @@ void DocumentSourceGroup::populate() {
 
 class DocumentSourceGroup::SpillSTLComparator {
 public:
-    bool operator()(const GroupsMap::value_type* lhs, const GroupsMap::value_type* rhs) const {
+    bool operator()(const GroupTable::value_type* lhs, const GroupTable::value_type* rhs) const {
         return Value::compare(lhs->first, rhs->first) < 0;
     }
 };
 
 shared_ptr<Sorter<Value, Value>::Iterator> DocumentSourceGroup::spill() {
-    vector<const GroupsMap::value_type*> ptrs;  // using pointers to speed sorting
+    vector<const GroupTable::value_type*> ptrs;  // using pointers to speed sorting
     ptrs.reserve(groups.size());
-    for (GroupsMap::const_iterator it = groups.begin(), end = groups.end(); it != end; ++it) {
+    for (GroupTable::const_iterator it = groups.begin(), end = groups.end(); it != end; ++it) {
         ptrs.push_back(&*it);
     }
 
     stable_sort(ptrs.begin(), ptrs.end(), SpillSTLComparator());
 
-    SortedFileWriter<Value, Value> writer(SortOptions().TempDir(pExpCtx->tempDir));
+    SortedFileWriter<Value, Value> writer(
+        SortOptions().TempDir(pExpCtx->tempDir).TrackSpills(pExpCtx->spillTracker));
     switch (vpAccumulatorFactory.size()) {  // same as ptrs[i]->second.size() for all i.
         case 0:                             // no values, essentially a distinct
             for (size_t i = 0; i < ptrs.size(); i++) {
@@ -0,0 +1,423 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source.h"
+
+#include <algorithm>
+#include <limits>
+
+#include "mongo/client/dbclientcursor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+using std::string;
+using std::vector;
+
+DocumentSourceLookUp::DocumentSourceLookUp(NamespaceString fromNs,
+                                           string as,
+                                           string localField,
+                                           string foreignField,
+                                           const intrusive_ptr<ExpressionContext>& pExpCtx)
+    : DocumentSource(pExpCtx),
+      _fromNs(std::move(fromNs)),
+      _as(std::move(as)),
+      _localField(std::move(localField)),
+      _foreignField(std::move(foreignField)),
+      _handlingUnwind(false),
+      _strategy(JoinStrategy::kUndecided) {}
+
+REGISTER_DOCUMENT_SOURCE(lookUp, DocumentSourceLookUp::createFromBson);
+
+const char* DocumentSourceLookUp::getSourceName() const {
+    return "$lookUp";
+}
+
+namespace {
+
+/**
+ * Missing and undefined values join with foreign documents whose field is null or missing, as in
+ * a {field: null} query.
+ */
+Value normalizeJoinKey(Value key) {
+    if (key.nullish()) {
+        return Value(BSONNULL);
+    }
+    return key;
+}
+
+}  // namespace
+
+boost::optional<Document> DocumentSourceLookUp::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    if (_strategy == JoinStrategy::kUndecided) {
+        chooseStrategy();
+    }
+
+    while (_output.empty()) {
+        if (_strategy == JoinStrategy::kHash) {
+            boost::optional<Document> input = pSource->getNext();
+            if (!input) {
+                return boost::none;
+            }
+            join(*input);
+            continue;
+        }
+
+        // Collect a batch of input documents, then fetch the foreign documents which may join with
+        // any of them using a single query.
+        const size_t batchSize = std::max(1, internalDocumentSourceLookUpBatchSize);
+        vector<Document> batch;
+        ValueSet localKeys;
+        while (batch.size() < batchSize) {
+            boost::optional<Document> input = pSource->getNext();
+            if (!input) {
+                break;
+            }
+            addLocalKeys(*input, &localKeys);
+            batch.push_back(std::move(*input));
+        }
+
+        if (batch.empty()) {
+            return boost::none;
+        }
+
+        loadForeignDocs(buildForeignQuery(localKeys), std::numeric_limits<long long>::max());
+        for (auto&& input : batch) {
+            join(input);
+        }
+    }
+
+    Document out = std::move(_output.front());
+    _output.pop_front();
+    return std::move(out);
+}
+
+void DocumentSourceLookUp::chooseStrategy() {
+    verify(_mongod);
+
+    if (foreignFieldIsIndexed()) {
+        _strategy = JoinStrategy::kIndexedProbe;
+        return;
+    }
+
+    // Without an index each query scans the whole foreign collection, so try to do so only once.
+    if (loadForeignDocs(_foreignFilter, internalDocumentSourceLookUpMaxHashTableBytes)) {
+        _strategy = JoinStrategy::kHash;
+    } else {
+        _strategy = JoinStrategy::kBlockNestedLoop;
+    }
+}
+
+bool DocumentSourceLookUp::foreignFieldIsIndexed() {
+    for (auto&& spec : _mongod->directClient()->getIndexSpecs(_fromNs.ns())) {
+        const BSONObj keyPattern = spec.getObjectField("key");
+        if (keyPattern.isEmpty() || keyPattern.firstElementFieldName() != _foreignField) {
+            continue;
+        }
+
+        // Sparse and partial indexes cannot answer the {$in: [null]} queries issued for missing
+        // local fields.
+        if (IndexNames::findPluginName(keyPattern) != IndexNames::BTREE ||
+            spec["sparse"].trueValue() || spec.hasField("partialFilterExpression")) {
+            continue;
+        }
+
+        return true;
+    }
+    return false;
+}
+
+bool DocumentSourceLookUp::loadForeignDocs(const BSONObj& query, long long maxMemoryUsageBytes) {
+    _foreignDocs.clear();
+    _foreignIndex.clear();
+
+    long long memoryUsageBytes = 0;
+    std::unique_ptr<DBClientCursor> cursor =
+        _mongod->directClient()->query(_fromNs.ns(), Query(query));
+    while (cursor->more()) {
+        BSONObj obj = cursor->nextSafe();
+
+        Document foreignDoc(obj);
+        memoryUsageBytes += foreignDoc.getApproximateSize();
+        if (memoryUsageBytes > maxMemoryUsageBytes) {
+            _foreignDocs.clear();
+            _foreignIndex.clear();
+            return false;
+        }
+
+        // A foreign document joins on each value of 'foreignField', including each element of an
+        // array, or on null if the field is missing.
+        const size_t position = _foreignDocs.size();
+        BSONElementSet foreignKeys;
+        obj.getFieldsDotted(_foreignField, foreignKeys);
+        if (foreignKeys.empty() && obj.getFieldDotted(_foreignField).type() != Array) {
+            _foreignIndex[Value(BSONNULL)].push_back(position);
+        }
+        for (auto&& key : foreignKeys) {
+            _foreignIndex[normalizeJoinKey(Value(key))].push_back(position);
+        }
+
+        _foreignDocs.push_back(std::move(foreignDoc));
+    }
+    return true;
+}
+
+BSONObj DocumentSourceLookUp::buildForeignQuery(const ValueSet& localKeys) const {
+    // Regular expressions must be compared for equality rather than matched, which $in would do.
+    BSONArrayBuilder inValues;
+    BSONArrayBuilder regexClauses;
+    for (auto&& key : localKeys) {
+        if (key.getType() == RegEx) {
+            BSONObjBuilder eqBuilder;
+            key.addToBsonObj(&eqBuilder, "$eq");
+            regexClauses.append(BSON(_foreignField << eqBuilder.obj()));
+        } else {
+            key.addToBsonArray(&inValues);
+        }
+    }
+
+    BSONArrayBuilder clauses;
+    if (!_foreignFilter.isEmpty()) {
+        clauses.append(_foreignFilter);
+    }
+
+    const BSONObj inClause = BSON(_foreignField << BSON("$in" << inValues.arr()));
+    const BSONArray regexes = regexClauses.arr();
+    if (regexes.isEmpty()) {
+        clauses.append(inClause);
+    } else {
+        BSONArrayBuilder orClauses;
+        orClauses.append(inClause);
+        for (auto&& regexClause : regexes) {
+            orClauses.append(regexClause);
+        }
+        clauses.append(BSON("$or" << orClauses.arr()));
+    }
+    return BSON("$and" << clauses.arr());
+}
+
+void DocumentSourceLookUp::addLocalKeys(const Document& input, ValueSet* localKeys) const {
+    // An array joins on each of its elements.
+    Value localValue = input.getNestedField(_localField);
+    if (localValue.getType() == Array) {
+        for (auto&& element : localValue.getArray()) {
+            localKeys->insert(normalizeJoinKey(element));
+        }
+    } else {
+        localKeys->insert(normalizeJoinKey(localValue));
+    }
+}
+
+void DocumentSourceLookUp::join(const Document& input) {
+    ValueSet localKeys;
+    addLocalKeys(input, &localKeys);
+
+    // Keep the foreign documents in the order they were read, and join each one at most once even
+    // when it matches several of the local keys.
+    vector<size_t> matches;
+    for (auto&& key : localKeys) {
+        auto it = _foreignIndex.find(key);
+        if (it != _foreignIndex.end()) {
+            matches.insert(matches.end(), it->second.begin(), it->second.end());
+        }
+    }
+    std::sort(matches.begin(), matches.end());
+    matches.erase(std::unique(matches.begin(), matches.end()), matches.end());
+
+    if (_handlingUnwind) {
+        for (size_t position : matches) {
+            MutableDocument output(input);
+            output.setNestedField(_as, Value(_foreignDocs[position]));
+            _output.push_back(output.freeze());
+        }
+        return;
+    }
+
+    vector<Value> joined;
+    joined.reserve(matches.size());
+    for (size_t position : matches) {
+        joined.push_back(Value(_foreignDocs[position]));
+    }
+
+    MutableDocument output(input);
+    output.setNestedField(_as, Value(std::move(joined)));
+    _output.push_back(output.freeze());
+}
+
+namespace {
+
+/**
+ * If every top-level predicate of 'matchSpec' applies to a field nested under 'prefix', stores
+ * the predicates with 'prefix' removed from their paths in 'out' and returns true.
+ */
+bool stripMatchPrefix(const BSONObj& matchSpec, StringData prefix, BSONObj* out) {
+    const string dottedPrefix = prefix.toString() + '.';
+
+    BSONObjBuilder stripped;
+    for (auto&& elem : matchSpec) {
+        StringData path = elem.fieldNameStringData();
+        if (!path.startsWith(dottedPrefix) || path.size() == dottedPrefix.size()) {
+            return false;
+        }
+        stripped.appendAs(elem, path.substr(dottedPrefix.size()));
+    }
+
+    *out = stripped.obj();
+    return !out->isEmpty();
+}
+
+}  // namespace
+
+bool DocumentSourceLookUp::coalesce(const intrusive_ptr<DocumentSource>& pNextSource) {
+    if (!_handlingUnwind) {
+        auto unwind = dynamic_cast<DocumentSourceUnwind*>(pNextSource.get());
+        if (!unwind || unwind->getUnwindPath() != _as.getPath(false)) {
+            return false;
+        }
+        _handlingUnwind = true;
+        return true;
+    }
+
+    // Once unwound, 'as' holds a single foreign document, so a $match on fields under it can be
+    // evaluated against the foreign collection instead.
+    auto match = dynamic_cast<DocumentSourceMatch*>(pNextSource.get());
+    if (!match || match->isTextQuery()) {
+        return false;
+    }
+
+    const BSONObj matchSpec = match->getQuery();
+    BSONObj foreignPredicates;
+    if (!stripMatchPrefix(matchSpec, _as.getPath(false), &foreignPredicates)) {
+        return false;
+    }
+
+    _absorbedMatches.push_back(matchSpec.getOwned());
+    if (_foreignFilter.isEmpty()) {
+        _foreignFilter = foreignPredicates;
+    } else {
+        _foreignFilter = BSON("$and" << BSON_ARRAY(_foreignFilter << foreignPredicates));
+    }
+    return true;
+}
+
+void DocumentSourceLookUp::dispose() {
+    _foreignDocs.clear();
+    _foreignIndex.clear();
+    _output.clear();
+    pSource->dispose();
+}
+
+DocumentSource::GetDepsReturn DocumentSourceLookUp::getDependencies(DepsTracker* deps) const {
+    deps->fields.insert(_localField.getPath(false));
+    return SEE_NEXT;
+}
+
+void DocumentSourceLookUp::serializeToArray(vector<Value>& array, bool explain) const {
+    MutableDocument spec(DOC("from" << _fromNs.coll() << "as" << _as.getPath(false) << "localField"
+                                    << _localField.getPath(false) << "foreignField"
+                                    << _foreignField));
+
+    if (explain) {
+        if (_handlingUnwind) {
+            spec["unwinding"] = Value(true);
+        }
+        if (!_foreignFilter.isEmpty()) {
+            spec["matching"] = Value(_foreignFilter);
+        }
+        array.push_back(Value(DOC(getSourceName() << spec.freeze())));
+        return;
+    }
+
+    // Re-emit any absorbed stages so that the pipeline can be parsed again, for example by the
+    // shard that merges a sharded aggregation.
+    array.push_back(Value(DOC(getSourceName() << spec.freeze())));
+    if (_handlingUnwind) {
+        array.push_back(Value(DOC("$unwind" << _as.getPath(true))));
+    }
+    for (auto&& matchSpec : _absorbedMatches) {
+        array.push_back(Value(DOC("$match" << matchSpec)));
+    }
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceLookUp::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(28809, "the $lookUp specification must be an Object", elem.type() == Object);
+
+    NamespaceString fromNs;
+    string as;
+    string localField;
+    string foreignField;
+
+    for (auto&& argument : elem.embeddedObject()) {
+        const auto argName = argument.fieldNameStringData();
+
+        uassert(28810,
+                str::stream() << "arguments to $lookUp must be strings, " << argName << ": "
+                              << argument << " is type " << typeName(argument.type()),
+                argument.type() == String);
+
+        if (argName == "from") {
+            fromNs = NamespaceString(pExpCtx->ns.db().toString() + '.' + argument.String());
+        } else if (argName == "as") {
+            as = argument.String();
+        } else if (argName == "localField") {
+            localField = argument.String();
+        } else if (argName == "foreignField") {
+            foreignField = argument.String();
+        } else {
+            uasserted(28811,
+                      str::stream() << "unknown argument to $lookUp: " << argument.fieldName());
+        }
+    }
+
+    uassert(28812,
+            "need to specify fields from, as, localField, and foreignField for a $lookUp",
+            !fromNs.ns().empty() && !as.empty() && !localField.empty() && !foreignField.empty());
+    uassert(28813,
+            str::stream() << "invalid $lookUp namespace: " << fromNs.ns(),
+            fromNs.isValid());
+    uassert(28814,
+            str::stream() << "$lookUp foreignField cannot start with '$': " << foreignField,
+            foreignField[0] != '$');
+
+    return new DocumentSourceLookUp(std::move(fromNs),
+                                    std::move(as),
+                                    std::move(localField),
+                                    std::move(foreignField),
+                                    pExpCtx);
+}
+}  // namespace mongo
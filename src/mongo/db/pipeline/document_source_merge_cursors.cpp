@@ -143,11 +143,31 @@ boost::optional<Document> DocumentSourceMergeCursors::getNext() {
     if (_unstarted)
         start();
 
-    // purge eof cursors and release their connections
-    while (!_cursors.empty() && !(*_currentCursor)->cursor.more()) {
-        (*_currentCursor)->connection.done();
-        _cursors.erase(_currentCursor);
-        _currentCursor = _cursors.begin();
+    // A cursor whose batch runs out sends a getMore without waiting for the reply, and the other
+    // cursors are read in the meantime, so that the getMores to all shards are in flight at once.
+    // Its reply is only waited for once it is that cursor's turn again.
+    while (!_cursors.empty()) {
+        CursorAndConnection& current = **_currentCursor;
+        if (current.pendingGetMore) {
+            current.pendingGetMore = false;
+            current.cursor.requestMoreLazyFinish();
+        }
+
+        if (current.cursor.moreInCurrentBatch())
+            break;
+
+        if (current.cursor.isDead()) {
+            // purge eof cursors and release their connections
+            current.connection.done();
+            _currentCursor = _cursors.erase(_currentCursor);
+        } else {
+            current.cursor.requestMoreLazy();
+            current.pendingGetMore = true;
+            ++_currentCursor;
+        }
+
+        if (_currentCursor == _cursors.end())
+            _currentCursor = _cursors.begin();
     }
 
     if (_cursors.empty())
@@ -164,9 +184,16 @@ boost::optional<Document> DocumentSourceMergeCursors::getNext() {
 
 void DocumentSourceMergeCursors::dispose() {
     // Note it is an error to call done() on a connection before consuming the response from a
-    // request. Therefore it is an error to call dispose() if there are any outstanding connections
-    // which have not received a reply.
+    // request, so the replies to any getMores still in flight are received first.
     for (auto&& cursorAndConn : _cursors) {
+        if (cursorAndConn->pendingGetMore) {
+            try {
+                cursorAndConn->cursor.requestMoreLazyFinish();
+            } catch (const DBException&) {
+                // The connection is closed rather than returned to the pool when it goes away.
+                continue;
+            }
+        }
         cursorAndConn->cursor.kill();
         cursorAndConn->connection.done();
     }
@@ -90,28 +90,40 @@ void DocumentSourceOut::prepTempCollection() {
                 ok);
     }
 
-    // copy indexes on _outputNs to _tempNs
-    const std::list<BSONObj> indexes = conn->getIndexSpecs(_outputNs.ns());
-    for (std::list<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
+    // The indexes on _outputNs are only built on _tempNs once all the data is in, so that the
+    // documents don't maintain every index as they are inserted.
+    _indexesToCopy = conn->getIndexSpecs(_outputNs.ns());
+}
+
+void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
+    Status status = _mongod->insert(_tempNs, toInsert);
+    uassert(16996, str::stream() << "insert for $out failed: " << status.toString(), status.isOK());
+}
+
+void DocumentSourceOut::copyIndexes() {
+    if (_indexesToCopy.empty())
+        return;
+
+    // All the indexes are created by one command, which builds them with a single scan of the
+    // collection using the bulk index builder.
+    BSONArrayBuilder indexBuilder;
+    for (std::list<BSONObj>::const_iterator it = _indexesToCopy.begin();
+         it != _indexesToCopy.end();
+         ++it) {
         MutableDocument index((Document(*it)));
         index.remove("_id");  // indexes shouldn't have _ids but some existing ones do
         index["ns"] = Value(_tempNs.ns());
-
-        BSONObj indexBson = index.freeze().toBson();
-        conn->insert(_tempNs.getSystemIndexesCollection(), indexBson);
-        BSONObj err = conn->getLastErrorDetailed();
-        uassert(16995,
-                str::stream() << "copying index for $out failed."
-                              << " index: " << indexBson << " error: " << err,
-                DBClientWithCommands::getLastErrorString(err).empty());
+        indexBuilder.append(index.freeze().toBson());
     }
-}
+    BSONArray indexes = indexBuilder.arr();
 
-void DocumentSourceOut::spill(const vector<BSONObj>& toInsert) {
-    BSONObj err = _mongod->insert(_tempNs, toInsert);
-    uassert(16996,
-            str::stream() << "insert for $out failed: " << err,
-            DBClientWithCommands::getLastErrorString(err).empty());
+    BSONObj cmd = BSON("createIndexes" << _tempNs.coll() << "indexes" << indexes);
+    BSONObj info;
+    bool ok = _mongod->directClient()->runCommand(_tempNs.db().toString(), cmd, info);
+    uassert(16995,
+            str::stream() << "copying indexes for $out failed."
+                          << " indexes: " << indexes << " error: " << info,
+            ok);
 }
 
 boost::optional<Document> DocumentSourceOut::getNext() {
@@ -144,6 +156,8 @@ boost::optional<Document> DocumentSourceOut::getNext() {
     if (!bufferedObjects.empty())
         spill(bufferedObjects);
 
+    copyIndexes();
+
     // Checking again to make sure we didn't become sharded while running.
     uassert(17018,
             str::stream() << "namespace '" << _outputNs.ns()
@@ -0,0 +1,135 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source.h"
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+DocumentSourcePackBuckets::DocumentSourcePackBuckets(
+    const intrusive_ptr<ExpressionContext>& pExpCtx,
+    std::string timeField,
+    std::string metaField,
+    int maxCount,
+    Milliseconds maxSpan)
+    : DocumentSource(pExpCtx),
+      _timeField(std::move(timeField)),
+      _metaField(std::move(metaField)),
+      _maxCount(maxCount),
+      _maxSpan(maxSpan),
+      _builder(_timeField, _metaField, _maxCount, _maxSpan) {}
+
+REGISTER_DOCUMENT_SOURCE(_internalPackBuckets, DocumentSourcePackBuckets::createFromBson);
+
+const char* DocumentSourcePackBuckets::getSourceName() const {
+    return "$_internalPackBuckets";
+}
+
+boost::optional<Document> DocumentSourcePackBuckets::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (true) {
+        BSONObj measurement;
+        if (_pending) {
+            measurement = std::move(*_pending);
+            _pending = boost::none;
+        } else if (boost::optional<Document> next = pSource->getNext()) {
+            measurement = next->toBson();
+        } else {
+            if (_builder.isEmpty()) {
+                return boost::none;
+            }
+            return Document(_builder.done());
+        }
+
+        auto added = _builder.add(measurement);
+        uassertStatusOK(added.getStatus());
+        if (!added.getValue()) {
+            _pending = measurement;
+            return Document(_builder.done());
+        }
+    }
+}
+
+Value DocumentSourcePackBuckets::serialize(bool explain) const {
+    MutableDocument spec;
+    spec["timeField"] = Value(_timeField);
+    if (!_metaField.empty()) {
+        spec["metaField"] = Value(_metaField);
+    }
+    spec["maxCount"] = Value(_maxCount);
+    spec["maxSpanSeconds"] = Value(durationCount<Seconds>(_maxSpan));
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+intrusive_ptr<DocumentSource> DocumentSourcePackBuckets::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(28828,
+            str::stream() << "$_internalPackBuckets specification must be an object, not "
+                          << typeName(elem.type()),
+            elem.type() == Object);
+
+    std::string timeField;
+    std::string metaField;
+    int maxCount = 1000;
+    long long maxSpanSeconds = 3600;
+    for (auto&& option : elem.Obj()) {
+        const StringData name = option.fieldNameStringData();
+        if (name == "timeField" || name == "metaField") {
+            uassert(28829,
+                    str::stream() << "$_internalPackBuckets " << name << " must be a string",
+                    option.type() == String);
+            (name == "timeField" ? timeField : metaField) = option.String();
+        } else if (name == "maxCount") {
+            uassert(28830,
+                    "$_internalPackBuckets maxCount must be a positive number",
+                    option.isNumber() && option.numberInt() > 0);
+            maxCount = option.numberInt();
+        } else if (name == "maxSpanSeconds") {
+            uassert(28831,
+                    "$_internalPackBuckets maxSpanSeconds must be a positive number",
+                    option.isNumber() && option.numberLong() > 0);
+            maxSpanSeconds = option.numberLong();
+        } else {
+            uasserted(28832, str::stream() << "unrecognized option to $_internalPackBuckets: "
+                                           << name);
+        }
+    }
+    uassert(28833, "$_internalPackBuckets requires a timeField", !timeField.empty());
+
+    return new DocumentSourcePackBuckets(
+        pExpCtx, timeField, metaField, maxCount, Seconds(maxSpanSeconds));
+}
+}  // namespace mongo
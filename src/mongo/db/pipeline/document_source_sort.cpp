@@ -36,6 +36,7 @@
 #include "mongo/db/pipeline/expression.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
+#include "mongo/db/query/query_knobs.h"
 
 namespace mongo {
 
@@ -221,6 +222,8 @@ SortOptions DocumentSourceSort::makeSortOptions() const {
     if (pExpCtx->extSortAllowed && !pExpCtx->inRouter) {
         opts.extSortAllowed = true;
         opts.tempDir = pExpCtx->tempDir;
+        opts.spillThreads = std::max(internalQueryExecSorterSpillThreads, 0);
+        opts.spillTracker = pExpCtx->spillTracker;
     }
 
     return opts;
@@ -32,6 +32,7 @@
 #include "mongo/db/pipeline/dependencies.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/service_context_noop.h"
 #include "mongo/db/storage_options.h"
@@ -147,6 +148,29 @@ public:
         }
     }
 };
+
+class ExtractFields {
+public:
+    void run() {
+        const char* array[] = {"a", "b.c"};
+        DepsTracker deps;
+        deps.fields = arrayToSet(array);
+        boost::optional<ParsedDeps> parsedDeps = deps.toParsedDeps();
+        ASSERT(parsedDeps);
+
+        assertExtracts(*parsedDeps, "{x: 1, a: 1, b: {c: 2, d: 3}, y: 4}", "{a: 1, b: {c: 2}}");
+        assertExtracts(*parsedDeps, "{b: [{c: 1, d: 2}, 3, {d: 4}]}", "{b: [{c: 1}, {}]}");
+        assertExtracts(*parsedDeps, "{b: 1, a: {c: 2}}", "{a: {c: 2}}");
+        assertExtracts(*parsedDeps, "{x: 1}", "{}");
+        // The first of several fields with the same name is the one that's looked up.
+        assertExtracts(*parsedDeps, "{a: 1, a: 2, b: {c: 3}, a: 4}", "{a: 1, a: 2, b: {c: 3}}");
+    }
+
+private:
+    void assertExtracts(const ParsedDeps& parsedDeps, const char* input, const char* expected) {
+        ASSERT_EQUALS(parsedDeps.extractFields(fromjson(input)).toBson(), fromjson(expected));
+    }
+};
 }
 
 namespace Mock {
@@ -877,6 +901,151 @@ public:
     }
 };
 
+/** A $group can stream sorted input only if the sort's leading fields are its key's fields. */
+class CanStreamInputSortedBy : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id: {x: '$a', y: '$$ROOT.b.c', z: '$a'}, n: {$sum: 1}}"));
+        auto streamingGroup = static_cast<DocumentSourceGroup*>(group());
+        ASSERT_EQUALS(fromjson("{a: 1, 'b.c': 1}"), streamingGroup->getStreamingSortPattern());
+        ASSERT(streamingGroup->canStreamInputSortedBy(fromjson("{'b.c': 1, a: -1}")));
+        ASSERT(streamingGroup->canStreamInputSortedBy(fromjson("{a: 1, 'b.c': 1, d: 1}")));
+        ASSERT(!streamingGroup->canStreamInputSortedBy(fromjson("{a: 1}")));
+        ASSERT(!streamingGroup->canStreamInputSortedBy(fromjson("{a: 1, d: 1, 'b.c': 1}")));
+        ASSERT(!streamingGroup->canStreamInputSortedBy(fromjson("{b: 1, a: 1}")));
+
+        createGroup(fromjson("{_id: {$add: ['$a', 1]}}"));
+        streamingGroup = static_cast<DocumentSourceGroup*>(group());
+        ASSERT_EQUALS(BSONObj(), streamingGroup->getStreamingSortPattern());
+        ASSERT(!streamingGroup->canStreamInputSortedBy(fromjson("{a: 1}")));
+    }
+};
+
+/** A streaming $group returns each group once it reads a document with a different key. */
+class StreamingReturnsGroupWhenKeyChanges : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id: '$a', s: {$push: '$b'}}"));
+        static_cast<DocumentSourceGroup*>(group())->setStreaming(true);
+        auto source = DocumentSourceMock::create(
+            {"{a: 1, b: 1}", "{a: 1, b: 2}", "{a: 2, b: 3}", "{b: 4}", "{a: null, b: 5}"});
+        group()->setSource(source.get());
+
+        boost::optional<Document> next = group()->getNext();
+        ASSERT(bool(next));
+        ASSERT_EQUALS(fromjson("{_id: 1, s: [1, 2]}"), next->toBson());
+        // The documents of the following groups have not been read yet.
+        ASSERT_EQUALS(2U, source->queue.size());
+
+        next = group()->getNext();
+        ASSERT(bool(next));
+        ASSERT_EQUALS(fromjson("{_id: 2, s: [3]}"), next->toBson());
+        ASSERT_EQUALS(1U, source->queue.size());
+
+        // Missing keys group with null ones.
+        next = group()->getNext();
+        ASSERT(bool(next));
+        ASSERT_EQUALS(fromjson("{_id: null, s: [4, 5]}"), next->toBson());
+        assertExhausted(group());
+    }
+};
+
+/** A streaming $group groups the rest of its input in a hash table once it sees an array key. */
+class StreamingFallsBackOnArrayKey : public Base {
+public:
+    void run() {
+        createGroup(fromjson("{_id: '$a', s: {$push: '$b'}}"));
+        static_cast<DocumentSourceGroup*>(group())->setStreaming(true);
+        auto source = DocumentSourceMock::create({"{a: 0, b: 0}",
+                                                  "{a: 1, b: 1}",
+                                                  "{a: [1, 2], b: 2}",
+                                                  "{a: 1, b: 3}",
+                                                  "{a: [1, 2], b: 4}",
+                                                  "{a: 2, b: 5}"});
+        group()->setSource(source.get());
+
+        boost::optional<Document> next = group()->getNext();
+        ASSERT(bool(next));
+        ASSERT_EQUALS(fromjson("{_id: 0, s: [0]}"), next->toBson());
+
+        IdMap resultSet;
+        while ((next = group()->getNext())) {
+            resultSet[next->getField("_id")] = *next;
+        }
+        assertExhausted(group());
+
+        BSONArrayBuilder bsonResultSet;
+        for (auto&& result : resultSet) {
+            bsonResultSet << result.second;
+        }
+        const BSONObj expected =
+            fromjson("{'': [{_id: 1, s: [1, 3]}, {_id: 2, s: [5]}, {_id: [1, 2], s: [2, 4]}]}");
+        ASSERT_EQUALS(expected[""].embeddedObject(), bsonResultSet.arr());
+    }
+};
+
+/**
+ * The shards' part of a split $group passes the rest of its input through as partial groups once
+ * a sample of it shows that grouping hardly reduces it, if its accumulators allow it.
+ */
+class ShardStopsPreAggregatingWithPoorReduction : public Base {
+public:
+    ShardStopsPreAggregatingWithPoorReduction()
+        : _oldSampleSize(internalDocumentSourceGroupPreAggregationSampleSize),
+          _oldRatio(internalDocumentSourceGroupMinPreAggregationRatio) {
+        internalDocumentSourceGroupPreAggregationSampleSize = 4;
+        internalDocumentSourceGroupMinPreAggregationRatio = 2.0;
+    }
+
+    ~ShardStopsPreAggregatingWithPoorReduction() {
+        internalDocumentSourceGroupPreAggregationSampleSize = _oldSampleSize;
+        internalDocumentSourceGroupMinPreAggregationRatio = _oldRatio;
+    }
+
+    void run() {
+        createGroup(fromjson("{_id: '$a', s: {$sum: '$b'}}"), true);
+        auto source = inputWithPoorReduction();
+        group()->setSource(source.get());
+
+        // The groups of the four sampled documents come first, in any order.
+        std::set<int> sampledIds;
+        for (int i = 0; i < 4; ++i) {
+            boost::optional<Document> next = group()->getNext();
+            ASSERT(bool(next));
+            sampledIds.insert(next->getField("_id").getInt());
+        }
+        ASSERT_EQUALS(4U, sampledIds.size());
+
+        // Each remaining document is then a group of its own.
+        ASSERT_EQUALS(fromjson("{_id: 5, s: 5}"), group()->getNext()->toBson());
+        ASSERT_EQUALS(fromjson("{_id: 5, s: 6}"), group()->getNext()->toBson());
+        assertExhausted(group());
+
+        // $push depends on the order of its input, so it keeps grouping.
+        createGroup(fromjson("{_id: '$a', s: {$push: '$b'}}"), true);
+        source = inputWithPoorReduction();
+        group()->setSource(source.get());
+        size_t numGroups = 0;
+        while (group()->getNext()) {
+            ++numGroups;
+        }
+        ASSERT_EQUALS(5U, numGroups);
+    }
+
+private:
+    intrusive_ptr<DocumentSourceMock> inputWithPoorReduction() {
+        return DocumentSourceMock::create({"{a: 1, b: 1}",
+                                           "{a: 2, b: 2}",
+                                           "{a: 3, b: 3}",
+                                           "{a: 4, b: 4}",
+                                           "{a: 5, b: 5}",
+                                           "{a: 5, b: 6}"});
+    }
+
+    const int _oldSampleSize;
+    const double _oldRatio;
+};
+
 }  // namespace DocumentSourceGroup
 
 namespace DocumentSourceProject {
@@ -2009,6 +2178,33 @@ class SeveralMoreDocuments : public CheckResultsBase {
     }
 };
 
+/**
+ * Unwinding into a consumer which releases each document before pulling the next one reuses the
+ * output storage, which must neither leak into the input document nor into earlier results.
+ */
+class ReleasedResultsReuseStorage : public Base {
+public:
+    void run() {
+        createUnwind("$a.b");
+        const Document input =
+            DOC("_id" << 0 << "a" << DOC("b" << DOC_ARRAY(1 << 2 << 3) << "c" << 4));
+        auto source = DocumentSourceMock::create(input);
+        unwind()->setSource(source.get());
+
+        BSONArrayBuilder bsonResultSet;
+        while (boost::optional<Document> current = unwind()->getNext()) {
+            bsonResultSet << *current;
+        }
+        assertExhausted();
+
+        // fromjson cannot parse an array, so place the array within an object.
+        const BSONObj expected =
+            fromjson("{'':[{_id:0,a:{b:1,c:4}},{_id:0,a:{b:2,c:4}},{_id:0,a:{b:3,c:4}}]}");
+        ASSERT_EQUALS(expected[""].embeddedObject(), bsonResultSet.arr());
+        ASSERT_EQUALS(fromjson("{_id:0,a:{b:[1,2,3],c:4}}"), input.toBson());
+    }
+};
+
 /** Dependant field paths. */
 class Dependencies : public Base {
 public:
@@ -2223,6 +2419,7 @@ public:
     All() : Suite("documentsource") {}
     void setupTests() {
         add<DocumentSourceClass::Deps>();
+        add<DocumentSourceClass::ExtractFields>();
 
         add<DocumentSourceLimit::DisposeSource>();
         add<DocumentSourceLimit::DisposeSourceCascade>();
@@ -2263,6 +2460,10 @@ public:
         add<DocumentSourceGroup::Dependencies>();
         add<DocumentSourceGroup::StringConstantIdAndAccumulatorExpressions>();
         add<DocumentSourceGroup::ArrayConstantAccumulatorExpression>();
+        add<DocumentSourceGroup::CanStreamInputSortedBy>();
+        add<DocumentSourceGroup::StreamingReturnsGroupWhenKeyChanges>();
+        add<DocumentSourceGroup::StreamingFallsBackOnArrayKey>();
+        add<DocumentSourceGroup::ShardStopsPreAggregatingWithPoorReduction>();
 
         add<DocumentSourceProject::Inclusion>();
         add<DocumentSourceProject::Optimize>();
@@ -2308,6 +2509,7 @@ public:
         add<DocumentSourceUnwind::DoubleNestedArray>();
         add<DocumentSourceUnwind::SeveralDocuments>();
         add<DocumentSourceUnwind::SeveralMoreDocuments>();
+        add<DocumentSourceUnwind::ReleasedResultsReuseStorage>();
         add<DocumentSourceUnwind::Dependencies>();
 
         add<DocumentSourceGeoNear::LimitCoalesce>();
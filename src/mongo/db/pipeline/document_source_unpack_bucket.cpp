@@ -0,0 +1,101 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/document_source.h"
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/db/pipeline/expression_context.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+using boost::intrusive_ptr;
+
+DocumentSourceUnpackBucket::DocumentSourceUnpackBucket(
+    const intrusive_ptr<ExpressionContext>& pExpCtx, std::string timeField, std::string metaField)
+    : DocumentSource(pExpCtx),
+      _timeField(std::move(timeField)),
+      _metaField(std::move(metaField)),
+      _unpacker(_timeField, _metaField) {}
+
+REGISTER_DOCUMENT_SOURCE(_internalUnpackBucket, DocumentSourceUnpackBucket::createFromBson);
+
+const char* DocumentSourceUnpackBucket::getSourceName() const {
+    return "$_internalUnpackBucket";
+}
+
+boost::optional<Document> DocumentSourceUnpackBucket::getNext() {
+    pExpCtx->checkForInterrupt();
+
+    while (!_unpacker.more()) {
+        boost::optional<Document> bucket = pSource->getNext();
+        if (!bucket) {
+            return boost::none;
+        }
+        _unpacker.reset(bucket->toBson());
+    }
+    return Document(_unpacker.next());
+}
+
+Value DocumentSourceUnpackBucket::serialize(bool explain) const {
+    MutableDocument spec;
+    spec["timeField"] = Value(_timeField);
+    if (!_metaField.empty()) {
+        spec["metaField"] = Value(_metaField);
+    }
+    return Value(DOC(getSourceName() << spec.freeze()));
+}
+
+intrusive_ptr<DocumentSource> DocumentSourceUnpackBucket::createFromBson(
+    BSONElement elem, const intrusive_ptr<ExpressionContext>& pExpCtx) {
+    uassert(28834,
+            str::stream() << "$_internalUnpackBucket specification must be an object, not "
+                          << typeName(elem.type()),
+            elem.type() == Object);
+
+    std::string timeField;
+    std::string metaField;
+    for (auto&& option : elem.Obj()) {
+        const StringData name = option.fieldNameStringData();
+        if (name == "timeField" || name == "metaField") {
+            uassert(28835,
+                    str::stream() << "$_internalUnpackBucket " << name << " must be a string",
+                    option.type() == String);
+            (name == "timeField" ? timeField : metaField) = option.String();
+        } else {
+            uasserted(28836, str::stream() << "unrecognized option to $_internalUnpackBucket: "
+                                           << name);
+        }
+    }
+    uassert(28837, "$_internalUnpackBucket requires a timeField", !timeField.empty());
+
+    return new DocumentSourceUnpackBucket(pExpCtx, timeField, metaField);
+}
+}  // namespace mongo
@@ -97,6 +97,10 @@ boost::optional<Document> DocumentSourceUnwind::Unwinder::getNext() {
     // clone. Because the value at the end will be replaced, everything
     // along the path leading to that will be replaced in order not to share
     // that change with any other clones (or the original).
+    //
+    // The clone only happens when the document returned for the previous element is still
+    // referenced. Consumers which release each document before asking for the next one, such
+    // as $group, let every element after the first be written in place into the same storage.
 
     if (_inputArray.getType() == Array) {
         if (_index == _inputArray.getArrayLength())
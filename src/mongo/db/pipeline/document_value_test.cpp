@@ -1494,6 +1494,8 @@ public:
         assertComparison(0, fromjson("{'':{x:1}}"), fromjson("{'':{x:1}}"));
         assertComparison(-1, fromjson("{'':{}}"), fromjson("{'':{x:1}}"));
         assertComparison(-1, fromjson("{'':{'z': 1}}"), fromjson("{'':{'a': 'a'}}"));
+        assertComparison(-1, fromjson("{'':{a: 1}}"), fromjson("{'':{b: 1}}"));
+        assertComparison(-1, fromjson("{'':{ab: 1}}"), fromjson("{'':{ba: 1}}"));
 
         // Array.
         assertComparison(0, fromjson("{'':[]}"), fromjson("{'':[]}"));
@@ -36,6 +36,7 @@
 #include <vector>
 
 #include "mongo/db/jsobj.h"
+#include "mongo/db/pipeline/decimal_summation.h"
 #include "mongo/db/pipeline/document.h"
 #include "mongo/db/pipeline/expression_context.h"
 #include "mongo/db/pipeline/value.h"
@@ -392,18 +393,30 @@ Value ExpressionAdd::evaluateInternal(Variables* vars) const {
     BSONType totalType = NumberInt;
     bool haveDate = false;
 
+    // Decimals are summed apart from the other operands, whose total is only converted to a
+    // decimal once all of them have been added.
+    DecimalSummation decimalTotal;
+    BSONType nonDecimalTotalType = NumberInt;
+    bool haveNonDecimal = false;
+
     const size_t n = vpOperand.size();
     for (size_t i = 0; i < n; ++i) {
         Value val = vpOperand[i]->evaluateInternal(vars);
 
-        if (val.numeric()) {
+        if (val.getType() == NumberDecimal) {
+            totalType = NumberDecimal;
+            decimalTotal.add(val.getDecimal());
+        } else if (val.numeric()) {
             totalType = Value::getWidestNumeric(totalType, val.getType());
+            nonDecimalTotalType = Value::getWidestNumeric(nonDecimalTotalType, val.getType());
+            haveNonDecimal = true;
 
             doubleTotal += val.coerceToDouble();
             longTotal += val.coerceToLong();
         } else if (val.getType() == Date) {
             uassert(16612, "only one Date allowed in an $add expression", !haveDate);
             haveDate = true;
+            haveNonDecimal = true;
 
             // We don't manipulate totalType here.
 
@@ -418,8 +431,17 @@ Value ExpressionAdd::evaluateInternal(Variables* vars) const {
         }
     }
 
+    if (totalType == NumberDecimal && haveNonDecimal) {
+        if (nonDecimalTotalType == NumberDouble)
+            decimalTotal.add(Decimal128(doubleTotal));
+        else
+            decimalTotal.add(longTotal);
+    }
+
     if (haveDate) {
-        if (totalType == NumberDouble)
+        if (totalType == NumberDecimal)
+            longTotal = decimalTotal.getDecimal().toLong();
+        else if (totalType == NumberDouble)
             longTotal = static_cast<long long>(doubleTotal);
         return Value(Date_t::fromMillisSinceEpoch(longTotal));
     } else if (totalType == NumberLong) {
@@ -428,6 +450,8 @@ Value ExpressionAdd::evaluateInternal(Variables* vars) const {
         return Value(doubleTotal);
     } else if (totalType == NumberInt) {
         return Value::createIntOrLong(longTotal);
+    } else if (totalType == NumberDecimal) {
+        return Value(decimalTotal.getDecimal());
     } else {
         massert(16417, "$add resulted in a non-numeric type", false);
     }
@@ -778,7 +802,7 @@ const char* ExpressionCompare::getOpName() const {
 Value ExpressionConcat::evaluateInternal(Variables* vars) const {
     const size_t n = vpOperand.size();
 
-    StringBuilder result;
+    StackStringBuilder result;
     for (size_t i = 0; i < n; ++i) {
         Value val = vpOperand[i]->evaluateInternal(vars);
         if (val.nullish())
@@ -1186,10 +1210,20 @@ intrusive_ptr<Expression> ExpressionObject::optimize() {
         if (it->second)
             it->second = it->second->optimize();
     }
+    rebuildFieldPlans();
 
     return intrusive_ptr<Expression>(this);
 }
 
+void ExpressionObject::rebuildFieldPlans() {
+    StringMap<FieldPlan> fieldPlans;
+    for (size_t i = 0; i < _order.size(); i++) {
+        Expression* expr = _expressions.find(_order[i])->second.get();
+        fieldPlans[_order[i]] = {expr, dynamic_cast<ExpressionObject*>(expr), i};
+    }
+    _fieldPlans = fieldPlans;
+}
+
 bool ExpressionObject::isSimple() {
     for (FieldMap::iterator it(_expressions.begin()); it != _expressions.end(); ++it) {
         if (it->second && !it->second->isSimple())
@@ -1233,33 +1267,45 @@ void ExpressionObject::addDependencies(DepsTracker* deps, vector<string>* path)
 void ExpressionObject::addToDocument(MutableDocument& out,
                                      const Document& currentDoc,
                                      Variables* vars) const {
-    FieldMap::const_iterator end = _expressions.end();
-
-    // This is used to mark fields we've done so that we can add the ones we haven't
-    set<string> doneFields;
+    const StringMap<FieldPlan>::const_iterator end = _fieldPlans.end();
+
+    // This is used to mark fields we've done so that we can add the ones we haven't. Only
+    // projections of more than 64 fields need to allocate for it.
+    const size_t kMaxMaskFields = 64;
+    uint64_t doneMask = 0;
+    std::vector<bool> doneVector(_order.size() > kMaxMaskFields ? _order.size() : 0);
+    auto isDone = [&](size_t index) -> bool {
+        return doneVector.empty() ? (doneMask & (1ULL << index)) != 0 : doneVector[index];
+    };
+    size_t numDoneFields = 0;
 
     FieldIterator fields(currentDoc);
     while (fields.more()) {
         Document::FieldPair field(fields.next());
 
-        // TODO don't make a new string here
-        const string fieldName = field.first.toString();
-        FieldMap::const_iterator exprIter = _expressions.find(fieldName);
+        StringMap<FieldPlan>::const_iterator planIter = _fieldPlans.find(field.first);
 
         // This field is not supposed to be in the output (unless it is _id)
-        if (exprIter == end) {
+        if (planIter == end) {
             if (!_excludeId && _atRoot && field.first == "_id") {
                 // _id from the root doc is always included (until exclusion is supported)
-                // not updating doneFields since "_id" isn't in _expressions
+                // not marked as done since "_id" isn't in _expressions
                 out.addField(field.first, field.second);
             }
             continue;
         }
 
         // make sure we don't add this field again
-        doneFields.insert(exprIter->first);
+        const size_t index = planIter->second.index;
+        if (!isDone(index)) {
+            if (doneVector.empty())
+                doneMask |= 1ULL << index;
+            else
+                doneVector[index] = true;
+            numDoneFields++;
+        }
 
-        Expression* expr = exprIter->second.get();
+        Expression* expr = planIter->second.expression;
 
         if (!expr) {
             // This means pull the matching field from the input document
@@ -1267,7 +1313,7 @@ void ExpressionObject::addToDocument(MutableDocument& out,
             continue;
         }
 
-        ExpressionObject* exprObj = dynamic_cast<ExpressionObject*>(expr);
+        ExpressionObject* exprObj = planIter->second.subObject;
         BSONType valueType = field.second.getType();
         if ((valueType != Object && valueType != Array) || !exprObj) {
             // This expression replace the whole field
@@ -1322,23 +1368,23 @@ void ExpressionObject::addToDocument(MutableDocument& out,
         }
     }
 
-    if (doneFields.size() == _expressions.size())
+    if (numDoneFields == _order.size())
         return;
 
     /* add any remaining fields we haven't already taken care of */
-    for (vector<string>::const_iterator i(_order.begin()); i != _order.end(); ++i) {
-        FieldMap::const_iterator it = _expressions.find(*i);
-        string fieldName(it->first);
-
+    for (size_t i = 0; i < _order.size(); i++) {
         /* if we've already dealt with this field, above, do nothing */
-        if (doneFields.count(fieldName))
+        if (isDone(i))
             continue;
 
+        const string& fieldName = _order[i];
+        const FieldPlan& plan = _fieldPlans.find(fieldName)->second;
+
         // this is a missing inclusion field
-        if (!it->second)
+        if (!plan.expression)
             continue;
 
-        Value pValue(it->second->evaluateInternal(vars));
+        Value pValue(plan.expression->evaluateInternal(vars));
 
         /*
           Don't add non-existent values (note:  different from NULL or Undefined);
@@ -1349,7 +1395,7 @@ void ExpressionObject::addToDocument(MutableDocument& out,
             continue;
 
         // don't add field if nothing was found in the subobject
-        if (dynamic_cast<ExpressionObject*>(it->second.get()) && pValue.getDocument().empty())
+        if (plan.subObject && pValue.getDocument().empty())
             continue;
 
         out.addField(fieldName, pValue);
@@ -1418,11 +1464,14 @@ void ExpressionObject::addField(const FieldPath& fieldPath,
     if (fieldPath.getPathLength() == 1) {
         verify(!haveExpr);  // haveExpr case handled above.
         expr = pExpression;
+        rebuildFieldPlans();
         return;
     }
 
-    if (!haveExpr)
+    if (!haveExpr) {
         expr = subObj = ExpressionObject::create();
+        rebuildFieldPlans();
+    }
 
     subObj->addField(fieldPath.tail(), pExpression);
 }
@@ -2019,12 +2068,26 @@ Value ExpressionMultiply::evaluateInternal(Variables* vars) const {
     long long longProduct = 1;
     BSONType productType = NumberInt;
 
+    // Decimals are multiplied apart from the other operands, whose product is only converted to a
+    // decimal once all of them have been multiplied.
+    Decimal128 decimalProduct;
+    BSONType nonDecimalProductType = NumberInt;
+    bool haveDecimal = false;
+    bool haveNonDecimal = false;
+
     const size_t n = vpOperand.size();
     for (size_t i = 0; i < n; ++i) {
         Value val = vpOperand[i]->evaluateInternal(vars);
 
-        if (val.numeric()) {
+        if (val.getType() == NumberDecimal) {
+            productType = NumberDecimal;
+            decimalProduct =
+                haveDecimal ? decimalProduct.multiply(val.getDecimal()) : val.getDecimal();
+            haveDecimal = true;
+        } else if (val.numeric()) {
             productType = Value::getWidestNumeric(productType, val.getType());
+            nonDecimalProductType = Value::getWidestNumeric(nonDecimalProductType, val.getType());
+            haveNonDecimal = true;
 
             doubleProduct *= val.coerceToDouble();
             longProduct *= val.coerceToLong();
@@ -2037,7 +2100,14 @@ Value ExpressionMultiply::evaluateInternal(Variables* vars) const {
         }
     }
 
-    if (productType == NumberDouble)
+    if (productType == NumberDecimal) {
+        if (haveNonDecimal) {
+            decimalProduct = decimalProduct.multiply(nonDecimalProductType == NumberDouble
+                                                         ? Decimal128(doubleProduct)
+                                                         : Decimal128(longProduct));
+        }
+        return Value(decimalProduct);
+    } else if (productType == NumberDouble)
         return Value(doubleProduct);
     else if (productType == NumberLong)
         return Value(longProduct);
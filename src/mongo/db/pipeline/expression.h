@@ -1060,6 +1060,11 @@ public:
 private:
     explicit ExpressionObject(bool atRoot);
 
+    /**
+     * Rebuilds _fieldPlans from _expressions. Must be called whenever _expressions changes.
+     */
+    void rebuildFieldPlans();
+
     // Mapping from fieldname to the Expression that generates its value.
     // NULL expression means inclusion from source document.
     typedef std::map<std::string, boost::intrusive_ptr<Expression>> FieldMap;
@@ -1068,6 +1073,20 @@ private:
     // this is used to maintain order for generated fields not in the source document
     std::vector<std::string> _order;
 
+    // What addToDocument() needs to know about each field of _expressions, precomputed so that it
+    // can look up the fields of each input document without copying their names or casting.
+    struct FieldPlan {
+        // Null for an inclusion. Owned by _expressions.
+        Expression* expression;
+
+        // Equal to 'expression' if it is an ExpressionObject, and null otherwise.
+        ExpressionObject* subObject;
+
+        // The position of the field in _order.
+        size_t index;
+    };
+    StringMap<FieldPlan> _fieldPlans;
+
     bool _excludeId;
     bool _atRoot;
 };
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "mongo/db/namespace_string.h"
@@ -36,6 +37,8 @@
 
 namespace mongo {
 
+class SpillTracker;
+
 struct ExpressionContext : public IntrusiveCounterUnsigned {
 public:
     ExpressionContext(OperationContext* opCtx, const NamespaceString& ns) : ns(ns), opCtx(opCtx) {}
@@ -58,6 +61,8 @@ public:
 
     NamespaceString ns;
     std::string tempDir;  // Defaults to empty to prevent external sorting in mongos.
+    // Shared by the external sorts of all stages. Null if they should not be accounted for.
+    std::shared_ptr<SpillTracker> spillTracker;
 
     OperationContext* opCtx;
     static const int kInterruptCheckPeriod = 128;
@@ -1459,6 +1459,44 @@ TEST(ExpressionFromAccumulators, Sum) {
          {{}, Value(0)}});
 }
 
+TEST(ExpressionFromAccumulators, SumDecimals) {
+    if (!Decimal128::enabled) {
+        return;
+    }
+    assertExpectedResults(
+        "$sum",
+        {// Decimals are summed exactly.
+         {{Value(Decimal128("0.10")), Value(Decimal128("0.20"))}, Value(Decimal128("0.30"))},
+         // If any argument is a decimal, $sum returns a decimal.
+         {{Value(Decimal128("1.5")), Value(2), Value(3LL), Value(0.5)}, Value(Decimal128("7"))}});
+}
+
+TEST(ExpressionAdd, Decimals) {
+    if (!Decimal128::enabled) {
+        return;
+    }
+    assertExpectedResults(
+        "$add",
+        {{{Value(Decimal128("1.25")), Value(Decimal128("-0.5"))}, Value(Decimal128("0.75"))},
+         {{Value(1), Value(Decimal128("2.5")), Value(3LL)}, Value(Decimal128("6.5"))},
+         {{Value(Decimal128("2.5")), Value(0.25)}, Value(Decimal128("2.75"))},
+         {{Value(Decimal128("1")), Value(BSONNULL)}, Value(BSONNULL)},
+         {{Value(Decimal128("2.9")), Value(Date_t::fromMillisSinceEpoch(1000))},
+          Value(Date_t::fromMillisSinceEpoch(1003))}});
+}
+
+TEST(ExpressionMultiply, Decimals) {
+    if (!Decimal128::enabled) {
+        return;
+    }
+    assertExpectedResults(
+        "$multiply",
+        {{{Value(Decimal128("1.5")), Value(Decimal128("-2"))}, Value(Decimal128("-3"))},
+         {{Value(3), Value(Decimal128("0.5")), Value(2LL)}, Value(Decimal128("3"))},
+         {{Value(Decimal128("0.5")), Value(0.5)}, Value(Decimal128("0.25"))},
+         {{Value(Decimal128("0.5")), Value(BSONNULL)}, Value(BSONNULL)}});
+}
+
 TEST(ExpressionFromAccumulators, StdDevPop) {
     assertExpectedResults("$stdDevPop",
                           {// $stdDevPop ignores non-numeric inputs.
@@ -2590,6 +2628,86 @@ public:
     }
 };
 
+/** Every other one of many included fields is present, followed by a computed field. */
+class ManyFields : public ExpectedResultBase {
+public:
+    virtual BSONObj source() {
+        BSONObjBuilder bob;
+        bob.append("_id", 0);
+        for (int i = 0; i < kNumFields; i += 2) {
+            bob.append(fieldName(i), i);
+        }
+        return bob.obj();
+    }
+    void prepareExpression() {
+        for (int i = 0; i < kNumFields; i++) {
+            expression()->includePath(fieldName(i));
+        }
+        expression()->addField(mongo::FieldPath("z"), ExpressionConstant::create(Value(5)));
+    }
+    BSONObj expected() {
+        BSONObjBuilder bob;
+        bob.appendElements(source());
+        bob.append("z", 5);
+        return bob.obj();
+    }
+    BSONArray expectedDependencies() {
+        set<string> fields{"_id"};
+        for (int i = 0; i < kNumFields; i++) {
+            fields.insert(fieldName(i));
+        }
+        BSONArrayBuilder bab;
+        for (auto&& field : fields) {
+            bab << field;
+        }
+        return bab.arr();
+    }
+    BSONObj expectedBsonRepresentation() {
+        BSONObjBuilder bob;
+        for (int i = 0; i < kNumFields; i++) {
+            bob.append(fieldName(i), true);
+        }
+        bob.append("z", BSON("$const" << 5));
+        return bob.obj();
+    }
+    bool expectedIsSimple() {
+        return false;
+    }
+
+private:
+    // More fields than fit the mask used to track which fields are done.
+    static const int kNumFields = 70;
+
+    static string fieldName(int i) {
+        return str::stream() << "f" << i;
+    }
+};
+
+/** A field repeated in the source is included each time, and no computed field is skipped. */
+class DuplicateSourceFields : public ExpectedResultBase {
+public:
+    virtual BSONObj source() {
+        return BSON("_id" << 0 << "a" << 1 << "a" << 2);
+    }
+    void prepareExpression() {
+        expression()->includePath("a");
+        expression()->addField(mongo::FieldPath("b"), ExpressionConstant::create(Value(5)));
+    }
+    BSONObj expected() {
+        return BSON("_id" << 0 << "a" << 1 << "a" << 2 << "b" << 5);
+    }
+    BSONArray expectedDependencies() {
+        return BSON_ARRAY("_id"
+                          << "a");
+    }
+    BSONObj expectedBsonRepresentation() {
+        return BSON("a" << true << "b" << BSON("$const" << 5));
+    }
+    bool expectedIsSimple() {
+        return false;
+    }
+};
+
 /** Two expressions cannot generate the same field. */
 class ConflictingExpressionFields : public Base {
 public:
@@ -4461,6 +4579,8 @@ public:
         add<Object::AdjacentDottedComputedFields>();
         add<Object::AdjacentNestedOrdering>();
         add<Object::MultipleNestedFields>();
+        add<Object::ManyFields>();
+        add<Object::DuplicateSourceFields>();
         add<Object::ConflictingExpressionFields>();
         add<Object::ConflictingInclusionExpressionFields>();
         add<Object::ConflictingExpressionInclusionFields>();
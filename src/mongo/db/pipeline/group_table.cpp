@@ -0,0 +1,92 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const uint32_t GroupTable::kEmptySlot;
+const size_t GroupTable::kMinSlots;
+
+size_t GroupTable::firstSlot(size_t hash) const {
+    // Value::Hash leaves the low bits of small integral keys nearly unchanged, so scramble them
+    // before masking.
+    const uint64_t mixed = static_cast<uint64_t>(hash) * 0x9E3779B97F4A7C15ULL;
+    return static_cast<size_t>(mixed ^ (mixed >> 32)) & (_slots.size() - 1);
+}
+
+GroupTable::Accumulators& GroupTable::findOrInsert(const Value& key, bool* inserted) {
+    if ((_groups.size() + 1) * 2 > _slots.size()) {
+        grow();
+    }
+
+    const size_t hash = Value::Hash()(key);
+    const size_t mask = _slots.size() - 1;
+    for (size_t slot = firstSlot(hash);; slot = (slot + 1) & mask) {
+        const uint32_t index = _slots[slot];
+        if (index == kEmptySlot) {
+            invariant(_groups.size() < kEmptySlot);
+            _slots[slot] = static_cast<uint32_t>(_groups.size());
+            _hashes.push_back(hash);
+            _groups.emplace_back(key, Accumulators());
+            *inserted = true;
+            return _groups.back().second;
+        }
+
+        if (_hashes[index] == hash && _groups[index].first == key) {
+            *inserted = false;
+            return _groups[index].second;
+        }
+    }
+}
+
+void GroupTable::grow() {
+    std::vector<uint32_t> slots(std::max(kMinSlots, _slots.size() * 2), kEmptySlot);
+    _slots.swap(slots);
+
+    const size_t mask = _slots.size() - 1;
+    for (size_t index = 0; index < _groups.size(); ++index) {
+        size_t slot = firstSlot(_hashes[index]);
+        while (_slots[slot] != kEmptySlot) {
+            slot = (slot + 1) & mask;
+        }
+        _slots[slot] = static_cast<uint32_t>(index);
+    }
+}
+
+void GroupTable::clear() {
+    std::vector<value_type>().swap(_groups);
+    std::vector<size_t>().swap(_hashes);
+    std::vector<uint32_t>().swap(_slots);
+}
+
+}  // namespace mongo
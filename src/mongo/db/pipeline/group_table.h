@@ -0,0 +1,119 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/intrusive_ptr.hpp>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "mongo/db/pipeline/accumulator.h"
+#include "mongo/db/pipeline/value.h"
+
+namespace mongo {
+
+/**
+ * Maps each $group key to the accumulators of its group.
+ *
+ * Groups are stored contiguously in insertion order in a vector, and an open-addressing table of
+ * group indexes with linear probing is used to find them. Growing the table only rehashes the
+ * indexes, so keys and accumulators are never copied, and unlike a node-based hash map the memory
+ * used by the table itself is known exactly.
+ */
+class GroupTable {
+public:
+    typedef std::vector<boost::intrusive_ptr<Accumulator>> Accumulators;
+    typedef std::pair<Value, Accumulators> value_type;
+    typedef std::vector<value_type>::const_iterator const_iterator;
+
+    /**
+     * Returns the accumulators of the group with key 'key', adding an empty group if there is none
+     * yet. Sets '*inserted' to whether a group was added. The returned reference is invalidated by
+     * the next insertion.
+     */
+    Accumulators& findOrInsert(const Value& key, bool* inserted);
+
+    size_t size() const {
+        return _groups.size();
+    }
+
+    bool empty() const {
+        return _groups.empty();
+    }
+
+    /**
+     * Iterates over the groups in the order they were inserted.
+     */
+    const_iterator begin() const {
+        return _groups.begin();
+    }
+
+    const_iterator end() const {
+        return _groups.end();
+    }
+
+    /**
+     * Removes all groups and releases the memory held by the table.
+     */
+    void clear();
+
+    /**
+     * Returns the number of bytes allocated by the table for its slots and group entries. This
+     * does not include memory owned by the keys or accumulators of the groups.
+     */
+    size_t memoryUsageBytes() const {
+        return _slots.capacity() * sizeof(uint32_t) + _groups.capacity() * sizeof(value_type) +
+            _hashes.capacity() * sizeof(size_t);
+    }
+
+private:
+    static const uint32_t kEmptySlot = ~uint32_t(0);
+    static const size_t kMinSlots = 16;
+
+    /**
+     * Returns the slot at which to start probing for a key with hash 'hash'.
+     */
+    size_t firstSlot(size_t hash) const;
+
+    /**
+     * Doubles the number of slots and reinserts every group index.
+     */
+    void grow();
+
+    std::vector<value_type> _groups;
+
+    // The hash of the key of each group, parallel to '_groups'.
+    std::vector<size_t> _hashes;
+
+    // A power of two number of slots, each kEmptySlot or an index into '_groups'. Kept at most half
+    // full.
+    std::vector<uint32_t> _slots;
+};
+
+}  // namespace mongo
@@ -0,0 +1,106 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/pipeline/group_table.h"
+
+#include <set>
+
+#include "mongo/db/pipeline/document.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(GroupTableTest, FindsInsertedGroups) {
+    GroupTable table;
+    ASSERT(table.empty());
+
+    const int numGroups = 10000;
+    bool inserted = false;
+    for (int i = 0; i < numGroups; ++i) {
+        table.findOrInsert(Value(i), &inserted).push_back(AccumulatorSum::create());
+        ASSERT(inserted);
+    }
+    ASSERT_EQUALS(size_t(numGroups), table.size());
+
+    // Numerically equal keys of different types belong to the same group.
+    for (int i = 0; i < numGroups; ++i) {
+        GroupTable::Accumulators& accums = table.findOrInsert(Value(double(i)), &inserted);
+        ASSERT(!inserted);
+        ASSERT_EQUALS(1U, accums.size());
+    }
+    ASSERT_EQUALS(size_t(numGroups), table.size());
+}
+
+TEST(GroupTableTest, IteratesInInsertionOrder) {
+    GroupTable table;
+    bool inserted = false;
+    const std::vector<Value> keys = {Value(3),
+                                     Value(StringData("b")),
+                                     Value(BSONNULL),
+                                     Value(DOC("a" << 1)),
+                                     Value(std::vector<Value>{Value(1), Value(2)})};
+    for (auto&& key : keys) {
+        table.findOrInsert(key, &inserted);
+        table.findOrInsert(keys[0], &inserted);
+    }
+
+    std::vector<Value> found;
+    for (auto&& group : table) {
+        found.push_back(group.first);
+    }
+    ASSERT_EQUALS(keys.size(), found.size());
+    for (size_t i = 0; i < keys.size(); ++i) {
+        ASSERT_EQUALS(keys[i], found[i]);
+    }
+}
+
+TEST(GroupTableTest, ClearReleasesMemory) {
+    GroupTable table;
+    ASSERT_EQUALS(0U, table.memoryUsageBytes());
+
+    bool inserted = false;
+    for (int i = 0; i < 100; ++i) {
+        table.findOrInsert(Value(i), &inserted);
+    }
+    ASSERT_GTE(table.memoryUsageBytes(), 100 * sizeof(GroupTable::value_type));
+
+    table.clear();
+    ASSERT(table.empty());
+    ASSERT(table.begin() == table.end());
+    ASSERT_EQUALS(0U, table.memoryUsageBytes());
+
+    table.findOrInsert(Value(1), &inserted);
+    ASSERT(inserted);
+    ASSERT_EQUALS(1U, table.size());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -171,6 +171,7 @@ intrusive_ptr<Pipeline> Pipeline::parseCommand(string& errmsg,
     Optimizations::Local::coalesceAdjacent(pPipeline.get());
     Optimizations::Local::optimizeEachDocumentSource(pPipeline.get());
     Optimizations::Local::duplicateMatchBeforeInitalRedact(pPipeline.get());
+    Optimizations::Local::streamGroupsAfterSort(pPipeline.get());
 
     return pPipeline;
 }
@@ -310,6 +311,18 @@ void Pipeline::Optimizations::Local::duplicateMatchBeforeInitalRedact(Pipeline*
     }
 }
 
+void Pipeline::Optimizations::Local::streamGroupsAfterSort(Pipeline* pipeline) {
+    SourceContainer& sources = pipeline->sources;
+    for (size_t srcn = sources.size(), srci = 1; srci < srcn; ++srci) {
+        auto group = dynamic_cast<DocumentSourceGroup*>(sources[srci].get());
+        auto sort = dynamic_cast<DocumentSourceSort*>(sources[srci - 1].get());
+        if (group && sort &&
+            group->canStreamInputSortedBy(sort->serializeSortKey(/*explain*/ false).toBson())) {
+            group->setStreaming(true);
+        }
+    }
+}
+
 Status Pipeline::checkAuthForCommand(ClientBasic* client,
                                      const std::string& db,
                                      const BSONObj& cmdObj) {
@@ -30,21 +30,30 @@
 
 #include "mongo/db/pipeline/pipeline_d.h"
 
+#include <algorithm>
+
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/exec/multi_iterator.h"
 #include "mongo/db/exec/working_set.h"
 #include "mongo/db/exec/shard_filter.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/ops/insert.h"
 #include "mongo/db/pipeline/document_source.h"
 #include "mongo/db/pipeline/pipeline.h"
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_stats.h"
+#include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/service_context.h"
+#include "mongo/db/stats/counters.h"
 #include "mongo/db/storage/record_store.h"
 #include "mongo/db/s/sharded_connection_info.h"
 #include "mongo/db/s/sharding_state.h"
@@ -84,13 +93,46 @@ public:
         return collection && collection->isCapped();
     }
 
-    BSONObj insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) final {
+    Status insert(const NamespaceString& ns, const std::vector<BSONObj>& objs) final {
+        OperationContext* txn = _ctx->opCtx;
         boost::optional<DisableDocumentValidation> maybeDisableValidation;
         if (_ctx->bypassDocumentValidation)
-            maybeDisableValidation.emplace(_ctx->opCtx);
+            maybeDisableValidation.emplace(txn);
+
+        std::vector<BSONObj> docs;
+        docs.reserve(objs.size());
+        for (const BSONObj& obj : objs) {
+            StatusWith<BSONObj> fixed = fixDocumentForInsert(obj);
+            if (!fixed.isOK()) {
+                return fixed.getStatus();
+            }
+            docs.push_back(fixed.getValue().isEmpty() ? obj : fixed.getValue());
+        }
+
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
+            ScopedTransaction scopedXact(txn, MODE_IX);
+            AutoGetCollection autoColl(txn, ns, MODE_IX);
+            Collection* collection = autoColl.getCollection();
+            if (!collection) {
+                return Status(ErrorCodes::NamespaceNotFound,
+                              str::stream() << "collection " << ns.ns() << " was dropped");
+            }
+            if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(ns)) {
+                return Status(ErrorCodes::NotMaster,
+                              str::stream() << "Not primary while writing to " << ns.ns());
+            }
 
-        _client.insert(ns.ns(), objs);
-        return _client.getLastErrorDetailed();
+            WriteUnitOfWork wuow(txn);
+            Status status = collection->insertDocuments(txn, docs.begin(), docs.end(), true);
+            if (!status.isOK()) {
+                return status;
+            }
+            wuow.commit();
+        }
+        MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, "$out insert", ns.ns());
+
+        globalOpCounters.incInsertInWriteLock(docs.size());
+        return Status::OK();
     }
 
     CollectionIndexUsageMap getIndexStats(OperationContext* opCtx,
@@ -112,6 +154,10 @@ public:
         return collection->infoCache()->getIndexUsageStats();
     }
 
+    std::vector<BSONObj> getQueryStats(OperationContext* opCtx, const NamespaceString& ns) final {
+        return QueryStatsStore::get(opCtx->getClient()->getServiceContext()).getStats(ns);
+    }
+
 private:
     intrusive_ptr<ExpressionContext> _ctx;
     DBDirectClient _client;
@@ -180,6 +226,68 @@ StatusWith<std::unique_ptr<PlanExecutor>> attemptToGetExecutor(
     return getExecutor(
         txn, collection, std::move(cq.getValue()), PlanExecutor::YIELD_AUTO, plannerOpts);
 }
+
+/**
+ * Returns whether 'field' is one of 'indexFields' or lies within one of them.
+ */
+bool isFieldInIndex(StringData field, const std::vector<std::string>& indexFields) {
+    for (const auto& indexField : indexFields) {
+        if (field == indexField ||
+            (field.startsWith(indexField) && field[indexField.size()] == '.')) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Returns the key patterns of the ready btree indexes of 'collection' that contain every field
+ * included by 'projection' and every field 'query' has a top-level predicate on. A scan of any
+ * of these may be able to produce the pipeline's input from index keys alone, without fetching
+ * documents, even when the query does not constrain the index. Returns nothing for queries with
+ * top-level operators, such as $or or $text, which the index would not simply filter.
+ */
+std::vector<BSONObj> candidateCoveringKeyPatterns(OperationContext* txn,
+                                                  Collection* collection,
+                                                  const BSONObj& query,
+                                                  const BSONObj& projection) {
+    std::vector<StringData> fields;
+    for (auto&& elem : query) {
+        if (elem.fieldName()[0] == '$') {
+            return {};
+        }
+        fields.push_back(elem.fieldNameStringData());
+    }
+    for (auto&& elem : projection) {
+        if (elem.type() == Object || elem.fieldName()[0] == '$') {
+            // Neither a $meta projection nor the placeholder DepsTracker uses when no fields are
+            // needed can be covered.
+            return {};
+        }
+        if (elem.trueValue()) {
+            fields.push_back(elem.fieldNameStringData());
+        }
+    }
+
+    std::vector<BSONObj> keyPatterns;
+    IndexCatalog::IndexIterator ii = collection->getIndexCatalog()->getIndexIterator(txn, false);
+    while (ii.more()) {
+        const IndexDescriptor* desc = ii.next();
+        if (!IndexNames::findPluginName(desc->keyPattern()).empty()) {
+            continue;
+        }
+        std::vector<std::string> indexFields;
+        for (auto&& keyElem : desc->keyPattern()) {
+            indexFields.push_back(keyElem.fieldName());
+        }
+        if (std::all_of(fields.begin(), fields.end(), [&](StringData field) {
+                return isFieldInIndex(field, indexFields);
+            })) {
+            keyPatterns.push_back(desc->keyPattern());
+        }
+    }
+    return keyPatterns;
+}
 }  // namespace
 
 shared_ptr<PlanExecutor> PipelineD::prepareCursorSource(
@@ -346,6 +454,24 @@ std::shared_ptr<PlanExecutor> PipelineD::prepareExecutor(
     // sort.
     dassert(sortObj->isEmpty());
 
+    // If the pipeline starts with a $group on fields that an index can both order and cover, scan
+    // that index so that the $group can return each group as soon as the key changes. Sorted plans
+    // which still need to fetch documents are not worth it compared to grouping in a hash table.
+    auto group = pipeline->sources.empty()
+        ? nullptr
+        : dynamic_cast<DocumentSourceGroup*>(pipeline->sources.front().get());
+    const BSONObj groupSortObj = group ? group->getStreamingSortPattern() : BSONObj();
+    if (!groupSortObj.isEmpty() && !projectionObj->isEmpty()) {
+        auto swExecutorGroupSortAndProj = attemptToGetExecutor(
+            txn, collection, expCtx, queryObj, *projectionObj, groupSortObj, plannerOpts);
+
+        if (swExecutorGroupSortAndProj.isOK()) {
+            *sortObj = groupSortObj;
+            group->setStreaming(true);
+            return std::move(swExecutorGroupSortAndProj.getValue());
+        }
+    }
+
     // See if the query system can cover the projection.
     auto swExecutorProj = attemptToGetExecutor(
         txn, collection, expCtx, queryObj, *projectionObj, *sortObj, plannerOpts);
@@ -354,6 +480,22 @@ std::shared_ptr<PlanExecutor> PipelineD::prepareExecutor(
         return std::move(swExecutorProj.getValue());
     }
 
+    // The planner only considers indexes that the query constrains or that provide a requested
+    // sort, so a pipeline whose fields are all in an index is never covered by it when the query
+    // does not constrain the index. Ask for the order of each index that has all the fields so
+    // that the planner considers scanning it, which reads keys instead of whole documents. The
+    // pipeline does not depend on that order, so it is not reported as a sort.
+    if (collection && !projectionObj->isEmpty()) {
+        for (auto&& keyPattern :
+             candidateCoveringKeyPatterns(txn, collection, queryObj, *projectionObj)) {
+            auto swExecutorIndexProj = attemptToGetExecutor(
+                txn, collection, expCtx, queryObj, *projectionObj, keyPattern, plannerOpts);
+            if (swExecutorIndexProj.isOK()) {
+                return std::move(swExecutorIndexProj.getValue());
+            }
+        }
+    }
+
     // The query system couldn't provide a covered projection.
     *projectionObj = BSONObj();
     // If this doesn't work, nothing will.
@@ -95,6 +95,14 @@ public:
      * BSONObjs converted to Documents.
      */
     static void duplicateMatchBeforeInitalRedact(Pipeline* pipeline);
+
+    /**
+     * Tells each $group directly following a $sort on its group key that its input is sorted.
+     *
+     * The $group can then return each group as soon as its last document is seen, holding a
+     * single group in memory instead of all of them.
+     */
+    static void streamGroupsAfterSort(Pipeline* pipeline);
 };
 
 /**
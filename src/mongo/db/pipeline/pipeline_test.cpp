@@ -179,6 +179,101 @@ class DoNotRemoveNonEmptyMatch : public Base {
     }
 };
 
+class StreamGroupAfterSortOnGroupKey : public Base {
+    string inputPipeJson() override {
+        return "[{$sort: {b: -1, a: 1, c: 1}}"
+               ",{$group: {_id: {x: '$a', y: '$b'}, n: {$sum: 1}}}"
+               "]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$sort: {sortKey: {b: -1, a: 1, c: 1}}}"
+               ",{$group: {_id: {x: '$a', y: '$b'}, n: {$sum: {$const: 1}}, $streaming: true}}"
+               "]";
+    }
+};
+
+class DoNotStreamGroupAfterSortOnOtherFields : public Base {
+    string inputPipeJson() override {
+        return "[{$sort: {a: 1, c: 1}}"
+               ",{$group: {_id: {x: '$a', y: '$b'}, n: {$sum: 1}}}"
+               "]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$sort: {sortKey: {a: 1, c: 1}}}"
+               ",{$group: {_id: {x: '$a', y: '$b'}, n: {$sum: {$const: 1}}}}"
+               "]";
+    }
+};
+
+class LookUpAbsorbsUnwind : public Base {
+    string inputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right'}}"
+               ",{$unwind: '$same'}"
+               "]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right', unwinding: true}}"
+               "]";
+    }
+};
+
+class LookUpAbsorbsMatchOnForeignFieldsAfterUnwind : public Base {
+    string inputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right'}}"
+               ",{$unwind: '$same'}"
+               ",{$match: {'same.x': 1, 'same.y.z': {$gt: 2}}}"
+               ",{$match: {'same.w': 3}}"
+               "]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right', unwinding: true, matching: {$and: [{x: 1, 'y.z': {$gt: 2}}, {w: 3}]}}}"
+               "]";
+    }
+};
+
+class LookUpDoesNotAbsorbMatchOnLocalFields : public Base {
+    string inputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right'}}"
+               ",{$unwind: '$same'}"
+               ",{$match: {'same.x': 1, left: 2}}"
+               "]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right', unwinding: true}}"
+               ",{$match: {'same.x': 1, left: 2}}"
+               "]";
+    }
+};
+
+class LookUpDoesNotAbsorbMatchWithoutUnwind : public Base {
+    string inputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right'}}"
+               ",{$match: {'same.x': 1}}"
+               ",{$unwind: '$same'}"
+               "]";
+    }
+
+    string outputPipeJson() override {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'left', foreignField: "
+               "'right'}}"
+               ",{$match: {'same.x': 1}}"
+               ",{$unwind: '$same'}"
+               "]";
+    }
+};
+
 }  // namespace Local
 
 namespace Sharded {
@@ -432,6 +527,25 @@ class Out : public needsPrimaryShardMergerBase {
     }
 };
 
+class LookUp : public needsPrimaryShardMergerBase {
+    bool needsPrimaryShardMerger() {
+        return true;
+    }
+    string inputPipeJson() {
+        return "[{$match: {a: 1}}"
+               ",{$lookUp: {from: 'foreign', as: 'same', localField: 'a', foreignField: 'b'}}"
+               ",{$unwind: '$same'}"
+               "]";
+    }
+    string shardPipeJson() {
+        return "[{$match: {a: 1}}]";
+    }
+    string mergePipeJson() {
+        return "[{$lookUp: {from: 'foreign', as: 'same', localField: 'a', foreignField: 'b', "
+               "unwinding: true}}]";
+    }
+};
+
 class Project : public needsPrimaryShardMergerBase {
     bool needsPrimaryShardMerger() {
         return false;
@@ -464,6 +578,12 @@ public:
         add<Optimizations::Local::RemoveEmptyMatch>();
         add<Optimizations::Local::RemoveMultipleEmptyMatches>();
         add<Optimizations::Local::DoNotRemoveNonEmptyMatch>();
+        add<Optimizations::Local::StreamGroupAfterSortOnGroupKey>();
+        add<Optimizations::Local::DoNotStreamGroupAfterSortOnOtherFields>();
+        add<Optimizations::Local::LookUpAbsorbsUnwind>();
+        add<Optimizations::Local::LookUpAbsorbsMatchOnForeignFieldsAfterUnwind>();
+        add<Optimizations::Local::LookUpDoesNotAbsorbMatchOnLocalFields>();
+        add<Optimizations::Local::LookUpDoesNotAbsorbMatchWithoutUnwind>();
         add<Optimizations::Sharded::Empty>();
         add<Optimizations::Sharded::moveFinalUnwindFromShardsToMerger::OneUnwind>();
         add<Optimizations::Sharded::moveFinalUnwindFromShardsToMerger::TwoUnwind>();
@@ -479,6 +599,7 @@ public:
                 ShardedSortMatchProjSkipLimBecomesMatchTopKSortSkipProj>();
         add<Optimizations::Sharded::limitFieldsSentFromShardsToMerger::ShardAlreadyExhaustive>();
         add<Optimizations::Sharded::needsPrimaryShardMerger::Out>();
+        add<Optimizations::Sharded::needsPrimaryShardMerger::LookUp>();
         add<Optimizations::Sharded::needsPrimaryShardMerger::Project>();
     }
 };
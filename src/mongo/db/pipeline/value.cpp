@@ -734,9 +734,17 @@ int Value::compare(const Value& rL, const Value& rR) {
             return rL.getStringData().compare(rR.getStringData());
 
         case Object:
+            // Values copied from the same document, such as the ones $unwind produces from a single
+            // input, share their storage, which makes them equal without walking it.
+            if (rL._storage.genericRCPtr == rR._storage.genericRCPtr)
+                return 0;
+
             return Document::compare(rL.getDocument(), rR.getDocument());
 
         case Array: {
+            if (rL._storage.genericRCPtr == rR._storage.genericRCPtr)
+                return 0;
+
             const vector<Value>& lArr = rL.getArray();
             const vector<Value>& rArr = rR.getArray();
 
@@ -876,10 +884,12 @@ void Value::hash_combine(size_t& seed) const {
             break;
         }
 
-        case DBRef:
-            boost::hash_combine(seed, _storage.getDBRef()->ns);
+        case DBRef: {
+            StringData ns = _storage.getDBRef()->ns;
+            MurmurHash3_x86_32(ns.rawData(), ns.size(), seed, &seed);
             _storage.getDBRef()->oid.hash_combine(seed);
             break;
+        }
 
 
         case BinData: {
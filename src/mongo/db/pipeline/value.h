@@ -151,6 +151,7 @@ public:
     Timestamp getTimestamp() const;
     const char* getRegex() const;
     const char* getRegexFlags() const;
+    BSONBinData getBinData() const;
     std::string getSymbol() const;
     std::string getCode() const;
     int getInt() const;
@@ -350,6 +351,12 @@ inline const char* Value::getRegexFlags() const {
     return flags;
 }
 
+inline BSONBinData Value::getBinData() const {
+    verify(getType() == BinData);
+    const StringData data = _storage.getString();
+    return BSONBinData(data.rawData(), data.size(), _storage.binDataType());
+}
+
 inline std::string Value::getSymbol() const {
     verify(getType() == Symbol);
     return _storage.getString().toString();
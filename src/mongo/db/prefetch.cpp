@@ -32,18 +32,28 @@
 
 #include "mongo/db/prefetch.h"
 
+#include "mongo/base/counter.h"
+#include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/catalog/collection.h"
 #include "mongo/db/catalog/database.h"
+#include "mongo/db/catalog/database_holder.h"
+#include "mongo/db/client.h"
 #include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/index/index_access_method.h"
 #include "mongo/db/jsobj.h"
+#include "mongo/db/operation_context_impl.h"
 #include "mongo/db/repl/bgsync.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/db/service_context.h"
 #include "mongo/db/stats/timer_stats.h"
 #include "mongo/db/storage/mmap_v1/mmap.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+#include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
@@ -64,6 +74,34 @@ ServerStatusMetricField<TimerStats> displayPrefetchIndexPages("repl.preload.inde
 TimerStats prefetchDocStats;
 ServerStatusMetricField<TimerStats> displayPrefetchDocPages("repl.preload.docs", &prefetchDocStats);
 
+// The number of documents prefetched which were found, and which were not, of which the latter
+// bring no pages in.
+Counter64 prefetchDocsFound;
+ServerStatusMetricField<Counter64> displayPrefetchDocsFound("repl.preload.docsFound",
+                                                            &prefetchDocsFound);
+Counter64 prefetchDocsNotFound;
+ServerStatusMetricField<Counter64> displayPrefetchDocsNotFound("repl.preload.docsNotFound",
+                                                               &prefetchDocsNotFound);
+
+// The number of ops the pipelined prefetch ran on, and dropped because it was too far behind.
+Counter64 pipelinedPrefetchOps;
+ServerStatusMetricField<Counter64> displayPipelinedPrefetchOps("repl.preload.pipeline.ops",
+                                                               &pipelinedPrefetchOps);
+Counter64 pipelinedPrefetchDroppedOps;
+ServerStatusMetricField<Counter64> displayPipelinedPrefetchDroppedOps(
+    "repl.preload.pipeline.droppedOps", &pipelinedPrefetchDroppedOps);
+
+MONGO_EXPORT_SERVER_PARAMETER(replPipelinedPrefetch, bool, true);
+MONGO_EXPORT_SERVER_PARAMETER(replPipelinedPrefetchMaxOps, int, 10000);
+
+const size_t kPipelinedPrefetchThreads = 4;
+
+// Ops are handed to the prefetch threads in chunks of this many.
+const size_t kPipelinedPrefetchChunkOps = 64;
+
+// Ops scheduled for pipelined prefetch which have not been prefetched yet.
+AtomicInt64 pipelinedPrefetchOpsQueued;
+
 // page in pages needed for all index lookups on a given object
 void prefetchIndexPages(OperationContext* txn,
                         Collection* collection,
@@ -125,6 +163,7 @@ void prefetchRecordPages(OperationContext* txn, Database* db, const char* ns, co
         BSONObj result;
         try {
             if (Helpers::findById(txn, db, ns, builder.done(), result)) {
+                prefetchDocsFound.increment();
                 // do we want to use Record::touch() here?  it's pretty similar.
                 volatile char _dummy_char = '\0';
 
@@ -134,6 +173,8 @@ void prefetchRecordPages(OperationContext* txn, Database* db, const char* ns, co
                 }
                 // hit the last page, in case we missed it above
                 _dummy_char += *(result.objdata() + result.objsize() - 1);
+            } else {
+                prefetchDocsNotFound.increment();
             }
         } catch (const DBException& e) {
             LOG(2) << "ignoring exception in prefetchRecordPages(): " << e.what() << endl;
@@ -165,10 +206,10 @@ void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSO
     BSONObj obj = op.getObjectField(opField);
     const char* ns = op.getStringField("ns");
 
-    // This will have to change for engines other than MMAP V1, because they might not have
-    // means for directly prefetching pages from the collection. For this purpose, acquire S
-    // lock on the database, instead of optimizing with IS.
-    Lock::CollectionLock collLock(txn->lockState(), ns, MODE_S);
+    // MMAP V1 has means for directly prefetching pages from the collection, for which it acquires
+    // an S lock on the collection, instead of optimizing with IS. Other engines read through
+    // their cursors, for which IS is enough, and which does not hold up the writers' IX locks.
+    Lock::CollectionLock collLock(txn->lockState(), ns, supportsDocLocking() ? MODE_IS : MODE_S);
 
     Collection* collection = db->getCollection(ns);
     if (!collection) {
@@ -208,6 +249,73 @@ void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSO
     }
 }
 
+namespace {
+
+void prefetchOpsInBackground(const std::vector<BSONObj>& ops) {
+    if (!ClientBasic::getCurrent()) {
+        Client::initThreadIfNotAlready();
+        AuthorizationSession::get(cc())->grantInternalAuthorization();
+    }
+
+    OperationContextImpl txn;
+    // Get through the ParallelBatchWriterMode lock the applier holds while it applies the batches
+    // before these ops. Only intent locks are taken, which do not block the writers.
+    txn.lockState()->setIsBatchWriter(true);
+
+    for (auto&& op : ops) {
+        if (inShutdown()) {
+            break;
+        }
+        const char* ns = op.getStringField("ns");
+        if (!ns || ns[0] == '\0') {
+            continue;
+        }
+        try {
+            ScopedTransaction transaction(&txn, MODE_IS);
+            Lock::DBLock dbLock(txn.lockState(), nsToDatabaseSubstring(ns), MODE_IS);
+            Database* db = dbHolder().get(&txn, ns);
+            if (db) {
+                prefetchPagesForReplicatedOp(&txn, db, op);
+            }
+        } catch (const DBException& e) {
+            LOG(2) << "ignoring exception in prefetchOpsInBackground(): " << e.what();
+        }
+    }
+
+    pipelinedPrefetchOps.increment(ops.size());
+    pipelinedPrefetchOpsQueued.subtractAndFetch(ops.size());
+}
+
+WorkStealingThreadPool* getPipelinedPrefetchPool() {
+    // Never destroyed, so that prefetches still queued at shutdown do not hold up the exit.
+    static WorkStealingThreadPool* pool =
+        new WorkStealingThreadPool(kPipelinedPrefetchThreads, "repl prefetch pipeline ");
+    return pool;
+}
+
+}  // namespace
+
+void schedulePipelinedPrefetch(std::vector<BSONObj> ops) {
+    if (!replPipelinedPrefetch || ops.empty() || !supportsDocLocking() ||
+        BackgroundSync::get()->getIndexPrefetchConfig() == BackgroundSync::PREFETCH_NONE) {
+        return;
+    }
+
+    const long long numOps = ops.size();
+    if (pipelinedPrefetchOpsQueued.addAndFetch(numOps) > replPipelinedPrefetchMaxOps) {
+        pipelinedPrefetchOpsQueued.subtractAndFetch(numOps);
+        pipelinedPrefetchDroppedOps.increment(numOps);
+        return;
+    }
+
+    WorkStealingThreadPool* pool = getPipelinedPrefetchPool();
+    for (size_t start = 0; start < ops.size(); start += kPipelinedPrefetchChunkOps) {
+        const size_t end = std::min(ops.size(), start + kPipelinedPrefetchChunkOps);
+        std::vector<BSONObj> chunk(ops.begin() + start, ops.begin() + end);
+        pool->schedule([chunk]() { prefetchOpsInBackground(chunk); });
+    }
+}
+
 class ReplIndexPrefetch : public ServerParameter {
 public:
     ReplIndexPrefetch() : ServerParameter(ServerParameterSet::getGlobal(), "replIndexPrefetch") {}
@@ -27,6 +27,8 @@
 */
 #pragma once
 
+#include <vector>
+
 namespace mongo {
 class BSONObj;
 class Database;
@@ -35,5 +37,16 @@ namespace repl {
 
 // page in possible index and/or data pages for an op from the oplog
 void prefetchPagesForReplicatedOp(OperationContext* txn, Database* db, const BSONObj& op);
+
+/**
+ * Pages in, on a pool of background threads, the index and data pages the ops will touch, so that
+ * they are in memory by the time the applier gets to the ops. The fetcher calls this as it buffers
+ * each batch, which overlaps the prefetch with the application of the batches before it.
+ *
+ * Does nothing unless the storage engine supports document-level locking, where the intent locks
+ * the prefetch takes do not hold up the writers. Ops are dropped rather than queued when the
+ * prefetch threads are more than replPipelinedPrefetchMaxOps ops behind.
+ */
+void schedulePipelinedPrefetch(std::vector<BSONObj> ops);
 }  // namespace repl
 }  // namespace mongo
@@ -34,6 +34,7 @@
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/query/filter_template_cache.h"
 #include "mongo/db/query/query_planner_common.h"
 #include "mongo/util/log.h"
 
@@ -94,6 +95,39 @@ bool matchExpressionLessThan(const MatchExpression* lhs, const MatchExpression*
     return matchExpressionComparator(lhs, rhs) < 0;
 }
 
+/**
+ * Parses 'filter', or, if its shape is in the filter template cache, builds it from the template.
+ * The bool is true if the expression is already normalized and sorted.
+ */
+StatusWith<std::pair<std::unique_ptr<MatchExpression>, bool>> parseFilter(
+    const BSONObj& filter, const MatchExpressionParser::WhereCallback& whereCallback) {
+    if (auto me = FilterTemplateCache::instantiate(filter)) {
+        return std::make_pair(std::move(me), true);
+    }
+
+    StatusWithMatchExpression statusWithMatcher =
+        MatchExpressionParser::parse(filter, whereCallback);
+    if (!statusWithMatcher.isOK()) {
+        return statusWithMatcher.getStatus();
+    }
+    return std::make_pair(std::move(statusWithMatcher.getValue()), false);
+}
+
+/**
+ * Returns true if 'elt' is a value that the _id index can look up exactly.
+ */
+bool isSimpleIdValue(const BSONElement& elt) {
+    if (elt.type() == Object) {
+        // If the value is an object, it can't have a query operator
+        // (must be a literal object match).
+        return elt.Obj().firstElementFieldName()[0] != '$';
+    }
+
+    // The _id fild cannot be something like { _id : { $gt : ...
+    // But it can be BinData.
+    return elt.isSimpleType() || BinData == elt.type();
+}
+
 }  // namespace
 
 //
@@ -214,17 +248,17 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
     std::unique_ptr<LiteParsedQuery> autoLpq(lpq);
 
     // Make MatchExpression.
-    StatusWithMatchExpression statusWithMatcher =
-        MatchExpressionParser::parse(autoLpq->getFilter(), whereCallback);
+    auto statusWithMatcher = parseFilter(autoLpq->getFilter(), whereCallback);
     if (!statusWithMatcher.isOK()) {
         return statusWithMatcher.getStatus();
     }
-    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue());
+    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue().first);
+    const bool isCanonical = statusWithMatcher.getValue().second;
 
     // Make the CQ we'll hopefully return.
     std::unique_ptr<CanonicalQuery> cq(new CanonicalQuery());
 
-    Status initStatus = cq->init(autoLpq.release(), whereCallback, me.release());
+    Status initStatus = cq->init(autoLpq.release(), whereCallback, me.release(), isCanonical);
 
     if (!initStatus.isOK()) {
         return initStatus;
@@ -293,16 +327,16 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
     auto& lpq = lpqStatus.getValue();
 
     // Build a parse tree from the BSONObj in the parsed query.
-    StatusWithMatchExpression statusWithMatcher =
-        MatchExpressionParser::parse(lpq->getFilter(), whereCallback);
+    auto statusWithMatcher = parseFilter(lpq->getFilter(), whereCallback);
     if (!statusWithMatcher.isOK()) {
         return statusWithMatcher.getStatus();
     }
-    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue());
+    std::unique_ptr<MatchExpression> me = std::move(statusWithMatcher.getValue().first);
+    const bool isCanonical = statusWithMatcher.getValue().second;
 
     // Make the CQ we'll hopefully return.
     std::unique_ptr<CanonicalQuery> cq(new CanonicalQuery());
-    Status initStatus = cq->init(lpq.release(), whereCallback, me.release());
+    Status initStatus = cq->init(lpq.release(), whereCallback, me.release(), isCanonical);
 
     if (!initStatus.isOK()) {
         return initStatus;
@@ -312,13 +346,15 @@ StatusWith<std::unique_ptr<CanonicalQuery>> CanonicalQuery::canonicalize(
 
 Status CanonicalQuery::init(LiteParsedQuery* lpq,
                             const MatchExpressionParser::WhereCallback& whereCallback,
-                            MatchExpression* root) {
+                            MatchExpression* root,
+                            bool rootIsCanonical) {
     _pq.reset(lpq);
 
     // Normalize, sort and validate tree.
-    root = normalizeTree(root);
-
-    sortTree(root);
+    if (!rootIsCanonical) {
+        root = normalizeTree(root);
+        sortTree(root);
+    }
     _root.reset(root);
     Status validStatus = isValid(root, *_pq);
     if (!validStatus.isOK()) {
@@ -354,15 +390,7 @@ bool CanonicalQuery::isSimpleIdQuery(const BSONObj& query) {
             // Verify that the query on _id is a simple equality.
             hasID = true;
 
-            if (elt.type() == Object) {
-                // If the value is an object, it can't have a query operator
-                // (must be a literal object match).
-                if (elt.Obj().firstElementFieldName()[0] == '$') {
-                    return false;
-                }
-            } else if (!elt.isSimpleType() && BinData != elt.type()) {
-                // The _id fild cannot be something like { _id : { $gt : ...
-                // But it can be BinData.
+            if (!isSimpleIdValue(elt)) {
                 return false;
             }
         } else if (elt.fieldName()[0] == '$' && (str::equals("$isolated", elt.fieldName()) ||
@@ -377,6 +405,40 @@ bool CanonicalQuery::isSimpleIdQuery(const BSONObj& query) {
     return hasID;
 }
 
+// static
+bool CanonicalQuery::isSimpleIdInQuery(const BSONObj& query) {
+    bool hasIn = false;
+
+    BSONObjIterator it(query);
+    while (it.more()) {
+        BSONElement elt = it.next();
+        if (str::equals("_id", elt.fieldName())) {
+            // The value must be exactly {$in: [...]}.
+            if (elt.type() != Object || elt.Obj().nFields() != 1) {
+                return false;
+            }
+            BSONElement in = elt.Obj().firstElement();
+            if (!str::equals("$in", in.fieldName()) || in.type() != Array) {
+                return false;
+            }
+
+            BSONForEach(value, in.Obj()) {
+                if (!isSimpleIdValue(value)) {
+                    return false;
+                }
+            }
+            hasIn = true;
+        } else if (elt.fieldName()[0] == '$' && (str::equals("$isolated", elt.fieldName()) ||
+                                                 str::equals("$atomic", elt.fieldName()))) {
+            // ok, passthrough
+        } else {
+            return false;
+        }
+    }
+
+    return hasIn;
+}
+
 // static
 MatchExpression* CanonicalQuery::normalizeTree(MatchExpression* root) {
     // root->isLogical() is true now.  We care about AND, OR, and NOT. NOR currently scares us.
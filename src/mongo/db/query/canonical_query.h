@@ -152,6 +152,13 @@ public:
      */
     static bool isSimpleIdQuery(const BSONObj& query);
 
+    /**
+     * Returns true if 'query' is {_id: {$in: [...]}}, optionally with $isolated or $atomic,
+     * and every value in the $in would be accepted as a simple _id equality by
+     * isSimpleIdQuery().
+     */
+    static bool isSimpleIdInQuery(const BSONObj& query);
+
     const NamespaceString& nss() const {
         return _pq->nss();
     }
@@ -214,10 +221,13 @@ private:
 
     /**
      * Takes ownership of 'root' and 'lpq'.
+     *
+     * Normalizes and sorts 'root' unless 'rootIsCanonical', which means it already was.
      */
     Status init(LiteParsedQuery* lpq,
                 const MatchExpressionParser::WhereCallback& whereCallback,
-                MatchExpression* root);
+                MatchExpression* root,
+                bool rootIsCanonical = false);
 
     std::unique_ptr<LiteParsedQuery> _pq;
 
@@ -30,6 +30,7 @@
 
 #include "mongo/db/json.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/db/query/filter_template_cache.h"
 #include "mongo/unittest/unittest.h"
 
 namespace mongo {
@@ -531,6 +532,41 @@ TEST(CanonicalQueryTest, NormalizeQueryTree) {
                        "{$and: [{a: 1}, {b: 1}, {c: 1}]}");
 }
 
+/**
+ * Canonicalizes two filters of the same shape, so that the second is built from the template the
+ * first one left in the filter template cache, and checks both against a plain parse.
+ */
+void testFilterTemplate(const char* firstStr, const char* secondStr) {
+    FilterTemplateCache::clearForTest();
+    for (const char* queryStr : {firstStr, secondStr}) {
+        unique_ptr<CanonicalQuery> cq(canonicalize(queryStr));
+        unique_ptr<MatchExpression> expected(
+            CanonicalQuery::normalizeTree(parseMatchExpression(fromjson(queryStr))));
+        CanonicalQuery::sortTree(expected.get());
+        ASSERT_EQUALS(expected->toString(), cq->root()->toString());
+        assertEquivalent(queryStr, expected.get(), cq->root());
+    }
+}
+
+TEST(CanonicalQueryTest, FilterTemplateMatchesParsedFilter) {
+    testFilterTemplate("{a: 1}", "{a: 2}");
+    testFilterTemplate("{b: 'x', a: {$gt: 1, $lte: 5}}", "{b: 'y', a: {$gt: 7, $lte: 9}}");
+    testFilterTemplate("{z: null, y: {$eq: true}, x: 1.5}", "{z: null, y: {$eq: false}, x: 2.5}");
+    // Not handled by templates, so parsed as usual.
+    testFilterTemplate("{a: {$in: [1, 2]}}", "{a: {$in: [3]}}");
+    testFilterTemplate("{$or: [{a: 1}, {b: 1}]}", "{$or: [{a: 2}, {b: 2}]}");
+}
+
+TEST(CanonicalQueryTest, FilterTemplateOnlyAppliesToTheSameShape) {
+    FilterTemplateCache::clearForTest();
+    canonicalize("{a: 1, b: 1}");
+    // Same fields but different literal types, so a different shape.
+    unique_ptr<CanonicalQuery> cq(canonicalize("{a: 'x', b: {$lt: 2}}"));
+    ASSERT_EQUALS(MatchExpression::AND, cq->root()->matchType());
+    ASSERT_EQUALS(MatchExpression::EQ, cq->root()->getChild(0)->matchType());
+    ASSERT_EQUALS(MatchExpression::LT, cq->root()->getChild(1)->matchType());
+}
+
 TEST(CanonicalQueryTest, CanonicalizeFromBaseQuery) {
     const bool isExplain = true;
     const std::string cmdStr =
@@ -0,0 +1,226 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/collection_sample.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/index/index_access_method.h"
+#include "mongo/db/index/index_descriptor.h"
+#include "mongo/db/index_names.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/index_bounds.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// Stop sampling once the sampled documents take up this many bytes, however few there are.
+const size_t kMaxSampleBytes = 4 * 1024 * 1024;
+
+// A sample is taken again once the collection's size differs from its size when the sample was
+// taken by more than this fraction, or once the sample is this old.
+const double kMaxSizeChange = 0.1;
+const Minutes kMaxSampleAge(10);
+
+/**
+ * Returns the index scan that 'node' reads from if the plan rooted at 'node' is a single index
+ * scan with only pass-through stages above it, or NULL otherwise.
+ */
+IndexScanNode* soleIndexScan(QuerySolutionNode* node) {
+    switch (node->getType()) {
+        case STAGE_IXSCAN:
+            return static_cast<IndexScanNode*>(node);
+        case STAGE_FETCH:
+        case STAGE_KEEP_MUTATIONS:
+        case STAGE_LIMIT:
+        case STAGE_PROJECTION:
+        case STAGE_SHARDING_FILTER:
+        case STAGE_SKIP:
+            return node->children.size() == 1 ? soleIndexScan(node->children[0]) : NULL;
+        default:
+            return NULL;
+    }
+}
+
+}  // namespace
+
+CollectionSample::CollectionSample(long long numRecords, Date_t takenAt)
+    : _numRecords(numRecords), _takenAt(takenAt) {}
+
+// static
+std::shared_ptr<const CollectionSample> CollectionSample::make(OperationContext* txn,
+                                                               const Collection* collection,
+                                                               size_t sampleSize) {
+    const long long numRecords = collection->numRecords(txn);
+    if (sampleSize == 0 || numRecords < static_cast<long long>(sampleSize)) {
+        // Racing the candidate plans is cheap on a collection this small.
+        return {};
+    }
+
+    std::unique_ptr<RecordCursor> cursor = collection->getRecordStore()->getRandomCursor(txn);
+    if (!cursor) {
+        return {};
+    }
+
+    std::shared_ptr<CollectionSample> sample(new CollectionSample(numRecords, Date_t::now()));
+    size_t sampleBytes = 0;
+    try {
+        while (sample->_docs.size() < sampleSize && sampleBytes < kMaxSampleBytes) {
+            boost::optional<Record> record = cursor->next();
+            if (!record) {
+                break;
+            }
+            sampleBytes += record->data.size();
+            sample->_docs.push_back(record->data.releaseToBson().getOwned());
+        }
+    } catch (const WriteConflictException& wce) {
+        return {};
+    }
+
+    if (sample->_docs.empty()) {
+        return {};
+    }
+    return std::move(sample);
+}
+
+bool CollectionSample::isStale(long long numRecords, Date_t now) const {
+    return std::abs(numRecords - _numRecords) > kMaxSizeChange * _numRecords ||
+        now - _takenAt > kMaxSampleAge;
+}
+
+bool CollectionSample::estimateKeysExamined(OperationContext* txn,
+                                            Collection* collection,
+                                            const IndexScanNode& node,
+                                            double* estimateOut) const {
+    // Simple ranges come from min() and max(), which are hinted anyway. Special index types
+    // generate keys which the bounds checker cannot interpret.
+    if (node.bounds.isSimpleRange || !IndexNames::findPluginName(node.indexKeyPattern).empty()) {
+        return false;
+    }
+
+    IndexCatalog* catalog = collection->getIndexCatalog();
+    const IndexDescriptor* descriptor = catalog->findIndexByKeyPattern(txn, node.indexKeyPattern);
+    if (!descriptor) {
+        return false;
+    }
+
+    const IndexAccessMethod* iam = catalog->getIndex(descriptor);
+    const MatchExpression* partialFilter = catalog->getEntry(descriptor)->getFilterExpression();
+
+    IndexBoundsChecker checker(&node.bounds, node.indexKeyPattern, node.direction);
+    size_t keysInBounds = 0;
+    for (const BSONObj& doc : _docs) {
+        if (partialFilter && !partialFilter->matchesBSON(doc)) {
+            continue;
+        }
+
+        BSONObjSet keys;
+        iam->getKeys(doc, &keys);
+        for (const BSONObj& key : keys) {
+            if (checker.isValidKey(key)) {
+                ++keysInBounds;
+            }
+        }
+    }
+
+    *estimateOut = keysInBounds * keysPerSampledKey();
+    return true;
+}
+
+double CollectionSample::estimateMatching(const MatchExpression& expr) const {
+    size_t nMatching = 0;
+    for (const BSONObj& doc : _docs) {
+        if (expr.matchesBSON(doc)) {
+            ++nMatching;
+        }
+    }
+    return nMatching * keysPerSampledKey();
+}
+
+void pruneSolutionsBySample(OperationContext* txn,
+                            Collection* collection,
+                            const CanonicalQuery& query,
+                            std::vector<QuerySolution*>* solutions) {
+    const double ratio = internalQueryPlanSamplePruningRatio;
+    if (ratio <= 0 || solutions->size() < 2 || !query.getParsed().getSort().isEmpty()) {
+        return;
+    }
+
+    std::shared_ptr<const CollectionSample> sample = collection->infoCache()->getSample(txn);
+    if (!sample) {
+        return;
+    }
+
+    std::vector<double> estimates(solutions->size(), -1);
+    double bestEstimate = -1;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        IndexScanNode* ixn = soleIndexScan((*solutions)[i]->root.get());
+        if (ixn && sample->estimateKeysExamined(txn, collection, *ixn, &estimates[i])) {
+            ixn->estimatedKeysExamined = estimates[i];
+            if (bestEstimate < 0 || estimates[i] < bestEstimate) {
+                bestEstimate = estimates[i];
+            }
+        }
+    }
+
+    if (bestEstimate < 0) {
+        return;
+    }
+
+    // Allow for a plan whose keys the sample missed entirely by treating the best estimate as at
+    // least one sampled key.
+    const double threshold = ratio * (bestEstimate + sample->keysPerSampledKey());
+
+    std::vector<QuerySolution*> kept;
+    for (size_t i = 0; i < solutions->size(); ++i) {
+        if (estimates[i] > threshold) {
+            LOG(2) << "Pruning candidate plan estimated to examine " << estimates[i]
+                   << " keys, against a best estimate of " << bestEstimate << " keys, for query "
+                   << query.toStringShort();
+            delete (*solutions)[i];
+        } else {
+            kept.push_back((*solutions)[i]);
+        }
+    }
+    solutions->swap(kept);
+}
+
+}  // namespace mongo
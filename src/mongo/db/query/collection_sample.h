@@ -0,0 +1,122 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class Collection;
+class OperationContext;
+struct IndexScanNode;
+class MatchExpression;
+class QuerySolution;
+
+/**
+ * A random sample of the documents in a collection, used to estimate how many index keys a
+ * candidate plan will examine before any plan is run.
+ *
+ * Samples are cached per collection by CollectionInfoCache and are immutable once taken, so a
+ * sample may be shared between concurrent operations.
+ */
+class CollectionSample {
+    MONGO_DISALLOW_COPYING(CollectionSample);
+
+public:
+    /**
+     * Takes a sample of up to 'sampleSize' documents from 'collection'. Returns null if the
+     * collection is too small for a sample to be useful or its storage engine cannot return
+     * records in random order.
+     */
+    static std::shared_ptr<const CollectionSample> make(OperationContext* txn,
+                                                        const Collection* collection,
+                                                        size_t sampleSize);
+
+    /**
+     * Returns true if the collection has changed size enough since this sample was taken, or the
+     * sample is old enough, that it should be taken again.
+     */
+    bool isStale(long long numRecords, Date_t now) const;
+
+    /**
+     * Estimates how many keys 'node' will examine in 'collection', by generating the index keys
+     * of every sampled document and checking them against the scan's bounds. Returns false if no
+     * estimate can be made for this kind of scan.
+     */
+    bool estimateKeysExamined(OperationContext* txn,
+                              Collection* collection,
+                              const IndexScanNode& node,
+                              double* estimateOut) const;
+
+    /**
+     * Estimates how many documents in the collection match 'expr' from the number of sampled
+     * documents which match it.
+     */
+    double estimateMatching(const MatchExpression& expr) const;
+
+    /**
+     * The number of keys in the collection that each key in the sample stands for.
+     */
+    double keysPerSampledKey() const {
+        return static_cast<double>(_numRecords) / _docs.size();
+    }
+
+    size_t size() const {
+        return _docs.size();
+    }
+
+private:
+    CollectionSample(long long numRecords, Date_t takenAt);
+
+    const long long _numRecords;
+    const Date_t _takenAt;
+    std::vector<BSONObj> _docs;
+};
+
+/**
+ * Estimates the keys examined by each of 'solutions' that scans a single index and records the
+ * estimate on its IndexScanNode, so that explain can report it. Candidates whose estimate is more
+ * than internalQueryPlanSamplePruningRatio times the best estimate are deleted and removed from
+ * 'solutions' before the plans are raced. Candidates which cannot be estimated are kept.
+ *
+ * Does nothing unless internalQueryPlanSamplePruningRatio is positive, or if 'query' is sorted,
+ * since a plan which examines more keys may still win by providing the sort.
+ */
+void pruneSolutionsBySample(OperationContext* txn,
+                            Collection* collection,
+                            const CanonicalQuery& query,
+                            std::vector<QuerySolution*>* solutions);
+
+}  // namespace mongo
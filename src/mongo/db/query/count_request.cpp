@@ -40,6 +40,7 @@ const char kQueryField[] = "query";
 const char kLimitField[] = "limit";
 const char kSkipField[] = "skip";
 const char kHintField[] = "hint";
+const char kApproximateField[] = "approximate";
 
 }  // namespace
 
@@ -68,6 +69,10 @@ BSONObj CountRequest::toBSON() const {
         builder.append(kHintField, _hint.get());
     }
 
+    if (_approximate) {
+        builder.append(kApproximateField, _approximate.get());
+    }
+
     return builder.obj();
 }
 
@@ -118,6 +123,13 @@ StatusWith<CountRequest> CountRequest::parseFromBSON(const std::string& dbname,
         request.setHint(BSON("$hint" << hint));
     }
 
+    // Approximate
+    if (cmdObj[kApproximateField].isBoolean()) {
+        request.setApproximate(cmdObj[kApproximateField].boolean());
+    } else if (cmdObj[kApproximateField].ok()) {
+        return Status(ErrorCodes::BadValue, "approximate value is not a boolean");
+    }
+
     return request;
 }
 
@@ -80,6 +80,14 @@ public:
 
     void setHint(BSONObj hint);
 
+    bool getApproximate() const {
+        return _approximate.value_or(false);
+    }
+
+    void setApproximate(bool approximate) {
+        _approximate = approximate;
+    }
+
     /**
      * Constructs a BSON representation of this request, which can be used for sending it in
      * commands.
@@ -107,6 +115,10 @@ private:
     // Optional. Indicates to the query planner that it should generate a count plan using a
     // particular index.
     boost::optional<BSONObj> _hint;
+
+    // Optional. Allows the count to be estimated from a sample of the collection instead of
+    // examining every matching document.
+    boost::optional<bool> _approximate;
 };
 
 }  // namespace mongo
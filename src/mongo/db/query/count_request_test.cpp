@@ -75,6 +75,28 @@ TEST(CountRequest, ParseComplete) {
     ASSERT_EQUALS(countRequest.getHint(), fromjson("{ b : 5 }"));
 }
 
+TEST(CountRequest, ParseApproximate) {
+    const auto countRequestStatus =
+        CountRequest::parseFromBSON("TestDB",
+                                    BSON("count"
+                                         << "TestColl"
+                                         << "query" << BSON("a" << 1) << "approximate" << true));
+
+    ASSERT_OK(countRequestStatus.getStatus());
+    ASSERT_TRUE(countRequestStatus.getValue().getApproximate());
+    ASSERT_EQUALS(countRequestStatus.getValue().toBSON()["approximate"].Bool(), true);
+}
+
+TEST(CountRequest, FailParseBadApproximateValue) {
+    const auto countRequestStatus =
+        CountRequest::parseFromBSON("TestDB",
+                                    BSON("count"
+                                         << "TestColl"
+                                         << "query" << BSON("a" << 1) << "approximate" << 1));
+
+    ASSERT_EQUALS(countRequestStatus.getStatus(), ErrorCodes::BadValue);
+}
+
 TEST(CountRequest, ParseNegativeLimit) {
     const auto countRequestStatus =
         CountRequest::parseFromBSON("TestDB",
@@ -0,0 +1,172 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kQuery
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/cursor_prefetch.h"
+
+#include <map>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/cursor_manager.h"
+#include "mongo/db/client.h"
+#include "mongo/db/clientcursor.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/find.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/s/operation_shard_version.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
+
+namespace mongo {
+namespace {
+
+// Bytes of results to read ahead on each idle cursor. Zero disables cursor prefetch.
+MONGO_EXPORT_SERVER_PARAMETER(cursorPrefetchBytes, int, 0);
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(cursorPrefetchThreads, int, 4);
+
+stdx::mutex prefetchMutex;
+stdx::condition_variable prefetchFinished;
+
+// Cursors with a read-ahead scheduled, mapped to whether it has begun.
+std::map<CursorId, bool> prefetches;
+
+ThreadPool* getPrefetchPool() {
+    static ThreadPool* pool = [] {
+        ThreadPool::Options options;
+        options.poolName = "CursorPrefetchPool";
+        options.threadNamePrefix = "CursorPrefetch";
+        options.maxThreads = std::max(1, static_cast<int>(cursorPrefetchThreads));
+        auto pool = new ThreadPool(options);
+        pool->startup();
+        return pool;
+    }();
+    return pool;
+}
+
+void finishPrefetch(CursorId cursorId) {
+    stdx::lock_guard<stdx::mutex> lk(prefetchMutex);
+    prefetches.erase(cursorId);
+    prefetchFinished.notify_all();
+}
+
+void readAhead(const NamespaceString& nss, CursorId cursorId) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(prefetchMutex);
+        auto it = prefetches.find(cursorId);
+        if (it == prefetches.end() || it->second) {
+            // Canceled by a getMore, or already begun by an earlier task for this cursor.
+            return;
+        }
+        it->second = true;
+    }
+    ON_BLOCK_EXIT(finishPrefetch, cursorId);
+
+    OperationContextImpl txn;
+    OperationShardVersion::get(&txn).setShardVersion(nss, ChunkVersion::IGNORED());
+    try {
+        AutoGetCollectionForRead ctx(&txn, nss);
+        Collection* collection = ctx.getCollection();
+        if (!collection) {
+            return;
+        }
+
+        ClientCursorPin ccPin(collection->getCursorManager(), cursorId);
+        ClientCursor* cursor = ccPin.c();
+        if (!cursor) {
+            return;
+        }
+
+        // A read-ahead which throws leaves the cursor unusable, as a getMore which throws does.
+        ScopeGuard cursorFreer = MakeGuard(&ClientCursorPin::deleteUnderlying, &ccPin);
+
+        PlanExecutor* exec = cursor->getExecutor();
+        exec->reattachToOperationContext(&txn);
+        exec->restoreState();
+        PlanExecutor::ExecState state = exec->readAhead(cursorPrefetchBytes);
+        exec->saveState();
+        exec->detachFromOperationContext();
+        cursorFreer.Dismiss();
+
+        LOG(3) << "read ahead on cursor " << cursorId << " over " << nss
+               << ", state: " << PlanExecutor::statestr(state);
+    } catch (const DBException& ex) {
+        LOG(1) << "read ahead on cursor " << cursorId << " over " << nss
+               << " failed: " << ex.toString();
+    }
+}
+
+}  // namespace
+
+bool isCursorPrefetchEligible(const NamespaceString& nss, const ClientCursor* cursor) {
+    return cursorPrefetchBytes > 0 && !nss.isListIndexesCursorNS() &&
+        !nss.isListCollectionsCursorNS() && !cursor->isAggCursor() &&
+        !cursor->isReadCommitted() && !isCursorTailable(cursor);
+}
+
+void scheduleCursorPrefetch(const NamespaceString& nss, CursorId cursorId) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(prefetchMutex);
+        if (!prefetches.emplace(cursorId, false).second) {
+            return;
+        }
+    }
+
+    Status scheduled = getPrefetchPool()->schedule([nss, cursorId] {
+        Client::initThreadIfNotAlready("CursorPrefetch");
+        readAhead(nss, cursorId);
+    });
+    if (!scheduled.isOK()) {
+        finishPrefetch(cursorId);
+    }
+}
+
+void waitForCursorPrefetch(CursorId cursorId) {
+    stdx::unique_lock<stdx::mutex> lk(prefetchMutex);
+    auto it = prefetches.find(cursorId);
+    if (it == prefetches.end()) {
+        return;
+    }
+    if (!it->second) {
+        prefetches.erase(it);
+        return;
+    }
+    prefetchFinished.wait(lk, [cursorId] { return prefetches.count(cursorId) == 0; });
+}
+
+}  // namespace mongo
@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/db/cursor_id.h"
+
+namespace mongo {
+
+class ClientCursor;
+class NamespaceString;
+
+/**
+ * Cursor prefetch computes the next batch of an idle cursor in the background, so that the
+ * getMore which asks for it returns without running the query. It is enabled by setting the
+ * cursorPrefetchBytes server parameter to the number of bytes of results to read ahead per
+ * cursor.
+ *
+ * The read-ahead pins the cursor and runs its plan with its usual yield policy, stashing the
+ * results in the PlanExecutor. Prefetched results are like those of a larger batch: they can
+ * reflect a document as it was when read ahead rather than when returned.
+ */
+
+/**
+ * Returns true if prefetch is enabled and 'cursor', registered for 'nss', may be read ahead.
+ * Tailable, aggregation, read-committed and catalog cursors are never prefetched.
+ */
+bool isCursorPrefetchEligible(const NamespaceString& nss, const ClientCursor* cursor);
+
+/**
+ * Schedules a read-ahead of cursor 'cursorId' on 'nss'. The caller must have released its pin
+ * on the cursor, and the cursor must be eligible for prefetch.
+ */
+void scheduleCursorPrefetch(const NamespaceString& nss, CursorId cursorId);
+
+/**
+ * Waits for a running read-ahead of 'cursorId' to finish, and cancels one which has not begun.
+ * Must be called by a getMore before it takes any locks, as the read-ahead holds the cursor's
+ * pin and collection lock.
+ */
+void waitForCursorPrefetch(CursorId cursorId);
+
+}  // namespace mongo
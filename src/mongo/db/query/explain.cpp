@@ -111,7 +111,7 @@ size_t getKeysExamined(StageType type, const SpecificStats* specific) {
     if (STAGE_IXSCAN == type) {
         const IndexScanStats* spec = static_cast<const IndexScanStats*>(specific);
         return spec->keysExamined;
-    } else if (STAGE_IDHACK == type) {
+    } else if (STAGE_IDHACK == type || STAGE_MULTI_IDHACK == type) {
         const IDHackStats* spec = static_cast<const IDHackStats*>(specific);
         return spec->keysExamined;
     } else if (STAGE_COUNT_SCAN == type) {
@@ -141,7 +141,7 @@ size_t getDocsExamined(StageType type, const SpecificStats* specific) {
     } else if (STAGE_FETCH == type) {
         const FetchStats* spec = static_cast<const FetchStats*>(specific);
         return spec->docsExamined;
-    } else if (STAGE_IDHACK == type) {
+    } else if (STAGE_IDHACK == type || STAGE_MULTI_IDHACK == type) {
         const IDHackStats* spec = static_cast<const IDHackStats*>(specific);
         return spec->docsExamined;
     } else if (STAGE_TEXT_OR == type) {
@@ -262,6 +262,9 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("nCounted", spec->nCounted);
             bob->appendNumber("nSkipped", spec->nSkipped);
+            if (spec->approximate) {
+                bob->appendBool("approximate", true);
+            }
         }
     } else if (STAGE_COUNT_SCAN == stats.stageType) {
         CountScanStats* spec = static_cast<CountScanStats*>(stats.specific.get());
@@ -336,7 +339,7 @@ void Explain::statsToBSON(const PlanStageStats& stats,
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("nGroups", spec->nGroups);
         }
-    } else if (STAGE_IDHACK == stats.stageType) {
+    } else if (STAGE_IDHACK == stats.stageType || STAGE_MULTI_IDHACK == stats.stageType) {
         IDHackStats* spec = static_cast<IDHackStats*>(stats.specific.get());
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("keysExamined", spec->keysExamined);
@@ -360,6 +363,10 @@ void Explain::statsToBSON(const PlanStageStats& stats,
             bob->append("indexBounds", spec->indexBounds);
         }
 
+        if (spec->estimatedKeysExamined >= 0) {
+            bob->append("estimatedKeysExamined", spec->estimatedKeysExamined);
+        }
+
         if (verbosity >= ExplainCommon::EXEC_STATS) {
             bob->appendNumber("keysExamined", spec->keysExamined);
             bob->appendNumber("dupsTested", spec->dupsTested);
@@ -724,7 +731,8 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
         statsOut->totalDocsExamined +=
             getDocsExamined(stages[i]->stageType(), stages[i]->getSpecificStats());
 
-        if (STAGE_IDHACK == stages[i]->stageType()) {
+        if (STAGE_IDHACK == stages[i]->stageType() ||
+            STAGE_MULTI_IDHACK == stages[i]->stageType()) {
             statsOut->isIdhack = true;
         }
         if (STAGE_SORT == stages[i]->stageType()) {
@@ -741,10 +749,10 @@ void Explain::getSummaryStats(const PlanExecutor& exec, PlanSummaryStats* statsO
             const CountScanStats* countScanStats =
                 static_cast<const CountScanStats*>(countScan->getSpecificStats());
             statsOut->indexesUsed.insert(countScanStats->indexName);
-        } else if (STAGE_IDHACK == stages[i]->stageType()) {
-            const IDHackStage* idHackStage = static_cast<const IDHackStage*>(stages[i]);
+        } else if (STAGE_IDHACK == stages[i]->stageType() ||
+                   STAGE_MULTI_IDHACK == stages[i]->stageType()) {
             const IDHackStats* idHackStats =
-                static_cast<const IDHackStats*>(idHackStage->getSpecificStats());
+                static_cast<const IDHackStats*>(stages[i]->getSpecificStats());
             statsOut->indexesUsed.insert(idHackStats->indexName);
         } else if (STAGE_DISTINCT_SCAN == stages[i]->stageType()) {
             const DistinctScan* distinctScan = static_cast<const DistinctScan*>(stages[i]);
@@ -36,6 +36,8 @@
 #include "mongo/db/index/expression_params.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/query/expression_index_knobs.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/stdx/mutex.h"
 #include "third_party/s2/s2cellid.h"
 #include "third_party/s2/s2region.h"
 #include "third_party/s2/s2regioncoverer.h"
@@ -135,6 +137,60 @@ void ExpressionMapping::cover2dsphere(const S2Region& region,
     S2CellIdsToIntervalsWithParents(cover, indexingParams, oilOut);
 }
 
+namespace {
+typedef LRUKeyValue<std::string, OrderedIntervalList> CoveringCache;
+
+stdx::mutex coveringCacheMutex;
+
+CoveringCache* getCoveringCache() {
+    static CoveringCache* cache = new CoveringCache(internalQueryS2GeoCoveringCacheSize);
+    return cache;
+}
+
+/**
+ * The bounds of a geometry depend on the covering knobs in effect and on the parameters of the
+ * index, so they are all part of the key along with the geometry itself.
+ */
+std::string coveringCacheKey(const BSONObj& geometry, const S2IndexingParams& indexingParams) {
+    const int params[] = {internalQueryS2GeoCoarsestLevel,
+                          internalQueryS2GeoFinestLevel,
+                          internalQueryS2GeoMaxCells,
+                          indexingParams.coarsestIndexedLevel,
+                          static_cast<int>(indexingParams.indexVersion)};
+    std::string key(reinterpret_cast<const char*>(params), sizeof(params));
+    key.append(geometry.objdata(), geometry.objsize());
+    return key;
+}
+}  // namespace
+
+void ExpressionMapping::cover2dsphereCached(const BSONObj& geometry,
+                                            const S2Region& region,
+                                            const S2IndexingParams& indexingParams,
+                                            OrderedIntervalList* oilOut) {
+    if (internalQueryS2GeoCoveringCacheSize <= 0 || geometry.objsize() > kMaxCachedGeometryBytes) {
+        cover2dsphere(region, indexingParams, oilOut);
+        return;
+    }
+
+    const std::string key = coveringCacheKey(geometry, indexingParams);
+    {
+        stdx::lock_guard<stdx::mutex> lock(coveringCacheMutex);
+        OrderedIntervalList* cached;
+        if (getCoveringCache()->get(key, &cached).isOK()) {
+            oilOut->intervals = cached->intervals;
+            return;
+        }
+    }
+
+    // Cover outside of the lock, a large region can take a while.
+    std::unique_ptr<OrderedIntervalList> computed(new OrderedIntervalList(oilOut->name));
+    cover2dsphere(region, indexingParams, computed.get());
+    oilOut->intervals = computed->intervals;
+
+    stdx::lock_guard<stdx::mutex> lock(coveringCacheMutex);
+    getCoveringCache()->add(key, computed.release());
+}
+
 namespace {
 bool compareIntervals(const Interval& a, const Interval& b) {
     return a.precedes(b);
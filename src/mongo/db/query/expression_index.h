@@ -77,6 +77,18 @@ public:
     static void cover2dsphere(const S2Region& region,
                               const S2IndexingParams& indexParams,
                               OrderedIntervalList* oilOut);
+
+    /**
+     * Like cover2dsphere, but looks the bounds up in a process-wide cache keyed by 'geometry',
+     * the BSON the region was parsed from, before computing them. Geometries larger than
+     * kMaxCachedGeometryBytes are always covered from scratch.
+     */
+    static void cover2dsphereCached(const BSONObj& geometry,
+                                    const S2Region& region,
+                                    const S2IndexingParams& indexParams,
+                                    OrderedIntervalList* oilOut);
+
+    static const int kMaxCachedGeometryBytes = 16 * 1024;
 };
 
 }  // namespace mongo
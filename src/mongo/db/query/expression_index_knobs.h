@@ -57,4 +57,8 @@ extern int internalQueryS2GeoCoarsestLevel;
 // What is the maximum cell count that we want? (advisory, not a hard threshold)
 extern int internalQueryS2GeoMaxCells;
 
+// How many 2dsphere index bounds computed for geo predicates do we keep around, so that queries
+// repeating a geometry on the same kind of index do not compute its covering again? 0 disables.
+extern int internalQueryS2GeoCoveringCacheSize;
+
 }  // namespace mongo
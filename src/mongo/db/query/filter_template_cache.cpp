@@ -0,0 +1,291 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/filter_template_cache.h"
+
+#include <algorithm>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "mongo/db/matcher/expression_leaf.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/matcher/expression_tree.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+// One comparison of a canonicalized filter, and which of the filter's literals it compares with.
+struct TemplateLeaf {
+    MatchExpression::MatchType matchType;
+    std::string path;
+    size_t literal;
+};
+
+// How a filter of one shape canonicalizes: its comparisons in sorted order, under an AND if there
+// is more than one. No leaves means the shape canonicalizes to something else, and is parsed as
+// usual.
+struct FilterTemplate {
+    std::vector<TemplateLeaf> leaves;
+};
+
+// The shapes are spread over several independently locked maps, so that queries of different
+// shapes do not contend.
+const size_t kNumPartitions = 16;
+
+struct Partition {
+    stdx::mutex mutex;
+    std::unordered_map<std::string, std::shared_ptr<const FilterTemplate>> templates;
+};
+
+Partition partitions[kNumPartitions];
+AtomicWord<long long> numShapes(0);
+
+bool isTemplateLiteral(BSONType type) {
+    switch (type) {
+        case NumberDouble:
+        case NumberInt:
+        case NumberLong:
+        case NumberDecimal:
+        case String:
+        case Bool:
+        case Date:
+        case jstOID:
+        case jstNULL:
+        case bsonTimestamp:
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool isTemplateOperator(const char* op) {
+    return str::equals(op, "$eq") || str::equals(op, "$lt") || str::equals(op, "$lte") ||
+        str::equals(op, "$gt") || str::equals(op, "$gte");
+}
+
+bool isTemplateMatchType(MatchExpression::MatchType matchType) {
+    switch (matchType) {
+        case MatchExpression::EQ:
+        case MatchExpression::LT:
+        case MatchExpression::LTE:
+        case MatchExpression::GT:
+        case MatchExpression::GTE:
+            return true;
+        default:
+            return false;
+    }
+}
+
+/**
+ * Appends the shape of 'filter' to 'shape' and its literals, in order, to 'literals'. Returns
+ * false if 'filter' is not of a shape templates handle.
+ *
+ * A field name is followed by a NUL, then by either the type of its value, or by '{', an operator
+ * and the type of its argument for each operator, and '}'. Types are single bytes that are never
+ * '{', so the encoding is unambiguous.
+ */
+bool computeShape(const BSONObj& filter, std::string* shape, std::vector<BSONElement>* literals) {
+    BSONObjIterator it(filter);
+    while (it.more()) {
+        const BSONElement e = it.next();
+        const StringData name = e.fieldNameStringData();
+        if (name.empty() || name[0] == '$') {
+            return false;
+        }
+        shape->append(name.rawData(), name.size());
+        shape->push_back('\0');
+
+        if (e.type() != Object) {
+            if (!isTemplateLiteral(e.type())) {
+                return false;
+            }
+            shape->push_back(static_cast<char>(e.type()));
+            literals->push_back(e);
+            continue;
+        }
+
+        BSONObjIterator ops(e.embeddedObject());
+        if (!ops.more()) {
+            return false;
+        }
+        shape->push_back('{');
+        while (ops.more()) {
+            const BSONElement op = ops.next();
+            if (!isTemplateOperator(op.fieldName()) || !isTemplateLiteral(op.type())) {
+                return false;
+            }
+            shape->append(op.fieldName());
+            shape->push_back(static_cast<char>(op.type()));
+            literals->push_back(op);
+        }
+        shape->push_back('}');
+    }
+    return !literals->empty();
+}
+
+/**
+ * Learns the template of a shape from 'root', the canonicalized form of a filter of that shape
+ * whose literals are 'literals'.
+ */
+std::shared_ptr<const FilterTemplate> makeTemplate(const MatchExpression* root,
+                                                   const std::vector<BSONElement>& literals) {
+    auto noTemplate = std::make_shared<const FilterTemplate>();
+
+    std::vector<const MatchExpression*> leaves;
+    if (MatchExpression::AND == root->matchType()) {
+        for (size_t i = 0; i < root->numChildren(); ++i) {
+            leaves.push_back(root->getChild(i));
+        }
+    } else {
+        leaves.push_back(root);
+    }
+    if (leaves.size() != literals.size()) {
+        return noTemplate;
+    }
+
+    auto tmpl = std::make_shared<FilterTemplate>();
+    for (const MatchExpression* leaf : leaves) {
+        if (!isTemplateMatchType(leaf->matchType())) {
+            return noTemplate;
+        }
+        const BSONElement& data = static_cast<const ComparisonMatchExpression*>(leaf)->getData();
+        const auto literal =
+            std::find_if(literals.begin(), literals.end(), [&](const BSONElement& e) {
+                return e.rawdata() == data.rawdata();
+            });
+        if (literal == literals.end()) {
+            return noTemplate;
+        }
+        tmpl->leaves.push_back(
+            {leaf->matchType(), leaf->path().toString(), size_t(literal - literals.begin())});
+    }
+    return std::move(tmpl);
+}
+
+std::unique_ptr<ComparisonMatchExpression> makeComparison(MatchExpression::MatchType matchType) {
+    switch (matchType) {
+        case MatchExpression::EQ:
+            return stdx::make_unique<EqualityMatchExpression>();
+        case MatchExpression::LT:
+            return stdx::make_unique<LTMatchExpression>();
+        case MatchExpression::LTE:
+            return stdx::make_unique<LTEMatchExpression>();
+        case MatchExpression::GT:
+            return stdx::make_unique<GTMatchExpression>();
+        case MatchExpression::GTE:
+            return stdx::make_unique<GTEMatchExpression>();
+        default:
+            MONGO_UNREACHABLE;
+    }
+}
+
+std::unique_ptr<MatchExpression> build(const FilterTemplate& tmpl,
+                                       const std::vector<BSONElement>& literals) {
+    std::vector<std::unique_ptr<ComparisonMatchExpression>> comparisons;
+    for (const TemplateLeaf& leaf : tmpl.leaves) {
+        auto cmp = makeComparison(leaf.matchType);
+        if (!cmp->init(leaf.path, literals[leaf.literal]).isOK()) {
+            return {};
+        }
+        comparisons.push_back(std::move(cmp));
+    }
+
+    if (comparisons.size() == 1) {
+        return std::move(comparisons.front());
+    }
+    auto root = stdx::make_unique<AndMatchExpression>();
+    for (auto&& cmp : comparisons) {
+        root->add(cmp.release());
+    }
+    return std::move(root);
+}
+
+}  // namespace
+
+std::unique_ptr<MatchExpression> FilterTemplateCache::instantiate(const BSONObj& filter) {
+    const long long maxShapes = internalQueryFilterTemplateCacheMaxShapes;
+    if (maxShapes <= 0) {
+        return {};
+    }
+
+    std::string shape;
+    std::vector<BSONElement> literals;
+    if (!computeShape(filter, &shape, &literals)) {
+        return {};
+    }
+
+    Partition& partition = partitions[std::hash<std::string>()(shape) % kNumPartitions];
+    std::shared_ptr<const FilterTemplate> tmpl;
+    {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        auto it = partition.templates.find(shape);
+        if (it != partition.templates.end()) {
+            tmpl = it->second;
+        }
+    }
+    if (tmpl) {
+        return tmpl->leaves.empty() ? nullptr : build(*tmpl, literals);
+    }
+
+    // The first filter of a shape is canonicalized as usual, and teaches the cache the template.
+    StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filter);
+    if (!statusWithMatcher.isOK()) {
+        return {};
+    }
+    std::unique_ptr<MatchExpression> root(
+        CanonicalQuery::normalizeTree(statusWithMatcher.getValue().release()));
+    CanonicalQuery::sortTree(root.get());
+
+    if (numShapes.load() < maxShapes) {
+        auto learned = makeTemplate(root.get(), literals);
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        if (partition.templates.emplace(std::move(shape), std::move(learned)).second) {
+            numShapes.addAndFetch(1);
+        }
+    }
+    return root;
+}
+
+void FilterTemplateCache::clearForTest() {
+    for (auto& partition : partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition.mutex);
+        numShapes.subtractAndFetch(partition.templates.size());
+        partition.templates.clear();
+    }
+}
+
+}  // namespace mongo
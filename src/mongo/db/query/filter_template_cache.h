@@ -0,0 +1,68 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/matcher/expression.h"
+
+namespace mongo {
+
+/**
+ * Remembers, per filter shape, the MatchExpression that CanonicalQuery produces after parsing,
+ * normalizing and sorting a filter of that shape, so that later filters of the same shape are
+ * built directly around their own literals.
+ *
+ * A shape is the filter with its literals masked: the field names, the operators and the BSON
+ * types of the values, in order. Only filters whose top level is a list of equalities and $eq,
+ * $lt, $lte, $gt and $gte comparisons against scalars are handled, since how those normalize and
+ * sort depends on the shape alone. That covers the bulk of application generated queries.
+ *
+ * At most internalQueryFilterTemplateCacheMaxShapes shapes are remembered. Once that many are,
+ * filters of new shapes are parsed as usual.
+ */
+class FilterTemplateCache {
+public:
+    /**
+     * Returns the normalized and sorted MatchExpression for 'filter', or nullptr if 'filter' does
+     * not have a shape this cache handles, in which case the caller parses it as usual. The
+     * returned expression points into 'filter', as a parsed one would.
+     *
+     * Thread safe.
+     */
+    static std::unique_ptr<MatchExpression> instantiate(const BSONObj& filter);
+
+    /**
+     * Forgets every shape.
+     */
+    static void clearForTest();
+};
+
+}  // namespace mongo
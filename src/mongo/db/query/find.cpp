@@ -49,6 +49,8 @@
 #include "mongo/db/query/get_executor.h"
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_stats.h"
+#include "mongo/db/query/reply_batch_builder.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/s/sharding_state.h"
 #include "mongo/db/server_options.h"
@@ -161,6 +163,22 @@ void endQueryOp(OperationContext* txn,
         collection->infoCache()->notifyOfQuery(txn, summaryStats.indexesUsed);
     }
 
+    // Account for the query in the statistics of its shape. Only the work done by the first batch
+    // is counted.
+    CanonicalQuery* cq = exec.getCanonicalQuery();
+    if (collection && cq && QueryStatsStore::isEnabled()) {
+        QueryStatsStore::Metrics metrics;
+        metrics.latencyMicros = curop->elapsedMicros();
+        metrics.keysExamined = summaryStats.totalKeysExamined;
+        metrics.docsExamined = summaryStats.totalDocsExamined;
+        metrics.nreturned = numResults;
+        QueryStatsStore::get(txn->getClient()->getServiceContext())
+            .record(*cq,
+                    collection->infoCache()->getPlanCache()->computeKey(*cq),
+                    metrics,
+                    [&exec] { return Explain::getPlanSummary(&exec); });
+    }
+
     const logger::LogComponent queryLogComponent = logger::LogComponent::kQuery;
     const logger::LogSeverity logLevelOne = logger::LogSeverity::Debug(1);
 
@@ -204,7 +222,7 @@ namespace {
  */
 void generateBatch(int ntoreturn,
                    ClientCursor* cursor,
-                   BufBuilder* bb,
+                   ReplyBatchBuilder* bb,
                    int* numResults,
                    Timestamp* slaveReadTill,
                    PlanExecutor::ExecState* state) {
@@ -213,7 +231,7 @@ void generateBatch(int ntoreturn,
     BSONObj obj;
     while (PlanExecutor::ADVANCED == (*state = exec->getNext(&obj, NULL))) {
         // Add result to output buffer.
-        bb->appendBuf((void*)obj.objdata(), obj.objsize());
+        bb->append(obj);
 
         // Count the result.
         (*numResults)++;
@@ -249,7 +267,8 @@ QueryResult::View getMore(OperationContext* txn,
                           int ntoreturn,
                           long long cursorid,
                           bool* exhaust,
-                          bool* isCursorAuthorized) {
+                          bool* isCursorAuthorized,
+                          Message* result) {
     CurOp& curop = *CurOp::get(txn);
 
     // For testing, we may want to fail if we receive a getmore.
@@ -319,8 +338,8 @@ QueryResult::View getMore(OperationContext* txn,
     const int InitialBufSize =
         512 + sizeof(QueryResult::Value) + FindCommon::kMaxBytesToReturnToClientAtOnce;
 
-    BufBuilder bb(InitialBufSize);
-    bb.skip(sizeof(QueryResult::Value));
+    ReplyBatchBuilder bb(cc ? FindCommon::getMoreBufSize(cc->getLastBatchBytes(), InitialBufSize)
+                            : static_cast<int>(sizeof(QueryResult::Value)));
 
     if (NULL == cc) {
         cursorid = 0;
@@ -370,6 +389,15 @@ QueryResult::View getMore(OperationContext* txn,
         exec->reattachToOperationContext(txn);
         exec->restoreState();
 
+        // If we're tailing a capped collection, retrieve a monotonically increasing insert
+        // counter before reading, so that an insert made after the batch is generated is not
+        // missed by the wait below.
+        uint64_t lastInsertCount = 0;
+        if (isCursorAwaitData(cc)) {
+            invariant(ctx->getCollection()->isCapped());
+            lastInsertCount = ctx->getCollection()->getCappedInsertNotifier()->getCount();
+        }
+
         PlanExecutor::ExecState state;
 
         generateBatch(ntoreturn, cc, &bb, &numResults, &slaveReadTill, &state);
@@ -389,7 +417,6 @@ QueryResult::View getMore(OperationContext* txn,
 
             // Block waiting for data for up to 1 second.
             Seconds timeout(1);
-            uint64_t lastInsertCount = notifier->getCount();
             notifier->waitForInsert(lastInsertCount, timeout);
             notifier.reset();
 
@@ -440,6 +467,7 @@ QueryResult::View getMore(OperationContext* txn,
         } else {
             // Continue caching the ClientCursor.
             cc->incPos(numResults);
+            cc->setLastBatchBytes(bb.len());
             exec->saveState();
             exec->detachFromOperationContext();
             LOG(5) << "getMore saving client cursor ended with state "
@@ -458,15 +486,14 @@ QueryResult::View getMore(OperationContext* txn,
         }
     }
 
-    QueryResult::View qr = bb.buf();
-    qr.msgdata().setLen(bb.len());
+    QueryResult::View qr = bb.done(result);
     qr.msgdata().setOperation(opReply);
     qr.setResultFlags(resultFlags);
     qr.setCursorId(cursorid);
     qr.setStartingFrom(startingResult);
     qr.setNReturned(numResults);
-    bb.decouple();
-    LOG(5) << "getMore returned " << numResults << " results\n";
+    LOG(5) << "getMore returned " << numResults << " results (" << bb.numReferenced()
+           << " sent by reference)\n";
     return qr;
 }
 
@@ -557,8 +584,7 @@ std::string runQuery(OperationContext* txn,
     // bb is used to hold query results
     // this buffer should contain either requested documents per query or
     // explain information, but not both
-    BufBuilder bb(32768);
-    bb.skip(sizeof(QueryResult::Value));
+    ReplyBatchBuilder bb(32768);
 
     // How many results have we obtained from the executor?
     int numResults = 0;
@@ -575,7 +601,7 @@ std::string runQuery(OperationContext* txn,
 
     while (PlanExecutor::ADVANCED == (state = exec->getNext(&obj, NULL))) {
         // Add result to output buffer.
-        bb.appendBuf((void*)obj.objdata(), obj.objsize());
+        bb.append(obj);
 
         // Count the result.
         ++numResults;
@@ -661,6 +687,7 @@ std::string runQuery(OperationContext* txn,
         }
 
         cc->setPos(numResults);
+        cc->setLastBatchBytes(bb.len());
 
         // If the query had a time limit, remaining time is "rolled over" to the cursor (for
         // use by future getmore ops).
@@ -672,12 +699,8 @@ std::string runQuery(OperationContext* txn,
         endQueryOp(txn, collection, *exec, dbProfilingLevel, numResults, ccId);
     }
 
-    // Add the results from the query into the output buffer.
-    result.appendData(bb.buf(), bb.len());
-    bb.decouple();
-
-    // Fill out the output buffer's header.
-    QueryResult::View qr = result.header().view2ptr();
+    // Add the results from the query into the output buffer and fill out its header.
+    QueryResult::View qr = bb.done(&result);
     qr.setCursorId(ccId);
     qr.setResultFlagsToOk();
     qr.msgdata().setOperation(opReply);
@@ -688,4 +711,75 @@ std::string runQuery(OperationContext* txn,
     return curop.debug().exhaust ? nss.ns() : "";
 }
 
+BSONObj runQueryForOne(OperationContext* txn,
+                       const NamespaceString& nss,
+                       const BSONObj& queryObj,
+                       const BSONObj& fields,
+                       int queryOptions) {
+    CurOp& curop = *CurOp::get(txn);
+    uassert(16256, str::stream() << "Invalid ns [" << nss.ns() << "]", nss.isValid());
+    invariant(!nss.isCommand());
+
+    // A negative ntoreturn asks for a single batch, so no cursor is ever saved.
+    beginQueryOp(txn, nss, queryObj, -1, 0);
+
+    auto lpq = uassertStatusOK(
+        LiteParsedQuery::fromLegacyQuery(nss, queryObj, fields, 0, -1, queryOptions));
+    auto statusWithCQ =
+        CanonicalQuery::canonicalize(lpq.release(), WhereCallbackReal(txn, nss.db()));
+    if (!statusWithCQ.isOK()) {
+        uasserted(
+            17287,
+            str::stream() << "Can't canonicalize query: " << statusWithCQ.getStatus().toString());
+    }
+    unique_ptr<CanonicalQuery> cq = std::move(statusWithCQ.getValue());
+
+    AutoGetCollectionForRead ctx(txn, nss);
+    Collection* collection = ctx.getCollection();
+
+    const int dbProfilingLevel =
+        ctx.getDb() ? ctx.getDb()->getProfilingLevel() : serverGlobalParams.defaultProfile;
+
+    std::unique_ptr<PlanExecutor> exec = uassertStatusOK(
+        getExecutorFind(txn, collection, nss, std::move(cq), PlanExecutor::YIELD_AUTO));
+
+    const LiteParsedQuery& pq = exec->getCanonicalQuery()->getParsed();
+    invariant(!pq.isExplain());
+
+    const ChunkVersion shardingVersionAtStart =
+        ShardingState::get(getGlobalServiceContext())->getVersion(nss.ns());
+
+    curop.setMaxTimeMicros(static_cast<unsigned long long>(pq.getMaxTimeMS()) * 1000);
+    txn->checkForInterrupt();
+
+    bool slaveOK = pq.isSlaveOk() || pq.hasReadPref();
+    uassertStatusOK(
+        repl::getGlobalReplicationCoordinator()->checkCanServeReadsFor(txn, nss, slaveOK));
+
+    curop.debug().planSummary = Explain::getPlanSummary(exec.get());
+
+    BSONObj obj;
+    PlanExecutor::ExecState state = exec->getNext(&obj, NULL);
+    if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+        const unique_ptr<PlanStageStats> stats(exec->getStats());
+        error() << "Plan executor error during find: " << PlanExecutor::statestr(state)
+                << ", stats: " << Explain::statsToBSON(*stats);
+        uasserted(17144, "Executor error: " + WorkingSetCommon::toStatusString(obj));
+    }
+
+    if (!ShardingState::get(getGlobalServiceContext())
+             ->getVersion(nss.ns())
+             .isWriteCompatibleWith(shardingVersionAtStart)) {
+        throw SendStaleConfigException(
+            nss.ns(),
+            "version changed during initial query",
+            shardingVersionAtStart,
+            ShardingState::get(getGlobalServiceContext())->getVersion(nss.ns()));
+    }
+
+    const long long numResults = PlanExecutor::ADVANCED == state ? 1 : 0;
+    endQueryOp(txn, collection, *exec, dbProfilingLevel, numResults, 0);
+    return numResults ? obj.getOwned() : BSONObj();
+}
+
 }  // namespace mongo
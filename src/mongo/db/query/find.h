@@ -113,13 +113,16 @@ StatusWith<std::unique_ptr<PlanExecutor>> getOplogStartHack(OperationContext* tx
 
 /**
  * Called from the getMore entry point in ops/query.cpp.
+ *
+ * Places the reply in 'result', which must be empty, and returns a view of its header.
  */
 QueryResult::View getMore(OperationContext* txn,
                           const char* ns,
                           int ntoreturn,
                           long long cursorid,
                           bool* exhaust,
-                          bool* isCursorAuthorized);
+                          bool* isCursorAuthorized,
+                          Message* result);
 
 /**
  * Run the query 'q' and place the result in 'result'.
@@ -129,4 +132,15 @@ std::string runQuery(OperationContext* txn,
                      const NamespaceString& ns,
                      Message& result);
 
+/**
+ * Runs the legacy query 'queryObj' with projection 'fields' the way runQuery() would for a
+ * single-batch query of one document, but returns the document itself, or an empty object when
+ * nothing matches, rather than building a reply message. Explain queries are not supported.
+ */
+BSONObj runQueryForOne(OperationContext* txn,
+                       const NamespaceString& nss,
+                       const BSONObj& queryObj,
+                       const BSONObj& fields,
+                       int queryOptions);
+
 }  // namespace mongo
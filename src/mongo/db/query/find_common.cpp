@@ -30,6 +30,8 @@
 
 #include "mongo/db/query/find_common.h"
 
+#include <algorithm>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/db/query/lite_parsed_query.h"
 #include "mongo/util/assert_util.h"
@@ -58,6 +60,16 @@ bool FindCommon::enoughForGetMore(long long effectiveBatchSize,
         (bytesBuffered > kMaxBytesToReturnToClientAtOnce);
 }
 
+int FindCommon::getMoreBufSize(int lastBatchBytes, int defaultSize) {
+    if (lastBatchBytes <= 0) {
+        return defaultSize;
+    }
+    // A batch stops growing once it is over kMaxBytesToReturnToClientAtOnce, so by at most one
+    // document, which the buffer can still grow to fit.
+    const int maxSize = kMaxBytesToReturnToClientAtOnce + 512;
+    return std::min(lastBatchBytes + lastBatchBytes / 8 + 512, maxSize);
+}
+
 BSONObj FindCommon::transformSortSpec(const BSONObj& sortSpec) {
     BSONObjBuilder comparatorBob;
 
@@ -62,6 +62,16 @@ public:
                                  long long numDocs,
                                  int bytesBuffered);
 
+    /**
+     * Returns the initial size of the buffer for the next batch of a cursor whose last batch was
+     * 'lastBatchBytes' long, or 'defaultSize' if the cursor has not returned a batch yet.
+     *
+     * Presizing from the previous batch, with some headroom, spares batches of a steady size from
+     * growing their buffer by doubling every time, and spares small batches, such as those of a
+     * tailable cursor, from allocating room for kMaxBytesToReturnToClientAtOnce.
+     */
+    static int getMoreBufSize(int lastBatchBytes, int defaultSize);
+
     /**
      * Transforms the raw sort spec into one suitable for use as the ordering specification in
      * BSONObj::woCompare().
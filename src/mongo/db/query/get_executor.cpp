@@ -32,6 +32,7 @@
 
 #include "mongo/db/query/get_executor.h"
 
+#include <cmath>
 #include <limits>
 #include <memory>
 
@@ -44,6 +45,7 @@
 #include "mongo/db/exec/eof.h"
 #include "mongo/db/exec/group.h"
 #include "mongo/db/exec/idhack.h"
+#include "mongo/db/exec/multi_idhack.h"
 #include "mongo/db/exec/multi_plan.h"
 #include "mongo/db/exec/oplogstart.h"
 #include "mongo/db/exec/projection.h"
@@ -54,6 +56,7 @@
 #include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/ops/update_lifecycle.h"
 #include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/collection_sample.h"
 #include "mongo/db/query/explain.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/internal_plans.h"
@@ -138,6 +141,7 @@ void fillOutPlannerParams(OperationContext* txn,
                                                     desc->indexName(),
                                                     ice->getFilterExpression(),
                                                     desc->infoObj()));
+        plannerParams->indices.back().multikeyComponents = ice->getMultikeyComponents();
     }
 
     // If query supports index filters, filter params.indices by indices in query settings.
@@ -185,6 +189,10 @@ void fillOutPlannerParams(OperationContext* txn,
         plannerParams->options |= QueryPlannerParams::INDEX_INTERSECTION;
     }
 
+    if (internalQueryPlannerEnableSkipScan) {
+        plannerParams->options |= QueryPlannerParams::INDEX_SKIP_SCAN;
+    }
+
     plannerParams->options |= QueryPlannerParams::SPLIT_LIMITED_SORT;
 
     // Doc-level locking storage engines cannot answer predicates implicitly via exact index
@@ -249,8 +257,13 @@ Status prepareExecution(OperationContext* opCtx,
     // If we have an _id index we can use an idhack plan.
     if (descriptor && IDHackStage::supportsQuery(*canonicalQuery)) {
         LOG(2) << "Using idhack: " << canonicalQuery->toStringShort();
-
         *rootOut = new IDHackStage(opCtx, collection, canonicalQuery, ws, descriptor);
+    } else if (descriptor && MultiIDHackStage::supportsQuery(*canonicalQuery)) {
+        LOG(2) << "Using multi-get idhack: " << canonicalQuery->toStringShort();
+        *rootOut = new MultiIDHackStage(opCtx, collection, canonicalQuery, ws, descriptor);
+    }
+
+    if (*rootOut) {
 
         // Might have to filter out orphaned docs.
         if (plannerParams.options & QueryPlannerParams::INCLUDE_SHARD_FILTER) {
@@ -369,6 +382,9 @@ Status prepareExecution(OperationContext* opCtx,
         }
     }
 
+    // Drop candidates which a sample of the collection shows to be much worse than the others.
+    pruneSolutionsBySample(opCtx, collection, *canonicalQuery, &solutions);
+
     if (1 == solutions.size()) {
         // Only one possible plan.  Run it.  Build the stages from the solution.
         verify(StageBuilder::build(opCtx, collection, *solutions[0], ws, rootOut));
@@ -1222,6 +1238,19 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorCount(OperationContext* txn,
 
     invariant(cq.get());
 
+    if (request.getApproximate()) {
+        // Estimate the count from the collection's sample if it has one. Collections too small
+        // to sample, or whose storage engine cannot sample them, are counted exactly.
+        std::shared_ptr<const CollectionSample> sample = collection->infoCache()->getSample(txn);
+        if (sample) {
+            const long long nEstimated = std::llround(sample->estimateMatching(*cq->root()));
+            unique_ptr<PlanStage> root =
+                make_unique<CountStage>(txn, collection, request, ws.get(), nEstimated);
+            return PlanExecutor::make(
+                txn, std::move(ws), std::move(root), request.getNs().ns(), yieldPolicy);
+        }
+    }
+
     const size_t plannerOptions = QueryPlannerParams::PRIVATE_IS_COUNT;
     PlanStage* child;
     QuerySolution* rawQuerySolution;
@@ -1341,6 +1370,7 @@ StatusWith<unique_ptr<PlanExecutor>> getExecutorDistinct(OperationContext* txn,
                                                        desc->indexName(),
                                                        ice->getFilterExpression(),
                                                        desc->infoObj()));
+            plannerParams.indices.back().multikeyComponents = ice->getMultikeyComponents();
         }
     }
 
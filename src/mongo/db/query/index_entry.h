@@ -101,6 +101,10 @@ struct IndexEntry {
 
     bool multikey;
 
+    // If the index is multikey, the components of 'keyPattern' which may have come from arrays,
+    // bit i for the i-th field. All of them unless the catalog knows better.
+    unsigned long long multikeyComponents = ~0ULL;
+
     bool sparse;
 
     bool unique;
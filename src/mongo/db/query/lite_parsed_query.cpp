@@ -757,9 +757,20 @@ bool LiteParsedQuery::isQueryIsolated(const BSONObj& query) {
 // static
 StatusWith<unique_ptr<LiteParsedQuery>> LiteParsedQuery::fromLegacyQueryMessage(
     const QueryMessage& qm) {
-    unique_ptr<LiteParsedQuery> pq(new LiteParsedQuery(NamespaceString(qm.ns)));
+    return fromLegacyQuery(
+        NamespaceString(qm.ns), qm.query, qm.fields, qm.ntoskip, qm.ntoreturn, qm.queryOptions);
+}
+
+// static
+StatusWith<unique_ptr<LiteParsedQuery>> LiteParsedQuery::fromLegacyQuery(NamespaceString nss,
+                                                                         const BSONObj& queryObj,
+                                                                         const BSONObj& proj,
+                                                                         int ntoskip,
+                                                                         int ntoreturn,
+                                                                         int queryOptions) {
+    unique_ptr<LiteParsedQuery> pq(new LiteParsedQuery(std::move(nss)));
 
-    Status status = pq->init(qm.ntoskip, qm.ntoreturn, qm.queryOptions, qm.query, qm.fields, true);
+    Status status = pq->init(ntoskip, ntoreturn, queryOptions, queryObj, proj, true);
     if (!status.isOK()) {
         return status;
     }
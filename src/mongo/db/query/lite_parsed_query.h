@@ -293,6 +293,17 @@ public:
     static StatusWith<std::unique_ptr<LiteParsedQuery>> fromLegacyQueryMessage(
         const QueryMessage& qm);
 
+    /**
+     * Same as fromLegacyQueryMessage(), for an OP_QUERY whose fields were never encoded into a
+     * Message, such as one issued through DBDirectClient.
+     */
+    static StatusWith<std::unique_ptr<LiteParsedQuery>> fromLegacyQuery(NamespaceString nss,
+                                                                        const BSONObj& queryObj,
+                                                                        const BSONObj& proj,
+                                                                        int ntoskip,
+                                                                        int ntoreturn,
+                                                                        int queryOptions);
+
 private:
     LiteParsedQuery(NamespaceString nss);
 
@@ -175,6 +175,36 @@ TEST(LRUKeyValueTest, ReplaceKeyTest) {
     assertInKVStore(cache, 4, 5);
 }
 
+/**
+ * Test that removeLeastRecentlyUsed() removes entries in LRU order
+ * and respects promotion by get().
+ */
+TEST(LRUKeyValueTest, RemoveLeastRecentlyUsedTest) {
+    LRUKeyValue<int, int> cache(10);
+    ASSERT(NULL == cache.removeLeastRecentlyUsed().get());
+
+    cache.add(1, new int(1));
+    cache.add(2, new int(2));
+    cache.add(3, new int(3));
+
+    // Promote 1 so that 2 is now the least recently used.
+    int* entry;
+    ASSERT_OK(cache.get(1, &entry));
+
+    std::unique_ptr<int> evicted = cache.removeLeastRecentlyUsed();
+    ASSERT(NULL != evicted.get());
+    ASSERT_EQUALS(*evicted, 2);
+    ASSERT_EQUALS(cache.size(), (size_t)2);
+    assertNotInKVStore(cache, 2);
+
+    evicted = cache.removeLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 3);
+    evicted = cache.removeLeastRecentlyUsed();
+    ASSERT_EQUALS(*evicted, 1);
+    ASSERT_EQUALS(cache.size(), (size_t)0);
+    ASSERT(NULL == cache.removeLeastRecentlyUsed().get());
+}
+
 /**
  * Test iteration over the kv-store.
  */
@@ -35,10 +35,13 @@
 #include <algorithm>
 #include <math.h>
 #include <memory>
+#include "mongo/base/counter.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/client/dbclientinterface.h"  // For QueryOption_foobar
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/matcher/expression_array.h"
 #include "mongo/db/matcher/expression_geo.h"
+#include "mongo/db/matcher/expression_leaf.h"
 #include "mongo/db/query/plan_ranker.h"
 #include "mongo/db/query/query_solution.h"
 #include "mongo/db/query/query_knobs.h"
@@ -57,6 +60,37 @@ const char kEncodeChildrenEnd = ']';
 const char kEncodeChildrenSeparator = ',';
 const char kEncodeSortSection = '~';
 const char kEncodeProjectionSection = '|';
+const char kEncodeInSizeBucket = '#';
+
+// $in lists of 2^kMaxInSizeBucket or more elements all share the last bucket.
+const int kMaxInSizeBucket = 9;
+
+// Plan cache metrics, summed over the plan caches of all collections.
+Counter64 planCacheHits;
+Counter64 planCacheMisses;
+Counter64 planCacheEvictions;
+Counter64 planCacheTotalSizeBytes;
+
+ServerStatusMetricField<Counter64> displayPlanCacheHits("query.planCache.hits", &planCacheHits);
+ServerStatusMetricField<Counter64> displayPlanCacheMisses("query.planCache.misses",
+                                                          &planCacheMisses);
+ServerStatusMetricField<Counter64> displayPlanCacheEvictions("query.planCache.evictions",
+                                                             &planCacheEvictions);
+ServerStatusMetricField<Counter64> displayPlanCacheTotalSizeBytes("query.planCache.totalSizeBytes",
+                                                                  &planCacheTotalSizeBytes);
+
+/**
+ * The bytes charged for an entry stored under 'key'. The key is held twice by the LRU store, once
+ * in its list and once in its map.
+ */
+size_t estimateCacheEntrySizeBytes(const PlanCacheKey& key, const PlanCacheEntry& entry) {
+    return entry.estimateObjectSizeInBytes() + 2 * (sizeof(PlanCacheKey) + key.capacity());
+}
+
+size_t estimateFeedbackSizeBytes(const PlanCacheEntryFeedback& feedback) {
+    return sizeof(PlanCacheEntryFeedback*) + sizeof(feedback) +
+        feedback.stats->estimateObjectSizeInBytes();
+}
 
 /**
  * Encode user-provided string. Cache key delimiters seen in the
@@ -73,6 +107,7 @@ void encodeUserString(StringData s, StringBuilder* keyBuilder) {
             case kEncodeChildrenSeparator:
             case kEncodeSortSection:
             case kEncodeProjectionSection:
+            case kEncodeInSizeBucket:
             case '\\':
                 *keyBuilder << '\\';
             // Fall through to default case.
@@ -174,6 +209,21 @@ const char* encodeMatchType(MatchExpression::MatchType mt) {
     }
 }
 
+/**
+ * Encodes the number of elements in an $in as the position of its highest set bit. Queries whose
+ * $in lists are within a factor of two of each other in size share a cache entry, while a plan
+ * chosen for a handful of elements is not reused, and then replanned, for hundreds.
+ */
+void encodeInSizeBucket(const InMatchExpression* tree, StringBuilder* keyBuilder) {
+    int size = tree->getData().size();
+    int bucket = 0;
+    while (size > 1 && bucket < kMaxInSizeBucket) {
+        size >>= 1;
+        ++bucket;
+    }
+    *keyBuilder << kEncodeInSizeBucket << bucket;
+}
+
 /**
  * Encodes GEO match expression.
  * Encoding includes:
@@ -383,6 +433,24 @@ PlanCacheEntry* PlanCacheEntry::clone() const {
     return entry;
 }
 
+size_t PlanCacheEntry::estimateObjectSizeInBytes() const {
+    size_t size = sizeof(*this) + query.objsize() + sort.objsize() + projection.objsize();
+    for (size_t i = 0; i < plannerData.size(); ++i) {
+        size += sizeof(SolutionCacheData*) + plannerData[i]->estimateObjectSizeInBytes();
+    }
+
+    size += sizeof(*decision) + decision->scores.capacity() * sizeof(double) +
+        decision->candidateOrder.capacity() * sizeof(size_t);
+    for (size_t i = 0; i < decision->stats.size(); ++i) {
+        size += sizeof(PlanStageStats*) + decision->stats.vector()[i]->estimateObjectSizeInBytes();
+    }
+
+    for (size_t i = 0; i < feedback.size(); ++i) {
+        size += estimateFeedbackSizeBytes(*feedback[i]);
+    }
+    return size;
+}
+
 std::string PlanCacheEntry::toString() const {
     return str::stream() << "(query: " << query.toString() << ";sort: " << sort.toString()
                          << ";projection: " << projection.toString()
@@ -417,6 +485,20 @@ PlanCacheIndexTree* PlanCacheIndexTree::clone() const {
     return root;
 }
 
+size_t PlanCacheIndexTree::estimateObjectSizeInBytes() const {
+    size_t size = sizeof(*this) + children.capacity() * sizeof(PlanCacheIndexTree*);
+    if (NULL != entry.get()) {
+        size += sizeof(IndexEntry) + entry->keyPattern.objsize() + entry->name.capacity() +
+            entry->infoObj.objsize();
+    }
+    for (std::vector<PlanCacheIndexTree*>::const_iterator it = children.begin();
+         it != children.end();
+         ++it) {
+        size += (*it)->estimateObjectSizeInBytes();
+    }
+    return size;
+}
+
 std::string PlanCacheIndexTree::toString(int indents) const {
     StringBuilder result;
     if (!children.empty()) {
@@ -455,6 +537,14 @@ SolutionCacheData* SolutionCacheData::clone() const {
     return other;
 }
 
+size_t SolutionCacheData::estimateObjectSizeInBytes() const {
+    size_t size = sizeof(*this);
+    if (NULL != tree.get()) {
+        size += tree->estimateObjectSizeInBytes();
+    }
+    return size;
+}
+
 std::string SolutionCacheData::toString() const {
     switch (this->solnType) {
         case WHOLE_IXSCAN_SOLN:
@@ -476,11 +566,14 @@ std::string SolutionCacheData::toString() const {
 // PlanCache
 //
 
-PlanCache::PlanCache() : _cache(internalQueryCacheSize) {}
+PlanCache::PlanCache() : _cache(internalQueryCacheSize), _sizeBytes(0) {}
 
-PlanCache::PlanCache(const std::string& ns) : _cache(internalQueryCacheSize), _ns(ns) {}
+PlanCache::PlanCache(const std::string& ns)
+    : _cache(internalQueryCacheSize), _sizeBytes(0), _ns(ns) {}
 
-PlanCache::~PlanCache() {}
+PlanCache::~PlanCache() {
+    planCacheTotalSizeBytes.decrement(_sizeBytes);
+}
 
 /**
  * Traverses expression tree pre-order.
@@ -498,6 +591,8 @@ void PlanCache::encodeKeyForMatch(const MatchExpression* tree, StringBuilder* ke
         encodeGeoMatchExpression(static_cast<const GeoMatchExpression*>(tree), keyBuilder);
     } else if (MatchExpression::GEO_NEAR == tree->matchType()) {
         encodeGeoNearMatchExpression(static_cast<const GeoNearMatchExpression*>(tree), keyBuilder);
+    } else if (MatchExpression::MATCH_IN == tree->matchType()) {
+        encodeInSizeBucket(static_cast<const InMatchExpression*>(tree), keyBuilder);
     }
 
     // Encode indexability.
@@ -652,14 +747,28 @@ Status PlanCache::add(const CanonicalQuery& query,
     }
     entry->projection = projBuilder.obj();
 
+    PlanCacheKey key = computeKey(query);
+    size_t entrySizeBytes = estimateCacheEntrySizeBytes(key, *entry);
+
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(computeKey(query), entry);
+    PlanCacheEntry* replacedEntry;
+    if (_cache.get(key, &replacedEntry).isOK()) {
+        // add() deletes the entry already stored under 'key'.
+        releaseEntry(replacedEntry);
+    }
+
+    std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.add(key, entry);
+    chargeEntry(entry, entrySizeBytes);
 
     if (NULL != evictedEntry.get()) {
         LOG(1) << _ns << ": plan cache maximum size exceeded - "
                << "removed least recently used entry " << evictedEntry->toString();
+        releaseEntry(evictedEntry.get());
+        planCacheEvictions.increment();
     }
 
+    evictToSizeBudget();
+
     return Status::OK();
 }
 
@@ -671,9 +780,11 @@ Status PlanCache::get(const CanonicalQuery& query, CachedSolution** crOut) const
     PlanCacheEntry* entry;
     Status cacheStatus = _cache.get(key, &entry);
     if (!cacheStatus.isOK()) {
+        planCacheMisses.increment();
         return cacheStatus;
     }
     invariant(entry);
+    planCacheHits.increment();
 
     *crOut = new CachedSolution(key, *entry);
 
@@ -697,20 +808,33 @@ Status PlanCache::feedback(const CanonicalQuery& cq, PlanCacheEntryFeedback* fee
 
     // We store up to a constant number of feedback entries.
     if (entry->feedback.size() < size_t(internalQueryCacheFeedbacksStored)) {
+        size_t feedbackSizeBytes = estimateFeedbackSizeBytes(*autoFeedback);
         entry->feedback.push_back(autoFeedback.release());
+        chargeEntry(entry, feedbackSizeBytes);
+        evictToSizeBudget();
     }
 
     return Status::OK();
 }
 
 Status PlanCache::remove(const CanonicalQuery& canonicalQuery) {
+    PlanCacheKey key = computeKey(canonicalQuery);
+
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
-    return _cache.remove(computeKey(canonicalQuery));
+    PlanCacheEntry* entry;
+    Status cacheStatus = _cache.get(key, &entry);
+    if (!cacheStatus.isOK()) {
+        return cacheStatus;
+    }
+    releaseEntry(entry);
+    return _cache.remove(key);
 }
 
 void PlanCache::clear() {
     stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
     _cache.clear();
+    planCacheTotalSizeBytes.decrement(_sizeBytes);
+    _sizeBytes = 0;
     _writeOperations.store(0);
 }
 
@@ -761,6 +885,41 @@ size_t PlanCache::size() const {
     return _cache.size();
 }
 
+size_t PlanCache::sizeBytes() const {
+    stdx::lock_guard<stdx::mutex> cacheLock(_cacheMutex);
+    return _sizeBytes;
+}
+
+// static
+long long PlanCache::totalSizeBytes() {
+    return planCacheTotalSizeBytes.get();
+}
+
+void PlanCache::chargeEntry(PlanCacheEntry* entry, size_t sizeBytes) {
+    entry->budgetedSizeBytes += sizeBytes;
+    _sizeBytes += sizeBytes;
+    planCacheTotalSizeBytes.increment(sizeBytes);
+}
+
+void PlanCache::releaseEntry(const PlanCacheEntry* entry) {
+    invariant(_sizeBytes >= entry->budgetedSizeBytes);
+    _sizeBytes -= entry->budgetedSizeBytes;
+    planCacheTotalSizeBytes.decrement(entry->budgetedSizeBytes);
+}
+
+void PlanCache::evictToSizeBudget() {
+    // The budget is shared by all collections, but each cache only evicts from itself. The
+    // collection whose workload grows the caches past the budget pays for it.
+    while (planCacheTotalSizeBytes.get() > internalQueryCacheMaxSizeBytes && _cache.size() > 0) {
+        std::unique_ptr<PlanCacheEntry> evictedEntry = _cache.removeLeastRecentlyUsed();
+        LOG(1) << _ns << ": plan cache size budget of " << internalQueryCacheMaxSizeBytes
+               << " bytes exceeded - removed least recently used entry "
+               << evictedEntry->toString();
+        releaseEntry(evictedEntry.get());
+        planCacheEvictions.increment();
+    }
+}
+
 void PlanCache::notifyOfIndexEntries(const std::vector<IndexEntry>& indexEntries) {
     _indexabilityState.updateDiscriminators(indexEntries);
 }
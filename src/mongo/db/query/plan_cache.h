@@ -111,6 +111,11 @@ struct PlanCacheIndexTree {
      */
     std::string toString(int indents = 0) const;
 
+    /**
+     * Estimates the memory held by this tree, including its children and index entries.
+     */
+    size_t estimateObjectSizeInBytes() const;
+
     // Children owned here.
     std::vector<PlanCacheIndexTree*> children;
 
@@ -139,6 +144,9 @@ struct SolutionCacheData {
     // For debugging.
     std::string toString() const;
 
+    // Estimates the memory held by this object, including 'tree'.
+    size_t estimateObjectSizeInBytes() const;
+
     // Owned here. If 'wholeIXSoln' is false, then 'tree'
     // can be used to tag an isomorphic match expression. If 'wholeIXSoln'
     // is true, then 'tree' is used to store the relevant IndexEntry.
@@ -228,6 +236,12 @@ public:
     // For debugging.
     std::string toString() const;
 
+    /**
+     * Estimates the memory held by this entry: its planner data, query shape, ranking decision
+     * and feedback.
+     */
+    size_t estimateObjectSizeInBytes() const;
+
     //
     // Planner data
     //
@@ -257,6 +271,10 @@ public:
     // Annotations from cached runs.  The CachedPlanStage provides these stats about its
     // runs when they complete.
     std::vector<PlanCacheEntryFeedback*> feedback;
+
+    // The bytes this entry and its key are charged against the plan cache size budget. Maintained
+    // by the PlanCache which owns the entry.
+    size_t budgetedSizeBytes = 0;
 };
 
 /**
@@ -380,6 +398,16 @@ public:
      */
     size_t size() const;
 
+    /**
+     * Returns the estimated number of bytes held by the entries in this cache.
+     */
+    size_t sizeBytes() const;
+
+    /**
+     * Returns the estimated number of bytes held by the plan caches of all collections.
+     */
+    static long long totalSizeBytes();
+
     /**
      * Updates internal state kept about the collection's indexes.  Must be called when the set
      * of indexes on the associated collection have changed.
@@ -393,11 +421,32 @@ private:
     void encodeKeyForSort(const BSONObj& sortObj, StringBuilder* keyBuilder) const;
     void encodeKeyForProj(const BSONObj& projObj, StringBuilder* keyBuilder) const;
 
+    /**
+     * Charges 'entry' against this cache's and the global size budgets. Callers must hold
+     * _cacheMutex.
+     */
+    void chargeEntry(PlanCacheEntry* entry, size_t sizeBytes);
+
+    /**
+     * Releases the size charged for 'entry', which is being removed from '_cache'. Callers must
+     * hold _cacheMutex.
+     */
+    void releaseEntry(const PlanCacheEntry* entry);
+
+    /**
+     * Evicts least recently used entries of this cache while the plan caches of all collections
+     * exceed internalQueryCacheMaxSizeBytes. Callers must hold _cacheMutex.
+     */
+    void evictToSizeBudget();
+
     LRUKeyValue<PlanCacheKey, PlanCacheEntry> _cache;
 
-    // Protects _cache.
+    // Protects _cache and _sizeBytes.
     mutable stdx::mutex _cacheMutex;
 
+    // The sum of 'budgetedSizeBytes' over the entries in _cache.
+    size_t _sizeBytes;
+
     // Counter for write notifications since initialization or last clear() invocation.  Starts
     // at 0.
     AtomicInt32 _writeOperations;
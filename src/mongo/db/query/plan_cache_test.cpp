@@ -45,6 +45,7 @@
 #include "mongo/db/query/query_solution.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/assert_util.h"
+#include "mongo/util/scopeguard.h"
 
 using namespace mongo;
 
@@ -388,6 +389,92 @@ TEST(PlanCacheTest, AddValidSolution) {
     ASSERT_EQUALS(planCache.size(), 1U);
 }
 
+/**
+ * Adds a cache entry for 'queryStr' with a single collection scan solution.
+ */
+void addCollScanSolution(PlanCache* planCache, const char* queryStr) {
+    unique_ptr<CanonicalQuery> cq(canonicalize(queryStr));
+    QuerySolution qs;
+    qs.cacheData.reset(new SolutionCacheData());
+    qs.cacheData->solnType = SolutionCacheData::COLLSCAN_SOLN;
+    std::vector<QuerySolution*> solns;
+    solns.push_back(&qs);
+    ASSERT_OK(planCache->add(*cq, solns, createDecision(1U)));
+}
+
+TEST(PlanCacheTest, SizeBytesAccounting) {
+    long long initialTotal = PlanCache::totalSizeBytes();
+    {
+        PlanCache planCache;
+        ASSERT_EQUALS(planCache.sizeBytes(), 0U);
+
+        addCollScanSolution(&planCache, "{a: 1}");
+        size_t entryBytes = planCache.sizeBytes();
+        ASSERT_GREATER_THAN(entryBytes, 0U);
+        ASSERT_EQUALS(PlanCache::totalSizeBytes(), initialTotal + (long long)entryBytes);
+
+        // Replacing an entry releases the bytes of the entry it replaces.
+        addCollScanSolution(&planCache, "{a: 1}");
+        ASSERT_EQUALS(planCache.sizeBytes(), entryBytes);
+
+        // A larger query shape makes for a larger entry.
+        addCollScanSolution(&planCache, "{b: {$in: [1, 2, 3, 4, 5, 6, 7, 8, 9, 10]}}");
+        size_t twoEntriesBytes = planCache.sizeBytes();
+        ASSERT_GREATER_THAN(twoEntriesBytes - entryBytes, entryBytes);
+
+        // Feedback is charged to its entry.
+        unique_ptr<CanonicalQuery> cq(canonicalize("{a: 1}"));
+        PlanCacheEntryFeedback* feedback = new PlanCacheEntryFeedback();
+        feedback->stats.reset(new PlanStageStats(CommonStats("COLLSCAN"), STAGE_COLLSCAN));
+        feedback->score = 0;
+        ASSERT_OK(planCache.feedback(*cq, feedback));
+        ASSERT_GREATER_THAN(planCache.sizeBytes(), twoEntriesBytes);
+
+        ASSERT_OK(planCache.remove(*cq));
+        ASSERT_EQUALS(planCache.sizeBytes(), twoEntriesBytes - entryBytes);
+
+        addCollScanSolution(&planCache, "{a: 1}");
+        planCache.clear();
+        ASSERT_EQUALS(planCache.sizeBytes(), 0U);
+        ASSERT_EQUALS(PlanCache::totalSizeBytes(), initialTotal);
+
+        // Destroying a cache releases the bytes it holds.
+        addCollScanSolution(&planCache, "{a: 1}");
+    }
+    ASSERT_EQUALS(PlanCache::totalSizeBytes(), initialTotal);
+}
+
+TEST(PlanCacheTest, EvictsLeastRecentlyUsedToSizeBudget) {
+    long long oldMaxSizeBytes = internalQueryCacheMaxSizeBytes;
+    ON_BLOCK_EXIT([&] { internalQueryCacheMaxSizeBytes = oldMaxSizeBytes; });
+
+    PlanCache planCache;
+    addCollScanSolution(&planCache, "{a: 1}");
+    addCollScanSolution(&planCache, "{b: 1}");
+
+    // The budget holds exactly the two entries in the cache.
+    internalQueryCacheMaxSizeBytes = PlanCache::totalSizeBytes();
+
+    // Promote {a: 1} so that {b: 1} becomes the least recently used entry.
+    unique_ptr<CanonicalQuery> cqA(canonicalize("{a: 1}"));
+    CachedSolution* rawCachedSolution;
+    ASSERT_OK(planCache.get(*cqA, &rawCachedSolution));
+    delete rawCachedSolution;
+
+    addCollScanSolution(&planCache, "{c: 1}");
+    ASSERT_EQUALS(planCache.size(), 2U);
+    ASSERT_TRUE(planCache.contains(*cqA));
+    ASSERT_FALSE(planCache.contains(*canonicalize("{b: 1}")));
+    ASSERT_TRUE(planCache.contains(*canonicalize("{c: 1}")));
+    ASSERT_LESS_THAN_OR_EQUALS(PlanCache::totalSizeBytes(), internalQueryCacheMaxSizeBytes);
+
+    // An entry which does not fit in the budget on its own is not kept.
+    internalQueryCacheMaxSizeBytes = 0;
+    addCollScanSolution(&planCache, "{d: 1}");
+    ASSERT_EQUALS(planCache.size(), 0U);
+    ASSERT_EQUALS(planCache.sizeBytes(), 0U);
+}
+
 /**
  * Each test in the CachePlanSelectionTest suite goes through
  * the following flow:
@@ -1070,6 +1157,8 @@ TEST(PlanCacheTest, ComputeKey) {
     testComputeKey("{a: 1, beqc: 1}", "{}", "{}", "an[eqa,eqbeqc]");
     testComputeKey("{ap1a: 1}", "{}", "{}", "eqap1a");
     testComputeKey("{aab: 1}", "{}", "{}", "eqaab");
+    testComputeKey("{a: {$in: [1]}}", "{}", "{}", "ina#0");
+    testComputeKey("{a: {$in: [1, 2, 3]}, b: 1}", "{}", "{}", "an[eqb,ina#1]");
 
     // With sort
     testComputeKey("{}", "{a: 1}", "{}", "an~aa");
@@ -1109,6 +1198,7 @@ TEST(PlanCacheTest, ComputeKey) {
 TEST(PlanCacheTest, ComputeKeyEscaped) {
     // Field name in query.
     testComputeKey("{'a,[]~|<>': 1}", "{}", "{}", "eqa\\,\\[\\]\\~\\|\\<\\>");
+    testComputeKey("{'a#1': 1}", "{}", "{}", "eqa\\#1");
 
     // Field name in sort.
     testComputeKey("{}", "{'a,[]~|<>': 1}", "{}", "an~aa\\,\\[\\]\\~\\|\\<\\>");
@@ -1120,6 +1210,28 @@ TEST(PlanCacheTest, ComputeKeyEscaped) {
     testComputeKey("{}", "{}", "{a: 'foo,[]~|<>'}", "an|ia");
 }
 
+// $in lists get the same key when their sizes are within a factor of two of each other.
+TEST(PlanCacheTest, ComputeKeyInSizeBuckets) {
+    PlanCache planCache;
+    auto keyForInSize = [&planCache](int size) {
+        BSONArrayBuilder values;
+        for (int i = 0; i < size; ++i) {
+            values.append(i);
+        }
+        unique_ptr<CanonicalQuery> cq(canonicalize(BSON("a" << BSON("$in" << values.arr()))));
+        return planCache.computeKey(*cq);
+    };
+
+    ASSERT_EQ(keyForInSize(4), keyForInSize(7));
+    ASSERT_EQ(keyForInSize(64), keyForInSize(100));
+    ASSERT_NOT_EQUALS(keyForInSize(1), keyForInSize(2));
+    ASSERT_NOT_EQUALS(keyForInSize(7), keyForInSize(8));
+    ASSERT_NOT_EQUALS(keyForInSize(5), keyForInSize(500));
+
+    // Very large lists all share one key.
+    ASSERT_EQ(keyForInSize(512), keyForInSize(2000));
+}
+
 // Cache keys for $geoWithin queries with legacy and GeoJSON coordinates should
 // not be the same.
 TEST(PlanCacheTest, ComputeKeyGeoWithin) {
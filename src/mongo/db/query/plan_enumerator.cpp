@@ -71,6 +71,8 @@ PlanEnumerator::PlanEnumerator(const PlanEnumeratorParams& params)
     : _root(params.root),
       _indices(params.indices),
       _ixisect(params.intersect),
+      _skipScan(params.skipScan),
+      _hasSkipScanAssignments(false),
       _orLimit(params.maxSolutionsPerOr),
       _intersectLimit(params.maxIntersectPerAnd) {}
 
@@ -222,8 +224,24 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         // In order to definitely use an index it must be prefixed with our field.
         // We don't consider notFirst indices here because we must be AND-related to a node
         // that uses the first spot in that index, and we currently do not know that
-        // unless we're in an AND node.
-        if (0 == rt->first.size()) {
+        // unless we're in an AND node. The exception is a skip scan, which we only consider
+        // when no index is prefixed with our field.
+        unique_ptr<PredicateAssignment> pred(new PredicateAssignment());
+        pred->expr = node;
+        pred->first.swap(rt->first);
+        pred->positions.resize(pred->first.size(), 0);
+        if (pred->first.empty() && _skipScan && NULL == context.elemMatchExpr) {
+            for (size_t i = 0; i < rt->notFirst.size(); ++i) {
+                IndexPosition pos;
+                if (canSkipScan(rt->notFirst[i], node, &pos)) {
+                    pred->first.push_back(rt->notFirst[i]);
+                    pred->positions.push_back(pos);
+                    _hasSkipScanAssignments = true;
+                }
+            }
+        }
+
+        if (pred->first.empty()) {
             return false;
         }
 
@@ -232,9 +250,7 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
         NodeAssignment* assign;
         allocateAssignment(node, &assign, &myMemoID);
 
-        assign->pred.reset(new PredicateAssignment());
-        assign->pred->expr = node;
-        assign->pred->first.swap(rt->first);
+        assign->pred.reset(pred.release());
         return true;
     } else if (Indexability::isBoundsGeneratingNot(node)) {
         bool childIndexable = prepMemo(node->getChild(0), childContext);
@@ -386,6 +402,25 @@ bool PlanEnumerator::prepMemo(MatchExpression* node, PrepMemoContext context) {
             }
         }
 
+        // A skip scan is only considered when no index can be used otherwise.
+        const bool trySkipScan = _skipScan && idxToFirst.empty() && subnodes.empty() &&
+            mandatorySubnodes.empty() && NULL == mandatoryPred &&
+            NULL == childContext.elemMatchExpr && !idxToNotFirst.empty();
+
+        if (trySkipScan) {
+            unique_ptr<AndAssignment> skipScanAssignment(new AndAssignment());
+            enumerateSkipScan(idxToNotFirst, skipScanAssignment.get());
+            if (skipScanAssignment->choices.empty()) {
+                return false;
+            }
+
+            size_t myMemoID;
+            NodeAssignment* nodeAssignment;
+            allocateAssignment(node, &nodeAssignment, &myMemoID);
+            nodeAssignment->andAssignment.reset(skipScanAssignment.release());
+            return true;
+        }
+
         // If none of our children can use indices, bail out.
         if (idxToFirst.empty() && (subnodes.size() == 0) && (mandatorySubnodes.size() == 0)) {
             return false;
@@ -645,6 +680,66 @@ void PlanEnumerator::enumerateOneIndex(const IndexToPredMap& idxToFirst,
     }
 }
 
+bool PlanEnumerator::canSkipScan(IndexID idx,
+                                 const MatchExpression* pred,
+                                 IndexPosition* posOut) const {
+    const IndexEntry& index = (*_indices)[idx];
+    if (INDEX_BTREE != index.type || index.sparse) {
+        return false;
+    }
+
+    const RelevantTag* rt = static_cast<const RelevantTag*>(pred->getTag());
+    if (NULL != rt->elemMatchExpr) {
+        return false;
+    }
+
+    IndexPosition pos = 0;
+    BSONObjIterator kpIt(index.keyPattern);
+    while (kpIt.more()) {
+        if (rt->path == kpIt.next().fieldName()) {
+            *posOut = pos;
+            return pos > 0;
+        }
+        ++pos;
+    }
+    return false;
+}
+
+void PlanEnumerator::enumerateSkipScan(const IndexToPredMap& idxToNotFirst,
+                                       AndAssignment* andAssignment) {
+    for (IndexToPredMap::const_iterator it = idxToNotFirst.begin(); it != idxToNotFirst.end();
+         ++it) {
+        vector<MatchExpression*> tryCompound;
+        IndexPosition pos;
+        for (size_t i = 0; i < it->second.size(); ++i) {
+            if (canSkipScan(it->first, it->second[i], &pos)) {
+                tryCompound.push_back(it->second[i]);
+            }
+        }
+        if (tryCompound.empty()) {
+            continue;
+        }
+
+        const IndexEntry& thisIndex = (*_indices)[it->first];
+
+        // As in enumerateOneIndex(), a multikey index only gets one predicate.
+        if (thisIndex.multikey) {
+            tryCompound.resize(1);
+        }
+
+        // None of the predicates is over the leading field, which compound() skips.
+        OneIndexAssignment indexAssign;
+        indexAssign.index = it->first;
+        compound(tryCompound, thisIndex, &indexAssign);
+        invariant(!indexAssign.preds.empty());
+
+        AndEnumerableState state;
+        state.assignments.push_back(indexAssign);
+        andAssignment->choices.push_back(state);
+        _hasSkipScanAssignments = true;
+    }
+}
+
 void PlanEnumerator::enumerateAndIntersect(const IndexToPredMap& idxToFirst,
                                            const IndexToPredMap& idxToNotFirst,
                                            const vector<MemoID>& subnodes,
@@ -1136,7 +1231,8 @@ void PlanEnumerator::tagMemo(size_t id) {
         PredicateAssignment* pa = assign->pred.get();
         verify(NULL == pa->expr->getTag());
         verify(pa->indexToAssign < pa->first.size());
-        pa->expr->setTag(new IndexTag(pa->first[pa->indexToAssign]));
+        pa->expr->setTag(
+            new IndexTag(pa->first[pa->indexToAssign], pa->positions[pa->indexToAssign]));
     } else if (NULL != assign->orAssignment) {
         OrAssignment* oa = assign->orAssignment.get();
         for (size_t i = 0; i < oa->subnodes.size(); ++i) {
@@ -42,6 +42,7 @@ namespace mongo {
 struct PlanEnumeratorParams {
     PlanEnumeratorParams()
         : intersect(false),
+          skipScan(false),
           maxSolutionsPerOr(internalQueryEnumerationMaxOrSolutions),
           maxIntersectPerAnd(internalQueryEnumerationMaxIntersectPerAnd) {}
 
@@ -49,6 +50,11 @@ struct PlanEnumeratorParams {
     // an indexed solution?
     bool intersect;
 
+    // Do we assign predicates over trailing fields of a compound index when no predicate
+    // constrains its leading fields? The index scan then skips over the distinct values of the
+    // unconstrained leading fields.
+    bool skipScan;
+
     // Not owned here.
     MatchExpression* root;
 
@@ -104,6 +110,14 @@ public:
      */
     bool getNext(MatchExpression** tree);
 
+    /**
+     * Returns true if any of the plans which getNext() may output scan an index whose leading
+     * fields are unconstrained. Only meaningful after init().
+     */
+    bool hasSkipScanAssignments() const {
+        return _hasSkipScanAssignments;
+    }
+
 private:
     //
     // Memoization strategy
@@ -177,6 +191,11 @@ private:
         PredicateAssignment() : indexToAssign(0) {}
 
         std::vector<IndexID> first;
+
+        // Parallel to 'first'. The position of the predicate's field in each index, which is zero
+        // unless the index is used for a skip scan.
+        std::vector<IndexPosition> positions;
+
         // Not owned here.
         MatchExpression* expr;
 
@@ -398,6 +417,22 @@ private:
                                  const std::set<IndexID>& mandatoryIndices,
                                  AndAssignment* andAssignment);
 
+    /**
+     * Returns true if 'pred' can be answered by a skip scan over index 'idx', which it uses in
+     * a position other than the first. If so, the position of the predicate's field in the index
+     * is returned through 'posOut'.
+     *
+     * Only btree indexes qualify. Sparse indexes do not, as documents missing the leading fields
+     * may be missing from the index.
+     */
+    bool canSkipScan(IndexID idx, const MatchExpression* pred, IndexPosition* posOut) const;
+
+    /**
+     * Generate assignments of the predicates in 'idxToNotFirst' to indices whose leading fields
+     * are unconstrained by the AND. Outputs the assignments into 'andAssignment'.
+     */
+    void enumerateSkipScan(const IndexToPredMap& idxToNotFirst, AndAssignment* andAssignment);
+
     /**
      * Try to assign predicates in 'tryCompound' to 'thisIndex' as compound assignments.
      * Output the assignments in 'assign'.
@@ -437,6 +472,12 @@ private:
     // Do we output >1 index per AND (index intersection)?
     bool _ixisect;
 
+    // Do we output plans which skip scan an index? See PlanEnumeratorParams::skipScan.
+    bool _skipScan;
+
+    // Set by prepMemo() if it produced at least one skip scan assignment.
+    bool _hasSkipScanAssignments;
+
     // How many enumerations are we willing to produce from each OR?
     size_t _orLimit;
 
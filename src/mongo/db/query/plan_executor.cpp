@@ -557,6 +557,34 @@ void PlanExecutor::enqueue(const BSONObj& obj) {
     _stash.push(obj.getOwned());
 }
 
+PlanExecutor::ExecState PlanExecutor::readAhead(size_t maxBytes) {
+    // getNextImpl() returns stashed results first, so they must be consumed before the plan can
+    // be run ahead of them.
+    if (!_stash.empty()) {
+        return PlanExecutor::ADVANCED;
+    }
+
+    std::queue<BSONObj> ahead;
+    size_t bytes = 0;
+    Snapshotted<BSONObj> obj;
+    ExecState state = PlanExecutor::ADVANCED;
+    while (bytes < maxBytes && PlanExecutor::ADVANCED == (state = getNextImpl(&obj, NULL))) {
+        ahead.push(obj.value().getOwned());
+        bytes += obj.value().objsize();
+    }
+
+    if (PlanExecutor::FAILURE == state || PlanExecutor::DEAD == state) {
+        if (!killed()) {
+            kill(str::stream() << "read-ahead failed: "
+                               << WorkingSetCommon::toStatusString(obj.value()));
+        }
+        return state;
+    }
+
+    _stash.swap(ahead);
+    return state;
+}
+
 //
 // ScopedExecutorRegistration
 //
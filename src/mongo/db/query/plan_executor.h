@@ -369,6 +369,17 @@ public:
      */
     void enqueue(const BSONObj& obj);
 
+    /**
+     * Runs the plan ahead of its consumer, stashing up to about 'maxBytes' of results to be
+     * returned by later calls to getNext(), in order. Does nothing if results are already
+     * stashed. Subsequent calls to getNext() must request the BSONObj and *not* the RecordId.
+     *
+     * Returns the state which ended the read-ahead, or ADVANCED if the byte budget was reached.
+     * On FAILURE or DEAD the executor is killed, discarding the stashed results, so that the
+     * consumer sees the error.
+     */
+    ExecState readAhead(size_t maxBytes);
+
 private:
     ExecState getNextImpl(Snapshotted<BSONObj>* objOut, RecordId* dlOut);
 
@@ -64,6 +64,7 @@ bool PlanYieldPolicy::yield(RecordFetcher* fetcher) {
     // Reset the yield timer in order to prevent from yielding again right away.
     resetTimer();
 
+    const bool forced = _forceYield;
     _forceYield = false;
 
     OperationContext* opCtx = _planYielding->getOpCtx();
@@ -86,6 +87,15 @@ bool PlanYieldPolicy::yield(RecordFetcher* fetcher) {
                 return true;
             }
 
+            // A periodic yield which would neither let anyone else have our locks nor give us a
+            // newer snapshot is skipped, along with the cursor re-seeks restoring would cost.
+            // Forced yields, which follow write conflicts or wait for a fetch, always happen.
+            if (!forced && !fetcher && _policy == PlanExecutor::YIELD_AUTO &&
+                internalQueryExecSkipUnneededYields && !opCtx->lockState()->hasLockWaiters() &&
+                opCtx->recoveryUnit()->isSnapshotCurrent()) {
+                return true;
+            }
+
             try {
                 _planYielding->saveState();
             } catch (const WriteConflictException& wce) {
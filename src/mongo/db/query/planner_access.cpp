@@ -208,6 +208,7 @@ QuerySolutionNode* QueryPlannerAccess::makeLeafNode(
         IndexScanNode* isn = new IndexScanNode();
         isn->indexKeyPattern = index.keyPattern;
         isn->indexIsMultiKey = index.multikey;
+        isn->multikeyComponents = index.multikeyComponents;
         isn->bounds.fields.resize(index.keyPattern.nFields());
         isn->maxScan = query.getParsed().getMaxScan();
         isn->addKeyMetadata = query.getParsed().returnKey();
@@ -1239,6 +1240,7 @@ QuerySolutionNode* QueryPlannerAccess::scanWholeIndex(const IndexEntry& index,
     unique_ptr<IndexScanNode> isn = make_unique<IndexScanNode>();
     isn->indexKeyPattern = index.keyPattern;
     isn->indexIsMultiKey = index.multikey;
+    isn->multikeyComponents = index.multikeyComponents;
     isn->maxScan = query.getParsed().getMaxScan();
     isn->addKeyMetadata = query.getParsed().returnKey();
 
@@ -1375,6 +1377,7 @@ QuerySolutionNode* QueryPlannerAccess::makeIndexScan(const IndexEntry& index,
     IndexScanNode* isn = new IndexScanNode();
     isn->indexKeyPattern = index.keyPattern;
     isn->indexIsMultiKey = index.multikey;
+    isn->multikeyComponents = index.multikeyComponents;
     isn->direction = 1;
     isn->maxScan = query.getParsed().getMaxScan();
     isn->addKeyMetadata = query.getParsed().returnKey();
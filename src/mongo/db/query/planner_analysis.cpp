@@ -210,6 +210,7 @@ void explodeScan(IndexScanNode* isn,
         child->maxScan = isn->maxScan;
         child->addKeyMetadata = isn->addKeyMetadata;
         child->indexIsMultiKey = isn->indexIsMultiKey;
+        child->multikeyComponents = isn->multikeyComponents;
 
         // Copy the filter, if there is one.
         if (isn->filter.get()) {
@@ -579,6 +580,14 @@ QuerySolutionNode* QueryPlannerAnalysis::analyzeSort(const CanonicalQuery& query
         sort->limit = 0;
     }
 
+    // A TEXT stage sorted on nothing but the text score only has to find the 'limit' documents
+    // which score highest, which lets it stop reading the index early.
+    QuerySolutionNode* sortInput = keyGenNode->children[0];
+    if (sort->limit && STAGE_TEXT == sortInput->getType() && 1 == sortObj.nFields() &&
+        LiteParsedQuery::isTextScoreMeta(sortObj.firstElement())) {
+        static_cast<TextNode*>(sortInput)->limit = sort->limit;
+    }
+
     *blockingSortOut = true;
 
     return solnRoot;
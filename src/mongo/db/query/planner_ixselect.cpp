@@ -119,6 +119,30 @@ void QueryPlannerIXSelect::findRelevantIndices(const unordered_set<string>& fiel
     }
 }
 
+// static
+void QueryPlannerIXSelect::findSkipScanIndices(const unordered_set<string>& fields,
+                                               const vector<IndexEntry>& allIndices,
+                                               vector<IndexEntry>* out) {
+    for (size_t i = 0; i < allIndices.size(); ++i) {
+        if (INDEX_BTREE != allIndices[i].type || allIndices[i].sparse) {
+            continue;
+        }
+
+        BSONObjIterator it(allIndices[i].keyPattern);
+        verify(it.more());
+        if (fields.end() != fields.find(it.next().fieldName())) {
+            continue;
+        }
+
+        while (it.more()) {
+            if (fields.end() != fields.find(it.next().fieldName())) {
+                out->push_back(allIndices[i]);
+                break;
+            }
+        }
+    }
+}
+
 // static
 bool QueryPlannerIXSelect::compatible(const BSONElement& elt,
                                       const IndexEntry& index,
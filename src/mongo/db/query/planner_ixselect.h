@@ -58,6 +58,15 @@ public:
                                     const std::vector<IndexEntry>& indices,
                                     std::vector<IndexEntry>* out);
 
+    /**
+     * Find all btree indices which are not prefixed by fields we have predicates over, but
+     * which have a later field we have predicates over. These indices can only be used by
+     * skip scanning over their leading fields.
+     */
+    static void findSkipScanIndices(const unordered_set<std::string>& fields,
+                                    const std::vector<IndexEntry>& indices,
+                                    std::vector<IndexEntry>* out);
+
     /**
      * Return true if the index key pattern field 'elt' (which belongs to 'index') can be used
      * to answer the predicate 'node'.
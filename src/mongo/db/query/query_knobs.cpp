@@ -40,10 +40,16 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanEvaluationMaxResults, int, 101);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheSize, int, 5000);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryStatsCacheSize, int, 1000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryFilterTemplateCacheMaxShapes, int, 1000);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheFeedbacksStored, int, 20);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheEvictionRatio, double, 10.0);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryCacheMaxSizeBytes, long long, 256 * 1024 * 1024);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerMaxIndexedSolutions, int, 64);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxOrSolutions, int, 10);
@@ -52,12 +58,20 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryEnumerationMaxIntersectPerAnd, int, 3
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryForceIntersectionPlans, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanSamplePruningRatio, double, 0.0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanSampleSize, int, 200);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableIndexIntersection, bool, true);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableHashIntersection, bool, false);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlannerEnableSkipScan, bool, false);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenIndependently, bool, true);
 
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryPlanOrChildrenThreads, int, 4);
+
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryMaxScansToExplode, int, 200);
 
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1024 * 1024);
@@ -65,5 +79,34 @@ MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecMaxBlockingSortBytes, int, 32 * 1
 // Yield every 128 cycles or 10ms.
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldIterations, int, 128);
 MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecYieldPeriodMS, int, 10);
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSkipUnneededYields, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecZeroCopyReplyMinBytes, int, 4 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecSorterSpillThreads, int, 2);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollScanFilterThreads, int, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollScanMaxRecordsPerWork, int, 64);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecCollScanReadAheadBytes, int, 16 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryExecEnableSortKeyThreshold, bool, true);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookUpBatchSize, int, 100);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceLookUpMaxHashTableBytes,
+                              long long,
+                              100 * 1024 * 1024);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupPreAggregationSampleSize, int, 10000);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceGroupMinPreAggregationRatio, double, 2.0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceMaxSpillBytes, long long, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalDocumentSourceMaxTotalSpillBytes, long long, 0);
+
+MONGO_EXPORT_SERVER_PARAMETER(internalQueryMapReduceUseNativeFunctions, bool, true);
 
 }  // namespace mongo
@@ -48,12 +48,24 @@ extern int internalQueryPlanEvaluationMaxResults;
 // Do we give a big ranking bonus to intersection plans?
 extern bool internalQueryForceIntersectionPlans;
 
+// Before racing several candidate plans, estimate the keys each single index scan plan will
+// examine from a random sample of the collection, and drop plans estimated to examine more than
+// this many times as many keys as the best one. A value of zero disables the estimates.
+extern double internalQueryPlanSamplePruningRatio;
+
+// How many documents are sampled from a collection for the estimates above.
+extern int internalQueryPlanSampleSize;
+
 // Do we have ixisect on at all?
 extern bool internalQueryPlannerEnableIndexIntersection;
 
 // Do we use hash-based intersection for rooted $and queries?
 extern bool internalQueryPlannerEnableHashIntersection;
 
+// Do we skip scan over the unconstrained leading fields of a compound index when no index is
+// prefixed by a predicate?
+extern bool internalQueryPlannerEnableSkipScan;
+
 //
 // plan cache
 //
@@ -61,6 +73,13 @@ extern bool internalQueryPlannerEnableHashIntersection;
 // How many entries in the cache?
 extern int internalQueryCacheSize;
 
+// How many query shapes does the query statistics table keep? Zero disables it.
+extern int internalQueryStatsCacheSize;
+
+// How many filter shapes does the filter template cache remember how to canonicalize? Zero
+// disables it.
+extern int internalQueryFilterTemplateCacheMaxShapes;
+
 // How many feedback entries do we collect before possibly evicting from the cache based on bad
 // performance?
 extern int internalQueryCacheFeedbacksStored;
@@ -69,6 +88,10 @@ extern int internalQueryCacheFeedbacksStored;
 // and replanning?
 extern double internalQueryCacheEvictionRatio;
 
+// How many bytes may the plan caches of all collections hold in total before the least recently
+// used entries are evicted?
+extern long long internalQueryCacheMaxSizeBytes;
+
 //
 // Planning and enumeration.
 //
@@ -85,6 +108,10 @@ extern int internalQueryEnumerationMaxIntersectPerAnd;
 // Do we want to plan each child of the OR independently?
 extern bool internalQueryPlanOrChildrenIndependently;
 
+// How many threads, counting the query's own, may enumerate plans for the children of a rooted OR
+// at once? Values below two plan the children one after another.
+extern int internalQueryPlanOrChildrenThreads;
+
 // How many index scans are we willing to produce in order to obtain a sort order
 // during explodeForSort?
 extern int internalQueryMaxScansToExplode;
@@ -101,4 +128,69 @@ extern int internalQueryExecYieldIterations;
 // Yield if it's been at least this many milliseconds since we last yielded.
 extern int internalQueryExecYieldPeriodMS;
 
+// Skip a periodic yield when no other operation waits for our locks and the storage engine's
+// snapshot is still current, since releasing them would achieve nothing.
+extern bool internalQueryExecSkipUnneededYields;
+
+// Owned documents of at least this many bytes are attached to legacy find and getMore replies by
+// reference rather than copied into the reply buffer. A value of zero disables this.
+extern int internalQueryExecZeroCopyReplyMinBytes;
+
+// External sorts used by index builds and aggregation sort and write up to this many spilled runs
+// on background threads while the next run is filled. A value of zero spills synchronously.
+extern int internalQueryExecSorterSpillThreads;
+
+// Collection scans with a filter read documents ahead in batches and evaluate the filter over each
+// batch on up to this many threads. A value of zero evaluates the filter one document at a time.
+extern int internalQueryExecCollScanFilterThreads;
+
+// A collection scan skips up to this many documents which fail its filter in a single call to
+// work(), instead of returning NEED_TIME to its parent for each of them.
+extern int internalQueryExecCollScanMaxRecordsPerWork;
+
+// Forward scans over a whole collection let the storage engine read up to this many bytes of
+// records ahead of the scan. A value of zero disables reading ahead.
+extern int internalQueryExecCollScanReadAheadBytes;
+
+// Does a sort with a limit of K pass the sort key of the K-th document it holds down to the stages
+// below it, so that they drop documents which can no longer make the results?
+extern bool internalQueryExecEnableSortKeyThreshold;
+
+//
+// Aggregation.
+//
+
+// $lookUp looks up the foreign documents for this many input documents with a single query.
+extern int internalDocumentSourceLookUpBatchSize;
+
+// $lookUp holds an unindexed foreign collection in memory only while it takes up at most this many
+// bytes, and otherwise scans it once per batch of input documents.
+extern long long internalDocumentSourceLookUpMaxHashTableBytes;
+
+// The shards' part of a split $group checks how well it reduces its input after this many input
+// documents.
+extern int internalDocumentSourceGroupPreAggregationSampleSize;
+
+// If fewer than this many input documents fell into each group on average by then, the shards' part
+// of a split $group stops grouping and passes each remaining document on to the merger as a partial
+// group of its own. A value of zero disables this.
+extern double internalDocumentSourceGroupMinPreAggregationRatio;
+
+// An aggregation fails rather than let the temporary files of its $sort and $group stages hold more
+// than this many bytes at once. A value of zero means no limit.
+extern long long internalDocumentSourceMaxSpillBytes;
+
+// An aggregation also fails rather than let the temporary files of every external sort on the
+// server hold more than this many bytes. Index builds count towards the total but are never
+// refused. A value of zero means no limit.
+extern long long internalDocumentSourceMaxTotalSpillBytes;
+
+//
+// MapReduce.
+//
+
+// Does mapReduce map and reduce natively, outside of the JS engine, when its functions have one of
+// a few common forms?
+extern bool internalQueryMapReduceUseNativeFunctions;
+
 }  // namespace mongo
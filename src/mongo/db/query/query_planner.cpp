@@ -101,6 +101,9 @@ string optionString(size_t options) {
     if (options & QueryPlannerParams::KEEP_MUTATIONS) {
         ss << "KEEP_MUTATIONS";
     }
+    if (options & QueryPlannerParams::INDEX_SKIP_SCAN) {
+        ss << "INDEX_SKIP_SCAN ";
+    }
 
     return ss;
 }
@@ -530,6 +533,9 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
 
     if (hintIndex.isEmpty()) {
         QueryPlannerIXSelect::findRelevantIndices(fields, params.indices, &relevantIndices);
+        if (params.options & QueryPlannerParams::INDEX_SKIP_SCAN) {
+            QueryPlannerIXSelect::findSkipScanIndices(fields, params.indices, &relevantIndices);
+        }
     } else {
         // Sigh.  If the hint is specified it might be using the index name.
         BSONElement firstHintElt = hintIndex.firstElement();
@@ -729,16 +735,23 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         LOG(5) << "Rated tree after text processing:" << query.root()->toString();
     }
 
+    // Whether any of the indexed plans may skip scan an index. The benefit of a skip scan depends
+    // on the number of distinct values of the index's leading fields, of which the planner knows
+    // nothing, so these plans are always ranked against a collection scan.
+    bool skipScanEnumerated = false;
+
     // If we have any relevant indices, we try to create indexed plans.
     if (0 < relevantIndices.size()) {
         // The enumerator spits out trees tagged with IndexTag(s).
         PlanEnumeratorParams enumParams;
         enumParams.intersect = params.options & QueryPlannerParams::INDEX_INTERSECTION;
+        enumParams.skipScan = params.options & QueryPlannerParams::INDEX_SKIP_SCAN;
         enumParams.root = query.root();
         enumParams.indices = &relevantIndices;
 
         PlanEnumerator isp(enumParams);
         isp.init();
+        skipScanEnumerated = isp.hasSkipScanAssignments();
 
         MatchExpression* rawTree;
         while (isp.getNext(&rawTree) && (out->size() < params.maxIndexedSolutions)) {
@@ -904,7 +917,8 @@ Status QueryPlanner::plan(const CanonicalQuery& query,
         !QueryPlannerCommon::hasNode(query.root(), MatchExpression::TEXT) && hintIndex.isEmpty();
 
     // The caller can explicitly ask for a collscan.
-    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN);
+    bool collscanRequested = (params.options & QueryPlannerParams::INCLUDE_COLLSCAN) ||
+        (skipScanEnumerated && canTableScan);
 
     // No indexed plans?  We must provide a collscan if possible or else we can't run the query.
     bool collscanNeeded = (0 == out->size() && canTableScan);
@@ -96,6 +96,11 @@ struct QueryPlannerParams {
         // Set this if you don't want any plans with a non-covered projection stage. All projections
         // must be provided/covered by an index.
         NO_UNCOVERED_PROJECTIONS = 1 << 10,
+
+        // Set this if you want to consider scanning a compound index whose leading fields are
+        // unconstrained by the query, skipping over their distinct values. Such plans are always
+        // ranked against a collection scan.
+        INDEX_SKIP_SCAN = 1 << 11,
     };
 
     // See Options enum above.
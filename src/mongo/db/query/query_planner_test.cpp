@@ -1280,6 +1280,27 @@ TEST_F(QueryPlannerTest, BasicCovering) {
         "{cscan: {dir: 1, filter: {x:{$gt:1}}}}}}");
 }
 
+TEST_F(QueryPlannerTest, MultikeyCoveringOfComponentWithoutArrays) {
+    // true means multikey, only 'b' has arrays.
+    addIndex(BSON("a" << 1 << "b" << 1), true);
+    params.indices.back().multikeyComponents = 1ULL << 1;
+    runQuerySortProj(fromjson("{a: {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, a: 1}"));
+
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: {ixscan: "
+        "{filter: null, pattern: {a: 1, b: 1}}}}}");
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, a: 1}, node: "
+        "{cscan: {dir: 1, filter: {a:{$gt:1}}}}}}");
+
+    runQuerySortProj(fromjson("{a: {$gt: 1}}"), BSONObj(), fromjson("{_id: 0, b: 1}"));
+    ASSERT_EQUALS(getNumSolutions(), 2U);
+    assertSolutionExists(
+        "{proj: {spec: {_id: 0, b: 1}, node: {fetch: {filter: null, node: {ixscan: "
+        "{filter: null, pattern: {a: 1, b: 1}}}}}}}");
+}
+
 TEST_F(QueryPlannerTest, DottedFieldCovering) {
     addIndex(BSON("a.b" << 1));
     runQuerySortProj(fromjson("{'a.b': 5}"), BSONObj(), fromjson("{_id: 0, 'a.b': 1}"));
@@ -4032,4 +4053,87 @@ TEST_F(QueryPlannerTest, NToReturnHackWithSingleBatch) {
         "{cscan: {dir:1, filter: {}}}}}}}");
 }
 
+//
+// Skip scans over the unconstrained leading fields of compound indexes
+//
+
+TEST_F(QueryPlannerTest, SkipScanNotConsideredByDefault) {
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanLeadingFieldUnconstrained) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    // The skip scan is always ranked against a collection scan.
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanCompoundsTrailingPredicates) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1 << "c" << 1));
+    runQuery(fromjson("{b: 5, c: {$gt: 1}}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1, c: 1}, "
+        "bounds: {a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]], "
+        "c: [[1,Infinity,false,true]]}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedWhenPrefixedIndexExists) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {b: 1}}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanUnderOr) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    addIndex(BSON("c" << 1));
+    runQuery(fromjson("{$or: [{b: 5}, {c: 6}]}"));
+
+    assertNumSolutions(2U);
+    assertSolutionExists("{cscan: {dir: 1}}");
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {or: {nodes: ["
+        "{ixscan: {filter: null, pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}},"
+        "{ixscan: {filter: null, pattern: {c: 1}}}]}}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanNotUsedForSparseIndex) {
+    params.options = QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1), false, true);
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists("{cscan: {dir: 1, filter: {b: 5}}}");
+}
+
+TEST_F(QueryPlannerTest, SkipScanWithNoTableScan) {
+    params.options = QueryPlannerParams::NO_TABLE_SCAN | QueryPlannerParams::INDEX_SKIP_SCAN;
+    addIndex(BSON("a" << 1 << "b" << 1));
+    runQuery(fromjson("{b: 5}"));
+
+    assertNumSolutions(1U);
+    assertSolutionExists(
+        "{fetch: {filter: null, node: {ixscan: {filter: null, pattern: {a: 1, b: 1}, bounds: "
+        "{a: [['MinKey','MaxKey',true,true]], b: [[5,5,true,true]]}}}}}");
+}
+
 }  // namespace
@@ -82,6 +82,10 @@ void TextNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     *ss << "diacriticSensitive= " << diacriticSensitive << '\n';
     addIndent(ss, indent + 1);
     *ss << "indexPrefix = " << indexPrefix.toString() << '\n';
+    if (limit) {
+        addIndent(ss, indent + 1);
+        *ss << "limit = " << limit << '\n';
+    }
     if (NULL != filter) {
         addIndent(ss, indent + 1);
         *ss << " filter = " << filter->toString();
@@ -100,6 +104,7 @@ QuerySolutionNode* TextNode::clone() const {
     copy->caseSensitive = this->caseSensitive;
     copy->diacriticSensitive = this->diacriticSensitive;
     copy->indexPrefix = this->indexPrefix;
+    copy->limit = this->limit;
 
     return copy;
 }
@@ -396,7 +401,12 @@ QuerySolutionNode* FetchNode::clone() const {
 //
 
 IndexScanNode::IndexScanNode()
-    : indexIsMultiKey(false), direction(1), maxScan(0), addKeyMetadata(false) {}
+    : indexIsMultiKey(false),
+      multikeyComponents(~0ULL),
+      direction(1),
+      maxScan(0),
+      addKeyMetadata(false),
+      estimatedKeysExamined(-1) {}
 
 void IndexScanNode::appendToString(mongoutils::str::stream* ss, int indent) const {
     addIndent(ss, indent);
@@ -415,23 +425,21 @@ void IndexScanNode::appendToString(mongoutils::str::stream* ss, int indent) cons
 }
 
 bool IndexScanNode::hasField(const string& field) const {
-    // There is no covering in a multikey index because you don't know whether or not the field
-    // in the key was extracted from an array in the original document.
-    if (indexIsMultiKey) {
-        return false;
-    }
-
     // Custom index access methods may return non-exact key data - this function is currently
     // used for covering exact key data only.
     if (IndexNames::BTREE != IndexNames::findPluginName(indexKeyPattern)) {
         return false;
     }
 
+    int position = 0;
     BSONObjIterator it(indexKeyPattern);
     while (it.more()) {
         if (field == it.next().fieldName()) {
-            return true;
+            // A field of a multikey index can't be covered if it may have come from an array in
+            // the original document, because the key only holds one of the array's elements.
+            return !indexIsMultiKey || !(multikeyComponents & (1ULL << position));
         }
+        position++;
     }
     return false;
 }
@@ -573,10 +581,12 @@ QuerySolutionNode* IndexScanNode::clone() const {
     copy->_sorts = this->_sorts;
     copy->indexKeyPattern = this->indexKeyPattern;
     copy->indexIsMultiKey = this->indexIsMultiKey;
+    copy->multikeyComponents = this->multikeyComponents;
     copy->direction = this->direction;
     copy->maxScan = this->maxScan;
     copy->addKeyMetadata = this->addKeyMetadata;
     copy->bounds = this->bounds;
+    copy->estimatedKeysExamined = this->estimatedKeysExamined;
 
     return copy;
 }
@@ -256,6 +256,10 @@ struct TextNode : public QuerySolutionNode {
     // text node while creating the text leaf node and convert them into a BSONObj index prefix
     // when we finish the text leaf node.
     BSONObj indexPrefix;
+
+    // If nonzero, only the 'limit' documents with the highest text scores are needed, because the
+    // node is the input of a sort on the text score with that limit.
+    size_t limit = 0;
 };
 
 struct CollectionScanNode : public QuerySolutionNode {
@@ -466,6 +470,9 @@ struct IndexScanNode : public QuerySolutionNode {
 
     BSONObj indexKeyPattern;
     bool indexIsMultiKey;
+    // If the index is multikey, the components of 'indexKeyPattern' which may have come from
+    // arrays (see IndexEntry::multikeyComponents).
+    unsigned long long multikeyComponents;
 
     int direction;
 
@@ -480,6 +487,10 @@ struct IndexScanNode : public QuerySolutionNode {
     // If you use the complex bounds, we force Btree access.
     // The complex bounds require Btree access.
     IndexBounds bounds;
+
+    // How many keys the planner estimates this scan will examine, or a negative value if it
+    // made no estimate. Reported by explain.
+    double estimatedKeysExamined;
 };
 
 struct ProjectionNode : public QuerySolutionNode {
@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats.h"
+
+#include <cmath>
+
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/db/service_context.h"
+
+namespace mongo {
+
+namespace {
+
+const auto getQueryStatsStore = ServiceContext::declareDecoration<QueryStatsStore>();
+
+// Larger example queries are left out, so that each entry stays small.
+const int kMaxExampleQueryBytes = 1024;
+
+}  // namespace
+
+long long QueryStatsEntry::getLatencyPercentileMicros(double percentile) const {
+    const uint64_t rank = std::max(uint64_t(1), uint64_t(std::ceil(percentile * execCount)));
+    uint64_t seen = 0;
+    for (int i = 0; i < OperationLatencyHistogram::kMaxBuckets; i++) {
+        seen += latencyBuckets[i];
+        if (seen >= rank) {
+            return i + 1 < OperationLatencyHistogram::kMaxBuckets
+                ? OperationLatencyHistogram::getBucketLowerBound(i + 1)
+                : OperationLatencyHistogram::getBucketLowerBound(i);
+        }
+    }
+    return 0;
+}
+
+void QueryStatsEntry::appendTo(BSONObjBuilder* builder) const {
+    builder->append("ns", ns);
+    builder->append("shape", shape);
+    if (!exampleQuery.isEmpty()) {
+        builder->append("query", exampleQuery);
+    }
+    builder->append("planSummary", planSummary);
+    builder->appendNumber("execCount", execCount);
+    {
+        BSONObjBuilder latencyBuilder(builder->subobjStart("latencyMicros"));
+        latencyBuilder.appendNumber("total", totalLatencyMicros);
+        latencyBuilder.appendNumber("p50", getLatencyPercentileMicros(0.5));
+        latencyBuilder.appendNumber("p99", getLatencyPercentileMicros(0.99));
+    }
+    builder->appendNumber("keysExamined", keysExamined);
+    builder->appendNumber("docsExamined", docsExamined);
+    builder->appendNumber("nreturned", nreturned);
+    builder->appendDate("firstSeen", firstSeen);
+    builder->appendDate("lastSeen", lastSeen);
+}
+
+QueryStatsStore& QueryStatsStore::get(ServiceContext* service) {
+    return getQueryStatsStore(service);
+}
+
+bool QueryStatsStore::isEnabled() {
+    return internalQueryStatsCacheSize > 0;
+}
+
+void QueryStatsStore::record(const CanonicalQuery& query,
+                             const PlanCacheKey& shape,
+                             const Metrics& metrics,
+                             const stdx::function<std::string()>& getPlanSummary) {
+    const int capacity = internalQueryStatsCacheSize;
+    if (capacity <= 0) {
+        return;
+    }
+
+    // The key cannot be ambiguous, since namespaces contain no null characters.
+    std::string key = query.ns();
+    key.push_back('\0');
+    key += shape;
+
+    const Date_t now = Date_t::now();
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_entries || _capacity != capacity) {
+        _entries.reset(new LRUKeyValue<std::string, QueryStatsEntry>(capacity));
+        _capacity = capacity;
+    }
+
+    QueryStatsEntry* entry;
+    if (!_entries->get(key, &entry).isOK()) {
+        entry = new QueryStatsEntry();
+        entry->ns = query.ns();
+        entry->shape = shape;
+
+        const LiteParsedQuery& parsed = query.getParsed();
+        BSONObjBuilder exampleBuilder;
+        exampleBuilder.append("filter", parsed.getFilter());
+        if (!parsed.getSort().isEmpty()) {
+            exampleBuilder.append("sort", parsed.getSort());
+        }
+        if (!parsed.getProj().isEmpty()) {
+            exampleBuilder.append("projection", parsed.getProj());
+        }
+        if (exampleBuilder.len() <= kMaxExampleQueryBytes) {
+            entry->exampleQuery = exampleBuilder.obj();
+        }
+
+        entry->planSummary = getPlanSummary();
+        entry->firstSeen = now;
+        _entries->add(key, entry);
+    }
+
+    entry->execCount++;
+    entry->totalLatencyMicros += metrics.latencyMicros;
+    entry->keysExamined += metrics.keysExamined;
+    entry->docsExamined += metrics.docsExamined;
+    entry->nreturned += metrics.nreturned;
+    entry->latencyBuckets[OperationLatencyHistogram::getBucket(
+        std::max(metrics.latencyMicros, 0LL))]++;
+    entry->lastSeen = now;
+}
+
+std::vector<BSONObj> QueryStatsStore::getStats(const NamespaceString& ns) const {
+    std::vector<BSONObj> stats;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_entries) {
+        return stats;
+    }
+
+    for (auto it = _entries->begin(); it != _entries->end(); ++it) {
+        const QueryStatsEntry& entry = *it->second;
+        if (entry.ns != ns.ns()) {
+            continue;
+        }
+        BSONObjBuilder builder;
+        entry.appendTo(&builder);
+        stats.push_back(builder.obj());
+    }
+    return stats;
+}
+
+void QueryStatsStore::clear() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _entries.reset();
+}
+
+}  // namespace mongo
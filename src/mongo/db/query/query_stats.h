@@ -0,0 +1,142 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/stats/operation_latency_histogram.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class ServiceContext;
+
+/**
+ * Statistics of the executions of one query shape against one namespace.
+ */
+struct QueryStatsEntry {
+    std::string ns;
+    PlanCacheKey shape;
+
+    // The first query of this shape, if it was small enough to keep.
+    BSONObj exampleQuery;
+
+    // The plan summary of the first query of this shape.
+    std::string planSummary;
+
+    long long execCount = 0;
+    long long totalLatencyMicros = 0;
+    long long keysExamined = 0;
+    long long docsExamined = 0;
+    long long nreturned = 0;
+    std::array<uint64_t, OperationLatencyHistogram::kMaxBuckets> latencyBuckets{};
+
+    Date_t firstSeen;
+    Date_t lastSeen;
+
+    /**
+     * Returns the upper bound of the latency bucket which holds the 'percentile'th latency.
+     */
+    long long getLatencyPercentileMicros(double percentile) const;
+
+    /**
+     * Appends {ns, shape, query, planSummary, execCount, latencyMicros: {total, p50, p99},
+     * keysExamined, docsExamined, nreturned, firstSeen, lastSeen}.
+     */
+    void appendTo(BSONObjBuilder* builder) const;
+};
+
+/**
+ * An in-memory table of the statistics of the finds each query shape ran, keyed by namespace and
+ * by the plan cache key of the query. Unlike the profiler, it costs no writes, and it also
+ * accounts for frequent queries that are too fast to be profiled.
+ *
+ * Holds at most internalQueryStatsCacheSize shapes, evicting the least recently run. Setting the
+ * parameter to zero disables it; changing it clears the table.
+ *
+ * Thread safe.
+ */
+class QueryStatsStore {
+    MONGO_DISALLOW_COPYING(QueryStatsStore);
+
+public:
+    struct Metrics {
+        long long latencyMicros = 0;
+        long long keysExamined = 0;
+        long long docsExamined = 0;
+        long long nreturned = 0;
+    };
+
+    QueryStatsStore() = default;
+
+    static QueryStatsStore& get(ServiceContext* service);
+
+    /**
+     * Returns whether record() keeps statistics, so that callers can skip computing its
+     * arguments otherwise.
+     */
+    static bool isEnabled();
+
+    /**
+     * Records an execution of 'query', whose plan cache key is 'shape'. 'getPlanSummary' is only
+     * called for a shape not in the table.
+     */
+    void record(const CanonicalQuery& query,
+                const PlanCacheKey& shape,
+                const Metrics& metrics,
+                const stdx::function<std::string()>& getPlanSummary);
+
+    /**
+     * Returns the statistics of the shapes run against 'ns', most recently run first.
+     */
+    std::vector<BSONObj> getStats(const NamespaceString& ns) const;
+
+    void clear();
+
+private:
+    // Protects all below.
+    mutable stdx::mutex _mutex;
+
+    // Created on first use, and recreated when the size limit changes.
+    std::unique_ptr<LRUKeyValue<std::string, QueryStatsEntry>> _entries;
+    int _capacity = 0;
+};
+
+}  // namespace mongo
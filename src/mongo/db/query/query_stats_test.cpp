@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/query_stats.h"
+
+#include "mongo/db/json.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString nss("test.collection");
+
+std::unique_ptr<CanonicalQuery> canonicalize(const char* queryStr) {
+    auto statusWithCQ = CanonicalQuery::canonicalize(nss, fromjson(queryStr));
+    ASSERT_OK(statusWithCQ.getStatus());
+    return std::move(statusWithCQ.getValue());
+}
+
+QueryStatsStore::Metrics makeMetrics(long long latencyMicros, long long docsExamined) {
+    QueryStatsStore::Metrics metrics;
+    metrics.latencyMicros = latencyMicros;
+    metrics.docsExamined = docsExamined;
+    metrics.nreturned = 1;
+    return metrics;
+}
+
+std::string planSummary() {
+    return "COLLSCAN";
+}
+
+TEST(QueryStatsTest, AggregatesByShape) {
+    QueryStatsStore store;
+    PlanCache planCache;
+
+    auto cq1 = canonicalize("{a: 1}");
+    auto cq2 = canonicalize("{a: 2}");
+    auto cq3 = canonicalize("{b: 1}");
+    store.record(*cq1, planCache.computeKey(*cq1), makeMetrics(10, 5), planSummary);
+    store.record(*cq2, planCache.computeKey(*cq2), makeMetrics(1000, 7), planSummary);
+    store.record(*cq3, planCache.computeKey(*cq3), makeMetrics(20, 1), planSummary);
+
+    auto stats = store.getStats(nss);
+    ASSERT_EQUALS(2U, stats.size());
+
+    // The most recently run shape comes first.
+    ASSERT_EQUALS(fromjson("{filter: {b: 1}}"), stats[0]["query"].Obj());
+    ASSERT_EQUALS(1, stats[0]["execCount"].numberLong());
+
+    BSONObj aStats = stats[1];
+    ASSERT_EQUALS(fromjson("{filter: {a: 1}}"), aStats["query"].Obj());
+    ASSERT_EQUALS("COLLSCAN", aStats["planSummary"].String());
+    ASSERT_EQUALS(2, aStats["execCount"].numberLong());
+    ASSERT_EQUALS(1010, aStats["latencyMicros"]["total"].numberLong());
+    ASSERT_EQUALS(12, aStats["latencyMicros"]["p50"].numberLong());
+    ASSERT_EQUALS(1024, aStats["latencyMicros"]["p99"].numberLong());
+    ASSERT_EQUALS(12, aStats["docsExamined"].numberLong());
+    ASSERT_EQUALS(2, aStats["nreturned"].numberLong());
+
+    ASSERT_TRUE(store.getStats(NamespaceString("test.other")).empty());
+}
+
+TEST(QueryStatsTest, EvictsLeastRecentlyRun) {
+    const int oldCacheSize = internalQueryStatsCacheSize;
+    internalQueryStatsCacheSize = 1;
+
+    QueryStatsStore store;
+    PlanCache planCache;
+    auto cq1 = canonicalize("{a: 1}");
+    auto cq2 = canonicalize("{b: 1}");
+    store.record(*cq1, planCache.computeKey(*cq1), makeMetrics(10, 1), planSummary);
+    store.record(*cq2, planCache.computeKey(*cq2), makeMetrics(10, 1), planSummary);
+
+    auto stats = store.getStats(nss);
+    ASSERT_EQUALS(1U, stats.size());
+    ASSERT_EQUALS(fromjson("{filter: {b: 1}}"), stats[0]["query"].Obj());
+
+    // A size of zero disables the table.
+    internalQueryStatsCacheSize = 0;
+    ASSERT_FALSE(QueryStatsStore::isEnabled());
+    store.record(*cq1, planCache.computeKey(*cq1), makeMetrics(10, 1), planSummary);
+    ASSERT_EQUALS(1U, store.getStats(nss).size());
+
+    internalQueryStatsCacheSize = oldCacheSize;
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/reply_batch_builder.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+namespace {
+// Size of the buffers started for copied documents once a document has been referenced.
+const int kFollowingBufSize = 4096;
+}  // namespace
+
+ReplyBatchBuilder::ReplyBatchBuilder(int initialBufSize)
+    : _buf(stdx::make_unique<BufBuilder>(initialBufSize)) {
+    _buf->skip(sizeof(QueryResult::Value));
+}
+
+void ReplyBatchBuilder::append(const BSONObj& obj) {
+    const int minReferenceBytes = internalQueryExecZeroCopyReplyMinBytes;
+    if (minReferenceBytes <= 0 || !obj.isOwned() || obj.objsize() < minReferenceBytes) {
+        if (!_buf) {
+            _buf = stdx::make_unique<BufBuilder>(kFollowingBufSize);
+        }
+        _buf->appendBuf(obj.objdata(), obj.objsize());
+        return;
+    }
+
+    _flush();
+    _message.appendReference(obj);
+    _flushedLen += obj.objsize();
+    _numReferenced++;
+}
+
+QueryResult::View ReplyBatchBuilder::done(Message* out) {
+    _flush();
+    *out = std::move(_message);
+
+    QueryResult::View qr = out->header().view2ptr();
+    invariant(qr.msgdata().getLen() == _flushedLen);
+    return qr;
+}
+
+void ReplyBatchBuilder::_flush() {
+    if (!_buf) {
+        return;
+    }
+    // Message::appendData() takes ownership of the buffer.
+    const int len = _buf->len();
+    _message.appendData(_buf->buf(), len);
+    _buf->decouple();
+    _buf.reset();
+    _flushedLen += len;
+}
+
+}  // namespace mongo
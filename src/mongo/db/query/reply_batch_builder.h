@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/dbmessage.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+class BSONObj;
+
+/**
+ * Accumulates the documents of an OP_REPLY batch generated by a legacy find or getMore.
+ *
+ * Unowned documents, and documents smaller than internalQueryExecZeroCopyReplyMinBytes, are
+ * copied into contiguous buffers. Larger owned documents, such as those read from a RecordStore
+ * that hands out its own copy of each record, are attached to the reply by reference instead, so
+ * the bytes go straight from their original buffer to the socket in a single vectored send.
+ */
+class ReplyBatchBuilder {
+    MONGO_DISALLOW_COPYING(ReplyBatchBuilder);
+
+public:
+    /**
+     * 'initialBufSize' is the initial size of the buffer holding the reply header and the
+     * documents which are copied before the first referenced one.
+     */
+    explicit ReplyBatchBuilder(int initialBufSize);
+
+    void append(const BSONObj& obj);
+
+    /**
+     * Total size of the reply in bytes, including the QueryResult header.
+     */
+    int len() const {
+        return _flushedLen + (_buf ? _buf->len() : 0);
+    }
+
+    /**
+     * Number of documents that were attached by reference rather than copied.
+     */
+    int numReferenced() const {
+        return _numReferenced;
+    }
+
+    /**
+     * Moves the batch into 'out', which must be empty, and returns a view of the reply header
+     * with its message length set. The caller is responsible for filling in the remaining
+     * header fields. The builder may not be used afterwards.
+     */
+    QueryResult::View done(Message* out);
+
+private:
+    void _flush();
+
+    // Buffer for copied documents which follow the last referenced one. The first buffer also
+    // holds the QueryResult header.
+    std::unique_ptr<BufBuilder> _buf;
+    Message _message;
+    int _flushedLen = 0;
+    int _numReferenced = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,171 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/query/reply_batch_builder.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/query/query_knobs.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+
+namespace {
+
+class ReplyBatchBuilderTest : public unittest::Test {
+public:
+    void setUp() final {
+        _savedMinBytes = internalQueryExecZeroCopyReplyMinBytes;
+        internalQueryExecZeroCopyReplyMinBytes = 64;
+    }
+
+    void tearDown() final {
+        internalQueryExecZeroCopyReplyMinBytes = _savedMinBytes;
+    }
+
+private:
+    int _savedMinBytes;
+};
+
+BSONObj makeDoc(int id, size_t padding) {
+    return BSON("_id" << id << "pad" << std::string(padding, 'x'));
+}
+
+/**
+ * Finishes 'builder' into a message and returns the documents it contains after flattening the
+ * message into a single buffer.
+ */
+std::vector<BSONObj> finish(ReplyBatchBuilder* builder, int nReturned, size_t* numBuffers) {
+    Message msg;
+    QueryResult::View qr = builder->done(&msg);
+    qr.msgdata().setOperation(opReply);
+    qr.setNReturned(nReturned);
+    *numBuffers = msg.numBuffers();
+
+    ASSERT_EQ(builder->len(), msg.size());
+    msg.concat();
+
+    std::vector<BSONObj> docs;
+    QueryResult::View flat = msg.singleData().view2ptr();
+    const char* data = flat.data();
+    for (int i = 0; i < flat.getNReturned(); ++i) {
+        BSONObj doc(data);
+        docs.push_back(doc.getOwned());
+        data += doc.objsize();
+    }
+    ASSERT_EQ(flat.view2ptr() + flat.msgdata().getLen(), data);
+    return docs;
+}
+
+TEST_F(ReplyBatchBuilderTest, SmallDocumentsAreCopied) {
+    ReplyBatchBuilder builder(512);
+    std::vector<BSONObj> input{makeDoc(0, 1), makeDoc(1, 2), makeDoc(2, 3)};
+    for (const auto& doc : input) {
+        builder.append(doc);
+    }
+    ASSERT_EQ(0, builder.numReferenced());
+
+    size_t numBuffers;
+    std::vector<BSONObj> output = finish(&builder, input.size(), &numBuffers);
+    ASSERT_EQ(1U, numBuffers);
+    ASSERT_EQ(input.size(), output.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        ASSERT_EQ(input[i], output[i]);
+    }
+}
+
+TEST_F(ReplyBatchBuilderTest, LargeOwnedDocumentsAreReferenced) {
+    ReplyBatchBuilder builder(512);
+    std::vector<BSONObj> input{
+        makeDoc(0, 1), makeDoc(1, 200), makeDoc(2, 300), makeDoc(3, 2), makeDoc(4, 3)};
+    for (const auto& doc : input) {
+        ASSERT(doc.isOwned());
+        builder.append(doc);
+    }
+    ASSERT_EQ(2, builder.numReferenced());
+
+    // The header and first document, the two referenced documents, and the two documents
+    // copied after them.
+    size_t numBuffers;
+    std::vector<BSONObj> output = finish(&builder, input.size(), &numBuffers);
+    ASSERT_EQ(4U, numBuffers);
+    ASSERT_EQ(input.size(), output.size());
+    for (size_t i = 0; i < input.size(); ++i) {
+        ASSERT_EQ(input[i], output[i]);
+    }
+}
+
+TEST_F(ReplyBatchBuilderTest, ReferencedDocumentsOutliveCallerCopies) {
+    ReplyBatchBuilder builder(512);
+    BSONObj expected = makeDoc(0, 500);
+    {
+        BSONObj doc = expected.copy();
+        builder.append(doc);
+    }
+    ASSERT_EQ(1, builder.numReferenced());
+
+    size_t numBuffers;
+    std::vector<BSONObj> output = finish(&builder, 1, &numBuffers);
+    ASSERT_EQ(2U, numBuffers);
+    ASSERT_EQ(1U, output.size());
+    ASSERT_EQ(expected, output[0]);
+}
+
+TEST_F(ReplyBatchBuilderTest, UnownedDocumentsAreCopied) {
+    ReplyBatchBuilder builder(512);
+    BSONObj owned = makeDoc(0, 500);
+    BSONObj unowned(owned.objdata());
+    ASSERT(!unowned.isOwned());
+    builder.append(unowned);
+    ASSERT_EQ(0, builder.numReferenced());
+
+    size_t numBuffers;
+    std::vector<BSONObj> output = finish(&builder, 1, &numBuffers);
+    ASSERT_EQ(1U, numBuffers);
+    ASSERT_EQ(owned, output[0]);
+}
+
+TEST_F(ReplyBatchBuilderTest, ReferencingCanBeDisabled) {
+    internalQueryExecZeroCopyReplyMinBytes = 0;
+    ReplyBatchBuilder builder(512);
+    builder.append(makeDoc(0, 500));
+    ASSERT_EQ(0, builder.numReferenced());
+
+    size_t numBuffers;
+    std::vector<BSONObj> output = finish(&builder, 1, &numBuffers);
+    ASSERT_EQ(1U, numBuffers);
+    ASSERT_EQ(makeDoc(0, 500), output[0]);
+}
+
+}  // namespace
+
+}  // namespace mongo
@@ -63,6 +63,33 @@ namespace mongo {
 using std::unique_ptr;
 using stdx::make_unique;
 
+PlanStage* buildStages(OperationContext* txn,
+                       Collection* collection,
+                       const QuerySolution& qsol,
+                       const QuerySolutionNode* root,
+                       WorkingSet* ws);
+
+namespace {
+
+PlanStage* buildAndHashStage(OperationContext* txn,
+                             Collection* collection,
+                             const QuerySolution& qsol,
+                             const AndHashNode* ahn,
+                             WorkingSet* ws,
+                             AndHashStage::Mode mode) {
+    auto ret = make_unique<AndHashStage>(txn, ws, collection, mode);
+    for (size_t i = 0; i < ahn->children.size(); ++i) {
+        PlanStage* childStage = buildStages(txn, collection, qsol, ahn->children[i], ws);
+        if (NULL == childStage) {
+            return NULL;
+        }
+        ret->addChild(childStage);
+    }
+    return ret.release();
+}
+
+}  // namespace
+
 PlanStage* buildStages(OperationContext* txn,
                        Collection* collection,
                        const QuerySolution& qsol,
@@ -99,10 +126,20 @@ PlanStage* buildStages(OperationContext* txn,
         params.direction = ixn->direction;
         params.maxScan = ixn->maxScan;
         params.addKeyMetadata = ixn->addKeyMetadata;
+        params.estimatedKeysExamined = ixn->estimatedKeysExamined;
         return new IndexScan(txn, params, ws, ixn->filter.get());
     } else if (STAGE_FETCH == root->getType()) {
         const FetchNode* fn = static_cast<const FetchNode*>(root);
-        PlanStage* childStage = buildStages(txn, collection, qsol, fn->children[0], ws);
+        PlanStage* childStage;
+        if (STAGE_AND_HASH == fn->children[0]->getType()) {
+            // The fetch replaces whatever the intersection would merge from the children's
+            // index keys, so the AND only has to intersect RecordIds.
+            const AndHashNode* ahn = static_cast<const AndHashNode*>(fn->children[0]);
+            childStage = buildAndHashStage(
+                txn, collection, qsol, ahn, ws, AndHashStage::Mode::kRecordIdsOnly);
+        } else {
+            childStage = buildStages(txn, collection, qsol, fn->children[0], ws);
+        }
         if (NULL == childStage) {
             return NULL;
         }
@@ -166,15 +203,8 @@ PlanStage* buildStages(OperationContext* txn,
         return new SkipStage(txn, sn->skip, ws, childStage);
     } else if (STAGE_AND_HASH == root->getType()) {
         const AndHashNode* ahn = static_cast<const AndHashNode*>(root);
-        auto ret = make_unique<AndHashStage>(txn, ws, collection);
-        for (size_t i = 0; i < ahn->children.size(); ++i) {
-            PlanStage* childStage = buildStages(txn, collection, qsol, ahn->children[i], ws);
-            if (NULL == childStage) {
-                return NULL;
-            }
-            ret->addChild(childStage);
-        }
-        return ret.release();
+        return buildAndHashStage(
+            txn, collection, qsol, ahn, ws, AndHashStage::Mode::kMergeMembers);
     } else if (STAGE_OR == root->getType()) {
         const OrNode* orn = static_cast<const OrNode*>(root);
         auto ret = make_unique<OrStage>(txn, ws, orn->dedup, orn->filter.get());
@@ -275,6 +305,7 @@ PlanStage* buildStages(OperationContext* txn,
         params.index = index;
         params.spec = fam->getSpec();
         params.indexPrefix = node->indexPrefix;
+        params.limit = node->limit;
 
         const std::string& language =
             ("" == node->language ? fam->getSpec().defaultLanguage().str() : node->language);
@@ -75,6 +75,10 @@ enum StageType {
     STAGE_IXSCAN,
     STAGE_LIMIT,
 
+    // The ID Hack for an $in over _id values.
+    STAGE_MULTI_IDHACK,
+
+
     // Implements parallelCollectionScan.
     STAGE_MULTI_ITERATOR,
 
@@ -36,6 +36,7 @@
 #include <memory>
 
 #include "mongo/db/client.h"
+#include "mongo/db/concurrency/locker.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/write_concern_options.h"
@@ -493,6 +494,7 @@ void RangeDeleter::doWork() {
 
         {
             auto txn = client->makeOperationContext();
+            txn->lockState()->setIsBackgroundOperation(true);
             nextTask->stats.deleteStartTS = jsTime();
             bool delResult =
                 _env->deleteRange(txn.get(), *nextTask, &nextTask->stats.deletedDocCount, &errMsg);
@@ -43,6 +43,7 @@
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/dbhelpers.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/prefetch.h"
 #include "mongo/db/repl/oplog.h"
 #include "mongo/db/repl/oplog_interface_local.h"
 #include "mongo/db/repl/oplogreader.h"
@@ -138,6 +139,11 @@ static ServerStatusMetricField<Counter64> displayBufferCount("repl.buffer.count"
 static Counter64 bufferSizeGauge;
 static ServerStatusMetricField<Counter64> displayBufferSize("repl.buffer.sizeBytes",
                                                             &bufferSizeGauge);
+// The number and time of each push of a network batch into the buffer, which blocks while the
+// buffer is full
+static TimerStats bufferPushStats;
+static ServerStatusMetricField<TimerStats> displayBufferPushes("repl.buffer.pushes",
+                                                               &bufferPushStats);
 // The max size (bytes) of the buffer
 static int bufferMaxSizeGauge = 256 * 1024 * 1024;
 static ServerStatusMetricField<int> displayBufferMaxSize("repl.buffer.maxSizeBytes",
@@ -469,9 +475,11 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
         invariant(documentBegin != documents.cbegin());
     }
 
-    // process documents
+    // Hand the rest of the batch over to the applier as a whole, so that the buffer lock is taken
+    // and the applier woken once per network batch rather than once per operation. The documents
+    // share the reply buffer of the fetcher, so this does not copy them.
     int currentBatchMessageSize = 0;
-    for (auto documentIter = documentBegin; documentIter != documentEnd; ++documentIter) {
+    if (documentBegin != documentEnd) {
         if (inShutdown()) {
             return;
         }
@@ -483,11 +491,13 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
             return;
         }
 
-        // At this point, we are guaranteed to have at least one thing to read out
-        // of the fetcher.
-        const BSONObj& o = *documentIter;
-        currentBatchMessageSize += o.objsize();
-        opsReadStats.increment();
+        size_t bufferedSize = 0;
+        for (auto documentIter = documentBegin; documentIter != documentEnd; ++documentIter) {
+            currentBatchMessageSize += documentIter->objsize();
+            bufferedSize += getSize(*documentIter);
+        }
+        const auto numDocuments = std::distance(documentBegin, documentEnd);
+        opsReadStats.increment(numDocuments);
 
         if (MONGO_FAIL_POINT(stepDownWhileDrainingFailPoint)) {
             sleepsecs(20);
@@ -502,14 +512,19 @@ void BackgroundSync::_fetcherCallback(const StatusWith<Fetcher::QueryResponse>&
             LOG(2) << "bgsync buffer has " << _buffer.size() << " bytes";
         }
 
-        bufferCountGauge.increment();
-        bufferSizeGauge.increment(getSize(o));
-        _buffer.push(o);
+        bufferCountGauge.increment(numDocuments);
+        bufferSizeGauge.increment(bufferedSize);
+        {
+            TimerHolder timer(&bufferPushStats);
+            _buffer.pushAll(documentBegin, documentEnd);
+        }
+        schedulePipelinedPrefetch(std::vector<BSONObj>(documentBegin, documentEnd));
 
+        const BSONObj& lastDocument = *(documentEnd - 1);
         {
             stdx::unique_lock<stdx::mutex> lock(_mutex);
-            _lastFetchedHash = o["h"].numberLong();
-            _lastOpTimeFetched = fassertStatusOK(28770, OpTime::parseFromBSON(o));
+            _lastFetchedHash = lastDocument["h"].numberLong();
+            _lastOpTimeFetched = fassertStatusOK(28770, OpTime::parseFromBSON(lastDocument));
             LOG(3) << "lastOpTimeFetched: " << _lastOpTimeFetched;
         }
     }
@@ -37,6 +37,7 @@
 #include <set>
 
 #include "mongo/db/catalog/collection_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/log.h"
@@ -47,6 +48,9 @@ namespace repl {
 
 namespace {
 
+// Number of collections of a database that are cloned at the same time.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(initialSyncMaxConcurrentCollectionCloners, int, 4);
+
 const char* kNameFieldName = "name";
 const char* kOptionsFieldName = "options";
 
@@ -100,7 +104,9 @@ DatabaseCloner::DatabaseCloner(ReplicationExecutor* executor,
       _scheduleDbWorkFn([this](const ReplicationExecutor::CallbackFn& work) {
           return _executor->scheduleDBWork(work);
       }),
-      _startCollectionCloner([](CollectionCloner& cloner) { return cloner.start(); }) {
+      _startCollectionCloner([](CollectionCloner& cloner) { return cloner.start(); }),
+      _maxConcurrentCollectionCloners(
+          std::max(1, static_cast<int>(initialSyncMaxConcurrentCollectionCloners))) {
     uassert(ErrorCodes::BadValue, "null replication executor", executor);
     uassert(ErrorCodes::BadValue, "empty database name", !dbname.empty());
     uassert(ErrorCodes::BadValue, "storage interface cannot be null", si);
@@ -181,6 +187,12 @@ void DatabaseCloner::setStartCollectionClonerFn(
     _startCollectionCloner = startCollectionCloner;
 }
 
+void DatabaseCloner::setMaxConcurrentCollectionCloners(size_t maxConcurrentCollectionCloners) {
+    invariant(maxConcurrentCollectionCloners > 0);
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    _maxConcurrentCollectionCloners = maxConcurrentCollectionCloners;
+}
+
 void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryResponse>& result,
                                               Fetcher::NextAction* nextAction,
                                               BSONObjBuilder* getMoreBob) {
@@ -284,18 +296,11 @@ void DatabaseCloner::_listCollectionsCallback(const StatusWith<Fetcher::QueryRes
         collectionCloner.setScheduleDbWorkFn(_scheduleDbWorkFn);
     }
 
-    // Start first collection cloner.
-    _currentCollectionClonerIter = _collectionCloners.begin();
-
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
-
-    Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
-    if (!startStatus.isOK()) {
-        LOG(1) << "    failed to start collection cloning on "
-               << _currentCollectionClonerIter->getSourceNamespace() << ": " << startStatus;
-        _finishCallback(startStatus);
-        return;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _nextCollectionClonerIter = _collectionCloners.begin();
     }
+    _startCollectionCloners();
 }
 
 void DatabaseCloner::_collectionClonerCallback(const Status& status, const NamespaceString& nss) {
@@ -304,22 +309,55 @@ void DatabaseCloner::_collectionClonerCallback(const Status& status, const Names
     // from cloning the rest of the collections in the listCollections result.
     _collectionWork(status, nss);
 
-    _currentCollectionClonerIter++;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        invariant(_numActiveCollectionCloners > 0);
+        --_numActiveCollectionCloners;
+    }
+    _startCollectionCloners();
+}
+
+void DatabaseCloner::_startCollectionCloners() {
+    while (true) {
+        CollectionCloner* cloner = nullptr;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (!_startCollectionClonerStatus.isOK() ||
+                _nextCollectionClonerIter == _collectionCloners.end() ||
+                _numActiveCollectionCloners >= _maxConcurrentCollectionCloners) {
+                break;
+            }
+            cloner = &*(_nextCollectionClonerIter++);
+            ++_numActiveCollectionCloners;
+        }
 
-    LOG(1) << "    cloning collection " << _currentCollectionClonerIter->getSourceNamespace();
+        LOG(1) << "    cloning collection " << cloner->getSourceNamespace();
 
-    if (_currentCollectionClonerIter != _collectionCloners.end()) {
-        Status startStatus = _startCollectionCloner(*_currentCollectionClonerIter);
+        Status startStatus = _startCollectionCloner(*cloner);
         if (!startStatus.isOK()) {
-            LOG(1) << "    failed to start collection cloning on "
-                   << _currentCollectionClonerIter->getSourceNamespace() << ": " << startStatus;
-            _finishCallback(startStatus);
-            return;
+            LOG(1) << "    failed to start collection cloning on " << cloner->getSourceNamespace()
+                   << ": " << startStatus;
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            --_numActiveCollectionCloners;
+            _startCollectionClonerStatus = startStatus;
         }
-        return;
     }
 
-    _finishCallback(Status::OK());
+    // The database cloner completes once no collection cloners are running and either all of them
+    // have been started or one of them failed to start. Cloners still running when a start fails
+    // are waited for, as they refer to this database cloner.
+    Status finishStatus = Status::OK();
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_collectionClonersFinished || _numActiveCollectionCloners > 0 ||
+            (_startCollectionClonerStatus.isOK() &&
+             _nextCollectionClonerIter != _collectionCloners.end())) {
+            return;
+        }
+        _collectionClonersFinished = true;
+        finishStatus = _startCollectionClonerStatus;
+    }
+    _finishCallback(finishStatus);
 }
 
 void DatabaseCloner::_finishCallback(const Status& status) {
@@ -133,6 +133,14 @@ public:
      */
     void setStartCollectionClonerFn(const StartCollectionClonerFn& startCollectionCloner);
 
+    /**
+     * Overrides the number of collection cloners that run at the same time, which defaults to the
+     * 'initialSyncMaxConcurrentCollectionCloners' server parameter.
+     *
+     * For testing only.
+     */
+    void setMaxConcurrentCollectionCloners(size_t maxConcurrentCollectionCloners);
+
 private:
     /**
      * Read collection names and options from listCollections result.
@@ -147,6 +155,12 @@ private:
      */
     void _collectionClonerCallback(const Status& status, const NamespaceString& nss);
 
+    /**
+     * Starts collection cloners until the maximum number of them is running, or all have been
+     * started. Reports completion once the last running collection cloner has finished.
+     */
+    void _startCollectionCloners();
+
     /**
      * Reports completion status.
      * Sets cloner to inactive.
@@ -191,12 +205,24 @@ private:
     std::vector<NamespaceString> _collectionNamespaces;
 
     std::list<CollectionCloner> _collectionCloners;
-    std::list<CollectionCloner>::iterator _currentCollectionClonerIter;
+
+    // Next collection cloner to start. Collection cloners are started in listCollections order,
+    // with at most _maxConcurrentCollectionCloners of them running at the same time.
+    std::list<CollectionCloner>::iterator _nextCollectionClonerIter;
+    size_t _numActiveCollectionCloners = 0;
+
+    // First error returned by _startCollectionCloner. No further cloners are started after it.
+    Status _startCollectionClonerStatus = Status::OK();
+
+    // Set once the completion of the collection cloners has been reported.
+    bool _collectionClonersFinished = false;
 
     // Function for scheduling database work using the executor.
     CollectionCloner::ScheduleDbWorkFn _scheduleDbWorkFn;
 
     StartCollectionClonerFn _startCollectionCloner;
+
+    size_t _maxConcurrentCollectionCloners;
 };
 
 }  // namespace repl
@@ -409,6 +409,7 @@ TEST_F(DatabaseClonerTest, StartFirstCollectionClonerFailed) {
 
 TEST_F(DatabaseClonerTest, StartSecondCollectionClonerFailed) {
     ASSERT_OK(databaseCloner->start());
+    databaseCloner->setMaxConcurrentCollectionCloners(1);
 
     // Replace scheduleDbWork function so that all callbacks (including exclusive tasks)
     // will run through network interface.
@@ -442,6 +443,7 @@ TEST_F(DatabaseClonerTest, StartSecondCollectionClonerFailed) {
 
 TEST_F(DatabaseClonerTest, FirstCollectionListIndexesFailed) {
     ASSERT_OK(databaseCloner->start());
+    databaseCloner->setMaxConcurrentCollectionCloners(1);
 
     // Replace scheduleDbWork function so that all callbacks (including exclusive tasks)
     // will run through network interface.
@@ -462,7 +464,7 @@ TEST_F(DatabaseClonerTest, FirstCollectionListIndexesFailed) {
     ASSERT_EQUALS(getDetectableErrorStatus(), getStatus());
     ASSERT_TRUE(databaseCloner->isActive());
 
-    // Collection cloners are run serially for now.
+    // Collection cloners are run serially in this test.
     // This affects the order of the network responses.
     processNetworkResponse(BSON("ok" << 0 << "errmsg"
                                      << ""
@@ -487,6 +489,7 @@ TEST_F(DatabaseClonerTest, FirstCollectionListIndexesFailed) {
 
 TEST_F(DatabaseClonerTest, CreateCollections) {
     ASSERT_OK(databaseCloner->start());
+    databaseCloner->setMaxConcurrentCollectionCloners(1);
 
     // Replace scheduleDbWork function so that all callbacks (including exclusive tasks)
     // will run through network interface.
@@ -507,7 +510,7 @@ TEST_F(DatabaseClonerTest, CreateCollections) {
     ASSERT_EQUALS(getDetectableErrorStatus(), getStatus());
     ASSERT_TRUE(databaseCloner->isActive());
 
-    // Collection cloners are run serially for now.
+    // Collection cloners are run serially in this test.
     // This affects the order of the network responses.
     processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
     processNetworkResponse(createCursorResponse(0, BSONArray()));
@@ -529,4 +532,52 @@ TEST_F(DatabaseClonerTest, CreateCollections) {
     }
 }
 
+TEST_F(DatabaseClonerTest, CreateCollectionsConcurrently) {
+    ASSERT_OK(databaseCloner->start());
+    databaseCloner->setMaxConcurrentCollectionCloners(2);
+
+    // Replace scheduleDbWork function so that all callbacks (including exclusive tasks)
+    // will run through network interface.
+    auto&& executor = getReplExecutor();
+    databaseCloner->setScheduleDbWorkFn([&](const ReplicationExecutor::CallbackFn& workFn) {
+        return executor.scheduleWork(workFn);
+    });
+
+    const std::vector<BSONObj> sourceInfos = {BSON("name"
+                                                   << "a"
+                                                   << "options" << BSONObj()),
+                                              BSON("name"
+                                                   << "b"
+                                                   << "options" << BSONObj()),
+                                              BSON("name"
+                                                   << "c"
+                                                   << "options" << BSONObj())};
+    processNetworkResponse(createListCollectionsResponse(
+        0, BSON_ARRAY(sourceInfos[0] << sourceInfos[1] << sourceInfos[2])));
+    ASSERT_TRUE(databaseCloner->isActive());
+
+    // The first two collection cloners list their indexes at the same time. The third one starts
+    // once one of them has finished.
+    auto net = getNet();
+    auto noiA = net->getNextReadyRequest();
+    ASSERT_EQUALS("a", noiA->getRequest().cmdObj["listIndexes"].str());
+    auto noiB = net->getNextReadyRequest();
+    ASSERT_EQUALS("b", noiB->getRequest().cmdObj["listIndexes"].str());
+    ASSERT_FALSE(net->hasReadyRequests());
+    scheduleNetworkResponse(noiB, createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    scheduleNetworkResponse(noiA, createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    finishProcessingNetworkResponse();
+
+    processNetworkResponse(createCursorResponse(0, BSONArray()));
+    processNetworkResponse(createCursorResponse(0, BSONArray()));
+    ASSERT_TRUE(databaseCloner->isActive());
+
+    processNetworkResponse(createListIndexesResponse(0, BSON_ARRAY(idIndexSpec)));
+    processNetworkResponse(createCursorResponse(0, BSONArray()));
+
+    ASSERT_OK(getStatus());
+    ASSERT_FALSE(databaseCloner->isActive());
+    ASSERT_EQUALS(3U, collectionWorkResults.size());
+}
+
 }  // namespace
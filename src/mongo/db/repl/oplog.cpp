@@ -38,6 +38,7 @@
 #include <set>
 #include <vector>
 
+#include "mongo/base/counter.h"
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/db/auth/action_set.h"
 #include "mongo/db/auth/action_type.h"
@@ -57,6 +58,7 @@
 #include "mongo/db/catalog/rename_collection.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/commands/dbhash.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
@@ -136,15 +138,14 @@ void checkOplogInsert(Status result) {
  * function registers the new optime with the storage system and the replication coordinator,
  * and provides no facility to revert those registrations on rollback.
  */
-std::pair<OpTime, long long> getNextOpTime(OperationContext* txn,
-                                           Collection* oplog,
-                                           const char* ns,
-                                           ReplicationCoordinator* replCoord,
-                                           const char* opstr,
-                                           ReplicationCoordinator::Mode replicationMode) {
+std::vector<std::pair<OpTime, long long>> getNextOpTimes(
+    OperationContext* txn,
+    Collection* oplog,
+    ReplicationCoordinator* replCoord,
+    ReplicationCoordinator::Mode replicationMode,
+    unsigned count) {
     synchronizeOnCappedInFlightResource(txn->lockState(), oplog->ns());
 
-    long long hashNew = 0;
     long long term = OpTime::kUninitializedTerm;
 
     // Fetch term out of the newOpMutex.
@@ -154,19 +155,73 @@ std::pair<OpTime, long long> getNextOpTime(OperationContext* txn,
         term = replCoord->getTerm();
     }
 
+    std::vector<std::pair<OpTime, long long>> slots;
+    slots.reserve(count);
+
     stdx::lock_guard<stdx::mutex> lk(newOpMutex);
-    Timestamp ts = getNextGlobalTimestamp();
+    // The whole batch is reserved with one allocation, so its entries get consecutive increments.
+    const Timestamp first = getNextGlobalTimestamps(count);
     newTimestampNotifier.notify_all();
 
-    fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(txn, ts));
+    for (unsigned i = 0; i < count; ++i) {
+        const Timestamp ts(first.getSecs(), first.getInc() + i);
+        fassert(28560, oplog->getRecordStore()->oplogDiskLocRegister(txn, ts));
+
+        // Set hash if we're in replset mode, otherwise it remains 0 in master/slave.
+        long long hashNew = 0;
+        if (replicationMode == ReplicationCoordinator::modeReplSet) {
+            hashNew = hashGenerator.nextInt64();
+        }
+
+        slots.push_back(std::make_pair(OpTime(ts, term), hashNew));
+    }
+    return slots;
+}
+
+std::pair<OpTime, long long> getNextOpTime(OperationContext* txn,
+                                           Collection* oplog,
+                                           const char* ns,
+                                           ReplicationCoordinator* replCoord,
+                                           const char* opstr,
+                                           ReplicationCoordinator::Mode replicationMode) {
+    return getNextOpTimes(txn, oplog, replCoord, replicationMode, 1).front();
+}
+
+/**
+ * Returns true if writes to 'nss' are not recorded in the oplog.
+ */
+bool isOplogDisabledFor(OperationContext* txn,
+                        const NamespaceString& nss,
+                        ReplicationCoordinator::Mode replicationMode) {
+    if (nss.db() == "local") {
+        return true;
+    }
+
+    if (nss.isSystemDotProfile()) {
+        return true;
+    }
 
-    // Set hash if we're in replset mode, otherwise it remains 0 in master/slave.
-    if (replicationMode == ReplicationCoordinator::modeReplSet) {
-        hashNew = hashGenerator.nextInt64();
+    if (replicationMode == ReplicationCoordinator::modeNone) {
+        return true;
     }
 
-    OpTime opTime(ts, term);
-    return std::pair<OpTime, long long>(opTime, hashNew);
+    return !txn->writesAreReplicated();
+}
+
+/**
+ * Looks up and caches the oplog collection. The caller must hold the oplog collection lock.
+ */
+void cacheOplogCollection(OperationContext* txn, const std::string& oplogCollectionName) {
+    if (_localOplogCollection == nullptr) {
+        OldClientContext ctx(txn, oplogCollectionName);
+        _localDB = ctx.db();
+        invariant(_localDB);
+        _localOplogCollection = _localDB->getCollection(oplogCollectionName);
+        massert(13347,
+                "the oplog collection " + oplogCollectionName +
+                    " missing. did you drop it? if so, restart the server",
+                _localOplogCollection);
+    }
 }
 
 /**
@@ -264,19 +319,7 @@ void _logOp(OperationContext* txn,
             ReplicationCoordinator::Mode replicationMode,
             bool updateReplOpTime) {
     NamespaceString nss(ns);
-    if (nss.db() == "local") {
-        return;
-    }
-
-    if (nss.isSystemDotProfile()) {
-        return;
-    }
-
-    if (replicationMode == ReplicationCoordinator::modeNone) {
-        return;
-    }
-
-    if (!txn->writesAreReplicated()) {
+    if (isOplogDisabledFor(txn, nss, replicationMode)) {
         return;
     }
 
@@ -292,18 +335,7 @@ void _logOp(OperationContext* txn,
         fassertFailed(17405);
     }
     Lock::CollectionLock lk2(txn->lockState(), oplogCollectionName, MODE_IX);
-
-
-    if (_localOplogCollection == nullptr) {
-        OldClientContext ctx(txn, oplogCollectionName);
-        _localDB = ctx.db();
-        invariant(_localDB);
-        _localOplogCollection = _localDB->getCollection(oplogCollectionName);
-        massert(13347,
-                "the oplog collection " + oplogCollectionName +
-                    " missing. did you drop it? if so, restart the server",
-                _localOplogCollection);
-    }
+    cacheOplogCollection(txn, oplogCollectionName);
 
     std::pair<OpTime, long long> slot =
         getNextOpTime(txn, _localOplogCollection, ns, replCoord, opstr, replicationMode);
@@ -357,7 +389,68 @@ void _logOp(OperationContext* txn,
            true);
 }
 
-OpTime writeOpsToOplog(OperationContext* txn, const std::deque<BSONObj>& ops) {
+void _logInsertOps(OperationContext* txn,
+                   const char* ns,
+                   std::vector<BSONObj>::const_iterator begin,
+                   std::vector<BSONObj>::const_iterator end,
+                   bool fromMigrate) {
+    const std::string& oplogCollectionName = _oplogCollectionName;
+    const ReplicationCoordinator::Mode replicationMode =
+        ReplicationCoordinator::get(txn)->getReplicationMode();
+
+    NamespaceString nss(ns);
+    if (begin == end || isOplogDisabledFor(txn, nss, replicationMode)) {
+        return;
+    }
+
+    fassert(28838, txn->recoveryUnit());
+
+    Lock::DBLock lk(txn->lockState(), "local", MODE_IX);
+
+    ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
+
+    if (replicationMode == ReplicationCoordinator::modeReplSet &&
+        !replCoord->canAcceptWritesFor(nss)) {
+        severe() << "logOp() but can't accept write to collection " << ns;
+        fassertFailed(17405);
+    }
+    Lock::CollectionLock lk2(txn->lockState(), oplogCollectionName, MODE_IX);
+    cacheOplogCollection(txn, oplogCollectionName);
+
+    const std::vector<std::pair<OpTime, long long>> slots = getNextOpTimes(
+        txn, _localOplogCollection, replCoord, replicationMode, std::distance(begin, end));
+
+    // Unlike the single document path this copies each document into its entry, so that all of
+    // the entries can be handed to the record store in one insertRecords() call.
+    std::vector<BSONObj> entries;
+    entries.reserve(slots.size());
+    auto slot = slots.begin();
+    for (auto it = begin; it != end; ++it, ++slot) {
+        BSONObjBuilder b(256 + it->objsize());
+        slot->first.append(&b);
+        b.append("h", slot->second);
+        b.append("v", OPLOG_VERSION);
+        b.append("op", "i");
+        b.append("ns", ns);
+        if (fromMigrate) {
+            b.appendBool("fromMigrate", true);
+        }
+        b.append("o", *it);
+        entries.push_back(b.obj());
+    }
+
+    // This transaction might roll back.
+    checkOplogInsert(
+        _localOplogCollection->insertDocuments(txn, entries.begin(), entries.end(), false));
+
+    // Set replCoord last optime only after we're sure the WUOW didn't abort and roll back.
+    const OpTime& lastOpTime = slots.back().first;
+    txn->recoveryUnit()->registerChange(new UpdateReplOpTimeChange(lastOpTime, replCoord));
+
+    ReplClientInfo::forClient(txn->getClient()).setLastOp(lastOpTime);
+}
+
+OpTime writeOpsToOplog(OperationContext* txn, const std::deque<OplogEntry>& ops) {
     ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
 
     OpTime lastOptime;
@@ -381,8 +474,8 @@ OpTime writeOpsToOplog(OperationContext* txn, const std::deque<BSONObj>& ops) {
         OldClientContext ctx(txn, rsOplogName, _localDB);
         WriteUnitOfWork wunit(txn);
 
-        for (std::deque<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
-            const BSONObj& op = *it;
+        for (std::deque<OplogEntry>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+            const BSONObj& op = it->raw;
             const OpTime optime = fassertStatusOK(28779, OpTime::parseFromBSON(op));
 
             checkOplogInsert(_localOplogCollection->insertDocument(txn, op, false));
@@ -663,6 +756,31 @@ Status applyOperation_inlock(OperationContext* txn,
             str::stream() << "Failed to apply insert due to missing collection: " << op.toString(),
             collection);
 
+        if (fieldO.type() == Array) {
+            // Inserts grouped by the applier, which falls back to applying them one at a time if
+            // this fails.
+            std::vector<BSONObj> documents;
+            for (auto elem : fieldO.Obj()) {
+                uassert(ErrorCodes::NoSuchKey,
+                        str::stream() << "Failed to apply insert due to missing _id: "
+                                      << op.toString(),
+                        elem.isABSONObj() && elem.Obj().hasField("_id"));
+                documents.push_back(elem.Obj());
+            }
+
+            WriteUnitOfWork wuow(txn);
+            Status status =
+                collection->insertDocuments(txn, documents.begin(), documents.end(), true);
+            if (!status.isOK()) {
+                return status;
+            }
+            wuow.commit();
+            for (size_t i = 1; i < documents.size(); ++i) {
+                opCounters->gotInsert();
+            }
+            return Status::OK();
+        }
+
         // No _id.
         // This indicates an issue with the upstream server:
         //     The oplog entry is corrupted; or
@@ -921,6 +1039,18 @@ void oplogCheckCloseDatabase(OperationContext* txn, Database* db) {
 
 MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replSnapshotThreadThrottleMicros, int, 1000);
 
+// Snapshots taken because a new op reached the oplog, snapshots taken on request, and passes which
+// found no new op and so took none.
+Counter64 createdSnapshots;
+ServerStatusMetricField<Counter64> displayCreatedSnapshots("repl.snapshots.created",
+                                                           &createdSnapshots);
+Counter64 forcedSnapshots;
+ServerStatusMetricField<Counter64> displayForcedSnapshots("repl.snapshots.forced",
+                                                          &forcedSnapshots);
+Counter64 skippedSnapshots;
+ServerStatusMetricField<Counter64> displaySkippedSnapshots("repl.snapshots.skipped",
+                                                           &skippedSnapshots);
+
 SnapshotThread::SnapshotThread(SnapshotManager* manager)
     : _manager(manager), _thread([this] { run(); }) {}
 
@@ -931,15 +1061,23 @@ void SnapshotThread::run() {
     auto replCoord = ReplicationCoordinator::get(serviceContext);
 
     Timestamp lastTimestamp = {};
+    OpTime lastSnapshotOpTime;
     while (true) {
         {
             // This block logically belongs at the end of the loop, but having it at the top
             // simplifies handling of the "continue" cases. It is harmless to do these before the
             // first run of the loop.
             _manager->cleanupUnneededSnapshots();
-            sleepmicros(replSnapshotThreadThrottleMicros);  // Throttle by sleeping.
+
+            // Throttle by waiting, but let through a forced snapshot, which a majority read may be
+            // waiting for.
+            stdx::unique_lock<stdx::mutex> lock(newOpMutex);
+            newTimestampNotifier.wait_for(lock,
+                                          Microseconds(replSnapshotThreadThrottleMicros),
+                                          [this] { return _inShutdown || _forcedSnapshotPending; });
         }
 
+        bool forced = false;
         {
             stdx::unique_lock<stdx::mutex> lock(newOpMutex);
             while (true) {
@@ -947,6 +1085,7 @@ void SnapshotThread::run() {
                     return;
 
                 if (_forcedSnapshotPending || lastTimestamp != getLastSetTimestamp()) {
+                    forced = _forcedSnapshotPending;
                     _forcedSnapshotPending = false;
                     lastTimestamp = getLastSetTimestamp();
                     break;
@@ -1010,8 +1149,17 @@ void SnapshotThread::run() {
                 invariant(!opTimeOfSnapshot.isNull());
             }
 
+            if (!forced && opTimeOfSnapshot == lastSnapshotOpTime) {
+                // The timestamp moved without a new op reaching the oplog, so this snapshot would
+                // only duplicate the last one.
+                skippedSnapshots.increment();
+                continue;
+            }
+
             _manager->createSnapshot(txn.get(), name);
             replCoord->onSnapshotCreate(opTimeOfSnapshot, name);
+            lastSnapshotOpTime = opTimeOfSnapshot;
+            (forced ? forcedSnapshots : createdSnapshots).increment();
         } catch (const WriteConflictException& wce) {
             log() << "skipping storage snapshot pass due to write conflict";
             continue;
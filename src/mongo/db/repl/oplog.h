@@ -31,9 +31,11 @@
 #include <cstddef>
 #include <deque>
 #include <string>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/base/disallow_copying.h"
+#include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/util/concurrency/mutex.h"
@@ -70,7 +72,7 @@ void createOplog(OperationContext* txn);
 // used internally by replication secondaries after they have applied ops.  Updates the global
 // optime.
 // Returns the optime for the last op inserted.
-OpTime writeOpsToOplog(OperationContext* txn, const std::deque<BSONObj>& ops);
+OpTime writeOpsToOplog(OperationContext* txn, const std::deque<OplogEntry>& ops);
 
 extern std::string rsOplogName;
 extern std::string masterSlaveOplogName;
@@ -109,6 +111,17 @@ void _logOp(OperationContext* txn,
             BSONObj* o2,
             bool fromMigrate);
 
+/**
+ * Logs an insert of each document in [begin, end) to the local oplog, as if by calling _logOp()
+ * with opstr "i" on each of them. The entries get consecutive timestamps reserved in a single
+ * allocation and are written to the oplog as one batch.
+ */
+void _logInsertOps(OperationContext* txn,
+                   const char* ns,
+                   std::vector<BSONObj>::const_iterator begin,
+                   std::vector<BSONObj>::const_iterator end,
+                   bool fromMigrate);
+
 // Flush out the cached pointers to the local database and oplog.
 // Used by the closeDatabase command to ensure we don't cache closed things.
 void oplogCheckCloseDatabase(OperationContext* txn, Database* db);
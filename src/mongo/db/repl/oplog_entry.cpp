@@ -0,0 +1,73 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/repl/oplog_entry.h"
+
+#include "mongo/db/namespace_string.h"
+#include "third_party/murmurhash3/MurmurHash3.h"
+
+namespace mongo {
+namespace repl {
+
+OplogEntry::OplogEntry(const BSONObj& rawInput) : raw(rawInput) {
+    for (auto elem : raw) {
+        const StringData name = elem.fieldNameStringData();
+        if (name == "op") {
+            if (elem.type() == String) {
+                opType = elem.valueStringData();
+            }
+        } else if (name == "ns") {
+            if (elem.type() == String) {
+                ns = elem.valueStringData();
+            }
+        } else if (name == "v") {
+            version = elem;
+        } else if (name == "o") {
+            o = elem;
+        } else if (name == "o2") {
+            o2 = elem;
+        } else if (name == "ts") {
+            ts = elem;
+        }
+    }
+    MurmurHash3_x86_32(ns.rawData(), ns.size(), 0, &nsHash);
+}
+
+bool OplogEntry::isCrudOpType() const {
+    return opType == "i" || opType == "u" || opType == "d";
+}
+
+bool OplogEntry::isCommandOrIndexBuild() const {
+    // Index builds are achieved through the use of an insert op, not a command op.
+    return opType == "c" || (!ns.empty() && nsToCollectionSubstring(ns) == "system.indexes");
+}
+
+}  // namespace repl
+}  // namespace mongo
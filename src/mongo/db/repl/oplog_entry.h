@@ -0,0 +1,76 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+#include "mongo/base/string_data.h"
+#include "mongo/bson/bsonelement.h"
+#include "mongo/bson/bsonobj.h"
+
+namespace mongo {
+namespace repl {
+
+/**
+ * An oplog entry, with the fields the secondary's apply path needs found in a single pass over the
+ * document. The elements point into 'raw', which owns or shares the buffer they live in, so
+ * copies of an OplogEntry stay valid as long as the BSONObj it was built from would.
+ *
+ * Fields missing from the document are left as EOO elements and empty strings, so malformed
+ * entries can still be reported by whoever applies them.
+ */
+struct OplogEntry {
+    explicit OplogEntry(const BSONObj& raw);
+
+    /**
+     * True for inserts, updates and deletes.
+     */
+    bool isCrudOpType() const;
+
+    /**
+     * True for commands, and for the inserts into system.indexes that build an index. Both are
+     * applied in batches of their own.
+     */
+    bool isCommandOrIndexBuild() const;
+
+    BSONObj raw;
+
+    StringData opType;
+    StringData ns;
+    BSONElement version;
+    BSONElement o;
+    BSONElement o2;
+    BSONElement ts;
+
+    // MurmurHash3 of 'ns', which assigns the entry to a writer thread.
+    uint32_t nsHash = 0;
+};
+
+}  // namespace repl
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/db/repl/oplog_entry.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace repl {
+namespace {
+
+TEST(OplogEntry, ParsesFields) {
+    const BSONObj raw = BSON("ts" << Timestamp(1, 2) << "h" << 3LL << "v" << 2 << "op"
+                                  << "u"
+                                  << "ns"
+                                  << "test.t"
+                                  << "o2" << BSON("_id" << 1) << "o"
+                                  << BSON("$set" << BSON("x" << 1)));
+    const OplogEntry entry(raw);
+
+    ASSERT_EQUALS("u", entry.opType);
+    ASSERT_EQUALS("test.t", entry.ns);
+    ASSERT_EQUALS(2, entry.version.numberInt());
+    ASSERT_EQUALS(Timestamp(1, 2), entry.ts.timestamp());
+    ASSERT_EQUALS(BSON("_id" << 1), entry.o2.Obj());
+    ASSERT_EQUALS(BSON("$set" << BSON("x" << 1)), entry.o.Obj());
+    ASSERT_TRUE(entry.isCrudOpType());
+    ASSERT_FALSE(entry.isCommandOrIndexBuild());
+
+    // The namespace hash depends on the namespace only.
+    const OplogEntry other(BSON("op"
+                                << "i"
+                                << "ns"
+                                << "test.t"
+                                << "o" << BSON("_id" << 2)));
+    ASSERT_EQUALS(entry.nsHash, other.nsHash);
+
+    // Copies point into the same buffer.
+    const OplogEntry copy(entry);
+    ASSERT_EQUALS(entry.o.rawdata(), copy.o.rawdata());
+}
+
+TEST(OplogEntry, MissingFields) {
+    const OplogEntry entry(BSON("op" << 1));
+
+    ASSERT_TRUE(entry.opType.empty());
+    ASSERT_TRUE(entry.ns.empty());
+    ASSERT_TRUE(entry.version.eoo());
+    ASSERT_TRUE(entry.o.eoo());
+    ASSERT_TRUE(entry.o2.eoo());
+    ASSERT_TRUE(entry.ts.eoo());
+    ASSERT_FALSE(entry.isCrudOpType());
+    ASSERT_FALSE(entry.isCommandOrIndexBuild());
+}
+
+TEST(OplogEntry, CommandsAndIndexBuilds) {
+    ASSERT_TRUE(OplogEntry(BSON("op"
+                                << "c"
+                                << "ns"
+                                << "test.$cmd"
+                                << "o" << BSON("drop"
+                                               << "t"))).isCommandOrIndexBuild());
+    ASSERT_TRUE(OplogEntry(BSON("op"
+                                << "i"
+                                << "ns"
+                                << "test.system.indexes"
+                                << "o" << BSON("ns"
+                                               << "test.t"))).isCommandOrIndexBuild());
+}
+
+}  // namespace
+}  // namespace repl
+}  // namespace mongo
@@ -42,5 +42,17 @@ MONGO_INITIALIZER(maxSyncSourceLagSecsCheck)(InitializerContext*) {
     }
     return Status::OK();
 }
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replHeartbeatJitterMillis, int, 200);
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(replNonVoterHeartbeatIntervalMillis, int, 5000);
+MONGO_INITIALIZER(replHeartbeatSchedulingCheck)(InitializerContext*) {
+    if (replHeartbeatJitterMillis < 0) {
+        return Status(ErrorCodes::BadValue, "replHeartbeatJitterMillis must be >= 0");
+    }
+    if (replNonVoterHeartbeatIntervalMillis < 0) {
+        return Status(ErrorCodes::BadValue, "replNonVoterHeartbeatIntervalMillis must be >= 0");
+    }
+    return Status::OK();
+}
 }
 }
@@ -39,6 +39,8 @@ namespace mongo {
 namespace repl {
 
 extern int maxSyncSourceLagSecs;
+extern int replHeartbeatJitterMillis;
+extern int replNonVoterHeartbeatIntervalMillis;
 
 bool anyReplEnabled();
 
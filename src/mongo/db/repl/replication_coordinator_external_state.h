@@ -99,6 +99,12 @@ public:
      */
     virtual void forwardSlaveProgress() = 0;
 
+    /**
+     * Wrapper around SyncSourceFeedback::forwardSlaveProgressImmediately, which sends the update
+     * without coalescing it with later progress.
+     */
+    virtual void forwardSlaveProgressImmediately() = 0;
+
     /**
      * Queries the singleton document in local.me.  If it exists and our hostname has not
      * changed since we wrote, returns the RID stored in the object.  If the document does not
@@ -178,6 +178,10 @@ void ReplicationCoordinatorExternalStateImpl::forwardSlaveProgress() {
     _syncSourceFeedback.forwardSlaveProgress();
 }
 
+void ReplicationCoordinatorExternalStateImpl::forwardSlaveProgressImmediately() {
+    _syncSourceFeedback.forwardSlaveProgressImmediately();
+}
+
 OID ReplicationCoordinatorExternalStateImpl::ensureMe(OperationContext* txn) {
     std::string myname = getHostName();
     OID myRID;
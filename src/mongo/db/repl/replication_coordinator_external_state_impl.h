@@ -55,6 +55,7 @@ public:
     virtual void initiateOplog(OperationContext* txn, bool updateReplOpTime);
     virtual void logTransitionToPrimaryToOplog(OperationContext* txn);
     virtual void forwardSlaveProgress();
+    virtual void forwardSlaveProgressImmediately();
     virtual OID ensureMe(OperationContext* txn);
     virtual bool isSelf(const HostAndPort& host);
     virtual StatusWith<BSONObj> loadLocalConfigDocument(OperationContext* txn);
@@ -63,6 +63,7 @@ void ReplicationCoordinatorExternalStateMock::initiateOplog(OperationContext* tx
                                                             bool updateReplOpTime) {}
 void ReplicationCoordinatorExternalStateMock::shutdown() {}
 void ReplicationCoordinatorExternalStateMock::forwardSlaveProgress() {}
+void ReplicationCoordinatorExternalStateMock::forwardSlaveProgressImmediately() {}
 
 OID ReplicationCoordinatorExternalStateMock::ensureMe(OperationContext*) {
     return OID::gen();
@@ -35,7 +35,9 @@
 #include <algorithm>
 #include <limits>
 
+#include "mongo/base/counter.h"
 #include "mongo/base/status.h"
+#include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/d_concurrency.h"
 #include "mongo/db/global_timestamp.h"
 #include "mongo/db/index/index_descriptor.h"
@@ -64,6 +66,7 @@
 #include "mongo/db/repl/update_position_args.h"
 #include "mongo/db/repl/vote_requester.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/rpc/metadata/repl_set_metadata.h"
 #include "mongo/rpc/request_interface.h"
@@ -83,6 +86,49 @@ using CallbackHandle = executor::TaskExecutor::CallbackHandle;
 
 namespace {
 
+// How many snapshots newer than the commit point are kept at once. Beyond that, each new snapshot
+// evicts one from the middle of the list, so the commit point still advances onto snapshots, only
+// in coarser steps, and the storage engine is not asked to keep an unbounded number of them.
+MONGO_EXPORT_SERVER_PARAMETER(replMaxUncommittedSnapshots, int, 1000);
+
+// When the snapshot serving committed reads was created, in milliseconds since the epoch, or zero
+// if there is none. Older snapshots are dropped once a newer one is committed, so this is also the
+// age of the oldest history the storage engine keeps for snapshots.
+AtomicInt64 committedSnapshotCreatedMillis(0);
+
+// How many snapshots are waiting for the commit point to reach them.
+AtomicInt64 uncommittedSnapshotCount(0);
+
+// Snapshots which replaced an uncommitted snapshot of the same OpTime.
+Counter64 coalescedSnapshots;
+ServerStatusMetricField<Counter64> displayCoalescedSnapshots("repl.snapshots.coalesced",
+                                                             &coalescedSnapshots);
+
+// Snapshots evicted because replMaxUncommittedSnapshots were already kept.
+Counter64 evictedSnapshots;
+ServerStatusMetricField<Counter64> displayEvictedSnapshots("repl.snapshots.evicted",
+                                                           &evictedSnapshots);
+
+class SnapshotGaugeMetric : public ServerStatusMetric {
+public:
+    SnapshotGaugeMetric(const std::string& name, stdx::function<long long()> getter)
+        : ServerStatusMetric(name), _getter(std::move(getter)) {}
+
+    void appendAtLeaf(BSONObjBuilder& b) const override {
+        b.append(_leafName, _getter());
+    }
+
+private:
+    const stdx::function<long long()> _getter;
+};
+
+SnapshotGaugeMetric displayCommittedSnapshotAge("repl.snapshots.committedAgeMillis", [] {
+    const long long created = committedSnapshotCreatedMillis.load();
+    return created ? std::max(Date_t::now().toMillisSinceEpoch() - created, 0LL) : 0LL;
+});
+SnapshotGaugeMetric displayUncommittedSnapshots("repl.snapshots.uncommitted",
+                                                [] { return uncommittedSnapshotCount.load(); });
+
 void lockAndCall(stdx::unique_lock<stdx::mutex>* lk, const stdx::function<void()>& fn) {
     if (!lk->owns_lock()) {
         lk->lock();
@@ -117,25 +163,35 @@ struct ReplicationCoordinatorImpl::WaiterInfo {
      * Constructor takes the list of waiters and enqueues itself on the list, removing itself
      * in the destructor.
      */
-    WaiterInfo(std::vector<WaiterInfo*>* _list,
+    WaiterInfo(WaiterList* _list,
                unsigned int _opID,
                const OpTime* _opTime,
                const WriteConcernOptions* _writeConcern,
                stdx::condition_variable* _condVar)
         : list(_list),
+          key(_writeConcern ? WaiterKey(_writeConcern->wMode,
+                                        _writeConcern->wMode.empty() ? _writeConcern->wNumNodes
+                                                                     : 0)
+                            : WaiterKey()),
           master(true),
           opID(_opID),
           opTime(_opTime),
           writeConcern(_writeConcern),
           condVar(_condVar) {
-        list->push_back(this);
+        position = (*list)[key].emplace(*opTime, this);
     }
 
     ~WaiterInfo() {
-        list->erase(std::remove(list->begin(), list->end(), this), list->end());
+        auto queue = list->find(key);
+        queue->second.erase(position);
+        if (queue->second.empty()) {
+            list->erase(queue);
+        }
     }
 
-    std::vector<WaiterInfo*>* list;
+    WaiterList* list;
+    const WaiterKey key;
+    WaiterQueue::iterator position;
     bool master;  // Set to false to indicate that stepDown was called while waiting
     const unsigned int opID;
     const OpTime* opTime;
@@ -437,11 +493,10 @@ void ReplicationCoordinatorImpl::shutdown() {
             return;
         }
         fassert(18823, _rsConfigState != kConfigStartingUp);
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* waiter = *it;
-            waiter->condVar->notify_all();
+        for (auto& queue : _replicationWaiterList) {
+            for (auto& waiter : queue.second) {
+                waiter.second->condVar->notify_all();
+            }
         }
     }
 
@@ -615,7 +670,7 @@ void ReplicationCoordinatorImpl::signalDrainComplete(OperationContext* txn) {
 }
 
 void ReplicationCoordinatorImpl::signalUpstreamUpdater() {
-    _externalState->forwardSlaveProgress();
+    _externalState->forwardSlaveProgressImmediately();
 }
 
 ReplicationCoordinatorImpl::SlaveInfo* ReplicationCoordinatorImpl::_findSlaveInfoByMemberID_inlock(
@@ -778,9 +833,12 @@ void ReplicationCoordinatorImpl::_setMyLastOptime_inlock(stdx::unique_lock<stdx:
         return;
     }
 
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        if (*(opTimeWaiter->opTime) <= opTime) {
-            opTimeWaiter->condVar->notify_all();
+    // All opTime waiters share one queue, whose waiters for 'opTime' or earlier are its prefix.
+    for (auto& queue : _opTimeWaiterList) {
+        for (auto it = queue.second.begin();
+             it != queue.second.end() && it->first <= opTime;
+             ++it) {
+            it->second->condVar->notify_all();
         }
     }
 
@@ -845,6 +903,12 @@ ReadConcernResponse ReplicationCoordinatorImpl::waitUntilOpTime(OperationContext
                                        Milliseconds(timer.millis()));
         }
 
+        if (isMajorityReadConcern && _uncommittedSnapshots.empty() && _lastCommittedOpTime >= ts) {
+            // The commit point already covers 'ts' but no snapshot has been taken since the
+            // committed one, so have one taken now rather than after the snapshot throttle.
+            _externalState->forceSnapshotCreation();
+        }
+
         stdx::condition_variable condVar;
         WriteConcernOptions writeConcern;
         writeConcern.wMode = WriteConcernOptions::kMajority;
@@ -949,20 +1013,14 @@ void ReplicationCoordinatorImpl::interrupt(unsigned opId) {
     // Wake ops waiting for a new snapshot.
     _snapshotCreatedCond.notify_all();
 
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        if (info->opID == opId) {
-            info->condVar->notify_all();
-            return;
-        }
-    }
-
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        if (opTimeWaiter->opID == opId) {
-            opTimeWaiter->condVar->notify_all();
-            return;
+    for (auto list : {&_replicationWaiterList, &_opTimeWaiterList}) {
+        for (auto& queue : *list) {
+            for (auto& waiter : queue.second) {
+                if (waiter.second->opID == opId) {
+                    waiter.second->condVar->notify_all();
+                    return;
+                }
+            }
         }
     }
 
@@ -974,15 +1032,12 @@ void ReplicationCoordinatorImpl::interruptAll() {
     // Wake ops waiting for a new snapshot.
     _snapshotCreatedCond.notify_all();
 
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        info->condVar->notify_all();
-    }
-
-    for (auto& opTimeWaiter : _opTimeWaiterList) {
-        opTimeWaiter->condVar->notify_all();
+    for (auto list : {&_replicationWaiterList, &_opTimeWaiterList}) {
+        for (auto& queue : *list) {
+            for (auto& waiter : queue.second) {
+                waiter.second->condVar->notify_all();
+            }
+        }
     }
 
     _scheduleWork(stdx::bind(&ReplicationCoordinatorImpl::_signalStepDownWaiters, this));
@@ -2114,12 +2169,11 @@ ReplicationCoordinatorImpl::_updateMemberStateFromTopologyCoordinator_inlock() {
     PostMemberStateUpdateAction result;
     if (_memberState.primary() || newState.removed() || newState.rollback()) {
         // Wake up any threads blocked in awaitReplication, close connections, etc.
-        for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-             it != _replicationWaiterList.end();
-             ++it) {
-            WaiterInfo* info = *it;
-            info->master = false;
-            info->condVar->notify_all();
+        for (auto& queue : _replicationWaiterList) {
+            for (auto& waiter : queue.second) {
+                waiter.second->master = false;
+                waiter.second->condVar->notify_all();
+            }
         }
         _canAcceptNonLocalWrites = false;
         result = kActionCloseAllConnections;
@@ -2342,12 +2396,14 @@ ReplicationCoordinatorImpl::_setCurrentRSConfig_inlock(
 }
 
 void ReplicationCoordinatorImpl::_wakeReadyWaiters_inlock() {
-    for (std::vector<WaiterInfo*>::iterator it = _replicationWaiterList.begin();
-         it != _replicationWaiterList.end();
-         ++it) {
-        WaiterInfo* info = *it;
-        if (_doneWaitingForReplication_inlock(
-                *info->opTime, SnapshotName::min(), *info->writeConcern)) {
+    // Only the satisfied prefix of each queue is visited, plus the first waiter past it.
+    for (auto& queue : _replicationWaiterList) {
+        for (auto& waiter : queue.second) {
+            WaiterInfo* info = waiter.second;
+            if (!_doneWaitingForReplication_inlock(
+                    *info->opTime, SnapshotName::min(), *info->writeConcern)) {
+                break;
+            }
             info->condVar->notify_all();
         }
     }
@@ -2373,7 +2429,9 @@ Status ReplicationCoordinatorImpl::processReplSetUpdatePosition(const UpdatePosi
         // Must do this outside _mutex
         // TODO: enable _dr, remove _externalState when DataReplicator is used excl.
         //_dr.slavesHaveProgressed();
-        _externalState->forwardSlaveProgress();
+        // Forward chained progress right away, so that each hop does not add the coalescing
+        // interval to the latency of majority writes.
+        _externalState->forwardSlaveProgressImmediately();
     }
     return status;
 }
@@ -2678,6 +2736,7 @@ void ReplicationCoordinatorImpl::_setLastCommittedOpTime_inlock(const OpTime& co
 
         // Forget about all snapshots <= the new commit point.
         _uncommittedSnapshots.erase(_uncommittedSnapshots.begin(), onePastCommitPoint);
+        uncommittedSnapshotCount.store(_uncommittedSnapshots.size());
 
         // Update committed snapshot and wake up any threads waiting on read concern or
         // write concern.
@@ -3003,7 +3062,7 @@ void ReplicationCoordinatorImpl::waitForNewSnapshot(OperationContext* txn) {
 void ReplicationCoordinatorImpl::onSnapshotCreate(OpTime timeOfSnapshot, SnapshotName name) {
     stdx::lock_guard<stdx::mutex> lock(_mutex);
 
-    auto snapshotInfo = SnapshotInfo{timeOfSnapshot, name};
+    auto snapshotInfo = SnapshotInfo{timeOfSnapshot, name, _replExecutor.now()};
     _snapshotCreatedCond.notify_all();
 
     if (timeOfSnapshot <= _lastCommittedOpTime) {
@@ -3017,11 +3076,22 @@ void ReplicationCoordinatorImpl::onSnapshotCreate(OpTime timeOfSnapshot, Snapsho
         invariant(snapshotInfo > _uncommittedSnapshots.back());
         // The name must independently be newer.
         invariant(snapshotInfo.name > _uncommittedSnapshots.back().name);
-        // Technically, we could delete older snapshots from the same optime since we will only ever
-        // want the newest. However, multiple snapshots on the same optime will be very rare so it
-        // isn't worth the effort and potential bugs that would introduce.
+
+        if (_uncommittedSnapshots.back().opTime == timeOfSnapshot) {
+            // Only the newest snapshot of an OpTime will ever be committed, so it replaces the
+            // older one. The storage engine drops the older one once a later snapshot is committed.
+            _uncommittedSnapshots.pop_back();
+            coalescedSnapshots.increment();
+        } else if (_uncommittedSnapshots.size() >=
+                   static_cast<size_t>(std::max(replMaxUncommittedSnapshots, 2))) {
+            // Keep the oldest, which the commit point reaches first, and the newest.
+            _uncommittedSnapshots.erase(_uncommittedSnapshots.begin() +
+                                        _uncommittedSnapshots.size() / 2);
+            evictedSnapshots.increment();
+        }
     }
     _uncommittedSnapshots.push_back(snapshotInfo);
+    uncommittedSnapshotCount.store(_uncommittedSnapshots.size());
 }
 
 void ReplicationCoordinatorImpl::_updateCommittedSnapshot_inlock(
@@ -3036,6 +3106,7 @@ void ReplicationCoordinatorImpl::_updateCommittedSnapshot_inlock(
         invariant(newCommittedSnapshot < _uncommittedSnapshots.front());
 
     _currentCommittedSnapshot = newCommittedSnapshot;
+    committedSnapshotCreatedMillis.store(newCommittedSnapshot.createdAt.toMillisSinceEpoch());
 
     _externalState->updateCommittedSnapshot(newCommittedSnapshot.name);
 
@@ -3051,6 +3122,8 @@ void ReplicationCoordinatorImpl::dropAllSnapshots() {
 void ReplicationCoordinatorImpl::_dropAllSnapshots_inlock() {
     _uncommittedSnapshots.clear();
     _currentCommittedSnapshot = boost::none;
+    uncommittedSnapshotCount.store(0);
+    committedSnapshotCreatedMillis.store(0);
     _externalState->dropAllSnapshots();
 }
 
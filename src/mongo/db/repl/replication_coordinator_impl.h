@@ -28,8 +28,11 @@
 
 #pragma once
 
-#include <vector>
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
+#include <vector>
 
 #include "mongo/base/status.h"
 #include "mongo/bson/timestamp.h"
@@ -348,6 +351,9 @@ private:
         OpTime opTime;
         SnapshotName name;
 
+        // When the snapshot was created. Not part of the ordering.
+        Date_t createdAt;
+
         bool operator==(const SnapshotInfo& other) const {
             return std::tie(opTime, name) == std::tie(other.opTime, other.name);
         }
@@ -423,6 +429,13 @@ private:
     // Struct that holds information about clients waiting for replication.
     struct WaiterInfo;
 
+    // Waiters for one write concern mode, identified by its wMode and wNumNodes, ordered by the
+    // OpTime they wait for. Whether a waiter is satisfied is monotonic in its OpTime, so the
+    // satisfied waiters of a mode are always a prefix of its queue.
+    using WaiterKey = std::pair<std::string, int>;
+    using WaiterQueue = std::multimap<OpTime, WaiterInfo*>;
+    using WaiterList = std::map<WaiterKey, WaiterQueue>;
+
     // Struct that holds information about nodes in this replication group, mainly used for
     // tracking replication progress for write concern satisfaction.
     struct SlaveInfo {
@@ -1146,11 +1159,11 @@ private:
 
     // list of information about clients waiting on replication.  Does *not* own the
     // WaiterInfos.
-    std::vector<WaiterInfo*> _replicationWaiterList;  // (M)
+    WaiterList _replicationWaiterList;  // (M)
 
     // list of information about clients waiting for a particular opTime.
     // Does *not* own the WaiterInfos.
-    std::vector<WaiterInfo*> _opTimeWaiterList;  // (M)
+    WaiterList _opTimeWaiterList;  // (M)
 
     // Set to true when we are in the process of shutting down replication.
     bool _inShutdown;  // (M)
@@ -1003,6 +1003,50 @@ TEST_F(ReplCoordTest, AwaitReplicationNumberOfNodesBlocking) {
     awaiter.reset();
 }
 
+TEST_F(ReplCoordTest, AwaitReplicationWakesWaitersSatisfiedByAnEarlierOpTime) {
+    OperationContextNoop txn;
+    assertStartSuccess(BSON("_id"
+                            << "mySet"
+                            << "version" << 2 << "members"
+                            << BSON_ARRAY(BSON("host"
+                                               << "node1:12345"
+                                               << "_id" << 0)
+                                          << BSON("host"
+                                                  << "node2:12345"
+                                                  << "_id" << 1) << BSON("host"
+                                                                         << "node3:12345"
+                                                                         << "_id" << 2))),
+                       HostAndPort("node1", 12345));
+    ASSERT(getReplCoord()->setFollowerMode(MemberState::RS_SECONDARY));
+    getReplCoord()->setMyLastOptime(OpTimeWithTermZero(100, 0));
+    simulateSuccessfulElection();
+
+    OpTimeWithTermZero time1(100, 1);
+    OpTimeWithTermZero time2(100, 2);
+
+    WriteConcernOptions writeConcern;
+    writeConcern.wTimeout = WriteConcernOptions::kNoTimeout;
+    writeConcern.wNumNodes = 2;
+
+    // The waiter for the later optime is queued first.
+    ReplicationAwaiter awaiter2(getReplCoord(), &txn);
+    awaiter2.setOpTime(time2);
+    awaiter2.setWriteConcern(writeConcern);
+    awaiter2.start(&txn);
+
+    ReplicationAwaiter awaiter1(getReplCoord(), &txn);
+    awaiter1.setOpTime(time1);
+    awaiter1.setWriteConcern(writeConcern);
+    awaiter1.start(&txn);
+
+    getReplCoord()->setMyLastOptime(time2);
+    ASSERT_OK(getReplCoord()->setLastOptime_forTest(2, 1, time1));
+    ASSERT_OK(awaiter1.getResult().status);
+
+    ASSERT_OK(getReplCoord()->setLastOptime_forTest(2, 1, time2));
+    ASSERT_OK(awaiter2.getResult().status);
+}
+
 TEST_F(ReplCoordTest, AwaitReplicationTimeout) {
     OperationContextNoop txn;
     assertStartSuccess(BSON("_id"
@@ -28,6 +28,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/status_with.h"
 #include "mongo/db/jsobj.h"
@@ -73,6 +75,14 @@ public:
      */
     virtual BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const = 0;
 
+    /**
+     * Fetches the documents of 'nss' whose _id is one of 'ids' from the sync source, in as few
+     * round trips as it allows. Documents which no longer exist are absent from the result, which
+     * is in no particular order.
+     */
+    virtual std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                           const std::vector<BSONElement>& ids) const = 0;
+
     /**
      * Clones a single collection from the sync source.
      */
@@ -30,6 +30,7 @@
 
 #include "mongo/db/repl/rollback_source_impl.h"
 
+#include "mongo/client/dbclientcursor.h"
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/cloner.h"
 #include "mongo/db/jsobj.h"
@@ -68,6 +69,31 @@ BSONObj RollbackSourceImpl::findOne(const NamespaceString& nss, const BSONObj& f
     return _getConnection()->findOne(nss.toString(), filter, NULL, QueryOption_SlaveOk).getOwned();
 }
 
+std::vector<BSONObj> RollbackSourceImpl::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    BSONObjBuilder filter;
+    {
+        BSONObjBuilder idFilter(filter.subobjStart("_id"));
+        BSONArrayBuilder in(idFilter.subarrayStart("$in"));
+        for (const auto& id : ids) {
+            in.append(id);
+        }
+    }
+
+    std::unique_ptr<DBClientCursor> cursor =
+        _getConnection()->query(nss.toString(), filter.obj(), 0, 0, NULL, QueryOption_SlaveOk);
+    uassert(28817,
+            str::stream() << "replSet rollback error querying " << nss.ns() << " on "
+                          << _source.toString(),
+            cursor);
+
+    std::vector<BSONObj> documents;
+    while (cursor->more()) {
+        documents.push_back(cursor->nextSafe().getOwned());
+    }
+    return documents;
+}
+
 void RollbackSourceImpl::copyCollectionFromRemote(OperationContext* txn,
                                                   const NamespaceString& nss) const {
     std::string errmsg;
@@ -370,7 +370,7 @@ Status _initialSync() {
     log() << "initial sync data copy, starting syncup";
 
     // prime oplog, but don't need to actually apply the op as the cloned data already reflects it.
-    OpTime lastOptime = writeOpsToOplog(&txn, {lastOp});
+    OpTime lastOptime = writeOpsToOplog(&txn, {OplogEntry(lastOp)});
     ReplClientInfo::forClient(txn.getClient()).setLastOp(lastOptime);
     replCoord->setMyLastOptime(lastOptime);
     setNewTimestamp(lastOptime.getTimestamp());
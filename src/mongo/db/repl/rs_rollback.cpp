@@ -141,6 +141,10 @@ struct DocID {
     }
 };
 
+// Limits on the documents of one collection refetched from the sync source by a single query.
+const size_t kRefetchBatchMaxDocs = 1000;
+const int kRefetchBatchMaxIdBytes = 1024 * 1024;
+
 struct FixUpInfo {
     // note this is a set -- if there are many $inc's on a single document we need to rollback,
     // we only need to refetch it once.
@@ -273,25 +277,44 @@ void syncFixUp(OperationContext* txn,
 
     BSONObj newMinValid;
 
-    // fetch all the goodVersions of each document from current primary
+    // fetch all the goodVersions of each document from current primary. toRefetch is ordered by
+    // namespace, so the documents of each collection are fetched a batch of _ids at a time.
     DocID doc;
     unsigned long long numFetched = 0;
     try {
-        for (set<DocID>::iterator it = fixUpInfo.toRefetch.begin(); it != fixUpInfo.toRefetch.end();
-             it++) {
+        set<DocID>::iterator it = fixUpInfo.toRefetch.begin();
+        while (it != fixUpInfo.toRefetch.end()) {
             doc = *it;
 
-            verify(!doc._id.eoo());
+            std::vector<BSONElement> ids;
+            int idBytes = 0;
+            set<DocID>::iterator batchEnd = it;
+            for (; batchEnd != fixUpInfo.toRefetch.end() && strcmp(batchEnd->ns, doc.ns) == 0 &&
+                 ids.size() < kRefetchBatchMaxDocs && idBytes < kRefetchBatchMaxIdBytes;
+                 ++batchEnd) {
+                verify(!batchEnd->_id.eoo());
+                ids.push_back(batchEnd->_id);
+                idBytes += batchEnd->_id.size();
+            }
 
-            {
-                // TODO : slow.  lots of round trips.
-                numFetched++;
-                BSONObj good = rollbackSource.findOne(NamespaceString(doc.ns), doc._id.wrap());
+            map<DocID, BSONObj> found;
+            for (const BSONObj& good : rollbackSource.findByIds(NamespaceString(doc.ns), ids)) {
                 totalSize += good.objsize();
                 uassert(13410, "replSet too much data to roll back", totalSize < 300 * 1024 * 1024);
 
-                // note good might be eoo, indicating we should delete it
-                goodVersions.push_back(pair<DocID, BSONObj>(doc, good));
+                DocID goodId;
+                goodId.ownedObj = good;
+                goodId.ns = doc.ns;
+                goodId._id = good["_id"];
+                found[goodId] = good;
+            }
+
+            for (; it != batchEnd; ++it) {
+                numFetched++;
+                map<DocID, BSONObj>::const_iterator good = found.find(*it);
+                // note good might be missing, indicating we should delete it
+                goodVersions.push_back(
+                    pair<DocID, BSONObj>(*it, good == found.end() ? BSONObj() : good->second));
             }
         }
         newMinValid = rollbackSource.getLastOperation();
@@ -84,6 +84,8 @@ public:
     const OplogInterface& getOplog() const override;
     BSONObj getLastOperation() const override;
     BSONObj findOne(const NamespaceString& nss, const BSONObj& filter) const override;
+    std::vector<BSONObj> findByIds(const NamespaceString& nss,
+                                   const std::vector<BSONElement>& ids) const override;
     void copyCollectionFromRemote(OperationContext* txn, const NamespaceString& nss) const override;
     StatusWith<BSONObj> getCollectionInfo(const NamespaceString& nss) const override;
 
@@ -113,6 +115,18 @@ BSONObj RollbackSourceMock::findOne(const NamespaceString& nss, const BSONObj& f
     return BSONObj();
 }
 
+std::vector<BSONObj> RollbackSourceMock::findByIds(const NamespaceString& nss,
+                                                   const std::vector<BSONElement>& ids) const {
+    std::vector<BSONObj> documents;
+    for (const auto& id : ids) {
+        BSONObj document = findOne(nss, id.wrap());
+        if (!document.isEmpty()) {
+            documents.push_back(document);
+        }
+    }
+    return documents;
+}
+
 void RollbackSourceMock::copyCollectionFromRemote(OperationContext* txn,
                                                   const NamespaceString& nss) const {}
 
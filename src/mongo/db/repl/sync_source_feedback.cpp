@@ -46,6 +46,7 @@
 #include "mongo/db/repl/replica_set_config.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 #include "mongo/util/net/hostandport.h"
@@ -57,6 +58,15 @@ using std::string;
 
 namespace repl {
 
+namespace {
+
+// Smallest interval between two replSetUpdatePosition commands reporting this node's own progress.
+// Applying a stream of small batches then costs one round-trip to the sync source per interval
+// rather than one per batch. Progress of the nodes chained through this one is not held back.
+MONGO_EXPORT_SERVER_PARAMETER(replUpdatePositionMinIntervalMillis, int, 10);
+
+}  // namespace
+
 void SyncSourceFeedback::_resetConnection() {
     LOG(1) << "resetting connection in sync source feedback";
     _connection.reset();
@@ -105,6 +115,13 @@ void SyncSourceFeedback::forwardSlaveProgress() {
     _cond.notify_all();
 }
 
+void SyncSourceFeedback::forwardSlaveProgressImmediately() {
+    stdx::lock_guard<stdx::mutex> lock(_mtx);
+    _positionChanged = true;
+    _forwardImmediately = true;
+    _cond.notify_all();
+}
+
 Status SyncSourceFeedback::updateUpstream(OperationContext* txn) {
     auto replCoord = repl::ReplicationCoordinator::get(txn);
     if (replCoord->getMemberState().primary()) {
@@ -171,11 +188,23 @@ void SyncSourceFeedback::run() {
                 }
             }
 
+            // Let more of this node's progress accumulate into the update, unless something that
+            // must be forwarded right away comes in meanwhile.
+            const Date_t sendAfter =
+                _lastUpdateSent + Milliseconds(replUpdatePositionMinIntervalMillis);
+            Date_t now = Date_t::now();
+            while (_positionChanged && !_forwardImmediately && !_shutdownSignaled &&
+                   now < sendAfter) {
+                _cond.wait_for(lock, sendAfter - now);
+                now = Date_t::now();
+            }
+
             if (_shutdownSignaled) {
                 break;
             }
 
             _positionChanged = false;
+            _forwardImmediately = false;
         }
 
         MemberState state = ReplicationCoordinator::get(txn.get())->getMemberState();
@@ -195,6 +224,7 @@ void SyncSourceFeedback::run() {
                 continue;
             }
         }
+        _lastUpdateSent = Date_t::now();
         Status status = updateUpstream(txn.get());
         if (!status.isOK()) {
             log() << "updateUpstream failed: " << status << ", will retry";
@@ -34,6 +34,7 @@
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/net/hostandport.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 class OperationContext;
@@ -43,9 +44,17 @@ namespace repl {
 class SyncSourceFeedback {
 public:
     /// Notifies the SyncSourceFeedbackThread to wake up and send an update upstream of slave
-    /// replication progress.
+    /// replication progress. Updates of this node's own progress are coalesced, so that at most
+    /// one is sent every replUpdatePositionMinIntervalMillis.
     void forwardSlaveProgress();
 
+    /**
+     * Like forwardSlaveProgress(), but the update is sent without waiting out the minimum
+     * interval. Used for the progress of nodes chaining through this one, and when the sync
+     * source changes, so that each hop of a chain does not add its own delay.
+     */
+    void forwardSlaveProgressImmediately();
+
     /**
      * Loops continuously until shutdown() is called, passing updates when they are present. If no
      * update occurs within the _keepAliveInterval, progress is forwarded to let the upstream node
@@ -90,6 +99,10 @@ private:
     Milliseconds _keepAliveInterval = Milliseconds(100);
     // used to indicate a position change which has not yet been pushed along
     bool _positionChanged = false;
+    // set along with _positionChanged when the change must not be coalesced
+    bool _forwardImmediately = false;
+    // when the last update was sent upstream; only used by the run() thread
+    Date_t _lastUpdateSent;
     // Once this is set to true the _run method will terminate
     bool _shutdownSignaled = false;
 };
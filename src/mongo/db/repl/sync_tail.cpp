@@ -33,6 +33,8 @@
 
 #include "mongo/db/repl/sync_tail.h"
 
+#include <algorithm>
+#include <array>
 #include <boost/functional/hash.hpp>
 #include <memory>
 #include "third_party/murmurhash3/MurmurHash3.h"
@@ -43,11 +45,13 @@
 #include "mongo/db/catalog/database.h"
 #include "mongo/db/catalog/database_holder.h"
 #include "mongo/db/catalog/document_validation.h"
+#include "mongo/db/catalog/index_catalog.h"
 #include "mongo/db/commands/fsync.h"
 #include "mongo/db/commands/server_status_metric.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/curop.h"
 #include "mongo/db/db_raii.h"
+#include "mongo/db/index/index_descriptor.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/prefetch.h"
@@ -60,10 +64,12 @@
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/timer_stats.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/string_map.h"
 
 namespace mongo {
 
@@ -99,6 +105,10 @@ public:
 
 } exportedWriterThreadCountParam;
 
+// When positive, steady state replication sizes batches from the measured apply rate so that each
+// takes about this long to apply, within replBatchLimitOperations and replBatchLimitBytes.
+MONGO_EXPORT_SERVER_PARAMETER(replBatchTargetApplyMillis, int, 0);
+
 
 static Counter64 opsAppliedStats;
 
@@ -111,31 +121,121 @@ MONGO_FP_DECLARE(rsSyncApplyStop);
 static TimerStats applyBatchStats;
 static ServerStatusMetricField<TimerStats> displayOpBatchesApplied("repl.apply.batches",
                                                                    &applyBatchStats);
+
+// Time the applier spends collecting each batch from the bgsync buffer, including waits for more
+// operations to arrive
+static TimerStats batchCollectionStats;
+static ServerStatusMetricField<TimerStats> displayBatchCollection("repl.apply.batchCollection",
+                                                                  &batchCollectionStats);
+// Time spent prefetching the pages each batch touches, on MMAPv1 only
+static TimerStats prefetchBatchStats;
+static ServerStatusMetricField<TimerStats> displayPrefetch("repl.apply.prefetch",
+                                                           &prefetchBatchStats);
+// Time spent writing each applied batch to the local oplog
+static TimerStats oplogWriteStats;
+static ServerStatusMetricField<TimerStats> displayOplogWrites("repl.apply.oplogWrites",
+                                                              &oplogWriteStats);
+// Time spent waiting for each applied batch to be journaled
+static TimerStats journalWaitStats;
+static ServerStatusMetricField<TimerStats> displayJournalWaits("repl.apply.journalWaits",
+                                                               &journalWaitStats);
+
+namespace {
+
+/**
+ * Counts the batches applied by their number of operations, in buckets of powers of two.
+ * Reported as an object from the lower bound of each bucket to its count, which always has the
+ * same fields so that FTDC can diff successive samples.
+ */
+class BatchSizeHistogram : public ServerStatusMetric {
+public:
+    static const int kNumBuckets = 18;
+
+    BatchSizeHistogram() : ServerStatusMetric("repl.apply.batchSizes") {}
+
+    void record(size_t numOperations) {
+        int bucket = 0;
+        while (bucket < kNumBuckets - 1 && (size_t(2) << bucket) <= numOperations) {
+            ++bucket;
+        }
+        _buckets[bucket].fetchAndAdd(1);
+    }
+
+    virtual void appendAtLeaf(BSONObjBuilder& b) const {
+        BSONObjBuilder histogram(b.subobjStart(_leafName));
+        for (int bucket = 0; bucket < kNumBuckets; ++bucket) {
+            histogram.append(BSONObjBuilder::numStr(1 << bucket),
+                             static_cast<long long>(_buckets[bucket].load()));
+        }
+    }
+
+private:
+    std::array<AtomicUInt64, kNumBuckets> _buckets;
+} batchSizeHistogram;
+
+/**
+ * Reports the busy and idle time of each thread in the writer pool of the SyncTail constructed
+ * last, which in steady state is that of the sync thread.
+ */
+class WriterPoolMetric : public ServerStatusMetric {
+public:
+    WriterPoolMetric() : ServerStatusMetric("repl.apply.writers") {}
+
+    void setPool(WorkStealingThreadPool* pool) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _pool = pool;
+    }
+
+    void clearPool(WorkStealingThreadPool* pool) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (_pool == pool) {
+            _pool = nullptr;
+        }
+    }
+
+    virtual void appendAtLeaf(BSONObjBuilder& b) const {
+        WorkStealingThreadPool::Stats stats;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            if (_pool) {
+                stats = _pool->getStats();
+            }
+        }
+
+        BSONObjBuilder writers(b.subobjStart(_leafName));
+        writers.append("tasks", stats.tasksExecuted);
+        writers.append("tasksStolen", stats.tasksStolen);
+        BSONArrayBuilder threads(writers.subarrayStart("threads"));
+        for (long long busyMicros : stats.workerBusyMicros) {
+            threads.append(BSON("busyMicros" << busyMicros << "idleMicros"
+                                             << stats.uptimeMicros - busyMicros));
+        }
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    WorkStealingThreadPool* _pool = nullptr;
+} writerPoolMetric;
+
+}  // namespace
 void initializePrefetchThread() {
     if (!ClientBasic::getCurrent()) {
         Client::initThreadIfNotAlready();
         AuthorizationSession::get(cc())->grantInternalAuthorization();
     }
 }
-namespace {
-bool isCrudOpType(const char* field) {
-    switch (field[0]) {
-        case 'd':
-        case 'i':
-        case 'u':
-            return field[1] == 0;
-    }
-    return false;
-}
-}
-
 SyncTail::SyncTail(BackgroundSyncInterface* q, MultiSyncApplyFunc func)
     : _networkQueue(q),
       _applyFunc(func),
+      _batchLimiter(replBatchLimitOperations),
       _writerPool(replWriterThreadCount, "repl writer worker "),
-      _prefetcherPool(replPrefetcherThreadCount, "repl prefetch worker ") {}
+      _prefetcherPool(replPrefetcherThreadCount, "repl prefetch worker ") {
+    writerPoolMetric.setPool(&_writerPool);
+}
 
-SyncTail::~SyncTail() {}
+SyncTail::~SyncTail() {
+    writerPoolMetric.clearPool(&_writerPool);
+}
 
 bool SyncTail::peek(BSONObj* op) {
     return _networkQueue->peek(op);
@@ -143,7 +243,7 @@ bool SyncTail::peek(BSONObj* op) {
 
 // static
 Status SyncTail::syncApply(OperationContext* txn,
-                           const BSONObj& op,
+                           const OplogEntry& op,
                            bool convertUpdateToUpsert,
                            ApplyOperationInLockFn applyOperationInLock,
                            ApplyCommandInLockFn applyCommandInLock,
@@ -155,20 +255,18 @@ Status SyncTail::syncApply(OperationContext* txn,
     // Count each log op application as a separate operation, for reporting purposes
     CurOp individualOp(txn);
 
-    const char* ns = op.getStringField("ns");
-    verify(ns);
-
-    const char* opType = op["op"].valuestrsafe();
+    const StringData ns = op.ns;
+    const StringData opType = op.opType;
 
-    bool isCommand(opType[0] == 'c');
-    bool isNoOp(opType[0] == 'n');
+    bool isCommand(opType.startsWith("c"));
+    bool isNoOp(opType.startsWith("n"));
 
-    if ((*ns == '\0') || (*ns == '.')) {
+    if (ns.empty() || ns[0] == '.') {
         // this is ugly
         // this is often a no-op
         // but can't be 100% sure
         if (!isNoOp) {
-            error() << "skipping bad op in oplog: " << op.toString();
+            error() << "skipping bad op in oplog: " << op.raw.toString();
         }
         return Status::OK();
     }
@@ -180,7 +278,7 @@ Status SyncTail::syncApply(OperationContext* txn,
             Lock::GlobalWrite globalWriteLock(txn->lockState());
 
             // special case apply for commands to avoid implicit database creation
-            Status status = applyCommandInLock(txn, op);
+            Status status = applyCommandInLock(txn, op.raw);
             incrementOpsAppliedStats();
             return status;
         }
@@ -193,7 +291,7 @@ Status SyncTail::syncApply(OperationContext* txn,
         txn->setReplicatedWrites(false);
         DisableDocumentValidation validationDisabler(txn);
 
-        Status status = applyOperationInLock(txn, db, op, convertUpdateToUpsert);
+        Status status = applyOperationInLock(txn, db, op.raw, convertUpdateToUpsert);
         if (!status.isOK() && status.code() == ErrorCodes::WriteConflict) {
             throw WriteConflictException();
         }
@@ -201,17 +299,17 @@ Status SyncTail::syncApply(OperationContext* txn,
         return status;
     };
 
-    if (isNoOp || (opType[0] == 'i' && nsToCollectionSubstring(ns) == "system.indexes")) {
+    if (isNoOp || (opType.startsWith("i") && nsToCollectionSubstring(ns) == "system.indexes")) {
         auto opStr = isNoOp ? "syncApply_noop" : "syncApply_indexBuild";
         MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
             Lock::DBLock dbLock(txn->lockState(), nsToDatabaseSubstring(ns), MODE_X);
-            OldClientContext ctx(txn, ns);
+            OldClientContext ctx(txn, ns.toString());
             return applyOp(ctx.db());
         }
         MONGO_WRITE_CONFLICT_RETRY_LOOP_END(txn, opStr, ns);
     }
 
-    if (isCrudOpType(opType)) {
+    if (op.isCrudOpType()) {
         MONGO_WRITE_CONFLICT_RETRY_LOOP_BEGIN {
             // DB lock always acquires the global lock
             std::unique_ptr<Lock::DBLock> dbLock;
@@ -226,19 +324,20 @@ Status SyncTail::syncApply(OperationContext* txn,
                 collectionLock.reset(new Lock::CollectionLock(txn->lockState(), ns, mode));
             };
 
+            const std::string nsString = ns.toString();
             resetLocks(MODE_IX);
             if (!dbHolder().get(txn, dbName)) {
                 // need to create database, try again
                 resetLocks(MODE_X);
-                ctx.reset(new OldClientContext(txn, ns));
+                ctx.reset(new OldClientContext(txn, nsString));
             } else {
-                ctx.reset(new OldClientContext(txn, ns));
+                ctx.reset(new OldClientContext(txn, nsString));
                 if (!ctx->db()->getCollection(ns)) {
                     // uh, oh, we need to create collection
                     // try again
                     ctx.reset();
                     resetLocks(MODE_X);
-                    ctx.reset(new OldClientContext(txn, ns));
+                    ctx.reset(new OldClientContext(txn, nsString));
                 }
             }
 
@@ -249,12 +348,14 @@ Status SyncTail::syncApply(OperationContext* txn,
 
     // unknown opType
     str::stream ss;
-    ss << "bad opType '" << opType << "' in oplog entry: " << op.toString();
+    ss << "bad opType '" << opType << "' in oplog entry: " << op.raw.toString();
     error() << std::string(ss);
     return Status(ErrorCodes::BadValue, ss);
 }
 
-Status SyncTail::syncApply(OperationContext* txn, const BSONObj& op, bool convertUpdateToUpsert) {
+Status SyncTail::syncApply(OperationContext* txn,
+                           const OplogEntry& op,
+                           bool convertUpdateToUpsert) {
     return syncApply(txn,
                      op,
                      convertUpdateToUpsert,
@@ -267,19 +368,18 @@ Status SyncTail::syncApply(OperationContext* txn, const BSONObj& op, bool conver
 namespace {
 
 // The pool threads call this to prefetch each op
-void prefetchOp(const BSONObj& op) {
+void prefetchOp(const OplogEntry& op) {
     initializePrefetchThread();
 
-    const char* ns = op.getStringField("ns");
-    if (ns && (ns[0] != '\0')) {
+    if (!op.ns.empty()) {
         try {
             // one possible tweak here would be to stay in the read lock for this database
             // for multiple prefetches if they are for the same database.
             OperationContextImpl txn;
-            AutoGetCollectionForRead ctx(&txn, ns);
+            AutoGetCollectionForRead ctx(&txn, op.ns.toString());
             Database* db = ctx.getDb();
             if (db) {
-                prefetchPagesForReplicatedOp(&txn, db, op);
+                prefetchPagesForReplicatedOp(&txn, db, op.raw);
             }
         } catch (const DBException& e) {
             LOG(2) << "ignoring exception in prefetchOp(): " << e.what() << endl;
@@ -291,57 +391,88 @@ void prefetchOp(const BSONObj& op) {
 }
 
 // Doles out all the work to the reader pool threads and waits for them to complete
-void prefetchOps(const std::deque<BSONObj>& ops, OldThreadPool* prefetcherPool) {
+void prefetchOps(const std::deque<OplogEntry>& ops, WorkStealingThreadPool* prefetcherPool) {
     invariant(prefetcherPool);
-    for (std::deque<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
-        prefetcherPool->schedule(&prefetchOp, *it);
+    for (std::deque<OplogEntry>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+        prefetcherPool->schedule(stdx::bind(&prefetchOp, *it));
     }
     prefetcherPool->join();
 }
 
 // Doles out all the work to the writer pool threads and waits for them to complete
-void applyOps(const std::vector<std::vector<BSONObj>>& writerVectors,
-              OldThreadPool* writerPool,
+void applyOps(const std::vector<std::vector<OplogEntry>>& writerVectors,
+              WorkStealingThreadPool* writerPool,
               SyncTail::MultiSyncApplyFunc func,
               SyncTail* sync) {
     TimerHolder timer(&applyBatchStats);
-    for (std::vector<std::vector<BSONObj>>::const_iterator it = writerVectors.begin();
-         it != writerVectors.end();
-         ++it) {
-        if (!it->empty()) {
-            writerPool->schedule(func, stdx::cref(*it), sync);
+    for (size_t i = 0; i < writerVectors.size(); ++i) {
+        if (!writerVectors[i].empty()) {
+            // fillWriterVectors() hashes each namespace, or document, to the same vector in every
+            // batch, so using the vector's index as the affinity hint keeps its writes on one
+            // writer thread unless another, idle, writer steals them.
+            writerPool->schedule(stdx::bind(func, stdx::cref(writerVectors[i]), sync), i);
         }
     }
     writerPool->join();
 }
 
-void fillWriterVectors(const std::deque<BSONObj>& ops,
-                       std::vector<std::vector<BSONObj>>* writerVectors) {
-    for (std::deque<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
-        const BSONElement e = it->getField("ns");
-        verify(e.type() == String);
-        const char* ns = e.valuestr();
-        int len = e.valuestrsize();
-        uint32_t hash = 0;
-        MurmurHash3_x86_32(ns, len, 0, &hash);
-
-        const char* opType = it->getField("op").valuestrsafe();
-
-        if (getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking() &&
-            isCrudOpType(opType)) {
-            BSONElement id;
-            switch (opType[0]) {
-                case 'u':
-                    id = it->getField("o2").Obj()["_id"];
-                    break;
-                case 'd':
-                case 'i':
-                    id = it->getField("o").Obj()["_id"];
-                    break;
+/**
+ * Returns true if the CRUD ops on 'ns' can be spread over the writers by document, rather than all
+ * going to the writer of the namespace. Ops on different documents of a capped collection must be
+ * applied in order, and reordering them across documents can make a unique secondary index report
+ * spurious duplicate keys. A collection that does not exist yet is left to a single writer too.
+ */
+bool canApplyOpsByDocument(OperationContext* txn, StringData ns) {
+    Lock::DBLock dbLock(txn->lockState(), nsToDatabaseSubstring(ns), MODE_IS);
+    Database* db = dbHolder().get(txn, ns);
+    if (!db) {
+        return false;
+    }
+    Lock::CollectionLock collLock(txn->lockState(), ns, MODE_IS);
+    Collection* collection = db->getCollection(ns);
+    if (!collection || collection->isCapped()) {
+        return false;
+    }
+    IndexCatalog::IndexIterator it =
+        collection->getIndexCatalog()->getIndexIterator(txn, true /* includeUnfinished */);
+    while (it.more()) {
+        const IndexDescriptor* desc = it.next();
+        if (desc->unique() && !desc->isIdIndex()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void fillWriterVectors(OperationContext* txn,
+                       const std::deque<OplogEntry>& ops,
+                       std::vector<std::vector<OplogEntry>>* writerVectors) {
+    const bool supportsDocLocking =
+        getGlobalServiceContext()->getGlobalStorageEngine()->supportsDocLocking();
+    // Whether each namespace of the batch can be applied by document. Commands and index builds
+    // are applied in batches of their own, so this does not change within the batch.
+    StringMap<bool> applyByDocument;
+
+    for (std::deque<OplogEntry>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+        const StringData ns = it->ns;
+        uint32_t hash = it->nsHash;
+
+        if (supportsDocLocking && it->isCrudOpType()) {
+            bool byDocument;
+            auto cached = applyByDocument.find(ns);
+            if (cached == applyByDocument.end()) {
+                byDocument = canApplyOpsByDocument(txn, ns);
+                applyByDocument[ns] = byDocument;
+            } else {
+                byDocument = cached->second;
             }
 
-            const size_t idHash = BSONElement::Hasher()(id);
-            MurmurHash3_x86_32(&idHash, sizeof(idHash), hash, &hash);
+            if (byDocument) {
+                const BSONElement id = (it->opType == "u" ? it->o2 : it->o).Obj()["_id"];
+
+                const size_t idHash = BSONElement::Hasher()(id);
+                MurmurHash3_x86_32(&idHash, sizeof(idHash), hash, &hash);
+            }
         }
 
         (*writerVectors)[hash % writerVectors->size()].push_back(*it);
@@ -354,8 +485,8 @@ void fillWriterVectors(const std::deque<BSONObj>& ops,
 // static
 OpTime SyncTail::multiApply(OperationContext* txn,
                             const OpQueue& ops,
-                            OldThreadPool* prefetcherPool,
-                            OldThreadPool* writerPool,
+                            WorkStealingThreadPool* prefetcherPool,
+                            WorkStealingThreadPool* writerPool,
                             MultiSyncApplyFunc func,
                             SyncTail* sync,
                             bool supportsWaitingUntilDurable) {
@@ -366,13 +497,15 @@ OpTime SyncTail::multiApply(OperationContext* txn,
 
     if (getGlobalServiceContext()->getGlobalStorageEngine()->isMmapV1()) {
         // Use a ThreadPool to prefetch all the operations in a batch.
+        TimerHolder timer(&prefetchBatchStats);
         prefetchOps(ops.getDeque(), prefetcherPool);
     }
 
-    std::vector<std::vector<BSONObj>> writerVectors(replWriterThreadCount);
+    std::vector<std::vector<OplogEntry>> writerVectors(replWriterThreadCount);
 
-    fillWriterVectors(ops.getDeque(), &writerVectors);
+    fillWriterVectors(txn, ops.getDeque(), &writerVectors);
     LOG(2) << "replication batch size is " << ops.getDeque().size() << endl;
+    batchSizeHistogram.record(ops.getDeque().size());
     // We must grab this because we're going to grab write locks later.
     // We hold this mutex the entire time we're writing; it doesn't matter
     // because all readers are blocked anyway.
@@ -399,9 +532,14 @@ OpTime SyncTail::multiApply(OperationContext* txn,
         txn->recoveryUnit()->goingToWaitUntilDurable();
     }
 
-    OpTime lastOpTime = writeOpsToOplog(txn, ops.getDeque());
+    OpTime lastOpTime;
+    {
+        TimerHolder timer(&oplogWriteStats);
+        lastOpTime = writeOpsToOplog(txn, ops.getDeque());
+    }
 
     if (mustWaitUntilDurable) {
+        TimerHolder timer(&journalWaitStats);
         txn->recoveryUnit()->waitUntilDurable();
     }
     ReplClientInfo::forClient(txn->getClient()).setLastOp(lastOpTime);
@@ -413,6 +551,28 @@ OpTime SyncTail::multiApply(OperationContext* txn,
     return lastOpTime;
 }
 
+const unsigned int SyncTail::BatchLimiter::kMinOperations;
+
+unsigned int SyncTail::BatchLimiter::getOperationLimit(int targetMillis) const {
+    if (targetMillis <= 0 || _opsPerMicro <= 0) {
+        return _maxOperations;
+    }
+
+    const double limit = _opsPerMicro * (targetMillis * 1000.0);
+    if (limit >= _maxOperations) {
+        return _maxOperations;
+    }
+    return std::max(static_cast<unsigned int>(limit), std::min(kMinOperations, _maxOperations));
+}
+
+void SyncTail::BatchLimiter::recordBatch(size_t numOperations, Microseconds elapsed) {
+    const long long micros = std::max(durationCount<Microseconds>(elapsed), 1LL);
+    const double rate = static_cast<double>(numOperations) / micros;
+
+    // Weigh the latest batch at a quarter so that one outlier does not swing the limit.
+    _opsPerMicro = _opsPerMicro <= 0 ? rate : 0.75 * _opsPerMicro + 0.25 * rate;
+}
+
 void SyncTail::oplogApplication(OperationContext* txn, const OpTime& endOpTime) {
     _applyOplogUntil(txn, endOpTime);
 }
@@ -430,8 +590,8 @@ void SyncTail::_applyOplogUntil(OperationContext* txn, const OpTime& endOpTime)
                 continue;
 
             // Check if we reached the end
-            const BSONObj currentOp = ops.back();
-            const OpTime currentOpTime = fassertStatusOK(28772, OpTime::parseFromBSON(currentOp));
+            const OpTime currentOpTime =
+                fassertStatusOK(28772, OpTime::parseFromBSON(ops.back().raw));
 
             // When we reach the end return this batch
             if (currentOpTime == endOpTime) {
@@ -454,8 +614,6 @@ void SyncTail::_applyOplogUntil(OperationContext* txn, const OpTime& endOpTime)
             fassertFailedNoTrace(18692);
         }
 
-        const BSONObj lastOp = ops.back().getOwned();
-
         // Tally operation information
         bytesApplied += ops.getSize();
         entriesApplied += ops.getDeque().size();
@@ -524,6 +682,8 @@ void SyncTail::oplogApplication() {
 
         Timer batchTimer;
         int lastTimeChecked = 0;
+        const unsigned int batchLimitOperations =
+            _batchLimiter.getOperationLimit(replBatchTargetApplyMillis);
 
         do {
             int now = batchTimer.seconds();
@@ -532,7 +692,7 @@ void SyncTail::oplogApplication() {
             if (!ops.empty()) {
                 if (now > replBatchLimitSeconds)
                     break;
-                if (ops.getDeque().size() > replBatchLimitOperations)
+                if (ops.getDeque().size() > batchLimitOperations)
                     break;
             }
             // occasionally check some things
@@ -553,8 +713,7 @@ void SyncTail::oplogApplication() {
 
             const int slaveDelaySecs = durationCount<Seconds>(replCoord->getSlaveDelaySecs());
             if (!ops.empty() && slaveDelaySecs > 0) {
-                const BSONObj lastOp = ops.back();
-                const unsigned int opTimestampSecs = lastOp["ts"].timestamp().getSecs();
+                const unsigned int opTimestampSecs = ops.back().ts.timestamp().getSecs();
 
                 // Stop the batch as the lastOp is too new to be applied. If we continue
                 // on, we can get ops that are way ahead of the delay and this will
@@ -584,14 +743,16 @@ void SyncTail::oplogApplication() {
         if (ops.empty()) {
             continue;
         }
+        batchCollectionStats.record(batchTimer);
 
-        const BSONObj lastOp = ops.back();
+        const OplogEntry& lastOp = ops.back();
         handleSlaveDelay(lastOp);
 
         // Set minValid to the last op to be applied in this next batch.
         // This will cause this node to go into RECOVERING state
         // if we should crash and restart before updating the oplog
-        setMinValid(&txn, fassertStatusOK(28773, OpTime::parseFromBSON(lastOp)));
+        setMinValid(&txn, fassertStatusOK(28773, OpTime::parseFromBSON(lastOp.raw)));
+        Timer applyTimer;
         multiApply(&txn,
                    ops,
                    &_prefetcherPool,
@@ -599,6 +760,7 @@ void SyncTail::oplogApplication() {
                    _applyFunc,
                    this,
                    supportsWaitingUntilDurable());
+        _batchLimiter.recordBatch(ops.getDeque().size(), Microseconds(applyTimer.micros()));
     }
 }
 
@@ -638,16 +800,14 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* txn,
         return true;
     }
 
-    const char* ns = op["ns"].valuestrsafe();
+    // Parse the entry once here; the rest of the apply path reads its fields from the OplogEntry.
+    const OplogEntry entry(op);
 
     // check for commands
-    if ((op["op"].valuestrsafe()[0] == 'c') ||
-        // Index builds are acheived through the use of an insert op, not a command op.
-        // The following line is the same as what the insert code uses to detect an index build.
-        (*ns != '\0' && nsToCollectionSubstring(ns) == "system.indexes")) {
+    if (entry.isCommandOrIndexBuild()) {
         if (ops->empty()) {
             // apply commands one-at-a-time
-            ops->push_back(op);
+            ops->push_back(entry);
             _networkQueue->consume();
         }
 
@@ -656,7 +816,7 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* txn,
     }
 
     // check for oplog version change
-    BSONElement elemVersion = op["v"];
+    BSONElement elemVersion = entry.version;
     int curVersion = 0;
     if (elemVersion.eoo())
         // missing version means version 1
@@ -671,21 +831,21 @@ bool SyncTail::tryPopAndWaitForMore(OperationContext* txn,
     }
 
     // Copy the op to the deque and remove it from the bgsync queue.
-    ops->push_back(op);
+    ops->push_back(entry);
     _networkQueue->consume();
 
     // Go back for more ops
     return false;
 }
 
-void SyncTail::handleSlaveDelay(const BSONObj& lastOp) {
+void SyncTail::handleSlaveDelay(const OplogEntry& lastOp) {
     ReplicationCoordinator* replCoord = getGlobalReplicationCoordinator();
     int slaveDelaySecs = durationCount<Seconds>(replCoord->getSlaveDelaySecs());
 
     // ignore slaveDelay if the box is still initializing. once
     // it becomes secondary we can worry about it.
     if (slaveDelaySecs > 0 && replCoord->getMemberState().secondary()) {
-        const Timestamp ts = lastOp["ts"].timestamp();
+        const Timestamp ts = lastOp.ts.timestamp();
         long long a = ts.getSecs();
         long long b = time(0);
         long long lag = b - a;
@@ -830,8 +990,60 @@ static void initializeWriterThread() {
     }
 }
 
+namespace {
+
+// Limits on the inserts multiSyncApply() coalesces into one grouped insert.
+const int kGroupedInsertMaxBytes = 256 * 1024;
+const size_t kGroupedInsertMaxCount = 64;
+
+/**
+ * Returns the end of the run of inserts into the namespace of the insert at 'begin' which can be
+ * applied together with it, within the limits above.
+ */
+std::vector<const OplogEntry*>::const_iterator findEndOfGroupedInserts(
+    std::vector<const OplogEntry*>::const_iterator begin,
+    std::vector<const OplogEntry*>::const_iterator end) {
+    const StringData ns = (*begin)->ns;
+    int groupBytes = (*begin)->o.objsize();
+    size_t groupCount = 1;
+    auto it = begin + 1;
+    for (; it != end && groupCount < kGroupedInsertMaxCount; ++it, ++groupCount) {
+        const OplogEntry& op = **it;
+        if (op.opType != "i" || op.ns != ns) {
+            break;
+        }
+        groupBytes += op.o.objsize();
+        if (groupBytes > kGroupedInsertMaxBytes) {
+            break;
+        }
+    }
+    return it;
+}
+
+/**
+ * Builds an insert op whose "o" field is the array of the documents inserted by the ops in
+ * [begin, end), which applyOperation_inlock() inserts in a single unit of work.
+ */
+OplogEntry makeGroupedInsert(std::vector<const OplogEntry*>::const_iterator begin,
+                             std::vector<const OplogEntry*>::const_iterator end) {
+    BSONObjBuilder groupedInsert;
+    for (auto elem : (*begin)->raw) {
+        if (elem.fieldNameStringData() != "o") {
+            groupedInsert.append(elem);
+        }
+    }
+    BSONArrayBuilder documents(groupedInsert.subarrayStart("o"));
+    for (auto it = begin; it != end; ++it) {
+        documents.append((*it)->o.Obj());
+    }
+    documents.done();
+    return OplogEntry(groupedInsert.obj());
+}
+
+}  // namespace
+
 // This free function is used by the writer threads to apply each op
-void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
+void multiSyncApply(const std::vector<OplogEntry>& ops, SyncTail* st) {
     initializeWriterThread();
 
     OperationContextImpl txn;
@@ -843,16 +1055,56 @@ void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
 
     bool convertUpdatesToUpserts = true;
 
-    for (std::vector<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+    // Ops on different namespaces are independent, so a stable sort by namespace brings together
+    // the inserts into each collection without reordering the ops of any one of them.
+    std::vector<const OplogEntry*> sortedOps;
+    sortedOps.reserve(ops.size());
+    for (const OplogEntry& op : ops) {
+        sortedOps.push_back(&op);
+    }
+    std::stable_sort(sortedOps.begin(),
+                     sortedOps.end(),
+                     [](const OplogEntry* l, const OplogEntry* r) { return l->ns < r->ns; });
+
+    // Ops before this point are not grouped again after a grouped insert containing them failed.
+    auto doNotGroupBefore = sortedOps.cbegin();
+
+    for (auto it = sortedOps.cbegin(); it != sortedOps.cend(); ++it) {
+        const OplogEntry& op = **it;
+
+        if (it >= doNotGroupBefore && op.opType == "i" &&
+            nsToCollectionSubstring(op.ns) != "system.indexes") {
+            auto groupEnd = findEndOfGroupedInserts(it, sortedOps.cend());
+            if (groupEnd - it > 1) {
+                try {
+                    uassertStatusOK(SyncTail::syncApply(
+                        &txn, makeGroupedInsert(it, groupEnd), convertUpdatesToUpserts));
+                    // syncApply() counted the grouped insert as one op.
+                    opsAppliedStats.increment(groupEnd - it - 1);
+                    it = groupEnd - 1;
+                    continue;
+                } catch (const DBException& e) {
+                    if (inShutdown()) {
+                        return;
+                    }
+                    // Nothing of the group was written. Apply its inserts one at a time, which
+                    // handles duplicate _ids by turning the insert into an update.
+                    LOG(1) << "failed to apply " << (groupEnd - it) << " inserts into " << op.ns
+                           << " as a group, applying them one by one: " << causedBy(e);
+                    doNotGroupBefore = groupEnd;
+                }
+            }
+        }
+
         try {
-            const Status s = SyncTail::syncApply(&txn, *it, convertUpdatesToUpserts);
+            const Status s = SyncTail::syncApply(&txn, op, convertUpdatesToUpserts);
             if (!s.isOK()) {
-                severe() << "Error applying operation (" << it->toString() << "): " << s;
+                severe() << "Error applying operation (" << op.raw.toString() << "): " << s;
                 fassertFailedNoTrace(16359);
             }
         } catch (const DBException& e) {
             severe() << "writer worker caught exception: " << causedBy(e)
-                     << " on: " << it->toString();
+                     << " on: " << op.raw.toString();
 
             if (inShutdown()) {
                 return;
@@ -864,7 +1116,7 @@ void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
 }
 
 // This free function is used by the initial sync writer threads to apply each op
-void multiInitialSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
+void multiInitialSyncApply(const std::vector<OplogEntry>& ops, SyncTail* st) {
     initializeWriterThread();
 
     OperationContextImpl txn;
@@ -876,14 +1128,15 @@ void multiInitialSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
 
     bool convertUpdatesToUpserts = false;
 
-    for (std::vector<BSONObj>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
+    for (std::vector<OplogEntry>::const_iterator it = ops.begin(); it != ops.end(); ++it) {
         try {
             const Status s = SyncTail::syncApply(&txn, *it, convertUpdatesToUpserts);
             if (!s.isOK()) {
-                if (st->shouldRetry(&txn, *it)) {
+                if (st->shouldRetry(&txn, it->raw)) {
                     const Status s2 = SyncTail::syncApply(&txn, *it, convertUpdatesToUpserts);
                     if (!s2.isOK()) {
-                        severe() << "Error applying operation (" << it->toString() << "): " << s2;
+                        severe() << "Error applying operation (" << it->raw.toString()
+                                 << "): " << s2;
                         fassertFailedNoTrace(15915);
                     }
                 }
@@ -894,7 +1147,7 @@ void multiInitialSyncApply(const std::vector<BSONObj>& ops, SyncTail* st) {
             }
         } catch (const DBException& e) {
             severe() << "writer worker caught exception: " << causedBy(e)
-                     << " on: " << it->toString();
+                     << " on: " << it->raw.toString();
 
             if (inShutdown()) {
                 return;
@@ -32,9 +32,11 @@
 
 #include "mongo/base/status.h"
 #include "mongo/bson/bsonobj.h"
+#include "mongo/db/repl/oplog_entry.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/stdx/functional.h"
-#include "mongo/util/concurrency/old_thread_pool.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+#include "mongo/util/time_support.h"
 
 namespace mongo {
 
@@ -51,7 +53,8 @@ class OpTime;
  */
 class SyncTail {
 public:
-    using MultiSyncApplyFunc = stdx::function<void(const std::vector<BSONObj>& ops, SyncTail* st)>;
+    using MultiSyncApplyFunc =
+        stdx::function<void(const std::vector<OplogEntry>& ops, SyncTail* st)>;
 
     /**
      * Type of function that takes a non-command op and applies it locally.
@@ -84,13 +87,15 @@ public:
      * be overridden for testing.
      */
     static Status syncApply(OperationContext* txn,
-                            const BSONObj& o,
+                            const OplogEntry& op,
                             bool convertUpdateToUpsert,
                             ApplyOperationInLockFn applyOperationInLock,
                             ApplyCommandInLockFn applyCommandInLock,
                             IncrementOpsAppliedStatsFn incrementOpsAppliedStats);
 
-    static Status syncApply(OperationContext* txn, const BSONObj& o, bool convertUpdateToUpsert);
+    static Status syncApply(OperationContext* txn,
+                            const OplogEntry& op,
+                            bool convertUpdateToUpsert);
 
     /**
      * Runs _applyOplogUntil(stopOpTime)
@@ -106,27 +111,61 @@ public:
         size_t getSize() const {
             return _size;
         }
-        const std::deque<BSONObj>& getDeque() const {
+        const std::deque<OplogEntry>& getDeque() const {
             return _deque;
         }
-        void push_back(BSONObj& op) {
+        void push_back(const OplogEntry& op) {
             _deque.push_back(op);
-            _size += op.objsize();
+            _size += op.raw.objsize();
         }
         bool empty() const {
             return _deque.empty();
         }
 
-        BSONObj back() const {
+        const OplogEntry& back() const {
             invariant(!_deque.empty());
             return _deque.back();
         }
 
     private:
-        std::deque<BSONObj> _deque;
+        std::deque<OplogEntry> _deque;
         size_t _size;
     };
 
+    /**
+     * Sizes oplog application batches so that applying one takes about a target time, from the
+     * apply rate measured over recent batches. A backlog of cheap operations is then applied in
+     * large batches, while expensive operations are split up so that one batch does not hold
+     * readers off for long.
+     */
+    class BatchLimiter {
+    public:
+        /**
+         * 'maxOperations' bounds every batch, whatever the measured rate.
+         */
+        explicit BatchLimiter(unsigned int maxOperations) : _maxOperations(maxOperations) {}
+
+        /**
+         * Returns the maximum number of operations for the next batch so that it applies in about
+         * 'targetMillis'. A non-positive target, or no measurement yet, gives 'maxOperations'.
+         */
+        unsigned int getOperationLimit(int targetMillis) const;
+
+        /**
+         * Records that a batch of 'numOperations' took 'elapsed' to apply.
+         */
+        void recordBatch(size_t numOperations, Microseconds elapsed);
+
+        // Smallest limit returned, so that slow batches still make progress.
+        static const unsigned int kMinOperations = 10;
+
+    private:
+        const unsigned int _maxOperations;
+
+        // Moving average of applied operations per microsecond. Zero until the first batch.
+        double _opsPerMicro = 0;
+    };
+
     // returns true if we should continue waiting for BSONObjs, false if we should
     // stop waiting and apply the queue we have.  Only returns false if !ops.empty().
     bool tryPopAndWaitForMore(OperationContext* txn,
@@ -169,8 +208,8 @@ protected:
     // Returns the last OpTime applied.
     static OpTime multiApply(OperationContext* txn,
                              const OpQueue& ops,
-                             OldThreadPool* prefetcherPool,
-                             OldThreadPool* writerPool,
+                             WorkStealingThreadPool* prefetcherPool,
+                             WorkStealingThreadPool* writerPool,
                              MultiSyncApplyFunc func,
                              SyncTail* sync,
                              bool supportsAwaitingCommit);
@@ -190,17 +229,20 @@ private:
     // Function to use during applyOps
     MultiSyncApplyFunc _applyFunc;
 
-    void handleSlaveDelay(const BSONObj& op);
+    void handleSlaveDelay(const OplogEntry& op);
+
+    // Sizes the batches of oplogApplication().
+    BatchLimiter _batchLimiter;
 
     // persistent pool of worker threads for writing ops to the databases
-    OldThreadPool _writerPool;
+    WorkStealingThreadPool _writerPool;
     // persistent pool of worker threads for prefetching
-    OldThreadPool _prefetcherPool;
+    WorkStealingThreadPool _prefetcherPool;
 };
 
 // These free functions are used by the thread pool workers to write ops to the db.
-void multiSyncApply(const std::vector<BSONObj>& ops, SyncTail* st);
-void multiInitialSyncApply(const std::vector<BSONObj>& ops, SyncTail* st);
+void multiSyncApply(const std::vector<OplogEntry>& ops, SyncTail* st);
+void multiInitialSyncApply(const std::vector<OplogEntry>& ops, SyncTail* st);
 
 }  // namespace repl
 }  // namespace mongo
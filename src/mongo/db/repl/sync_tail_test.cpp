@@ -118,9 +118,37 @@ void SyncTailTest::tearDown() {
     setGlobalReplicationCoordinator(nullptr);
 }
 
+TEST(SyncTailBatchLimiterTest, NoTargetOrMeasurementUsesMaximum) {
+    SyncTail::BatchLimiter limiter(5000);
+    ASSERT_EQUALS(5000U, limiter.getOperationLimit(100));
+
+    limiter.recordBatch(100, Milliseconds(1000));
+    ASSERT_EQUALS(5000U, limiter.getOperationLimit(0));
+}
+
+TEST(SyncTailBatchLimiterTest, LimitFollowsMeasuredRate) {
+    SyncTail::BatchLimiter limiter(5000);
+
+    // 1000 operations per second gives 100 operations in 100ms.
+    limiter.recordBatch(1000, Milliseconds(1000));
+    ASSERT_EQUALS(100U, limiter.getOperationLimit(100));
+
+    // Fast batches raise the limit up to the maximum.
+    for (int i = 0; i < 20; i++) {
+        limiter.recordBatch(1000, Milliseconds(1));
+    }
+    ASSERT_EQUALS(5000U, limiter.getOperationLimit(100));
+
+    // Very slow batches lower it down to the minimum.
+    for (int i = 0; i < 100; i++) {
+        limiter.recordBatch(1, Seconds(10));
+    }
+    ASSERT_EQUALS(SyncTail::BatchLimiter::kMinOperations, limiter.getOperationLimit(100));
+}
+
 TEST_F(SyncTailTest, Peek) {
     BackgroundSyncMock bgsync;
-    SyncTail syncTail(&bgsync, [](const std::vector<BSONObj>& ops, SyncTail* st) {});
+    SyncTail syncTail(&bgsync, [](const std::vector<OplogEntry>& ops, SyncTail* st) {});
     BSONObj obj;
     ASSERT_FALSE(syncTail.peek(&obj));
 }
@@ -128,14 +156,14 @@ TEST_F(SyncTailTest, Peek) {
 TEST_F(SyncTailTest, SyncApplyNoNamespaceBadOp) {
     const BSONObj op = BSON("op"
                             << "x");
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, false, _applyOp, _applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), false, _applyOp, _applyCmd, _incOps));
     ASSERT_EQUALS(0U, _opsApplied);
 }
 
 TEST_F(SyncTailTest, SyncApplyNoNamespaceNoOp) {
     ASSERT_OK(SyncTail::syncApply(_txn.get(),
-                                  BSON("op"
-                                       << "n"),
+                                  OplogEntry(BSON("op"
+                                                  << "n")),
                                   false));
     ASSERT_EQUALS(0U, _opsApplied);
 }
@@ -146,7 +174,8 @@ TEST_F(SyncTailTest, SyncApplyBadOp) {
                             << "ns"
                             << "test.t");
     ASSERT_EQUALS(ErrorCodes::BadValue,
-                  SyncTail::syncApply(_txn.get(), op, false, _applyOp, _applyCmd, _incOps).code());
+                  SyncTail::syncApply(
+                      _txn.get(), OplogEntry(op), false, _applyOp, _applyCmd, _incOps).code());
     ASSERT_EQUALS(0U, _opsApplied);
 }
 
@@ -177,7 +206,7 @@ TEST_F(SyncTailTest, SyncApplyNoOp) {
         };
     ASSERT_TRUE(_txn->writesAreReplicated());
     ASSERT_FALSE(documentValidationDisabled(_txn.get()));
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, false, applyOp, applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), false, applyOp, applyCmd, _incOps));
     ASSERT_TRUE(applyOpCalled);
     ASSERT_EQUALS(1U, _opsApplied);
 }
@@ -203,7 +232,7 @@ TEST_F(SyncTailTest, SyncApplyNoOpApplyOpThrowsException) {
             FAIL("applyCommand unexpectedly invoked.");
             return Status::OK();
         };
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, false, applyOp, applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), false, applyOp, applyCmd, _incOps));
     ASSERT_EQUALS(5, applyOpCalled);
     ASSERT_EQUALS(1U, _opsApplied);
 }
@@ -236,7 +265,7 @@ void SyncTailTest::_testSyncApplyInsertDocument(LockMode expectedMode) {
         };
     ASSERT_TRUE(_txn->writesAreReplicated());
     ASSERT_FALSE(documentValidationDisabled(_txn.get()));
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, true, applyOp, applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), true, applyOp, applyCmd, _incOps));
     ASSERT_TRUE(applyOpCalled);
     ASSERT_EQUALS(1U, _opsApplied);
 }
@@ -296,7 +325,7 @@ TEST_F(SyncTailTest, SyncApplyIndexBuild) {
         };
     ASSERT_TRUE(_txn->writesAreReplicated());
     ASSERT_FALSE(documentValidationDisabled(_txn.get()));
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, false, applyOp, applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), false, applyOp, applyCmd, _incOps));
     ASSERT_TRUE(applyOpCalled);
     ASSERT_EQUALS(1U, _opsApplied);
 }
@@ -326,7 +355,7 @@ TEST_F(SyncTailTest, SyncApplyCommand) {
         };
     ASSERT_TRUE(_txn->writesAreReplicated());
     ASSERT_FALSE(documentValidationDisabled(_txn.get()));
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, false, applyOp, applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), false, applyOp, applyCmd, _incOps));
     ASSERT_TRUE(applyCmdCalled);
     ASSERT_EQUALS(1U, _opsApplied);
 }
@@ -352,7 +381,7 @@ TEST_F(SyncTailTest, SyncApplyCommandThrowsException) {
             }
             return Status::OK();
         };
-    ASSERT_OK(SyncTail::syncApply(_txn.get(), op, false, applyOp, applyCmd, _incOps));
+    ASSERT_OK(SyncTail::syncApply(_txn.get(), OplogEntry(op), false, applyOp, applyCmd, _incOps));
     ASSERT_EQUALS(5, applyCmdCalled);
     ASSERT_EQUALS(1U, _opsApplied);
 }
@@ -117,6 +117,7 @@ TopologyCoordinatorImpl::TopologyCoordinatorImpl(Options options)
       _currentPrimaryIndex(-1),
       _forceSyncSourceIndex(-1),
       _options(std::move(options)),
+      _random(static_cast<int64_t>(curTimeMillis64())),
       _selfIndex(-1),
       _stepDownPending(false),
       _maintenanceModeCalls(0),
@@ -931,6 +932,21 @@ HeartbeatResponseAction TopologyCoordinatorImpl::processHeartbeatResponse(
             hbStats.getMillis() * _rsConfig.getVoterPosition(_selfIndex);
     } else {
         heartbeatInterval = _rsConfig.getHeartbeatInterval();
+
+        // Non-voting members only need each other's state to choose sync sources, so they
+        // exchange heartbeats less often. With many non-voters this removes most of the
+        // heartbeats from a set, while every member still heartbeats the voters (and thus the
+        // primary) and is heartbeated by them at the configured interval.
+        const Milliseconds nonVoterInterval =
+            std::min(_options.nonVoterHeartbeatInterval,
+                     _rsConfig.getHeartbeatTimeoutPeriodMillis() / 2);
+        if (nonVoterInterval > heartbeatInterval && _selfIndex >= 0 &&
+            !_selfConfig().isVoter()) {
+            const MemberConfig* targetConfig = _rsConfig.findMemberByHostAndPort(target);
+            if (targetConfig && !targetConfig->isVoter()) {
+                heartbeatInterval = nonVoterInterval;
+            }
+        }
     }
 
     const Milliseconds alreadyElapsed = now - hbStats.getLastHeartbeatStartDate();
@@ -942,6 +958,10 @@ HeartbeatResponseAction TopologyCoordinatorImpl::processHeartbeatResponse(
         nextHeartbeatStartDate = now;
     } else {
         nextHeartbeatStartDate = now + heartbeatInterval;
+        if (_options.maxHeartbeatJitter > Milliseconds(0)) {
+            nextHeartbeatStartDate += Milliseconds(
+                _random.nextInt64(durationCount<Milliseconds>(_options.maxHeartbeatJitter)));
+        }
     }
 
     if (hbResponse.isOK() && hbResponse.getValue().hasConfig()) {
@@ -39,6 +39,7 @@
 #include "mongo/db/repl/replica_set_config.h"
 #include "mongo/db/repl/replication_coordinator.h"
 #include "mongo/db/repl/topology_coordinator.h"
+#include "mongo/platform/random.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/util/time_support.h"
 
@@ -132,6 +133,15 @@ public:
 
         // Whether or not the storage engine supports read committed.
         bool storageEngineSupportsReadCommitted{true};
+
+        // Each regularly scheduled heartbeat is delayed by a random amount below this, so that
+        // the heartbeats of large replica sets do not fall into lockstep.
+        Milliseconds maxHeartbeatJitter{0};
+
+        // When longer than the configured heartbeat interval, the interval at which a non-voting
+        // member heartbeats other non-voting members. It never exceeds half the heartbeat
+        // timeout, so such members still see each other as up.
+        Milliseconds nonVoterHeartbeatInterval{0};
     };
 
     /**
@@ -395,6 +405,9 @@ private:
     // Options for this TopologyCoordinator
     Options _options;
 
+    // Source of the heartbeat jitter
+    PseudoRandom _random;
+
     // "heartbeat message"
     // sent in requestHeartbeat respond in field "hbm"
     std::string _hbmsg;
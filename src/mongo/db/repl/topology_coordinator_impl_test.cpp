@@ -1449,6 +1449,58 @@ TEST_F(TopoCoordTest, ArbiterHeartbeatFrequency) {
     ASSERT_EQUALS(expected, action.getNextHeartbeatStartDate());
 }
 
+TEST_F(TopoCoordTest, NonVotersHeartbeatEachOtherLessOften) {
+    TopologyCoordinatorImpl::Options options;
+    options.nonVoterHeartbeatInterval = Milliseconds(5000);
+    setOptions(options);
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version" << 1 << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself"
+                                               << "votes" << 0 << "priority" << 0)
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2"
+                                                  << "votes" << 0 << "priority" << 0)
+                                    << BSON("_id" << 30 << "host"
+                                                  << "h3")) << "settings"
+                      << BSON("heartbeatTimeoutSecs" << 6)),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    // Between non-voters the interval is capped at half of the heartbeat timeout.
+    HeartbeatResponseAction action =
+        heartbeatFromMember(HostAndPort("h2"), "rs0", MemberState::RS_SECONDARY, OpTime());
+    ASSERT_EQUALS(now() + Milliseconds(3000), action.getNextHeartbeatStartDate());
+
+    // Voters are still heartbeated at the configured interval.
+    action = heartbeatFromMember(HostAndPort("h3"), "rs0", MemberState::RS_SECONDARY, OpTime());
+    ASSERT_EQUALS(now() + Milliseconds(2000), action.getNextHeartbeatStartDate());
+}
+
+TEST_F(TopoCoordTest, HeartbeatJitterDelaysNextHeartbeat) {
+    TopologyCoordinatorImpl::Options options;
+    options.maxHeartbeatJitter = Milliseconds(100);
+    setOptions(options);
+    updateConfig(BSON("_id"
+                      << "rs0"
+                      << "version" << 1 << "members"
+                      << BSON_ARRAY(BSON("_id" << 10 << "host"
+                                               << "hself")
+                                    << BSON("_id" << 20 << "host"
+                                                  << "h2"))),
+                 0);
+    setSelfMemberState(MemberState::RS_SECONDARY);
+
+    for (int i = 0; i < 20; ++i) {
+        HeartbeatResponseAction action =
+            heartbeatFromMember(HostAndPort("h2"), "rs0", MemberState::RS_SECONDARY, OpTime());
+        ASSERT_GREATER_THAN_OR_EQUALS(action.getNextHeartbeatStartDate(),
+                                      now() + Milliseconds(2000));
+        ASSERT_LESS_THAN(action.getNextHeartbeatStartDate(), now() + Milliseconds(2100));
+    }
+}
+
 class HeartbeatResponseTest : public TopoCoordTest {
 public:
     virtual void setUp() {
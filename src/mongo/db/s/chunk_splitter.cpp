@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kSharding
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/s/chunk_splitter.h"
+
+#include "mongo/db/auth/authorization_manager_global.h"
+#include "mongo/db/auth/authorization_session.h"
+#include "mongo/db/client.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/s/collection_metadata.h"
+#include "mongo/db/s/sharded_connection_info.h"
+#include "mongo/db/s/sharding_state.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/s/catalog/type_chunk.h"
+#include "mongo/s/shard_key_pattern.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+
+namespace {
+
+// Whether shard primaries split the chunks they own as data is inserted into them.
+MONGO_EXPORT_SERVER_PARAMETER(shardAutoSplit, bool, false);
+
+// The chunk size, in megabytes, which the chunk splitter keeps chunks under.
+MONGO_EXPORT_SERVER_PARAMETER(shardAutoSplitChunkSizeMB, int, 64);
+
+// A chunk is checked for splitting each time this fraction of the chunk size is inserted into it,
+// matching the routers' split heuristics.
+const int kSplitTestFactor = 5;
+
+// Maximum number of split checks running at the same time
+const int kMaxConcurrentSplits = 3;
+
+}  // namespace
+
+ChunkSplitter::ChunkSplitter() : _splitTickets(kMaxConcurrentSplits) {}
+
+ChunkSplitter::~ChunkSplitter() = default;
+
+void ChunkSplitter::noteInsert(OperationContext* txn, const std::string& ns, const BSONObj& doc) {
+    // Only primaries split, so writes applied from the oplog are not counted.
+    if (!shardAutoSplit || !txn->writesAreReplicated()) {
+        return;
+    }
+
+    ShardingState* const shardingState = ShardingState::get(txn);
+    if (!shardingState->enabled()) {
+        return;
+    }
+
+    const std::shared_ptr<CollectionMetadata> metadata = shardingState->getCollectionMetadata(ns);
+    if (!metadata) {
+        return;
+    }
+
+    const BSONObj keyPattern = metadata->getKeyPattern();
+    const BSONObj shardKey = ShardKeyPattern(keyPattern).extractShardKeyFromDoc(doc);
+    if (shardKey.isEmpty()) {
+        return;
+    }
+
+    ChunkType chunk;
+    if (!metadata->getNextChunk(shardKey, &chunk) || shardKey.woCompare(chunk.getMin()) < 0 ||
+        shardKey.woCompare(chunk.getMax()) >= 0) {
+        // The document is not in a chunk this shard owns yet
+        return;
+    }
+
+    const long long chunkSizeBytes = static_cast<long long>(shardAutoSplitChunkSizeMB) << 20;
+    const OID epoch = metadata->getCollVersion().epoch();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        CollectionWrites& writes = _writes[ns];
+        if (writes.epoch != epoch) {
+            writes.epoch = epoch;
+            writes.bytesByChunk.clear();
+        }
+
+        long long& bytesWritten = writes.bytesByChunk[chunk.getMin()];
+        bytesWritten += doc.objsize();
+        if (bytesWritten < chunkSizeBytes / kSplitTestFactor) {
+            return;
+        }
+
+        if (!_splitTickets.tryAcquire()) {
+            LOG(1) << "won't auto split because not enough tickets: " << ns;
+            return;
+        }
+
+        bytesWritten = 0;
+    }
+
+    const BSONObj min = chunk.getMin().getOwned();
+    const BSONObj max = chunk.getMax().getOwned();
+    stdx::thread([this, ns, keyPattern, min, max, epoch]() {
+        _splitChunk(ns, keyPattern, min, max, epoch);
+    }).detach();
+}
+
+void ChunkSplitter::_splitChunk(const std::string& ns,
+                                const BSONObj& keyPattern,
+                                const BSONObj& min,
+                                const BSONObj& max,
+                                const OID& epoch) {
+    TicketHolderReleaser releaser(&_splitTickets);
+
+    Client::initThread("chunkSplitter");
+    OperationContextImpl txn;
+
+    if (getGlobalAuthorizationManager()->isAuthEnabled()) {
+        ShardedConnectionInfo::addHook();
+        AuthorizationSession::get(txn.getClient())->grantInternalAuthorization();
+    }
+
+    try {
+        ShardingState* const shardingState = ShardingState::get(&txn);
+        const long long chunkSizeBytes = static_cast<long long>(shardAutoSplitChunkSizeMB) << 20;
+
+        DBDirectClient client(&txn);
+
+        BSONObj splitVectorResult;
+        if (!client.runCommand("admin",
+                               BSON("splitVector" << ns << "keyPattern" << keyPattern << "min"
+                                                  << min << "max" << max << "maxChunkSizeBytes"
+                                                  << chunkSizeBytes),
+                               splitVectorResult)) {
+            LOG(1) << "splitVector for auto split of " << ns << " failed: " << splitVectorResult;
+            return;
+        }
+
+        const BSONObj splitKeys = splitVectorResult.getObjectField("splitKeys");
+        if (splitKeys.isEmpty()) {
+            return;
+        }
+
+        BSONObj splitChunkResult;
+        if (!client.runCommand("admin",
+                               BSON("splitChunk" << ns << "keyPattern" << keyPattern << "min"
+                                                 << min << "max" << max << "from"
+                                                 << shardingState->getShardName() << "splitKeys"
+                                                 << BSONArray(splitKeys) << "configdb"
+                                                 << shardingState->getConfigServer(&txn)
+                                                 << "epoch" << epoch),
+                               splitChunkResult)) {
+            warning() << "auto split of chunk [" << min << ", " << max << ") in " << ns
+                      << " failed: " << splitChunkResult;
+            return;
+        }
+
+        log() << "autosplitted chunk [" << min << ", " << max << ") in " << ns << " into "
+              << (splitKeys.nFields() + 1);
+    } catch (const DBException& ex) {
+        warning() << "auto split of chunk [" << min << ", " << max << ") in " << ns
+                  << " failed: " << ex.toStatus();
+    }
+}
+
+}  // namespace mongo
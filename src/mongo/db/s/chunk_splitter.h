@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonmisc.h"
+#include "mongo/bson/oid.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/concurrency/ticketholder.h"
+
+namespace mongo {
+
+class ChunkType;
+class OperationContext;
+
+/**
+ * Tracks, on a shard primary, how much data has been inserted into each chunk of the sharded
+ * collections it owns, and splits a chunk once enough has been written to it that it may have
+ * outgrown the maximum chunk size.
+ *
+ * Writes to a chunk can arrive through any number of routers, each of which only sees its own
+ * share of them, whereas every write to the chunk goes through its shard.
+ */
+class ChunkSplitter {
+    MONGO_DISALLOW_COPYING(ChunkSplitter);
+
+public:
+    ChunkSplitter();
+    ~ChunkSplitter();
+
+    /**
+     * Notes that 'doc' was inserted into the collection 'ns' and, if that brought the data
+     * written to its chunk since it was last checked over the split test threshold, starts a
+     * background check which splits the chunk if it's too large.
+     *
+     * Does nothing unless the shardAutoSplit server parameter is set.
+     */
+    void noteInsert(OperationContext* txn, const std::string& ns, const BSONObj& doc);
+
+private:
+    struct CollectionWrites {
+        OID epoch;
+
+        // Bytes inserted into each chunk since it was last checked, by chunk min key
+        std::map<BSONObj, long long, BSONObjCmp> bytesByChunk;
+    };
+
+    /**
+     * Runs splitVector over the chunk and, if it finds any split points, splits the chunk at
+     * them. Runs on its own thread, holding one of the split tickets.
+     */
+    void _splitChunk(const std::string& ns,
+                     const BSONObj& keyPattern,
+                     const BSONObj& min,
+                     const BSONObj& max,
+                     const OID& epoch);
+
+    // Bounds the number of split checks running at the same time
+    TicketHolder _splitTickets;
+
+    // Protects _writes
+    stdx::mutex _mutex;
+
+    std::map<std::string, CollectionWrites> _writes;
+};
+
+}  // namespace mongo
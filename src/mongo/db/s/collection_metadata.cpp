@@ -32,7 +32,10 @@
 
 #include "mongo/db/s/collection_metadata.h"
 
+#include <algorithm>
+
 #include "mongo/bson/util/builder.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/catalog/type_chunk.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
@@ -45,6 +48,10 @@ using std::string;
 using std::vector;
 using str::stream;
 
+namespace {
+const Ordering kAllAscending = Ordering::make(BSONObj());
+}  // namespace
+
 CollectionMetadata::CollectionMetadata() = default;
 
 CollectionMetadata::~CollectionMetadata() = default;
@@ -195,6 +202,7 @@ CollectionMetadata* CollectionMetadata::cloneMinusPending(const ChunkType& pendi
     metadata->_pendingMap.erase(pending.getMin());
     metadata->_chunksMap = this->_chunksMap;
     metadata->_rangesMap = this->_rangesMap;
+    metadata->_rangesIndex = this->_rangesIndex;
     metadata->_shardVersion = _shardVersion;
     metadata->_collVersion = _collVersion;
 
@@ -229,6 +237,7 @@ CollectionMetadata* CollectionMetadata::clonePlusPending(const ChunkType& pendin
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
     metadata->_rangesMap = this->_rangesMap;
+    metadata->_rangesIndex = this->_rangesIndex;
     metadata->_shardVersion = _shardVersion;
     metadata->_collVersion = _collVersion;
 
@@ -400,6 +409,7 @@ CollectionMetadata* CollectionMetadata::cloneMerge(const BSONObj& minKey,
     metadata->_pendingMap = this->_pendingMap;
     metadata->_chunksMap = this->_chunksMap;
     metadata->_rangesMap = this->_rangesMap;
+    metadata->_rangesIndex = this->_rangesIndex;
     metadata->_shardVersion = newShardVersion;
     metadata->_collVersion = newShardVersion > _collVersion ? newShardVersion : this->_collVersion;
 
@@ -420,28 +430,26 @@ bool CollectionMetadata::keyBelongsToMe(const BSONObj& key) const {
         return true;
     }
 
-    if (_rangesMap.size() <= 0) {
+    if (_rangesIndex.empty()) {
         return false;
     }
 
-    RangeMap::const_iterator it = _rangesMap.upper_bound(key);
-    if (it != _rangesMap.begin())
-        it--;
+    const KeyString encoded(key, kAllAscending);
+    const std::string keyString(encoded.getBuffer(), encoded.getSize());
 
-    bool good = rangeContains(it->first, it->second, key);
+    // Find the last range whose min is at or before the key; the key belongs to it if it is
+    // also before the range's max.
+    auto it = std::upper_bound(
+        _rangesIndex.begin(),
+        _rangesIndex.end(),
+        keyString,
+        [](const string& k, const std::pair<string, string>& range) { return k < range.first; });
+    if (it == _rangesIndex.begin()) {
+        return false;
+    }
+    --it;
 
-#if 0
-        // DISABLED because of SERVER-11175 - huge amount of logging
-        // Logs if the point doesn't belong here.
-        if ( !good ) {
-            log() << "bad: " << key << " " << it->first << " " << key.woCompare( it->first ) << " "
-                  << key.woCompare( it->second );
-
-            for ( RangeMap::const_iterator i = _rangesMap.begin(); i != _rangesMap.end(); ++i ) {
-                log() << "\t" << i->first << "\t" << i->second << "\t";
-            }
-        }
-#endif
+    bool good = keyString < it->second;
 
     return good;
 }
@@ -709,6 +717,18 @@ void CollectionMetadata::fillRanges() {
     dassert(!min.isEmpty());
 
     _rangesMap.insert(make_pair(min, max));
+    fillRangesIndex();
+}
+
+void CollectionMetadata::fillRangesIndex() {
+    _rangesIndex.clear();
+    _rangesIndex.reserve(_rangesMap.size());
+    for (const auto& range : _rangesMap) {
+        const KeyString min(range.first, kAllAscending);
+        const KeyString max(range.second, kAllAscending);
+        _rangesIndex.emplace_back(std::string(min.getBuffer(), min.getSize()),
+                                  std::string(max.getBuffer(), max.getSize()));
+    }
 }
 
 void CollectionMetadata::fillKeyPatternFields() {
@@ -29,6 +29,10 @@
 #pragma once
 
 
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/db/field_ref_set.h"
@@ -299,6 +303,11 @@ private:
     // installations.
     RangeMap _rangesMap;
 
+    // The ranges of _rangesMap as KeyStrings of their min and max keys, sorted by min key.
+    // keyBelongsToMe() binary searches it with memcmp rather than walking the map comparing
+    // BSONObjs.
+    std::vector<std::pair<std::string, std::string>> _rangesIndex;
+
     /**
      * Returns true if this metadata was loaded with all necessary information.
      */
@@ -309,6 +318,11 @@ private:
      */
     void fillRanges();
 
+    /**
+     * Builds _rangesIndex from _rangesMap.
+     */
+    void fillRangesIndex();
+
     /**
      * Creates the _keyField* local data
      */
@@ -53,6 +53,7 @@
 #include "mongo/db/range_deleter_service.h"
 #include "mongo/db/repl/repl_client_info.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/mmap_v1/dur.h"
 #include "mongo/db/s/sharded_connection_info.h"
@@ -62,9 +63,11 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/shard_key_pattern.h"
 #include "mongo/stdx/chrono.h"
+#include "mongo/stdx/future.h"
 #include "mongo/util/fail_point_service.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/timer.h"
 
 namespace mongo {
 
@@ -171,6 +174,13 @@ MONGO_FP_DECLARE(migrateThreadHangAtStep3);
 MONGO_FP_DECLARE(migrateThreadHangAtStep4);
 MONGO_FP_DECLARE(migrateThreadHangAtStep5);
 
+// Caps the rate, in bytes per second, at which a recipient clones the documents of a chunk from
+// the donor. Zero means unlimited.
+MONGO_EXPORT_SERVER_PARAMETER(migrateCloneMaxBytesPerSecond, int, 0);
+
+// Number of cloned documents inserted under a single acquisition of the database lock.
+const int kCloneInsertGroupSize = 100;
+
 
 MigrationDestinationManager::MigrationDestinationManager()
     : _active(false),
@@ -561,11 +571,26 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
         // 3. Initial bulk clone
         setState(CLONE);
 
-        while (true) {
+        // The next batch is requested from the donor while the current one is being inserted, so
+        // that the donor's scan and the network transfer overlap with the local writes.
+        auto fetchBatch = [&conn]() {
             BSONObj res;
-            if (!conn->runCommand("admin",
-                                  BSON("_migrateClone" << 1),
-                                  res)) {  // gets array of objects to copy, in disk order
+            bool ok = conn->runCommand("admin",
+                                       BSON("_migrateClone" << 1),
+                                       res);  // gets array of objects to copy, in disk order
+            return std::make_pair(ok, res.getOwned());
+        };
+
+        Timer cloneTimer;
+        long long bytesThisClone = 0;
+
+        stdx::future<std::pair<bool, BSONObj>> nextBatch =
+            stdx::async(stdx::launch::async, fetchBatch);
+
+        while (true) {
+            const auto batch = nextBatch.get();
+            const BSONObj& res = batch.second;
+            if (!batch.first) {
                 setState(FAIL);
                 errmsg = "_migrateClone failed: ";
                 errmsg += res.toString();
@@ -575,45 +600,65 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
             }
 
             BSONObj arr = res["objects"].Obj();
-            int thisTime = 0;
+            if (arr.isEmpty())
+                break;
+
+            nextBatch = stdx::async(stdx::launch::async, fetchBatch);
 
             BSONObjIterator i(arr);
             while (i.more()) {
-                txn->checkForInterrupt();
-
-                if (getState() == ABORT) {
-                    errmsg = str::stream() << "Migration abort requested while "
-                                           << "copying documents";
-                    error() << errmsg << migrateLog;
-                    return;
-                }
-
-                BSONObj docToClone = i.next().Obj();
+                // Insert the documents in groups, each under a single lock acquisition, rather
+                // than taking the database lock once per document.
+                long long groupBytes = 0;
+                int groupDocs = 0;
                 {
                     OldClientWriteContext cx(txn, ns);
 
-                    BSONObj localDoc;
-                    if (willOverrideLocalId(
-                            txn, ns, min, max, shardKeyPattern, cx.db(), docToClone, &localDoc)) {
-                        string errMsg = str::stream() << "cannot migrate chunk, local document "
-                                                      << localDoc << " has same _id as cloned "
-                                                      << "remote document " << docToClone;
-
-                        warning() << errMsg;
-
-                        // Exception will abort migration cleanly
-                        uasserted(16976, errMsg);
+                    while (i.more() && groupDocs < kCloneInsertGroupSize) {
+                        txn->checkForInterrupt();
+
+                        if (getState() == ABORT) {
+                            errmsg = str::stream() << "Migration abort requested while "
+                                                   << "copying documents";
+                            error() << errmsg << migrateLog;
+                            return;
+                        }
+
+                        BSONObj docToClone = i.next().Obj();
+
+                        BSONObj localDoc;
+                        if (willOverrideLocalId(txn,
+                                                ns,
+                                                min,
+                                                max,
+                                                shardKeyPattern,
+                                                cx.db(),
+                                                docToClone,
+                                                &localDoc)) {
+                            string errMsg = str::stream()
+                                << "cannot migrate chunk, local document " << localDoc
+                                << " has same _id as cloned "
+                                << "remote document " << docToClone;
+
+                            warning() << errMsg;
+
+                            // Exception will abort migration cleanly
+                            uasserted(16976, errMsg);
+                        }
+
+                        Helpers::upsert(txn, ns, docToClone, true);
+
+                        groupDocs++;
+                        groupBytes += docToClone.objsize();
                     }
-
-                    Helpers::upsert(txn, ns, docToClone, true);
                 }
-                thisTime++;
 
                 {
                     stdx::lock_guard<stdx::mutex> statsLock(_mutex);
-                    _numCloned++;
-                    _clonedBytes += docToClone.objsize();
+                    _numCloned += groupDocs;
+                    _clonedBytes += groupBytes;
                 }
+                bytesThisClone += groupBytes;
 
                 if (writeConcern.shouldWaitForOtherNodes()) {
                     repl::ReplicationCoordinator::StatusAndDuration replStatus =
@@ -630,8 +675,16 @@ void MigrationDestinationManager::_migrateDriver(OperationContext* txn,
                 }
             }
 
-            if (thisTime == 0)
-                break;
+            // Stay under the configured cloning bandwidth by sleeping until the bytes cloned so
+            // far would have taken the allowed time to transfer.
+            const int maxBytesPerSecond = migrateCloneMaxBytesPerSecond;
+            if (maxBytesPerSecond > 0) {
+                const long long allowedMillis = bytesThisClone * 1000 / maxBytesPerSecond;
+                const long long elapsedMillis = cloneTimer.millis();
+                if (allowedMillis > elapsedMillis) {
+                    sleepmillis(allowedMillis - elapsedMillis);
+                }
+            }
         }
 
         timing.done(3);
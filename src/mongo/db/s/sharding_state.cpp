@@ -48,6 +48,7 @@
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/sharding_initialization.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/sock.h"
@@ -112,9 +113,12 @@ bool isMongos() {
 
 ShardingState::ShardingState()
     : _enabled(false),
-      _configServerTickets(3 /* max number of concurrent config server refresh threads */) {}
+      _configServerTickets(3 /* max number of concurrent config server refresh threads */),
+      _publishedMetadata(new CollectionMetadataMap()) {}
 
-ShardingState::~ShardingState() = default;
+ShardingState::~ShardingState() {
+    delete _publishedMetadata.load();
+}
 
 ShardingState* ShardingState::get(ServiceContext* serviceContext) {
     return &getShardingState(serviceContext);
@@ -192,22 +196,17 @@ void ShardingState::setShardName(const string& name) {
 void ShardingState::clearCollectionMetadata() {
     stdx::lock_guard<stdx::mutex> lk(_mutex);
     _collMetadata.clear();
+    _publishMetadata_inlock();
 }
 
 // TODO we shouldn't need three ways for checking the version. Fix this.
 bool ShardingState::hasVersion(const string& ns) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    CollectionMetadataMap::const_iterator it = _collMetadata.find(ns);
-    return it != _collMetadata.end();
+    return static_cast<bool>(_findPublishedMetadata(ns));
 }
 
 ChunkVersion ShardingState::getVersion(const string& ns) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    CollectionMetadataMap::const_iterator it = _collMetadata.find(ns);
-    if (it != _collMetadata.end()) {
-        shared_ptr<CollectionMetadata> p = it->second;
+    shared_ptr<CollectionMetadata> p = _findPublishedMetadata(ns);
+    if (p) {
         return p->getShardVersion();
     } else {
         return ChunkVersion(0, 0, OID());
@@ -241,6 +240,7 @@ void ShardingState::donateChunk(OperationContext* txn,
     // TODO: a bit dangerous to have two different zero-version states - no-metadata and
     // no-version
     _collMetadata[ns] = cloned;
+    _publishMetadata_inlock();
 }
 
 void ShardingState::undoDonateChunk(OperationContext* txn,
@@ -254,6 +254,7 @@ void ShardingState::undoDonateChunk(OperationContext* txn,
     CollectionMetadataMap::iterator it = _collMetadata.find(ns);
     verify(it != _collMetadata.end());
     it->second = prevMetadata;
+    _publishMetadata_inlock();
 }
 
 bool ShardingState::notePending(OperationContext* txn,
@@ -298,6 +299,7 @@ bool ShardingState::notePending(OperationContext* txn,
         return false;
 
     _collMetadata[ns] = cloned;
+    _publishMetadata_inlock();
     return true;
 }
 
@@ -341,6 +343,7 @@ bool ShardingState::forgetPending(OperationContext* txn,
         return false;
 
     _collMetadata[ns] = cloned;
+    _publishMetadata_inlock();
     return true;
 }
 
@@ -367,6 +370,7 @@ void ShardingState::splitChunk(OperationContext* txn,
     uassert(16857, errMsg, NULL != cloned.get());
 
     _collMetadata[ns] = cloned;
+    _publishMetadata_inlock();
 }
 
 void ShardingState::mergeChunks(OperationContext* txn,
@@ -388,6 +392,7 @@ void ShardingState::mergeChunks(OperationContext* txn,
     uassert(17004, errMsg, NULL != cloned.get());
 
     _collMetadata[ns] = cloned;
+    _publishMetadata_inlock();
 }
 
 bool ShardingState::inCriticalMigrateSection() {
@@ -404,6 +409,7 @@ void ShardingState::resetMetadata(const string& ns) {
     warning() << "resetting metadata for " << ns << ", this should only be used in testing";
 
     _collMetadata.erase(ns);
+    _publishMetadata_inlock();
 }
 
 Status ShardingState::refreshMetadataIfNeeded(OperationContext* txn,
@@ -690,6 +696,7 @@ Status ShardingState::doRefreshMetadata(OperationContext* txn,
                 installType = InstallType_Drop;
                 _collMetadata.erase(it);
             }
+            _publishMetadata_inlock();
 
             *latestShardVersion = remoteShardVersion;
         }
@@ -792,14 +799,33 @@ bool ShardingState::needCollectionMetadata(OperationContext* txn, const string&
 }
 
 shared_ptr<CollectionMetadata> ShardingState::getCollectionMetadata(const string& ns) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _findPublishedMetadata(ns);
+}
 
-    CollectionMetadataMap::const_iterator it = _collMetadata.find(ns);
-    if (it == _collMetadata.end()) {
-        return shared_ptr<CollectionMetadata>();
-    } else {
-        return it->second;
+shared_ptr<CollectionMetadata> ShardingState::_findPublishedMetadata(const string& ns) const {
+    AtomicWord<long long>& readers = _metadataReaders[_metadataEpoch.load() % 2];
+    readers.fetchAndAdd(1);
+    const CollectionMetadataMap* published = _publishedMetadata.load();
+    CollectionMetadataMap::const_iterator it = published->find(ns);
+    shared_ptr<CollectionMetadata> metadata =
+        it == published->end() ? shared_ptr<CollectionMetadata>() : it->second;
+    readers.fetchAndSubtract(1);
+    return metadata;
+}
+
+void ShardingState::_publishMetadata_inlock() {
+    const CollectionMetadataMap* retired =
+        _publishedMetadata.swap(new CollectionMetadataMap(_collMetadata));
+
+    // A reader holding 'retired' counted itself before the swap. Each flip sends new readers to
+    // the other counter, so the counter it leaves behind drains.
+    for (int i = 0; i < 2; ++i) {
+        const unsigned long long epoch = _metadataEpoch.fetchAndAdd(1);
+        while (_metadataReaders[epoch % 2].load() != 0) {
+            stdx::this_thread::yield();
+        }
     }
+    delete retired;
 }
 
 }  // namespace mongo
@@ -34,8 +34,10 @@
 
 #include "mongo/base/disallow_copying.h"
 #include "mongo/bson/oid.h"
+#include "mongo/db/s/chunk_splitter.h"
 #include "mongo/db/s/migration_destination_manager.h"
 #include "mongo/db/s/migration_source_manager.h"
+#include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/ticketholder.h"
@@ -85,6 +87,10 @@ public:
         return &_migrationDestManager;
     }
 
+    ChunkSplitter* chunkSplitter() {
+        return &_chunkSplitter;
+    }
+
     // Initialize sharding state and begin authenticating outgoing connections and handling
     // shard versions.  If this is not run before sharded operations occur auth will not work
     // and versions will not be tracked.
@@ -309,12 +315,27 @@ private:
                              bool useRequestedVersion,
                              ChunkVersion* latestShardVersion);
 
+    /**
+     * Returns the metadata for 'ns' from the published copy of _collMetadata, without taking
+     * _mutex, or nullptr if the collection has none.
+     */
+    std::shared_ptr<CollectionMetadata> _findPublishedMetadata(const std::string& ns) const;
+
+    /**
+     * Publishes a copy of _collMetadata for lock-free readers, and frees the previous copy once
+     * no reader can be using it. Must be called after every change to _collMetadata.
+     */
+    void _publishMetadata_inlock();
+
     // Manages the state of the migration donor shard
     MigrationSourceManager _migrationSourceManager;
 
     // Manages the state of the migration recipient shard
     MigrationDestinationManager _migrationDestManager;
 
+    // Splits the chunks owned by this shard as data is inserted into them
+    ChunkSplitter _chunkSplitter;
+
     // Protects state below
     stdx::mutex _mutex;
 
@@ -329,6 +350,15 @@ private:
     mutable TicketHolder _configServerTickets;
 
     CollectionMetadataMap _collMetadata;
+
+    // Immutable copy of _collMetadata, replaced by _publishMetadata_inlock(), through which
+    // versioned operations find their metadata without taking _mutex. Each reader counts itself
+    // in _metadataReaders[_metadataEpoch % 2] while it holds the pointer. After replacing the
+    // copy, the publisher flips the epoch twice and waits for each counter in turn to drain,
+    // after which no reader can still hold the previous copy.
+    AtomicWord<const CollectionMetadataMap*> _publishedMetadata;
+    AtomicWord<unsigned long long> _metadataEpoch;
+    mutable AtomicWord<long long> _metadataReaders[2];
 };
 
 }  // namespace mongo
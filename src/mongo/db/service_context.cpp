@@ -113,8 +113,16 @@ Status validateStorageOptions(
 }
 
 ServiceContext::~ServiceContext() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-    invariant(_clients.empty());
+    for (auto& shard : _clientShards) {
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        invariant(shard.clients.empty());
+    }
+}
+
+ServiceContext::ClientShard& ServiceContext::_shardFor(Client* client) {
+    // Clients are heap allocated, so the low bits of their addresses carry no information.
+    const auto addr = reinterpret_cast<uintptr_t>(client);
+    return _clientShards[(addr >> 6) % kNumClientShards];
 }
 
 ServiceContext::UniqueClient ServiceContext::makeClient(std::string desc,
@@ -137,8 +145,9 @@ ServiceContext::UniqueClient ServiceContext::makeClient(std::string desc,
         throw;
     }
     {
-        stdx::lock_guard<stdx::mutex> lk(_mutex);
-        invariant(_clients.insert(client.get()).second);
+        ClientShard& shard = _shardFor(client.get());
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        invariant(shard.clients.insert(client.get()).second);
     }
     return UniqueClient(client.release());
 }
@@ -162,8 +171,9 @@ void ServiceContext::setClockSource(std::unique_ptr<ClockSource> newSource) {
 void ServiceContext::ClientDeleter::operator()(Client* client) const {
     ServiceContext* const service = client->getServiceContext();
     {
-        stdx::lock_guard<stdx::mutex> lk(service->_mutex);
-        invariant(service->_clients.erase(client));
+        ClientShard& shard = service->_shardFor(client);
+        stdx::lock_guard<stdx::mutex> lk(shard.mutex);
+        invariant(shard.clients.erase(client));
     }
     try {
         for (const auto& observer : service->_clientObservers) {
@@ -228,11 +238,26 @@ void ServiceContext::registerClientObserver(std::unique_ptr<ClientObserver> obse
 }
 
 ServiceContext::LockedClientsCursor::LockedClientsCursor(ServiceContext* service)
-    : _lock(service->_mutex), _curr(service->_clients.cbegin()), _end(service->_clients.cend()) {}
+    : _service(service),
+      _lock(service->_clientShards[0].mutex),
+      _curr(service->_clientShards[0].clients.cbegin()),
+      _end(service->_clientShards[0].clients.cend()) {}
 
 Client* ServiceContext::LockedClientsCursor::next() {
-    if (_curr == _end)
+    if (!_lock.owns_lock()) {
+        // Already past the last shard.
         return nullptr;
+    }
+    while (_curr == _end) {
+        if (++_shard == kNumClientShards) {
+            _lock.unlock();
+            return nullptr;
+        }
+        ClientShard& shard = _service->_clientShards[_shard];
+        _lock = stdx::unique_lock<stdx::mutex>(shard.mutex);
+        _curr = shard.clients.cbegin();
+        _end = shard.clients.cend();
+    }
     Client* result = *_curr;
     ++_curr;
     return result;
@@ -28,6 +28,7 @@
 
 #pragma once
 
+#include <array>
 #include <memory>
 #include <vector>
 
@@ -35,6 +36,7 @@
 #include "mongo/db/storage/storage_engine.h"
 #include "mongo/platform/unordered_set.h"
 #include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/decorable.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/tick_source.h"
@@ -146,22 +148,29 @@ public:
     /**
      * Cursor for enumerating the live Client objects belonging to a ServiceContext.
      *
-     * Lifetimes of this type are synchronized with client creation and destruction.
+     * The clients are registered in kNumClientShards independently locked shards, and the cursor
+     * locks one shard at a time, so a scan never stops the whole server from creating or
+     * destroying Client objects. A client created or destroyed during the scan may or may not be
+     * enumerated.
      */
     class LockedClientsCursor {
     public:
         /**
-         * Constructs a cursor for enumerating the clients of "service", blocking "service" from
-         * creating or destroying Client objects until this instance is destroyed.
+         * Constructs a cursor for enumerating the clients of "service".
          */
         explicit LockedClientsCursor(ServiceContext* service);
 
         /**
          * Returns the next client in the enumeration, or nullptr if there are no more clients.
+         *
+         * The returned client is not destroyed before the next call to next() or the destruction
+         * of this cursor, whichever comes first.
          */
         Client* next();
 
     private:
+        ServiceContext* const _service;
+        size_t _shard = 0;
         stdx::unique_lock<stdx::mutex> _lock;
         ClientSet::const_iterator _curr;
         ClientSet::const_iterator _end;
@@ -336,11 +345,24 @@ private:
      */
     virtual std::unique_ptr<OperationContext> _newOpCtx(Client* client) = 0;
 
+    /**
+     * One part of the set of live clients, with its own mutex so that creating and destroying
+     * clients on different shards, and enumerating them, do not contend.
+     */
+    struct ClientShard {
+        stdx::mutex mutex;
+        ClientSet clients;
+    };
+
+    static const size_t kNumClientShards = 16;
+
+    ClientShard& _shardFor(Client* client);
+
     /**
      * Vector of registered observers.
      */
     std::vector<std::unique_ptr<ClientObserver>> _clientObservers;
-    ClientSet _clients;
+    std::array<ClientShard, kNumClientShards> _clientShards;
 
     std::unique_ptr<TickSource> _tickSource;
     std::unique_ptr<ClockSource> _clockSource;
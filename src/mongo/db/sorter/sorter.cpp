@@ -56,6 +56,7 @@
 #include "mongo/db/storage_options.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/s/mongos_options.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/bufreader.h"
 #include "mongo/util/mongoutils/str.h"
@@ -116,16 +117,30 @@ void dassertCompIsSane(const Comparator& comp, const Data& lhs, const Data& rhs)
 #endif
 }
 
-/** Ensures a named file is deleted when this object goes out of scope */
+/**
+ * Ensures a named file is deleted when this object goes out of scope, and releases the bytes it
+ * accounted for in the file's SpillTracker.
+ */
 class FileDeleter {
 public:
-    FileDeleter(const std::string& fileName) : _fileName(fileName) {}
+    FileDeleter(const std::string& fileName, std::shared_ptr<SpillTracker> tracker)
+        : _fileName(fileName),
+          _tracker(tracker ? std::move(tracker) : std::make_shared<SpillTracker>(0, 0)) {}
     ~FileDeleter() {
         DESTRUCTOR_GUARD(boost::filesystem::remove(_fileName);)
+        _tracker->release(_bytes);
+    }
+
+    /** Accounts for 'bytes' about to be written to the file. Throws if over a limit. */
+    void reserve(long long bytes) {
+        uassertStatusOK(_tracker->reserve(bytes));
+        _bytes += bytes;
     }
 
 private:
     const std::string _fileName;
+    const std::shared_ptr<SpillTracker> _tracker;
+    long long _bytes = 0;
 };
 
 /** Returns results from sorted in-memory storage */
@@ -407,6 +422,16 @@ public:
                   const Settings& settings = Settings())
         : _comp(comp), _settings(settings), _opts(opts), _memUsed(0) {
         verify(_opts.limit == 0);
+
+        // Every run being written in the background holds on to its data, so split the memory
+        // budget between those and the run being filled.
+        _spillThreshold = _opts.maxMemoryUsageBytes / (_opts.spillThreads + 1);
+    }
+
+    ~NoLimitSorter() {
+        for (auto& spill : _pendingSpills) {
+            spill->thread.join();
+        }
     }
 
     void add(const Key& key, const Value& val) {
@@ -415,23 +440,26 @@ public:
         _memUsed += key.memUsageForSorter();
         _memUsed += val.memUsageForSorter();
 
-        if (_memUsed > _opts.maxMemoryUsageBytes)
+        if (_memUsed > _spillThreshold)
             spill();
     }
 
     Iterator* done() {
-        if (_iters.empty()) {
-            sort();
+        if (_iters.empty() && _pendingSpills.empty()) {
+            sort(&_data, _comp);
             return new InMemIterator<Key, Value>(_data);
         }
 
         spill();
+        while (!_pendingSpills.empty()) {
+            waitForOldestSpill();
+        }
         return Iterator::merge(_iters, _opts, _comp);
     }
 
     // TEMP these are here for compatibility. Will be replaced with a general stats API
     int numFiles() const {
-        return _iters.size();
+        return _iters.size() + _pendingSpills.size();
     }
     size_t memUsed() const {
         return _memUsed;
@@ -450,15 +478,51 @@ private:
         const Comparator& _comp;
     };
 
-    void sort() {
-        STLComparator less(_comp);
-        std::stable_sort(_data.begin(), _data.end(), less);
+    /**
+     * A run being sorted and written to its file on a background thread.
+     */
+    struct PendingSpill {
+        std::deque<Data> data;
+        std::shared_ptr<Iterator> iter;
+        Status status = Status::OK();
+        stdx::thread thread;
+    };
+
+    static void sort(std::deque<Data>* data, const Comparator& comp) {
+        STLComparator less(comp);
+        std::stable_sort(data->begin(), data->end(), less);
 
         // Does 2x more compares than stable_sort
         // TODO test on windows
         // std::sort(_data.begin(), _data.end(), comp);
     }
 
+    static std::shared_ptr<Iterator> sortAndWrite(std::deque<Data>* data,
+                                                  const Comparator& comp,
+                                                  const SortOptions& opts,
+                                                  const Settings& settings) {
+        sort(data, comp);
+
+        SortedFileWriter<Key, Value> writer(opts, settings);
+        for (; !data->empty(); data->pop_front()) {
+            writer.addAlreadySorted(data->front().first, data->front().second);
+        }
+
+        return std::shared_ptr<Iterator>(writer.done());
+    }
+
+    /**
+     * Joins the oldest background spill and appends its file to _iters. Runs are kept in the
+     * order they were added so the merge stays stable.
+     */
+    void waitForOldestSpill() {
+        std::unique_ptr<PendingSpill> spill = std::move(_pendingSpills.front());
+        _pendingSpills.pop_front();
+        spill->thread.join();
+        uassertStatusOK(spill->status);
+        _iters.push_back(spill->iter);
+    }
+
     void spill() {
         if (_data.empty())
             return;
@@ -475,24 +539,38 @@ private:
                           << " Pass allowDiskUse:true to opt in.");
         }
 
-        sort();
+        _memUsed = 0;
 
-        SortedFileWriter<Key, Value> writer(_opts, _settings);
-        for (; !_data.empty(); _data.pop_front()) {
-            writer.addAlreadySorted(_data.front().first, _data.front().second);
+        if (_opts.spillThreads == 0) {
+            _iters.push_back(sortAndWrite(&_data, _comp, _opts, _settings));
+            return;
         }
 
-        _iters.push_back(std::shared_ptr<Iterator>(writer.done()));
+        if (_pendingSpills.size() >= _opts.spillThreads) {
+            waitForOldestSpill();
+        }
 
-        _memUsed = 0;
+        std::unique_ptr<PendingSpill> spill(new PendingSpill());
+        spill->data.swap(_data);
+        PendingSpill* const spillPtr = spill.get();
+        spill->thread = stdx::thread([this, spillPtr] {
+            try {
+                spillPtr->iter = sortAndWrite(&spillPtr->data, _comp, _opts, _settings);
+            } catch (...) {
+                spillPtr->status = exceptionToStatus();
+            }
+        });
+        _pendingSpills.push_back(std::move(spill));
     }
 
     const Comparator _comp;
     const Settings _settings;
     SortOptions _opts;
     size_t _memUsed;
+    size_t _spillThreshold;
     std::deque<Data> _data;                         // the "current" data
     std::vector<std::shared_ptr<Iterator>> _iters;  // data that has already been spilled
+    std::deque<std::unique_ptr<PendingSpill>> _pendingSpills;  // runs still being spilled
 };
 
 template <typename Key, typename Value, typename Comparator>
@@ -790,6 +868,41 @@ inline unsigned nextFileNumber() {
 }
 }  // namespace sorter
 
+//
+// SpillTracker
+//
+
+inline AtomicInt64& SpillTracker::totalBytesInUse() {
+    // This is unified across all Sorter types and instances.
+    static AtomicInt64 totalBytes;
+    return totalBytes;
+}
+
+inline Status SpillTracker::reserve(long long bytes) {
+    namespace str = mongoutils::str;
+
+    if (_bytesInUse.addAndFetch(bytes) > _maxBytes && _maxBytes > 0) {
+        _bytesInUse.subtractAndFetch(bytes);
+        return Status(ErrorCodes::OutOfDiskSpace,
+                      str::stream() << "Sort exceeded its limit of " << _maxBytes
+                                    << " bytes of temporary files");
+    }
+    if (totalBytesInUse().addAndFetch(bytes) > _maxTotalBytes && _maxTotalBytes > 0) {
+        totalBytesInUse().subtractAndFetch(bytes);
+        _bytesInUse.subtractAndFetch(bytes);
+        return Status(ErrorCodes::OutOfDiskSpace,
+                      str::stream() << "Sorts exceeded the server's limit of " << _maxTotalBytes
+                                    << " bytes of temporary files");
+    }
+    _bytesWritten.addAndFetch(bytes);
+    return Status::OK();
+}
+
+inline void SpillTracker::release(long long bytes) {
+    _bytesInUse.subtractAndFetch(bytes);
+    totalBytesInUse().subtractAndFetch(bytes);
+}
+
 //
 // SortedFileWriter
 //
@@ -822,7 +935,7 @@ SortedFileWriter<Key, Value>::SortedFileWriter(const SortOptions& opts, const Se
                           << "\": " << sorter::myErrnoWithDescription(),
             _file.good());
 
-    _fileDeleter = std::make_shared<sorter::FileDeleter>(_fileName);
+    _fileDeleter = std::make_shared<sorter::FileDeleter>(_fileName, opts.spillTracker);
 
     // throw on failure
     _file.exceptions(std::ios::failbit | std::ios::badbit | std::ios::eofbit);
@@ -848,8 +961,11 @@ void SortedFileWriter<Key, Value>::spill() {
     snappy::Compress(_buffer.buf(), _buffer.len(), &compressed);
     verify(compressed.size() <= size_t(std::numeric_limits<int32_t>::max()));
 
+    const bool useCompressed = compressed.size() < size_t(_buffer.len() / 10 * 9);
+    _fileDeleter->reserve(sizeof(int32_t) + (useCompressed ? compressed.size() : _buffer.len()));
+
     try {
-        if (compressed.size() < size_t(_buffer.len() / 10 * 9)) {
+        if (useCompressed) {
             const int32_t size = -int32_t(compressed.size());  // negative means compressed
             _file.write(reinterpret_cast<const char*>(&size), sizeof(size));
             _file.write(compressed.data(), compressed.size());
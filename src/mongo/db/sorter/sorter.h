@@ -30,12 +30,15 @@
 
 #include <deque>
 #include <fstream>
+#include <memory>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
 #include "mongo/bson/util/builder.h"
+#include "mongo/platform/atomic_word.h"
 
 /**
  * This is the public API for the Sorter (both in-memory and external)
@@ -88,6 +91,45 @@ namespace sorter {
 class FileDeleter;
 }
 
+/**
+ * Accounts for the bytes that external sorts hold in temporary files, both for the sorts sharing
+ * one tracker (normally every sort of one operation) and for every sort in the process. Bytes stay
+ * accounted for until their file is deleted.
+ */
+class SpillTracker {
+    MONGO_DISALLOW_COPYING(SpillTracker);
+
+public:
+    /**
+     * 'maxBytes' bounds the bytes held by the files of the sorts using this tracker, and
+     * 'maxTotalBytes' the bytes held by those of every sort in the process. Zero means no limit.
+     */
+    SpillTracker(long long maxBytes, long long maxTotalBytes)
+        : _maxBytes(maxBytes), _maxTotalBytes(maxTotalBytes) {}
+
+    /**
+     * Accounts for 'bytes' more written to a temporary file. Returns an error, and accounts for
+     * nothing, if that would exceed either limit.
+     */
+    Status reserve(long long bytes);
+
+    void release(long long bytes);
+
+    /// Bytes written by the sorts using this tracker, including those of deleted files.
+    long long bytesWritten() const {
+        return _bytesWritten.load();
+    }
+
+    /// Bytes held by the temporary files of every sort in the process.
+    static AtomicInt64& totalBytesInUse();
+
+private:
+    const long long _maxBytes;
+    const long long _maxTotalBytes;
+    AtomicInt64 _bytesInUse;
+    AtomicInt64 _bytesWritten;
+};
+
 /**
  * Runtime options that control the Sorter's behavior
  */
@@ -97,8 +139,13 @@ struct SortOptions {
     bool extSortAllowed;         /// If false, uassert if more mem needed than allowed.
     std::string tempDir;         /// Directory to directly place files in.
                                  /// Must be explicitly set if extSortAllowed is true.
+    size_t spillThreads;         /// Max runs sorted and written in the background at once.
+                                 /// 0 spills on the thread calling add(). Ignored with a limit.
+    std::shared_ptr<SpillTracker> spillTracker;  /// Accounts for and limits temporary files.
+                                                 /// If null, files count only towards the total.
 
-    SortOptions() : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false) {}
+    SortOptions()
+        : limit(0), maxMemoryUsageBytes(64 * 1024 * 1024), extSortAllowed(false), spillThreads(0) {}
 
     /// Fluent API to support expressions like SortOptions().Limit(1000).ExtSortAllowed(true)
 
@@ -121,6 +168,16 @@ struct SortOptions {
         tempDir = newTempDir;
         return *this;
     }
+
+    SortOptions& SpillThreads(size_t newSpillThreads) {
+        spillThreads = newSpillThreads;
+        return *this;
+    }
+
+    SortOptions& TrackSpills(std::shared_ptr<SpillTracker> newSpillTracker) {
+        spillTracker = std::move(newSpillTracker);
+        return *this;
+    }
 };
 
 /// This is the output from the sorting framework
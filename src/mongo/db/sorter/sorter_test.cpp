@@ -267,6 +267,44 @@ public:
     }
 };
 
+class SpillTrackerTests {
+public:
+    void run() {
+        unittest::TempDir tempDir("spillTrackerTests");
+        const long long totalBefore = SpillTracker::totalBytesInUse().load();
+        {  // within the limit
+            auto tracker = std::make_shared<SpillTracker>(1024 * 1024, 0);
+            std::shared_ptr<IWIterator> iter;
+            {
+                SortedFileWriter<IntWrapper, IntWrapper> writer(
+                    SortOptions().TempDir(tempDir.path()).TrackSpills(tracker));
+                for (int i = 0; i < 1000; i++)
+                    writer.addAlreadySorted(i, -i);
+                iter.reset(writer.done());
+            }
+
+            // The file counts towards the total until it is deleted.
+            const long long written = tracker->bytesWritten();
+            ASSERT_GREATER_THAN(written, 0);
+            ASSERT_EQUALS(SpillTracker::totalBytesInUse().load(), totalBefore + written);
+            ASSERT_ITERATORS_EQUIVALENT(iter, make_shared<IntIterator>(0, 1000));
+        }
+        ASSERT_EQUALS(SpillTracker::totalBytesInUse().load(), totalBefore);
+
+        {  // over the limit
+            auto tracker = std::make_shared<SpillTracker>(100, 0);
+            SortedFileWriter<IntWrapper, IntWrapper> writer(
+                SortOptions().TempDir(tempDir.path()).TrackSpills(tracker));
+            for (int i = 0; i < 1000; i++)
+                writer.addAlreadySorted(i, -i);
+            ASSERT_THROWS_CODE(writer.done(), UserException, ErrorCodes::OutOfDiskSpace);
+            ASSERT_EQUALS(tracker->bytesWritten(), 0);
+        }
+        ASSERT_EQUALS(SpillTracker::totalBytesInUse().load(), totalBefore);
+
+        ASSERT(boost::filesystem::is_empty(tempDir.path()));
+    }
+};
 
 class MergeIteratorTests {
 public:
@@ -510,6 +548,12 @@ public:
     std::unique_ptr<int[]> _array;
 };
 
+// Same as LotsOfDataLittleMemory, with runs sorted and written on background threads.
+class LotsOfDataParallelSpills : public LotsOfDataLittleMemory</*random=*/true> {
+    SortOptions adjustSortOptions(SortOptions opts) {
+        return LotsOfDataLittleMemory::adjustSortOptions(opts).SpillThreads(3);
+    }
+};
 
 template <long long Limit, bool Random = true>
 class LotsOfDataWithLimit : public LotsOfDataLittleMemory<Random> {
@@ -547,12 +591,14 @@ public:
     void setupTests() {
         add<InMemIterTests>();
         add<SortedFileWriterAndFileIteratorTests>();
+        add<SpillTrackerTests>();
         add<MergeIteratorTests>();
         add<SorterTests::Basic>();
         add<SorterTests::Limit>();
         add<SorterTests::Dupes>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/false>>();
         add<SorterTests::LotsOfDataLittleMemory</*random=*/true>>();
+        add<SorterTests::LotsOfDataParallelSpills>();
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/false>>();     // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<1, /*random=*/true>>();      // limit=1 is special case
         add<SorterTests::LotsOfDataWithLimit<100, /*random=*/false>>();   // fits in mem
@@ -43,6 +43,7 @@
 #include "mongo/db/storage_options.h"
 #include "mongo/util/mongoutils/str.h"
 #include "mongo/util/log.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/version.h"
 
@@ -208,7 +209,8 @@ void logMongodStartupWarnings(const StorageGlobalParams& storageParams,
                 }
                 // if the text following the space doesn't begin with 'interleave', then
                 // issue the warning.
-                else if (line.find("interleave", where) != where) {
+                // Connections pinned to nodes are meant to allocate node-local memory.
+                else if (!numaPinConnections && line.find("interleave", where) != where) {
                     log() << startupWarningsLog;
                     log() << "** WARNING: You are running on a NUMA machine." << startupWarningsLog;
                     log() << "**          We suggest launching mongod like this to avoid "
@@ -0,0 +1,356 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/cpu_sampler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <errno.h>
+#include <execinfo.h>
+#include <signal.h>
+#include <sys/time.h>
+#endif
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/threadlocal.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+namespace {
+
+// The tag of the current thread. The length is cleared while the tag is rewritten, so that a
+// signal interrupting the write sees no tag rather than a torn one.
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL char threadTag[CpuSampler::kMaxTagLength];
+MONGO_TRIVIALLY_CONSTRUCTIBLE_THREAD_LOCAL volatile int threadTagLength;
+
+struct Sample {
+    int numFrames;
+    int tagLength;
+    void* frames[CpuSampler::kMaxFrames];
+    char tag[CpuSampler::kMaxTagLength];
+};
+
+// State shared with the signal handler.
+AtomicWord<bool> samplerRunning(false);
+AtomicWord<Sample*> sampleBuffer(nullptr);
+AtomicWord<unsigned long long> nextSample(0);
+AtomicInt32 handlersInFlight(0);
+size_t sampleCapacity = 0;
+
+// State only used by start() and stop(), under samplerMutex.
+stdx::mutex samplerMutex;
+std::unique_ptr<Sample[]> ownedSampleBuffer;
+int samplerPeriodMicros = 0;
+
+}  // namespace
+
+#if defined(__linux__)
+
+namespace {
+
+// The handler and the signal trampoline are at the top of every sampled stack.
+const int kSkipFrames = 2;
+
+struct sigaction previousAction;
+
+void sigprofHandler(int, siginfo_t*, void*) {
+    const int savedErrno = errno;
+    handlersInFlight.fetchAndAdd(1);
+
+    Sample* buffer = sampleBuffer.load();
+    if (buffer) {
+        const size_t index = nextSample.fetchAndAdd(1);
+        if (index < sampleCapacity) {
+            Sample& sample = buffer[index];
+
+            void* frames[CpuSampler::kMaxFrames + kSkipFrames];
+            const int numFrames = backtrace(frames, CpuSampler::kMaxFrames + kSkipFrames);
+            sample.numFrames = std::max(numFrames - kSkipFrames, 0);
+            memcpy(sample.frames, frames + kSkipFrames, sample.numFrames * sizeof(void*));
+
+            sample.tagLength = threadTagLength;
+            memcpy(sample.tag, threadTag, sample.tagLength);
+        }
+    }
+
+    handlersInFlight.fetchAndSubtract(1);
+    errno = savedErrno;
+}
+
+std::string frameName(void* address) {
+    Dl_info info;
+    if (dladdr(address, &info) && info.dli_sname) {
+        int status;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        if (demangled) {
+            std::string name(demangled);
+            free(demangled);
+            return name;
+        }
+        return info.dli_sname;
+    }
+    return str::stream() << address;
+}
+
+Status startTimer(int periodMicros) {
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = sigprofHandler;
+    action.sa_flags = SA_SIGINFO | SA_RESTART;
+    sigemptyset(&action.sa_mask);
+    if (sigaction(SIGPROF, &action, &previousAction) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "sigaction failed: " << strerror(errno));
+    }
+
+    struct itimerval timer;
+    timer.it_interval.tv_sec = periodMicros / 1000000;
+    timer.it_interval.tv_usec = periodMicros % 1000000;
+    timer.it_value = timer.it_interval;
+    if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+        const int err = errno;
+        sigaction(SIGPROF, &previousAction, nullptr);
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "setitimer failed: " << strerror(err));
+    }
+    return Status::OK();
+}
+
+void stopTimer() {
+    struct itimerval timer;
+    memset(&timer, 0, sizeof(timer));
+    setitimer(ITIMER_PROF, &timer, nullptr);
+}
+
+void restoreHandler() {
+    sigaction(SIGPROF, &previousAction, nullptr);
+}
+
+// backtrace() loads libgcc on its first call, which must not happen in the signal handler.
+void warmUpBacktrace() {
+    void* frames[1];
+    backtrace(frames, 1);
+}
+
+}  // namespace
+
+#else
+
+namespace {
+
+std::string frameName(void* address) {
+    return str::stream() << address;
+}
+
+Status startTimer(int periodMicros) {
+    return Status(ErrorCodes::IllegalOperation, "The CPU sampler is only supported on Linux");
+}
+
+void stopTimer() {}
+
+void restoreHandler() {}
+
+void warmUpBacktrace() {}
+
+}  // namespace
+
+#endif
+
+Status CpuSampler::start(int periodMicros, size_t maxSamples) {
+    if (periodMicros <= 0) {
+        return Status(ErrorCodes::BadValue, "The sampling period must be positive");
+    }
+    if (maxSamples == 0) {
+        return Status(ErrorCodes::BadValue, "The maximum number of samples must be positive");
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(samplerMutex);
+    if (samplerRunning.load()) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      "The CPU sampler is already running");
+    }
+
+    warmUpBacktrace();
+
+    ownedSampleBuffer.reset(new Sample[maxSamples]);
+    sampleCapacity = maxSamples;
+    nextSample.store(0);
+    sampleBuffer.store(ownedSampleBuffer.get());
+
+    Status status = startTimer(periodMicros);
+    if (!status.isOK()) {
+        sampleBuffer.store(nullptr);
+        ownedSampleBuffer.reset();
+        return status;
+    }
+
+    samplerPeriodMicros = periodMicros;
+    samplerRunning.store(true);
+    return Status::OK();
+}
+
+Status CpuSampler::stop(BSONObjBuilder* result) {
+    stdx::lock_guard<stdx::mutex> lk(samplerMutex);
+    if (!samplerRunning.load()) {
+        return Status(ErrorCodes::IllegalOperation, "The CPU sampler is not running");
+    }
+
+    stopTimer();
+    sampleBuffer.store(nullptr);
+    samplerRunning.store(false);
+
+    // A signal raised before the timer stopped may still be copying a sample.
+    while (handlersInFlight.load() != 0) {
+        stdx::this_thread::yield();
+    }
+    restoreHandler();
+
+    const size_t taken = nextSample.load();
+    const size_t numSamples = std::min(taken, sampleCapacity);
+
+    // Symbolize each distinct address once, then fold the samples whose tags and frame names
+    // match, whatever their exact return addresses.
+    std::unordered_map<void*, std::string> frameNames;
+    std::map<std::string, long long> folded;
+    for (size_t i = 0; i < numSamples; i++) {
+        const Sample& sample = ownedSampleBuffer[i];
+        std::string stack = sample.tagLength > 0 ? std::string(sample.tag, sample.tagLength)
+                                                  : std::string("<untagged>");
+        for (int frame = sample.numFrames - 1; frame >= 0; frame--) {
+            void* address = sample.frames[frame];
+            auto it = frameNames.find(address);
+            if (it == frameNames.end()) {
+                it = frameNames.emplace(address, frameName(address)).first;
+            }
+            stack += ';';
+            stack += it->second;
+        }
+        folded[stack]++;
+    }
+    ownedSampleBuffer.reset();
+
+    std::vector<std::pair<long long, const std::string*>> byCount;
+    for (const auto& entry : folded) {
+        byCount.emplace_back(entry.second, &entry.first);
+    }
+    std::sort(byCount.begin(),
+              byCount.end(),
+              [](const std::pair<long long, const std::string*>& lhs,
+                 const std::pair<long long, const std::string*>& rhs) {
+                  return lhs.first > rhs.first;
+              });
+
+    result->append("periodMicros", samplerPeriodMicros);
+    result->appendNumber("samples", static_cast<long long>(numSamples));
+    result->appendNumber("dropped", static_cast<long long>(taken - numSamples));
+
+    // Leave the least frequent stacks out rather than exceed the maximum size of a reply.
+    bool truncated = false;
+    {
+        BSONArrayBuilder stacks(result->subarrayStart("stacks"));
+        for (const auto& entry : byCount) {
+            if (result->len() + static_cast<int>(entry.second->size()) >
+                BSONObjMaxUserSize / 2) {
+                truncated = true;
+                break;
+            }
+            BSONObjBuilder stackBuilder(stacks.subobjStart());
+            stackBuilder.append("stack", *entry.second);
+            stackBuilder.appendNumber("count", entry.first);
+        }
+    }
+    result->append("truncated", truncated);
+    return Status::OK();
+}
+
+bool CpuSampler::isRunning() {
+    return samplerRunning.loadRelaxed();
+}
+
+CpuSampler::ScopedTag::ScopedTag(StringData opName, StringData db, StringData coll) {
+    if (!isRunning()) {
+        return;
+    }
+    _active = true;
+
+    _previousLength = threadTagLength;
+    memcpy(_previous, threadTag, _previousLength);
+
+    threadTagLength = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+
+    size_t length = 0;
+    auto appendToTag = [&length](StringData part) {
+        const size_t partLength = std::min(part.size(), kMaxTagLength - length);
+        memcpy(threadTag + length, part.rawData(), partLength);
+        length += partLength;
+    };
+    appendToTag(opName);
+    if (!db.empty()) {
+        appendToTag(" ");
+        appendToTag(db);
+        if (!coll.empty()) {
+            appendToTag(".");
+            appendToTag(coll);
+        }
+    }
+
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    threadTagLength = length;
+}
+
+CpuSampler::ScopedTag::~ScopedTag() {
+    if (!_active) {
+        return;
+    }
+
+    threadTagLength = 0;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    memcpy(threadTag, _previous, _previousLength);
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+    threadTagLength = _previousLength;
+}
+
+}  // namespace mongo
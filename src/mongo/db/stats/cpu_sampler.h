@@ -0,0 +1,95 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * A sampling CPU profiler which is always built in, unlike the gperftools profiler behind the
+ * _cpuProfilerStart command.
+ *
+ * While it runs, a profiling timer interrupts whichever thread is consuming CPU every period with
+ * SIGPROF. The signal handler copies the stack of the interrupted thread, along with the tag that
+ * thread set with a ScopedTag, into a buffer preallocated by start(). stop() symbolizes the samples
+ * and folds identical stacks together.
+ *
+ * Only supported on Linux; start() fails on other platforms.
+ */
+class CpuSampler {
+    MONGO_DISALLOW_COPYING(CpuSampler);
+
+public:
+    static const int kMaxFrames = 32;
+    static const int kMaxTagLength = 96;
+
+    /**
+     * Starts sampling every 'periodMicros' microseconds of CPU time, keeping at most 'maxSamples'
+     * samples. Fails if the sampler is already running.
+     */
+    static Status start(int periodMicros, size_t maxSamples);
+
+    /**
+     * Stops sampling and appends the samples to 'result', as
+     * {periodMicros, samples, dropped, stacks: [{stack, count}, ...]}, with the stacks in
+     * descending order of count. Each stack is in the folded format read by flame graph tools:
+     * the tag of the sampled thread, then its frames from the outermost in, joined by ';'.
+     */
+    static Status stop(BSONObjBuilder* result);
+
+    static bool isRunning();
+
+    /**
+     * Tags the samples taken on the current thread while in scope with "<opName> <db>.<coll>",
+     * or "<opName> <db>" if 'coll' is empty, such as the command and namespace of the operation
+     * it is running. Does nothing unless the sampler is running when constructed, so that it
+     * costs a single atomic load otherwise.
+     */
+    class ScopedTag {
+        MONGO_DISALLOW_COPYING(ScopedTag);
+
+    public:
+        ScopedTag(StringData opName, StringData db, StringData coll = StringData());
+        ~ScopedTag();
+
+    private:
+        bool _active = false;
+        int _previousLength = 0;
+        char _previous[kMaxTagLength];
+    };
+};
+
+}  // namespace mongo
@@ -0,0 +1,110 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/cpu_sampler.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+namespace {
+
+#if defined(__linux__)
+
+TEST(CpuSamplerTest, StartAndStop) {
+    BSONObjBuilder notRunning;
+    ASSERT_EQUALS(ErrorCodes::IllegalOperation, CpuSampler::stop(&notRunning));
+
+    ASSERT_OK(CpuSampler::start(1000, 10000));
+    ASSERT_TRUE(CpuSampler::isRunning());
+    ASSERT_EQUALS(ErrorCodes::ConflictingOperationInProgress, CpuSampler::start(1000, 10000));
+
+    // Burn enough CPU time for the profiling timer to fire many times.
+    volatile unsigned long long x = 0;
+    {
+        CpuSampler::ScopedTag tag("test", "db", "coll");
+        Timer t;
+        while (t.millis() < 300) {
+            for (int i = 0; i < 100000; i++) {
+                x = x + i;
+            }
+        }
+    }
+
+    BSONObjBuilder builder;
+    ASSERT_OK(CpuSampler::stop(&builder));
+    ASSERT_FALSE(CpuSampler::isRunning());
+
+    BSONObj result = builder.obj();
+    ASSERT_EQUALS(1000, result["periodMicros"].numberInt());
+    ASSERT_GREATER_THAN(result["samples"].numberLong(), 0);
+    ASSERT_EQUALS(0, result["dropped"].numberLong());
+    ASSERT_FALSE(result["truncated"].trueValue());
+
+    long long tagged = 0;
+    long long total = 0;
+    for (auto&& elem : result["stacks"].Obj()) {
+        const std::string stack = elem["stack"].String();
+        total += elem["count"].numberLong();
+        if (StringData(stack).startsWith("test db.coll;")) {
+            tagged += elem["count"].numberLong();
+        }
+    }
+    ASSERT_EQUALS(result["samples"].numberLong(), total);
+    ASSERT_GREATER_THAN(tagged, 0);
+}
+
+TEST(CpuSamplerTest, DropsSamplesPastTheLimit) {
+    ASSERT_OK(CpuSampler::start(1000, 1));
+
+    volatile unsigned long long x = 0;
+    Timer t;
+    while (t.millis() < 100) {
+        x = x + 1;
+    }
+
+    BSONObjBuilder builder;
+    ASSERT_OK(CpuSampler::stop(&builder));
+    BSONObj result = builder.obj();
+    ASSERT_EQUALS(1, result["samples"].numberLong());
+    ASSERT_GREATER_THAN(result["dropped"].numberLong(), 0);
+}
+
+#endif
+
+TEST(CpuSamplerTest, RejectsInvalidArguments) {
+    ASSERT_EQUALS(ErrorCodes::BadValue, CpuSampler::start(0, 10));
+    ASSERT_EQUALS(ErrorCodes::BadValue, CpuSampler::start(1000, 0));
+    ASSERT_FALSE(CpuSampler::isRunning());
+}
+
+}  // namespace
+}  // namespace mongo
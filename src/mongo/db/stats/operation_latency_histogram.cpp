@@ -0,0 +1,97 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_latency_histogram.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const int OperationLatencyHistogram::kMaxBuckets;
+
+// Bucket 0 counts latencies of 0 and 1 microseconds. After it, each power of two [2^k, 2^(k+1))
+// is split into a lower and an upper half, for k from 1 to 36; the last bucket also counts
+// anything longer.
+uint64_t OperationLatencyHistogram::getBucketLowerBound(int bucket) {
+    invariant(bucket >= 0 && bucket < kMaxBuckets);
+    if (bucket == 0) {
+        return 0;
+    }
+    const int power = (bucket - 1) / 2 + 1;
+    const bool upperHalf = (bucket - 1) % 2;
+    return (1ULL << power) + (upperHalf ? 1ULL << (power - 1) : 0);
+}
+
+int OperationLatencyHistogram::getBucket(uint64_t latencyMicros) {
+    if (latencyMicros < 2) {
+        return 0;
+    }
+    const int power = 63 - countLeadingZeros64(latencyMicros);
+    const int upperHalf = (latencyMicros >> (power - 1)) & 1;
+    const int bucket = 1 + (power - 1) * 2 + upperHalf;
+    return bucket < kMaxBuckets ? bucket : kMaxBuckets - 1;
+}
+
+void OperationLatencyHistogram::increment(uint64_t latencyMicros, OpType type) {
+    HistogramData& data = _histograms[type];
+    data.buckets[getBucket(latencyMicros)]++;
+    data.entryCount++;
+    data.sumLatencyMicros += latencyMicros;
+}
+
+void OperationLatencyHistogram::append(bool includeHistograms, BSONObjBuilder* builder) const {
+    _append(_histograms[kReads], "reads", includeHistograms, builder);
+    _append(_histograms[kWrites], "writes", includeHistograms, builder);
+    _append(_histograms[kCommands], "commands", includeHistograms, builder);
+}
+
+void OperationLatencyHistogram::_append(const HistogramData& data,
+                                        const char* key,
+                                        bool includeHistograms,
+                                        BSONObjBuilder* builder) {
+    BSONObjBuilder histogramBuilder(builder->subobjStart(key));
+    histogramBuilder.append("latency", static_cast<long long>(data.sumLatencyMicros));
+    histogramBuilder.append("ops", static_cast<long long>(data.entryCount));
+    if (includeHistograms) {
+        BSONArrayBuilder arrayBuilder(histogramBuilder.subarrayStart("histogram"));
+        for (int i = 0; i < kMaxBuckets; i++) {
+            if (data.buckets[i] == 0) {
+                continue;
+            }
+            BSONObjBuilder entryBuilder(arrayBuilder.subobjStart());
+            entryBuilder.append("micros", static_cast<long long>(getBucketLowerBound(i)));
+            entryBuilder.append("count", static_cast<long long>(data.buckets[i]));
+        }
+    }
+}
+
+}  // namespace mongo
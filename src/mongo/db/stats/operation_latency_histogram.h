@@ -0,0 +1,86 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+/**
+ * Latency histograms of the reads, writes and commands run against a namespace or the whole
+ * server. Each histogram counts operations in buckets whose bounds grow by half a power of two,
+ * up to about 19 hours, which keeps any reported percentile within 50% of the true latency for a
+ * fixed amount of space.
+ *
+ * Not thread safe; Top records into and reports histograms under its own lock.
+ */
+class OperationLatencyHistogram {
+public:
+    enum OpType { kReads, kWrites, kCommands };
+
+    static const int kMaxBuckets = 73;
+
+    /**
+     * Returns the smallest latency, in microseconds, counted in bucket 'bucket'.
+     */
+    static uint64_t getBucketLowerBound(int bucket);
+
+    /**
+     * Returns the bucket which counts a latency of 'latencyMicros'.
+     */
+    static int getBucket(uint64_t latencyMicros);
+
+    void increment(uint64_t latencyMicros, OpType type);
+
+    /**
+     * Appends a subobject for each of reads, writes and commands, holding the total latency and
+     * count of its operations and, if 'includeHistograms' is true, the bounds and counts of its
+     * nonempty buckets.
+     */
+    void append(bool includeHistograms, BSONObjBuilder* builder) const;
+
+private:
+    struct HistogramData {
+        std::array<uint64_t, kMaxBuckets> buckets{};
+        uint64_t entryCount = 0;
+        uint64_t sumLatencyMicros = 0;
+    };
+
+    static void _append(const HistogramData& data,
+                        const char* key,
+                        bool includeHistograms,
+                        BSONObjBuilder* builder);
+
+    std::array<HistogramData, 3> _histograms;
+};
+
+}  // namespace mongo
@@ -0,0 +1,85 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/stats/operation_latency_histogram.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+
+namespace {
+
+using namespace mongo;
+
+TEST(OperationLatencyHistogramTest, BucketBounds) {
+    ASSERT_EQUALS(0, OperationLatencyHistogram::getBucket(0));
+    ASSERT_EQUALS(0, OperationLatencyHistogram::getBucket(1));
+    ASSERT_EQUALS(1, OperationLatencyHistogram::getBucket(2));
+    ASSERT_EQUALS(2, OperationLatencyHistogram::getBucket(3));
+    ASSERT_EQUALS(3, OperationLatencyHistogram::getBucket(4));
+    ASSERT_EQUALS(3, OperationLatencyHistogram::getBucket(5));
+    ASSERT_EQUALS(4, OperationLatencyHistogram::getBucket(6));
+    ASSERT_EQUALS(OperationLatencyHistogram::kMaxBuckets - 1,
+                  OperationLatencyHistogram::getBucket(1ULL << 40));
+
+    for (int i = 0; i < OperationLatencyHistogram::kMaxBuckets; i++) {
+        uint64_t lowerBound = OperationLatencyHistogram::getBucketLowerBound(i);
+        ASSERT_EQUALS(i, OperationLatencyHistogram::getBucket(lowerBound));
+        if (i > 0) {
+            ASSERT_EQUALS(i - 1, OperationLatencyHistogram::getBucket(lowerBound - 1));
+        }
+    }
+}
+
+TEST(OperationLatencyHistogramTest, Append) {
+    OperationLatencyHistogram histogram;
+    histogram.increment(3, OperationLatencyHistogram::kReads);
+    histogram.increment(5, OperationLatencyHistogram::kReads);
+    histogram.increment(4, OperationLatencyHistogram::kReads);
+    histogram.increment(1000, OperationLatencyHistogram::kCommands);
+
+    BSONObjBuilder withoutHistograms;
+    histogram.append(false, &withoutHistograms);
+    ASSERT_EQUALS(BSON("reads" << BSON("latency" << 12LL << "ops" << 3LL) << "writes"
+                               << BSON("latency" << 0LL << "ops" << 0LL) << "commands"
+                               << BSON("latency" << 1000LL << "ops" << 1LL)),
+                  withoutHistograms.obj());
+
+    BSONObjBuilder withHistograms;
+    histogram.append(true, &withHistograms);
+    BSONObj stats = withHistograms.obj();
+    ASSERT_EQUALS(BSON_ARRAY(BSON("micros" << 3LL << "count" << 1LL)
+                             << BSON("micros" << 4LL << "count" << 2LL)),
+                  stats["reads"]["histogram"].Obj());
+    ASSERT_EQUALS(BSONArray(), stats["writes"]["histogram"].Obj());
+    ASSERT_EQUALS(BSON_ARRAY(BSON("micros" << 768LL << "count" << 1LL)),
+                  stats["commands"]["histogram"].Obj());
+}
+
+}  // namespace
@@ -89,9 +89,43 @@ void Top::record(StringData ns, int op, int lockType, long long micros, bool com
     _record(coll, op, lockType, micros, command);
 }
 
+namespace {
+
+/**
+ * Returns the class of operation 'op' as counted by OperationLatencyHistogram, or false if it is
+ * not one that is counted.
+ */
+bool getLatencyOpType(int op, bool command, OperationLatencyHistogram::OpType* type) {
+    if (command || op == dbCommand) {
+        *type = OperationLatencyHistogram::kCommands;
+        return true;
+    }
+    switch (op) {
+        case dbQuery:
+        case dbGetMore:
+            *type = OperationLatencyHistogram::kReads;
+            return true;
+        case dbInsert:
+        case dbUpdate:
+        case dbDelete:
+            *type = OperationLatencyHistogram::kWrites;
+            return true;
+        default:
+            return false;
+    }
+}
+
+}  // namespace
+
 void Top::_record(CollectionData& c, int op, int lockType, long long micros, bool command) {
     c.total.inc(micros);
 
+    OperationLatencyHistogram::OpType latencyOpType;
+    if (micros >= 0 && getLatencyOpType(op, command, &latencyOpType)) {
+        c.opLatencyHistogram.increment(micros, latencyOpType);
+        _globalHistogramStats.increment(micros, latencyOpType);
+    }
+
     if (lockType > 0)
         c.writeLock.inc(micros);
     else if (lockType < 0)
@@ -140,6 +174,11 @@ void Top::collectionDropped(StringData ns) {
     _lastDropped = ns.toString();
 }
 
+void Top::appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder) {
+    stdx::lock_guard<SimpleMutex> lk(_lock);
+    _globalHistogramStats.append(includeHistograms, builder);
+}
+
 void Top::cloneMap(Top::UsageMap& out) const {
     stdx::lock_guard<SimpleMutex> lk(_lock);
     out = _usage;
@@ -177,6 +216,10 @@ void Top::_appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const {
         _appendStatsEntry(b, "remove", coll.remove);
         _appendStatsEntry(b, "commands", coll.commands);
 
+        BSONObjBuilder latencyStatsBuilder(bb.subobjStart("latencyStats"));
+        coll.opLatencyHistogram.append(true, &latencyStatsBuilder);
+        latencyStatsBuilder.done();
+
         bb.done();
     }
 }
@@ -31,6 +31,7 @@
 
 #include <boost/date_time/posix_time/posix_time.hpp>
 
+#include "mongo/db/stats/operation_latency_histogram.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/string_map.h"
 
@@ -77,6 +78,9 @@ public:
         UsageData update;
         UsageData remove;
         UsageData commands;
+
+        // Not diffed by the constructor above, which leaves it empty.
+        OperationLatencyHistogram opLatencyHistogram;
     };
 
     typedef StringMap<CollectionData> UsageMap;
@@ -87,6 +91,12 @@ public:
     void cloneMap(UsageMap& out) const;
     void collectionDropped(StringData ns);
 
+    /**
+     * Appends the latency statistics of all the operations recorded, as described by
+     * OperationLatencyHistogram::append().
+     */
+    void appendGlobalLatencyStats(bool includeHistograms, BSONObjBuilder* builder);
+
 private:
     void _appendToUsageMap(BSONObjBuilder& b, const UsageMap& map) const;
     void _appendStatsEntry(BSONObjBuilder& b, const char* statsName, const UsageData& map) const;
@@ -95,6 +105,7 @@ private:
     mutable SimpleMutex _lock;
     UsageMap _usage;
     std::string _lastDropped;
+    OperationLatencyHistogram _globalHistogramStats;
 };
 
 }  // namespace mongo
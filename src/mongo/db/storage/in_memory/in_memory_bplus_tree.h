@@ -0,0 +1,555 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * An ordered map with unique keys, stored as a B+tree whose nodes each keep up to kMaxNodeSize
+ * entries in one array, with the leaves linked in key order. Compared to the red-black trees of
+ * std::map and std::set, a lookup visits a few nodes with their keys next to each other rather
+ * than one heap node per comparison, and a scan walks along arrays.
+ *
+ * The interface is the part of std::map used by the in-memory storage engine, with two
+ * differences:
+ *  - Inserting or erasing an entry invalidates all iterators into the tree.
+ *  - The value type is std::pair<K, V> rather than std::pair<const K, V>, so that entries can be
+ *    moved within nodes. Callers must not modify the keys of entries in the tree.
+ *
+ * Inserting keys in ascending order, as bulk loads do, appends to the last leaf and fills each
+ * leaf before starting the next. Erasing only frees nodes which become empty; underfull nodes are
+ * not merged with their neighbours.
+ *
+ * Not thread safe. Concurrent readers are fine as long as nothing modifies the tree.
+ */
+template <typename K, typename V, typename Compare = std::less<K>>
+class InMemoryBPlusTree {
+    MONGO_DISALLOW_COPYING(InMemoryBPlusTree);
+
+    struct Leaf;
+
+public:
+    typedef K key_type;
+    typedef V mapped_type;
+    typedef std::pair<K, V> value_type;
+
+    static const size_t kMaxNodeSize = 64;
+
+    template <bool IsConst>
+    class Iterator {
+    public:
+        typedef std::bidirectional_iterator_tag iterator_category;
+        typedef typename InMemoryBPlusTree::value_type value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef typename std::conditional<IsConst, const value_type*, value_type*>::type pointer;
+        typedef typename std::conditional<IsConst, const value_type&, value_type&>::type reference;
+
+        Iterator() = default;
+
+        // Also converts an iterator to a const_iterator.
+        Iterator(const Iterator<false>& other)
+            : _tree(other._tree), _leaf(other._leaf), _pos(other._pos) {}
+
+        reference operator*() const {
+            return _leaf->entries[_pos];
+        }
+
+        pointer operator->() const {
+            return &_leaf->entries[_pos];
+        }
+
+        Iterator& operator++() {
+            if (++_pos == _leaf->entries.size()) {
+                _leaf = _leaf->next;
+                _pos = 0;
+            }
+            return *this;
+        }
+
+        Iterator operator++(int) {
+            Iterator old = *this;
+            ++*this;
+            return old;
+        }
+
+        Iterator& operator--() {
+            if (!_leaf) {
+                _leaf = _tree->_lastLeaf;
+                _pos = _leaf->entries.size() - 1;
+            } else if (_pos == 0) {
+                _leaf = _leaf->prev;
+                _pos = _leaf->entries.size() - 1;
+            } else {
+                --_pos;
+            }
+            return *this;
+        }
+
+        Iterator operator--(int) {
+            Iterator old = *this;
+            --*this;
+            return old;
+        }
+
+        bool operator==(const Iterator& other) const {
+            return _leaf == other._leaf && _pos == other._pos;
+        }
+
+        bool operator!=(const Iterator& other) const {
+            return !(*this == other);
+        }
+
+    private:
+        friend class InMemoryBPlusTree;
+        friend class Iterator<!IsConst>;
+
+        Iterator(const InMemoryBPlusTree* tree, Leaf* leaf, size_t pos)
+            : _tree(tree), _leaf(leaf), _pos(pos) {}
+
+        const InMemoryBPlusTree* _tree = nullptr;
+        Leaf* _leaf = nullptr;  // Null at end().
+        size_t _pos = 0;
+    };
+
+    typedef Iterator<false> iterator;
+    typedef Iterator<true> const_iterator;
+    typedef std::reverse_iterator<iterator> reverse_iterator;
+    typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+    explicit InMemoryBPlusTree(const Compare& comp = Compare()) : _comp(comp) {}
+
+    ~InMemoryBPlusTree() {
+        _destroy(_root);
+    }
+
+    const Compare& key_comp() const {
+        return _comp;
+    }
+
+    size_t size() const {
+        return _size;
+    }
+
+    bool empty() const {
+        return _size == 0;
+    }
+
+    iterator begin() {
+        return {this, _firstLeaf, 0};
+    }
+    const_iterator begin() const {
+        return {this, _firstLeaf, 0};
+    }
+
+    iterator end() {
+        return {this, nullptr, 0};
+    }
+    const_iterator end() const {
+        return {this, nullptr, 0};
+    }
+
+    reverse_iterator rbegin() {
+        return reverse_iterator(end());
+    }
+    const_reverse_iterator rbegin() const {
+        return const_reverse_iterator(end());
+    }
+
+    reverse_iterator rend() {
+        return reverse_iterator(begin());
+    }
+    const_reverse_iterator rend() const {
+        return const_reverse_iterator(begin());
+    }
+
+    const_iterator lower_bound(const K& key) const {
+        if (!_root)
+            return end();
+        const Leaf* leaf = _findLeaf(key, nullptr);
+        return _makeIterator(leaf, _lowerBoundInLeaf(leaf, key));
+    }
+    iterator lower_bound(const K& key) {
+        return _toMutable(static_cast<const InMemoryBPlusTree*>(this)->lower_bound(key));
+    }
+
+    const_iterator upper_bound(const K& key) const {
+        if (!_root)
+            return end();
+        const Leaf* leaf = _findLeaf(key, nullptr);
+        return _makeIterator(leaf, _upperBoundInLeaf(leaf, key));
+    }
+    iterator upper_bound(const K& key) {
+        return _toMutable(static_cast<const InMemoryBPlusTree*>(this)->upper_bound(key));
+    }
+
+    const_iterator find(const K& key) const {
+        const_iterator it = lower_bound(key);
+        if (it == end() || _comp(key, it->first))
+            return end();
+        return it;
+    }
+    iterator find(const K& key) {
+        return _toMutable(static_cast<const InMemoryBPlusTree*>(this)->find(key));
+    }
+
+    /**
+     * Inserts 'entry' unless there already is an entry with its key. Returns an iterator to the
+     * entry with the key, and whether it was inserted.
+     */
+    std::pair<iterator, bool> insert(value_type entry) {
+        if (!_root) {
+            Leaf* leaf = new Leaf();
+            leaf->entries.push_back(std::move(entry));
+            _root = _firstLeaf = _lastLeaf = leaf;
+            _height = 1;
+            _size = 1;
+            return {{this, leaf, 0}, true};
+        }
+
+        // Appending to a last leaf with room needs no search.
+        if (_lastLeaf->entries.size() < kMaxNodeSize &&
+            _comp(_lastLeaf->entries.back().first, entry.first)) {
+            _lastLeaf->entries.push_back(std::move(entry));
+            ++_size;
+            return {{this, _lastLeaf, _lastLeaf->entries.size() - 1}, true};
+        }
+
+        Path path;
+        Leaf* leaf = _findLeaf(entry.first, &path);
+        const size_t pos = _lowerBoundInLeaf(leaf, entry.first);
+        if (pos != leaf->entries.size() && !_comp(entry.first, leaf->entries[pos].first))
+            return {{this, leaf, pos}, false};
+
+        leaf->entries.insert(leaf->entries.begin() + pos, std::move(entry));
+        ++_size;
+        if (leaf->entries.size() <= kMaxNodeSize)
+            return {{this, leaf, pos}, true};
+
+        // Split the leaf in two. An entry appended to the last leaf starts a new one instead, so
+        // that ascending inserts leave full leaves behind.
+        const bool appending = leaf == _lastLeaf && pos == leaf->entries.size() - 1;
+        const size_t splitAt = appending ? pos : leaf->entries.size() / 2;
+
+        Leaf* right = new Leaf();
+        std::move(leaf->entries.begin() + splitAt,
+                  leaf->entries.end(),
+                  std::back_inserter(right->entries));
+        leaf->entries.erase(leaf->entries.begin() + splitAt, leaf->entries.end());
+
+        right->prev = leaf;
+        right->next = leaf->next;
+        if (leaf->next) {
+            leaf->next->prev = right;
+        } else {
+            _lastLeaf = right;
+        }
+        leaf->next = right;
+
+        _insertInParents(&path, right->entries.front().first, right, appending);
+
+        if (pos < splitAt)
+            return {{this, leaf, pos}, true};
+        return {{this, right, pos - splitAt}, true};
+    }
+
+    /**
+     * Returns the value for 'key', inserting a default constructed one if there is none.
+     */
+    V& operator[](const K& key) {
+        iterator it = lower_bound(key);
+        if (it != end() && !_comp(key, it->first))
+            return it->second;
+        return insert(value_type(key, V())).first->second;
+    }
+
+    /**
+     * Erases the entry at 'it' and returns an iterator to the entry after it.
+     */
+    iterator erase(const_iterator it) {
+        Leaf* leaf = it._leaf;
+        --_size;
+        if (leaf->entries.size() > 1) {
+            leaf->entries.erase(leaf->entries.begin() + it._pos);
+            return _toMutable(_makeIterator(leaf, it._pos));
+        }
+
+        Leaf* next = leaf->next;
+        _eraseLeaf(leaf);
+        return {this, next, 0};
+    }
+
+    size_t erase(const K& key) {
+        const_iterator it = find(key);
+        if (it == end())
+            return 0;
+        erase(it);
+        return 1;
+    }
+
+    void clear() {
+        _destroy(_root);
+        _root = nullptr;
+        _firstLeaf = _lastLeaf = nullptr;
+        _height = 0;
+        _size = 0;
+    }
+
+    /**
+     * Exchanges the contents of two trees. Iterators into either tree are invalidated.
+     */
+    void swap(InMemoryBPlusTree& other) {
+        using std::swap;
+        swap(_comp, other._comp);
+        swap(_root, other._root);
+        swap(_firstLeaf, other._firstLeaf);
+        swap(_lastLeaf, other._lastLeaf);
+        swap(_height, other._height);
+        swap(_size, other._size);
+    }
+
+    friend void swap(InMemoryBPlusTree& lhs, InMemoryBPlusTree& rhs) {
+        lhs.swap(rhs);
+    }
+
+private:
+    // Each split of the root adds a level, and needs kMaxNodeSize / 2 times as many entries as
+    // the previous one did, so no tree gets near this height.
+    static const size_t kMaxHeight = 16;
+
+    struct Node {
+        explicit Node(bool isLeaf) : isLeaf(isLeaf) {}
+
+        const bool isLeaf;
+    };
+
+    struct Leaf : Node {
+        Leaf() : Node(true) {
+            entries.reserve(kMaxNodeSize + 1);
+        }
+
+        std::vector<value_type> entries;
+        Leaf* prev = nullptr;
+        Leaf* next = nullptr;
+    };
+
+    /**
+     * children[i] holds the keys from keys[i - 1] inclusive up to keys[i] exclusive.
+     */
+    struct Internal : Node {
+        Internal() : Node(false) {
+            keys.reserve(kMaxNodeSize);
+            children.reserve(kMaxNodeSize + 1);
+        }
+
+        std::vector<K> keys;
+        std::vector<Node*> children;
+    };
+
+    /**
+     * The internal nodes passed through on the way from the root to a leaf, and which of their
+     * children was taken.
+     */
+    struct Path {
+        std::array<std::pair<Internal*, size_t>, kMaxHeight> levels;
+        size_t depth = 0;
+    };
+
+    Leaf* _findLeaf(const K& key, Path* path) const {
+        Node* node = _root;
+        size_t depth = 0;
+        while (!node->isLeaf) {
+            Internal* internal = static_cast<Internal*>(node);
+            const size_t child =
+                std::upper_bound(internal->keys.begin(), internal->keys.end(), key, _comp) -
+                internal->keys.begin();
+            if (path)
+                path->levels[depth] = {internal, child};
+            ++depth;
+            node = internal->children[child];
+        }
+        if (path)
+            path->depth = depth;
+        return static_cast<Leaf*>(node);
+    }
+
+    size_t _lowerBoundInLeaf(const Leaf* leaf, const K& key) const {
+        return std::lower_bound(leaf->entries.begin(),
+                                leaf->entries.end(),
+                                key,
+                                [this](const value_type& entry, const K& key) {
+                                    return _comp(entry.first, key);
+                                }) -
+            leaf->entries.begin();
+    }
+
+    size_t _upperBoundInLeaf(const Leaf* leaf, const K& key) const {
+        return std::upper_bound(leaf->entries.begin(),
+                                leaf->entries.end(),
+                                key,
+                                [this](const K& key, const value_type& entry) {
+                                    return _comp(key, entry.first);
+                                }) -
+            leaf->entries.begin();
+    }
+
+    /**
+     * Adds 'right', split off from the node at the end of 'path', to the parents on 'path',
+     * splitting them in turn as they fill up.
+     */
+    void _insertInParents(Path* path, K key, Node* right, bool appending) {
+        size_t depth = path->depth;
+        while (depth > 0) {
+            Internal* parent = path->levels[depth - 1].first;
+            const size_t child = path->levels[depth - 1].second;
+            parent->keys.insert(parent->keys.begin() + child, std::move(key));
+            parent->children.insert(parent->children.begin() + child + 1, right);
+            if (parent->children.size() <= kMaxNodeSize)
+                return;
+
+            // The children from splitAt on move to a new node, and the key between the two halves
+            // moves up to the grandparent.
+            const size_t splitAt =
+                appending ? parent->children.size() - 1 : parent->children.size() / 2;
+            Internal* newRight = new Internal();
+            newRight->children.assign(parent->children.begin() + splitAt, parent->children.end());
+            std::move(parent->keys.begin() + splitAt,
+                      parent->keys.end(),
+                      std::back_inserter(newRight->keys));
+            key = std::move(parent->keys[splitAt - 1]);
+            parent->children.erase(parent->children.begin() + splitAt, parent->children.end());
+            parent->keys.erase(parent->keys.begin() + (splitAt - 1), parent->keys.end());
+
+            right = newRight;
+            --depth;
+        }
+
+        // The root was split.
+        Internal* root = new Internal();
+        root->keys.push_back(std::move(key));
+        root->children.push_back(_root);
+        root->children.push_back(right);
+        _root = root;
+        ++_height;
+        invariant(_height <= kMaxHeight);
+    }
+
+    /**
+     * Unlinks and frees a leaf whose only entry is being erased, along with any parents left
+     * without children.
+     */
+    void _eraseLeaf(Leaf* leaf) {
+        Path path;
+        invariant(_findLeaf(leaf->entries.front().first, &path) == leaf);
+
+        if (leaf->prev) {
+            leaf->prev->next = leaf->next;
+        } else {
+            _firstLeaf = leaf->next;
+        }
+        if (leaf->next) {
+            leaf->next->prev = leaf->prev;
+        } else {
+            _lastLeaf = leaf->prev;
+        }
+        delete leaf;
+
+        for (size_t depth = path.depth; depth > 0; --depth) {
+            Internal* parent = path.levels[depth - 1].first;
+            const size_t child = path.levels[depth - 1].second;
+            parent->children.erase(parent->children.begin() + child);
+            if (!parent->keys.empty())
+                parent->keys.erase(parent->keys.begin() + (child == 0 ? 0 : child - 1));
+
+            if (!parent->children.empty()) {
+                // Drop roots with a single child.
+                while (!_root->isLeaf && static_cast<Internal*>(_root)->children.size() == 1) {
+                    Internal* oldRoot = static_cast<Internal*>(_root);
+                    _root = oldRoot->children.front();
+                    delete oldRoot;
+                    --_height;
+                }
+                return;
+            }
+            delete parent;
+        }
+
+        // That was the last entry.
+        _root = nullptr;
+        _height = 0;
+    }
+
+    /**
+     * Returns an iterator to the entry at 'pos' in 'leaf', which may be one past its end.
+     */
+    const_iterator _makeIterator(const Leaf* leaf, size_t pos) const {
+        Leaf* mutableLeaf = const_cast<Leaf*>(leaf);
+        if (pos == leaf->entries.size())
+            return {this, mutableLeaf->next, 0};
+        return {this, mutableLeaf, pos};
+    }
+
+    iterator _toMutable(const_iterator it) {
+        return {this, it._leaf, it._pos};
+    }
+
+    static void _destroy(Node* node) {
+        if (!node)
+            return;
+        if (node->isLeaf) {
+            delete static_cast<Leaf*>(node);
+            return;
+        }
+        Internal* internal = static_cast<Internal*>(node);
+        for (Node* child : internal->children) {
+            _destroy(child);
+        }
+        delete internal;
+    }
+
+    Compare _comp;
+    Node* _root = nullptr;
+    Leaf* _firstLeaf = nullptr;
+    Leaf* _lastLeaf = nullptr;
+    size_t _height = 0;
+    size_t _size = 0;
+};
+
+}  // namespace mongo
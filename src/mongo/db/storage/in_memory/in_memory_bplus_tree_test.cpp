@@ -0,0 +1,195 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/in_memory/in_memory_bplus_tree.h"
+
+#include <map>
+#include <string>
+
+#include "mongo/platform/random.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+typedef InMemoryBPlusTree<int, std::string> Tree;
+typedef std::map<int, std::string> Map;
+
+void assertSameContents(const Map& expected, const Tree& tree) {
+    ASSERT_EQ(expected.size(), tree.size());
+    ASSERT_EQ(expected.empty(), tree.empty());
+
+    auto it = tree.begin();
+    for (const auto& entry : expected) {
+        ASSERT(it != tree.end());
+        ASSERT_EQ(entry.first, it->first);
+        ASSERT_EQ(entry.second, it->second);
+        ++it;
+    }
+    ASSERT(it == tree.end());
+
+    auto rit = tree.rbegin();
+    for (auto expectedIt = expected.rbegin(); expectedIt != expected.rend(); ++expectedIt) {
+        ASSERT(rit != tree.rend());
+        ASSERT_EQ(expectedIt->first, rit->first);
+        ++rit;
+    }
+    ASSERT(rit == tree.rend());
+}
+
+void assertSameBounds(const Map& expected, const Tree& tree, int key) {
+    auto expectedLower = expected.lower_bound(key);
+    auto lower = tree.lower_bound(key);
+    ASSERT_EQ(expectedLower == expected.end(), lower == tree.end());
+    if (lower != tree.end())
+        ASSERT_EQ(expectedLower->first, lower->first);
+
+    auto expectedUpper = expected.upper_bound(key);
+    auto upper = tree.upper_bound(key);
+    ASSERT_EQ(expectedUpper == expected.end(), upper == tree.end());
+    if (upper != tree.end())
+        ASSERT_EQ(expectedUpper->first, upper->first);
+
+    ASSERT_EQ(expected.count(key) == 1, tree.find(key) != tree.end());
+}
+
+TEST(InMemoryBPlusTree, Empty) {
+    Tree tree;
+    ASSERT(tree.empty());
+    ASSERT(tree.begin() == tree.end());
+    ASSERT(tree.rbegin() == tree.rend());
+    ASSERT(tree.lower_bound(1) == tree.end());
+    ASSERT(tree.find(1) == tree.end());
+    ASSERT_EQ(0U, tree.erase(1));
+}
+
+TEST(InMemoryBPlusTree, InsertIsUnique) {
+    Tree tree;
+    ASSERT(tree.insert({1, "a"}).second);
+    auto result = tree.insert({1, "b"});
+    ASSERT(!result.second);
+    ASSERT_EQ("a", result.first->second);
+    ASSERT_EQ(1U, tree.size());
+
+    tree[1] = "c";
+    tree[2] = "d";
+    assertSameContents({{1, "c"}, {2, "d"}}, tree);
+}
+
+TEST(InMemoryBPlusTree, AscendingAndDescendingInserts) {
+    const int n = 10 * 1000;
+    Map expected;
+    Tree ascending;
+    Tree descending;
+    for (int i = 0; i < n; i++) {
+        expected[i] = std::to_string(i);
+        ASSERT(ascending.insert({i, std::to_string(i)}).second);
+        ASSERT(descending.insert({n - 1 - i, std::to_string(n - 1 - i)}).second);
+    }
+    assertSameContents(expected, ascending);
+    assertSameContents(expected, descending);
+
+    for (int i = -1; i <= n; i += 7) {
+        assertSameBounds(expected, ascending, i);
+        assertSameBounds(expected, descending, i);
+    }
+}
+
+TEST(InMemoryBPlusTree, RandomInsertsAndErases) {
+    PseudoRandom random(1234);
+    Map expected;
+    Tree tree;
+    for (int round = 0; round < 20; round++) {
+        // Alternate between growing and shrinking, so that nodes are both split and freed.
+        const bool growing = round % 2 == 0;
+        for (int i = 0; i < 5000; i++) {
+            const int key = random.nextInt32(20 * 1000);
+            if (growing || random.nextInt32(4) == 0) {
+                const bool inserted = expected.insert({key, std::to_string(i)}).second;
+                ASSERT_EQ(inserted, tree.insert({key, std::to_string(i)}).second);
+            } else {
+                ASSERT_EQ(expected.erase(key), tree.erase(key));
+            }
+        }
+        assertSameContents(expected, tree);
+        for (int i = 0; i < 100; i++) {
+            assertSameBounds(expected, tree, random.nextInt32(20 * 1000));
+        }
+    }
+}
+
+TEST(InMemoryBPlusTree, EraseWhileIterating) {
+    Map expected;
+    Tree tree;
+    for (int i = 0; i < 1000; i++) {
+        expected[i] = "x";
+        tree[i] = "x";
+    }
+
+    // Erase every key from 500 on, and every odd key below it.
+    for (Tree::iterator it = tree.lower_bound(500); it != tree.end();) {
+        it = tree.erase(it);
+    }
+    for (Tree::iterator it = tree.begin(); it != tree.end();) {
+        it = it->first % 2 ? tree.erase(it) : ++it;
+    }
+    for (auto it = expected.begin(); it != expected.end();) {
+        it = it->first >= 500 || it->first % 2 ? expected.erase(it) : ++it;
+    }
+    assertSameContents(expected, tree);
+
+    while (!tree.empty()) {
+        tree.erase(tree.begin());
+    }
+    assertSameContents({}, tree);
+    tree[3] = "y";
+    assertSameContents({{3, "y"}}, tree);
+}
+
+TEST(InMemoryBPlusTree, Swap) {
+    Tree left;
+    Tree right;
+    for (int i = 0; i < 100; i++) {
+        left[i] = "left";
+    }
+    right[1000] = "right";
+
+    swap(left, right);
+    ASSERT_EQ(1U, left.size());
+    ASSERT_EQ(100U, right.size());
+    ASSERT_EQ("right", (--left.end())->second);
+    ASSERT_EQ(99, (--right.end())->first);
+
+    right.clear();
+    assertSameContents({}, right);
+}
+
+}  // namespace
+}  // namespace mongo
@@ -32,12 +32,19 @@
 
 #include "mongo/db/storage/in_memory/in_memory_btree_impl.h"
 
-#include <set>
+#include <deque>
+#include <string>
 
 #include "mongo/db/catalog/index_catalog_entry.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/index_entry_comparison.h"
+#include "mongo/db/storage/in_memory/in_memory_bplus_tree.h"
 #include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
+#include "mongo/db/storage/in_memory/in_memory_simulated_latency.h"
+#include "mongo/db/storage/in_memory/in_memory_version_chain.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
@@ -69,7 +76,50 @@ BSONObj stripFieldNames(const BSONObj& query) {
     return bb.obj();
 }
 
-typedef std::set<IndexKeyEntry, IndexEntryComparison> IndexSet;
+// An index entry never changes its key and RecordId, so its versions only say whether it is
+// present.
+struct IndexEntryVersions {
+    explicit IndexEntryVersions(IndexKeyEntry entry) : entry(std::move(entry)) {}
+
+    IndexKeyEntry entry;
+    InMemoryVersionChain<bool> presence;
+};
+
+// Entries are keyed by the KeyString of their (key, RecordId), so that they are ordered by
+// comparing bytes rather than by BSONObj::woCompare.
+typedef InMemoryBPlusTree<string, IndexEntryVersions> IndexSet;
+
+struct IndexData {
+    explicit IndexData(const Ordering& ordering) : ordering(ordering) {}
+
+    const Ordering ordering;
+
+    mutable stdx::mutex mutex;  // Guards all members below.
+
+    IndexSet entries;
+
+    // Bumped whenever 'entries' gains or loses an entry, which invalidates its iterators.
+    uint64_t entriesEpoch = 0;
+
+    long long keySize = 0;
+
+    // The entries that committed transactions have written over, with the commit version.
+    std::deque<std::pair<uint64_t, string>> versionsToPrune;
+};
+
+string toKeyString(const BSONObj& key, const Ordering& ordering, const RecordId& loc) {
+    const KeyString keyString(key, ordering, loc);
+    return string(keyString.getBuffer(), keyString.getSize());
+}
+
+// Queries use a discriminator in place of the RecordId, so that they sort before or after all
+// entries with the same key.
+string toKeyString(const BSONObj& key,
+                   const Ordering& ordering,
+                   KeyString::Discriminator discriminator) {
+    const KeyString keyString(key, ordering, discriminator);
+    return string(keyString.getBuffer(), keyString.getSize());
+}
 
 // taken from btree_logic.cpp
 Status dupKeyError(const BSONObj& key) {
@@ -80,23 +130,76 @@ Status dupKeyError(const BSONObj& key) {
     return Status(ErrorCodes::DuplicateKey, sb.str());
 }
 
-bool isDup(const IndexSet& data, const BSONObj& key, RecordId loc) {
-    const IndexSet::const_iterator it = data.find(IndexKeyEntry(key, RecordId()));
-    if (it == data.end())
-        return false;
-
-    // Not a dup if the entry is for the same loc.
-    return it->loc != loc;
+/**
+ * Returns whether 'writer' sees an entry for 'key' with another RecordId. Throws a
+ * WriteConflictException if a concurrent transaction has written an entry for 'key'.
+ */
+bool isDup_inlock(const IndexData& data,
+                  const InMemoryTransaction* writer,
+                  const BSONObj& key,
+                  RecordId loc) {
+    bool dup = false;
+    for (auto it = data.entries.lower_bound(
+             toKeyString(key, data.ordering, KeyString::kExclusiveBefore));
+         it != data.entries.end() &&
+         it->second.entry.key.woCompare(key, data.ordering, false) == 0;
+         ++it) {
+        if (it->second.presence.conflictsWith(writer))
+            throw WriteConflictException();
+        if (it->second.entry.loc != loc && it->second.presence.find(writer))
+            dup = true;
+    }
+    return dup;
 }
 
-class InMemoryBtreeBuilderImpl : public SortedDataBuilderInterface {
+// Rolls back a version added to an entry, and has the versions it hides discarded once nothing
+// reads them.
+class IndexChange : public RecoveryUnit::Change {
 public:
-    InMemoryBtreeBuilderImpl(IndexSet* data, long long* currentKeySize, bool dupsAllowed)
+    IndexChange(IndexData* data,
+                shared_ptr<InMemoryTransaction> writer,
+                string keyString,
+                long long keySizeChange,
+                bool hidesOlderVersion)
         : _data(data),
-          _currentKeySize(currentKeySize),
-          _dupsAllowed(dupsAllowed),
-          _comparator(_data->key_comp()) {
-        invariant(_data->empty());
+          _writer(std::move(writer)),
+          _keyString(std::move(keyString)),
+          _keySizeChange(keySizeChange),
+          _hidesOlderVersion(hidesOlderVersion) {}
+
+    virtual void commit() {
+        if (!_hidesOlderVersion)
+            return;
+        const uint64_t commitVersion = _writer ? _writer->getCommitVersion() : 0;
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _data->versionsToPrune.emplace_back(commitVersion, _keyString);
+    }
+
+    virtual void rollback() {
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        auto it = _data->entries.find(_keyString);
+        invariant(it != _data->entries.end());
+        it->second.presence.pop(_writer.get());
+        if (it->second.presence.empty()) {
+            _data->entries.erase(it);
+            _data->entriesEpoch++;
+        }
+        _data->keySize -= _keySizeChange;
+    }
+
+private:
+    IndexData* const _data;
+    const shared_ptr<InMemoryTransaction> _writer;
+    const string _keyString;
+    const long long _keySizeChange;
+    const bool _hidesOlderVersion;
+};
+
+class InMemoryBtreeBuilderImpl : public SortedDataBuilderInterface {
+public:
+    InMemoryBtreeBuilderImpl(IndexData* data, bool dupsAllowed)
+        : _data(data), _dupsAllowed(dupsAllowed) {
+        invariant(_data->entries.empty());
     }
 
     Status addKey(const BSONObj& key, const RecordId& loc) {
@@ -109,41 +212,45 @@ public:
         invariant(loc.isNormal());
         invariant(!hasFieldNames(key));
 
-        if (!_data->empty()) {
+        string keyString = toKeyString(key, _data->ordering, loc);
+
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        if (!_data->entries.empty()) {
             // Compare specified key with last inserted key, ignoring its RecordId
-            int cmp = _comparator.compare(IndexKeyEntry(key, RecordId()), *_last);
-            if (cmp < 0 || (_dupsAllowed && cmp == 0 && loc < _last->loc)) {
+            const IndexKeyEntry& last = _data->entries.rbegin()->second.entry;
+            int cmp = key.woCompare(last.key, _data->ordering, false);
+            if (cmp < 0 || (_dupsAllowed && cmp == 0 && loc < last.loc)) {
                 return Status(ErrorCodes::InternalError,
                               "expected ascending (key, RecordId) order in bulk builder");
-            } else if (!_dupsAllowed && cmp == 0 && loc != _last->loc) {
+            } else if (!_dupsAllowed && cmp == 0 && loc != last.loc) {
                 return dupKeyError(key);
             }
         }
 
-        BSONObj owned = key.getOwned();
-        _last = _data->insert(_data->end(), IndexKeyEntry(owned, loc));
-        *_currentKeySize += key.objsize();
+        // Entries in ascending order are appended to the last leaf of the tree. The index is not
+        // yet visible to queries, so its entries have no writer.
+        auto inserted = _data->entries.insert(
+            IndexSet::value_type(std::move(keyString), IndexEntryVersions({key.getOwned(), loc})));
+        if (inserted.second) {
+            inserted.first->second.presence.push(nullptr, true);
+            _data->entriesEpoch++;
+            _data->keySize += key.objsize();
+        }
 
         return Status::OK();
     }
 
 private:
-    IndexSet* const _data;
-    long long* _currentKeySize;
+    IndexData* const _data;
     const bool _dupsAllowed;
-
-    IndexEntryComparison _comparator;  // used by the bulk builder to detect duplicate keys
-    IndexSet::const_iterator _last;    // or (key, RecordId) ordering violations
 };
 
 class InMemoryBtreeImpl : public SortedDataInterface {
 public:
-    InMemoryBtreeImpl(IndexSet* data) : _data(data) {
-        _currentKeySize = 0;
-    }
+    InMemoryBtreeImpl(IndexData* data) : _data(data) {}
 
     virtual SortedDataBuilderInterface* getBulkBuilder(OperationContext* txn, bool dupsAllowed) {
-        return new InMemoryBtreeBuilderImpl(_data, &_currentKeySize, dupsAllowed);
+        return new InMemoryBtreeBuilderImpl(_data, dupsAllowed);
     }
 
     virtual Status insert(OperationContext* txn,
@@ -160,15 +267,30 @@ public:
             return Status(ErrorCodes::KeyTooLong, msg);
         }
 
-        // TODO optimization: save the iterator from the dup-check to speed up insert
-        if (!dupsAllowed && isDup(*_data, key, loc))
+        simulateInMemoryLatency(InMemoryLatencyKind::kWrite);
+        shared_ptr<InMemoryTransaction> writer = InMemoryRecoveryUnit::getTransaction(txn);
+        string keyString = toKeyString(key, _data->ordering, loc);
+
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _pruneVersions_inlock(txn);
+
+        // The dup-check and insert happen under the same lock, so that concurrent inserts of the
+        // same key conflict.
+        if (!dupsAllowed && isDup_inlock(*_data, writer.get(), key, loc))
             return dupKeyError(key);
 
-        IndexKeyEntry entry(key.getOwned(), loc);
-        if (_data->insert(entry).second) {
-            _currentKeySize += key.objsize();
-            txn->recoveryUnit()->registerChange(new IndexChange(_data, entry, true));
+        auto it = _data->entries.find(keyString);
+        if (it == _data->entries.end()) {
+            it = _data->entries
+                     .insert(IndexSet::value_type(keyString,
+                                                  IndexEntryVersions({key.getOwned(), loc})))
+                     .first;
+            _data->entriesEpoch++;
+        } else if (it->second.presence.find(writer.get())) {
+            return Status::OK();
         }
+
+        _pushVersion_inlock(txn, std::move(writer), it, true, key.objsize());
         return Status::OK();
     }
 
@@ -179,12 +301,15 @@ public:
         invariant(loc.isNormal());
         invariant(!hasFieldNames(key));
 
-        IndexKeyEntry entry(key.getOwned(), loc);
-        const size_t numDeleted = _data->erase(entry);
-        invariant(numDeleted <= 1);
-        if (numDeleted == 1) {
-            _currentKeySize -= key.objsize();
-            txn->recoveryUnit()->registerChange(new IndexChange(_data, entry, false));
+        simulateInMemoryLatency(InMemoryLatencyKind::kWrite);
+        shared_ptr<InMemoryTransaction> writer = InMemoryRecoveryUnit::getTransaction(txn);
+
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _pruneVersions_inlock(txn);
+
+        auto it = _data->entries.find(toKeyString(key, _data->ordering, loc));
+        if (it != _data->entries.end() && it->second.presence.find(writer.get())) {
+            _pushVersion_inlock(txn, std::move(writer), it, boost::none, -key.objsize());
         }
     }
 
@@ -193,7 +318,14 @@ public:
                               long long* numKeysOut,
                               BSONObjBuilder* output) const {
         // TODO check invariants?
-        *numKeysOut = _data->size();
+        const InMemoryTransaction* reader = InMemoryRecoveryUnit::getTransaction(txn).get();
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        long long numKeys = 0;
+        for (auto it = _data->entries.begin(); it != _data->entries.end(); ++it) {
+            if (it->second.presence.find(reader))
+                numKeys++;
+        }
+        *numKeysOut = numKeys;
     }
 
     virtual bool appendCustomStats(OperationContext* txn,
@@ -203,18 +335,27 @@ public:
     }
 
     virtual long long getSpaceUsedBytes(OperationContext* txn) const {
-        return _currentKeySize + (sizeof(IndexKeyEntry) * _data->size());
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        return _data->keySize + (sizeof(IndexSet::value_type) * _data->entries.size());
     }
 
     virtual Status dupKeyCheck(OperationContext* txn, const BSONObj& key, const RecordId& loc) {
         invariant(!hasFieldNames(key));
-        if (isDup(*_data, key, loc))
+        const InMemoryTransaction* writer = InMemoryRecoveryUnit::getTransaction(txn).get();
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        if (isDup_inlock(*_data, writer, key, loc))
             return dupKeyError(key);
         return Status::OK();
     }
 
     virtual bool isEmpty(OperationContext* txn) {
-        return _data->empty();
+        const InMemoryTransaction* reader = InMemoryRecoveryUnit::getTransaction(txn).get();
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        for (auto it = _data->entries.begin(); it != _data->entries.end(); ++it) {
+            if (it->second.presence.find(reader))
+                return false;
+        }
+        return true;
     }
 
     virtual Status touch(OperationContext* txn) const {
@@ -224,102 +365,76 @@ public:
 
     class Cursor final : public SortedDataInterface::Cursor {
     public:
-        Cursor(OperationContext* txn, const IndexSet& data, bool isForward)
-            : _txn(txn), _data(data), _forward(isForward), _it(data.end()) {}
+        Cursor(OperationContext* txn, const IndexData& data, bool isForward)
+            : _txn(txn), _data(data), _forward(isForward) {}
 
         boost::optional<IndexKeyEntry> next(RequestedInfo parts) override {
-            if (_lastMoveWasRestore) {
-                // Return current position rather than advancing.
-                _lastMoveWasRestore = false;
-            } else {
-                advance();
-                if (atEndPoint())
-                    _isEOF = true;
-            }
-
             if (_isEOF)
                 return {};
-            return *_it;
+
+            simulateInMemoryLatency(InMemoryLatencyKind::kRead);
+            stdx::lock_guard<stdx::mutex> lk(_data.mutex);
+            IndexSet::const_iterator it;
+            if (_itEpoch == _data.entriesEpoch) {
+                // _it is still at _key.
+                it = _it;
+                if (_forward)
+                    ++it;
+            } else {
+                it = _forward ? _data.entries.upper_bound(_key) : _data.entries.lower_bound(_key);
+            }
+            return settle_inlock(it);
         }
 
         void setEndPosition(const BSONObj& key, bool inclusive) override {
             if (key.isEmpty()) {
                 // This means scan to end of index.
-                _endState = boost::none;
+                _endQuery = boost::none;
                 return;
             }
 
             // NOTE: this uses the opposite min/max rules as a normal seek because a forward
             // scan should land after the key if inclusive and before if exclusive.
-            _endState = EndState(stripFieldNames(key),
-                                 _forward == inclusive ? RecordId::max() : RecordId::min());
-            seekEndCursor();
+            _endQuery = toKeyString(stripFieldNames(key),
+                                    _data.ordering,
+                                    _forward == inclusive ? KeyString::kExclusiveAfter
+                                                          : KeyString::kExclusiveBefore);
         }
 
         boost::optional<IndexKeyEntry> seek(const BSONObj& key,
                                             bool inclusive,
                                             RequestedInfo parts) override {
             const BSONObj query = stripFieldNames(key);
-            locate(query, _forward == inclusive ? RecordId::min() : RecordId::max());
-            _lastMoveWasRestore = false;
-            if (_isEOF)
-                return {};
-            dassert(inclusive ? compareKeys(_it->key, query) >= 0
-                              : compareKeys(_it->key, query) > 0);
-            return *_it;
+            auto entry = locate(toKeyString(query,
+                                            _data.ordering,
+                                            _forward == inclusive ? KeyString::kExclusiveBefore
+                                                                  : KeyString::kExclusiveAfter));
+            dassert(!entry || (inclusive ? compareKeys(entry->key, query) >= 0
+                                         : compareKeys(entry->key, query) > 0));
+            return entry;
         }
 
         boost::optional<IndexKeyEntry> seek(const IndexSeekPoint& seekPoint,
                                             RequestedInfo parts) override {
             // Query encodes exclusive case so it can be treated as an inclusive query.
             const BSONObj query = IndexEntryComparison::makeQueryObject(seekPoint, _forward);
-            locate(query, _forward ? RecordId::min() : RecordId::max());
-            _lastMoveWasRestore = false;
-            if (_isEOF)
-                return {};
-            dassert(compareKeys(_it->key, query) >= 0);
-            return *_it;
+            const auto discriminator =
+                _forward ? KeyString::kExclusiveBefore : KeyString::kExclusiveAfter;
+            auto entry = locate(toKeyString(query, _data.ordering, discriminator));
+            dassert(!entry || compareKeys(entry->key, query) >= 0);
+            return entry;
         }
 
         void save() override {
-            // Keep original position if we haven't moved since the last restore.
-            _txn = nullptr;
-            if (_lastMoveWasRestore)
-                return;
-
-            if (_isEOF) {
-                saveUnpositioned();
-                return;
-            }
-
-            _savedAtEnd = false;
-            _savedKey = _it->key.getOwned();
-            _savedLoc = _it->loc;
-            // Doing nothing with end cursor since it will do full reseek on restore.
+            // Nothing to do, since the cursor moves from the key it last returned, which is
+            // correct even if index entries have been inserted or removed around it.
         }
 
         void saveUnpositioned() override {
-            _savedAtEnd = true;
-            // Doing nothing with end cursor since it will do full reseek on restore.
+            _isEOF = true;
         }
 
-        void restore() override {
-            // Always do a full seek on restore. We cannot use our last position since index
-            // entries may have been inserted closer to our endpoint and we would need to move
-            // over them.
-            seekEndCursor();
-
-            if (_savedAtEnd) {
-                _isEOF = true;
-                return;
-            }
-
-            // Need to find our position from the root.
-            locate(_savedKey, _savedLoc);
-
-            _lastMoveWasRestore = _isEOF  // We weren't EOF but now are.
-                || _data.value_comp().compare(*_it, {_savedKey, _savedLoc}) != 0;
-        }
+        void restore() override {}
 
         void detachFromOperationContext() final {
             _txn = nullptr;
@@ -330,40 +445,55 @@ public:
         }
 
     private:
-        bool atEndPoint() const {
-            return _endState && _it == _endState->it;
+        boost::optional<IndexKeyEntry> locate(const string& query) {
+            simulateInMemoryLatency(InMemoryLatencyKind::kRead);
+            stdx::lock_guard<stdx::mutex> lk(_data.mutex);
+            _isEOF = false;
+            return settle_inlock(_forward ? _data.entries.lower_bound(query)
+                                          : _data.entries.upper_bound(query));
         }
 
-        // Advances once in the direction of the scan, updating _isEOF as needed.
-        // Does nothing if already _isEOF.
-        void advance() {
-            if (_isEOF)
-                return;
-            if (_forward) {
-                if (_it != _data.end())
-                    ++_it;
-                if (_it == _data.end() || atEndPoint())
-                    _isEOF = true;
-            } else {
-                if (_it == _data.begin() || _data.empty()) {
-                    _isEOF = true;
+        // Returns the first entry at or after 'it' in the direction of the scan that this
+        // transaction sees, unless it is past the end point. For reverse cursors, 'it' is one past
+        // the first candidate.
+        boost::optional<IndexKeyEntry> settle_inlock(IndexSet::const_iterator it) {
+            const shared_ptr<InMemoryTransaction> reader =
+                InMemoryRecoveryUnit::getTransaction(_txn);
+            while (true) {
+                if (_forward) {
+                    if (it == _data.entries.end())
+                        break;
                 } else {
-                    --_it;
+                    if (it == _data.entries.begin())
+                        break;
+                    --it;
                 }
-                if (atEndPoint())
-                    _isEOF = true;
+
+                if (atOrPastEndPoint(it->first))
+                    break;
+
+                if (it->second.presence.find(reader.get())) {
+                    _it = it;
+                    _itEpoch = _data.entriesEpoch;
+                    _key = it->first;
+                    return it->second.entry;
+                }
+
+                if (_forward)
+                    ++it;
             }
+
+            _isEOF = true;
+            return {};
         }
 
-        bool atOrPastEndPointAfterSeeking() const {
-            if (_isEOF)
-                return true;
-            if (!_endState)
+        bool atOrPastEndPoint(const string& key) const {
+            if (!_endQuery)
                 return false;
 
-            const int cmp = _data.value_comp().compare(*_it, _endState->query);
+            const int cmp = key.compare(*_endQuery);
 
-            // We set up _endState->query to be in between the last in-range value and the first
+            // We set up _endQuery to be in between the last in-range value and the first
             // out-of-range value. In particular, it is constructed to never equal any legal
             // index key.
             dassert(cmp != 0);
@@ -377,74 +507,26 @@ public:
             }
         }
 
-        void locate(const BSONObj& key, const RecordId& loc) {
-            _isEOF = false;
-            const auto query = IndexKeyEntry(key, loc);
-            _it = _data.lower_bound(query);
-            if (_forward) {
-                if (_it == _data.end())
-                    _isEOF = true;
-            } else {
-                // lower_bound lands us on or after query. Reverse cursors must be on or before.
-                if (_it == _data.end() || _data.value_comp().compare(*_it, query) > 0)
-                    advance();  // sets _isEOF if there is nothing more to return.
-            }
-
-            if (atOrPastEndPointAfterSeeking())
-                _isEOF = true;
-        }
-
         // Returns comparison relative to direction of scan. If rhs would be seen later, returns
         // a positive value.
         int compareKeys(const BSONObj& lhs, const BSONObj& rhs) const {
-            int cmp = _data.value_comp().compare({lhs, RecordId()}, {rhs, RecordId()});
+            int cmp = lhs.woCompare(rhs, _data.ordering, false);
             return _forward ? cmp : -cmp;
         }
 
-        void seekEndCursor() {
-            if (!_endState || _data.empty())
-                return;
-
-            auto it = _data.lower_bound(_endState->query);
-            if (!_forward) {
-                // lower_bound lands us on or after query. Reverse cursors must be on or before.
-                if (it == _data.end() || _data.value_comp().compare(*it, _endState->query) > 0) {
-                    if (it == _data.begin()) {
-                        it = _data.end();  // all existing data in range.
-                    } else {
-                        --it;
-                    }
-                }
-            }
-
-            if (it != _data.end())
-                dassert(compareKeys(it->key, _endState->query.key) >= 0);
-            _endState->it = it;
-        }
-
         OperationContext* _txn;  // not owned
-        const IndexSet& _data;
+        const IndexData& _data;
         const bool _forward;
         bool _isEOF = true;
-        IndexSet::const_iterator _it;
 
-        struct EndState {
-            EndState(BSONObj key, RecordId loc) : query(std::move(key), loc) {}
+        // The key of the entry last returned, where the next move starts from.
+        string _key;
 
-            IndexKeyEntry query;
-            IndexSet::const_iterator it;
-        };
-        boost::optional<EndState> _endState;
-
-        // Used by next to decide to return current position rather than moving. Should be reset
-        // to false by any operation that moves the cursor, other than subsequent save/restore
-        // pairs.
-        bool _lastMoveWasRestore = false;
-
-        // For save/restore since _it may be invalidated during a yield.
-        bool _savedAtEnd = false;
-        BSONObj _savedKey;
-        RecordId _savedLoc;
+        // Positioned at _key while _itEpoch is the entries' epoch.
+        IndexSet::const_iterator _it;
+        uint64_t _itEpoch = 0;
+
+        boost::optional<string> _endQuery;
     };
 
     virtual std::unique_ptr<SortedDataInterface::Cursor> newCursor(OperationContext* txn,
@@ -458,27 +540,45 @@ public:
     }
 
 private:
-    class IndexChange : public RecoveryUnit::Change {
-    public:
-        IndexChange(IndexSet* data, const IndexKeyEntry& entry, bool insert)
-            : _data(data), _entry(entry), _insert(insert) {}
-
-        virtual void commit() {}
-        virtual void rollback() {
-            if (_insert)
-                _data->erase(_entry);
-            else
-                _data->insert(_entry);
-        }
+    /**
+     * Adds a version of the entry at 'it', written by 'writer'. Throws a WriteConflictException
+     * if a concurrent transaction has written the entry.
+     */
+    void _pushVersion_inlock(OperationContext* txn,
+                             shared_ptr<InMemoryTransaction> writer,
+                             IndexSet::iterator it,
+                             boost::optional<bool> present,
+                             long long keySizeChange) {
+        if (it->second.presence.conflictsWith(writer.get()))
+            throw WriteConflictException();
+
+        const bool isInsert = it->second.presence.empty();
+        txn->recoveryUnit()->registerChange(
+            new IndexChange(_data, writer, it->first, keySizeChange, !isInsert));
+        it->second.presence.push(std::move(writer), present);
+        _data->keySize += keySizeChange;
+    }
 
-    private:
-        IndexSet* _data;
-        const IndexKeyEntry _entry;
-        const bool _insert;
-    };
+    /**
+     * Discards the versions that committed transactions have hidden from every reader.
+     */
+    void _pruneVersions_inlock(OperationContext* txn) {
+        if (_data->versionsToPrune.empty())
+            return;
+
+        const uint64_t oldestReadVersion = InMemoryRecoveryUnit::getOldestReadVersion(txn);
+        while (!_data->versionsToPrune.empty() &&
+               _data->versionsToPrune.front().first <= oldestReadVersion) {
+            auto it = _data->entries.find(_data->versionsToPrune.front().second);
+            _data->versionsToPrune.pop_front();
+            if (it != _data->entries.end() && it->second.presence.prune(oldestReadVersion)) {
+                _data->entries.erase(it);
+                _data->entriesEpoch++;
+            }
+        }
+    }
 
-    IndexSet* _data;
-    long long _currentKeySize;
+    IndexData* _data;
 };
 }  // namespace
 
@@ -488,9 +588,9 @@ SortedDataInterface* getInMemoryBtreeImpl(const Ordering& ordering,
                                           std::shared_ptr<void>* dataInOut) {
     invariant(dataInOut);
     if (!*dataInOut) {
-        *dataInOut = std::make_shared<IndexSet>(IndexEntryComparison(ordering));
+        *dataInOut = std::make_shared<IndexData>(ordering);
     }
-    return new InMemoryBtreeImpl(static_cast<IndexSet*>(dataInOut->get()));
+    return new InMemoryBtreeImpl(static_cast<IndexData*>(dataInOut->get()));
 }
 
 }  // namespace mongo
@@ -32,6 +32,7 @@
 
 
 #include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
+#include "mongo/db/storage/in_memory/in_memory_snapshot_manager.h"
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 #include "mongo/stdx/memory.h"
 #include "mongo/unittest/unittest.h"
@@ -47,10 +48,11 @@ public:
     }
 
     std::unique_ptr<RecoveryUnit> newRecoveryUnit() final {
-        return stdx::make_unique<InMemoryRecoveryUnit>();
+        return stdx::make_unique<InMemoryRecoveryUnit>(&_snapshotManager);
     }
 
 private:
+    InMemorySnapshotManager _snapshotManager;
     std::shared_ptr<void> _data;  // used by InMemoryBtreeImpl
     Ordering _order;
 };
@@ -38,7 +38,7 @@
 namespace mongo {
 
 RecoveryUnit* InMemoryEngine::newRecoveryUnit() {
-    return new InMemoryRecoveryUnit();
+    return new InMemoryRecoveryUnit(&_snapshotManager);
 }
 
 Status InMemoryEngine::createRecordStore(OperationContext* opCtx,
@@ -30,6 +30,7 @@
 
 #pragma once
 
+#include "mongo/db/storage/in_memory/in_memory_snapshot_manager.h"
 #include "mongo/db/storage/kv/kv_engine.h"
 #include "mongo/stdx/mutex.h"
 #include "mongo/util/string_map.h"
@@ -60,8 +61,12 @@ public:
 
     virtual Status dropIdent(OperationContext* opCtx, StringData ident);
 
+    virtual SnapshotManager* getSnapshotManager() const final {
+        return &_snapshotManager;
+    }
+
     virtual bool supportsDocLocking() const {
-        return false;
+        return true;
     }
 
     virtual bool supportsDirectoryPerDB() const {
@@ -95,5 +100,9 @@ private:
 
     mutable stdx::mutex _mutex;
     DataMap _dataMap;  // All actual data is owned in here
+
+    // Transactions are begun and committed through here. Mutable since getSnapshotManager() is
+    // const.
+    mutable InMemorySnapshotManager _snapshotManager;
 };
 }
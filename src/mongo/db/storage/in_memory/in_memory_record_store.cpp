@@ -34,9 +34,12 @@
 #include "mongo/db/storage/in_memory/in_memory_record_store.h"
 
 
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/jsobj.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
+#include "mongo/db/storage/in_memory/in_memory_simulated_latency.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/recovery_unit.h"
 #include "mongo/stdx/memory.h"
@@ -48,203 +51,207 @@ namespace mongo {
 
 using std::shared_ptr;
 
-class InMemoryRecordStore::InsertChange : public RecoveryUnit::Change {
+// Rolls back a version added to a record, and has the versions it hides discarded once nothing
+// reads them.
+class InMemoryRecordStore::VersionChange : public RecoveryUnit::Change {
 public:
-    InsertChange(Data* data, RecordId loc) : _data(data), _loc(loc) {}
-    virtual void commit() {}
-    virtual void rollback() {
-        Records::iterator it = _data->records.find(_loc);
-        if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
-            _data->records.erase(it);
-        }
+    VersionChange(Data* data,
+                  shared_ptr<InMemoryTransaction> writer,
+                  RecordId loc,
+                  int64_t dataSizeChange,
+                  int64_t numRecordsChange,
+                  bool hidesOlderVersion)
+        : _data(data),
+          _writer(std::move(writer)),
+          _loc(loc),
+          _dataSizeChange(dataSizeChange),
+          _numRecordsChange(numRecordsChange),
+          _hidesOlderVersion(hidesOlderVersion) {}
+
+    virtual void commit() {
+        if (!_hidesOlderVersion)
+            return;
+        const uint64_t commitVersion = _writer ? _writer->getCommitVersion() : 0;
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _data->versionsToPrune.emplace_back(commitVersion, _loc);
     }
 
-private:
-    Data* const _data;
-    const RecordId _loc;
-};
-
-// Works for both removes and updates
-class InMemoryRecordStore::RemoveChange : public RecoveryUnit::Change {
-public:
-    RemoveChange(Data* data, RecordId loc, const InMemoryRecord& rec)
-        : _data(data), _loc(loc), _rec(rec) {}
-
-    virtual void commit() {}
     virtual void rollback() {
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
         Records::iterator it = _data->records.find(_loc);
-        if (it != _data->records.end()) {
-            _data->dataSize -= it->second.size;
+        invariant(it != _data->records.end());
+        it->second.pop(_writer.get());
+        if (it->second.empty()) {
+            _data->records.erase(it);
+            _data->recordsEpoch++;
         }
-
-        _data->dataSize += _rec.size;
-        _data->records[_loc] = _rec;
+        _data->dataSize -= _dataSizeChange;
+        _data->numRecords -= _numRecordsChange;
     }
 
 private:
     Data* const _data;
+    const shared_ptr<InMemoryTransaction> _writer;
     const RecordId _loc;
-    const InMemoryRecord _rec;
+    const int64_t _dataSizeChange;
+    const int64_t _numRecordsChange;
+    const bool _hidesOlderVersion;
 };
 
-class InMemoryRecordStore::TruncateChange : public RecoveryUnit::Change {
+// Ends the hiding of a record inserted into a capped collection, or registered for the oplog.
+class InMemoryRecordStore::CappedInsertChange : public RecoveryUnit::Change {
 public:
-    TruncateChange(Data* data) : _data(data), _dataSize(0) {
-        using std::swap;
-        swap(_dataSize, _data->dataSize);
-        swap(_records, _data->records);
+    CappedInsertChange(Data* data, RecordId loc) : _data(data), _loc(loc) {}
+
+    virtual void commit() {
+        dealtWith();
     }
 
-    virtual void commit() {}
     virtual void rollback() {
-        using std::swap;
-        swap(_dataSize, _data->dataSize);
-        swap(_records, _data->records);
+        dealtWith();
     }
 
 private:
+    void dealtWith() {
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        invariant(_data->uncommittedCappedIds.erase(_loc) == 1);
+    }
+
     Data* const _data;
-    int64_t _dataSize;
-    Records _records;
+    const RecordId _loc;
 };
 
 class InMemoryRecordStore::Cursor final : public SeekableRecordCursor {
 public:
-    Cursor(OperationContext* txn, const InMemoryRecordStore& rs)
-        : _records(rs._data->records), _isCapped(rs.isCapped()) {}
+    Cursor(OperationContext* txn, const InMemoryRecordStore& rs, bool forward)
+        : _txn(txn), _rs(rs), _data(*rs._data), _forward(forward) {}
 
     boost::optional<Record> next() final {
-        if (_needFirstSeek) {
-            _needFirstSeek = false;
-            _it = _records.begin();
-        } else if (!_lastMoveWasRestore && _it != _records.end()) {
-            ++_it;
-        }
-        _lastMoveWasRestore = false;
-
-        if (_it == _records.end())
+        if (_eof)
             return {};
-        return {{_it->first, _it->second.toRecordData()}};
+
+        simulateInMemoryLatency(InMemoryLatencyKind::kRead);
+        stdx::lock_guard<stdx::mutex> lk(_data.mutex);
+        const Records& records = _data.records;
+        Records::const_iterator it;
+        if (_lastReturnedId.isNull()) {
+            it = _forward ? records.begin() : records.end();
+        } else if (_itEpoch == _data.recordsEpoch) {
+            // _it is still at _lastReturnedId.
+            it = _it;
+            if (_forward)
+                ++it;
+        } else {
+            it = _forward ? records.upper_bound(_lastReturnedId)
+                          : records.lower_bound(_lastReturnedId);
+        }
+        return _settle_inlock(it);
     }
 
     boost::optional<Record> seekExact(const RecordId& id) final {
-        _lastMoveWasRestore = false;
-        _needFirstSeek = false;
-        _it = _records.find(id);
-        if (_it == _records.end())
+        simulateInMemoryLatency(InMemoryLatencyKind::kRead);
+        stdx::lock_guard<stdx::mutex> lk(_data.mutex);
+        _eof = true;
+
+        Records::const_iterator it = _data.records.find(id);
+        if (it == _data.records.end())
             return {};
-        return {{_it->first, _it->second.toRecordData()}};
-    }
 
-    void save() final {
-        if (!_needFirstSeek && !_lastMoveWasRestore)
-            _savedId = _it == _records.end() ? RecordId() : _it->first;
+        const InMemoryRecord* rec = it->second.find(_transaction());
+        if (!rec)
+            return {};
+
+        _eof = false;
+        _positionAt_inlock(it);
+        return {{id, rec->toRecordData()}};
     }
 
+    void save() final {}
+
     void saveUnpositioned() final {
-        _savedId = RecordId();
+        _eof = true;
     }
 
     bool restore() final {
-        if (_savedId.isNull()) {
-            _it = _records.end();
+        if (!_rs.isCapped() || _eof || _lastReturnedId.isNull())
             return true;
-        }
-
-        _it = _records.lower_bound(_savedId);
-        _lastMoveWasRestore = _it == _records.end() || _it->first != _savedId;
 
         // Capped iterators die on invalidation rather than advancing.
-        return !(_isCapped && _lastMoveWasRestore);
+        stdx::lock_guard<stdx::mutex> lk(_data.mutex);
+        return _rs._findRecord_inlock(_txn, _lastReturnedId);
     }
 
-    void detachFromOperationContext() final {}
-    void reattachToOperationContext(OperationContext* txn) final {}
-
-private:
-    Records::const_iterator _it;
-    bool _needFirstSeek = true;
-    bool _lastMoveWasRestore = false;
-    RecordId _savedId;  // Location to restore() to. Null means EOF.
-
-    const InMemoryRecordStore::Records& _records;
-    const bool _isCapped;
-};
-
-class InMemoryRecordStore::ReverseCursor final : public SeekableRecordCursor {
-public:
-    ReverseCursor(OperationContext* txn, const InMemoryRecordStore& rs)
-        : _records(rs._data->records), _isCapped(rs.isCapped()) {}
+    void detachFromOperationContext() final {
+        _txn = nullptr;
+    }
 
-    boost::optional<Record> next() final {
-        if (_needFirstSeek) {
-            _needFirstSeek = false;
-            _it = _records.rbegin();
-        } else if (!_lastMoveWasRestore && _it != _records.rend()) {
-            ++_it;
-        }
-        _lastMoveWasRestore = false;
+    void reattachToOperationContext(OperationContext* txn) final {
+        _txn = txn;
+    }
 
-        if (_it == _records.rend())
-            return {};
-        return {{_it->first, _it->second.toRecordData()}};
+private:
+    const InMemoryTransaction* _transaction() {
+        _transactionHolder = InMemoryRecoveryUnit::getTransaction(_txn);
+        return _transactionHolder.get();
     }
 
-    boost::optional<Record> seekExact(const RecordId& id) final {
-        _lastMoveWasRestore = false;
-        _needFirstSeek = false;
+    void _positionAt_inlock(Records::const_iterator it) {
+        _it = it;
+        _itEpoch = _data.recordsEpoch;
+        _lastReturnedId = it->first;
+    }
 
-        auto forwardIt = _records.find(id);
-        if (forwardIt == _records.end()) {
-            _it = _records.rend();
-            return {};
-        }
+    // Returns the first record at or after 'it' in the direction of the scan that this
+    // transaction sees. For reverse cursors, 'it' is one past the first candidate.
+    boost::optional<Record> _settle_inlock(Records::const_iterator it) {
+        const InMemoryTransaction* reader = _transaction();
+        const Records& records = _data.records;
+        while (true) {
+            if (_forward) {
+                if (it == records.end())
+                    break;
+            } else {
+                if (it == records.begin())
+                    break;
+                --it;
+            }
 
-        // The reverse_iterator will point to the preceding element, so increment the base
-        // iterator to make it point past the found element.
-        ++forwardIt;
-        _it = Records::const_reverse_iterator(forwardIt);
-        dassert(_it != _records.rend());
-        dassert(_it->first == id);
-        return {{_it->first, _it->second.toRecordData()}};
-    }
+            if (_rs._isCappedHidden_inlock(it->first)) {
+                if (_forward)
+                    break;
+                continue;
+            }
 
-    void save() final {
-        if (!_needFirstSeek && !_lastMoveWasRestore)
-            _savedId = _it == _records.rend() ? RecordId() : _it->first;
-    }
+            if (const InMemoryRecord* rec = it->second.find(reader)) {
+                _positionAt_inlock(it);
+                return {{it->first, rec->toRecordData()}};
+            }
 
-    void saveUnpositioned() final {
-        _savedId = RecordId();
-    }
+            // A capped collection is read in insertion order without holes, so a forward scan
+            // stops at a record inserted after its snapshot.
+            if (_forward && _rs.isCapped() && !it->second.seesAnyVersion(reader))
+                break;
 
-    bool restore() final {
-        if (_savedId.isNull()) {
-            _it = _records.rend();
-            return true;
+            if (_forward)
+                ++it;
         }
 
-        // Note: upper_bound returns the first entry > _savedId and reverse_iterators
-        // dereference to the element before their base iterator. This combine to make this
-        // dereference to the first element <= _savedId which is what we want here.
-        _it = Records::const_reverse_iterator(_records.upper_bound(_savedId));
-        _lastMoveWasRestore = _it == _records.rend() || _it->first != _savedId;
-
-        // Capped iterators die on invalidation rather than advancing.
-        return !(_isCapped && _lastMoveWasRestore);
+        _eof = true;
+        return {};
     }
 
-    void detachFromOperationContext() final {}
-    void reattachToOperationContext(OperationContext* txn) final {}
+    OperationContext* _txn;
+    const InMemoryRecordStore& _rs;
+    const Data& _data;
+    const bool _forward;
+    shared_ptr<InMemoryTransaction> _transactionHolder;
 
-private:
-    Records::const_reverse_iterator _it;
-    bool _needFirstSeek = true;
-    bool _lastMoveWasRestore = false;
-    RecordId _savedId;  // Location to restore() to. Null means EOF.
-    const InMemoryRecordStore::Records& _records;
-    const bool _isCapped;
+    bool _eof = false;
+    RecordId _lastReturnedId;  // If null, need to seek to first/last record.
+
+    // Positioned at _lastReturnedId while _itEpoch is the records' epoch.
+    Records::const_iterator _it;
+    uint64_t _itEpoch = 0;
 };
 
 
@@ -283,51 +290,92 @@ const char* InMemoryRecordStore::name() const {
 }
 
 RecordData InMemoryRecordStore::dataFor(OperationContext* txn, const RecordId& loc) const {
-    return recordFor(loc)->toRecordData();
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    return _recordFor_inlock(txn, loc).toRecordData();
 }
 
-const InMemoryRecordStore::InMemoryRecord* InMemoryRecordStore::recordFor(
-    const RecordId& loc) const {
+const InMemoryRecordStore::InMemoryRecord* InMemoryRecordStore::_findRecord_inlock(
+    OperationContext* txn, const RecordId& loc) const {
     Records::const_iterator it = _data->records.find(loc);
-    if (it == _data->records.end()) {
-        error() << "InMemoryRecordStore::recordFor cannot find record for " << ns() << ":" << loc;
-    }
-    invariant(it != _data->records.end());
-    return &it->second;
+    if (it == _data->records.end())
+        return nullptr;
+    return it->second.find(InMemoryRecoveryUnit::getTransaction(txn).get());
 }
 
-InMemoryRecordStore::InMemoryRecord* InMemoryRecordStore::recordFor(const RecordId& loc) {
-    Records::iterator it = _data->records.find(loc);
-    if (it == _data->records.end()) {
+const InMemoryRecordStore::InMemoryRecord& InMemoryRecordStore::_recordFor_inlock(
+    OperationContext* txn, const RecordId& loc) const {
+    const InMemoryRecord* rec = _findRecord_inlock(txn, loc);
+    if (!rec) {
         error() << "InMemoryRecordStore::recordFor cannot find record for " << ns() << ":" << loc;
     }
-    invariant(it != _data->records.end());
-    return &it->second;
+    invariant(rec);
+    return *rec;
 }
 
 bool InMemoryRecordStore::findRecord(OperationContext* txn,
                                      const RecordId& loc,
                                      RecordData* rd) const {
-    Records::const_iterator it = _data->records.find(loc);
-    if (it == _data->records.end()) {
+    simulateInMemoryLatency(InMemoryLatencyKind::kRead);
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    const InMemoryRecord* rec = _findRecord_inlock(txn, loc);
+    if (!rec) {
         return false;
     }
-    *rd = it->second.toRecordData();
+    *rd = rec->toRecordData();
     return true;
 }
 
+void InMemoryRecordStore::_pushVersion_inlock(OperationContext* txn,
+                                              Records::iterator it,
+                                              boost::optional<InMemoryRecord> rec) {
+    shared_ptr<InMemoryTransaction> writer = InMemoryRecoveryUnit::getTransaction(txn);
+    if (it->second.conflictsWith(writer.get()))
+        throw WriteConflictException();
+
+    const bool isInsert = it->second.empty();
+    const InMemoryRecord* oldRec = isInsert ? nullptr : it->second.find(writer.get());
+    invariant(isInsert || oldRec);
+
+    const int64_t dataSizeChange = (rec ? rec->size : 0) - (oldRec ? oldRec->size : 0);
+    const int64_t numRecordsChange = isInsert ? 1 : (rec ? 0 : -1);
+    txn->recoveryUnit()->registerChange(new VersionChange(
+        _data, writer, it->first, dataSizeChange, numRecordsChange, !isInsert));
+    it->second.push(std::move(writer), std::move(rec));
+    _data->dataSize += dataSizeChange;
+    _data->numRecords += numRecordsChange;
+}
+
+void InMemoryRecordStore::_pruneVersions_inlock(OperationContext* txn) {
+    if (_data->versionsToPrune.empty())
+        return;
+
+    const uint64_t oldestReadVersion = InMemoryRecoveryUnit::getOldestReadVersion(txn);
+    while (!_data->versionsToPrune.empty() &&
+           _data->versionsToPrune.front().first <= oldestReadVersion) {
+        Records::iterator it = _data->records.find(_data->versionsToPrune.front().second);
+        _data->versionsToPrune.pop_front();
+        if (it != _data->records.end() && it->second.prune(oldestReadVersion)) {
+            _data->records.erase(it);
+            _data->recordsEpoch++;
+        }
+    }
+}
+
 void InMemoryRecordStore::deleteRecord(OperationContext* txn, const RecordId& loc) {
-    InMemoryRecord* rec = recordFor(loc);
-    txn->recoveryUnit()->registerChange(new RemoveChange(_data, loc, *rec));
-    _data->dataSize -= rec->size;
-    invariant(_data->records.erase(loc) == 1);
+    simulateInMemoryLatency(InMemoryLatencyKind::kWrite);
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    _pruneVersions_inlock(txn);
+
+    Records::iterator it = _data->records.find(loc);
+    invariant(it != _data->records.end());
+    _pushVersion_inlock(txn, it, boost::none);
 }
 
 bool InMemoryRecordStore::cappedAndNeedDelete(OperationContext* txn) const {
     if (!_isCapped)
         return false;
 
-    if (_data->dataSize > _cappedMaxSize)
+    if (dataSize(txn) > _cappedMaxSize)
         return true;
 
     if ((_cappedMaxDocs != -1) && (numRecords(txn) > _cappedMaxDocs))
@@ -337,32 +385,72 @@ bool InMemoryRecordStore::cappedAndNeedDelete(OperationContext* txn) const {
 }
 
 void InMemoryRecordStore::cappedDeleteAsNeeded(OperationContext* txn) {
-    while (cappedAndNeedDelete(txn)) {
-        invariant(!_data->records.empty());
+    if (!cappedAndNeedDelete(txn))
+        return;
+
+    // Only one writer deletes at a time. The others let the collection grow a little over its
+    // limits rather than conflict deleting the same records.
+    stdx::unique_lock<stdx::mutex> deleterLock(_data->cappedDeleterMutex, stdx::try_to_lock);
+    if (!deleterLock.owns_lock())
+        return;
 
-        Records::iterator oldest = _data->records.begin();
-        RecordId id = oldest->first;
-        RecordData data = oldest->second.toRecordData();
+    auto cursor = getCursor(txn, true);
+    while (cappedAndNeedDelete(txn)) {
+        auto record = cursor->next();
+        if (!record)
+            break;
 
         if (_cappedDeleteCallback)
-            uassertStatusOK(_cappedDeleteCallback->aboutToDeleteCapped(txn, id, data));
+            uassertStatusOK(
+                _cappedDeleteCallback->aboutToDeleteCapped(txn, record->id, record->data));
 
-        deleteRecord(txn, id);
+        deleteRecord(txn, record->id);
     }
 }
 
-StatusWith<RecordId> InMemoryRecordStore::extractAndCheckLocForOplog(const char* data,
-                                                                     int len) const {
+StatusWith<RecordId> InMemoryRecordStore::extractAndCheckLocForOplog_inlock(const char* data,
+                                                                            int len) const {
     StatusWith<RecordId> status = oploghack::extractKey(data, len);
     if (!status.isOK())
         return status;
 
-    if (!_data->records.empty() && status.getValue() <= _data->records.rbegin()->first)
+    // Entries registered with oplogDiskLocRegister() may be inserted out of order.
+    if (!_data->records.empty() && status.getValue() <= _data->records.rbegin()->first &&
+        !_data->uncommittedCappedIds.count(status.getValue()))
         return StatusWith<RecordId>(ErrorCodes::BadValue, "ts not higher than highest");
 
     return status;
 }
 
+StatusWith<RecordId> InMemoryRecordStore::_insertRecord(OperationContext* txn,
+                                                        InMemoryRecord rec) {
+    simulateInMemoryLatency(InMemoryLatencyKind::kWrite);
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    _pruneVersions_inlock(txn);
+
+    RecordId loc;
+    if (_data->isOplog) {
+        StatusWith<RecordId> status = extractAndCheckLocForOplog_inlock(rec.data.get(), rec.size);
+        if (!status.isOK())
+            return status;
+        loc = status.getValue();
+    } else {
+        loc = allocateLoc();
+        if (_isCapped) {
+            _data->uncommittedCappedIds.insert(loc);
+            txn->recoveryUnit()->registerChange(new CappedInsertChange(_data, loc));
+        }
+    }
+
+    auto inserted = _data->records.insert(Records::value_type(loc, Records::mapped_type()));
+    if (!inserted.second)
+        return StatusWith<RecordId>(ErrorCodes::BadValue, "ts not higher than highest");
+    _data->recordsEpoch++;
+
+    _pushVersion_inlock(txn, inserted.first, std::move(rec));
+    return StatusWith<RecordId>(loc);
+}
+
 StatusWith<RecordId> InMemoryRecordStore::insertRecord(OperationContext* txn,
                                                        const char* data,
                                                        int len,
@@ -376,23 +464,10 @@ StatusWith<RecordId> InMemoryRecordStore::insertRecord(OperationContext* txn,
     InMemoryRecord rec(len);
     memcpy(rec.data.get(), data, len);
 
-    RecordId loc;
-    if (_data->isOplog) {
-        StatusWith<RecordId> status = extractAndCheckLocForOplog(data, len);
-        if (!status.isOK())
-            return status;
-        loc = status.getValue();
-    } else {
-        loc = allocateLoc();
-    }
-
-    txn->recoveryUnit()->registerChange(new InsertChange(_data, loc));
-    _data->dataSize += len;
-    _data->records[loc] = rec;
-
-    cappedDeleteAsNeeded(txn);
-
-    return StatusWith<RecordId>(loc);
+    StatusWith<RecordId> loc = _insertRecord(txn, std::move(rec));
+    if (loc.isOK())
+        cappedDeleteAsNeeded(txn);
+    return loc;
 }
 
 StatusWith<RecordId> InMemoryRecordStore::insertRecord(OperationContext* txn,
@@ -408,23 +483,10 @@ StatusWith<RecordId> InMemoryRecordStore::insertRecord(OperationContext* txn,
     InMemoryRecord rec(len);
     doc->writeDocument(rec.data.get());
 
-    RecordId loc;
-    if (_data->isOplog) {
-        StatusWith<RecordId> status = extractAndCheckLocForOplog(rec.data.get(), len);
-        if (!status.isOK())
-            return status;
-        loc = status.getValue();
-    } else {
-        loc = allocateLoc();
-    }
-
-    txn->recoveryUnit()->registerChange(new InsertChange(_data, loc));
-    _data->dataSize += len;
-    _data->records[loc] = rec;
-
-    cappedDeleteAsNeeded(txn);
-
-    return StatusWith<RecordId>(loc);
+    StatusWith<RecordId> loc = _insertRecord(txn, std::move(rec));
+    if (loc.isOK())
+        cappedDeleteAsNeeded(txn);
+    return loc;
 }
 
 StatusWith<RecordId> InMemoryRecordStore::updateRecord(OperationContext* txn,
@@ -433,29 +495,24 @@ StatusWith<RecordId> InMemoryRecordStore::updateRecord(OperationContext* txn,
                                                        int len,
                                                        bool enforceQuota,
                                                        UpdateNotifier* notifier) {
-    InMemoryRecord* oldRecord = recordFor(loc);
-    int oldLen = oldRecord->size;
-
-    if (_isCapped && len > oldLen) {
-        return StatusWith<RecordId>(
-            ErrorCodes::InternalError, "failing update: objects in a capped ns cannot grow", 10003);
-    }
-
-    if (notifier) {
-        // The in-memory KV engine uses the invalidation framework (does not support
-        // doc-locking), and therefore must notify that it is updating a document.
-        Status callbackStatus = notifier->recordStoreGoingToUpdateInPlace(txn, loc);
-        if (!callbackStatus.isOK()) {
-            return StatusWith<RecordId>(callbackStatus);
+    simulateInMemoryLatency(InMemoryLatencyKind::kWrite);
+    {
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _pruneVersions_inlock(txn);
+
+        const int oldLen = _recordFor_inlock(txn, loc).size;
+        if (_isCapped && len > oldLen) {
+            return StatusWith<RecordId>(ErrorCodes::InternalError,
+                                        "failing update: objects in a capped ns cannot grow",
+                                        10003);
         }
-    }
 
-    InMemoryRecord newRecord(len);
-    memcpy(newRecord.data.get(), data, len);
+        InMemoryRecord newRecord(len);
+        memcpy(newRecord.data.get(), data, len);
 
-    txn->recoveryUnit()->registerChange(new RemoveChange(_data, loc, *oldRecord));
-    _data->dataSize += len - oldLen;
-    *oldRecord = newRecord;
+        // Readers see the old version until this commits, so there is nothing to invalidate.
+        _pushVersion_inlock(txn, _data->records.find(loc), std::move(newRecord));
+    }
 
     cappedDeleteAsNeeded(txn);
 
@@ -472,54 +529,66 @@ StatusWith<RecordData> InMemoryRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
-    InMemoryRecord* oldRecord = recordFor(loc);
-    const int len = oldRecord->size;
-
-    InMemoryRecord newRecord(len);
-    memcpy(newRecord.data.get(), oldRecord->data.get(), len);
-
-    txn->recoveryUnit()->registerChange(new RemoveChange(_data, loc, *oldRecord));
-    *oldRecord = newRecord;
-
-    cappedDeleteAsNeeded(txn);
+    simulateInMemoryLatency(InMemoryLatencyKind::kWrite);
+    RecordData newData;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _pruneVersions_inlock(txn);
+
+        const InMemoryRecord& oldRecord = _recordFor_inlock(txn, loc);
+        const int len = oldRecord.size;
+
+        InMemoryRecord newRecord(len);
+        memcpy(newRecord.data.get(), oldRecord.data.get(), len);
+
+        char* root = newRecord.data.get();
+        mutablebson::DamageVector::const_iterator where = damages.begin();
+        const mutablebson::DamageVector::const_iterator end = damages.end();
+        for (; where != end; ++where) {
+            const char* sourcePtr = damageSource + where->sourceOffset;
+            char* targetPtr = root + where->targetOffset;
+            std::memcpy(targetPtr, sourcePtr, where->size);
+        }
 
-    char* root = newRecord.data.get();
-    mutablebson::DamageVector::const_iterator where = damages.begin();
-    const mutablebson::DamageVector::const_iterator end = damages.end();
-    for (; where != end; ++where) {
-        const char* sourcePtr = damageSource + where->sourceOffset;
-        char* targetPtr = root + where->targetOffset;
-        std::memcpy(targetPtr, sourcePtr, where->size);
+        newData = newRecord.toRecordData();
+        _pushVersion_inlock(txn, _data->records.find(loc), std::move(newRecord));
     }
 
-    *oldRecord = newRecord;
+    cappedDeleteAsNeeded(txn);
 
-    return newRecord.toRecordData();
+    return newData;
 }
 
 std::unique_ptr<SeekableRecordCursor> InMemoryRecordStore::getCursor(OperationContext* txn,
                                                                      bool forward) const {
-    if (forward)
-        return stdx::make_unique<Cursor>(txn, *this);
-    return stdx::make_unique<ReverseCursor>(txn, *this);
+    return stdx::make_unique<Cursor>(txn, *this, forward);
 }
 
 Status InMemoryRecordStore::truncate(OperationContext* txn) {
-    // Unlike other changes, TruncateChange mutates _data on construction to perform the
-    // truncate
-    txn->recoveryUnit()->registerChange(new TruncateChange(_data));
+    // Deletes every record this transaction sees, so that older snapshots still see them.
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    _pruneVersions_inlock(txn);
+
+    const InMemoryTransaction* reader = InMemoryRecoveryUnit::getTransaction(txn).get();
+    for (Records::iterator it = _data->records.begin(); it != _data->records.end(); ++it) {
+        if (it->second.find(reader))
+            _pushVersion_inlock(txn, it, boost::none);
+    }
     return Status::OK();
 }
 
 void InMemoryRecordStore::temp_cappedTruncateAfter(OperationContext* txn,
                                                    RecordId end,
                                                    bool inclusive) {
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    _pruneVersions_inlock(txn);
+
+    const InMemoryTransaction* reader = InMemoryRecoveryUnit::getTransaction(txn).get();
     Records::iterator it =
         inclusive ? _data->records.lower_bound(end) : _data->records.upper_bound(end);
-    while (it != _data->records.end()) {
-        txn->recoveryUnit()->registerChange(new RemoveChange(_data, it->first, it->second));
-        _data->dataSize -= it->second.size;
-        _data->records.erase(it++);
+    for (; it != _data->records.end(); ++it) {
+        if (it->second.find(reader))
+            _pushVersion_inlock(txn, it, boost::none);
     }
 }
 
@@ -530,12 +599,13 @@ Status InMemoryRecordStore::validate(OperationContext* txn,
                                      ValidateResults* results,
                                      BSONObjBuilder* output) {
     results->valid = true;
-    if (scanData && full) {
-        for (Records::const_iterator it = _data->records.begin(); it != _data->records.end();
-             ++it) {
-            const InMemoryRecord& rec = it->second;
+    long long nrecords = 0;
+    auto cursor = getCursor(txn, true);
+    while (auto record = cursor->next()) {
+        nrecords++;
+        if (scanData && full) {
             size_t dataSize;
-            const Status status = adaptor->validate(rec.toRecordData(), &dataSize);
+            const Status status = adaptor->validate(record->data, &dataSize);
             if (!status.isOK()) {
                 results->valid = false;
                 results->errors.push_back("invalid object detected (see logs)");
@@ -544,7 +614,7 @@ Status InMemoryRecordStore::validate(OperationContext* txn,
         }
     }
 
-    output->appendNumber("nrecords", _data->records.size());
+    output->appendNumber("nrecords", nrecords);
 
     return Status::OK();
 }
@@ -577,7 +647,7 @@ int64_t InMemoryRecordStore::storageSize(OperationContext* txn,
                                          int infoLevel) const {
     // Note: not making use of extraInfo or infoLevel since we don't have extents
     const int64_t recordOverhead = numRecords(txn) * sizeof(InMemoryRecord);
-    return _data->dataSize + recordOverhead;
+    return dataSize(txn) + recordOverhead;
 }
 
 RecordId InMemoryRecordStore::allocateLoc() {
@@ -586,21 +656,38 @@ RecordId InMemoryRecordStore::allocateLoc() {
     return out;
 }
 
+bool InMemoryRecordStore::_isCappedHidden_inlock(const RecordId& loc) const {
+    return !_data->uncommittedCappedIds.empty() && *_data->uncommittedCappedIds.begin() <= loc;
+}
+
 boost::optional<RecordId> InMemoryRecordStore::oplogStartHack(
     OperationContext* txn, const RecordId& startingPosition) const {
     if (!_data->isOplog)
         return boost::none;
 
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    const InMemoryTransaction* reader = InMemoryRecoveryUnit::getTransaction(txn).get();
     const Records& records = _data->records;
 
-    if (records.empty())
-        return RecordId();
-
-    Records::const_iterator it = records.lower_bound(startingPosition);
-    if (it == records.end() || it->first > startingPosition)
+    // Returns the last visible record at or before startingPosition.
+    Records::const_iterator it = records.upper_bound(startingPosition);
+    while (it != records.begin()) {
         --it;
+        if (!_isCappedHidden_inlock(it->first) && it->second.find(reader))
+            return it->first;
+    }
+    return RecordId();
+}
 
-    return it->first;
+Status InMemoryRecordStore::oplogDiskLocRegister(OperationContext* txn, const Timestamp& opTime) {
+    StatusWith<RecordId> loc = oploghack::keyForOptime(opTime);
+    if (!loc.isOK())
+        return loc.getStatus();
+
+    stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+    _data->uncommittedCappedIds.insert(loc.getValue());
+    txn->recoveryUnit()->registerChange(new CappedInsertChange(_data, loc.getValue()));
+    return Status::OK();
 }
 
 }  // namespace mongo
@@ -30,17 +30,25 @@
 
 #pragma once
 
-#include <boost/shared_array.hpp>
-#include <map>
+#include <deque>
+#include <set>
 
 #include "mongo/db/storage/capped_callback.h"
+#include "mongo/db/storage/in_memory/in_memory_bplus_tree.h"
+#include "mongo/db/storage/in_memory/in_memory_version_chain.h"
 #include "mongo/db/storage/record_store.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/shared_buffer.h"
 
 namespace mongo {
 
 /**
  * A RecordStore that stores all data in-memory.
  *
+ * Each record is a chain of versions, so that transactions read the snapshot they began with
+ * while others write. Writing a record that a concurrent transaction has written throws a
+ * WriteConflictException.
+ *
  * @param cappedMaxSize - required if isCapped. limit uses dataSize() in this impl.
  */
 class InMemoryRecordStore : public RecordStore {
@@ -111,45 +119,51 @@ public:
                                 int infoLevel = 0) const;
 
     virtual long long dataSize(OperationContext* txn) const {
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
         return _data->dataSize;
     }
 
     virtual long long numRecords(OperationContext* txn) const {
-        return _data->records.size();
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        return _data->numRecords;
     }
 
     virtual boost::optional<RecordId> oplogStartHack(OperationContext* txn,
                                                      const RecordId& startingPosition) const;
 
+    virtual Status oplogDiskLocRegister(OperationContext* txn, const Timestamp& opTime);
+
     virtual void updateStatsAfterRepair(OperationContext* txn,
                                         long long numRecords,
                                         long long dataSize) {
-        invariant(_data->records.size() == size_t(numRecords));
+        stdx::lock_guard<stdx::mutex> lk(_data->mutex);
+        _data->numRecords = numRecords;
         _data->dataSize = dataSize;
     }
 
 protected:
     struct InMemoryRecord {
         InMemoryRecord() : size(0) {}
-        InMemoryRecord(int size) : size(size), data(new char[size]) {}
+        InMemoryRecord(int size) : size(size), data(SharedBuffer::allocate(size)) {}
 
+        /**
+         * The returned RecordData shares the buffer, so it stays valid once the version is
+         * discarded.
+         */
         RecordData toRecordData() const {
-            return RecordData(data.get(), size);
+            return RecordData(data, size);
         }
 
         int size;
-        boost::shared_array<char> data;
+        SharedBuffer data;
     };
 
-    virtual const InMemoryRecord* recordFor(const RecordId& loc) const;
-    virtual InMemoryRecord* recordFor(const RecordId& loc);
-
 public:
     //
     // Not in RecordStore interface
     //
 
-    typedef std::map<RecordId, InMemoryRecord> Records;
+    typedef InMemoryBPlusTree<RecordId, InMemoryVersionChain<InMemoryRecord>> Records;
 
     bool isCapped() const {
         return _isCapped;
@@ -167,14 +181,31 @@ public:
     }
 
 private:
-    class InsertChange;
-    class RemoveChange;
-    class TruncateChange;
+    class VersionChange;
+    class CappedInsertChange;
 
     class Cursor;
-    class ReverseCursor;
 
-    StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len) const;
+    StatusWith<RecordId> extractAndCheckLocForOplog_inlock(const char* data, int len) const;
+    StatusWith<RecordId> _insertRecord(OperationContext* txn, InMemoryRecord rec);
+
+    /**
+     * Adds a version of the record at 'loc', written by the transaction of 'txn'. Throws a
+     * WriteConflictException if a concurrent transaction has written the record.
+     */
+    void _pushVersion_inlock(OperationContext* txn,
+                             Records::iterator it,
+                             boost::optional<InMemoryRecord> rec);
+
+    /**
+     * Discards the versions that committed transactions have hidden from every reader.
+     */
+    void _pruneVersions_inlock(OperationContext* txn);
+
+    const InMemoryRecord* _findRecord_inlock(OperationContext* txn, const RecordId& loc) const;
+    const InMemoryRecord& _recordFor_inlock(OperationContext* txn, const RecordId& loc) const;
+
+    bool _isCappedHidden_inlock(const RecordId& loc) const;
 
     RecordId allocateLoc();
     bool cappedAndNeedDelete(OperationContext* txn) const;
@@ -188,12 +219,30 @@ private:
 
     // This is the "persistent" data.
     struct Data {
-        Data(bool isOplog) : dataSize(0), nextId(1), isOplog(isOplog) {}
+        Data(bool isOplog) : isOplog(isOplog) {}
+
+        mutable stdx::mutex mutex;  // Guards all members but cappedDeleterMutex.
+
+        // Count uncommitted writes, like the other engines do.
+        int64_t dataSize = 0;
+        int64_t numRecords = 0;
 
-        int64_t dataSize;
         Records records;
-        int64_t nextId;
+
+        // Bumped whenever 'records' gains or loses an entry, which invalidates its iterators.
+        uint64_t recordsEpoch = 0;
+
+        int64_t nextId = 1;
         const bool isOplog;
+
+        // The records that committed transactions have written over, with the commit version.
+        std::deque<std::pair<uint64_t, RecordId>> versionsToPrune;
+
+        // Records of a capped collection that are being inserted. Cursors don't return them, or
+        // anything after them, until they commit.
+        std::set<RecordId> uncommittedCappedIds;
+
+        stdx::mutex cappedDeleterMutex;
     };
 
     Data* const _data;
@@ -31,7 +31,9 @@
 #include "mongo/db/storage/in_memory/in_memory_record_store.h"
 
 
+#include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
+#include "mongo/db/storage/in_memory/in_memory_snapshot_manager.h"
 #include "mongo/db/storage/record_store_test_harness.h"
 #include "mongo/unittest/unittest.h"
 
@@ -51,17 +53,80 @@ public:
     }
 
     RecoveryUnit* newRecoveryUnit() final {
-        return new InMemoryRecoveryUnit();
+        return new InMemoryRecoveryUnit(&_snapshotManager);
     }
 
     bool supportsDocLocking() final {
-        return false;
+        return true;
     }
 
     std::shared_ptr<void> data;
+
+private:
+    InMemorySnapshotManager _snapshotManager;
 };
 
 std::unique_ptr<HarnessHelper> newHarnessHelper() {
     return stdx::make_unique<InMemoryHarnessHelper>();
 }
+
+TEST(InMemoryRecordStoreTest, ReadersSeeTheirSnapshot) {
+    InMemoryHarnessHelper harness;
+    std::unique_ptr<RecordStore> rs(harness.newNonCappedRecordStore());
+
+    RecordId loc;
+    {
+        auto txn = harness.newOperationContext();
+        WriteUnitOfWork wuow(txn.get());
+        loc = uassertStatusOK(rs->insertRecord(txn.get(), "a", 2, false));
+        wuow.commit();
+    }
+
+    auto readerClient = harness.serviceContext()->makeClient("reader");
+    auto reader = harness.newOperationContext(readerClient.get());
+    ASSERT_EQUALS(std::string("a"), rs->dataFor(reader.get(), loc).data());
+
+    {
+        auto txn = harness.newOperationContext();
+        WriteUnitOfWork wuow(txn.get());
+        ASSERT_OK(rs->updateRecord(txn.get(), loc, "bb", 3, false, NULL).getStatus());
+        ASSERT_EQUALS(std::string("bb"), rs->dataFor(txn.get(), loc).data());
+        wuow.commit();
+    }
+
+    // The reader keeps its snapshot until it is abandoned.
+    ASSERT_EQUALS(std::string("a"), rs->dataFor(reader.get(), loc).data());
+    reader->recoveryUnit()->abandonSnapshot();
+    ASSERT_EQUALS(std::string("bb"), rs->dataFor(reader.get(), loc).data());
+}
+
+TEST(InMemoryRecordStoreTest, ConcurrentUpdatesConflict) {
+    InMemoryHarnessHelper harness;
+    std::unique_ptr<RecordStore> rs(harness.newNonCappedRecordStore());
+
+    RecordId loc;
+    {
+        auto txn = harness.newOperationContext();
+        WriteUnitOfWork wuow(txn.get());
+        loc = uassertStatusOK(rs->insertRecord(txn.get(), "a", 2, false));
+        wuow.commit();
+    }
+
+    auto client1 = harness.serviceContext()->makeClient("c1");
+    auto txn1 = harness.newOperationContext(client1.get());
+    auto client2 = harness.serviceContext()->makeClient("c2");
+    auto txn2 = harness.newOperationContext(client2.get());
+
+    WriteUnitOfWork wuow1(txn1.get());
+    WriteUnitOfWork wuow2(txn2.get());
+    ASSERT_EQUALS(std::string("a"), rs->dataFor(txn2.get(), loc).data());
+
+    ASSERT_OK(rs->updateRecord(txn1.get(), loc, "b", 2, false, NULL).getStatus());
+    ASSERT_THROWS(rs->updateRecord(txn2.get(), loc, "c", 2, false, NULL),
+                  WriteConflictException);
+    wuow1.commit();
+
+    // txn2's snapshot predates txn1's commit, so it still conflicts.
+    ASSERT_THROWS(rs->deleteRecord(txn2.get(), loc), WriteConflictException);
+}
 }
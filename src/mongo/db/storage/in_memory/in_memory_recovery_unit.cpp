@@ -32,23 +32,52 @@
 
 #include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
 
+#include "mongo/base/checked_cast.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/storage/in_memory/in_memory_simulated_latency.h"
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/util/log.h"
 
 namespace mongo {
 
+InMemoryRecoveryUnit::InMemoryRecoveryUnit(InMemorySnapshotManager* snapshotManager)
+    : _snapshotManager(snapshotManager) {}
+
+InMemoryRecoveryUnit::~InMemoryRecoveryUnit() {
+    invariant(!_inUnitOfWork);
+    _endTransaction();
+}
+
+void InMemoryRecoveryUnit::beginUnitOfWork(OperationContext* opCtx) {
+    invariant(!_areWriteUnitOfWorksBanned);
+    invariant(!_inUnitOfWork);
+    _inUnitOfWork = true;
+}
+
 void InMemoryRecoveryUnit::commitUnitOfWork() {
+    invariant(_inUnitOfWork);
+    _inUnitOfWork = false;
+    if (!_changes.empty())
+        simulateInMemoryLatency(InMemoryLatencyKind::kCommit);
     try {
+        // Writes become visible to other transactions before the changes commit, so that
+        // commit() can find the version they were given.
+        if (_transaction && !_changes.empty())
+            _snapshotManager->commitTransaction(_transaction.get());
+
         for (Changes::iterator it = _changes.begin(), end = _changes.end(); it != end; ++it) {
             (*it)->commit();
         }
         _changes.clear();
+        _endTransaction();
     } catch (...) {
         std::terminate();
     }
 }
 
 void InMemoryRecoveryUnit::abortUnitOfWork() {
+    invariant(_inUnitOfWork);
+    _inUnitOfWork = false;
     try {
         for (Changes::reverse_iterator it = _changes.rbegin(), end = _changes.rend(); it != end;
              ++it) {
@@ -57,8 +86,87 @@ void InMemoryRecoveryUnit::abortUnitOfWork() {
             change->rollback();
         }
         _changes.clear();
+        _endTransaction();
     } catch (...) {
         std::terminate();
     }
 }
+
+void InMemoryRecoveryUnit::abandonSnapshot() {
+    invariant(!_inUnitOfWork);
+    _endTransaction();
+    _areWriteUnitOfWorksBanned = false;
+}
+
+Status InMemoryRecoveryUnit::setReadFromMajorityCommittedSnapshot() {
+    auto snapshotName = _snapshotManager->getMinSnapshotForNextCommittedRead();
+    if (!snapshotName) {
+        return {ErrorCodes::ReadConcernMajorityNotAvailableYet,
+                "Read concern majority reads are currently not possible."};
+    }
+
+    _majorityCommittedSnapshot = *snapshotName;
+    _readFromMajorityCommittedSnapshot = true;
+    return Status::OK();
+}
+
+boost::optional<SnapshotName> InMemoryRecoveryUnit::getMajorityCommittedSnapshot() const {
+    if (!_readFromMajorityCommittedSnapshot)
+        return {};
+    return _majorityCommittedSnapshot;
+}
+
+void InMemoryRecoveryUnit::registerChange(Change* change) {
+    _changes.push_back(ChangePtr(change));
 }
+
+InMemoryRecoveryUnit* InMemoryRecoveryUnit::get(OperationContext* txn) {
+    invariant(txn);
+    return checked_cast<InMemoryRecoveryUnit*>(txn->recoveryUnit());
+}
+
+const std::shared_ptr<InMemoryTransaction>& InMemoryRecoveryUnit::getTransaction() {
+    if (!_transaction) {
+        if (_readFromMajorityCommittedSnapshot) {
+            _transaction =
+                _snapshotManager->beginTransactionOnCommittedSnapshot(&_majorityCommittedSnapshot);
+        } else {
+            _transaction = _snapshotManager->beginTransaction();
+        }
+    }
+    return _transaction;
+}
+
+std::shared_ptr<InMemoryTransaction> InMemoryRecoveryUnit::getTransaction(OperationContext* txn) {
+    auto ru = dynamic_cast<InMemoryRecoveryUnit*>(txn->recoveryUnit());
+    if (!ru)
+        return {};
+    return ru->getTransaction();
+}
+
+uint64_t InMemoryRecoveryUnit::getOldestReadVersion(OperationContext* txn) {
+    auto ru = dynamic_cast<InMemoryRecoveryUnit*>(txn->recoveryUnit());
+    if (!ru)
+        return kMaxVersion;
+    return ru->_snapshotManager->getOldestReadVersion();
+}
+
+void InMemoryRecoveryUnit::prepareForCreateSnapshot() {
+    invariant(!_transaction);
+    invariant(!_inUnitOfWork);
+    invariant(!_readFromMajorityCommittedSnapshot);
+
+    // Begins the transaction whose read version the named snapshot will have.
+    getTransaction();
+    _areWriteUnitOfWorksBanned = true;
+}
+
+void InMemoryRecoveryUnit::_endTransaction() {
+    if (!_transaction)
+        return;
+    _snapshotManager->endTransaction(_transaction.get());
+    _transaction.reset();
+    _mySnapshotCount++;
+}
+
+}  // namespace mongo
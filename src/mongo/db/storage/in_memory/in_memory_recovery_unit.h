@@ -30,9 +30,11 @@
 
 #pragma once
 
+#include <memory>
 #include <vector>
 
 #include "mongo/db/record_id.h"
+#include "mongo/db/storage/in_memory/in_memory_snapshot_manager.h"
 #include "mongo/db/storage/recovery_unit.h"
 
 namespace mongo {
@@ -41,7 +43,10 @@ class SortedDataInterface;
 
 class InMemoryRecoveryUnit : public RecoveryUnit {
 public:
-    void beginUnitOfWork(OperationContext* opCtx) final{};
+    explicit InMemoryRecoveryUnit(InMemorySnapshotManager* snapshotManager);
+    ~InMemoryRecoveryUnit();
+
+    void beginUnitOfWork(OperationContext* opCtx) final;
     void commitUnitOfWork() final;
     void abortUnitOfWork() final;
 
@@ -49,12 +54,17 @@ public:
         return true;
     }
 
-    virtual void abandonSnapshot() {}
+    virtual void abandonSnapshot();
 
-    virtual void registerChange(Change* change) {
-        _changes.push_back(ChangePtr(change));
+    Status setReadFromMajorityCommittedSnapshot() final;
+    bool isReadingFromMajorityCommittedSnapshot() const final {
+        return _readFromMajorityCommittedSnapshot;
     }
 
+    boost::optional<SnapshotName> getMajorityCommittedSnapshot() const final;
+
+    virtual void registerChange(Change* change);
+
     virtual void* writingPtr(void* data, size_t len) {
         invariant(!"don't call writingPtr");
     }
@@ -62,13 +72,47 @@ public:
     virtual void setRollbackWritesDisabled() {}
 
     virtual SnapshotId getSnapshotId() const {
-        return SnapshotId();
+        return SnapshotId(_mySnapshotCount);
     }
 
+    static InMemoryRecoveryUnit* get(OperationContext* txn);
+
+    /**
+     * Returns the transaction that reads and writes through this recovery unit, beginning one if
+     * there is none. It lasts until the unit of work ends or the snapshot is abandoned.
+     */
+    const std::shared_ptr<InMemoryTransaction>& getTransaction();
+
+    /**
+     * Returns the transaction of 'txn', or null if its recovery unit is not an
+     * InMemoryRecoveryUnit. The in_memory record store is also used by other engines.
+     */
+    static std::shared_ptr<InMemoryTransaction> getTransaction(OperationContext* txn);
+
+    /**
+     * Returns the version below which versions hidden by newer ones can be discarded, or
+     * kMaxVersion if 'txn' does not have an InMemoryRecoveryUnit.
+     */
+    static uint64_t getOldestReadVersion(OperationContext* txn);
+
+    void prepareForCreateSnapshot();
+
+    static const uint64_t kMaxVersion = UINT64_MAX;
+
 private:
+    void _endTransaction();
+
     typedef std::shared_ptr<Change> ChangePtr;
     typedef std::vector<ChangePtr> Changes;
 
+    InMemorySnapshotManager* const _snapshotManager;  // not owned
+    std::shared_ptr<InMemoryTransaction> _transaction;
+    bool _inUnitOfWork = false;
+    bool _areWriteUnitOfWorksBanned = false;
+    bool _readFromMajorityCommittedSnapshot = false;
+    SnapshotName _majorityCommittedSnapshot = SnapshotName::min();
+    uint64_t _mySnapshotCount = 1;
+
     Changes _changes;
 };
 
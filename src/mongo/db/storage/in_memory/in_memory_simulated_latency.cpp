@@ -0,0 +1,87 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/in_memory/in_memory_simulated_latency.h"
+
+#include <cmath>
+
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/random.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+// The mean latency, in microseconds, of each kind of operation. Zero means no delay.
+MONGO_EXPORT_SERVER_PARAMETER(inMemorySimulatedReadMicros, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(inMemorySimulatedWriteMicros, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(inMemorySimulatedCommitMicros, int, 0);
+
+// Draws each latency from an exponential distribution with the configured mean, rather than
+// always using the mean, to model the long tail of real devices.
+MONGO_EXPORT_SERVER_PARAMETER(inMemorySimulatedLatencyExponential, bool, false);
+
+namespace {
+
+stdx::mutex randomMutex;
+PseudoRandom random(static_cast<int64_t>(curTimeMicros64()));
+
+long long drawExponential(int mean) {
+    double uniform;
+    {
+        stdx::lock_guard<stdx::mutex> lk(randomMutex);
+        uniform = random.nextCanonicalDouble();
+    }
+    return static_cast<long long>(-std::log(1.0 - uniform) * mean);
+}
+
+}  // namespace
+
+void simulateInMemoryLatency(InMemoryLatencyKind kind) {
+    int mean = 0;
+    switch (kind) {
+        case InMemoryLatencyKind::kRead:
+            mean = inMemorySimulatedReadMicros;
+            break;
+        case InMemoryLatencyKind::kWrite:
+            mean = inMemorySimulatedWriteMicros;
+            break;
+        case InMemoryLatencyKind::kCommit:
+            mean = inMemorySimulatedCommitMicros;
+            break;
+    }
+
+    if (mean <= 0)
+        return;
+
+    sleepmicros(inMemorySimulatedLatencyExponential ? drawExponential(mean) : mean);
+}
+
+}  // namespace mongo
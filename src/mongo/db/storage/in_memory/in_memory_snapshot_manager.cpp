@@ -0,0 +1,138 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/in_memory/in_memory_snapshot_manager.h"
+
+#include <algorithm>
+
+#include "mongo/db/storage/in_memory/in_memory_recovery_unit.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+Status InMemorySnapshotManager::prepareForCreateSnapshot(OperationContext* txn) {
+    InMemoryRecoveryUnit::get(txn)->prepareForCreateSnapshot();
+    return Status::OK();
+}
+
+Status InMemorySnapshotManager::createSnapshot(OperationContext* txn, const SnapshotName& name) {
+    const uint64_t readVersion = InMemoryRecoveryUnit::get(txn)->getTransaction()->getReadVersion();
+
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _snapshots[name] = readVersion;
+    _updateOldestReadVersion_inlock();
+    return Status::OK();
+}
+
+void InMemorySnapshotManager::setCommittedSnapshot(const SnapshotName& name) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    invariant(!_committedSnapshot || *_committedSnapshot <= name);
+    invariant(_snapshots.count(name));
+    _committedSnapshot = name;
+}
+
+void InMemorySnapshotManager::cleanupUnneededSnapshots() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    if (!_committedSnapshot)
+        return;
+
+    _snapshots.erase(_snapshots.begin(), _snapshots.lower_bound(*_committedSnapshot));
+    _updateOldestReadVersion_inlock();
+}
+
+void InMemorySnapshotManager::dropAllSnapshots() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    _committedSnapshot = boost::none;
+    _snapshots.clear();
+    _updateOldestReadVersion_inlock();
+}
+
+std::shared_ptr<InMemoryTransaction> InMemorySnapshotManager::beginTransaction() {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    auto transaction = std::make_shared<InMemoryTransaction>(_lastCommitVersion);
+    _activeReadVersions.insert(_lastCommitVersion);
+    _updateOldestReadVersion_inlock();
+    return transaction;
+}
+
+std::shared_ptr<InMemoryTransaction> InMemorySnapshotManager::beginTransactionOnCommittedSnapshot(
+    SnapshotName* nameOut) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+
+    uassert(ErrorCodes::ReadConcernMajorityNotAvailableYet,
+            "Committed view disappeared while running operation",
+            _committedSnapshot);
+
+    const uint64_t readVersion = _snapshots[*_committedSnapshot];
+    auto transaction = std::make_shared<InMemoryTransaction>(readVersion);
+    _activeReadVersions.insert(readVersion);
+    _updateOldestReadVersion_inlock();
+    *nameOut = *_committedSnapshot;
+    return transaction;
+}
+
+boost::optional<SnapshotName> InMemorySnapshotManager::getMinSnapshotForNextCommittedRead() const {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    return _committedSnapshot;
+}
+
+void InMemorySnapshotManager::commitTransaction(InMemoryTransaction* transaction) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    invariant(transaction->getCommitVersion() == 0);
+
+    // Transactions that begin after this see the new version, and those that began before do not,
+    // since both happen under _mutex.
+    transaction->_commitVersion.store(++_lastCommitVersion);
+    _updateOldestReadVersion_inlock();
+}
+
+void InMemorySnapshotManager::endTransaction(InMemoryTransaction* transaction) {
+    stdx::lock_guard<stdx::mutex> lock(_mutex);
+    if (transaction->getCommitVersion() == 0)
+        transaction->_commitVersion.store(InMemoryTransaction::kAborted);
+
+    auto it = _activeReadVersions.find(transaction->getReadVersion());
+    invariant(it != _activeReadVersions.end());
+    _activeReadVersions.erase(it);
+    _updateOldestReadVersion_inlock();
+}
+
+void InMemorySnapshotManager::_updateOldestReadVersion_inlock() {
+    uint64_t oldest = _lastCommitVersion;
+    if (!_activeReadVersions.empty())
+        oldest = std::min(oldest, *_activeReadVersions.begin());
+    if (!_snapshots.empty())
+        oldest = std::min(oldest, _snapshots.begin()->second);
+    _oldestReadVersion.store(oldest);
+}
+
+}  // namespace mongo
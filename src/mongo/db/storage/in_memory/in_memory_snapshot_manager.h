@@ -0,0 +1,165 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <set>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/db/storage/snapshot_manager.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * A transaction of the in_memory engine. It reads the versions committed at or before its read
+ * version, and its own writes, and is given a commit version when it commits.
+ */
+class InMemoryTransaction {
+    MONGO_DISALLOW_COPYING(InMemoryTransaction);
+
+public:
+    explicit InMemoryTransaction(uint64_t readVersion) : _readVersion(readVersion) {}
+
+    uint64_t getReadVersion() const {
+        return _readVersion;
+    }
+
+    /**
+     * Returns 0 until the transaction commits and kAborted once it has rolled back.
+     */
+    uint64_t getCommitVersion() const {
+        return _commitVersion.load();
+    }
+
+    /**
+     * Returns whether 'reader' can see the versions written by 'writer'. A null transaction stands
+     * for operations outside of an InMemoryRecoveryUnit: versions it writes are visible to all,
+     * and it sees the newest version of everything.
+     */
+    static bool canSee(const InMemoryTransaction* reader, const InMemoryTransaction* writer) {
+        if (!reader || !writer || reader == writer)
+            return true;
+        const uint64_t commitVersion = writer->getCommitVersion();
+        return commitVersion != 0 && commitVersion <= reader->_readVersion;
+    }
+
+    /**
+     * Returns whether 'writer' must not overwrite a version written by 'other', because 'other'
+     * has not committed or committed after 'writer' took its snapshot.
+     */
+    static bool conflicts(const InMemoryTransaction* writer, const InMemoryTransaction* other) {
+        return !canSee(writer, other);
+    }
+
+    static const uint64_t kAborted = UINT64_MAX;
+
+private:
+    friend class InMemorySnapshotManager;
+
+    const uint64_t _readVersion;
+    AtomicUInt64 _commitVersion;
+};
+
+/**
+ * Hands out the read and commit versions of InMemoryTransactions, and names the read versions
+ * of snapshots for committed reads.
+ */
+class InMemorySnapshotManager final : public SnapshotManager {
+    MONGO_DISALLOW_COPYING(InMemorySnapshotManager);
+
+public:
+    InMemorySnapshotManager() = default;
+
+    Status prepareForCreateSnapshot(OperationContext* txn) final;
+    Status createSnapshot(OperationContext* txn, const SnapshotName& name) final;
+    void setCommittedSnapshot(const SnapshotName& name) final;
+    void cleanupUnneededSnapshots() final;
+    void dropAllSnapshots() final;
+
+    //
+    // in_memory-specific methods
+    //
+
+    /**
+     * Begins a transaction reading everything committed so far.
+     */
+    std::shared_ptr<InMemoryTransaction> beginTransaction();
+
+    /**
+     * Begins a transaction reading the committed snapshot, whose name is returned in 'nameOut'.
+     *
+     * Throws if there is currently no committed snapshot.
+     */
+    std::shared_ptr<InMemoryTransaction> beginTransactionOnCommittedSnapshot(
+        SnapshotName* nameOut);
+
+    /**
+     * Returns lowest SnapshotName that could possibly be used by a future call to
+     * beginTransactionOnCommittedSnapshot, or boost::none if there is currently no committed
+     * snapshot.
+     */
+    boost::optional<SnapshotName> getMinSnapshotForNextCommittedRead() const;
+
+    /**
+     * Gives 'transaction' the next commit version, making its writes visible to the
+     * transactions that begin afterwards.
+     */
+    void commitTransaction(InMemoryTransaction* transaction);
+
+    /**
+     * Ends a transaction that has committed, or sets 'transaction' aborted once its writes have
+     * been rolled back.
+     */
+    void endTransaction(InMemoryTransaction* transaction);
+
+    /**
+     * Returns the lowest read version of any active transaction or named snapshot. Versions that
+     * are hidden by newer ones from transactions reading at this version can be discarded.
+     */
+    uint64_t getOldestReadVersion() const {
+        return _oldestReadVersion.load();
+    }
+
+private:
+    void _updateOldestReadVersion_inlock();
+
+    mutable stdx::mutex _mutex;  // Guards all members but _oldestReadVersion.
+    uint64_t _lastCommitVersion = 0;
+    std::multiset<uint64_t> _activeReadVersions;
+    std::map<SnapshotName, uint64_t> _snapshots;  // The read version of each named snapshot.
+    boost::optional<SnapshotName> _committedSnapshot;
+    AtomicUInt64 _oldestReadVersion;
+};
+
+}  // namespace mongo
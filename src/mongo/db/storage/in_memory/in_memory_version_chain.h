@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+
+#include "mongo/db/storage/in_memory/in_memory_snapshot_manager.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+/**
+ * The versions of one record or index entry of the in_memory engine, newest first. Each version
+ * is either a value or a tombstone, and is seen by the transactions that can see its writer.
+ *
+ * Not thread-safe: the chains of a record store or an index are guarded by its mutex.
+ */
+template <typename T>
+class InMemoryVersionChain {
+public:
+    InMemoryVersionChain() = default;
+    InMemoryVersionChain(InMemoryVersionChain&&) = default;
+    InMemoryVersionChain& operator=(InMemoryVersionChain&&) = default;
+
+    /**
+     * Returns the value of the newest version 'reader' sees, or nullptr if that is a tombstone or
+     * it sees no version.
+     */
+    const T* find(const InMemoryTransaction* reader) const {
+        const Version* version = _findVersion(reader);
+        return version && version->value ? version->value.get_ptr() : nullptr;
+    }
+
+    /**
+     * Returns whether 'reader' sees any version, including a tombstone.
+     */
+    bool seesAnyVersion(const InMemoryTransaction* reader) const {
+        return _findVersion(reader);
+    }
+
+    /**
+     * Returns whether 'writer' may not add a version, because the newest one was written by a
+     * concurrent transaction.
+     */
+    bool conflictsWith(const InMemoryTransaction* writer) const {
+        return _newest && InMemoryTransaction::conflicts(writer, _newest->writer.get());
+    }
+
+    /**
+     * Adds a version written by 'writer'. A 'value' of boost::none is a tombstone.
+     */
+    void push(std::shared_ptr<InMemoryTransaction> writer, boost::optional<T> value) {
+        dassert(!conflictsWith(writer.get()));
+        std::unique_ptr<Version> version(new Version(std::move(writer), std::move(value)));
+        version->older = std::move(_newest);
+        _newest = std::move(version);
+    }
+
+    /**
+     * Removes the newest version, which 'writer' added, when rolling it back.
+     */
+    void pop(const InMemoryTransaction* writer) {
+        invariant(_newest && _newest->writer.get() == writer);
+        _newest = std::move(_newest->older);
+    }
+
+    /**
+     * Discards the versions that no transaction reading at or after 'oldestReadVersion' can see.
+     * Returns true if nothing is left that such a transaction could see, so that the whole chain
+     * can be discarded.
+     */
+    bool prune(uint64_t oldestReadVersion) {
+        Version* version = _newest.get();
+        while (version && !_isSeenAt(*version, oldestReadVersion)) {
+            version = version->older.get();
+        }
+        if (!version)
+            return !_newest;
+
+        version->older.reset();
+        return version == _newest.get() && !version->value;
+    }
+
+    bool empty() const {
+        return !_newest;
+    }
+
+private:
+    struct Version {
+        Version(std::shared_ptr<InMemoryTransaction> writer, boost::optional<T> value)
+            : writer(std::move(writer)), value(std::move(value)) {}
+
+        const std::shared_ptr<InMemoryTransaction> writer;  // Null if written by no transaction.
+        const boost::optional<T> value;                     // boost::none for a tombstone.
+        std::unique_ptr<Version> older;
+    };
+
+    const Version* _findVersion(const InMemoryTransaction* reader) const {
+        for (const Version* version = _newest.get(); version; version = version->older.get()) {
+            if (InMemoryTransaction::canSee(reader, version->writer.get()))
+                return version;
+        }
+        return nullptr;
+    }
+
+    static bool _isSeenAt(const Version& version, uint64_t readVersion) {
+        if (!version.writer)
+            return true;
+        const uint64_t commitVersion = version.writer->getCommitVersion();
+        return commitVersion != 0 && commitVersion <= readVersion;
+    }
+
+    std::unique_ptr<Version> _newest;
+};
+
+}  // namespace mongo
@@ -1130,28 +1130,6 @@ std::string KeyString::toString() const {
     return toHex(getBuffer(), getSize());
 }
 
-int KeyString::compare(const KeyString& other) const {
-    int a = getSize();
-    int b = other.getSize();
-
-    int min = std::min(a, b);
-
-    int cmp = memcmp(getBuffer(), other.getBuffer(), min);
-
-    if (cmp) {
-        if (cmp < 0)
-            return -1;
-        return 1;
-    }
-
-    // keys match
-
-    if (a == b)
-        return 0;
-
-    return a < b ? -1 : 1;
-}
-
 void KeyString::TypeBits::resetFromBuffer(BufReader* reader) {
     if (!reader->remaining()) {
         // This means AllZeros state was encoded as an empty buffer.
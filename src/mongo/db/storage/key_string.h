@@ -30,6 +30,9 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstring>
+
 #include "mongo/bson/bsonobj.h"
 #include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/bson/bsonmisc.h"
@@ -271,7 +274,25 @@ public:
         return _typeBits;
     }
 
-    int compare(const KeyString& other) const;
+    /**
+     * Compares the encoded bytes of the two keys. This is inline, as the storage engines call it
+     * for every step of an index scan; memcmp is already vectorized by the C library.
+     */
+    int compare(const KeyString& other) const {
+        const size_t a = getSize();
+        const size_t b = other.getSize();
+
+        const int cmp = memcmp(getBuffer(), other.getBuffer(), std::min(a, b));
+        if (cmp) {
+            return cmp < 0 ? -1 : 1;
+        }
+
+        // keys match up to the length of the shorter one
+        if (a == b)
+            return 0;
+
+        return a < b ? -1 : 1;
+    }
 
     /**
      * @return a hex encoding of this key
@@ -87,6 +87,43 @@ public:
     const Entry _entry;
 };
 
+class KVCatalog::UpdateEntryChange : public RecoveryUnit::Change {
+public:
+    UpdateEntryChange(KVCatalog* catalog, StringData ns, RecordId loc, BSONObj obj)
+        : _catalog(catalog), _ns(ns.toString()), _loc(loc), _obj(std::move(obj)) {}
+
+    virtual void commit() {
+        stdx::lock_guard<stdx::mutex> lk(_catalog->_identsLock);
+        if (Entry* entry = _findEntry_inlock()) {
+            entry->obj = _obj;
+            entry->md.reset();
+            entry->uncommittedWrites--;
+        }
+    }
+
+    virtual void rollback() {
+        stdx::lock_guard<stdx::mutex> lk(_catalog->_identsLock);
+        if (Entry* entry = _findEntry_inlock()) {
+            entry->uncommittedWrites--;
+        }
+    }
+
+private:
+    // Returns the entry this change was registered for, unless the transaction dropped it.
+    Entry* _findEntry_inlock() {
+        NSToIdentMap::iterator it = _catalog->_idents.find(_ns);
+        if (it == _catalog->_idents.end() || it->second.storedLoc != _loc)
+            return NULL;
+        invariant(it->second.uncommittedWrites > 0);
+        return &it->second;
+    }
+
+    KVCatalog* const _catalog;
+    const std::string _ns;
+    const RecordId _loc;
+    const BSONObj _obj;
+};
+
 KVCatalog::KVCatalog(RecordStore* rs,
                      bool isRsThreadSafe,
                      bool directoryPerDb,
@@ -130,12 +167,14 @@ void KVCatalog::init(OperationContext* opCtx) {
     // No locking needed since called single threaded.
     auto cursor = _rs->getCursor(opCtx);
     while (auto record = cursor->next()) {
-        BSONObj obj = record->data.releaseToBson();
+        BSONObj obj = record->data.releaseToBson().getOwned();
 
         // No rollback since this is just loading already committed data.
         string ns = obj["ns"].String();
         string ident = obj["ident"].String();
-        _idents[ns] = Entry(ident, record->id);
+        Entry& entry = _idents[ns];
+        entry = Entry(ident, record->id);
+        entry.obj = obj;
     }
 
     // In the unlikely event that we have used this _rand before generate a new one.
@@ -189,6 +228,7 @@ Status KVCatalog::newCollection(OperationContext* opCtx,
         return res.getStatus();
 
     old = Entry(ident, res.getValue());
+    _registerEntryUpdate_inlock(opCtx, ns, obj);
     LOG(1) << "stored meta data for " << ns << " @ " << res.getValue();
     return Status::OK();
 }
@@ -208,7 +248,27 @@ std::string KVCatalog::getIndexIdent(OperationContext* opCtx,
     return idxIdent[idxName].String();
 }
 
+void KVCatalog::_registerEntryUpdate_inlock(OperationContext* opCtx,
+                                            StringData ns,
+                                            const BSONObj& obj) {
+    Entry& entry = _idents[ns.toString()];
+    entry.uncommittedWrites++;
+    opCtx->recoveryUnit()->registerChange(
+        new UpdateEntryChange(this, ns, entry.storedLoc, obj.getOwned()));
+}
+
 BSONObj KVCatalog::_findEntry(OperationContext* opCtx, StringData ns, RecordId* out) const {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        NSToIdentMap::const_iterator it = _idents.find(ns.toString());
+        invariant(it != _idents.end());
+        if (it->second.isCached()) {
+            if (out)
+                *out = it->second.storedLoc;
+            return it->second.obj;
+        }
+    }
+
     std::unique_ptr<Lock::ResourceLock> rLk;
     if (!_isRsThreadSafe && opCtx->lockState()) {
         rLk.reset(new Lock::ResourceLock(opCtx->lockState(), resourceIdCatalogMetadata, MODE_S));
@@ -239,15 +299,29 @@ BSONObj KVCatalog::_findEntry(OperationContext* opCtx, StringData ns, RecordId*
 
 const BSONCollectionCatalogEntry::MetaData KVCatalog::getMetaData(OperationContext* opCtx,
                                                                   StringData ns) {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_identsLock);
+        NSToIdentMap::const_iterator it = _idents.find(ns.toString());
+        invariant(it != _idents.end());
+        if (it->second.isCached() && it->second.md)
+            return *it->second.md;
+    }
+
     BSONObj obj = _findEntry(opCtx, ns);
     LOG(3) << " fetched CCE metadata: " << obj;
-    BSONCollectionCatalogEntry::MetaData md;
+    auto md = std::make_shared<BSONCollectionCatalogEntry::MetaData>();
     const BSONElement mdElement = obj["md"];
     if (mdElement.isABSONObj()) {
         LOG(3) << "returning metadata: " << mdElement;
-        md.parse(mdElement.Obj());
+        md->parse(mdElement.Obj());
     }
-    return md;
+
+    // Keep the parsed metadata if it came from the cached document, and that is still current.
+    stdx::lock_guard<stdx::mutex> lk(_identsLock);
+    NSToIdentMap::iterator it = _idents.find(ns.toString());
+    if (it != _idents.end() && it->second.isCached() && it->second.obj.objdata() == obj.objdata())
+        it->second.md = md;
+    return *md;
 }
 
 void KVCatalog::putMetaData(OperationContext* opCtx,
@@ -294,6 +368,9 @@ void KVCatalog::putMetaData(OperationContext* opCtx,
         _rs->updateRecord(opCtx, loc, obj.objdata(), obj.objsize(), false, NULL);
     fassert(28521, status.getStatus());
     invariant(status.getValue() == loc);
+
+    stdx::lock_guard<stdx::mutex> lk(_identsLock);
+    _registerEntryUpdate_inlock(opCtx, ns, obj);
 }
 
 Status KVCatalog::renameCollection(OperationContext* opCtx,
@@ -307,6 +384,7 @@ Status KVCatalog::renameCollection(OperationContext* opCtx,
 
     RecordId loc;
     BSONObj old = _findEntry(opCtx, fromNS, &loc).getOwned();
+    BSONObj obj;
     {
         BSONObjBuilder b;
 
@@ -321,7 +399,7 @@ Status KVCatalog::renameCollection(OperationContext* opCtx,
 
         b.appendElementsUnique(old);
 
-        BSONObj obj = b.obj();
+        obj = b.obj();
         StatusWith<RecordId> status =
             _rs->updateRecord(opCtx, loc, obj.objdata(), obj.objsize(), false, NULL);
         fassert(28522, status.getStatus());
@@ -337,6 +415,7 @@ Status KVCatalog::renameCollection(OperationContext* opCtx,
 
     _idents.erase(fromIt);
     _idents[toNS.toString()] = Entry(old["ident"].String(), loc);
+    _registerEntryUpdate_inlock(opCtx, toNS, obj);
 
     return Status::OK();
 }
@@ -31,6 +31,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <string>
 
 #include "mongo/base/string_data.h"
@@ -85,9 +86,16 @@ public:
 private:
     class AddIdentChange;
     class RemoveIdentChange;
+    class UpdateEntryChange;
 
     BSONObj _findEntry(OperationContext* opCtx, StringData ns, RecordId* out = NULL) const;
 
+    /**
+     * Notes that this transaction has written 'obj' as the catalog document for 'ns', which
+     * becomes its cached document once the transaction commits.
+     */
+    void _registerEntryUpdate_inlock(OperationContext* opCtx, StringData ns, const BSONObj& obj);
+
     /**
      * Generates a new unique identifier for a new "thing".
      * @param ns - the containing ns
@@ -113,6 +121,17 @@ private:
         Entry(std::string i, RecordId l) : ident(i), storedLoc(l) {}
         std::string ident;
         RecordId storedLoc;
+
+        // The committed catalog document, and its metadata once parsed. These are only read while
+        // no transaction has uncommitted writes to the document, since until then that
+        // transaction has to read its own writes from the record store.
+        BSONObj obj;
+        std::shared_ptr<const BSONCollectionCatalogEntry::MetaData> md;
+        int uncommittedWrites = 0;
+
+        bool isCached() const {
+            return uncommittedWrites == 0 && !obj.isEmpty();
+        }
     };
     typedef std::map<std::string, Entry> NSToIdentMap;
     NSToIdentMap _idents;
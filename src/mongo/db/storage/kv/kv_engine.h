@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/base/string_data.h"
 #include "mongo/db/catalog/collection_options.h"
 
@@ -94,6 +95,19 @@ public:
         return 0;
     }
 
+    /**
+     * See StorageEngine::beginNonBlockingBackup.
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support non-blocking backups");
+    }
+
+    /**
+     * See StorageEngine::endNonBlockingBackup.
+     */
+    virtual void endNonBlockingBackup(OperationContext* opCtx) {}
+
     virtual bool isDurable() const = 0;
 
     /**
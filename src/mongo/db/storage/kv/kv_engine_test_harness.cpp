@@ -278,6 +278,70 @@ TEST(KVCatalogTest, Idx1) {
     }
 }
 
+TEST(KVCatalogTest, RollBackMetaData) {
+    unique_ptr<KVHarnessHelper> helper(KVHarnessHelper::create());
+    KVEngine* engine = helper->getEngine();
+
+    unique_ptr<RecordStore> rs;
+    unique_ptr<KVCatalog> catalog;
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(engine->createRecordStore(&opCtx, "catalog", "catalog", CollectionOptions()));
+        rs.reset(engine->getRecordStore(&opCtx, "catalog", "catalog", CollectionOptions()));
+        catalog.reset(new KVCatalog(rs.get(), true, false, false));
+        uow.commit();
+    }
+
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(catalog->newCollection(&opCtx, "a.b", CollectionOptions()));
+        uow.commit();
+    }
+
+    {
+        MyOperationContext opCtx(engine);
+        ASSERT_EQUALS(0U, catalog->getMetaData(&opCtx, "a.b").indexes.size());
+    }
+
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+
+        BSONCollectionCatalogEntry::MetaData md;
+        md.ns = "a.b";
+        md.indexes.push_back(BSONCollectionCatalogEntry::IndexMetaData(BSON("name"
+                                                                            << "foo"),
+                                                                       false,
+                                                                       RecordId(),
+                                                                       false));
+        catalog->putMetaData(&opCtx, "a.b", md);
+
+        // The transaction reads its own write.
+        ASSERT_EQUALS(1U, catalog->getMetaData(&opCtx, "a.b").indexes.size());
+        ASSERT_FALSE(catalog->getIndexIdent(&opCtx, "a.b", "foo").empty());
+    }
+
+    {
+        MyOperationContext opCtx(engine);
+        ASSERT_EQUALS(0U, catalog->getMetaData(&opCtx, "a.b").indexes.size());
+    }
+
+    {
+        MyOperationContext opCtx(engine);
+        WriteUnitOfWork uow(&opCtx);
+        ASSERT_OK(catalog->renameCollection(&opCtx, "a.b", "a.c", false));
+        ASSERT_EQUALS("a.c", catalog->getMetaData(&opCtx, "a.c").ns);
+        uow.commit();
+    }
+
+    {
+        MyOperationContext opCtx(engine);
+        ASSERT_EQUALS("a.c", catalog->getMetaData(&opCtx, "a.c").ns);
+    }
+}
+
 TEST(KVCatalogTest, DirectoryPerDb1) {
     unique_ptr<KVHarnessHelper> helper(KVHarnessHelper::create());
     KVEngine* engine = helper->getEngine();
@@ -247,6 +247,15 @@ int KVStorageEngine::flushAllFiles(bool sync) {
     return _engine->flushAllFiles(sync);
 }
 
+StatusWith<std::vector<std::string>> KVStorageEngine::beginNonBlockingBackup(
+    OperationContext* txn) {
+    return _engine->beginNonBlockingBackup(txn);
+}
+
+void KVStorageEngine::endNonBlockingBackup(OperationContext* txn) {
+    _engine->endNonBlockingBackup(txn);
+}
+
 bool KVStorageEngine::isDurable() const {
     return _engine->isDurable();
 }
@@ -80,6 +80,10 @@ public:
 
     virtual int flushAllFiles(bool sync);
 
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* txn);
+
+    virtual void endNonBlockingBackup(OperationContext* txn);
+
     virtual bool isDurable() const;
 
     virtual Status repairRecordStore(OperationContext* txn, const std::string& ns);
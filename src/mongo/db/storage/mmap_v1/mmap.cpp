@@ -36,6 +36,9 @@
 #include <boost/filesystem/operations.hpp>
 
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/concurrency/rwlock.h"
 #include "mongo/util/log.h"
 #include "mongo/util/map_util.h"
@@ -166,6 +169,10 @@ void MongoFile::closeAllFiles(stringstream& message) {
     return total;
 }
 
+// A synchronous flushAll() flushes this many files at a time, each on its own thread, so that the
+// periodic flush of a database with many files takes less time.
+MONGO_EXPORT_SERVER_PARAMETER(mmapv1FlushThreads, int, 4);
+
 void nullFunc() {}
 
 // callback notifications
@@ -212,8 +219,29 @@ void (*MongoFile::notifyPostFlush)() = nullFunc;
         }
     }
 
-    for (size_t i = 0; i < thingsToFlush.size(); i++) {
-        thingsToFlush[i]->flush();
+    const size_t numThreads =
+        std::min(thingsToFlush.size(), static_cast<size_t>(std::max(1, mmapv1FlushThreads)));
+    if (numThreads <= 1) {
+        for (size_t i = 0; i < thingsToFlush.size(); i++) {
+            thingsToFlush[i]->flush();
+        }
+        return thingsToFlush.size();
+    }
+
+    // Each thread takes the next file to flush until there are none left, so that one large file
+    // does not hold up the others.
+    AtomicWord<unsigned long long> nextToFlush(0);
+    vector<stdx::thread> threads;
+    for (size_t i = 0; i < numThreads; i++) {
+        threads.emplace_back([&] {
+            for (size_t j = nextToFlush.fetchAndAdd(1); j < thingsToFlush.size();
+                 j = nextToFlush.fetchAndAdd(1)) {
+                thingsToFlush[j]->flush();
+            }
+        });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
     }
 
     return thingsToFlush.size();
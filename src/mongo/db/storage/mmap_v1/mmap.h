@@ -59,6 +59,12 @@ private:
     unsigned _len;
 };
 
+/**
+ * Hints that [p, p + len) will be read soon, so that the OS starts reading in the pages which are
+ * not in memory without waiting for them to fault.
+ */
+void adviseWillNeed(const void* p, size_t len);
+
 // lock order: lock dbMutex before this if you lock both
 class LockMongoFilesShared {
     friend class LockMongoFilesExclusive;
@@ -93,6 +93,13 @@ public:
         // we expect a page fault to occur, so we should this out of the lock.
         __record_touch_dummy += *recordChar;
 
+        // A large record spans more pages than the one just faulted in. Have the OS read them in
+        // together now, rather than one fault at a time once we hold the locks again.
+        const int length = _record->lengthWithHeaders();
+        if (length > 0) {
+            adviseWillNeed(recordChar, length);
+        }
+
         // We're not going to touch the record anymore, so we can give up our
         // lock on mongo files. We do this here because we have to release the
         // lock on mongo files prior to reacquiring lock mgr locks.
@@ -74,6 +74,7 @@ stdx::mutex mapViewMutex;
 
 MAdvise::MAdvise(void*, unsigned, Advice) {}
 MAdvise::~MAdvise() {}
+void adviseWillNeed(const void*, size_t) {}
 
 const unsigned long long memoryMappedFileLocationFloor = 256LL * 1024LL * 1024LL * 1024LL;
 static unsigned long long _nextMemoryMappedFileLocation = memoryMappedFileLocationFloor;
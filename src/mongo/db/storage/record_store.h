@@ -31,6 +31,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <vector>
 
 #include "mongo/base/owned_pointer_vector.h"
 #include "mongo/bson/mutable/damage_vector.h"
@@ -91,6 +92,15 @@ struct Record {
     RecordData data;
 };
 
+/**
+ * A document which has been inserted into a RecordStore at 'id', as passed to index maintenance
+ * for a batch of inserts.
+ */
+struct BsonRecord {
+    RecordId id;
+    const BSONObj* docPtr;
+};
+
 /**
  * Retrieves Records from a RecordStore.
  *
@@ -197,6 +207,16 @@ public:
      */
     virtual void invalidate(const RecordId& id){};
 
+    /**
+     * Hints that the caller is going to read through most of the remaining records in order, so
+     * the storage engine may read up to 'maxBytesAhead' bytes of upcoming records into its cache
+     * while the caller works on the ones already returned.
+     *
+     * This is only a hint, and does not change which records are returned. It must be called in
+     * the same state as next().
+     */
+    virtual void enableReadAhead(int64_t maxBytesAhead) {}
+
     //
     // RecordFetchers
     //
@@ -366,6 +386,27 @@ public:
                                               const DocWriter* doc,
                                               bool enforceQuota) = 0;
 
+    /**
+     * Inserts 'records' as if by calling insertRecord() on each of them in order, and sets the
+     * id of each one to the RecordId it was stored at. Implementations may override this to
+     * amortize the per-record costs across the batch.
+     *
+     * On failure some of the records may already have been inserted, so the caller must abandon
+     * the enclosing WriteUnitOfWork.
+     */
+    virtual Status insertRecords(OperationContext* txn,
+                                 std::vector<Record>* records,
+                                 bool enforceQuota) {
+        for (auto& record : *records) {
+            StatusWith<RecordId> res =
+                insertRecord(txn, record.data.data(), record.data.size(), enforceQuota);
+            if (!res.isOK())
+                return res.getStatus();
+            record.id = res.getValue();
+        }
+        return Status::OK();
+    }
+
     /**
      * @param notifier - Only used by record stores which do not support doc-locking.
      *                   In the case of a document move, this is called after the document
@@ -485,6 +526,15 @@ public:
         invariant(false);
     }
 
+    /**
+     * Can compact() run with only intent locks held, alongside reads and writes of the data?
+     *
+     * Only called if compactSupported() and compactsInPlace() return true.
+     */
+    virtual bool compactsOnline() const {
+        return false;
+    }
+
     /**
      * Attempt to reduce the storage space used by this RecordStore.
      *
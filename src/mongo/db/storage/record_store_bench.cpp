@@ -0,0 +1,157 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/client.h"
+#include "mongo/db/concurrency/write_conflict_exception.h"
+#include "mongo/db/operation_context.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/record_data.h"
+#include "mongo/db/storage/record_store.h"
+#include "mongo/db/storage/record_store_test_harness.h"
+#include "mongo/db/storage/storage_bench.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+// Number of records each range scan reads.
+const int kScanLength = 100;
+
+/**
+ * Runs "write" in a WriteUnitOfWork on "txn", retrying it when it conflicts with the writes of
+ * other benchmark threads.
+ */
+template <typename Write>
+void writeWithRetry(OperationContext* txn, const Write& write) {
+    while (true) {
+        try {
+            WriteUnitOfWork uow(txn);
+            write();
+            uow.commit();
+            return;
+        } catch (const WriteConflictException&) {
+            txn->recoveryUnit()->abandonSnapshot();
+        }
+    }
+}
+
+/**
+ * Times inserts, point lookups, range scans, updates and deletes of "docSize" byte records on
+ * "numThreads" threads, each working on the records it inserted.
+ */
+void benchmarkRecordStore(int docSize, int numThreads) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    vector<ServiceContext::UniqueClient> clients;
+    vector<unique_ptr<OperationContext>> opCtxs;
+    for (int i = 0; i < numThreads; ++i) {
+        clients.push_back(harnessHelper->serviceContext()->makeClient(str::stream() << "bench"
+                                                                                    << i));
+        opCtxs.push_back(harnessHelper->newOperationContext(clients.back().get()));
+    }
+
+    const int numOps = storage_bench::opsPerThread();
+    const string data(docSize - 1, 'x');
+    vector<vector<RecordId>> ids(numThreads, vector<RecordId>(numOps));
+    const string suffix = str::stream() << "." << docSize << "B";
+
+    storage_bench::run("RecordStore.insert" + suffix, numThreads, [&](int thread, int i) {
+        OperationContext* txn = opCtxs[thread].get();
+        writeWithRetry(txn, [&] {
+            StatusWith<RecordId> res = rs->insertRecord(txn, data.c_str(), docSize, false);
+            ASSERT_OK(res.getStatus());
+            ids[thread][i] = res.getValue();
+        });
+    });
+
+    // Reads look records up out of insertion order, and each is its own storage transaction, as
+    // separate queries would be.
+    storage_bench::run("RecordStore.pointLookup" + suffix, numThreads, [&](int thread, int i) {
+        OperationContext* txn = opCtxs[thread].get();
+        RecordData record;
+        ASSERT(rs->findRecord(txn, ids[thread][(i * 7919LL) % numOps], &record));
+        ASSERT_EQUALS(docSize, record.size());
+        txn->recoveryUnit()->abandonSnapshot();
+    });
+
+    storage_bench::run("RecordStore.rangeScan" + suffix, numThreads, [&](int thread, int i) {
+        OperationContext* txn = opCtxs[thread].get();
+        {
+            auto cursor = rs->getCursor(txn);
+            ASSERT(cursor->seekExact(ids[thread][(i * 7919LL) % numOps]));
+            for (int n = 1; n < kScanLength && cursor->next(); ++n) {
+            }
+        }
+        txn->recoveryUnit()->abandonSnapshot();
+    });
+
+    storage_bench::run("RecordStore.update" + suffix, numThreads, [&](int thread, int i) {
+        OperationContext* txn = opCtxs[thread].get();
+        writeWithRetry(txn, [&] {
+            StatusWith<RecordId> res =
+                rs->updateRecord(txn, ids[thread][i], data.c_str(), docSize, false, NULL);
+            ASSERT_OK(res.getStatus());
+            ids[thread][i] = res.getValue();
+        });
+    });
+
+    storage_bench::run("RecordStore.delete" + suffix, numThreads, [&](int thread, int i) {
+        OperationContext* txn = opCtxs[thread].get();
+        writeWithRetry(txn, [&] { rs->deleteRecord(txn, ids[thread][i]); });
+    });
+
+    ASSERT_EQUALS(0, rs->numRecords(opCtxs[0].get()));
+}
+
+TEST(RecordStoreBenchmark, SmallRecords) {
+    const bool supportsDocLocking = newHarnessHelper()->supportsDocLocking();
+    for (int numThreads : storage_bench::threadCounts(supportsDocLocking)) {
+        benchmarkRecordStore(100, numThreads);
+    }
+}
+
+TEST(RecordStoreBenchmark, LargeRecords) {
+    const bool supportsDocLocking = newHarnessHelper()->supportsDocLocking();
+    for (int numThreads : storage_bench::threadCounts(supportsDocLocking)) {
+        benchmarkRecordStore(10 * 1024, numThreads);
+    }
+}
+
+}  // namespace
+}  // namespace mongo
@@ -174,4 +174,47 @@ TEST(RecordStoreTestHarness, InsertMultipleRecordsUsingDocWriter) {
     }
 }
 
+// Insert multiple records with a single insertRecords() call and verify that each was
+// assigned its own RecordId and can be read back.
+TEST(RecordStoreTestHarness, InsertRecordsBatch) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int nToInsert = 10;
+    string datas[nToInsert];
+    std::vector<Record> records;
+    for (int i = 0; i < nToInsert; i++) {
+        stringstream ss;
+        ss << "record " << i;
+        datas[i] = ss.str();
+
+        Record record = {RecordId(), RecordData(datas[i].c_str(), datas[i].size() + 1)};
+        records.push_back(record);
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(rs->insertRecords(opCtx.get(), &records, false));
+            uow.commit();
+        }
+    }
+
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(nToInsert, rs->numRecords(opCtx.get()));
+        for (int i = 0; i < nToInsert; i++) {
+            ASSERT(records[i].id.isNormal());
+            if (i > 0) {
+                ASSERT_NOT_EQUALS(records[i - 1].id, records[i].id);
+            }
+
+            RecordData record = rs->dataFor(opCtx.get(), records[i].id);
+            ASSERT_EQUALS(datas[i].size() + 1, static_cast<size_t>(record.size()));
+            ASSERT_EQUALS(datas[i], record.data());
+        }
+    }
+}
+
 }  // namespace mongo
@@ -87,6 +87,16 @@ public:
      */
     virtual void abandonSnapshot() = 0;
 
+    /**
+     * Returns true if abandoning the snapshot now would gain nothing: no other transaction has
+     * committed since it was opened, so a new snapshot would see the same data, and holding on to
+     * it keeps no other operation waiting. Query yields use this to skip saving and restoring
+     * their cursors. Engines which cannot tell return false.
+     */
+    virtual bool isSnapshotCurrent() const {
+        return false;
+    }
+
     /**
      * Informs this RecoveryUnit that all future reads through it should be from a snapshot
      * marked as Majority Committed. Snapshots should still be separately acquired and newer
@@ -29,6 +29,7 @@
 #include <boost/optional/optional.hpp>
 #include <boost/optional/optional_io.hpp>
 #include <memory>
+#include <vector>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/operation_context.h"
@@ -99,6 +100,25 @@ public:
                           const RecordId& loc,
                           bool dupsAllowed) = 0;
 
+    /**
+     * Insert 'entries' into the index as if by calling insert() on each of them in order.
+     * Callers pass the entries sorted by IndexEntryComparison under the index's ordering so
+     * that implementations which override this can walk the tree once.
+     *
+     * On failure some of the entries may already have been inserted, so the caller must abandon
+     * the enclosing WriteUnitOfWork.
+     */
+    virtual Status insertKeys(OperationContext* txn,
+                              const std::vector<IndexKeyEntry>& entries,
+                              bool dupsAllowed) {
+        for (const auto& entry : entries) {
+            Status status = insert(txn, entry.key, entry.loc, dupsAllowed);
+            if (!status.isOK())
+                return status;
+        }
+        return Status::OK();
+    }
+
     /**
      * Remove the entry from the index with the specified key and RecordId.
      *
@@ -0,0 +1,133 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <string>
+
+#include "mongo/db/operation_context.h"
+#include "mongo/db/record_id.h"
+#include "mongo/db/storage/sorted_data_interface.h"
+#include "mongo/db/storage/sorted_data_interface_test_harness.h"
+#include "mongo/db/storage/storage_bench.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+using std::string;
+using std::unique_ptr;
+
+// Number of entries each range scan reads.
+const int kScanLength = 100;
+
+/**
+ * Returns the i'th key of a benchmark: an integer if "keySize" is 0, and otherwise a string of
+ * "keySize" bytes which sorts in the order of "i".
+ */
+BSONObj makeKey(int i, int keySize) {
+    if (keySize == 0)
+        return BSON("" << i);
+    string padded = str::stream() << string(10, '0') << i;
+    padded = padded.substr(padded.size() - 10) + string(keySize - 10, 'x');
+    return BSON("" << padded);
+}
+
+RecordId makeLoc(int i) {
+    return RecordId(0, 42 + 2 * i);
+}
+
+/**
+ * Times inserts, point lookups, range scans, updates and deletes of index entries.  Entries are
+ * visited in a scrambled order, so that inserts do not always append to the end of the index.
+ *
+ * The harness does not say whether an index allows concurrent writers, so this runs on one
+ * thread only.
+ */
+void benchmarkSortedDataInterface(int keySize) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+    unique_ptr<OperationContext> txn(harnessHelper->newOperationContext());
+
+    const int numOps = storage_bench::opsPerThread();
+    auto entry = [numOps](int i) { return static_cast<int>((i * 7919LL) % numOps); };
+    const string suffix = keySize ? string(str::stream() << ".string" << keySize << "B") : ".int";
+
+    storage_bench::run("SortedDataInterface.insert" + suffix, 1, [&](int, int i) {
+        WriteUnitOfWork uow(txn.get());
+        ASSERT_OK(sorted->insert(txn.get(), makeKey(entry(i), keySize), makeLoc(entry(i)), true));
+        uow.commit();
+    });
+
+    storage_bench::run("SortedDataInterface.pointLookup" + suffix, 1, [&](int, int i) {
+        {
+            auto cursor = sorted->newCursor(txn.get());
+            ASSERT(cursor->seekExact(makeKey(entry(i), keySize)));
+        }
+        txn->recoveryUnit()->abandonSnapshot();
+    });
+
+    storage_bench::run("SortedDataInterface.rangeScan" + suffix, 1, [&](int, int i) {
+        {
+            auto cursor = sorted->newCursor(txn.get());
+            ASSERT(cursor->seek(makeKey(entry(i), keySize), true));
+            for (int n = 1; n < kScanLength && cursor->next(); ++n) {
+            }
+        }
+        txn->recoveryUnit()->abandonSnapshot();
+    });
+
+    // An update of an indexed field replaces the entry of the document.
+    storage_bench::run("SortedDataInterface.update" + suffix, 1, [&](int, int i) {
+        WriteUnitOfWork uow(txn.get());
+        sorted->unindex(txn.get(), makeKey(entry(i), keySize), makeLoc(entry(i)), true);
+        ASSERT_OK(sorted->insert(
+            txn.get(), makeKey(entry(i), keySize), makeLoc(numOps + entry(i)), true));
+        uow.commit();
+    });
+
+    storage_bench::run("SortedDataInterface.delete" + suffix, 1, [&](int, int i) {
+        WriteUnitOfWork uow(txn.get());
+        sorted->unindex(txn.get(), makeKey(entry(i), keySize), makeLoc(numOps + entry(i)), true);
+        uow.commit();
+    });
+
+    ASSERT(sorted->isEmpty(txn.get()));
+}
+
+TEST(SortedDataInterfaceBenchmark, IntegerKeys) {
+    benchmarkSortedDataInterface(0);
+}
+
+TEST(SortedDataInterfaceBenchmark, StringKeys) {
+    benchmarkSortedDataInterface(100);
+}
+
+}  // namespace
+}  // namespace mongo
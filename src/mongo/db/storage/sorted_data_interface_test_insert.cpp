@@ -31,6 +31,7 @@
 #include "mongo/db/storage/sorted_data_interface_test_harness.h"
 
 #include <memory>
+#include <vector>
 
 #include "mongo/db/storage/sorted_data_interface.h"
 #include "mongo/unittest/unittest.h"
@@ -360,4 +361,49 @@ TEST(SortedDataInterface, InsertMultipleCompoundKeys) {
     }
 }
 
+// Insert a batch of sorted keys with a single insertKeys() call and verify that the
+// number of entries in the index equals the number that were inserted.
+TEST(SortedDataInterface, InsertKeys) {
+    const std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(false));
+
+    const std::vector<IndexKeyEntry> entries = {
+        IndexKeyEntry(key1, loc1), IndexKeyEntry(key2, loc2), IndexKeyEntry(key3, loc3)};
+
+    {
+        const std::unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        {
+            WriteUnitOfWork uow(opCtx.get());
+            ASSERT_OK(sorted->insertKeys(opCtx.get(), entries, true));
+            uow.commit();
+        }
+    }
+
+    {
+        const std::unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQUALS(3, sorted->numEntries(opCtx.get()));
+    }
+}
+
+// Insert a batch containing the same key at two RecordIds into a unique index and verify
+// that insertKeys() reports the duplicate.
+TEST(SortedDataInterface, InsertKeysDuplicate) {
+    const std::unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    const std::unique_ptr<SortedDataInterface> sorted(harnessHelper->newSortedDataInterface(true));
+
+    const std::vector<IndexKeyEntry> entries = {IndexKeyEntry(key1, loc1),
+                                                IndexKeyEntry(key1, loc2)};
+
+    {
+        const std::unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        ASSERT_NOT_OK(sorted->insertKeys(opCtx.get(), entries, false));
+    }
+
+    {
+        const std::unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT(sorted->isEmpty(opCtx.get()));
+    }
+}
+
 }  // namespace mongo
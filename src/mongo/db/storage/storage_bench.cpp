@@ -0,0 +1,177 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/storage_bench.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <map>
+#include <string>
+
+#include "mongo/base/parse_number.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/stdx/chrono.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/log.h"
+
+namespace mongo {
+namespace storage_bench {
+namespace {
+
+const int kDefaultOpsPerThread = 1000;
+
+stdx::mutex resultsMutex;
+
+// Results of each benchmark by thread count.
+std::map<std::string, std::map<int, BSONObj>> results;
+
+double percentileMicros(std::vector<long long>* nanos, double percentile) {
+    if (nanos->empty())
+        return 0;
+    const size_t rank =
+        std::min(nanos->size() - 1, static_cast<size_t>(percentile * nanos->size()));
+    std::nth_element(nanos->begin(), nanos->begin() + rank, nanos->end());
+    return (*nanos)[rank] / 1000.0;
+}
+
+/**
+ * Writes every result recorded so far to the file named by MONGO_STORAGE_BENCH_OUTPUT, if any.
+ */
+void writeResults() {
+    const char* path = getenv("MONGO_STORAGE_BENCH_OUTPUT");
+    if (!path)
+        return;
+
+    BSONObjBuilder bob;
+    BSONArrayBuilder benchmarks(bob.subarrayStart("results"));
+    for (const auto& benchmark : results) {
+        BSONObjBuilder entry(benchmarks.subobjStart());
+        entry.append("name", benchmark.first);
+        double max = 0;
+        BSONObjBuilder byThreads(entry.subobjStart("results"));
+        for (const auto& threadResult : benchmark.second) {
+            byThreads.append(std::to_string(threadResult.first), threadResult.second);
+            max = std::max(max, threadResult.second["ops_per_sec"].numberDouble());
+        }
+        byThreads.done();
+        entry.append("max", max);
+    }
+    benchmarks.done();
+
+    std::ofstream out(path, std::ios::out | std::ios::trunc);
+    out << bob.obj().jsonString(Strict, true) << std::endl;
+    if (!out) {
+        warning() << "could not write storage benchmark results to " << path;
+    }
+}
+
+}  // namespace
+
+int opsPerThread() {
+    const char* ops = getenv("MONGO_STORAGE_BENCH_OPS");
+    int parsed;
+    if (ops && parseNumberFromString(ops, &parsed).isOK() && parsed > 0)
+        return parsed;
+    return kDefaultOpsPerThread;
+}
+
+std::vector<int> threadCounts(bool supportsConcurrency) {
+    if (!supportsConcurrency)
+        return {1};
+    return {1, 4, 8};
+}
+
+void run(StringData name, int numThreads, const stdx::function<void(int, int)>& op) {
+    using stdx::chrono::steady_clock;
+
+    const int numOps = opsPerThread();
+    std::vector<std::vector<long long>> latencies(numThreads);
+    std::vector<std::exception_ptr> errors(numThreads);
+
+    auto work = [&](int thread) {
+        try {
+            std::vector<long long>& nanos = latencies[thread];
+            nanos.reserve(numOps);
+            for (int i = 0; i < numOps; ++i) {
+                const steady_clock::time_point start = steady_clock::now();
+                op(thread, i);
+                nanos.push_back(stdx::chrono::duration_cast<stdx::chrono::nanoseconds>(
+                                    steady_clock::now() - start).count());
+            }
+        } catch (...) {
+            errors[thread] = std::current_exception();
+        }
+    };
+
+    const steady_clock::time_point start = steady_clock::now();
+    if (numThreads == 1) {
+        work(0);
+    } else {
+        std::vector<stdx::thread> threads;
+        for (int thread = 0; thread < numThreads; ++thread) {
+            threads.emplace_back(work, thread);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+    }
+    const double seconds =
+        stdx::chrono::duration_cast<stdx::chrono::duration<double>>(steady_clock::now() - start)
+            .count();
+
+    for (const auto& error : errors) {
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+    std::vector<long long> nanos;
+    for (const auto& threadNanos : latencies) {
+        nanos.insert(nanos.end(), threadNanos.begin(), threadNanos.end());
+    }
+
+    BSONObjBuilder result;
+    result.append("ops_per_sec", seconds > 0 ? nanos.size() / seconds : 0);
+    result.append("latency_p50_micros", percentileMicros(&nanos, 0.5));
+    result.append("latency_p99_micros", percentileMicros(&nanos, 0.99));
+    BSONObj resultObj = result.obj();
+    log() << "storage benchmark " << name << " with " << numThreads << " threads: " << resultObj;
+
+    stdx::lock_guard<stdx::mutex> lk(resultsMutex);
+    results[name.toString()][numThreads] = resultObj;
+    writeResults();
+}
+
+}  // namespace storage_bench
+}  // namespace mongo
@@ -0,0 +1,67 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/string_data.h"
+#include "mongo/stdx/functional.h"
+
+namespace mongo {
+namespace storage_bench {
+
+/**
+ * Microbenchmark support for the record store and sorted data interface test harnesses, which
+ * time their operations against every storage engine that provides a HarnessHelper.
+ *
+ * By default each benchmark runs few enough operations to double as a smoke test in the unit
+ * test runs.  For real measurements, MONGO_STORAGE_BENCH_OPS sets the number of operations per
+ * thread, and MONGO_STORAGE_BENCH_OUTPUT names a file to write the results to, in the JSON form
+ * read by buildscripts/perf_regression_check.py.
+ */
+
+/**
+ * Returns the number of operations each thread runs in a benchmark.
+ */
+int opsPerThread();
+
+/**
+ * Returns the thread counts to run a benchmark at: only 1 unless "supportsConcurrency".
+ */
+std::vector<int> threadCounts(bool supportsConcurrency);
+
+/**
+ * Calls "op" opsPerThread() times on each of "numThreads" threads, passing it the index of the
+ * thread and of the operation, and records the throughput and latency percentiles of the calls
+ * under "name".  Rethrows the first exception thrown by "op" once all threads have stopped.
+ */
+void run(StringData name, int numThreads, const stdx::function<void(int, int)>& op);
+
+}  // namespace storage_bench
+}  // namespace mongo
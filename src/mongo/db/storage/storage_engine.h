@@ -34,6 +34,7 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
 #include "mongo/bson/bsonobj.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -191,6 +192,25 @@ public:
      */
     virtual int flushAllFiles(bool sync) = 0;
 
+    /**
+     * Pins a consistent on-disk image of the data files, which remains valid while writes
+     * continue, and returns the names of the files to copy, relative to the dbpath. The files can
+     * be copied, for instance to seed a new replica set member, until endNonBlockingBackup() is
+     * called. Only one such backup can be open at a time.
+     *
+     * Returns CommandNotSupported if the storage engine cannot do this.
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* txn) {
+        return Status(ErrorCodes::CommandNotSupported,
+                      "this storage engine does not support non-blocking backups");
+    }
+
+    /**
+     * Releases the image pinned by beginNonBlockingBackup(). The copied files must not be used
+     * before this returns.
+     */
+    virtual void endNonBlockingBackup(OperationContext* txn) {}
+
     /**
      * Recover as much data as possible from a potentially corrupt RecordStore.
      * This only recovers the record data, not indexes or anything else.
@@ -243,6 +243,28 @@ Status WiredTigerIndex::insert(OperationContext* txn,
     return _insert(c, key, loc, dupsAllowed);
 }
 
+Status WiredTigerIndex::insertKeys(OperationContext* txn,
+                                   const std::vector<IndexKeyEntry>& entries,
+                                   bool dupsAllowed) {
+    WiredTigerCursor curwrap(_uri, _tableId, false, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+
+    for (const auto& entry : entries) {
+        invariant(entry.loc.isNormal());
+        dassert(!hasFieldNames(entry.key));
+
+        Status s = checkKeySize(entry.key);
+        if (!s.isOK())
+            return s;
+
+        s = _insert(c, entry.key, entry.loc, dupsAllowed);
+        if (!s.isOK())
+            return s;
+    }
+    return Status::OK();
+}
+
 void WiredTigerIndex::unindex(OperationContext* txn,
                               const BSONObj& key,
                               const RecordId& loc,
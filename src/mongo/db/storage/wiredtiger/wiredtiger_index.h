@@ -83,6 +83,10 @@ public:
                           const RecordId& loc,
                           bool dupsAllowed);
 
+    virtual Status insertKeys(OperationContext* txn,
+                              const std::vector<IndexKeyEntry>& entries,
+                              bool dupsAllowed);
+
     virtual void unindex(OperationContext* txn,
                          const BSONObj& key,
                          const RecordId& loc,
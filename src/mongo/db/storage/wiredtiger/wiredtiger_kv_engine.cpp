@@ -47,7 +47,9 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/processinfo.h"
 #include "mongo/util/scopeguard.h"
@@ -163,6 +165,11 @@ WiredTigerKVEngine::WiredTigerKVEngine(const std::string& path,
         _sizeStorer.reset(new WiredTigerSizeStorer(_conn, _sizeStorerUri));
         _sizeStorer->fillCache();
     }
+
+    _ticketController.reset(
+        new WiredTigerTicketController(_conn,
+                                       WiredTigerRecoveryUnit::getTicketHolder(false),
+                                       WiredTigerRecoveryUnit::getTicketHolder(true)));
 }
 
 
@@ -179,7 +186,9 @@ void WiredTigerKVEngine::cleanShutdown() {
     syncSizeInfo(true);
     if (_conn) {
         // these must be the last things we do before _conn->close();
+        _ticketController.reset(NULL);
         _sizeStorer.reset(NULL);
+        _backupSession.reset();
         _sessionCache->shuttingDown();
 
 #if !__has_feature(address_sanitizer)
@@ -250,6 +259,43 @@ int WiredTigerKVEngine::flushAllFiles(bool sync) {
     return 1;
 }
 
+StatusWith<std::vector<std::string>> WiredTigerKVEngine::beginNonBlockingBackup(
+    OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> lk(_backupMutex);
+    if (_backupSession) {
+        return Status(ErrorCodes::IllegalOperation, "a non-blocking backup is already in progress");
+    }
+
+    // Include the latest writes in the checkpoint the backup cursor pins.
+    flushAllFiles(true);
+
+    auto session = stdx::make_unique<WiredTigerSession>(_conn);
+    WT_SESSION* s = session->getSession();
+    WT_CURSOR* cursor = NULL;
+    int ret = s->open_cursor(s, "backup:", NULL, NULL, &cursor);
+    if (ret != 0) {
+        return wtRCToStatus(ret);
+    }
+
+    std::vector<std::string> filenames;
+    while ((ret = cursor->next(cursor)) == 0) {
+        const char* filename;
+        invariantWTOK(cursor->get_key(cursor, &filename));
+        filenames.emplace_back(filename);
+    }
+    if (ret != WT_NOTFOUND) {
+        return wtRCToStatus(ret);
+    }
+
+    _backupSession = std::move(session);
+    return filenames;
+}
+
+void WiredTigerKVEngine::endNonBlockingBackup(OperationContext* opCtx) {
+    stdx::lock_guard<stdx::mutex> lk(_backupMutex);
+    _backupSession.reset();
+}
+
 void WiredTigerKVEngine::syncSizeInfo(bool sync) const {
     if (!_sizeStorer)
         return;
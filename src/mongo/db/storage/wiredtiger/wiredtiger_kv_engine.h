@@ -46,6 +46,7 @@ namespace mongo {
 
 class WiredTigerSessionCache;
 class WiredTigerSizeStorer;
+class WiredTigerTicketController;
 
 class WiredTigerKVEngine final : public KVEngine {
 public:
@@ -96,6 +97,14 @@ public:
 
     virtual int flushAllFiles(bool sync);
 
+    /**
+     * Opens a WiredTiger backup cursor, which keeps the files of the last checkpoint from being
+     * modified or removed until endNonBlockingBackup() closes it.
+     */
+    virtual StatusWith<std::vector<std::string>> beginNonBlockingBackup(OperationContext* opCtx);
+
+    virtual void endNonBlockingBackup(OperationContext* opCtx);
+
     virtual int64_t getIdentSize(OperationContext* opCtx, StringData ident);
 
     virtual Status repairIdent(OperationContext* opCtx, StringData ident);
@@ -153,9 +162,15 @@ private:
     mutable stdx::mutex _identToDropMutex;
 
     std::unique_ptr<WiredTigerSizeStorer> _sizeStorer;
+    std::unique_ptr<WiredTigerTicketController> _ticketController;
     std::string _sizeStorerUri;
     mutable ElapsedTracker _sizeStorerSyncTracker;
 
     mutable Date_t _previousCheckedDropsQueued;
+
+    // Session holding the open backup cursor, if a non-blocking backup is in progress. Closing the
+    // session closes the cursor.
+    stdx::mutex _backupMutex;
+    std::unique_ptr<WiredTigerSession> _backupSession;
 };
 }
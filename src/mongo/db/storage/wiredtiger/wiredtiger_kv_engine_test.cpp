@@ -31,8 +31,12 @@
 
 #include "mongo/db/storage/kv/kv_engine_test_harness.h"
 
+#include <algorithm>
+
+#include "mongo/db/operation_context_noop.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/unittest/temp_dir.h"
+#include "mongo/unittest/unittest.h"
 
 namespace mongo {
 
@@ -64,4 +68,25 @@ private:
 KVHarnessHelper* KVHarnessHelper::create() {
     return new WiredTigerKVHarnessHelper();
 }
+
+TEST(WiredTigerKVEngineTest, NonBlockingBackup) {
+    WiredTigerKVHarnessHelper helper;
+    KVEngine* engine = helper.getEngine();
+
+    OperationContextNoop opCtx(engine->newRecoveryUnit());
+    ASSERT_OK(engine->createRecordStore(&opCtx, "a.b", "backupident", CollectionOptions()));
+
+    auto swFilenames = engine->beginNonBlockingBackup(&opCtx);
+    ASSERT_OK(swFilenames.getStatus());
+    const auto& filenames = swFilenames.getValue();
+    ASSERT(std::find(filenames.begin(), filenames.end(), "backupident.wt") != filenames.end());
+
+    // Only one backup can be in progress at a time.
+    ASSERT_EQUALS(ErrorCodes::IllegalOperation,
+                  engine->beginNonBlockingBackup(&opCtx).getStatus().code());
+
+    engine->endNonBlockingBackup(&opCtx);
+    ASSERT_OK(engine->beginNonBlockingBackup(&opCtx).getStatus());
+    engine->endNonBlockingBackup(&opCtx);
+}
 }
@@ -35,12 +35,17 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_record_store.h"
 
+#include <algorithm>
+#include <cmath>
+#include <deque>
 #include <wiredtiger.h>
 
 #include "mongo/base/checked_cast.h"
+#include "mongo/db/client.h"
 #include "mongo/db/concurrency/write_conflict_exception.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/storage/oplog_hack.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_customization_hooks.h"
@@ -50,13 +55,18 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_size_storer.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/fail_point.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
+#include "mongo/util/progress_meter.h"
 #include "mongo/util/scopeguard.h"
 #include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
 
 //#define RS_ITERATOR_TRACE(x) log() << "WTRS::Iterator " << x
 #define RS_ITERATOR_TRACE(x)
@@ -89,8 +99,206 @@ bool shouldUseOplogHack(OperationContext* opCtx, const std::string& uri) {
 
 MONGO_FP_DECLARE(WTWriteConflictException);
 
+// compact() runs WiredTiger's compaction in rounds of about this many seconds, between which it
+// reports progress and checks for interruption.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCompactRoundSeconds, int, 1);
+
+// compact() sleeps between rounds to write no more than this many megabytes a second on average.
+// A value of zero does not throttle compaction.
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerCompactMaxWriteMBPerSecond, int, 0);
+
 const std::string kWiredTigerEngineName = "wiredTiger";
 
+namespace {
+
+/**
+ * Reads the records of a table ahead of a forward cursor on a thread of its own, so that a scan
+ * of data which is not in the cache waits on the disk while the records it already has are being
+ * processed. The records read ahead are discarded; reading them brings their pages into the cache,
+ * where the cursor then finds them.
+ *
+ * The reader only uses WiredTiger while the cursor is restored, since the connection may be closed
+ * once the operation using the cursor has released its locks.
+ */
+class ReadAhead {
+    MONGO_DISALLOW_COPYING(ReadAhead);
+
+public:
+    static const int kMaxTimesOvertaken = 16;
+
+    ReadAhead(WiredTigerSessionCache* sessionCache,
+              const std::string& uri,
+              uint64_t tableId,
+              const RecordId& start,
+              int64_t maxBytesAhead)
+        : _sessionCache(sessionCache),
+          _uri(uri),
+          _tableId(tableId),
+          _maxBytesAhead(maxBytesAhead),
+          _readTo(start),
+          _consumedTo(start.repr()) {
+        _thread = stdx::thread([this] { _run(); });
+    }
+
+    ~ReadAhead() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _stopped.store(true);
+        }
+        _condvar.notify_all();
+        _thread.join();
+    }
+
+    /**
+     * Called by the cursor for each record it returns.
+     */
+    void consumed(const RecordId& id, int64_t bytes) {
+        _consumedTo.store(id.repr());
+        const int64_t bytesConsumed = _bytesConsumed.addAndFetch(bytes);
+        if (_readerWaiting.load() && _bytesRead.load() - bytesConsumed <= _maxBytesAhead / 2) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _condvar.notify_all();
+        }
+    }
+
+    /**
+     * Called when the cursor is saved. Returns once the reader has stopped using WiredTiger.
+     */
+    void pause() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        _attached.store(false);
+        _condvar.notify_all();
+        _condvar.wait(lk, [this] { return !_reading; });
+    }
+
+    /**
+     * Called when the cursor is restored.
+     */
+    void resume() {
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _attached.store(true);
+        }
+        _condvar.notify_all();
+    }
+
+private:
+    bool _windowFull(int64_t maxBytesAhead) const {
+        return _bytesRead.load() - _bytesConsumed.load() >= maxBytesAhead;
+    }
+
+    void _run() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_stopped.load()) {
+            if (_exhausted || !_attached.load()) {
+                _condvar.wait(lk);
+                continue;
+            }
+
+            if (_windowFull(_maxBytesAhead)) {
+                // Wait for the cursor to catch up half way, so that the reader does not wake up
+                // for every record.
+                _readerWaiting.store(true);
+                _condvar.wait(lk, [this] {
+                    return _stopped.load() || !_attached.load() ||
+                        !_windowFull(_maxBytesAhead - _maxBytesAhead / 2);
+                });
+                _readerWaiting.store(false);
+                continue;
+            }
+
+            _reading = true;
+            lk.unlock();
+            _readUntilFull();
+            lk.lock();
+            _reading = false;
+            _condvar.notify_all();
+        }
+    }
+
+    /**
+     * Reads ahead until the window is full, the cursor is saved, or the cursor has overtaken the
+     * reader.
+     */
+    void _readUntilFull() {
+        WiredTigerSession* session = _sessionCache->getSession();
+        WT_CURSOR* c = session->getCursor(_uri, _tableId, true);
+        ON_BLOCK_EXIT([&] {
+            session->releaseCursor(_tableId, c);
+            _sessionCache->releaseSession(session);
+        });
+
+        // Start from wherever is further along, since there is no point reading records the
+        // cursor has already returned. A cursor which keeps overtaking the reader is scanning
+        // records that are in the cache already, so the reader gives up.
+        const RecordId consumedTo(_consumedTo.load());
+        if (_readTo < consumedTo) {
+            if (++_timesOvertaken > kMaxTimesOvertaken) {
+                _exhausted = true;
+                return;
+            }
+            _readTo = consumedTo;
+            _bytesRead.store(_bytesConsumed.load());
+        }
+
+        int ret;
+        if (_readTo.isNull()) {
+            ret = c->next(c);
+        } else {
+            int cmp;
+            c->set_key(c, _readTo.repr());
+            ret = c->search_near(c, &cmp);
+            if (ret == 0 && cmp <= 0)
+                ret = c->next(c);
+        }
+
+        while (ret == 0) {
+            int64_t key;
+            WT_ITEM value;
+            if ((ret = c->get_key(c, &key)) != 0 || (ret = c->get_value(c, &value)) != 0)
+                break;
+
+            _readTo = RecordId(key);
+            _bytesRead.store(_bytesRead.load() + static_cast<int64_t>(value.size));
+
+            if (_stopped.load() || !_attached.load() || _windowFull(_maxBytesAhead) ||
+                _readTo.repr() < _consumedTo.load()) {
+                return;
+            }
+            ret = c->next(c);
+        }
+
+        // Either the end of the table, or an error which the cursor will report itself if it
+        // runs into it too. In both cases there is nothing more to read ahead.
+        _exhausted = true;
+    }
+
+    WiredTigerSessionCache* const _sessionCache;
+    const std::string _uri;
+    const uint64_t _tableId;
+    const int64_t _maxBytesAhead;
+
+    // Only used by the reader thread.
+    RecordId _readTo;
+    int _timesOvertaken = 0;
+    bool _exhausted = false;
+
+    AtomicInt64 _consumedTo;
+    AtomicInt64 _bytesConsumed;
+    AtomicInt64 _bytesRead;
+    AtomicWord<bool> _attached{true};
+    AtomicWord<bool> _stopped{false};
+    AtomicWord<bool> _readerWaiting{false};
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    bool _reading = false;  // Guarded by _mutex.
+
+    stdx::thread _thread;
+};
+
+}  // namespace
+
 class WiredTigerRecordStore::Cursor final : public SeekableRecordCursor {
 public:
     Cursor(OperationContext* txn, const WiredTigerRecordStore& rs, bool forward = true)
@@ -156,6 +364,8 @@ public:
         invariantWTOK(c->get_value(c, &value));
 
         _lastReturnedId = id;
+        if (_readAhead)
+            _readAhead->consumed(id, value.size);
         return {{id, {static_cast<const char*>(value.data), static_cast<int>(value.size)}}};
     }
 
@@ -179,6 +389,9 @@ public:
     }
 
     void save() final {
+        if (_readAhead)
+            _readAhead->pause();
+
         try {
             if (_cursor)
                 _cursor->reset();
@@ -191,6 +404,7 @@ public:
     void saveUnpositioned() final {
         save();
         _lastReturnedId = RecordId();
+        _readAhead.reset();
     }
 
     bool restore() final {
@@ -200,6 +414,9 @@ public:
         // This will ensure an active session exists, so any restored cursors will bind to it
         invariant(WiredTigerRecoveryUnit::get(_txn)->getSession(_txn) == _cursor->getSession());
 
+        if (_readAhead)
+            _readAhead->resume();
+
         // If we've hit EOF, then this iterator is done and need not be restored.
         if (_eof)
             return true;
@@ -254,6 +471,19 @@ public:
         // _cursor recreated in restore() to avoid risk of WT_ROLLBACK issues.
     }
 
+    void enableReadAhead(int64_t maxBytesAhead) final {
+        // Capped collections are left alone, since their cursors stop at hidden records. Reading
+        // ahead of a scan over a small collection costs more in starting a thread than it saves.
+        if (_readAhead || !_forward || _rs._isCapped || maxBytesAhead <= 0 ||
+            _rs.dataSize(_txn) < 4 * maxBytesAhead) {
+            return;
+        }
+
+        WiredTigerSessionCache* sessionCache = WiredTigerRecoveryUnit::get(_txn)->getSessionCache();
+        _readAhead = stdx::make_unique<ReadAhead>(
+            sessionCache, _rs.getURI(), _rs.tableId(), _lastReturnedId, maxBytesAhead);
+    }
+
 private:
     bool isVisible(const RecordId& id) {
         if (!_rs._isCapped)
@@ -280,6 +510,7 @@ private:
     bool _eof = false;
     RecordId _lastReturnedId;  // If null, need to seek to first/last record.
     const RecordId _readUntilForOplog;
+    std::unique_ptr<ReadAhead> _readAhead;
 };
 
 StatusWith<std::string> WiredTigerRecordStore::parseOptionsField(const BSONObj options) {
@@ -368,6 +599,289 @@ private:
     OperationContext* _txn;
 };
 
+/**
+ * Divides the oplog into "stones": runs of consecutive records, in insertion order, that together
+ * hold at least '_minBytesPerStone' bytes. Each stone remembers only its record count, its size
+ * and its last RecordId, so that once there are more stones than the oplog needs to keep, the
+ * oldest one can be reclaimed with a single range truncate instead of having the inserters find
+ * and delete the oldest records a few at a time.
+ *
+ * The stones are tracked only in memory, and are recomputed when the oplog is opened.
+ */
+class WiredTigerRecordStore::OplogStones {
+public:
+    struct Stone {
+        int64_t records;      // Approximate number of records in the stone.
+        int64_t bytes;        // Approximate size of the records in the stone.
+        RecordId lastRecord;  // RecordId of the last record in the stone.
+    };
+
+    OplogStones(OperationContext* txn, WiredTigerRecordStore* rs) : _rs(rs) {
+        invariant(rs->isCapped());
+        invariant(rs->cappedMaxSize() > 0);
+
+        // Keep between 10 and 100 stones, and make them no smaller than the largest document,
+        // so that a single insert rarely fills more than one.
+        const int64_t kMinStonesToKeep = 10;
+        const int64_t kMaxStonesToKeep = 100;
+        const int64_t maxSize = rs->cappedMaxSize();
+        const int64_t numStones = maxSize / BSONObjMaxInternalSize;
+        _numStonesToKeep = std::min(kMaxStonesToKeep, std::max(kMinStonesToKeep, numStones));
+        _minBytesPerStone = maxSize / _numStonesToKeep;
+        invariant(_minBytesPerStone > 0);
+
+        _calculateStones(txn);
+    }
+
+    bool hasExcessStones() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _hasExcessStones_inlock();
+    }
+
+    /**
+     * Returns the oldest stone if there are more stones than the oplog needs to keep.
+     */
+    boost::optional<Stone> peekOldestStoneIfNeeded() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        if (!_hasExcessStones_inlock()) {
+            return boost::none;
+        }
+        return _stones.front();
+    }
+
+    void popOldestStone() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        invariant(!_stones.empty());
+        _stones.pop_front();
+    }
+
+    /**
+     * Accounts for an inserted record once the unit of work inserting it commits.
+     */
+    void updateCurrentStoneAfterInsertOnCommit(OperationContext* txn,
+                                               int64_t bytesInserted,
+                                               const RecordId& highestInserted);
+
+    /**
+     * Forgets all of the stones once the unit of work emptying the oplog commits.
+     */
+    void clearStonesOnCommit(OperationContext* txn);
+
+    /**
+     * Drops the stones which ended at or after 'firstRemovedId', and takes the records which were
+     * removed out of the stone currently being filled.
+     */
+    void updateStonesAfterCappedTruncateAfter(int64_t recordsRemoved,
+                                              int64_t bytesRemoved,
+                                              const RecordId& firstRemovedId) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+        int64_t recordsInLostStones = 0;
+        int64_t bytesInLostStones = 0;
+        while (!_stones.empty() && _stones.back().lastRecord >= firstRemovedId) {
+            recordsInLostStones += _stones.back().records;
+            bytesInLostStones += _stones.back().bytes;
+            _stones.pop_back();
+        }
+
+        // The records of the dropped stones which were not removed now belong to the stone
+        // currently being filled.
+        _currentRecords.addAndFetch(recordsInLostStones - recordsRemoved);
+        _currentBytes.addAndFetch(bytesInLostStones - bytesRemoved);
+    }
+
+    size_t numStones() const {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        return _stones.size();
+    }
+
+    // Where the next truncate starts from, so that it does not have to walk over the records
+    // removed by earlier ones. Only accessed while holding the capped deleter mutex.
+    RecordId firstRecord;
+
+private:
+    class InsertChange;
+    class TruncateChange;
+
+    bool _hasExcessStones_inlock() const {
+        return _stones.size() > static_cast<size_t>(_numStonesToKeep);
+    }
+
+    void _calculateStones(OperationContext* txn) {
+        const int64_t numRecords = _rs->numRecords(txn);
+        const int64_t dataSize = _rs->dataSize(txn);
+
+        LOG(1) << "The size storer reports that the oplog contains " << numRecords
+               << " records totaling to " << dataSize << " bytes";
+
+        // Only sample the oplog when it has enough records for the sample to be representative,
+        // since a random cursor may return the same record more than once.
+        if (numRecords <= 0 || dataSize <= 0 ||
+            uint64_t(numRecords) < kMinSampleRatio * kRandomSamplesPerStone * _numStonesToKeep) {
+            _calculateStonesByScanning(txn);
+            return;
+        }
+
+        _calculateStonesBySampling(txn, numRecords, dataSize);
+    }
+
+    void _calculateStonesByScanning(OperationContext* txn) {
+        log() << "Scanning the oplog to determine where to place markers for truncation";
+
+        int64_t currentRecords = 0;
+        int64_t currentBytes = 0;
+
+        Cursor cursor(txn, *_rs, /*forward=*/true);
+        while (auto record = cursor.next()) {
+            currentRecords++;
+            currentBytes += record->data.size();
+            if (currentBytes >= _minBytesPerStone) {
+                LOG(1) << "Placing a marker at optime " << Timestamp(record->id.repr()).toString();
+                _stones.push_back({currentRecords, currentBytes, record->id});
+
+                currentRecords = 0;
+                currentBytes = 0;
+            }
+        }
+
+        _currentRecords.store(currentRecords);
+        _currentBytes.store(currentBytes);
+    }
+
+    void _calculateStonesBySampling(OperationContext* txn, int64_t numRecords, int64_t dataSize) {
+        log() << "Sampling the oplog to determine where to place markers for truncation";
+
+        // Use the oplog's average record size to estimate the number of records in each stone,
+        // and thus the number of samples to take.
+        const double avgRecordSize = double(dataSize) / numRecords;
+        const int64_t estRecordsPerStone =
+            std::max(int64_t(1), int64_t(std::ceil(_minBytesPerStone / avgRecordSize)));
+        const int64_t estBytesPerStone = estRecordsPerStone * avgRecordSize;
+        const uint64_t numSamples = kRandomSamplesPerStone * numRecords / estRecordsPerStone;
+
+        std::vector<RecordId> samples;
+        samples.reserve(numSamples);
+
+        RandomCursor cursor(txn, *_rs);
+        for (uint64_t i = 0; i < numSamples; ++i) {
+            auto record = cursor.next();
+            if (!record) {
+                // The size storer's counts were stale, so scan the oplog instead.
+                _calculateStonesByScanning(txn);
+                return;
+            }
+            samples.push_back(record->id);
+        }
+        std::sort(samples.begin(), samples.end());
+
+        // Every 'kRandomSamplesPerStone'th sample approximates the end of a stone.
+        for (size_t i = kRandomSamplesPerStone - 1; i < samples.size();
+             i += kRandomSamplesPerStone) {
+            const RecordId& lastRecord = samples[i];
+            LOG(1) << "Placing a marker at optime " << Timestamp(lastRecord.repr()).toString();
+            _stones.push_back({estRecordsPerStone, estBytesPerStone, lastRecord});
+        }
+
+        // The remainder is the stone currently being filled.
+        const int64_t numStones = _stones.size();
+        _currentRecords.store(std::max(int64_t(0), numRecords - estRecordsPerStone * numStones));
+        _currentBytes.store(std::max(int64_t(0), dataSize - estBytesPerStone * numStones));
+    }
+
+    /**
+     * Adds the records inserted since the last stone as a new stone, if they hold enough bytes.
+     */
+    void _createNewStoneIfNeeded(const RecordId& lastRecord) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex, stdx::try_to_lock);
+        if (!lk) {
+            // Someone else is already creating a stone, so the next insert will check again.
+            return;
+        }
+
+        if (_currentBytes.load() < _minBytesPerStone) {
+            // Another thread created the stone while we were waiting.
+            return;
+        }
+
+        if (!_stones.empty() && lastRecord <= _stones.back().lastRecord) {
+            // Inserts can commit out of order, and a stone has to end after the previous one.
+            return;
+        }
+
+        _stones.push_back({_currentRecords.swap(0), _currentBytes.swap(0), lastRecord});
+    }
+
+    // How many records to sample for each stone when computing the stones from a random cursor,
+    // and how many more records than samples the oplog must have for sampling to be used at all.
+    static const uint64_t kRandomSamplesPerStone = 10;
+    static const uint64_t kMinSampleRatio = 4;
+
+    WiredTigerRecordStore* _rs;  // not owned
+
+    int64_t _numStonesToKeep;
+    int64_t _minBytesPerStone;
+
+    // Protects '_stones'.
+    mutable stdx::mutex _mutex;
+
+    // Oldest stone first.
+    std::deque<Stone> _stones;
+
+    // The records inserted since the newest stone was created.
+    AtomicInt64 _currentRecords;
+    AtomicInt64 _currentBytes;
+};
+
+class WiredTigerRecordStore::OplogStones::InsertChange final : public RecoveryUnit::Change {
+public:
+    InsertChange(OplogStones* oplogStones, int64_t bytesInserted, const RecordId& highestInserted)
+        : _oplogStones(oplogStones),
+          _bytesInserted(bytesInserted),
+          _highestInserted(highestInserted) {}
+
+    void commit() final {
+        _oplogStones->_currentRecords.addAndFetch(1);
+        int64_t newCurrentBytes = _oplogStones->_currentBytes.addAndFetch(_bytesInserted);
+        if (newCurrentBytes >= _oplogStones->_minBytesPerStone) {
+            _oplogStones->_createNewStoneIfNeeded(_highestInserted);
+        }
+    }
+
+    void rollback() final {}
+
+private:
+    OplogStones* _oplogStones;
+    int64_t _bytesInserted;
+    RecordId _highestInserted;
+};
+
+class WiredTigerRecordStore::OplogStones::TruncateChange final : public RecoveryUnit::Change {
+public:
+    TruncateChange(OplogStones* oplogStones) : _oplogStones(oplogStones) {}
+
+    void commit() final {
+        _oplogStones->_currentRecords.store(0);
+        _oplogStones->_currentBytes.store(0);
+
+        stdx::lock_guard<stdx::mutex> lk(_oplogStones->_mutex);
+        _oplogStones->_stones.clear();
+    }
+
+    void rollback() final {}
+
+private:
+    OplogStones* _oplogStones;
+};
+
+void WiredTigerRecordStore::OplogStones::updateCurrentStoneAfterInsertOnCommit(
+    OperationContext* txn, int64_t bytesInserted, const RecordId& highestInserted) {
+    txn->recoveryUnit()->registerChange(new InsertChange(this, bytesInserted, highestInserted));
+}
+
+void WiredTigerRecordStore::OplogStones::clearStonesOnCommit(OperationContext* txn) {
+    txn->recoveryUnit()->registerChange(new TruncateChange(this));
+}
+
 
 // static
 StatusWith<std::string> WiredTigerRecordStore::generateCreateString(
@@ -465,7 +979,7 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
     Cursor cursor(ctx, *this, /*forward=*/false);
     if (auto record = cursor.next()) {
         int64_t max = _makeKey(record->id);
-        _oplog_highestSeen = record->id;
+        _oplog_highestSeen.store(max);
         _nextIdNum.store(1 + max);
 
         if (_sizeStorer) {
@@ -496,6 +1010,10 @@ WiredTigerRecordStore::WiredTigerRecordStore(OperationContext* ctx,
     }
 
     _hasBackgroundThread = WiredTigerKVEngine::initRsOplogBackgroundThread(ns);
+
+    if (_isOplog && _isCapped) {
+        _oplogStones = std::make_shared<OplogStones>(ctx, this);
+    }
 }
 
 WiredTigerRecordStore::~WiredTigerRecordStore() {
@@ -640,6 +1158,19 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* txn,
     // This variable isn't thread safe, but has loose semantics anyway.
     dassert(!_isOplog || _cappedMaxDocs == -1);
 
+    if (_oplogStones) {
+        // The oplog is reclaimed a whole stone at a time, by the background thread if there is
+        // one, so inserts never have to wait for it.
+        if (_hasBackgroundThread || !_oplogStones->hasExcessStones())
+            return 0;
+
+        boost::unique_lock<boost::timed_mutex> lock(_cappedDeleterMutex,  // NOLINT
+                                                    boost::try_to_lock);
+        if (!lock.owns_lock())
+            return 0;  // Someone else is already reclaiming.
+        return _reclaimOplog_inlock(txn);
+    }
+
     if (!cappedAndNeedDelete())
         return 0;
 
@@ -698,6 +1229,10 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded(OperationContext* txn,
 
 int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* txn,
                                                            const RecordId& justInserted) {
+    if (_oplogStones) {
+        return _reclaimOplog_inlock(txn);
+    }
+
     // we do this is a side transaction in case it aborts
     WiredTigerRecoveryUnit* realRecoveryUnit =
         checked_cast<WiredTigerRecoveryUnit*>(txn->releaseRecoveryUnit());
@@ -797,6 +1332,72 @@ int64_t WiredTigerRecordStore::cappedDeleteAsNeeded_inlock(OperationContext* txn
     return docsRemoved;
 }
 
+int64_t WiredTigerRecordStore::_reclaimOplog_inlock(OperationContext* txn) {
+    // Like cappedDeleteAsNeeded_inlock(), truncate in a side transaction in case it aborts.
+    WiredTigerRecoveryUnit* realRecoveryUnit =
+        checked_cast<WiredTigerRecoveryUnit*>(txn->releaseRecoveryUnit());
+    invariant(realRecoveryUnit);
+    WiredTigerSessionCache* sc = realRecoveryUnit->getSessionCache();
+    OperationContext::RecoveryUnitState const realRUstate =
+        txn->setRecoveryUnit(new WiredTigerRecoveryUnit(sc), OperationContext::kNotInUnitOfWork);
+
+    WiredTigerRecoveryUnit::get(txn)->markNoTicketRequired();  // realRecoveryUnit already has
+    WT_SESSION* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn)->getSession();
+
+    // The oplog has no indexes and is only read through cursors, which the storage engine keeps
+    // valid across deletes, so the records are removed without calling the capped delete
+    // callback on each of them.
+    int64_t docsRemoved = 0;
+    try {
+        while (auto stone = _oplogStones->peekOldestStoneIfNeeded()) {
+            if (_shuttingDown)
+                break;
+
+            LOG(1) << "Truncating the oplog between " << _oplogStones->firstRecord << " and "
+                   << stone->lastRecord << " to remove approximately " << stone->records
+                   << " records totaling to " << stone->bytes << " bytes";
+
+            WriteUnitOfWork wuow(txn);
+
+            WiredTigerCursor startWrap(_uri, _tableId, true, txn);
+            WT_CURSOR* start = startWrap.get();
+            start->set_key(start, _makeKey(_oplogStones->firstRecord));
+
+            WiredTigerCursor endWrap(_uri, _tableId, true, txn);
+            WT_CURSOR* end = endWrap.get();
+            end->set_key(end, _makeKey(stone->lastRecord));
+
+            int ret = WT_OP_CHECK(session->truncate(session, NULL, start, end, NULL));
+            if (ret == WT_ROLLBACK) {
+                throw WriteConflictException();
+            }
+            invariantWTOK(ret);
+
+            _changeNumRecords(txn, -stone->records);
+            _increaseDataSize(txn, -stone->bytes);
+            wuow.commit();
+
+            // Remove the stone only once its records are gone, so a failed truncate is retried.
+            _oplogStones->popOldestStone();
+            _oplogStones->firstRecord = stone->lastRecord;
+            docsRemoved += stone->records;
+        }
+    } catch (const WriteConflictException& wce) {
+        delete txn->releaseRecoveryUnit();
+        txn->setRecoveryUnit(realRecoveryUnit, realRUstate);
+        log() << "got conflict truncating the oplog, will retry later";
+        return docsRemoved;
+    } catch (...) {
+        delete txn->releaseRecoveryUnit();
+        txn->setRecoveryUnit(realRecoveryUnit, realRUstate);
+        throw;
+    }
+
+    delete txn->releaseRecoveryUnit();
+    txn->setRecoveryUnit(realRecoveryUnit, realRUstate);
+    return docsRemoved;
+}
+
 StatusWith<RecordId> WiredTigerRecordStore::extractAndCheckLocForOplog(const char* data, int len) {
     return oploghack::extractKey(data, len);
 }
@@ -815,12 +1416,7 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* txn,
         if (!status.isOK())
             return status;
         loc = status.getValue();
-        if (loc > _oplog_highestSeen) {
-            stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
-            if (loc > _oplog_highestSeen) {
-                _oplog_highestSeen = loc;
-            }
-        }
+        _raiseOplogHighestSeen(loc);
     } else if (_isCapped) {
         stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
         loc = _nextId();
@@ -845,13 +1441,68 @@ StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* txn,
     _changeNumRecords(txn, 1);
     _increaseDataSize(txn, len);
 
+    if (_oplogStones) {
+        _oplogStones->updateCurrentStoneAfterInsertOnCommit(txn, len, loc);
+    }
+
     cappedDeleteAsNeeded(txn, loc);
 
     return StatusWith<RecordId>(loc);
 }
 
+Status WiredTigerRecordStore::insertRecords(OperationContext* txn,
+                                            std::vector<Record>* records,
+                                            bool enforceQuota) {
+    // The oplog derives its RecordIds from the documents, and capped collections have to track
+    // every uncommitted RecordId and may delete as they go, so both insert one at a time.
+    if (_useOplogHack || _isCapped) {
+        return RecordStore::insertRecords(txn, records, enforceQuota);
+    }
+
+    if (records->empty()) {
+        return Status::OK();
+    }
+
+    // Reserve the RecordIds for the whole batch at once.
+    const int64_t firstId = _nextIdNum.fetchAndAdd(records->size());
+
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+
+    int64_t totalLength = 0;
+    for (size_t i = 0; i < records->size(); i++) {
+        Record& record = (*records)[i];
+        const RecordId loc(firstId + i);
+        invariant(loc.isNormal());
+
+        c->set_key(c, _makeKey(loc));
+        WiredTigerItem value(record.data.data(), record.data.size());
+        c->set_value(c, value.Get());
+        int ret = WT_OP_CHECK(c->insert(c));
+        if (ret) {
+            return wtRCToStatus(ret, "WiredTigerRecordStore::insertRecords");
+        }
+
+        record.id = loc;
+        totalLength += record.data.size();
+    }
+
+    _changeNumRecords(txn, records->size());
+    _increaseDataSize(txn, totalLength);
+    return Status::OK();
+}
+
 void WiredTigerRecordStore::dealtWithCappedLoc(const RecordId& loc) {
     stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
+    if (!_uncommittedDiskLocs.empty() && _uncommittedDiskLocs.front() == loc) {
+        // The common case: inserts mostly commit in the order they registered their RecordIds.
+        _uncommittedDiskLocs.pop_front();
+        _lowestUncommittedDiskLoc.store(
+            _uncommittedDiskLocs.empty() ? 0 : _makeKey(_uncommittedDiskLocs.front()));
+        return;
+    }
     SortedDiskLocs::iterator it =
         std::find(_uncommittedDiskLocs.begin(), _uncommittedDiskLocs.end(), loc);
     invariant(it != _uncommittedDiskLocs.end());
@@ -859,16 +1510,13 @@ void WiredTigerRecordStore::dealtWithCappedLoc(const RecordId& loc) {
 }
 
 bool WiredTigerRecordStore::isCappedHidden(const RecordId& loc) const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
-    if (_uncommittedDiskLocs.empty()) {
-        return false;
-    }
-    return _uncommittedDiskLocs.front() <= loc;
+    const int64_t lowest = _lowestUncommittedDiskLoc.load();
+    return lowest != 0 && lowest <= _makeKey(loc);
 }
 
 RecordId WiredTigerRecordStore::lowestCappedHiddenRecord() const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
-    return _uncommittedDiskLocs.empty() ? RecordId() : _uncommittedDiskLocs.front();
+    const int64_t lowest = _lowestUncommittedDiskLoc.load();
+    return lowest == 0 ? RecordId() : _fromKey(lowest);
 }
 
 StatusWith<RecordId> WiredTigerRecordStore::insertRecord(OperationContext* txn,
@@ -916,7 +1564,7 @@ StatusWith<RecordId> WiredTigerRecordStore::updateRecord(OperationContext* txn,
 }
 
 bool WiredTigerRecordStore::updateWithDamagesSupported() const {
-    return false;
+    return true;
 }
 
 StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
@@ -925,16 +1573,46 @@ StatusWith<RecordData> WiredTigerRecordStore::updateWithDamages(
     const RecordData& oldRec,
     const char* damageSource,
     const mutablebson::DamageVector& damages) {
-    MONGO_UNREACHABLE;
+    WiredTigerCursor curwrap(_uri, _tableId, true, txn);
+    curwrap.assertInActiveTxn();
+    WT_CURSOR* c = curwrap.get();
+    invariant(c);
+    c->set_key(c, _makeKey(loc));
+    int ret = WT_OP_CHECK(c->search(c));
+    invariantWTOK(ret);
+
+    WT_ITEM old_value;
+    ret = c->get_value(c, &old_value);
+    invariantWTOK(ret);
+
+    // WiredTiger has no way to store part of a value, so the damages are applied to a copy of
+    // the record which then replaces it.  This still spares the caller from rebuilding the
+    // whole document out of its mutable form.
+    const int len = old_value.size;
+    auto buffer = SharedBuffer::allocate(len);
+    memcpy(buffer.get(), old_value.data, len);
+
+    char* root = buffer.get();
+    for (const auto& damage : damages) {
+        invariant(damage.targetOffset + damage.size <= static_cast<size_t>(len));
+        memcpy(root + damage.targetOffset, damageSource + damage.sourceOffset, damage.size);
+    }
+
+    c->set_key(c, _makeKey(loc));
+    WiredTigerItem value(root, len);
+    c->set_value(c, value.Get());
+    ret = WT_OP_CHECK(c->insert(c));
+    invariantWTOK(ret);
+
+    return RecordData(std::move(buffer), len);
 }
 
 void WiredTigerRecordStore::_oplogSetStartHack(WiredTigerRecoveryUnit* wru) const {
-    stdx::lock_guard<stdx::mutex> lk(_uncommittedDiskLocsMutex);
-    if (_uncommittedDiskLocs.empty()) {
-        wru->setOplogReadTill(_oplog_highestSeen);
-    } else {
-        wru->setOplogReadTill(_uncommittedDiskLocs.front());
-    }
+    // Read the highest RecordId before the lowest uncommitted one. If nothing is uncommitted
+    // then, every RecordId up to the highest one read first has committed.
+    const int64_t highestSeen = _oplog_highestSeen.load();
+    const int64_t lowest = _lowestUncommittedDiskLoc.load();
+    wru->setOplogReadTill(_fromKey(lowest == 0 ? highestSeen : lowest));
 }
 
 std::unique_ptr<SeekableRecordCursor> WiredTigerRecordStore::getCursor(OperationContext* txn,
@@ -976,6 +1654,10 @@ Status WiredTigerRecordStore::truncate(OperationContext* txn) {
     _changeNumRecords(txn, -numRecords(txn));
     _increaseDataSize(txn, -dataSize(txn));
 
+    if (_oplogStones) {
+        _oplogStones->clearStonesOnCommit(txn);
+    }
+
     return Status::OK();
 }
 
@@ -985,10 +1667,61 @@ Status WiredTigerRecordStore::compact(OperationContext* txn,
                                       CompactStats* stats) {
     WiredTigerSessionCache* cache = WiredTigerRecoveryUnit::get(txn)->getSessionCache();
     WiredTigerSession* session = cache->getSession();
+    ON_BLOCK_EXIT([&] { cache->releaseSession(session); });
     WT_SESSION* s = session->getSession();
-    int ret = s->compact(s, getURI().c_str(), "timeout=0");
-    invariantWTOK(ret);
-    cache->releaseSession(session);
+
+    // Statistics may be disabled, in which case compaction reports no progress and is not
+    // throttled.
+    const auto getStat = [&](int key) -> int64_t {
+        auto result = WiredTigerUtil::getStatisticsValueAs<int64_t>(
+            s, "statistics:" + getURI(), "statistics=(fast)", key);
+        return result.isOK() ? result.getValue() : 0;
+    };
+
+    const int64_t startSize = getStat(WT_STAT_DSRC_BLOCK_SIZE);
+    const int64_t reusableMB = getStat(WT_STAT_DSRC_BLOCK_REUSE_BYTES) >> 20;
+    stdx::unique_lock<Client> lk(*txn->getClient());
+    ProgressMeterHolder progress(
+        *txn->setMessage_inlock("compact", "Compact Progress (MB reclaimed)", reusableMB));
+    lk.unlock();
+
+    // WiredTiger compacts a file a region at a time between checkpoints of it, while it is being
+    // read and written. Run it in rounds of bounded length, so that between them compaction can
+    // report its progress, be interrupted, and sleep to keep within its write budget.
+    const std::string config = str::stream() << "timeout="
+                                             << std::max(1, wiredTigerCompactRoundSeconds);
+    int64_t reclaimedMB = 0;
+    while (true) {
+        const int64_t bytesWritten = getStat(WT_STAT_DSRC_CACHE_BYTES_WRITE);
+        Timer timer;
+        const int ret = s->compact(s, getURI().c_str(), config.c_str());
+        if (ret != 0 && ret != ETIMEDOUT)
+            return wtRCToStatus(ret);
+
+        const int64_t nowReclaimedMB = (startSize - getStat(WT_STAT_DSRC_BLOCK_SIZE)) >> 20;
+        if (nowReclaimedMB > reclaimedMB) {
+            progress.hit(static_cast<int>(nowReclaimedMB - reclaimedMB));
+            reclaimedMB = nowReclaimedMB;
+        }
+
+        // Anything other than a timeout means there is nothing more to move.
+        if (ret == 0)
+            break;
+
+        txn->checkForInterrupt();
+
+        const int64_t maxBytesPerSecond = int64_t(wiredTigerCompactMaxWriteMBPerSecond) << 20;
+        if (maxBytesPerSecond > 0) {
+            const int64_t roundMillis = (getStat(WT_STAT_DSRC_CACHE_BYTES_WRITE) - bytesWritten) *
+                1000 / maxBytesPerSecond;
+            for (int64_t slept = timer.millis(); slept < roundMillis; slept += 100) {
+                sleepmillis(std::min(roundMillis - slept, int64_t(100)));
+                txn->checkForInterrupt();
+            }
+        }
+    }
+
+    progress.finished();
     return Status::OK();
 }
 
@@ -1073,6 +1806,9 @@ void WiredTigerRecordStore::appendCustomStats(OperationContext* txn,
         result->appendIntOrLL("sleepCount", _cappedSleep.load());
         result->appendIntOrLL("sleepMS", _cappedSleepMS.load());
     }
+    if (_oplogStones) {
+        result->appendIntOrLL("numOplogStones", static_cast<long long>(_oplogStones->numStones()));
+    }
     WiredTigerSession* session = WiredTigerRecoveryUnit::get(txn)->getSession(txn);
     WT_SESSION* s = session->getSession();
     BSONObjBuilder bob(result->subobjStart(kWiredTigerEngineName));
@@ -1142,8 +1878,23 @@ void WiredTigerRecordStore::_addUncommitedDiskLoc_inlock(OperationContext* txn,
     // todo: make this a dassert at some point
     invariant(_uncommittedDiskLocs.empty() || _uncommittedDiskLocs.back() < loc);
     _uncommittedDiskLocs.push_back(loc);
+    if (_uncommittedDiskLocs.size() == 1) {
+        _lowestUncommittedDiskLoc.store(_makeKey(loc));
+    }
     txn->recoveryUnit()->registerChange(new CappedInsertChange(this, loc));
-    _oplog_highestSeen = loc;
+    _raiseOplogHighestSeen(loc);
+}
+
+void WiredTigerRecordStore::_raiseOplogHighestSeen(const RecordId& loc) {
+    const int64_t key = _makeKey(loc);
+    int64_t seen = _oplog_highestSeen.load();
+    while (key > seen) {
+        const int64_t previous = _oplog_highestSeen.compareAndSwap(seen, key);
+        if (previous == seen) {
+            return;
+        }
+        seen = previous;
+    }
 }
 
 boost::optional<RecordId> WiredTigerRecordStore::oplogStartHack(
@@ -1249,14 +2000,26 @@ void WiredTigerRecordStore::temp_cappedTruncateAfter(OperationContext* txn,
                                                      bool inclusive) {
     WriteUnitOfWork wuow(txn);
     Cursor cursor(txn, *this);
+    RecordId firstRemovedId;
+    int64_t recordsRemoved = 0;
+    int64_t bytesRemoved = 0;
     while (auto record = cursor.next()) {
         RecordId loc = record->id;
         if (end < loc || (inclusive && end == loc)) {
             if (_cappedDeleteCallback)
                 uassertStatusOK(_cappedDeleteCallback->aboutToDeleteCapped(txn, loc, record->data));
+            if (firstRemovedId.isNull())
+                firstRemovedId = loc;
+            recordsRemoved++;
+            bytesRemoved += record->data.size();
             deleteRecord(txn, loc);
         }
     }
     wuow.commit();
+
+    if (_oplogStones && recordsRemoved > 0) {
+        _oplogStones->updateStonesAfterCappedTruncateAfter(
+            recordsRemoved, bytesRemoved, firstRemovedId);
+    }
 }
 }
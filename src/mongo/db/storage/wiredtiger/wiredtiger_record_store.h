@@ -32,6 +32,8 @@
 #pragma once
 
 #include <boost/thread/mutex.hpp>
+#include <deque>
+#include <memory>
 #include <set>
 #include <string>
 
@@ -122,6 +124,10 @@ public:
                                               const DocWriter* doc,
                                               bool enforceQuota);
 
+    virtual Status insertRecords(OperationContext* txn,
+                                 std::vector<Record>* records,
+                                 bool enforceQuota);
+
     virtual StatusWith<RecordId> updateRecord(OperationContext* txn,
                                               const RecordId& oldLocation,
                                               const char* data,
@@ -151,6 +157,9 @@ public:
     virtual bool compactsInPlace() const {
         return true;
     }
+    virtual bool compactsOnline() const {
+        return true;
+    }
 
     virtual Status compact(OperationContext* txn,
                            RecordStoreCompactAdaptor* adaptor,
@@ -204,6 +213,11 @@ public:
     }
 
     void dealtWithCappedLoc(const RecordId& loc);
+
+    /**
+     * These read the lowest uncommitted RecordId from an atomic rather than the list of
+     * uncommitted RecordIds, so that readers of the oplog never wait on its writers.
+     */
     bool isCappedHidden(const RecordId& loc) const;
     RecordId lowestCappedHiddenRecord() const;
 
@@ -223,6 +237,7 @@ private:
     class CappedInsertChange;
     class NumRecordsChange;
     class DataSizeChange;
+    class OplogStones;
 
     static WiredTigerRecoveryUnit* _getRecoveryUnit(OperationContext* txn);
 
@@ -231,6 +246,11 @@ private:
 
     void _addUncommitedDiskLoc_inlock(OperationContext* txn, const RecordId& loc);
 
+    /**
+     * Raises _oplog_highestSeen to 'loc' unless it is already higher.
+     */
+    void _raiseOplogHighestSeen(const RecordId& loc);
+
     RecordId _nextId();
     void _setId(RecordId loc);
     bool cappedAndNeedDelete() const;
@@ -240,6 +260,12 @@ private:
     StatusWith<RecordId> extractAndCheckLocForOplog(const char* data, int len);
     void _oplogSetStartHack(WiredTigerRecoveryUnit* wru) const;
 
+    /**
+     * Truncates the oldest stones of the oplog while there are more than it needs to keep.
+     * Returns the number of records removed. The caller must hold '_cappedDeleterMutex'.
+     */
+    int64_t _reclaimOplog_inlock(OperationContext* txn);
+
     const std::string _uri;
     const uint64_t _tableId;  // not persisted
 
@@ -259,12 +285,19 @@ private:
 
     const bool _useOplogHack;
 
-    typedef std::vector<RecordId> SortedDiskLocs;
+    // Inserts register their RecordIds in increasing order, and remove them from the list when
+    // they commit or roll back, usually in the same order. Both take _uncommittedDiskLocsMutex.
+    // Readers only look at the lowest entry, which is mirrored in _lowestUncommittedDiskLoc.
+    typedef std::deque<RecordId> SortedDiskLocs;
     SortedDiskLocs _uncommittedDiskLocs;
-    RecordId _oplog_visibleTo;
-    RecordId _oplog_highestSeen;
     mutable stdx::mutex _uncommittedDiskLocsMutex;
 
+    // Key of _uncommittedDiskLocs.front(), or of the null RecordId when the list is empty.
+    // Written with _uncommittedDiskLocsMutex held, read without it.
+    AtomicInt64 _lowestUncommittedDiskLoc;
+    // Key of the highest RecordId inserted into the oplog or registered by oplogDiskLocRegister.
+    AtomicInt64 _oplog_highestSeen;
+
     AtomicInt64 _nextIdNum;
     AtomicInt64 _dataSize;
     AtomicInt64 _numRecords;
@@ -274,6 +307,10 @@ private:
 
     bool _shuttingDown;
     bool _hasBackgroundThread;
+
+    // Non-null only for the oplog, which is reclaimed a whole stone at a time rather than by
+    // deleting its oldest records one insert at a time.
+    std::shared_ptr<OplogStones> _oplogStones;
 };
 
 // WT failpoint to throw write conflict exceptions randomly
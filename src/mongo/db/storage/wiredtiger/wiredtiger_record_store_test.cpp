@@ -47,6 +47,7 @@
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/unittest/temp_dir.h"
 #include "mongo/unittest/unittest.h"
+#include "mongo/util/mongoutils/str.h"
 
 namespace mongo {
 
@@ -379,6 +380,33 @@ TEST(WiredTigerRecordStoreTest, SizeStorer1) {
     rs.reset(NULL);  // this has to be deleted before ss
 }
 
+// Checks that syncing more entries than fit in one batch writes all of them, and that an entry
+// changed after a sync is written again by the next one.
+TEST(WiredTigerRecordStoreTest, SizeStorerSyncsInBatches) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    string indexUri = "table:sizeStorer";
+    WiredTigerSizeStorer ss(harnessHelper->conn(), indexUri);
+
+    const int N = 2500;
+    for (int i = 0; i < N; i++) {
+        ss.storeToCache(std::string(str::stream() << "table:" << i), i, 2 * i);
+    }
+    ss.syncCache(false);
+
+    ss.storeToCache("table:7", 70, 140);
+    ss.syncCache(false);
+
+    WiredTigerSizeStorer ss2(harnessHelper->conn(), indexUri);
+    ss2.fillCache();
+    for (int i = 0; i < N; i++) {
+        long long numRecords;
+        long long dataSize;
+        ss2.loadFromCache(std::string(str::stream() << "table:" << i), &numRecords, &dataSize);
+        ASSERT_EQUALS(i == 7 ? 70 : i, numRecords);
+        ASSERT_EQUALS(i == 7 ? 140 : 2 * i, dataSize);
+    }
+}
+
 namespace {
 
 class GoodValidateAdaptor : public ValidateAdaptor {
@@ -818,6 +846,112 @@ TEST(WiredTigerRecordStoreTest, OplogOrder) {
     }
 }
 
+// Fills an oplog several times over and checks that it is kept at about its configured size by
+// truncating its oldest records, both as they are inserted and after it is reopened.
+TEST(WiredTigerRecordStoreTest, OplogStones) {
+    unique_ptr<WiredTigerHarnessHelper> harnessHelper(new WiredTigerHarnessHelper());
+    const int64_t cappedMaxSize = 10000;
+    const int64_t minBytesPerStone = cappedMaxSize / 10;
+
+    int inc = 0;
+    auto insertAndCheck = [&](unique_ptr<RecordStore>& rs, int numInserts) {
+        RecordId last;
+        for (int i = 0; i < numInserts; i++) {
+            unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+            WriteUnitOfWork uow(opCtx.get());
+            last = _oplogOrderInsertOplog(opCtx.get(), rs, ++inc);
+            uow.commit();
+        }
+
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        long long numRecords = 0;
+        long long dataSize = 0;
+        RecordId prev;
+        auto cursor = rs->getCursor(opCtx.get());
+        while (auto record = cursor->next()) {
+            ASSERT_LT(prev, record->id);
+            prev = record->id;
+            numRecords++;
+            dataSize += record->data.size();
+        }
+        ASSERT_EQ(last, prev);
+
+        // The oplog never drops below its configured size, and holds at most two stones more.
+        ASSERT_GTE(dataSize, cappedMaxSize);
+        ASSERT_LTE(dataSize, cappedMaxSize + 2 * minBytesPerStone + 100);
+        return std::make_pair(numRecords, dataSize);
+    };
+
+    unique_ptr<RecordStore> rs(
+        harnessHelper->newCappedRecordStore("local.oplog.foo", cappedMaxSize, -1));
+    auto counts = insertAndCheck(rs, 2000);
+    {
+        // The counts tracked by whole stones are exact when the stones were built by inserts.
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        ASSERT_EQ(counts.first, rs->numRecords(opCtx.get()));
+        ASSERT_EQ(counts.second, rs->dataSize(opCtx.get()));
+
+        BSONObjBuilder builder;
+        rs->appendCustomStats(opCtx.get(), &builder, 1.0);
+        ASSERT_GTE(builder.obj()["numOplogStones"].numberLong(), 10);
+    }
+
+    // Reopening the oplog places its stones by sampling.
+    rs.reset();
+    rs = harnessHelper->newCappedRecordStore("local.oplog.foo", cappedMaxSize, -1);
+    insertAndCheck(rs, 2000);
+}
+
+TEST(WiredTigerRecordStoreTest, ReadAheadScan) {
+    unique_ptr<HarnessHelper> harnessHelper(newHarnessHelper());
+    unique_ptr<RecordStore> rs(harnessHelper->newNonCappedRecordStore());
+
+    const int N = 2000;
+    const std::string data(1000, 'x');
+    std::vector<RecordId> ids;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        WriteUnitOfWork uow(opCtx.get());
+        for (int i = 0; i < N; i++) {
+            StatusWith<RecordId> res =
+                rs->insertRecord(opCtx.get(), data.c_str(), data.size() + 1, false);
+            ASSERT_OK(res.getStatus());
+            ids.push_back(res.getValue());
+        }
+        uow.commit();
+    }
+
+    // A window much smaller than the collection, so that the reader has to wait for the cursor.
+    const int64_t maxBytesAhead = 64 * 1024;
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        cursor->enableReadAhead(maxBytesAhead);
+        for (int i = 0; i < N; i++) {
+            if (i % 100 == 0) {
+                cursor->save();
+                ASSERT(cursor->restore());
+            }
+            auto record = cursor->next();
+            ASSERT(record);
+            ASSERT_EQ(ids[i], record->id);
+        }
+        ASSERT(!cursor->next());
+    }
+
+    // The cursor may be destroyed while the reader is still reading.
+    {
+        unique_ptr<OperationContext> opCtx(harnessHelper->newOperationContext());
+        auto cursor = rs->getCursor(opCtx.get());
+        cursor->enableReadAhead(maxBytesAhead);
+        for (int i = 0; i < N / 2; i++) {
+            auto record = cursor->next();
+            ASSERT(record);
+            ASSERT_EQ(ids[i], record->id);
+        }
+    }
+}
+
 TEST(WiredTigerRecordStoreTest, StorageSizeStatisticsDisabled) {
     WiredTigerHarnessHelper harnessHelper("statistics=(none)");
     unique_ptr<RecordStore> rs(harnessHelper.newNonCappedRecordStore("a.b"));
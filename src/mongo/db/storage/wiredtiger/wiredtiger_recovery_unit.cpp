@@ -37,6 +37,7 @@
 #include "mongo/db/server_parameters.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_recovery_unit.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
@@ -73,6 +74,10 @@ struct WaitUntilDurableData {
     stdx::condition_variable condvar;
     long long lastSyncTime;
 } waitUntilDurableData;
+
+// Counts the transactions committed by every session, so that a transaction can tell whether its
+// snapshot is still current.
+AtomicUInt64 committedTransactionCount;
 }
 
 WiredTigerRecoveryUnit::WiredTigerRecoveryUnit(WiredTigerSessionCache* sc)
@@ -277,6 +282,12 @@ TicketServerParameter openWriteTransactionParam(&openWriteTransaction,
 TicketHolder openReadTransaction(128);
 TicketServerParameter openReadTransactionParam(&openReadTransaction,
                                                "wiredTigerConcurrentReadTransactions");
+
+// Background operations take one of these before a read or write ticket, so that they never hold
+// more than this many of the read and write tickets.
+TicketHolder openBackgroundTransaction(16);
+TicketServerParameter openBackgroundTransactionParam(&openBackgroundTransaction,
+                                                     "wiredTigerConcurrentBackgroundTransactions");
 }
 
 void WiredTigerRecoveryUnit::appendGlobalStats(BSONObjBuilder& b) {
@@ -295,17 +306,28 @@ void WiredTigerRecoveryUnit::appendGlobalStats(BSONObjBuilder& b) {
         bbb.append("totalTickets", openReadTransaction.outof());
         bbb.done();
     }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("background"));
+        bbb.append("out", openBackgroundTransaction.used());
+        bbb.append("available", openBackgroundTransaction.available());
+        bbb.append("totalTickets", openBackgroundTransaction.outof());
+        bbb.done();
+    }
+    WiredTigerTicketController::appendStats(&bb);
     bb.done();
 }
 
+TicketHolder* WiredTigerRecoveryUnit::getTicketHolder(bool forWrites) {
+    return forWrites ? &openWriteTransaction : &openReadTransaction;
+}
+
 void WiredTigerRecoveryUnit::_txnClose(bool commit) {
     invariant(_active);
     WT_SESSION* s = _session->getSession();
     if (commit) {
-        invariantWTOK(s->commit_transaction(s, NULL));
+        invariantWTOK(s->commit_transaction(s, _syncing ? "sync=background" : NULL));
+        committedTransactionCount.fetchAndAdd(1);
         LOG(2) << "WT commit_transaction";
-        if (_syncing)
-            waitUntilDurableData.syncHappend();
     } else {
         invariantWTOK(s->rollback_transaction(s, NULL));
         LOG(2) << "WT rollback_transaction";
@@ -313,6 +335,47 @@ void WiredTigerRecoveryUnit::_txnClose(bool commit) {
     _active = false;
     _myTransactionCount++;
     _ticket.reset(NULL);
+    _backgroundTicket.reset(NULL);
+
+    // Wait for the sync only after giving up the ticket, so waiting writers don't hold back
+    // other transactions.
+    if (commit && _syncing) {
+        _waitForLogSync();
+    }
+}
+
+void WiredTigerRecoveryUnit::_waitForLogSync() {
+    invariant(!_active);
+    if (_sessionCache->isEngineDurable()) {
+        // Without a timeout_ms, transaction_sync() returns ETIMEDOUT rather than waiting.
+        WT_SESSION* s = _session->getSession();
+        invariantWTOK(s->transaction_sync(s, "timeout_ms=2000000000"));
+    }
+    waitUntilDurableData.syncHappend();
+}
+
+bool WiredTigerRecoveryUnit::isSnapshotCurrent() const {
+    if (!_active) {
+        return true;
+    }
+
+    // A majority committed snapshot moves on with replication rather than with commits.
+    if (_readFromMajorityCommittedSnapshot) {
+        return false;
+    }
+
+    if (committedTransactionCount.load() != _commitCountAtOpen) {
+        return false;
+    }
+
+    // The ticket is given back along with the snapshot, so keeping it while others queue for one
+    // would hold them up.
+    for (const TicketHolderReleaser* ticket : {&_ticket, &_backgroundTicket}) {
+        if (ticket->hasTicket() && ticket->getHolder()->available() <= 0) {
+            return false;
+        }
+    }
+    return true;
 }
 
 SnapshotId WiredTigerRecoveryUnit::getSnapshotId() const {
@@ -352,19 +415,32 @@ void WiredTigerRecoveryUnit::_getTicket(OperationContext* opCtx) {
         return;
 
     bool writeLocked;
+    bool background = false;
 
     // If we have a strong lock, waiting for a ticket can cause a deadlock.
     if (opCtx != NULL && opCtx->lockState() != NULL) {
         if (opCtx->lockState()->hasStrongLocks())
             return;
         writeLocked = opCtx->lockState()->isWriteLocked();
+        background = opCtx->lockState()->isBackgroundOperation();
     } else {
         writeLocked = _everStartedWrite;
     }
 
-    TicketHolder* holder = writeLocked ? &openWriteTransaction : &openReadTransaction;
+    if (background) {
+        openBackgroundTransaction.waitForTicket();
+        _backgroundTicket.reset(&openBackgroundTransaction);
+    }
 
-    holder->waitForTicket();
+    TicketHolder* holder = getTicketHolder(writeLocked);
+
+    if (holder->tryAcquire()) {
+        WiredTigerTicketController::onTicketAcquired(writeLocked, false, 0);
+    } else {
+        Timer waitTimer;
+        holder->waitForTicket();
+        WiredTigerTicketController::onTicketAcquired(writeLocked, true, waitTimer.micros());
+    }
     _ticket.reset(holder);
 }
 
@@ -374,12 +450,13 @@ void WiredTigerRecoveryUnit::_txnOpen(OperationContext* opCtx) {
 
     WT_SESSION* s = _session->getSession();
     _syncing = _syncing || waitUntilDurableData.numWaitingForSync.load() > 0;
+    _commitCountAtOpen = committedTransactionCount.load();
 
     if (_readFromMajorityCommittedSnapshot) {
         _majorityCommittedSnapshot =
-            _sessionCache->snapshotManager().beginTransactionOnCommittedSnapshot(s, _syncing);
+            _sessionCache->snapshotManager().beginTransactionOnCommittedSnapshot(s);
     } else {
-        invariantWTOK(s->begin_transaction(s, _syncing ? "sync=true" : NULL));
+        invariantWTOK(s->begin_transaction(s, NULL));
     }
 
     LOG(2) << "WT begin_transaction";
@@ -68,6 +68,8 @@ public:
 
     virtual void abandonSnapshot();
 
+    bool isSnapshotCurrent() const final;
+
     // un-used API
     virtual void* writingPtr(void* data, size_t len) {
         invariant(!"don't call writingPtr");
@@ -110,6 +112,11 @@ public:
 
     static void appendGlobalStats(BSONObjBuilder& b);
 
+    /**
+     * Returns the tickets which transactions wait for, depending on whether they write.
+     */
+    static TicketHolder* getTicketHolder(bool forWrites);
+
     /**
      * Prepares this RU to be the basis for a named snapshot.
      *
@@ -125,6 +132,13 @@ private:
     void _txnClose(bool commit);
     void _txnOpen(OperationContext* opCtx);
 
+    /**
+     * Waits for the log records of the transaction just committed with background sync to be
+     * synced by WiredTiger's log server thread, which syncs once for all of the transactions
+     * waiting on it.
+     */
+    void _waitForLogSync();
+
     WiredTigerSessionCache* _sessionCache;  // not owned
     WiredTigerSession* _session;            // owned, but from pool
     bool _defaultCommit;
@@ -132,6 +146,8 @@ private:
     bool _inUnitOfWork;
     bool _active;
     uint64_t _myTransactionCount;
+    // The number of transactions committed by any session when this one began.
+    uint64_t _commitCountAtOpen = 0;
     bool _everStartedWrite;
     Timer _timer;
     bool _currentlySquirreled;
@@ -146,6 +162,7 @@ private:
     bool _noTicketNeeded;
     void _getTicket(OperationContext* opCtx);
     TicketHolderReleaser _ticket;
+    TicketHolderReleaser _backgroundTicket;
 };
 
 /**
@@ -33,6 +33,8 @@
 
 #include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
 
+#include <algorithm>
+
 #include "mongo/db/storage/wiredtiger/wiredtiger_kv_engine.h"
 #include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
 #include "mongo/stdx/memory.h"
@@ -43,7 +45,12 @@
 namespace mongo {
 
 WiredTigerSession::WiredTigerSession(WT_CONNECTION* conn, int epoch)
-    : _epoch(epoch), _session(NULL), _cursorGen(0), _cursorsCached(0), _cursorsOut(0) {
+    : _epoch(epoch),
+      _session(NULL),
+      _cursorGen(0),
+      _cursorsCached(0),
+      _cursorsOut(0),
+      _cursorCacheMaxAge(kMinCursorCacheAge) {
     invariantWTOK(conn->open_session(conn, NULL, "isolation=snapshot", &_session));
 }
 
@@ -65,6 +72,17 @@ WT_CURSOR* WiredTigerSession::getCursor(const std::string& uri, uint64_t id, boo
         }
     }
 
+    // Reopening a cursor which was recently closed for not being used means that this session's
+    // working set of tables does not fit in the cache, so keep cursors around for longer.
+    std::vector<uint64_t>::iterator evicted =
+        std::find(_recentlyEvicted.begin(), _recentlyEvicted.end(), id);
+    if (evicted != _recentlyEvicted.end()) {
+        _recentlyEvicted.erase(evicted);
+        if (_cursorCacheMaxAge < kMaxCursorCacheAge) {
+            _cursorCacheMaxAge *= 2;
+        }
+    }
+
     WT_CURSOR* c = NULL;
     int ret = _session->open_cursor(
         _session, uri.c_str(), NULL, forRecordStore ? "" : "overwrite=false", &c);
@@ -90,8 +108,14 @@ void WiredTigerSession::releaseCursor(uint64_t id, WT_CURSOR* cursor) {
     // The reasoning here is to imagine a workload with N tables performing operations randomly
     // across all of them (i.e., each cursor has 1/N chance of used for each operation).  We
     // would like to cache N cursors in that case, so any given cursor could go N**2 operations
-    // in between use.
-    while (_cursorGen - _cursors.back()._gen > 10000) {
+    // in between use. Rather than assuming a workload, the age limit starts low and grows
+    // whenever getCursor() has to reopen a cursor this closed recently.
+    while (_cursorGen - _cursors.back()._gen > _cursorCacheMaxAge) {
+        if (_recentlyEvicted.size() == kMaxRecentlyEvicted) {
+            _recentlyEvicted.erase(_recentlyEvicted.begin());
+        }
+        _recentlyEvicted.push_back(_cursors.back()._id);
+
         cursor = _cursors.back()._cursor;
         _cursors.pop_back();
         _cursorsCached--;
@@ -151,33 +175,52 @@ void WiredTigerSessionCache::shuttingDown() {
     _snapshotManager.shutdown();
 }
 
+bool WiredTigerSessionCache::isEngineDurable() const {
+    return _engine && _engine->isDurable();
+}
+
 void WiredTigerSessionCache::closeAll() {
-    // Increment the epoch as we are now closing all sessions with this epoch
-    SessionCache swap;
+    // Increment the epoch as we are now closing all sessions with this epoch. Sessions released
+    // after this will see the new epoch under their partition's lock, and be freed instead.
+    _epoch.fetchAndAdd(1);
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        _epoch.fetchAndAdd(1);
-        _sessions.swap(swap);
-    }
+    for (size_t i = 0; i < kNumSessionCachePartitions; i++) {
+        SessionCache swap;
+
+        {
+            scoped_spinlock lock(_partitions[i].lock);
+            _partitions[i].sessions.swap(swap);
+        }
 
-    for (SessionCache::iterator i = swap.begin(); i != swap.end(); i++) {
-        delete (*i);
+        for (SessionCache::iterator it = swap.begin(); it != swap.end(); it++) {
+            delete (*it);
+        }
     }
 }
 
+size_t WiredTigerSessionCache::_getPartitionIndex() const {
+    return std::hash<stdx::thread::id>()(stdx::this_thread::get_id()) %
+        kNumSessionCachePartitions;
+}
+
 WiredTigerSession* WiredTigerSessionCache::getSession() {
     // We should never be able to get here after _shuttingDown is set, because no new
     // operations should be allowed to start.
     invariant(!(_shuttingDown.loadRelaxed() & kShuttingDownMask));
 
-    {
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
-        if (!_sessions.empty()) {
+    // Start with this thread's own partition, and only look through the others if it is empty,
+    // so that sessions released by exited threads are not left unused.
+    const size_t first = _getPartitionIndex();
+    for (size_t i = 0; i < kNumSessionCachePartitions; i++) {
+        SessionCachePartition& partition =
+            _partitions[(first + i) % kNumSessionCachePartitions];
+
+        scoped_spinlock lock(partition.lock);
+        if (!partition.sessions.empty()) {
             // Get the most recently used session so that if we discard sessions, we're
             // discarding older ones
-            WiredTigerSession* cachedSession = _sessions.back();
-            _sessions.pop_back();
+            WiredTigerSession* cachedSession = partition.sessions.back();
+            partition.sessions.pop_back();
             return cachedSession;
         }
     }
@@ -214,10 +257,11 @@ void WiredTigerSessionCache::releaseSession(WiredTigerSession* session) {
     uint64_t currentEpoch = _epoch.load();
 
     if (session->_getEpoch() == currentEpoch) {  // check outside of lock to reduce contention
-        stdx::lock_guard<stdx::mutex> lock(_cacheLock);
+        SessionCachePartition& partition = _partitions[_getPartitionIndex()];
+        scoped_spinlock lock(partition.lock);
         if (session->_getEpoch() == _epoch.load()) {  // recheck inside the lock for correctness
             returnedToCache = true;
-            _sessions.push_back(session);
+            partition.sessions.push_back(session);
         }
     } else
         invariant(session->_getEpoch() < currentEpoch);
@@ -33,6 +33,7 @@
 
 #include <list>
 #include <string>
+#include <vector>
 
 #include <boost/thread/shared_mutex.hpp>
 #include <wiredtiger.h>
@@ -109,11 +110,23 @@ private:
         return _epoch;
     }
 
+    // Cursors not used in this many releaseCursor() calls are closed. It starts at
+    // kMinCursorCacheAge and doubles, up to kMaxCursorCacheAge, each time a cursor is reopened
+    // soon after being closed for its age.
+    static const uint64_t kMinCursorCacheAge = 10000;
+    static const uint64_t kMaxCursorCacheAge = kMinCursorCacheAge << 8;
+
+    // How many of the most recently aged out cursors' table ids are remembered.
+    static const size_t kMaxRecentlyEvicted = 16;
+
     const uint64_t _epoch;
     WT_SESSION* _session;  // owned
     CursorCache _cursors;  // owned
     uint64_t _cursorGen;
     int _cursorsCached, _cursorsOut;
+
+    uint64_t _cursorCacheMaxAge;
+    std::vector<uint64_t> _recentlyEvicted;  // oldest first
 };
 
 /**
@@ -130,6 +143,9 @@ public:
      * Returns a previously released session for reuse, or creates a new session.
      * This method must only be called while holding the global lock to avoid races with
      * shuttingDown, but otherwise is thread safe.
+     *
+     * Sessions are taken from the calling thread's partition of the cache first, so that threads
+     * running on different cores rarely touch the same lock.
      */
     WiredTigerSession* getSession();
 
@@ -156,6 +172,12 @@ public:
         return _conn;
     }
 
+    /**
+     * Returns true if the engine is journaled, so that transactions can wait for their log
+     * records to be synced.
+     */
+    bool isEngineDurable() const;
+
     WiredTigerSnapshotManager& snapshotManager() {
         return _snapshotManager;
     }
@@ -174,11 +196,25 @@ private:
     AtomicUInt32 _shuttingDown;
     static const uint32_t kShuttingDownMask = 1 << 31;
 
-    stdx::mutex _cacheLock;
     typedef std::vector<WiredTigerSession*> SessionCache;
-    SessionCache _sessions;
+
+    // A part of the cache, used by the threads whose ids hash to it. Each partition is guarded
+    // by its own spin lock, which is held only long enough to push or pop a session.
+    struct SessionCachePartition {
+        SpinLock lock;
+        SessionCache sessions;
+    };
+
+    static const size_t kNumSessionCachePartitions = 64;
+
+    /**
+     * Returns the partition that the calling thread gets and releases its sessions through.
+     */
+    size_t _getPartitionIndex() const;
+
+    SessionCachePartition _partitions[kNumSessionCachePartitions];
 
     // Bumped when all open sessions need to be closed
-    AtomicUInt64 _epoch;  // atomic so we can check it outside of the lock
+    AtomicUInt64 _epoch;  // atomic so we can check it outside of the partition locks
 };
 }
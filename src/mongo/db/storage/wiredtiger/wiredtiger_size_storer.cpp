@@ -31,6 +31,8 @@
 
 #define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
 
+#include <utility>
+#include <vector>
 #include <wiredtiger.h>
 
 #include "mongo/bson/bsonobj.h"
@@ -169,70 +171,78 @@ void WiredTigerSizeStorer::fillCache() {
 }
 
 void WiredTigerSizeStorer::syncCache(bool syncToDisk) {
-    stdx::lock_guard<stdx::mutex> cursorLock(_cursorMutex);
-    _checkMagic();
-
-    Map myMap;
-    {
-        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            std::string uriKey = it->first;
-            Entry& entry = it->second;
-            if (entry.rs) {
-                if (entry.dataSize != entry.rs->dataSize(NULL)) {
-                    entry.dataSize = entry.rs->dataSize(NULL);
-                    entry.dirty = true;
-                }
-                if (entry.numRecords != entry.rs->numRecords(NULL)) {
-                    entry.numRecords = entry.rs->numRecords(NULL);
-                    entry.dirty = true;
-                }
-            }
-
-            if (!entry.dirty)
-                continue;
-            myMap[uriKey] = entry;
-        }
+    stdx::unique_lock<stdx::mutex> cursorLock(_cursorMutex, stdx::defer_lock);
+    if (syncToDisk) {
+        cursorLock.lock();
+    } else if (!cursorLock.try_lock()) {
+        return;
     }
-
-    if (myMap.empty())
-        return;  // Nothing to do.
+    _checkMagic();
 
     WT_SESSION* session = _session.getSession();
-    invariantWTOK(session->begin_transaction(session, syncToDisk ? "sync=true" : ""));
-    ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
+    std::vector<std::pair<std::string, BSONObj>> batch;
+    std::string lastScanned;
+    bool scannedAll = false;
+    bool atStart = true;
+    while (!scannedAll) {
+        batch.clear();
+        {
+            // Entries are never erased, only added, so the scan can pick up after the last key
+            // it looked at each time it retakes the mutex.
+            stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
+            Map::iterator it = atStart ? _entries.begin() : _entries.upper_bound(lastScanned);
+            for (size_t scanned = 0; it != _entries.end() && scanned < kSyncBatchSize;
+                 ++it, ++scanned) {
+                Entry& entry = it->second;
+                if (entry.rs) {
+                    if (entry.dataSize != entry.rs->dataSize(NULL)) {
+                        entry.dataSize = entry.rs->dataSize(NULL);
+                        entry.dirty = true;
+                    }
+                    if (entry.numRecords != entry.rs->numRecords(NULL)) {
+                        entry.numRecords = entry.rs->numRecords(NULL);
+                        entry.dirty = true;
+                    }
+                }
+                lastScanned = it->first;
 
-    for (Map::iterator it = myMap.begin(); it != myMap.end(); ++it) {
-        string uriKey = it->first;
-        Entry& entry = it->second;
+                if (!entry.dirty)
+                    continue;
 
-        BSONObj data;
-        {
-            BSONObjBuilder b;
-            b.append("numRecords", entry.numRecords);
-            b.append("dataSize", entry.dataSize);
-            data = b.obj();
+                // Clear the flag now, rather than once the batch is written, so that sizes stored
+                // while the batch is being written are picked up by the next sync.
+                entry.dirty = false;
+                batch.push_back(std::make_pair(
+                    it->first,
+                    BSON("numRecords" << entry.numRecords << "dataSize" << entry.dataSize)));
+            }
+            scannedAll = (it == _entries.end());
+            atStart = false;
         }
 
-        LOG(2) << "WiredTigerSizeStorer::storeInto " << uriKey << " -> " << data;
+        if (batch.empty())
+            continue;
 
-        WiredTigerItem key(uriKey.c_str(), uriKey.size());
-        WiredTigerItem value(data.objdata(), data.objsize());
-        _cursor->set_key(_cursor, key.Get());
-        _cursor->set_value(_cursor, value.Get());
-        invariantWTOK(_cursor->insert(_cursor));
-    }
+        invariantWTOK(session->begin_transaction(session, syncToDisk ? "sync=true" : ""));
+        ScopeGuard rollbacker = MakeGuard(session->rollback_transaction, session, "");
 
-    invariantWTOK(_cursor->reset(_cursor));
+        for (size_t i = 0; i < batch.size(); i++) {
+            const string& uriKey = batch[i].first;
+            const BSONObj& data = batch[i].second;
 
-    rollbacker.Dismiss();
-    invariantWTOK(session->commit_transaction(session, NULL));
+            LOG(2) << "WiredTigerSizeStorer::storeInto " << uriKey << " -> " << data;
 
-    {
-        stdx::lock_guard<stdx::mutex> lk(_entriesMutex);
-        for (Map::iterator it = _entries.begin(); it != _entries.end(); ++it) {
-            it->second.dirty = false;
+            WiredTigerItem key(uriKey.c_str(), uriKey.size());
+            WiredTigerItem value(data.objdata(), data.objsize());
+            _cursor->set_key(_cursor, key.Get());
+            _cursor->set_value(_cursor, value.Get());
+            invariantWTOK(_cursor->insert(_cursor));
         }
+
+        invariantWTOK(_cursor->reset(_cursor));
+
+        rollbacker.Dismiss();
+        invariantWTOK(session->commit_transaction(session, NULL));
     }
 }
 }
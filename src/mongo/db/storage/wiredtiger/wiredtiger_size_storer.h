@@ -62,7 +62,11 @@ public:
     void fillCache();
 
     /**
-     * Writes all changes to the underlying table.
+     * Writes all changes to the underlying table, a batch of entries at a time so that record
+     * stores storing their sizes are never blocked behind all of them.
+     *
+     * When 'syncToDisk' is false, returns without doing anything if another thread is already
+     * syncing, since the changes will be picked up by the next sync.
      */
     void syncCache(bool syncToDisk);
 
@@ -77,6 +81,9 @@ private:
         WiredTigerRecordStore* rs;  // not owned
     };
 
+    // How many entries syncCache() looks at, and writes in one transaction, at a time.
+    static const size_t kSyncBatchSize = 1000;
+
     int _magic;
 
     // Guards _cursor. Acquire *before* _entriesMutex.
@@ -0,0 +1,224 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kStorage
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+
+#include <algorithm>
+
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_session_cache.h"
+#include "mongo/db/storage/wiredtiger/wiredtiger_util.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/log.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTickets, bool, false);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsMin, int, 32);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsMax, int, 512);
+MONGO_EXPORT_SERVER_PARAMETER(wiredTigerAdaptiveTicketsIntervalMillis, int, 1000);
+
+// TicketHolder::resize() does not accept fewer tickets than this.
+const int kMinimumTickets = 5;
+
+// Application threads start evicting pages once this percentage of the cache is in use, which is
+// WiredTiger's default eviction_trigger.
+const uint64_t kEvictionTriggerPercent = 95;
+
+struct TicketCounters {
+    AtomicInt64 acquired;
+    AtomicInt64 waited;
+    AtomicInt64 waitMicros;
+    AtomicInt64 increases;
+    AtomicInt64 decreases;
+};
+
+TicketCounters ticketCounters[2];  // indexed by forWrites
+AtomicInt64 cachePressureAdjustments;
+AtomicWord<bool> lastCachePressure(false);
+
+void appendCounters(BSONObjBuilder* b, const TicketCounters& counters) {
+    b->append("acquired", counters.acquired.load());
+    b->append("waited", counters.waited.load());
+    b->append("totalWaitMicros", counters.waitMicros.load());
+    b->append("increases", counters.increases.load());
+    b->append("decreases", counters.decreases.load());
+}
+
+}  // namespace
+
+WiredTigerTicketController::WiredTigerTicketController(WT_CONNECTION* conn,
+                                                       TicketHolder* readTickets,
+                                                       TicketHolder* writeTickets)
+    : _conn(conn), _readTickets(readTickets), _writeTickets(writeTickets) {
+    _thread = stdx::thread([this] { _run(); });
+}
+
+WiredTigerTicketController::~WiredTigerTicketController() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _stopped = true;
+    }
+    _condvar.notify_all();
+    _thread.join();
+}
+
+// static
+void WiredTigerTicketController::onTicketAcquired(bool forWrites,
+                                                  bool waited,
+                                                  long long waitMicros) {
+    TicketCounters& counters = ticketCounters[forWrites];
+    counters.acquired.fetchAndAdd(1);
+    if (waited) {
+        counters.waited.fetchAndAdd(1);
+        counters.waitMicros.fetchAndAdd(waitMicros);
+    }
+}
+
+// static
+void WiredTigerTicketController::appendStats(BSONObjBuilder* b) {
+    BSONObjBuilder bb(b->subobjStart("adaptive"));
+    bb.append("enabled", wiredTigerAdaptiveTickets);
+    bb.append("cachePressure", lastCachePressure.load());
+    bb.append("cachePressureAdjustments", cachePressureAdjustments.load());
+    {
+        BSONObjBuilder bbb(bb.subobjStart("write"));
+        appendCounters(&bbb, ticketCounters[true]);
+        bbb.done();
+    }
+    {
+        BSONObjBuilder bbb(bb.subobjStart("read"));
+        appendCounters(&bbb, ticketCounters[false]);
+        bbb.done();
+    }
+    bb.done();
+}
+
+// static
+int WiredTigerTicketController::nextTicketCount(
+    int current, bool waitedForTickets, bool cachePressure, int minTickets, int maxTickets) {
+    minTickets = std::max(minTickets, kMinimumTickets);
+    maxTickets = std::max(maxTickets, minTickets);
+
+    int next = current;
+    if (cachePressure) {
+        next = current - current / 4;
+    } else if (waitedForTickets) {
+        next = current + kIncreaseStep;
+    }
+    return std::min(std::max(next, minTickets), maxTickets);
+}
+
+void WiredTigerTicketController::_run() {
+    WiredTigerSession session(_conn);
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (!_stopped) {
+        const int intervalMillis = std::max(1, wiredTigerAdaptiveTicketsIntervalMillis);
+        _condvar.wait_for(lk, stdx::chrono::milliseconds(intervalMillis));
+        if (_stopped || !wiredTigerAdaptiveTickets) {
+            _haveEvictionBaseline = false;
+            continue;
+        }
+
+        lk.unlock();
+        const bool cachePressure = _sampleCachePressure(session.getSession());
+        lastCachePressure.store(cachePressure);
+        if (cachePressure)
+            cachePressureAdjustments.fetchAndAdd(1);
+
+        _adjust(_readTickets, false, cachePressure);
+        _adjust(_writeTickets, true, cachePressure);
+        lk.lock();
+    }
+}
+
+bool WiredTigerTicketController::_sampleCachePressure(WT_SESSION* session) {
+    const std::string uri = "statistics:";
+    const std::string config = "statistics=(fast)";
+
+    StatusWith<uint64_t> appEvictions =
+        WiredTigerUtil::getStatisticsValue(session, uri, config, WT_STAT_CONN_CACHE_EVICTION_APP);
+    StatusWith<uint64_t> bytesInUse =
+        WiredTigerUtil::getStatisticsValue(session, uri, config, WT_STAT_CONN_CACHE_BYTES_INUSE);
+    StatusWith<uint64_t> bytesMax =
+        WiredTigerUtil::getStatisticsValue(session, uri, config, WT_STAT_CONN_CACHE_BYTES_MAX);
+    if (!appEvictions.isOK() || !bytesInUse.isOK() || !bytesMax.isOK()) {
+        // Without the statistics, leave the number of tickets where it is.
+        _haveEvictionBaseline = false;
+        return false;
+    }
+
+    const bool appThreadsEvicted =
+        _haveEvictionBaseline && appEvictions.getValue() > _lastAppEvictions;
+    _lastAppEvictions = appEvictions.getValue();
+    _haveEvictionBaseline = true;
+
+    return appThreadsEvicted ||
+        bytesInUse.getValue() * 100 >= bytesMax.getValue() * kEvictionTriggerPercent;
+}
+
+void WiredTigerTicketController::_adjust(TicketHolder* holder,
+                                         bool forWrites,
+                                         bool cachePressure) {
+    const long long waited = ticketCounters[forWrites].waited.load();
+    const bool waitedForTickets = waited > _waitedAtLastAdjustment[forWrites];
+    _waitedAtLastAdjustment[forWrites] = waited;
+
+    const int current = holder->outof();
+    const int next = nextTicketCount(current,
+                                     waitedForTickets,
+                                     cachePressure,
+                                     wiredTigerAdaptiveTicketsMin,
+                                     wiredTigerAdaptiveTicketsMax);
+    if (next == current)
+        return;
+
+    // Shrinking waits for the tickets it takes away to be returned.
+    Status status = holder->resize(next);
+    if (!status.isOK()) {
+        warning() << "Unable to resize " << (forWrites ? "write" : "read")
+                  << " transaction tickets to " << next << ": " << status;
+        return;
+    }
+
+    (next > current ? ticketCounters[forWrites].increases : ticketCounters[forWrites].decreases)
+        .fetchAndAdd(1);
+    LOG(1) << "Resized " << (forWrites ? "write" : "read") << " transaction tickets from "
+           << current << " to " << next << (cachePressure ? " under cache pressure" : "");
+}
+
+}  // namespace mongo
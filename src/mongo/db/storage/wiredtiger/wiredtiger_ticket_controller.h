@@ -0,0 +1,117 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <wiredtiger.h>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class TicketHolder;
+
+/**
+ * Sizes the WiredTiger read and write transaction tickets while wiredTigerAdaptiveTickets is on,
+ * in an additive increase, multiplicative decrease loop: for each kind of ticket, while
+ * operations had to wait for one and the cache keeps up, the number of tickets grows by a
+ * constant step; once application threads have to evict pages from the cache, or it is full past
+ * the point at which they start to, the number of tickets shrinks by a quarter. The number of
+ * tickets stays between wiredTigerAdaptiveTicketsMin and wiredTigerAdaptiveTicketsMax.
+ *
+ * Setting wiredTigerConcurrentReadTransactions or wiredTigerConcurrentWriteTransactions still
+ * sizes the tickets directly, and the controller carries on from the new size.
+ */
+class WiredTigerTicketController {
+    MONGO_DISALLOW_COPYING(WiredTigerTicketController);
+
+public:
+    static const int kIncreaseStep = 8;
+
+    /**
+     * Starts the thread which adjusts 'readTickets' and 'writeTickets', neither of which is owned,
+     * from the statistics of 'conn'.
+     */
+    WiredTigerTicketController(WT_CONNECTION* conn,
+                               TicketHolder* readTickets,
+                               TicketHolder* writeTickets);
+
+    /**
+     * Stops the thread. Must be called before 'conn' is closed.
+     */
+    ~WiredTigerTicketController();
+
+    /**
+     * Called for every ticket handed out to a transaction, with how long it waited for the ticket.
+     */
+    static void onTicketAcquired(bool forWrites, bool waited, long long waitMicros);
+
+    /**
+     * Appends the counters and the last decisions of the controller, under "adaptive".
+     */
+    static void appendStats(BSONObjBuilder* b);
+
+    /**
+     * Returns the number of tickets to have next, given how many there are and whether operations
+     * waited for one and the cache was under pressure since the last adjustment.
+     */
+    static int nextTicketCount(
+        int current, bool waitedForTickets, bool cachePressure, int minTickets, int maxTickets);
+
+private:
+    void _run();
+
+    /**
+     * Returns whether the cache was under pressure since the last call.
+     */
+    bool _sampleCachePressure(WT_SESSION* session);
+
+    void _adjust(TicketHolder* holder, bool forWrites, bool cachePressure);
+
+    WT_CONNECTION* const _conn;
+    TicketHolder* const _readTickets;
+    TicketHolder* const _writeTickets;
+
+    // Only used by the thread.
+    uint64_t _lastAppEvictions = 0;
+    bool _haveEvictionBaseline = false;
+    long long _waitedAtLastAdjustment[2] = {0, 0};  // indexed by forWrites
+
+    stdx::mutex _mutex;
+    stdx::condition_variable _condvar;
+    bool _stopped = false;  // protected by _mutex
+
+    stdx::thread _thread;
+};
+
+}  // namespace mongo
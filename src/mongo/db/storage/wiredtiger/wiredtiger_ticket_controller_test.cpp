@@ -0,0 +1,63 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/storage/wiredtiger/wiredtiger_ticket_controller.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const int kStep = WiredTigerTicketController::kIncreaseStep;
+
+TEST(WiredTigerTicketControllerTest, IncreasesAdditivelyWhileOperationsWait) {
+    ASSERT_EQUALS(128 + kStep,
+                  WiredTigerTicketController::nextTicketCount(128, true, false, 32, 512));
+    ASSERT_EQUALS(128, WiredTigerTicketController::nextTicketCount(128, false, false, 32, 512));
+    ASSERT_EQUALS(512, WiredTigerTicketController::nextTicketCount(510, true, false, 32, 512));
+}
+
+TEST(WiredTigerTicketControllerTest, DecreasesMultiplicativelyUnderCachePressure) {
+    ASSERT_EQUALS(96, WiredTigerTicketController::nextTicketCount(128, true, true, 32, 512));
+    ASSERT_EQUALS(96, WiredTigerTicketController::nextTicketCount(128, false, true, 32, 512));
+    ASSERT_EQUALS(32, WiredTigerTicketController::nextTicketCount(40, false, true, 32, 512));
+}
+
+TEST(WiredTigerTicketControllerTest, StaysWithinBounds) {
+    // A size set outside of the bounds is brought back within them.
+    ASSERT_EQUALS(512, WiredTigerTicketController::nextTicketCount(1000, false, false, 32, 512));
+    ASSERT_EQUALS(32, WiredTigerTicketController::nextTicketCount(8, false, false, 32, 512));
+
+    // Bounds which TicketHolder::resize() would reject are ignored.
+    ASSERT_EQUALS(5, WiredTigerTicketController::nextTicketCount(6, false, true, 0, 0));
+    ASSERT_EQUALS(64, WiredTigerTicketController::nextTicketCount(128, false, true, 64, 16));
+}
+
+}  // namespace
+}  // namespace mongo
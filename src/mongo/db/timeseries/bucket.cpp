@@ -0,0 +1,227 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket.h"
+
+#include <algorithm>
+
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+BucketBuilder::BucketBuilder(std::string timeField,
+                             std::string metaField,
+                             int maxCount,
+                             Milliseconds maxSpan)
+    : _timeField(std::move(timeField)),
+      _metaField(std::move(metaField)),
+      _maxCount(maxCount),
+      _maxSpan(maxSpan) {}
+
+StatusWith<bool> BucketBuilder::add(const BSONObj& measurement) {
+    BSONElement time;
+    BSONElement meta;
+    // The values of the fields in the order of '_columns', and those of fields the bucket does
+    // not have yet.
+    std::vector<double> values(_columns.size());
+    std::vector<BSONElement> newFields;
+    size_t numFields = 0;
+
+    for (auto&& elem : measurement) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (fieldName == _timeField) {
+            if (elem.type() != Date) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "the time field of a measurement must be a date: "
+                                      << elem};
+            }
+            time = elem;
+        } else if (!_metaField.empty() && fieldName == _metaField) {
+            meta = elem;
+        } else if (fieldName != "_id") {
+            if (!elem.isNumber()) {
+                return {ErrorCodes::BadValue,
+                        str::stream() << "the fields of a measurement must be numbers: " << elem};
+            }
+            numFields++;
+            auto column = std::find_if(_columns.begin(),
+                                       _columns.end(),
+                                       [&](const Column& c) { return c.name == fieldName; });
+            if (column == _columns.end()) {
+                newFields.push_back(elem);
+            } else {
+                values[column - _columns.begin()] = elem.numberDouble();
+            }
+        }
+    }
+    if (time.eoo()) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "a measurement must have the time field " << _timeField};
+    }
+
+    if (_count == 0) {
+        _meta = meta.eoo() ? BSONObj() : meta.wrap("meta");
+        _times.reset(new TimestampColumnEncoder());
+        _minTime = _maxTime = time.date();
+        for (auto&& elem : newFields) {
+            _columns.emplace_back(elem.fieldName());
+            values.push_back(elem.numberDouble());
+            _columns.back().min = _columns.back().max = elem.numberDouble();
+        }
+    } else {
+        const bool sameMeta = meta.eoo()
+            ? _meta.isEmpty()
+            : !_meta.isEmpty() && meta.woCompare(_meta.firstElement(), false) == 0;
+        const Date_t first = _minTime;
+        const bool inWindow = time.date() >= first && time.date() - first < _maxSpan;
+        if (_count >= _maxCount || !sameMeta || !inWindow || !newFields.empty() ||
+            numFields != _columns.size()) {
+            return false;
+        }
+    }
+
+    _times->append(time.date().toMillisSinceEpoch());
+    _minTime = std::min(_minTime, time.date());
+    _maxTime = std::max(_maxTime, time.date());
+    for (size_t i = 0; i < _columns.size(); i++) {
+        Column& column = _columns[i];
+        column.encoder.append(values[i]);
+        column.min = std::min(column.min, values[i]);
+        column.max = std::max(column.max, values[i]);
+    }
+    _count++;
+    return true;
+}
+
+BSONObj BucketBuilder::done() {
+    invariant(!isEmpty());
+
+    BSONObjBuilder bucket;
+    if (!_meta.isEmpty()) {
+        bucket.appendAs(_meta.firstElement(), "meta");
+    }
+
+    {
+        BSONObjBuilder control(bucket.subobjStart("control"));
+        control.append("version", kBucketVersion);
+        control.append("count", _count);
+        BSONObjBuilder min(control.subobjStart("min"));
+        min.append(_timeField, _minTime);
+        for (auto&& column : _columns) {
+            min.append(column.name, column.min);
+        }
+        min.doneFast();
+        BSONObjBuilder max(control.subobjStart("max"));
+        max.append(_timeField, _maxTime);
+        for (auto&& column : _columns) {
+            max.append(column.name, column.max);
+        }
+    }
+
+    {
+        BSONObjBuilder data(bucket.subobjStart("data"));
+        data.appendBinData(
+            _timeField, _times->buffer().size(), BinDataGeneral, _times->buffer().data());
+        for (auto&& column : _columns) {
+            const std::string& buffer = column.encoder.buffer();
+            data.appendBinData(column.name, buffer.size(), BinDataGeneral, buffer.data());
+        }
+    }
+
+    _count = 0;
+    _meta = BSONObj();
+    _times.reset();
+    _columns.clear();
+    return bucket.obj();
+}
+
+namespace {
+StringData binDataColumn(const BSONElement& elem) {
+    uassert(28823,
+            str::stream() << "time-series bucket column must be BinData: " << elem,
+            elem.type() == BinData);
+    int length;
+    const char* data = elem.binData(length);
+    return StringData(data, length);
+}
+}  // namespace
+
+BucketUnpacker::BucketUnpacker(std::string timeField, std::string metaField)
+    : _timeField(std::move(timeField)), _metaField(std::move(metaField)) {}
+
+void BucketUnpacker::reset(const BSONObj& bucket) {
+    _bucket = bucket;
+    _meta = _bucket["meta"];
+    _times.reset();
+    _columns.clear();
+
+    const BSONElement control = _bucket["control"];
+    uassert(28824,
+            str::stream() << "time-series bucket has no control object: " << _bucket,
+            control.type() == Object);
+    uassert(28825,
+            str::stream() << "unsupported time-series bucket version: " << control,
+            control["version"].numberInt() == BucketBuilder::kBucketVersion);
+    _remaining = control["count"].numberInt();
+
+    const BSONElement data = _bucket["data"];
+    uassert(28826,
+            str::stream() << "time-series bucket has no data object: " << _bucket,
+            data.type() == Object);
+    for (auto&& column : data.Obj()) {
+        if (column.fieldNameStringData() == _timeField) {
+            _times.reset(new TimestampColumnDecoder(binDataColumn(column)));
+        } else {
+            _columns.emplace_back(column.fieldNameStringData(),
+                                  DoubleColumnDecoder(binDataColumn(column)));
+        }
+    }
+    uassert(28827,
+            str::stream() << "time-series bucket has no time field " << _timeField,
+            _times || _remaining == 0);
+}
+
+BSONObj BucketUnpacker::next() {
+    invariant(more());
+    _remaining--;
+
+    BSONObjBuilder measurement;
+    measurement.append(_timeField, Date_t::fromMillisSinceEpoch(_times->next()));
+    if (!_meta.eoo() && !_metaField.empty()) {
+        measurement.appendAs(_meta, _metaField);
+    }
+    for (auto&& column : _columns) {
+        measurement.append(column.first, column.second.next());
+    }
+    return measurement.obj();
+}
+
+}  // namespace mongo
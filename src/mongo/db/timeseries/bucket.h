@@ -0,0 +1,139 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/status_with.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/timeseries/bucket_compression.h"
+
+namespace mongo {
+
+/**
+ * Builds a bucket, which stores the measurements of one series over a window of time in a single
+ * document, with a compressed column per field:
+ *
+ *   {meta: <meta field value of the series>,
+ *    control: {version: 1,
+ *              count: <number of measurements>,
+ *              min: {<time field>: <Date>, <field>: <number>, ...},
+ *              max: {<time field>: <Date>, <field>: <number>, ...}},
+ *    data: {<time field>: <BinData>, <field>: <BinData>, ...}}
+ *
+ * All the measurements in a bucket have the same meta field value, or none, a Date in the time
+ * field, and numbers in the same set of other fields, which are stored as doubles. The _id of a
+ * measurement is not stored.
+ */
+class BucketBuilder {
+public:
+    static const int kBucketVersion = 1;
+
+    /**
+     * 'metaField' may be empty for series which are told apart by their fields only.
+     */
+    BucketBuilder(std::string timeField, std::string metaField, int maxCount, Milliseconds maxSpan);
+
+    /**
+     * Adds 'measurement' to the bucket, unless the bucket is full or 'measurement' belongs in
+     * another bucket: one for a different meta field value or set of fields, or for a later
+     * window of time. Returns whether 'measurement' was added, or an error if it cannot be stored
+     * in any bucket.
+     */
+    StatusWith<bool> add(const BSONObj& measurement);
+
+    bool isEmpty() const {
+        return _count == 0;
+    }
+
+    /**
+     * Returns the bucket of the measurements added so far and empties the builder.
+     */
+    BSONObj done();
+
+private:
+    struct Column {
+        explicit Column(std::string name) : name(std::move(name)) {}
+
+        std::string name;
+        DoubleColumnEncoder encoder;
+        double min = 0;
+        double max = 0;
+    };
+
+    const std::string _timeField;
+    const std::string _metaField;
+    const int _maxCount;
+    const Milliseconds _maxSpan;
+
+    int _count = 0;
+    // The meta field of the measurements as the only element, or empty if they have none.
+    BSONObj _meta;
+    std::unique_ptr<TimestampColumnEncoder> _times;
+    Date_t _minTime;
+    Date_t _maxTime;
+    std::vector<Column> _columns;
+};
+
+/**
+ * Returns the measurements stored in buckets made by a BucketBuilder, each as
+ *
+ *   {<time field>: <Date>, <meta field>: <meta field value>, <field>: <double>, ...}
+ *
+ * Throws a UserException for documents which are not buckets.
+ */
+class BucketUnpacker {
+public:
+    BucketUnpacker(std::string timeField, std::string metaField);
+
+    /**
+     * Starts returning the measurements of 'bucket'.
+     */
+    void reset(const BSONObj& bucket);
+
+    bool more() const {
+        return _remaining > 0;
+    }
+
+    BSONObj next();
+
+private:
+    const std::string _timeField;
+    const std::string _metaField;
+
+    BSONObj _bucket;
+    BSONElement _meta;
+    int _remaining = 0;
+    std::unique_ptr<TimestampColumnDecoder> _times;
+    std::vector<std::pair<StringData, DoubleColumnDecoder>> _columns;
+};
+
+}  // namespace mongo
@@ -0,0 +1,205 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket_compression.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "mongo/platform/bits.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+namespace {
+// Maps signed values of small magnitude to small unsigned ones: 0, -1, 1, -2, ... to 0, 1, 2, 3.
+uint64_t zigZagEncode(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t zigZagDecode(uint64_t value) {
+    return static_cast<int64_t>((value >> 1) ^ (~(value & 1) + 1));
+}
+
+// Wrapping subtraction, timestamps far apart must not overflow.
+int64_t difference(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) - static_cast<uint64_t>(b));
+}
+
+int64_t sum(int64_t a, int64_t b) {
+    return static_cast<int64_t>(static_cast<uint64_t>(a) + static_cast<uint64_t>(b));
+}
+
+// Delta of deltas are stored after a prefix giving their size: '0' for a zero, then '10', '110'
+// and '1110' for zigzagged values below 2^7, 2^9 and 2^12, and '1111' for anything else.
+const int kDeltaOfDeltaBits[] = {7, 9, 12, 64};
+
+// Leading zeros of the XOR of two doubles are stored in 5 bits.
+const int kMaxLeadingZeros = 31;
+}  // namespace
+
+void BitWriter::write(uint64_t bits, int numBits) {
+    invariant(numBits >= 0 && numBits <= 64);
+    while (numBits > 0) {
+        if (_freeBits == 0) {
+            _buffer.push_back(0);
+            _freeBits = 8;
+        }
+        const int n = std::min(numBits, _freeBits);
+        const uint64_t chunk = (bits >> (numBits - n)) & ((1u << n) - 1);
+        _buffer.back() |= static_cast<char>(chunk << (_freeBits - n));
+        _freeBits -= n;
+        numBits -= n;
+    }
+}
+
+uint64_t BitReader::read(int numBits) {
+    invariant(numBits >= 0 && numBits <= 64);
+    uint64_t result = 0;
+    while (numBits > 0) {
+        const size_t byte = _bitOffset / 8;
+        uassert(28821, "truncated time-series bucket column", byte < _buffer.size());
+        const int available = 8 - _bitOffset % 8;
+        const int n = std::min(numBits, available);
+        const uint8_t bits = static_cast<uint8_t>(_buffer[byte]);
+        result = (result << n) | ((bits >> (available - n)) & ((1u << n) - 1));
+        _bitOffset += n;
+        numBits -= n;
+    }
+    return result;
+}
+
+void TimestampColumnEncoder::append(int64_t millis) {
+    if (_count == 0) {
+        _writer.write(millis, 64);
+    } else if (_count == 1) {
+        _lastDelta = difference(millis, _last);
+        _writer.write(_lastDelta, 64);
+    } else {
+        const int64_t delta = difference(millis, _last);
+        const uint64_t deltaOfDelta = zigZagEncode(difference(delta, _lastDelta));
+        if (deltaOfDelta == 0) {
+            _writer.write(0, 1);
+        } else if (deltaOfDelta < (1ULL << 7)) {
+            _writer.write(0x2, 2);
+            _writer.write(deltaOfDelta, 7);
+        } else if (deltaOfDelta < (1ULL << 9)) {
+            _writer.write(0x6, 3);
+            _writer.write(deltaOfDelta, 9);
+        } else if (deltaOfDelta < (1ULL << 12)) {
+            _writer.write(0xe, 4);
+            _writer.write(deltaOfDelta, 12);
+        } else {
+            _writer.write(0xf, 4);
+            _writer.write(deltaOfDelta, 64);
+        }
+        _lastDelta = delta;
+    }
+    _last = millis;
+    _count++;
+}
+
+int64_t TimestampColumnDecoder::next() {
+    if (_count == 0) {
+        _last = _reader.read(64);
+    } else if (_count == 1) {
+        _lastDelta = _reader.read(64);
+        _last = sum(_last, _lastDelta);
+    } else {
+        uint64_t deltaOfDelta = 0;
+        if (_reader.readBit()) {
+            int size = 0;
+            while (size < 3 && _reader.readBit()) {
+                size++;
+            }
+            deltaOfDelta = _reader.read(kDeltaOfDeltaBits[size]);
+        }
+        _lastDelta = sum(_lastDelta, zigZagDecode(deltaOfDelta));
+        _last = sum(_last, _lastDelta);
+    }
+    _count++;
+    return _last;
+}
+
+void DoubleColumnEncoder::append(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    if (_first) {
+        _writer.write(bits, 64);
+        _first = false;
+        _last = bits;
+        return;
+    }
+
+    const uint64_t xored = bits ^ _last;
+    _last = bits;
+    if (xored == 0) {
+        _writer.write(0, 1);
+        return;
+    }
+    _writer.write(1, 1);
+
+    const int leadingZeros = std::min(countLeadingZeros64(xored), kMaxLeadingZeros);
+    const int trailingZeros = countTrailingZeros64(xored);
+    if (_leadingZeros >= 0 && leadingZeros >= _leadingZeros && trailingZeros >= _trailingZeros) {
+        _writer.write(0, 1);
+        _writer.write(xored >> _trailingZeros, 64 - _leadingZeros - _trailingZeros);
+        return;
+    }
+
+    const int meaningfulBits = 64 - leadingZeros - trailingZeros;
+    _writer.write(1, 1);
+    _writer.write(leadingZeros, 5);
+    _writer.write(meaningfulBits - 1, 6);
+    _writer.write(xored >> trailingZeros, meaningfulBits);
+    _leadingZeros = leadingZeros;
+    _trailingZeros = trailingZeros;
+}
+
+double DoubleColumnDecoder::next() {
+    if (_first) {
+        _last = _reader.read(64);
+        _first = false;
+    } else if (_reader.readBit()) {
+        if (_reader.readBit()) {
+            _leadingZeros = _reader.read(5);
+            const int meaningfulBits = _reader.read(6) + 1;
+            _trailingZeros = 64 - _leadingZeros - meaningfulBits;
+            uassert(28822, "corrupt time-series bucket column", _trailingZeros >= 0);
+        }
+        _last ^= _reader.read(64 - _leadingZeros - _trailingZeros) << _trailingZeros;
+    }
+
+    double value;
+    std::memcpy(&value, &_last, sizeof(value));
+    return value;
+}
+
+}  // namespace mongo
@@ -0,0 +1,153 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+/**
+ * Appends values of up to 64 bits to a byte buffer, most significant bit first, without padding
+ * between them.
+ */
+class BitWriter {
+public:
+    /**
+     * Appends the low 'numBits' bits of 'bits'. 'numBits' must be in [0, 64].
+     */
+    void write(uint64_t bits, int numBits);
+
+    /**
+     * The bytes written so far. The last byte is padded with zero bits.
+     */
+    const std::string& buffer() const {
+        return _buffer;
+    }
+
+private:
+    std::string _buffer;
+    // How many bits of the last byte of '_buffer' are unused.
+    int _freeBits = 0;
+};
+
+/**
+ * Reads back the values appended by a BitWriter. Throws a UserException when reading past the
+ * end of the buffer.
+ */
+class BitReader {
+public:
+    explicit BitReader(StringData buffer) : _buffer(buffer) {}
+
+    /**
+     * Reads 'numBits' bits, which must be in [0, 64], as the low bits of the returned value.
+     */
+    uint64_t read(int numBits);
+
+    bool readBit() {
+        return read(1);
+    }
+
+private:
+    StringData _buffer;
+    size_t _bitOffset = 0;
+};
+
+/**
+ * Encodes a column of millisecond timestamps as the deltas between consecutive deltas, which are
+ * zero for measurements taken at a fixed interval, in as few as one bit per timestamp.
+ */
+class TimestampColumnEncoder {
+public:
+    void append(int64_t millis);
+
+    const std::string& buffer() const {
+        return _writer.buffer();
+    }
+
+private:
+    BitWriter _writer;
+    int64_t _count = 0;
+    int64_t _last = 0;
+    int64_t _lastDelta = 0;
+};
+
+class TimestampColumnDecoder {
+public:
+    explicit TimestampColumnDecoder(StringData buffer) : _reader(buffer) {}
+
+    int64_t next();
+
+private:
+    BitReader _reader;
+    int64_t _count = 0;
+    int64_t _last = 0;
+    int64_t _lastDelta = 0;
+};
+
+/**
+ * Encodes a column of doubles as the XOR of each with the previous one, storing only the bits
+ * between the leading and trailing zeros of the XOR. Slowly changing measurements share most of
+ * their sign, exponent and high mantissa bits, so their XORs are mostly zeros.
+ */
+class DoubleColumnEncoder {
+public:
+    void append(double value);
+
+    const std::string& buffer() const {
+        return _writer.buffer();
+    }
+
+private:
+    BitWriter _writer;
+    bool _first = true;
+    uint64_t _last = 0;
+    // The window of meaningful bits of the last XOR stored with its own window, which following
+    // XORs that fit in it reuse.
+    int _leadingZeros = -1;
+    int _trailingZeros = 0;
+};
+
+class DoubleColumnDecoder {
+public:
+    explicit DoubleColumnDecoder(StringData buffer) : _reader(buffer) {}
+
+    double next();
+
+private:
+    BitReader _reader;
+    bool _first = true;
+    uint64_t _last = 0;
+    int _leadingZeros = 0;
+    int _trailingZeros = 0;
+};
+
+}  // namespace mongo
@@ -0,0 +1,185 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/timeseries/bucket.h"
+
+#include <limits>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(BitStream, RoundTripsValuesOfAnyWidth) {
+    BitWriter writer;
+    for (int numBits = 0; numBits <= 64; numBits++) {
+        writer.write(numBits == 64 ? ~0ULL : (1ULL << numBits) - 1 - numBits, numBits);
+    }
+    BitReader reader(writer.buffer());
+    for (int numBits = 0; numBits <= 64; numBits++) {
+        ASSERT_EQUALS(numBits == 64 ? ~0ULL : (1ULL << numBits) - 1 - numBits,
+                      reader.read(numBits));
+    }
+    ASSERT_THROWS(reader.read(8), UserException);
+}
+
+TEST(TimestampColumn, RoundTripsRegularAndIrregularIntervals) {
+    const std::vector<int64_t> times = {1000,
+                                        2000,
+                                        3000,
+                                        4000,
+                                        4001,
+                                        9000,
+                                        8000,
+                                        std::numeric_limits<int64_t>::max(),
+                                        std::numeric_limits<int64_t>::min(),
+                                        0};
+    TimestampColumnEncoder encoder;
+    for (int64_t time : times) {
+        encoder.append(time);
+    }
+    TimestampColumnDecoder decoder(encoder.buffer());
+    for (int64_t time : times) {
+        ASSERT_EQUALS(time, decoder.next());
+    }
+}
+
+TEST(TimestampColumn, FixedIntervalsTakeOneBitEach) {
+    TimestampColumnEncoder encoder;
+    for (int i = 0; i < 1002; i++) {
+        encoder.append(1446000000000LL + i * 1000);
+    }
+    // Two 64 bit values, then a bit for each of the other 1000 timestamps.
+    ASSERT_EQUALS(16U + 125U, encoder.buffer().size());
+}
+
+TEST(DoubleColumn, RoundTripsValues) {
+    const std::vector<double> values = {20.5,
+                                        20.5,
+                                        20.625,
+                                        -3,
+                                        0,
+                                        -0.0,
+                                        1e300,
+                                        std::numeric_limits<double>::infinity(),
+                                        std::numeric_limits<double>::denorm_min(),
+                                        20.5};
+    DoubleColumnEncoder encoder;
+    for (double value : values) {
+        encoder.append(value);
+    }
+    DoubleColumnDecoder decoder(encoder.buffer());
+    for (double value : values) {
+        const double decoded = decoder.next();
+        ASSERT_EQUALS(0, memcmp(&value, &decoded, sizeof(value)));
+    }
+}
+
+TEST(Bucket, RoundTripsMeasurements) {
+    BucketBuilder builder("ts", "sensor", 1000, Hours(1));
+    const Date_t start = Date_t::fromMillisSinceEpoch(1446000000000LL);
+    for (int i = 0; i < 100; i++) {
+        auto added = builder.add(BSON("_id" << i << "sensor" << BSON("id" << 7) << "ts"
+                                            << start + Seconds(i) << "value" << 20 + i % 3
+                                            << "battery" << 3.7));
+        ASSERT_OK(added.getStatus());
+        ASSERT_TRUE(added.getValue());
+    }
+    const BSONObj bucket = builder.done();
+    ASSERT_TRUE(builder.isEmpty());
+
+    ASSERT_EQUALS(BSON("id" << 7), bucket["meta"].Obj());
+    ASSERT_EQUALS(100, bucket["control"]["count"].numberInt());
+    ASSERT_EQUALS(BSON("ts" << start << "value" << 20.0 << "battery" << 3.7),
+                  bucket["control"]["min"].Obj());
+    ASSERT_EQUALS(BSON("ts" << start + Seconds(99) << "value" << 22.0 << "battery" << 3.7),
+                  bucket["control"]["max"].Obj());
+
+    BucketUnpacker unpacker("ts", "sensor");
+    unpacker.reset(bucket);
+    for (int i = 0; i < 100; i++) {
+        ASSERT_TRUE(unpacker.more());
+        ASSERT_EQUALS(BSON("ts" << start + Seconds(i) << "sensor" << BSON("id" << 7) << "value"
+                                << 20.0 + i % 3 << "battery" << 3.7),
+                      unpacker.next());
+    }
+    ASSERT_FALSE(unpacker.more());
+}
+
+TEST(Bucket, RefusesMeasurementsOfOtherBuckets) {
+    BucketBuilder builder("ts", "sensor", 2, Minutes(1));
+    const Date_t start = Date_t::fromMillisSinceEpoch(1446000000000LL);
+    ASSERT_TRUE(builder.add(BSON("sensor" << 1 << "ts" << start << "v" << 1)).getValue());
+
+    ASSERT_FALSE(builder.add(BSON("sensor" << 2 << "ts" << start << "v" << 1)).getValue());
+    ASSERT_FALSE(builder.add(BSON("ts" << start << "v" << 1)).getValue());
+    ASSERT_FALSE(builder.add(BSON("sensor" << 1 << "ts" << start << "w" << 1)).getValue());
+    ASSERT_FALSE(
+        builder.add(BSON("sensor" << 1 << "ts" << start << "v" << 1 << "w" << 1)).getValue());
+    ASSERT_FALSE(builder.add(BSON("sensor" << 1 << "ts" << start + Minutes(1) << "v" << 1))
+                     .getValue());
+    ASSERT_FALSE(builder.add(BSON("sensor" << 1 << "ts" << start - Seconds(1) << "v" << 1))
+                     .getValue());
+
+    ASSERT_TRUE(builder.add(BSON("sensor" << 1 << "ts" << start + Seconds(59) << "v" << 2))
+                    .getValue());
+    ASSERT_FALSE(builder.add(BSON("sensor" << 1 << "ts" << start << "v" << 1)).getValue());
+
+    ASSERT_EQUALS(2, builder.done()["control"]["count"].numberInt());
+}
+
+TEST(Bucket, RejectsInvalidMeasurements) {
+    BucketBuilder builder("ts", "", 1000, Hours(1));
+    ASSERT_NOT_OK(builder.add(BSON("v" << 1)).getStatus());
+    ASSERT_NOT_OK(builder.add(BSON("ts" << 1 << "v" << 1)).getStatus());
+    ASSERT_NOT_OK(builder.add(BSON("ts" << Date_t() << "v"
+                                        << "a")).getStatus());
+    ASSERT_TRUE(builder.isEmpty());
+}
+
+TEST(Bucket, UnpackerRejectsOtherDocuments) {
+    BucketUnpacker unpacker("ts", "");
+    ASSERT_THROWS(unpacker.reset(BSON("a" << 1)), UserException);
+    ASSERT_THROWS(unpacker.reset(BSON("control" << BSON("version" << 2 << "count" << 1) << "data"
+                                                << BSONObj())),
+                  UserException);
+
+    BucketBuilder builder("ts", "", 1000, Hours(1));
+    ASSERT_TRUE(builder.add(BSON("ts" << Date_t() << "v" << 1)).getValue());
+    const BSONObj bucket = builder.done();
+    BSONObjBuilder truncated;
+    truncated.append(bucket["control"]);
+    truncated.append("data", BSON("ts" << BSONBinData("", 0, BinDataGeneral)));
+    unpacker.reset(truncated.obj());
+    ASSERT_THROWS(unpacker.next(), UserException);
+}
+
+}  // namespace
+}  // namespace mongo
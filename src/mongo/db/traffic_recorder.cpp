@@ -0,0 +1,258 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kCommand
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_recorder.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/db/auth/action_set.h"
+#include "mongo/db/auth/action_type.h"
+#include "mongo/db/auth/privilege.h"
+#include "mongo/db/commands.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+
+namespace mongo {
+
+namespace {
+
+// Directory that recordings are written to. Recording is disabled when it is empty, and the
+// commands only accept plain file names, so that they cannot write anywhere else.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(trafficRecordingDirectory, std::string, "");
+
+const long long kDefaultMaxFileSize = 1024 * 1024 * 1024;
+
+TrafficRecorder trafficRecorder;
+
+}  // namespace
+
+TrafficRecorder& TrafficRecorder::get() {
+    return trafficRecorder;
+}
+
+Status TrafficRecorder::start(const std::string& filename, long long maxFileSize) {
+    if (trafficRecordingDirectory.empty()) {
+        return Status(ErrorCodes::IllegalOperation,
+                      "traffic recording requires the trafficRecordingDirectory parameter");
+    }
+    if (filename.empty() || filename.find('/') != std::string::npos ||
+        filename.find('\\') != std::string::npos || filename.find("..") != std::string::npos) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "invalid traffic recording file name: " << filename);
+    }
+    if (maxFileSize <= 0) {
+        return Status(ErrorCodes::BadValue, "maxFileSize must be positive");
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (_out) {
+        return Status(ErrorCodes::ConflictingOperationInProgress,
+                      str::stream() << "already recording traffic to " << _path);
+    }
+
+    const std::string path = trafficRecordingDirectory + "/" + filename;
+    std::unique_ptr<std::ofstream> out(
+        new std::ofstream(path.c_str(), std::ios::out | std::ios::binary | std::ios::trunc));
+    if (!out->is_open()) {
+        return Status(ErrorCodes::FileNotOpen,
+                      str::stream() << "could not open traffic recording file " << path);
+    }
+
+    _path = path;
+    _out = std::move(out);
+    _writer.reset(new TrafficRecordWriter(_out.get()));
+    _started.reset();
+    _maxFileSize = maxFileSize;
+    _bytesWritten = 0;
+    _records = 0;
+    _recording.store(true);
+
+    log() << "recording traffic to " << _path;
+    return Status::OK();
+}
+
+Status TrafficRecorder::stop() {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    if (!_out) {
+        return Status(ErrorCodes::IllegalOperation, "not recording traffic");
+    }
+    _stop_inlock();
+    return Status::OK();
+}
+
+void TrafficRecorder::observeRequest(long long connectionId, const Message& request) {
+    MsgData::View data = request.singleData();
+    _append(connectionId, TrafficRecord::Kind::kRequest, data.view2ptr(), data.getLen());
+}
+
+void TrafficRecorder::observeReply(long long connectionId, const Message& reply) {
+    MsgData::View data = reply.header();
+    _append(connectionId,
+            TrafficRecord::Kind::kReply,
+            data.view2ptr(),
+            TrafficRecord::kMessageHeaderSize);
+}
+
+void TrafficRecorder::report(BSONObjBuilder* builder) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    builder->append("recording", bool(_out));
+    if (_out) {
+        builder->append("file", _path);
+        builder->append("maxFileSize", _maxFileSize);
+    }
+    builder->append("bytesWritten", _bytesWritten);
+    builder->append("records", _records);
+}
+
+void TrafficRecorder::_append(long long connectionId,
+                              TrafficRecord::Kind kind,
+                              const char* data,
+                              size_t len) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    // Recording may have stopped since the caller checked isRecording().
+    if (!_out) {
+        return;
+    }
+
+    _bytesWritten += _writer->append(
+        connectionId, Microseconds(_started.micros()), kind, data, len);
+    ++_records;
+
+    if (!_out->good()) {
+        error() << "failed to write traffic recording " << _path << ", stopping recording";
+        _stop_inlock();
+    } else if (_bytesWritten >= _maxFileSize) {
+        log() << "traffic recording " << _path << " reached its maximum size";
+        _stop_inlock();
+    }
+}
+
+void TrafficRecorder::_stop_inlock() {
+    _recording.store(false);
+    _out->close();
+    _writer.reset();
+    _out.reset();
+    log() << "stopped recording traffic to " << _path << " after " << _records << " records ("
+          << _bytesWritten << " bytes)";
+}
+
+namespace {
+
+class TrafficRecordingCommand : public Command {
+public:
+    TrafficRecordingCommand(const char* name) : Command(name) {}
+    virtual bool slaveOk() const {
+        return true;
+    }
+    virtual bool adminOnly() const {
+        return true;
+    }
+    virtual bool isWriteCommandForConfigServer() const {
+        return false;
+    }
+    virtual void addRequiredPrivileges(const std::string& dbname,
+                                       const BSONObj& cmdObj,
+                                       std::vector<Privilege>* out) {
+        ActionSet actions;
+        actions.addAction(ActionType::diagLogging);
+        out->push_back(Privilege(ResourcePattern::forClusterResource(), actions));
+    }
+};
+
+class CmdStartRecordingTraffic : public TrafficRecordingCommand {
+public:
+    CmdStartRecordingTraffic() : TrafficRecordingCommand("startRecordingTraffic") {}
+
+    virtual void help(std::stringstream& h) const {
+        h << "Records the messages this server receives to a file for mongoreplay.\n"
+          << "{ startRecordingTraffic: 1, filename: <name within trafficRecordingDirectory>,"
+          << " maxFileSize: <bytes, default 1GB> }";
+    }
+
+    virtual bool run(OperationContext* txn,
+                     const std::string& dbname,
+                     BSONObj& cmdObj,
+                     int,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) {
+        BSONElement filename = cmdObj["filename"];
+        if (filename.type() != String) {
+            return appendCommandStatus(
+                result, Status(ErrorCodes::BadValue, "filename must be a string"));
+        }
+
+        long long maxFileSize = kDefaultMaxFileSize;
+        BSONElement maxFileSizeElem = cmdObj["maxFileSize"];
+        if (!maxFileSizeElem.eoo()) {
+            if (!maxFileSizeElem.isNumber()) {
+                return appendCommandStatus(
+                    result, Status(ErrorCodes::BadValue, "maxFileSize must be a number"));
+            }
+            maxFileSize = maxFileSizeElem.safeNumberLong();
+        }
+
+        Status status = TrafficRecorder::get().start(filename.String(), maxFileSize);
+        if (status.isOK()) {
+            TrafficRecorder::get().report(&result);
+        }
+        return appendCommandStatus(result, status);
+    }
+} cmdStartRecordingTraffic;
+
+class CmdStopRecordingTraffic : public TrafficRecordingCommand {
+public:
+    CmdStopRecordingTraffic() : TrafficRecordingCommand("stopRecordingTraffic") {}
+
+    virtual void help(std::stringstream& h) const {
+        h << "Stops recording traffic started by startRecordingTraffic.\n"
+          << "{ stopRecordingTraffic: 1 }";
+    }
+
+    virtual bool run(OperationContext* txn,
+                     const std::string& dbname,
+                     BSONObj& cmdObj,
+                     int,
+                     std::string& errmsg,
+                     BSONObjBuilder& result) {
+        Status status = TrafficRecorder::get().stop();
+        TrafficRecorder::get().report(&result);
+        return appendCommandStatus(result, status);
+    }
+} cmdStopRecordingTraffic;
+
+}  // namespace
+
+}  // namespace mongo
@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/db/traffic_recording.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+class Message;
+
+/**
+ * Records the messages mongod receives, and the headers of its replies, per connection and with
+ * their timing, to a file that mongoreplay can play back against another server. See
+ * TrafficRecord for the format.
+ *
+ * Recording is started and stopped with the startRecordingTraffic and stopRecordingTraffic
+ * commands, into files under the directory named by the trafficRecordingDirectory startup
+ * parameter. It is unavailable when that parameter is not set.
+ */
+class TrafficRecorder {
+    MONGO_DISALLOW_COPYING(TrafficRecorder);
+
+public:
+    TrafficRecorder() = default;
+
+    static TrafficRecorder& get();
+
+    /**
+     * Starts recording to 'filename' within the trafficRecordingDirectory. Recording stops by
+     * itself once the file holds 'maxFileSize' bytes.
+     */
+    Status start(const std::string& filename, long long maxFileSize);
+
+    /**
+     * Stops recording and closes the file.
+     */
+    Status stop();
+
+    /**
+     * Cheap check for the message handler, which only calls the observe methods when it is true.
+     */
+    bool isRecording() const {
+        return _recording.loadRelaxed();
+    }
+
+    void observeRequest(long long connectionId, const Message& request);
+
+    /**
+     * Records the header of 'reply', which must already have been sent, so that its responseTo
+     * is set.
+     */
+    void observeReply(long long connectionId, const Message& reply);
+
+    /**
+     * Appends the state of the recording.
+     */
+    void report(BSONObjBuilder* builder);
+
+private:
+    void _append(long long connectionId,
+                 TrafficRecord::Kind kind,
+                 const char* data,
+                 size_t len);
+
+    void _stop_inlock();
+
+    AtomicWord<bool> _recording{false};
+
+    stdx::mutex _mutex;  // Guards all members below.
+    std::string _path;
+    std::unique_ptr<std::ofstream> _out;
+    std::unique_ptr<TrafficRecordWriter> _writer;
+    Timer _started;
+    long long _maxFileSize = 0;
+    long long _bytesWritten = 0;
+    long long _records = 0;
+};
+
+}  // namespace mongo
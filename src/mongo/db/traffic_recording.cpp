@@ -0,0 +1,129 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/traffic_recording.h"
+
+#include <cstring>
+#include <istream>
+#include <ostream>
+
+#include "mongo/base/data_view.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace {
+
+const char kMagic[] = "MDBTRAF1";
+const size_t kMagicSize = sizeof(kMagic) - 1;
+
+// length, connection id, offset and kind.
+const size_t kRecordHeaderSize = 4 + 8 + 8 + 1;
+
+// Bound on a record's length, so a corrupt length fails cleanly rather than allocating wildly.
+const size_t kMaxRecordSize = kRecordHeaderSize + 64 * 1024 * 1024;
+
+// Offsets of requestID and responseTo in a wire protocol message header.
+const size_t kRequestIdOffset = 4;
+const size_t kResponseToOffset = 8;
+
+}  // namespace
+
+int32_t TrafficRecord::requestId() const {
+    invariant(message.size() >= kMessageHeaderSize);
+    return ConstDataView(message.data()).read<LittleEndian<int32_t>>(kRequestIdOffset);
+}
+
+int32_t TrafficRecord::responseTo() const {
+    invariant(message.size() >= kMessageHeaderSize);
+    return ConstDataView(message.data()).read<LittleEndian<int32_t>>(kResponseToOffset);
+}
+
+TrafficRecordWriter::TrafficRecordWriter(std::ostream* out) : _out(out) {
+    _out->write(kMagic, kMagicSize);
+}
+
+size_t TrafficRecordWriter::append(uint64_t connectionId,
+                                   Microseconds offset,
+                                   TrafficRecord::Kind kind,
+                                   const char* message,
+                                   size_t len) {
+    char header[kRecordHeaderSize];
+    DataView view(header);
+    view.write(tagLittleEndian(static_cast<uint32_t>(kRecordHeaderSize + len)), 0);
+    view.write(tagLittleEndian(connectionId), 4);
+    view.write(tagLittleEndian(static_cast<uint64_t>(durationCount<Microseconds>(offset))), 12);
+    view.write(tagLittleEndian(static_cast<uint8_t>(kind)), 20);
+
+    _out->write(header, sizeof(header));
+    _out->write(message, len);
+    return sizeof(header) + len;
+}
+
+TrafficRecordReader::TrafficRecordReader(std::istream* in) : _in(in) {}
+
+StatusWith<bool> TrafficRecordReader::next(TrafficRecord* record) {
+    if (!_readMagic) {
+        char magic[kMagicSize];
+        if (!_in->read(magic, kMagicSize) || memcmp(magic, kMagic, kMagicSize) != 0) {
+            return Status(ErrorCodes::FailedToParse, "not a traffic recording");
+        }
+        _readMagic = true;
+    }
+
+    char header[kRecordHeaderSize];
+    _in->read(header, sizeof(header));
+    if (_in->gcount() == 0 && _in->eof()) {
+        return false;
+    }
+    if (!*_in) {
+        return Status(ErrorCodes::FailedToParse, "traffic recording ends inside a record");
+    }
+
+    ConstDataView view(header);
+    const uint32_t length = view.read<LittleEndian<uint32_t>>();
+    const uint8_t kind = view.read<LittleEndian<uint8_t>>(20);
+    if (length < kRecordHeaderSize + TrafficRecord::kMessageHeaderSize || length > kMaxRecordSize ||
+        kind > static_cast<uint8_t>(TrafficRecord::Kind::kReply)) {
+        return Status(ErrorCodes::FailedToParse,
+                      str::stream() << "corrupt traffic record of length " << length);
+    }
+
+    record->connectionId = view.read<LittleEndian<uint64_t>>(4);
+    record->offset = Microseconds(view.read<LittleEndian<uint64_t>>(12));
+    record->kind = static_cast<TrafficRecord::Kind>(kind);
+    record->message.resize(length - kRecordHeaderSize);
+    if (!_in->read(&record->message[0], record->message.size())) {
+        return Status(ErrorCodes::FailedToParse, "traffic recording ends inside a record");
+    }
+    return true;
+}
+
+}  // namespace mongo
@@ -0,0 +1,125 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+/**
+ * One message of a traffic recording, as written by mongod's traffic recorder and read by
+ * mongoreplay.
+ *
+ * A recording is the 8 byte magic "MDBTRAF1", followed by records of the form
+ *
+ *     uint32 length of the record, including this field
+ *     uint64 id of the connection the message arrived or left on
+ *     uint64 microseconds since the recording started
+ *     uint8  kind
+ *     bytes  the message
+ *
+ * with integers little endian. A request record holds the whole wire protocol message; a reply
+ * record only holds the reply's 16 byte message header, whose responseTo pairs it with its request.
+ */
+struct TrafficRecord {
+    enum class Kind : uint8_t { kRequest = 0, kReply = 1 };
+
+    static const size_t kMessageHeaderSize = 16;
+
+    /**
+     * Returns the requestID from the header of 'message'.
+     */
+    int32_t requestId() const;
+
+    /**
+     * Returns the responseTo from the header of 'message'.
+     */
+    int32_t responseTo() const;
+
+    uint64_t connectionId = 0;
+    Microseconds offset{0};
+    Kind kind = Kind::kRequest;
+    std::string message;
+};
+
+/**
+ * Writes a traffic recording to a stream. Not thread safe.
+ */
+class TrafficRecordWriter {
+    MONGO_DISALLOW_COPYING(TrafficRecordWriter);
+
+public:
+    /**
+     * Writes the magic that starts a recording to 'out', which must outlive this writer.
+     */
+    explicit TrafficRecordWriter(std::ostream* out);
+
+    /**
+     * Appends a record holding the 'len' bytes at 'message', and returns how many bytes it took.
+     */
+    size_t append(uint64_t connectionId,
+                  Microseconds offset,
+                  TrafficRecord::Kind kind,
+                  const char* message,
+                  size_t len);
+
+private:
+    std::ostream* const _out;
+};
+
+/**
+ * Reads a traffic recording from a stream. Not thread safe.
+ */
+class TrafficRecordReader {
+    MONGO_DISALLOW_COPYING(TrafficRecordReader);
+
+public:
+    /**
+     * Reads from 'in', which must outlive this reader.
+     */
+    explicit TrafficRecordReader(std::istream* in);
+
+    /**
+     * Reads the next record into 'record'. Returns false at the end of the recording, or an error
+     * if the stream does not hold a well formed recording.
+     */
+    StatusWith<bool> next(TrafficRecord* record);
+
+private:
+    std::istream* const _in;
+    bool _readMagic = false;
+};
+
+}  // namespace mongo
@@ -0,0 +1,100 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <sstream>
+
+#include "mongo/base/data_view.h"
+#include "mongo/db/traffic_recording.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+std::string makeMessage(int32_t requestId, int32_t responseTo, const std::string& body) {
+    std::string message(TrafficRecord::kMessageHeaderSize + body.size(), '\0');
+    DataView view(&message[0]);
+    view.write(tagLittleEndian(static_cast<int32_t>(message.size())), 0);
+    view.write(tagLittleEndian(requestId), 4);
+    view.write(tagLittleEndian(responseTo), 8);
+    message.replace(TrafficRecord::kMessageHeaderSize, body.size(), body);
+    return message;
+}
+
+TEST(TrafficRecordingTest, RecordsRoundTrip) {
+    std::stringstream stream;
+    TrafficRecordWriter writer(&stream);
+
+    const std::string request = makeMessage(7, 0, "request body");
+    const std::string reply = makeMessage(100, 7, "");
+    writer.append(
+        3, Microseconds(15), TrafficRecord::Kind::kRequest, request.data(), request.size());
+    writer.append(3, Microseconds(40), TrafficRecord::Kind::kReply, reply.data(), reply.size());
+
+    TrafficRecordReader reader(&stream);
+    TrafficRecord record;
+
+    ASSERT_TRUE(unittest::assertGet(reader.next(&record)));
+    ASSERT_EQUALS(3U, record.connectionId);
+    ASSERT_EQUALS(15, durationCount<Microseconds>(record.offset));
+    ASSERT(record.kind == TrafficRecord::Kind::kRequest);
+    ASSERT_EQUALS(request, record.message);
+    ASSERT_EQUALS(7, record.requestId());
+
+    ASSERT_TRUE(unittest::assertGet(reader.next(&record)));
+    ASSERT(record.kind == TrafficRecord::Kind::kReply);
+    ASSERT_EQUALS(40, durationCount<Microseconds>(record.offset));
+    ASSERT_EQUALS(7, record.responseTo());
+
+    ASSERT_FALSE(unittest::assertGet(reader.next(&record)));
+}
+
+TEST(TrafficRecordingTest, TruncatedRecordFails) {
+    std::stringstream stream;
+    TrafficRecordWriter writer(&stream);
+    const std::string request = makeMessage(1, 0, "body");
+    writer.append(
+        1, Microseconds(0), TrafficRecord::Kind::kRequest, request.data(), request.size());
+
+    std::string contents = stream.str();
+    std::stringstream truncated(contents.substr(0, contents.size() - 2));
+    TrafficRecordReader reader(&truncated);
+    TrafficRecord record;
+    ASSERT_EQUALS(ErrorCodes::FailedToParse, reader.next(&record).getStatus());
+}
+
+TEST(TrafficRecordingTest, RejectsOtherFiles) {
+    std::stringstream stream("not a recording at all");
+    TrafficRecordReader reader(&stream);
+    TrafficRecord record;
+    ASSERT_EQUALS(ErrorCodes::FailedToParse, reader.next(&record).getStatus());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -34,6 +34,9 @@
 
 #include "mongo/db/ttl.h"
 
+#include <algorithm>
+#include <map>
+
 #include "mongo/base/counter.h"
 #include "mongo/db/auth/authorization_session.h"
 #include "mongo/db/auth/user_name.h"
@@ -54,7 +57,10 @@
 #include "mongo/db/query/internal_plans.h"
 #include "mongo/db/repl/replication_coordinator_global.h"
 #include "mongo/db/server_parameters.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/background.h"
+#include "mongo/util/concurrency/thread_pool.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
 
@@ -77,6 +83,103 @@ ServerStatusMetricField<Counter64> ttlDeletedDocumentsDisplay("ttl.deletedDocume
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorEnabled, bool, true);
 MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorSleepSecs, int, 60);  // used for testing
 
+// The most documents deleted under one acquisition of the collection lock. The lock is released
+// between batches so that the deletes of a large backlog are interleaved with other operations.
+// Zero deletes all the expired documents of an index in one batch.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorBatchSize, int, 1000);
+
+// The most documents the TTL monitor deletes per second, summed over all TTL indexes, or zero
+// for no limit. Each delete writes an oplog entry of about the size of the document's _id, so this
+// also bounds the rate at which TTL deletes grow the oplog.
+MONGO_EXPORT_SERVER_PARAMETER(ttlMonitorMaxDeletesPerSecond, int, 0);
+
+// How many TTL indexes have their expired documents deleted at the same time.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(ttlMonitorThreads, int, 4);
+
+namespace {
+
+/**
+ * Spaces out the batches of all the TTL delete tasks so that together they delete no more than
+ * ttlMonitorMaxDeletesPerSecond documents per second.
+ */
+class TTLDeleteThrottle {
+public:
+    /**
+     * Sleeps for as long as 'numDeleted' more deletes take at the permitted rate, after the
+     * deletes of earlier batches have been paid for.
+     */
+    void pay(long long numDeleted) {
+        const int rate = ttlMonitorMaxDeletesPerSecond;
+        if (rate <= 0 || numDeleted <= 0) {
+            return;
+        }
+
+        const Date_t now = Date_t::now();
+        Date_t wakeTime;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _paidUntil = std::max(_paidUntil, now) + Milliseconds(numDeleted * 1000 / rate);
+            wakeTime = _paidUntil;
+        }
+        sleepmillis(durationCount<Milliseconds>(wakeTime - now));
+    }
+
+private:
+    stdx::mutex _mutex;
+    Date_t _paidUntil;
+};
+
+TTLDeleteThrottle ttlDeleteThrottle;
+
+/**
+ * How far behind each TTL index is: the number of seconds since the oldest document which is
+ * still indexed by it expired, as of the last batch deleted through the index. Shown as
+ * serverStatus().metrics.ttl.backlogSecs, keyed by index namespace.
+ */
+class TTLBacklogMetric : public ServerStatusMetric {
+public:
+    TTLBacklogMetric() : ServerStatusMetric("ttl.backlogSecs") {}
+
+    void record(const string& indexNs, long long backlogSecs) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _backlogSecs[indexNs] = backlogSecs;
+    }
+
+    /**
+     * Forgets the indexes which are no longer TTL indexes.
+     */
+    void retain(const set<string>& indexNamespaces) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (auto it = _backlogSecs.begin(); it != _backlogSecs.end();) {
+            if (indexNamespaces.count(it->first)) {
+                ++it;
+            } else {
+                it = _backlogSecs.erase(it);
+            }
+        }
+    }
+
+    void appendAtLeaf(BSONObjBuilder& b) const final {
+        BSONObjBuilder sub(b.subobjStart(_leafName));
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (const auto& entry : _backlogSecs) {
+            sub.appendNumber(entry.first, entry.second);
+        }
+    }
+
+private:
+    mutable stdx::mutex _mutex;
+    std::map<string, long long> _backlogSecs;
+};
+
+TTLBacklogMetric ttlBacklogMetric;
+
+string indexNamespace(const BSONObj& idx) {
+    return idx["ns"].String() + ".$" + idx["name"].String();
+}
+
+}  // namespace
+
 class TTLMonitor : public BackgroundJob {
 public:
     TTLMonitor() {}
@@ -92,8 +195,21 @@ public:
         Client::initThread(name().c_str());
         AuthorizationSession::get(cc())->grantInternalAuthorization();
 
+        ThreadPool::Options options;
+        options.poolName = "TTLMonitorPool";
+        options.threadNamePrefix = "TTLMonitorWorker";
+        options.maxThreads = std::max(1, static_cast<int>(ttlMonitorThreads));
+        ThreadPool pool(options);
+        pool.startup();
+
+        // A pass which runs out of time before deleting every expired document is followed by
+        // another without sleeping, so that a large backlog is deleted continuously.
+        bool backlogged = false;
         while (!inShutdown()) {
-            sleepsecs(ttlMonitorSleepSecs);
+            if (!backlogged) {
+                sleepsecs(ttlMonitorSleepSecs);
+            }
+            backlogged = false;
 
             LOG(3) << "TTLMonitor thread awake" << endl;
 
@@ -110,48 +226,74 @@ public:
             }
 
             try {
-                doTTLPass();
+                backlogged = doTTLPass(&pool);
             } catch (const WriteConflictException& e) {
                 LOG(1) << "Got WriteConflictException in TTL thread";
             }
         }
+
+        pool.shutdown();
+        pool.join();
     }
 
 private:
-    void doTTLPass() {
+    /**
+     * Deletes the expired documents of every TTL index, handing each index to 'pool' as a
+     * separate task. Returns true if any of them was left with expired documents.
+     */
+    bool doTTLPass(ThreadPool* pool) {
         // Count it as active from the moment the TTL thread wakes up
         OperationContextImpl txn;
+        txn.lockState()->setIsBackgroundOperation(true);
 
         // if part of replSet but not in a readable state (e.g. during initial sync), skip.
         if (repl::getGlobalReplicationCoordinator()->getReplicationMode() ==
                 repl::ReplicationCoordinator::modeReplSet &&
             !repl::getGlobalReplicationCoordinator()->getMemberState().readable())
-            return;
+            return false;
 
         set<string> dbs;
         dbHolder().getAllShortNames(dbs);
 
         ttlPasses.increment();
 
+        AtomicWord<bool> backlogged(false);
+        set<string> indexNamespaces;
+        const Date_t deadline = Date_t::now() + Seconds(ttlMonitorSleepSecs);
         for (set<string>::const_iterator i = dbs.begin(); i != dbs.end(); ++i) {
-            string db = *i;
+            const string db = *i;
 
             vector<BSONObj> indexes;
             getTTLIndexesForDB(&txn, db, &indexes);
 
             for (vector<BSONObj>::const_iterator it = indexes.begin(); it != indexes.end(); ++it) {
-                BSONObj idx = *it;
-                try {
-                    if (!doTTLForIndex(&txn, db, idx)) {
-                        break;  // stop processing TTL indexes on this database
+                const BSONObj idx = *it;
+                indexNamespaces.insert(indexNamespace(idx));
+
+                Status scheduled = pool->schedule([this, db, idx, deadline, &backlogged] {
+                    Client::initThreadIfNotAlready("TTLMonitorWorker");
+                    AuthorizationSession::get(cc())->grantInternalAuthorization();
+
+                    OperationContextImpl txn;
+                    txn.lockState()->setIsBackgroundOperation(true);
+                    try {
+                        if (doTTLForIndex(&txn, db, idx, deadline)) {
+                            backlogged.store(true);
+                        }
+                    } catch (const DBException& dbex) {
+                        error() << "Error processing ttl index: " << idx << " -- "
+                                << dbex.toString();
                     }
-                } catch (const DBException& dbex) {
-                    error() << "Error processing ttl index: " << idx << " -- " << dbex.toString();
-                    // continue on to the next index
-                    continue;
+                });
+                if (!scheduled.isOK()) {
+                    error() << "Could not schedule ttl job for: " << idx << " -- " << scheduled;
                 }
             }
         }
+
+        pool->waitForIdle();
+        ttlBacklogMetric.retain(indexNamespaces);
+        return backlogged.load();
     }
 
     /**
@@ -204,22 +346,50 @@ private:
      * after a sufficient amount of time has passed according to its expiry
      * specification.
      *
-     * @return true if caller should continue processing TTL indexes of collections
-     *         on the specified database, and false otherwise
+     * The documents are deleted in batches of at most ttlMonitorBatchSize, releasing the locks
+     * and paying ttlDeleteThrottle between batches, until none are left or 'deadline' passes.
+     *
+     * @return true if expired documents were left behind
+     */
+    bool doTTLForIndex(OperationContext* txn,
+                       const string& dbName,
+                       const BSONObj& idx,
+                       Date_t deadline) {
+        while (!inShutdown() && ttlMonitorEnabled && !lockedForWriting()) {
+            long long numDeleted = 0;
+            if (!doTTLBatchForIndex(txn, dbName, idx, &numDeleted)) {
+                return false;
+            }
+            ttlDeleteThrottle.pay(numDeleted);
+            if (Date_t::now() >= deadline) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * Deletes one batch of expired documents through the TTL index 'idx', and records how far
+     * behind the index is in ttlBacklogMetric.
+     *
+     * @return true if the index still has expired documents to delete
      */
-    bool doTTLForIndex(OperationContext* txn, const string& dbName, BSONObj idx) {
+    bool doTTLBatchForIndex(OperationContext* txn,
+                            const string& dbName,
+                            BSONObj idx,
+                            long long* numDeletedOut) {
         const string ns = idx["ns"].String();
         NamespaceString nss(ns);
         if (!userAllowedWriteNS(nss).isOK()) {
             error() << "namespace '" << ns
                     << "' doesn't allow deletes, skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         BSONObj key = idx["key"].Obj();
         if (key.nFields() != 1) {
             error() << "key for ttl index can only have 1 field, skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         LOG(1) << "TTL -- ns: " << ns << " key: " << key;
@@ -236,7 +406,7 @@ private:
         Collection* collection = db->getCollection(ns);
         if (!collection) {
             // Collection was dropped.
-            return true;
+            return false;
         }
 
         if (!repl::getGlobalReplicationCoordinator()->canAcceptWritesFor(nss)) {
@@ -249,7 +419,7 @@ private:
         if (!desc) {
             LOG(1) << "index not found (index build in progress? index dropped?), skipping "
                    << "ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         // Re-read 'idx' from the descriptor, in case the collection or index definition
@@ -258,7 +428,7 @@ private:
 
         if (IndexType::INDEX_BTREE != IndexNames::nameToType(desc->getAccessMethodName())) {
             error() << "special index can't be used as a ttl index, skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         BSONElement secondsExpireElt = idx[secondsExpireField];
@@ -266,7 +436,7 @@ private:
             error() << "ttl indexes require the " << secondsExpireField << " field to be "
                     << "numeric but received a type of " << typeName(secondsExpireElt.type())
                     << ", skipping ttl job for: " << idx;
-            return true;
+            return false;
         }
 
         const Date_t kDawnOfTime =
@@ -292,6 +462,7 @@ private:
 
         DeleteStageParams params;
         params.isMulti = true;
+        params.limit = ttlMonitorBatchSize;
         params.canonicalQuery = canonicalQuery.getValue().get();
 
         unique_ptr<PlanExecutor> exec =
@@ -308,14 +479,34 @@ private:
         Status result = exec->executePlan();
         if (!result.isOK()) {
             error() << "ttl query execution for index " << idx << " failed with status: " << result;
-            return true;
+            return false;
         }
 
         const long long numDeleted = DeleteStage::getNumDeleted(*exec);
         ttlDeletedDocuments.increment(numDeleted);
+        *numDeletedOut = numDeleted;
         LOG(1) << "\tTTL deleted: " << numDeleted << endl;
 
-        return true;
+        // The first key left in the range is that of the oldest document still to be deleted.
+        unique_ptr<PlanExecutor> backlogExec =
+            InternalPlanner::indexScan(txn,
+                                       collection,
+                                       desc,
+                                       startKey,
+                                       endKey,
+                                       endKeyInclusive,
+                                       PlanExecutor::YIELD_MANUAL,
+                                       direction);
+        BSONObj oldestKey;
+        const bool backlogged =
+            PlanExecutor::ADVANCED == backlogExec->getNext(&oldestKey, NULL);
+        const long long backlogSecs = backlogged
+            ? durationCount<Seconds>(expirationTime - oldestKey.firstElement().date())
+            : 0;
+        ttlBacklogMetric.record(indexNamespace(idx), backlogSecs);
+
+        // Stop if nothing could be deleted, rather than spin on documents which no longer match.
+        return backlogged && numDeleted > 0;
     }
 };
 
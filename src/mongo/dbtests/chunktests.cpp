@@ -60,6 +60,7 @@ public:
         }
 
         _chunkRanges.reloadAll(_chunkMap);
+        _routingTable = ChunkRoutingTable(_chunkMap);
     }
 };
 
@@ -330,6 +331,73 @@ class InMultiShard : public CompoundKeyBase {
     }
 };
 
+/**
+ * Routes shard keys through the chunk routing table, including keys of other types than the split
+ * points and keys equal to a split point, which belong to the chunk it starts.
+ */
+class FindIntersectingChunk {
+public:
+    void run() {
+        TestableChunkManager chunkManager("", ShardKeyPattern(BSON("a" << 1 << "b" << 1)), false);
+        chunkManager.setSingleChunkForShards({BSON("a" << 5 << "b" << 10),
+                                              BSON("a" << 5 << "b" << 20),
+                                              BSON("a"
+                                                   << "x"
+                                                   << "b" << 0)});
+
+        ASSERT_EQUALS("0", shardFor(chunkManager, BSON("a" << MINKEY << "b" << MINKEY)));
+        ASSERT_EQUALS("0", shardFor(chunkManager, BSON("a" << 5 << "b" << 9.5)));
+        ASSERT_EQUALS("1", shardFor(chunkManager, BSON("a" << 5.0 << "b" << 10LL)));
+        ASSERT_EQUALS("1", shardFor(chunkManager, BSON("a" << 5 << "b" << "y")));
+        ASSERT_EQUALS("2", shardFor(chunkManager, BSON("a" << 6 << "b" << 0)));
+        ASSERT_EQUALS("2", shardFor(chunkManager, BSON("a" << "w" << "b" << 1)));
+        ASSERT_EQUALS("3", shardFor(chunkManager, BSON("a" << "x" << "b" << 0)));
+        ASSERT_EQUALS("3", shardFor(chunkManager, BSON("a" << "xx" << "b" << MINKEY)));
+        ASSERT_EQUALS("3", shardFor(chunkManager, BSON("a" << MAXKEY << "b" << 1)));
+    }
+
+private:
+    static ShardId shardFor(const ChunkManager& chunkManager, const BSONObj& shardKey) {
+        return chunkManager.findIntersectingChunk(nullptr, shardKey)->getShardId();
+    }
+};
+
+/**
+ * Splits a $in over the shard key into one query per shard holding only the values routed to it,
+ * and declines to split queries whose values can't all be routed by equality.
+ */
+class SplitQueryByShard {
+public:
+    void run() {
+        TestableChunkManager chunkManager("", ShardKeyPattern(BSON("a" << 1)), false);
+        chunkManager.setSingleChunkForShards({BSON("a"
+                                                   << "x"),
+                                              BSON("a"
+                                                   << "y"),
+                                              BSON("a"
+                                                   << "z")});
+
+        std::map<ShardId, BSONObj> shardQueries;
+        ASSERT(chunkManager.splitQueryByShard(
+            fromjson("{b:1, a:{$in:['u','y','v','zz','yy']}, c:2}"), &shardQueries));
+        ASSERT_EQUALS(3U, shardQueries.size());
+        ASSERT_EQUALS(fromjson("{b:1, a:{$in:['u','v']}, c:2}"), shardQueries["0"]);
+        ASSERT_EQUALS(fromjson("{b:1, a:{$in:['y','yy']}, c:2}"), shardQueries["2"]);
+        ASSERT_EQUALS(fromjson("{b:1, a:{$in:['zz']}, c:2}"), shardQueries["3"]);
+
+        for (const char* query : {"{a:{$in:['u',/y/]}}",
+                                  "{a:{$in:['u',['y']]}}",
+                                  "{a:{$in:[]}}",
+                                  "{a:{$in:['u'], $ne:'v'}}",
+                                  "{a:'u'}",
+                                  "{b:{$in:['u','y']}}"}) {
+            shardQueries.clear();
+            ASSERT_FALSE(chunkManager.splitQueryByShard(fromjson(query), &shardQueries));
+            ASSERT(shardQueries.empty());
+        }
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("chunk") {}
@@ -354,6 +422,8 @@ public:
         add<InequalityThenUnsatisfiable>();
         add<OrEqualityUnsatisfiableInequality>();
         add<InMultiShard>();
+        add<FindIntersectingChunk>();
+        add<SplitQueryByShard>();
     }
 };
 
@@ -55,13 +55,15 @@ static const char* const ns = "unittests.removetests";
 /** Simple test for Helpers::RemoveRange. */
 class RemoveRange {
 public:
-    RemoveRange() : _min(4), _max(8) {}
+    RemoveRange(int min = 4, int max = 8, int numDocs = 10)
+        : _min(min), _max(max), _numDocs(numDocs) {}
 
     void run() {
         OperationContextImpl txn;
         DBDirectClient client(&txn);
 
-        for (int i = 0; i < 10; ++i) {
+        client.remove(ns, BSONObj());
+        for (int i = 0; i < _numDocs; ++i) {
             client.insert(ns, BSON("_id" << i));
         }
 
@@ -86,7 +88,7 @@ private:
         for (int i = 0; i < _min; ++i) {
             bab << BSON("_id" << i);
         }
-        for (int i = _max; i < 10; ++i) {
+        for (int i = _max; i < _numDocs; ++i) {
             bab << BSON("_id" << i);
         }
         return bab.arr();
@@ -103,6 +105,13 @@ private:
     }
     int _min;
     int _max;
+    int _numDocs;
+};
+
+/** Removes a range holding more documents than Helpers::removeRange deletes per batch. */
+class RemoveRangeAcrossBatches : public RemoveRange {
+public:
+    RemoveRangeAcrossBatches() : RemoveRange(10, 300, 400) {}
 };
 
 class All : public Suite {
@@ -110,6 +119,7 @@ public:
     All() : Suite("remove") {}
     void setupTests() {
         add<RemoveRange>();
+        add<RemoveRangeAcrossBatches>();
     }
 } myall;
 
@@ -110,6 +110,32 @@ public:
     }
 };
 
+class FindOneInsertUpdate : ClientBase {
+public:
+    virtual void run() {
+        OperationContextImpl txn;
+        DBDirectClient client(&txn);
+
+        client.dropCollection(ns);
+        client.insert(ns, BSON("_id" << 1 << "x" << 1));
+        client.insert(ns, BSON("_id" << 2 << "x" << 5));
+        ASSERT(client.getLastError().empty());
+
+        client.update(ns, QUERY("_id" << 1), BSON("$set" << BSON("x" << 10)));
+        ASSERT(client.getLastError().empty());
+        client.update(ns, QUERY("_id" << 3), BSON("_id" << 3 << "x" << 0), true, false);
+        ASSERT(client.getLastError().empty());
+        ASSERT_EQUALS((int)client.count(ns), 3);
+
+        ASSERT_EQUALS(client.findOne(ns, QUERY("_id" << 1))["x"].numberInt(), 10);
+        ASSERT_EQUALS(client.findOne(ns, Query().sort("x", 1))["_id"].numberInt(), 3);
+
+        BSONObj fields = BSON("_id" << 0 << "x" << 1);
+        ASSERT_EQUALS(client.findOne(ns, QUERY("_id" << 2), &fields), BSON("x" << 5));
+        ASSERT(client.findOne(ns, QUERY("_id" << 4)).isEmpty());
+    }
+};
+
 class BadNSCmd : ClientBase {
 public:
     virtual void run() {
@@ -137,6 +163,16 @@ public:
     }
 };
 
+class BadNSFindOne : ClientBase {
+public:
+    virtual void run() {
+        OperationContextImpl txn;
+        DBDirectClient client(&txn);
+
+        ASSERT_THROWS(client.findOne("", Query()), UserException);
+    }
+};
+
 class BadNSGetMore : ClientBase {
 public:
     virtual void run() {
@@ -190,8 +226,10 @@ public:
     void setupTests() {
         add<Capped>();
         add<InsertMany>();
+        add<FindOneInsertUpdate>();
         add<BadNSCmd>();
         add<BadNSQuery>();
+        add<BadNSFindOne>();
         add<BadNSGetMore>();
         add<BadNSInsert>();
         add<BadNSUpdate>();
@@ -93,6 +93,66 @@ private:
     Database* _db;
 };
 
+/**
+ * Test for the hashed lookups of IndexCatalog::findIndexByName() and findIndexByKeyPattern().
+ */
+class FindIndex {
+public:
+    FindIndex() {
+        OperationContextImpl txn;
+        ScopedTransaction transaction(&txn, MODE_IX);
+        Lock::DBLock lk(txn.lockState(), nsToDatabaseSubstring(_ns), MODE_X);
+        OldClientContext ctx(&txn, _ns);
+        WriteUnitOfWork wuow(&txn);
+
+        _db = ctx.db();
+        _coll = _db->createCollection(&txn, _ns);
+        _catalog = _coll->getIndexCatalog();
+        wuow.commit();
+    }
+
+    ~FindIndex() {
+        OperationContextImpl txn;
+        ScopedTransaction transaction(&txn, MODE_IX);
+        Lock::DBLock lk(txn.lockState(), nsToDatabaseSubstring(_ns), MODE_X);
+        OldClientContext ctx(&txn, _ns);
+        WriteUnitOfWork wuow(&txn);
+
+        _db->dropCollection(&txn, _ns);
+        wuow.commit();
+    }
+
+    void run() {
+        OperationContextImpl txn;
+        OldClientWriteContext ctx(&txn, _ns);
+
+        dbtests::createIndex(&txn, _ns, BSON("x" << 1));
+        dbtests::createIndex(&txn, _ns, BSON("y" << 1 << "z" << -1));
+
+        IndexDescriptor* desc = _catalog->findIndexByName(&txn, "y_1_z_-1");
+        ASSERT(desc);
+        ASSERT_EQUALS(desc, _catalog->findIndexByKeyPattern(&txn, BSON("y" << 1 << "z" << -1)));
+        // Key patterns compare by value, not by their binary representation.
+        ASSERT_EQUALS(desc, _catalog->findIndexByKeyPattern(&txn, BSON("y" << 1.0 << "z" << -1)));
+        ASSERT_FALSE(_catalog->findIndexByKeyPattern(&txn, BSON("z" << -1 << "y" << 1)));
+        ASSERT_FALSE(_catalog->findIndexByName(&txn, "y_1"));
+
+        {
+            WriteUnitOfWork wuow(&txn);
+            ASSERT_OK(_catalog->dropIndex(&txn, desc));
+            wuow.commit();
+        }
+        ASSERT_FALSE(_catalog->findIndexByName(&txn, "y_1_z_-1"));
+        ASSERT_FALSE(_catalog->findIndexByKeyPattern(&txn, BSON("y" << 1 << "z" << -1)));
+        ASSERT(_catalog->findIndexByKeyPattern(&txn, BSON("x" << 1)));
+    }
+
+private:
+    IndexCatalog* _catalog;
+    Collection* _coll;
+    Database* _db;
+};
+
 /**
  * Test for IndexCatalog::refreshEntry().
  */
@@ -170,6 +230,7 @@ public:
     IndexCatalogTests() : Suite("indexcatalogtests") {}
     void setupTests() {
         add<IndexIteratorTests>();
+        add<FindIndex>();
         add<RefreshEntry>();
     }
 };
@@ -46,10 +46,12 @@
 #include <iostream>
 #include <mutex>
 
+#include "mongo/bson/json.h"
 #include "mongo/config.h"
 #include "mongo/db/client.h"
 #include "mongo/db/db.h"
 #include "mongo/db/dbdirectclient.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/operation_context_impl.h"
 #include "mongo/db/storage/mmap_v1/dur_stats.h"
@@ -59,6 +61,7 @@
 #include "mongo/dbtests/framework_options.h"
 #include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/epoch_manager.h"
 #include "mongo/util/log.h"
 #include "mongo/util/timer.h"
 #include "mongo/util/version.h"
@@ -366,6 +369,7 @@ std::mutex mstd;                  // NOLINT
 std::timed_mutex mstd_timed;      // NOLINT
 SpinLock s;
 stdx::condition_variable c;
+EpochManager epochs;
 
 class boostmutexspeed : public B {
 public:
@@ -444,6 +448,118 @@ public:
     }
 };
 
+class epochguardspeed : public B {
+public:
+    string name() {
+        return "EpochManager::ReadGuard";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        EpochManager::ReadGuard guard(&epochs);
+    }
+};
+class epochretirespeed : public B {
+public:
+    string name() {
+        return "EpochManager::retire";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void timed() {
+        epochs.retire(new int(0));
+    }
+    void post() {
+        epochs.synchronize();
+    }
+};
+
+// A document shaped like a logged CurOp entry, with strings which mostly need no escaping.
+static BSONObj jsonSpeedDoc() {
+    BSONObjBuilder b;
+    b.append("desc", "conn1234");
+    b.append("ns", "test.collection");
+    b.append("query", BSON("name" << "a \"quoted\" value\twith\nescapes" << "n" << 12345));
+    b.append("planSummary", "IXSCAN { name: 1 }");
+    BSONArrayBuilder arr(b.subarrayStart("msgs"));
+    for (int i = 0; i < 20; i++) {
+        arr.append(std::string(100, 'a' + i % 26) + "/path");
+    }
+    arr.done();
+    return b.obj();
+}
+
+class jsonstringspeed : public B {
+    BSONObj _doc;
+
+public:
+    string name() {
+        return "BSONObj::jsonString";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        _doc = jsonSpeedDoc();
+    }
+    void timed() {
+        _doc.jsonString();
+    }
+};
+
+class fromjsonspeed : public B {
+    std::string _json;
+
+public:
+    string name() {
+        return "fromjson";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        _json = jsonSpeedDoc().jsonString();
+    }
+    void timed() {
+        fromjson(_json);
+    }
+};
+
+class hash64speed : public B {
+    BSONObj _doc;
+
+public:
+    string name() {
+        return "BSONElementHasher::hash64";
+    }
+    virtual int howLongMillis() {
+        return 500;
+    }
+    virtual bool showDurStats() {
+        return false;
+    }
+    void prep() {
+        // An ObjectId, as hashed for a {_id: "hashed"} shard key.
+        _doc = BSON("_id" << OID::gen());
+    }
+    void timed() {
+        BSONElementHasher::hash64(_doc.firstElement(), BSONElementHasher::DEFAULT_HASH_SEED);
+    }
+};
 
 class All : public Suite {
 public:
@@ -457,6 +573,11 @@ public:
         add<boosttimed_mutexspeed>();
         add<stdmutexspeed>();
         add<stdtimed_mutexspeed>();
+        add<epochguardspeed>();
+        add<epochretirespeed>();
+        add<jsonstringspeed>();
+        add<fromjsonspeed>();
+        add<hash64speed>();
     }
 } myall;
 }
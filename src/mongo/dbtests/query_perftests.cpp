@@ -0,0 +1,434 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * Microbenchmarks of the query planner and of plan stage trees.
+ *
+ * Each benchmark repeats a unit of work for a fixed time and prints the nanoseconds it took per
+ * plan, translation or document, so that planner and execution costs can be compared across
+ * builds.  Run them with "dbtest queryperf", under the storage engine to measure.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <iomanip>
+#include <iostream>
+
+#include "mongo/db/catalog/collection.h"
+#include "mongo/db/catalog/index_catalog.h"
+#include "mongo/db/client.h"
+#include "mongo/db/db_raii.h"
+#include "mongo/db/dbdirectclient.h"
+#include "mongo/db/exec/collection_scan.h"
+#include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
+#include "mongo/db/exec/sort.h"
+#include "mongo/db/exec/sort_key_generator.h"
+#include "mongo/db/json.h"
+#include "mongo/db/matcher/expression_parser.h"
+#include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/query/get_executor.h"
+#include "mongo/db/query/index_bounds_builder.h"
+#include "mongo/db/query/plan_cache.h"
+#include "mongo/db/query/plan_executor.h"
+#include "mongo/db/query/query_planner.h"
+#include "mongo/db/query/query_planner_params.h"
+#include "mongo/db/query/query_solution.h"
+#include "mongo/dbtests/dbtests.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/timer.h"
+
+namespace QueryPerfTests {
+
+using std::cout;
+using std::endl;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using stdx::make_unique;
+
+/**
+ * A benchmark: timed() does one unit of work and returns the number of items (plans, documents)
+ * it covered, and run() repeats it for a fixed time and reports the time per item.
+ */
+class Benchmark {
+public:
+    virtual ~Benchmark() {}
+
+    void run() {
+        prep();
+
+        long long runMicros = 2 * 1000 * 1000;
+        DEV {
+            // Debug builds are not meaningful to measure, so only check that the benchmark runs.
+            runMicros = 100 * 1000;
+        }
+
+        Timer timer;
+        long long items = 0;
+        do {
+            items += timed();
+        } while (timer.micros() < runMicros);
+
+        cout << "stats " << std::setw(56) << std::left << name() << ' ' << std::right
+             << std::setw(12) << std::fixed << std::setprecision(1)
+             << timer.micros() * 1000.0 / items << " ns/" << unit() << endl;
+    }
+
+protected:
+    virtual string name() const = 0;
+
+    virtual const char* unit() const = 0;
+
+    virtual void prep() {}
+
+    virtual long long timed() = 0;
+};
+
+//
+// Planner benchmarks.
+//
+
+const int kNumFields = 8;
+
+/**
+ * Plans a query against "numIndexes" indexes over the fields a0 to a7.  The first eight are
+ * single-field indexes, and the rest are compound indexes on two of the fields.
+ */
+template <int numIndexes>
+class PlannerBenchmark : public Benchmark {
+protected:
+    virtual BSONObj filter() const = 0;
+
+    virtual const char* unit() const {
+        return "plan";
+    }
+
+    virtual void prep() {
+        _params.options = QueryPlannerParams::INCLUDE_COLLSCAN;
+        for (int i = 0; i < numIndexes; ++i) {
+            BSONObjBuilder keyPattern;
+            keyPattern.append(string(str::stream() << "a" << i % kNumFields), 1);
+            if (i >= kNumFields) {
+                int second = (i + i / kNumFields) % kNumFields;
+                keyPattern.append(string(str::stream() << "a" << second), 1);
+            }
+            _params.indices.push_back(IndexEntry(keyPattern.obj(),
+                                                 false,  // multikey
+                                                 false,  // sparse
+                                                 false,  // unique
+                                                 str::stream() << "index" << i,
+                                                 NULL,  // filterExpr
+                                                 BSONObj()));
+        }
+
+        auto statusWithCQ = CanonicalQuery::canonicalize(NamespaceString("test.perf"), filter());
+        ASSERT_OK(statusWithCQ.getStatus());
+        _cq = std::move(statusWithCQ.getValue());
+    }
+
+    virtual long long timed() {
+        vector<QuerySolution*> solutions;
+        ASSERT_OK(QueryPlanner::plan(*_cq, _params, &solutions));
+        for (auto solution : solutions) {
+            delete solution;
+        }
+        return 1;
+    }
+
+private:
+    QueryPlannerParams _params;
+    unique_ptr<CanonicalQuery> _cq;
+};
+
+template <int numIndexes>
+class PlanEqualities : public PlannerBenchmark<numIndexes> {
+    virtual string name() const {
+        return str::stream() << "QueryPlanner::plan equalities " << numIndexes << " indexes";
+    }
+
+    virtual BSONObj filter() const {
+        return fromjson("{a0: 5, a1: 7}");
+    }
+};
+
+template <int numIndexes>
+class PlanRanges : public PlannerBenchmark<numIndexes> {
+    virtual string name() const {
+        return str::stream() << "QueryPlanner::plan ranges " << numIndexes << " indexes";
+    }
+
+    virtual BSONObj filter() const {
+        return fromjson("{a0: {$gt: 1, $lt: 10}, a2: {$gte: 3}, a3: {$in: [1, 2, 3]}}");
+    }
+};
+
+template <int numIndexes>
+class PlanOrTree : public PlannerBenchmark<numIndexes> {
+    virtual string name() const {
+        return str::stream() << "QueryPlanner::plan $or tree " << numIndexes << " indexes";
+    }
+
+    virtual BSONObj filter() const {
+        return fromjson(
+            "{$or: [{a0: 1, a1: 2}, {a2: {$gt: 3}}, {a3: 4, $or: [{a4: 5}, {a5: {$lt: 6}}]}]}");
+    }
+};
+
+/**
+ * Translates a 1000 element $in into index bounds.
+ */
+class IndexBoundsBuilderIn : public Benchmark {
+    virtual string name() const {
+        return "IndexBoundsBuilder::translate $in of 1000";
+    }
+
+    virtual const char* unit() const {
+        return "translate";
+    }
+
+    virtual void prep() {
+        BSONArrayBuilder values;
+        for (int i = 0; i < 1000; ++i) {
+            values.append(i);
+        }
+        _query = BSON("a" << BSON("$in" << values.arr()));
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(_query);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        _expr = std::move(statusWithMatcher.getValue());
+    }
+
+    virtual long long timed() {
+        IndexEntry index(BSON("a" << 1));
+        OrderedIntervalList oil;
+        IndexBoundsBuilder::BoundsTightness tightness;
+        IndexBoundsBuilder::translate(
+            _expr.get(), index.keyPattern.firstElement(), index, &oil, &tightness);
+        return 1;
+    }
+
+    BSONObj _query;
+    unique_ptr<MatchExpression> _expr;
+};
+
+//
+// Execution benchmarks.
+//
+
+/**
+ * Runs plan stage trees over a collection of "numDocs" documents {_id: i, a: i, b: i % 100}
+ * with indexes on "a" and "b", and reports the time per document returned.
+ */
+template <int numDocs>
+class ExecutionBenchmark : public Benchmark {
+public:
+    ExecutionBenchmark() : _client(&_txn) {}
+
+    virtual ~ExecutionBenchmark() {
+        _client.dropCollection(ns());
+    }
+
+protected:
+    static const char* ns() {
+        return "perftest.QueryPerfTests";
+    }
+
+    virtual const char* unit() const {
+        return "doc";
+    }
+
+    virtual void prep() {
+        _client.dropCollection(ns());
+        for (int i = 0; i < numDocs; ++i) {
+            _client.insert(ns(), BSON("_id" << i << "a" << i << "b" << i % 100));
+        }
+        ASSERT_OK(dbtests::createIndex(&_txn, ns(), BSON("a" << 1)));
+        ASSERT_OK(dbtests::createIndex(&_txn, ns(), BSON("b" << 1)));
+    }
+
+    virtual long long timed() {
+        AutoGetCollectionForRead ctx(&_txn, ns());
+        Collection* collection = ctx.getCollection();
+
+        auto ws = make_unique<WorkingSet>();
+        unique_ptr<PlanStage> root = makeRoot(collection, ws.get());
+        auto statusWithExec = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(root), collection, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithExec.getStatus());
+        return drain(statusWithExec.getValue().get());
+    }
+
+    /**
+     * Returns the root of the stage tree to run, which may keep pointers to members of "this".
+     */
+    virtual unique_ptr<PlanStage> makeRoot(Collection* collection, WorkingSet* ws) = 0;
+
+    static long long drain(PlanExecutor* exec) {
+        long long count = 0;
+        BSONObj obj;
+        while (PlanExecutor::ADVANCED == exec->getNext(&obj, NULL)) {
+            ++count;
+        }
+        return count;
+    }
+
+    unique_ptr<MatchExpression> parse(const BSONObj& filter) {
+        StatusWithMatchExpression statusWithMatcher = MatchExpressionParser::parse(filter);
+        ASSERT_OK(statusWithMatcher.getStatus());
+        return std::move(statusWithMatcher.getValue());
+    }
+
+    OperationContextImpl _txn;
+    DBDirectClient _client;
+};
+
+template <int numDocs>
+class CollectionScanFilter : public ExecutionBenchmark<numDocs> {
+    virtual string name() const {
+        return str::stream() << "CollectionScan with filter " << numDocs << " docs";
+    }
+
+    virtual unique_ptr<PlanStage> makeRoot(Collection* collection, WorkingSet* ws) {
+        _filter = this->parse(BSON("b" << BSON("$gte" << 0)));
+        CollectionScanParams params;
+        params.collection = collection;
+        return make_unique<CollectionScan>(&this->_txn, params, ws, _filter.get());
+    }
+
+    unique_ptr<MatchExpression> _filter;
+};
+
+template <int numDocs>
+class IndexScanFetch : public ExecutionBenchmark<numDocs> {
+    virtual string name() const {
+        return str::stream() << "IndexScan and Fetch " << numDocs << " docs";
+    }
+
+    virtual unique_ptr<PlanStage> makeRoot(Collection* collection, WorkingSet* ws) {
+        IndexScanParams params;
+        params.descriptor =
+            collection->getIndexCatalog()->findIndexByKeyPattern(&this->_txn, BSON("a" << 1));
+        invariant(params.descriptor);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << 0);
+        params.bounds.endKey = BSON("" << numDocs);
+        params.bounds.endKeyInclusive = false;
+        params.direction = 1;
+
+        auto ixscan = make_unique<IndexScan>(&this->_txn, params, ws, nullptr);
+        return make_unique<FetchStage>(&this->_txn, ws, ixscan.release(), nullptr, collection);
+    }
+};
+
+template <int numDocs>
+class SortCollection : public ExecutionBenchmark<numDocs> {
+    virtual string name() const {
+        return str::stream() << "Sort of CollectionScan " << numDocs << " docs";
+    }
+
+    virtual unique_ptr<PlanStage> makeRoot(Collection* collection, WorkingSet* ws) {
+        CollectionScanParams scanParams;
+        scanParams.collection = collection;
+        auto scan = make_unique<CollectionScan>(&this->_txn, scanParams, ws, nullptr);
+
+        SortStageParams params;
+        params.collection = collection;
+        params.pattern = BSON("b" << 1 << "a" << -1);
+        auto keyGen = make_unique<SortKeyGeneratorStage>(
+            &this->_txn, scan.release(), ws, collection, params.pattern, BSONObj());
+        return make_unique<SortStage>(&this->_txn, params, ws, keyGen.release());
+    }
+};
+
+/**
+ * Plans and runs a query with two candidate indexes, clearing the plan cache first so that every
+ * run has to trial both plans in a MultiPlanStage.
+ */
+template <int numDocs>
+class MultiPlanQuery : public ExecutionBenchmark<numDocs> {
+    virtual string name() const {
+        return str::stream() << "MultiPlanStage trial and run " << numDocs << " docs";
+    }
+
+    virtual const char* unit() const {
+        return "query";
+    }
+
+    virtual long long timed() {
+        AutoGetCollectionForRead ctx(&this->_txn, this->ns());
+        Collection* collection = ctx.getCollection();
+        collection->infoCache()->getPlanCache()->clear();
+
+        auto statusWithCQ = CanonicalQuery::canonicalize(
+            NamespaceString(this->ns()), BSON("a" << BSON("$gte" << numDocs / 2) << "b" << 7));
+        ASSERT_OK(statusWithCQ.getStatus());
+        auto statusWithExec = getExecutor(&this->_txn,
+                                          collection,
+                                          std::move(statusWithCQ.getValue()),
+                                          PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithExec.getStatus());
+        this->drain(statusWithExec.getValue().get());
+        return 1;
+    }
+
+    virtual unique_ptr<PlanStage> makeRoot(Collection* collection, WorkingSet* ws) {
+        MONGO_UNREACHABLE;
+    }
+};
+
+class All : public Suite {
+public:
+    All() : Suite("queryperf") {}
+
+    void setupTests() {
+        add<PlanEqualities<5>>();
+        add<PlanEqualities<16>>();
+        add<PlanEqualities<64>>();
+        add<PlanRanges<5>>();
+        add<PlanRanges<16>>();
+        add<PlanRanges<64>>();
+        add<PlanOrTree<5>>();
+        add<PlanOrTree<16>>();
+        add<PlanOrTree<64>>();
+        add<IndexBoundsBuilderIn>();
+
+        add<CollectionScanFilter<1000>>();
+        add<CollectionScanFilter<10000>>();
+        add<IndexScanFetch<1000>>();
+        add<IndexScanFetch<10000>>();
+        add<SortCollection<1000>>();
+        add<SortCollection<10000>>();
+        add<MultiPlanQuery<1000>>();
+        add<MultiPlanQuery<10000>>();
+    }
+};
+
+SuiteInstance<All> all;
+
+}  // namespace QueryPerfTests
@@ -428,6 +428,48 @@ public:
     }
 };
 
+/**
+ * Test that many client cursors can be found by id and are all
+ * invalidated together.
+ */
+class InvalidateMany : public PlanExecutorBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, nss.ns());
+        insert(BSON("a" << 1 << "b" << 1));
+
+        BSONObj filterObj = fromjson("{_id: {$gt: 0}, b: {$gt: 0}}");
+
+        Collection* coll = ctx.getCollection();
+        CursorManager* cursorManager = coll->getCursorManager();
+
+        const size_t numToCreate = 100;
+        std::set<CursorId> createdIds;
+        for (size_t i = 0; i < numToCreate; i++) {
+            PlanExecutor* exec = makeCollScanExec(coll, filterObj);
+            ClientCursor* cc =
+                new ClientCursor(cursorManager, exec, nss.ns(), false, 0, BSONObj());
+            createdIds.insert(cc->cursorid());
+        }
+
+        ASSERT_EQUALS(numToCreate, createdIds.size());
+        ASSERT_EQUALS(numToCreate, numCursors());
+
+        std::set<CursorId> openCursors;
+        cursorManager->getCursorIds(&openCursors);
+        ASSERT(openCursors == createdIds);
+
+        for (CursorId id : createdIds) {
+            ClientCursor* cc = cursorManager->find(id, false);
+            ASSERT(cc);
+            ASSERT_EQUALS(id, cc->cursorid());
+        }
+
+        cursorManager->invalidateAll(false, "InvalidateMany Test");
+        ASSERT_EQUALS(0U, numCursors());
+    }
+};
+
 /**
  * Test that pinned client cursors persist even after
  * invalidation.
@@ -513,6 +555,7 @@ public:
         add<SnapshotControl>();
         add<SnapshotTest>();
         add<ClientCursor::Invalidate>();
+        add<ClientCursor::InvalidateMany>();
         add<ClientCursor::InvalidatePinned>();
         add<ClientCursor::Timeout>();
     }
@@ -455,6 +455,79 @@ public:
     }
 };
 
+// An AND with three children which only intersects RecordIds, as when a FETCH is its parent.
+class QueryStageAndHashThreeLeafRecordIdsOnly : public QueryStageAndBase {
+public:
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+        Database* db = ctx.db();
+        Collection* coll = ctx.getCollection();
+        if (!coll) {
+            WriteUnitOfWork wuow(&_txn);
+            coll = db->createCollection(&_txn, ns());
+            wuow.commit();
+        }
+
+        for (int i = 0; i < 50; ++i) {
+            insert(BSON("foo" << i << "bar" << i << "baz" << i));
+        }
+
+        addIndex(BSON("foo" << 1));
+        addIndex(BSON("bar" << 1));
+        addIndex(BSON("baz" << 1));
+
+        WorkingSet ws;
+        auto ah = make_unique<AndHashStage>(
+            &_txn, &ws, coll, AndHashStage::Mode::kRecordIdsOnly);
+
+        // Foo <= 20
+        IndexScanParams params;
+        params.descriptor = getIndex(BSON("foo" << 1), coll);
+        params.bounds.isSimpleRange = true;
+        params.bounds.startKey = BSON("" << 20);
+        params.bounds.endKey = BSONObj();
+        params.bounds.endKeyInclusive = true;
+        params.direction = -1;
+        ah->addChild(new IndexScan(&_txn, params, &ws, NULL));
+
+        // Bar >= 10
+        params.descriptor = getIndex(BSON("bar" << 1), coll);
+        params.bounds.startKey = BSON("" << 10);
+        params.bounds.endKey = BSONObj();
+        params.bounds.endKeyInclusive = true;
+        params.direction = 1;
+        ah->addChild(new IndexScan(&_txn, params, &ws, NULL));
+
+        // 5 <= baz <= 15
+        params.descriptor = getIndex(BSON("baz" << 1), coll);
+        params.bounds.startKey = BSON("" << 5);
+        params.bounds.endKey = BSON("" << 15);
+        params.bounds.endKeyInclusive = true;
+        params.direction = 1;
+        ah->addChild(new IndexScan(&_txn, params, &ws, NULL));
+
+        // The members returned are those of the last child, so they hold only its keys.
+        int count = 0;
+        while (!ah->isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState status = ah->work(&id);
+            if (PlanStage::ADVANCED != status) {
+                continue;
+            }
+            WorkingSetMember* member = ws.get(id);
+            ASSERT_EQUALS(1U, member->keyData.size());
+            BSONElement elt;
+            ASSERT_TRUE(member->getFieldDotted("baz", &elt));
+            ASSERT_GREATER_THAN_OR_EQUALS(elt.numberInt(), 10);
+            ASSERT_FALSE(member->getFieldDotted("foo", &elt));
+            ++count;
+        }
+
+        // foo == 10, 11, 12, 13, 14, 15.
+        ASSERT_EQUALS(6, count);
+    }
+};
+
 // An AND with three children.
 // Add large keys (512 bytes) to index of last child to verify that
 // keys in last child are not buffered
@@ -1452,6 +1525,7 @@ public:
         add<QueryStageAndHashTwoLeafFirstChildLargeKeys>();
         add<QueryStageAndHashTwoLeafLastChildLargeKeys>();
         add<QueryStageAndHashThreeLeaf>();
+        add<QueryStageAndHashThreeLeafRecordIdsOnly>();
         add<QueryStageAndHashThreeLeafMiddleChildLargeKeys>();
         add<QueryStageAndHashWithNothing>();
         add<QueryStageAndHashProducesNothing>();
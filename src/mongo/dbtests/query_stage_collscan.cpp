@@ -193,6 +193,58 @@ public:
     }
 };
 
+//
+// Documents which fail the filter are skipped without a call to work() for each of them, but the
+// stats still account for every document.
+//
+
+class QueryStageCollscanSkipsUnmatchedDocuments : public QueryStageCollectionScanBase {
+public:
+    void run() {
+        AutoGetCollectionForRead ctx(&_txn, ns());
+
+        CollectionScanParams params;
+        params.collection = ctx.getCollection();
+        params.direction = CollectionScanParams::FORWARD;
+        params.tailable = false;
+
+        StatusWithMatchExpression statusWithMatcher =
+            MatchExpressionParser::parse(BSON("foo" << BSON("$mod" << BSON_ARRAY(10 << 0))));
+        verify(statusWithMatcher.isOK());
+        unique_ptr<MatchExpression> filterExpr = std::move(statusWithMatcher.getValue());
+
+        WorkingSet ws;
+        CollectionScan scan(&_txn, params, &ws, filterExpr.get());
+
+        int calls = 0;
+        vector<int> results;
+        while (!scan.isEOF()) {
+            WorkingSetID id = WorkingSet::INVALID_ID;
+            PlanStage::StageState state = scan.work(&id);
+            ++calls;
+            if (PlanStage::ADVANCED == state) {
+                results.push_back(ws.get(id)->obj.value()["foo"].numberInt());
+                ws.free(id);
+            }
+        }
+
+        ASSERT_EQUALS(5U, results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            ASSERT_EQUALS(static_cast<int>(i) * 10, results[i]);
+        }
+
+        // One call creates the cursor, one call per result and one for EOF.
+        ASSERT_EQUALS(7, calls);
+
+        const CollectionScanStats* stats =
+            static_cast<const CollectionScanStats*>(scan.getSpecificStats());
+        ASSERT_EQUALS(static_cast<size_t>(numObj()), stats->docsTested);
+        unique_ptr<PlanStageStats> planStats = scan.getStats();
+        ASSERT_EQUALS(5U, planStats->common.advanced);
+        ASSERT_GREATER_THAN(planStats->common.works, static_cast<size_t>(numObj()));
+    }
+};
+
 //
 // Get objects in the order we inserted them.
 //
@@ -393,6 +445,7 @@ public:
         add<QueryStageCollscanBasicBackward>();
         add<QueryStageCollscanBasicForwardWithMatch>();
         add<QueryStageCollscanBasicBackwardWithMatch>();
+        add<QueryStageCollscanSkipsUnmatchedDocuments>();
         add<QueryStageCollscanObjectsInOrderForward>();
         add<QueryStageCollscanObjectsInOrderBackward>();
         add<QueryStageCollscanInvalidateUpcomingObject>();
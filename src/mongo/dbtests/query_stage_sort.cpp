@@ -32,11 +32,13 @@
 #include "mongo/db/db_raii.h"
 #include "mongo/db/dbdirectclient.h"
 #include "mongo/db/exec/fetch.h"
+#include "mongo/db/exec/index_scan.h"
 #include "mongo/db/exec/plan_stage.h"
 #include "mongo/db/exec/queued_data_stage.h"
 #include "mongo/db/exec/sort.h"
 #include "mongo/db/json.h"
 #include "mongo/db/operation_context_impl.h"
+#include "mongo/db/query/query_knobs.h"
 #include "mongo/db/query/plan_executor.h"
 #include "mongo/dbtests/dbtests.h"
 #include "mongo/stdx/memory.h"
@@ -573,6 +575,71 @@ public:
     }
 };
 
+// With a limit, an index scan below the sort drops the keys which order after the limit-th
+// document the sort holds, so that they are never fetched.
+class QueryStageSortIndexScanThreshold : public QueryStageSortTestBase {
+public:
+    virtual int numObj() {
+        return 1000;
+    }
+    virtual int limit() const {
+        return 5;
+    }
+
+    void run() {
+        OldClientWriteContext ctx(&_txn, ns());
+        for (int i = 0; i < numObj(); ++i) {
+            insert(BSON("a" << i % 10 << "b" << i));
+        }
+        const BSONObj keyPattern = BSON("a" << 1 << "b" << 1);
+        ASSERT_OK(dbtests::createIndex(&_txn, ns(), keyPattern));
+        Collection* coll = ctx.db()->getCollection(ns());
+        ASSERT(internalQueryExecEnableSortKeyThreshold);
+
+        // Scan the whole index, which is in order of 'a' rather than 'b'.
+        auto ws = make_unique<WorkingSet>();
+        IndexScanParams ixParams;
+        ixParams.descriptor = coll->getIndexCatalog()->findIndexByKeyPattern(&_txn, keyPattern);
+        ixParams.bounds.isSimpleRange = true;
+        ixParams.bounds.startKey = BSON("" << MINKEY << "" << MINKEY);
+        ixParams.bounds.endKey = BSON("" << MAXKEY << "" << MAXKEY);
+        ixParams.bounds.endKeyInclusive = true;
+        ixParams.direction = 1;
+        auto ixScan = make_unique<IndexScan>(&_txn, ixParams, ws.get(), nullptr);
+
+        auto fetchStage =
+            make_unique<FetchStage>(&_txn, ws.get(), ixScan.release(), nullptr, coll);
+        const FetchStats* fetchStats =
+            static_cast<const FetchStats*>(fetchStage->getSpecificStats());
+
+        SortStageParams params;
+        params.collection = coll;
+        params.pattern = BSON("b" << 1);
+        params.limit = limit();
+
+        auto keyGenStage = make_unique<SortKeyGeneratorStage>(
+            &_txn, fetchStage.release(), ws.get(), coll, params.pattern, BSONObj());
+
+        auto sortStage = make_unique<SortStage>(&_txn, params, ws.get(), keyGenStage.release());
+
+        auto statusWithPlanExecutor = PlanExecutor::make(
+            &_txn, std::move(ws), std::move(sortStage), coll, PlanExecutor::YIELD_MANUAL);
+        ASSERT_OK(statusWithPlanExecutor.getStatus());
+        unique_ptr<PlanExecutor> exec = std::move(statusWithPlanExecutor.getValue());
+
+        BSONObj obj;
+        for (int i = 0; i < limit(); ++i) {
+            ASSERT_EQUALS(PlanExecutor::ADVANCED, exec->getNext(&obj, NULL));
+            ASSERT_EQUALS(i, obj["b"].numberInt());
+        }
+        ASSERT_EQUALS(PlanExecutor::IS_EOF, exec->getNext(&obj, NULL));
+
+        // After the first value of 'a', only the few keys which order before the limit-th
+        // document held by the sort are fetched.
+        ASSERT_LESS_THAN(fetchStats->docsExamined, static_cast<size_t>(numObj() / 10));
+    }
+};
+
 class All : public Suite {
 public:
     All() : Suite("query_stage_sort") {}
@@ -590,6 +657,7 @@ public:
         add<QueryStageSortDeletionInvalidationWithLimit<10>>();
         add<QueryStageSortDeletionInvalidationWithLimit<1>>();
         add<QueryStageSortParallelArrays>();
+        add<QueryStageSortIndexScanThreshold>();
     }
 };
 
@@ -35,6 +35,7 @@
 #include "mongo/base/system_error.h"
 #include "mongo/config.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/ssl_manager.h"
 
 #ifdef MONGO_CONFIG_SSL
@@ -69,6 +70,12 @@ void AsyncSecureStream::read(asio::mutable_buffer buffer, StreamHandler&& stream
 }
 
 void AsyncSecureStream::_handleConnect(asio::ip::tcp::resolver::iterator iter) {
+    // Resume the session of the last connection to this server, if there is one, so that
+    // the pool reconnecting does not cost a full handshake per connection.
+    const auto endpoint = iter->endpoint();
+    _remoteEndpoint = str::stream() << endpoint.address().to_string() << ':' << endpoint.port();
+    getSSLManager()->resumeClientSession(_stream.native_handle(), _remoteEndpoint);
+
     _stream.async_handshake(decltype(_stream)::client,
                             [this, iter](std::error_code ec) {
                                 if (ec) {
@@ -83,6 +90,8 @@ void AsyncSecureStream::_handleHandshake(std::error_code ec, const std::string&
         getSSLManager()->parseAndValidatePeerCertificate(_stream.native_handle(), hostName);
     if (!certStatus.isOK()) {
         warning() << certStatus.getStatus();
+    } else {
+        getSSLManager()->saveClientSession(_stream.native_handle(), _remoteEndpoint);
     }
     _userHandler(make_error_code(certStatus.getStatus().code()));
 }
@@ -34,6 +34,7 @@
 
 #include <asio.hpp>
 #include <asio/ssl.hpp>
+#include <string>
 
 #include "mongo/executor/async_stream_interface.h"
 
@@ -60,6 +61,8 @@ private:
 
     asio::ssl::stream<asio::ip::tcp::socket> _stream;
     ConnectHandler _userHandler;
+    // "address:port" of the server, which identifies the session to resume.
+    std::string _remoteEndpoint;
 };
 
 }  // namespace executor
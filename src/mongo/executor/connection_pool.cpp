@@ -29,6 +29,10 @@
 
 #include "mongo/executor/connection_pool.h"
 
+#include <array>
+#include <map>
+#include <set>
+
 #include "mongo/stdx/memory.h"
 #include "mongo/util/assert_util.h"
 #include "mongo/util/scopeguard.h"
@@ -44,6 +48,74 @@
 namespace mongo {
 namespace executor {
 
+namespace {
+
+// Upper bounds of the buckets of the checkout wait histogram, the last of which has none
+const size_t kNumCheckoutWaitBuckets = 5;
+const std::array<Milliseconds, kNumCheckoutWaitBuckets - 1> kCheckoutWaitBounds{
+    {Milliseconds(1), Milliseconds(10), Milliseconds(100), Milliseconds(1000)}};
+const std::array<const char*, kNumCheckoutWaitBuckets> kCheckoutWaitBucketNames{
+    {"0-1ms", "1-10ms", "10-100ms", "100-1000ms", "1000ms+"}};
+
+/**
+ * The stats of the connections to one host, which may be summed over several pools.
+ */
+struct HostStats {
+    void appendTo(BSONObjBuilder* builder) const {
+        builder->appendNumber("inUse", static_cast<long long>(inUse));
+        builder->appendNumber("available", static_cast<long long>(available));
+        builder->appendNumber("pending", static_cast<long long>(pending));
+        builder->appendNumber("waiting", static_cast<long long>(waiting));
+        builder->appendNumber("created", created);
+
+        BSONObjBuilder waitsBob(builder->subobjStart("checkoutWaits"));
+        for (size_t i = 0; i < checkoutWaits.size(); ++i) {
+            waitsBob.appendNumber(kCheckoutWaitBucketNames[i], checkoutWaits[i]);
+        }
+        waitsBob.done();
+    }
+
+    size_t inUse = 0;
+    size_t available = 0;
+    size_t pending = 0;
+    size_t waiting = 0;
+    long long created = 0;
+    std::array<long long, kNumCheckoutWaitBuckets> checkoutWaits{};
+};
+
+using HostStatsMap = std::map<std::string, HostStats>;
+
+void appendHostStats(const HostStatsMap& stats, BSONObjBuilder* builder) {
+    HostStats totals;
+
+    BSONObjBuilder hostsBob(builder->subobjStart("hosts"));
+    for (const auto& host : stats) {
+        BSONObjBuilder hostBob(hostsBob.subobjStart(host.first));
+        host.second.appendTo(&hostBob);
+        hostBob.done();
+
+        totals.inUse += host.second.inUse;
+        totals.available += host.second.available;
+        totals.pending += host.second.pending;
+        totals.waiting += host.second.waiting;
+        totals.created += host.second.created;
+        for (size_t i = 0; i < totals.checkoutWaits.size(); ++i) {
+            totals.checkoutWaits[i] += host.second.checkoutWaits[i];
+        }
+    }
+    hostsBob.done();
+
+    BSONObjBuilder totalsBob(builder->subobjStart("totals"));
+    totals.appendTo(&totalsBob);
+    totalsBob.done();
+}
+
+// All the connection pools in the process, for appendAllStats
+stdx::mutex allPoolsMutex;
+std::set<ConnectionPool*> allPools;
+
+}  // namespace
+
 /**
  * A pool for a specific HostAndPort
  *
@@ -78,13 +150,22 @@ public:
      */
     void returnConnection(ConnectionInterface* connection, stdx::unique_lock<stdx::mutex> lk);
 
+    /**
+     * Adds the stats of the pool to 'stats'. Must be called with the parent's _mutex held.
+     */
+    void appendStats(HostStats* stats) const;
+
 private:
     using OwnedConnection = std::unique_ptr<ConnectionInterface>;
     using OwnershipPool = std::unordered_map<ConnectionInterface*, OwnedConnection>;
-    using Request = std::pair<Date_t, GetConnectionCallback>;
+    struct Request {
+        Date_t expiration;
+        Date_t requestedAt;
+        GetConnectionCallback cb;
+    };
     struct RequestComparator {
         bool operator()(const Request& a, const Request& b) {
-            return a.first > b.first;
+            return a.expiration > b.expiration;
         }
     };
 
@@ -101,6 +182,8 @@ private:
 
     void updateStateInLock();
 
+    void noteCheckoutWait(Milliseconds wait);
+
 private:
     ConnectionPool* const _parent;
 
@@ -118,6 +201,10 @@ private:
     size_t _generation;
     bool _inFulfillRequests;
 
+    // Connections made over the life of the pool, and requests by how long they waited for one
+    long long _created = 0;
+    std::array<long long, kNumCheckoutWaitBuckets> _checkoutWaits{};
+
     /**
      * The current state of the pool
      *
@@ -151,9 +238,42 @@ Milliseconds const ConnectionPool::kDefaultRefreshRequirement = Minutes(5);
 Milliseconds const ConnectionPool::kDefaultHostTimeout = Minutes(5);
 
 ConnectionPool::ConnectionPool(std::unique_ptr<DependentTypeFactoryInterface> impl, Options options)
-    : _options(std::move(options)), _factory(std::move(impl)) {}
+    : _options(std::move(options)), _factory(std::move(impl)) {
+    stdx::lock_guard<stdx::mutex> lk(allPoolsMutex);
+    allPools.insert(this);
+}
+
+ConnectionPool::~ConnectionPool() {
+    stdx::lock_guard<stdx::mutex> lk(allPoolsMutex);
+    allPools.erase(this);
+}
+
+void ConnectionPool::appendStats(BSONObjBuilder* builder) {
+    HostStatsMap stats;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        for (const auto& pool : _pools) {
+            pool.second->appendStats(&stats[pool.first.toString()]);
+        }
+    }
+
+    appendHostStats(stats, builder);
+}
+
+void ConnectionPool::appendAllStats(BSONObjBuilder* builder) {
+    HostStatsMap stats;
+    {
+        stdx::lock_guard<stdx::mutex> allPoolsLk(allPoolsMutex);
+        for (ConnectionPool* parent : allPools) {
+            stdx::lock_guard<stdx::mutex> lk(parent->_mutex);
+            for (const auto& pool : parent->_pools) {
+                pool.second->appendStats(&stats[pool.first.toString()]);
+            }
+        }
+    }
 
-ConnectionPool::~ConnectionPool() = default;
+    appendHostStats(stats, builder);
+}
 
 void ConnectionPool::dropConnections(const HostAndPort& hostAndPort) {
     stdx::unique_lock<stdx::mutex> lk(_mutex);
@@ -215,9 +335,9 @@ void ConnectionPool::SpecificPool::getConnection(const HostAndPort& hostAndPort,
                                                  Milliseconds timeout,
                                                  stdx::unique_lock<stdx::mutex> lk,
                                                  GetConnectionCallback cb) {
-    auto expiration = _parent->_factory->now() + timeout;
+    auto now = _parent->_factory->now();
 
-    _requests.push(make_pair(expiration, std::move(cb)));
+    _requests.push(Request{now + timeout, now, std::move(cb)});
 
     updateStateInLock();
 
@@ -250,8 +370,10 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
         // If we need to refresh this connection
 
         if (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() >=
-            _parent->_options.minConnections) {
-            // If we already have minConnections, just let the connection lapse
+                _parent->_options.minConnections &&
+            _readyPool.size() >= _parent->_options.minIdleConnections) {
+            // If we already have minConnections and minIdleConnections, just let the connection
+            // lapse
             return;
         }
 
@@ -294,6 +416,25 @@ void ConnectionPool::SpecificPool::returnConnection(ConnectionInterface* connPtr
     updateStateInLock();
 }
 
+void ConnectionPool::SpecificPool::appendStats(HostStats* stats) const {
+    stats->inUse += _checkedOutPool.size();
+    stats->available += _readyPool.size();
+    stats->pending += _processingPool.size();
+    stats->waiting += _requests.size();
+    stats->created += _created;
+    for (size_t i = 0; i < _checkoutWaits.size(); ++i) {
+        stats->checkoutWaits[i] += _checkoutWaits[i];
+    }
+}
+
+void ConnectionPool::SpecificPool::noteCheckoutWait(Milliseconds wait) {
+    size_t bucket = 0;
+    while (bucket < kCheckoutWaitBounds.size() && wait >= kCheckoutWaitBounds[bucket]) {
+        ++bucket;
+    }
+    ++_checkoutWaits[bucket];
+}
+
 // Adds a live connection to the ready pool
 void ConnectionPool::SpecificPool::addToReady(stdx::unique_lock<stdx::mutex>& lk,
                                               OwnedConnection conn) {
@@ -356,7 +497,7 @@ void ConnectionPool::SpecificPool::processFailure(const Status& status,
     lk.unlock();
 
     while (requestsToFail.size()) {
-        requestsToFail.top().second(status);
+        requestsToFail.top().cb(status);
         requestsToFail.pop();
     }
 }
@@ -383,7 +524,8 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
         conn->cancelTimeout();
 
         // Grab the request and callback
-        auto cb = std::move(_requests.top().second);
+        auto cb = std::move(_requests.top().cb);
+        noteCheckoutWait(_parent->_factory->now() - _requests.top().requestedAt);
         _requests.pop();
 
         updateStateInLock();
@@ -401,22 +543,27 @@ void ConnectionPool::SpecificPool::fulfillRequests(stdx::unique_lock<stdx::mutex
 }
 
 // spawn enough connections to satisfy open requests and minpool, while
-// honoring maxpool
+// honoring maxpool and the limit on connections in setup at once
 void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mutex>& lk,
                                                     const HostAndPort& hostAndPort) {
-    // We want minConnections <= outstanding requests <= maxConnections
+    // We want minConnections <= outstanding requests + minIdleConnections <= maxConnections
     auto target = [&] {
-        return std::max(
-            _parent->_options.minConnections,
-            std::min(_requests.size() + _checkedOutPool.size(), _parent->_options.maxConnections));
+        return std::max(_parent->_options.minConnections,
+                        std::min(_requests.size() + _checkedOutPool.size() +
+                                     _parent->_options.minIdleConnections,
+                                 _parent->_options.maxConnections));
     };
 
-    // While all of our inflight connections are less than our target
-    while (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() < target()) {
+    // While all of our inflight connections are less than our target. Requests which can't get a
+    // new connection because too many are already in setup wait for one of those, or for a
+    // connection to be returned, instead.
+    while (_readyPool.size() + _processingPool.size() + _checkedOutPool.size() < target() &&
+           _processingPool.size() < _parent->_options.maxConnecting) {
         // make a new connection and put it in processing
         auto handle = _parent->_factory->makeConnection(hostAndPort, _generation);
         auto connPtr = handle.get();
         _processingPool[connPtr] = std::move(handle);
+        ++_created;
 
         // Run the setup callback
         lk.unlock();
@@ -436,6 +583,13 @@ void ConnectionPool::SpecificPool::spawnConnections(stdx::unique_lock<stdx::mute
                            } else {
                                // If the setup failed, cascade the failure edge
                                processFailure(status, std::move(lk));
+                               return;
+                           }
+
+                           // Now that this connection is out of setup, another
+                           // one may be needed
+                           if (_state != State::kInShutdown) {
+                               spawnConnections(lk, _hostAndPort);
                            }
                        });
         // Note that this assumes that the refreshTimeout is sound for the
@@ -491,16 +645,16 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
 
         // If we were already running and the timer is the same as it was
         // before, nothing to do
-        if (_state == State::kRunning && _requestTimerExpiration == _requests.top().first)
+        if (_state == State::kRunning && _requestTimerExpiration == _requests.top().expiration)
             return;
 
         _state = State::kRunning;
 
         _requestTimer->cancelTimeout();
 
-        _requestTimerExpiration = _requests.top().first;
+        _requestTimerExpiration = _requests.top().expiration;
 
-        auto timeout = _requests.top().first - _parent->_factory->now();
+        auto timeout = _requests.top().expiration - _parent->_factory->now();
 
         // We set a timer for the most recent request, then invoke each timed
         // out request we couldn't service
@@ -514,8 +668,8 @@ void ConnectionPool::SpecificPool::updateStateInLock() {
                 while (_requests.size()) {
                     auto& x = _requests.top();
 
-                    if (x.first <= now) {
-                        auto cb = std::move(x.second);
+                    if (x.expiration <= now) {
+                        auto cb = std::move(x.cb);
                         _requests.pop();
 
                         lk.unlock();
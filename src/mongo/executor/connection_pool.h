@@ -32,6 +32,7 @@
 #include <queue>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobjbuilder.h"
 #include "mongo/stdx/chrono.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/mutex.h"
@@ -82,6 +83,21 @@ public:
          */
         size_t maxConnections = std::numeric_limits<size_t>::max();
 
+        /**
+         * The number of available connections to keep on top of those in
+         * use while a host is active, so that rising load finds connections
+         * already set up rather than waiting on new ones.
+         */
+        size_t minIdleConnections = 0;
+
+        /**
+         * The maximum number of connections to a host which may be in setup
+         * at once. Requests beyond those wait for a connection to finish setup
+         * or to be returned, so that a burst of requests reuses a few
+         * connections rather than opening one each.
+         */
+        size_t maxConnecting = std::numeric_limits<size_t>::max();
+
         /**
          * Amount of time to wait before timing out a refresh attempt
          */
@@ -111,8 +127,18 @@ public:
     void get(const HostAndPort& hostAndPort, Milliseconds timeout, GetConnectionCallback cb);
 
     /**
-     * TODO add a function returning connection pool stats
+     * Appends, for each host, the number of connections in use, available
+     * and in setup or refresh, the number of requests waiting for one, the
+     * number of connections created and a histogram of how long requests
+     * waited to get a connection.
+     */
+    void appendStats(BSONObjBuilder* builder);
+
+    /**
+     * Appends the stats of all the connection pools in the process, summed
+     * by host.
      */
+    static void appendAllStats(BSONObjBuilder* builder);
 
 private:
     void returnConnection(ConnectionInterface* connection);
@@ -405,6 +405,141 @@ TEST_F(ConnectionPoolTest, maxPoolRespected) {
     ASSERT_EQ(conn1Ptr, conn3.get());
 }
 
+/**
+ * Verify that we respect maxConnecting
+ */
+TEST_F(ConnectionPoolTest, maxConnectingRespected) {
+    ConnectionPool::Options options;
+    options.maxConnecting = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), options);
+
+    ConnectionPool::ConnectionHandle conn1;
+    ConnectionPool::ConnectionHandle conn2;
+
+    // Make 2 requests, each which keep their connection
+    pool.get(HostAndPort(),
+             Milliseconds(1000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn1 = std::move(swConn.getValue());
+             });
+    pool.get(HostAndPort(),
+             Milliseconds(2000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn2 = std::move(swConn.getValue());
+             });
+
+    // Only one connection is in setup at a time
+    ASSERT_EQ(1u, ConnectionImpl::setupQueueDepth());
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+    ASSERT(!conn2);
+    ASSERT_EQ(1u, ConnectionImpl::setupQueueDepth());
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn2);
+    ASSERT_EQ(0u, ConnectionImpl::setupQueueDepth());
+}
+
+/**
+ * Verify that minIdleConnections are kept on top of the connections in use
+ */
+TEST_F(ConnectionPoolTest, minIdleRespected) {
+    ConnectionPool::Options options;
+    options.minIdleConnections = 1;
+    ConnectionPool pool(stdx::make_unique<PoolImpl>(), options);
+
+    ConnectionPool::ConnectionHandle conn1;
+    ConnectionPool::ConnectionHandle conn2;
+
+    // One connection for the request and one to keep available
+    pool.get(HostAndPort(),
+             Milliseconds(1000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn1 = std::move(swConn.getValue());
+             });
+    ASSERT_EQ(2u, ConnectionImpl::setupQueueDepth());
+
+    ConnectionImpl::pushSetup(Status::OK());
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+
+    // The next request takes the available connection right away, and another is set up
+    pool.get(HostAndPort(),
+             Milliseconds(1000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn2 = std::move(swConn.getValue());
+             });
+    ASSERT(conn2);
+    ASSERT_NE(conn1.get(), conn2.get());
+    ASSERT_EQ(1u, ConnectionImpl::setupQueueDepth());
+}
+
+/**
+ * Verify that the stats count connections and checkout waits
+ */
+TEST_F(ConnectionPoolTest, statsReported) {
+    ConnectionPool pool(stdx::make_unique<PoolImpl>());
+
+    auto now = Date_t::now();
+    PoolImpl::setNow(now);
+
+    const HostAndPort host("localhost:30000");
+    ConnectionPool::ConnectionHandle conn1;
+    pool.get(host,
+             Milliseconds(1000),
+             [&](StatusWith<ConnectionPool::ConnectionHandle> swConn) {
+                 ASSERT(swConn.isOK());
+
+                 conn1 = std::move(swConn.getValue());
+             });
+
+    {
+        BSONObjBuilder bob;
+        pool.appendStats(&bob);
+        BSONObj stats = bob.obj();
+        BSONObj hostStats = stats["hosts"][host.toString()].Obj();
+        ASSERT_EQ(0, hostStats["inUse"].numberInt());
+        ASSERT_EQ(1, hostStats["pending"].numberInt());
+        ASSERT_EQ(1, hostStats["waiting"].numberInt());
+    }
+
+    // The request waits 20ms for its connection
+    PoolImpl::setNow(now + Milliseconds(20));
+    ConnectionImpl::pushSetup(Status::OK());
+    ASSERT(conn1);
+
+    BSONObjBuilder bob;
+    pool.appendStats(&bob);
+    BSONObj stats = bob.obj();
+    BSONObj hostStats = stats["hosts"][host.toString()].Obj();
+    ASSERT_EQ(1, hostStats["inUse"].numberInt());
+    ASSERT_EQ(0, hostStats["available"].numberInt());
+    ASSERT_EQ(0, hostStats["pending"].numberInt());
+    ASSERT_EQ(0, hostStats["waiting"].numberInt());
+    ASSERT_EQ(1, hostStats["created"].numberInt());
+    ASSERT_EQ(0, hostStats["checkoutWaits"]["1-10ms"].numberInt());
+    ASSERT_EQ(1, hostStats["checkoutWaits"]["10-100ms"].numberInt());
+    ASSERT_EQ(1, stats["totals"]["inUse"].numberInt());
+
+    conn1.reset();
+
+    BSONObjBuilder returnedBob;
+    pool.appendStats(&returnedBob);
+    stats = returnedBob.obj();
+    hostStats = stats["hosts"][host.toString()].Obj();
+    ASSERT_EQ(0, hostStats["inUse"].numberInt());
+    ASSERT_EQ(1, hostStats["available"].numberInt());
+}
+
 /**
  * Verify that minConnections is respected
  */
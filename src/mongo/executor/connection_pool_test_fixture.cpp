@@ -104,9 +104,7 @@ void ConnectionImpl::pushSetup(PushSetupCallback status) {
     _pushSetupQueue.push_back(status);
 
     if (_setupQueue.size()) {
-        _setupQueue.front()->_setupCallback(_setupQueue.front(), _pushSetupQueue.front()());
-        _setupQueue.pop_front();
-        _pushSetupQueue.pop_front();
+        runNextSetup();
     }
 }
 
@@ -114,6 +112,20 @@ void ConnectionImpl::pushSetup(Status status) {
     pushSetup([status]() { return status; });
 }
 
+void ConnectionImpl::runNextSetup() {
+    // Dequeue first, as the setup callback may start the setup of another connection
+    auto connPtr = _setupQueue.front();
+    auto pushSetup = std::move(_pushSetupQueue.front());
+    _setupQueue.pop_front();
+    _pushSetupQueue.pop_front();
+
+    connPtr->_setupCallback(connPtr, pushSetup());
+}
+
+size_t ConnectionImpl::setupQueueDepth() {
+    return _setupQueue.size();
+}
+
 void ConnectionImpl::pushRefresh(PushRefreshCallback status) {
     _pushRefreshQueue.push_back(status);
 
@@ -154,9 +166,7 @@ void ConnectionImpl::setup(Milliseconds timeout, SetupCallback cb) {
     _setupQueue.push_back(this);
 
     if (_pushSetupQueue.size()) {
-        _setupQueue.front()->_setupCallback(_setupQueue.front(), _pushSetupQueue.front()());
-        _setupQueue.pop_front();
-        _pushSetupQueue.pop_front();
+        runNextSetup();
     }
 }
 
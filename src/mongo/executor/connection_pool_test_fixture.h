@@ -97,7 +97,13 @@ public:
     static void pushRefresh(PushRefreshCallback status);
     static void pushRefresh(Status status);
 
+    // The number of connections waiting for their setup to be pushed
+    static size_t setupQueueDepth();
+
 private:
+    // Complete the setup of the first queued connection with the first pushed status
+    static void runNextSetup();
+
     Date_t getLastUsed() const override;
 
     const Status& getStatus() const override;
@@ -0,0 +1,225 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <boost/optional.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status_with.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/executor/remote_command_response.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+namespace executor {
+
+template <typename T>
+class Deferred;
+
+namespace deferred_detail {
+
+template <typename R>
+struct ValueTypeOf;
+
+template <typename U>
+struct ValueTypeOf<StatusWith<U>> {
+    using type = U;
+};
+
+template <typename U>
+struct ValueTypeOf<Deferred<U>> {
+    using type = U;
+};
+
+}  // namespace deferred_detail
+
+/**
+ * A result which becomes available at some later time, such as the response of a remote command.
+ *
+ * Work which depends on the result is chained with then() or thenAsync(). Each continuation runs
+ * on a TaskExecutor once the result it needs is ready, so a multi-step flow waits on the network
+ * without holding a thread. An error, including the executor refusing or canceling the
+ * continuation, skips the remaining continuations and becomes the result of the chain.
+ *
+ * Deferred is a handle to shared state. Copies refer to the same result, which must be set
+ * exactly once with emplace().
+ */
+template <typename T>
+class Deferred {
+public:
+    Deferred() : _state(std::make_shared<State>()) {}
+
+    /**
+     * Returns a Deferred whose result is already 'result'.
+     */
+    static Deferred<T> makeReady(StatusWith<T> result) {
+        Deferred<T> deferred;
+        deferred.emplace(std::move(result));
+        return deferred;
+    }
+
+    /**
+     * Sets the result and runs the continuations waiting for it on the calling thread. Each of
+     * them only schedules work on its executor.
+     */
+    void emplace(StatusWith<T> result) const {
+        std::vector<Continuation> continuations;
+        {
+            stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+            invariant(!_state->result);
+            _state->result.emplace(std::move(result));
+            continuations.swap(_state->continuations);
+            _state->condition.notify_all();
+        }
+        for (auto&& continuation : continuations) {
+            continuation(*_state->result);
+        }
+    }
+
+    bool isReady() const {
+        stdx::lock_guard<stdx::mutex> lk(_state->mutex);
+        return static_cast<bool>(_state->result);
+    }
+
+    /**
+     * Blocks until the result is set and returns it. Must not be called from a thread of an
+     * executor which has to run for the result to become ready.
+     */
+    StatusWith<T> get() const {
+        stdx::unique_lock<stdx::mutex> lk(_state->mutex);
+        _state->condition.wait(lk, [this] { return static_cast<bool>(_state->result); });
+        return *_state->result;
+    }
+
+    /**
+     * Schedules 'fn' on 'executor' with the value once it is ready. 'fn' takes a const T& and
+     * returns a StatusWith<U>, which becomes the result of the returned Deferred<U>.
+     */
+    template <typename Fn,
+              typename U = typename deferred_detail::ValueTypeOf<
+                  typename std::result_of<Fn(const T&)>::type>::type>
+    Deferred<U> then(TaskExecutor* executor, Fn fn) const {
+        Deferred<U> next;
+        _schedule(executor,
+                  next,
+                  [fn, next](const T& value) { next.emplace(fn(value)); });
+        return next;
+    }
+
+    /**
+     * Like then(), but 'fn' starts further asynchronous work and returns a Deferred<U> for it.
+     * The returned Deferred becomes ready when that one does.
+     */
+    template <typename Fn,
+              typename U = typename deferred_detail::ValueTypeOf<
+                  typename std::result_of<Fn(const T&)>::type>::type>
+    Deferred<U> thenAsync(TaskExecutor* executor, Fn fn) const {
+        Deferred<U> next;
+        _schedule(executor,
+                  next,
+                  [fn, next](const T& value) {
+                      fn(value)._onReady([next](const StatusWith<U>& result) {
+                          next.emplace(result);
+                      });
+                  });
+        return next;
+    }
+
+private:
+    template <typename>
+    friend class Deferred;
+
+    using Continuation = stdx::function<void(const StatusWith<T>&)>;
+
+    struct State {
+        stdx::mutex mutex;
+        stdx::condition_variable condition;
+        boost::optional<StatusWith<T>> result;
+        std::vector<Continuation> continuations;
+    };
+
+    /**
+     * Runs 'continuation' with the result, immediately if it is already set.
+     */
+    void _onReady(Continuation continuation) const {
+        stdx::unique_lock<stdx::mutex> lk(_state->mutex);
+        if (!_state->result) {
+            _state->continuations.push_back(std::move(continuation));
+            return;
+        }
+        lk.unlock();
+        continuation(*_state->result);
+    }
+
+    /**
+     * Once the result is ready, schedules 'work' on 'executor' with the value, or fails 'next'
+     * with the error of the result, of scheduling, or of the callback.
+     */
+    template <typename U>
+    void _schedule(TaskExecutor* executor,
+                   const Deferred<U>& next,
+                   stdx::function<void(const T&)> work) const {
+        _onReady([executor, next, work](const StatusWith<T>& result) {
+            if (!result.isOK()) {
+                next.emplace(result.getStatus());
+                return;
+            }
+            auto value = result.getValue();
+            auto cbh = executor->scheduleWork(
+                [next, work, value](const TaskExecutor::CallbackArgs& cbData) {
+                    if (!cbData.status.isOK()) {
+                        next.emplace(cbData.status);
+                        return;
+                    }
+                    work(value);
+                });
+            if (!cbh.isOK()) {
+                next.emplace(cbh.getStatus());
+            }
+        });
+    }
+
+    std::shared_ptr<State> _state;
+};
+
+/**
+ * Schedules 'request' on 'executor' and returns a Deferred for its response.
+ */
+Deferred<RemoteCommandResponse> scheduleRemoteCommandDeferred(TaskExecutor* executor,
+                                                              const RemoteCommandRequest& request);
+
+}  // namespace executor
+}  // namespace mongo
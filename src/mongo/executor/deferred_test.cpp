@@ -0,0 +1,130 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/executor/deferred.h"
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/executor/thread_pool_task_executor_test_fixture.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace executor {
+namespace {
+
+using DeferredTest = ThreadPoolExecutorTest;
+
+TEST_F(DeferredTest, ContinuationsRunInOrderOnTheExecutor) {
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    auto result = Deferred<int>::makeReady(1)
+                      .then(&executor, [](const int& x) { return StatusWith<int>(x + 1); })
+                      .then(&executor, [](const int& x) { return StatusWith<int>(x * 2); });
+    ASSERT_EQUALS(4, unittest::assertGet(result.get()));
+}
+
+TEST_F(DeferredTest, ErrorSkipsRemainingContinuations) {
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    bool ranAfterError = false;
+    Deferred<int> first;
+    auto result = first.then(&executor,
+                             [](const int& x) {
+                                 return StatusWith<int>(ErrorCodes::BadValue, "bad value");
+                             })
+                      .then(&executor,
+                            [&ranAfterError](const int& x) {
+                                ranAfterError = true;
+                                return StatusWith<int>(x);
+                            });
+    ASSERT_FALSE(result.isReady());
+    first.emplace(1);
+    ASSERT_EQUALS(ErrorCodes::BadValue, result.get().getStatus());
+    ASSERT_FALSE(ranAfterError);
+}
+
+TEST_F(DeferredTest, RemoteCommandsChainWithoutBlocking) {
+    auto net = getNet();
+    auto& executor = getExecutor();
+    launchExecutorThread();
+
+    const HostAndPort host("localhost", 27017);
+    auto result =
+        scheduleRemoteCommandDeferred(&executor,
+                                      RemoteCommandRequest(host, "admin", BSON("first" << 1)))
+            .thenAsync(&executor,
+                       [&executor, host](const RemoteCommandResponse& response) {
+                           return scheduleRemoteCommandDeferred(
+                               &executor,
+                               RemoteCommandRequest(
+                                   host, "admin", BSON("second" << response.data["n"])));
+                       })
+            .then(&executor,
+                  [](const RemoteCommandResponse& response) {
+                      return StatusWith<int>(response.data["n"].numberInt());
+                  });
+
+    net->enterNetwork();
+    auto noi = net->getNextReadyRequest();
+    ASSERT_EQUALS(BSON("first" << 1), noi->getRequest().cmdObj);
+    net->scheduleResponse(
+        noi,
+        net->now(),
+        RemoteCommandResponse(BSON("ok" << 1 << "n" << 2), BSONObj(), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    net->enterNetwork();
+    noi = net->getNextReadyRequest();
+    ASSERT_EQUALS(BSON("second" << 2), noi->getRequest().cmdObj);
+    net->scheduleResponse(
+        noi,
+        net->now(),
+        RemoteCommandResponse(BSON("ok" << 1 << "n" << 3), BSONObj(), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ASSERT_EQUALS(3, unittest::assertGet(result.get()));
+}
+
+TEST_F(DeferredTest, ContinuationFailsAfterShutdown) {
+    auto& executor = getExecutor();
+    launchExecutorThread();
+    executor.shutdown();
+
+    auto result = Deferred<int>::makeReady(1).then(
+        &executor, [](const int& x) { return StatusWith<int>(x); });
+    ASSERT_EQUALS(ErrorCodes::ShutdownInProgress, result.get().getStatus());
+}
+
+}  // namespace
+}  // namespace executor
+}  // namespace mongo
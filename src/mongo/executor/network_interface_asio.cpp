@@ -63,7 +63,8 @@ NetworkInterfaceASIO::NetworkInterfaceASIO(
       _streamFactory(std::move(streamFactory)),
       _connectionPool(stdx::make_unique<connection_pool_asio::ASIOImpl>(this),
                       _options.connectionPoolOptions),
-      _isExecutorRunnable(false) {}
+      _isExecutorRunnable(false),
+      _alarmTimer(_io_service) {}
 
 std::string NetworkInterfaceASIO::getDiagnosticString() {
     str::stream output;
@@ -208,19 +209,50 @@ void NetworkInterfaceASIO::cancelAllCommands() {
 }
 
 void NetworkInterfaceASIO::setAlarm(Date_t when, const stdx::function<void()>& action) {
-    // "alarm" must stay alive until it expires, hence the shared_ptr.
-    auto alarm = std::make_shared<asio::steady_timer>(_io_service, when - now());
-    alarm->async_wait([alarm, this, action](std::error_code ec) {
-        if (!ec) {
-            return action();
-        } else if (ec != asio::error::operation_aborted) {
-            // When the network interface is shut down, it will cancel all pending
-            // alarms, raising an "operation_aborted" error here, which we ignore.
-            warning() << "setAlarm() received an error: " << ec.message();
-        }
-    });
+    stdx::lock_guard<stdx::mutex> lk(_alarmsMutex);
+    _alarms.emplace(when, action);
+    _armAlarmTimer_inlock();
 };
 
+void NetworkInterfaceASIO::_armAlarmTimer_inlock() {
+    if (_alarms.empty() || _alarms.top().when >= _alarmTimerExpiration) {
+        return;
+    }
+
+    // Moving the expiration cancels the wait for the later one, whose handler then sees
+    // "operation_aborted".
+    _alarmTimerExpiration = _alarms.top().when;
+    _alarmTimer.expires_from_now(_alarmTimerExpiration - now());
+    _alarmTimer.async_wait([this](std::error_code ec) { _processAlarms(ec); });
+}
+
+void NetworkInterfaceASIO::_processAlarms(std::error_code ec) {
+    if (ec == asio::error::operation_aborted) {
+        // Either the timer was re-armed for an earlier alarm, or the network interface is shutting
+        // down, and so there is nothing to do.
+        return;
+    } else if (ec) {
+        warning() << "setAlarm() received an error: " << ec.message();
+    }
+
+    std::vector<AlarmInfo::AlarmAction> dueActions;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_alarmsMutex);
+        const Date_t currentTime = now();
+        while (!_alarms.empty() && _alarms.top().when <= currentTime) {
+            dueActions.push_back(std::move(_alarms.top().action));
+            _alarms.pop();
+        }
+
+        _alarmTimerExpiration = Date_t::max();
+        _armAlarmTimer_inlock();
+    }
+
+    for (const auto& action : dueActions) {
+        action();
+    }
+}
+
 bool NetworkInterfaceASIO::inShutdown() const {
     return (_state.load() == State::kShutdown);
 }
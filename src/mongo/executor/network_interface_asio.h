@@ -31,7 +31,9 @@
 #include <asio.hpp>
 
 #include <boost/optional.hpp>
+#include <functional>
 #include <memory>
+#include <queue>
 #include <string>
 #include <system_error>
 #include <unordered_map>
@@ -51,6 +53,7 @@
 #include "mongo/stdx/mutex.h"
 #include "mongo/stdx/thread.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
 
 namespace mongo {
 namespace executor {
@@ -122,6 +125,8 @@ private:
         rpc::ProtocolSet clientProtocols() const;
         void setServerProtocols(rpc::ProtocolSet protocols);
 
+        MessageCompressorManager& compressorManager();
+
 // Explicit move construction and assignment to support MSVC
 #if defined(_MSC_VER) && _MSC_VER < 1900
         AsyncConnection(AsyncConnection&&);
@@ -136,6 +141,8 @@ private:
 
         rpc::ProtocolSet _serverProtocols;
         rpc::ProtocolSet _clientProtocols{rpc::supports::kAll};
+
+        MessageCompressorManager _compressorManager;
     };
 
     /**
@@ -169,6 +176,10 @@ private:
 
         Message& toSend();
         Message& toRecv();
+
+        // Holds the compressed form of toSend() while it is being written, if the connection
+        // negotiated compression.
+        Message& compressedToSend();
         MSGHEADER::Value& header();
 
         ResponseStatus response(rpc::Protocol protocol, Date_t now);
@@ -180,6 +191,7 @@ private:
 
         Message _toSend;
         Message _toRecv;
+        Message _compressedToSend;
 
         // TODO: Investigate efficiency of storing header separately.
         MSGHEADER::Value _header;
@@ -306,6 +318,32 @@ private:
 
     void _asyncRunCommand(AsyncCommand* cmd, NetworkOpHandler handler);
 
+    /**
+     * Information describing a scheduled alarm.
+     */
+    struct AlarmInfo {
+        using AlarmAction = stdx::function<void()>;
+        AlarmInfo(Date_t inWhen, AlarmAction inAction)
+            : when(inWhen), action(std::move(inAction)) {}
+        bool operator>(const AlarmInfo& rhs) const {
+            return when > rhs.when;
+        }
+
+        Date_t when;
+        AlarmAction action;
+    };
+
+    /**
+     * Sets _alarmTimer to fire when the next alarm is due, unless it already does. Must be called
+     * with _alarmsMutex held.
+     */
+    void _armAlarmTimer_inlock();
+
+    /**
+     * Runs every alarm which is due, all at once, and re-arms _alarmTimer for the rest.
+     */
+    void _processAlarms(std::error_code ec);
+
     Options _options;
 
     asio::io_service _io_service;
@@ -328,6 +366,17 @@ private:
     stdx::mutex _executorMutex;
     bool _isExecutorRunnable;
     stdx::condition_variable _isExecutorRunnableCondition;
+
+    // Protects the alarms and the timer which fires for them
+    stdx::mutex _alarmsMutex;
+
+    // Heap of alarms, with the next alarm always on top. A single timer serves all of them, rather
+    // than one per alarm.
+    std::priority_queue<AlarmInfo, std::vector<AlarmInfo>, std::greater<AlarmInfo>> _alarms;
+    asio::steady_timer _alarmTimer;
+
+    // When _alarmTimer is set to fire, or Date_t::max() if it isn't waiting for an alarm
+    Date_t _alarmTimerExpiration = Date_t::max();
 };
 
 template <typename T, typename R, typename... MethodArgs, typename... DeducedArgs>
@@ -55,7 +55,10 @@ void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
     requestBuilder.setDatabase("admin");
     requestBuilder.setCommandName("isMaster");
     requestBuilder.setMetadata(rpc::makeEmptyMetadata());
-    requestBuilder.setCommandArgs(BSON("isMaster" << 1));
+    BSONObjBuilder isMasterCmd;
+    isMasterCmd.append("isMaster", 1);
+    op->connection().compressorManager().clientBegin(&isMasterCmd);
+    requestBuilder.setCommandArgs(isMasterCmd.done());
 
     // Set current command to ismaster request and run
     auto beginStatus = op->beginCommand(std::move(*(requestBuilder.done())));
@@ -87,6 +90,7 @@ void NetworkInterfaceASIO::_runIsMaster(AsyncOp* op) {
             return _completeOperation(op, protocolSet.getStatus());
 
         op->connection().setServerProtocols(protocolSet.getValue());
+        op->connection().compressorManager().clientFinish(commandReply.data);
 
         // Set the operation protocol
         auto negotiatedProtocol =
@@ -172,6 +172,10 @@ Message& NetworkInterfaceASIO::AsyncCommand::toRecv() {
     return _toRecv;
 }
 
+Message& NetworkInterfaceASIO::AsyncCommand::compressedToSend() {
+    return _compressedToSend;
+}
+
 MSGHEADER::Value& NetworkInterfaceASIO::AsyncCommand::header() {
     return _header;
 }
@@ -291,8 +295,15 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncCommand* cmd, NetworkOpHandler
     // 4 - advance the state machine by calling handler()
 
     // Step 4
-    auto recvMessageCallback =
-        [this, cmd, handler](std::error_code ec, size_t bytes) { handler(ec, bytes); };
+    auto recvMessageCallback = [this, cmd, handler](std::error_code ec, size_t bytes) {
+        if (!ec) {
+            Status status = cmd->conn().compressorManager().decompressMessage(&cmd->toRecv());
+            if (!status.isOK()) {
+                return handler(make_error_code(status.code()), bytes);
+            }
+        }
+        handler(ec, bytes);
+    };
 
     // Step 3
     auto recvHeaderCallback = [this, cmd, handler, recvMessageCallback](std::error_code ec,
@@ -324,7 +335,18 @@ void NetworkInterfaceASIO::_asyncRunCommand(AsyncCommand* cmd, NetworkOpHandler
     };
 
     // Step 1
-    asyncSendMessage(cmd->conn().stream(), &cmd->toSend(), std::move(sendMessageCallback));
+    Message* toSend = &cmd->toSend();
+    auto& compressorManager = cmd->conn().compressorManager();
+    if (compressorManager.getOutgoingCompressor()) {
+        cmd->compressedToSend().reset();
+        Status status = compressorManager.compressMessage(*toSend, &cmd->compressedToSend());
+        if (status.isOK()) {
+            toSend = &cmd->compressedToSend();
+        } else {
+            LOG(1) << "failed to compress message, sending it uncompressed: " << status;
+        }
+    }
+    asyncSendMessage(cmd->conn().stream(), toSend, std::move(sendMessageCallback));
 }
 
 void NetworkInterfaceASIO::_runConnectionHook(AsyncOp* op) {
@@ -41,6 +41,7 @@
 #include "mongo/rpc/legacy_reply_builder.h"
 #include "mongo/stdx/future.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/unittest/unittest.h"
 #include "mongo/util/log.h"
 #include "mongo/util/scopeguard.h"
@@ -458,6 +459,33 @@ TEST_F(NetworkInterfaceASIOTest, setAlarm) {
     ASSERT(status == stdx::future_status::timeout);
 }
 
+TEST_F(NetworkInterfaceASIOTest, setAlarmsOutOfOrder) {
+    stdx::mutex mutex;
+    std::vector<int> order;
+    stdx::promise<void> done;
+    stdx::future<void> allRun = done.get_future();
+
+    // The later alarm is set first, so the shared timer has to be brought forward for the second.
+    Date_t start = net().now();
+    net().setAlarm(start + Milliseconds(200),
+                   [&]() {
+                       stdx::lock_guard<stdx::mutex> lk(mutex);
+                       order.push_back(2);
+                       done.set_value();
+                   });
+    net().setAlarm(start + Milliseconds(50),
+                   [&]() {
+                       stdx::lock_guard<stdx::mutex> lk(mutex);
+                       order.push_back(1);
+                   });
+
+    ASSERT(allRun.wait_for(Milliseconds(5000)) == stdx::future_status::ready);
+    stdx::lock_guard<stdx::mutex> lk(mutex);
+    ASSERT_EQUALS(2U, order.size());
+    ASSERT_EQUALS(1, order[0]);
+    ASSERT_EQUALS(2, order[1]);
+}
+
 }  // namespace
 }  // namespace executor
 }  // namespace mongo
@@ -60,6 +60,40 @@ MONGO_INITIALIZER(outboundNetworkImpl)(InitializerContext*) {
     return Status::OK();
 }
 
+// The ASIO network interface sets up at most this many connections to a host at once. Requests
+// beyond those wait for a connection to become available, which under a burst is usually sooner
+// than a new connection could connect, run isMaster and authenticate. Zero removes the limit.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(connectionPoolMaxConnectingPerHost, int, 2);
+
+// The ASIO network interface keeps at most this many connections to a host, including those in
+// use and in setup. Zero removes the limit.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(connectionPoolMaxConnsPerHost, int, 0);
+
+// While a host is in use, the ASIO network interface keeps this many connections to it available
+// on top of those in use, so that rising load finds them already set up.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(connectionPoolMinIdlePerHost, int, 0);
+
+namespace {
+
+NetworkInterfaceASIO::Options makeNetworkInterfaceASIOOptions() {
+    NetworkInterfaceASIO::Options options;
+    if (connectionPoolMaxConnectingPerHost > 0) {
+        options.connectionPoolOptions.maxConnecting =
+            static_cast<size_t>(connectionPoolMaxConnectingPerHost);
+    }
+    if (connectionPoolMaxConnsPerHost > 0) {
+        options.connectionPoolOptions.maxConnections =
+            static_cast<size_t>(connectionPoolMaxConnsPerHost);
+    }
+    if (connectionPoolMinIdlePerHost > 0) {
+        options.connectionPoolOptions.minIdleConnections =
+            static_cast<size_t>(connectionPoolMinIdlePerHost);
+    }
+    return options;
+}
+
+}  // namespace
+
 std::unique_ptr<NetworkInterface> makeNetworkInterface() {
     return makeNetworkInterface(nullptr);
 }
@@ -70,11 +104,13 @@ std::unique_ptr<NetworkInterface> makeNetworkInterface(
 #ifdef MONGO_CONFIG_SSL
         if (SSLManagerInterface* manager = getSSLManager()) {
             auto factory = stdx::make_unique<AsyncSecureStreamFactory>(manager);
-            return stdx::make_unique<NetworkInterfaceASIO>(std::move(factory), std::move(hook));
+            return stdx::make_unique<NetworkInterfaceASIO>(
+                std::move(factory), std::move(hook), makeNetworkInterfaceASIOOptions());
         }
 #endif
         auto factory = stdx::make_unique<AsyncStreamFactory>();
-        return stdx::make_unique<NetworkInterfaceASIO>(std::move(factory), std::move(hook));
+        return stdx::make_unique<NetworkInterfaceASIO>(
+            std::move(factory), std::move(hook), makeNetworkInterfaceASIOOptions());
 
     } else {
         return stdx::make_unique<NetworkInterfaceImpl>(std::move(hook));
@@ -83,6 +83,9 @@ public:
     WorkQueue::iterator iter;
     Date_t readyDate;
     bool isNetworkOperation = false;
+
+    // Whether "iter" points into the sleepers queue, where the callback waits for its readyDate
+    bool isSleeping = false;
 };
 
 class ThreadPoolTaskExecutor::EventState : public TaskExecutor::EventState {
@@ -233,6 +236,7 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleWorkAt(
     if (!cbHandle.isOK()) {
         return cbHandle;
     }
+    checked_cast<CallbackState*>(getCallbackFromHandle(cbHandle.getValue()))->isSleeping = true;
     _net->setAlarm(when,
                    [this, when, cbHandle] {
                        auto cbState =
@@ -242,7 +246,10 @@ StatusWith<TaskExecutor::CallbackHandle> ThreadPoolTaskExecutor::scheduleWorkAt(
                        }
                        invariant(now() >= when);
                        stdx::lock_guard<stdx::mutex> lk(_mutex);
-                       scheduleIntoPool_inlock(&_sleepersQueue, cbState->iter);
+                       // cancel() may have scheduled the callback since the check above
+                       if (cbState->isSleeping) {
+                           scheduleIntoPool_inlock(&_sleepersQueue, cbState->iter);
+                       }
                    });
 
     return cbHandle;
@@ -321,18 +328,10 @@ void ThreadPoolTaskExecutor::cancel(const CallbackHandle& cbHandle) {
         _net->cancelCommand(cbHandle);
         return;
     }
-    if (cbState->readyDate != Date_t{}) {
-        // This callback might still be in the sleeper queue; if it is, schedule it now
-        // rather than when the alarm fires.
-        auto iter = std::find_if(_sleepersQueue.begin(),
-                                 _sleepersQueue.end(),
-                                 [cbState](const std::shared_ptr<CallbackState>& other) {
-                                     return cbState == other.get();
-                                 });
-        if (iter != _sleepersQueue.end()) {
-            invariant(iter == cbState->iter);
-            scheduleIntoPool_inlock(&_sleepersQueue, cbState->iter);
-        }
+    if (cbState->isSleeping) {
+        // This callback is still in the sleeper queue, so schedule it now rather than when the
+        // alarm fires.
+        scheduleIntoPool_inlock(&_sleepersQueue, cbState->iter);
     }
 }
 
@@ -397,6 +396,7 @@ void ThreadPoolTaskExecutor::scheduleIntoPool_inlock(WorkQueue* fromQueue,
         begin,
         end,
         [this](const std::shared_ptr<CallbackState>& cbState) {
+            cbState->isSleeping = false;
             fassert(28735, _pool->schedule([this, cbState] { runCallback(std::move(cbState)); }));
         });
     _poolInProgressQueue.splice(_poolInProgressQueue.end(), *fromQueue, begin, end);
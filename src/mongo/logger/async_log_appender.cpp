@@ -0,0 +1,143 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_log_appender.h"
+
+#include "mongo/stdx/functional.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+namespace logger {
+
+AsyncLogAppender::QueuedEvent::QueuedEvent(const MessageEventEphemeral& event)
+    : date(event.getDate()),
+      severity(event.getSeverity()),
+      component(event.getComponent()),
+      contextName(event.getContextName().toString()),
+      message(event.getMessage().toString()) {}
+
+AsyncLogAppender::AsyncLogAppender(std::unique_ptr<EventAppender> target, size_t maxQueuedEvents)
+    : _target(std::move(target)), _maxQueuedEvents(maxQueuedEvents ? maxQueuedEvents : 1) {
+    _thread = stdx::thread(stdx::bind(&AsyncLogAppender::_run, this));
+}
+
+AsyncLogAppender::~AsyncLogAppender() {
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+        _workAvailable.notify_one();
+    }
+    _thread.join();
+}
+
+Status AsyncLogAppender::append(const MessageEventEphemeral& event) {
+    const bool mayDrop = event.getSeverity() < LogSeverity::Warning();
+    const bool mustWait = event.getSeverity() >= LogSeverity::Severe();
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (_queue.size() >= _maxQueuedEvents) {
+        if (mayDrop) {
+            ++_droppedSinceWrite;
+            ++_droppedTotal;
+            return Status::OK();
+        }
+        _spaceAvailable.wait(lk);
+    }
+
+    _queue.emplace_back(event);
+    const long long enqueued = ++_enqueuedCount;
+    _workAvailable.notify_one();
+
+    if (mustWait) {
+        while (_writtenCount < enqueued) {
+            _written.wait(lk);
+        }
+    }
+    return Status::OK();
+}
+
+void AsyncLogAppender::flush() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    const long long enqueued = _enqueuedCount;
+    while (_writtenCount < enqueued) {
+        _written.wait(lk);
+    }
+}
+
+long long AsyncLogAppender::getDroppedCount() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _droppedTotal;
+}
+
+void AsyncLogAppender::_run() {
+    setThreadName("asyncLogWriter");
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (true) {
+        while (_queue.empty() && !_droppedSinceWrite && !_shutdown) {
+            _workAvailable.wait(lk);
+        }
+        if (_queue.empty() && !_droppedSinceWrite) {
+            return;
+        }
+
+        std::deque<QueuedEvent> batch;
+        batch.swap(_queue);
+        const long long dropped = _droppedSinceWrite;
+        _droppedSinceWrite = 0;
+        const long long enqueued = _enqueuedCount;
+        _spaceAvailable.notify_all();
+        lk.unlock();
+
+        // There is nobody to return a failure to, so, as when the log file cannot be written
+        // by the synchronous appenders, the events are lost.
+        if (dropped) {
+            const std::string message = str::stream()
+                << dropped << " log messages were dropped because the log queue was full";
+            _target->append(MessageEventEphemeral(Date_t::now(),
+                                                  LogSeverity::Warning(),
+                                                  LogComponent::kDefault,
+                                                  getThreadName(),
+                                                  message));
+        }
+        for (const auto& event : batch) {
+            _target->append(MessageEventEphemeral(
+                event.date, event.severity, event.component, event.contextName, event.message));
+        }
+
+        lk.lock();
+        _writtenCount = enqueued;
+        _written.notify_all();
+    }
+}
+
+}  // namespace logger
+}  // namespace mongo
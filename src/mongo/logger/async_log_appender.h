@@ -0,0 +1,115 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/logger/appender.h"
+#include "mongo/logger/log_component.h"
+#include "mongo/logger/log_severity.h"
+#include "mongo/logger/message_event.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+namespace logger {
+
+/**
+ * Appender which hands events to a background thread that writes them to another appender, so
+ * that threads which log do not wait for the underlying file or stream.
+ *
+ * At most "maxQueuedEvents" events are buffered.  When the buffer is full, events less severe
+ * than warnings are dropped, and the number of dropped events is written in their place once
+ * there is room again; warnings and more severe events wait for room.  Severe events also wait
+ * until they have been written, so that they reach the log before a possible abort.
+ */
+class AsyncLogAppender : public Appender<MessageEventEphemeral> {
+    MONGO_DISALLOW_COPYING(AsyncLogAppender);
+
+public:
+    typedef Appender<MessageEventEphemeral> EventAppender;
+
+    AsyncLogAppender(std::unique_ptr<EventAppender> target, size_t maxQueuedEvents);
+
+    /**
+     * Writes out all queued events and stops the background thread.
+     */
+    virtual ~AsyncLogAppender();
+
+    virtual Status append(const MessageEventEphemeral& event);
+
+    /**
+     * Waits until every event appended before this call has been written.
+     */
+    void flush();
+
+    /**
+     * Returns the total number of events dropped because the buffer was full.
+     */
+    long long getDroppedCount() const;
+
+private:
+    struct QueuedEvent {
+        explicit QueuedEvent(const MessageEventEphemeral& event);
+
+        Date_t date;
+        LogSeverity severity;
+        LogComponent component;
+        std::string contextName;
+        std::string message;
+    };
+
+    void _run();
+
+    const std::unique_ptr<EventAppender> _target;
+    const size_t _maxQueuedEvents;
+
+    mutable stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _spaceAvailable;
+    stdx::condition_variable _written;
+
+    std::deque<QueuedEvent> _queue;
+    long long _enqueuedCount = 0;
+    long long _writtenCount = 0;
+    long long _droppedSinceWrite = 0;
+    long long _droppedTotal = 0;
+    bool _shutdown = false;
+
+    stdx::thread _thread;
+};
+
+}  // namespace logger
+}  // namespace mongo
@@ -0,0 +1,154 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/logger/async_log_appender.h"
+
+#include <string>
+#include <vector>
+
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace logger {
+namespace {
+
+/**
+ * Records the messages of the events appended to it, and holds up the writer while it is
+ * blocked.
+ */
+class RecordingAppender : public Appender<MessageEventEphemeral> {
+public:
+    RecordingAppender(std::vector<std::string>* messages) : _messages(messages) {}
+
+    virtual Status append(const MessageEventEphemeral& event) {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (_blocked) {
+            _waiting = true;
+            _changed.notify_all();
+            _changed.wait(lk);
+        }
+        _messages->push_back(event.getMessage().toString());
+        return Status::OK();
+    }
+
+    void block() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _blocked = true;
+    }
+
+    void unblock() {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _blocked = false;
+        _changed.notify_all();
+    }
+
+    void waitForBlockedWriter() {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!_waiting) {
+            _changed.wait(lk);
+        }
+    }
+
+private:
+    std::vector<std::string>* _messages;
+    stdx::mutex _mutex;
+    stdx::condition_variable _changed;
+    bool _blocked = false;
+    bool _waiting = false;
+};
+
+MessageEventEphemeral makeEvent(LogSeverity severity, StringData message) {
+    return MessageEventEphemeral(Date_t::now(), severity, "test", message);
+}
+
+TEST(AsyncLogAppender, WritesEventsInOrder) {
+    std::vector<std::string> messages;
+    AsyncLogAppender appender(stdx::make_unique<RecordingAppender>(&messages), 100);
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), std::to_string(i))));
+    }
+    appender.flush();
+
+    ASSERT_EQUALS(50U, messages.size());
+    for (int i = 0; i < 50; ++i) {
+        ASSERT_EQUALS(std::to_string(i), messages[i]);
+    }
+    ASSERT_EQUALS(0, appender.getDroppedCount());
+}
+
+TEST(AsyncLogAppender, DropsInformationalEventsWhenFull) {
+    std::vector<std::string> messages;
+    auto recorder = stdx::make_unique<RecordingAppender>(&messages);
+    RecordingAppender* target = recorder.get();
+    AsyncLogAppender appender(std::move(recorder), 2);
+
+    // Hold up the writer on the first event so that the following ones stay queued.
+    target->block();
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "first")));
+    target->waitForBlockedWriter();
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "queued")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "queued")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "dropped")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Info(), "dropped")));
+    ASSERT_EQUALS(2, appender.getDroppedCount());
+    target->unblock();
+
+    // A warning is never dropped, and is written after the report of the dropped events.
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Warning(), "warning")));
+    appender.flush();
+
+    ASSERT_EQUALS("first", messages.front());
+    ASSERT_EQUALS("warning", messages.back());
+    bool reportedDrops = false;
+    for (const auto& message : messages) {
+        ASSERT_NOT_EQUALS("dropped", message);
+        if (message == "2 log messages were dropped because the log queue was full") {
+            reportedDrops = true;
+        }
+    }
+    ASSERT_TRUE(reportedDrops);
+}
+
+TEST(AsyncLogAppender, SevereEventsAreWrittenBeforeAppendReturns) {
+    std::vector<std::string> messages;
+    AsyncLogAppender appender(stdx::make_unique<RecordingAppender>(&messages), 100);
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Log(), "before")));
+    ASSERT_OK(appender.append(makeEvent(LogSeverity::Severe(), "severe")));
+
+    ASSERT_EQUALS(2U, messages.size());
+    ASSERT_EQUALS("severe", messages.back());
+}
+
+}  // namespace
+}  // namespace logger
+}  // namespace mongo
@@ -103,6 +103,18 @@ BID_UINT128 quantizeTo15DecimalDigits(BID_UINT128 value,
     return value;
 }
 
+// The layout of the high 64 bits of a binary integer decimal. When the two bits after the sign
+// are both set, the exponent is shifted down by two bits and the coefficient has an implicit
+// leading 0b100, which is also how infinities and NaNs are encoded.
+const std::uint64_t kSignBit = 1ull << 63;
+const std::uint64_t kCombinationLargeMask = 3ull << 61;
+const int kExponentShift = 49;
+const int kLargeExponentShift = 47;
+const std::uint64_t kExponentMask = (1ull << 14) - 1;
+const std::uint64_t kCoefficientHighMask = (1ull << 49) - 1;
+const std::uint64_t kLargeCoefficientHighMask = (1ull << 47) - 1;
+const std::uint64_t kLargeCoefficientHighPrefix = 1ull << 49;
+
 }  // namespace
 
 Decimal128::Decimal128(std::int32_t int32Value)
@@ -254,10 +266,39 @@ Decimal128::Decimal128(std::string stringValue, RoundingMode roundMode) {
     _value = libraryTypeToValue(dec128);
 }
 
+Decimal128::Decimal128(std::uint64_t sign,
+                       std::uint64_t biasedExponent,
+                       std::uint64_t coefficientHigh,
+                       std::uint64_t coefficientLow) {
+    invariant(sign <= 1);
+    invariant(biasedExponent <= kMaxBiasedExponent);
+    invariant(coefficientHigh <= kCoefficientHighMask);
+    _value.high64 = (sign ? kSignBit : 0) | (biasedExponent << kExponentShift) | coefficientHigh;
+    _value.low64 = coefficientLow;
+}
+
 Decimal128::Value Decimal128::getValue() const {
     return _value;
 }
 
+std::uint32_t Decimal128::getBiasedExponent() const {
+    const int shift = (_value.high64 & kCombinationLargeMask) == kCombinationLargeMask
+        ? kLargeExponentShift
+        : kExponentShift;
+    return (_value.high64 >> shift) & kExponentMask;
+}
+
+std::uint64_t Decimal128::getCoefficientHigh() const {
+    if ((_value.high64 & kCombinationLargeMask) == kCombinationLargeMask) {
+        return kLargeCoefficientHighPrefix | (_value.high64 & kLargeCoefficientHighMask);
+    }
+    return _value.high64 & kCoefficientHighMask;
+}
+
+std::uint64_t Decimal128::getCoefficientLow() const {
+    return _value.low64;
+}
+
 Decimal128 Decimal128::toAbs() const {
     BID_UINT128 dec128 = decimal128ToLibraryType(_value);
     dec128 = bid128_abs(dec128);
@@ -651,6 +692,9 @@ const Decimal128 Decimal128::kSmallestNegative(Decimal128::Value({1ull, 0ull + n
 // Get the reprsentation of 0 with the largest negative exponent
 const Decimal128 Decimal128::kLargestNegativeExponentZero(Decimal128::Value({0ull, 0ull}));
 
+const std::uint32_t Decimal128::kExponentBias;
+const std::uint32_t Decimal128::kMaxBiasedExponent;
+
 // Shift the format of the combination bits to the right position to get Inf and NaN
 // +Inf = 0111 1000 ... ... = 0x78 ... ...
 // +NaN = 0111 1100 ... ... = 0x7c ... ...
@@ -71,6 +71,9 @@ public:
 
     static const Decimal128 kLargestNegativeExponentZero;
 
+    static const std::uint32_t kExponentBias = 6176;
+    static const std::uint32_t kMaxBiasedExponent = 12287;
+
     static const Decimal128 kPositiveInfinity;
     static const Decimal128 kNegativeInfinity;
     static const Decimal128 kPositiveNaN;
@@ -130,6 +133,16 @@ public:
     Decimal128(std::int32_t int32Value);
     Decimal128(long long int64Value);
 
+    /**
+     * This constructor builds a finite Decimal128 from its sign (0 for positive, 1 for negative),
+     * its biased exponent and the high 49 and low 64 bits of its coefficient, which must be less
+     * than 10^34. The value is coefficient * 10^(biasedExponent - kExponentBias).
+     */
+    Decimal128(std::uint64_t sign,
+               std::uint64_t biasedExponent,
+               std::uint64_t coefficientHigh,
+               std::uint64_t coefficientLow);
+
     /**
      * This constructor takes a double and constructs a Decimal128 object
      * given a roundMode with a fixed precision of 15. Doubles can only
@@ -159,6 +172,16 @@ public:
      */
     Value getValue() const;
 
+    /**
+     * These functions get the parts of the binary integer decimal encoding of a Decimal128: its
+     * biased exponent and the high 49 and low 64 bits of its coefficient. Infinities, NaNs and
+     * out of range coefficients decode with a coefficient of at least 2^113, so a coefficient
+     * with no high bits set always belongs to a finite value.
+     */
+    std::uint32_t getBiasedExponent() const;
+    std::uint64_t getCoefficientHigh() const;
+    std::uint64_t getCoefficientLow() const;
+
     /**
      * This function returns the decimal absolute value of the caller.
      */
@@ -49,10 +49,29 @@ Decimal128::Decimal128(std::string stringValue, RoundingMode roundMode) {
     invariant(false);
 }
 
+Decimal128::Decimal128(std::uint64_t sign,
+                       std::uint64_t biasedExponent,
+                       std::uint64_t coefficientHigh,
+                       std::uint64_t coefficientLow) {
+    invariant(false);
+}
+
 Decimal128::Value Decimal128::getValue() const {
     invariant(false);
 }
 
+uint32_t Decimal128::getBiasedExponent() const {
+    invariant(false);
+}
+
+uint64_t Decimal128::getCoefficientHigh() const {
+    invariant(false);
+}
+
+uint64_t Decimal128::getCoefficientLow() const {
+    invariant(false);
+}
+
 Decimal128 Decimal128::toAbs() const {
     invariant(false);
 }
@@ -202,6 +221,9 @@ const Decimal128 Decimal128::kSmallestNegative = Decimal128();
 
 const Decimal128 Decimal128::kLargestNegativeExponentZero = Decimal128();
 
+const std::uint32_t Decimal128::kExponentBias;
+const std::uint32_t Decimal128::kMaxBiasedExponent;
+
 const Decimal128 Decimal128::kPositiveInfinity = Decimal128();
 const Decimal128 Decimal128::kNegativeInfinity = Decimal128();
 const Decimal128 Decimal128::kPositiveNaN = Decimal128();
@@ -269,6 +269,28 @@ TEST(Decimal128Test, TestStringConstructorNaN) {
     ASSERT_EQUALS(val.low64, lowBytes);
 }
 
+TEST(Decimal128Test, TestPartsConstructor) {
+    Decimal128 d(1, Decimal128::kExponentBias - 2, 0, 12345);
+    ASSERT_EQUALS(d.toString(), "-123.45");
+    ASSERT_EQUALS(d.getBiasedExponent(), Decimal128::kExponentBias - 2);
+    ASSERT_EQUALS(d.getCoefficientHigh(), 0ull);
+    ASSERT_EQUALS(d.getCoefficientLow(), 12345ull);
+}
+
+TEST(Decimal128Test, TestGetPartsOfLargestPositive) {
+    Decimal128 d = Decimal128::kLargestPositive;
+    ASSERT_EQUALS(d.getBiasedExponent(), Decimal128::kMaxBiasedExponent);
+    // 9999999999999999999999999999999999 = 0x1ed09bead87c0 378d8e63ffffffff
+    ASSERT_EQUALS(d.getCoefficientHigh(), 0x1ed09bead87c0ull);
+    ASSERT_EQUALS(d.getCoefficientLow(), 0x378d8e63ffffffffull);
+}
+
+TEST(Decimal128Test, TestGetPartsOfSpecialValues) {
+    // Infinities and NaNs decode with coefficients too large for any finite value.
+    ASSERT_GREATER_THAN_OR_EQUALS(Decimal128::kPositiveInfinity.getCoefficientHigh(), 1ull << 49);
+    ASSERT_GREATER_THAN_OR_EQUALS(Decimal128::kNegativeNaN.getCoefficientHigh(), 1ull << 49);
+}
+
 // Tests for absolute value function
 TEST(Decimal128Test, TestAbsValuePos) {
     Decimal128 d(25);
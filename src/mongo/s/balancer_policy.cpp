@@ -166,12 +166,21 @@ string DistributionStatus::getBestReceieverShard(const string& tag) const {
         }
 
         unsigned myChunks = numberOfChunksInShard(i->first);
-        if (myChunks >= minChunks) {
+        if (myChunks > minChunks) {
             LOG(1) << i->first << " has more chunks me:" << myChunks << " best: " << best << ":"
                    << minChunks;
             continue;
         }
 
+        // Among shards with as few chunks, prefer the one holding the least data, so that shards
+        // whose chunks are larger than average stop receiving more of them.
+        if (myChunks == minChunks &&
+            i->second.getCurrSizeMB() >= shardInfo(best).getCurrSizeMB()) {
+            LOG(1) << i->first << " has as many chunks and more data me:" << myChunks << " best: "
+                   << best << ":" << minChunks;
+            continue;
+        }
+
         best = i->first;
         minChunks = myChunks;
     }
@@ -185,7 +194,11 @@ string DistributionStatus::getMostOverloadedShard(const string& tag) const {
 
     for (ShardInfoMap::const_iterator i = _shardInfo.begin(); i != _shardInfo.end(); ++i) {
         unsigned myChunks = numberOfChunksInShardWithTag(i->first, tag);
-        if (myChunks <= maxChunks)
+        if (myChunks < maxChunks || myChunks == 0)
+            continue;
+
+        // Among shards with as many chunks, move off the one holding the most data.
+        if (myChunks == maxChunks && i->second.getCurrSizeMB() <= shardInfo(worst).getCurrSizeMB())
             continue;
 
         worst = i->first;
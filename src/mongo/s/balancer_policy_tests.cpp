@@ -469,6 +469,31 @@ TEST(BalancerPolicyTests, MaxSizeRespect) {
     ASSERT_EQUALS("shard1", m->to);
 }
 
+/**
+ * Among shards with the same number of chunks, chunks move off the shard holding the most data and
+ * onto the shard holding the least.
+ */
+TEST(BalancerPolicyTests, DataSizeBreaksTies) {
+    ShardToChunksMap chunks;
+    addShard(chunks, 5, false);
+    addShard(chunks, 5, false);
+    addShard(chunks, 1, false);
+    addShard(chunks, 1, true);
+
+    ShardInfoMap shards;
+    shards["shard0"] = ShardInfo(0, 10, false);
+    shards["shard1"] = ShardInfo(0, 50, false);
+    shards["shard2"] = ShardInfo(0, 40, false);
+    shards["shard3"] = ShardInfo(0, 5, false);
+
+    DistributionStatus d(shards, chunks);
+    std::unique_ptr<MigrateInfo> m(BalancerPolicy::balance("ns", d, 1));
+
+    ASSERT(m);
+    ASSERT_EQUALS("shard1", m->from);
+    ASSERT_EQUALS("shard3", m->to);
+}
+
 /**
  * Here we check that being over the maxSize is *not* equivalent to draining, we don't want
  * to empty shards for no other reason than they are over this limit.
@@ -36,6 +36,7 @@
 #include "mongo/s/catalog/type_database.h"
 #include "mongo/s/config.h"
 #include "mongo/s/grid.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -47,14 +48,36 @@ CatalogCache::CatalogCache() {}
 
 StatusWith<shared_ptr<DBConfig>> CatalogCache::getDatabase(OperationContext* txn,
                                                            const string& dbName) {
-    stdx::lock_guard<stdx::mutex> guard(_mutex);
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
 
-    ShardedDatabasesMap::iterator it = _databases.find(dbName);
-    if (it != _databases.end()) {
-        return it->second;
+    while (true) {
+        ShardedDatabasesMap::iterator it = _databases.find(dbName);
+        if (it != _databases.end()) {
+            return it->second;
+        }
+
+        // Only one thread loads a given database. If the load fails the waiters find the
+        // database still missing and one of them retries it.
+        if (_databasesBeingLoaded.insert(dbName).second) {
+            break;
+        }
+
+        _databaseLoadedCV.wait(lk);
     }
 
-    // Need to load from the store
+    ON_BLOCK_EXIT([&] {
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+
+        _databasesBeingLoaded.erase(dbName);
+        _databaseLoadedCV.notify_all();
+    });
+
+    // Need to load from the store, which is done without holding the cache mutex so lookups of
+    // databases already in the cache are not blocked behind the config server
+    lk.unlock();
+
     auto status = grid.catalogManager(txn)->getDatabase(txn, dbName);
     if (!status.isOK()) {
         return status.getStatus();
@@ -65,6 +88,7 @@ StatusWith<shared_ptr<DBConfig>> CatalogCache::getDatabase(OperationContext* txn
         std::make_shared<DBConfig>(dbName, dbOpTimePair.value, dbOpTimePair.opTime);
     db->load(txn);
 
+    lk.lock();
     invariant(_databases.insert(std::make_pair(dbName, db)).second);
 
     return db;
@@ -30,9 +30,11 @@
 
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 
 #include "mongo/base/disallow_copying.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/stdx/mutex.h"
 
 namespace mongo {
@@ -61,6 +63,10 @@ public:
      * local variable. The reason for this is so that if the cache gets invalidated, the caller
      * does not miss getting the most up-to-date value.
      *
+     * The cache mutex is never held while loading from the config server. Only one thread at a
+     * time loads any given database; concurrent requests for the same database wait for that
+     * load to complete, while requests for other databases proceed.
+     *
      * @param dbname The name of the database (must not contain dots, etc).
      * @return The database if it exists, NULL otherwise.
      */
@@ -84,6 +90,11 @@ private:
     // Databases catalog map and mutex to protect it
     stdx::mutex _mutex;
     ShardedDatabasesMap _databases;
+
+    // Names of the databases currently being loaded from the config server and the condition
+    // variable signalled whenever one of these loads finishes (successfully or not)
+    std::set<std::string> _databasesBeingLoaded;
+    stdx::condition_variable _databaseLoadedCV;
 };
 
 }  // namespace mongo
@@ -146,7 +146,7 @@ bool tryMoveToOtherShard(OperationContext* txn,
     }
 
     // update our config
-    manager.reload(txn);
+    manager.refresh(txn);
 
     return true;
 }
@@ -520,7 +520,7 @@ bool Chunk::moveAndCommit(OperationContext* txn,
     // if succeeded, needs to reload to pick up the new location
     // if failed, mongos may be stale
     // reload is excessive here as the failure could be simply because collection metadata is taken
-    _manager->reload(txn);
+    _manager->refresh(txn);
 
     return worked;
 }
@@ -39,10 +39,12 @@
 #include "mongo/bson/util/bson_extract.h"
 #include "mongo/client/remote_command_targeter.h"
 #include "mongo/db/commands.h"
+#include "mongo/db/hasher.h"
 #include "mongo/db/namespace_string.h"
 #include "mongo/db/query/index_bounds_builder.h"
 #include "mongo/db/query/query_planner.h"
 #include "mongo/db/query/query_planner_common.h"
+#include "mongo/db/storage/key_string.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/catalog/type_chunk.h"
@@ -196,6 +198,7 @@ void ChunkManager::loadExistingRanges(OperationContext* txn, const ChunkManager*
                 _shardIds.swap(shardIds);
                 _shardVersions.swap(shardVersions);
                 _chunkRanges.reloadAll(_chunkMap);
+                _routingTable = ChunkRoutingTable(_chunkMap);
 
                 return;
             }
@@ -239,14 +242,18 @@ bool ChunkManager::_load(OperationContext* txn,
         // Could be v.expensive
         // TODO: If chunks were immutable and didn't reference the manager, we could do more
         // interesting things here
+        //
+        // The old map is walked in order, so each chunk goes at the end of the new one. Inserting
+        // with that hint, and allocating each chunk together with its reference count, keeps the
+        // copy to one allocation and no key comparisons per chunk.
         for (const auto& oldChunkMapEntry : oldChunkMap) {
-            shared_ptr<Chunk> oldC = oldChunkMapEntry.second;
-            shared_ptr<Chunk> newC(new Chunk(
-                this, oldC->getMin(), oldC->getMax(), oldC->getShardId(), oldC->getLastmod()));
+            const shared_ptr<Chunk>& oldC = oldChunkMapEntry.second;
+            shared_ptr<Chunk> newC = std::make_shared<Chunk>(
+                this, oldC->getMin(), oldC->getMax(), oldC->getShardId(), oldC->getLastmod());
 
             newC->setBytesWritten(oldC->getBytesWritten());
 
-            chunkMap.insert(make_pair(oldC->getMax(), newC));
+            chunkMap.emplace_hint(chunkMap.end(), oldChunkMapEntry.first, std::move(newC));
         }
 
         LOG(2) << "loading chunk manager for collection " << _ns
@@ -334,6 +341,14 @@ shared_ptr<ChunkManager> ChunkManager::reload(OperationContext* txn, bool force)
     return config->getChunkManager(txn, getns(), force);
 }
 
+void ChunkManager::refresh(OperationContext* txn) const {
+    const NamespaceString nss(_ns);
+    auto status = grid.catalogCache()->getDatabase(txn, nss.db().toString());
+    shared_ptr<DBConfig> config = uassertStatusOK(status);
+
+    config->refreshChunkManager(txn, getns());
+}
+
 void ChunkManager::_printChunks() const {
     for (ChunkMap::const_iterator it = _chunkMap.begin(), end = _chunkMap.end(); it != end; ++it) {
         log() << *it->second;
@@ -451,22 +466,14 @@ void ChunkManager::createFirstChunks(OperationContext* txn,
 
 ChunkPtr ChunkManager::findIntersectingChunk(OperationContext* txn, const BSONObj& shardKey) const {
     {
-        BSONObj chunkMin;
-        ChunkPtr chunk;
-        {
-            ChunkMap::const_iterator it = _chunkMap.upper_bound(shardKey);
-            if (it != _chunkMap.end()) {
-                chunkMin = it->first;
-                chunk = it->second;
-            }
-        }
+        ChunkPtr chunk = _routingTable.upperBound(shardKey);
 
         if (chunk) {
             if (chunk->containsKey(shardKey)) {
                 return chunk;
             }
 
-            log() << chunkMin;
+            log() << chunk->getMax();
             log() << *chunk;
             log() << shardKey;
 
@@ -525,6 +532,74 @@ void ChunkManager::getShardIdsForQuery(set<ShardId>& shardIds, const BSONObj& qu
     }
 }
 
+bool ChunkManager::splitQueryByShard(const BSONObj& query,
+                                     map<ShardId, BSONObj>* shardQueries) const {
+    dassert(shardQueries->empty());
+
+    const BSONObj& keyPattern = _keyPattern.toBSON();
+    if (keyPattern.nFields() != 1) {
+        return false;
+    }
+
+    const StringData keyField = keyPattern.firstElement().fieldNameStringData();
+    const BSONElement keyPredicate = query[keyField];
+    if (keyPredicate.type() != Object || keyPredicate.Obj().nFields() != 1) {
+        return false;
+    }
+
+    const BSONElement inElement = keyPredicate.Obj().firstElement();
+    if (inElement.fieldNameStringData() != "$in" || inElement.type() != Array) {
+        return false;
+    }
+
+    // Group the values by the shard owning the chunk each one routes to. Values which are not
+    // plain equalities over the shard key (regular expressions, arrays, ...) make the whole query
+    // fall back to being forwarded unmodified.
+    map<ShardId, BSONArrayBuilder> valuesByShard;
+    for (const auto& value : inElement.Obj()) {
+        if (value.type() == Array || value.type() == RegEx ||
+            (value.type() == Object && !value.embeddedObject().okForStorage())) {
+            return false;
+        }
+
+        BSONObjBuilder shardKeyBuilder;
+        if (_keyPattern.isHashedPattern()) {
+            shardKeyBuilder.append(
+                keyField, BSONElementHasher::hash64(value, BSONElementHasher::DEFAULT_HASH_SEED));
+        } else {
+            shardKeyBuilder.appendAs(value, keyField);
+        }
+        const BSONObj shardKey = shardKeyBuilder.obj();
+
+        ChunkPtr chunk = _routingTable.upperBound(shardKey);
+        if (!chunk || !chunk->containsKey(shardKey)) {
+            return false;
+        }
+
+        valuesByShard[chunk->getShardId()].append(value);
+    }
+
+    if (valuesByShard.empty()) {
+        return false;
+    }
+
+    for (auto& shardValues : valuesByShard) {
+        BSONObjBuilder shardQuery;
+        for (const auto& elem : query) {
+            if (elem.fieldNameStringData() == keyField) {
+                BSONObjBuilder inBuilder(shardQuery.subobjStart(keyField));
+                inBuilder.appendArray("$in", shardValues.second.arr());
+                inBuilder.doneFast();
+            } else {
+                shardQuery.append(elem);
+            }
+        }
+        shardQueries->emplace(shardValues.first, shardQuery.obj());
+    }
+
+    return true;
+}
+
 void ChunkManager::getShardIdsForRange(set<ShardId>& shardIds,
                                        const BSONObj& min,
                                        const BSONObj& max) const {
@@ -791,6 +866,59 @@ void ChunkRangeManager::reloadAll(const ChunkMap& chunks) {
     DEV assertValid();
 }
 
+namespace {
+
+// KeyString encodes index keys, whose elements have empty field names.
+BSONObj stripFieldNames(const BSONObj& obj) {
+    BSONObjBuilder stripped(obj.objsize());
+    for (const auto& elem : obj) {
+        stripped.appendAs(elem, StringData());
+    }
+    return stripped.obj();
+}
+
+}  // namespace
+
+ChunkRoutingTable::ChunkRoutingTable(const ChunkMap& chunks) {
+    // Chunk bounds are compared with BSONObj::woCompare, so the keys are all encoded ascending.
+    const Ordering ordering = Ordering::make(BSONObj());
+
+    _offsets.reserve(chunks.size() + 1);
+    _chunks.reserve(chunks.size());
+    _offsets.push_back(0);
+    for (const auto& entry : chunks) {
+        const KeyString max(stripFieldNames(entry.first), ordering);
+        _bounds.append(max.getBuffer(), max.getSize());
+        _offsets.push_back(_bounds.size());
+        _chunks.push_back(entry.second);
+    }
+}
+
+std::shared_ptr<Chunk> ChunkRoutingTable::upperBound(const BSONObj& shardKey) const {
+    const KeyString key(stripFieldNames(shardKey), Ordering::make(BSONObj()));
+    const char* const keyData = key.getBuffer();
+    const size_t keySize = key.getSize();
+
+    // Find the first max greater than the key.
+    size_t low = 0;
+    size_t high = _chunks.size();
+    while (low < high) {
+        const size_t mid = low + (high - low) / 2;
+        const size_t boundSize = _offsets[mid + 1] - _offsets[mid];
+        int cmp = memcmp(_bounds.data() + _offsets[mid], keyData, std::min(boundSize, keySize));
+        if (cmp == 0) {
+            cmp = boundSize < keySize ? -1 : (boundSize > keySize ? 1 : 0);
+        }
+        if (cmp > 0) {
+            high = mid;
+        } else {
+            low = mid + 1;
+        }
+    }
+
+    return low == _chunks.size() ? std::shared_ptr<Chunk>() : _chunks[low];
+}
+
 void ChunkRangeManager::_insertRange(ChunkMap::const_iterator begin,
                                      const ChunkMap::const_iterator end) {
     while (begin != end) {
@@ -120,6 +120,34 @@ private:
     ChunkRangeMap _ranges;
 };
 
+/**
+ * Immutable index of the chunks of a ChunkMap by their max, used to route shard keys. The bounds
+ * are KeyString encoded into one contiguous buffer, so that a lookup encodes the shard key once
+ * and binary searches with memcmp rather than comparing BSONObjs down the levels of a map.
+ */
+class ChunkRoutingTable {
+public:
+    ChunkRoutingTable() = default;
+
+    explicit ChunkRoutingTable(const ChunkMap& chunks);
+
+    /**
+     * Returns the chunk with the smallest max greater than 'shardKey', like
+     * ChunkMap::upper_bound(), or a null pointer if there is none.
+     */
+    std::shared_ptr<Chunk> upperBound(const BSONObj& shardKey) const;
+
+    size_t size() const {
+        return _chunks.size();
+    }
+
+private:
+    // The encoded max of chunk i is _bounds[_offsets[i], _offsets[i + 1]).
+    std::string _bounds;
+    std::vector<size_t> _offsets;
+    std::vector<std::shared_ptr<Chunk>> _chunks;
+};
+
 
 /* config.sharding
      { ns: 'alleyinsider.fs.chunks' ,
@@ -197,6 +225,16 @@ public:
     ChunkPtr findIntersectingChunk(OperationContext* txn, const BSONObj& shardKey) const;
 
     void getShardIdsForQuery(std::set<ShardId>& shardIds, const BSONObj& query) const;
+
+    /**
+     * If 'query' restricts a single-field shard key with a top-level $in of equality values, as
+     * in { key : { $in : [ ... ] }, ... }, fills 'shardQueries' with one copy of 'query' per
+     * shard owning any of the values, whose $in lists only the values routed to that shard.
+     *
+     * Returns false, leaving 'shardQueries' empty, if the query is not of this form.
+     */
+    bool splitQueryByShard(const BSONObj& query,
+                           std::map<ShardId, BSONObj>* shardQueries) const;
     void getAllShardIds(std::set<ShardId>* all) const;
     /** @param shardIds set to the shard ids for shards
      *         covered by the interval [min, max], see SERVER-4791
@@ -245,6 +283,12 @@ public:
     std::shared_ptr<ChunkManager> reload(OperationContext* txn,
                                          bool force = true) const;  // doesn't modify self!
 
+    /**
+     * Like reload(), but does not wait if another thread is already reloading this collection.
+     * Used to pick up changes made by this process whose effect is not needed immediately.
+     */
+    void refresh(OperationContext* txn) const;
+
     /**
      * Returns the opTime of config server the last time chunks were loaded.
      */
@@ -271,6 +315,7 @@ private:
 
     ChunkMap _chunkMap;
     ChunkRangeManager _chunkRanges;
+    ChunkRoutingTable _routingTable;
 
     std::set<ShardId> _shardIds;
 
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/client/async_multi_command.h"
+
+#include "mongo/db/audit.h"
+#include "mongo/executor/remote_command_request.h"
+#include "mongo/s/cluster_last_error_info.h"
+#include "mongo/stdx/memory.h"
+
+namespace mongo {
+
+using executor::RemoteCommandRequest;
+using executor::TaskExecutor;
+
+AsyncMultiCommand::AsyncMultiCommand(TaskExecutor* executor) : _executor(executor) {}
+
+AsyncMultiCommand::~AsyncMultiCommand() {
+    // The callbacks of outstanding commands reference them, so they must have run before the
+    // commands can be released.
+    for (const auto& command : _pendingCommands) {
+        if (command->cbHandle.isValid()) {
+            _executor->cancel(command->cbHandle);
+            _executor->wait(command->cbHandle);
+        }
+    }
+}
+
+void AsyncMultiCommand::addCommand(const ConnectionString& endpoint,
+                                   StringData dbName,
+                                   const BSONObj& request) {
+    _pendingCommands.push_back(stdx::make_unique<PendingCommand>(endpoint, dbName, request));
+}
+
+void AsyncMultiCommand::sendAll() {
+    // The impersonated users, used by the shards for auditing, belong to the client running the
+    // commands, which the executor's network threads don't have.
+    BSONObjBuilder metadataBob;
+    audit::writeImpersonatedUsersToMetadata(&metadataBob);
+    const BSONObj metadata = metadataBob.obj();
+
+    for (const auto& command : _pendingCommands) {
+        dassert(!command->cbHandle.isValid());
+        dassert(command->endpoint.type() == ConnectionString::MASTER ||
+                command->endpoint.type() == ConnectionString::CUSTOM);
+
+        const RemoteCommandRequest request(
+            command->endpoint.getServers().front(), command->dbName, command->cmdObj, metadata);
+
+        PendingCommand* const pending = command.get();
+        auto cbHandle = _executor->scheduleRemoteCommand(
+            request, [this, pending](const TaskExecutor::RemoteCommandCallbackArgs& cbData) {
+                stdx::lock_guard<stdx::mutex> lk(_mutex);
+                pending->response = cbData.response;
+                pending->done = true;
+                _responseCV.notify_all();
+            });
+
+        if (!cbHandle.isOK()) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            pending->response = cbHandle.getStatus();
+            pending->done = true;
+            continue;
+        }
+
+        pending->cbHandle = cbHandle.getValue();
+    }
+}
+
+int AsyncMultiCommand::numPending() const {
+    return static_cast<int>(_pendingCommands.size());
+}
+
+Status AsyncMultiCommand::recvAny(ConnectionString* endpoint, BSONSerializable* response) {
+    std::unique_ptr<PendingCommand> command;
+
+    {
+        stdx::unique_lock<stdx::mutex> lk(_mutex);
+        while (!command) {
+            for (auto it = _pendingCommands.begin(); it != _pendingCommands.end(); ++it) {
+                if ((*it)->done) {
+                    command = std::move(*it);
+                    _pendingCommands.erase(it);
+                    break;
+                }
+            }
+
+            if (!command) {
+                _responseCV.wait(lk);
+            }
+        }
+    }
+
+    *endpoint = command->endpoint;
+    if (!command->response.isOK()) {
+        return command->response.getStatus();
+    }
+
+    const auto& remoteResponse = command->response.getValue();
+
+    // Capture the shard's last op so that getLastError calls made by the client can wait for it,
+    // as the ShardConnection reply metadata reader does.
+    saveGLEStats(remoteResponse.metadata, command->endpoint.getServers().front().toString());
+
+    std::string errMsg;
+    if (!response->parseBSON(remoteResponse.data, &errMsg) || !response->isValid(&errMsg)) {
+        return Status(ErrorCodes::FailedToParse, errMsg);
+    }
+
+    return Status::OK();
+}
+
+AsyncMultiCommand::PendingCommand::PendingCommand(const ConnectionString& endpoint,
+                                                  StringData dbName,
+                                                  const BSONObj& cmdObj)
+    : endpoint(endpoint),
+      dbName(dbName.toString()),
+      cmdObj(cmdObj),
+      done(false),
+      response(Status(ErrorCodes::InternalError, "no response received")) {}
+
+}  // namespace mongo
@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/executor/task_executor.h"
+#include "mongo/s/client/multi_command_dispatch.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * An AsyncMultiCommand sends commands to different hosts in parallel through a TaskExecutor, so
+ * that they share the executor's connection pool instead of each checking out a ShardConnection
+ * for the duration of the command.
+ *
+ * Unlike DBClientMultiCommand, responses are returned in the order they arrive.
+ *
+ * See MultiCommandDispatch for more details.
+ */
+class AsyncMultiCommand : public MultiCommandDispatch {
+    MONGO_DISALLOW_COPYING(AsyncMultiCommand);
+
+public:
+    explicit AsyncMultiCommand(executor::TaskExecutor* executor);
+
+    /**
+     * Cancels the commands whose responses haven't been received and waits for their callbacks.
+     */
+    ~AsyncMultiCommand();
+
+    void addCommand(const ConnectionString& endpoint,
+                    StringData dbName,
+                    const BSONObj& request) override;
+
+    void sendAll() override;
+
+    int numPending() const override;
+
+    Status recvAny(ConnectionString* endpoint, BSONSerializable* response) override;
+
+private:
+    // All info associated with an pre- or in-flight command
+    struct PendingCommand {
+        PendingCommand(const ConnectionString& endpoint, StringData dbName, const BSONObj& cmdObj);
+
+        // What to send
+        const ConnectionString endpoint;
+        const std::string dbName;
+        const BSONObj cmdObj;
+
+        // Set once the command has been scheduled
+        executor::TaskExecutor::CallbackHandle cbHandle;
+
+        // The response, or whatever went wrong. Only valid once 'done' is set.
+        bool done;
+        executor::TaskExecutor::ResponseStatus response;
+    };
+
+    typedef std::deque<std::unique_ptr<PendingCommand>> PendingQueue;
+
+    executor::TaskExecutor* const _executor;
+
+    // Protects the 'done' and 'response' fields of the pending commands
+    stdx::mutex _mutex;
+
+    // Signalled each time a response arrives
+    stdx::condition_variable _responseCV;
+
+    PendingQueue _pendingCommands;
+};
+
+}  // namespace mongo
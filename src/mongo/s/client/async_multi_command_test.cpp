@@ -0,0 +1,105 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/client/async_multi_command.h"
+
+#include "mongo/executor/network_interface_mock.h"
+#include "mongo/executor/thread_pool_task_executor_test_fixture.h"
+#include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+using executor::NetworkInterfaceMock;
+using executor::RemoteCommandResponse;
+using executor::TaskExecutor;
+
+class AsyncMultiCommandTest : public executor::ThreadPoolExecutorTest {
+public:
+    void setUp() final {
+        ThreadPoolExecutorTest::setUp();
+        launchExecutorThread();
+    }
+
+    void postExecutorThreadLaunch() final {}
+
+protected:
+    const HostAndPort _host1{"shard1", 27017};
+    const HostAndPort _host2{"shard2", 27017};
+};
+
+TEST_F(AsyncMultiCommandTest, ResponsesAreReturnedAsTheyArrive) {
+    AsyncMultiCommand dispatcher(&getExecutor());
+    dispatcher.addCommand(ConnectionString(_host1), "db", BSON("insert"
+                                                                << "coll"));
+    dispatcher.addCommand(ConnectionString(_host2), "db", BSON("insert"
+                                                                << "coll"));
+    dispatcher.sendAll();
+    ASSERT_EQUALS(2, dispatcher.numPending());
+
+    NetworkInterfaceMock* net = getNet();
+    net->enterNetwork();
+    auto noi1 = net->getNextReadyRequest();
+    ASSERT_EQUALS(_host1, noi1->getRequest().target);
+    auto noi2 = net->getNextReadyRequest();
+    ASSERT_EQUALS(_host2, noi2->getRequest().target);
+
+    // The second shard answers first
+    net->scheduleResponse(
+        noi2,
+        net->now(),
+        RemoteCommandResponse(BSON("ok" << 1 << "n" << 1), BSONObj(), Milliseconds(0)));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ConnectionString endpoint;
+    BatchedCommandResponse response;
+    ASSERT_OK(dispatcher.recvAny(&endpoint, &response));
+    ASSERT_EQUALS(_host2, endpoint.getServers().front());
+    ASSERT(response.getOk());
+    ASSERT_EQUALS(1, response.getN());
+    ASSERT_EQUALS(1, dispatcher.numPending());
+
+    net->enterNetwork();
+    net->scheduleResponse(
+        noi1,
+        net->now(),
+        TaskExecutor::ResponseStatus(ErrorCodes::HostUnreachable, "shard1 is unreachable"));
+    net->runReadyNetworkOperations();
+    net->exitNetwork();
+
+    ASSERT_EQUALS(ErrorCodes::HostUnreachable, dispatcher.recvAny(&endpoint, &response));
+    ASSERT_EQUALS(_host1, endpoint.getServers().front());
+    ASSERT_EQUALS(0, dispatcher.numPending());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -36,16 +36,21 @@
 #include <vector>
 
 #include "mongo/base/status.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/write_concern_options.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/catalog/catalog_manager.h"
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/chunk_manager_targeter.h"
-#include "mongo/s/client/dbclient_multi_command.h"
+#include "mongo/s/client/async_multi_command.h"
+#include "mongo/s/client/shard_registry.h"
 #include "mongo/s/config.h"
 #include "mongo/s/dbclient_shard_resolver.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_cache.h"
 #include "mongo/s/write_ops/batch_write_exec.h"
+#include "mongo/s/write_ops/coalescing_write_dispatch.h"
+#include "mongo/stdx/memory.h"
 #include "mongo/util/log.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -60,8 +65,23 @@ using std::stringstream;
 
 const int ConfigOpTimeoutMillis = 30 * 1000;
 
+// Unordered inserts with the default write concern, which concurrent operations send to the same
+// shard and collection within this many microseconds, are merged into one insert command. Zero
+// sends every batch on its own.
+MONGO_EXPORT_SERVER_PARAMETER(clusterWriteCoalescingWindowMicros, int, 0);
+
 namespace {
 
+/**
+ * Returns the coalescer through which the batches of all operations are merged.
+ */
+WriteCoalescer* getWriteCoalescer() {
+    static WriteCoalescer* const coalescer = new WriteCoalescer([] {
+        return stdx::make_unique<AsyncMultiCommand>(grid.shardRegistry()->getExecutor());
+    });
+    return coalescer;
+}
+
 /**
  * Constructs the BSON specification document for the given namespace, index key
  * and options.
@@ -257,10 +277,24 @@ void ClusterWriter::write(OperationContext* txn,
         }
 
         DBClientShardResolver resolver;
-        DBClientMultiCommand dispatcher;
-        BatchWriteExec exec(&targeter, &resolver, &dispatcher);
+        AsyncMultiCommand asyncDispatcher(grid.shardRegistry()->getExecutor());
+        MultiCommandDispatch* dispatcher = &asyncDispatcher;
+
+        std::unique_ptr<CoalescingWriteDispatch> coalescingDispatcher;
+        const int coalescingWindowMicros = clusterWriteCoalescingWindowMicros;
+        if (coalescingWindowMicros > 0) {
+            coalescingDispatcher = stdx::make_unique<CoalescingWriteDispatch>(
+                getWriteCoalescer(), &asyncDispatcher, Microseconds(coalescingWindowMicros));
+            dispatcher = coalescingDispatcher.get();
+        }
+
+        BatchWriteExec exec(&targeter, &resolver, dispatcher);
         exec.executeBatch(txn, request, response);
 
+        // Whether or not it succeeded, the batch may have changed documents that queries through
+        // this mongos have cached.
+        ClusterQueryCache::get()->invalidate(request.getTargetingNSS());
+
         if (_autoSplit) {
             splitIfNeeded(txn, request.getNS(), *targeter.getStats());
         }
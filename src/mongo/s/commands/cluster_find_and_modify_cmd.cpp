@@ -42,6 +42,7 @@
 #include "mongo/s/chunk_manager.h"
 #include "mongo/s/cluster_explain.h"
 #include "mongo/s/grid.h"
+#include "mongo/s/query/cluster_query_cache.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/s/strategy.h"
 #include "mongo/util/timer.h"
@@ -219,6 +220,8 @@ private:
         bool ok = conn->runCommand(conf->name(), cmdObj, res);
         conn.done();
 
+        ClusterQueryCache::get()->invalidate(NamespaceString(ns));
+
         // RecvStaleConfigCode is the code for RecvStaleConfigException.
         if (!ok && res.getIntField("code") == RecvStaleConfigCode) {
             // Command code traps this exception and re-runs
@@ -33,6 +33,7 @@
 #include "mongo/s/catalog/forwarding_catalog_manager.h"
 #include "mongo/s/grid.h"
 #include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/util/net/message_compressor.h"
 
 namespace mongo {
 namespace {
@@ -76,6 +77,7 @@ public:
         // it is compiled.
         result.append("maxWireVersion", maxWireVersion);
         result.append("minWireVersion", minWireVersion);
+        MessageCompressorManager::serverNegotiate(cmdObj, &result);
 
         return true;
     }
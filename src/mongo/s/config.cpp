@@ -54,6 +54,7 @@
 #include "mongo/s/cluster_write.h"
 #include "mongo/s/grid.h"
 #include "mongo/util/log.h"
+#include "mongo/util/scopeguard.h"
 
 namespace mongo {
 
@@ -280,6 +281,19 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
                                                         const string& ns,
                                                         bool shouldReload,
                                                         bool forceReload) {
+    return _getChunkManager(txn, ns, shouldReload, forceReload, true);
+}
+
+std::shared_ptr<ChunkManager> DBConfig::refreshChunkManager(OperationContext* txn,
+                                                            const string& ns) {
+    return _getChunkManager(txn, ns, true, false, false);
+}
+
+std::shared_ptr<ChunkManager> DBConfig::_getChunkManager(OperationContext* txn,
+                                                         const string& ns,
+                                                         bool shouldReload,
+                                                         bool forceReload,
+                                                         bool waitForReloadInProgress) {
     BSONObj key;
     ChunkVersion oldVersion;
     ChunkManagerPtr oldManager;
@@ -345,92 +359,148 @@ std::shared_ptr<ChunkManager> DBConfig::getChunkManager(OperationContext* txn,
 
     // we are not locked now, and want to load a new ChunkManager
 
-    unique_ptr<ChunkManager> tempChunkManager;
+    stdx::unique_lock<stdx::mutex> lk(_lock);
 
-    {
-        stdx::lock_guard<stdx::mutex> lll(_hitConfigServerLock);
+    // Only one thread at a time reloads this namespace. Reloads of the other collections in the
+    // database are not held up behind it.
+    for (auto it = _reloadsInProgress.find(ns); it != _reloadsInProgress.end();
+         it = _reloadsInProgress.find(ns)) {
+        if (!waitForReloadInProgress) {
+            // The reload in flight may have read the chunks before the caller's change, so have
+            // it load once more and serve the cached chunk manager in the meantime
+            it->second = true;
 
-        if (!newestChunk.empty() && !forceReload) {
-            // If we have a target we're going for see if we've hit already
-            stdx::lock_guard<stdx::mutex> lk(_lock);
+            const CollectionInfo& ci = _collections[ns];
+            uassert(10181, str::stream() << "not sharded:" << ns, ci.isSharded());
+            return ci.getCM();
+        }
 
-            CollectionInfo& ci = _collections[ns];
+        _reloadFinishedCV.wait(lk);
+    }
 
-            if (ci.isSharded() && ci.getCM()) {
-                ChunkVersion currentVersion = newestChunk[0].getVersion();
+    if (!newestChunk.empty() && !forceReload) {
+        // If we have a target we're going for see if we've hit already
+        CollectionInfo& ci = _collections[ns];
 
-                // Only reload if the version we found is newer than our own in the same epoch
-                if (currentVersion <= ci.getCM()->getVersion() &&
-                    ci.getCM()->getVersion().hasEqualEpoch(currentVersion)) {
-                    return ci.getCM();
-                }
+        if (ci.isSharded() && ci.getCM()) {
+            ChunkVersion currentVersion = newestChunk[0].getVersion();
+
+            // Only reload if the version we found is newer than our own in the same epoch
+            if (currentVersion <= ci.getCM()->getVersion() &&
+                ci.getCM()->getVersion().hasEqualEpoch(currentVersion)) {
+                return ci.getCM();
             }
         }
+    } else if (!forceReload) {
+        // Without a target version, coalesce with a reload of this collection which completed
+        // while we waited and installed a newer ChunkManager than the one we set out to replace.
+        // Should that one be stale too, the caller's retry reloads again.
+        CollectionInfo& ci = _collections[ns];
+
+        if (ci.isSharded() && ci.getCM() && ci.getCM() != oldManager) {
+            return ci.getCM();
+        }
+    }
+
+    _reloadsInProgress[ns] = false;
 
-        tempChunkManager.reset(new ChunkManager(
+    const auto endReload = [&] {
+        _reloadsInProgress.erase(ns);
+        _reloadFinishedCV.notify_all();
+    };
+
+    ScopeGuard reloadGuard = MakeGuard([&] {
+        if (!lk.owns_lock()) {
+            lk.lock();
+        }
+
+        endReload();
+    });
+
+    while (true) {
+        lk.unlock();
+
+        unique_ptr<ChunkManager> tempChunkManager(new ChunkManager(
             oldManager->getns(), oldManager->getShardKeyPattern(), oldManager->isUnique()));
         tempChunkManager->loadExistingRanges(txn, oldManager.get());
 
         if (tempChunkManager->numChunks() == 0) {
+            lk.lock();
+            endReload();
+            reloadGuard.Dismiss();
+            lk.unlock();
+
             // Maybe we're not sharded any more, so do a full reload
             reload(txn);
 
             return getChunkManager(txn, ns, false);
         }
-    }
 
-    stdx::lock_guard<stdx::mutex> lk(_lock);
+        lk.lock();
 
-    CollectionInfo& ci = _collections[ns];
-    uassert(14822, (string) "state changed in the middle: " + ns, ci.isSharded());
+        CollectionInfo& ci = _collections[ns];
+        uassert(14822, (string) "state changed in the middle: " + ns, ci.isSharded());
 
-    // Reset if our versions aren't the same
-    bool shouldReset = !tempChunkManager->getVersion().equals(ci.getCM()->getVersion());
+        // Reset if our versions aren't the same
+        bool shouldReset = !tempChunkManager->getVersion().equals(ci.getCM()->getVersion());
 
-    // Also reset if we're forced to do so
-    if (!shouldReset && forceReload) {
-        shouldReset = true;
-        warning() << "chunk manager reload forced for collection '" << ns << "', config version is "
-                  << tempChunkManager->getVersion();
-    }
+        // Also reset if we're forced to do so
+        if (!shouldReset && forceReload) {
+            shouldReset = true;
+            warning() << "chunk manager reload forced for collection '" << ns
+                      << "', config version is " << tempChunkManager->getVersion();
+        }
 
-    //
-    // LEGACY BEHAVIOR
-    //
-    // It's possible to get into a state when dropping collections when our new version is
-    // less than our prev version. Behave identically to legacy mongos, for now, and warn to
-    // draw attention to the problem.
-    //
-    // TODO: Assert in next version, to allow smooth upgrades
-    //
+        //
+        // LEGACY BEHAVIOR
+        //
+        // It's possible to get into a state when dropping collections when our new version is
+        // less than our prev version. Behave identically to legacy mongos, for now, and warn to
+        // draw attention to the problem.
+        //
+        // TODO: Assert in next version, to allow smooth upgrades
+        //
+
+        if (shouldReset && tempChunkManager->getVersion() < ci.getCM()->getVersion()) {
+            shouldReset = false;
+
+            warning() << "not resetting chunk manager for collection '" << ns
+                      << "', config version is " << tempChunkManager->getVersion() << " and "
+                      << "old version is " << ci.getCM()->getVersion();
+        }
 
-    if (shouldReset && tempChunkManager->getVersion() < ci.getCM()->getVersion()) {
-        shouldReset = false;
+        // end legacy behavior
 
-        warning() << "not resetting chunk manager for collection '" << ns << "', config version is "
-                  << tempChunkManager->getVersion() << " and "
-                  << "old version is " << ci.getCM()->getVersion();
-    }
+        if (shouldReset) {
+            const auto cmOpTime = tempChunkManager->getConfigOpTime();
+            invariant(cmOpTime >= _configOpTime);
+
+            // The existing ChunkManager could have been updated since we last checked, so
+            // replace the existing chunk manager only if it is strictly newer.
+            // The condition should be (>) than instead of (>=), but use (>=) since legacy non-repl
+            // config servers will always have an opTime of zero.
+            if (cmOpTime >= ci.getCM()->getConfigOpTime()) {
+                ci.resetCM(tempChunkManager.release());
+            }
+        }
 
-    // end legacy behavior
+        uassert(15883,
+                str::stream() << "not sharded after chunk manager reset : " << ns,
+                ci.isSharded());
 
-    if (shouldReset) {
-        const auto cmOpTime = tempChunkManager->getConfigOpTime();
-        invariant(cmOpTime >= _configOpTime);
+        auto it = _reloadsInProgress.find(ns);
+        invariant(it != _reloadsInProgress.end());
 
-        // The existing ChunkManager could have been updated since we last checked, so
-        // replace the existing chunk manager only if it is strictly newer.
-        // The condition should be (>) than instead of (>=), but use (>=) since legacy non-repl
-        // config servers will always have an opTime of zero.
-        if (cmOpTime >= ci.getCM()->getConfigOpTime()) {
-            ci.resetCM(tempChunkManager.release());
+        if (!it->second) {
+            return ci.getCM();
         }
-    }
 
-    uassert(
-        15883, str::stream() << "not sharded after chunk manager reset : " << ns, ci.isSharded());
-
-    return ci.getCM();
+        // A proactive refresh arrived while we were loading, so load once more to be sure its
+        // change is picked up
+        it->second = false;
+        oldManager = ci.getCM();
+        forceReload = false;
+    }
 }
 
 void DBConfig::setPrimary(OperationContext* txn, const std::string& s) {
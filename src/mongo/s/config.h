@@ -28,11 +28,13 @@
 
 #pragma once
 
+#include <map>
 #include <set>
 
 #include "mongo/db/jsobj.h"
 #include "mongo/db/repl/optime.h"
 #include "mongo/s/client/shard.h"
+#include "mongo/stdx/condition_variable.h"
 #include "mongo/util/concurrency/mutex.h"
 
 namespace mongo {
@@ -159,6 +161,15 @@ public:
                                                           bool reload = false,
                                                           bool forceReload = false);
 
+    /**
+     * Proactively refreshes the chunk manager for 'ns', for use after this process has changed
+     * the collection's chunks and does not need to observe the result right away. If another
+     * thread is already reloading the namespace, returns the currently cached chunk manager
+     * without waiting and has that thread load once more after it finishes.
+     */
+    std::shared_ptr<ChunkManager> refreshChunkManager(OperationContext* txn,
+                                                      const std::string& ns);
+
     /**
      * Returns shard id for primary shard for the database for which this DBConfig represents.
      */
@@ -182,6 +193,12 @@ protected:
                                  std::set<ShardId>& shardIds,
                                  std::string& errmsg);
 
+    std::shared_ptr<ChunkManager> _getChunkManager(OperationContext* txn,
+                                                   const std::string& ns,
+                                                   bool shouldReload,
+                                                   bool forceReload,
+                                                   bool waitForReloadInProgress);
+
     bool _load(OperationContext* txn);
 
     void _save(OperationContext* txn, bool db = true, bool coll = true);
@@ -202,9 +219,12 @@ protected:
     // OpTime of config server when the database definition was loaded.
     repl::OpTime _configOpTime;
 
-    // Ensures that only one thread at a time loads collection configuration data from
-    // the config server
-    stdx::mutex _hitConfigServerLock;
+    // Namespaces whose chunks are currently being loaded from the config server, protected by
+    // _lock. Only one thread at a time reloads any given namespace, so that a slow reload does
+    // not hold up the other collections of this database. The value is set when a proactive
+    // refresh arrived during the reload and the reloading thread must load once more.
+    std::map<std::string, bool> _reloadsInProgress;
+    stdx::condition_variable _reloadFinishedCV;
 };
 
 
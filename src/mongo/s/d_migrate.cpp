@@ -1436,6 +1436,10 @@ void logOpForSharding(OperationContext* txn,
                       bool notInActiveChunk) {
     ShardingState::get(txn)->migrationSourceManager()->logOp(
         txn, opstr, ns, obj, patt, notInActiveChunk);
+
+    if (opstr[0] == 'i' && !notInActiveChunk) {
+        ShardingState::get(txn)->chunkSplitter()->noteInsert(txn, ns, obj);
+    }
 }
 
 }  // namespace mongo
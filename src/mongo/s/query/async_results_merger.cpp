@@ -32,6 +32,10 @@
 
 #include "mongo/s/query/async_results_merger.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "mongo/client/replica_set_monitor.h"
 #include "mongo/db/query/cursor_response.h"
 #include "mongo/db/query/getmore_request.h"
 #include "mongo/db/query/killcursors_request.h"
@@ -43,6 +47,14 @@
 
 namespace mongo {
 
+namespace {
+
+// The fewest documents a getMore sized by a remote's share of a sorted merge asks for, so that
+// remotes which contribute little are not asked for their documents one or two at a time.
+const long long kMinAdaptiveBatchSize = 16;
+
+}  // namespace
+
 AsyncResultsMerger::AsyncResultsMerger(executor::TaskExecutor* executor,
                                        ClusterClientCursorParams params)
     : _executor(executor),
@@ -171,6 +183,8 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadySorted() {
 
     BSONObj front = _remotes[smallestRemote].docBuffer.front();
     _remotes[smallestRemote].docBuffer.pop();
+    ++_remotes[smallestRemote].mergedCount;
+    ++_mergedCount;
 
     // Re-populate the merging queue with the next result from 'smallestRemote', if it has a
     // next result.
@@ -190,6 +204,8 @@ boost::optional<BSONObj> AsyncResultsMerger::nextReadyUnsorted() {
         if (_remotes[_gettingFromRemote].hasNext()) {
             BSONObj front = _remotes[_gettingFromRemote].docBuffer.front();
             _remotes[_gettingFromRemote].docBuffer.pop();
+            ++_remotes[_gettingFromRemote].mergedCount;
+            ++_mergedCount;
 
             if (_params.isTailable && !_remotes[_gettingFromRemote].hasNext()) {
                 // The cursor is tailable and we're about to return the last buffered result. This
@@ -228,6 +244,25 @@ Status AsyncResultsMerger::askForNextBatch_inlock(size_t remoteIndex) {
         remote.fetchedCount = 0;
     }
 
+    if (remote.cursorId && _params.limit) {
+        // No remote needs to send more documents than the merged stream has left to return.
+        long long remaining =
+            std::max(*_params.limit + _params.skip.value_or(0) - _mergedCount, 1LL);
+
+        // In a sorted merge, size the batch by the share of the merged results this remote has
+        // supplied so far. A remote whose documents sort late would otherwise send documents
+        // which are never returned, as the other remotes fill the limit first.
+        if (!_params.sort.isEmpty()) {
+            const double share = (remote.mergedCount + 1.0) / (_mergedCount + _remotes.size());
+            const long long shareOfRemaining = std::ceil(2 * share * remaining);
+            remaining =
+                std::min(remaining, std::max(shareOfRemaining, kMinAdaptiveBatchSize));
+        }
+
+        adjustedBatchSize =
+            adjustedBatchSize ? std::min(*adjustedBatchSize, remaining) : remaining;
+    }
+
     BSONObj cmdObj = remote.cursorId
         ? GetMoreRequest(_params.nsString, *remote.cursorId, adjustedBatchSize, boost::none)
               .toBSON()
@@ -340,6 +375,14 @@ void AsyncResultsMerger::handleBatchResponse(
         return;
     }
 
+    // Feed the time this batch took into the replica set's host selection. Batches of tailable
+    // cursors are left out, since they may have been held on the remote waiting for new data.
+    if (remote.replSetMonitor && !_params.isTailable) {
+        remote.replSetMonitor->updateHostLatency(
+            remote.hostAndPort,
+            durationCount<Microseconds>(cbData.response.getValue().elapsedMillis));
+    }
+
     auto getMoreParseStatus = CursorResponse::parseFromBSON(cbData.response.getValue().data);
     if (!getMoreParseStatus.isOK()) {
         remote.status = getMoreParseStatus.getStatus();
@@ -498,7 +541,10 @@ executor::TaskExecutor::EventHandle AsyncResultsMerger::kill() {
 
 AsyncResultsMerger::RemoteCursorData::RemoteCursorData(
     const ClusterClientCursorParams::Remote& params)
-    : hostAndPort(params.hostAndPort), cmdObj(params.cmdObj), cursorId(params.cursorId) {
+    : hostAndPort(params.hostAndPort),
+      replSetMonitor(params.replSetMonitor),
+      cmdObj(params.cmdObj),
+      cursorId(params.cursorId) {
     // Either cmdObj or cursorId can be provided, but not both.
     invariant(static_cast<bool>(cmdObj) != static_cast<bool>(cursorId));
 }
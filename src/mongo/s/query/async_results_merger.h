@@ -168,6 +168,9 @@ private:
 
         HostAndPort hostAndPort;
 
+        // Told how long each batch from this remote took, if the remote is a replica set member.
+        std::shared_ptr<ReplicaSetMonitor> replSetMonitor;
+
         // The command object for sending to the remote to establish the cursor. If a remote cursor
         // has not been established yet, this member will be set to a valid command object. If a
         // remote cursor has already been established, this member will be unset.
@@ -186,6 +189,10 @@ private:
         // Count of fetched docs during ARM processing of the current batch. Used to reduce the
         // batchSize in getMore when mongod returned less docs than the requested batchSize.
         long long fetchedCount = 0;
+
+        // Count of this remote's docs returned by the ARM. Used to size getMores by the share of
+        // the merged results each remote supplies.
+        long long mergedCount = 0;
     };
 
     class MergingComparator {
@@ -288,6 +295,9 @@ private:
     // Used only if there is *not* a sort.
     size_t _gettingFromRemote = 0;
 
+    // The number of docs returned by nextReady() so far, from all remotes.
+    long long _mergedCount = 0;
+
     Status _status = Status::OK();
 
     executor::TaskExecutor::EventHandle _currentEvent;
@@ -969,6 +969,71 @@ TEST_F(AsyncResultsMergerTest, GetMoreBatchSizes) {
     ASSERT(!unittest::assertGet(arm->nextReady()));
 }
 
+TEST_F(AsyncResultsMergerTest, GetMoreBatchSizesFollowLimitAndShareOfSortedMerge) {
+    BSONObj findCmd = fromjson("{find: 'testcoll', sort: {_id: 1}, limit: 100}");
+    makeCursorFromFindCmd(findCmd, {_remotes[0], _remotes[1]});
+
+    auto readyEvent = unittest::assertGet(arm->nextEvent());
+
+    std::vector<CursorResponse> responses;
+    std::vector<BSONObj> batch1;
+    for (int i = 1; i <= 20; ++i) {
+        batch1.push_back(BSON("$sortKey" << BSON("" << i)));
+    }
+    responses.emplace_back(_nss, CursorId(1), batch1);
+    std::vector<BSONObj> batch2 = {fromjson("{$sortKey: {'': 101}}")};
+    responses.emplace_back(_nss, CursorId(2), batch2);
+    scheduleNetworkResponses(responses, CursorResponse::ResponseType::InitialResponse);
+    executor->waitForEvent(readyEvent);
+
+    for (int i = 1; i <= 20; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(BSON("$sortKey" << BSON("" << i)), *unittest::assertGet(arm->nextReady()));
+    }
+    ASSERT_FALSE(arm->ready());
+
+    // The first remote has supplied all of the merged results, so it is asked for everything the
+    // limit has left.
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    auto request = GetMoreRequest::parseFromBSON("anydbname", getFirstPendingRequest().cmdObj);
+    ASSERT_OK(request.getStatus());
+    ASSERT_EQ(request.getValue().cursorid, 1LL);
+    ASSERT_EQ(*request.getValue().batchSize, 80LL);
+
+    responses.clear();
+    std::vector<BSONObj> batch3;
+    for (int i = 21; i <= 30; ++i) {
+        batch3.push_back(BSON("$sortKey" << BSON("" << i)));
+    }
+    responses.emplace_back(_nss, CursorId(0), batch3);
+    scheduleNetworkResponses(responses, CursorResponse::ResponseType::SubsequentResponse);
+    executor->waitForEvent(readyEvent);
+
+    for (int i = 21; i <= 30; ++i) {
+        ASSERT_TRUE(arm->ready());
+        ASSERT_EQ(BSON("$sortKey" << BSON("" << i)), *unittest::assertGet(arm->nextReady()));
+    }
+    ASSERT_TRUE(arm->ready());
+    ASSERT_EQ(fromjson("{$sortKey: {'': 101}}"), *unittest::assertGet(arm->nextReady()));
+    ASSERT_FALSE(arm->ready());
+
+    // The second remote has supplied one of the 31 merged results, so it is sent a small batch.
+    readyEvent = unittest::assertGet(arm->nextEvent());
+    auto secondRequest =
+        GetMoreRequest::parseFromBSON("anydbname", getFirstPendingRequest().cmdObj);
+    ASSERT_OK(secondRequest.getStatus());
+    ASSERT_EQ(secondRequest.getValue().cursorid, 2LL);
+    ASSERT_EQ(*secondRequest.getValue().batchSize, 16LL);
+
+    responses.clear();
+    responses.emplace_back(_nss, CursorId(0), std::vector<BSONObj>());
+    scheduleNetworkResponses(responses, CursorResponse::ResponseType::SubsequentResponse);
+    executor->waitForEvent(readyEvent);
+
+    ASSERT_TRUE(arm->ready());
+    ASSERT(!unittest::assertGet(arm->nextReady()));
+}
+
 TEST_F(AsyncResultsMergerTest, SendsSecondaryOkAsMetadata) {
     BSONObj findCmd = fromjson("{find: 'testcoll', batchSize: 2}");
     const bool isSecondaryOk = true;
@@ -76,6 +76,11 @@ public:
      */
     virtual bool isTailable() const = 0;
 
+    /**
+     * Returns whether next() can return without waiting for results from remote nodes.
+     */
+    virtual bool ready() = 0;
+
     /**
      * Returns the number of result documents returned so far by this cursor via the next() method.
      */
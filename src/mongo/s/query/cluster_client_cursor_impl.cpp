@@ -72,6 +72,10 @@ bool ClusterClientCursorImpl::isTailable() const {
     return _isTailable;
 }
 
+bool ClusterClientCursorImpl::ready() {
+    return !_stash.empty() || _root->ready();
+}
+
 long long ClusterClientCursorImpl::getNumReturnedSoFar() const {
     return _numReturnedSoFar;
 }
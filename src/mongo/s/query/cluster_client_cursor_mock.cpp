@@ -75,6 +75,10 @@ bool ClusterClientCursorMock::isTailable() const {
     return false;
 }
 
+bool ClusterClientCursorMock::ready() {
+    return true;
+}
+
 void ClusterClientCursorMock::queueResult(const BSONObj& obj) {
     _resultsQueue.push({obj});
 }
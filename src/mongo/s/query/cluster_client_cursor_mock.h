@@ -49,6 +49,8 @@ public:
 
     bool isTailable() const final;
 
+    bool ready() final;
+
     long long getNumReturnedSoFar() const final;
 
     void queueResult(const BSONObj& obj) final;
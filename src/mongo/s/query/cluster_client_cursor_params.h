@@ -29,6 +29,7 @@
 #pragma once
 
 #include <boost/optional.hpp>
+#include <memory>
 #include <vector>
 
 #include "mongo/bson/bsonobj.h"
@@ -38,6 +39,8 @@
 
 namespace mongo {
 
+class ReplicaSetMonitor;
+
 struct ClusterClientCursorParams {
     // When mongos has to do a merge in order to return results to the client in the correct sort
     // order, it requests a sortKey meta-projection using this field name.
@@ -76,6 +79,11 @@ struct ClusterClientCursorParams {
         //
         // Exactly one of 'cmdObj' or 'cursorId' must be set.
         boost::optional<CursorId> cursorId;
+
+        // The monitor of the replica set which 'hostAndPort' belongs to, if any. It is told how
+        // long each batch took to come back, so that a member which slows down is passed over for
+        // reads within the local threshold. Optional.
+        std::shared_ptr<ReplicaSetMonitor> replSetMonitor;
     };
 
     ClusterClientCursorParams() {}
@@ -32,6 +32,7 @@
 
 #include <set>
 
+#include "mongo/stdx/memory.h"
 #include "mongo/util/clock_source.h"
 #include "mongo/util/mongoutils/str.h"
 
@@ -116,6 +117,11 @@ bool ClusterCursorManager::PinnedCursor::isTailable() const {
     return _cursor->isTailable();
 }
 
+bool ClusterCursorManager::PinnedCursor::ready() {
+    invariant(_cursor);
+    return _cursor->ready();
+}
+
 void ClusterCursorManager::PinnedCursor::returnCursor(CursorState cursorState) {
     invariant(_cursor);
     // Note that unpinning a cursor transfers ownership of the underlying ClusterClientCursor object
@@ -153,14 +159,26 @@ void ClusterCursorManager::PinnedCursor::returnAndKillCursor() {
 }
 
 ClusterCursorManager::ClusterCursorManager(ClockSource* clockSource)
-    : _pseudoRandom(std::unique_ptr<SecureRandom>(SecureRandom::create())->nextInt64()),
-      _clockSource(clockSource) {
+    : _clockSource(clockSource) {
     invariant(_clockSource);
+
+    std::unique_ptr<SecureRandom> secureRandom(SecureRandom::create());
+    _partitions.reserve(kNumPartitions);
+    for (uint32_t i = 0; i < kNumPartitions; ++i) {
+        _partitions.emplace_back(stdx::make_unique<Partition>(i, secureRandom->nextInt64()));
+    }
 }
 
 ClusterCursorManager::~ClusterCursorManager() {
-    invariant(_cursorIdPrefixToNamespaceMap.empty());
-    invariant(_namespaceToContainerMap.empty());
+    for (const auto& partition : _partitions) {
+        invariant(partition->cursorIdPrefixToNamespaceMap.empty());
+        invariant(partition->namespaceToContainerMap.empty());
+    }
+}
+
+ClusterCursorManager::Partition* ClusterCursorManager::getPartition(
+    const NamespaceString& nss) const {
+    return _partitions[NamespaceString::Hasher()(nss) % kNumPartitions].get();
 }
 
 ClusterCursorManager::PinnedCursor ClusterCursorManager::registerCursor(
@@ -168,26 +186,32 @@ ClusterCursorManager::PinnedCursor ClusterCursorManager::registerCursor(
     const NamespaceString& nss,
     CursorType cursorType,
     CursorLifetime cursorLifetime) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition* const partition = getPartition(nss);
+    stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
     invariant(cursor);
 
     // Find the CursorEntryContainer for this namespace.  If none exists, create one.
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto& namespaceToContainerMap = partition->namespaceToContainerMap;
+    auto& cursorIdPrefixToNamespaceMap = partition->cursorIdPrefixToNamespaceMap;
+    auto nsToContainerIt = namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == namespaceToContainerMap.end()) {
         uint32_t containerPrefix = 0;
         do {
             // The server has always generated positive values for CursorId (which is a signed
             // type), so we use std::abs() here on the prefix for consistency with this historical
-            // behavior.
-            containerPrefix = static_cast<uint32_t>(std::abs(_pseudoRandom.nextInt32()));
-        } while (_cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
-        _cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
+            // behavior.  The prefix is then moved into this partition's residue class, which keeps
+            // it below 2^31 since kNumPartitions is a power of two.
+            const uint32_t randomValue =
+                static_cast<uint32_t>(std::abs(partition->pseudoRandom.nextInt32()));
+            containerPrefix = randomValue - randomValue % kNumPartitions + partition->index;
+        } while (cursorIdPrefixToNamespaceMap.count(containerPrefix) > 0);
+        cursorIdPrefixToNamespaceMap[containerPrefix] = nss;
 
         auto emplaceResult =
-            _namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
+            namespaceToContainerMap.emplace(nss, CursorEntryContainer(containerPrefix));
         invariant(emplaceResult.second);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        invariant(namespaceToContainerMap.size() == cursorIdPrefixToNamespaceMap.size());
 
         nsToContainerIt = emplaceResult.first;
     } else {
@@ -199,7 +223,7 @@ ClusterCursorManager::PinnedCursor ClusterCursorManager::registerCursor(
     CursorEntryMap& entryMap = container.entryMap;
     CursorId cursorId = 0;
     do {
-        const uint32_t cursorSuffix = static_cast<uint32_t>(_pseudoRandom.nextInt32());
+        const uint32_t cursorSuffix = static_cast<uint32_t>(partition->pseudoRandom.nextInt32());
         cursorId = createCursorId(container.containerPrefix, cursorSuffix);
     } while (cursorId == 0 || entryMap.count(cursorId) > 0);
 
@@ -217,9 +241,10 @@ ClusterCursorManager::PinnedCursor ClusterCursorManager::registerCursor(
 
 StatusWith<ClusterCursorManager::PinnedCursor> ClusterCursorManager::checkOutCursor(
     const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition* const partition = getPartition(nss);
+    stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -242,11 +267,12 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
                                          const NamespaceString& nss,
                                          CursorId cursorId,
                                          CursorState cursorState) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition* const partition = getPartition(nss);
+    stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
     invariant(cursor);
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     invariant(entry);
 
     entry->returnCursor(std::move(cursor));
@@ -261,9 +287,10 @@ void ClusterCursorManager::checkInCursor(std::unique_ptr<ClusterClientCursor> cu
 }
 
 Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cursorId) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    Partition* const partition = getPartition(nss);
+    stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -274,82 +301,90 @@ Status ClusterCursorManager::killCursor(const NamespaceString& nss, CursorId cur
 }
 
 void ClusterCursorManager::killMortalCursorsInactiveSince(Date_t cutoff) {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorEntry& entry = cursorIdEntryPair.second;
-            if (entry.getLifetimeType() == CursorLifetime::Mortal &&
-                entry.getLastActive() <= cutoff) {
-                entry.setKillPending();
+    // Each partition is scanned under its own lock, so a scan never blocks the whole manager.
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorEntry& entry = cursorIdEntryPair.second;
+                if (entry.getLifetimeType() == CursorLifetime::Mortal &&
+                    entry.getLastActive() <= cutoff) {
+                    entry.setKillPending();
+                }
             }
         }
     }
 }
 
 void ClusterCursorManager::killAllCursors() {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            cursorIdEntryPair.second.setKillPending();
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                cursorIdEntryPair.second.setKillPending();
+            }
         }
     }
 }
 
 void ClusterCursorManager::reapZombieCursors() {
-    // List all zombie cursors under the manager lock, and kill them one-by-one while not holding
-    // the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold a lock while
-    // issuing the kill).
-
-    stdx::unique_lock<stdx::mutex> lk(_mutex);
-    std::vector<std::pair<NamespaceString, CursorId>> zombieCursorDescriptors;
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        const NamespaceString& nss = nsContainerPair.first;
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            CursorId cursorId = cursorIdEntryPair.first;
-            const CursorEntry& entry = cursorIdEntryPair.second;
-            if (!entry.getKillPending()) {
-                continue;
+    // List the zombie cursors of each partition under the partition lock, and kill them one-by-one
+    // while not holding the lock (ClusterClientCursor::kill() is blocking, so we don't want to hold
+    // a lock while issuing the kill).
+    for (const auto& partition : _partitions) {
+        stdx::unique_lock<stdx::mutex> lk(partition->mutex);
+        std::vector<std::pair<NamespaceString, CursorId>> zombieCursorDescriptors;
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            const NamespaceString& nss = nsContainerPair.first;
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                CursorId cursorId = cursorIdEntryPair.first;
+                const CursorEntry& entry = cursorIdEntryPair.second;
+                if (!entry.getKillPending()) {
+                    continue;
+                }
+                zombieCursorDescriptors.emplace_back(nss, cursorId);
             }
-            zombieCursorDescriptors.emplace_back(nss, cursorId);
         }
-    }
 
-    for (auto& namespaceCursorIdPair : zombieCursorDescriptors) {
-        StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor =
-            detachCursor_inlock(namespaceCursorIdPair.first, namespaceCursorIdPair.second);
-        if (!zombieCursor.isOK()) {
-            // Cursor in use, or has already been deleted.
-            continue;
-        }
+        for (auto& namespaceCursorIdPair : zombieCursorDescriptors) {
+            StatusWith<std::unique_ptr<ClusterClientCursor>> zombieCursor = detachCursor_inlock(
+                partition.get(), namespaceCursorIdPair.first, namespaceCursorIdPair.second);
+            if (!zombieCursor.isOK()) {
+                // Cursor in use, or has already been deleted.
+                continue;
+            }
 
-        lk.unlock();
-        zombieCursor.getValue()->kill();
-        lk.lock();
-        // Cursor deleted as it goes out of scope.
+            lk.unlock();
+            zombieCursor.getValue()->kill();
+            lk.lock();
+            // Cursor deleted as it goes out of scope.
+        }
     }
 }
 
 ClusterCursorManager::Stats ClusterCursorManager::stats() const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
-
     Stats stats;
 
-    for (auto& nsContainerPair : _namespaceToContainerMap) {
-        for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
-            const CursorEntry& entry = cursorIdEntryPair.second;
-
-            if (entry.getKillPending()) {
-                continue;
-            }
-            switch (entry.getCursorType()) {
-                case CursorType::NamespaceNotSharded:
-                    ++stats.cursorsNotSharded;
-                    break;
-                case CursorType::NamespaceSharded:
-                    ++stats.cursorsSharded;
-                    break;
+    for (const auto& partition : _partitions) {
+        stdx::lock_guard<stdx::mutex> lk(partition->mutex);
+
+        for (auto& nsContainerPair : partition->namespaceToContainerMap) {
+            for (auto& cursorIdEntryPair : nsContainerPair.second.entryMap) {
+                const CursorEntry& entry = cursorIdEntryPair.second;
+
+                if (entry.getKillPending()) {
+                    continue;
+                }
+                switch (entry.getCursorType()) {
+                    case CursorType::NamespaceNotSharded:
+                        ++stats.cursorsNotSharded;
+                        break;
+                    case CursorType::NamespaceSharded:
+                        ++stats.cursorsSharded;
+                        break;
+                }
             }
         }
     }
@@ -359,19 +394,22 @@ ClusterCursorManager::Stats ClusterCursorManager::stats() const {
 
 boost::optional<NamespaceString> ClusterCursorManager::getNamespaceForCursorId(
     CursorId cursorId) const {
-    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    const uint32_t prefix = extractPrefixFromCursorId(cursorId);
+    const Partition* partition = _partitions[prefix % kNumPartitions].get();
+    stdx::lock_guard<stdx::mutex> lk(partition->mutex);
 
-    const auto it = _cursorIdPrefixToNamespaceMap.find(extractPrefixFromCursorId(cursorId));
-    if (it == _cursorIdPrefixToNamespaceMap.end()) {
+    const auto it = partition->cursorIdPrefixToNamespaceMap.find(prefix);
+    if (it == partition->cursorIdPrefixToNamespaceMap.end()) {
         return boost::none;
     }
     return it->second;
 }
 
-ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const NamespaceString& nss,
+ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(Partition* partition,
+                                                                         const NamespaceString& nss,
                                                                          CursorId cursorId) {
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    if (nsToContainerIt == _namespaceToContainerMap.end()) {
+    auto nsToContainerIt = partition->namespaceToContainerMap.find(nss);
+    if (nsToContainerIt == partition->namespaceToContainerMap.end()) {
         return nullptr;
     }
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
@@ -384,8 +422,8 @@ ClusterCursorManager::CursorEntry* ClusterCursorManager::getEntry_inlock(const N
 }
 
 StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCursor_inlock(
-    const NamespaceString& nss, CursorId cursorId) {
-    CursorEntry* entry = getEntry_inlock(nss, cursorId);
+    Partition* partition, const NamespaceString& nss, CursorId cursorId) {
+    CursorEntry* entry = getEntry_inlock(partition, nss, cursorId);
     if (!entry) {
         return cursorNotFoundStatus(nss, cursorId);
     }
@@ -395,8 +433,8 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         return cursorInUseStatus(nss, cursorId);
     }
 
-    auto nsToContainerIt = _namespaceToContainerMap.find(nss);
-    invariant(nsToContainerIt != _namespaceToContainerMap.end());
+    auto nsToContainerIt = partition->namespaceToContainerMap.find(nss);
+    invariant(nsToContainerIt != partition->namespaceToContainerMap.end());
     CursorEntryMap& entryMap = nsToContainerIt->second.entryMap;
     size_t eraseResult = entryMap.erase(cursorId);
     invariant(1 == eraseResult);
@@ -404,10 +442,11 @@ StatusWith<std::unique_ptr<ClusterClientCursor>> ClusterCursorManager::detachCur
         // This was the last cursor remaining in the given namespace.  Erase all state associated
         // with this namespace.
         size_t numDeleted =
-            _cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
+            partition->cursorIdPrefixToNamespaceMap.erase(nsToContainerIt->second.containerPrefix);
         invariant(numDeleted == 1);
-        _namespaceToContainerMap.erase(nsToContainerIt);
-        invariant(_namespaceToContainerMap.size() == _cursorIdPrefixToNamespaceMap.size());
+        partition->namespaceToContainerMap.erase(nsToContainerIt);
+        invariant(partition->namespaceToContainerMap.size() ==
+                  partition->cursorIdPrefixToNamespaceMap.size());
     }
 
     return std::move(cursor);
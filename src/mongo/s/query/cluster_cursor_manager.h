@@ -158,6 +158,12 @@ public:
          */
         bool isTailable() const;
 
+        /**
+         * Returns whether next() can return without blocking.  Cannot be called after
+         * returnCursor() is called.  A cursor must be owned.
+         */
+        bool ready();
+
         /**
          * Transfers ownership of the underlying cursor back to the manager.  A cursor must be
          * owned, and a cursor will no longer be owned after this method completes.
@@ -317,6 +323,7 @@ public:
 
 private:
     class CursorEntry;
+    struct Partition;
     using CursorEntryMap = std::unordered_map<CursorId, CursorEntry>;
 
     /**
@@ -337,9 +344,11 @@ private:
      * Returns a pointer to the CursorEntry for the given cursor.  If the given cursor is not
      * registered, returns null.
      *
-     * Not thread-safe.
+     * The caller must hold the mutex of 'partition', which must be the partition of 'nss'.
      */
-    CursorEntry* getEntry_inlock(const NamespaceString& nss, CursorId cursorId);
+    static CursorEntry* getEntry_inlock(Partition* partition,
+                                        const NamespaceString& nss,
+                                        CursorId cursorId);
 
     /**
      * De-registers the given cursor, and returns an owned pointer to the underlying
@@ -348,10 +357,10 @@ private:
      * If the given cursor is pinned, returns an error Status with code CursorInUse.  If the given
      * cursor is not registered, returns an error Status with code CursorNotFound.
      *
-     * Not thread-safe.
+     * The caller must hold the mutex of 'partition', which must be the partition of 'nss'.
      */
-    StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(const NamespaceString& nss,
-                                                                         CursorId cursorId);
+    static StatusWith<std::unique_ptr<ClusterClientCursor>> detachCursor_inlock(
+        Partition* partition, const NamespaceString& nss, CursorId cursorId);
 
     /**
      * CursorEntry is a moveable, non-copyable container for a single cursor.
@@ -474,33 +483,60 @@ private:
         CursorEntryMap entryMap;
     };
 
-    // Synchronizes access to all private state.
-    mutable stdx::mutex _mutex;
+    /**
+     * An independently locked part of the manager's state. Each namespace belongs to exactly one
+     * partition, chosen by hashing it, so operations on cursors of different namespaces rarely
+     * contend on the same mutex.
+     *
+     * The cursor id prefixes given out by a partition are all congruent to its index modulo
+     * kNumPartitions, which lets getNamespaceForCursorId() find the partition from the id alone.
+     */
+    struct Partition {
+        MONGO_DISALLOW_COPYING(Partition);
+
+        Partition(uint32_t index, int64_t seed) : index(index), pseudoRandom(seed) {}
+
+        const uint32_t index;
+
+        // Synchronizes access to all other members.
+        mutable stdx::mutex mutex;
+
+        // Randomness source.  Used for cursor id generation.
+        PseudoRandom pseudoRandom;
+
+        // Map from cursor id prefix to associated namespace.  Exists only to provide namespace
+        // lookup for (deprecated) getNamespaceForCursorId() method.
+        //
+        // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the
+        // first cursor on a given namespace is registered, it is given a CursorId with a prefix
+        // that is unique to that namespace, and an arbitrary suffix.  Cursors subsequently
+        // registered on that namespace will all share the same prefix.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        std::unordered_map<uint32_t, NamespaceString> cursorIdPrefixToNamespaceMap;
+
+        // Map from namespace to the CursorEntryContainer for that namespace.
+        //
+        // Entries are added when the first cursor on the given namespace is registered, and
+        // removed when the last cursor on the given namespace is destroyed.
+        std::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
+            namespaceToContainerMap;
+    };
+
+    // Must be a power of two, so that prefixes of a partition stay below 2^31.
+    static const uint32_t kNumPartitions = 16;
 
-    // Randomness source.  Used for cursor id generation.
-    PseudoRandom _pseudoRandom;
+    /**
+     * Returns the partition holding the cursors on 'nss'.
+     */
+    Partition* getPartition(const NamespaceString& nss) const;
 
     // Clock source.  Used when the 'last active' time for a cursor needs to be set/updated.
     ClockSource* _clockSource;
 
-    // Map from cursor id prefix to associated namespace.  Exists only to provide namespace lookup
-    // for (deprecated) getNamespaceForCursorId() method.
-    //
-    // A CursorId is a 64-bit type, made up of a 32-bit prefix and a 32-bit suffix.  When the first
-    // cursor on a given namespace is registered, it is given a CursorId with a prefix that is
-    // unique to that namespace, and an arbitrary suffix.  Cursors subsequently registered on that
-    // namespace will all share the same prefix.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    std::unordered_map<uint32_t, NamespaceString> _cursorIdPrefixToNamespaceMap;
-
-    // Map from namespace to the CursorEntryContainer for that namespace.
-    //
-    // Entries are added when the first cursor on the given namespace is registered, and removed
-    // when the last cursor on the given namespace is destroyed.
-    std::unordered_map<NamespaceString, CursorEntryContainer, NamespaceString::Hasher>
-        _namespaceToContainerMap;
+    // Holds kNumPartitions partitions, indexed by Partition::index.
+    std::vector<std::unique_ptr<Partition>> _partitions;
 };
 
 }  // namespace
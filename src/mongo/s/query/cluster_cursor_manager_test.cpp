@@ -636,6 +636,40 @@ TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdMultipleCursorsDifferent
     }
 }
 
+// Test that cursors on many namespaces, which are spread over the manager's partitions, get
+// positive ids mapping back to their namespace, and that kills and stats cover all of them.
+TEST_F(ClusterCursorManagerTest, CursorsOnManyNamespaces) {
+    const size_t numNamespaces = 200;
+    std::vector<std::pair<NamespaceString, CursorId>> cursors;
+    for (size_t i = 0; i < numNamespaces; ++i) {
+        NamespaceString cursorNamespace(std::string(str::stream() << "test.collection" << i));
+        auto cursor =
+            getManager()->registerCursor(allocateMockCursor(),
+                                         cursorNamespace,
+                                         ClusterCursorManager::CursorType::NamespaceNotSharded,
+                                         ClusterCursorManager::CursorLifetime::Mortal);
+        ASSERT_GT(cursor.getCursorId(), 0);
+        cursors.emplace_back(cursorNamespace, cursor.getCursorId());
+        cursor.returnCursor(ClusterCursorManager::CursorState::NotExhausted);
+    }
+    ASSERT_EQ(numNamespaces, getManager()->stats().cursorsNotSharded);
+
+    for (const auto& nssCursorIdPair : cursors) {
+        boost::optional<NamespaceString> cursorNamespace =
+            getManager()->getNamespaceForCursorId(nssCursorIdPair.second);
+        ASSERT(cursorNamespace);
+        ASSERT_EQ(nssCursorIdPair.first.ns(), cursorNamespace->ns());
+    }
+
+    getManager()->killAllCursors();
+    ASSERT_EQ(0U, getManager()->stats().cursorsNotSharded);
+    getManager()->reapZombieCursors();
+    for (size_t i = 0; i < numNamespaces; ++i) {
+        ASSERT(isMockCursorKilled(i));
+        ASSERT_FALSE(getManager()->getNamespaceForCursorId(cursors[i].second));
+    }
+}
+
 // Test that getting the namespace for an unknown cursor returns boost::none.
 TEST_F(ClusterCursorManagerTest, GetNamespaceForCursorIdUnknown) {
     boost::optional<NamespaceString> cursorNamespace = getManager()->getNamespaceForCursorId(5);
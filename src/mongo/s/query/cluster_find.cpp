@@ -32,7 +32,9 @@
 
 #include "mongo/s/query/cluster_find.h"
 
+#include <map>
 #include <set>
+#include <string>
 #include <vector>
 
 #include "mongo/base/status_with.h"
@@ -40,10 +42,12 @@
 #include "mongo/client/connpool.h"
 #include "mongo/client/read_preference.h"
 #include "mongo/client/remote_command_targeter.h"
+#include "mongo/client/replica_set_monitor.h"
 #include "mongo/db/commands.h"
 #include "mongo/db/query/canonical_query.h"
 #include "mongo/db/query/find_common.h"
 #include "mongo/db/query/getmore_request.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/rpc/metadata/server_selection_metadata.h"
 #include "mongo/s/catalog/catalog_cache.h"
 #include "mongo/s/chunk_manager.h"
@@ -54,6 +58,7 @@
 #include "mongo/s/grid.h"
 #include "mongo/s/query/cluster_client_cursor_impl.h"
 #include "mongo/s/query/cluster_cursor_manager.h"
+#include "mongo/s/query/cluster_query_cache.h"
 #include "mongo/s/query/store_possible_cursor.h"
 #include "mongo/s/stale_exception.h"
 #include "mongo/stdx/memory.h"
@@ -61,6 +66,11 @@
 
 namespace mongo {
 
+// Once this many milliseconds have passed since a query was sent to the shards, mongos returns the
+// results it has buffered as the first batch rather than waiting on the shards to fill the batch.
+// Zero waits for a full batch.
+MONGO_EXPORT_SERVER_PARAMETER(clusterFindFirstBatchDeadlineMS, int, 0);
+
 namespace {
 
 static const BSONObj kSortKeyMetaProjection = BSON("$meta"
@@ -74,9 +84,10 @@ static const int kPerDocumentOverheadBytesUpperBound = 10;
 
 /**
  * Given the LiteParsedQuery 'lpq' being executed by mongos, returns a copy of the query which is
- * suitable for forwarding to the targeted hosts.
+ * suitable for forwarding to the targeted hosts, with 'filter' as its query predicate.
  */
-std::unique_ptr<LiteParsedQuery> transformQueryForShards(const LiteParsedQuery& lpq) {
+std::unique_ptr<LiteParsedQuery> transformQueryForShards(const LiteParsedQuery& lpq,
+                                                         const BSONObj& filter) {
     // If there is a limit, we forward the sum of the limit and the skip.
     boost::optional<long long> newLimit;
     if (lpq.getLimit()) {
@@ -99,7 +110,7 @@ std::unique_ptr<LiteParsedQuery> transformQueryForShards(const LiteParsedQuery&
     }
 
     return LiteParsedQuery::makeAsFindCmd(lpq.nss(),
-                                          lpq.getFilter(),
+                                          filter,
                                           newProjection,
                                           lpq.getSort(),
                                           lpq.getHint(),
@@ -183,26 +194,49 @@ StatusWith<CursorId> runConfigServerQuerySCCC(const CanonicalQuery& query,
     return outgoingCursorResponse.getValue().cursorId;
 }
 
+/**
+ * The version of the routing information a query on a collection with chunk manager
+ * 'chunkManager' is targeted with. Unsharded collections are always at the unsharded version.
+ */
+ChunkVersion getRoutingVersion(const std::shared_ptr<ChunkManager>& chunkManager) {
+    return chunkManager ? chunkManager->getVersion() : ChunkVersion::UNSHARDED();
+}
+
 StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
                                              const CanonicalQuery& query,
                                              const ReadPreferenceSetting& readPref,
                                              ChunkManager* chunkManager,
                                              std::shared_ptr<Shard> primary,
                                              std::vector<BSONObj>* results) {
+    boost::optional<Date_t> firstBatchDeadline;
+    if (clusterFindFirstBatchDeadlineMS > 0) {
+        firstBatchDeadline = Date_t::now() + Milliseconds(clusterFindFirstBatchDeadlineMS);
+    }
+
     auto shardRegistry = grid.shardRegistry();
 
     // Get the set of shards on which we will run the query.
     std::vector<std::shared_ptr<Shard>> shards;
+
+    // When the query is an $in over the shard key, each shard is sent only the values which route
+    // to it, rather than all of them.
+    std::map<ShardId, BSONObj> shardFilters;
     if (primary) {
         shards.emplace_back(std::move(primary));
     } else {
         invariant(chunkManager);
 
-        std::set<ShardId> shardIds;
-        chunkManager->getShardIdsForQuery(shardIds, query.getParsed().getFilter());
+        if (chunkManager->splitQueryByShard(query.getParsed().getFilter(), &shardFilters)) {
+            for (const auto& shardFilter : shardFilters) {
+                shards.emplace_back(shardRegistry->getShard(txn, shardFilter.first));
+            }
+        } else {
+            std::set<ShardId> shardIds;
+            chunkManager->getShardIdsForQuery(shardIds, query.getParsed().getFilter());
 
-        for (auto id : shardIds) {
-            shards.emplace_back(shardRegistry->getShard(txn, id));
+            for (auto id : shardIds) {
+                shards.emplace_back(shardRegistry->getShard(txn, id));
+            }
         }
     }
 
@@ -230,7 +264,8 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
     // Tailable cursors can't have a sort, which should have already been validated.
     invariant(params.sort.isEmpty() || !params.isTailable);
 
-    const auto lpqToForward = transformQueryForShards(query.getParsed());
+    const auto lpqToForward =
+        transformQueryForShards(query.getParsed(), query.getParsed().getFilter());
 
     // Use read pref to target a particular host from each shard. Also construct the find command
     // that we will forward to each shard.
@@ -250,7 +285,13 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
 
         // Build the find command, and attach shard version if necessary.
         BSONObjBuilder cmdBuilder;
-        lpqToForward->asFindCommand(&cmdBuilder);
+        auto shardFilter = shardFilters.find(shard->getId());
+        if (shardFilter != shardFilters.end()) {
+            transformQueryForShards(query.getParsed(), shardFilter->second)
+                ->asFindCommand(&cmdBuilder);
+        } else {
+            lpqToForward->asFindCommand(&cmdBuilder);
+        }
 
         if (chunkManager) {
             auto shardVersion = chunkManager->getVersion(shard->getId());
@@ -258,6 +299,10 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
         }
 
         params.remotes.emplace_back(std::move(hostAndPort.getValue()), cmdBuilder.obj());
+        if (shard->getConnString().type() == ConnectionString::SET) {
+            params.remotes.back().replSetMonitor =
+                ReplicaSetMonitor::get(shard->getConnString().getSetName());
+        }
     }
 
     auto ccc =
@@ -276,6 +321,12 @@ StatusWith<CursorId> runQueryWithoutRetrying(OperationContext* txn,
     auto cursorState = ClusterCursorManager::CursorState::NotExhausted;
     int bytesBuffered = 0;
     while (!FindCommon::enoughForFirstBatch(query.getParsed(), results->size(), bytesBuffered)) {
+        // Past the first batch deadline, return what we have rather than wait on a slow shard.
+        if (firstBatchDeadline && !results->empty() && Date_t::now() >= *firstBatchDeadline &&
+            !pinnedCursor.ready()) {
+            break;
+        }
+
         auto next = pinnedCursor.next();
         if (!next.isOK()) {
             return next.getStatus();
@@ -346,12 +397,33 @@ StatusWith<CursorId> ClusterFind::runQuery(OperationContext* txn,
     std::shared_ptr<Shard> primary;
     dbConfig.getValue()->getChunkManagerOrPrimary(txn, query.nss().ns(), chunkManager, primary);
 
+    // Answer the query from the results cached on this mongos, if they are still current.
+    auto queryCache = ClusterQueryCache::get();
+    std::string cacheKey;
+    unsigned long long writeGeneration = 0;
+    if (ClusterQueryCache::isEnabled()) {
+        cacheKey = ClusterQueryCache::makeKey(query, readPref);
+    }
+    if (!cacheKey.empty()) {
+        if (queryCache->lookup(cacheKey, query.nss(), getRoutingVersion(chunkManager), results)) {
+            return CursorId(0);
+        }
+        writeGeneration = queryCache->getWriteGeneration(query.nss());
+    }
+
     // Re-target and re-send the initial find command to the shards until we have established the
     // shard version.
     for (size_t retries = 1; retries <= kMaxStaleConfigRetries; ++retries) {
         auto cursorId = runQueryWithoutRetrying(
             txn, query, readPref, chunkManager.get(), std::move(primary), results);
         if (cursorId.isOK()) {
+            if (!cacheKey.empty() && cursorId.getValue() == 0) {
+                queryCache->insert(cacheKey,
+                                   query.nss(),
+                                   getRoutingVersion(chunkManager),
+                                   writeGeneration,
+                                   *results);
+            }
             return cursorId;
         }
         auto status = std::move(cursorId.getStatus());
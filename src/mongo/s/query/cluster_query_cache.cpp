@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_cache.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+
+#include "mongo/base/counter.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/client/read_preference.h"
+#include "mongo/db/commands/server_status_metric.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/db/server_parameters.h"
+
+namespace mongo {
+
+MONGO_EXPORT_SERVER_PARAMETER(clusterQueryCacheMaxSizeBytes, int, 0);
+MONGO_EXPORT_SERVER_PARAMETER(clusterQueryCacheMaxAgeMS, int, 1000);
+
+namespace {
+
+Counter64 queryCacheHits;
+Counter64 queryCacheMisses;
+
+ServerStatusMetricField<Counter64> displayQueryCacheHits("query.clusterQueryCache.hits",
+                                                         &queryCacheHits);
+ServerStatusMetricField<Counter64> displayQueryCacheMisses("query.clusterQueryCache.misses",
+                                                           &queryCacheMisses);
+
+ClusterQueryCache globalQueryCache;
+
+/**
+ * The bytes charged for results cached under 'key'. The key is held twice by the LRU store, once
+ * in its list and once in its map.
+ */
+size_t estimateEntrySizeBytes(const std::string& key, const std::vector<BSONObj>& results) {
+    size_t size = 2 * (sizeof(std::string) + key.capacity()) + results.capacity() * sizeof(BSONObj);
+    for (const auto& result : results) {
+        size += result.objsize();
+    }
+    return size;
+}
+
+}  // namespace
+
+ClusterQueryCache::ClusterQueryCache() : _entries(std::numeric_limits<size_t>::max()) {}
+
+ClusterQueryCache::~ClusterQueryCache() = default;
+
+ClusterQueryCache* ClusterQueryCache::get() {
+    return &globalQueryCache;
+}
+
+bool ClusterQueryCache::isEnabled() {
+    return clusterQueryCacheMaxSizeBytes > 0;
+}
+
+std::string ClusterQueryCache::makeKey(const CanonicalQuery& query,
+                                       const ReadPreferenceSetting& readPref) {
+    const auto& lpq = query.getParsed();
+
+    // Tailable cursors never finish in their first batch, and partial results may be missing the
+    // documents of an unreachable shard.
+    if (lpq.isExplain() || lpq.isTailable() || lpq.isAllowPartialResults()) {
+        return std::string();
+    }
+
+    BSONObjBuilder keyBuilder;
+    keyBuilder.append("$db", query.nss().db());
+    lpq.asFindCommand(&keyBuilder);
+    keyBuilder.append("$readPreference", readPref.toBSON());
+    BSONObj key = keyBuilder.obj();
+    return std::string(key.objdata(), key.objsize());
+}
+
+unsigned long long ClusterQueryCache::getWriteGeneration(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _generations[nss.ns()];
+}
+
+bool ClusterQueryCache::lookup(const std::string& key,
+                               const NamespaceString& nss,
+                               const ChunkVersion& version,
+                               std::vector<BSONObj>* results) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    Entry* entry;
+    if (!_entries.get(key, &entry).isOK()) {
+        queryCacheMisses.increment();
+        return false;
+    }
+
+    if (!entry->version.equals(version) || entry->generation != _generations[nss.ns()] ||
+        entry->cachedAt + Milliseconds(clusterQueryCacheMaxAgeMS) <= Date_t::now()) {
+        _remove_inlock(key, *entry);
+        queryCacheMisses.increment();
+        return false;
+    }
+
+    results->insert(results->end(), entry->results.begin(), entry->results.end());
+    queryCacheHits.increment();
+    return true;
+}
+
+void ClusterQueryCache::insert(const std::string& key,
+                               const NamespaceString& nss,
+                               const ChunkVersion& version,
+                               unsigned long long generation,
+                               const std::vector<BSONObj>& results) {
+    const size_t sizeBytes = estimateEntrySizeBytes(key, results);
+    const size_t maxSizeBytes = std::max(clusterQueryCacheMaxSizeBytes, 0);
+    if (sizeBytes > maxSizeBytes) {
+        return;
+    }
+
+    std::unique_ptr<Entry> entry(new Entry());
+    entry->version = version;
+    entry->generation = generation;
+    entry->cachedAt = Date_t::now();
+    entry->results.reserve(results.size());
+    for (const auto& result : results) {
+        entry->results.push_back(result.getOwned());
+    }
+    entry->sizeBytes = sizeBytes;
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    // A write which raced with the query may not be reflected in its results.
+    if (generation != _generations[nss.ns()]) {
+        return;
+    }
+
+    Entry* existing;
+    if (_entries.get(key, &existing).isOK()) {
+        _remove_inlock(key, *existing);
+    }
+
+    _sizeBytes += sizeBytes;
+    _entries.add(key, entry.release());
+
+    while (_sizeBytes > maxSizeBytes) {
+        std::unique_ptr<Entry> evicted = _entries.removeLeastRecentlyUsed();
+        invariant(evicted);
+        _sizeBytes -= evicted->sizeBytes;
+    }
+}
+
+void ClusterQueryCache::invalidate(const NamespaceString& nss) {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    ++_generations[nss.ns()];
+}
+
+size_t ClusterQueryCache::getSizeBytes() const {
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+    return _sizeBytes;
+}
+
+void ClusterQueryCache::_remove_inlock(const std::string& key, const Entry& entry) {
+    _sizeBytes -= entry.sizeBytes;
+    invariant(_entries.remove(key).isOK());
+}
+
+}  // namespace mongo
@@ -0,0 +1,149 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/bson/bsonobj.h"
+#include "mongo/db/query/lru_key_value.h"
+#include "mongo/s/chunk_version.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/string_map.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class CanonicalQuery;
+class NamespaceString;
+struct ReadPreferenceSetting;
+
+// The bytes of query results mongos may hold in its query cache. Zero disables the cache.
+extern int clusterQueryCacheMaxSizeBytes;
+
+// How long a cached result may be served. Bounds staleness against writes which do not go through
+// this mongos.
+extern int clusterQueryCacheMaxAgeMS;
+
+/**
+ * An opt-in cache of the results of queries run through mongos, for collections which are read
+ * far more often than they are written.
+ *
+ * Only queries which are answered entirely in their first batch are cached. An entry is served
+ * only while the routing version of its collection is the one the results were read under, its
+ * collection has not been written through this mongos since, and it is younger than
+ * clusterQueryCacheMaxAgeMS. Entries are evicted least recently used first once the cached
+ * results exceed clusterQueryCacheMaxSizeBytes.
+ *
+ * This class is thread-safe.
+ */
+class ClusterQueryCache {
+    MONGO_DISALLOW_COPYING(ClusterQueryCache);
+
+public:
+    ClusterQueryCache();
+    ~ClusterQueryCache();
+
+    /**
+     * The cache shared by all operations on this mongos.
+     */
+    static ClusterQueryCache* get();
+
+    /**
+     * Returns true if the cache is turned on.
+     */
+    static bool isEnabled();
+
+    /**
+     * Returns the key the results of 'query', targeted according to 'readPref', are cached
+     * under, or an empty string if the results of 'query' may not be cached.
+     */
+    static std::string makeKey(const CanonicalQuery& query, const ReadPreferenceSetting& readPref);
+
+    /**
+     * Returns the write generation of 'nss'. Results read after this call may be inserted under
+     * it, and are dropped if 'nss' is written before they are inserted.
+     */
+    unsigned long long getWriteGeneration(const NamespaceString& nss);
+
+    /**
+     * If results for 'key' read under routing version 'version' are cached, appends them to
+     * 'results' and returns true.
+     */
+    bool lookup(const std::string& key,
+                const NamespaceString& nss,
+                const ChunkVersion& version,
+                std::vector<BSONObj>* results);
+
+    /**
+     * Caches the complete 'results' of the query with 'key', read under routing version
+     * 'version' after 'nss' was at write generation 'generation'.
+     */
+    void insert(const std::string& key,
+                const NamespaceString& nss,
+                const ChunkVersion& version,
+                unsigned long long generation,
+                const std::vector<BSONObj>& results);
+
+    /**
+     * Makes every cached result of 'nss' stale. Called after each write to 'nss'.
+     */
+    void invalidate(const NamespaceString& nss);
+
+    /**
+     * Returns the number of bytes charged for the cached results.
+     */
+    size_t getSizeBytes() const;
+
+private:
+    struct Entry {
+        ChunkVersion version;
+        unsigned long long generation;
+        Date_t cachedAt;
+        std::vector<BSONObj> results;
+        size_t sizeBytes;
+    };
+
+    /**
+     * Removes 'key' and releases the bytes charged for it. Requires '_mutex'.
+     */
+    void _remove_inlock(const std::string& key, const Entry& entry);
+
+    mutable stdx::mutex _mutex;
+
+    LRUKeyValue<std::string, Entry> _entries;
+
+    // The write generation of each namespace which has been written since startup.
+    StringMap<unsigned long long> _generations;
+
+    size_t _sizeBytes = 0;
+};
+
+}  // namespace mongo
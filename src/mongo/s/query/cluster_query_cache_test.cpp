@@ -0,0 +1,174 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/query/cluster_query_cache.h"
+
+#include "mongo/client/read_preference.h"
+#include "mongo/db/json.h"
+#include "mongo/db/namespace_string.h"
+#include "mongo/db/query/canonical_query.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+const NamespaceString nss("testdb.testcoll");
+const ReadPreferenceSetting primaryOnly(ReadPreference::PrimaryOnly, TagSet());
+
+std::unique_ptr<CanonicalQuery> canonicalize(const NamespaceString& ns, const char* cmdStr) {
+    auto lpq =
+        unittest::assertGet(LiteParsedQuery::makeFromFindCommand(ns, fromjson(cmdStr), false));
+    return unittest::assertGet(CanonicalQuery::canonicalize(lpq.release()));
+}
+
+class ClusterQueryCacheTest : public unittest::Test {
+protected:
+    void setUp() final {
+        _savedMaxSizeBytes = clusterQueryCacheMaxSizeBytes;
+        _savedMaxAgeMS = clusterQueryCacheMaxAgeMS;
+        clusterQueryCacheMaxSizeBytes = 1024 * 1024;
+        clusterQueryCacheMaxAgeMS = 60 * 1000;
+    }
+
+    void tearDown() final {
+        clusterQueryCacheMaxSizeBytes = _savedMaxSizeBytes;
+        clusterQueryCacheMaxAgeMS = _savedMaxAgeMS;
+    }
+
+    ClusterQueryCache _cache;
+    const ChunkVersion _version{1, 0, OID::gen()};
+    const std::vector<BSONObj> _results{BSON("_id" << 1), BSON("_id" << 2)};
+
+private:
+    int _savedMaxSizeBytes;
+    int _savedMaxAgeMS;
+};
+
+TEST_F(ClusterQueryCacheTest, KeysDistinguishQueries) {
+    auto key = ClusterQueryCache::makeKey(*canonicalize(nss, "{find: 'testcoll', filter: {a: 1}}"),
+                                          primaryOnly);
+    ASSERT(!key.empty());
+    ASSERT_EQUALS(key,
+                  ClusterQueryCache::makeKey(
+                      *canonicalize(nss, "{find: 'testcoll', filter: {a: 1}}"), primaryOnly));
+
+    ASSERT_NOT_EQUALS(key,
+                      ClusterQueryCache::makeKey(
+                          *canonicalize(nss, "{find: 'testcoll', filter: {a: 2}}"), primaryOnly));
+    ASSERT_NOT_EQUALS(
+        key,
+        ClusterQueryCache::makeKey(
+            *canonicalize(nss, "{find: 'testcoll', filter: {a: 1}, limit: 1}"), primaryOnly));
+    ASSERT_NOT_EQUALS(key,
+                      ClusterQueryCache::makeKey(
+                          *canonicalize(NamespaceString("otherdb.testcoll"),
+                                        "{find: 'testcoll', filter: {a: 1}}"),
+                          primaryOnly));
+    ASSERT_NOT_EQUALS(key,
+                      ClusterQueryCache::makeKey(
+                          *canonicalize(nss, "{find: 'testcoll', filter: {a: 1}}"),
+                          ReadPreferenceSetting(ReadPreference::Nearest, TagSet())));
+
+    // Tailable cursors are never cached.
+    ASSERT(ClusterQueryCache::makeKey(
+               *canonicalize(nss, "{find: 'testcoll', filter: {a: 1}, tailable: true}"),
+               primaryOnly).empty());
+}
+
+TEST_F(ClusterQueryCacheTest, HitUntilWritten) {
+    _cache.insert("key", nss, _version, _cache.getWriteGeneration(nss), _results);
+
+    std::vector<BSONObj> results;
+    ASSERT(_cache.lookup("key", nss, _version, &results));
+    ASSERT_EQUALS(2U, results.size());
+    ASSERT_EQUALS(BSON("_id" << 2), results[1]);
+
+    // Writes to other collections leave the entry alone.
+    _cache.invalidate(NamespaceString("testdb.other"));
+    results.clear();
+    ASSERT(_cache.lookup("key", nss, _version, &results));
+
+    _cache.invalidate(nss);
+    results.clear();
+    ASSERT(!_cache.lookup("key", nss, _version, &results));
+    ASSERT(results.empty());
+    ASSERT_EQUALS(0U, _cache.getSizeBytes());
+}
+
+TEST_F(ClusterQueryCacheTest, ResultsReadBeforeAWriteAreNotCached) {
+    const auto generation = _cache.getWriteGeneration(nss);
+    _cache.invalidate(nss);
+    _cache.insert("key", nss, _version, generation, _results);
+
+    std::vector<BSONObj> results;
+    ASSERT(!_cache.lookup("key", nss, _version, &results));
+}
+
+TEST_F(ClusterQueryCacheTest, MissOnRoutingVersionChange) {
+    _cache.insert("key", nss, _version, _cache.getWriteGeneration(nss), _results);
+
+    std::vector<BSONObj> results;
+    ASSERT(!_cache.lookup("key", nss, ChunkVersion(2, 0, _version.epoch()), &results));
+    ASSERT(!_cache.lookup("key", nss, _version, &results));
+}
+
+TEST_F(ClusterQueryCacheTest, MissOnceExpired) {
+    clusterQueryCacheMaxAgeMS = 0;
+    _cache.insert("key", nss, _version, _cache.getWriteGeneration(nss), _results);
+
+    std::vector<BSONObj> results;
+    ASSERT(!_cache.lookup("key", nss, _version, &results));
+}
+
+TEST_F(ClusterQueryCacheTest, EvictsLeastRecentlyUsedOverBudget) {
+    const auto generation = _cache.getWriteGeneration(nss);
+    _cache.insert("key0", nss, _version, generation, _results);
+    const size_t entrySizeBytes = _cache.getSizeBytes();
+    clusterQueryCacheMaxSizeBytes = 2 * entrySizeBytes;
+
+    _cache.insert("key1", nss, _version, generation, _results);
+    std::vector<BSONObj> results;
+    ASSERT(_cache.lookup("key0", nss, _version, &results));
+
+    // key1 is now the least recently used.
+    _cache.insert("key2", nss, _version, generation, _results);
+    ASSERT_EQUALS(2 * entrySizeBytes, _cache.getSizeBytes());
+    ASSERT(_cache.lookup("key0", nss, _version, &results));
+    ASSERT(_cache.lookup("key2", nss, _version, &results));
+    ASSERT(!_cache.lookup("key1", nss, _version, &results));
+
+    // Results larger than the whole budget are not cached.
+    clusterQueryCacheMaxSizeBytes = entrySizeBytes - 1;
+    _cache.insert("key3", nss, _version, generation, _results);
+    ASSERT(!_cache.lookup("key3", nss, _version, &results));
+}
+
+}  // namespace
+}  // namespace mongo
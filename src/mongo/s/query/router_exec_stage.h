@@ -66,6 +66,15 @@ public:
      */
     virtual void kill() = 0;
 
+    /**
+     * Returns whether next() can return without waiting on a remote host. Stages which don't talk
+     * to remote hosts themselves defer to their child, so a stage which has to discard results may
+     * still wait even though this returned true.
+     */
+    virtual bool ready() {
+        return !_child || _child->ready();
+    }
+
 protected:
     /**
      * Returns an unowned pointer to the child stage, or nullptr if there is no child.
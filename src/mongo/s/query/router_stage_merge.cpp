@@ -62,6 +62,10 @@ StatusWith<boost::optional<BSONObj>> RouterStageMerge::next() {
     return statusWithNext;
 }
 
+bool RouterStageMerge::ready() {
+    return _arm.ready();
+}
+
 void RouterStageMerge::kill() {
     auto killEvent = _arm.kill();
     _executor->waitForEvent(killEvent);
@@ -49,6 +49,8 @@ public:
 
     void kill() final;
 
+    bool ready() final;
+
 private:
     // Not owned here.
     executor::TaskExecutor* _executor;
@@ -0,0 +1,338 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/write_ops/coalescing_write_dispatch.h"
+
+#include "mongo/bson/util/builder.h"
+#include "mongo/s/write_ops/batched_command_request.h"
+#include "mongo/s/write_ops/batched_command_response.h"
+
+namespace mongo {
+
+namespace {
+
+const char kDocumentsField[] = "documents";
+
+using Clock = stdx::chrono::steady_clock;
+
+/**
+ * Returns whether 'writeConcern' asks for no more than the shard's default acknowledgement.
+ */
+bool isDefaultWriteConcern(const BSONObj& writeConcern) {
+    for (const auto& elem : writeConcern) {
+        const StringData fieldName = elem.fieldNameStringData();
+        if (fieldName == "w") {
+            if (!elem.isNumber() || elem.numberInt() != 1) {
+                return false;
+            }
+        } else if (fieldName != "wtimeout") {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+}  // namespace
+
+struct WriteCoalescer::Group {
+    Group(std::string key,
+          const ConnectionString& endpoint,
+          StringData dbName,
+          Clock::time_point sendAt)
+        : key(std::move(key)), endpoint(endpoint), dbName(dbName.toString()), sendAt(sendAt) {}
+
+    // The endpoint, database and the fields the members' commands share, which is all but their
+    // documents
+    const std::string key;
+    const ConnectionString endpoint;
+    const std::string dbName;
+
+    // When the group is sent if it hasn't filled up before
+    const Clock::time_point sendAt;
+
+    // The members' commands, which own the documents
+    std::vector<BSONObj> requests;
+    std::vector<BSONObj> documents;
+    int documentBytes = 0;
+
+    // Whether the group no longer accepts members, is being sent or has been answered
+    bool closed = false;
+    bool sending = false;
+    bool done = false;
+
+    // The outcome of the merged command, only valid once 'done' is set
+    Status status = Status::OK();
+    BatchedCommandResponse response;
+};
+
+WriteCoalescer::WriteCoalescer(DispatchFactory makeDispatch)
+    : _makeDispatch(std::move(makeDispatch)) {}
+
+bool WriteCoalescer::canCoalesce(const BSONObj& request) {
+    const BSONElement insertElem = request.firstElement();
+    if (insertElem.fieldNameStringData() != "insert" || insertElem.type() != String) {
+        return false;
+    }
+
+    // Index builds go through inserts into system.indexes, one index spec at a time
+    if (insertElem.valueStringData() == "system.indexes") {
+        return false;
+    }
+
+    if (request[kDocumentsField].type() != Array) {
+        return false;
+    }
+
+    // Write commands are ordered unless they say otherwise
+    const BSONElement orderedElem = request["ordered"];
+    if (orderedElem.type() != Bool || orderedElem.boolean()) {
+        return false;
+    }
+
+    const BSONElement writeConcernElem = request["writeConcern"];
+    return writeConcernElem.eoo() ||
+        (writeConcernElem.type() == Object && isDefaultWriteConcern(writeConcernElem.Obj()));
+}
+
+WriteCoalescer::Ticket WriteCoalescer::join(const ConnectionString& endpoint,
+                                            StringData dbName,
+                                            const BSONObj& request,
+                                            Microseconds window) {
+    dassert(canCoalesce(request));
+
+    const BSONObj ownedRequest = request.getOwned();
+
+    BSONObjBuilder headerBob;
+    std::vector<BSONObj> documents;
+    int documentBytes = 0;
+    for (const auto& elem : ownedRequest) {
+        if (elem.fieldNameStringData() != kDocumentsField) {
+            headerBob.append(elem);
+            continue;
+        }
+
+        for (const auto& docElem : elem.Obj()) {
+            documents.push_back(docElem.Obj());
+            documentBytes += docElem.size();
+        }
+    }
+    const BSONObj header = headerBob.obj();
+
+    std::string key = endpoint.toString();
+    key.push_back('\0');
+    key.append(dbName.rawData(), dbName.size());
+    key.push_back('\0');
+    key.append(header.objdata(), header.objsize());
+
+    stdx::lock_guard<stdx::mutex> lk(_mutex);
+
+    auto it = _openGroups.find(key);
+    if (it != _openGroups.end()) {
+        Group* const group = it->second.get();
+        const size_t numDocuments = group->documents.size() + documents.size();
+        if (numDocuments > BatchedCommandRequest::kMaxWriteBatchSize ||
+            group->documentBytes + documentBytes > BSONObjMaxUserSize) {
+            // No room for this batch, so let the group go out now and start a new one
+            group->closed = true;
+            _openGroups.erase(it);
+            _groupCV.notify_all();
+            it = _openGroups.end();
+        }
+    }
+
+    if (it == _openGroups.end()) {
+        auto group = std::make_shared<Group>(key, endpoint, dbName, Clock::now() + window);
+        it = _openGroups.emplace(std::move(key), std::move(group)).first;
+    }
+
+    const std::shared_ptr<Group> group = it->second;
+
+    Ticket ticket;
+    ticket.endpoint = endpoint;
+    ticket.group = group;
+    ticket.first = group->documents.size();
+    ticket.count = documents.size();
+
+    group->requests.push_back(ownedRequest);
+    group->documents.insert(group->documents.end(), documents.begin(), documents.end());
+    group->documentBytes += documentBytes;
+
+    if (group->documents.size() == BatchedCommandRequest::kMaxWriteBatchSize) {
+        group->closed = true;
+        _openGroups.erase(it);
+        _groupCV.notify_all();
+    }
+
+    return ticket;
+}
+
+Status WriteCoalescer::wait(const Ticket& ticket, BatchedCommandResponse* response) {
+    Group* const group = ticket.group.get();
+
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    while (!group->done) {
+        if (group->sending) {
+            _groupCV.wait(lk);
+            continue;
+        }
+
+        if (!group->closed && Clock::now() < group->sendAt) {
+            _groupCV.wait_until(lk, group->sendAt);
+            continue;
+        }
+
+        // Nobody has sent the group yet, so this member does it for all of them
+        group->sending = true;
+        if (!group->closed) {
+            group->closed = true;
+            _openGroups.erase(group->key);
+        }
+
+        lk.unlock();
+        _send(group);
+        lk.lock();
+
+        group->done = true;
+        _groupCV.notify_all();
+    }
+
+    if (!group->status.isOK()) {
+        return group->status;
+    }
+
+    group->response.cloneTo(response);
+    if (!response->getOk()) {
+        // The whole command failed, which applies to every member alike
+        return Status::OK();
+    }
+
+    // Each document was either inserted or has a write error, so the member's count of inserted
+    // documents follows from its share of the errors.
+    response->unsetErrDetails();
+    long long numErrors = 0;
+    if (group->response.isErrDetailsSet()) {
+        for (const WriteErrorDetail* error : group->response.getErrDetails()) {
+            const size_t index = static_cast<size_t>(error->getIndex());
+            if (index < ticket.first || index >= ticket.first + ticket.count) {
+                continue;
+            }
+
+            WriteErrorDetail* errorCopy = new WriteErrorDetail;
+            error->cloneTo(errorCopy);
+            errorCopy->setIndex(static_cast<int>(index - ticket.first));
+            response->addToErrDetails(errorCopy);
+            ++numErrors;
+        }
+    }
+    response->setN(static_cast<long long>(ticket.count) - numErrors);
+
+    return Status::OK();
+}
+
+void WriteCoalescer::_send(Group* group) {
+    // The merged command is the first member's, with everyone's documents
+    BSONObjBuilder cmdBob;
+    for (const auto& elem : group->requests.front()) {
+        if (elem.fieldNameStringData() != kDocumentsField) {
+            cmdBob.append(elem);
+            continue;
+        }
+
+        BSONArrayBuilder documentsBob(cmdBob.subarrayStart(kDocumentsField));
+        for (const auto& doc : group->documents) {
+            documentsBob.append(doc);
+        }
+        documentsBob.done();
+    }
+
+    std::unique_ptr<MultiCommandDispatch> dispatcher = _makeDispatch();
+    dispatcher->addCommand(group->endpoint, group->dbName, cmdBob.obj());
+    dispatcher->sendAll();
+
+    ConnectionString endpoint;
+    group->status = dispatcher->recvAny(&endpoint, &group->response);
+}
+
+CoalescingWriteDispatch::CoalescingWriteDispatch(WriteCoalescer* coalescer,
+                                                 MultiCommandDispatch* dispatcher,
+                                                 Microseconds window)
+    : _coalescer(coalescer), _dispatcher(dispatcher), _window(window) {}
+
+void CoalescingWriteDispatch::addCommand(const ConnectionString& endpoint,
+                                         StringData dbName,
+                                         const BSONObj& request) {
+    if (!WriteCoalescer::canCoalesce(request)) {
+        _dispatcher->addCommand(endpoint, dbName, request);
+        return;
+    }
+
+    _toJoin.push_back(PendingWrite{endpoint, dbName.toString(), request});
+}
+
+void CoalescingWriteDispatch::sendAll() {
+    for (const auto& write : _toJoin) {
+        _tickets.push_back(
+            _coalescer->join(write.endpoint, write.dbName, write.request, _window));
+    }
+    _toJoin.clear();
+
+    _dispatcher->sendAll();
+}
+
+int CoalescingWriteDispatch::numPending() const {
+    return static_cast<int>(_toJoin.size() + _tickets.size()) + _dispatcher->numPending();
+}
+
+Status CoalescingWriteDispatch::recvAny(ConnectionString* endpoint, BSONSerializable* response) {
+    if (_tickets.empty()) {
+        return _dispatcher->recvAny(endpoint, response);
+    }
+
+    const WriteCoalescer::Ticket ticket = std::move(_tickets.back());
+    _tickets.pop_back();
+
+    *endpoint = ticket.endpoint;
+
+    BatchedCommandResponse batchResponse;
+    Status status = _coalescer->wait(ticket, &batchResponse);
+    if (!status.isOK()) {
+        return status;
+    }
+
+    std::string errMsg;
+    if (!response->parseBSON(batchResponse.toBSON(), &errMsg) || !response->isValid(&errMsg)) {
+        return Status(ErrorCodes::FailedToParse, errMsg);
+    }
+
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,173 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/s/client/multi_command_dispatch.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+class BatchedCommandResponse;
+
+/**
+ * A WriteCoalescer merges the insert batches that concurrent operations send to the same shard
+ * and collection within a short window into a single insert command, and splits its response
+ * back into one response per batch.
+ *
+ * Only unordered inserts with the default (w:1) write concern are merged. Their response can be
+ * split exactly: each document was either inserted or has its own write error, and a write
+ * concern error, if any, applies to all of them. Batches are only merged when every other field
+ * of their commands, including the shard version, is identical.
+ *
+ * There is no background thread. Whichever waiter finds its group's window over, or the group
+ * full, sends the merged command and hands the results to the other members.
+ *
+ * This class is thread-safe.
+ */
+class WriteCoalescer {
+    MONGO_DISALLOW_COPYING(WriteCoalescer);
+
+public:
+    using DispatchFactory = stdx::function<std::unique_ptr<MultiCommandDispatch>()>;
+
+    struct Group;
+
+    /**
+     * One batch's place in a group: a ticket for the response to the documents
+     * [first, first + count) of the merged command.
+     */
+    struct Ticket {
+        ConnectionString endpoint;
+        std::shared_ptr<Group> group;
+        size_t first = 0;
+        size_t count = 0;
+    };
+
+    /**
+     * 'makeDispatch' creates the dispatchers through which merged commands are sent.
+     */
+    explicit WriteCoalescer(DispatchFactory makeDispatch);
+
+    /**
+     * Returns whether the write command 'request' may be merged with others.
+     */
+    static bool canCoalesce(const BSONObj& request);
+
+    /**
+     * Adds the documents of 'request', for which canCoalesce() must be true, to the open group
+     * for its endpoint and command, or to a new group which will be sent after 'window'.
+     */
+    Ticket join(const ConnectionString& endpoint,
+                StringData dbName,
+                const BSONObj& request,
+                Microseconds window);
+
+    /**
+     * Blocks until the group of 'ticket' has been sent and answered, sending it if no other
+     * member already is, and fills 'response' with the results for the ticket's documents.
+     *
+     * Returns !OK if the merged command could not be sent or its response could not be read.
+     */
+    Status wait(const Ticket& ticket, BatchedCommandResponse* response);
+
+private:
+    /**
+     * Sends the merged command of 'group' and stores its response in it. Must be called without
+     * holding '_mutex'.
+     */
+    void _send(Group* group);
+
+    const DispatchFactory _makeDispatch;
+
+    // Protects '_openGroups' and the state of every group
+    stdx::mutex _mutex;
+
+    // Signalled when a group is closed to new members or has been answered
+    stdx::condition_variable _groupCV;
+
+    // Groups still accepting members, keyed by endpoint, database and command without documents
+    std::map<std::string, std::shared_ptr<Group>> _openGroups;
+};
+
+/**
+ * A CoalescingWriteDispatch is a MultiCommandDispatch which passes the write batches that can be
+ * merged with other operations' batches to a WriteCoalescer, and all other commands to a regular
+ * dispatcher.
+ *
+ * See MultiCommandDispatch for more details.
+ */
+class CoalescingWriteDispatch : public MultiCommandDispatch {
+    MONGO_DISALLOW_COPYING(CoalescingWriteDispatch);
+
+public:
+    /**
+     * Neither 'coalescer' nor 'dispatcher' are owned and both must outlive this object.
+     */
+    CoalescingWriteDispatch(WriteCoalescer* coalescer,
+                            MultiCommandDispatch* dispatcher,
+                            Microseconds window);
+
+    void addCommand(const ConnectionString& endpoint,
+                    StringData dbName,
+                    const BSONObj& request) override;
+
+    void sendAll() override;
+
+    int numPending() const override;
+
+    Status recvAny(ConnectionString* endpoint, BSONSerializable* response) override;
+
+private:
+    struct PendingWrite {
+        ConnectionString endpoint;
+        std::string dbName;
+        BSONObj request;
+    };
+
+    WriteCoalescer* const _coalescer;
+    MultiCommandDispatch* const _dispatcher;
+    const Microseconds _window;
+
+    // Batches added since the last sendAll, which will join a group when it is called
+    std::vector<PendingWrite> _toJoin;
+
+    // Batches whose group has been joined, but whose response hasn't been received
+    std::vector<WriteCoalescer::Ticket> _tickets;
+};
+
+}  // namespace mongo
@@ -0,0 +1,211 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/s/write_ops/coalescing_write_dispatch.h"
+
+#include <vector>
+
+#include "mongo/db/jsobj.h"
+#include "mongo/s/write_ops/batched_command_response.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+/**
+ * Records the commands sent through it and answers each of them with the same response.
+ */
+class RecordingDispatch : public MultiCommandDispatch {
+public:
+    RecordingDispatch(std::vector<BSONObj>* sent, const BatchedCommandResponse& response)
+        : _sent(sent), _response(response.toBSON()) {}
+
+    void addCommand(const ConnectionString& endpoint,
+                    StringData dbName,
+                    const BSONObj& request) override {
+        _sent->push_back(request.getOwned());
+        _pending.push_back(endpoint);
+    }
+
+    void sendAll() override {}
+
+    int numPending() const override {
+        return static_cast<int>(_pending.size());
+    }
+
+    Status recvAny(ConnectionString* endpoint, BSONSerializable* response) override {
+        *endpoint = _pending.back();
+        _pending.pop_back();
+
+        std::string errMsg;
+        ASSERT(response->parseBSON(_response, &errMsg));
+        return Status::OK();
+    }
+
+private:
+    std::vector<BSONObj>* const _sent;
+    const BSONObj _response;
+    std::vector<ConnectionString> _pending;
+};
+
+class WriteCoalescerTest : public mongo::unittest::Test {
+protected:
+    WriteCoalescerTest()
+        : shardHost(HostAndPort("shard:27017")),
+          coalescer([this] { return stdx::make_unique<RecordingDispatch>(&sent, response); }) {
+        response.setOk(true);
+        response.setN(0);
+    }
+
+    static BSONObj insert(const BSONArray& documents, int shardVersionMajor = 1) {
+        return BSON("insert"
+                    << "coll"
+                    << "documents" << documents << "ordered" << false << "metadata"
+                    << BSON("shardVersion" << BSON_ARRAY(Timestamp(shardVersionMajor, 0)
+                                                         << OID())));
+    }
+
+    const ConnectionString shardHost;
+    std::vector<BSONObj> sent;
+    BatchedCommandResponse response;
+    WriteCoalescer coalescer;
+};
+
+TEST(WriteCoalescerEligibilityTest, OnlyUnorderedInsertsWithDefaultWriteConcern) {
+    const BSONArray docs = BSON_ARRAY(BSON("_id" << 1));
+
+    ASSERT(WriteCoalescer::canCoalesce(BSON("insert"
+                                            << "coll"
+                                            << "documents" << docs << "ordered" << false)));
+    ASSERT(WriteCoalescer::canCoalesce(BSON("insert"
+                                            << "coll"
+                                            << "documents" << docs << "ordered" << false
+                                            << "writeConcern" << BSON("w" << 1))));
+
+    ASSERT_FALSE(WriteCoalescer::canCoalesce(BSON("insert"
+                                                  << "coll"
+                                                  << "documents" << docs)));
+    ASSERT_FALSE(WriteCoalescer::canCoalesce(BSON("insert"
+                                                  << "coll"
+                                                  << "documents" << docs << "ordered" << false
+                                                  << "writeConcern" << BSON("w"
+                                                                            << "majority"))));
+    ASSERT_FALSE(WriteCoalescer::canCoalesce(BSON("insert"
+                                                  << "system.indexes"
+                                                  << "documents" << docs << "ordered" << false)));
+    ASSERT_FALSE(WriteCoalescer::canCoalesce(
+        BSON("delete"
+             << "coll"
+             << "deletes" << BSON_ARRAY(BSON("q" << BSONObj() << "limit" << 0)) << "ordered"
+             << false)));
+}
+
+TEST_F(WriteCoalescerTest, MergedResponseIsSplitPerBatch) {
+    WriteErrorDetail* error = new WriteErrorDetail;
+    error->setIndex(2);
+    error->setErrCode(ErrorCodes::DuplicateKey);
+    error->setErrMessage("duplicate key");
+    response.addToErrDetails(error);
+    response.setN(2);
+
+    const auto first = coalescer.join(shardHost,
+                                      "db",
+                                      insert(BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2))),
+                                      Milliseconds(1));
+    const auto second =
+        coalescer.join(shardHost, "db", insert(BSON_ARRAY(BSON("_id" << 1))), Milliseconds(1));
+
+    BatchedCommandResponse firstResponse;
+    ASSERT_OK(coalescer.wait(first, &firstResponse));
+    BatchedCommandResponse secondResponse;
+    ASSERT_OK(coalescer.wait(second, &secondResponse));
+
+    ASSERT_EQUALS(1U, sent.size());
+    ASSERT_EQUALS(insert(BSON_ARRAY(BSON("_id" << 1) << BSON("_id" << 2) << BSON("_id" << 1))),
+                  sent.front());
+
+    ASSERT(firstResponse.getOk());
+    ASSERT_EQUALS(2, firstResponse.getN());
+    ASSERT_FALSE(firstResponse.isErrDetailsSet());
+
+    ASSERT(secondResponse.getOk());
+    ASSERT_EQUALS(0, secondResponse.getN());
+    ASSERT_EQUALS(1U, secondResponse.sizeErrDetails());
+    ASSERT_EQUALS(0, secondResponse.getErrDetailsAt(0)->getIndex());
+    ASSERT_EQUALS(ErrorCodes::DuplicateKey, secondResponse.getErrDetailsAt(0)->getErrCode());
+}
+
+TEST_F(WriteCoalescerTest, BatchesForDifferentShardVersionsAreNotMerged) {
+    const auto first =
+        coalescer.join(shardHost, "db", insert(BSON_ARRAY(BSON("_id" << 1)), 1), Milliseconds(1));
+    const auto second =
+        coalescer.join(shardHost, "db", insert(BSON_ARRAY(BSON("_id" << 2)), 2), Milliseconds(1));
+
+    BatchedCommandResponse firstResponse;
+    ASSERT_OK(coalescer.wait(first, &firstResponse));
+    BatchedCommandResponse secondResponse;
+    ASSERT_OK(coalescer.wait(second, &secondResponse));
+
+    ASSERT_EQUALS(2U, sent.size());
+    ASSERT_EQUALS(insert(BSON_ARRAY(BSON("_id" << 1)), 1), sent[0]);
+    ASSERT_EQUALS(insert(BSON_ARRAY(BSON("_id" << 2)), 2), sent[1]);
+    ASSERT_EQUALS(1, firstResponse.getN());
+    ASSERT_EQUALS(1, secondResponse.getN());
+}
+
+TEST_F(WriteCoalescerTest, DispatchPassesOtherCommandsThrough) {
+    std::vector<BSONObj> direct;
+    RecordingDispatch directDispatch(&direct, response);
+    CoalescingWriteDispatch dispatch(&coalescer, &directDispatch, Milliseconds(1));
+
+    const BSONObj ordered = BSON("insert"
+                                 << "coll"
+                                 << "documents" << BSON_ARRAY(BSON("_id" << 1)));
+    dispatch.addCommand(shardHost, "db", ordered);
+    dispatch.addCommand(shardHost, "db", insert(BSON_ARRAY(BSON("_id" << 2))));
+    dispatch.sendAll();
+    ASSERT_EQUALS(2, dispatch.numPending());
+
+    while (dispatch.numPending() > 0) {
+        ConnectionString endpoint;
+        BatchedCommandResponse batchResponse;
+        ASSERT_OK(dispatch.recvAny(&endpoint, &batchResponse));
+        ASSERT_EQUALS(shardHost.toString(), endpoint.toString());
+    }
+
+    ASSERT_EQUALS(1U, direct.size());
+    ASSERT_EQUALS(ordered, direct.front());
+    ASSERT_EQUALS(1U, sent.size());
+    ASSERT_EQUALS(insert(BSON_ARRAY(BSON("_id" << 2))), sent.front());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -40,7 +40,9 @@
 #include "mongo/client/dbclientinterface.h"
 #include "mongo/db/service_context.h"
 #include "mongo/db/operation_context.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/platform/unordered_set.h"
+#include "mongo/stdx/thread.h"
 #include "mongo/util/file.h"
 #include "mongo/util/log.h"
 #include "mongo/util/text.h"
@@ -307,6 +309,14 @@ void Scope::execCoreFiles() {
 }
 
 namespace {
+
+// The number of idle scopes kept for reuse. Zero keeps two per core, and at least ten.
+MONGO_EXPORT_SERVER_PARAMETER(internalJavaScriptMaxIdleScopes, int, 0);
+
+// A scope is reused by at most this many operations before it is discarded, so that state left in
+// its global object doesn't build up. Each reuse finds the functions compiled by earlier ones.
+MONGO_EXPORT_SERVER_PARAMETER(internalJavaScriptMaxScopeReuse, int, 100);
+
 class ScopeCache {
 public:
     void release(const string& poolName, const std::shared_ptr<Scope>& scope) {
@@ -319,13 +329,14 @@ public:
             return;
         }
 
-        if (scope->getTimesUsed() > kMaxScopeReuse)
+        if (scope->getTimesUsed() > internalJavaScriptMaxScopeReuse)
             return;  // used too many times to save
 
         if (!scope->getError().empty())
             return;  // not saving errored scopes
 
-        if (_pools.size() >= kMaxPoolSize) {
+        const size_t maxPoolSize = getMaxPoolSize();
+        while (_pools.size() >= maxPoolSize) {
             // prefer to keep recently-used scopes
             _pools.pop_back();
         }
@@ -364,10 +375,14 @@ private:
         string poolName;
     };
 
-    // Note: if these numbers change, reconsider choice of datastructure for _pools
-    static const unsigned kMaxPoolSize = 10;
-    static const int kMaxScopeReuse = 10;
+    static size_t getMaxPoolSize() {
+        if (internalJavaScriptMaxIdleScopes > 0)
+            return internalJavaScriptMaxIdleScopes;
+        return std::max(10u, 2 * stdx::thread::hardware_concurrency());
+    }
 
+    // Note: if the pool grows much beyond a few hundred scopes, reconsider choice of datastructure
+    // for _pools
     typedef std::deque<ScopeAndPool> Pools;  // More-recently used Scopes are kept at the front.
     Pools _pools;                            // protected by _mutex
     stdx::mutex _mutex;
@@ -34,11 +34,14 @@
 
 #include "mongo/shell/bench.h"
 
-#include <pcrecpp.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
+#include <pcrecpp.h>
 
 #include "mongo/client/dbclientcursor.h"
 #include "mongo/db/namespace_string.h"
+#include "mongo/platform/bits.h"
 #include "mongo/scripting/bson_template_evaluator.h"
 #include "mongo/scripting/engine.h"
 #include "mongo/stdx/thread.h"
@@ -86,11 +89,55 @@ BenchRunEventCounter::~BenchRunEventCounter() {}
 void BenchRunEventCounter::reset() {
     _numEvents = 0;
     _totalTimeMicros = 0;
+    _maxTimeMicros = 0;
+    std::fill(_buckets, _buckets + kNumBuckets, 0);
 }
 
 void BenchRunEventCounter::updateFrom(const BenchRunEventCounter& other) {
     _numEvents += other._numEvents;
     _totalTimeMicros += other._totalTimeMicros;
+    _maxTimeMicros = std::max(_maxTimeMicros, other._maxTimeMicros);
+    for (int i = 0; i < kNumBuckets; ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+}
+
+void BenchRunEventCounter::countOne(long long timeMicros) {
+    ++_numEvents;
+    _totalTimeMicros += timeMicros;
+    _maxTimeMicros = std::max(_maxTimeMicros, timeMicros);
+    ++_buckets[bucketFor(timeMicros)];
+}
+
+long long BenchRunEventCounter::getPercentileMicros(double percentile) const {
+    const unsigned long long rank = std::max(
+        1ULL, static_cast<unsigned long long>(std::ceil(percentile / 100 * _numEvents)));
+    unsigned long long seen = 0;
+    for (int i = 0; i < kNumBuckets; ++i) {
+        seen += _buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), _maxTimeMicros);
+        }
+    }
+    return _maxTimeMicros;
+}
+
+int BenchRunEventCounter::bucketFor(long long timeMicros) {
+    if (timeMicros < kSubBucketCount) {
+        return std::max(0LL, timeMicros);
+    }
+    const int log2 = 63 - countLeadingZeros64(timeMicros);
+    const int shift = log2 - kSubBucketBits;
+    return kSubBucketCount * (shift + 1) + static_cast<int>(timeMicros >> shift) - kSubBucketCount;
+}
+
+long long BenchRunEventCounter::bucketUpperBound(int bucket) {
+    if (bucket < kSubBucketCount) {
+        return bucket;
+    }
+    const int shift = bucket / kSubBucketCount - 1;
+    const long long subBucket = bucket % kSubBucketCount;
+    return ((kSubBucketCount + subBucket + 1) << shift) - 1;
 }
 
 BenchRunStats::BenchRunStats() {
@@ -110,6 +157,9 @@ void BenchRunStats::reset() {
     deleteCounter.reset();
     queryCounter.reset();
     commandCounter.reset();
+    aggregateCounter.reset();
+    findAndModifyCounter.reset();
+    getMoreCounter.reset();
     trappedErrors.clear();
 }
 
@@ -125,6 +175,9 @@ void BenchRunStats::updateFrom(const BenchRunStats& other) {
     deleteCounter.updateFrom(other.deleteCounter);
     queryCounter.updateFrom(other.queryCounter);
     commandCounter.updateFrom(other.commandCounter);
+    aggregateCounter.updateFrom(other.aggregateCounter);
+    findAndModifyCounter.updateFrom(other.findAndModifyCounter);
+    getMoreCounter.updateFrom(other.getMoreCounter);
 
     for (size_t i = 0; i < other.trappedErrors.size(); ++i)
         trappedErrors.push_back(other.trappedErrors[i]);
@@ -156,6 +209,7 @@ void BenchRunConfig::initializeToDefaults() {
     throwGLE = false;
     breakOnTrap = true;
     randomSeed = 1314159265358979323;
+    targetOpsPerSecond = 0;
 }
 
 BenchRunConfig* BenchRunConfig::createFromBson(const BSONObj& args) {
@@ -182,6 +236,9 @@ void BenchRunConfig::initializeFromBson(const BSONObj& args) {
         this->randomSeed = args["randomSeed"].numberInt();
     if (args["seconds"].isNumber())
         this->seconds = args["seconds"].number();
+    if (args["targetOpsPerSecond"].isNumber())
+        this->targetOpsPerSecond = args["targetOpsPerSecond"].number();
+    uassert(28820, "targetOpsPerSecond must not be negative", this->targetOpsPerSecond >= 0);
     if (!args["hideResults"].eoo())
         this->hideResults = args["hideResults"].trueValue();
     if (!args["handleErrors"].eoo())
@@ -358,6 +415,26 @@ bool BenchRunWorker::shouldCollectStats() const {
 
 void doNothing(const BSONObj&) {}
 
+/**
+ * Returns the number of documents left in "cursor", and counts each round trip it makes to fetch
+ * another batch in "getMoreCounter".
+ */
+int drainCursor(DBClientCursor* cursor, BenchRunEventCounter* getMoreCounter) {
+    int count = 0;
+    while (true) {
+        if (!cursor->moreInCurrentBatch()) {
+            if (cursor->getCursorId() == 0)
+                break;
+            BenchRunEventTrace _bret(getMoreCounter);
+            if (!cursor->more())
+                break;
+        }
+        cursor->nextSafe();
+        ++count;
+    }
+    return count;
+}
+
 void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
     verify(conn);
     long long count = 0;
@@ -373,6 +450,13 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
         }
     }
 
+    // In an open-loop run, operation N of this worker is intended to start N intervals after the
+    // worker started.
+    const double opIntervalMicros = _config->targetOpsPerSecond > 0
+        ? 1000000.0 * _config->parallel / _config->targetOpsPerSecond
+        : 0;
+    long long numScheduledOps = 0;
+
     while (!shouldStop()) {
         BSONObjIterator i(_config->ops);
         while (i.more()) {
@@ -381,6 +465,17 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
             auto& stats = shouldCollectStats() ? _stats : _statsBlackHole;
             BSONElement e = i.next();
 
+            long long scheduleLagMicros = 0;
+            if (opIntervalMicros > 0) {
+                const long long intendedStartMicros =
+                    static_cast<long long>(opIntervalMicros * numScheduledOps++);
+                const long long nowMicros = timer.micros();
+                if (nowMicros < intendedStartMicros)
+                    sleepmicros(intendedStartMicros - nowMicros);
+                else
+                    scheduleLagMicros = nowMicros - intendedStartMicros;
+            }
+
             string ns = e["ns"].String();
             string op = e["op"].String();
 
@@ -423,7 +518,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                 } else if (op == "findOne") {
                     BSONObj result;
                     {
-                        BenchRunEventTrace _bret(&stats.findOneCounter);
+                        BenchRunEventTrace _bret(&stats.findOneCounter, scheduleLagMicros);
                         result =
                             conn->findOne(ns, fixQuery(e["query"].Obj(), bsonTemplateEvaluator));
                     }
@@ -447,7 +542,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     bool ok;
                     BSONObj result;
                     {
-                        BenchRunEventTrace _bret(&stats.commandCounter);
+                        BenchRunEventTrace _bret(&stats.commandCounter, scheduleLagMicros);
                         ok = conn->runCommand(ns,
                                               fixQuery(e["command"].Obj(), bsonTemplateEvaluator),
                                               result,
@@ -485,14 +580,14 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
 
                     // use special query function for exhaust query option
                     if (options & QueryOption_Exhaust) {
-                        BenchRunEventTrace _bret(&stats.queryCounter);
+                        BenchRunEventTrace _bret(&stats.queryCounter, scheduleLagMicros);
                         stdx::function<void(const BSONObj&)> castedDoNothing(doNothing);
                         count = conn->query(castedDoNothing, ns, fixedQuery, &filter, options);
                     } else {
-                        BenchRunEventTrace _bret(&stats.queryCounter);
+                        BenchRunEventTrace _bret(&stats.queryCounter, scheduleLagMicros);
                         cursor =
                             conn->query(ns, fixedQuery, limit, skip, &filter, options, batchSize);
-                        count = cursor->itcount();
+                        count = drainCursor(cursor.get(), &stats.getMoreCounter);
                     }
 
                     if (expected >= 0 && count != expected) {
@@ -517,6 +612,106 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     if (!_config->hideResults || e["showResult"].trueValue())
                         log() << "Result from benchRun thread [query] : " << count << endl;
 
+                } else if (op == "aggregate") {
+                    int batchSize = e["batchSize"].eoo() ? -1 : e["batchSize"].numberInt();
+                    int expected = e["expected"].eoo() ? -1 : e["expected"].Int();
+
+                    BSONObjBuilder builder;
+                    builder.append("aggregate", nsToCollectionSubstring(ns));
+                    BSONArrayBuilder pipelineBuilder(builder.subarrayStart("pipeline"));
+                    for (auto& stage : e["pipeline"].Array()) {
+                        pipelineBuilder.append(fixQuery(stage.Obj(), bsonTemplateEvaluator));
+                    }
+                    pipelineBuilder.done();
+                    builder.append("cursor",
+                                   batchSize >= 0 ? BSON("batchSize" << batchSize) : BSONObj());
+                    BSONObj command = builder.obj();
+
+                    int count;
+                    {
+                        BenchRunEventTrace _bret(&stats.aggregateCounter, scheduleLagMicros);
+                        BSONObj result;
+                        if (!conn->runCommand(
+                                nsToDatabaseSubstring(ns).toString(), command, result)) {
+                            throw DBException((string) "From benchRun aggregate" +
+                                                  causedBy(result["errmsg"].str()),
+                                              result["code"].numberInt());
+                        }
+
+                        BSONObj cursorObj = result["cursor"].Obj();
+                        count = cursorObj["firstBatch"].Obj().nFields();
+                        long long cursorId = cursorObj["id"].numberLong();
+                        if (cursorId != 0) {
+                            DBClientCursor cursor(conn, cursorObj["ns"].String(), cursorId, 0, 0);
+                            count += drainCursor(&cursor, &stats.getMoreCounter);
+                        }
+                    }
+
+                    if (expected >= 0 && count != expected) {
+                        cout << "bench aggregate on: " << ns << " expected: " << expected
+                             << " got: " << count << endl;
+                        verify(false);
+                    }
+
+                    if (check) {
+                        BSONObj thisValue = BSON("count" << count << "context" << context);
+                        int err = scope->invoke(scopeFunc, 0, &thisValue, 1000 * 60, false);
+                        if (err) {
+                            log() << "Error checking in benchRun thread [aggregate]"
+                                  << causedBy(scope->getError()) << endl;
+
+                            stats.errCount++;
+
+                            return;
+                        }
+                    }
+
+                    if (!_config->hideResults || e["showResult"].trueValue())
+                        log() << "Result from benchRun thread [aggregate] : " << count << endl;
+
+                } else if (op == "findAndModify") {
+                    BSONObjBuilder builder;
+                    builder.append("findAndModify", nsToCollectionSubstring(ns));
+                    builder.append("query",
+                                   fixQuery(e["query"].eoo() ? BSONObj() : e["query"].Obj(),
+                                            bsonTemplateEvaluator));
+                    if (!e["update"].eoo())
+                        builder.append("update",
+                                       fixQuery(e["update"].Obj(), bsonTemplateEvaluator));
+                    if (!e["sort"].eoo())
+                        builder.append("sort", e["sort"].Obj());
+                    if (!e["fields"].eoo())
+                        builder.append("fields", e["fields"].Obj());
+                    builder.append("remove", e["remove"].trueValue());
+                    builder.append("upsert", e["upsert"].trueValue());
+                    builder.append("new", e["new"].trueValue());
+                    BSONObj command = builder.obj();
+
+                    bool ok;
+                    BSONObj result;
+                    {
+                        BenchRunEventTrace _bret(&stats.findAndModifyCounter, scheduleLagMicros);
+                        ok = conn->runCommand(
+                            nsToDatabaseSubstring(ns).toString(), command, result);
+                    }
+                    if (!ok) {
+                        stats.errCount++;
+                    } else if (check) {
+                        int err = scope->invoke(scopeFunc, 0, &result, 1000 * 60, false);
+                        if (err) {
+                            log() << "Error checking in benchRun thread [findAndModify]"
+                                  << causedBy(scope->getError()) << endl;
+
+                            stats.errCount++;
+
+                            return;
+                        }
+                    }
+
+                    if (!_config->hideResults || e["showResult"].trueValue())
+                        log() << "Result from benchRun thread [findAndModify] : " << result
+                              << endl;
+
                 } else if (op == "update") {
                     bool multi = e["multi"].trueValue();
                     bool upsert = e["upsert"].trueValue();
@@ -526,7 +721,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     bool safe = e["safe"].trueValue();
 
                     {
-                        BenchRunEventTrace _bret(&stats.updateCounter);
+                        BenchRunEventTrace _bret(&stats.updateCounter, scheduleLagMicros);
                         BSONObj query = fixQuery(queryOrginal, bsonTemplateEvaluator);
                         BSONObj update = fixQuery(updateOriginal, bsonTemplateEvaluator);
 
@@ -575,7 +770,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     BSONObj result;
 
                     {
-                        BenchRunEventTrace _bret(&stats.insertCounter);
+                        BenchRunEventTrace _bret(&stats.insertCounter, scheduleLagMicros);
 
                         BSONObj insertDoc;
                         if (useWriteCmd) {
@@ -641,7 +836,7 @@ void BenchRunWorker::generateLoadOnConnection(DBClientBase* conn) {
                     bool safe = e["safe"].trueValue();
                     BSONObj result;
                     {
-                        BenchRunEventTrace _bret(&stats.deleteCounter);
+                        BenchRunEventTrace _bret(&stats.deleteCounter, scheduleLagMicros);
                         BSONObj predicate = fixQuery(query, bsonTemplateEvaluator);
                         if (useWriteCmd) {
                             // TODO: Replace after SERVER-11774.
@@ -891,6 +1086,20 @@ static void appendAverageMicrosIfAvailable(BSONObjBuilder& buf,
                    static_cast<double>(counter.getTotalTimeMicros()) / counter.getNumEvents());
 }
 
+static void appendPercentilesMicrosIfAvailable(BSONObjBuilder& buf,
+                                               const std::string& name,
+                                               const BenchRunEventCounter& counter) {
+    if (counter.getNumEvents() == 0)
+        return;
+
+    BSONObjBuilder percentiles(buf.subobjStart(name));
+    percentiles.append("p50", counter.getPercentileMicros(50));
+    percentiles.append("p90", counter.getPercentileMicros(90));
+    percentiles.append("p99", counter.getPercentileMicros(99));
+    percentiles.append("p999", counter.getPercentileMicros(99.9));
+    percentiles.append("max", counter.getMaxMicros());
+}
+
 BSONObj BenchRunner::finish(BenchRunner* runner) {
     runner->stop();
 
@@ -913,6 +1122,21 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendAverageMicrosIfAvailable(buf, "updateLatencyAverageMicros", stats.updateCounter);
     appendAverageMicrosIfAvailable(buf, "queryLatencyAverageMicros", stats.queryCounter);
     appendAverageMicrosIfAvailable(buf, "commandsLatencyAverageMicros", stats.commandCounter);
+    appendAverageMicrosIfAvailable(buf, "aggregateLatencyAverageMicros", stats.aggregateCounter);
+    appendAverageMicrosIfAvailable(
+        buf, "findAndModifyLatencyAverageMicros", stats.findAndModifyCounter);
+    appendAverageMicrosIfAvailable(buf, "getMoreLatencyAverageMicros", stats.getMoreCounter);
+
+    appendPercentilesMicrosIfAvailable(buf, "findOneLatencyMicros", stats.findOneCounter);
+    appendPercentilesMicrosIfAvailable(buf, "insertLatencyMicros", stats.insertCounter);
+    appendPercentilesMicrosIfAvailable(buf, "deleteLatencyMicros", stats.deleteCounter);
+    appendPercentilesMicrosIfAvailable(buf, "updateLatencyMicros", stats.updateCounter);
+    appendPercentilesMicrosIfAvailable(buf, "queryLatencyMicros", stats.queryCounter);
+    appendPercentilesMicrosIfAvailable(buf, "commandsLatencyMicros", stats.commandCounter);
+    appendPercentilesMicrosIfAvailable(buf, "aggregateLatencyMicros", stats.aggregateCounter);
+    appendPercentilesMicrosIfAvailable(
+        buf, "findAndModifyLatencyMicros", stats.findAndModifyCounter);
+    appendPercentilesMicrosIfAvailable(buf, "getMoreLatencyMicros", stats.getMoreCounter);
 
     buf.append("totalOps", static_cast<long long>(stats.opCount));
 
@@ -927,6 +1151,9 @@ BSONObj BenchRunner::finish(BenchRunner* runner) {
     appendPerSec("update", stats.updateCounter.getNumEvents());
     appendPerSec("query", stats.queryCounter.getNumEvents());
     appendPerSec("command", stats.commandCounter.getNumEvents());
+    appendPerSec("aggregate", stats.aggregateCounter.getNumEvents());
+    appendPerSec("findAndModify", stats.findAndModifyCounter.getNumEvents());
+    appendPerSec("getMore", stats.getMoreCounter.getNumEvents());
 
     BSONObj zoo = buf.obj();
 
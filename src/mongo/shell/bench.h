@@ -102,6 +102,16 @@ public:
     /// Base random seed for threads
     int64_t randomSeed;
 
+    /**
+     * Total number of operations per second to start across all threads, or 0 to have each
+     * thread start its next operation as soon as the previous one finishes.
+     *
+     * With a target rate, each operation has an intended start time, and the time by which it
+     * starts late is counted in its latency, so that a slow server cannot hide its tail latency
+     * by holding back the load it is offered.
+     */
+    double targetOpsPerSecond;
+
     bool hideResults;
     bool handleErrors;
     bool hideErrors;
@@ -158,10 +168,7 @@ public:
     /**
      * Count one instance of the event, which took "timeMicros" microseconds.
      */
-    void countOne(long long timeMicros) {
-        ++_numEvents;
-        _totalTimeMicros += timeMicros;
-    }
+    void countOne(long long timeMicros);
 
     /**
      * Get the total number of microseconds ellapsed during all observed events.
@@ -177,9 +184,33 @@ public:
         return _numEvents;
     }
 
+    /**
+     * Get the duration in microseconds which "percentile" percent of the observed events did not
+     * exceed.  The result is rounded up by at most 1/16th of its value.
+     */
+    long long getPercentileMicros(double percentile) const;
+
+    /**
+     * Get the duration of the longest observed event, in microseconds.
+     */
+    long long getMaxMicros() const {
+        return _maxTimeMicros;
+    }
+
 private:
+    // Durations are counted in buckets whose width is 1/16th of the power of two below them, so
+    // that percentiles have the same relative precision across all durations.
+    static const int kSubBucketBits = 4;
+    static const int kSubBucketCount = 1 << kSubBucketBits;
+    static const int kNumBuckets = kSubBucketCount * (64 - kSubBucketBits + 1);
+
+    static int bucketFor(long long timeMicros);
+    static long long bucketUpperBound(int bucket);
+
     unsigned long long _numEvents;
     long long _totalTimeMicros;
+    long long _maxTimeMicros;
+    unsigned long long _buckets[kNumBuckets];
 };
 
 /**
@@ -203,6 +234,15 @@ public:
         initialize(eventCounter, eventCounter, false);
     }
 
+    /**
+     * Traces an event which started "scheduleLagMicros" microseconds later than intended, and
+     * counts that delay as part of its duration.
+     */
+    BenchRunEventTrace(BenchRunEventCounter* eventCounter, long long scheduleLagMicros) {
+        initialize(eventCounter, eventCounter, false);
+        _scheduleLagMicros = scheduleLagMicros;
+    }
+
     BenchRunEventTrace(BenchRunEventCounter* successCounter,
                        BenchRunEventCounter* failCounter,
                        bool defaultToFailure = true) {
@@ -210,7 +250,8 @@ public:
     }
 
     ~BenchRunEventTrace() {
-        (_succeeded ? _successCounter : _failCounter)->countOne(_timer.micros());
+        (_succeeded ? _successCounter : _failCounter)
+            ->countOne(_scheduleLagMicros + _timer.micros());
     }
 
     void succeed() {
@@ -227,9 +268,11 @@ private:
         _successCounter = successCounter;
         _failCounter = failCounter;
         _succeeded = !defaultToFailure;
+        _scheduleLagMicros = 0;
     }
 
     Timer _timer;
+    long long _scheduleLagMicros;
     BenchRunEventCounter* _successCounter;
     BenchRunEventCounter* _failCounter;
     bool _succeeded;
@@ -259,6 +302,9 @@ public:
     BenchRunEventCounter deleteCounter;
     BenchRunEventCounter queryCounter;
     BenchRunEventCounter commandCounter;
+    BenchRunEventCounter aggregateCounter;
+    BenchRunEventCounter findAndModifyCounter;
+    BenchRunEventCounter getMoreCounter;
 
     std::map<std::string, long long> opcounters;
     std::vector<BSONObj> trappedErrors;
@@ -83,6 +83,7 @@ DBCollection.prototype.help = function () {
     print("\tdb." + shortName + ".updateOne( filter, update, <optional params> ) - update the first matching document, optional parameters are: upsert, w, wtimeout, j");
     print("\tdb." + shortName + ".updateMany( filter, update, <optional params> ) - update all matching documents, optional parameters are: upsert, w, wtimeout, j");
     print("\tdb." + shortName + ".validate( <full> ) - SLOW");;
+    print("\tdb." + shortName + ".watch( <optional params> ) - returns a tailable cursor over this collection's oplog entries, optional parameters are: operationTypes, resumeAfter, projection");
     print("\tdb." + shortName + ".getShardVersion() - only for use with sharding");
     print("\tdb." + shortName + ".getShardDistribution() - prints statistics about data distribution in the cluster");
     print("\tdb." + shortName + ".getSplitKeysForChunks( <maxChunkSize> ) - calculates split points over all chunks and returns splitter function");
@@ -1009,6 +1010,39 @@ DBCollection.prototype.getCollection = function( subName ){
     return this._db.getCollection( this._shortName + "." + subName );
 }
 
+/**
+  * Returns a tailable, awaitData cursor over the replica set oplog entries for this collection, so
+  * that the server rather than the client filters out the entries of other collections.
+  *
+  * operationTypes: The oplog 'op' values to return, e.g. ['i', 'u', 'd']. Default: all.
+  * resumeAfter: Return entries after this oplog timestamp, e.g. the 'ts' of the last entry a
+  *              previous cursor returned. Default: the newest entry in the oplog.
+  * projection: Applied to each oplog entry. Keep 'ts' in it to be able to resume.
+  */
+DBCollection.prototype.watch = function(options) {
+    'use strict';
+
+    options = options || {};
+    var oplog = this.getDB().getSiblingDB("local").getCollection("oplog.rs");
+
+    var resumeAfter = options.resumeAfter;
+    if (resumeAfter === undefined) {
+        var newest = oplog.find({}, {ts: 1}).sort({$natural: -1}).limit(1).toArray();
+        if (newest.length == 0) {
+            throw Error("cannot watch " + this.getFullName() + ": no replica set oplog found");
+        }
+        resumeAfter = newest[0].ts;
+    }
+
+    // The 'ts' predicate lets oplogReplay find where to start without scanning the whole oplog.
+    var query = {ts: {$gt: resumeAfter}, ns: this.getFullName()};
+    if (options.operationTypes) {
+        query.op = {$in: options.operationTypes};
+    }
+
+    return oplog.find(query, options.projection).tailable(true).oplogReplay();
+};
+
 /**
   * scale: The scale at which to deliver results. Unless specified, this command returns all data
   *        in bytes.
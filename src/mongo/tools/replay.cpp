@@ -0,0 +1,353 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+/**
+ * mongoreplay plays a traffic recording made with startRecordingTraffic back against a server,
+ * one connection per recorded connection, keeping each connection's order and the recorded
+ * spacing of its requests (scaled by --speed). It then reports, per command, the latency the
+ * recorded server saw next to the latency of the replay, for comparing two builds on the same
+ * workload.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kDefault
+
+#include "mongo/platform/basic.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/data_view.h"
+#include "mongo/base/initializer.h"
+#include "mongo/client/dbclientinterface.h"
+#include "mongo/db/traffic_recording.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/tools/mongoreplay_options.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/exit_code.h"
+#include "mongo/util/log.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/quick_exit.h"
+#include "mongo/util/static_observer.h"
+#include "mongo/util/text.h"
+#include "mongo/util/time_support.h"
+#include "mongo/util/timer.h"
+
+using namespace mongo;
+using namespace std;
+
+namespace mongo {
+bool inShutdown() {
+    return false;
+}
+}  // namespace mongo
+
+namespace {
+
+// Offset of the opCode in a wire protocol message header.
+const size_t kOpCodeOffset = 12;
+
+struct ReplayRequest {
+    Microseconds offset{0};
+    std::string label;
+    std::string message;
+    long long recordedMicros = -1;  // -1 when the recording has no reply for the request.
+};
+
+struct ReplayConnection {
+    std::vector<ReplayRequest> requests;
+};
+
+struct LatencyStats {
+    long long failures = 0;
+    std::vector<long long> recorded;
+    std::vector<long long> replayed;
+};
+
+typedef std::map<std::string, LatencyStats> StatsMap;
+
+int opCodeOf(const std::string& message) {
+    return ConstDataView(message.data()).read<LittleEndian<int32_t>>(kOpCodeOffset);
+}
+
+bool expectsReply(int op) {
+    return op == dbQuery || op == dbGetMore || op == dbCommand;
+}
+
+/**
+ * Names a request for the report: the command name for commands, in either wire format, and the
+ * operation otherwise.
+ */
+std::string labelFor(const std::string& message) {
+    const int op = opCodeOf(message);
+    const char* const end = message.data() + message.size();
+    const char* p = message.data() + TrafficRecord::kMessageHeaderSize;
+
+    if (op == dbCommand) {
+        // database, then command name.
+        const char* database = static_cast<const char*>(memchr(p, '\0', end - p));
+        if (database && database + 1 < end) {
+            const char* name = database + 1;
+            if (memchr(name, '\0', end - name)) {
+                return name;
+            }
+        }
+    } else if (op == dbQuery && end - p > 4) {
+        // flags, then namespace; queries of "<db>.$cmd" are commands.
+        p += 4;
+        const char* nsEnd = static_cast<const char*>(memchr(p, '\0', end - p));
+        if (nsEnd && StringData(p, nsEnd - p).endsWith(".$cmd")) {
+            // numberToSkip and numberToReturn, then the command object.
+            const char* obj = nsEnd + 1 + 8;
+            if (end - obj > 5) {
+                const int32_t objSize = ConstDataView(obj).read<LittleEndian<int32_t>>();
+                if (objSize > 5 && objSize <= end - obj) {
+                    return BSONObj(obj).firstElementFieldName();
+                }
+            }
+        }
+    }
+    return opToString(op);
+}
+
+/**
+ * Reads the recording, grouping requests by connection and pairing each reply with its request
+ * to find the recorded latency.
+ */
+Status loadRecording(const std::string& path, std::map<uint64_t, ReplayConnection>* connections) {
+    std::ifstream in(path.c_str(), std::ios::in | std::ios::binary);
+    if (!in.is_open()) {
+        return Status(ErrorCodes::FileNotOpen, "could not open " + path);
+    }
+
+    // (connection, requestId) of requests still waiting for their reply.
+    std::map<std::pair<uint64_t, int32_t>, size_t> pending;
+
+    TrafficRecordReader reader(&in);
+    TrafficRecord record;
+    while (true) {
+        StatusWith<bool> more = reader.next(&record);
+        if (!more.isOK()) {
+            return more.getStatus();
+        }
+        if (!more.getValue()) {
+            return Status::OK();
+        }
+
+        ReplayConnection& connection = (*connections)[record.connectionId];
+        if (record.kind == TrafficRecord::Kind::kRequest) {
+            ReplayRequest request;
+            request.offset = record.offset;
+            request.label = labelFor(record.message);
+            request.message = std::move(record.message);
+            pending[std::make_pair(record.connectionId, record.requestId())] =
+                connection.requests.size();
+            connection.requests.push_back(std::move(request));
+            continue;
+        }
+
+        auto it = pending.find(std::make_pair(record.connectionId, record.responseTo()));
+        if (it == pending.end()) {
+            continue;
+        }
+        ReplayRequest& request = connection.requests[it->second];
+        request.recordedMicros = durationCount<Microseconds>(record.offset - request.offset);
+        pending.erase(it);
+    }
+}
+
+/**
+ * Replays one recorded connection over its own connection to the target, sleeping until each
+ * request's scaled offset from 'replayStart'.
+ */
+void replayConnection(const ReplayConnection& connection,
+                      const Timer& replayStart,
+                      StatsMap* stats,
+                      stdx::mutex* statsMutex) {
+    StatsMap local;
+    const double speed = mongoReplayGlobalParams.speed;
+
+    DBClientConnection conn;
+    std::string errmsg;
+    if (!conn.connect(HostAndPort(mongoReplayGlobalParams.host), errmsg)) {
+        cerr << "could not connect to " << mongoReplayGlobalParams.host << ": " << errmsg << endl;
+        for (const ReplayRequest& request : connection.requests) {
+            local[request.label].failures++;
+        }
+    } else {
+        for (const ReplayRequest& request : connection.requests) {
+            if (speed > 0) {
+                const long long due = durationCount<Microseconds>(request.offset) / speed;
+                const long long now = replayStart.micros();
+                if (due > now) {
+                    sleepmicros(due - now);
+                }
+            }
+
+            LatencyStats& entry = local[request.label];
+            const int op = opCodeOf(request.message);
+
+            char* data = static_cast<char*>(mongoMalloc(request.message.size()));
+            memcpy(data, request.message.data(), request.message.size());
+            Message toSend(data, true);
+
+            try {
+                Timer timer;
+                if (expectsReply(op)) {
+                    Message response;
+                    if (!conn.call(toSend, response, false)) {
+                        entry.failures++;
+                        continue;
+                    }
+                } else {
+                    conn.say(toSend);
+                }
+                entry.replayed.push_back(timer.micros());
+                if (request.recordedMicros >= 0) {
+                    entry.recorded.push_back(request.recordedMicros);
+                }
+            } catch (const DBException& ex) {
+                entry.failures++;
+                if (conn.isFailed()) {
+                    cerr << "lost connection to " << mongoReplayGlobalParams.host << ": "
+                         << ex.toString() << endl;
+                    break;
+                }
+            }
+        }
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(*statsMutex);
+    for (auto&& entry : local) {
+        LatencyStats& merged = (*stats)[entry.first];
+        merged.failures += entry.second.failures;
+        merged.recorded.insert(
+            merged.recorded.end(), entry.second.recorded.begin(), entry.second.recorded.end());
+        merged.replayed.insert(
+            merged.replayed.end(), entry.second.replayed.begin(), entry.second.replayed.end());
+    }
+}
+
+/**
+ * Sorts 'latencies' and returns its mean and 99th percentile, or zeros when it is empty.
+ */
+std::pair<long long, long long> summarize(std::vector<long long>* latencies) {
+    if (latencies->empty()) {
+        return std::make_pair(0LL, 0LL);
+    }
+    std::sort(latencies->begin(), latencies->end());
+    long long total = 0;
+    for (long long latency : *latencies) {
+        total += latency;
+    }
+    const size_t p99 = std::min(latencies->size() - 1, latencies->size() * 99 / 100);
+    return std::make_pair(total / static_cast<long long>(latencies->size()), (*latencies)[p99]);
+}
+
+void printReport(StatsMap* stats, long long elapsedMicros) {
+    cout << "replayed against " << mongoReplayGlobalParams.host << " in "
+         << elapsedMicros / 1000 << "ms" << endl;
+    cout << "latencies in microseconds" << endl;
+    cout << left << setw(24) << "operation" << right << setw(10) << "count" << setw(10)
+         << "failed" << setw(14) << "recorded avg" << setw(14) << "recorded p99" << setw(14)
+         << "replay avg" << setw(14) << "replay p99" << endl;
+
+    for (auto&& entry : *stats) {
+        LatencyStats& latency = entry.second;
+        const size_t count = latency.replayed.size();
+        const std::pair<long long, long long> recorded = summarize(&latency.recorded);
+        const std::pair<long long, long long> replayed = summarize(&latency.replayed);
+        cout << left << setw(24) << entry.first << right << setw(10) << count << setw(10)
+             << latency.failures << setw(14) << recorded.first << setw(14) << recorded.second
+             << setw(14) << replayed.first << setw(14) << replayed.second << endl;
+    }
+}
+
+}  // namespace
+
+int toolMain(int argc, char** argv, char** envp) {
+    mongo::runGlobalInitializersOrDie(argc, argv, envp);
+
+    static StaticObserver staticObserver;
+
+    std::map<uint64_t, ReplayConnection> connections;
+    Status status = loadRecording(mongoReplayGlobalParams.file, &connections);
+    if (!status.isOK()) {
+        cerr << "failed to read " << mongoReplayGlobalParams.file << ": " << status.toString()
+             << endl;
+        return EXIT_FAILURE;
+    }
+
+    StatsMap stats;
+    stdx::mutex statsMutex;
+    Timer replayStart;
+
+    std::vector<stdx::thread> threads;
+    for (auto&& connection : connections) {
+        if (connection.second.requests.empty()) {
+            continue;
+        }
+        const ReplayConnection* replay = &connection.second;
+        threads.emplace_back(
+            [replay, &replayStart, &stats, &statsMutex] {
+                replayConnection(*replay, replayStart, &stats, &statsMutex);
+            });
+    }
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+
+    printReport(&stats, replayStart.micros());
+    return 0;
+}
+
+#if defined(_WIN32)
+// In Windows, wmain() is an alternate entry point for main(), and receives the same parameters
+// as main() but encoded in Windows Unicode (UTF-16); "wide" 16-bit wchar_t characters.  The
+// WindowsCommandLine object converts these wide character strings to a UTF-8 coded equivalent
+// and makes them available through the argv() and envp() members.  This enables toolMain()
+// to process UTF-8 encoded arguments and environment variables without regard to platform.
+int wmain(int argc, wchar_t* argvW[], wchar_t* envpW[]) {
+    WindowsCommandLine wcl(argc, argvW, envpW);
+    int exitCode = toolMain(argc, wcl.argv(), wcl.envp());
+    quickExit(exitCode);
+}
+#else
+int main(int argc, char* argv[], char** envp) {
+    int exitCode = toolMain(argc, argv, envp);
+    quickExit(exitCode);
+}
+#endif
@@ -0,0 +1,193 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/util/allocator.h"
+
+namespace mongo {
+
+/**
+ * A bump-pointer allocator for short-lived buffers.
+ *
+ * Memory is carved sequentially out of large blocks and is only given back in bulk by reset(),
+ * which keeps one block around for reuse so that a steady stream of small requests does not touch
+ * the heap at all. The most recent allocation can be grown in place or released, which is what
+ * a BufBuilder does as it grows and when it is destroyed.
+ *
+ * Not thread safe.
+ */
+class BumpArena {
+    MONGO_DISALLOW_COPYING(BumpArena);
+
+public:
+    static const size_t kDefaultBlockSize = 32 * 1024;
+
+    explicit BumpArena(size_t blockSize = kDefaultBlockSize) : _blockSize(blockSize) {}
+
+    ~BumpArena() {
+        while (_current) {
+            Block* prev = _current->prev;
+            free(_current);
+            _current = prev;
+        }
+    }
+
+    void* allocate(size_t size) {
+        const size_t capacity = _roundUp(size);
+        const size_t needed = sizeof(Header) + capacity;
+        if (!_current || _current->size - _current->used < needed) {
+            _addBlock(needed);
+        }
+
+        Header* header = reinterpret_cast<Header*>(_current->data() + _current->used);
+        header->capacity = capacity;
+        _current->used += needed;
+        _last = header;
+        return header + 1;
+    }
+
+    /**
+     * Grows an allocation made from this arena, in place if it is the most recent one and the
+     * current block has room.
+     */
+    void* reallocate(void* p, size_t size) {
+        if (!p) {
+            return allocate(size);
+        }
+
+        Header* header = _header(p);
+        if (size <= header->capacity) {
+            return p;
+        }
+
+        const size_t capacity = _roundUp(size);
+        if (header == _last && _current->size - _current->used >= capacity - header->capacity) {
+            _current->used += capacity - header->capacity;
+            header->capacity = capacity;
+            return p;
+        }
+
+        void* grown = allocate(size);
+        memcpy(grown, p, header->capacity);
+        return grown;
+    }
+
+    /**
+     * Gives back the most recent allocation. Any other allocation is only reclaimed by reset().
+     */
+    void deallocate(void* p) {
+        if (!p || _header(p) != _last) {
+            return;
+        }
+        _current->used -= sizeof(Header) + _last->capacity;
+        _last = nullptr;
+    }
+
+    /**
+     * Releases every allocation. One block of the default size is retained for reuse and any
+     * others, including those made for oversized requests, are returned to the heap.
+     */
+    void reset() {
+        Block* keep = nullptr;
+        while (_current) {
+            Block* prev = _current->prev;
+            if (!keep && _current->size == _blockSize) {
+                keep = _current;
+            } else {
+                free(_current);
+            }
+            _current = prev;
+        }
+
+        if (keep) {
+            keep->prev = nullptr;
+            keep->used = 0;
+        }
+        _current = keep;
+        _last = nullptr;
+    }
+
+    /**
+     * Number of bytes of block storage currently held, whether in use or not.
+     */
+    size_t bytesReserved() const {
+        size_t total = 0;
+        for (Block* block = _current; block; block = block->prev) {
+            total += block->size;
+        }
+        return total;
+    }
+
+private:
+    // Both headers are padded to 16 bytes so that allocations keep the alignment of malloc().
+    struct Block {
+        Block* prev;
+        size_t size;
+        size_t used;
+        size_t padding;
+
+        char* data() {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    struct Header {
+        size_t capacity;
+        size_t padding;
+    };
+
+    static size_t _roundUp(size_t size) {
+        return (size + 15) & ~size_t(15);
+    }
+
+    static Header* _header(void* p) {
+        return static_cast<Header*>(p) - 1;
+    }
+
+    void _addBlock(size_t needed) {
+        const size_t size = std::max(_blockSize, needed);
+        Block* block = static_cast<Block*>(mongoMalloc(sizeof(Block) + size));
+        block->prev = _current;
+        block->size = size;
+        block->used = 0;
+        _current = block;
+        _last = nullptr;
+    }
+
+    const size_t _blockSize;
+    Block* _current = nullptr;
+    Header* _last = nullptr;
+};
+
+}  // namespace mongo
@@ -0,0 +1,108 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/bump_arena.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+bool isAligned(void* p) {
+    return reinterpret_cast<uintptr_t>(p) % 16 == 0;
+}
+
+TEST(BumpArenaTest, AllocationsAreAlignedAndDistinct) {
+    BumpArena arena(1024);
+    char* a = static_cast<char*>(arena.allocate(3));
+    char* b = static_cast<char*>(arena.allocate(17));
+    ASSERT(isAligned(a));
+    ASSERT(isAligned(b));
+    ASSERT_GTE(b, a + 3);
+    ASSERT_EQUALS(1024U, arena.bytesReserved());
+}
+
+TEST(BumpArenaTest, ReallocateLastAllocationGrowsInPlace) {
+    BumpArena arena(1024);
+    char* p = static_cast<char*>(arena.allocate(64));
+    memset(p, 'x', 64);
+    ASSERT_EQUALS(static_cast<void*>(p), arena.reallocate(p, 256));
+    ASSERT_EQUALS('x', p[63]);
+}
+
+TEST(BumpArenaTest, ReallocateEarlierAllocationCopies) {
+    BumpArena arena(1024);
+    char* p = static_cast<char*>(arena.allocate(16));
+    memcpy(p, "0123456789abcdef", 16);
+    arena.allocate(16);
+
+    char* grown = static_cast<char*>(arena.reallocate(p, 128));
+    ASSERT_NOT_EQUALS(p, grown);
+    ASSERT_EQUALS(0, memcmp(grown, "0123456789abcdef", 16));
+}
+
+TEST(BumpArenaTest, DeallocateLastAllocationIsReused) {
+    BumpArena arena(1024);
+    void* p = arena.allocate(100);
+    arena.deallocate(p);
+    ASSERT_EQUALS(p, arena.allocate(100));
+}
+
+TEST(BumpArenaTest, LargeAllocationsGetTheirOwnBlock) {
+    BumpArena arena(1024);
+    arena.allocate(10);
+    char* big = static_cast<char*>(arena.allocate(4096));
+    memset(big, 'y', 4096);
+    ASSERT_GREATER_THAN(arena.bytesReserved(), 4096U + 1024U);
+}
+
+TEST(BumpArenaTest, ResetKeepsOneBlock) {
+    BumpArena arena(1024);
+    for (int i = 0; i < 100; i++) {
+        arena.allocate(100);
+    }
+    arena.allocate(1024 * 1024);
+    ASSERT_GREATER_THAN(arena.bytesReserved(), 1024U * 1024U);
+
+    arena.reset();
+    ASSERT_EQUALS(1024U, arena.bytesReserved());
+
+    // The retained block is reused from its start.
+    void* first = arena.allocate(8);
+    arena.reset();
+    ASSERT_EQUALS(first, arena.allocate(8));
+    ASSERT_EQUALS(1024U, arena.bytesReserved());
+}
+
+}  // namespace
+}  // namespace mongo
@@ -0,0 +1,159 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/epoch_manager.h"
+
+#include <functional>
+
+#include "mongo/stdx/thread.h"
+#include "mongo/util/assert_util.h"
+
+namespace mongo {
+
+const size_t EpochManager::kNumSlots;
+const size_t EpochManager::kReclaimBatchSize;
+const unsigned long long EpochManager::kInactive;
+
+EpochManager::ReadGuard::ReadGuard(EpochManager* manager)
+    : _manager(manager), _slot(manager->_enter()) {}
+
+EpochManager::ReadGuard::~ReadGuard() {
+    _manager->_exit(_slot);
+}
+
+EpochManager::EpochManager() : _epoch(1) {}
+
+EpochManager::~EpochManager() {
+    for (const Slot& slot : _slots) {
+        invariant(slot.epoch.load() == kInactive);
+    }
+    for (Retired& retired : _retired) {
+        retired.reclaimer();
+    }
+}
+
+void EpochManager::retire(Reclaimer reclaimer) {
+    bool reclaim;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        // Read the epoch under the mutex, so that _retired stays in epoch order.
+        _retired.push_back(Retired{_epoch.load(), std::move(reclaimer)});
+        _numRetired.addAndFetch(1);
+        reclaim = ++_retiredSinceReclaim >= kReclaimBatchSize;
+    }
+
+    if (reclaim) {
+        tryReclaim();
+    }
+}
+
+size_t EpochManager::tryReclaim() {
+    const unsigned long long epoch = _tryAdvance();
+
+    std::vector<Retired> ready;
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _retiredSinceReclaim = 0;
+
+        auto end = _retired.begin();
+        while (end != _retired.end() && end->epoch + 2 <= epoch) {
+            ++end;
+        }
+        ready.assign(std::make_move_iterator(_retired.begin()), std::make_move_iterator(end));
+        _retired.erase(_retired.begin(), end);
+    }
+
+    // Reclaimers run outside of the mutex, since they may free large structures or retire more
+    // objects.
+    for (Retired& retired : ready) {
+        retired.reclaimer();
+    }
+    _numReclaimed.addAndFetch(ready.size());
+    return ready.size();
+}
+
+void EpochManager::synchronize() {
+    const long long target = _numRetired.load();
+    while (true) {
+        tryReclaim();
+        if (_numReclaimed.load() >= target) {
+            return;
+        }
+        stdx::this_thread::yield();
+    }
+}
+
+EpochManager::Stats EpochManager::getStats() const {
+    Stats stats;
+    stats.epoch = _epoch.load();
+    stats.retired = _numRetired.load();
+    stats.reclaimed = _numReclaimed.load();
+    return stats;
+}
+
+size_t EpochManager::_enter() {
+    // Threads start their search at different slots, so that they rarely contend for one.
+    const size_t start = std::hash<stdx::thread::id>()(stdx::this_thread::get_id());
+    for (size_t i = 0;; ++i) {
+        const size_t index = (start + i) % kNumSlots;
+        Slot& slot = _slots[index];
+
+        // A guard may record an epoch which is already stale by the time the compare-and-swap
+        // publishes it. That is safe: the guard only reads shared pointers after publishing, by
+        // which point anything retired before the epoch it recorded has already been unlinked.
+        if (slot.epoch.load() == kInactive &&
+            slot.epoch.compareAndSwap(kInactive, _epoch.load()) == kInactive) {
+            return index;
+        }
+
+        if (i % kNumSlots == kNumSlots - 1) {
+            stdx::this_thread::yield();
+        }
+    }
+}
+
+void EpochManager::_exit(size_t slot) {
+    _slots[slot].epoch.store(kInactive);
+}
+
+unsigned long long EpochManager::_tryAdvance() {
+    const unsigned long long epoch = _epoch.load();
+    for (const Slot& slot : _slots) {
+        const unsigned long long slotEpoch = slot.epoch.load();
+        if (slotEpoch != kInactive && slotEpoch != epoch) {
+            return epoch;
+        }
+    }
+
+    _epoch.compareAndSwap(epoch, epoch + 1);
+    return _epoch.load();
+}
+
+}  // namespace mongo
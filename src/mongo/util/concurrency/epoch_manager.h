@@ -0,0 +1,167 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+
+namespace mongo {
+
+/**
+ * Epoch-based reclamation, for structures whose readers go without locks.
+ *
+ * A reader holds a ReadGuard while it follows pointers into the structure. A writer unlinks an
+ * object so that new readers cannot reach it, then retires it; the object is reclaimed only once
+ * every reader that was inside a ReadGuard when it was retired has left it.
+ *
+ * The manager keeps a global epoch, and each ReadGuard records the epoch it started in. The
+ * global epoch only moves from E to E + 1 once every active guard has started in E, so once it
+ * reaches E + 2 no guard can still see an object retired in E.
+ *
+ * Example:
+ *
+ *     // Reader.
+ *     EpochManager::ReadGuard guard(&epochs);
+ *     const Config* config = current.load();
+ *     ... use *config ...
+ *
+ *     // Writer, serialized with other writers.
+ *     Config* old = current.swap(newConfig);
+ *     epochs.retire(old);
+ *
+ * Guards are cheap: entering one claims a slot with a compare-and-swap and leaving it is a store.
+ * There are kNumSlots slots; when they are all taken, entering a guard spins until one frees up.
+ */
+class EpochManager {
+    MONGO_DISALLOW_COPYING(EpochManager);
+
+public:
+    using Reclaimer = stdx::function<void()>;
+
+    static const size_t kNumSlots = 256;
+
+    // Retiring this many objects since the last attempt makes retire() try to reclaim.
+    static const size_t kReclaimBatchSize = 64;
+
+    struct Stats {
+        unsigned long long epoch = 0;
+        long long retired = 0;
+        long long reclaimed = 0;
+    };
+
+    /**
+     * Marks the calling thread as reading structures protected by an EpochManager, for the
+     * lifetime of the guard. Guards may nest.
+     */
+    class ReadGuard {
+        MONGO_DISALLOW_COPYING(ReadGuard);
+
+    public:
+        explicit ReadGuard(EpochManager* manager);
+        ~ReadGuard();
+
+    private:
+        EpochManager* const _manager;
+        size_t _slot;
+    };
+
+    EpochManager();
+
+    /**
+     * Runs the reclaimers of every object still retired. No ReadGuard may be active.
+     */
+    ~EpochManager();
+
+    /**
+     * Defers "reclaimer" until no reader can still see the object it frees. It runs on the thread
+     * that calls retire(), tryReclaim() or synchronize() once that is the case.
+     */
+    void retire(Reclaimer reclaimer);
+
+    template <typename T>
+    void retire(T* object) {
+        retire([object] { delete object; });
+    }
+
+    /**
+     * Advances the epoch if no reader is holding it back and runs the reclaimers which are safe
+     * to run. Returns how many ran.
+     */
+    size_t tryReclaim();
+
+    /**
+     * Blocks until everything retired so far has been reclaimed. May not be called inside a
+     * ReadGuard of this manager, which would wait for itself.
+     */
+    void synchronize();
+
+    Stats getStats() const;
+
+private:
+    struct Retired {
+        unsigned long long epoch;
+        Reclaimer reclaimer;
+    };
+
+    // The epoch the slot's guard started in, or kInactive.
+    struct MONGO_COMPILER_ALIGN_TYPE(64) Slot {
+        AtomicUInt64 epoch;
+    };
+
+    static const unsigned long long kInactive = 0;
+
+    size_t _enter();
+    void _exit(size_t slot);
+
+    /**
+     * Moves the global epoch forward by one if every active guard started in the current epoch.
+     * Returns the global epoch.
+     */
+    unsigned long long _tryAdvance();
+
+    Slot _slots[kNumSlots];
+
+    // Starts at 1, since 0 marks inactive slots.
+    AtomicUInt64 _epoch;
+
+    // Guards _retired and _retiredSinceReclaim.
+    stdx::mutex _mutex;
+    std::vector<Retired> _retired;
+    size_t _retiredSinceReclaim = 0;
+
+    AtomicInt64 _numRetired;
+    AtomicInt64 _numReclaimed;
+};
+
+}  // namespace mongo
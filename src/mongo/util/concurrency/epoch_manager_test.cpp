@@ -0,0 +1,156 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include <vector>
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/epoch_manager.h"
+
+namespace mongo {
+namespace {
+
+TEST(EpochManagerTest, RetiredObjectOutlivesReadersThatMaySeeIt) {
+    EpochManager epochs;
+    bool reclaimed = false;
+
+    {
+        EpochManager::ReadGuard guard(&epochs);
+        epochs.retire([&reclaimed] { reclaimed = true; });
+        for (int i = 0; i < 10; ++i) {
+            epochs.tryReclaim();
+        }
+        ASSERT_FALSE(reclaimed);
+    }
+
+    // The epoch moved on once while the reader was inside its guard, and moves on again now.
+    ASSERT_EQUALS(1U, epochs.tryReclaim());
+    ASSERT_TRUE(reclaimed);
+
+    EpochManager::Stats stats = epochs.getStats();
+    ASSERT_EQUALS(1, stats.retired);
+    ASSERT_EQUALS(1, stats.reclaimed);
+}
+
+TEST(EpochManagerTest, NestedGuards) {
+    EpochManager epochs;
+    bool reclaimed = false;
+
+    {
+        EpochManager::ReadGuard guard(&epochs);
+        {
+            EpochManager::ReadGuard nested(&epochs);
+            epochs.retire([&reclaimed] { reclaimed = true; });
+        }
+        for (int i = 0; i < 10; ++i) {
+            epochs.tryReclaim();
+        }
+        ASSERT_FALSE(reclaimed);
+    }
+
+    epochs.synchronize();
+    ASSERT_TRUE(reclaimed);
+}
+
+TEST(EpochManagerTest, SynchronizeAndDestructorReclaimEverything) {
+    int reclaimed = 0;
+    {
+        EpochManager epochs;
+        epochs.retire([&reclaimed] { ++reclaimed; });
+        epochs.retire(new int(5));
+        epochs.synchronize();
+        ASSERT_EQUALS(1, reclaimed);
+
+        epochs.retire([&reclaimed] { ++reclaimed; });
+    }
+    ASSERT_EQUALS(2, reclaimed);
+}
+
+TEST(EpochManagerTest, RetireReclaimsInBatches) {
+    EpochManager epochs;
+    AtomicInt32 reclaimed;
+    for (size_t i = 0; i < 10 * EpochManager::kReclaimBatchSize; ++i) {
+        epochs.retire([&reclaimed] { reclaimed.addAndFetch(1); });
+    }
+    ASSERT_GREATER_THAN(reclaimed.load(), 0);
+}
+
+// Readers keep checking that the object they reach through a shared pointer has not been
+// reclaimed, while a writer keeps replacing it.
+TEST(EpochManagerTest, ConcurrentReadersNeverSeeReclaimedObjects) {
+    struct Node {
+        AtomicWord<bool> reclaimed{false};
+    };
+
+    EpochManager epochs;
+    std::vector<std::unique_ptr<Node>> nodes;
+    const size_t numNodes = 20000;
+    for (size_t i = 0; i < numNodes; ++i) {
+        nodes.push_back(stdx::make_unique<Node>());
+    }
+
+    AtomicWord<Node*> current(nodes[0].get());
+    AtomicWord<bool> done(false);
+    AtomicInt32 violations;
+
+    std::vector<stdx::thread> readers;
+    for (int i = 0; i < 4; ++i) {
+        readers.emplace_back([&] {
+            while (!done.load()) {
+                EpochManager::ReadGuard guard(&epochs);
+                Node* node = current.load();
+                for (int j = 0; j < 10; ++j) {
+                    if (node->reclaimed.load()) {
+                        violations.addAndFetch(1);
+                    }
+                }
+            }
+        });
+    }
+
+    for (size_t i = 1; i < numNodes; ++i) {
+        Node* old = current.swap(nodes[i].get());
+        epochs.retire([old] { old->reclaimed.store(true); });
+    }
+
+    done.store(true);
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    epochs.synchronize();
+
+    ASSERT_EQUALS(0, violations.load());
+    ASSERT_EQUALS(static_cast<long long>(numNodes - 1), epochs.getStats().reclaimed);
+}
+
+}  // namespace
+}  // namespace mongo
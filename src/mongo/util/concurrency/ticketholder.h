@@ -111,6 +111,10 @@ public:
         return _holder != NULL;
     }
 
+    TicketHolder* getHolder() const {
+        return _holder;
+    }
+
     void reset(TicketHolder* holder = NULL) {
         if (_holder) {
             _holder->release();
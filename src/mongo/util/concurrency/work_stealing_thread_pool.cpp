@@ -0,0 +1,191 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kExecutor
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+
+#include <limits>
+
+#include "mongo/stdx/memory.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+
+namespace mongo {
+
+const size_t WorkStealingThreadPool::kNoAffinity = std::numeric_limits<size_t>::max();
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t numWorkers,
+                                               const std::string& threadNamePrefix) {
+    if (numWorkers == 0) {
+        numWorkers = 1;
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        _workers.push_back(stdx::make_unique<Worker>());
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        const std::string threadName = str::stream() << threadNamePrefix << i;
+        _threads.emplace_back(
+            stdx::bind(&WorkStealingThreadPool::_consumeTasks, this, i, threadName));
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    join();
+
+    {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _shutdown = true;
+        _workAvailable.notify_all();
+    }
+
+    for (auto& thread : _threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingThreadPool::schedule(Task task, size_t affinity) {
+    if (affinity == kNoAffinity) {
+        affinity = _nextWorker.fetchAndAdd(1);
+    }
+
+    _numOutstanding.addAndFetch(1);
+
+    Worker* worker = _workers[affinity % _workers.size()].get();
+    {
+        stdx::lock_guard<stdx::mutex> lk(worker->mutex);
+        worker->tasks.push_back(std::move(task));
+    }
+
+    // A worker registers itself as sleeping before checking _numQueued one last time, so either it
+    // sees this task or this thread sees it sleeping.
+    _numQueued.addAndFetch(1);
+    if (_numSleepingWorkers.load() > 0) {
+        stdx::lock_guard<stdx::mutex> lk(_mutex);
+        _workAvailable.notify_one();
+    }
+}
+
+void WorkStealingThreadPool::join() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _numJoiners.addAndFetch(1);
+    while (_numOutstanding.load() != 0) {
+        _poolIsIdle.wait(lk);
+    }
+    _numJoiners.subtractAndFetch(1);
+}
+
+WorkStealingThreadPool::Stats WorkStealingThreadPool::getStats() const {
+    Stats stats;
+    stats.tasksExecuted = _tasksExecuted.load();
+    stats.tasksStolen = _tasksStolen.load();
+    stats.uptimeMicros = _uptime.micros();
+    for (const auto& worker : _workers) {
+        stats.workerBusyMicros.push_back(worker->busyMicros.load());
+    }
+    return stats;
+}
+
+void WorkStealingThreadPool::_consumeTasks(size_t index, const std::string& threadName) {
+    setThreadName(threadName);
+    LOG(1) << "starting work-stealing pool thread " << threadName;
+
+    Task task;
+    while (true) {
+        if (!_takeTask(index, &task)) {
+            if (!_waitForWork()) {
+                break;
+            }
+            continue;
+        }
+
+        Timer busy;
+        try {
+            task();
+        } catch (...) {
+            severe() << "Exception reached top of stack in thread " << threadName;
+            std::terminate();
+        }
+        task = nullptr;
+        _workers[index]->busyMicros.addAndFetch(busy.micros());
+        _tasksExecuted.addAndFetch(1);
+
+        if (_numOutstanding.subtractAndFetch(1) == 0 && _numJoiners.load() > 0) {
+            stdx::lock_guard<stdx::mutex> lk(_mutex);
+            _poolIsIdle.notify_all();
+        }
+    }
+
+    LOG(1) << "shutting down work-stealing pool thread " << threadName;
+}
+
+bool WorkStealingThreadPool::_takeTask(size_t index, Task* task) {
+    {
+        Worker* own = _workers[index].get();
+        stdx::lock_guard<stdx::mutex> lk(own->mutex);
+        if (!own->tasks.empty()) {
+            *task = std::move(own->tasks.front());
+            own->tasks.pop_front();
+            _numQueued.subtractAndFetch(1);
+            return true;
+        }
+    }
+
+    // Steal from the end of the victim's queue, which is the work its owner would get to last.
+    for (size_t i = 1; i < _workers.size(); ++i) {
+        Worker* victim = _workers[(index + i) % _workers.size()].get();
+        stdx::lock_guard<stdx::mutex> lk(victim->mutex);
+        if (!victim->tasks.empty()) {
+            *task = std::move(victim->tasks.back());
+            victim->tasks.pop_back();
+            _numQueued.subtractAndFetch(1);
+            _tasksStolen.addAndFetch(1);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool WorkStealingThreadPool::_waitForWork() {
+    stdx::unique_lock<stdx::mutex> lk(_mutex);
+    _numSleepingWorkers.addAndFetch(1);
+    // _numQueued may briefly go negative, when a task is taken before schedule() counts it.
+    while (!_shutdown && _numQueued.load() <= 0) {
+        _workAvailable.wait(lk);
+    }
+    _numSleepingWorkers.subtractAndFetch(1);
+    return !_shutdown;
+}
+
+}  // namespace mongo
@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/platform/compiler.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/functional.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/timer.h"
+
+namespace mongo {
+
+/**
+ * A fixed-size pool of threads in which every worker owns its own queue of tasks.
+ *
+ * Unlike ThreadPool, which serializes every schedule and every dequeue on one mutex, each task
+ * is pushed onto the queue of a single worker. A worker runs the tasks on its own queue in the
+ * order they were scheduled, and when that queue is empty it steals from the tail of the other
+ * workers' queues before going to sleep.
+ *
+ * Callers which schedule related work repeatedly, such as the repl writer vectors for a given
+ * collection, may pass an affinity hint so that the work keeps landing on the same worker thread
+ * and finds that thread's caches warm. Tasks without a hint are spread over the workers in turn.
+ */
+class WorkStealingThreadPool {
+    MONGO_DISALLOW_COPYING(WorkStealingThreadPool);
+
+public:
+    using Task = stdx::function<void()>;
+
+    // Affinity hint for tasks which may run on any worker.
+    static const size_t kNoAffinity;
+
+    struct Stats {
+        // The number of tasks which ran to completion.
+        long long tasksExecuted = 0;
+
+        // The number of those tasks which ran on a worker other than the one they were queued on.
+        long long tasksStolen = 0;
+
+        // Microseconds since the pool started.
+        long long uptimeMicros = 0;
+
+        // Microseconds each worker, by index, spent running tasks. The rest of the uptime it was
+        // idle or looking for work.
+        std::vector<long long> workerBusyMicros;
+    };
+
+    /**
+     * Starts "numWorkers" threads (at least one), named "threadNamePrefix" followed by the
+     * worker's index.
+     */
+    WorkStealingThreadPool(size_t numWorkers, const std::string& threadNamePrefix);
+
+    /**
+     * Waits for the pending tasks to complete, then stops and joins the worker threads.
+     */
+    ~WorkStealingThreadPool();
+
+    /**
+     * Queues "task" on the worker "affinity" maps to (modulo the number of workers), or on the
+     * next worker in turn for kNoAffinity.
+     */
+    void schedule(Task task, size_t affinity = kNoAffinity);
+
+    /**
+     * Blocks until every task scheduled so far, and every task those tasks scheduled, has run.
+     * Like OldThreadPool::join(), this does not stop new tasks from being scheduled. May not be
+     * called by a task in the pool.
+     */
+    void join();
+
+    size_t getNumWorkers() const {
+        return _workers.size();
+    }
+
+    Stats getStats() const;
+
+private:
+    // Each worker's queue sits on its own cache lines, so that workers taking tasks from their own
+    // queues do not contend with each other.
+    struct MONGO_COMPILER_ALIGN_TYPE(128) Worker {
+        stdx::mutex mutex;
+        std::deque<Task> tasks;
+        AtomicInt64 busyMicros;
+    };
+
+    void _consumeTasks(size_t index, const std::string& threadName);
+
+    /**
+     * Takes the oldest task from the worker's own queue or, failing that, the newest task from
+     * another worker's queue. Returns false if every queue was empty.
+     */
+    bool _takeTask(size_t index, Task* task);
+
+    /**
+     * Called by a worker whose search for a task came up empty. Returns false once the pool is
+     * shutting down.
+     */
+    bool _waitForWork();
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+    std::vector<stdx::thread> _threads;
+
+    // Number of tasks sitting in the workers' queues.
+    AtomicInt64 _numQueued;
+
+    // Number of tasks scheduled which have not finished running yet.
+    AtomicInt64 _numOutstanding;
+
+    // Round-robin cursor for tasks scheduled without an affinity hint.
+    AtomicUInt64 _nextWorker;
+
+    AtomicInt64 _tasksExecuted;
+    AtomicInt64 _tasksStolen;
+    Timer _uptime;
+
+    // Sleeping workers and callers of join() register themselves under _mutex, so that schedule()
+    // and the last task to finish only have to take it when there is someone to wake up.
+    stdx::mutex _mutex;
+    stdx::condition_variable _workAvailable;
+    stdx::condition_variable _poolIsIdle;
+    AtomicInt32 _numSleepingWorkers;
+    AtomicInt32 _numJoiners;
+    bool _shutdown = false;
+};
+
+}  // namespace mongo
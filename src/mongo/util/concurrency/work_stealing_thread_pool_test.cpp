@@ -0,0 +1,145 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/condition_variable.h"
+#include "mongo/stdx/mutex.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/concurrency/work_stealing_thread_pool.h"
+#include "mongo/util/time_support.h"
+
+namespace {
+using namespace mongo;
+
+TEST(WorkStealingThreadPoolTest, JoinWaitsForAllTasks) {
+    WorkStealingThreadPool pool(4, "WorkStealingThreadPoolTest-");
+    ASSERT_EQUALS(4U, pool.getNumWorkers());
+
+    AtomicInt32 count;
+    for (int i = 0; i < 1000; ++i) {
+        pool.schedule([&count] { count.addAndFetch(1); });
+    }
+    pool.join();
+    ASSERT_EQUALS(1000, count.load());
+    ASSERT_EQUALS(1000, pool.getStats().tasksExecuted);
+
+    // The pool can be reused after join().
+    for (int i = 0; i < 10; ++i) {
+        pool.schedule([&count] { count.addAndFetch(1); }, i);
+    }
+    pool.join();
+    ASSERT_EQUALS(1010, count.load());
+}
+
+TEST(WorkStealingThreadPoolTest, RecordsBusyTimePerWorker) {
+    WorkStealingThreadPool pool(2, "WorkStealingThreadPoolTest-");
+    pool.schedule([] { sleepmillis(20); }, 0);
+    pool.join();
+
+    const WorkStealingThreadPool::Stats stats = pool.getStats();
+    ASSERT_EQUALS(2U, stats.workerBusyMicros.size());
+    const long long busyMicros = stats.workerBusyMicros[0] + stats.workerBusyMicros[1];
+    ASSERT_GTE(busyMicros, 20 * 1000);
+    ASSERT_GTE(stats.uptimeMicros, busyMicros);
+}
+
+TEST(WorkStealingThreadPoolTest, IdleWorkersStealFromABusyWorker) {
+    WorkStealingThreadPool pool(4, "WorkStealingThreadPoolTest-");
+
+    // Block the worker all of the tasks are queued on; the others have to steal them.
+    stdx::mutex mutex;
+    stdx::condition_variable cv;
+    bool blocked = false;
+    bool release = false;
+    pool.schedule(
+        [&] {
+            stdx::unique_lock<stdx::mutex> lk(mutex);
+            blocked = true;
+            cv.notify_all();
+            cv.wait(lk, [&] { return release; });
+        },
+        0);
+    {
+        stdx::unique_lock<stdx::mutex> lk(mutex);
+        cv.wait(lk, [&] { return blocked; });
+    }
+
+    // Another worker may have stolen the blocking task before worker 0 woke up, in which case
+    // worker 0 is free to run the tasks on its own queue.
+    const bool blockedOwner = pool.getStats().tasksStolen == 0;
+
+    AtomicInt32 count;
+    const int numTasks = 100;
+    for (int i = 0; i < numTasks; ++i) {
+        pool.schedule(
+            [&] {
+                if (count.addAndFetch(1) == numTasks) {
+                    stdx::lock_guard<stdx::mutex> lk(mutex);
+                    release = true;
+                    cv.notify_all();
+                }
+            },
+            0);
+    }
+    pool.join();
+
+    ASSERT_EQUALS(numTasks, count.load());
+    if (blockedOwner) {
+        ASSERT_EQUALS(numTasks, pool.getStats().tasksStolen);
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, TasksMayScheduleMoreTasks) {
+    WorkStealingThreadPool pool(3, "WorkStealingThreadPoolTest-");
+
+    AtomicInt32 count;
+    for (int i = 0; i < 10; ++i) {
+        pool.schedule([&pool, &count] {
+            for (int j = 0; j < 10; ++j) {
+                pool.schedule([&count] { count.addAndFetch(1); });
+            }
+        });
+    }
+    pool.join();
+    ASSERT_EQUALS(100, count.load());
+}
+
+TEST(WorkStealingThreadPoolTest, DestructorRunsPendingTasks) {
+    AtomicInt32 count;
+    {
+        WorkStealingThreadPool pool(1, "WorkStealingThreadPoolTest-");
+        for (int i = 0; i < 50; ++i) {
+            pool.schedule([&count] { count.addAndFetch(1); });
+        }
+    }
+    ASSERT_EQUALS(50, count.load());
+}
+
+}  // namespace
@@ -37,9 +37,14 @@
 
 #include "mongo/config.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/base/owned_pointer_vector.h"
+#include "mongo/platform/atomic_word.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/concurrency/thread_name.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
 #include "mongo/util/net/message_port.h"
 #include "mongo/util/net/ssl_manager.h"
 #include "mongo/util/scopeguard.h"
@@ -63,6 +68,10 @@
 #ifdef __OpenBSD__
 #include <sys/uio.h>
 #endif
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/epoll.h>
+#endif
 
 #else
 
@@ -81,8 +90,65 @@ using std::vector;
 
 // ----- Listener -------
 
+namespace {
+
+// Length of the queue of connections each listening socket lets the kernel complete before they
+// are accepted. The kernel caps it at net.core.somaxconn.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenBacklog, int, SOMAXCONN);
+
+// Number of threads accepting connections. Each of them accepts from its own set of TCP sockets,
+// bound to the same addresses with SO_REUSEPORT so that the kernel spreads incoming connections
+// over them. Only used on Linux.
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(listenerThreads, int, 1);
+
+// Most connections an acceptor takes from one socket per wakeup, so that one busy socket does
+// not starve the others.
+const size_t kMaxAcceptBatch = 64;
+
+AtomicInt64 acceptedConnections;
+AtomicInt64 acceptWakeups;
+AtomicInt64 acceptQueueDepth;
+AtomicInt64 maxAcceptQueueDepth;
+AtomicInt64 firstMessages;
+AtomicInt64 timeToFirstMessageMicros;
+
+#ifdef __linux__
+/**
+ * Returns the number of connections waiting to be accepted on the listening TCP socket 'sock',
+ * or -1 if it cannot be found, as for Unix domain sockets.
+ */
+long long getAcceptQueueDepth(SOCKET sock) {
+    struct tcp_info info;
+    socklen_t len = sizeof(info);
+    if (getsockopt(sock, IPPROTO_TCP, TCP_INFO, &info, &len) != 0) {
+        return -1;
+    }
+    // For a socket in the LISTEN state, this is the length of its accept queue.
+    return info.tcpi_unacked;
+}
+#endif
+
+}  // namespace
+
 const Listener* Listener::_timeTracker;
 
+Listener::Stats Listener::getStats() {
+    Stats stats;
+    stats.acceptThreads = std::max(1, listenerThreads);
+    stats.accepted = acceptedConnections.load();
+    stats.acceptWakeups = acceptWakeups.load();
+    stats.acceptQueueDepth = acceptQueueDepth.load();
+    stats.maxAcceptQueueDepth = maxAcceptQueueDepth.load();
+    stats.firstMessages = firstMessages.load();
+    stats.timeToFirstMessageMicros = timeToFirstMessageMicros.load();
+    return stats;
+}
+
+void Listener::recordTimeToFirstMessage(long long micros) {
+    firstMessages.fetchAndAdd(1);
+    timeToFirstMessageMicros.fetchAndAdd(micros);
+}
+
 vector<SockAddr> ipToAddrs(const char* ips, int port, bool useUnixSockets) {
     vector<SockAddr> out;
     if (*ips == '\0') {
@@ -147,6 +213,12 @@ void Listener::setupSockets() {
     _mine = ipToAddrs(_ip.c_str(), _port, false);
 #endif
 
+#if defined(__linux__) && defined(SO_REUSEPORT)
+    const int acceptors = std::max(1, listenerThreads);
+#else
+    const int acceptors = 1;
+#endif
+
     for (std::vector<SockAddr>::const_iterator it = _mine.begin(), end = _mine.end(); it != end;
          ++it) {
         const SockAddr& me = *it;
@@ -156,66 +228,226 @@ void Listener::setupSockets() {
             return;
         }
 
-        SOCKET sock = ::socket(me.getType(), SOCK_STREAM, 0);
-        ScopeGuard socketGuard = MakeGuard(&closesocket, sock);
-        massert(15863,
-                str::stream() << "listen(): invalid socket? " << errnoWithDescription(),
-                sock >= 0);
+        // Each acceptor gets its own socket for every TCP address. A Unix domain socket has a
+        // single path, so only the first acceptor listens on it.
+        const int copies = me.getType() == AF_UNIX ? 1 : acceptors;
+        for (int acceptor = 0; acceptor < copies; ++acceptor) {
+            if (!_setupSocket(me, acceptor, copies > 1)) {
+                return;
+            }
+        }
+    }
+
+    _setupSocketsSuccessful = true;
+}
+
+bool Listener::_setupSocket(const SockAddr& me, size_t acceptor, bool reusePort) {
+    SOCKET sock = ::socket(me.getType(), SOCK_STREAM, 0);
+    ScopeGuard socketGuard = MakeGuard(&closesocket, sock);
+    massert(15863,
+            str::stream() << "listen(): invalid socket? " << errnoWithDescription(),
+            sock >= 0);
 
-        if (me.getType() == AF_UNIX) {
+    if (me.getType() == AF_UNIX) {
 #if !defined(_WIN32)
-            if (unlink(me.getAddr().c_str()) == -1) {
-                if (errno != ENOENT) {
-                    error() << "Failed to unlink socket file " << me << " "
-                            << errnoWithDescription(errno);
-                    fassertFailedNoTrace(28578);
-                }
+        if (unlink(me.getAddr().c_str()) == -1) {
+            if (errno != ENOENT) {
+                error() << "Failed to unlink socket file " << me << " "
+                        << errnoWithDescription(errno);
+                fassertFailedNoTrace(28578);
             }
+        }
 #endif
-        } else if (me.getType() == AF_INET6) {
-            // IPv6 can also accept IPv4 connections as mapped addresses (::ffff:127.0.0.1)
-            // That causes a conflict if we don't do set it to IPV6_ONLY
-            const int one = 1;
-            setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&one, sizeof(one));
+    } else if (me.getType() == AF_INET6) {
+        // IPv6 can also accept IPv4 connections as mapped addresses (::ffff:127.0.0.1)
+        // That causes a conflict if we don't do set it to IPV6_ONLY
+        const int one = 1;
+        setsockopt(sock, IPPROTO_IPV6, IPV6_V6ONLY, (const char*)&one, sizeof(one));
+    }
+
+#if !defined(_WIN32)
+    {
+        const int one = 1;
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0)
+            log() << "Failed to set socket opt, SO_REUSEADDR" << endl;
+    }
+#endif
+
+#if defined(SO_REUSEPORT)
+    if (reusePort) {
+        const int one = 1;
+        if (setsockopt(sock, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) < 0) {
+            error() << "listen(): failed to set SO_REUSEPORT for socket: " << me.toString() << " "
+                    << errnoWithDescription();
+            return false;
         }
+    }
+#endif
+
+    if (::bind(sock, me.raw(), me.addressSize) != 0) {
+        int x = errno;
+        error() << "listen(): bind() failed " << errnoWithDescription(x)
+                << " for socket: " << me.toString() << endl;
+        if (x == EADDRINUSE)
+            error() << "  addr already in use" << endl;
+        return false;
+    }
 
 #if !defined(_WIN32)
-        {
-            const int one = 1;
-            if (setsockopt(sock, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) < 0)
-                log() << "Failed to set socket opt, SO_REUSEADDR" << endl;
+    if (me.getType() == AF_UNIX) {
+        if (chmod(me.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
+            error() << "Failed to chmod socket file " << me << " " << errnoWithDescription(errno);
+            fassertFailedNoTrace(28582);
         }
+        ListeningSockets::get()->addPath(me.getAddr());
+    }
 #endif
 
-        if (::bind(sock, me.raw(), me.addressSize) != 0) {
+    _socks.push_back(sock);
+    _sockAcceptors.push_back(acceptor);
+    socketGuard.Dismiss();
+    return true;
+}
+
+
+#if defined(__linux__)
+void Listener::initAndListen() {
+    if (!_setupSocketsSuccessful) {
+        return;
+    }
+
+    size_t acceptors = 0;
+    for (unsigned i = 0; i < _socks.size(); i++) {
+        if (::listen(_socks[i], listenBacklog) != 0) {
+            error() << "listen(): listen() failed " << errnoWithDescription() << endl;
+            return;
+        }
+
+        ListeningSockets::get()->add(_socks[i]);
+        acceptors = std::max(acceptors, _sockAcceptors[i] + 1);
+    }
+
+#ifdef MONGO_CONFIG_SSL
+    _logListen(_port, _ssl);
+#else
+    _logListen(_port, false);
+#endif
+
+    {
+        // Wake up any threads blocked in waitUntilListening()
+        stdx::lock_guard<stdx::mutex> lock(_readyMutex);
+        _ready = true;
+        _readyCondition.notify_all();
+    }
+
+    std::vector<stdx::thread> threads;
+    for (size_t acceptor = 1; acceptor < acceptors; ++acceptor) {
+        threads.emplace_back([this, acceptor] {
+            setThreadName(std::string(str::stream() << "listener" << acceptor));
+            _acceptLoop(acceptor);
+        });
+    }
+    _acceptLoop(0);
+    for (auto&& thread : threads) {
+        thread.join();
+    }
+}
+
+void Listener::_acceptLoop(size_t acceptor) {
+    const int epfd = epoll_create1(EPOLL_CLOEXEC);
+    if (epfd < 0) {
+        error() << "listen(): epoll_create1() failed " << errnoWithDescription() << endl;
+        return;
+    }
+    ON_BLOCK_EXIT(::close, epfd);
+
+    for (unsigned i = 0; i < _socks.size(); i++) {
+        if (_sockAcceptors[i] != acceptor) {
+            continue;
+        }
+
+        // Accepting until EAGAIN drains each socket's queue in one wakeup.
+        const int flags = fcntl(_socks[i], F_GETFL);
+        struct epoll_event event = {};
+        event.events = EPOLLIN;
+        event.data.fd = _socks[i];
+        if (flags < 0 || fcntl(_socks[i], F_SETFL, flags | O_NONBLOCK) < 0 ||
+            epoll_ctl(epfd, EPOLL_CTL_ADD, _socks[i], &event) != 0) {
+            error() << "listen(): failed to poll socket " << errnoWithDescription() << endl;
+            return;
+        }
+    }
+
+    // Only the first acceptor keeps the elapsed time, which it advances at least every 10ms.
+    const long long startMillis = curTimeMillis64();
+    struct epoll_event events[16];
+    while (!inShutdown()) {
+        const int ret = epoll_wait(epfd, events, 16, 10);
+        if (acceptor == 0) {
+            _elapsedTime = curTimeMillis64() - startMillis;
+        }
+
+        if (ret < 0) {
             int x = errno;
-            error() << "listen(): bind() failed " << errnoWithDescription(x)
-                    << " for socket: " << me.toString() << endl;
-            if (x == EADDRINUSE)
-                error() << "  addr already in use" << endl;
+            if (x == EINTR) {
+                continue;
+            }
+            if (!inShutdown())
+                log() << "epoll_wait() failure: " << errnoWithDescription(x) << endl;
             return;
         }
 
-#if !defined(_WIN32)
-        if (me.getType() == AF_UNIX) {
-            if (chmod(me.getAddr().c_str(), serverGlobalParams.unixSocketPermissions) == -1) {
-                error() << "Failed to chmod socket file " << me << " "
-                        << errnoWithDescription(errno);
-                fassertFailedNoTrace(28582);
+        for (int i = 0; i < ret; ++i) {
+            if (!_acceptBatch(events[i].data.fd)) {
+                return;
             }
-            ListeningSockets::get()->addPath(me.getAddr());
         }
-#endif
+    }
+}
+
+bool Listener::_acceptBatch(SOCKET sock) {
+    acceptWakeups.fetchAndAdd(1);
 
-        _socks.push_back(sock);
-        socketGuard.Dismiss();
+    const long long depth = getAcceptQueueDepth(sock);
+    if (depth >= 0) {
+        acceptQueueDepth.store(depth);
+        if (depth > maxAcceptQueueDepth.load()) {
+            maxAcceptQueueDepth.store(depth);
+        }
     }
 
-    _setupSocketsSuccessful = true;
+    for (size_t n = 0; n < kMaxAcceptBatch; ++n) {
+        SockAddr from;
+        int s = accept4(sock, from.raw(), &from.addressSize, SOCK_CLOEXEC);
+        if (s < 0) {
+            int x = errno;  // so no global issues
+            if (x == EAGAIN || x == EWOULDBLOCK) {
+                return true;
+            } else if (x == EBADF) {
+                log() << "Port " << _port << " is no longer valid" << endl;
+                return false;
+            } else if (x == ECONNABORTED || x == EINTR) {
+                continue;
+            }
+            if (inShutdown()) {
+                return false;
+            }
+            log() << "Listener: accept4() returns " << s << " " << errnoWithDescription(x)
+                  << endl;
+            if (x == EMFILE || x == ENFILE) {
+                // Connection still in listen queue but we can't accept it yet
+                error() << "Out of file descriptors. Waiting one second before trying to "
+                           "accept more connections." << warnings;
+                sleepsecs(1);
+            }
+            return true;
+        }
+        _accepted(s, from);
+    }
+    return true;
 }
 
-
-#if !defined(_WIN32)
+#elif !defined(_WIN32)
 void Listener::initAndListen() {
     if (!_setupSocketsSuccessful) {
         return;
@@ -223,7 +455,7 @@ void Listener::initAndListen() {
 
     SOCKET maxfd = 0;  // needed for select()
     for (unsigned i = 0; i < _socks.size(); i++) {
-        if (::listen(_socks[i], 128) != 0) {
+        if (::listen(_socks[i], listenBacklog) != 0) {
             error() << "listen(): listen() failed " << errnoWithDescription() << endl;
             return;
         }
@@ -268,11 +500,7 @@ void Listener::initAndListen() {
         const int ret = select(maxfd + 1, fds, NULL, NULL, &maxSelectTime);
 
         if (ret == 0) {
-#if defined(__linux__)
-            _elapsedTime += (10000 - maxSelectTime.tv_usec) / 1000;
-#else
             _elapsedTime += 10;
-#endif
             continue;
         }
 
@@ -289,11 +517,7 @@ void Listener::initAndListen() {
             return;
         }
 
-#if defined(__linux__)
-        _elapsedTime += std::max(ret, (int)((10000 - maxSelectTime.tv_usec) / 1000));
-#else
         _elapsedTime += ret;  // assume 1ms to grab connection. very rough
-#endif
 
         for (vector<SOCKET>::iterator it = _socks.begin(), end = _socks.end(); it != end; ++it) {
             if (!(FD_ISSET(*it, fds)))
@@ -324,33 +548,41 @@ void Listener::initAndListen() {
                 }
                 continue;
             }
-            if (from.getType() != AF_UNIX)
-                disableNagle(s);
+            _accepted(s, from);
+        }
+    }
+}
+#endif
+
+#if !defined(_WIN32)
+void Listener::_accepted(int s, const SockAddr& from) {
+    acceptedConnections.fetchAndAdd(1);
+
+    if (from.getType() != AF_UNIX)
+        disableNagle(s);
 
 #ifdef SO_NOSIGPIPE
-            // ignore SIGPIPE signals on osx, to avoid process exit
-            const int one = 1;
-            setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(int));
+    // ignore SIGPIPE signals on osx, to avoid process exit
+    const int one = 1;
+    setsockopt(s, SOL_SOCKET, SO_NOSIGPIPE, &one, sizeof(int));
 #endif
 
-            long long myConnectionNumber = globalConnectionNumber.addAndFetch(1);
+    long long myConnectionNumber = globalConnectionNumber.addAndFetch(1);
 
-            if (_logConnect && !serverGlobalParams.quiet) {
-                int conns = globalTicketHolder.used() + 1;
-                const char* word = (conns == 1 ? " connection" : " connections");
-                log() << "connection accepted from " << from.toString() << " #"
-                      << myConnectionNumber << " (" << conns << word << " now open)" << endl;
-            }
+    if (_logConnect && !serverGlobalParams.quiet) {
+        int conns = globalTicketHolder.used() + 1;
+        const char* word = (conns == 1 ? " connection" : " connections");
+        log() << "connection accepted from " << from.toString() << " #" << myConnectionNumber
+              << " (" << conns << word << " now open)" << endl;
+    }
 
-            std::shared_ptr<Socket> pnewSock(new Socket(s, from));
+    std::shared_ptr<Socket> pnewSock(new Socket(s, from));
 #ifdef MONGO_CONFIG_SSL
-            if (_ssl) {
-                pnewSock->secureAccepted(_ssl);
-            }
-#endif
-            accepted(pnewSock, myConnectionNumber);
-        }
+    if (_ssl) {
+        pnewSock->secureAccepted(_ssl);
     }
+#endif
+    accepted(pnewSock, myConnectionNumber);
 }
 
 #else
@@ -411,7 +643,7 @@ void Listener::initAndListen() {
     }
 
     for (unsigned i = 0; i < _socks.size(); i++) {
-        if (::listen(_socks[i], 128) != 0) {
+        if (::listen(_socks[i], listenBacklog) != 0) {
             error() << "listen(): listen() failed " << errnoWithDescription() << endl;
             return;
         }
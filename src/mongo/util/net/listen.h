@@ -108,9 +108,61 @@ public:
      */
     void waitUntilListening() const;
 
+    /**
+     * Counters of the listeners of this process, reported in serverStatus.
+     */
+    struct Stats {
+        int acceptThreads = 0;
+        long long accepted = 0;
+        // Wakeups of an acceptor for a socket with connections to accept. accepted/acceptWakeups
+        // is the number of connections accepted per wakeup.
+        long long acceptWakeups = 0;
+        // Connections waiting to be accepted on the last socket an acceptor woke up for, and the
+        // most seen. Only kept on Linux.
+        long long acceptQueueDepth = 0;
+        long long maxAcceptQueueDepth = 0;
+        // Connections which have received their first message, and their total time from being
+        // accepted until then.
+        long long firstMessages = 0;
+        long long timeToFirstMessageMicros = 0;
+    };
+
+    static Stats getStats();
+
+    /**
+     * Records that a connection received its first message 'micros' after being accepted.
+     */
+    static void recordTimeToFirstMessage(long long micros);
+
 private:
+    /**
+     * Creates, binds and records a listening socket for 'me' served by the acceptor thread
+     * numbered 'acceptor', setting SO_REUSEPORT if 'reusePort' is set. Returns false on failure.
+     */
+    bool _setupSocket(const SockAddr& me, size_t acceptor, bool reusePort);
+
+    /**
+     * Sets up the socket 's' accepted from 'from' and hands it to accepted().
+     */
+    void _accepted(int s, const SockAddr& from);
+
+#if defined(__linux__)
+    /**
+     * Accepts connections on the sockets of acceptor thread 'acceptor' until shutdown.
+     */
+    void _acceptLoop(size_t acceptor);
+
+    /**
+     * Accepts the connections waiting on 'sock', up to a bound. Returns false if the listener
+     * should stop.
+     */
+    bool _acceptBatch(SOCKET sock);
+#endif
+
     std::vector<SockAddr> _mine;
     std::vector<SOCKET> _socks;
+    // The acceptor thread serving each element of _socks.
+    std::vector<size_t> _sockAcceptors;
     std::string _name;
     std::string _ip;
     bool _setupSocketsSuccessful;
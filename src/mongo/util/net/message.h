@@ -36,6 +36,7 @@
 #include "mongo/base/data_view.h"
 #include "mongo/base/disallow_copying.h"
 #include "mongo/base/encoded_value_storage.h"
+#include "mongo/bson/bsonobj.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/util/allocator.h"
 #include "mongo/util/mongoutils/str.h"
@@ -67,6 +68,7 @@ enum Operations {
     dbKillCursors = 2007,
     dbCommand = 2008,
     dbCommandReply = 2009,
+    dbCompressed = 2012, /* wraps another message; see MessageCompressorManager */
 };
 
 bool doesOpGetAResponse(int op);
@@ -95,6 +97,8 @@ inline const char* opToString(int op) {
             return "command";
         case dbCommandReply:
             return "commandReply";
+        case dbCompressed:
+            return "compressed";
         default:
             massert(16141, str::stream() << "cannot translate opcode " << op, !op);
             return "";
@@ -420,6 +424,8 @@ public:
         r._buf = 0;
         if (r._data.size() > 0) {
             _data.swap(r._data);
+            _referenced.swap(r._referenced);
+            _references.swap(r._references);
         }
         r._freeIt = false;
         _freeIt = true;
@@ -431,14 +437,16 @@ public:
             if (_buf) {
                 free(_buf);
             }
-            for (std::vector<std::pair<char*, int>>::const_iterator i = _data.begin();
-                 i != _data.end();
-                 ++i) {
-                free(i->first);
+            for (size_t i = 0; i < _data.size(); ++i) {
+                if (!_isReference(i)) {
+                    free(_data[i].first);
+                }
             }
         }
         _buf = 0;
         _data.clear();
+        _referenced.clear();
+        _references.clear();
         _freeIt = false;
     }
 
@@ -455,12 +463,23 @@ public:
             return;
         }
         verify(_freeIt);
-        if (_buf) {
-            _data.push_back(std::make_pair(_buf, MsgData::ConstView(_buf).getLen()));
-            _buf = 0;
-        }
-        _data.push_back(std::make_pair(d, size));
-        header().setLen(header().getLen() + size);
+        _appendBuffer(d, size, false);
+    }
+
+    // use to add the contents of an owned BSONObj without copying it. The message keeps a
+    // reference to 'obj' for as long as it holds the buffer instead of freeing it.
+    // The message must already contain a header buffer.
+    void appendReference(const BSONObj& obj) {
+        verify(!empty());
+        verify(_freeIt);
+        invariant(obj.isOwned());
+        _appendBuffer(const_cast<char*>(obj.objdata()), obj.objsize(), true);
+        _references.push_back(obj);
+    }
+
+    // number of buffers which will be handed to the socket when this message is sent
+    size_t numBuffers() const {
+        return _buf ? 1 : _data.size();
     }
 
     // use to set first buffer if empty
@@ -498,12 +517,36 @@ private:
         _freeIt = freeIt;
         _buf = d;
     }
+
+    void _appendBuffer(char* d, int size, bool isReference) {
+        if (_buf) {
+            _data.push_back(std::make_pair(_buf, MsgData::ConstView(_buf).getLen()));
+            _buf = 0;
+        }
+        if (isReference && _referenced.empty()) {
+            _referenced.resize(_data.size(), false);
+        }
+        _data.push_back(std::make_pair(d, size));
+        if (!_referenced.empty()) {
+            _referenced.push_back(isReference);
+        }
+        header().setLen(header().getLen() + size);
+    }
+
+    bool _isReference(size_t i) const {
+        return i < _referenced.size() && _referenced[i];
+    }
+
     // if just one buffer, keep it in _buf, otherwise keep a sequence of buffers in _data
     char* _buf;
     // byte buffer(s) - the first must contain at least a full MsgData unless using _buf for storage
     // instead
     typedef std::vector<std::pair<char*, int>> MsgVec;
     MsgVec _data;
+    // parallel to _data once a buffer has been added with appendReference(); such buffers are
+    // kept alive by _references rather than freed by the message
+    std::vector<bool> _referenced;
+    std::vector<BSONObj> _references;
     bool _freeIt;
 };
 
@@ -0,0 +1,403 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_compressor.h"
+
+#include <cstring>
+#include <snappy.h>
+#include <zlib.h>
+
+#include "mongo/base/data_view.h"
+#include "mongo/bson/util/builder.h"
+#include "mongo/db/jsobj.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/util/assert_util.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/stringutils.h"
+
+namespace mongo {
+
+namespace {
+
+const char kCompressionField[] = "compression";
+const char kDisabled[] = "disabled";
+
+class NoopMessageCompressor final : public MessageCompressorBase {
+public:
+    NoopMessageCompressor() : MessageCompressorBase(MessageCompressorId::kNoop, "noop") {}
+
+    std::size_t getMaxCompressedSize(std::size_t inputSize) override {
+        return inputSize;
+    }
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override {
+        return _copy(input, output);
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        return _copy(input, output);
+    }
+
+private:
+    static StatusWith<std::size_t> _copy(ConstDataRange input, DataRange output) {
+        if (output.length() < input.length()) {
+            return {ErrorCodes::BadValue, "output buffer too small"};
+        }
+        memcpy(const_cast<char*>(output.data()), input.data(), input.length());
+        return input.length();
+    }
+};
+
+class SnappyMessageCompressor final : public MessageCompressorBase {
+public:
+    SnappyMessageCompressor() : MessageCompressorBase(MessageCompressorId::kSnappy, "snappy") {}
+
+    std::size_t getMaxCompressedSize(std::size_t inputSize) override {
+        return snappy::MaxCompressedLength(inputSize);
+    }
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override {
+        invariant(output.length() >= getMaxCompressedSize(input.length()));
+        std::size_t outLength;
+        snappy::RawCompress(
+            input.data(), input.length(), const_cast<char*>(output.data()), &outLength);
+        return outLength;
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        std::size_t expectedLength;
+        if (!snappy::GetUncompressedLength(input.data(), input.length(), &expectedLength) ||
+            expectedLength > output.length()) {
+            return {ErrorCodes::BadValue, "invalid uncompressed length in snappy data"};
+        }
+        if (!snappy::RawUncompress(
+                input.data(), input.length(), const_cast<char*>(output.data()))) {
+            return {ErrorCodes::BadValue, "invalid snappy compressed data"};
+        }
+        return expectedLength;
+    }
+};
+
+class ZlibMessageCompressor final : public MessageCompressorBase {
+public:
+    ZlibMessageCompressor() : MessageCompressorBase(MessageCompressorId::kZlib, "zlib") {}
+
+    // The bundled zlib only provides the stream interface, so compress2()/uncompress() and
+    // compressBound() are not available and their equivalents are implemented here.
+    std::size_t getMaxCompressedSize(std::size_t inputSize) override {
+        // Same bound as zlib's compressBound().
+        return inputSize + (inputSize >> 12) + (inputSize >> 14) + (inputSize >> 25) + 13;
+    }
+
+    StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) override {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        int err = ::deflateInit(&stream, Z_DEFAULT_COMPRESSION);
+        if (err != Z_OK) {
+            return {ErrorCodes::ZLibError, str::stream() << "deflateInit failed with " << err};
+        }
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream.avail_in = input.length();
+        stream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(output.data()));
+        stream.avail_out = output.length();
+
+        err = ::deflate(&stream, Z_FINISH);
+        const std::size_t outLength = stream.total_out;
+        ::deflateEnd(&stream);
+        if (err != Z_STREAM_END) {
+            return {ErrorCodes::ZLibError, str::stream() << "deflate failed with " << err};
+        }
+        return outLength;
+    }
+
+    StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) override {
+        z_stream stream;
+        memset(&stream, 0, sizeof(stream));
+        int err = ::inflateInit(&stream);
+        if (err != Z_OK) {
+            return {ErrorCodes::ZLibError, str::stream() << "inflateInit failed with " << err};
+        }
+
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream.avail_in = input.length();
+        stream.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(output.data()));
+        stream.avail_out = output.length();
+
+        err = ::inflate(&stream, Z_FINISH);
+        const std::size_t outLength = stream.total_out;
+        ::inflateEnd(&stream);
+        if (err != Z_STREAM_END) {
+            return {ErrorCodes::ZLibError, str::stream() << "inflate failed with " << err};
+        }
+        return outLength;
+    }
+};
+
+StatusWith<std::vector<std::string>> parseCompressorNames(const std::string& value) {
+    std::vector<std::string> names;
+    if (value == kDisabled) {
+        return names;
+    }
+    splitStringDelim(value, &names, ',');
+    for (const auto& name : names) {
+        if (name == kDisabled) {
+            return {ErrorCodes::BadValue,
+                    str::stream() << "'" << kDisabled << "' cannot be combined with compressors"};
+        }
+    }
+    return names;
+}
+
+std::string networkMessageCompressors = "snappy";
+
+class ExportedMessageCompressorsParameter : public ExportedServerParameter<std::string> {
+public:
+    ExportedMessageCompressorsParameter()
+        : ExportedServerParameter<std::string>(ServerParameterSet::getGlobal(),
+                                               "networkMessageCompressors",
+                                               &networkMessageCompressors,
+                                               true,   // allowedToChangeAtStartup
+                                               false)  // allowedToChangeAtRuntime
+    {}
+
+    Status set(const std::string& newValue) override {
+        auto swNames = parseCompressorNames(newValue);
+        if (!swNames.isOK()) {
+            return swNames.getStatus();
+        }
+        Status status =
+            MessageCompressorRegistry::get().setEnabledNames(std::move(swNames.getValue()));
+        if (!status.isOK()) {
+            return status;
+        }
+        return ExportedServerParameter<std::string>::set(newValue);
+    }
+
+    Status setFromString(const std::string& str) override {
+        return set(str);
+    }
+} exportedMessageCompressorsParameter;
+
+}  // namespace
+
+MessageCompressorRegistry::MessageCompressorRegistry() {
+    _compressors.push_back(stdx::make_unique<NoopMessageCompressor>());
+    _compressors.push_back(stdx::make_unique<SnappyMessageCompressor>());
+    _compressors.push_back(stdx::make_unique<ZlibMessageCompressor>());
+
+    auto swNames = parseCompressorNames(networkMessageCompressors);
+    fassert(28807, swNames.getStatus());
+    fassert(28808, setEnabledNames(std::move(swNames.getValue())));
+}
+
+MessageCompressorRegistry& MessageCompressorRegistry::get() {
+    static MessageCompressorRegistry registry;
+    return registry;
+}
+
+MessageCompressorBase* MessageCompressorRegistry::getCompressor(StringData name) const {
+    for (const auto& enabledName : _enabledNames) {
+        if (enabledName == name) {
+            for (const auto& compressor : _compressors) {
+                if (compressor->getName() == name) {
+                    return compressor.get();
+                }
+            }
+        }
+    }
+    return nullptr;
+}
+
+MessageCompressorBase* MessageCompressorRegistry::getCompressor(MessageCompressorId id) const {
+    for (const auto& compressor : _compressors) {
+        if (compressor->getId() == id) {
+            return getCompressor(compressor->getName());
+        }
+    }
+    return nullptr;
+}
+
+Status MessageCompressorRegistry::setEnabledNames(std::vector<std::string> names) {
+    for (const auto& name : names) {
+        bool known = false;
+        for (const auto& compressor : _compressors) {
+            known = known || compressor->getName() == name;
+        }
+        if (!known) {
+            return {ErrorCodes::BadValue, str::stream() << "unknown message compressor: " << name};
+        }
+    }
+    _enabledNames = std::move(names);
+    return Status::OK();
+}
+
+void MessageCompressorManager::clientBegin(BSONObjBuilder* isMasterCmd) const {
+    const auto& names = MessageCompressorRegistry::get().getEnabledNames();
+    if (names.empty()) {
+        return;
+    }
+    BSONArrayBuilder arr(isMasterCmd->subarrayStart(kCompressionField));
+    for (const auto& name : names) {
+        arr.append(name);
+    }
+    arr.doneFast();
+}
+
+void MessageCompressorManager::clientFinish(const BSONObj& isMasterReply) {
+    _negotiated = nullptr;
+    BSONElement elem = isMasterReply[kCompressionField];
+    if (elem.type() != Array) {
+        return;
+    }
+    for (const auto& nameElem : elem.Obj()) {
+        if (nameElem.type() != String) {
+            continue;
+        }
+        if (auto compressor = MessageCompressorRegistry::get().getCompressor(nameElem.String())) {
+            _negotiated = compressor;
+            return;
+        }
+    }
+}
+
+void MessageCompressorManager::serverNegotiate(const BSONObj& isMasterCmd,
+                                               BSONObjBuilder* isMasterReply) {
+    BSONElement elem = isMasterCmd[kCompressionField];
+    if (elem.type() != Array) {
+        return;
+    }
+    BSONArrayBuilder arr(isMasterReply->subarrayStart(kCompressionField));
+    for (const auto& nameElem : elem.Obj()) {
+        if (nameElem.type() == String &&
+            MessageCompressorRegistry::get().getCompressor(nameElem.String())) {
+            arr.append(nameElem.String());
+        }
+    }
+    arr.doneFast();
+}
+
+MessageCompressorBase* MessageCompressorManager::getOutgoingCompressor() const {
+    return _negotiated ? _negotiated : _lastReceived;
+}
+
+Status MessageCompressorManager::compressMessage(const Message& msg, Message* out) const {
+    MessageCompressorBase* compressor = getOutgoingCompressor();
+    invariant(compressor);
+    invariant(msg.buf());
+
+    MsgData::ConstView input(msg.buf());
+    const std::size_t inputSize = input.dataLen();
+    const std::size_t bufferSize =
+        MsgData::MsgDataHeaderSize + kCompressionHeaderSize + compressor->getMaxCompressedSize(inputSize);
+
+    char* buf = reinterpret_cast<char*>(mongoMalloc(bufferSize));
+    Message compressed(buf, true);
+
+    MsgData::View output(buf);
+    output.setId(input.getId());
+    output.setResponseTo(input.getResponseTo());
+    output.setOperation(dbCompressed);
+
+    DataView(output.data()).write<LittleEndian<int32_t>>(input.getOperation(), 0);
+    DataView(output.data()).write<LittleEndian<int32_t>>(inputSize, 4);
+    DataView(output.data()).write<uint8_t>(static_cast<uint8_t>(compressor->getId()), 8);
+
+    char* payload = output.data() + kCompressionHeaderSize;
+    auto swLength = compressor->compressData(ConstDataRange(input.data(), inputSize),
+                                             DataRange(payload, buf + bufferSize));
+    if (!swLength.isOK()) {
+        return swLength.getStatus();
+    }
+    output.setLen(MsgData::MsgDataHeaderSize + kCompressionHeaderSize + swLength.getValue());
+
+    *out = std::move(compressed);
+    return Status::OK();
+}
+
+Status MessageCompressorManager::decompressMessage(Message* msg) {
+    if (msg->operation() != dbCompressed) {
+        _lastReceived = nullptr;
+        return Status::OK();
+    }
+
+    MsgData::ConstView input(msg->singleData().view2ptr());
+    if (input.dataLen() < static_cast<int>(kCompressionHeaderSize)) {
+        return {ErrorCodes::BadValue, "compressed message is too short"};
+    }
+
+    const int32_t originalOp = ConstDataView(input.data()).read<LittleEndian<int32_t>>();
+    const int32_t originalSize = ConstDataView(input.data()).read<LittleEndian<int32_t>>(4);
+    const uint8_t compressorId = ConstDataView(input.data()).read<uint8_t>(8);
+
+    if (originalSize < 0 ||
+        static_cast<std::size_t>(originalSize) + MsgData::MsgDataHeaderSize > MaxMessageSizeBytes) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "invalid uncompressed message size " << originalSize};
+    }
+
+    MessageCompressorBase* compressor = MessageCompressorRegistry::get().getCompressor(
+        static_cast<MessageCompressorId>(compressorId));
+    if (!compressor) {
+        return {ErrorCodes::BadValue,
+                str::stream() << "message compressed with unsupported compressor id "
+                              << static_cast<int>(compressorId)};
+    }
+
+    const std::size_t bufferSize = MsgData::MsgDataHeaderSize + originalSize;
+    char* buf = reinterpret_cast<char*>(mongoMalloc(bufferSize));
+    Message decompressed(buf, true);
+
+    MsgData::View output(buf);
+    output.setLen(bufferSize);
+    output.setId(input.getId());
+    output.setResponseTo(input.getResponseTo());
+    output.setOperation(originalOp);
+
+    auto swLength = compressor->decompressData(
+        ConstDataRange(input.data() + kCompressionHeaderSize,
+                       input.data() + input.dataLen()),
+        DataRange(output.data(), buf + bufferSize));
+    if (!swLength.isOK()) {
+        return swLength.getStatus();
+    }
+    if (swLength.getValue() != static_cast<std::size_t>(originalSize)) {
+        return {ErrorCodes::BadValue, "decompressed message has the wrong size"};
+    }
+
+    msg->reset();
+    *msg = std::move(decompressed);
+    _lastReceived = compressor;
+    return Status::OK();
+}
+
+}  // namespace mongo
@@ -0,0 +1,212 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "mongo/base/data_range.h"
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+
+namespace mongo {
+
+class BSONObj;
+class BSONObjBuilder;
+class Message;
+
+/**
+ * Identifies the algorithm used for a compressed message on the wire. These values are part of
+ * the wire protocol and must never change.
+ */
+enum class MessageCompressorId : uint8_t {
+    kNoop = 0,
+    kSnappy = 1,
+    kZlib = 2,
+};
+
+/**
+ * A compression algorithm usable for wire protocol messages.
+ */
+class MessageCompressorBase {
+    MONGO_DISALLOW_COPYING(MessageCompressorBase);
+
+public:
+    virtual ~MessageCompressorBase() = default;
+
+    const std::string& getName() const {
+        return _name;
+    }
+
+    MessageCompressorId getId() const {
+        return _id;
+    }
+
+    /**
+     * Returns an upper bound on the size of the output of compressData() for an input of
+     * "inputSize" bytes.
+     */
+    virtual std::size_t getMaxCompressedSize(std::size_t inputSize) = 0;
+
+    /**
+     * Compresses "input" into "output", which must be at least getMaxCompressedSize() bytes
+     * long, and returns the number of bytes written.
+     */
+    virtual StatusWith<std::size_t> compressData(ConstDataRange input, DataRange output) = 0;
+
+    /**
+     * Decompresses "input" into "output", and returns the number of bytes written. Fails if the
+     * decompressed data does not fit in "output".
+     */
+    virtual StatusWith<std::size_t> decompressData(ConstDataRange input, DataRange output) = 0;
+
+protected:
+    MessageCompressorBase(MessageCompressorId id, std::string name)
+        : _id(id), _name(std::move(name)) {}
+
+private:
+    const MessageCompressorId _id;
+    const std::string _name;
+};
+
+/**
+ * The set of compressors this process may use, in order of preference. The list is controlled by
+ * the "networkMessageCompressors" server parameter, a comma separated list of compressor names,
+ * or "disabled".
+ */
+class MessageCompressorRegistry {
+    MONGO_DISALLOW_COPYING(MessageCompressorRegistry);
+
+public:
+    MessageCompressorRegistry();
+
+    static MessageCompressorRegistry& get();
+
+    /**
+     * Returns the names of the enabled compressors, most preferred first.
+     */
+    const std::vector<std::string>& getEnabledNames() const {
+        return _enabledNames;
+    }
+
+    /**
+     * Returns the enabled compressor with the given name or id, or nullptr if there is none.
+     */
+    MessageCompressorBase* getCompressor(StringData name) const;
+    MessageCompressorBase* getCompressor(MessageCompressorId id) const;
+
+    /**
+     * Replaces the enabled compressor list; each name must refer to a known compressor.
+     */
+    Status setEnabledNames(std::vector<std::string> names);
+
+private:
+    std::vector<std::unique_ptr<MessageCompressorBase>> _compressors;
+    std::vector<std::string> _enabledNames;
+};
+
+/**
+ * Per-connection compression state.
+ *
+ * Negotiation piggybacks on isMaster: the client lists the compressors it supports in a
+ * "compression" array, and the server replies with the subset it supports. The client then
+ * compresses every request with the first compressor in the reply. A server never compresses a
+ * reply to an uncompressed request, and compresses a reply with the same compressor as the
+ * request, so it needs no negotiated state of its own. Peers which do not understand the
+ * "compression" field ignore it, and never receive a compressed message.
+ *
+ * Compressed messages have the dbCompressed opcode, and the body:
+ *
+ *     int32  opcode of the original message
+ *     int32  length of the original message body (excluding the standard header)
+ *     uint8  MessageCompressorId
+ *     bytes  compressed original body
+ *
+ * The header's requestID and responseTo are those of the original message.
+ */
+class MessageCompressorManager {
+    MONGO_DISALLOW_COPYING(MessageCompressorManager);
+
+public:
+    static constexpr std::size_t kCompressionHeaderSize = 9;
+
+    MessageCompressorManager() = default;
+    MessageCompressorManager(MessageCompressorManager&&) = default;
+    MessageCompressorManager& operator=(MessageCompressorManager&&) = default;
+
+    /**
+     * Appends the "compression" field to an outgoing isMaster request.
+     */
+    void clientBegin(BSONObjBuilder* isMasterCmd) const;
+
+    /**
+     * Processes the server's isMaster reply, enabling compression of outgoing requests if the
+     * server listed a compressor this process supports.
+     */
+    void clientFinish(const BSONObj& isMasterReply);
+
+    /**
+     * Appends the compressors common to this server and the client's isMaster request, in the
+     * client's order of preference, to the isMaster reply. Appends nothing if the client did not
+     * ask for compression.
+     */
+    static void serverNegotiate(const BSONObj& isMasterCmd, BSONObjBuilder* isMasterReply);
+
+    /**
+     * Returns the compressor to use for the next outgoing message, or nullptr if it should be sent
+     * uncompressed.
+     */
+    MessageCompressorBase* getOutgoingCompressor() const;
+
+    /**
+     * Compresses "msg", which must consist of a single buffer, into "out" with
+     * getOutgoingCompressor(), which must not be null.
+     */
+    Status compressMessage(const Message& msg, Message* out) const;
+
+    /**
+     * If "msg" is compressed, replaces it with its decompressed contents and remembers the
+     * compressor so that the reply may use it too. An uncompressed "msg" is left alone and makes
+     * the next reply uncompressed.
+     */
+    Status decompressMessage(Message* msg);
+
+private:
+    // Set on the client side by clientFinish().
+    MessageCompressorBase* _negotiated = nullptr;
+
+    // Set on the server side by decompressMessage().
+    MessageCompressorBase* _lastReceived = nullptr;
+};
+
+}  // namespace mongo
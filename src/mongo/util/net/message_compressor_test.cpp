@@ -0,0 +1,162 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/db/jsobj.h"
+#include "mongo/unittest/unittest.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
+
+namespace mongo {
+namespace {
+
+void makeQueryMessage(Message* msg, StringData payload) {
+    std::string body;
+    for (int i = 0; i < 100; ++i) {
+        body += payload.toString();
+    }
+    msg->setData(dbQuery, body.c_str(), body.size() + 1);
+    msg->header().setId(1234);
+    msg->header().setResponseTo(5678);
+}
+
+void checkRoundTrip(StringData compressorName) {
+    MessageCompressorManager client;
+    BSONObjBuilder reply;
+    reply.append("compression", BSON_ARRAY(compressorName));
+    client.clientFinish(reply.obj());
+    ASSERT(client.getOutgoingCompressor());
+    ASSERT_EQUALS(compressorName, client.getOutgoingCompressor()->getName());
+
+    Message original;
+    makeQueryMessage(&original, "abcdefghij");
+
+    Message compressed;
+    ASSERT_OK(client.compressMessage(original, &compressed));
+    ASSERT_EQUALS(dbCompressed, compressed.operation());
+    ASSERT_EQUALS(original.header().getId(), compressed.header().getId());
+    ASSERT_EQUALS(original.header().getResponseTo(), compressed.header().getResponseTo());
+    ASSERT_LESS_THAN(compressed.size(), original.size());
+
+    MessageCompressorManager server;
+    ASSERT_FALSE(server.getOutgoingCompressor());
+    ASSERT_OK(server.decompressMessage(&compressed));
+    ASSERT_EQUALS(dbQuery, compressed.operation());
+    ASSERT_EQUALS(original.size(), compressed.size());
+    ASSERT_EQUALS(0, memcmp(original.buf(), compressed.buf(), original.size()));
+
+    // The server answers in kind, until it sees an uncompressed request.
+    ASSERT(server.getOutgoingCompressor());
+    ASSERT_EQUALS(compressorName, server.getOutgoingCompressor()->getName());
+    ASSERT_OK(server.decompressMessage(&original));
+    ASSERT_FALSE(server.getOutgoingCompressor());
+}
+
+TEST(MessageCompressor, SnappyRoundTrip) {
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"snappy"}));
+    checkRoundTrip("snappy");
+}
+
+TEST(MessageCompressor, ZlibRoundTrip) {
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"zlib"}));
+    checkRoundTrip("zlib");
+}
+
+TEST(MessageCompressor, UnknownCompressorName) {
+    ASSERT_NOT_OK(MessageCompressorRegistry::get().setEnabledNames({"lz77"}));
+}
+
+TEST(MessageCompressor, NegotiationPicksCommonCompressorInClientOrder) {
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"snappy", "zlib"}));
+
+    BSONObj cmd = BSON("isMaster" << 1 << "compression" << BSON_ARRAY("lz77"
+                                                                      << "zlib"
+                                                                      << "snappy"));
+    BSONObjBuilder reply;
+    MessageCompressorManager::serverNegotiate(cmd, &reply);
+    BSONObj replyObj = reply.obj();
+    ASSERT_EQUALS(BSON("compression" << BSON_ARRAY("zlib"
+                                                   << "snappy")),
+                  replyObj);
+
+    MessageCompressorManager client;
+    client.clientFinish(replyObj);
+    ASSERT(client.getOutgoingCompressor());
+    ASSERT_EQUALS("zlib", client.getOutgoingCompressor()->getName());
+}
+
+TEST(MessageCompressor, NoNegotiationWithoutCompressionField) {
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"snappy"}));
+
+    BSONObjBuilder reply;
+    MessageCompressorManager::serverNegotiate(BSON("isMaster" << 1), &reply);
+    ASSERT_EQUALS(BSONObj(), reply.obj());
+
+    MessageCompressorManager client;
+    client.clientFinish(BSON("ismaster" << true));
+    ASSERT_FALSE(client.getOutgoingCompressor());
+}
+
+TEST(MessageCompressor, DisabledCompressorIsRejectedOnReceipt) {
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"snappy", "zlib"}));
+
+    MessageCompressorManager client;
+    client.clientFinish(BSON("compression" << BSON_ARRAY("zlib")));
+
+    Message original;
+    makeQueryMessage(&original, "0123456789");
+    Message compressed;
+    ASSERT_OK(client.compressMessage(original, &compressed));
+
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"snappy"}));
+    MessageCompressorManager server;
+    ASSERT_NOT_OK(server.decompressMessage(&compressed));
+}
+
+TEST(MessageCompressor, CorruptPayloadIsRejected) {
+    ASSERT_OK(MessageCompressorRegistry::get().setEnabledNames({"snappy"}));
+
+    MessageCompressorManager client;
+    client.clientFinish(BSON("compression" << BSON_ARRAY("snappy")));
+
+    Message original;
+    makeQueryMessage(&original, "0123456789");
+    Message compressed;
+    ASSERT_OK(client.compressMessage(original, &compressed));
+
+    // Claim a larger uncompressed size than the payload produces.
+    char* body = compressed.buf() + MsgData::MsgDataHeaderSize;
+    DataView(body).write<LittleEndian<int32_t>>(original.dataSize() + 1, 4);
+
+    MessageCompressorManager server;
+    ASSERT_NOT_OK(server.decompressMessage(&compressed));
+}
+
+}  // namespace
+}  // namespace mongo
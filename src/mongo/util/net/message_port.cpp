@@ -197,6 +197,13 @@ bool MessagingPort::recv(Message& m) {
 
         guard.Dismiss();
         m.setData(md.view2ptr(), true);
+
+        Status status = _compressorManager.decompressMessage(&m);
+        if (!status.isOK()) {
+            LOG(0) << "recv(): failed to decompress message from " << remote() << ": " << status;
+            m.reset();
+            return false;
+        }
         return true;
 
     } catch (const SocketException& e) {
@@ -250,6 +257,18 @@ void MessagingPort::say(Message& toSend, int responseTo) {
     mmm(log() << "*  say()  thr:" << GetCurrentThreadId() << endl;)
         toSend.header().setId(nextMessageId());
     toSend.header().setResponseTo(responseTo);
+
+    // Multi-buffer messages are sent as they are rather than paying for a concatenation.
+    if (_compressorManager.getOutgoingCompressor() && toSend.buf() &&
+        toSend.operation() != dbCompressed) {
+        Message compressed;
+        Status status = _compressorManager.compressMessage(toSend, &compressed);
+        if (status.isOK()) {
+            compressed.send(*this, "say");
+            return;
+        }
+        LOG(1) << "failed to compress message, sending it uncompressed: " << status;
+    }
     toSend.send(*this, "say");
 }
 
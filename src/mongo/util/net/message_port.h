@@ -34,6 +34,7 @@
 #include "mongo/config.h"
 #include "mongo/util/net/abstract_message_port.h"
 #include "mongo/util/net/message.h"
+#include "mongo/util/net/message_compressor.h"
 #include "mongo/util/net/sock.h"
 
 namespace mongo {
@@ -55,7 +56,7 @@ public:
 
     void setSocketTimeout(double timeout);
 
-    void shutdown();
+    virtual void shutdown();
 
     /* it's assumed if you reuse a message object, that it doesn't cross MessagingPort's.
        also, the Message data will go out of scope on the subsequent recv call.
@@ -117,7 +118,17 @@ public:
         return psock->getSockCreationMicroSec();
     }
 
+    /**
+     * State of wire protocol compression on this port. recv() transparently decompresses
+     * incoming messages and say() compresses outgoing ones as the manager directs.
+     */
+    MessageCompressorManager& compressorManager() {
+        return _compressorManager;
+    }
+
 private:
+    MessageCompressorManager _compressorManager;
+
     // this is the parsed version of remote
     // mutable because its initialized only on call to remote()
     mutable HostAndPort _remoteParsed;
@@ -34,10 +34,15 @@
 
 #pragma once
 
+#include <string>
+
 #include "mongo/platform/basic.h"
 
 namespace mongo {
 
+class AbstractMessagingPort;
+class Message;
+
 class MessageHandler {
 public:
     virtual ~MessageHandler() {}
@@ -69,6 +74,9 @@ public:
     virtual void setupSockets() = 0;
 };
 
-// TODO use a factory here to decide between port and asio variations
+/**
+ * Creates the server selected by the "inboundNetworkImpl" server parameter: one thread per
+ * connection by default, or ASIO-multiplexed sockets with a bounded worker pool.
+ */
 MessageServer* createServer(const MessageServer::Options& opts, MessageHandler* handler);
 }
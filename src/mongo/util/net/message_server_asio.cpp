@@ -0,0 +1,541 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kNetwork
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/net/message_server_asio.h"
+
+#ifndef _WIN32
+#include <asio.hpp>
+#include <sys/socket.h>
+#endif
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/init.h"
+#include "mongo/config.h"
+#include "mongo/db/client.h"
+#include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
+#include "mongo/db/stats/counters.h"
+#include "mongo/stdx/memory.h"
+#include "mongo/stdx/thread.h"
+#include "mongo/util/allocator.h"
+#include "mongo/util/concurrency/synchronization.h"
+#include "mongo/util/concurrency/thread_name.h"
+#include "mongo/util/concurrency/thread_pool.h"
+#include "mongo/util/concurrency/ticketholder.h"
+#include "mongo/util/exit.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/net/listen.h"
+#include "mongo/util/net/message.h"
+#include "mongo/util/net/message_port.h"
+#include "mongo/util/net/ssl_options.h"
+#include "mongo/util/scopeguard.h"
+#include "mongo/util/time_support.h"
+
+namespace mongo {
+
+namespace {
+
+const char kInboundNetworkImplThreadPerConnection[] = "threadPerConnection";
+const char kInboundNetworkImplASIO[] = "ASIO";
+
+}  // namespace
+
+MONGO_EXPORT_STARTUP_SERVER_PARAMETER(inboundNetworkImpl,
+                                      std::string,
+                                      kInboundNetworkImplThreadPerConnection);
+MONGO_INITIALIZER(inboundNetworkImpl)(InitializerContext*) {
+    if (inboundNetworkImpl != kInboundNetworkImplThreadPerConnection &&
+        inboundNetworkImpl != kInboundNetworkImplASIO) {
+        return Status(ErrorCodes::BadValue,
+                      "unsupported inbound networking option: " + inboundNetworkImpl);
+    }
+    return Status::OK();
+}
+
+namespace {
+
+class ExportedThreadCountParameter : public ExportedServerParameter<int> {
+public:
+    ExportedThreadCountParameter(const std::string& name, int* value, int maxValue)
+        : ExportedServerParameter<int>(ServerParameterSet::getGlobal(),
+                                       name,
+                                       value,
+                                       true,    // allowedToChangeAtStartup
+                                       false),  // allowedToChangeAtRuntime
+          _maxValue(maxValue) {}
+
+    virtual Status validate(const int& potentialNewValue) {
+        if (potentialNewValue < 1 || potentialNewValue > _maxValue) {
+            return Status(ErrorCodes::BadValue,
+                          str::stream() << name() << " must be between 1 and " << _maxValue);
+        }
+        return Status::OK();
+    }
+
+private:
+    const int _maxValue;
+};
+
+// Number of threads which wait on client sockets and read incoming messages.
+int inboundASIOIOThreads = 2;
+ExportedThreadCountParameter exportedInboundASIOIOThreads("inboundASIOIOThreads",
+                                                          &inboundASIOIOThreads,
+                                                          64);
+
+// Upper bound on the number of threads running operations. Operations which block for a long
+// time (awaitData getMores, exhaust cursors, lock waits) hold on to a worker for their whole
+// duration, so this must stay well above the expected number of concurrently blocked operations.
+int inboundASIOMaxWorkerThreads = 512;
+ExportedThreadCountParameter exportedInboundASIOMaxWorkerThreads("inboundASIOMaxWorkerThreads",
+                                                                 &inboundASIOMaxWorkerThreads,
+                                                                 100000);
+
+}  // namespace
+
+bool useASIOMessageServer() {
+    if (inboundNetworkImpl != kInboundNetworkImplASIO) {
+        return false;
+    }
+#ifdef _WIN32
+    warning() << "inboundNetworkImpl=" << kInboundNetworkImplASIO
+              << " is not supported on Windows; using one thread per connection";
+    return false;
+#else
+    if (sslGlobalParams.sslMode.load() != SSLParams::SSLMode_disabled) {
+        warning() << "inboundNetworkImpl=" << kInboundNetworkImplASIO
+                  << " is not supported with SSL; using one thread per connection";
+        return false;
+    }
+    return true;
+#endif
+}
+
+#ifdef _WIN32
+
+MessageServer* createASIOMessageServer(const MessageServer::Options& opts,
+                                       MessageHandler* handler) {
+    MONGO_UNREACHABLE;
+}
+
+#else
+
+namespace {
+
+class ASIOMessageServer : public MessageServer, public Listener {
+    MONGO_DISALLOW_COPYING(ASIOMessageServer);
+
+public:
+    ASIOMessageServer(const MessageServer::Options& opts, MessageHandler* handler)
+        : Listener("", opts.ipList, opts.port), _handler(handler), _workers(_makePoolOptions()) {}
+
+    ~ASIOMessageServer() {
+        _work.reset();
+        _ioService.stop();
+        for (auto& thread : _ioThreads) {
+            thread.join();
+        }
+        _workers.shutdown();
+        _workers.join();
+    }
+
+    virtual void accepted(std::shared_ptr<Socket> psocket, long long connectionId);
+
+    virtual void setAsTimeTracker() {
+        Listener::setAsTimeTracker();
+    }
+
+    virtual void setupSockets() {
+        Listener::setupSockets();
+    }
+
+    void run() {
+        _workers.startup();
+        _work = stdx::make_unique<asio::io_service::work>(_ioService);
+        for (int i = 0; i < inboundASIOIOThreads; ++i) {
+            _ioThreads.emplace_back([this, i] {
+                setThreadName(std::string(str::stream() << "ingressIO" << i));
+                _ioService.run();
+            });
+        }
+        log() << "accepting connections with " << inboundASIOIOThreads
+              << " I/O threads and up to " << inboundASIOMaxWorkerThreads << " worker threads";
+        initAndListen();
+    }
+
+    virtual bool useUnixSockets() const {
+        return true;
+    }
+
+private:
+    class Connection;
+
+    static ThreadPool::Options _makePoolOptions() {
+        ThreadPool::Options options;
+        options.poolName = "ingressWorkers";
+        options.threadNamePrefix = "ingressWorker";
+        options.minThreads = 1;
+        options.maxThreads = static_cast<size_t>(inboundASIOMaxWorkerThreads);
+        return options;
+    }
+
+    MessageHandler* const _handler;
+
+    asio::io_service _ioService;
+    std::unique_ptr<asio::io_service::work> _work;
+    std::vector<stdx::thread> _ioThreads;
+
+    ThreadPool _workers;
+};
+
+/**
+ * A MessagingPort whose file descriptor is also registered with the I/O threads. shutdown(),
+ * which MessagingPort::closeAllSockets() may call from any thread, only wakes up pending reads
+ * and writes; the owning Connection closes the descriptor once it is no longer registered, so
+ * that its number cannot be reused while the I/O threads still refer to it.
+ */
+class ASIOMessagingPort : public MessagingPort {
+public:
+    explicit ASIOMessagingPort(std::shared_ptr<Socket> socket) : MessagingPort(std::move(socket)) {}
+
+    void shutdown() override {
+        const int fd = psock->rawFD();
+        if (fd >= 0) {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+
+    void close() {
+        MessagingPort::shutdown();
+    }
+};
+
+/**
+ * State of one client connection. Each connection alternates between two phases:
+ *
+ *  1. Reading: the socket is non-blocking and owned by the I/O threads, which read the header
+ *     and then the body of the next message without occupying a worker.
+ *  2. Processing: the complete message is handed to a worker thread, which switches the socket
+ *     back to blocking mode, binds the connection's Client to itself and calls the handler.
+ *     Replies are written synchronously through the MessagingPort.
+ *
+ * Only one phase is active at a time, so the connection needs no locking. The connection keeps
+ * itself alive through the shared_ptr captured by whichever callback is pending.
+ */
+class ASIOMessageServer::Connection : public std::enable_shared_from_this<Connection> {
+    MONGO_DISALLOW_COPYING(Connection);
+
+public:
+    Connection(ASIOMessageServer* server, std::shared_ptr<Socket> socket, long long connectionId)
+        : _server(server), _port(std::move(socket)), _descriptor(server->_ioService) {
+        _port.setConnectionId(connectionId);
+    }
+
+    ~Connection() {
+        _close();
+        Listener::globalTicketHolder.release();
+    }
+
+    /**
+     * Registers the socket with the I/O threads and runs the handler's connected() callback on a
+     * worker thread, after which the first message is read.
+     */
+    void start() {
+        _port.psock->setLogLevel(logger::LogSeverity::Debug(1));
+        _descriptor.assign(_port.psock->rawFD());
+
+        auto self = shared_from_this();
+        _schedule([self] { self->_connected(); });
+    }
+
+private:
+    /**
+     * Unregisters the socket from the I/O threads and closes it. Must only be called while no
+     * asynchronous operation is pending on the socket.
+     */
+    void _close() {
+        // The Socket owns the file descriptor.
+        _descriptor.release();
+        _port.close();
+    }
+
+    void _schedule(ThreadPool::Task task) {
+        Status status = _server->_workers.schedule(std::move(task));
+        if (!status.isOK()) {
+            log() << "failed to schedule work for connection " << _port.connectionId() << ": "
+                  << status;
+            _close();
+        }
+    }
+
+    void _connected() {
+        try {
+            _server->_handler->connected(&_port);
+            _client = Client::releaseCurrent();
+        } catch (const DBException& e) {
+            log() << "DBException setting up client connection, closing it: " << e;
+            if (haveClient()) {
+                _client = Client::releaseCurrent();
+            }
+            _close();
+            return;
+        }
+        _readHeader();
+    }
+
+    void _readHeader() {
+        if (inShutdown()) {
+            _close();
+            return;
+        }
+
+        auto self = shared_from_this();
+        asio::async_read(_descriptor,
+                         asio::buffer(_header.view().view2ptr(), sizeof(MSGHEADER::Value)),
+                         [self](const std::error_code& ec, size_t) { self->_onHeader(ec); });
+    }
+
+    void _onHeader(const std::error_code& ec) {
+        if (ec) {
+            _endConnection(ec);
+            return;
+        }
+
+        const int len = _header.constView().getMessageLength();
+        if (len == 542393671) {
+            // An HTTP GET on the native driver port. Let a worker send the explanation, since
+            // the socket must be blocking for that.
+            auto self = shared_from_this();
+            _schedule([self] { self->_replyToHTTP(); });
+            return;
+        }
+
+        if (_awaitingFirstMessage) {
+            const int responseTo = _header.constView().getResponseTo();
+            if (responseTo != 0 && responseTo != -1) {
+                log() << "SSL handshake received but server is started without SSL support, "
+                      << "closing connection from " << _port.psock->remoteString();
+                _close();
+                return;
+            }
+            _awaitingFirstMessage = false;
+        }
+
+        if (static_cast<size_t>(len) < sizeof(MSGHEADER::Value) ||
+            static_cast<size_t>(len) > MaxMessageSizeBytes) {
+            LOG(0) << "recv(): message len " << len << " is invalid. "
+                   << "Min " << sizeof(MSGHEADER::Value) << " Max: " << MaxMessageSizeBytes;
+            _close();
+            return;
+        }
+
+        // Round up the same way MessagingPort::recv() does to keep allocation sizes uniform.
+        const int allocSize = (len + 1023) & 0xfffffc00;
+        char* buf = reinterpret_cast<char*>(mongoMalloc(allocSize));
+        memcpy(buf, _header.view().view2ptr(), sizeof(MSGHEADER::Value));
+        _message.setData(buf, true);
+
+        auto self = shared_from_this();
+        asio::async_read(_descriptor,
+                         asio::buffer(buf + sizeof(MSGHEADER::Value),
+                                      len - sizeof(MSGHEADER::Value)),
+                         [self](const std::error_code& ec, size_t) { self->_onBody(ec); });
+    }
+
+    void _onBody(const std::error_code& ec) {
+        if (ec) {
+            _message.reset();
+            _endConnection(ec);
+            return;
+        }
+
+        auto self = shared_from_this();
+        _schedule([self] { self->_process(); });
+    }
+
+    void _process() {
+        bool keepGoing = _makeBlocking();
+        if (keepGoing) {
+            Status status = _port.compressorManager().decompressMessage(&_message);
+            if (!status.isOK()) {
+                log() << "failed to decompress message from " << _port.psock->remoteString()
+                      << ", closing connection: " << status;
+                _close();
+                keepGoing = false;
+            }
+        }
+        if (keepGoing) {
+            Client::setCurrent(std::move(_client));
+            ON_BLOCK_EXIT([this] { _client = Client::releaseCurrent(); });
+
+            keepGoing = _runHandler();
+        }
+
+        _message.reset();
+        if (keepGoing) {
+            _readHeader();
+        }
+    }
+
+    /**
+     * Calls the handler on the current message. Returns false if the connection must be closed.
+     */
+    bool _runHandler() {
+        const long long bytesIn = _message.header().getLen();
+        try {
+            _port.psock->clearCounters();
+            _server->_handler->process(_message, &_port);
+            networkCounter.hit(bytesIn, _port.psock->getBytesOut());
+
+            // Occasionally we want to see if we're using too much memory.
+            if ((_messageCount++ & 0xf) == 0) {
+                markThreadIdle();
+            }
+            return true;
+        } catch (AssertionException& e) {
+            log() << "AssertionException handling request, closing client connection: " << e;
+        } catch (SocketException& e) {
+            log() << "SocketException handling request, closing client connection: " << e;
+        } catch (const DBException& e) {
+            // must be right above std::exception to avoid catching subclasses
+            log() << "DBException handling request, closing client connection: " << e;
+        } catch (std::exception& e) {
+            error() << "Uncaught std::exception: " << e.what() << ", terminating";
+            dbexit(EXIT_UNCAUGHT);
+        }
+        _close();
+        return false;
+    }
+
+    void _replyToHTTP() {
+        if (!_makeBlocking()) {
+            return;
+        }
+        const std::string msg =
+            "It looks like you are trying to access MongoDB over HTTP on the native driver "
+            "port.\n";
+        LOG(_port.psock->getLogLevel()) << msg;
+        std::stringstream ss;
+        ss << "HTTP/1.0 200 OK\r\nConnection: close\r\nContent-Type: "
+              "text/plain\r\nContent-Length: " << msg.size() << "\r\n\r\n" << msg;
+        const std::string s = ss.str();
+        try {
+            _port.send(s.c_str(), s.size(), "http");
+        } catch (const SocketException&) {
+        }
+        _close();
+    }
+
+    /**
+     * The I/O threads leave the socket in non-blocking mode, but replies are sent with the
+     * blocking Socket API.
+     */
+    bool _makeBlocking() {
+        std::error_code ec;
+        _descriptor.native_non_blocking(false, ec);
+        if (ec) {
+            log() << "failed to switch connection " << _port.connectionId()
+                  << " to blocking mode, closing it: " << ec.message();
+            _close();
+            return false;
+        }
+        return true;
+    }
+
+    void _endConnection(const std::error_code& ec) {
+        if (ec != asio::error::eof) {
+            LOG(_port.psock->getLogLevel()) << "error reading from "
+                                            << _port.psock->remoteString() << ": "
+                                            << ec.message();
+        }
+        if (!serverGlobalParams.quiet) {
+            int conns = Listener::globalTicketHolder.used() - 1;
+            const char* word = (conns == 1 ? " connection" : " connections");
+            log() << "end connection " << _port.psock->remoteString() << " (" << conns << word
+                  << " now open)";
+        }
+        _close();
+    }
+
+    ASIOMessageServer* const _server;
+    ASIOMessagingPort _port;
+    asio::posix::stream_descriptor _descriptor;
+
+    // Detached from any thread between messages.
+    ServiceContext::UniqueClient _client;
+
+    MSGHEADER::Value _header;
+    Message _message;
+    bool _awaitingFirstMessage = true;
+    uint64_t _messageCount = 0;
+};
+
+void ASIOMessageServer::accepted(std::shared_ptr<Socket> psocket, long long connectionId) {
+    ScopeGuard sleepAfterClosingPort = MakeGuard(sleepmillis, 2);
+
+    if (!Listener::globalTicketHolder.tryAcquire()) {
+        log() << "connection refused because too many open connections: "
+              << Listener::globalTicketHolder.used();
+        return;
+    }
+
+    std::shared_ptr<Connection> connection;
+    try {
+        connection = std::make_shared<Connection>(this, std::move(psocket), connectionId);
+    } catch (...) {
+        Listener::globalTicketHolder.release();
+        log() << "failed to allocate state for new connection, closing it";
+        return;
+    }
+
+    // From here on the Connection is responsible for releasing the ticket.
+    try {
+        connection->start();
+        sleepAfterClosingPort.Dismiss();
+    } catch (const std::exception& e) {
+        log() << "failed to register new connection, closing it: " << e.what();
+    }
+}
+
+}  // namespace
+
+MessageServer* createASIOMessageServer(const MessageServer::Options& opts,
+                                       MessageHandler* handler) {
+    return new ASIOMessageServer(opts, handler);
+}
+
+#endif  // _WIN32
+
+}  // namespace mongo
@@ -0,0 +1,53 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include "mongo/util/net/message_server.h"
+
+namespace mongo {
+
+/**
+ * Returns true if the "inboundNetworkImpl" server parameter selects the ASIO ingress mode and
+ * that mode can be used with the current platform and SSL configuration. Logs a warning and
+ * returns false if ASIO was requested but cannot be used.
+ */
+bool useASIOMessageServer();
+
+/**
+ * Creates a MessageServer which multiplexes all client sockets over a small pool of ASIO I/O
+ * threads, and runs handler->process() on a bounded pool of worker threads once a complete
+ * message has been read from a socket.
+ *
+ * The handler must not rely on being called from the same thread for every message on a given
+ * connection. The current thread's Client is moved between threads by the server.
+ */
+MessageServer* createASIOMessageServer(const MessageServer::Options& opts,
+                                       MessageHandler* handler);
+
+}  // namespace mongo
@@ -38,6 +38,7 @@
 #include "mongo/config.h"
 #include "mongo/db/lasterror.h"
 #include "mongo/db/server_options.h"
+#include "mongo/db/server_parameters.h"
 #include "mongo/db/stats/counters.h"
 #include "mongo/stdx/functional.h"
 #include "mongo/stdx/thread.h"
@@ -52,8 +53,11 @@
 #include "mongo/util/net/message.h"
 #include "mongo/util/net/message_port.h"
 #include "mongo/util/net/message_server.h"
+#include "mongo/util/net/message_server_asio.h"
 #include "mongo/util/net/ssl_manager.h"
+#include "mongo/util/numa.h"
 #include "mongo/util/scopeguard.h"
+#include "mongo/util/timer.h"
 
 #ifdef __linux__  // TODO: consider making this ifndef _WIN32
 #include <sys/resource.h>
@@ -70,6 +74,29 @@ using std::endl;
 
 namespace {
 
+ExportedServerParameter<bool> numaPinConnectionsParameter(
+    ServerParameterSet::getGlobal(), "numaPinConnections", &numaPinConnections, true, false);
+
+/**
+ * Pins the thread of connection "connectionId" to a NUMA node, spreading the connections over the
+ * nodes which have CPUs in turn.
+ */
+void pinConnectionThread(long long connectionId) {
+    NumaTopology& topology = NumaTopology::get();
+    for (size_t i = 0; i < topology.numNodes(); ++i) {
+        const size_t node = (connectionId + i) % topology.numNodes();
+        if (topology.cpusOfNode(node).empty()) {
+            continue;
+        }
+
+        Status status = topology.pinCurrentThreadToNode(node);
+        if (!status.isOK()) {
+            LOG(1) << "Cannot pin connection " << connectionId << ": " << status;
+        }
+        return;
+    }
+}
+
 class MessagingPortWithHandler : public MessagingPort {
     MONGO_DISALLOW_COPYING(MessagingPortWithHandler);
 
@@ -85,9 +112,17 @@ public:
         return _handler;
     }
 
+    /**
+     * Time since the connection was accepted.
+     */
+    const Timer& sinceAccepted() const {
+        return _sinceAccepted;
+    }
+
 private:
     // Not owned.
     MessageHandler* const _handler;
+    const Timer _sinceAccepted;
 };
 
 }  // namespace
@@ -204,6 +239,9 @@ private:
         MessageHandler* const handler = portWithHandler->getHandler();
 
         setThreadName(std::string(str::stream() << "conn" << portWithHandler->connectionId()));
+        if (numaPinConnections) {
+            pinConnectionThread(portWithHandler->connectionId());
+        }
         portWithHandler->psock->setLogLevel(logger::LogSeverity::Debug(1));
 
         Message m;
@@ -226,6 +264,10 @@ private:
                     break;
                 }
 
+                if (counter == 0) {
+                    Listener::recordTimeToFirstMessage(portWithHandler->sinceAccepted().micros());
+                }
+
                 handler->process(m, portWithHandler.get());
                 networkCounter.hit(portWithHandler->psock->getBytesIn(),
                                    portWithHandler->psock->getBytesOut());
@@ -264,6 +306,9 @@ private:
 
 
 MessageServer* createServer(const MessageServer::Options& opts, MessageHandler* handler) {
+    if (useASIOMessageServer()) {
+        return createASIOMessageServer(opts, handler);
+    }
     return new PortMessageServer(opts, handler);
 }
 
@@ -41,12 +41,15 @@
 #include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <errno.h>
+#include <limits.h>
 #include <netdb.h>
 #if defined(__OpenBSD__)
 #include <sys/uio.h>
 #endif
 #endif
 
+#include <algorithm>
+
 #include "mongo/config.h"
 #include "mongo/db/server_options.h"
 #include "mongo/util/background.h"
@@ -680,7 +683,13 @@ void Socket::_send(const vector<pair<char*, int>>& data, const char* context) {
 void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
 #ifdef MONGO_CONFIG_SSL
     if (_sslConnection.get()) {
-        _send(data, context);
+        // Write the whole message with one SSL_write so that it goes out in as few TLS
+        // records as possible, rather than at least one per buffer.
+        std::vector<char> buffer;
+        for (auto&& piece : data) {
+            buffer.insert(buffer.end(), piece.first, piece.first + piece.second);
+        }
+        send(buffer.data(), buffer.size(), context);
         return;
     }
 #endif
@@ -690,7 +699,7 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
     _send(data, context);
 #else
     vector<struct iovec> d(data.size());
-    int i = 0;
+    size_t i = 0;
     for (vector<pair<char*, int>>::const_iterator j = data.begin(); j != data.end(); ++j) {
         if (j->second > 0) {
             d[i].iov_base = j->first;
@@ -699,10 +708,18 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
             _bytesOut += j->second;
         }
     }
+    if (i == 0) {
+        return;
+    }
+
+    // sendmsg() rejects more than IOV_MAX buffers at once, which zero-copy replies made up of
+    // many documents can exceed, so the vector is handed to the kernel in windows of at most
+    // that many entries.
+    struct iovec* const end = &d[0] + i;
     struct msghdr meta;
     memset(&meta, 0, sizeof(meta));
     meta.msg_iov = &d[0];
-    meta.msg_iovlen = d.size();
+    meta.msg_iovlen = std::min<size_t>(i, IOV_MAX);
 
     while (meta.msg_iovlen > 0) {
         int ret = -1;
@@ -739,6 +756,9 @@ void Socket::send(const vector<pair<char*, int>>& data, const char* context) {
                     --(meta.msg_iovlen);
                 }
             }
+            if (meta.msg_iovlen == 0) {
+                meta.msg_iovlen = std::min<size_t>(end - meta.msg_iov, IOV_MAX);
+            }
         }
     }
 #endif
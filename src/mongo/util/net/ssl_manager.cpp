@@ -35,8 +35,10 @@
 #include <boost/thread/recursive_mutex.hpp>
 #include <boost/thread/tss.hpp>
 #include <iostream>
+#include <map>
 #include <sstream>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "mongo/base/init.h"
@@ -44,6 +46,7 @@
 #include "mongo/config.h"
 #include "mongo/platform/atomic_word.h"
 #include "mongo/stdx/memory.h"
+#include "mongo/stdx/mutex.h"
 #include "mongo/util/concurrency/mutex.h"
 #include "mongo/util/exit.h"
 #include "mongo/util/debug_util.h"
@@ -169,6 +172,10 @@ SSLManagerInterface* theSSLManager = NULL;
 using UniqueSSLContext = std::unique_ptr<SSL_CTX, decltype(&_free_ssl_context)>;
 static const int BUFFER_SIZE = 8 * 1024;
 static const int DATE_LEN = 128;
+// Remote hosts whose sessions a client context remembers before starting over.
+static const size_t maxClientSessions = 1024;
+// Sessions the server side of a context keeps for clients to resume.
+static const long serverSessionCacheSize = 20 * 1024;
 
 class SSLManager : public SSLManagerInterface {
 public:
@@ -190,6 +197,10 @@ public:
     StatusWith<boost::optional<std::string>> parseAndValidatePeerCertificate(
         SSL* conn, const std::string& remoteHost) final;
 
+    void resumeClientSession(SSL* ssl, const std::string& remoteHost) final;
+
+    void saveClientSession(SSL* ssl, const std::string& remoteHost) final;
+
     virtual void cleanupThreadLocals();
 
     virtual const SSLConfiguration& getSSLConfiguration() const {
@@ -219,6 +230,12 @@ private:
     bool _allowInvalidHostnames;
     SSLConfiguration _sslConfiguration;
 
+    // Last session established by each client context with each remote host, for resumption.
+    // Holds a reference to every session in it.
+    using ClientSessionKey = std::pair<SSL_CTX*, std::string>;
+    stdx::mutex _clientSessionsMutex;
+    std::map<ClientSessionKey, SSL_SESSION*> _clientSessions;
+
     /**
      * creates an SSL object to be used for this file descriptor.
      * caller must SSL_free it.
@@ -570,6 +587,11 @@ Status SSLManager::initSSLContext(SSL_CTX* context, const SSLParams& params) {
                                     << getSSLErrorMessage(ERR_get_error()));
     }
 
+    // Let reconnecting clients resume their sessions, either by session id or, for clients
+    // which support them, with session tickets, which OpenSSL enables by default.
+    ::SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_SERVER);
+    ::SSL_CTX_sess_set_cache_size(context, serverSessionCacheSize);
+
     if (!params.sslClusterFile.empty()) {
         ::EVP_set_pw_prompt("Enter cluster certificate passphrase");
         if (!_setupPEM(context, params.sslClusterFile, params.sslClusterPassword)) {
@@ -840,6 +862,8 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     std::unique_ptr<SSLConnection> sslConn =
         stdx::make_unique<SSLConnection>(_clientContext.get(), socket, (const char*)NULL, 0);
 
+    resumeClientSession(sslConn->ssl, socket->remoteString());
+
     int ret;
     do {
         ret = ::SSL_connect(sslConn->ssl);
@@ -848,9 +872,43 @@ SSLConnection* SSLManager::connect(Socket* socket) {
     if (ret != 1)
         _handleSSLError(SSL_get_error(sslConn.get(), ret), ret);
 
+    saveClientSession(sslConn->ssl, socket->remoteString());
     return sslConn.release();
 }
 
+void SSLManager::resumeClientSession(SSL* ssl, const std::string& remoteHost) {
+    stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+    auto it = _clientSessions.find(std::make_pair(::SSL_get_SSL_CTX(ssl), remoteHost));
+    if (it != _clientSessions.end()) {
+        // If the server no longer knows the session, the handshake falls back to a full one.
+        ::SSL_set_session(ssl, it->second);
+    }
+}
+
+void SSLManager::saveClientSession(SSL* ssl, const std::string& remoteHost) {
+    SSL_SESSION* session = ::SSL_get1_session(ssl);
+    if (!session) {
+        return;
+    }
+
+    stdx::lock_guard<stdx::mutex> lk(_clientSessionsMutex);
+    auto key = std::make_pair(::SSL_get_SSL_CTX(ssl), remoteHost);
+    auto it = _clientSessions.find(key);
+    if (it != _clientSessions.end()) {
+        ::SSL_SESSION_free(it->second);
+        it->second = session;
+        return;
+    }
+
+    if (_clientSessions.size() >= maxClientSessions) {
+        for (auto&& entry : _clientSessions) {
+            ::SSL_SESSION_free(entry.second);
+        }
+        _clientSessions.clear();
+    }
+    _clientSessions.insert(std::make_pair(std::move(key), session));
+}
+
 SSLConnection* SSLManager::accept(Socket* socket, const char* initialBytes, int len) {
     std::unique_ptr<SSLConnection> sslConn =
         stdx::make_unique<SSLConnection>(_serverContext.get(), socket, initialBytes, len);
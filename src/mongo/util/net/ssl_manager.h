@@ -166,6 +166,18 @@ public:
      */
     virtual StatusWith<boost::optional<std::string>> parseAndValidatePeerCertificate(
         SSL* ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * Offers "ssl", which is about to connect to "remoteHost", the session the last connection
+     * from the same SSL context to that host established, so that the handshake can resume it
+     * instead of starting over.  Must be called before the handshake starts.
+     */
+    virtual void resumeClientSession(SSL* ssl, const std::string& remoteHost) = 0;
+
+    /**
+     * Remembers the session "ssl" established with "remoteHost" for later connections to it.
+     */
+    virtual void saveClientSession(SSL* ssl, const std::string& remoteHost) = 0;
 };
 
 // Access SSL functions through this instance.
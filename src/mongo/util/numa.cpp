@@ -0,0 +1,161 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#define MONGO_LOG_DEFAULT_COMPONENT ::mongo::logger::LogComponent::kControl
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa.h"
+
+#ifdef __linux__
+#include <fstream>
+#include <sched.h>
+#endif
+
+#include "mongo/base/parse_number.h"
+#include "mongo/bson/bsonobjbuilder.h"
+#include "mongo/util/log.h"
+#include "mongo/util/mongoutils/str.h"
+#include "mongo/util/text.h"
+
+namespace mongo {
+
+bool numaPinConnections = false;
+
+namespace {
+
+std::vector<std::vector<int>> readNodeCpus() {
+    std::vector<std::vector<int>> nodeCpus;
+#ifdef __linux__
+    // Nodes are numbered from zero; a machine can have holes in the numbering, which we treat as
+    // the end of the list.
+    for (size_t node = 0;; ++node) {
+        const std::string path = str::stream() << "/sys/devices/system/node/node" << node
+                                               << "/cpulist";
+        std::ifstream f(path.c_str(), std::ifstream::in);
+        if (!f.is_open()) {
+            break;
+        }
+
+        std::string line;
+        std::getline(f, line);
+        auto cpus = NumaTopology::parseCpuList(line);
+        if (!cpus.isOK()) {
+            warning() << "Cannot read the CPUs of NUMA node " << node << " from " << path << ": "
+                      << cpus.getStatus();
+            return {};
+        }
+        nodeCpus.push_back(std::move(cpus.getValue()));
+    }
+
+    if (nodeCpus.size() < 2) {
+        nodeCpus.clear();
+    }
+#endif
+    return nodeCpus;
+}
+
+}  // namespace
+
+NumaTopology& NumaTopology::get() {
+    static NumaTopology topology(readNodeCpus());
+    return topology;
+}
+
+NumaTopology::NumaTopology(std::vector<std::vector<int>> nodeCpus)
+    : _nodeCpus(std::move(nodeCpus)), _threadsPinned(new AtomicInt64[_nodeCpus.size()]) {}
+
+Status NumaTopology::pinCurrentThreadToNode(size_t node) {
+    if (node >= numNodes()) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "There is no NUMA node " << node << "; there are "
+                                    << numNodes());
+    }
+    if (_nodeCpus[node].empty()) {
+        return Status(ErrorCodes::BadValue,
+                      str::stream() << "NUMA node " << node << " has no CPUs");
+    }
+
+#ifdef __linux__
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    for (int cpu : _nodeCpus[node]) {
+        if (cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpus);
+        }
+    }
+    if (sched_setaffinity(0, sizeof(cpus), &cpus) != 0) {
+        return Status(ErrorCodes::InternalError,
+                      str::stream() << "Cannot pin thread to NUMA node " << node << ": "
+                                    << errnoWithDescription());
+    }
+    _threadsPinned[node].addAndFetch(1);
+    return Status::OK();
+#else
+    return Status(ErrorCodes::InternalError, "Pinning threads is only supported on Linux");
+#endif
+}
+
+void NumaTopology::appendStats(BSONObjBuilder* builder) const {
+    BSONArrayBuilder nodes(builder->subarrayStart("nodes"));
+    for (size_t node = 0; node < numNodes(); ++node) {
+        BSONObjBuilder nodeBuilder(nodes.subobjStart());
+        nodeBuilder.append("cpus", static_cast<int>(_nodeCpus[node].size()));
+        nodeBuilder.append("threadsPinned", _threadsPinned[node].load());
+    }
+}
+
+StatusWith<std::vector<int>> NumaTopology::parseCpuList(StringData list) {
+    std::vector<int> cpus;
+    if (list.empty()) {
+        // A node with memory but no CPUs.
+        return cpus;
+    }
+
+    for (const std::string& range : StringSplitter::split(list.toString(), ",")) {
+        const size_t dash = range.find('-');
+        const StringData firstStr = StringData(range).substr(0, dash);
+        const StringData lastStr =
+            dash == std::string::npos ? firstStr : StringData(range).substr(dash + 1);
+
+        int first;
+        int last;
+        if (!parseNumberFromStringWithBase(firstStr, 10, &first).isOK() ||
+            !parseNumberFromStringWithBase(lastStr, 10, &last).isOK() || first < 0 ||
+            last < first) {
+            return Status(ErrorCodes::FailedToParse,
+                          str::stream() << "Bad CPU range '" << range << "' in '" << list << "'");
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            cpus.push_back(cpu);
+        }
+    }
+    return cpus;
+}
+
+}  // namespace mongo
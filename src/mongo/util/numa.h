@@ -0,0 +1,94 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "mongo/base/disallow_copying.h"
+#include "mongo/base/status.h"
+#include "mongo/base/status_with.h"
+#include "mongo/base/string_data.h"
+#include "mongo/platform/atomic_word.h"
+
+namespace mongo {
+
+class BSONObjBuilder;
+
+// Whether the thread of each incoming connection is pinned to one of the NUMA nodes, in turn; the
+// "numaPinConnections" startup parameter. Only the thread-per-connection server pins its threads.
+extern bool numaPinConnections;
+
+/**
+ * The NUMA nodes of this machine and the CPUs on each of them.
+ *
+ * Only Linux reports the topology, from /sys/devices/system/node; elsewhere, and on machines with
+ * a single node, there are no nodes and nothing is ever pinned.
+ */
+class NumaTopology {
+    MONGO_DISALLOW_COPYING(NumaTopology);
+
+public:
+    /**
+     * Returns the topology, which is read the first time this is called.
+     */
+    static NumaTopology& get();
+
+    explicit NumaTopology(std::vector<std::vector<int>> nodeCpus);
+
+    size_t numNodes() const {
+        return _nodeCpus.size();
+    }
+
+    const std::vector<int>& cpusOfNode(size_t node) const {
+        return _nodeCpus[node];
+    }
+
+    /**
+     * Restricts the calling thread to the CPUs of "node". Memory the thread first touches from
+     * then on is allocated on that node by the kernel's default local allocation policy.
+     */
+    Status pinCurrentThreadToNode(size_t node);
+
+    /**
+     * Appends, for each node, its CPU count and the number of threads pinned to it so far.
+     */
+    void appendStats(BSONObjBuilder* builder) const;
+
+    /**
+     * Parses a sysfs CPU list such as "0-3,8,10-11".
+     */
+    static StatusWith<std::vector<int>> parseCpuList(StringData list);
+
+private:
+    const std::vector<std::vector<int>> _nodeCpus;
+    const std::unique_ptr<AtomicInt64[]> _threadsPinned;
+};
+
+}  // namespace mongo
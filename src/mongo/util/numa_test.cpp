@@ -0,0 +1,66 @@
+/**
+ *    Copyright (C) 2015 MongoDB Inc.
+ *
+ *    This program is free software: you can redistribute it and/or  modify
+ *    it under the terms of the GNU Affero General Public License, version 3,
+ *    as published by the Free Software Foundation.
+ *
+ *    This program is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU Affero General Public License for more details.
+ *
+ *    You should have received a copy of the GNU Affero General Public License
+ *    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *    As a special exception, the copyright holders give permission to link the
+ *    code of portions of this program with the OpenSSL library under certain
+ *    conditions as described in each individual source file and distribute
+ *    linked combinations including the program with the OpenSSL library. You
+ *    must comply with the GNU Affero General Public License in all respects for
+ *    all of the code used other than as permitted herein. If you modify file(s)
+ *    with this exception, you may extend this exception to your version of the
+ *    file(s), but you are not obligated to do so. If you do not wish to do so,
+ *    delete this exception statement from your version. If you delete this
+ *    exception statement from all source files in the program, then also delete
+ *    it in the license file.
+ */
+
+#include "mongo/platform/basic.h"
+
+#include "mongo/util/numa.h"
+#include "mongo/unittest/unittest.h"
+
+namespace mongo {
+namespace {
+
+TEST(NumaTopology, ParseCpuList) {
+    ASSERT(std::vector<int>({0, 1, 2, 3, 8, 10, 11}) ==
+           NumaTopology::parseCpuList("0-3,8,10-11").getValue());
+    ASSERT(std::vector<int>({7}) == NumaTopology::parseCpuList("7").getValue());
+    ASSERT_TRUE(NumaTopology::parseCpuList("").getValue().empty());
+
+    ASSERT_NOT_OK(NumaTopology::parseCpuList("3-1").getStatus());
+    ASSERT_NOT_OK(NumaTopology::parseCpuList("0-").getStatus());
+    ASSERT_NOT_OK(NumaTopology::parseCpuList("a").getStatus());
+}
+
+TEST(NumaTopology, PinToNode) {
+    NumaTopology none({});
+    ASSERT_EQUALS(0U, none.numNodes());
+    ASSERT_NOT_OK(none.pinCurrentThreadToNode(0));
+
+    NumaTopology memoryOnly({{0}, {}});
+    ASSERT_NOT_OK(memoryOnly.pinCurrentThreadToNode(1));
+
+    // The machine's own topology is always one the current thread can be pinned to.
+    NumaTopology& topology = NumaTopology::get();
+    for (size_t node = 0; node < topology.numNodes(); ++node) {
+        if (!topology.cpusOfNode(node).empty()) {
+            ASSERT_OK(topology.pinCurrentThreadToNode(node));
+        }
+    }
+}
+
+}  // namespace
+}  // namespace mongo
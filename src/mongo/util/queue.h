@@ -74,6 +74,32 @@ public:
         _cvNoLongerEmpty.notify_one();
     }
 
+    /**
+     * Pushes the items in [begin, end) under a single acquisition of the queue lock, waking the
+     * consumer once. Waits until the whole range fits, or until the queue is empty when the range
+     * is larger than the max size on its own.
+     */
+    template <typename Iterator>
+    void pushAll(Iterator begin, Iterator end) {
+        if (begin == end) {
+            return;
+        }
+        size_t rangeSize = 0;
+        for (auto i = begin; i != end; ++i) {
+            rangeSize += _getSize(*i);
+        }
+        stdx::unique_lock<stdx::mutex> l(_lock);
+        _clearing = false;
+        while (_currentSize > 0 && _currentSize + rangeSize > _maxSize) {
+            _cvNoLongerFull.wait(l);
+        }
+        for (auto i = begin; i != end; ++i) {
+            _queue.push(*i);
+        }
+        _currentSize += rangeSize;
+        _cvNoLongerEmpty.notify_one();
+    }
+
     bool empty() const {
         stdx::lock_guard<stdx::mutex> l(_lock);
         return _queue.empty();
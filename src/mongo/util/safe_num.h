@@ -154,7 +154,11 @@ public:
     friend class mutablebson::Element;
     friend class mutablebson::Document;
 
-    // TODO: output to builder
+    /**
+     * Appends the value to 'bob' under 'fieldName', with the type of the value. Must not be
+     * called on an EOO-typed instance.
+     */
+    void toBSON(StringData fieldName, BSONObjBuilder* bob) const;
 
     //
     // accessors